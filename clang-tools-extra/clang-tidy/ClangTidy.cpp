@@ -46,7 +46,10 @@
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <utility>
 
 using namespace clang::ast_matchers;
@@ -487,15 +490,13 @@ getCheckOptions(const ClangTidyOptions &Options,
   return Factory.getCheckOptions();
 }
 
-std::vector<ClangTidyError>
-runClangTidy(clang::tidy::ClangTidyContext &Context,
-             const CompilationDatabase &Compilations,
-             ArrayRef<std::string> InputFiles,
-             llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
-             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile) {
-  ClangTool Tool(Compilations, InputFiles,
-                 std::make_shared<PCHContainerOperations>(), BaseFS);
-
+/// Runs the checks enabled in \p Context on the files of \p Tool, reporting
+/// the diagnostics to \p DiagConsumer.
+static void
+runChecks(ClangTool &Tool, ClangTidyContext &Context,
+          ClangTidyDiagnosticConsumer &DiagConsumer,
+          llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+          bool EnableCheckProfile, llvm::StringRef StoreCheckProfile) {
   // Add extra arguments passed by the clang-tidy command-line.
   ArgumentsAdjuster PerFileExtraArgumentsInserter =
       [&Context](const CommandLineArguments &Args, StringRef Filename) {
@@ -519,7 +520,6 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   Context.setEnableProfiling(EnableCheckProfile);
   Context.setProfileStoragePrefix(StoreCheckProfile);
 
-  ClangTidyDiagnosticConsumer DiagConsumer(Context);
   DiagnosticsEngine DE(new DiagnosticIDs(), new DiagnosticOptions(),
                        &DiagConsumer, /*ShouldOwnClient=*/false);
   Context.setDiagnosticsEngine(&DE);
@@ -564,6 +564,108 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
 
   ActionFactory Factory(Context, BaseFS);
   Tool.run(&Factory);
+}
+
+std::vector<ClangTidyError>
+runClangTidy(clang::tidy::ClangTidyContext &Context,
+             const CompilationDatabase &Compilations,
+             ArrayRef<std::string> InputFiles,
+             llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile) {
+  ClangTool Tool(Compilations, InputFiles,
+                 std::make_shared<PCHContainerOperations>(), BaseFS);
+  ClangTidyDiagnosticConsumer DiagConsumer(Context);
+  runChecks(Tool, Context, DiagConsumer, BaseFS, EnableCheckProfile,
+            StoreCheckProfile);
+  return DiagConsumer.take();
+}
+
+namespace {
+/// Gives the contexts of the worker threads access to the options provider of
+/// the main context, which caches the configuration files it reads.
+class SynchronizedOptionsProvider : public ClangTidyOptionsProvider {
+public:
+  SynchronizedOptionsProvider(ClangTidyOptionsProvider &Provider,
+                              std::mutex &Mutex)
+      : Provider(Provider), Mutex(Mutex) {}
+
+  const ClangTidyGlobalOptions &getGlobalOptions() override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Provider.getGlobalOptions();
+  }
+
+  std::vector<OptionsSource> getRawOptions(llvm::StringRef FileName) override {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Provider.getRawOptions(FileName);
+  }
+
+private:
+  ClangTidyOptionsProvider &Provider;
+  std::mutex &Mutex;
+};
+
+/// The state owned by one thread of a parallel run.
+struct Worker {
+  Worker(ClangTidyContext &MainContext, std::mutex &OptionsMutex,
+         llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS)
+      : Context(std::make_unique<SynchronizedOptionsProvider>(
+                    MainContext.getOptionsProvider(), OptionsMutex),
+                MainContext.canEnableAnalyzerAlphaCheckers()),
+        DiagConsumer(Context, /*ExternalDiagEngine=*/nullptr,
+                     /*RemoveIncompatibleErrors=*/false),
+        BaseFS(std::move(BaseFS)) {}
+
+  ClangTidyContext Context;
+  ClangTidyDiagnosticConsumer DiagConsumer;
+  llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS;
+};
+} // namespace
+
+std::vector<ClangTidyError>
+runClangTidy(clang::tidy::ClangTidyContext &Context,
+             const CompilationDatabase &Compilations,
+             ArrayRef<std::string> InputFiles, unsigned Jobs,
+             llvm::function_ref<
+                 llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem>()>
+                 CreateBaseFS,
+             bool EnableCheckProfile, llvm::StringRef StoreCheckProfile) {
+  Jobs = std::min<size_t>(Jobs, InputFiles.size());
+  if (Jobs <= 1)
+    return runClangTidy(Context, Compilations, InputFiles, CreateBaseFS(),
+                        EnableCheckProfile, StoreCheckProfile);
+
+  std::mutex OptionsMutex;
+  std::vector<std::unique_ptr<Worker>> Workers;
+  for (unsigned I = 0; I < Jobs; ++I)
+    Workers.push_back(
+        std::make_unique<Worker>(Context, OptionsMutex, CreateBaseFS()));
+
+  // Files are handed out one at a time, as their analysis times vary widely.
+  // A worker keeps its FileManager across files, so that headers shared by its
+  // translation units are only looked up once, like in a sequential run.
+  std::atomic<size_t> NextFile(0);
+  {
+    llvm::ThreadPool Pool(Jobs);
+    for (std::unique_ptr<Worker> &W : Workers)
+      Pool.async([&, W = W.get()] {
+        llvm::IntrusiveRefCntPtr<FileManager> Files(
+            new FileManager(FileSystemOptions(), W->BaseFS));
+        for (size_t I = NextFile++; I < InputFiles.size(); I = NextFile++) {
+          ClangTool Tool(Compilations, InputFiles[I],
+                         std::make_shared<PCHContainerOperations>(), W->BaseFS,
+                         Files);
+          runChecks(Tool, W->Context, W->DiagConsumer, W->BaseFS,
+                    EnableCheckProfile, StoreCheckProfile);
+        }
+      });
+    Pool.wait();
+  }
+
+  // Merging sorts the findings of all workers together, which drops the
+  // copies reported for a header by translation units of different workers.
+  ClangTidyDiagnosticConsumer DiagConsumer(Context);
+  for (std::unique_ptr<Worker> &W : Workers)
+    DiagConsumer.merge(W->DiagConsumer);
   return DiagConsumer.take();
 }
 
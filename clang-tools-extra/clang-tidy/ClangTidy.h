@@ -12,6 +12,7 @@
 #include "ClangTidyCheck.h"
 #include "ClangTidyDiagnosticConsumer.h"
 #include "ClangTidyOptions.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/raw_ostream.h"
 #include <memory>
 #include <vector>
@@ -79,6 +80,24 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
              bool EnableCheckProfile = false,
              llvm::StringRef StoreCheckProfile = StringRef());
 
+/// Run a set of clang-tidy checks on a set of files using \p Jobs threads.
+///
+/// Each thread analyzes whole translation units with its own context and a
+/// filesystem returned by \p CreateBaseFS, which is called \p Jobs times before
+/// any analysis starts: the working directory is changed for every compile
+/// command, so the threads can't share one filesystem. Diagnostics and
+/// statistics are merged into \p Context, and a finding reported in a header
+/// by several translation units is only returned once.
+std::vector<ClangTidyError>
+runClangTidy(clang::tidy::ClangTidyContext &Context,
+             const tooling::CompilationDatabase &Compilations,
+             ArrayRef<std::string> InputFiles, unsigned Jobs,
+             llvm::function_ref<
+                 llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem>()>
+                 CreateBaseFS,
+             bool EnableCheckProfile = false,
+             llvm::StringRef StoreCheckProfile = StringRef());
+
 // FIXME: This interface will need to be significantly extended to be useful.
 // FIXME: Implement confidence levels for displaying/fixing errors.
 //
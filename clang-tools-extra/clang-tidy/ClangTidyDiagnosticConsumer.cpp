@@ -717,6 +717,9 @@ struct EqualClangTidyError {
 
 std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
   finalizeLastError();
+  Errors.insert(Errors.end(), std::make_move_iterator(MergedErrors.begin()),
+                std::make_move_iterator(MergedErrors.end()));
+  MergedErrors.clear();
 
   std::sort(Errors.begin(), Errors.end(), LessClangTidyError());
   Errors.erase(std::unique(Errors.begin(), Errors.end(), EqualClangTidyError()),
@@ -725,3 +728,12 @@ std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
     removeIncompatibleErrors();
   return std::move(Errors);
 }
+
+void ClangTidyDiagnosticConsumer::merge(ClangTidyDiagnosticConsumer &Other) {
+  std::vector<ClangTidyError> OtherErrors = Other.take();
+  MergedErrors.insert(MergedErrors.end(),
+                      std::make_move_iterator(OtherErrors.begin()),
+                      std::make_move_iterator(OtherErrors.end()));
+  Context.Stats += Other.Context.Stats;
+  Other.Context.Stats = ClangTidyStats();
+}
@@ -63,6 +63,15 @@ struct ClangTidyStats {
     return ErrorsIgnoredNOLINT + ErrorsIgnoredCheckFilter +
            ErrorsIgnoredNonUserCode + ErrorsIgnoredLineFilter;
   }
+
+  ClangTidyStats &operator+=(const ClangTidyStats &Other) {
+    ErrorsDisplayed += Other.ErrorsDisplayed;
+    ErrorsIgnoredCheckFilter += Other.ErrorsIgnoredCheckFilter;
+    ErrorsIgnoredNOLINT += Other.ErrorsIgnoredNOLINT;
+    ErrorsIgnoredNonUserCode += Other.ErrorsIgnoredNonUserCode;
+    ErrorsIgnoredLineFilter += Other.ErrorsIgnoredLineFilter;
+    return *this;
+  }
 };
 
 /// Every \c ClangTidyCheck reports errors through a \c DiagnosticsEngine
@@ -139,6 +148,9 @@ public:
   /// \c CurrentFile.
   ClangTidyOptions getOptionsForFile(StringRef File) const;
 
+  /// Returns the provider the options are read from. It is not thread-safe.
+  ClangTidyOptionsProvider &getOptionsProvider() { return *OptionsProvider; }
+
   /// Returns \c ClangTidyStats containing issued and ignored diagnostic
   /// counters.
   const ClangTidyStats &getStats() const { return Stats; }
@@ -241,6 +253,12 @@ public:
   // Retrieve the diagnostics that were captured.
   std::vector<ClangTidyError> take();
 
+  /// Takes the diagnostics captured by \p Other, which may use a different
+  /// context, and its statistics. They are returned by the next \c take()
+  /// together with this consumer's diagnostics, so findings reported by both
+  /// consumers are only returned once.
+  void merge(ClangTidyDiagnosticConsumer &Other);
+
 private:
   void finalizeLastError();
   void removeIncompatibleErrors();
@@ -260,6 +278,7 @@ private:
   DiagnosticsEngine *ExternalDiagEngine;
   bool RemoveIncompatibleErrors;
   std::vector<ClangTidyError> Errors;
+  std::vector<ClangTidyError> MergedErrors;
   std::unique_ptr<llvm::Regex> HeaderFilter;
   bool LastErrorRelatesToUserCode;
   bool LastErrorPassesLineFilter;
@@ -21,6 +21,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 
 using namespace clang::ast_matchers;
 using namespace clang::driver;
@@ -224,6 +225,13 @@ over the real file system.
                                        cl::value_desc("filename"),
                                        cl::cat(ClangTidyCategory));
 
+static cl::opt<unsigned> Jobs("j", cl::desc(R"(
+Number of threads analyzing the input files in
+parallel. 0 means one thread per core.
+)"),
+                              cl::init(1), cl::value_desc("threads"),
+                              cl::cat(ClangTidyCategory));
+
 namespace clang {
 namespace tidy {
 
@@ -326,20 +334,31 @@ getVfsFromFile(const std::string &OverlayFile,
   return FS;
 }
 
-static int clangTidyMain(int argc, const char **argv) {
-  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
-  CommonOptionsParser OptionsParser(argc, argv, ClangTidyCategory,
-                                    cl::ZeroOrMore);
+/// Creates the filesystem the input files are analyzed on, layering the
+/// -vfsoverlay file over \p RealFS.
+static llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem>
+createBaseFS(llvm::IntrusiveRefCntPtr<vfs::FileSystem> RealFS) {
   llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem> BaseFS(
-      new vfs::OverlayFileSystem(vfs::getRealFileSystem()));
+      new vfs::OverlayFileSystem(std::move(RealFS)));
 
   if (!VfsOverlay.empty()) {
     IntrusiveRefCntPtr<vfs::FileSystem> VfsFromFile =
         getVfsFromFile(VfsOverlay, BaseFS);
     if (!VfsFromFile)
-      return 1;
+      return nullptr;
     BaseFS->pushOverlay(VfsFromFile);
   }
+  return BaseFS;
+}
+
+static int clangTidyMain(int argc, const char **argv) {
+  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+  CommonOptionsParser OptionsParser(argc, argv, ClangTidyCategory,
+                                    cl::ZeroOrMore);
+  llvm::IntrusiveRefCntPtr<vfs::OverlayFileSystem> BaseFS =
+      createBaseFS(vfs::getRealFileSystem());
+  if (!BaseFS)
+    return 1;
 
   auto OwningOptionsProvider = createOptionsProvider(BaseFS);
   auto *OptionsProvider = OwningOptionsProvider.get();
@@ -427,9 +446,22 @@ static int clangTidyMain(int argc, const char **argv) {
 
   ClangTidyContext Context(std::move(OwningOptionsProvider),
                            AllowEnablingAnalyzerAlphaCheckers);
-  std::vector<ClangTidyError> Errors =
-      runClangTidy(Context, OptionsParser.getCompilations(), PathList, BaseFS,
-                   EnableCheckProfile, ProfilePrefix);
+  std::vector<ClangTidyError> Errors;
+  if (Jobs == 1) {
+    Errors = runClangTidy(Context, OptionsParser.getCompilations(), PathList,
+                          BaseFS, EnableCheckProfile, ProfilePrefix);
+  } else {
+    // The threads change their working directories independently, so each
+    // needs its own physical filesystem rather than the process-wide one. The
+    // overlay file was already read successfully above.
+    Errors = runClangTidy(
+        Context, OptionsParser.getCompilations(), PathList,
+        Jobs == 0 ? llvm::hardware_concurrency() : Jobs,
+        [] {
+          return createBaseFS(vfs::createPhysicalFileSystem().release());
+        },
+        EnableCheckProfile, ProfilePrefix);
+  }
   bool FoundErrors = llvm::find_if(Errors, [](const ClangTidyError &E) {
                        return E.DiagLevel == ClangTidyError::Error;
                      }) != Errors.end();
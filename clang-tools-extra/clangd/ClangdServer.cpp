@@ -8,6 +8,7 @@
 
 #include "ClangdServer.h"
 #include "CodeComplete.h"
+#include "DiagnosticsCache.h"
 #include "FindSymbols.h"
 #include "Format.h"
 #include "FormattedString.h"
@@ -54,9 +55,25 @@ namespace {
 // Update the FileIndex with new ASTs and plumb the diagnostics responses.
 struct UpdateIndexCallbacks : public ParsingCallbacks {
   UpdateIndexCallbacks(FileIndex *FIndex, DiagnosticsConsumer &DiagConsumer,
-                       bool SemanticHighlighting)
+                       bool SemanticHighlighting,
+                       std::unique_ptr<DiagnosticsCache> DiagCache)
       : FIndex(FIndex), DiagConsumer(DiagConsumer),
-        SemanticHighlighting(SemanticHighlighting) {}
+        SemanticHighlighting(SemanticHighlighting),
+        DiagCache(std::move(DiagCache)) {}
+
+  void onFileOpened(PathRef Path, llvm::StringRef Contents,
+                    PublishFn Publish) override {
+    if (!DiagCache)
+      return;
+    auto Diagnostics = DiagCache->load(Path, Contents);
+    if (!Diagnostics)
+      return;
+    vlog("Publishing {0} cached diagnostics for {1}", Diagnostics->size(),
+         Path);
+    Publish([&]() {
+      DiagConsumer.onDiagnosticsReady(Path, std::move(*Diagnostics));
+    });
+  }
 
   void onPreambleAST(PathRef Path, ASTContext &Ctx,
                      std::shared_ptr<clang::Preprocessor> PP,
@@ -66,17 +83,28 @@ struct UpdateIndexCallbacks : public ParsingCallbacks {
   }
 
   void onMainAST(PathRef Path, ParsedAST &AST, PublishFn Publish) override {
-    if (FIndex)
+    // An AST with skipped function bodies is only good for diagnostics, the
+    // complete one that follows will update the index and highlightings.
+    bool Complete = AST.getSkippedFunctionBodies().empty();
+    if (FIndex && Complete)
       FIndex->updateMain(Path, AST);
 
     std::vector<Diag> Diagnostics = AST.getDiagnostics();
+    if (DiagCache && Complete) {
+      const SourceManager &SM = AST.getSourceManager();
+      if (auto Err = DiagCache->store(
+              Path, SM.getBufferData(SM.getMainFileID()), Diagnostics))
+        elog("Failed to cache diagnostics for {0}: {1}", Path,
+             std::move(Err));
+    }
     std::vector<HighlightingToken> Highlightings;
-    if (SemanticHighlighting)
+    bool PublishHighlightings = SemanticHighlighting && Complete;
+    if (PublishHighlightings)
       Highlightings = getSemanticHighlightings(AST);
 
     Publish([&]() {
       DiagConsumer.onDiagnosticsReady(Path, std::move(Diagnostics));
-      if (SemanticHighlighting)
+      if (PublishHighlightings)
         DiagConsumer.onHighlightingsReady(Path, std::move(Highlightings));
     });
   }
@@ -94,6 +122,7 @@ private:
   FileIndex *FIndex;
   DiagnosticsConsumer &DiagConsumer;
   bool SemanticHighlighting;
+  std::unique_ptr<DiagnosticsCache> DiagCache;
 };
 } // namespace
 
@@ -116,6 +145,7 @@ ClangdServer::ClangdServer(const GlobalCompilationDatabase &CDB,
                      : nullptr),
       GetClangTidyOptions(Opts.GetClangTidyOptions),
       SuggestMissingIncludes(Opts.SuggestMissingIncludes),
+      SkipUnchangedFunctionBodies(Opts.SkipUnchangedFunctionBodies),
       TweakFilter(Opts.TweakFilter), WorkspaceRoot(Opts.WorkspaceRoot),
       // Pass a callback into `WorkScheduler` to extract symbols from a newly
       // parsed file and rebuild the file index synchronously each time an AST
@@ -125,7 +155,10 @@ ClangdServer::ClangdServer(const GlobalCompilationDatabase &CDB,
       WorkScheduler(
           CDB, Opts.AsyncThreadsCount, Opts.StorePreamblesInMemory,
           std::make_unique<UpdateIndexCallbacks>(
-              DynamicIdx.get(), DiagConsumer, Opts.SemanticHighlighting),
+              DynamicIdx.get(), DiagConsumer, Opts.SemanticHighlighting,
+              Opts.DiagnosticsCacheDir ? std::make_unique<DiagnosticsCache>(
+                                             *Opts.DiagnosticsCacheDir)
+                                       : nullptr),
           Opts.UpdateDebounce, Opts.RetentionPolicy) {
   // Adds an index to the stack, at higher priority than existing indexes.
   auto AddIndex = [&](SymbolIndex *Idx) {
@@ -160,6 +193,7 @@ void ClangdServer::addDocument(PathRef File, llvm::StringRef Contents,
   if (GetClangTidyOptions)
     Opts.ClangTidyOpts = GetClangTidyOptions(*FS, File);
   Opts.SuggestMissingIncludes = SuggestMissingIncludes;
+  Opts.SkipUnchangedFunctionBodies = SkipUnchangedFunctionBodies;
 
   // Compile command is set asynchronously during update, as it can be slow.
   ParseInputs Inputs;
@@ -173,7 +207,13 @@ void ClangdServer::addDocument(PathRef File, llvm::StringRef Contents,
     BackgroundIdx->boostRelated(File);
 }
 
-void ClangdServer::removeDocument(PathRef File) { WorkScheduler.remove(File); }
+void ClangdServer::removeDocument(PathRef File) {
+  {
+    std::lock_guard<std::mutex> Lock(CachedCompletionMutex);
+    CachedCompletionByFile.erase(File);
+  }
+  WorkScheduler.remove(File);
+}
 
 llvm::StringRef ClangdServer::getDocument(PathRef File) const {
   return WorkScheduler.getContents(File);
@@ -211,11 +251,21 @@ void ClangdServer::codeComplete(PathRef File, Position Pos,
         }
       }
     }
+    CachedCodeCompletion Cache;
+    if (CodeCompleteOpts.ReusePreviousResults) {
+      std::lock_guard<std::mutex> Lock(CachedCompletionMutex);
+      Cache = std::move(CachedCompletionByFile[File]);
+    }
     // FIXME(ibiryukov): even if Preamble is non-null, we may want to check
     // both the old and the new version in case only one of them matches.
     CodeCompleteResult Result = clangd::codeComplete(
         File, IP->Command, IP->Preamble, IP->Contents, Pos, FS,
-        CodeCompleteOpts, SpecFuzzyFind ? SpecFuzzyFind.getPointer() : nullptr);
+        CodeCompleteOpts, SpecFuzzyFind ? SpecFuzzyFind.getPointer() : nullptr,
+        &Cache);
+    if (CodeCompleteOpts.ReusePreviousResults) {
+      std::lock_guard<std::mutex> Lock(CachedCompletionMutex);
+      CachedCompletionByFile[File] = std::move(Cache);
+    }
     {
       clang::clangd::trace::Span Tracer("Completion results callback");
       CB(std::move(Result));
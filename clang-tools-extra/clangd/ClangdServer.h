@@ -127,6 +127,14 @@ public:
 
     bool SuggestMissingIncludes = false;
 
+    /// If set, the last diagnostics of each file are stored in this directory,
+    /// and published right away when the file is opened again unchanged.
+    llvm::Optional<std::string> DiagnosticsCacheDir;
+
+    /// Publish diagnostics for an edited file from a quick reparse that skips
+    /// unchanged function bodies, before building the complete AST.
+    bool SkipUnchangedFunctionBodies = false;
+
     /// Clangd will execute compiler drivers matching one of these globs to
     /// fetch system include path.
     std::vector<std::string> QueryDriverGlobs;
@@ -323,6 +331,10 @@ private:
   // can be caused by missing includes (e.g. member access in incomplete type).
   bool SuggestMissingIncludes = false;
 
+  // If this is true, diagnostics for edited files are first computed by a
+  // quick reparse skipping the unchanged function bodies.
+  bool SkipUnchangedFunctionBodies = false;
+
   std::function<bool(const Tweak &)> TweakFilter;
 
   // GUARDED_BY(CachedCompletionFuzzyFindRequestMutex)
@@ -330,6 +342,10 @@ private:
       CachedCompletionFuzzyFindRequestByFile;
   mutable std::mutex CachedCompletionFuzzyFindRequestMutex;
 
+  // GUARDED_BY(CachedCompletionMutex)
+  llvm::StringMap<CachedCodeCompletion> CachedCompletionByFile;
+  mutable std::mutex CachedCompletionMutex;
+
   llvm::Optional<std::string> WorkspaceRoot;
   // WorkScheduler has to be the last member, because its destructor has to be
   // called before all other members to stop the worker thread that references
@@ -1202,6 +1202,7 @@ class CodeCompleteFlow {
   PathRef FileName;
   IncludeStructure Includes;           // Complete once the compiler runs.
   SpeculativeFuzzyFind *SpecFuzzyFind; // Can be nullptr.
+  CachedCodeCompletion *Cache;         // Can be nullptr.
   const CodeCompleteOptions &Opts;
 
   // Sema takes ownership of Recorder. Recorder is valid until Sema cleanup.
@@ -1229,14 +1230,17 @@ class CodeCompleteFlow {
   /// Initialized right before sema run. This is only set if `SpecFuzzyFind` is
   /// set and contains a cached request.
   llvm::Optional<FuzzyFindRequest> SpecReq;
+  // Filtering data of the returned completions. Only filled if Cache is set.
+  std::vector<CachedCodeCompletion::Item> ResultItems;
 
 public:
   // A CodeCompleteFlow object is only useful for calling run() exactly once.
   CodeCompleteFlow(PathRef FileName, const IncludeStructure &Includes,
                    SpeculativeFuzzyFind *SpecFuzzyFind,
+                   CachedCodeCompletion *Cache,
                    const CodeCompleteOptions &Opts)
       : FileName(FileName), Includes(Includes), SpecFuzzyFind(SpecFuzzyFind),
-        Opts(Opts) {}
+        Cache(Cache), Opts(Opts) {}
 
   CodeCompleteResult run(const SemaCompleteInput &SemaCCInput) && {
     trace::Span Tracer("CodeCompleteFlow");
@@ -1304,6 +1308,8 @@ public:
     semaCodeComplete(std::move(RecorderOwner), Opts.getClangCompleteOpts(),
                      SemaCCInput, &Includes);
     logResults(Output, Tracer);
+    if (Cache)
+      updateCache(Output, SemaCCInput);
     return Output;
   }
 
@@ -1388,6 +1394,26 @@ public:
   }
 
 private:
+  // Keeps the results for the next completion, if they can be reused.
+  void updateCache(const CodeCompleteResult &Output,
+                   const SemaCompleteInput &SemaCCInput) {
+    *Cache = CachedCodeCompletion();
+    // Results that were truncated may lack some of the next ones. Sema might
+    // also have seen a different identifier than we did.
+    if (!Filter || Output.HasMore || Filter->pattern() != HeuristicPrefix.Name)
+      return;
+    assert(ResultItems.size() == Output.Completions.size());
+    Cache->Preamble = SemaCCInput.Preamble;
+    Cache->Index = Opts.Index;
+    Cache->Limit = Opts.Limit;
+    Cache->Contents = SemaCCInput.Contents.str();
+    Cache->FilterOffset =
+        HeuristicPrefix.Name.begin() - SemaCCInput.Contents.begin();
+    Cache->Filter = HeuristicPrefix.Name.str();
+    Cache->Result = Output;
+    Cache->Items = std::move(ResultItems);
+  }
+
   void populateContextWords(llvm::StringRef Content) {
     // Take last 3 lines before the completion point.
     unsigned RangeEnd = HeuristicPrefix.Qualifier.begin() - Content.data(),
@@ -1458,6 +1484,13 @@ private:
       Output.Completions.push_back(toCodeCompletion(C.first));
       Output.Completions.back().Score = C.second;
       Output.Completions.back().CompletionTokenRange = ReplacedRange;
+      if (Cache) {
+        const CompletionCandidate &First = C.first.front();
+        ResultItems.push_back(
+            {First.Name.str(),
+             First.SemaResult &&
+                 First.SemaResult->Kind == CodeCompletionResult::RK_Macro});
+      }
     }
     Output.HasMore = Incomplete;
     Output.Context = CCContextKind;
@@ -1720,20 +1753,104 @@ CompletionPrefix guessCompletionPrefix(llvm::StringRef Content,
   return Result;
 }
 
+// Computes the completions at Offset from the cached ones, if the only edit
+// since is that the identifier being completed got longer: the new results are
+// then the cached ones that still match, with the new name match factored into
+// their scores. Updates the cache on success.
+static llvm::Optional<CodeCompleteResult>
+reuseCachedCompletion(CachedCodeCompletion &Cache,
+                      const PreambleData *Preamble, llvm::StringRef Contents,
+                      size_t Offset, const CodeCompleteOptions &Opts) {
+  if (!Cache.Preamble || Cache.Preamble != Preamble ||
+      Cache.Index != Opts.Index || Cache.Limit != Opts.Limit)
+    return None;
+  CompletionPrefix Prefix = guessCompletionPrefix(Contents, Offset);
+  size_t FilterOffset = Prefix.Name.begin() - Contents.begin();
+  llvm::StringRef CachedContents = Cache.Contents;
+  if (FilterOffset != Cache.FilterOffset ||
+      !Prefix.Name.startswith(Cache.Filter) ||
+      Contents.take_front(FilterOffset) !=
+          CachedContents.take_front(FilterOffset) ||
+      Contents.drop_front(Offset) !=
+          CachedContents.drop_front(FilterOffset + Cache.Filter.size()))
+    return None;
+
+  trace::Span Tracer("ReuseCachedCompletion");
+  FuzzyMatcher CachedFilter(Cache.Filter), Filter(Prefix.Name);
+  unsigned Typed = Prefix.Name.size() - Cache.Filter.size();
+  using ItemMatch = std::pair<CodeCompletion, CachedCodeCompletion::Item>;
+  std::vector<ItemMatch> Matches;
+  for (size_t I = 0, E = Cache.Items.size(); I < E; ++I) {
+    const CachedCodeCompletion::Item &Item = Cache.Items[I];
+    // Same rules as CodeCompleteFlow::fuzzyScore().
+    if (Item.PrefixMatchOnly &&
+        !llvm::StringRef(Item.FilterName).startswith_lower(Prefix.Name))
+      continue;
+    llvm::Optional<float> NameMatch = Filter.match(Item.FilterName);
+    if (!NameMatch)
+      continue;
+    // NameMatch is a multiplier on the relevance and the total score.
+    llvm::Optional<float> CachedNameMatch =
+        CachedFilter.match(Item.FilterName);
+    if (!CachedNameMatch || *CachedNameMatch == 0)
+      return None;
+    CodeCompletion C = Cache.Result.Completions[I];
+    C.Score.Relevance = C.Score.Relevance / *CachedNameMatch * *NameMatch;
+    C.Score.Total = C.Score.Total / *CachedNameMatch * *NameMatch;
+    C.CompletionTokenRange.end.character += Typed;
+    Matches.emplace_back(std::move(C), Item);
+  }
+  // Same order as ScoredBundleGreater.
+  llvm::sort(Matches, [](const ItemMatch &L, const ItemMatch &R) {
+    if (L.first.Score.Total != R.first.Score.Total)
+      return L.first.Score.Total > R.first.Score.Total;
+    return L.second.FilterName < R.second.FilterName;
+  });
+
+  CodeCompleteResult Output;
+  Output.Context = Cache.Result.Context;
+  std::vector<CachedCodeCompletion::Item> Items;
+  for (auto &M : Matches) {
+    Output.Completions.push_back(std::move(M.first));
+    Items.push_back(std::move(M.second));
+  }
+  SPAN_ATTACH(Tracer, "cached_results", int64_t(Cache.Items.size()));
+  SPAN_ATTACH(Tracer, "returned_results", int64_t(Output.Completions.size()));
+  log("Code complete: reused {0} results of the previous completion, "
+      "{1} returned.",
+      Cache.Items.size(), Output.Completions.size());
+
+  Cache.Contents = Contents.str();
+  Cache.Filter = Prefix.Name.str();
+  Cache.Result = Output;
+  Cache.Items = std::move(Items);
+  return Output;
+}
+
 CodeCompleteResult
 codeComplete(PathRef FileName, const tooling::CompileCommand &Command,
              const PreambleData *Preamble, llvm::StringRef Contents,
              Position Pos, llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS,
-             CodeCompleteOptions Opts, SpeculativeFuzzyFind *SpecFuzzyFind) {
+             CodeCompleteOptions Opts, SpeculativeFuzzyFind *SpecFuzzyFind,
+             CachedCodeCompletion *Cache) {
   auto Offset = positionToOffset(Contents, Pos);
   if (!Offset) {
     elog("Code completion position was invalid {0}", Offset.takeError());
     return CodeCompleteResult();
   }
+  bool RunParser =
+      Preamble && Opts.RunParser != CodeCompleteOptions::NeverParse;
+  // Only results from Sema are cached.
+  if (!Opts.ReusePreviousResults || !RunParser)
+    Cache = nullptr;
+  if (Cache)
+    if (auto Reused =
+            reuseCachedCompletion(*Cache, Preamble, Contents, *Offset, Opts))
+      return std::move(*Reused);
   auto Flow = CodeCompleteFlow(
       FileName, Preamble ? Preamble->Includes : IncludeStructure(),
-      SpecFuzzyFind, Opts);
-  return (!Preamble || Opts.RunParser == CodeCompleteOptions::NeverParse)
+      SpecFuzzyFind, Cache, Opts);
+  return !RunParser
              ? std::move(Flow).runWithoutSema(Contents, *Offset, VFS)
              : std::move(Flow).run(
                    {FileName, Command, Preamble, Contents, *Offset, VFS});
@@ -95,6 +95,14 @@ struct CodeCompleteOptions {
   /// this should be effective for a number of code completions.
   bool SpeculativeIndexRequest = false;
 
+  /// If set to true, the results of a code completion are kept, and a
+  /// following completion at the same point, after the user typed more
+  /// characters of the identifier and made no other edit, is answered by
+  /// refiltering and rescoring them instead of running Sema again.
+  /// This is only done when the previous results were complete (i.e. not
+  /// truncated by `Limit`), as they then include all the new ones.
+  bool ReusePreviousResults = false;
+
   // Populated internally by clangd, do not set.
   /// If `Index` is set, it is used to augment the code completion
   /// results.
@@ -237,6 +245,33 @@ struct SpeculativeFuzzyFind {
   std::future<SymbolSlab> Result;
 };
 
+/// The results of the last code completion in a file, along with what they
+/// were computed from, to answer the next completion if it only differs by a
+/// longer identifier (see `CodeCompleteOptions::ReusePreviousResults`).
+/// Set by `codeComplete()`; callers only need to keep it around.
+struct CachedCodeCompletion {
+  /// The data about a completion item that is needed to filter it again.
+  struct Item {
+    /// The name the item was filtered and sorted by.
+    std::string FilterName;
+    /// Whether the item only matches names starting with the filter (macros).
+    bool PrefixMatchOnly = false;
+  };
+
+  /// Only compared by address, never dereferenced.
+  const PreambleData *Preamble = nullptr;
+  const SymbolIndex *Index = nullptr;
+  size_t Limit = 0;
+  std::string Contents;
+  /// The offset of the typed identifier in Contents.
+  size_t FilterOffset = 0;
+  /// The typed identifier, which ends at the completion point.
+  std::string Filter;
+  CodeCompleteResult Result;
+  /// Parallel to Result.Completions.
+  std::vector<Item> Items;
+};
+
 /// Gets code completions at a specified \p Pos in \p FileName.
 ///
 /// If \p Preamble is nullptr, this runs code completion without compiling the
@@ -247,13 +282,17 @@ struct SpeculativeFuzzyFind {
 /// the speculative result is used by code completion (e.g. speculation failed),
 /// the speculative result is not consumed, and `SpecFuzzyFind` is only
 /// destroyed when the async request finishes.
+///
+/// If \p Cache is set and `Opts.ReusePreviousResults` is true, the results may
+/// be computed from the cached ones, and the cache is updated.
 CodeCompleteResult codeComplete(PathRef FileName,
                                 const tooling::CompileCommand &Command,
                                 const PreambleData *Preamble,
                                 StringRef Contents, Position Pos,
                                 IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS,
                                 CodeCompleteOptions Opts,
-                                SpeculativeFuzzyFind *SpecFuzzyFind = nullptr);
+                                SpeculativeFuzzyFind *SpecFuzzyFind = nullptr,
+                                CachedCodeCompletion *Cache = nullptr);
 
 /// Get signature help at a specified \p Pos in \p FileName.
 SignatureHelp signatureHelp(PathRef FileName,
@@ -38,6 +38,9 @@ public:
 struct ParseOptions {
   tidy::ClangTidyOptions ClangTidyOpts;
   bool SuggestMissingIncludes = false;
+  /// When the main file changes, first parse it skipping the bodies of the
+  /// functions that the edit did not touch, and publish diagnostics from that.
+  bool SkipUnchangedFunctionBodies = false;
 };
 
 /// Information required to run clang, e.g. to parse AST or do code completion.
@@ -0,0 +1,199 @@
+//===--- DiagnosticsCache.cpp - Diagnostics persisted across runs -*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "DiagnosticsCache.h"
+#include "Logger.h"
+#include "Protocol.h"
+#include "SourceCode.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+
+namespace clang {
+namespace clangd {
+
+// Bump whenever the format of the stored diagnostics changes.
+static constexpr int64_t FormatVersion = 1;
+
+// The serialization functions are found by ADL from llvm::json, so they can't
+// live in an anonymous namespace.
+
+static void toJSON(const DiagBase &D, llvm::json::Object &O) {
+  O["message"] = D.Message;
+  O["file"] = D.File;
+  if (D.AbsFile)
+    O["absFile"] = *D.AbsFile;
+  O["range"] = D.Range;
+  O["severity"] = static_cast<int64_t>(D.Severity);
+  O["category"] = D.Category;
+  O["insideMainFile"] = D.InsideMainFile;
+}
+
+static bool fromJSON(const llvm::json::Value &V, DiagBase &D) {
+  const llvm::json::Object *O = V.getAsObject();
+  if (!O)
+    return false;
+  llvm::json::ObjectMapper M(V);
+  int64_t Severity;
+  if (!M || !M.map("message", D.Message) || !M.map("file", D.File) ||
+      !M.map("range", D.Range) || !M.map("severity", Severity) ||
+      !M.map("category", D.Category) ||
+      !M.map("insideMainFile", D.InsideMainFile))
+    return false;
+  if (auto AbsFile = O->getString("absFile"))
+    D.AbsFile = AbsFile->str();
+  D.Severity = static_cast<DiagnosticsEngine::Level>(Severity);
+  return true;
+}
+
+static llvm::json::Value toJSON(const Note &N) {
+  llvm::json::Object O;
+  toJSON(N, O);
+  return std::move(O);
+}
+
+static bool fromJSON(const llvm::json::Value &V, Note &N) {
+  return fromJSON(V, static_cast<DiagBase &>(N));
+}
+
+static llvm::json::Value toJSON(const Fix &F) {
+  return llvm::json::Object{{"message", F.Message},
+                            {"edits", llvm::json::Array(F.Edits)}};
+}
+
+static bool fromJSON(const llvm::json::Value &V, Fix &F) {
+  llvm::json::ObjectMapper M(V);
+  std::vector<TextEdit> Edits;
+  if (!M || !M.map("message", F.Message) || !M.map("edits", Edits))
+    return false;
+  F.Edits.assign(Edits.begin(), Edits.end());
+  return true;
+}
+
+static llvm::json::Value toJSON(const Diag &D) {
+  llvm::json::Object O;
+  toJSON(D, O);
+  O["id"] = static_cast<int64_t>(D.ID);
+  O["name"] = D.Name;
+  O["source"] = static_cast<int64_t>(D.Source);
+  O["notes"] = llvm::json::Array(D.Notes);
+  O["fixes"] = llvm::json::Array(D.Fixes);
+  return std::move(O);
+}
+
+static bool fromJSON(const llvm::json::Value &V, Diag &D) {
+  llvm::json::ObjectMapper M(V);
+  int64_t ID, Source;
+  if (!fromJSON(V, static_cast<DiagBase &>(D)) || !M.map("id", ID) ||
+      !M.map("name", D.Name) || !M.map("source", Source) ||
+      !M.map("notes", D.Notes) || !M.map("fixes", D.Fixes))
+    return false;
+  D.ID = ID;
+  switch (Source) {
+  case Diag::Clang:
+    D.Source = Diag::Clang;
+    break;
+  case Diag::ClangTidy:
+    D.Source = Diag::ClangTidy;
+    break;
+  default:
+    D.Source = Diag::Unknown;
+    break;
+  }
+  return true;
+}
+
+namespace {
+
+// FIXME: share with the background index storage.
+llvm::Error
+writeAtomically(llvm::StringRef OutPath,
+                llvm::function_ref<void(llvm::raw_ostream &)> Writer) {
+  // Write to a temporary file first.
+  llvm::SmallString<128> TempPath;
+  int FD;
+  auto EC =
+      llvm::sys::fs::createUniqueFile(OutPath + ".tmp.%%%%%%%%", FD, TempPath);
+  if (EC)
+    return llvm::errorCodeToError(EC);
+  // Make sure temp file is destroyed on failure.
+  auto RemoveOnFail =
+      llvm::make_scope_exit([TempPath] { llvm::sys::fs::remove(TempPath); });
+  llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+  Writer(OS);
+  OS.close();
+  if (OS.has_error())
+    return llvm::errorCodeToError(OS.error());
+  // Then move to real location.
+  EC = llvm::sys::fs::rename(TempPath, OutPath);
+  if (EC)
+    return llvm::errorCodeToError(EC);
+  RemoveOnFail.release();
+  return llvm::Error::success();
+}
+
+} // namespace
+
+DiagnosticsCache::DiagnosticsCache(llvm::StringRef Directory)
+    : Directory(Directory) {
+  if (std::error_code EC = llvm::sys::fs::create_directories(Directory))
+    elog("Failed to create directory {0} for diagnostics cache: {1}",
+         Directory, EC.message());
+}
+
+std::string DiagnosticsCache::pathFor(PathRef File) const {
+  llvm::SmallString<128> Result(Directory);
+  llvm::sys::path::append(Result, llvm::sys::path::filename(File) + "." +
+                                      llvm::toHex(digest(File)) + ".diags");
+  return Result.str();
+}
+
+llvm::Optional<std::vector<Diag>>
+DiagnosticsCache::load(PathRef File, llvm::StringRef Contents) const {
+  auto Buffer = llvm::MemoryBuffer::getFile(pathFor(File));
+  if (!Buffer)
+    return None;
+  auto Parsed = llvm::json::parse(Buffer->get()->getBuffer());
+  if (!Parsed) {
+    elog("Malformed cached diagnostics for {0}: {1}", File,
+         Parsed.takeError());
+    return None;
+  }
+  const llvm::json::Object *O = Parsed->getAsObject();
+  if (!O || O->getInteger("version") != FormatVersion ||
+      O->getString("file") != llvm::StringRef(File) ||
+      O->getString("digest") != llvm::StringRef(llvm::toHex(digest(Contents))))
+    return None;
+  std::vector<Diag> Result;
+  const llvm::json::Value *Diags = O->get("diagnostics");
+  if (!Diags || !fromJSON(*Diags, Result)) {
+    elog("Malformed cached diagnostics for {0}", File);
+    return None;
+  }
+  return Result;
+}
+
+llvm::Error DiagnosticsCache::store(PathRef File, llvm::StringRef Contents,
+                                    llvm::ArrayRef<Diag> Diags) const {
+  llvm::json::Object O{
+      {"version", FormatVersion},
+      {"file", File},
+      {"digest", llvm::toHex(digest(Contents))},
+      {"diagnostics", llvm::json::Array(Diags)},
+  };
+  return writeAtomically(pathFor(File), [&](llvm::raw_ostream &OS) {
+    OS << llvm::json::Value(std::move(O));
+  });
+}
+
+} // namespace clangd
+} // namespace clang
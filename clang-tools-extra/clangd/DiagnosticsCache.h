@@ -0,0 +1,58 @@
+//===--- DiagnosticsCache.h - Diagnostics persisted across runs --*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Keeps the last diagnostics of each file on disk, so that reopening a file
+// after clangd restarts can show them right away, while the first build of the
+// file is still running.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_DIAGNOSTICSCACHE_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_DIAGNOSTICSCACHE_H
+
+#include "Diagnostics.h"
+#include "Path.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include <string>
+#include <vector>
+
+namespace clang {
+namespace clangd {
+
+/// Stores diagnostics of main files in a directory, one file per source file.
+/// Entries are only returned for the exact contents they were computed from.
+/// Headers and compile flags are not tracked, so loaded diagnostics may be
+/// stale and should be replaced by the next build.
+/// Thread-safe, as long as each source file is only stored from one thread.
+class DiagnosticsCache {
+public:
+  /// Creates \p Directory if it doesn't exist.
+  explicit DiagnosticsCache(llvm::StringRef Directory);
+
+  /// Returns the diagnostics stored for \p File, if they were computed from
+  /// \p Contents.
+  llvm::Optional<std::vector<Diag>> load(PathRef File,
+                                         llvm::StringRef Contents) const;
+
+  /// Replaces the diagnostics stored for \p File.
+  llvm::Error store(PathRef File, llvm::StringRef Contents,
+                    llvm::ArrayRef<Diag> Diags) const;
+
+private:
+  std::string pathFor(PathRef File) const;
+
+  std::string Directory;
+};
+
+} // namespace clangd
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANGD_DIAGNOSTICSCACHE_H
@@ -185,16 +185,24 @@ bool FuzzyMatcher::init(llvm::StringRef NewWord) {
   std::copy(NewWord.begin(), NewWord.begin() + WordN, Word);
   if (PatN == 0)
     return true;
-  for (int I = 0; I < WordN; ++I)
-    LowWord[I] = lower(Word[I]);
 
-  // Cheap subsequence check.
-  for (int W = 0, P = 0; P != PatN; ++W) {
-    if (W == WordN)
+  // Cheap subsequence check, done while lowercasing as it rejects most words.
+  // Matching greedily from the front finds the earliest position for each
+  // pattern character.
+  int P = 0;
+  for (int W = 0; W < WordN; ++W) {
+    if (WordN - W < PatN - P)
       return false;
-    if (LowWord[W] == LowPat[P])
-      ++P;
+    LowWord[W] = lower(Word[W]);
+    if (P < PatN && LowWord[W] == LowPat[P])
+      MatchBegin[P++] = W;
   }
+  if (P != PatN)
+    return false;
+  // And from the back, the latest one.
+  for (int W = WordN - 1; P > 0; --W)
+    if (LowWord[W] == LowPat[P - 1])
+      MatchEnd[--P] = W;
 
   // FIXME: some words are hard to tokenize algorithmically.
   // e.g. vsprintf is V S Print F, and should match [pri] but not [int].
@@ -213,14 +221,21 @@ bool FuzzyMatcher::init(llvm::StringRef NewWord) {
 // and 3 being a great one. So we treat the score range as [0, 3 * PatN].
 // This range is not strict: we can apply larger bonuses/penalties, or penalize
 // non-matched characters.
+//
+// Only cells that can be on a complete match are filled: matching Pat[..P]
+// needs at least MatchBegin[P] + 1 characters of Word, and its Match state is
+// useless past MatchEnd[P]. The next row never reads beyond MatchEnd[P + 1].
 void FuzzyMatcher::buildGraph() {
-  for (int W = 0; W < WordN; ++W) {
+  for (int W = 0; W < MatchEnd[0]; ++W) {
     Scores[0][W + 1][Miss] = {Scores[0][W][Miss].Score - skipPenalty(W, Miss),
                               Miss};
     Scores[0][W + 1][Match] = {AwfulScore, Miss};
   }
   for (int P = 0; P < PatN; ++P) {
-    for (int W = P; W < WordN; ++W) {
+    int Begin = MatchBegin[P], End = P + 1 < PatN ? MatchEnd[P + 1] : WordN;
+    Scores[P + 1][Begin][Miss] = Scores[P + 1][Begin][Match] = {AwfulScore,
+                                                                 Miss};
+    for (int W = Begin; W < End; ++W) {
       auto &Score = Scores[P + 1][W + 1], &PreMiss = Scores[P + 1][W];
 
       auto MatchMissScore = PreMiss[Match].Score;
@@ -233,6 +248,10 @@ void FuzzyMatcher::buildGraph() {
                         ? ScoreInfo{MatchMissScore, Match}
                         : ScoreInfo{MissMissScore, Miss};
 
+      if (W > MatchEnd[P]) {
+        Score[Match] = {AwfulScore, Miss};
+        continue;
+      }
       auto &PreMatch = Scores[P][W];
       auto MatchMatchScore =
           allowMatch(P, W, Match)
@@ -248,6 +267,13 @@ void FuzzyMatcher::buildGraph() {
   }
 }
 
+// Whether buildGraph() filled Scores[P][W] for the last word.
+bool FuzzyMatcher::inBand(int P, int W) const {
+  if (P == 0)
+    return W <= MatchEnd[0];
+  return W >= MatchBegin[P - 1] && W <= (P < PatN ? MatchEnd[P] : WordN);
+}
+
 bool FuzzyMatcher::allowMatch(int P, int W, Action Last) const {
   if (LowPat[P] != LowWord[W])
     return false;
@@ -322,7 +348,9 @@ llvm::SmallString<256> FuzzyMatcher::dumpLast(llvm::raw_ostream &OS) const {
     return Result;
   } else if (isAwful(std::max(Scores[PatN][WordN][Match].Score,
                               Scores[PatN][WordN][Miss].Score))) {
+    // There is no path to trace back, and the table is not fully populated.
     OS << "Substring check passed, but all matches are forbidden\n";
+    return Result;
   }
   if (!(PatTypeSet & 1 << Upper))
     OS << "Lowercase query, so scoring ignores case\n";
@@ -384,7 +412,7 @@ llvm::SmallString<256> FuzzyMatcher::dumpLast(llvm::raw_ostream &OS) const {
     for (Action A : {Miss, Match}) {
       OS << ((I && A == Miss) ? Pat[I - 1] : ' ') << "|";
       for (int J = 0; J <= WordN; ++J) {
-        if (!isAwful(Scores[I][J][A].Score))
+        if (inBand(I, J) && !isAwful(Scores[I][J][A].Score))
           OS << llvm::format("%3d%c", Scores[I][J][A].Score,
                              Scores[I][J][A].Prev == Match ? '*' : ' ');
         else
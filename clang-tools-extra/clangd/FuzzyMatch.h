@@ -100,6 +100,7 @@ private:
 
   bool init(llvm::StringRef Word);
   void buildGraph();
+  bool inBand(int P, int W) const;
   bool allowMatch(int P, int W, Action Last) const;
   int skipPenalty(int W, Action Last) const;
   int matchBonus(int P, int W, Action Last) const;
@@ -119,6 +120,10 @@ private:
   CharRole WordRole[MaxWord]; // Word segmentation info
   CharTypeSet WordTypeSet;    // Bitmask of 1<<CharType for all Word characters
   bool WordContainsPattern;   // Simple substring check
+  // Earliest and latest positions in Word where each pattern character can be
+  // matched, ignoring scoring. buildGraph() only fills cells between them.
+  int MatchBegin[MaxPat];
+  int MatchEnd[MaxPat];
 
   // Cumulative best-match score table.
   // Boundary conditions are filled in by the constructor.
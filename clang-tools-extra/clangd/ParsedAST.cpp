@@ -21,6 +21,7 @@
 #include "index/Index.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Decl.h"
+#include "clang/AST/RecursiveASTVisitor.h"
 #include "clang/Basic/LangOptions.h"
 #include "clang/Basic/SourceLocation.h"
 #include "clang/Basic/SourceManager.h"
@@ -42,11 +43,13 @@
 #include "clang/Tooling/CompilationDatabase.h"
 #include "clang/Tooling/Syntax/Tokens.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <limits>
 #include <memory>
 
 namespace clang {
@@ -57,10 +60,214 @@ template <class T> std::size_t getUsedBytes(const std::vector<T> &Vec) {
   return Vec.capacity() * sizeof(T);
 }
 
+// The 0-based line of \p Loc, if it is spelled directly in the main file.
+llvm::Optional<unsigned> mainFileLine(SourceLocation Loc,
+                                      const SourceManager &SM) {
+  if (Loc.isInvalid() || !Loc.isFileID())
+    return None;
+  auto Decomposed = SM.getDecomposedLoc(Loc);
+  if (Decomposed.first != SM.getMainFileID())
+    return None;
+  return SM.getLineNumber(Decomposed.first, Decomposed.second) - 1;
+}
+
+// Lines of the main file that were touched by an edit. Lines before FirstLine
+// are the same in both versions, and so are lines starting at OldEndLine in the
+// old version and at NewEndLine in the new one.
+struct EditedLines {
+  unsigned FirstLine;
+  unsigned OldEndLine;
+  unsigned NewEndLine;
+};
+
+EditedLines diffLines(llvm::StringRef Old, llvm::StringRef New) {
+  size_t MaxCommon = std::min(Old.size(), New.size());
+  size_t Prefix = 0;
+  while (Prefix < MaxCommon && Old[Prefix] == New[Prefix])
+    ++Prefix;
+  // Only keep complete lines in the common prefix.
+  while (Prefix > 0 && Old[Prefix - 1] != '\n')
+    --Prefix;
+  size_t CommonSuffix = 0;
+  while (CommonSuffix < MaxCommon - Prefix &&
+         Old[Old.size() - CommonSuffix - 1] == New[New.size() - CommonSuffix - 1])
+    ++CommonSuffix;
+  // Same for the suffix: it must start at the beginning of a line in both
+  // versions.
+  size_t Suffix = CommonSuffix;
+  auto StartsLine = [&](llvm::StringRef Text) {
+    size_t Start = Text.size() - Suffix;
+    return Start == Prefix || Text[Start - 1] == '\n';
+  };
+  while (Suffix > 0 && !(StartsLine(Old) && StartsLine(New)))
+    --Suffix;
+
+  EditedLines Result;
+  Result.FirstLine = Old.take_front(Prefix).count('\n');
+  if (Suffix == 0) {
+    // The edit extends to the end of the file.
+    Result.OldEndLine = Result.NewEndLine =
+        std::numeric_limits<unsigned>::max();
+  } else {
+    Result.OldEndLine = Old.drop_back(Suffix).count('\n');
+    Result.NewEndLine = New.drop_back(Suffix).count('\n');
+  }
+  return Result;
+}
+
+// Whether a diagnostic can be wrong when some function bodies were skipped,
+// because it depends on what the bodies use: clang-tidy checks, and warnings
+// about unused, unneeded or undefined declarations.
+bool dependsOnFunctionBodies(const Diag &D) {
+  if (D.Source == Diag::ClangTidy)
+    return true;
+  if (D.Source != Diag::Clang)
+    return false;
+  llvm::StringRef Flag = DiagnosticIDs::getWarningOptionForDiag(D.ID);
+  return Flag.startswith("unused") || Flag.startswith("unneeded-") ||
+         Flag == "undefined-internal" || Flag == "undefined-inline";
+}
+
+// Decides which function bodies need not be parsed again, because they lie
+// outside of the lines edited since the previous build. Functions are matched
+// against the previous build by the (shifted) line of their name.
+class FunctionBodySkipper {
+public:
+  FunctionBodySkipper(const PreviousBuild &Previous, llvm::StringRef Contents)
+      : Previous(Previous), Edit(diffLines(Previous.Contents, Contents)) {
+    for (const FunctionBodyLines &Body : Previous.FunctionBodies) {
+      auto It = ByDeclLine.try_emplace(Body.DeclLine, &Body);
+      // Never guess between several functions declared on the same line.
+      if (!It.second)
+        It.first->second = nullptr;
+    }
+  }
+
+  bool shouldSkip(const Decl *D) {
+    auto Line = mainFileLine(D->getLocation(),
+                             D->getASTContext().getSourceManager());
+    if (!Line)
+      return false;
+    unsigned OldLine;
+    if (*Line < Edit.FirstLine)
+      OldLine = *Line;
+    else if (*Line >= Edit.NewEndLine &&
+             Edit.NewEndLine != std::numeric_limits<unsigned>::max())
+      OldLine = *Line - Edit.NewEndLine + Edit.OldEndLine;
+    else
+      return false;
+    auto It = ByDeclLine.find(OldLine);
+    if (It == ByDeclLine.end() || !It->second)
+      return false;
+    const FunctionBodyLines &Old = *It->second;
+    FunctionBodyLines New = Old;
+    New.DeclLine = *Line;
+    if (Old.LastLine < Edit.FirstLine) {
+      // Nothing moved.
+    } else if (Old.FirstLine >= Edit.OldEndLine) {
+      New.FirstLine = Old.FirstLine - Edit.OldEndLine + Edit.NewEndLine;
+      New.LastLine = Old.LastLine - Edit.OldEndLine + Edit.NewEndLine;
+    } else {
+      return false;
+    }
+    Skipped.push_back({&Old, New});
+    return true;
+  }
+
+  std::vector<FunctionBodyLines> skippedBodies() const {
+    std::vector<FunctionBodyLines> Result;
+    for (const auto &S : Skipped)
+      Result.push_back(S.second);
+    return Result;
+  }
+
+  // Diagnostics of the previous build that were entirely inside one of the
+  // skipped bodies, moved to the body's new location.
+  std::vector<Diag> carriedOverDiags() const {
+    std::vector<Diag> Result;
+    for (const Diag &D : Previous.Diags) {
+      if (!D.InsideMainFile)
+        continue;
+      for (const auto &S : Skipped) {
+        const FunctionBodyLines &Old = *S.first;
+        auto Inside = [&](const Range &R) {
+          return Old.FirstLine <= static_cast<unsigned>(R.start.line) &&
+                 static_cast<unsigned>(R.end.line) <= Old.LastLine;
+        };
+        if (!Inside(D.Range) ||
+            llvm::any_of(D.Notes,
+                         [&](const Note &N) {
+                           return N.InsideMainFile && !Inside(N.Range);
+                         }) ||
+            llvm::any_of(D.Fixes, [&](const Fix &F) {
+              return llvm::any_of(F.Edits, [&](const TextEdit &E) {
+                return !Inside(E.range);
+              });
+            }))
+          continue;
+        int Delta = static_cast<int>(S.second.FirstLine) -
+                    static_cast<int>(Old.FirstLine);
+        auto Shift = [&](Range &R) {
+          R.start.line += Delta;
+          R.end.line += Delta;
+        };
+        Diag Moved = D;
+        Shift(Moved.Range);
+        for (Note &N : Moved.Notes)
+          if (N.InsideMainFile)
+            Shift(N.Range);
+        for (Fix &F : Moved.Fixes)
+          for (TextEdit &E : F.Edits)
+            Shift(E.range);
+        Result.push_back(std::move(Moved));
+        break;
+      }
+    }
+    return Result;
+  }
+
+private:
+  const PreviousBuild &Previous;
+  EditedLines Edit;
+  // Bodies of the previous build by the line of the function name. Null for
+  // lines with more than one function.
+  llvm::DenseMap<unsigned, const FunctionBodyLines *> ByDeclLine;
+  // Pairs of old and new positions of the skipped bodies.
+  std::vector<std::pair<const FunctionBodyLines *, FunctionBodyLines>> Skipped;
+};
+
+// Collects the bodies of the functions defined in the main file.
+class CollectFunctionBodies
+    : public RecursiveASTVisitor<CollectFunctionBodies> {
+public:
+  CollectFunctionBodies(const SourceManager &SM,
+                        std::vector<FunctionBodyLines> &Out)
+      : SM(SM), Out(Out) {}
+
+  bool VisitFunctionDecl(FunctionDecl *FD) {
+    if (FD->isImplicit() || !FD->doesThisDeclarationHaveABody())
+      return true;
+    const Stmt *Body = FD->getBody();
+    if (!Body)
+      return true;
+    auto DeclLine = mainFileLine(FD->getLocation(), SM);
+    auto FirstLine = mainFileLine(Body->getBeginLoc(), SM);
+    auto LastLine = mainFileLine(Body->getEndLoc(), SM);
+    if (DeclLine && FirstLine && LastLine)
+      Out.push_back({*DeclLine, *FirstLine, *LastLine});
+    return true;
+  }
+
+private:
+  const SourceManager &SM;
+  std::vector<FunctionBodyLines> &Out;
+};
+
 class DeclTrackingASTConsumer : public ASTConsumer {
 public:
-  DeclTrackingASTConsumer(std::vector<Decl *> &TopLevelDecls)
-      : TopLevelDecls(TopLevelDecls) {}
+  DeclTrackingASTConsumer(std::vector<Decl *> &TopLevelDecls,
+                          FunctionBodySkipper *Skipper)
+      : TopLevelDecls(TopLevelDecls), Skipper(Skipper) {}
 
   bool HandleTopLevelDecl(DeclGroupRef DG) override {
     for (Decl *D : DG) {
@@ -80,22 +287,31 @@ public:
     return true;
   }
 
+  bool shouldSkipFunctionBody(Decl *D) override {
+    return Skipper && Skipper->shouldSkip(D);
+  }
+
 private:
   std::vector<Decl *> &TopLevelDecls;
+  FunctionBodySkipper *Skipper;
 };
 
 class ClangdFrontendAction : public SyntaxOnlyAction {
 public:
+  ClangdFrontendAction(FunctionBodySkipper *Skipper) : Skipper(Skipper) {}
+
   std::vector<Decl *> takeTopLevelDecls() { return std::move(TopLevelDecls); }
 
 protected:
   std::unique_ptr<ASTConsumer>
   CreateASTConsumer(CompilerInstance &CI, llvm::StringRef InFile) override {
-    return std::make_unique<DeclTrackingASTConsumer>(/*ref*/ TopLevelDecls);
+    return std::make_unique<DeclTrackingASTConsumer>(/*ref*/ TopLevelDecls,
+                                                     Skipper);
   }
 
 private:
   std::vector<Decl *> TopLevelDecls;
+  FunctionBodySkipper *Skipper;
 };
 
 // This collects macro expansions in the main file.
@@ -235,7 +451,8 @@ ParsedAST::build(std::unique_ptr<clang::CompilerInvocation> CI,
                  std::shared_ptr<const PreambleData> Preamble,
                  std::unique_ptr<llvm::MemoryBuffer> Buffer,
                  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS,
-                 const SymbolIndex *Index, const ParseOptions &Opts) {
+                 const SymbolIndex *Index, const ParseOptions &Opts,
+                 const PreviousBuild *Previous) {
   assert(CI);
   // Command-line parsing sets DisableFree to true by default, but we don't want
   // to leak memory in clangd.
@@ -252,7 +469,12 @@ ParsedAST::build(std::unique_ptr<clang::CompilerInvocation> CI,
   if (!Clang)
     return None;
 
-  auto Action = std::make_unique<ClangdFrontendAction>();
+  llvm::Optional<FunctionBodySkipper> Skipper;
+  if (Previous) {
+    Skipper.emplace(*Previous, Content);
+    Clang->getFrontendOpts().SkipFunctionBodies = true;
+  }
+  auto Action = std::make_unique<ClangdFrontendAction>(Skipper.getPointer());
   const FrontendInputFile &MainInput = Clang->getFrontendOpts().Inputs[0];
   if (!Action->BeginSourceFile(*Clang, MainInput)) {
     log("BeginSourceFile() failed when building AST for {0}",
@@ -407,15 +629,27 @@ ParsedAST::build(std::unique_ptr<clang::CompilerInvocation> CI,
   // Add diagnostics from the preamble, if any.
   if (Preamble)
     Diags.insert(Diags.end(), Preamble->Diags.begin(), Preamble->Diags.end());
-  // Finally, add diagnostics coming from the AST.
+  // Finally, add diagnostics coming from the AST. If bodies were skipped, those
+  // that depend on them are left to the complete build.
   {
     std::vector<Diag> D = ASTDiags.take(CTContext.getPointer());
+    if (Skipper && !Skipper->skippedBodies().empty())
+      llvm::erase_if(D, dependsOnFunctionBodies);
+    Diags.insert(Diags.end(), D.begin(), D.end());
+  }
+  // And the ones from the function bodies we did not parse.
+  std::vector<FunctionBodyLines> SkippedBodies;
+  if (Skipper) {
+    SkippedBodies = Skipper->skippedBodies();
+    std::vector<Diag> D = Skipper->carriedOverDiags();
     Diags.insert(Diags.end(), D.begin(), D.end());
   }
-  return ParsedAST(std::move(Preamble), std::move(Clang), std::move(Action),
+  ParsedAST Result(std::move(Preamble), std::move(Clang), std::move(Action),
                    std::move(Tokens), std::move(MainFileMacroExpLocs),
                    std::move(ParsedDecls), std::move(Diags),
                    std::move(Includes), std::move(CanonIncludes));
+  Result.SkippedFunctionBodies = std::move(SkippedBodies);
+  return std::move(Result);
 }
 
 ParsedAST::ParsedAST(ParsedAST &&Other) = default;
@@ -521,9 +755,11 @@ llvm::Optional<ParsedAST>
 buildAST(PathRef FileName, std::unique_ptr<CompilerInvocation> Invocation,
          llvm::ArrayRef<Diag> CompilerInvocationDiags,
          const ParseInputs &Inputs,
-         std::shared_ptr<const PreambleData> Preamble) {
+         std::shared_ptr<const PreambleData> Preamble,
+         const PreviousBuild *Previous) {
   trace::Span Tracer("BuildAST");
   SPAN_ATTACH(Tracer, "File", FileName);
+  SPAN_ATTACH(Tracer, "Incremental", Previous != nullptr);
 
   auto VFS = Inputs.FS;
   if (Preamble && Preamble->StatCache)
@@ -538,7 +774,15 @@ buildAST(PathRef FileName, std::unique_ptr<CompilerInvocation> Invocation,
       std::make_unique<CompilerInvocation>(*Invocation),
       CompilerInvocationDiags, Preamble,
       llvm::MemoryBuffer::getMemBufferCopy(Inputs.Contents, FileName),
-      std::move(VFS), Inputs.Index, Inputs.Opts);
+      std::move(VFS), Inputs.Index, Inputs.Opts, Previous);
+}
+
+PreviousBuild::PreviousBuild(llvm::StringRef Contents, ParsedAST &AST)
+    : Contents(Contents), FunctionBodies(AST.getSkippedFunctionBodies()),
+      Diags(AST.getDiagnostics()) {
+  CollectFunctionBodies Collector(AST.getSourceManager(), FunctionBodies);
+  for (Decl *D : AST.getLocalTopLevelDecls())
+    Collector.TraverseDecl(D);
 }
 
 } // namespace clangd
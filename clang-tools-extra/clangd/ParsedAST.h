@@ -40,19 +40,35 @@
 namespace clang {
 namespace clangd {
 class SymbolIndex;
+struct PreviousBuild;
+
+/// Lines spanned by the body of a function defined in the main file. All line
+/// numbers are 0-based.
+struct FunctionBodyLines {
+  /// The line of the function's name.
+  unsigned DeclLine;
+  /// The lines of the opening and closing braces of the body.
+  unsigned FirstLine;
+  unsigned LastLine;
+};
 
 /// Stores and provides access to parsed AST.
 class ParsedAST {
 public:
   /// Attempts to run Clang and store parsed AST. If \p Preamble is non-null
   /// it is reused during parsing.
+  /// If \p Previous is non-null, bodies of functions that lie outside of the
+  /// lines edited since that build are skipped, and their diagnostics are
+  /// copied from \p Previous. Such an AST is only good for publishing
+  /// diagnostics and should be followed by a full build.
   static llvm::Optional<ParsedAST>
   build(std::unique_ptr<clang::CompilerInvocation> CI,
         llvm::ArrayRef<Diag> CompilerInvocationDiags,
         std::shared_ptr<const PreambleData> Preamble,
         std::unique_ptr<llvm::MemoryBuffer> Buffer,
         llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> VFS,
-        const SymbolIndex *Index, const ParseOptions &Opts);
+        const SymbolIndex *Index, const ParseOptions &Opts,
+        const PreviousBuild *Previous = nullptr);
 
   ParsedAST(ParsedAST &&Other);
   ParsedAST &operator=(ParsedAST &&Other);
@@ -96,6 +112,12 @@ public:
   /// (!) does not have tokens from the preamble.
   const syntax::TokenBuffer &getTokens() const { return Tokens; }
 
+  /// Function bodies that were skipped because they were not edited since the
+  /// previous build. Empty for a complete AST.
+  llvm::ArrayRef<FunctionBodyLines> getSkippedFunctionBodies() const {
+    return SkippedFunctionBodies;
+  }
+
 private:
   ParsedAST(std::shared_ptr<const PreambleData> Preamble,
             std::unique_ptr<CompilerInstance> Clang,
@@ -130,6 +152,20 @@ private:
   std::vector<Decl *> LocalTopLevelDecls;
   IncludeStructure Includes;
   CanonicalIncludes CanonIncludes;
+  std::vector<FunctionBodyLines> SkippedFunctionBodies;
+};
+
+/// What the build of a previous version of the main file found. Allows the
+/// next build to skip the function bodies an edit did not touch.
+struct PreviousBuild {
+  /// Records the results of building \p AST from \p Contents.
+  PreviousBuild(llvm::StringRef Contents, ParsedAST &AST);
+
+  std::string Contents;
+  /// Bodies of all the functions defined in the main file, including the
+  /// skipped ones.
+  std::vector<FunctionBodyLines> FunctionBodies;
+  std::vector<Diag> Diags;
 };
 
 /// Build an AST from provided user inputs. This function does not check if
@@ -139,7 +175,8 @@ llvm::Optional<ParsedAST>
 buildAST(PathRef FileName, std::unique_ptr<CompilerInvocation> Invocation,
          llvm::ArrayRef<Diag> CompilerInvocationDiags,
          const ParseInputs &Inputs,
-         std::shared_ptr<const PreambleData> Preamble);
+         std::shared_ptr<const PreambleData> Preamble,
+         const PreviousBuild *Previous = nullptr);
 
 /// For testing/debugging purposes. Note that this method deserializes all
 /// unserialized Decls, so use with care.
@@ -69,10 +69,35 @@ using std::chrono::steady_clock;
 
 namespace {
 class ASTWorker;
+
+/// A preamble together with the compile command it was built with.
+struct RetainedPreamble {
+  std::shared_ptr<const PreambleData> Preamble;
+  tooling::CompileCommand Command;
+};
+
+/// The last build of the main file, with the preamble and command it used.
+struct LastMainFileBuild {
+  PreviousBuild Build;
+  std::weak_ptr<const PreambleData> Preamble;
+  tooling::CompileCommand Command;
+};
 } // namespace
 
 static clang::clangd::Key<std::string> kFileBeingProcessed;
 
+/// Time from scheduling a task until it starts running, labeled with the
+/// priority of the task.
+constexpr trace::Metric TaskLatency("task_latency_ms");
+
+static void recordLatency(steady_clock::time_point AddTime,
+                          TaskPriority Priority) {
+  TaskLatency.record(std::chrono::duration<double, std::milli>(
+                         steady_clock::now() - AddTime)
+                         .count(),
+                     toString(Priority));
+}
+
 llvm::Optional<llvm::StringRef> TUScheduler::getFileBeingProcessedInContext() {
   if (auto *File = Context::current().get(kFileBeingProcessed))
     return llvm::StringRef(*File);
@@ -146,6 +171,50 @@ private:
   std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
 };
 
+/// An LRU cache of preambles of recently closed files.
+/// Reopening a file shortly after closing it (e.g. switching between files in
+/// an editor) can then skip the preamble build. buildPreamble() still checks
+/// that a retained preamble is up-to-date before reusing it.
+/// Preambles are only reused for the file that built them, source locations
+/// stored in a preamble refer to that main file.
+/// Only accessed by the thread calling TUScheduler::update() and remove().
+class TUScheduler::PreambleCache {
+public:
+  PreambleCache(unsigned MaxRetainedPreambles)
+      : MaxRetainedPreambles(MaxRetainedPreambles) {}
+
+  /// Store the preamble of a closed file, possibly evicting the least recently
+  /// closed ones.
+  void put(PathRef File, RetainedPreamble P) {
+    if (!P.Preamble || MaxRetainedPreambles == 0)
+      return;
+    take(File);
+    LRU.insert(LRU.begin(), {File.str(), std::move(P)});
+    if (LRU.size() > MaxRetainedPreambles)
+      LRU.pop_back();
+  }
+
+  /// Returns the preamble retained for \p File and removes it from the cache.
+  /// The returned preamble is empty if nothing was retained.
+  RetainedPreamble take(PathRef File) {
+    auto It = llvm::find_if(LRU, [&](const std::pair<std::string,
+                                                     RetainedPreamble> &P) {
+      return P.first == File;
+    });
+    if (It == LRU.end())
+      return RetainedPreamble();
+    RetainedPreamble P = std::move(It->second);
+    LRU.erase(It);
+    return P;
+  }
+
+private:
+  unsigned MaxRetainedPreambles;
+  /// Items sorted in LRU order, i.e. first item is the most recently closed
+  /// file.
+  std::vector<std::pair<std::string, RetainedPreamble>> LRU;
+};
+
 namespace {
 class ASTWorkerHandle;
 
@@ -164,7 +233,7 @@ class ASTWorker {
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
             TUScheduler::ASTCache &LRUCache, Semaphore &Barrier, bool RunSync,
             steady_clock::duration UpdateDebounce, bool StorePreamblesInMemory,
-            ParsingCallbacks &Callbacks);
+            ParsingCallbacks &Callbacks, RetainedPreamble Retained);
 
 public:
   /// Create a new ASTWorker and return a handle to it.
@@ -172,11 +241,14 @@ public:
   /// is null, all requests will be processed on the calling thread
   /// synchronously instead. \p Barrier is acquired when processing each
   /// request, it is used to limit the number of actively running threads.
+  /// \p Retained is a preamble previously built for \p FileName, the first
+  /// update will try to reuse it.
   static ASTWorkerHandle
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
          TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
          Semaphore &Barrier, steady_clock::duration UpdateDebounce,
-         bool StorePreamblesInMemory, ParsingCallbacks &Callbacks);
+         bool StorePreamblesInMemory, ParsingCallbacks &Callbacks,
+         RetainedPreamble Retained);
   ~ASTWorker();
 
   void update(ParseInputs Inputs, WantDiagnostics);
@@ -186,6 +258,8 @@ public:
   bool blockUntilIdle(Deadline Timeout) const;
 
   std::shared_ptr<const PreambleData> getPossiblyStalePreamble() const;
+  /// Returns the last built preamble and the command it was built with.
+  RetainedPreamble getRetainedPreamble() const;
 
   /// Obtain a preamble reflecting all updates so far. Threadsafe.
   /// It may be delivered immediately, or later on the worker thread.
@@ -224,6 +298,16 @@ private:
   Deadline scheduleLocked();
   /// Should the first task in the queue be skipped instead of run?
   bool shouldSkipHeadLocked() const;
+  /// Is there an update queued after the task that is running now?
+  bool hasPendingUpdate() const;
+  /// Builds the main file skipping the function bodies unchanged since
+  /// LastBuild and publishes the diagnostics. Returns true if it did so. Only
+  /// called in the worker thread.
+  bool publishIncrementalAST(const ParseInputs &Inputs,
+                             const CompilerInvocation &Invocation,
+                             llvm::ArrayRef<Diag> CompilerInvocationDiags,
+                             std::shared_ptr<const PreambleData> Preamble,
+                             ParsingCallbacks::PublishFn RunPublish);
   /// This is private because `FileInputs.FS` is not thread-safe and thus not
   /// safe to share. Callers should make sure not to expose `FS` via a public
   /// interface.
@@ -255,6 +339,11 @@ private:
   Semaphore &Barrier;
   /// Whether the 'onMainAST' callback ran for the current FileInputs.
   bool RanASTCallback = false;
+  /// Whether any update was processed yet. Only accessed by the worker thread.
+  bool ProcessedUpdate = false;
+  /// Only set when ParseOptions::SkipUnchangedFunctionBodies is on. Only
+  /// accessed by the worker thread.
+  llvm::Optional<LastMainFileBuild> LastBuild;
   /// Guards members used by both TUScheduler and the worker thread.
   mutable std::mutex Mutex;
   /// File inputs, currently being used by the worker.
@@ -262,6 +351,8 @@ private:
   /// be consumed by clients of ASTWorker.
   std::shared_ptr<const ParseInputs> FileInputs;         /* GUARDED_BY(Mutex) */
   std::shared_ptr<const PreambleData> LastBuiltPreamble; /* GUARDED_BY(Mutex) */
+  /// Compile command used to build LastBuiltPreamble.
+  tooling::CompileCommand LastPreambleCommand; /* GUARDED_BY(Mutex) */
   /// Becomes ready when the first preamble build finishes.
   Notification PreambleWasBuilt;
   /// Set to true to signal run() to finish processing.
@@ -326,10 +417,11 @@ ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
                   TUScheduler::ASTCache &IdleASTs, AsyncTaskRunner *Tasks,
                   Semaphore &Barrier, steady_clock::duration UpdateDebounce,
-                  bool StorePreamblesInMemory, ParsingCallbacks &Callbacks) {
-  std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks,
-                    UpdateDebounce, StorePreamblesInMemory, Callbacks));
+                  bool StorePreamblesInMemory, ParsingCallbacks &Callbacks,
+                  RetainedPreamble Retained) {
+  std::shared_ptr<ASTWorker> Worker(new ASTWorker(
+      FileName, CDB, IdleASTs, Barrier, /*RunSync=*/!Tasks, UpdateDebounce,
+      StorePreamblesInMemory, Callbacks, std::move(Retained)));
   if (Tasks)
     Tasks->runAsync("worker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -340,13 +432,15 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
                      TUScheduler::ASTCache &LRUCache, Semaphore &Barrier,
                      bool RunSync, steady_clock::duration UpdateDebounce,
-                     bool StorePreamblesInMemory, ParsingCallbacks &Callbacks)
+                     bool StorePreamblesInMemory, ParsingCallbacks &Callbacks,
+                     RetainedPreamble Retained)
     : IdleASTs(LRUCache), RunSync(RunSync), UpdateDebounce(UpdateDebounce),
       FileName(FileName), CDB(CDB),
       StorePreambleInMemory(StorePreamblesInMemory),
       Callbacks(Callbacks), Status{TUAction(TUAction::Idle, ""),
                                    TUStatus::BuildDetails()},
-      Barrier(Barrier), Done(false) {
+      Barrier(Barrier), LastBuiltPreamble(std::move(Retained.Preamble)),
+      LastPreambleCommand(std::move(Retained.Command)), Done(false) {
   auto Inputs = std::make_shared<ParseInputs>();
   // Set a fallback command because compile command can be accessed before
   // `Inputs` is initialized. Other fields are only used after initialization
@@ -376,6 +470,12 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
         Publish();
     };
 
+    // Let clients show results from a previous session while we build. This
+    // goes first, as even getting the compile command can be slow.
+    if (!ProcessedUpdate && WantDiags != WantDiagnostics::No)
+      Callbacks.onFileOpened(FileName, Inputs.Contents, RunPublish);
+    ProcessedUpdate = true;
+
     // Get the actual command as `Inputs` does not have a command.
     // FIXME: some build systems like Bazel will take time to preparing
     // environment to build the file, it would be nice if we could emit a
@@ -392,7 +492,6 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
         std::tie(PrevInputs->CompileCommand, PrevInputs->Contents) ==
         std::tie(Inputs.CompileCommand, Inputs.Contents);
 
-    tooling::CompileCommand OldCommand = PrevInputs->CompileCommand;
     bool RanCallbackForPrevInputs = RanASTCallback;
     {
       std::lock_guard<std::mutex> Lock(Mutex);
@@ -426,10 +525,10 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
       return;
     }
 
-    std::shared_ptr<const PreambleData> OldPreamble =
-        getPossiblyStalePreamble();
+    RetainedPreamble Old = getRetainedPreamble();
+    std::shared_ptr<const PreambleData> OldPreamble = std::move(Old.Preamble);
     std::shared_ptr<const PreambleData> NewPreamble = buildPreamble(
-        FileName, *Invocation, OldPreamble, OldCommand, Inputs,
+        FileName, *Invocation, OldPreamble, Old.Command, Inputs,
         StorePreambleInMemory,
         [this](ASTContext &Ctx, std::shared_ptr<clang::Preprocessor> PP,
                const CanonicalIncludes &CanonIncludes) {
@@ -440,6 +539,7 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
     {
       std::lock_guard<std::mutex> Lock(Mutex);
       LastBuiltPreamble = NewPreamble;
+      LastPreambleCommand = Inputs.CompileCommand;
     }
     // Before doing the expensive AST reparse, we want to release our reference
     // to the old preamble, so it can be freed if there are no other references
@@ -483,10 +583,21 @@ void ASTWorker::update(ParseInputs Inputs, WantDiagnostics WantDiags) {
 
     // Get the AST for diagnostics.
     llvm::Optional<std::unique_ptr<ParsedAST>> AST = IdleASTs.take(this);
+    if (!AST && publishIncrementalAST(Inputs, *Invocation,
+                                      CompilerInvocationDiags, NewPreamble,
+                                      RunPublish)) {
+      // Building the complete AST would be wasted if it's about to be replaced.
+      // Note that the incremental AST is not cached, reads build their own.
+      if (hasPendingUpdate())
+        return;
+    }
     if (!AST) {
       llvm::Optional<ParsedAST> NewAST =
           buildAST(FileName, std::move(Invocation), CompilerInvocationDiags,
                    Inputs, NewPreamble);
+      if (NewAST && Inputs.Opts.SkipUnchangedFunctionBodies)
+        LastBuild = LastMainFileBuild{PreviousBuild(Inputs.Contents, *NewAST),
+                                      NewPreamble, Inputs.CompileCommand};
       AST = NewAST ? std::make_unique<ParsedAST>(std::move(*NewAST)) : nullptr;
       if (!(*AST)) { // buildAST fails.
         TUStatus::BuildDetails Details;
@@ -562,6 +673,11 @@ ASTWorker::getPossiblyStalePreamble() const {
   return LastBuiltPreamble;
 }
 
+RetainedPreamble ASTWorker::getRetainedPreamble() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return RetainedPreamble{LastBuiltPreamble, LastPreambleCommand};
+}
+
 void ASTWorker::getCurrentPreamble(
     llvm::unique_function<void(std::shared_ptr<const PreambleData>)> Callback) {
   // We could just call startTask() to throw the read on the queue, knowing
@@ -694,11 +810,16 @@ void ASTWorker::run() {
     } // unlock Mutex
 
     {
-      std::unique_lock<Semaphore> Lock(Barrier, std::try_to_lock);
-      if (!Lock.owns_lock()) {
+      // Reads are requested by the user, e.g. hover or go-to-definition, and
+      // should not wait behind rebuilds of other files.
+      TaskPriority Priority =
+          Req.UpdateType ? TaskPriority::Visible : TaskPriority::Interactive;
+      if (!Barrier.try_lock(Priority)) {
         emitTUStatus({TUAction::Queued, Req.Name});
-        Lock.lock();
+        Barrier.lock(Priority);
       }
+      auto ReleaseBarrier = llvm::make_scope_exit([&] { Barrier.unlock(); });
+      recordLatency(Req.AddTime, Priority);
       WithContext Guard(std::move(Req.Ctx));
       trace::Span Tracer(Req.Name);
       emitTUStatus({TUAction::RunningAction, Req.Name});
@@ -755,6 +876,43 @@ Deadline ASTWorker::scheduleLocked() {
   return D;
 }
 
+bool ASTWorker::hasPendingUpdate() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  // The running task stays at the front of the queue until it finishes.
+  return Requests.size() > 1 &&
+         std::any_of(std::next(Requests.begin()), Requests.end(),
+                     [](const Request &R) { return R.UpdateType.hasValue(); });
+}
+
+bool ASTWorker::publishIncrementalAST(
+    const ParseInputs &Inputs, const CompilerInvocation &Invocation,
+    llvm::ArrayRef<Diag> CompilerInvocationDiags,
+    std::shared_ptr<const PreambleData> Preamble,
+    ParsingCallbacks::PublishFn RunPublish) {
+  // In sync mode nothing can supersede the complete AST, so it's pure overhead.
+  if (!Inputs.Opts.SkipUnchangedFunctionBodies || RunSync || !LastBuild)
+    return false;
+  // Anything that changes how the unchanged bodies parse invalidates the
+  // previous build.
+  if (LastBuild->Preamble.lock() != Preamble ||
+      LastBuild->Command != Inputs.CompileCommand ||
+      LastBuild->Build.Contents == Inputs.Contents)
+    return false;
+  llvm::Optional<ParsedAST> AST = buildAST(
+      FileName, std::make_unique<CompilerInvocation>(Invocation),
+      CompilerInvocationDiags, Inputs, Preamble, &LastBuild->Build);
+  // If no body was skipped, the complete build is no slower.
+  if (!AST || AST->getSkippedFunctionBodies().empty())
+    return false;
+  {
+    trace::Span Span("Running main AST callback");
+    Callbacks.onMainAST(FileName, *AST, RunPublish);
+  }
+  LastBuild = LastMainFileBuild{PreviousBuild(Inputs.Contents, *AST),
+                                std::move(Preamble), Inputs.CompileCommand};
+  return true;
+}
+
 // Returns true if Requests.front() is a dead update that can be skipped.
 bool ASTWorker::shouldSkipHeadLocked() const {
   assert(!Requests.empty());
@@ -852,6 +1010,8 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
                           : std::make_unique<ParsingCallbacks>()),
       Barrier(AsyncThreadsCount),
       IdleASTs(std::make_unique<ASTCache>(RetentionPolicy.MaxRetainedASTs)),
+      ClosedPreambles(
+          std::make_unique<PreambleCache>(RetentionPolicy.MaxRetainedPreambles)),
       UpdateDebounce(UpdateDebounce) {
   if (0 < AsyncThreadsCount) {
     PreambleTasks.emplace();
@@ -889,7 +1049,8 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
     ASTWorkerHandle Worker = ASTWorker::create(
         File, CDB, *IdleASTs,
         WorkerThreads ? WorkerThreads.getPointer() : nullptr, Barrier,
-        UpdateDebounce, StorePreamblesInMemory, *Callbacks);
+        UpdateDebounce, StorePreamblesInMemory, *Callbacks,
+        ClosedPreambles->take(File));
     FD = std::unique_ptr<FileData>(
         new FileData{Inputs.Contents, std::move(Worker)});
   } else {
@@ -900,10 +1061,14 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
 }
 
 void TUScheduler::remove(PathRef File) {
-  bool Removed = Files.erase(File);
-  if (!Removed)
+  auto It = Files.find(File);
+  if (It == Files.end()) {
     elog("Trying to remove file from TUScheduler that is not tracked: {0}",
          File);
+    return;
+  }
+  ClosedPreambles->put(File, It->second->Worker->getRetainedPreamble());
+  Files.erase(It);
 }
 
 llvm::StringRef TUScheduler::getContents(PathRef File) const {
@@ -975,7 +1140,8 @@ void TUScheduler::runWithPreamble(llvm::StringRef Name, PathRef File,
                Command = Worker->getCurrentCompileCommand(),
                Ctx = Context::current().derive(kFileBeingProcessed, File),
                ConsistentPreamble = std::move(ConsistentPreamble),
-               Action = std::move(Action), this]() mutable {
+               Action = std::move(Action), AddTime = steady_clock::now(),
+               this]() mutable {
     std::shared_ptr<const PreambleData> Preamble;
     if (ConsistentPreamble.valid()) {
       Preamble = ConsistentPreamble.get();
@@ -989,7 +1155,11 @@ void TUScheduler::runWithPreamble(llvm::StringRef Name, PathRef File,
       Preamble = Worker->getPossiblyStalePreamble();
     }
 
-    std::lock_guard<Semaphore> BarrierLock(Barrier);
+    // Preamble actions are code completion and signature help, which the user
+    // is waiting for.
+    Barrier.lock(TaskPriority::Interactive);
+    auto ReleaseBarrier = llvm::make_scope_exit([&] { Barrier.unlock(); });
+    recordLatency(AddTime, TaskPriority::Interactive);
     WithContext Guard(std::move(Ctx));
     trace::Span Tracer(Name);
     SPAN_ATTACH(Tracer, "file", File);
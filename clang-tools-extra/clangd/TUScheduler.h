@@ -58,6 +58,9 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// Maximum number of preambles of closed files to be retained, so that they
+  /// can be reused if the files are reopened.
+  unsigned MaxRetainedPreambles = 3;
 };
 
 struct TUAction {
@@ -128,6 +131,13 @@ public:
   /// Publish() may never run in this case).
   virtual void onMainAST(PathRef Path, ParsedAST &AST, PublishFn Publish) {}
 
+  /// Called on the worker thread when processing the first update of a file,
+  /// before anything is built. Results computed for the same \p Contents in a
+  /// previous session may be published here, see onMainAST on how to use
+  /// \p Publish.
+  virtual void onFileOpened(PathRef Path, llvm::StringRef Contents,
+                            PublishFn Publish) {}
+
   /// Called whenever the AST fails to build. \p Diags will have the diagnostics
   /// that led to failure.
   virtual void onFailedAST(PathRef Path, std::vector<Diag> Diags,
@@ -236,6 +246,8 @@ public:
   /// Responsible for retaining and rebuilding idle ASTs. An implementation is
   /// an LRU cache.
   class ASTCache;
+  /// Retains preambles of recently closed files.
+  class PreambleCache;
 
   // The file being built/processed in the current thread. This is a hack in
   // order to get the file name into the index implementations. Do not depend on
@@ -251,6 +263,7 @@ private:
   Semaphore Barrier;
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
+  std::unique_ptr<PreambleCache> ClosedPreambles;
   // None when running tasks synchronously and non-None when running tasks
   // asynchronously.
   llvm::Optional<AsyncTaskRunner> PreambleTasks;
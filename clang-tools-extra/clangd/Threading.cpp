@@ -1,6 +1,7 @@
 #include "Threading.h"
 #include "Trace.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Threading.h"
 #include <atomic>
@@ -29,26 +30,50 @@ void Notification::wait() const {
   CV.wait(Lock, [this] { return Notified; });
 }
 
+llvm::StringRef toString(TaskPriority Priority) {
+  switch (Priority) {
+  case TaskPriority::Interactive:
+    return "interactive";
+  case TaskPriority::Visible:
+    return "visible";
+  }
+  llvm_unreachable("Unknown TaskPriority");
+}
+
 Semaphore::Semaphore(std::size_t MaxLocks) : FreeSlots(MaxLocks) {}
 
-bool Semaphore::try_lock() {
+bool Semaphore::hasMoreUrgentWaiters(TaskPriority Priority) const {
+  for (unsigned P = 0; P < static_cast<unsigned>(Priority); ++P)
+    if (Waiters[P])
+      return true;
+  return false;
+}
+
+bool Semaphore::try_lock(TaskPriority Priority) {
   std::unique_lock<std::mutex> Lock(Mutex);
-  if (FreeSlots > 0) {
+  if (FreeSlots > 0 && !hasMoreUrgentWaiters(Priority)) {
     --FreeSlots;
     return true;
   }
   return false;
 }
 
-void Semaphore::lock() {
+void Semaphore::lock(TaskPriority Priority) {
   trace::Span Span("WaitForFreeSemaphoreSlot");
+  SPAN_ATTACH(Span, "priority", toString(Priority));
   // trace::Span can also acquire locks in ctor and dtor, we make sure it
   // happens when Semaphore's own lock is not held.
   {
     std::unique_lock<std::mutex> Lock(Mutex);
-    SlotsChanged.wait(Lock, [&]() { return FreeSlots > 0; });
+    ++Waiters[static_cast<unsigned>(Priority)];
+    SlotsChanged.wait(Lock, [&]() {
+      return FreeSlots > 0 && !hasMoreUrgentWaiters(Priority);
+    });
+    --Waiters[static_cast<unsigned>(Priority)];
     --FreeSlots;
   }
+  // Less urgent waiters may be able to take a slot now that we're not waiting.
+  SlotsChanged.notify_all();
 }
 
 void Semaphore::unlock() {
@@ -56,7 +81,8 @@ void Semaphore::unlock() {
   ++FreeSlots;
   Lock.unlock();
 
-  SlotsChanged.notify_one();
+  // Only some of the waiters may take the slot, wake all of them to decide.
+  SlotsChanged.notify_all();
 }
 
 AsyncTaskRunner::~AsyncTaskRunner() { wait(); }
@@ -12,6 +12,7 @@
 #include "Context.h"
 #include "llvm/ADT/FunctionExtras.h"
 #include "llvm/ADT/Twine.h"
+#include <array>
 #include <cassert>
 #include <condition_variable>
 #include <future>
@@ -37,19 +38,36 @@ private:
   mutable std::mutex Mu;
 };
 
+/// Latency classes of tasks that compete for the same worker slots, from the
+/// most to the least urgent.
+enum class TaskPriority : unsigned {
+  /// The user is waiting for the result, e.g. code completion or hover.
+  Interactive,
+  /// Results are shown to the user, e.g. diagnostics of open files.
+  Visible,
+};
+llvm::StringRef toString(TaskPriority);
+
 /// Limits the number of threads that can acquire the lock at the same time.
+/// When slots are contended, a free slot is granted to one of the waiters with
+/// the most urgent priority.
 class Semaphore {
 public:
   Semaphore(std::size_t MaxLocks);
 
-  bool try_lock();
-  void lock();
+  bool try_lock(TaskPriority Priority = TaskPriority::Visible);
+  void lock(TaskPriority Priority = TaskPriority::Visible);
   void unlock();
 
 private:
+  bool hasMoreUrgentWaiters(TaskPriority Priority) const /*REQUIRES(Mutex)*/;
+
   std::mutex Mutex;
   std::condition_variable SlotsChanged;
   std::size_t FreeSlots;
+  /// Number of threads blocked in lock(), indexed by priority.
+  std::array<unsigned, static_cast<unsigned>(TaskPriority::Visible) + 1>
+      Waiters = {}; /* GUARDED_BY(Mutex) */
 };
 
 /// A point in time we can wait for.
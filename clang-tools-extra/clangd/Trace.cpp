@@ -68,6 +68,16 @@ public:
               llvm::json::Object{{"name", Name}, {"args", std::move(Args)}});
   }
 
+  // Measurements are shown as counters, one series per label.
+  void record(const Metric &Metric, double Value,
+              llvm::StringRef Label) override {
+    jsonEvent("C", llvm::json::Object{
+                       {"name", Metric.Name},
+                       {"args", llvm::json::Object{
+                                    {Label.empty() ? "value" : Label, Value}}},
+                   });
+  }
+
   // Record an event on the current thread. ph, pid, tid, ts are set.
   // Contents must be a list of the other JSON key/values.
   void jsonEvent(llvm::StringRef Phase, llvm::json::Object &&Contents,
@@ -202,6 +212,12 @@ std::unique_ptr<EventTracer> createJSONTracer(llvm::raw_ostream &OS,
   return std::make_unique<JSONTracer>(OS, Pretty);
 }
 
+void Metric::record(double Value, llvm::StringRef Label) const {
+  if (!T)
+    return;
+  T->record(*this, Value, Label);
+}
+
 void log(const llvm::Twine &Message) {
   if (!T)
     return;
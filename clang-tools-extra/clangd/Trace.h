@@ -18,6 +18,7 @@
 #define LLVM_CLANG_TOOLS_EXTRA_CLANGD_TRACE_H_
 
 #include "Context.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
@@ -26,6 +27,20 @@ namespace clang {
 namespace clangd {
 namespace trace {
 
+/// Represents measurements of clangd events, e.g. latencies of requests.
+/// Each recorded value carries a label, e.g. the kind of the request, and the
+/// active EventTracer decides how to aggregate them, e.g. into one histogram
+/// per label.
+struct Metric {
+  constexpr Metric(llvm::StringLiteral Name) : Name(Name) {}
+
+  /// Records \p Value for this metric in the active tracer, if any.
+  void record(double Value, llvm::StringRef Label = "") const;
+
+  /// Uniquely identifies the metric.
+  const llvm::StringLiteral Name;
+};
+
 /// A consumer of trace events. The events are produced by Spans and trace::log.
 /// Implmentations of this interface must be thread-safe.
 class EventTracer {
@@ -47,6 +62,10 @@ public:
 
   /// Called for instant events.
   virtual void instant(llvm::StringRef Name, llvm::json::Object &&Args) = 0;
+
+  /// Called whenever a metric records a measurement.
+  virtual void record(const Metric &Metric, double Value,
+                      llvm::StringRef Label) {}
 };
 
 /// Sets up a global EventTracer that consumes events produced by Span and
@@ -33,26 +33,30 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &OS, const Ref &R) {
 }
 
 void RefSlab::Builder::insert(const SymbolID &ID, const Ref &S) {
-  auto &M = Refs[ID];
-  if (M.count(S))
-    return;
-  Ref R = S;
-  R.Location.FileURI =
-      UniqueStrings.save(R.Location.FileURI).data();
-  M.insert(std::move(R));
+  Entries.emplace_back(ID, S);
+  Entries.back().second.Location.FileURI =
+      UniqueStrings.save(S.Location.FileURI).data();
 }
 
 RefSlab RefSlab::Builder::build() && {
+  // Sort refs by symbol and drop duplicates.
+  llvm::sort(Entries);
+  Entries.erase(std::unique(Entries.begin(), Entries.end()), Entries.end());
+
   // We can reuse the arena, as it only has unique strings and we need them all.
   // Reallocate refs on the arena to reduce waste and indirections when reading.
   std::vector<std::pair<SymbolID, llvm::ArrayRef<Ref>>> Result;
-  Result.reserve(Refs.size());
-  size_t NumRefs = 0;
-  for (auto &Sym : Refs) {
-    std::vector<Ref> SymRefs(Sym.second.begin(), Sym.second.end());
-    NumRefs += SymRefs.size();
-    Result.emplace_back(Sym.first, llvm::ArrayRef<Ref>(SymRefs).copy(Arena));
+  std::vector<Ref> SymRefs;
+  for (size_t I = 0, E = Entries.size(); I < E;) {
+    const SymbolID &ID = Entries[I].first;
+    SymRefs.clear();
+    for (; I < E && Entries[I].first == ID; ++I)
+      SymRefs.push_back(Entries[I].second);
+    Result.emplace_back(ID, llvm::ArrayRef<Ref>(SymRefs).copy(Arena));
   }
+  size_t NumRefs = Entries.size();
+  Entries.clear();
+  Entries.shrink_to_fit();
   return RefSlab(std::move(Result), std::move(Arena), NumRefs);
 }
 
@@ -101,7 +101,9 @@ public:
   private:
     llvm::BumpPtrAllocator Arena;
     llvm::UniqueStringSaver UniqueStrings; // Contents on the arena.
-    llvm::DenseMap<SymbolID, std::set<Ref>> Refs;
+    // Refs in insertion order, possibly with duplicates. A flat vector costs
+    // far less memory than a set per symbol; build() sorts and deduplicates.
+    std::vector<std::pair<SymbolID, Ref>> Entries;
   };
 
 private:
@@ -213,6 +213,9 @@ public:
   }
 };
 
+// The strings point into a single buffer holding the whole table, rather than
+// being copied one by one: they only need to live until the symbols and refs
+// that use them have been copied into slabs.
 struct StringTableIn {
   llvm::BumpPtrAllocator Arena;
   std::vector<llvm::StringRef> Strings;
@@ -224,25 +227,23 @@ llvm::Expected<StringTableIn> readStringTable(llvm::StringRef Data) {
   if (R.err())
     return makeError("Truncated string table");
 
+  StringTableIn Table;
   llvm::StringRef Uncompressed;
-  llvm::SmallString<1> UncompressedStorage;
-  if (UncompressedSize == 0) // No compression
-    Uncompressed = R.rest();
-  else {
-    if (llvm::Error E = llvm::zlib::uncompress(R.rest(), UncompressedStorage,
-                                               UncompressedSize))
+  if (UncompressedSize == 0) { // No compression
+    Uncompressed = llvm::StringRef(R.rest()).copy(Table.Arena);
+  } else {
+    char *Buf = Table.Arena.Allocate<char>(UncompressedSize);
+    size_t Size = UncompressedSize;
+    if (llvm::Error E = llvm::zlib::uncompress(R.rest(), Buf, Size))
       return std::move(E);
-    Uncompressed = UncompressedStorage;
+    Uncompressed = llvm::StringRef(Buf, Size);
   }
 
-  StringTableIn Table;
-  llvm::StringSaver Saver(Table.Arena);
-  R = Reader(Uncompressed);
   for (Reader R(Uncompressed); !R.eof();) {
     auto Len = R.rest().find(0);
     if (Len == llvm::StringRef::npos)
       return makeError("Bad string table: not null terminated");
-    Table.Strings.push_back(Saver.save(R.consume(Len)));
+    Table.Strings.push_back(R.consume(Len));
     R.consume8();
   }
   if (R.err())
@@ -39,29 +39,6 @@ namespace {
 const Token RestrictedForCodeCompletion =
     Token(Token::Kind::Sentinel, "Restricted For Code Completion");
 
-// Returns the tokens which are given symbol's characteristics. Currently, the
-// generated tokens only contain fuzzy matching trigrams and symbol's scope,
-// but in the future this will also return path proximity tokens and other
-// types of tokens such as symbol type (if applicable).
-// Returns the tokens which are given symbols's characteristics. For example,
-// trigrams and scopes.
-// FIXME(kbobyrev): Support more token types:
-// * Namespace proximity
-std::vector<Token> generateSearchTokens(const Symbol &Sym) {
-  std::vector<Token> Result = generateIdentifierTrigrams(Sym.Name);
-  Result.emplace_back(Token::Kind::Scope, Sym.Scope);
-  // Skip token generation for symbols with unknown declaration location.
-  if (!llvm::StringRef(Sym.CanonicalDeclaration.FileURI).empty())
-    for (const auto &ProximityURI :
-         generateProximityURIs(Sym.CanonicalDeclaration.FileURI))
-      Result.emplace_back(Token::Kind::ProximityURI, ProximityURI);
-  if (Sym.Flags & Symbol::IndexedForCodeCompletion)
-    Result.emplace_back(RestrictedForCodeCompletion);
-  if (!Sym.Type.empty())
-    Result.emplace_back(Token::Kind::Type, Sym.Type);
-  return Result;
-}
-
 } // namespace
 
 void Dex::buildIndex() {
@@ -86,18 +63,73 @@ void Dex::buildIndex() {
     Symbols[I] = ScoredSymbols[I].second;
   }
 
-  // Populate TempInvertedIndex with lists for index symbols.
-  llvm::DenseMap<Token, std::vector<DocID>> TempInvertedIndex;
+  // Populate lists of items for the tokens given by symbols' characteristics:
+  // trigrams, scope, proximity URIs of the declaration file, code completion
+  // restriction and type.
+  // FIXME(kbobyrev): Support more token types:
+  // * Namespace proximity
+  //
+  // Many symbols share a name (e.g. overloads), a scope or a declaration file.
+  // Generating trigrams and proximity URIs is expensive, so the tokens for
+  // each distinct value are generated once, and the indices of their lists are
+  // reused by all symbols with that value.
+  std::vector<std::vector<DocID>> Lists;
+  llvm::DenseMap<Token, unsigned> TokenToList;
+  auto GetList = [&](Token T) {
+    auto R = TokenToList.try_emplace(std::move(T), Lists.size());
+    if (R.second)
+      Lists.emplace_back();
+    return R.first->second;
+  };
+  llvm::StringMap<std::vector<unsigned>> NameLists;
+  llvm::StringMap<std::vector<unsigned>> FileLists;
+  llvm::StringMap<unsigned> ScopeLists;
+  llvm::StringMap<unsigned> TypeLists;
+  unsigned RestrictedList = GetList(RestrictedForCodeCompletion);
+
   for (DocID SymbolRank = 0; SymbolRank < Symbols.size(); ++SymbolRank) {
     const auto *Sym = Symbols[SymbolRank];
-    for (const auto &Token : generateSearchTokens(*Sym))
-      TempInvertedIndex[Token].push_back(SymbolRank);
+
+    auto Name = NameLists.try_emplace(Sym->Name);
+    if (Name.second)
+      for (Token &T : generateIdentifierTrigrams(Sym->Name))
+        Name.first->second.push_back(GetList(std::move(T)));
+    for (unsigned L : Name.first->second)
+      Lists[L].push_back(SymbolRank);
+
+    auto Scope = ScopeLists.try_emplace(Sym->Scope);
+    if (Scope.second)
+      Scope.first->second = GetList(Token(Token::Kind::Scope, Sym->Scope));
+    Lists[Scope.first->second].push_back(SymbolRank);
+
+    // Skip token generation for symbols with unknown declaration location.
+    llvm::StringRef FileURI = Sym->CanonicalDeclaration.FileURI;
+    if (!FileURI.empty()) {
+      auto File = FileLists.try_emplace(FileURI);
+      if (File.second)
+        for (const auto &ProximityURI : generateProximityURIs(FileURI))
+          File.first->second.push_back(
+              GetList(Token(Token::Kind::ProximityURI, ProximityURI)));
+      for (unsigned L : File.first->second)
+        Lists[L].push_back(SymbolRank);
+    }
+
+    if (Sym->Flags & Symbol::IndexedForCodeCompletion)
+      Lists[RestrictedList].push_back(SymbolRank);
+
+    if (!Sym->Type.empty()) {
+      auto Type = TypeLists.try_emplace(Sym->Type);
+      if (Type.second)
+        Type.first->second = GetList(Token(Token::Kind::Type, Sym->Type));
+      Lists[Type.first->second].push_back(SymbolRank);
+    }
   }
 
   // Convert lists of items to posting lists.
-  for (const auto &TokenToPostingList : TempInvertedIndex)
-    InvertedIndex.insert(
-        {TokenToPostingList.first, PostingList(TokenToPostingList.second)});
+  for (const auto &TokenAndList : TokenToList)
+    if (!Lists[TokenAndList.second].empty())
+      InvertedIndex.insert(
+          {TokenAndList.first, PostingList(Lists[TokenAndList.second])});
 }
 
 std::unique_ptr<Iterator> Dex::iterator(const Token &Tok) const {
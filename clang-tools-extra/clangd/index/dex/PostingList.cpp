@@ -18,17 +18,18 @@ namespace clangd {
 namespace dex {
 namespace {
 
+llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes);
+
 /// Implements iterator of PostingList chunks. This requires iterating over two
-/// levels: the first level iterator iterates over the chunks and decompresses
-/// them on-the-fly when the contents of chunk are to be seen.
+/// levels: the first level iterator iterates over the chunks, using their
+/// heads as skip pointers, and the deltas within the current chunk are decoded
+/// one at a time, only as far as the cursor actually moves.
 class ChunkIterator : public Iterator {
 public:
   explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
       : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
-    if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
-    }
+    if (!Chunks.empty())
+      enterChunk();
   }
 
   bool reachedEnd() const override { return CurrentChunk == Chunks.end(); }
@@ -37,27 +38,36 @@ public:
   void advance() override {
     assert(!reachedEnd() &&
            "Posting List iterator can't advance() at the end.");
-    ++CurrentID;
-    normalizeCursor();
+    if (!readNext()) {
+      ++CurrentChunk;
+      if (!reachedEnd())
+        enterChunk();
+    }
   }
 
-  /// Applies binary search to advance cursor to the next item with DocID
-  /// equal or higher than the given one.
+  /// Finds the last chunk which might contain ID via galloping search over
+  /// chunk heads, then decodes it up to the first item with DocID equal or
+  /// higher than the given one.
   void advanceTo(DocID ID) override {
     assert(!reachedEnd() &&
            "Posting List iterator can't advance() at the end.");
     if (ID <= peek())
       return;
     advanceToChunk(ID);
-    // Try to find ID within current chunk.
-    CurrentID = std::partition_point(CurrentID, DecompressedChunk.end(),
-                                     [&](const DocID D) { return D < ID; });
-    normalizeCursor();
+    while (Current < ID) {
+      if (!readNext()) {
+        // The next chunk's head is greater than ID, or there is none.
+        ++CurrentChunk;
+        if (!reachedEnd())
+          enterChunk();
+        return;
+      }
+    }
   }
 
   DocID peek() const override {
     assert(!reachedEnd() && "Posting List iterator can't peek() at the end.");
-    return *CurrentID;
+    return Current;
   }
 
   float consume() override {
@@ -84,43 +94,55 @@ private:
     return OS << ']';
   }
 
-  /// If the cursor is at the end of a chunk, place it at the start of the next
-  /// chunk.
-  void normalizeCursor() {
-    // Invariant is already established if examined chunk is not exhausted.
-    if (CurrentID != std::end(DecompressedChunk))
-      return;
-    // Advance to next chunk if current one is exhausted.
-    ++CurrentChunk;
-    if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
-      return;
-    DecompressedChunk = CurrentChunk->decompress();
-    CurrentID = DecompressedChunk.begin();
+  /// Places the cursor at the head of CurrentChunk.
+  void enterChunk() {
+    Current = CurrentChunk->Head;
+    Remaining = CurrentChunk->Payload;
+  }
+
+  /// Moves the cursor to the next item of the current chunk, if there is one.
+  bool readNext() {
+    if (Remaining.empty())
+      return false;
+    auto Delta = readVByte(Remaining);
+    if (!Delta) {
+      Remaining = {};
+      return false;
+    }
+    Current += *Delta;
+    return true;
   }
 
-  /// Advances CurrentChunk to the chunk which might contain ID.
+  /// Advances CurrentChunk to the chunk which might contain ID. Targets are
+  /// usually close to the cursor, so gallop forward before binary searching.
   void advanceToChunk(DocID ID) {
-    if ((CurrentChunk != Chunks.end() - 1) &&
-        ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
-      --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
+    auto Next = CurrentChunk + 1;
+    if (Next == Chunks.end() || Next->Head > ID)
+      return;
+    // Find a range [Next, Next + Step) with Next->Head <= ID which contains
+    // the last such chunk.
+    size_t Step = 1;
+    while (static_cast<size_t>(Chunks.end() - Next) > Step &&
+           (Next + Step)->Head <= ID) {
+      Next += Step;
+      Step *= 2;
     }
+    auto Last = Next + std::min<size_t>(Step, Chunks.end() - Next);
+    CurrentChunk = std::partition_point(
+                       Next + 1, Last,
+                       [&](const Chunk &C) { return C.Head <= ID; }) -
+                   1;
+    enterChunk();
   }
 
   const Token *Tok;
   llvm::ArrayRef<Chunk> Chunks;
   /// Iterator over chunks.
-  /// If CurrentChunk is valid, then DecompressedChunk is
-  /// CurrentChunk->decompress() and CurrentID is a valid (non-end) iterator
-  /// into it.
+  /// If CurrentChunk is valid, then Current is the DocID under the cursor, and
+  /// Remaining holds the encoded deltas of CurrentChunk that follow it.
   decltype(Chunks)::const_iterator CurrentChunk;
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> DecompressedChunk;
-  /// Iterator over DecompressedChunk.
-  decltype(DecompressedChunk)::iterator CurrentID;
+  DocID Current = 0;
+  llvm::ArrayRef<uint8_t> Remaining;
 
   static constexpr size_t ApproxEntriesPerChunk = 15;
 };
@@ -213,7 +235,7 @@ llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
     Delta = *MaybeDelta;
     Result.push_back(Current + Delta);
   }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
+  return Result;
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
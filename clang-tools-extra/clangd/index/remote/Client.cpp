@@ -0,0 +1,130 @@
+//===--- Client.cpp ----------------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Client.h"
+#include "Cancellation.h"
+#include "Index.grpc.pb.h"
+#include "Logger.h"
+#include "Trace.h"
+#include "marshalling/Marshalling.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/StringSaver.h"
+#include <chrono>
+#include <grpcpp/grpcpp.h>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+class IndexClient : public clangd::SymbolIndex {
+  template <typename RequestT, typename ReplyT>
+  using StreamingCall = std::unique_ptr<grpc::ClientReader<ReplyT>> (
+      remote::SymbolIndex::Stub::*)(grpc::ClientContext *, const RequestT &);
+
+  /// Sends \p Request and passes each deserialized result to \p Callback.
+  /// Returns the final_result sent by the server.
+  template <typename RequestT, typename ReplyT, typename CallbackT>
+  bool streamRPC(const RequestT &Request,
+                 StreamingCall<RequestT, ReplyT> RPCCall,
+                 CallbackT Callback) const {
+    trace::Span Tracer(RequestT::descriptor()->name());
+    grpc::ClientContext Context;
+    Context.set_deadline(std::chrono::system_clock::now() + DeadlineWaitingTime);
+    auto Reader = (Stub.get()->*RPCCall)(&Context, Request);
+    // Strings of the results only need to outlive the callbacks.
+    llvm::BumpPtrAllocator Arena;
+    llvm::UniqueStringSaver Strings(Arena);
+    bool FinalResult = false;
+    unsigned Received = 0;
+    ReplyT Reply;
+    while (Reader->Read(&Reply)) {
+      if (isCancelled()) {
+        Context.TryCancel();
+        break;
+      }
+      if (!Reply.has_stream_result()) {
+        FinalResult = Reply.final_result();
+        continue;
+      }
+      auto Result = fromProtobuf(Reply.stream_result(), &Strings, ProjectRoot);
+      if (!Result)
+        continue;
+      Callback(*Result);
+      ++Received;
+    }
+    grpc::Status Status = Reader->Finish();
+    if (!Status.ok() && Status.error_code() != grpc::StatusCode::CANCELLED)
+      elog("Remote index {0} request failed: {1}",
+           RequestT::descriptor()->name(), Status.error_message());
+    SPAN_ATTACH(Tracer, "results", static_cast<int>(Received));
+    return FinalResult;
+  }
+
+public:
+  IndexClient(std::shared_ptr<grpc::Channel> Channel,
+              llvm::StringRef ProjectRoot)
+      : Stub(remote::SymbolIndex::NewStub(Channel)),
+        ProjectRoot(ProjectRoot) {}
+
+  void lookup(const clangd::LookupRequest &Request,
+              llvm::function_ref<void(const clangd::Symbol &)> Callback)
+      const override {
+    streamRPC(toProtobuf(Request), &remote::SymbolIndex::Stub::Lookup,
+              Callback);
+  }
+
+  bool
+  fuzzyFind(const clangd::FuzzyFindRequest &Request,
+            llvm::function_ref<void(const clangd::Symbol &)> Callback)
+      const override {
+    return streamRPC(toProtobuf(Request, ProjectRoot),
+                     &remote::SymbolIndex::Stub::FuzzyFind, Callback);
+  }
+
+  void refs(const clangd::RefsRequest &Request,
+            llvm::function_ref<void(const clangd::Ref &)> Callback)
+      const override {
+    streamRPC(toProtobuf(Request), &remote::SymbolIndex::Stub::Refs, Callback);
+  }
+
+  void relations(const clangd::RelationsRequest &Request,
+                 llvm::function_ref<void(const SymbolID &,
+                                         const clangd::Symbol &)>
+                     Callback) const override {
+    streamRPC(toProtobuf(Request), &remote::SymbolIndex::Stub::Relations,
+              [&](const std::pair<SymbolID, clangd::Symbol> &Relation) {
+                Callback(Relation.first, Relation.second);
+              });
+  }
+
+  // IndexClient does not take any space since the data is stored on the
+  // server.
+  size_t estimateMemoryUsage() const override { return 0; }
+
+private:
+  std::unique_ptr<remote::SymbolIndex::Stub> Stub;
+  std::string ProjectRoot;
+  // Each request will be terminated if it takes too long, a remote index must
+  // never keep code completion or navigation waiting.
+  const std::chrono::seconds DeadlineWaitingTime = std::chrono::seconds(10);
+};
+
+} // namespace
+
+std::unique_ptr<clangd::SymbolIndex> getClient(llvm::StringRef Address,
+                                               llvm::StringRef ProjectRoot) {
+  const auto Channel =
+      grpc::CreateChannel(Address.str(), grpc::InsecureChannelCredentials());
+  Channel->GetState(/*try_to_connect=*/true);
+  return std::make_unique<IndexClient>(Channel, ProjectRoot);
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
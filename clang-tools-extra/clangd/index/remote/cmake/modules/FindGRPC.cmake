@@ -0,0 +1,42 @@
+# Locates gRPC and Protobuf built with CMake and installed to
+# ${GRPC_INSTALL_PATH} (or found on the default search paths) and provides
+# generate_grpc_protos() to compile .proto files into a library.
+set(protobuf_MODULE_COMPATIBLE TRUE)
+find_package(Protobuf CONFIG REQUIRED HINTS ${GRPC_INSTALL_PATH})
+message(STATUS "Using protobuf ${Protobuf_VERSION}")
+find_package(gRPC CONFIG REQUIRED HINTS ${GRPC_INSTALL_PATH})
+message(STATUS "Using gRPC ${gRPC_VERSION}")
+
+include_directories(${Protobuf_INCLUDE_DIRS})
+
+set(GRPC_CPP_PLUGIN $<TARGET_FILE:gRPC::grpc_cpp_plugin>)
+set(PROTOC $<TARGET_FILE:protobuf::protoc>)
+
+# Generates C++ sources for the messages and services of ProtoFile and builds
+# them into LibraryName. The headers are generated into the current binary
+# directory, which is added to the include path of LibraryName's users.
+function(generate_grpc_protos LibraryName ProtoFile)
+  get_filename_component(ProtoSourceAbsolutePath
+    "${CMAKE_CURRENT_SOURCE_DIR}/${ProtoFile}" ABSOLUTE)
+  get_filename_component(ProtoSourcePath ${ProtoSourceAbsolutePath} PATH)
+  get_filename_component(ProtoName ${ProtoFile} NAME_WE)
+
+  set(GeneratedProtoSource "${CMAKE_CURRENT_BINARY_DIR}/${ProtoName}.pb.cc")
+  set(GeneratedProtoHeader "${CMAKE_CURRENT_BINARY_DIR}/${ProtoName}.pb.h")
+  set(GeneratedGRPCSource "${CMAKE_CURRENT_BINARY_DIR}/${ProtoName}.grpc.pb.cc")
+  set(GeneratedGRPCHeader "${CMAKE_CURRENT_BINARY_DIR}/${ProtoName}.grpc.pb.h")
+  add_custom_command(
+    OUTPUT "${GeneratedProtoSource}" "${GeneratedProtoHeader}"
+           "${GeneratedGRPCSource}" "${GeneratedGRPCHeader}"
+    COMMAND ${PROTOC}
+    ARGS --grpc_out="${CMAKE_CURRENT_BINARY_DIR}"
+         --cpp_out="${CMAKE_CURRENT_BINARY_DIR}"
+         --proto_path="${ProtoSourcePath}"
+         --plugin=protoc-gen-grpc="${GRPC_CPP_PLUGIN}"
+         "${ProtoSourceAbsolutePath}"
+    DEPENDS "${ProtoSourceAbsolutePath}")
+
+  add_library(${LibraryName} ${GeneratedProtoSource} ${GeneratedGRPCSource})
+  target_include_directories(${LibraryName} PUBLIC ${CMAKE_CURRENT_BINARY_DIR})
+  target_link_libraries(${LibraryName} PUBLIC gRPC::grpc++ protobuf::libprotobuf)
+endfunction()
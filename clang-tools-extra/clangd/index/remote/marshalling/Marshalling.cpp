@@ -0,0 +1,398 @@
+//===--- Marshalling.cpp -----------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Marshalling.h"
+#include "Headers.h"
+#include "Logger.h"
+#include "URI.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Path.h"
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+namespace {
+
+/// Strips \p Root from the absolute \p Path. Returns None if \p Path is not
+/// inside \p Root.
+llvm::Optional<std::string> makeRelative(llvm::StringRef Path,
+                                         llvm::StringRef Root) {
+  if (Root.empty())
+    return llvm::None;
+  llvm::SmallString<256> Prefix = Root;
+  if (!llvm::sys::path::is_separator(Prefix.back()))
+    Prefix += llvm::sys::path::get_separator();
+  if (!Path.startswith(Prefix) || Path.size() == Prefix.size())
+    return llvm::None;
+  return llvm::sys::path::convert_to_slash(Path.drop_front(Prefix.size()));
+}
+
+/// Prepends \p Root to a '/'-separated relative path.
+std::string makeAbsolute(llvm::StringRef RelativePath, llvm::StringRef Root) {
+  llvm::SmallString<256> Result = Root;
+  llvm::sys::path::append(Result, RelativePath);
+  llvm::sys::path::native(Result);
+  return Result.str();
+}
+
+template <typename MessageT>
+llvm::Optional<llvm::DenseSet<SymbolID>> getIDs(MessageT IDs) {
+  llvm::DenseSet<SymbolID> Result;
+  for (const auto &ID : IDs) {
+    auto SID = SymbolID::fromStr(ID);
+    if (!SID) {
+      elog("Remote index: invalid SymbolID {0}: {1}", ID, SID.takeError());
+      return llvm::None;
+    }
+    Result.insert(*SID);
+  }
+  return Result;
+}
+
+clangd::SymbolLocation::Position fromProtobuf(const Position &Message) {
+  clangd::SymbolLocation::Position Result;
+  Result.setLine(Message.line());
+  Result.setColumn(Message.column());
+  return Result;
+}
+
+Position toProtobuf(const clangd::SymbolLocation::Position &From) {
+  Position Result;
+  Result.set_line(From.line());
+  Result.set_column(From.column());
+  return Result;
+}
+
+llvm::Optional<clangd::SymbolLocation>
+fromProtobuf(const SymbolLocation &Message, llvm::UniqueStringSaver *Strings,
+             llvm::StringRef ProjectRoot) {
+  auto URI = relativePathToURI(Message.file_path(), ProjectRoot);
+  if (!URI)
+    return llvm::None;
+  clangd::SymbolLocation Location;
+  Location.FileURI = Strings->save(*URI).begin();
+  Location.Start = fromProtobuf(Message.start());
+  Location.End = fromProtobuf(Message.end());
+  return Location;
+}
+
+llvm::Optional<SymbolLocation> toProtobuf(const clangd::SymbolLocation &From,
+                                          llvm::StringRef IndexRoot) {
+  auto RelativePath = uriToRelativePath(From.FileURI, IndexRoot);
+  if (!RelativePath)
+    return llvm::None;
+  SymbolLocation Result;
+  Result.set_file_path(*RelativePath);
+  *Result.mutable_start() = toProtobuf(From.Start);
+  *Result.mutable_end() = toProtobuf(From.End);
+  return Result;
+}
+
+clang::index::SymbolInfo fromProtobuf(const SymbolInfo &Message) {
+  clang::index::SymbolInfo Result;
+  Result.Kind = static_cast<clang::index::SymbolKind>(Message.kind());
+  Result.SubKind = static_cast<clang::index::SymbolSubKind>(Message.subkind());
+  Result.Lang = static_cast<clang::index::SymbolLanguage>(Message.language());
+  Result.Properties =
+      static_cast<clang::index::SymbolPropertySet>(Message.properties());
+  return Result;
+}
+
+SymbolInfo toProtobuf(const clang::index::SymbolInfo &From) {
+  SymbolInfo Result;
+  Result.set_kind(static_cast<uint32_t>(From.Kind));
+  Result.set_subkind(static_cast<uint32_t>(From.SubKind));
+  Result.set_language(static_cast<uint32_t>(From.Lang));
+  Result.set_properties(From.Properties);
+  return Result;
+}
+
+} // namespace
+
+llvm::Optional<std::string> uriToRelativePath(llvm::StringRef URI,
+                                              llvm::StringRef IndexRoot) {
+  auto ParsedURI = clangd::URI::parse(URI);
+  if (!ParsedURI) {
+    elog("Remote index: failed to parse URI {0}: {1}", URI,
+         ParsedURI.takeError());
+    return llvm::None;
+  }
+  if (ParsedURI->scheme() != "file")
+    return llvm::None;
+  auto Path = clangd::URI::resolve(*ParsedURI);
+  if (!Path) {
+    elog("Remote index: failed to resolve URI {0}: {1}", URI,
+         Path.takeError());
+    return llvm::None;
+  }
+  return makeRelative(*Path, IndexRoot);
+}
+
+llvm::Optional<std::string> relativePathToURI(llvm::StringRef RelativePath,
+                                              llvm::StringRef ProjectRoot) {
+  if (RelativePath.empty() ||
+      llvm::sys::path::is_absolute(RelativePath,
+                                   llvm::sys::path::Style::posix) ||
+      !llvm::sys::path::is_absolute(ProjectRoot))
+    return llvm::None;
+  return clangd::URI::createFile(makeAbsolute(RelativePath, ProjectRoot))
+      .toString();
+}
+
+LookupRequest toProtobuf(const clangd::LookupRequest &From) {
+  LookupRequest Result;
+  for (const auto &SymbolID : From.IDs)
+    Result.add_ids(SymbolID.str());
+  return Result;
+}
+
+FuzzyFindRequest toProtobuf(const clangd::FuzzyFindRequest &From,
+                            llvm::StringRef ProjectRoot) {
+  FuzzyFindRequest Result;
+  Result.set_query(From.Query);
+  for (const auto &Scope : From.Scopes)
+    Result.add_scopes(Scope);
+  Result.set_any_scope(From.AnyScope);
+  if (From.Limit)
+    Result.set_limit(*From.Limit);
+  Result.set_restricted_for_code_completion(From.RestrictForCodeCompletion);
+  // Proximity paths outside of the project can not be matched on the server.
+  for (const auto &Path : From.ProximityPaths)
+    if (auto RelativePath = makeRelative(Path, ProjectRoot))
+      Result.add_proximity_paths(*RelativePath);
+  for (const auto &Type : From.PreferredTypes)
+    Result.add_preferred_types(Type);
+  return Result;
+}
+
+RefsRequest toProtobuf(const clangd::RefsRequest &From) {
+  RefsRequest Result;
+  for (const auto &SymbolID : From.IDs)
+    Result.add_ids(SymbolID.str());
+  Result.set_filter(static_cast<uint32_t>(From.Filter));
+  if (From.Limit)
+    Result.set_limit(*From.Limit);
+  return Result;
+}
+
+RelationsRequest toProtobuf(const clangd::RelationsRequest &From) {
+  RelationsRequest Result;
+  for (const auto &SymbolID : From.Subjects)
+    Result.add_subjects(SymbolID.str());
+  Result.set_predicate(static_cast<uint32_t>(From.Predicate));
+  if (From.Limit)
+    Result.set_limit(*From.Limit);
+  return Result;
+}
+
+llvm::Optional<clangd::Symbol> fromProtobuf(const Symbol &Message,
+                                            llvm::UniqueStringSaver *Strings,
+                                            llvm::StringRef ProjectRoot) {
+  if (!Message.has_info() || !Message.has_canonical_declaration()) {
+    elog("Remote index: cannot convert Symbol without info or declaration");
+    return llvm::None;
+  }
+  auto ID = SymbolID::fromStr(Message.id());
+  if (!ID) {
+    elog("Remote index: invalid SymbolID {0}: {1}", Message.id(),
+         ID.takeError());
+    return llvm::None;
+  }
+  clangd::Symbol Result;
+  Result.ID = *ID;
+  Result.SymInfo = fromProtobuf(Message.info());
+  Result.Name = Strings->save(Message.name());
+  Result.Scope = Strings->save(Message.scope());
+  auto Declaration = fromProtobuf(Message.canonical_declaration(), Strings,
+                                  ProjectRoot);
+  if (!Declaration)
+    return llvm::None;
+  Result.CanonicalDeclaration = *Declaration;
+  if (Message.has_definition()) {
+    auto Definition =
+        fromProtobuf(Message.definition(), Strings, ProjectRoot);
+    if (Definition)
+      Result.Definition = *Definition;
+  }
+  Result.References = Message.references();
+  Result.Origin = static_cast<clangd::SymbolOrigin>(Message.origin());
+  Result.Signature = Strings->save(Message.signature());
+  Result.TemplateSpecializationArgs =
+      Strings->save(Message.template_specialization_args());
+  Result.CompletionSnippetSuffix =
+      Strings->save(Message.completion_snippet_suffix());
+  Result.Documentation = Strings->save(Message.documentation());
+  Result.ReturnType = Strings->save(Message.return_type());
+  Result.Type = Strings->save(Message.type());
+  for (const auto &Header : Message.headers()) {
+    llvm::StringRef Spelling = Header.header();
+    if (!isLiteralInclude(Spelling)) {
+      auto URI = relativePathToURI(Spelling, ProjectRoot);
+      if (!URI)
+        continue;
+      Spelling = Strings->save(*URI);
+    } else {
+      Spelling = Strings->save(Spelling);
+    }
+    Result.IncludeHeaders.emplace_back(Spelling, Header.references());
+  }
+  Result.Flags = static_cast<clangd::Symbol::SymbolFlag>(Message.flags());
+  return Result;
+}
+
+llvm::Optional<clangd::Ref> fromProtobuf(const Ref &Message,
+                                         llvm::UniqueStringSaver *Strings,
+                                         llvm::StringRef ProjectRoot) {
+  if (!Message.has_location()) {
+    elog("Remote index: cannot convert Ref without location");
+    return llvm::None;
+  }
+  auto Location = fromProtobuf(Message.location(), Strings, ProjectRoot);
+  if (!Location)
+    return llvm::None;
+  clangd::Ref Result;
+  Result.Location = *Location;
+  Result.Kind = static_cast<clangd::RefKind>(Message.kind());
+  return Result;
+}
+
+llvm::Optional<std::pair<clangd::SymbolID, clangd::Symbol>>
+fromProtobuf(const Relation &Message, llvm::UniqueStringSaver *Strings,
+             llvm::StringRef ProjectRoot) {
+  auto Subject = SymbolID::fromStr(Message.subject_id());
+  if (!Subject) {
+    elog("Remote index: invalid SymbolID {0}: {1}", Message.subject_id(),
+         Subject.takeError());
+    return llvm::None;
+  }
+  auto Object = fromProtobuf(Message.object(), Strings, ProjectRoot);
+  if (!Object)
+    return llvm::None;
+  return std::make_pair(*Subject, *Object);
+}
+
+llvm::Optional<clangd::LookupRequest>
+fromProtobuf(const LookupRequest *Message) {
+  auto IDs = getIDs(Message->ids());
+  if (!IDs)
+    return llvm::None;
+  clangd::LookupRequest Result;
+  Result.IDs = std::move(*IDs);
+  return Result;
+}
+
+clangd::FuzzyFindRequest fromProtobuf(const FuzzyFindRequest *Message,
+                                      llvm::StringRef IndexRoot) {
+  clangd::FuzzyFindRequest Result;
+  Result.Query = Message->query();
+  for (const auto &Scope : Message->scopes())
+    Result.Scopes.push_back(Scope);
+  Result.AnyScope = Message->any_scope();
+  if (Message->has_limit())
+    Result.Limit = Message->limit();
+  Result.RestrictForCodeCompletion = Message->restricted_for_code_completion();
+  for (const auto &Path : Message->proximity_paths())
+    if (!Path.empty() &&
+        !llvm::sys::path::is_absolute(Path, llvm::sys::path::Style::posix))
+      Result.ProximityPaths.push_back(makeAbsolute(Path, IndexRoot));
+  for (const auto &Type : Message->preferred_types())
+    Result.PreferredTypes.push_back(Type);
+  return Result;
+}
+
+llvm::Optional<clangd::RefsRequest> fromProtobuf(const RefsRequest *Message) {
+  auto IDs = getIDs(Message->ids());
+  if (!IDs)
+    return llvm::None;
+  clangd::RefsRequest Result;
+  Result.IDs = std::move(*IDs);
+  if (Message->has_filter())
+    Result.Filter = static_cast<clangd::RefKind>(Message->filter());
+  if (Message->has_limit())
+    Result.Limit = Message->limit();
+  return Result;
+}
+
+llvm::Optional<clangd::RelationsRequest>
+fromProtobuf(const RelationsRequest *Message) {
+  auto IDs = getIDs(Message->subjects());
+  if (!IDs)
+    return llvm::None;
+  clangd::RelationsRequest Result;
+  Result.Subjects = std::move(*IDs);
+  Result.Predicate = static_cast<clang::index::SymbolRole>(Message->predicate());
+  if (Message->has_limit())
+    Result.Limit = Message->limit();
+  return Result;
+}
+
+llvm::Optional<Symbol> toProtobuf(const clangd::Symbol &From,
+                                  llvm::StringRef IndexRoot) {
+  auto Declaration = toProtobuf(From.CanonicalDeclaration, IndexRoot);
+  if (!Declaration)
+    return llvm::None;
+  Symbol Result;
+  Result.set_id(From.ID.str());
+  *Result.mutable_info() = toProtobuf(From.SymInfo);
+  Result.set_name(From.Name);
+  Result.set_scope(From.Scope);
+  *Result.mutable_canonical_declaration() = *Declaration;
+  if (From.Definition)
+    if (auto Definition = toProtobuf(From.Definition, IndexRoot))
+      *Result.mutable_definition() = *Definition;
+  Result.set_references(From.References);
+  Result.set_origin(static_cast<uint32_t>(From.Origin));
+  Result.set_signature(From.Signature);
+  Result.set_template_specialization_args(From.TemplateSpecializationArgs);
+  Result.set_completion_snippet_suffix(From.CompletionSnippetSuffix);
+  Result.set_documentation(From.Documentation);
+  Result.set_return_type(From.ReturnType);
+  Result.set_type(From.Type);
+  for (const auto &Header : From.IncludeHeaders) {
+    std::string Spelling = Header.IncludeHeader;
+    if (!isLiteralInclude(Spelling)) {
+      auto RelativePath = uriToRelativePath(Spelling, IndexRoot);
+      if (!RelativePath)
+        continue;
+      Spelling = std::move(*RelativePath);
+    }
+    auto *NextHeader = Result.add_headers();
+    NextHeader->set_header(Spelling);
+    NextHeader->set_references(Header.References);
+  }
+  Result.set_flags(static_cast<uint32_t>(From.Flags));
+  return Result;
+}
+
+llvm::Optional<Ref> toProtobuf(const clangd::Ref &From,
+                               llvm::StringRef IndexRoot) {
+  auto Location = toProtobuf(From.Location, IndexRoot);
+  if (!Location)
+    return llvm::None;
+  Ref Result;
+  *Result.mutable_location() = *Location;
+  Result.set_kind(static_cast<uint32_t>(From.Kind));
+  return Result;
+}
+
+llvm::Optional<Relation> toProtobuf(const clangd::SymbolID &Subject,
+                                    const clangd::Symbol &Object,
+                                    llvm::StringRef IndexRoot) {
+  auto SerializedObject = toProtobuf(Object, IndexRoot);
+  if (!SerializedObject)
+    return llvm::None;
+  Relation Result;
+  Result.set_subject_id(Subject.str());
+  *Result.mutable_object() = *SerializedObject;
+  return Result;
+}
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
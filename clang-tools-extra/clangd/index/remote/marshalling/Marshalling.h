@@ -0,0 +1,81 @@
+//===--- Marshalling.h -------------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Marshalling provides translation between native clangd types into the
+// Protobuf-generated classes. Most translations are 1-to-1 and wrap variables
+// into appropriate Protobuf types.
+//
+// Locations are sent over the wire as paths relative to the project root,
+// because the server and its clients usually have the sources checked out in
+// different directories. The server strips its IndexRoot from the URIs stored
+// in the index, the client prepends its ProjectRoot and builds a file URI.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_MARSHALLING_H
+#define LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_MARSHALLING_H
+
+#include "Index.pb.h"
+#include "index/Index.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/Support/StringSaver.h"
+
+namespace clang {
+namespace clangd {
+namespace remote {
+
+// Client side: clangd requests are serialized, results are deserialized.
+LookupRequest toProtobuf(const clangd::LookupRequest &From);
+FuzzyFindRequest toProtobuf(const clangd::FuzzyFindRequest &From,
+                            llvm::StringRef ProjectRoot);
+RefsRequest toProtobuf(const clangd::RefsRequest &From);
+RelationsRequest toProtobuf(const clangd::RelationsRequest &From);
+
+/// Strings of the returned values are owned by \p Strings.
+llvm::Optional<clangd::Symbol> fromProtobuf(const Symbol &Message,
+                                            llvm::UniqueStringSaver *Strings,
+                                            llvm::StringRef ProjectRoot);
+llvm::Optional<clangd::Ref> fromProtobuf(const Ref &Message,
+                                         llvm::UniqueStringSaver *Strings,
+                                         llvm::StringRef ProjectRoot);
+llvm::Optional<std::pair<clangd::SymbolID, clangd::Symbol>>
+fromProtobuf(const Relation &Message, llvm::UniqueStringSaver *Strings,
+             llvm::StringRef ProjectRoot);
+
+// Server side: requests are deserialized, results are serialized.
+llvm::Optional<clangd::LookupRequest> fromProtobuf(const LookupRequest *Message);
+clangd::FuzzyFindRequest fromProtobuf(const FuzzyFindRequest *Message,
+                                      llvm::StringRef IndexRoot);
+llvm::Optional<clangd::RefsRequest> fromProtobuf(const RefsRequest *Message);
+llvm::Optional<clangd::RelationsRequest>
+fromProtobuf(const RelationsRequest *Message);
+
+/// Returns None if a location of \p From can not be expressed relative to
+/// \p IndexRoot.
+llvm::Optional<Symbol> toProtobuf(const clangd::Symbol &From,
+                                  llvm::StringRef IndexRoot);
+llvm::Optional<Ref> toProtobuf(const clangd::Ref &From,
+                               llvm::StringRef IndexRoot);
+llvm::Optional<Relation> toProtobuf(const clangd::SymbolID &Subject,
+                                    const clangd::Symbol &Object,
+                                    llvm::StringRef IndexRoot);
+
+/// Translates \p URI of a file under \p IndexRoot into a path relative to
+/// \p IndexRoot with '/' as separator. Returns None for other URIs.
+llvm::Optional<std::string> uriToRelativePath(llvm::StringRef URI,
+                                              llvm::StringRef IndexRoot);
+/// Translates \p RelativePath received from the server into a file URI of the
+/// corresponding file under \p ProjectRoot.
+llvm::Optional<std::string> relativePathToURI(llvm::StringRef RelativePath,
+                                              llvm::StringRef ProjectRoot);
+
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+#endif // LLVM_CLANG_TOOLS_EXTRA_CLANGD_INDEX_REMOTE_MARSHALLING_H
@@ -0,0 +1,183 @@
+//===--- Server.cpp - gRPC-based Remote Index Server ---------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Index.grpc.pb.h"
+#include "Logger.h"
+#include "index/Index.h"
+#include "index/Serialization.h"
+#include "index/remote/marshalling/Marshalling.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Signals.h"
+#include <grpcpp/grpcpp.h>
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+const std::string Overview = R"(
+This is an experimental remote index implementation. The server opens a Dex
+index built by clangd-indexer and serves its symbols, references and relations
+over gRPC, so that clients don't have to index the whole project themselves.
+)";
+
+llvm::cl::opt<std::string> IndexPath(llvm::cl::desc("<INDEX FILE>"),
+                                     llvm::cl::Positional, llvm::cl::Required);
+
+llvm::cl::opt<std::string> IndexRoot(llvm::cl::desc("<PROJECT ROOT>"),
+                                     llvm::cl::Positional, llvm::cl::Required);
+
+llvm::cl::opt<std::string> ServerAddress(
+    "server-address", llvm::cl::init("0.0.0.0:50051"),
+    llvm::cl::desc("Address of the invoked server. Defaults to 0.0.0.0:50051"));
+
+class RemoteIndexServer final : public SymbolIndex::Service {
+public:
+  RemoteIndexServer(std::unique_ptr<clangd::SymbolIndex> Index,
+                    llvm::StringRef IndexRoot)
+      : Index(std::move(Index)), IndexRoot(IndexRoot) {}
+
+private:
+  grpc::Status Lookup(grpc::ServerContext *Context,
+                      const LookupRequest *Request,
+                      grpc::ServerWriter<LookupReply> *Reply) override {
+    auto Req = fromProtobuf(Request);
+    if (!Req)
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "invalid symbol ID");
+    Index->lookup(*Req, [&](const clangd::Symbol &Sym) {
+      if (Context->IsCancelled())
+        return;
+      auto Serialized = toProtobuf(Sym, IndexRoot);
+      if (!Serialized)
+        return;
+      LookupReply NextMessage;
+      *NextMessage.mutable_stream_result() = *Serialized;
+      Reply->Write(NextMessage);
+    });
+    return finish<LookupReply>(Context, Reply, /*FinalResult=*/true);
+  }
+
+  grpc::Status FuzzyFind(grpc::ServerContext *Context,
+                         const FuzzyFindRequest *Request,
+                         grpc::ServerWriter<FuzzyFindReply> *Reply) override {
+    bool HasMore =
+        Index->fuzzyFind(fromProtobuf(Request, IndexRoot),
+                         [&](const clangd::Symbol &Sym) {
+                           if (Context->IsCancelled())
+                             return;
+                           auto Serialized = toProtobuf(Sym, IndexRoot);
+                           if (!Serialized)
+                             return;
+                           FuzzyFindReply NextMessage;
+                           *NextMessage.mutable_stream_result() = *Serialized;
+                           Reply->Write(NextMessage);
+                         });
+    return finish<FuzzyFindReply>(Context, Reply, HasMore);
+  }
+
+  grpc::Status Refs(grpc::ServerContext *Context, const RefsRequest *Request,
+                    grpc::ServerWriter<RefsReply> *Reply) override {
+    auto Req = fromProtobuf(Request);
+    if (!Req)
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "invalid symbol ID");
+    Index->refs(*Req, [&](const clangd::Ref &Reference) {
+      if (Context->IsCancelled())
+        return;
+      auto Serialized = toProtobuf(Reference, IndexRoot);
+      if (!Serialized)
+        return;
+      RefsReply NextMessage;
+      *NextMessage.mutable_stream_result() = *Serialized;
+      Reply->Write(NextMessage);
+    });
+    return finish<RefsReply>(Context, Reply, /*FinalResult=*/true);
+  }
+
+  grpc::Status Relations(grpc::ServerContext *Context,
+                         const RelationsRequest *Request,
+                         grpc::ServerWriter<RelationsReply> *Reply) override {
+    auto Req = fromProtobuf(Request);
+    if (!Req)
+      return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "invalid symbol ID");
+    Index->relations(*Req, [&](const SymbolID &Subject,
+                               const clangd::Symbol &Object) {
+      if (Context->IsCancelled())
+        return;
+      auto Serialized = toProtobuf(Subject, Object, IndexRoot);
+      if (!Serialized)
+        return;
+      RelationsReply NextMessage;
+      *NextMessage.mutable_stream_result() = *Serialized;
+      Reply->Write(NextMessage);
+    });
+    return finish<RelationsReply>(Context, Reply, /*FinalResult=*/true);
+  }
+
+  /// Terminates the stream of results with \p FinalResult.
+  template <typename ReplyT>
+  grpc::Status finish(grpc::ServerContext *Context,
+                      grpc::ServerWriter<ReplyT> *Reply, bool FinalResult) {
+    if (Context->IsCancelled())
+      return grpc::Status::CANCELLED;
+    ReplyT LastMessage;
+    LastMessage.set_final_result(FinalResult);
+    Reply->Write(LastMessage);
+    return grpc::Status::OK;
+  }
+
+  std::unique_ptr<clangd::SymbolIndex> Index;
+  std::string IndexRoot;
+};
+
+void runServer(std::unique_ptr<clangd::SymbolIndex> Index,
+               const std::string &ServerAddress) {
+  RemoteIndexServer Service(std::move(Index), IndexRoot);
+
+  grpc::EnableDefaultHealthCheckService(true);
+  grpc::ServerBuilder Builder;
+  Builder.AddListeningPort(ServerAddress, grpc::InsecureServerCredentials());
+  Builder.RegisterService(&Service);
+  std::unique_ptr<grpc::Server> Server(Builder.BuildAndStart());
+  if (!Server) {
+    elog("Failed to start server on {0}", ServerAddress);
+    return;
+  }
+  log("Server listening on {0}", ServerAddress);
+
+  Server->Wait();
+}
+
+} // namespace
+} // namespace remote
+} // namespace clangd
+} // namespace clang
+
+int main(int argc, char *argv[]) {
+  using namespace clang::clangd::remote;
+  llvm::cl::ParseCommandLineOptions(argc, argv, Overview);
+  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+
+  if (!llvm::sys::path::is_absolute(IndexRoot)) {
+    llvm::errs() << "Index root should be an absolute path.\n";
+    return -1;
+  }
+
+  std::unique_ptr<clang::clangd::SymbolIndex> Index =
+      clang::clangd::loadIndex(IndexPath, /*UseDex=*/true);
+  if (!Index) {
+    llvm::errs() << "Failed to open the index.\n";
+    return -1;
+  }
+
+  runServer(std::move(Index), ServerAddress);
+}
@@ -15,6 +15,9 @@
 #include "Transport.h"
 #include "index/Background.h"
 #include "index/Serialization.h"
+#if CLANGD_ENABLE_REMOTE
+#include "index/remote/Client.h"
+#endif
 #include "clang/Basic/Version.h"
 #include "clang/Format/Format.h"
 #include "llvm/ADT/Optional.h"
@@ -255,6 +258,24 @@ opt<bool> SuggestMissingIncludes{
     init(true),
 };
 
+opt<std::string> DiagnosticsCacheDir{
+    "diagnostics-cache-dir",
+    cat(Features),
+    desc("Store the last diagnostics of each file in this directory, and show "
+         "them immediately when the file is reopened unchanged"),
+    init(""),
+    Hidden,
+};
+
+opt<bool> SkipUnchangedFunctionBodies{
+    "skip-unchanged-function-bodies",
+    cat(Features),
+    desc("Publish diagnostics for edits from a quick reparse that skips "
+         "function bodies not touched by the edit"),
+    init(false),
+    Hidden,
+};
+
 list<std::string> TweakList{
     "tweaks",
     cat(Features),
@@ -283,6 +304,26 @@ opt<Path> IndexFile{
     Hidden,
 };
 
+#if CLANGD_ENABLE_REMOTE
+opt<std::string> RemoteIndexAddress{
+    "remote-index-address",
+    cat(Misc),
+    desc("Address of the remote index server (clangd-index-server) to use "
+         "as the static index. Background indexing is disabled, open files "
+         "are still indexed locally"),
+    init(""),
+    Hidden,
+};
+
+opt<Path> ProjectRoot{
+    "project-root",
+    cat(Misc),
+    desc("Path to the project root. Requires remote-index-address to be set"),
+    init(""),
+    Hidden,
+};
+#endif
+
 opt<bool> Test{
     "lit-test",
     cat(Misc),
@@ -592,6 +633,24 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     if (Sync)
       AsyncIndexLoad.wait();
   }
+#if CLANGD_ENABLE_REMOTE
+  if (RemoteIndexAddress.empty() != ProjectRoot.empty()) {
+    llvm::errs() << "remote-index-address and project-root have to be "
+                    "specified at the same time.\n";
+    return 1;
+  }
+  if (EnableIndex && !RemoteIndexAddress.empty()) {
+    if (IndexFile.empty()) {
+      log("Connecting to remote index at {0}", RemoteIndexAddress);
+      StaticIdx = remote::getClient(RemoteIndexAddress, ProjectRoot);
+      // The remote index covers the project, only index the open files.
+      Opts.BackgroundIndex = false;
+    } else {
+      elog("When enabling remote index, index-file should not be specified. "
+           "Only one can be used at a time, remote index will be ignored.");
+    }
+  }
+#endif
   Opts.StaticIndex = StaticIdx.get();
   Opts.AsyncThreadsCount = WorkerThreadsCount;
 
@@ -607,6 +666,7 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     CCOpts.IncludeIndicator.NoInsert.clear();
   }
   CCOpts.SpeculativeIndexRequest = Opts.StaticIndex;
+  CCOpts.ReusePreviousResults = true;
   CCOpts.EnableFunctionArgSnippets = EnableFunctionArgSnippets;
   CCOpts.AllScopes = AllScopesCompletion;
   CCOpts.RunParser = CodeCompletionParse;
@@ -653,6 +713,9 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     };
   }
   Opts.SuggestMissingIncludes = SuggestMissingIncludes;
+  Opts.SkipUnchangedFunctionBodies = SkipUnchangedFunctionBodies;
+  if (!DiagnosticsCacheDir.empty())
+    Opts.DiagnosticsCacheDir = DiagnosticsCacheDir;
   Opts.QueryDriverGlobs = std::move(QueryDriverGlobs);
 
   Opts.TweakFilter = [&](const Tweak &T) {
@@ -2121,6 +2121,43 @@ TEST(CompletionTest, EnableSpeculativeIndexRequest) {
   ASSERT_EQ(Reqs3.size(), 2u);
 }
 
+TEST(CompletionTest, ReusePreviousResults) {
+  MockFSProvider FS;
+  MockCompilationDatabase CDB;
+  IgnoreDiagnostics DiagConsumer;
+  ClangdServer Server(CDB, FS, DiagConsumer, ClangdServer::optsForTest());
+
+  auto File = testPath("foo.cpp");
+  clangd::CodeCompleteOptions Opts = {};
+  IndexRequestCollector Requests;
+  Opts.Index = &Requests;
+  Opts.ReusePreviousResults = true;
+
+  auto CompleteAt = [&](llvm::StringRef Code) {
+    Annotations Test(Code);
+    runAddDocument(Server, File, Test.code());
+    return cantFail(runCodeComplete(Server, File, Test.point(), Opts));
+  };
+  const char *Decls = "int abcd; int abxy; int zzz;\n";
+
+  auto Results = CompleteAt(std::string(Decls) + "void f() { ab^ }");
+  EXPECT_THAT(Results.Completions,
+              AllOf(Contains(Named("abcd")), Contains(Named("abxy"))));
+  EXPECT_EQ(Requests.consumeRequests().size(), 1u);
+
+  // Typing more of the identifier refilters the previous results.
+  Results = CompleteAt(std::string(Decls) + "void f() { abc^ }");
+  EXPECT_THAT(Results.Completions, Contains(Named("abcd")));
+  EXPECT_THAT(Results.Completions, Not(Contains(Named("abxy"))));
+  EXPECT_EQ(Requests.consumeRequests().size(), 0u);
+
+  // Any other edit runs code completion again.
+  Results = CompleteAt(std::string(Decls) + "int abcz;\nvoid f() { abc^ }");
+  EXPECT_THAT(Results.Completions,
+              AllOf(Contains(Named("abcd")), Contains(Named("abcz"))));
+  EXPECT_EQ(Requests.consumeRequests().size(), 1u);
+}
+
 TEST(CompletionTest, InsertTheMostPopularHeader) {
   std::string DeclFile = URI::create(testPath("foo")).toString();
   Symbol sym = func("Func");
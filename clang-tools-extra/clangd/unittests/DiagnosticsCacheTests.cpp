@@ -0,0 +1,105 @@
+//===-- DiagnosticsCacheTests.cpp -------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "DiagnosticsCache.h"
+#include "TestFS.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace clang {
+namespace clangd {
+namespace {
+
+class DiagnosticsCacheTest : public ::testing::Test {
+protected:
+  DiagnosticsCacheTest() {
+    EXPECT_FALSE(llvm::sys::fs::createUniqueDirectory("clangd-diags-test", Root))
+        << "Failed to create unique directory";
+  }
+
+  ~DiagnosticsCacheTest() {
+    EXPECT_FALSE(llvm::sys::fs::remove_directories(Root))
+        << "Failed to cleanup " << Root;
+  }
+
+  llvm::SmallString<128> Root;
+};
+
+Diag makeDiag() {
+  Diag D;
+  D.Message = "use of undeclared identifier 'foo'";
+  D.File = testPath("foo.cpp");
+  D.AbsFile = D.File;
+  D.Range = {{1, 2}, {1, 5}};
+  D.Severity = DiagnosticsEngine::Error;
+  D.Category = "Semantic Issue";
+  D.InsideMainFile = true;
+  D.ID = 42;
+  D.Name = "undeclared_var_use";
+  D.Source = Diag::Clang;
+  Note N;
+  N.Message = "declared here";
+  N.File = testPath("foo.h");
+  N.Range = {{3, 0}, {3, 4}};
+  D.Notes.push_back(N);
+  Fix F;
+  F.Message = "change 'foo' to 'bar'";
+  F.Edits.push_back(TextEdit{D.Range, "bar"});
+  D.Fixes.push_back(F);
+  return D;
+}
+
+TEST_F(DiagnosticsCacheTest, RoundTrip) {
+  DiagnosticsCache Cache(Root);
+  std::string File = testPath("foo.cpp");
+  ASSERT_FALSE(Cache.load(File, "int x = foo;"));
+
+  Diag D = makeDiag();
+  ASSERT_FALSE(bool(Cache.store(File, "int x = foo;", {D})));
+  auto Loaded = Cache.load(File, "int x = foo;");
+  ASSERT_TRUE(Loaded);
+  ASSERT_EQ(Loaded->size(), 1u);
+  const Diag &L = Loaded->front();
+  EXPECT_EQ(L.Message, D.Message);
+  EXPECT_EQ(L.File, D.File);
+  EXPECT_EQ(L.AbsFile, D.AbsFile);
+  EXPECT_EQ(L.Range, D.Range);
+  EXPECT_EQ(L.Severity, D.Severity);
+  EXPECT_EQ(L.Category, D.Category);
+  EXPECT_EQ(L.InsideMainFile, D.InsideMainFile);
+  EXPECT_EQ(L.ID, D.ID);
+  EXPECT_EQ(L.Name, D.Name);
+  EXPECT_EQ(L.Source, D.Source);
+  ASSERT_EQ(L.Notes.size(), 1u);
+  EXPECT_EQ(L.Notes[0].Message, D.Notes[0].Message);
+  EXPECT_EQ(L.Notes[0].Range, D.Notes[0].Range);
+  ASSERT_EQ(L.Fixes.size(), 1u);
+  EXPECT_EQ(L.Fixes[0].Message, D.Fixes[0].Message);
+  ASSERT_EQ(L.Fixes[0].Edits.size(), 1u);
+  EXPECT_EQ(L.Fixes[0].Edits[0], D.Fixes[0].Edits[0]);
+}
+
+TEST_F(DiagnosticsCacheTest, IgnoresChangedContents) {
+  DiagnosticsCache Cache(Root);
+  std::string File = testPath("foo.cpp");
+  ASSERT_FALSE(bool(Cache.store(File, "int x = foo;", {makeDiag()})));
+  EXPECT_FALSE(Cache.load(File, "int x = bar;"));
+  EXPECT_FALSE(Cache.load(testPath("bar.cpp"), "int x = foo;"));
+  // Storing again replaces the entry.
+  ASSERT_FALSE(bool(Cache.store(File, "int x = bar;", {})));
+  EXPECT_FALSE(Cache.load(File, "int x = foo;"));
+  auto Loaded = Cache.load(File, "int x = bar;");
+  ASSERT_TRUE(Loaded);
+  EXPECT_TRUE(Loaded->empty());
+}
+
+} // namespace
+} // namespace clangd
+} // namespace clang
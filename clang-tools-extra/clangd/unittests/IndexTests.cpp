@@ -115,6 +115,33 @@ TEST(RelationSlab, Duplicates) {
                         Relation{A, index::SymbolRole::RelationBaseOf, C}));
 }
 
+TEST(RefSlab, Duplicates) {
+  SymbolID A{"A"};
+  SymbolID B{"B"};
+  std::string FooURI = "unittest:///foo.cc";
+  std::string FooURICopy = FooURI;
+
+  Ref R1;
+  R1.Kind = RefKind::Reference;
+  R1.Location.FileURI = FooURI.c_str();
+  R1.Location.Start.setLine(1);
+  Ref R2 = R1;
+  R2.Location.Start.setLine(2);
+  Ref R1Copy = R1;
+  R1Copy.Location.FileURI = FooURICopy.c_str();
+
+  RefSlab::Builder Builder;
+  Builder.insert(B, R1);
+  Builder.insert(A, R2);
+  Builder.insert(A, R1);
+  Builder.insert(A, R1Copy);
+
+  RefSlab Slab = std::move(Builder).build();
+  EXPECT_EQ(Slab.numRefs(), 3u);
+  EXPECT_THAT(Slab, UnorderedElementsAre(Pair(A, ElementsAre(R1, R2)),
+                                         Pair(B, ElementsAre(R1))));
+}
+
 TEST(SwapIndexTest, OldIndexRecycled) {
   auto Token = std::make_shared<int>();
   std::weak_ptr<int> WeakToken = Token;
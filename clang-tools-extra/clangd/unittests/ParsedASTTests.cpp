@@ -34,6 +34,7 @@ namespace {
 using ::testing::AllOf;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
 
 MATCHER_P(DeclNamed, Name, "") {
   if (NamedDecl *ND = dyn_cast<NamedDecl>(arg))
@@ -277,6 +278,60 @@ TEST(ParsedASTTest, CollectsMainFileMacroExpansions) {
   EXPECT_EQ(MacroExpansionPositions, TestCase.points());
 }
 
+TEST(ParsedASTTest, SkipsUnchangedFunctionBodies) {
+  TestTU TU = TestTU::withCode(R"cpp(
+    void edited() { int X = 1; }
+    void unchanged() { undeclared(); }
+  )cpp");
+  ParsedAST Before = TU.build();
+  ASSERT_EQ(Before.getDiagnostics().size(), 1u);
+  PreviousBuild Previous(TU.Code, Before);
+
+  Annotations After(R"cpp(
+    // A new line moves everything below.
+    void edited() { int X = 1 + 1; }
+    void unchanged() { $undeclared[[undeclared]](); }
+  )cpp");
+  TU.Code = After.code();
+  TU.Previous = &Previous;
+  ParsedAST AST = TU.build();
+  ASSERT_EQ(AST.getSkippedFunctionBodies().size(), 1u);
+  EXPECT_EQ(AST.getSkippedFunctionBodies()[0].DeclLine, 3u);
+  // The diagnostic inside the skipped body is carried over and moved.
+  ASSERT_EQ(AST.getDiagnostics().size(), 1u);
+  EXPECT_EQ(AST.getDiagnostics()[0].Range, After.range("undeclared"));
+  EXPECT_EQ(AST.getDiagnostics()[0].Message,
+            Before.getDiagnostics()[0].Message);
+}
+
+TEST(ParsedASTTest, SkippedFunctionBodiesHideBodyDependentDiagnostics) {
+  TestTU TU = TestTU::withCode(R"cpp(
+    static void helper() {}
+    void edited() { int X = 1; (void)X; }
+    void caller() { helper(); }
+  )cpp");
+  TU.ExtraArgs = {"-Wunused"};
+  ParsedAST Before = TU.build();
+  EXPECT_THAT(Before.getDiagnostics(), IsEmpty());
+  PreviousBuild Previous(TU.Code, Before);
+
+  // helper() is only used in the body of caller(), which is skipped, so it
+  // would look unused.
+  TU.Code = R"cpp(
+    static void helper() {}
+    void edited() { int X = 2; (void)X; }
+    void caller() { helper(); }
+  )cpp";
+  TU.Previous = &Previous;
+  ParsedAST AST = TU.build();
+  ASSERT_FALSE(AST.getSkippedFunctionBodies().empty());
+  EXPECT_THAT(AST.getDiagnostics(), IsEmpty());
+
+  // The same file parsed completely has no warning either.
+  TU.Previous = nullptr;
+  EXPECT_THAT(TU.build().getDiagnostics(), IsEmpty());
+}
+
 } // namespace
 } // namespace clangd
 } // namespace clang
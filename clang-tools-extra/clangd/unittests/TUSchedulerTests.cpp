@@ -556,6 +556,44 @@ TEST_F(TUSchedulerTests, EmptyPreamble) {
       });
 }
 
+TEST_F(TUSchedulerTests, ReusesPreambleOfClosedFile) {
+  TUScheduler S(CDB,
+                /*AsyncThreadsCount=*/getDefaultAsyncThreadsCount(),
+                /*StorePreambleInMemory=*/true, /*ASTCallbacks=*/nullptr,
+                /*UpdateDebounce=*/std::chrono::steady_clock::duration::zero(),
+                ASTRetentionPolicy());
+
+  auto Foo = testPath("foo.cpp");
+  auto Header = testPath("foo.h");
+  Files[Header] = "void foo();";
+  Timestamps[Header] = time_t(0);
+  auto Contents = R"cpp(
+    #include "foo.h"
+    int main() { foo(); }
+  )cpp";
+
+  auto GetPreamble = [&]() {
+    const PreambleData *Result = nullptr;
+    S.runWithPreamble("GetPreamble", Foo, TUScheduler::Stale,
+                      [&](Expected<InputsAndPreamble> IP) {
+                        Result = cantFail(std::move(IP)).Preamble;
+                      });
+    EXPECT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+    return Result;
+  };
+
+  S.update(Foo, getInputs(Foo, Contents), WantDiagnostics::No);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  const PreambleData *Preamble = GetPreamble();
+  ASSERT_TRUE(Preamble);
+
+  // Reopening the file with the same contents reuses the retained preamble.
+  S.remove(Foo);
+  S.update(Foo, getInputs(Foo, Contents), WantDiagnostics::No);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_EQ(GetPreamble(), Preamble);
+}
+
 TEST_F(TUSchedulerTests, RunWaitsForPreamble) {
   // Testing strategy: we update the file and schedule a few preamble reads at
   // the same time. All reads should get the same non-null preamble.
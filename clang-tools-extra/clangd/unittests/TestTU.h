@@ -60,6 +60,8 @@ struct TestTU {
   llvm::Optional<std::string> ClangTidyWarningsAsErrors;
   // Index to use when building AST.
   const SymbolIndex *ExternalIndex = nullptr;
+  // Previous build to skip unchanged function bodies against.
+  const PreviousBuild *Previous = nullptr;
 
   // Simulate a header guard of the header (using an #import directive).
   bool ImplicitHeaderGuard = true;
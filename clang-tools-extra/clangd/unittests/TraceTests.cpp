@@ -10,6 +10,7 @@
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/YAMLParser.h"
@@ -122,6 +123,36 @@ TEST(TraceTest, SmokeTest) {
   ASSERT_EQ(++Prop, Root->end());
 }
 
+TEST(TraceTest, Metrics) {
+  class RecordingTracer : public trace::EventTracer {
+  public:
+    Context beginSpan(llvm::StringRef, llvm::json::Object *) override {
+      return Context::current().clone();
+    }
+    void instant(llvm::StringRef, llvm::json::Object &&) override {}
+    void record(const trace::Metric &Metric, double Value,
+                llvm::StringRef Label) override {
+      Recorded.push_back(
+          llvm::formatv("{0}/{1}={2}", Metric.Name, Label, Value).str());
+    }
+
+    std::vector<std::string> Recorded;
+  };
+
+  constexpr trace::Metric Latency("latency");
+  // Nothing is recorded without an active tracer.
+  Latency.record(1, "dropped");
+
+  RecordingTracer Tracer;
+  {
+    trace::Session Session(Tracer);
+    Latency.record(2, "interactive");
+    Latency.record(3);
+  }
+  EXPECT_THAT(Tracer.Recorded,
+              testing::ElementsAre("latency/interactive=2.00", "latency/=3.00"));
+}
+
 } // namespace
 } // namespace clangd
 } // namespace clang
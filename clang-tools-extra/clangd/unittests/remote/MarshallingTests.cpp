@@ -0,0 +1,152 @@
+//===--- MarshallingTests.cpp ------------------------------------*- C++-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "../TestFS.h"
+#include "URI.h"
+#include "index/Index.h"
+#include "index/remote/marshalling/Marshalling.h"
+#include "llvm/Support/Path.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace clang {
+namespace clangd {
+namespace remote {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(RemoteMarshallingTest, Paths) {
+  std::string ServerRoot = testPath("server/");
+  std::string ClientRoot = testPath("client/");
+  std::string ServerURI =
+      URI::createFile(testPath("server/lib/foo.h")).toString();
+
+  auto RelativePath = uriToRelativePath(ServerURI, ServerRoot);
+  ASSERT_TRUE(RelativePath);
+  EXPECT_EQ(*RelativePath, "lib/foo.h");
+  auto ClientURI = relativePathToURI(*RelativePath, ClientRoot);
+  ASSERT_TRUE(ClientURI);
+  EXPECT_EQ(*ClientURI, URI::createFile(testPath("client/lib/foo.h")).toString());
+
+  // Files outside of the index root are not sent to clients.
+  EXPECT_FALSE(uriToRelativePath(
+      URI::createFile(testPath("elsewhere/foo.h")).toString(), ServerRoot));
+  EXPECT_FALSE(uriToRelativePath("unittest:///lib/foo.h", ServerRoot));
+  // Only relative paths are accepted from the server.
+  EXPECT_FALSE(relativePathToURI("/lib/foo.h", ClientRoot));
+  EXPECT_FALSE(relativePathToURI("", ClientRoot));
+}
+
+TEST(RemoteMarshallingTest, SymbolSerialization) {
+  llvm::BumpPtrAllocator Arena;
+  llvm::UniqueStringSaver Strings(Arena);
+  std::string ServerRoot = testPath("server/");
+  std::string ClientRoot = testPath("client/");
+  std::string DeclURI = URI::createFile(testPath("server/foo.h")).toString();
+  std::string DefURI = URI::createFile(testPath("server/foo.cpp")).toString();
+
+  clangd::Symbol Sym;
+  Sym.ID = SymbolID("ns::foo");
+  Sym.SymInfo.Kind = index::SymbolKind::Function;
+  Sym.SymInfo.SubKind = index::SymbolSubKind::None;
+  Sym.SymInfo.Lang = index::SymbolLanguage::CXX;
+  Sym.SymInfo.Properties = 0;
+  Sym.Name = "foo";
+  Sym.Scope = "ns::";
+  Sym.CanonicalDeclaration.FileURI = DeclURI.c_str();
+  Sym.CanonicalDeclaration.Start.setLine(1);
+  Sym.CanonicalDeclaration.Start.setColumn(2);
+  Sym.CanonicalDeclaration.End.setLine(1);
+  Sym.CanonicalDeclaration.End.setColumn(5);
+  Sym.Definition.FileURI = DefURI.c_str();
+  Sym.References = 42;
+  Sym.Origin = SymbolOrigin::Static;
+  Sym.Signature = "(int)";
+  Sym.ReturnType = "void";
+  Sym.IncludeHeaders.emplace_back(DeclURI, 3);
+  Sym.IncludeHeaders.emplace_back("<vector>", 1);
+  Sym.Flags = clangd::Symbol::IndexedForCodeCompletion;
+
+  auto Serialized = toProtobuf(Sym, ServerRoot);
+  ASSERT_TRUE(Serialized);
+  EXPECT_EQ(Serialized->canonical_declaration().file_path(), "foo.h");
+  auto Deserialized = fromProtobuf(*Serialized, &Strings, ClientRoot);
+  ASSERT_TRUE(Deserialized);
+
+  EXPECT_EQ(Deserialized->ID, Sym.ID);
+  EXPECT_EQ(Deserialized->SymInfo.Kind, Sym.SymInfo.Kind);
+  EXPECT_EQ(Deserialized->Name, Sym.Name);
+  EXPECT_EQ(Deserialized->Scope, Sym.Scope);
+  EXPECT_EQ(llvm::StringRef(Deserialized->CanonicalDeclaration.FileURI),
+            URI::createFile(testPath("client/foo.h")).toString());
+  EXPECT_EQ(Deserialized->CanonicalDeclaration.Start,
+            Sym.CanonicalDeclaration.Start);
+  EXPECT_EQ(Deserialized->CanonicalDeclaration.End,
+            Sym.CanonicalDeclaration.End);
+  EXPECT_EQ(llvm::StringRef(Deserialized->Definition.FileURI),
+            URI::createFile(testPath("client/foo.cpp")).toString());
+  EXPECT_EQ(Deserialized->References, Sym.References);
+  EXPECT_EQ(Deserialized->Origin, Sym.Origin);
+  EXPECT_EQ(Deserialized->Signature, Sym.Signature);
+  EXPECT_EQ(Deserialized->ReturnType, Sym.ReturnType);
+  EXPECT_EQ(Deserialized->Flags, Sym.Flags);
+  ASSERT_EQ(Deserialized->IncludeHeaders.size(), 2u);
+  EXPECT_EQ(Deserialized->IncludeHeaders[0].IncludeHeader,
+            URI::createFile(testPath("client/foo.h")).toString());
+  EXPECT_EQ(Deserialized->IncludeHeaders[0].References, 3u);
+  EXPECT_EQ(Deserialized->IncludeHeaders[1].IncludeHeader, "<vector>");
+
+  // Symbols declared outside of the index root can not be sent.
+  std::string OutsideURI =
+      URI::createFile(testPath("elsewhere/foo.h")).toString();
+  Sym.CanonicalDeclaration.FileURI = OutsideURI.c_str();
+  EXPECT_FALSE(toProtobuf(Sym, ServerRoot));
+}
+
+TEST(RemoteMarshallingTest, RefSerialization) {
+  llvm::BumpPtrAllocator Arena;
+  llvm::UniqueStringSaver Strings(Arena);
+  std::string URI = URI::createFile(testPath("server/foo.cpp")).toString();
+
+  clangd::Ref R;
+  R.Location.FileURI = URI.c_str();
+  R.Location.Start.setLine(7);
+  R.Kind = RefKind::Reference;
+
+  auto Serialized = toProtobuf(R, testPath("server/"));
+  ASSERT_TRUE(Serialized);
+  auto Deserialized = fromProtobuf(*Serialized, &Strings, testPath("client/"));
+  ASSERT_TRUE(Deserialized);
+  EXPECT_EQ(Deserialized->Kind, R.Kind);
+  EXPECT_EQ(Deserialized->Location.Start, R.Location.Start);
+  EXPECT_EQ(llvm::StringRef(Deserialized->Location.FileURI),
+            URI::createFile(testPath("client/foo.cpp")).toString());
+}
+
+TEST(RemoteMarshallingTest, FuzzyFindRequestSerialization) {
+  clangd::FuzzyFindRequest Request;
+  Request.Query = "fo";
+  Request.Scopes = {"ns::"};
+  Request.Limit = 10;
+  Request.ProximityPaths = {testPath("client/lib/foo.cpp"),
+                            testPath("elsewhere/bar.cpp")};
+
+  auto Serialized = toProtobuf(Request, testPath("client/"));
+  auto Deserialized = fromProtobuf(&Serialized, testPath("server/"));
+  EXPECT_EQ(Deserialized.Query, Request.Query);
+  EXPECT_EQ(Deserialized.Scopes, Request.Scopes);
+  EXPECT_EQ(Deserialized.Limit, Request.Limit);
+  EXPECT_THAT(Deserialized.ProximityPaths,
+              ElementsAre(testPath("server/lib/foo.cpp")));
+}
+
+} // namespace
+} // namespace remote
+} // namespace clangd
+} // namespace clang
@@ -0,0 +1,11 @@
+// RUN: mkdir -p %T/parallel-jobs
+// RUN: echo '#include "header.h"' > %T/parallel-jobs/a.cpp
+// RUN: echo '#include "header.h"' > %T/parallel-jobs/b.cpp
+// RUN: echo 'int *C = 0;' > %T/parallel-jobs/c.cpp
+// RUN: echo 'int *HP = 0;' > %T/parallel-jobs/header.h
+// RUN: clang-tidy -j 2 -checks='-*,modernize-use-nullptr' -header-filter=.* %T/parallel-jobs/a.cpp %T/parallel-jobs/b.cpp %T/parallel-jobs/c.cpp -- 2>&1 | FileCheck -implicit-check-not='{{warning:|error:}}' %s
+
+// The finding in the header is reported once, although both a.cpp and b.cpp
+// include it and may be analyzed by different threads.
+// CHECK-DAG: c.cpp:1:10: warning: use nullptr [modernize-use-nullptr]
+// CHECK-DAG: header.h:1:11: warning: use nullptr [modernize-use-nullptr]
@@ -271,6 +271,10 @@ private:
   llvm::DenseMap<const MaterializeTemporaryExpr *, APValue *>
     MaterializedTemporaryValues;
 
+  /// The results of the constexpr function calls the constant evaluator
+  /// memoized, keyed by the callee and the values of the arguments.
+  llvm::StringMap<APValue> ConstexprCallResults;
+
   /// Used to cleanups APValues stored in the AST.
   mutable llvm::SmallVector<APValue *, 0> APValueCleanups;
 
@@ -2814,6 +2818,11 @@ public:
   APValue *getMaterializedTemporaryValue(const MaterializeTemporaryExpr *E,
                                          bool MayCreate);
 
+  /// Get the storage for the memoized results of constexpr function calls.
+  llvm::StringMap<APValue> &getConstexprCallResults() {
+    return ConstexprCallResults;
+  }
+
   /// Return a string representing the human readable name for the specified
   /// function declaration or file name. Used by SourceLocExpr and
   /// PredefinedExpr to cache evaluated results.
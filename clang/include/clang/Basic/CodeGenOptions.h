@@ -235,6 +235,12 @@ public:
   /// the summary and module symbol table (and not, e.g. any debug metadata).
   std::string ThinLinkBitcodeFile;
 
+  /// If non-empty, the module is split into one partition for the main output
+  /// and one for each of these files after optimization, and the code of the
+  /// partitions is generated in parallel. Linking the outputs together gives
+  /// the same result as linking the object file of the whole module.
+  std::vector<std::string> SplitCodeGenOutputs;
+
   /// Prefix to use for -save-temps output.
   std::string SaveTempsFilePrefix;
 
@@ -188,8 +188,9 @@ private:
                                                      StringRef IndexName,
                                                      bool DisplayCTUProgress);
   template <typename T>
-  const T *findDefInDeclContext(const DeclContext *DC,
-                                StringRef LookupName);
+  const T *findDefInUnit(ASTUnit *Unit, StringRef LookupName);
+  void collectDefinitions(const DeclContext *DC,
+                          llvm::StringMap<const NamedDecl *> &Defs);
   template <typename T>
   llvm::Expected<const T *> importDefinitionImpl(const T *D, ASTUnit *Unit);
 
@@ -198,6 +199,16 @@ private:
 
   ImporterMapTy ASTUnitImporterMap;
 
+  using DefinitionMapTy =
+      llvm::DenseMap<const TranslationUnitDecl *,
+                     llvm::StringMap<const NamedDecl *>>;
+
+  /// The function and variable definitions of the loaded ASTUnits, by lookup
+  /// name. A unit's map is filled on the first lookup in that unit, so that
+  /// the following ones don't have to generate the USR of every definition
+  /// again.
+  DefinitionMapTy UnitDefinitions;
+
   ASTContext &Context;
   std::shared_ptr<ASTImporterSharedState> ImporterSharedSt;
   /// Map of imported FileID's (in "To" context) to FileID in "From" context
@@ -286,6 +297,8 @@ private:
 
     using IndexMapTy = BaseMapTy<std::string>;
     IndexMapTy NameFileMap;
+    /// Set once the index file has been parsed, even if it's empty.
+    bool IsIndexLoaded = false;
 
     ASTFileLoader FileAccessor;
 
@@ -85,6 +85,10 @@ class Command {
   /// The results are the contents of a response file, written into a raw_ostream.
   void writeResponseFile(raw_ostream &OS) const;
 
+protected:
+  /// Print the input filenames, if requested.
+  void PrintFileNames() const;
+
 public:
   Command(const Action &Source, const Tool &Creator, const char *Executable,
           const llvm::opt::ArgStringList &Arguments,
@@ -132,6 +136,15 @@ public:
   void setPrintInputFilenames(bool P) { PrintInputFilenames = P; }
 };
 
+/// Use the CC1 tool callback when available, to avoid creating a new process.
+class CC1Command : public Command {
+public:
+  using Command::Command;
+
+  int Execute(ArrayRef<Optional<StringRef>> Redirects, std::string *ErrMsg,
+              bool *ExecutionFailed) const override;
+};
+
 /// Like Command, but with a fallback which is executed in case
 /// the primary command crashes.
 class FallbackCommand : public Command {
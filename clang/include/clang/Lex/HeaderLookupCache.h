@@ -0,0 +1,152 @@
+//===--- HeaderLookupCache.h - Persistent include lookup cache --*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the HeaderLookupCache interface.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_LEX_HEADERLOOKUPCACHE_H
+#define LLVM_CLANG_LEX_HEADERLOOKUPCACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace vfs {
+class FileSystem;
+} // namespace vfs
+} // namespace llvm
+
+namespace clang {
+
+/// A cache of the search directories in which \#include lookups found their
+/// files, shared by all the compilations that use the same cache file.
+///
+/// An entry maps the name of a file and the index of the search directory the
+/// lookup started at to the index of the directory that contains the file, for
+/// a given list of search directories. With it, a lookup goes straight to that
+/// directory instead of looking for the file in all the directories before it.
+///
+/// The entry records the modification times of the directories that tell
+/// whether the file appeared in one of the directories it skips: as files are
+/// created and removed, the modification time of the directories that contain
+/// them changes. The entry is ignored once one of these changed. Checking an
+/// entry only needs the status of directories, which all the lookups share.
+///
+/// Only lookups that skip nothing but normal directories are cached, as
+/// frameworks and header maps can change without that being visible in the
+/// modification time of a directory.
+class HeaderLookupCache {
+public:
+  /// \param Path The file to load the cache from and to write it to.
+  /// \param ConfigHash Identifies the list of search directories, as the
+  /// lookups with other lists are unrelated.
+  /// \param Dirs The absolute path of each search directory, or an empty
+  /// string for the ones that aren't normal directories.
+  HeaderLookupCache(StringRef Path, uint64_t ConfigHash,
+                    std::vector<std::string> Dirs, llvm::vfs::FileSystem &FS);
+
+  /// The number of search directories the cache is for.
+  unsigned getNumDirs() const { return Dirs.size(); }
+
+  /// Returns the search directory in which to look for \p Filename when
+  /// the lookup starts in the directory \p StartIdx, or None if the cache
+  /// doesn't know.
+  Optional<unsigned> lookup(StringRef Filename, unsigned StartIdx);
+
+  /// Remembers that looking up \p Filename from the directory \p StartIdx found
+  /// it in the directory \p HitIdx, or nowhere if \p HitIdx is the number of
+  /// directories.
+  void record(StringRef Filename, unsigned StartIdx, unsigned HitIdx);
+
+  /// Writes the lookups recorded in this compilation to the cache file,
+  /// merged with the lookups other compilations wrote in the meantime.
+  ///
+  /// Failures are ignored: it's just a cache.
+  void write();
+
+private:
+  /// A directory whose modification time shows whether a lookup can change.
+  struct WitnessDir {
+    std::string Path;
+    uint64_t MTime;
+  };
+
+  /// A lookup, as stored in the cache file.
+  struct Lookup {
+    uint64_t ConfigHash;
+    unsigned StartIdx;
+    unsigned HitIdx;
+    /// Indexes into the list of directories of the file it was read from.
+    SmallVector<unsigned, 4> Witnesses;
+    std::string Filename;
+  };
+
+  /// The contents of a cache file.
+  struct CacheFile {
+    std::vector<WitnessDir> Dirs;
+    std::vector<Lookup> Lookups;
+  };
+
+  /// Reads the cache file, or returns an empty one if it can't be read.
+  CacheFile readCacheFile() const;
+
+  /// Returns the current modification time of the directory \p Path, or None
+  /// if it isn't a directory.
+  Optional<uint64_t> getDirMTime(StringRef Path);
+
+  /// Returns whether the directories of \p L still have the modification
+  /// times recorded for them in \p FileDirs.
+  bool isUpToDate(const Lookup &L, ArrayRef<WitnessDir> FileDirs);
+
+  /// Returns whether this compilation saw one of the directories of \p L
+  /// with another modification time than the one recorded in \p FileDirs.
+  bool isKnownOutOfDate(const Lookup &L, ArrayRef<WitnessDir> FileDirs) const;
+
+  /// Returns the directory whose modification time changes if \p Filename is
+  /// created in the search directory \p Dir: the deepest existing directory
+  /// along the path of the file.
+  std::string getWitnessDir(StringRef Dir, StringRef Filename);
+
+  /// Returns the key of a lookup in \c Cached and \c Recorded.
+  static std::string getKey(StringRef Filename, unsigned StartIdx);
+
+  std::string Path;
+  uint64_t ConfigHash;
+  std::vector<std::string> Dirs;
+  llvm::vfs::FileSystem &FS;
+
+  /// When this compilation started, in nanoseconds since the epoch.
+  uint64_t StartTime;
+
+  /// The modification times of the directories, or None for the ones that
+  /// don't exist.
+  llvm::StringMap<Optional<uint64_t>> DirMTimes;
+
+  /// The directories of the cache file as it was loaded.
+  std::vector<WitnessDir> CachedDirs;
+
+  /// The lookups from the cache file for this list of directories, that aren't
+  /// known to be out of date.
+  llvm::StringMap<Lookup> Cached;
+
+  /// The directory in which each lookup this compilation performed, and that
+  /// wasn't in the cache, found its file.
+  llvm::StringMap<unsigned> Recorded;
+};
+
+} // end namespace clang
+
+#endif // LLVM_CLANG_LEX_HEADERLOOKUPCACHE_H
@@ -38,6 +38,7 @@ class DirectoryEntry;
 class ExternalPreprocessorSource;
 class FileEntry;
 class FileManager;
+class HeaderLookupCache;
 class HeaderSearchOptions;
 class IdentifierInfo;
 class LangOptions;
@@ -214,6 +215,10 @@ class HeaderSearch {
   };
   llvm::StringMap<LookupFileCacheInfo, llvm::BumpPtrAllocator> LookupFileCache;
 
+  /// The lookups shared with other compilations through
+  /// HeaderSearchOptions::HeaderLookupCachePath, created on the first lookup.
+  std::unique_ptr<HeaderLookupCache> PersistentLookupCache;
+
   /// Collection mapping a framework or subframework
   /// name like "Carbon" to the Carbon.framework directory.
   llvm::StringMap<FrameworkCacheEntry, llvm::BumpPtrAllocator> FrameworkMap;
@@ -262,6 +267,7 @@ public:
                const LangOptions &LangOpts, const TargetInfo *Target);
   HeaderSearch(const HeaderSearch &) = delete;
   HeaderSearch &operator=(const HeaderSearch &) = delete;
+  ~HeaderSearch();
 
   /// Retrieve the header-search options with which this header search
   /// was initialized.
@@ -293,6 +299,10 @@ public:
     SystemDirIdx++;
   }
 
+  /// Write the lookups performed so far to the lookup cache shared with other
+  /// compilations, if there is one.
+  void writePersistentLookupCache();
+
   /// Set the list of system header prefixes.
   void SetSystemHeaderPrefixes(ArrayRef<std::pair<std::string, bool>> P) {
     SystemHeaderPrefixes.assign(P.begin(), P.end());
@@ -593,6 +603,10 @@ public:
   void loadTopLevelSystemModules();
 
 private:
+  /// Returns the lookup cache shared with other compilations, or null if
+  /// there is none.
+  HeaderLookupCache *getPersistentLookupCache();
+
   /// Lookup a module with the given module name and search-name.
   ///
   /// \param ModuleName The name of the module we're looking for.
@@ -113,6 +113,10 @@ public:
   /// The directory used for a user build.
   std::string ModuleUserBuildPath;
 
+  /// The file in which to cache the results of include lookups across
+  /// compilations, if any.
+  std::string HeaderLookupCachePath;
+
   /// The mapping of module names to prebuilt module files.
   std::map<std::string, std::string> PrebuiltModuleFiles;
 
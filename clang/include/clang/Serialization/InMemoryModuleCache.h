@@ -14,6 +14,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include <memory>
+#include <mutex>
 
 namespace clang {
 
@@ -27,7 +28,14 @@ namespace clang {
 /// Critically, it ensures that a single process has a consistent view of each
 /// PCM.  This is used by \a CompilerInstance when building PCMs to ensure that
 /// each \a ModuleManager sees the same files.
-class InMemoryModuleCache : public llvm::RefCountedBase<InMemoryModuleCache> {
+///
+/// The cache may be shared by CompilerInstances running on different threads,
+/// e.g. when building explicit modules in parallel.  Each call is atomic, but
+/// callers must still make sure that no two threads try to read the same PCM
+/// from disk (or build it) at once, for example by only sharing PCMs that were
+/// built before any of their importers started.
+class InMemoryModuleCache
+    : public llvm::ThreadSafeRefCountedBase<InMemoryModuleCache> {
   struct PCM {
     std::unique_ptr<llvm::MemoryBuffer> Buffer;
 
@@ -44,6 +52,9 @@ class InMemoryModuleCache : public llvm::RefCountedBase<InMemoryModuleCache> {
   /// Cache of buffers.
   llvm::StringMap<PCM> PCMs;
 
+  /// Guards PCMs.  The buffers themselves are immutable.
+  mutable std::mutex Mutex;
+
 public:
   /// There are four states for a PCM.  It must monotonically increase.
   ///
@@ -0,0 +1,134 @@
+//===- ModuleDepCollector.h - Callbacks to collect deps ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_MODULE_DEP_COLLECTOR_H
+#define LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_MODULE_DEP_COLLECTOR_H
+
+#include "clang/Basic/LLVM.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Frontend/Utils.h"
+#include "clang/Lex/HeaderSearch.h"
+#include "clang/Lex/PPCallbacks.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include <string>
+#include <vector>
+
+namespace clang {
+namespace tooling {
+namespace dependencies {
+
+class DependencyConsumer;
+
+/// The dependency information of a single clang module.
+struct ModuleDeps {
+  /// The name of the module.
+  std::string ModuleName;
+
+  /// The context hash of the translation unit that imports the module.
+  ///
+  /// Modules can only be shared between translation units with the same
+  /// context hash, which is also used by implicit module builds to separate
+  /// modules built with incompatible options.
+  std::string ContextHash;
+
+  /// The path to the module map file that defines the module.
+  std::string ClangModuleMapFile;
+
+  /// The path to the module file the scanner loaded for this module.
+  std::string ImplicitModulePCMPath;
+
+  /// The files the module was built from.
+  llvm::StringSet<> FileDeps;
+
+  /// The names of the modules this module directly imports. They have the same
+  /// context hash.
+  std::vector<std::string> ClangModuleDeps;
+
+  /// The -cc1 command line that builds the module, without the paths of the
+  /// module file to create and of the module files of its dependencies.
+  std::vector<std::string> NonPathCommandLine;
+
+  /// Whether the translation unit imports the module directly.
+  bool ImportedByMainFile = false;
+
+  /// Returns the full -cc1 command line that builds the module.
+  ///
+  /// \param LookupPCMPath Returns the path of the module file of a module,
+  /// given its name.
+  std::vector<std::string> getFullCommandLine(
+      llvm::function_ref<std::string(StringRef ModuleName)> LookupPCMPath)
+      const;
+};
+
+/// Returns the -cc1 arguments of \p TUCommandLine, the -cc1 command line of a
+/// translation unit, that also apply when building the modules it imports.
+///
+/// This drops the inputs and outputs as well as the action, and any option
+/// that only makes sense for the translation unit itself.
+std::vector<std::string>
+getModuleCommandLineBase(ArrayRef<std::string> TUCommandLine);
+
+class ModuleDepCollector;
+
+/// Records which modules the translation unit imports, and once the main file
+/// was preprocessed, reports them and their transitive dependencies.
+class ModuleDepCollectorPP final : public PPCallbacks {
+public:
+  ModuleDepCollectorPP(CompilerInstance &I, ModuleDepCollector &MDC)
+      : Instance(I), MDC(MDC) {}
+
+  void InclusionDirective(SourceLocation HashLoc, const Token &IncludeTok,
+                          StringRef FileName, bool IsAngled,
+                          CharSourceRange FilenameRange, const FileEntry *File,
+                          StringRef SearchPath, StringRef RelativePath,
+                          const Module *Imported,
+                          SrcMgr::CharacteristicKind FileType) override;
+  void moduleImport(SourceLocation ImportLoc, ModuleIdPath Path,
+                    const Module *Imported) override;
+
+  void EndOfMainFile() override;
+
+private:
+  CompilerInstance &Instance;
+  ModuleDepCollector &MDC;
+  /// The top-level modules the translation unit imports.
+  llvm::SetVector<const Module *> DirectDeps;
+
+  void handleTopLevelModule(const Module *M);
+  void addModuleDeps(const Module *TopLevel, const Module *M, ModuleDeps &MD);
+};
+
+/// Collects the clang module dependencies of a translation unit and reports
+/// them to a \c DependencyConsumer.
+class ModuleDepCollector final : public DependencyCollector {
+public:
+  /// \param ModuleCommandLineBase The arguments every module's command line
+  /// starts with, see \c getModuleCommandLineBase().
+  ModuleDepCollector(CompilerInstance &I, DependencyConsumer &C,
+                     std::vector<std::string> ModuleCommandLineBase);
+
+  void attachToPreprocessor(Preprocessor &PP) override;
+
+private:
+  friend ModuleDepCollectorPP;
+
+  CompilerInstance &Instance;
+  DependencyConsumer &Consumer;
+  std::vector<std::string> ModuleCommandLineBase;
+  std::string ContextHash;
+  /// The modules seen so far, by name.
+  llvm::StringMap<ModuleDeps> Deps;
+};
+
+} // end namespace dependencies
+} // end namespace tooling
+} // end namespace clang
+
+#endif // LLVM_CLANG_TOOLING_DEPENDENCY_SCANNING_MODULE_DEP_COLLECTOR_H
@@ -782,6 +782,18 @@ namespace {
     /// initialization.
     uint64_t ArrayInitIndex = -1;
 
+    /// If we're evaluating a call whose result we want to memoize, the call
+    /// stack depth of its frame, otherwise 0.
+    unsigned MemoizedCallDepth = 0;
+
+    /// Did the call we want to memoize access an object that isn't local to
+    /// it, and whose value might differ in another evaluation?
+    bool MemoizedCallIsImpure = false;
+
+    /// The number of diagnostics requested so far, whether or not they were
+    /// recorded.
+    unsigned NumDiagsRequested = 0;
+
     /// HasActiveDiagnostic - Was the previous diagnostic stored? If so, further
     /// notes attached to it will also be stored, otherwise they will not be.
     bool HasActiveDiagnostic;
@@ -971,12 +983,14 @@ namespace {
     FFDiag(SourceLocation Loc,
           diag::kind DiagId = diag::note_invalid_subexpr_in_const_expr,
           unsigned ExtraNotes = 0) {
+      ++NumDiagsRequested;
       return Diag(Loc, DiagId, ExtraNotes, false);
     }
 
     OptionalDiagnostic FFDiag(const Expr *E, diag::kind DiagId
                               = diag::note_invalid_subexpr_in_const_expr,
                             unsigned ExtraNotes = 0) {
+      ++NumDiagsRequested;
       if (EvalStatus.Diag)
         return Diag(E->getExprLoc(), DiagId, ExtraNotes, /*IsCCEDiag*/false);
       HasActiveDiagnostic = false;
@@ -991,6 +1005,7 @@ namespace {
     OptionalDiagnostic CCEDiag(SourceLocation Loc, diag::kind DiagId
                                  = diag::note_invalid_subexpr_in_const_expr,
                                unsigned ExtraNotes = 0) {
+      ++NumDiagsRequested;
       // Don't override a previous diagnostic. Don't bother collecting
       // diagnostics if we're evaluating for overflow.
       if (!EvalStatus.Diag || !EvalStatus.Diag->empty()) {
@@ -3345,6 +3360,20 @@ static CompleteObject findCompleteObject(EvalInfo &Info, const Expr *E,
     }
   }
 
+  // The result of a memoized call must not depend on objects from outside of
+  // it whose values can change during an evaluation: those of enclosing calls
+  // and the ones whose lifetimes began in this evaluation.
+  if (Info.MemoizedCallDepth) {
+    if (Frame ? Depth < Info.MemoizedCallDepth
+              : isModification(AK) ||
+                    llvm::isa_and_nonnull<MaterializeTemporaryExpr>(
+                        LVal.Base.dyn_cast<const Expr *>()) ||
+                    declaresSameEntity(
+                        LVal.Base.dyn_cast<const ValueDecl *>(),
+                        Info.EvaluatingDecl.dyn_cast<const ValueDecl *>()))
+      Info.MemoizedCallIsImpure = true;
+  }
+
   bool IsAccess = isFormalAccess(AK);
 
   // C++11 DR1311: An lvalue-to-rvalue conversion on a volatile-qualified type
@@ -5136,6 +5165,50 @@ static bool EvaluateArgs(ArrayRef<const Expr *> Args, ArgVector &ArgValues,
   return Success;
 }
 
+static bool isMemoizableScalarType(QualType T) {
+  return T->isIntegralOrEnumerationType() || T->isRealFloatingType();
+}
+
+/// Compute the key under which the result of a call to \p Callee with the
+/// arguments \p ArgValues is memoized. Returns false if the call's result
+/// can't be memoized: only calls to non-member functions that take and return
+/// scalars by value are, as they can only depend on their arguments (and on
+/// constants).
+static bool getMemoizedCallKey(EvalInfo &Info, const FunctionDecl *Callee,
+                               const LValue *This, ArrayRef<APValue> ArgValues,
+                               SmallVectorImpl<char> &Key) {
+  if (This || Callee->isVariadic() ||
+      Info.checkingPotentialConstantExpression() ||
+      Info.SpeculativeEvaluationDepth ||
+      (Info.EvalMode != EvalInfo::EM_ConstantExpression &&
+       Info.EvalMode != EvalInfo::EM_ConstantExpressionUnevaluated) ||
+      !isMemoizableScalarType(Callee->getReturnType()) ||
+      ArgValues.size() != Callee->getNumParams())
+    return false;
+
+  auto AddBytes = [&](const void *Data, size_t Size) {
+    const char *Bytes = static_cast<const char *>(Data);
+    Key.append(Bytes, Bytes + Size);
+  };
+  const Decl *Canon = Callee->getCanonicalDecl();
+  AddBytes(&Canon, sizeof(Canon));
+  AddBytes(&Info.InConstantContext, sizeof(Info.InConstantContext));
+  for (unsigned I = 0, N = ArgValues.size(); I != N; ++I) {
+    if (!isMemoizableScalarType(Callee->getParamDecl(I)->getType()))
+      return false;
+    const APValue &Arg = ArgValues[I];
+    llvm::APInt Bits;
+    if (Arg.isInt())
+      Bits = Arg.getInt();
+    else if (Arg.isFloat())
+      Bits = Arg.getFloat().bitcastToAPInt();
+    else
+      return false;
+    AddBytes(Bits.getRawData(), Bits.getNumWords() * sizeof(uint64_t));
+  }
+  return true;
+}
+
 /// Evaluate a function call.
 static bool HandleFunctionCall(SourceLocation CallLoc,
                                const FunctionDecl *Callee, const LValue *This,
@@ -5146,6 +5219,20 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
   if (!EvaluateArgs(Args, ArgValues, Info, Callee))
     return false;
 
+  // Reuse the result of an earlier evaluation of the same call, if any. This
+  // saves both time and steps on code that keeps calling the same helpers.
+  SmallString<64> MemoKey;
+  bool Memoize = getMemoizedCallKey(Info, Callee, This, ArgValues, MemoKey);
+  llvm::StringMap<APValue> &MemoizedResults =
+      Info.Ctx.getConstexprCallResults();
+  if (Memoize) {
+    auto It = MemoizedResults.find(MemoKey);
+    if (It != MemoizedResults.end()) {
+      Result = It->second;
+      return true;
+    }
+  }
+
   if (!Info.CheckCallLimit(CallLoc))
     return false;
 
@@ -5189,8 +5276,30 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
                                         Frame.LambdaThisCaptureField);
   }
 
+  unsigned OldMemoizedCallDepth = Info.MemoizedCallDepth;
+  bool OldMemoizedCallIsImpure = Info.MemoizedCallIsImpure;
+  unsigned OldNumDiagsRequested = Info.NumDiagsRequested;
+  if (Memoize) {
+    Info.MemoizedCallDepth = Info.CallStackDepth;
+    Info.MemoizedCallIsImpure = false;
+  }
+
   StmtResult Ret = {Result, ResultSlot};
   EvalStmtResult ESR = EvaluateStmt(Ret, Info, Body);
+
+  if (Memoize) {
+    // Only remember calls that were a constant expression, without any
+    // side-effects, and that didn't depend on anything but their arguments.
+    if (ESR == ESR_Returned && !Info.MemoizedCallIsImpure &&
+        Info.NumDiagsRequested == OldNumDiagsRequested &&
+        !Info.EvalStatus.HasSideEffects &&
+        !Info.EvalStatus.HasUndefinedBehavior &&
+        (Result.isInt() || Result.isFloat()))
+      MemoizedResults[MemoKey] = Result;
+    Info.MemoizedCallDepth = OldMemoizedCallDepth;
+    Info.MemoizedCallIsImpure |= OldMemoizedCallIsImpure;
+  }
+
   if (ESR == ESR_Succeeded) {
     if (Callee->getReturnType()->isVoidType())
       return true;
@@ -43,6 +43,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
@@ -68,9 +69,12 @@
 #include "llvm/Transforms/Scalar/GVN.h"
 #include "llvm/Transforms/Utils.h"
 #include "llvm/Transforms/Utils/CanonicalizeAliases.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/EntryExitInstrumenter.h"
 #include "llvm/Transforms/Utils/NameAnonGlobals.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "llvm/Transforms/Utils/SymbolRewriter.h"
+#include <atomic>
 #include <memory>
 using namespace clang;
 using namespace llvm;
@@ -117,6 +121,17 @@ class EmitAssemblyHelper {
   bool AddEmitPasses(legacy::PassManager &CodeGenPasses, BackendAction Action,
                      raw_pwrite_stream &OS, raw_pwrite_stream *DwoOS);
 
+  /// Whether the code of the module is generated by EmitSplitCode rather than
+  /// by the passes added by AddEmitPasses.
+  bool shouldSplitCodeGen(BackendAction Action) const {
+    return (Action == Backend_EmitObj || Action == Backend_EmitAssembly) &&
+           !CodeGenOpts.SplitCodeGenOutputs.empty();
+  }
+
+  /// Splits the module into one partition for \p OS and one for each of
+  /// CodeGenOpts.SplitCodeGenOutputs, and generates their code in parallel.
+  void EmitSplitCode(BackendAction Action, raw_pwrite_stream &OS);
+
   std::unique_ptr<llvm::ToolOutputFile> openOutputFile(StringRef Path) {
     std::error_code EC;
     auto F = std::make_unique<llvm::ToolOutputFile>(Path, EC,
@@ -745,6 +760,10 @@ static void setCommandLineOpts(const CodeGenOptions &CodeGenOpts) {
     BackendArgs.push_back("-limit-float-precision");
     BackendArgs.push_back(CodeGenOpts.LimitFloatPrecision.c_str());
   }
+  // Leave the global options alone if there is nothing to set, so that
+  // compilations can run concurrently in one process.
+  if (BackendArgs.size() == 1)
+    return;
   BackendArgs.push_back(nullptr);
   llvm::cl::ParseCommandLineOptions(BackendArgs.size() - 1,
                                     BackendArgs.data());
@@ -773,12 +792,17 @@ void EmitAssemblyHelper::CreateTargetMachine(bool MustCreateTM) {
                                           Options, RM, CM, OptLevel));
 }
 
-bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
-                                       BackendAction Action,
-                                       raw_pwrite_stream &OS,
-                                       raw_pwrite_stream *DwoOS) {
+/// Adds the passes that generate the code of a module for \p TM to
+/// \p CodeGenPasses.
+///
+/// \return True on success.
+static bool addCodeGenPasses(legacy::PassManager &CodeGenPasses,
+                             TargetMachine &TM,
+                             const CodeGenOptions &CodeGenOpts,
+                             BackendAction Action, raw_pwrite_stream &OS,
+                             raw_pwrite_stream *DwoOS) {
   // Add LibraryInfo.
-  llvm::Triple TargetTriple(TheModule->getTargetTriple());
+  llvm::Triple TargetTriple(TM.getTargetTriple());
   std::unique_ptr<TargetLibraryInfoImpl> TLII(
       createTLII(TargetTriple, CodeGenOpts));
   CodeGenPasses.add(new TargetLibraryInfoWrapperPass(*TLII));
@@ -793,8 +817,15 @@ bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
   if (CodeGenOpts.OptimizationLevel > 0)
     CodeGenPasses.add(createObjCARCContractPass());
 
-  if (TM->addPassesToEmitFile(CodeGenPasses, OS, DwoOS, CGFT,
-                              /*DisableVerify=*/!CodeGenOpts.VerifyModule)) {
+  return !TM.addPassesToEmitFile(CodeGenPasses, OS, DwoOS, CGFT,
+                                 /*DisableVerify=*/!CodeGenOpts.VerifyModule);
+}
+
+bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
+                                       BackendAction Action,
+                                       raw_pwrite_stream &OS,
+                                       raw_pwrite_stream *DwoOS) {
+  if (!addCodeGenPasses(CodeGenPasses, *TM, CodeGenOpts, Action, OS, DwoOS)) {
     Diags.Report(diag::err_fe_unable_to_interface_with_target);
     return false;
   }
@@ -802,6 +833,77 @@ bool EmitAssemblyHelper::AddEmitPasses(legacy::PassManager &CodeGenPasses,
   return true;
 }
 
+void EmitAssemblyHelper::EmitSplitCode(BackendAction Action,
+                                       raw_pwrite_stream &OS) {
+  std::vector<std::unique_ptr<llvm::ToolOutputFile>> PartitionFiles;
+  SmallVector<raw_pwrite_stream *, 8> OSs = {&OS};
+  for (const std::string &Path : CodeGenOpts.SplitCodeGenOutputs) {
+    PartitionFiles.push_back(openOutputFile(Path));
+    if (!PartitionFiles.back())
+      return;
+    OSs.push_back(&PartitionFiles.back()->os());
+  }
+
+  // The code of each partition is generated on its own thread, in its own
+  // context and for its own TargetMachine. As the outputs are combined by a
+  // regular link rather than by LTO, locals have to stay in the partition of
+  // their users.
+  std::atomic<bool> Failed(false);
+  {
+    ThreadPool Pool(OSs.size());
+    unsigned NumPartitions = 0;
+    SplitModule(
+        // The caller still owns the module, so split a copy of it.
+        CloneModule(*TheModule), OSs.size(),
+        [&](std::unique_ptr<Module> Partition) {
+          // Move the partition to the context of its thread through bitcode,
+          // which has to be written on this thread.
+          SmallString<0> BC;
+          raw_svector_ostream BCOS(BC);
+          WriteBitcodeToFile(*Partition, BCOS);
+
+          raw_pwrite_stream *PartitionOS = OSs[NumPartitions++];
+          Pool.async(
+              [&, PartitionOS](const SmallString<0> &BC) {
+                LLVMContext Context;
+                Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
+                    MemoryBufferRef(BC.str(), "<split-module>"), Context);
+                if (!MOrErr) {
+                  consumeError(MOrErr.takeError());
+                  Failed = true;
+                  return;
+                }
+
+                std::unique_ptr<TargetMachine> PartitionTM(
+                    TM->getTarget().createTargetMachine(
+                        TM->getTargetTriple().str(), TM->getTargetCPU(),
+                        TM->getTargetFeatureString(), TM->Options,
+                        TM->getRelocationModel(), TM->getCodeModel(),
+                        TM->getOptLevel()));
+                legacy::PassManager CodeGenPasses;
+                CodeGenPasses.add(createTargetTransformInfoWrapperPass(
+                    PartitionTM->getTargetIRAnalysis()));
+                if (!addCodeGenPasses(CodeGenPasses, *PartitionTM,
+                                      CodeGenOpts, Action, *PartitionOS,
+                                      /*DwoOS=*/nullptr)) {
+                  Failed = true;
+                  return;
+                }
+                CodeGenPasses.run(**MOrErr);
+              },
+              std::move(BC));
+        },
+        /*PreserveLocals=*/true);
+  }
+
+  if (Failed) {
+    Diags.Report(diag::err_fe_unable_to_interface_with_target);
+    return;
+  }
+  for (std::unique_ptr<llvm::ToolOutputFile> &File : PartitionFiles)
+    File->keep();
+}
+
 void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
                                       std::unique_ptr<raw_pwrite_stream> OS) {
   TimeRegion Region(FrontendTimesIsEnabled ? &CodeGenerationTime : nullptr);
@@ -875,6 +977,9 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
     break;
 
   default:
+    // The code of the partitions is generated after optimization.
+    if (shouldSplitCodeGen(Action))
+      break;
     if (!CodeGenOpts.SplitDwarfOutput.empty()) {
       DwoOS = openOutputFile(CodeGenOpts.SplitDwarfOutput);
       if (!DwoOS)
@@ -908,7 +1013,10 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
 
   {
     PrettyStackTraceString CrashInfo("Code generation");
-    CodeGenPasses.run(*TheModule);
+    if (shouldSplitCodeGen(Action))
+      EmitSplitCode(Action, *OS);
+    else
+      CodeGenPasses.run(*TheModule);
   }
 
   if (ThinLinkOS)
@@ -1287,6 +1395,9 @@ void EmitAssemblyHelper::EmitAssemblyWithNewPassManager(
   case Backend_EmitMCNull:
   case Backend_EmitObj:
     NeedCodeGen = true;
+    // The code of the partitions is generated after optimization.
+    if (shouldSplitCodeGen(Action))
+      break;
     CodeGenPasses.add(
         createTargetTransformInfoWrapperPass(getTargetIRAnalysis()));
     if (!CodeGenOpts.SplitDwarfOutput.empty()) {
@@ -1313,7 +1424,10 @@ void EmitAssemblyHelper::EmitAssemblyWithNewPassManager(
   // Now if needed, run the legacy PM for codegen.
   if (NeedCodeGen) {
     PrettyStackTraceString CrashInfo("Code generation");
-    CodeGenPasses.run(*TheModule);
+    if (shouldSplitCodeGen(Action))
+      EmitSplitCode(Action, *OS);
+    else
+      CodeGenPasses.run(*TheModule);
   }
 
   if (ThinLinkOS)
@@ -1439,6 +1553,7 @@ static void runThinLTOBackend(ModuleSummaryIndex *CombinedIndex, Module *M,
   Conf.UseNewPM = CGOpts.ExperimentalNewPassManager;
   Conf.DebugPassManager = CGOpts.DebugPassManager;
   Conf.RemarksWithHotness = CGOpts.DiagnosticsWithHotness;
+  Conf.RemarksHotnessThreshold = CGOpts.DiagnosticsHotnessThreshold;
   Conf.RemarksFilename = CGOpts.OptRecordFile;
   Conf.RemarksPasses = CGOpts.OptRecordPasses;
   Conf.RemarksFormat = CGOpts.OptRecordFormat;
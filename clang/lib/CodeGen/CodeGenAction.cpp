@@ -311,8 +311,10 @@ namespace clang {
 
       Ctx.setDiagnosticHandler(std::move(OldDiagnosticHandler));
 
-      if (OptRecordFile)
+      if (OptRecordFile) {
+        Ctx.getRemarkStreamer()->finalize();
         OptRecordFile->keep();
+      }
     }
 
     void HandleTagDeclDefinition(TagDecl *D) override {
@@ -22,9 +22,9 @@
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
-#include <fstream>
 #include <sstream>
 
 namespace clang {
@@ -130,26 +130,31 @@ std::error_code IndexError::convertToErrorCode() const {
 
 llvm::Expected<llvm::StringMap<std::string>>
 parseCrossTUIndex(StringRef IndexPath, StringRef CrossTUDir) {
-  std::ifstream ExternalMapFile(IndexPath);
+  // Indexes of whole projects have millions of lines: read the file in one
+  // go rather than line by line.
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> ExternalMapFile =
+      llvm::MemoryBuffer::getFile(IndexPath, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
   if (!ExternalMapFile)
     return llvm::make_error<IndexError>(index_error_code::missing_index_file,
                                         IndexPath.str());
 
   llvm::StringMap<std::string> Result;
-  std::string Line;
+  StringRef Rest = (*ExternalMapFile)->getBuffer();
   unsigned LineNo = 1;
-  while (std::getline(ExternalMapFile, Line)) {
-    const size_t Pos = Line.find(" ");
-    if (Pos > 0 && Pos != std::string::npos) {
-      StringRef LineRef{Line};
+  SmallString<256> FilePath;
+  while (!Rest.empty()) {
+    StringRef LineRef;
+    std::tie(LineRef, Rest) = Rest.split('\n');
+    const size_t Pos = LineRef.find(" ");
+    if (Pos > 0 && Pos != StringRef::npos) {
       StringRef LookupName = LineRef.substr(0, Pos);
-      if (Result.count(LookupName))
-        return llvm::make_error<IndexError>(
-            index_error_code::multiple_definitions, IndexPath.str(), LineNo);
       StringRef FileName = LineRef.substr(Pos + 1);
-      SmallString<256> FilePath = CrossTUDir;
+      FilePath = CrossTUDir;
       llvm::sys::path::append(FilePath, FileName);
-      Result[LookupName] = FilePath.str().str();
+      if (!Result.try_emplace(LookupName, FilePath.str()).second)
+        return llvm::make_error<IndexError>(
+            index_error_code::multiple_definitions, IndexPath.str(), LineNo);
     } else
       return llvm::make_error<IndexError>(
           index_error_code::invalid_index_format, IndexPath.str(), LineNo);
@@ -201,29 +206,48 @@ CrossTranslationUnitContext::getLookupName(const NamedDecl *ND) {
   return std::string(DeclUSR.str());
 }
 
-/// Recursively visits the decls of a DeclContext, and returns one with the
-/// given USR.
-template <typename T>
-const T *
-CrossTranslationUnitContext::findDefInDeclContext(const DeclContext *DC,
-                                                  StringRef LookupName) {
+/// Recursively visits the decls of a DeclContext, and records the function
+/// and variable definitions by lookup name. If several definitions have the
+/// same name, the first one visited is kept.
+void CrossTranslationUnitContext::collectDefinitions(
+    const DeclContext *DC, llvm::StringMap<const NamedDecl *> &Defs) {
   assert(DC && "Declaration Context must not be null");
   for (const Decl *D : DC->decls()) {
     const auto *SubDC = dyn_cast<DeclContext>(D);
     if (SubDC)
-      if (const auto *ND = findDefInDeclContext<T>(SubDC, LookupName))
-        return ND;
-
-    const auto *ND = dyn_cast<T>(D);
-    const T *ResultDecl;
-    if (!ND || !hasBodyOrInit(ND, ResultDecl))
+      collectDefinitions(SubDC, Defs);
+
+    const NamedDecl *ResultDecl = nullptr;
+    if (const auto *FD = dyn_cast<FunctionDecl>(D)) {
+      const FunctionDecl *DefD;
+      if (hasBodyOrInit(FD, DefD))
+        ResultDecl = DefD;
+    } else if (const auto *VD = dyn_cast<VarDecl>(D)) {
+      const VarDecl *DefD;
+      if (hasBodyOrInit(VD, DefD))
+        ResultDecl = DefD;
+    }
+    if (!ResultDecl)
       continue;
     llvm::Optional<std::string> ResultLookupName = getLookupName(ResultDecl);
-    if (!ResultLookupName || *ResultLookupName != LookupName)
+    if (!ResultLookupName)
       continue;
-    return ResultDecl;
+    Defs.try_emplace(*ResultLookupName, ResultDecl);
   }
-  return nullptr;
+}
+
+/// Returns the definition with the given USR in the translation unit of
+/// \p Unit, if there is one.
+template <typename T>
+const T *CrossTranslationUnitContext::findDefInUnit(ASTUnit *Unit,
+                                                    StringRef LookupName) {
+  const TranslationUnitDecl *TU =
+      Unit->getASTContext().getTranslationUnitDecl();
+  auto Inserted = UnitDefinitions.try_emplace(TU);
+  llvm::StringMap<const NamedDecl *> &Defs = Inserted.first->second;
+  if (Inserted.second)
+    collectDefinitions(TU, Defs);
+  return dyn_cast_or_null<T>(Defs.lookup(LookupName));
 }
 
 template <typename T>
@@ -294,8 +318,7 @@ llvm::Expected<const T *> CrossTranslationUnitContext::getCrossTUDefinitionImpl(
         index_error_code::lang_dialect_mismatch);
   }
 
-  TranslationUnitDecl *TU = Unit->getASTContext().getTranslationUnitDecl();
-  if (const T *ResultDecl = findDefInDeclContext<T>(TU, *LookupName))
+  if (const T *ResultDecl = findDefInUnit<T>(Unit, *LookupName))
     return importDefinition(ResultDecl, Unit);
   return llvm::make_error<IndexError>(index_error_code::failed_import);
 }
@@ -416,16 +439,16 @@ CrossTranslationUnitContext::ASTUnitStorage::getASTUnitForFunction(
             ensureCTUIndexLoaded(CrossTUDir, IndexName))
       return std::move(IndexLoadError);
 
-    // Check if there is and entry in the index for the function.
-    if (!NameFileMap.count(FunctionName)) {
+    // Search in the index for the filename where the definition of FuncitonName
+    // resides.
+    auto IndexEntry = NameFileMap.find(FunctionName);
+    if (IndexEntry == NameFileMap.end()) {
       ++NumNotInOtherTU;
       return llvm::make_error<IndexError>(index_error_code::missing_definition);
     }
 
-    // Search in the index for the filename where the definition of FuncitonName
-    // resides.
     if (llvm::Expected<ASTUnit *> FoundForFile =
-            getASTUnitForFile(NameFileMap[FunctionName], DisplayCTUProgress)) {
+            getASTUnitForFile(IndexEntry->second, DisplayCTUProgress)) {
 
       // Update the cache.
       NameASTUnitMap[FunctionName] = *FoundForFile;
@@ -445,13 +468,13 @@ CrossTranslationUnitContext::ASTUnitStorage::getFileForFunction(
     StringRef FunctionName, StringRef CrossTUDir, StringRef IndexName) {
   if (llvm::Error IndexLoadError = ensureCTUIndexLoaded(CrossTUDir, IndexName))
     return std::move(IndexLoadError);
-  return NameFileMap[FunctionName];
+  return NameFileMap.lookup(FunctionName);
 }
 
 llvm::Error CrossTranslationUnitContext::ASTUnitStorage::ensureCTUIndexLoaded(
     StringRef CrossTUDir, StringRef IndexName) {
-  // Dont initialize if the map is filled.
-  if (!NameFileMap.empty())
+  // Dont initialize if the index has been read already.
+  if (IsIndexLoaded)
     return llvm::Error::success();
 
   // Get the absolute path to the index file.
@@ -463,7 +486,8 @@ llvm::Error CrossTranslationUnitContext::ASTUnitStorage::ensureCTUIndexLoaded(
 
   if (auto IndexMapping = parseCrossTUIndex(IndexFile, CrossTUDir)) {
     // Initialize member map.
-    NameFileMap = *IndexMapping;
+    NameFileMap = std::move(*IndexMapping);
+    IsIndexLoaded = true;
     return llvm::Error::success();
   } else {
     // Error while parsing CrossTU index file.
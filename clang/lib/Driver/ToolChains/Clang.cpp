@@ -1265,6 +1265,7 @@ void Clang::AddPreprocessingOptions(Compilation &C, const JobAction &JA,
   Args.AddAllArgs(CmdArgs,
                   {options::OPT_D, options::OPT_U, options::OPT_I_Group,
                    options::OPT_F, options::OPT_index_header_map});
+  Args.AddLastArg(CmdArgs, options::OPT_fheader_lookup_cache_EQ);
 
   // Add -Wp, and -Xpreprocessor if using the preprocessor.
 
@@ -5505,6 +5506,10 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
                    options::OPT_fno_complete_member_pointers, false))
     CmdArgs.push_back("-fcomplete-member-pointers");
 
+  if (Args.hasFlag(options::OPT_fpch_instantiate_templates,
+                   options::OPT_fno_pch_instantiate_templates, false))
+    CmdArgs.push_back("-fpch-instantiate-templates");
+
   if (!Args.hasFlag(options::OPT_fcxx_static_destructors,
                     options::OPT_fno_cxx_static_destructors, true))
     CmdArgs.push_back("-fno-c++-static-destructors");
@@ -5546,10 +5551,41 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back(Args.MakeArgString(Str));
   }
 
+  // With -fparallel-codegen=<n>, the backend generates the code of each
+  // partition of the module into a temporary object file, and a relocatable
+  // link combines them into the output.
+  SmallVector<const char *, 8> CodeGenPartitions;
+  if (Arg *A = Args.getLastArg(options::OPT_fparallel_codegen_EQ)) {
+    unsigned NumPartitions;
+    if (StringRef(A->getValue()).getAsInteger(10, NumPartitions) ||
+        NumPartitions == 0)
+      D.Diag(diag::err_drv_invalid_int_value)
+          << A->getAsString(Args) << A->getValue();
+    else if (!TC.getTriple().isOSBinFormatELF())
+      D.Diag(diag::err_drv_unsupported_opt_for_target)
+          << A->getAsString(Args) << TC.getTripleString();
+    else if (NumPartitions > 1 && Output.getType() == types::TY_Object &&
+             Output.isFilename() && !D.isUsingLTO() &&
+             DwarfFission == DwarfFissionKind::None) {
+      StringRef Stem = llvm::sys::path::stem(Output.getFilename());
+      for (unsigned I = 0; I != NumPartitions; ++I)
+        CodeGenPartitions.push_back(C.addTempFile(Args.MakeArgString(
+            D.GetTemporaryPath(Stem, types::getTypeTempSuffix(
+                                         types::TY_Object)))));
+    }
+  }
+
   // Add the "-o out -x type src.c" flags last. This is done primarily to make
   // the -cc1 command easier to edit when reproducing compiler crashes.
   if (Output.getType() == types::TY_Dependencies) {
     // Handled with other dependency code.
+  } else if (!CodeGenPartitions.empty()) {
+    CmdArgs.push_back("-o");
+    CmdArgs.push_back(CodeGenPartitions[0]);
+    for (const char *Partition : makeArrayRef(CodeGenPartitions).slice(1)) {
+      CmdArgs.push_back("-split-codegen-output");
+      CmdArgs.push_back(Partition);
+    }
   } else if (Output.isFilename()) {
     CmdArgs.push_back("-o");
     CmdArgs.push_back(Output.getFilename());
@@ -5586,10 +5622,24 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     // fails, so that the main compilation's fallback to cl.exe runs.
     C.addCommand(std::make_unique<ForceSuccessCommand>(JA, *this, Exec,
                                                         CmdArgs, Inputs));
+  } else if (D.CC1Main && !D.CCGenDiagnostics) {
+    // Invoke the CC1 directly in this process.
+    C.addCommand(
+        std::make_unique<CC1Command>(JA, *this, Exec, CmdArgs, Inputs));
   } else {
     C.addCommand(std::make_unique<Command>(JA, *this, Exec, CmdArgs, Inputs));
   }
 
+  if (!CodeGenPartitions.empty()) {
+    ArgStringList LinkArgs;
+    LinkArgs.push_back("-r");
+    LinkArgs.push_back("-o");
+    LinkArgs.push_back(Output.getFilename());
+    LinkArgs.append(CodeGenPartitions.begin(), CodeGenPartitions.end());
+    C.addCommand(std::make_unique<Command>(
+        JA, *this, Args.MakeArgString(TC.GetLinkerPath()), LinkArgs, Inputs));
+  }
+
   // Make the compile command echo its inputs for /showFilenames.
   if (Output.getType() == types::TY_Object &&
       Args.hasFlag(options::OPT__SLASH_showFilenames,
@@ -6314,7 +6364,12 @@ void ClangAs::ConstructJob(Compilation &C, const JobAction &JA,
   CmdArgs.push_back(Input.getFilename());
 
   const char *Exec = getToolChain().getDriver().getClangProgramPath();
-  C.addCommand(std::make_unique<Command>(JA, *this, Exec, CmdArgs, Inputs));
+  if (D.CC1Main && !D.CCGenDiagnostics)
+    // Invoke cc1as directly in this process.
+    C.addCommand(
+        std::make_unique<CC1Command>(JA, *this, Exec, CmdArgs, Inputs));
+  else
+    C.addCommand(std::make_unique<Command>(JA, *this, Exec, CmdArgs, Inputs));
 }
 
 // Begin OffloadBundler
@@ -36,12 +36,12 @@ public:
   // Returns true if 'Range' intersects with one of the input ranges.
   bool affectsCharSourceRange(const CharSourceRange &Range);
 
-private:
   // Returns true if the range from 'First' to 'Last' intersects with one of the
   // input ranges.
   bool affectsTokenRange(const FormatToken &First, const FormatToken &Last,
                          bool IncludeLeadingNewlines);
 
+private:
   // Returns true if one of the input ranges intersect the leading empty lines
   // before 'Tok'.
   bool affectsLeadingEmptyLines(const FormatToken &Tok);
@@ -1316,6 +1316,21 @@ public:
   }
 
 private:
+  std::pair<size_t, size_t>
+  getLinesToAnalyze(ArrayRef<UnwrappedLine> Lines) override {
+    // The local style is derived from the whole file, and the lines outside of
+    // the affected top-level declarations are only known not to change in C++.
+    if (Style.Language != FormatStyle::LK_Cpp ||
+        Style.DerivePointerAlignment ||
+        Style.Standard == FormatStyle::LS_Auto ||
+        Style.ExperimentalAutoDetectBinPacking ||
+        Env.getFirstStartColumn() != 0 || Env.getNextStartColumn() != 0 ||
+        Env.getLastStartColumn() != 0)
+      return {0, Lines.size()};
+    return UnwrappedLineFormatter::finalizeUnaffectedLines(Lines,
+                                                           AffectedRangeMgr);
+  }
+
   static bool inputUsesCRLF(StringRef Text) {
     return Text.count('\r') * 2 > Text.count('\n');
   }
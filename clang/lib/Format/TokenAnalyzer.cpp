@@ -77,9 +77,19 @@ std::pair<tooling::Replacements, unsigned> TokenAnalyzer::process() {
     SmallVector<AnnotatedLine *, 16> AnnotatedLines;
 
     TokenAnnotator Annotator(Style, Tokens.getKeywords());
-    for (unsigned i = 0, e = UnwrappedLines[Run].size(); i != e; ++i) {
+    size_t Begin, End;
+    std::tie(Begin, End) = getLinesToAnalyze(UnwrappedLines[Run]);
+    if (Begin == End)
+      continue;
+    for (size_t i = Begin; i != End; ++i) {
       AnnotatedLines.push_back(new AnnotatedLine(UnwrappedLines[Run][i]));
-      Annotator.annotate(*AnnotatedLines.back());
+      AnnotatedLine &Line = *AnnotatedLines.back();
+      // Keep the line indices relative to the analyzed lines.
+      if (Line.MatchingOpeningBlockLineIndex != UnwrappedLine::kInvalidIndex)
+        Line.MatchingOpeningBlockLineIndex -= Begin;
+      if (Line.MatchingClosingBlockLineIndex != UnwrappedLine::kInvalidIndex)
+        Line.MatchingClosingBlockLineIndex -= Begin;
+      Annotator.annotate(Line);
     }
 
     std::pair<tooling::Replacements, unsigned> RunResult =
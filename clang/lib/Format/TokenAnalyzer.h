@@ -89,6 +89,13 @@ protected:
           SmallVectorImpl<AnnotatedLine *> &AnnotatedLines,
           FormatTokenLexer &Tokens) = 0;
 
+  // Returns the range [Begin, End) of \p Lines that is annotated and passed
+  // to analyze(). By default, this is all of them.
+  virtual std::pair<size_t, size_t>
+  getLinesToAnalyze(ArrayRef<UnwrappedLine> Lines) {
+    return {0, Lines.size()};
+  }
+
   void consumeUnwrappedLine(const UnwrappedLine &TheLine) override;
 
   void finishRun() override;
@@ -1019,6 +1019,47 @@ private:
   llvm::SpecificBumpPtrAllocator<StateNode> Allocator;
 };
 
+/// Returns whether \p Line starts with a token that the \c LevelIndentTracker
+/// indents with an offset relative to its level, like an access specifier.
+bool mayHaveIndentOffset(const UnwrappedLine &Line) {
+  const FormatToken *First = Line.Tokens.front().Tok;
+  if (First->isOneOf(tok::kw_public, tok::kw_protected, tok::kw_private,
+                     tok::at))
+    return true;
+  return Line.Tokens.size() > 1 &&
+         std::next(Line.Tokens.begin())->Tok->is(tok::colon);
+}
+
+/// Returns whether formatting \p Lines can start at \p Lines[I] without
+/// changing the result, given that neither \p Lines[I] nor the lines before
+/// it are affected.
+///
+/// \p Lines[I] must be a top-level line in column 0 after an empty line, so
+/// that whitespace alignment stops before it and it can't be formatted to fix
+/// its indentation. Neither \p Lines[I] nor the line before must allow the
+/// \c LineJoiner to merge \p Lines[I] into a previous line.
+bool startsIndependentLines(ArrayRef<UnwrappedLine> Lines, size_t I) {
+  const UnwrappedLine &Line = Lines[I];
+  const FormatToken *First = Line.Tokens.front().Tok;
+  if (Line.Level != 0 || Line.InPPDirective || First->NewlinesBefore < 2 ||
+      First->OriginalColumn != 0 || mayHaveIndentOffset(Line) ||
+      First->isOneOf(tok::comment, tok::l_brace, tok::r_brace))
+    return false;
+  const UnwrappedLine &Previous = Lines[I - 1];
+  return Previous.Tokens.back().Tok->isNot(tok::l_brace) &&
+         !Previous.Tokens.front().Tok->isOneOf(tok::kw_if, tok::kw_while,
+                                               tok::kw_for, tok::kw_case,
+                                               tok::kw_default);
+}
+
+void markFinalized(const UnwrappedLine &Line) {
+  for (const UnwrappedLineNode &Node : Line.Tokens) {
+    Node.Tok->Finalized = true;
+    for (const UnwrappedLine &Child : Node.Children)
+      markFinalized(Child);
+  }
+}
+
 } // anonymous namespace
 
 unsigned UnwrappedLineFormatter::format(
@@ -1204,6 +1245,88 @@ void UnwrappedLineFormatter::formatFirstToken(
                                      !RootToken.HasUnescapedNewline);
 }
 
+std::pair<size_t, size_t> UnwrappedLineFormatter::finalizeUnaffectedLines(
+    ArrayRef<UnwrappedLine> Lines, AffectedRangeManager &AffectedRangeMgr) {
+  std::pair<size_t, size_t> Range = getLinesToFormat(Lines, AffectedRangeMgr);
+  // Like format() does for the lines it leaves unchanged, so that the lines
+  // shared with the next preprocessor branches aren't formatted there either.
+  for (size_t I = 0, N = Lines.size(); I != N; ++I)
+    if (I < Range.first || I >= Range.second)
+      markFinalized(Lines[I]);
+  return Range;
+}
+
+std::pair<size_t, size_t> UnwrappedLineFormatter::getLinesToFormat(
+    ArrayRef<UnwrappedLine> Lines, AffectedRangeManager &AffectedRangeMgr) {
+  const size_t N = Lines.size();
+  size_t FirstAffected = N, LastAffected = 0;
+  for (size_t I = 0; I != N; ++I) {
+    if (AffectedRangeMgr.affectsTokenRange(*Lines[I].Tokens.front().Tok,
+                                           *Lines[I].Tokens.back().Tok,
+                                           /*IncludeLeadingNewlines=*/true)) {
+      FirstAffected = std::min(FirstAffected, I);
+      LastAffected = I;
+    }
+  }
+  if (FirstAffected == N)
+    return {0, 0};
+
+  // Lines[Begin] is the first line to format, and Lines[End] the first one
+  // after the affected lines that can't be formatted. Lines[End] is formatted
+  // too, as its leading whitespace may be reformatted and the whitespace
+  // alignment of the lines before depends on it; nothing after it is.
+  size_t Begin = FirstAffected ? FirstAffected - 1 : 0;
+  while (Begin > 0 && !startsIndependentLines(Lines, Begin))
+    --Begin;
+  size_t End = LastAffected + 1;
+  while (End < N && !startsIndependentLines(Lines, End))
+    ++End;
+
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    // A closing brace looks at the line with its opening brace, and is
+    // affected if that line is.
+    for (size_t I = Begin; I <= End && I < N; ++I) {
+      size_t Opening = Lines[I].MatchingOpeningBlockLineIndex;
+      if (Opening != UnwrappedLine::kInvalidIndex && Opening < Begin) {
+        Begin = Opening;
+        while (Begin > 0 && !startsIndependentLines(Lines, Begin))
+          --Begin;
+        Changed = true;
+      }
+    }
+    if (End == N)
+      continue;
+    for (size_t I = End + 1; I < N; ++I) {
+      size_t Opening = Lines[I].MatchingOpeningBlockLineIndex;
+      if (Opening != UnwrappedLine::kInvalidIndex && Opening >= Begin &&
+          Opening <= End) {
+        End = I + 1;
+        while (End < N && !startsIndependentLines(Lines, End))
+          ++End;
+        Changed = true;
+        break;
+      }
+    }
+    // Lines[End] keeps its indentation only if all the top-level lines that
+    // determine it are in column 0.
+    for (size_t I = Begin; I <= End && I < N; ++I) {
+      const UnwrappedLine &Line = Lines[I];
+      if (Line.Level == 0 && !Line.InPPDirective &&
+          Line.Tokens.front().Tok->isNot(tok::comment) &&
+          (Line.Tokens.front().Tok->OriginalColumn != 0 ||
+           mayHaveIndentOffset(Line))) {
+        End = N;
+        Changed = true;
+        break;
+      }
+    }
+  }
+  if (End == N)
+    return {Begin, N};
+  return {Begin, End + 1};
+}
+
 unsigned
 UnwrappedLineFormatter::getColumnLimit(bool InPPDirective,
                                        const AnnotatedLine *NextLine) const {
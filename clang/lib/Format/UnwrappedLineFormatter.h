@@ -15,7 +15,9 @@
 #ifndef LLVM_CLANG_LIB_FORMAT_UNWRAPPEDLINEFORMATTER_H
 #define LLVM_CLANG_LIB_FORMAT_UNWRAPPEDLINEFORMATTER_H
 
+#include "AffectedRangeManager.h"
 #include "ContinuationIndenter.h"
+#include "UnwrappedLineParser.h"
 #include "clang/Format/Format.h"
 #include <map>
 
@@ -42,7 +44,24 @@ public:
                   bool FixBadIndentation = false, unsigned FirstStartColumn = 0,
                   unsigned NextStartColumn = 0, unsigned LastStartColumn = 0);
 
+  /// Marks the tokens of the lines of \p Lines that formatting leaves
+  /// unchanged as finalized, and returns the range [Begin, End) of the others,
+  /// whose formatting yields all the replacements in the ranges of
+  /// \p AffectedRangeMgr.
+  ///
+  /// The range starts and ends at top-level lines after an empty line, which
+  /// are not affected and can't be formatted: formatting neither changes the
+  /// lines outside of the range, nor depends on them. This saves annotating
+  /// and formatting the whole file when only a few lines change.
+  static std::pair<size_t, size_t>
+  finalizeUnaffectedLines(ArrayRef<UnwrappedLine> Lines,
+                          AffectedRangeManager &AffectedRangeMgr);
+
 private:
+  static std::pair<size_t, size_t>
+  getLinesToFormat(ArrayRef<UnwrappedLine> Lines,
+                   AffectedRangeManager &AffectedRangeMgr);
+
   /// Add a new line and the required indent before the first Token
   /// of the \c UnwrappedLine if there was no structural parsing error.
   void formatFirstToken(const AnnotatedLine &Line,
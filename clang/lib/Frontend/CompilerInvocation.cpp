@@ -986,6 +986,10 @@ static bool ParseCodeGenArgs(CodeGenOptions &Opts, ArgList &Args, InputKind IK,
             .Default(llvm::sys::path::filename(FrontendOpts.OutputFile).str());
 
   Opts.ThinLinkBitcodeFile = Args.getLastArgValue(OPT_fthin_link_bitcode_EQ);
+  Opts.SplitCodeGenOutputs = Args.getAllArgValues(OPT_split_codegen_output);
+  if (!Opts.SplitCodeGenOutputs.empty() && !Opts.SplitDwarfOutput.empty())
+    Diags.Report(diag::err_drv_argument_not_allowed_with)
+        << "-split-codegen-output" << "-split-dwarf-output";
 
   Opts.MSVolatile = Args.hasArg(OPT_fms_volatile);
 
@@ -2050,6 +2054,8 @@ static void ParseHeaderSearchArgs(HeaderSearchOptions &Opts, ArgList &Args,
   Opts.ModuleCachePath = P.str();
 
   Opts.ModuleUserBuildPath = Args.getLastArgValue(OPT_fmodules_user_build_path);
+  Opts.HeaderLookupCachePath =
+      Args.getLastArgValue(OPT_fheader_lookup_cache_EQ);
   // Only the -fmodule-file=<name>=<file> form.
   for (const auto *A : Args.filtered(OPT_fmodule_file)) {
     StringRef Val = A->getValue();
@@ -3174,6 +3180,9 @@ static void ParseLangArgs(LangOptions &Opts, ArgList &Args, InputKind IK,
 
   Opts.CompleteMemberPointers = Args.hasArg(OPT_fcomplete_member_pointers);
   Opts.BuildingPCHWithObjectFile = Args.hasArg(OPT_building_pch_with_obj);
+  Opts.PCHInstantiateTemplates =
+      Args.hasFlag(OPT_fpch_instantiate_templates,
+                   OPT_fno_pch_instantiate_templates, false);
 }
 
 static bool isStrictlyPreprocessorAction(frontend::ActionKind Action) {
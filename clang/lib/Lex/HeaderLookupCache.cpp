@@ -0,0 +1,284 @@
+//===--- HeaderLookupCache.cpp - Persistent cache of include lookups ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the HeaderLookupCache interface.
+//
+// The cache file is a text file. Its first line identifies the format, and
+// each following line is one of:
+//
+//   d <mtime> <path>
+//     A directory and its modification time, in nanoseconds since the epoch.
+//     The directories are numbered from 0 in the order of these lines.
+//   l <config> <start> <hit> <dirs> <filename>
+//     A lookup of <filename> for the list of search directories whose hash is
+//     <config>, in hexadecimal, that started in the search directory <start>
+//     and found the file in <hit>. <dirs> are the comma-separated numbers of
+//     the directories that must not have changed, or '-' if there are none.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Lex/HeaderLookupCache.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <map>
+
+using namespace clang;
+
+static const char CacheFileMagic[] = "CLANG-HEADER-LOOKUP-CACHE 1";
+
+/// Directories modified this many nanoseconds before the compilation started,
+/// or later, might have changed after a lookup without their modification time
+/// showing it, as the file system only keeps the time with some granularity.
+static const uint64_t MTimeGranularity = 2000000000;
+
+static uint64_t toNanoseconds(llvm::sys::TimePoint<> Time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Time.time_since_epoch())
+      .count();
+}
+
+HeaderLookupCache::HeaderLookupCache(StringRef Path, uint64_t ConfigHash,
+                                     std::vector<std::string> Dirs,
+                                     llvm::vfs::FileSystem &FS)
+    : Path(Path), ConfigHash(ConfigHash), Dirs(std::move(Dirs)), FS(FS),
+      StartTime(toNanoseconds(std::chrono::system_clock::now())) {
+  CacheFile File = readCacheFile();
+  CachedDirs = std::move(File.Dirs);
+  for (Lookup &L : File.Lookups)
+    if (L.ConfigHash == ConfigHash && L.StartIdx <= L.HitIdx &&
+        L.HitIdx <= this->Dirs.size())
+      Cached[getKey(L.Filename, L.StartIdx)] = std::move(L);
+}
+
+std::string HeaderLookupCache::getKey(StringRef Filename, unsigned StartIdx) {
+  return std::to_string(StartIdx) + ":" + Filename.str();
+}
+
+Optional<unsigned> HeaderLookupCache::lookup(StringRef Filename,
+                                             unsigned StartIdx) {
+  auto It = Cached.find(getKey(Filename, StartIdx));
+  if (It == Cached.end())
+    return None;
+  if (!isUpToDate(It->second, CachedDirs)) {
+    Cached.erase(It);
+    return None;
+  }
+  return It->second.HitIdx;
+}
+
+void HeaderLookupCache::record(StringRef Filename, unsigned StartIdx,
+                               unsigned HitIdx) {
+  // Names that escape the search directory can't be checked through the
+  // modification time of the directories below it.
+  if (Filename.contains('\n') || llvm::sys::path::is_absolute(Filename) ||
+      llvm::is_contained(llvm::make_range(llvm::sys::path::begin(Filename),
+                                          llvm::sys::path::end(Filename)),
+                         ".."))
+    return;
+  Recorded[getKey(Filename, StartIdx)] = HitIdx;
+}
+
+Optional<uint64_t> HeaderLookupCache::getDirMTime(StringRef Path) {
+  auto Inserted = DirMTimes.try_emplace(Path);
+  if (Inserted.second) {
+    llvm::ErrorOr<llvm::vfs::Status> Status = FS.status(Path);
+    if (Status && Status->isDirectory())
+      Inserted.first->second =
+          toNanoseconds(Status->getLastModificationTime());
+  }
+  return Inserted.first->second;
+}
+
+bool HeaderLookupCache::isUpToDate(const Lookup &L,
+                                   ArrayRef<WitnessDir> FileDirs) {
+  for (unsigned W : L.Witnesses) {
+    Optional<uint64_t> MTime = getDirMTime(FileDirs[W].Path);
+    if (!MTime || *MTime != FileDirs[W].MTime)
+      return false;
+  }
+  return true;
+}
+
+bool HeaderLookupCache::isKnownOutOfDate(const Lookup &L,
+                                         ArrayRef<WitnessDir> FileDirs) const {
+  for (unsigned W : L.Witnesses) {
+    auto It = DirMTimes.find(FileDirs[W].Path);
+    if (It != DirMTimes.end() &&
+        (!It->second || *It->second != FileDirs[W].MTime))
+      return true;
+  }
+  return false;
+}
+
+std::string HeaderLookupCache::getWitnessDir(StringRef Dir,
+                                             StringRef Filename) {
+  SmallString<256> Witness(Dir);
+  StringRef Parent = llvm::sys::path::parent_path(Filename);
+  for (auto I = llvm::sys::path::begin(Parent),
+            E = llvm::sys::path::end(Parent);
+       I != E; ++I) {
+    SmallString<256> Child(Witness);
+    llvm::sys::path::append(Child, *I);
+    if (!getDirMTime(Child))
+      break;
+    Witness = Child;
+  }
+  return Witness.str();
+}
+
+HeaderLookupCache::CacheFile HeaderLookupCache::readCacheFile() const {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+      llvm::MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!Buffer)
+    return CacheFile();
+
+  StringRef Line, Contents = (*Buffer)->getBuffer();
+  std::tie(Line, Contents) = Contents.split('\n');
+  if (Line != CacheFileMagic)
+    return CacheFile();
+
+  // Start over if the file is malformed.
+  CacheFile File;
+  while (!Contents.empty()) {
+    std::tie(Line, Contents) = Contents.split('\n');
+    StringRef Kind, Rest;
+    std::tie(Kind, Rest) = Line.split(' ');
+    if (Kind == "d") {
+      StringRef MTime;
+      std::tie(MTime, Rest) = Rest.split(' ');
+      WitnessDir D;
+      if (MTime.getAsInteger(10, D.MTime) || Rest.empty())
+        return CacheFile();
+      D.Path = Rest;
+      File.Dirs.push_back(std::move(D));
+    } else if (Kind == "l") {
+      StringRef Config, Start, Hit, Witnesses;
+      std::tie(Config, Rest) = Rest.split(' ');
+      std::tie(Start, Rest) = Rest.split(' ');
+      std::tie(Hit, Rest) = Rest.split(' ');
+      std::tie(Witnesses, Rest) = Rest.split(' ');
+      Lookup L;
+      if (Config.getAsInteger(16, L.ConfigHash) ||
+          Start.getAsInteger(10, L.StartIdx) ||
+          Hit.getAsInteger(10, L.HitIdx) || Rest.empty())
+        return CacheFile();
+      if (Witnesses != "-") {
+        SmallVector<StringRef, 4> Numbers;
+        Witnesses.split(Numbers, ',');
+        for (StringRef Number : Numbers) {
+          unsigned W;
+          if (Number.getAsInteger(10, W) || W >= File.Dirs.size())
+            return CacheFile();
+          L.Witnesses.push_back(W);
+        }
+      }
+      L.Filename = Rest;
+      File.Lookups.push_back(std::move(L));
+    } else {
+      return CacheFile();
+    }
+  }
+  return File;
+}
+
+void HeaderLookupCache::write() {
+  if (Recorded.empty())
+    return;
+
+  CacheFile File = readCacheFile();
+  CacheFile Out;
+  std::map<std::pair<std::string, uint64_t>, unsigned> DirNumbers;
+  auto GetDirNumber = [&](const WitnessDir &D) {
+    auto Inserted =
+        DirNumbers.insert({{D.Path, D.MTime}, (unsigned)Out.Dirs.size()});
+    if (Inserted.second)
+      Out.Dirs.push_back(D);
+    return Inserted.first->second;
+  };
+
+  // Keep the lookups of the other compilations, unless this one knows better.
+  for (Lookup &L : File.Lookups) {
+    if ((L.ConfigHash == ConfigHash &&
+         Recorded.count(getKey(L.Filename, L.StartIdx))) ||
+        isKnownOutOfDate(L, File.Dirs))
+      continue;
+    for (unsigned &W : L.Witnesses)
+      W = GetDirNumber(File.Dirs[W]);
+    Out.Lookups.push_back(std::move(L));
+  }
+
+  for (const auto &R : Recorded) {
+    StringRef Start, Filename;
+    std::tie(Start, Filename) = R.first().split(':');
+    Lookup L;
+    L.ConfigHash = ConfigHash;
+    Start.getAsInteger(10, L.StartIdx);
+    L.HitIdx = R.second;
+    L.Filename = Filename;
+
+    SmallVector<WitnessDir, 4> Witnesses;
+    bool Cacheable = true;
+    for (unsigned I = L.StartIdx; I != L.HitIdx && Cacheable; ++I) {
+      if (Dirs[I].empty() || Dirs[I].find('\n') != std::string::npos ||
+          !getDirMTime(Dirs[I])) {
+        Cacheable = false;
+        break;
+      }
+      WitnessDir W;
+      W.Path = getWitnessDir(Dirs[I], Filename);
+      W.MTime = *getDirMTime(W.Path);
+      // The directory might have changed after the lookup.
+      Cacheable = W.MTime + MTimeGranularity < StartTime;
+      Witnesses.push_back(std::move(W));
+    }
+    if (!Cacheable)
+      continue;
+    for (const WitnessDir &W : Witnesses)
+      L.Witnesses.push_back(GetDirNumber(W));
+    Out.Lookups.push_back(std::move(L));
+  }
+  Recorded.clear();
+
+  // Write to a temporary file first, so that other compilations never see a
+  // partial cache file.
+  SmallString<128> TempPath;
+  int FD;
+  if (llvm::sys::fs::createUniqueFile(Path + "-%%%%%%%%.tmp", FD, TempPath))
+    return;
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << CacheFileMagic << '\n';
+    for (const WitnessDir &D : Out.Dirs)
+      OS << "d " << D.MTime << ' ' << D.Path << '\n';
+    for (const Lookup &L : Out.Lookups) {
+      OS << "l " << llvm::format_hex_no_prefix(L.ConfigHash, 16) << ' '
+         << L.StartIdx << ' ' << L.HitIdx << ' ';
+      if (L.Witnesses.empty())
+        OS << '-';
+      for (unsigned I = 0, E = L.Witnesses.size(); I != E; ++I)
+        OS << (I ? "," : "") << L.Witnesses[I];
+      OS << ' ' << L.Filename << '\n';
+    }
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return;
+    }
+  }
+  if (llvm::sys::fs::rename(TempPath, Path))
+    llvm::sys::fs::remove(TempPath);
+}
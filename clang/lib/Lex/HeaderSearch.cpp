@@ -18,6 +18,7 @@
 #include "clang/Basic/SourceManager.h"
 #include "clang/Lex/DirectoryLookup.h"
 #include "clang/Lex/ExternalPreprocessorSource.h"
+#include "clang/Lex/HeaderLookupCache.h"
 #include "clang/Lex/HeaderMap.h"
 #include "clang/Lex/HeaderSearchOptions.h"
 #include "clang/Lex/LexDiagnostic.h"
@@ -35,6 +36,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/xxhash.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
@@ -75,6 +77,8 @@ HeaderSearch::HeaderSearch(std::shared_ptr<HeaderSearchOptions> HSOpts,
       FileMgr(SourceMgr.getFileManager()), FrameworkMap(64),
       ModMap(SourceMgr, Diags, LangOpts, Target, *this) {}
 
+HeaderSearch::~HeaderSearch() = default;
+
 void HeaderSearch::PrintStats() {
   fprintf(stderr, "\n*** HeaderSearch Stats:\n");
   fprintf(stderr, "%d files tracked.\n", (int)FileInfo.size());
@@ -97,6 +101,39 @@ void HeaderSearch::PrintStats() {
   fprintf(stderr, "%d subframework lookups.\n", NumSubFrameworkLookups);
 }
 
+HeaderLookupCache *HeaderSearch::getPersistentLookupCache() {
+  if (HSOpts->HeaderLookupCachePath.empty())
+    return nullptr;
+
+  // Search paths can be added after the first lookup, which makes the cached
+  // lookups for the previous ones useless.
+  if (PersistentLookupCache) {
+    if (PersistentLookupCache->getNumDirs() == SearchDirs.size())
+      return PersistentLookupCache.get();
+    PersistentLookupCache->write();
+  }
+
+  std::string Config;
+  std::vector<std::string> Dirs;
+  for (const DirectoryLookup &DL : SearchDirs) {
+    SmallString<256> Name(DL.getName());
+    FileMgr.makeAbsolutePath(Name);
+    Config += char('0' + DL.getLookupType());
+    Config += Name;
+    Config += '\0';
+    Dirs.push_back(DL.isNormalDir() ? Name.str() : "");
+  }
+  PersistentLookupCache = std::make_unique<HeaderLookupCache>(
+      HSOpts->HeaderLookupCachePath, llvm::xxHash64(Config), std::move(Dirs),
+      FileMgr.getVirtualFileSystem());
+  return PersistentLookupCache.get();
+}
+
+void HeaderSearch::writePersistentLookupCache() {
+  if (PersistentLookupCache)
+    PersistentLookupCache->write();
+}
+
 /// CreateHeaderMap - This method returns a HeaderMap for the specified
 /// FileEntry, uniquing them through the 'HeaderMaps' datastructure.
 const HeaderMap *HeaderSearch::CreateHeaderMap(const FileEntry *FE) {
@@ -854,6 +891,11 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
   if (FromDir)
     i = FromDir-&SearchDirs[0];
 
+  // The cache shared with other compilations, if this lookup is to be recorded
+  // in it.
+  HeaderLookupCache *PersistentLookup = nullptr;
+  unsigned PersistentStartIdx = 0;
+
   // Cache all of the lookups performed by this method.  Many headers are
   // multiply included, and the "pragma once" optimization prevents them from
   // being relex/pp'd, but they would still have to search through a
@@ -876,6 +918,18 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
     // our search start.  We will fill in our found location below, so prime the
     // start point value.
     CacheLookup.reset(/*StartIdx=*/i+1);
+
+    // Other compilations with the same search paths might know already where
+    // the file is.
+    if (!SkipCache)
+      PersistentLookup = getPersistentLookupCache();
+    if (PersistentLookup) {
+      PersistentStartIdx = i;
+      if (Optional<unsigned> HitIdx = PersistentLookup->lookup(Filename, i)) {
+        i = *HitIdx;
+        PersistentLookup = nullptr;
+      }
+    }
   }
 
   SmallString<64> MappedName;
@@ -903,6 +957,9 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
     if (!File)
       continue;
 
+    if (PersistentLookup && !CacheLookup.MappedName)
+      PersistentLookup->record(Filename, PersistentStartIdx, i);
+
     CurDir = &SearchDirs[i];
 
     // This file is a system header or C++ unfriendly if the dir is.
@@ -954,6 +1011,9 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
     return File;
   }
 
+  if (PersistentLookup && !CacheLookup.MappedName)
+    PersistentLookup->record(Filename, PersistentStartIdx, SearchDirs.size());
+
   // If we are including a file with a quoted include "foo.h" from inside
   // a header in a framework that is currently being built, and we couldn't
   // resolve "foo.h" any other way, change the include to <Foo/foo.h>, where
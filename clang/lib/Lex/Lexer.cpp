@@ -1625,9 +1625,118 @@ bool Lexer::tryConsumeIdentifierUTF8Char(const char *&CurPtr) {
   return true;
 }
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#elif __ALTIVEC__
+#include <altivec.h>
+#undef bool
+#endif
+
+//===----------------------------------------------------------------------===//
+// Vectorized Character Scanning
+//===----------------------------------------------------------------------===//
+//
+// The hot loops of the lexer that walk over runs of characters of one class
+// first skip over the run 16 bytes at a time with these helpers. Each returns
+// a pointer to the first character that is not in the class, or to where
+// fewer than 16 bytes are left before the end of the buffer; the callers then
+// carry on byte by byte from there. Without SSE2 they return the pointer they
+// were given.
+//
+// As the buffer is null terminated and \0 is never in a class, none of the
+// helpers can skip over the end of the buffer or a code-completion point.
+
+#ifdef __SSE2__
+/// Returns the bytes of \p Chunk that are in the ASCII range [Lo, Hi].
+static inline __m128i inRange(__m128i Chunk, char Lo, char Hi) {
+  return _mm_and_si128(_mm_cmpgt_epi8(Chunk, _mm_set1_epi8(Lo - 1)),
+                       _mm_cmplt_epi8(Chunk, _mm_set1_epi8(Hi + 1)));
+}
+
+/// Returns the bytes of \p Chunk that are equal to \p C.
+static inline __m128i equalTo(__m128i Chunk, char C) {
+  return _mm_cmpeq_epi8(Chunk, _mm_set1_epi8(C));
+}
+
+/// Skips 16-byte chunks for which \p InClass returns all bytes.
+template <typename ClassifierTy>
+static inline const char *skipChunks(const char *CurPtr, const char *BufferEnd,
+                                     ClassifierTy InClass) {
+  while (BufferEnd - CurPtr >= 16) {
+    __m128i Chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(CurPtr));
+    unsigned NotInClass = ~_mm_movemask_epi8(InClass(Chunk)) & 0xFFFF;
+    if (NotInClass)
+      return CurPtr + llvm::countTrailingZeros(NotInClass);
+    CurPtr += 16;
+  }
+  return CurPtr;
+}
+#endif
+
+/// Skips the characters of [_A-Za-z0-9]*.
+static const char *skipIdentifierBody(const char *CurPtr,
+                                      const char *BufferEnd) {
+#ifdef __SSE2__
+  CurPtr = skipChunks(CurPtr, BufferEnd, [](__m128i Chunk) {
+    // Setting bit 5 maps upper case letters onto lower case ones, and no
+    // other character onto a letter.
+    __m128i Lower = _mm_or_si128(Chunk, _mm_set1_epi8(0x20));
+    return _mm_or_si128(
+        _mm_or_si128(inRange(Lower, 'a', 'z'), inRange(Chunk, '0', '9')),
+        equalTo(Chunk, '_'));
+  });
+#endif
+  return CurPtr;
+}
+
+/// Skips horizontal whitespace.
+static const char *skipHorizontalWhitespace(const char *CurPtr,
+                                            const char *BufferEnd) {
+#ifdef __SSE2__
+  CurPtr = skipChunks(CurPtr, BufferEnd, [](__m128i Chunk) {
+    return _mm_or_si128(
+        _mm_or_si128(equalTo(Chunk, ' '), equalTo(Chunk, '\t')),
+        _mm_or_si128(equalTo(Chunk, '\f'), equalTo(Chunk, '\v')));
+  });
+#endif
+  return CurPtr;
+}
+
+/// Skips the characters of a string literal that getAndAdvanceChar would
+/// return unchanged. Stops at the closing quote, escapes, newlines, nul
+/// characters and possible trigraphs.
+static const char *skipPlainStringChars(const char *CurPtr,
+                                        const char *BufferEnd) {
+#ifdef __SSE2__
+  CurPtr = skipChunks(CurPtr, BufferEnd, [](__m128i Chunk) {
+    __m128i Special = _mm_or_si128(
+        _mm_or_si128(equalTo(Chunk, '"'), equalTo(Chunk, '\\')),
+        _mm_or_si128(equalTo(Chunk, '\n'), equalTo(Chunk, '\r')));
+    Special = _mm_or_si128(
+        Special, _mm_or_si128(equalTo(Chunk, '\0'), equalTo(Chunk, '?')));
+    return _mm_cmpeq_epi8(Special, _mm_setzero_si128());
+  });
+#endif
+  return CurPtr;
+}
+
+/// Skips the characters of a raw string literal that cannot end it.
+static const char *skipRawStringChars(const char *CurPtr,
+                                      const char *BufferEnd) {
+#ifdef __SSE2__
+  CurPtr = skipChunks(CurPtr, BufferEnd, [](__m128i Chunk) {
+    return _mm_cmpeq_epi8(
+        _mm_or_si128(equalTo(Chunk, ')'), equalTo(Chunk, '\0')),
+        _mm_setzero_si128());
+  });
+#endif
+  return CurPtr;
+}
+
 bool Lexer::LexIdentifier(Token &Result, const char *CurPtr) {
   // Match [_A-Za-z0-9]*, we have already matched [_A-Za-z$]
   unsigned Size;
+  CurPtr = skipIdentifierBody(CurPtr, BufferEnd);
   unsigned char C = *CurPtr++;
   while (isIdentifierBody(C))
     C = *CurPtr++;
@@ -1906,6 +2015,7 @@ bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
            ? diag::warn_cxx98_compat_unicode_literal
            : diag::warn_c99_compat_unicode_literal);
 
+  CurPtr = skipPlainStringChars(CurPtr, BufferEnd);
   char C = getAndAdvanceChar(CurPtr, Result);
   while (C != '"') {
     // Skip escaped characters.  Escaped newlines will already be processed by
@@ -1934,6 +2044,7 @@ bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
 
       NulCharacter = CurPtr-1;
     }
+    CurPtr = skipPlainStringChars(CurPtr, BufferEnd);
     C = getAndAdvanceChar(CurPtr, Result);
   }
 
@@ -2004,6 +2115,7 @@ bool Lexer::LexRawStringLiteral(Token &Result, const char *CurPtr,
   CurPtr += PrefixLen + 1; // skip over prefix and '('
 
   while (true) {
+    CurPtr = skipRawStringChars(CurPtr, BufferEnd);
     char C = *CurPtr++;
 
     if (C == ')') {
@@ -2183,6 +2295,10 @@ bool Lexer::SkipWhitespace(Token &Result, const char *CurPtr,
   // Skip consecutive spaces efficiently.
   while (true) {
     // Skip horizontal whitespace very aggressively.
+    if (isHorizontalWhitespace(Char)) {
+      CurPtr = skipHorizontalWhitespace(CurPtr, BufferEnd);
+      Char = *CurPtr;
+    }
     while (isHorizontalWhitespace(Char))
       Char = *++CurPtr;
 
@@ -2459,13 +2575,6 @@ static bool isEndOfBlockCommentWithEscapedNewLine(const char *CurPtr,
   return true;
 }
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#elif __ALTIVEC__
-#include <altivec.h>
-#undef bool
-#endif
-
 /// We have just read from input the / and * characters that started a comment.
 /// Read until we find the * and / characters that terminate the comment.
 /// Note that we don't bother decoding trigraphs or escaped newlines in block
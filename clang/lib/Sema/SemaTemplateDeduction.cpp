@@ -3827,8 +3827,12 @@ Sema::TemplateDeductionResult Sema::DeduceTemplateArguments(
       return TDK_TooManyArguments;
   }
 
-  // Treat forwarding references as lifetime_const.
+  // Treat forwarding references as lifetime_const. The templates of large
+  // overload sets are deduced against over and over, so only add the
+  // attribute the first time.
   for (ParmVarDecl *PVD : Function->parameters()) {
+    if (PVD->hasAttr<LifetimeconstAttr>())
+      continue;
     QualType ToCheck = PVD->getType();
     if (const auto *ParamExpansion = dyn_cast<PackExpansionType>(ToCheck))
       ToCheck = ParamExpansion->getPattern();
@@ -13,6 +13,7 @@ using namespace clang;
 
 InMemoryModuleCache::State
 InMemoryModuleCache::getPCMState(llvm::StringRef Filename) const {
+  std::lock_guard<std::mutex> Lock(Mutex);
   auto I = PCMs.find(Filename);
   if (I == PCMs.end())
     return Unknown;
@@ -24,6 +25,7 @@ InMemoryModuleCache::getPCMState(llvm::StringRef Filename) const {
 llvm::MemoryBuffer &
 InMemoryModuleCache::addPCM(llvm::StringRef Filename,
                             std::unique_ptr<llvm::MemoryBuffer> Buffer) {
+  std::lock_guard<std::mutex> Lock(Mutex);
   auto Insertion = PCMs.insert(std::make_pair(Filename, std::move(Buffer)));
   assert(Insertion.second && "Already has a PCM");
   return *Insertion.first->second.Buffer;
@@ -32,6 +34,7 @@ InMemoryModuleCache::addPCM(llvm::StringRef Filename,
 llvm::MemoryBuffer &
 InMemoryModuleCache::addBuiltPCM(llvm::StringRef Filename,
                                  std::unique_ptr<llvm::MemoryBuffer> Buffer) {
+  std::lock_guard<std::mutex> Lock(Mutex);
   auto &PCM = PCMs[Filename];
   assert(!PCM.IsFinal && "Trying to override finalized PCM?");
   assert(!PCM.Buffer && "Trying to override tentative PCM?");
@@ -42,6 +45,7 @@ InMemoryModuleCache::addBuiltPCM(llvm::StringRef Filename,
 
 llvm::MemoryBuffer *
 InMemoryModuleCache::lookupPCM(llvm::StringRef Filename) const {
+  std::lock_guard<std::mutex> Lock(Mutex);
   auto I = PCMs.find(Filename);
   if (I == PCMs.end())
     return nullptr;
@@ -57,6 +61,7 @@ bool InMemoryModuleCache::shouldBuildPCM(llvm::StringRef Filename) const {
 }
 
 bool InMemoryModuleCache::tryToDropPCM(llvm::StringRef Filename) {
+  std::lock_guard<std::mutex> Lock(Mutex);
   auto I = PCMs.find(Filename);
   assert(I != PCMs.end() && "PCM to remove is unknown...");
 
@@ -71,6 +76,7 @@ bool InMemoryModuleCache::tryToDropPCM(llvm::StringRef Filename) {
 }
 
 void InMemoryModuleCache::finalizePCM(llvm::StringRef Filename) {
+  std::lock_guard<std::mutex> Lock(Mutex);
   auto I = PCMs.find(Filename);
   assert(I != PCMs.end() && "PCM to finalize is unknown...");
 
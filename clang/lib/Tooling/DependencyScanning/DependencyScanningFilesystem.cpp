@@ -8,7 +8,9 @@
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
 #include "clang/Lex/DependencyDirectivesSourceMinimizer.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Threading.h"
 
 using namespace clang;
@@ -103,6 +105,29 @@ DependencyScanningFilesystemSharedCache::get(StringRef Key) {
   return It.first->getValue();
 }
 
+/// Returns true if the file may be written while the dependencies are scanned,
+/// like the module files that are built implicitly, so that neither its status
+/// nor its contents may be cached.
+static bool shouldBypassCache(StringRef Filename) {
+  StringRef Ext = llvm::sys::path::extension(Filename);
+  return Ext == ".pcm" || Ext == ".pch" || Ext == ".timestamp" ||
+         Ext == ".lock" || llvm::sys::path::filename(Filename) == "modules.idx";
+}
+
+/// Returns true if the file is a source file the minimizer understands. Other
+/// files, in particular module maps, are kept as they are.
+static bool shouldMinimize(StringRef Filename) {
+  StringRef Ext = llvm::sys::path::extension(Filename);
+  // Headers like the C++ standard library ones have no extension.
+  if (Ext.empty())
+    return true;
+  return llvm::StringSwitch<bool>(Ext.drop_front().lower())
+      .Cases("c", "cc", "cpp", "cxx", "c++", true)
+      .Cases("h", "hh", "hpp", "hxx", "h++", true)
+      .Cases("m", "mm", "def", "inc", "ipp", "tcc", true)
+      .Default(false);
+}
+
 llvm::ErrorOr<llvm::vfs::Status>
 DependencyScanningWorkerFilesystem::status(const Twine &Path) {
   SmallString<256> OwnedFilename;
@@ -112,10 +137,11 @@ DependencyScanningWorkerFilesystem::status(const Twine &Path) {
   if (const CachedFileSystemEntry *Entry = getCachedEntry(Filename))
     return Entry->getStatus();
 
-  // FIXME: Handle PCM/PCH files.
-  // FIXME: Handle module map files.
+  if (shouldBypassCache(Filename))
+    return getUnderlyingFS().status(Filename);
 
-  bool KeepOriginalSource = IgnoredFiles.count(Filename);
+  bool KeepOriginalSource =
+      IgnoredFiles.count(Filename) || !shouldMinimize(Filename);
   DependencyScanningFilesystemSharedCache::SharedFileSystemEntry
       &SharedCacheEntry = SharedCache.get(Filename);
   const CachedFileSystemEntry *Result;
@@ -193,10 +219,11 @@ DependencyScanningWorkerFilesystem::openFileForRead(const Twine &Path) {
   if (const CachedFileSystemEntry *Entry = getCachedEntry(Filename))
     return createFile(Entry);
 
-  // FIXME: Handle PCM/PCH files.
-  // FIXME: Handle module map files.
+  if (shouldBypassCache(Filename))
+    return getUnderlyingFS().openFileForRead(Filename);
 
-  bool KeepOriginalSource = IgnoredFiles.count(Filename);
+  bool KeepOriginalSource =
+      IgnoredFiles.count(Filename) || !shouldMinimize(Filename);
   DependencyScanningFilesystemSharedCache::SharedFileSystemEntry
       &SharedCacheEntry = SharedCache.get(Filename);
   const CachedFileSystemEntry *Result;
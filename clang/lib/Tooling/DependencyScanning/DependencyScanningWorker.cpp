@@ -7,13 +7,20 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningWorker.h"
+#include "clang/Driver/Compilation.h"
+#include "clang/Driver/Driver.h"
+#include "clang/Driver/Job.h"
+#include "clang/Driver/Tool.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/CompilerInvocation.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Frontend/Utils.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningService.h"
+#include "clang/Tooling/DependencyScanning/ModuleDepCollector.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Path.h"
 
 using namespace clang;
 using namespace tooling;
@@ -60,15 +67,48 @@ private:
   std::string CWD;
 };
 
+/// Returns the -cc1 command line the driver runs for the given driver command
+/// line, or None if it doesn't run exactly one clang job.
+static llvm::Optional<std::vector<std::string>>
+getCC1CommandLine(ArrayRef<std::string> CommandLine,
+                  IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS) {
+  std::vector<const char *> Argv;
+  for (const std::string &Arg : CommandLine)
+    Argv.push_back(Arg.c_str());
+
+  // The driver already ran for the scanning invocation and reported its
+  // diagnostics.
+  DiagnosticsEngine Diags(new DiagnosticIDs(), new DiagnosticOptions(),
+                          new IgnoringDiagConsumer());
+  driver::Driver TheDriver(Argv[0], llvm::sys::getDefaultTargetTriple(), Diags,
+                           std::move(FS));
+  TheDriver.setTitle("clang_based_tool");
+  TheDriver.setCheckInputsExist(false);
+  std::unique_ptr<driver::Compilation> C(TheDriver.BuildCompilation(Argv));
+  if (!C || C->getJobs().size() != 1)
+    return None;
+  const auto *Cmd = dyn_cast<driver::Command>(&*C->getJobs().begin());
+  if (!Cmd || StringRef(Cmd->getCreator().getName()) != "clang")
+    return None;
+  return std::vector<std::string>(Cmd->getArguments().begin(),
+                                  Cmd->getArguments().end());
+}
+
 /// A clang tool that runs the preprocessor in a mode that's optimized for
 /// dependency scanning for the given compiler invocation.
 class DependencyScanningAction : public tooling::ToolAction {
 public:
   DependencyScanningAction(
       StringRef WorkingDirectory, DependencyConsumer &Consumer,
-      llvm::IntrusiveRefCntPtr<DependencyScanningWorkerFilesystem> DepFS)
+      llvm::IntrusiveRefCntPtr<DependencyScanningWorkerFilesystem> DepFS,
+      llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> RealFS,
+      ScanningOutputFormat Format)
       : WorkingDirectory(WorkingDirectory), Consumer(Consumer),
-        DepFS(std::move(DepFS)) {}
+        DepFS(std::move(DepFS)), RealFS(std::move(RealFS)), Format(Format) {}
+
+  /// Sets the driver command line from the compilation database that the next
+  /// invocation runs for, before it was adjusted for scanning.
+  void setCommandLine(const CommandLineArguments &Args) { CommandLine = Args; }
 
   bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
                      FileManager *FileMgr,
@@ -101,6 +141,16 @@ public:
       // filesystem.
       FileMgr->setVirtualFileSystem(createVFSFromCompilerInvocation(
           CI, Compiler.getDiagnostics(), DepFS));
+
+      // The modules that are built implicitly while scanning are built from
+      // minimized sources, so they must never be picked up by a real build.
+      std::string &ModuleCachePath =
+          Compiler.getHeaderSearchOpts().ModuleCachePath;
+      if (!ModuleCachePath.empty()) {
+        SmallString<128> MinimizedCachePath(ModuleCachePath);
+        llvm::sys::path::append(MinimizedCachePath, "minimized");
+        ModuleCachePath = MinimizedCachePath.str();
+      }
     }
 
     FileMgr->getFileSystemOpts().WorkingDir = WorkingDirectory;
@@ -123,6 +173,22 @@ public:
         std::make_shared<DependencyConsumerForwarder>(std::move(Opts),
                                                       Consumer));
 
+    if (Format == ScanningOutputFormat::Full) {
+      Consumer.handleContextHash(Compiler.getInvocation().getModuleHash());
+      // The module command lines are derived from the translation unit's
+      // command line as given, not the one that was adjusted for scanning. It
+      // still needs the resource directory the scanner used.
+      CommandLineArguments ModuleCommandLine = CommandLine;
+      if (llvm::none_of(ModuleCommandLine, [](StringRef Arg) {
+            return Arg.startswith("-resource-dir");
+          }))
+        ModuleCommandLine.push_back("-resource-dir=" +
+                                    Compiler.getHeaderSearchOpts().ResourceDir);
+      if (auto CC1CommandLine = getCC1CommandLine(ModuleCommandLine, RealFS))
+        Compiler.addDependencyCollector(std::make_shared<ModuleDepCollector>(
+            Compiler, Consumer, getModuleCommandLineBase(*CC1CommandLine)));
+    }
+
     auto Action = std::make_unique<PreprocessOnlyAction>();
     const bool Result = Compiler.ExecuteAction(*Action);
     if (!DepFS)
@@ -134,12 +200,16 @@ private:
   StringRef WorkingDirectory;
   DependencyConsumer &Consumer;
   llvm::IntrusiveRefCntPtr<DependencyScanningWorkerFilesystem> DepFS;
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> RealFS;
+  ScanningOutputFormat Format;
+  CommandLineArguments CommandLine;
 };
 
 } // end anonymous namespace
 
 DependencyScanningWorker::DependencyScanningWorker(
-    DependencyScanningService &Service) {
+    DependencyScanningService &Service)
+    : Format(Service.getFormat()) {
   DiagOpts = new DiagnosticOptions();
   PCHContainerOps = std::make_shared<PCHContainerOperations>();
   RealFS = new ProxyFileSystemWithoutChdir(llvm::vfs::getRealFileSystem());
@@ -178,7 +248,23 @@ llvm::Error DependencyScanningWorker::computeDependencies(
     Tool.setRestoreWorkingDir(false);
     Tool.setPrintErrorMessage(false);
     Tool.setDiagnosticConsumer(&DC);
-    DependencyScanningAction Action(WorkingDirectory, Consumer, DepFS);
+    DependencyScanningAction Action(WorkingDirectory, Consumer, DepFS, RealFS,
+                                    Format);
+    // The command options are rewritten to run Clang in preprocessor only
+    // mode.
+    Tool.appendArgumentsAdjuster(
+        [&Action](const CommandLineArguments &Args, StringRef /*unused*/) {
+          Action.setCommandLine(Args);
+          CommandLineArguments AdjustedArgs = Args;
+          AdjustedArgs.push_back("-o");
+          AdjustedArgs.push_back("/dev/null");
+          AdjustedArgs.push_back("-Xclang");
+          AdjustedArgs.push_back("-Eonly");
+          AdjustedArgs.push_back("-Xclang");
+          AdjustedArgs.push_back("-sys-header-deps");
+          AdjustedArgs.push_back("-Wno-error");
+          return AdjustedArgs;
+        });
     return !Tool.run(&Action);
   });
 }
@@ -0,0 +1,177 @@
+//===- ModuleDepCollector.cpp - Callbacks to collect deps -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Tooling/DependencyScanning/ModuleDepCollector.h"
+#include "clang/Driver/Options.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Lex/Preprocessor.h"
+#include "clang/Serialization/ASTReader.h"
+#include "clang/Tooling/DependencyScanning/DependencyScanningWorker.h"
+#include "llvm/Option/ArgList.h"
+#include "llvm/Option/OptTable.h"
+
+using namespace clang;
+using namespace tooling;
+using namespace dependencies;
+
+std::vector<std::string> ModuleDeps::getFullCommandLine(
+    llvm::function_ref<std::string(StringRef)> LookupPCMPath) const {
+  std::vector<std::string> Ret = NonPathCommandLine;
+  Ret.push_back("-o");
+  Ret.push_back(LookupPCMPath(ModuleName));
+  for (const std::string &Dep : ClangModuleDeps)
+    Ret.push_back("-fmodule-file=" + LookupPCMPath(Dep));
+  return Ret;
+}
+
+/// Returns true if the -cc1 option only applies to the translation unit, and
+/// not to the modules it imports.
+static bool isTranslationUnitOnlyOption(const llvm::opt::Option &O) {
+  using namespace driver::options;
+  using llvm::opt::OptSpecifier;
+  static const OptSpecifier TUOnlyOptions[] = {
+      // The inputs, outputs and action are replaced.
+      OPT_INPUT, OPT_o, OPT_x, OPT_main_file_name, OPT_fmodule_name_EQ,
+      OPT_Action_Group,
+      // Building a module ignores the prefix headers and the PCH, see
+      // PreprocessorOptions::resetNonModularOptions().
+      OPT_include, OPT_include_pch, OPT_imacros, OPT_chain_include,
+      // The other outputs of the translation unit.
+      OPT_M_Group, OPT_dependency_file, OPT_dependency_dot, OPT_sys_header_deps,
+      OPT_module_file_deps, OPT_header_include_file, OPT_H, OPT_show_includes,
+      OPT_diagnostic_serialized_file, OPT_split_dwarf_file,
+      OPT_coverage_data_file, OPT_coverage_notes_file};
+  return llvm::any_of(TUOnlyOptions,
+                      [&](OptSpecifier Opt) { return O.matches(Opt); });
+}
+
+std::vector<std::string>
+dependencies::getModuleCommandLineBase(ArrayRef<std::string> TUCommandLine) {
+  std::vector<const char *> Argv;
+  for (const std::string &Arg : TUCommandLine)
+    Argv.push_back(Arg.c_str());
+
+  unsigned MissingArgIndex, MissingArgCount;
+  llvm::opt::InputArgList Args = driver::getDriverOptTable().ParseArgs(
+      Argv, MissingArgIndex, MissingArgCount, driver::options::CC1Option);
+
+  std::vector<std::string> Result;
+  for (const llvm::opt::Arg *A : Args) {
+    if (isTranslationUnitOnlyOption(A->getOption()))
+      continue;
+    llvm::opt::ArgStringList Rendered;
+    A->render(Args, Rendered);
+    Result.insert(Result.end(), Rendered.begin(), Rendered.end());
+  }
+  return Result;
+}
+
+/// Returns the value of -x that makes the -cc1 invocation parse a module map
+/// for modules in the given language.
+static StringRef getModuleMapInputKind(const LangOptions &LangOpts) {
+  if (LangOpts.ObjC)
+    return LangOpts.CPlusPlus ? "objective-c++-module-map"
+                              : "objective-c-module-map";
+  return LangOpts.CPlusPlus ? "c++-module-map" : "c-module-map";
+}
+
+void ModuleDepCollectorPP::InclusionDirective(
+    SourceLocation HashLoc, const Token &IncludeTok, StringRef FileName,
+    bool IsAngled, CharSourceRange FilenameRange, const FileEntry *File,
+    StringRef SearchPath, StringRef RelativePath, const Module *Imported,
+    SrcMgr::CharacteristicKind FileType) {
+  if (Imported)
+    DirectDeps.insert(Imported->getTopLevelModule());
+}
+
+void ModuleDepCollectorPP::moduleImport(SourceLocation ImportLoc,
+                                        ModuleIdPath Path,
+                                        const Module *Imported) {
+  if (Imported)
+    DirectDeps.insert(Imported->getTopLevelModule());
+}
+
+void ModuleDepCollectorPP::EndOfMainFile() {
+  for (const Module *M : DirectDeps) {
+    handleTopLevelModule(M);
+    MDC.Deps[M->getFullModuleName()].ImportedByMainFile = true;
+  }
+
+  for (auto &&I : MDC.Deps)
+    MDC.Consumer.handleModuleDependency(I.second);
+}
+
+void ModuleDepCollectorPP::handleTopLevelModule(const Module *M) {
+  assert(M == M->getTopLevelModule() && "Expected top level module!");
+
+  auto Inserted = MDC.Deps.try_emplace(M->getFullModuleName());
+  if (!Inserted.second)
+    return;
+
+  ModuleDeps &MD = Inserted.first->second;
+  MD.ModuleName = M->getFullModuleName();
+  MD.ContextHash = MDC.ContextHash;
+
+  const ModuleMap &ModMap =
+      Instance.getPreprocessor().getHeaderSearchInfo().getModuleMap();
+  if (const FileEntry *ModuleMapFile = ModMap.getModuleMapFileForUniquing(M))
+    MD.ClangModuleMapFile = ModuleMapFile->getName();
+
+  // The module was loaded from the module file the scanner built implicitly,
+  // which records the files the module was built from.
+  IntrusiveRefCntPtr<ASTReader> Reader = Instance.getModuleManager();
+  if (const FileEntry *ASTFile = M->getASTFile()) {
+    MD.ImplicitModulePCMPath = ASTFile->getName();
+    if (serialization::ModuleFile *MF =
+            Reader ? Reader->getModuleManager().lookup(ASTFile) : nullptr)
+      Reader->visitInputFiles(
+          *MF, /*IncludeSystem=*/true, /*Complain=*/false,
+          [&](const serialization::InputFile &IF, bool IsSystem) {
+            if (const FileEntry *File = IF.getFile())
+              MD.FileDeps.insert(File->getName());
+          });
+  }
+
+  addModuleDeps(M, M, MD);
+
+  MD.NonPathCommandLine = MDC.ModuleCommandLineBase;
+  MD.NonPathCommandLine.push_back("-emit-module");
+  MD.NonPathCommandLine.push_back("-fmodule-name=" + MD.ModuleName);
+  MD.NonPathCommandLine.push_back("-fno-implicit-modules");
+  MD.NonPathCommandLine.push_back("-x");
+  MD.NonPathCommandLine.push_back(
+      getModuleMapInputKind(Instance.getLangOpts()));
+  MD.NonPathCommandLine.push_back(MD.ClangModuleMapFile);
+}
+
+void ModuleDepCollectorPP::addModuleDeps(const Module *TopLevel,
+                                         const Module *M, ModuleDeps &MD) {
+  for (const Module *Import : M->Imports) {
+    const Module *Dep = Import->getTopLevelModule();
+    if (Dep == TopLevel)
+      continue;
+    std::string DepName = Dep->getFullModuleName();
+    if (llvm::is_contained(MD.ClangModuleDeps, DepName))
+      continue;
+    MD.ClangModuleDeps.push_back(DepName);
+    handleTopLevelModule(Dep);
+  }
+  for (const Module *SubM : M->submodules())
+    addModuleDeps(TopLevel, SubM, MD);
+}
+
+ModuleDepCollector::ModuleDepCollector(
+    CompilerInstance &I, DependencyConsumer &C,
+    std::vector<std::string> ModuleCommandLineBase)
+    : Instance(I), Consumer(C),
+      ModuleCommandLineBase(std::move(ModuleCommandLineBase)),
+      ContextHash(I.getInvocation().getModuleHash()) {}
+
+void ModuleDepCollector::attachToPreprocessor(Preprocessor &PP) {
+  PP.addPPCallbacks(std::make_unique<ModuleDepCollectorPP>(Instance, *this));
+}
@@ -0,0 +1,17 @@
+// RUN: %clang_cc1 -std=c++11 -ast-dump %s | FileCheck %s
+
+// Forwarding references are implicitly lifetime_const. Deducing against the
+// template several times must not add the attribute more than once.
+
+template <typename T> void f(T &&);
+
+void g(int i) {
+  f(i);
+  f(i);
+  f(1);
+}
+
+// CHECK:      FunctionDecl {{.*}} f 'void (T &&)'
+// CHECK-NEXT: ParmVarDecl {{.*}} 'T &&'
+// CHECK-NEXT: LifetimeconstAttr {{.*}} Implicit
+// CHECK-NEXT: FunctionDecl {{.*}} f 'void (int &)'
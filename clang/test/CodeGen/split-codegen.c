@@ -0,0 +1,25 @@
+// REQUIRES: x86-registered-target
+
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -O2 -emit-obj %s -o %t.0.o \
+// RUN:   -split-codegen-output %t.1.o -split-codegen-output %t.2.o
+// RUN: llvm-nm %t.0.o %t.1.o %t.2.o | FileCheck %s
+
+// Also with the new pass manager.
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -O2 -emit-obj %s -o %t.0.o \
+// RUN:   -split-codegen-output %t.1.o -split-codegen-output %t.2.o \
+// RUN:   -fexperimental-new-pass-manager
+// RUN: llvm-nm %t.0.o %t.1.o %t.2.o | FileCheck %s
+
+// Locals have to stay in the partition of their users.
+// CHECK-DAG: t helper
+// CHECK-DAG: T f
+// CHECK-DAG: T g
+// CHECK-DAG: D v
+
+__attribute__((noinline)) static int helper(int x) { return x * 3; }
+
+int v = 42;
+
+int f(int x) { return helper(x) + 1; }
+
+int g(int x) { return helper(x) + v; }
@@ -0,0 +1,10 @@
+// RUN: %clang -fintegrated-cc1 -fsyntax-only -Werror %s
+// RUN: %clang -fno-integrated-cc1 -fsyntax-only -Werror %s
+// RUN: %clang -fno-integrated-cc1 -fintegrated-cc1 -c -o %t.o %s
+// RUN: not %clang -fintegrated-cc1 -fsyntax-only -DBAD %s 2>&1 \
+// RUN:   | FileCheck %s
+
+#ifdef BAD
+#error in-process
+// CHECK: error: in-process
+#endif
@@ -0,0 +1,26 @@
+// Jobs run by the compile server see the modules that they build implicitly
+// into the module cache, both when they build them and when they reuse them.
+
+// REQUIRES: shell
+// UNSUPPORTED: system-windows
+
+// RUN: rm -rf %t && mkdir -p %t/include
+// RUN: echo 'module a { header "a.h" }' > %t/include/module.modulemap
+// RUN: echo 'int a(void);' > %t/include/a.h
+
+// RUN: %clang -cc1serve -j 1 %t/sock < /dev/null > %t/server.log 2>&1 & \
+// RUN:   echo $! > %t/server.pid
+// RUN: trap 'kill $(cat %t/server.pid)' EXIT; \
+// RUN:   while [ ! -S %t/sock ]; do sleep 0.1; done
+
+// RUN: env CLANG_CC1_SERVER=%t/sock %clang_cc1 -fsyntax-only -fmodules \
+// RUN:   -fimplicit-module-maps -fmodules-cache-path=%t/cache -I%t/include %s
+// RUN: env CLANG_CC1_SERVER=%t/sock %clang_cc1 -fsyntax-only -fmodules \
+// RUN:   -fimplicit-module-maps -fmodules-cache-path=%t/cache -I%t/include %s
+
+// The server is still running.
+// RUN: kill -0 $(cat %t/server.pid)
+
+#include "a.h"
+
+int main(void) { return a(); }
@@ -0,0 +1,24 @@
+// RUN: %clang -### -target x86_64-unknown-linux -c %s -o %t.o \
+// RUN:   -fparallel-codegen=3 2>&1 | FileCheck %s
+// CHECK: "-cc1"
+// CHECK-SAME: "-o" "[[P0:[^"]+]]" "-split-codegen-output" "[[P1:[^"]+]]" "-split-codegen-output" "[[P2:[^"]+]]"
+// CHECK-NEXT: "{{[^"]*}}ld{{(\.exe)?}}" "-r" "-o" "{{[^"]*}}.o" "[[P0]]" "[[P1]]" "[[P2]]"
+
+// RUN: %clang -### -target x86_64-unknown-linux -c %s -o %t.o \
+// RUN:   -fparallel-codegen=1 2>&1 | FileCheck --check-prefix=NOSPLIT %s
+// RUN: %clang -### -target x86_64-unknown-linux -S %s -o %t.s \
+// RUN:   -fparallel-codegen=3 2>&1 | FileCheck --check-prefix=NOSPLIT %s
+// RUN: %clang -### -target x86_64-unknown-linux -c %s -o %t.o -flto \
+// RUN:   -fparallel-codegen=3 2>&1 | FileCheck --check-prefix=NOSPLIT %s
+// RUN: %clang -### -target x86_64-unknown-linux -c %s -o %t.o -gsplit-dwarf \
+// RUN:   -fparallel-codegen=3 2>&1 | FileCheck --check-prefix=NOSPLIT %s
+// NOSPLIT-NOT: "-split-codegen-output"
+// NOSPLIT-NOT: "-r"
+
+// RUN: not %clang -### -target x86_64-unknown-linux -c %s \
+// RUN:   -fparallel-codegen=x 2>&1 | FileCheck --check-prefix=INVALID %s
+// INVALID: error: invalid integral value 'x' in '-fparallel-codegen=x'
+
+// RUN: not %clang -### -target x86_64-apple-darwin -c %s \
+// RUN:   -fparallel-codegen=2 2>&1 | FileCheck --check-prefix=UNSUPPORTED %s
+// UNSUPPORTED: error: unsupported option '-fparallel-codegen=2' for target 'x86_64-apple-darwin'
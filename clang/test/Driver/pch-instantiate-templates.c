@@ -0,0 +1,7 @@
+// RUN: %clang -### -x c++-header %s -o %t.pch 2>&1 | FileCheck --check-prefix=NOFLAG %s
+// RUN: %clang -### -x c++-header %s -o %t.pch -fpch-instantiate-templates 2>&1 | FileCheck %s
+// RUN: %clang -### -x c++-header %s -o %t.pch -fpch-instantiate-templates -fno-pch-instantiate-templates 2>&1 | FileCheck --check-prefix=NOFLAG %s
+// RUN: %clang_cl -### /Yc%s /Fp%t.pch /c -fpch-instantiate-templates -- %s 2>&1 | FileCheck %s
+
+// CHECK: "-fpch-instantiate-templates"
+// NOFLAG-NOT: "-fpch-instantiate-templates"
@@ -0,0 +1,29 @@
+// Test this without pch; the template is instantiated at the end of the TU.
+// RUN: %clang_cc1 -fsyntax-only %s -verify
+
+// Test with pch; the template is instantiated in the TU that uses the pch.
+// RUN: %clang_cc1 -x c++-header -emit-pch -o %t %s -verify=pch
+// RUN: %clang_cc1 -include-pch %t -fsyntax-only %s -verify
+
+// Test with -fpch-instantiate-templates; the template is instantiated while
+// building the pch already.
+// RUN: %clang_cc1 -x c++-header -emit-pch -fpch-instantiate-templates \
+// RUN:   -o %t.inst %s -verify
+
+// pch-no-diagnostics
+
+#ifndef HEADER
+#define HEADER
+
+template <typename T> struct A {
+  T foo() const { return "test"; }
+};
+
+double bar(A<double> *a) {
+  return a->foo();
+}
+
+#endif
+
+// expected-error@19 {{cannot initialize return object of type 'double' with an lvalue of type 'const char [5]'}}
+// expected-note@23 {{in instantiation of member function 'A<double>::foo' requested here}}
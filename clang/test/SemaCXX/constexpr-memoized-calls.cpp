@@ -0,0 +1,12 @@
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s -fconstexpr-steps 1000
+// expected-no-diagnostics
+
+// Calls to functions that take and return scalars are only evaluated once per
+// set of arguments; without that, this takes millions of steps.
+constexpr unsigned long long fib(unsigned N) {
+  return N < 2 ? N : fib(N - 1) + fib(N - 2);
+}
+static_assert(fib(60) == 1548008755920ULL, "");
+
+constexpr double half(double D) { return D / 2; }
+static_assert(half(3) == 1.5 && half(-3) == -1.5, "");
@@ -7,15 +7,23 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendActions.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/Serialization/InMemoryModuleCache.h"
 #include "clang/Tooling/CommonOptionsParser.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningService.h"
 #include "clang/Tooling/DependencyScanning/DependencyScanningWorker.h"
 #include "clang/Tooling/JSONCompilationDatabase.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/Options.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
+#include <map>
 #include <mutex>
 #include <thread>
 
@@ -38,6 +46,253 @@ private:
   raw_ostream &OS;
 };
 
+/// The module dependency graph of all the translation units, merged from the
+/// results of the worker threads.
+class FullDeps {
+public:
+  /// \param ModuleFilesDir The directory the module files are put into.
+  FullDeps(StringRef ModuleFilesDir) : ModuleFilesDir(ModuleFilesDir) {}
+
+  void addTranslationUnit(std::string Input, StringRef WorkingDirectory,
+                          std::string ContextHash,
+                          std::vector<std::string> FileDeps,
+                          std::vector<ModuleDeps> Modules) {
+    std::unique_lock<std::mutex> LockGuard(Lock);
+    TranslationUnitDeps TU;
+    TU.Input = std::move(Input);
+    TU.WorkingDirectory = WorkingDirectory;
+    TU.ContextHash = std::move(ContextHash);
+    TU.FileDeps = std::move(FileDeps);
+    for (ModuleDeps &MD : Modules) {
+      if (MD.ImportedByMainFile)
+        TU.ClangModuleDeps.push_back(MD.ModuleName);
+      ModuleKey Key(MD.ContextHash, MD.ModuleName);
+      // Every translation unit with the same context hash sees the same
+      // module, except for ImportedByMainFile. The paths in the command line
+      // are relative to the working directory of the first one.
+      this->Modules.emplace(std::move(Key),
+                            ModuleInfo{std::move(MD), WorkingDirectory});
+    }
+    TUs.push_back(std::move(TU));
+  }
+
+  /// Returns the path of the module file of a module.
+  std::string lookupPCMPath(StringRef ContextHash, StringRef ModuleName) const {
+    SmallString<256> Path(ModuleFilesDir);
+    llvm::sys::path::append(Path, ContextHash, ModuleName + ".pcm");
+    return Path.str();
+  }
+
+  std::vector<std::string> getFullCommandLine(const ModuleDeps &MD) const {
+    return MD.getFullCommandLine([&](StringRef ModuleName) {
+      return lookupPCMPath(MD.ContextHash, ModuleName);
+    });
+  }
+
+  /// Prints the module graph as JSON.
+  void printFullOutput(raw_ostream &OS) {
+    auto ToJSON = [](std::vector<std::string> Strings) {
+      llvm::sort(Strings);
+      return llvm::json::Array(Strings);
+    };
+
+    llvm::json::Array OutModules;
+    for (const auto &KV : Modules) {
+      const ModuleDeps &MD = KV.second.MD;
+      std::vector<std::string> FileDeps;
+      for (const auto &File : MD.FileDeps)
+        FileDeps.push_back(File.getKey());
+      OutModules.push_back(llvm::json::Object{
+          {"name", MD.ModuleName},
+          {"context-hash", MD.ContextHash},
+          {"working-directory", KV.second.WorkingDirectory},
+          {"clang-modulemap-file", MD.ClangModuleMapFile},
+          {"file-deps", ToJSON(std::move(FileDeps))},
+          {"clang-module-deps", ToJSON(MD.ClangModuleDeps)},
+          {"command-line", llvm::json::Array(getFullCommandLine(MD))},
+      });
+    }
+
+    llvm::sort(TUs, [](const TranslationUnitDeps &A,
+                       const TranslationUnitDeps &B) {
+      return A.Input < B.Input;
+    });
+    llvm::json::Array OutTUs;
+    for (const TranslationUnitDeps &TU : TUs) {
+      std::vector<std::string> ModuleFiles;
+      for (const std::string &ModuleName : TU.ClangModuleDeps)
+        ModuleFiles.push_back(lookupPCMPath(TU.ContextHash, ModuleName));
+      OutTUs.push_back(llvm::json::Object{
+          {"input-file", TU.Input},
+          {"working-directory", TU.WorkingDirectory},
+          {"context-hash", TU.ContextHash},
+          {"file-deps", ToJSON(TU.FileDeps)},
+          {"clang-module-deps", ToJSON(TU.ClangModuleDeps)},
+          {"clang-module-files", ToJSON(std::move(ModuleFiles))},
+      });
+    }
+
+    llvm::json::Object Output{{"modules", std::move(OutModules)},
+                              {"translation-units", std::move(OutTUs)}};
+    OS << llvm::formatv("{0:2}\n", llvm::json::Value(std::move(Output)));
+  }
+
+  /// Builds all the module files, each one as soon as the module files of its
+  /// dependencies are built, on \p NumWorkers threads.
+  ///
+  /// The modules share one in-memory module cache, so that each module file is
+  /// read from disk at most once, and none of the builds wait on the others'
+  /// locks like implicit module builds do.
+  ///
+  /// \returns True on error.
+  bool buildModules(unsigned NumWorkers, SharedStream &Errs) {
+    struct ModuleNode {
+      const ModuleInfo *Info = nullptr;
+      std::vector<ModuleNode *> Dependents;
+      std::atomic<unsigned> NumPendingDeps{0};
+      std::atomic<bool> DepsFailed{false};
+    };
+    std::map<ModuleKey, ModuleNode> Nodes;
+    for (const auto &KV : Modules)
+      Nodes[KV.first].Info = &KV.second;
+    for (auto &KV : Nodes) {
+      for (const std::string &Dep : KV.second.Info->MD.ClangModuleDeps) {
+        auto It = Nodes.find(ModuleKey(KV.first.first, Dep));
+        if (It == Nodes.end()) {
+          KV.second.DepsFailed = true;
+          continue;
+        }
+        It->second.Dependents.push_back(&KV.second);
+        ++KV.second.NumPendingDeps;
+      }
+    }
+
+    IntrusiveRefCntPtr<InMemoryModuleCache> ModuleCache =
+        new InMemoryModuleCache;
+    auto PCHContainerOps = std::make_shared<PCHContainerOperations>();
+    std::atomic<bool> HadErrors(false);
+    std::atomic<unsigned> NumBuilt(0);
+    llvm::ThreadPool Pool(NumWorkers);
+
+    std::function<void(ModuleNode &)> Build = [&](ModuleNode &Node) {
+      const ModuleDeps &MD = Node.Info->MD;
+      bool Success = false;
+      if (Node.DepsFailed) {
+        Errs.applyLocked([&](raw_ostream &OS) {
+          OS << "Not building module " << MD.ModuleName
+             << " because a module it depends on failed to build\n";
+        });
+      } else {
+        std::string Diagnostics;
+        llvm::raw_string_ostream DiagOS(Diagnostics);
+        Success =
+            buildModule(getFullCommandLine(MD), Node.Info->WorkingDirectory,
+                        lookupPCMPath(MD.ContextHash, MD.ModuleName),
+                        *ModuleCache, PCHContainerOps, DiagOS);
+        DiagOS.flush();
+        if (!Success || !Diagnostics.empty())
+          Errs.applyLocked([&](raw_ostream &OS) {
+            if (!Success)
+              OS << "Error while building module " << MD.ModuleName << ":\n";
+            OS << Diagnostics;
+          });
+      }
+      if (Success)
+        ++NumBuilt;
+      else
+        HadErrors = true;
+
+      for (ModuleNode *Dependent : Node.Dependents) {
+        if (!Success)
+          Dependent->DepsFailed = true;
+        if (--Dependent->NumPendingDeps == 0)
+          Pool.async([&Build, Dependent] { Build(*Dependent); });
+      }
+    };
+
+    for (auto &KV : Nodes)
+      if (KV.second.NumPendingDeps == 0)
+        Pool.async([&Build, &KV] { Build(KV.second); });
+    Pool.wait();
+
+    // Modules that are part of a dependency cycle never became ready.
+    if (NumBuilt != Nodes.size() && !HadErrors) {
+      Errs.applyLocked([&](raw_ostream &OS) {
+        OS << "Error: cyclic module dependencies\n";
+      });
+      return true;
+    }
+    return HadErrors;
+  }
+
+private:
+  /// Builds a module file with the given -cc1 command line, and adds it to the
+  /// shared in-memory module cache.
+  static bool
+  buildModule(ArrayRef<std::string> CommandLine, StringRef WorkingDirectory,
+              StringRef PCMPath, InMemoryModuleCache &ModuleCache,
+              std::shared_ptr<PCHContainerOperations> PCHContainerOps,
+              raw_ostream &DiagOS) {
+    std::vector<const char *> Args;
+    for (const std::string &Arg : CommandLine)
+      Args.push_back(Arg.c_str());
+
+    IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts = new DiagnosticOptions();
+    TextDiagnosticPrinter DiagPrinter(DiagOS, DiagOpts.get());
+    DiagnosticsEngine Diags(new DiagnosticIDs(), DiagOpts, &DiagPrinter,
+                            /*ShouldOwnClient=*/false);
+    auto Invocation = std::make_shared<CompilerInvocation>();
+    // Skip the "-cc1".
+    if (!CompilerInvocation::CreateFromArgs(
+            *Invocation, llvm::makeArrayRef(Args).drop_front(), Diags))
+      return false;
+    Invocation->getFrontendOpts().DisableFree = false;
+    Invocation->getFileSystemOpts().WorkingDir = WorkingDirectory;
+
+    CompilerInstance Compiler(std::move(PCHContainerOps), &ModuleCache);
+    Compiler.setInvocation(std::move(Invocation));
+    Compiler.createDiagnostics(&DiagPrinter, /*ShouldOwnClient=*/false);
+    if (!Compiler.hasDiagnostics())
+      return false;
+
+    GenerateModuleFromModuleMapAction Action;
+    if (!Compiler.ExecuteAction(Action))
+      return false;
+
+    // The modules that import this one find its module file in the cache.
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+        llvm::MemoryBuffer::getFile(PCMPath);
+    if (!Buffer) {
+      DiagOS << "error: cannot read the module file " << PCMPath << ": "
+             << Buffer.getError().message() << "\n";
+      return false;
+    }
+    ModuleCache.addBuiltPCM(PCMPath, std::move(*Buffer));
+    return true;
+  }
+
+  struct ModuleInfo {
+    ModuleDeps MD;
+    std::string WorkingDirectory;
+  };
+
+  struct TranslationUnitDeps {
+    std::string Input;
+    std::string WorkingDirectory;
+    std::string ContextHash;
+    std::vector<std::string> FileDeps;
+    std::vector<std::string> ClangModuleDeps;
+  };
+
+  /// The context hash and the name of a module.
+  using ModuleKey = std::pair<std::string, std::string>;
+
+  std::string ModuleFilesDir;
+  std::mutex Lock;
+  std::map<ModuleKey, ModuleInfo> Modules;
+  std::vector<TranslationUnitDeps> TUs;
+};
+
 /// The high-level implementation of the dependency discovery tool that runs on
 /// an individual worker thread.
 class DependencyScanningTool {
@@ -46,10 +301,13 @@ public:
   ///
   /// \param Compilations     The reference to the compilation database that's
   /// used by the clang tool.
+  /// \param FD               Where the full dependencies are merged for
+  /// \c ScanningOutputFormat::Full.
   DependencyScanningTool(DependencyScanningService &Service,
                          const tooling::CompilationDatabase &Compilations,
-                         SharedStream &OS, SharedStream &Errs)
-      : Worker(Service), Compilations(Compilations), OS(OS), Errs(Errs) {}
+                         SharedStream &OS, SharedStream &Errs, FullDeps &FD)
+      : Worker(Service), Format(Service.getFormat()),
+        Compilations(Compilations), OS(OS), Errs(Errs), FD(FD) {}
 
   /// Print out the dependency information into a string using the dependency
   /// file format that is specified in the options (-MD is the default) and
@@ -69,6 +327,10 @@ public:
         Dependencies.push_back(File);
       }
 
+      void handleModuleDependency(ModuleDeps MD) override {}
+
+      void handleContextHash(std::string Hash) override {}
+
       void printDependencies(std::string &S) {
         if (!Opts)
           return;
@@ -107,30 +369,75 @@ public:
     return Output;
   }
 
-  /// Computes the dependencies for the given file and prints them out.
+  /// Collects the full dependencies of the given file, including the modules
+  /// it depends on, and merges them into the full dependency graph.
+  llvm::Error addFullDependencies(const std::string &Input, StringRef CWD) {
+    class FullDependencyConsumer : public DependencyConsumer {
+    public:
+      void handleFileDependency(const DependencyOutputOptions &Opts,
+                                StringRef File) override {
+        Dependencies.push_back(File);
+      }
+
+      void handleModuleDependency(ModuleDeps MD) override {
+        Modules.push_back(std::move(MD));
+      }
+
+      void handleContextHash(std::string Hash) override {
+        ContextHash = std::move(Hash);
+      }
+
+      std::vector<std::string> Dependencies;
+      std::vector<ModuleDeps> Modules;
+      std::string ContextHash;
+    };
+
+    FullDependencyConsumer Consumer;
+    if (llvm::Error Err =
+            Worker.computeDependencies(Input, CWD, Compilations, Consumer))
+      return Err;
+    FD.addTranslationUnit(Input, CWD, std::move(Consumer.ContextHash),
+                          std::move(Consumer.Dependencies),
+                          std::move(Consumer.Modules));
+    return llvm::Error::success();
+  }
+
+  /// Computes the dependencies for the given file and prints them out, or
+  /// merges them into the full dependency graph.
   ///
   /// \returns True on error.
   bool runOnFile(const std::string &Input, StringRef CWD) {
-    auto MaybeFile = getDependencyFile(Input, CWD);
-    if (!MaybeFile) {
+    auto HandleError = [this, &Input](llvm::Error Err) {
       llvm::handleAllErrors(
-          MaybeFile.takeError(), [this, &Input](llvm::StringError &Err) {
+          std::move(Err), [this, &Input](llvm::StringError &Err) {
             Errs.applyLocked([&](raw_ostream &OS) {
               OS << "Error while scanning dependencies for " << Input << ":\n";
               OS << Err.getMessage();
             });
           });
       return true;
+    };
+
+    if (Format == ScanningOutputFormat::Full) {
+      if (llvm::Error Err = addFullDependencies(Input, CWD))
+        return HandleError(std::move(Err));
+      return false;
     }
+
+    auto MaybeFile = getDependencyFile(Input, CWD);
+    if (!MaybeFile)
+      return HandleError(MaybeFile.takeError());
     OS.applyLocked([&](raw_ostream &OS) { OS << *MaybeFile; });
     return false;
   }
 
 private:
   DependencyScanningWorker Worker;
+  ScanningOutputFormat Format;
   const tooling::CompilationDatabase &Compilations;
   SharedStream &OS;
   SharedStream &Errs;
+  FullDeps &FD;
 };
 
 llvm::cl::opt<bool> Help("h", llvm::cl::desc("Alias for -help"),
@@ -152,6 +459,29 @@ static llvm::cl::opt<ScanningMode> ScanMode(
                    "unmodified source files")),
     llvm::cl::init(ScanningMode::MinimizedSourcePreprocessing));
 
+static llvm::cl::opt<ScanningOutputFormat> Format(
+    "format", llvm::cl::desc("The output format for the dependencies"),
+    llvm::cl::values(clEnumValN(ScanningOutputFormat::Make, "make",
+                                "Makefile compatible dep file"),
+                     clEnumValN(ScanningOutputFormat::Full, "experimental-full",
+                                "Full dependency graph suitable"
+                                " for explicitly building modules. This format "
+                                "is experimental and will change.")),
+    llvm::cl::init(ScanningOutputFormat::Make),
+    llvm::cl::cat(DependencyScannerCategory));
+
+llvm::cl::opt<bool> BuildModules(
+    "build-modules",
+    llvm::cl::desc("Build the modules found by -format=experimental-full in "
+                   "dependency order, using the -j worker threads"),
+    llvm::cl::init(false), llvm::cl::cat(DependencyScannerCategory));
+
+llvm::cl::opt<std::string> ModuleFilesDir(
+    "module-files-dir",
+    llvm::cl::desc("The directory the module files are built into, in one "
+                   "subdirectory per context hash"),
+    llvm::cl::init(""), llvm::cl::cat(DependencyScannerCategory));
+
 llvm::cl::opt<unsigned>
     NumThreads("j", llvm::cl::Optional,
                llvm::cl::desc("Number of worker threads to use (default: use "
@@ -193,28 +523,23 @@ int main(int argc, const char **argv) {
   for (const auto &Command : Compilations->getAllCompileCommands())
     Inputs.emplace_back(Command.Filename, Command.Directory);
 
-  // The command options are rewritten to run Clang in preprocessor only mode.
-  auto AdjustingCompilations =
-      std::make_unique<tooling::ArgumentsAdjustingCompilations>(
-          std::move(Compilations));
-  AdjustingCompilations->appendArgumentsAdjuster(
-      [](const tooling::CommandLineArguments &Args, StringRef /*unused*/) {
-        tooling::CommandLineArguments AdjustedArgs = Args;
-        AdjustedArgs.push_back("-o");
-        AdjustedArgs.push_back("/dev/null");
-        AdjustedArgs.push_back("-Xclang");
-        AdjustedArgs.push_back("-Eonly");
-        AdjustedArgs.push_back("-Xclang");
-        AdjustedArgs.push_back("-sys-header-deps");
-        AdjustedArgs.push_back("-Wno-error");
-        return AdjustedArgs;
-      });
+  if (BuildModules && Format != ScanningOutputFormat::Full) {
+    llvm::errs()
+        << "error: -build-modules requires -format=experimental-full\n";
+    return 1;
+  }
 
   SharedStream Errs(llvm::errs());
   // Print out the dependency results to STDOUT by default.
   SharedStream DependencyOS(llvm::outs());
 
-  DependencyScanningService Service(ScanMode, ReuseFileManager);
+  // The worker rewrites the commands to run Clang in preprocessor only mode.
+  DependencyScanningService Service(ScanMode, Format, ReuseFileManager);
+  // The module files are built from the working directory of the tool, not
+  // the one of the compilation.
+  SmallString<256> AbsoluteModuleFilesDir(ModuleFilesDir);
+  llvm::sys::fs::make_absolute(AbsoluteModuleFilesDir);
+  FullDeps FD(AbsoluteModuleFilesDir);
 #if LLVM_ENABLE_THREADS
   unsigned NumWorkers =
       NumThreads == 0 ? llvm::hardware_concurrency() : NumThreads;
@@ -224,15 +549,17 @@ int main(int argc, const char **argv) {
   std::vector<std::unique_ptr<DependencyScanningTool>> WorkerTools;
   for (unsigned I = 0; I < NumWorkers; ++I)
     WorkerTools.push_back(std::make_unique<DependencyScanningTool>(
-        Service, *AdjustingCompilations, DependencyOS, Errs));
+        Service, *Compilations, DependencyOS, Errs, FD));
 
   std::vector<std::thread> WorkerThreads;
   std::atomic<bool> HadErrors(false);
   std::mutex Lock;
   size_t Index = 0;
 
-  llvm::outs() << "Running clang-scan-deps on " << Inputs.size()
-               << " files using " << NumWorkers << " workers\n";
+  // Keep the full output valid JSON.
+  if (Format == ScanningOutputFormat::Make)
+    llvm::outs() << "Running clang-scan-deps on " << Inputs.size()
+                 << " files using " << NumWorkers << " workers\n";
   for (unsigned I = 0; I < NumWorkers; ++I) {
     auto Worker = [I, &Lock, &Index, &Inputs, &HadErrors, &WorkerTools]() {
       while (true) {
@@ -262,5 +589,11 @@ int main(int argc, const char **argv) {
   for (auto &W : WorkerThreads)
     W.join();
 
+  if (Format == ScanningOutputFormat::Full) {
+    FD.printFullOutput(llvm::outs());
+    if (BuildModules && FD.buildModules(NumWorkers, Errs))
+      HadErrors = true;
+  }
+
   return HadErrors;
 }
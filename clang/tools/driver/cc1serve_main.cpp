@@ -0,0 +1,859 @@
+//===-- cc1serve_main.cpp - Clang CC1 compile server ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This is the entry point to the clang -cc1serve functionality, which runs
+// -cc1 jobs submitted over a Unix domain socket in a long-running process.
+//
+// The server initializes the targets once and keeps a cache of the file system
+// queries and file contents of all jobs, so that headers and modules used by
+// many translation units are only looked up and read once. On Linux the cache
+// is kept up to date with inotify; elsewhere every cached file is checked with
+// one stat per job. The module cache, where jobs build modules implicitly, is
+// not cached.
+//
+// A -cc1 process submits its job to the server named by the CLANG_CC1_SERVER
+// environment variable. Jobs that rely on process-wide state (-mllvm, plugins,
+// timers and statistics, reading stdin or writing stdout) are not accepted, and
+// the client then compiles as usual. So are jobs from another directory or
+// another clang binary, and jobs whose umask or environment differs from the
+// server's in a way a job can observe.
+//
+// A job that crashes or hits a fatal error takes the server down with it. The
+// clients of all jobs in flight then compile in-process, so the one that
+// failed reports the error itself.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/Stack.h"
+#include "clang/CodeGen/ObjectFilePCHContainerOperations.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/CompilerInvocation.h"
+#include "clang/Frontend/TextDiagnosticBuffer.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/FrontendTool/Utils.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+#ifdef LLVM_ON_UNIX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+using namespace clang;
+
+#ifdef LLVM_ON_UNIX
+
+namespace {
+
+/// The result of a file system query, shared by the jobs of the server.
+struct CachedEntry {
+  llvm::ErrorOr<llvm::vfs::Status> Stat = std::error_code();
+  /// The contents of the file, if it was opened.
+  std::unique_ptr<llvm::MemoryBuffer> Contents;
+  /// The error from opening the file, if it was opened and that failed.
+  std::error_code OpenError;
+
+  bool isOpened() const { return Contents || OpenError; }
+};
+
+using CachedEntryRef = std::shared_ptr<const CachedEntry>;
+
+/// Returns true if both queries found the same file, or failed the same way.
+static bool isSameFile(const llvm::ErrorOr<llvm::vfs::Status> &A,
+                       const llvm::ErrorOr<llvm::vfs::Status> &B) {
+  if (!A || !B)
+    return !A && !B && A.getError() == B.getError();
+  return A->getUniqueID() == B->getUniqueID() &&
+         A->getType() == B->getType() && A->getSize() == B->getSize() &&
+         A->getLastModificationTime() == B->getLastModificationTime();
+}
+
+/// The file system cache of the server.
+///
+/// Entries are grouped by directory. On Linux, every directory is registered
+/// with inotify before the first entry in it is looked up, and its entries are
+/// dropped when anything in it changes. The changes are applied at the start
+/// of every job, so a job sees every change made before it was submitted.
+/// Entries of directories that cannot be watched are checked with a stat
+/// whenever a job first looks them up, and only their contents are reused.
+///
+/// This class is thread safe.
+class FileSystemCache {
+public:
+  explicit FileSystemCache(IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS)
+      : FS(std::move(FS)) {
+#ifdef __linux__
+    InotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+  }
+
+  ~FileSystemCache() {
+    if (InotifyFD >= 0)
+      ::close(InotifyFD);
+  }
+
+  /// Apply the file system changes that happened so far.
+  void update();
+
+  /// Look up the absolute path \p Path. If \p Open is set, the returned entry
+  /// was opened.
+  CachedEntryRef get(StringRef Path, bool Open);
+
+private:
+  struct Directory {
+    /// The inotify watch descriptor, or -1 if the directory is not watched.
+    int WatchFD = -1;
+    bool WatchAttempted = false;
+    /// Incremented whenever entries are dropped, so that entries looked up
+    /// concurrently are not inserted afterwards.
+    unsigned Generation = 0;
+    llvm::StringMap<CachedEntryRef> Entries;
+  };
+  using DirectoryEntry = llvm::StringMapEntry<Directory>;
+
+  Directory &getDirectory(StringRef Name);
+  void invalidate(DirectoryEntry &Dir, bool Unwatch);
+  void invalidatePrefix(StringRef Path);
+  void invalidateAll();
+
+  IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS;
+  int InotifyFD = -1;
+
+  std::mutex Mutex;
+  llvm::StringMap<Directory> Directories;
+  llvm::DenseMap<int, SmallVector<DirectoryEntry *, 1>> Watches;
+};
+
+} // end anonymous namespace
+
+FileSystemCache::Directory &FileSystemCache::getDirectory(StringRef Name) {
+  DirectoryEntry &Dir = *Directories.try_emplace(Name).first;
+  Directory &D = Dir.getValue();
+#ifdef __linux__
+  if (!D.WatchAttempted && InotifyFD >= 0) {
+    D.WatchAttempted = true;
+    D.WatchFD = inotify_add_watch(
+        InotifyFD, Dir.getKey().str().c_str(),
+        IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_DELETE_SELF |
+            IN_MODIFY | IN_MOVE_SELF | IN_MOVED_FROM | IN_MOVED_TO |
+            IN_ONLYDIR);
+    // Entries found while the directory was not watched may be stale.
+    D.Entries.clear();
+    ++D.Generation;
+    if (D.WatchFD >= 0)
+      Watches[D.WatchFD].push_back(&Dir);
+  }
+#endif
+  return D;
+}
+
+void FileSystemCache::invalidate(DirectoryEntry &Dir, bool Unwatch) {
+  Directory &D = Dir.getValue();
+  D.Entries.clear();
+  ++D.Generation;
+  if (!Unwatch)
+    return;
+  // The path may refer to another directory now. Watch it again on its next
+  // use.
+  if (D.WatchFD >= 0) {
+    auto It = Watches.find(D.WatchFD);
+    if (It != Watches.end()) {
+      llvm::erase_if(It->second, [&](DirectoryEntry *E) { return E == &Dir; });
+      if (It->second.empty())
+        Watches.erase(It);
+    }
+  }
+  D.WatchFD = -1;
+  D.WatchAttempted = false;
+}
+
+void FileSystemCache::invalidatePrefix(StringRef Path) {
+  for (DirectoryEntry &Dir : Directories) {
+    StringRef Name = Dir.getKey();
+    if (Name.startswith(Path) &&
+        (Name.size() == Path.size() ||
+         llvm::sys::path::is_separator(Name[Path.size()])))
+      invalidate(Dir, /*Unwatch=*/true);
+  }
+}
+
+void FileSystemCache::invalidateAll() {
+  for (DirectoryEntry &Dir : Directories)
+    invalidate(Dir, /*Unwatch=*/true);
+}
+
+void FileSystemCache::update() {
+#ifdef __linux__
+  if (InotifyFD < 0)
+    return;
+  std::lock_guard<std::mutex> Lock(Mutex);
+  alignas(struct inotify_event) char Buffer[16384];
+  for (;;) {
+    ssize_t Size = ::read(InotifyFD, Buffer, sizeof(Buffer));
+    if (Size < 0 && errno == EINTR)
+      continue;
+    if (Size <= 0)
+      break;
+    for (char *P = Buffer; P < Buffer + Size;) {
+      const auto *Event = reinterpret_cast<const struct inotify_event *>(P);
+      P += sizeof(struct inotify_event) + Event->len;
+
+      if (Event->mask & IN_Q_OVERFLOW) {
+        invalidateAll();
+        continue;
+      }
+      auto It = Watches.find(Event->wd);
+      if (It == Watches.end())
+        continue;
+      // Copy the list, invalidation may change it.
+      SmallVector<DirectoryEntry *, 1> Dirs(It->second.begin(),
+                                            It->second.end());
+      if (Event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+        for (DirectoryEntry *Dir : Dirs)
+          invalidate(*Dir, /*Unwatch=*/true);
+        continue;
+      }
+      StringRef Name(Event->len ? Event->name : "");
+      for (DirectoryEntry *Dir : Dirs) {
+        Directory &D = Dir->getValue();
+        D.Entries.erase(Name);
+        ++D.Generation;
+        // A new or removed entry may be a directory, or a symlink to one.
+        // Either way the paths below it may refer to other files now.
+        if (Event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) {
+          SmallString<256> Path(Dir->getKey());
+          llvm::sys::path::append(Path, Name);
+          invalidatePrefix(Path);
+        }
+      }
+    }
+  }
+#endif
+}
+
+CachedEntryRef FileSystemCache::get(StringRef Path, bool Open) {
+  StringRef DirName = llvm::sys::path::parent_path(Path);
+  StringRef Name = llvm::sys::path::filename(Path);
+
+  CachedEntryRef Cached;
+  bool Watched;
+  unsigned Generation;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Directory &D = getDirectory(DirName);
+    auto It = D.Entries.find(Name);
+    if (It != D.Entries.end()) {
+      Cached = It->second;
+      if (D.WatchFD >= 0 && (!Open || Cached->isOpened()))
+        return Cached;
+    }
+    Watched = D.WatchFD >= 0;
+    Generation = D.Generation;
+  }
+
+  // Query the file system without holding the lock. An unwatched entry only
+  // needs to be read again if the file changed.
+  auto Entry = std::make_shared<CachedEntry>();
+  if (Open) {
+    if (!Watched && Cached && Cached->isOpened() &&
+        isSameFile(FS->status(Path), Cached->Stat))
+      return Cached;
+    auto File = FS->openFileForRead(Path);
+    if (File) {
+      Entry->Stat = (*File)->status();
+      if (Entry->Stat) {
+        // Read the file into memory, so that later changes to it do not
+        // change the contents seen by the jobs.
+        auto Buffer = (*File)->getBuffer(Path, Entry->Stat->getSize(),
+                                         /*RequiresNullTerminator=*/true,
+                                         /*IsVolatile=*/true);
+        if (Buffer)
+          Entry->Contents = std::move(*Buffer);
+        else
+          Entry->OpenError = Buffer.getError();
+      }
+    } else {
+      Entry->OpenError = File.getError();
+    }
+    // Opening fails for directories and missing files, and may succeed for
+    // a file whose status cannot be read. Record both results.
+    if (!Entry->Contents && !Entry->OpenError)
+      Entry->OpenError = Entry->Stat.getError();
+    if (!Entry->Contents)
+      Entry->Stat = FS->status(Path);
+  } else {
+    Entry->Stat = FS->status(Path);
+    if (!Watched && Cached && isSameFile(Entry->Stat, Cached->Stat))
+      return Cached;
+  }
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Directory &D = getDirectory(DirName);
+  if (D.Generation == Generation)
+    D.Entries[Name] = Entry;
+  return Entry;
+}
+
+namespace {
+
+/// A file opened through a JobFileSystem.
+class CachedFile : public llvm::vfs::File {
+public:
+  CachedFile(const CachedEntry &Entry, const Twine &Name)
+      : Contents(Entry.Contents->getBuffer()),
+        Stat(llvm::vfs::Status::copyWithNewName(*Entry.Stat, Name)) {}
+
+  llvm::ErrorOr<llvm::vfs::Status> status() override { return Stat; }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
+  getBuffer(const Twine &Name, int64_t FileSize, bool RequiresNullTerminator,
+            bool IsVolatile) override {
+    return llvm::MemoryBuffer::getMemBuffer(Contents, Name.str(),
+                                            RequiresNullTerminator);
+  }
+
+  std::error_code close() override { return {}; }
+
+private:
+  StringRef Contents;
+  llvm::vfs::Status Stat;
+};
+
+/// The file system of one job. It answers every query of the job from the
+/// server's FileSystemCache, looking up each path there at most once so that
+/// the job sees a consistent file system, and keeps the contents it handed out
+/// alive even if they are dropped from the cache.
+///
+/// The job may create files while it runs, such as the modules it builds into
+/// the module cache, and then look for them. Queries below the module cache go
+/// to the real file system, since modules may also be rebuilt in place, and so
+/// do the queries below the output directory that found nothing.
+///
+/// This class is not thread safe.
+class JobFileSystem : public llvm::vfs::ProxyFileSystem {
+public:
+  explicit JobFileSystem(FileSystemCache &Cache)
+      : ProxyFileSystem(llvm::vfs::getRealFileSystem()), Cache(Cache) {}
+
+  /// Do not cache any query below the directory \p Path.
+  void addUncachedDirectory(StringRef Path) {
+    if (!Path.empty())
+      UncachedDirectories.push_back(getKey(Path).str());
+  }
+
+  /// Do not cache the queries below the directory \p Path that find nothing.
+  void addOutputDirectory(StringRef Path) {
+    if (!Path.empty())
+      OutputDirectories.push_back(getKey(Path).str());
+  }
+
+  llvm::ErrorOr<llvm::vfs::Status> status(const Twine &Path) override {
+    SmallString<256> Key = getKey(Path);
+    if (isBelow(Key, UncachedDirectories))
+      return ProxyFileSystem::status(Path);
+    const CachedEntry &Entry = lookup(Key, /*Open=*/false);
+    if (!Entry.Stat) {
+      if (isBelow(Key, OutputDirectories)) {
+        Entries.erase(Key);
+        return ProxyFileSystem::status(Path);
+      }
+      return Entry.Stat.getError();
+    }
+    return llvm::vfs::Status::copyWithNewName(*Entry.Stat, Path);
+  }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>>
+  openFileForRead(const Twine &Path) override {
+    SmallString<256> Key = getKey(Path);
+    if (isBelow(Key, UncachedDirectories))
+      return ProxyFileSystem::openFileForRead(Path);
+    const CachedEntry &Entry = lookup(Key, /*Open=*/true);
+    if (!Entry.Contents) {
+      if (isBelow(Key, OutputDirectories)) {
+        Entries.erase(Key);
+        return ProxyFileSystem::openFileForRead(Path);
+      }
+      return Entry.OpenError;
+    }
+    return std::make_unique<CachedFile>(Entry, Path);
+  }
+
+private:
+  static SmallString<256> getKey(const Twine &Path) {
+    SmallString<256> Key;
+    Path.toVector(Key);
+    llvm::sys::fs::make_absolute(Key);
+    llvm::sys::path::remove_dots(Key);
+    return Key;
+  }
+
+  static bool isBelow(StringRef Key, ArrayRef<std::string> Dirs) {
+    for (const std::string &Dir : Dirs)
+      if (Key.startswith(Dir) &&
+          (Key.size() == Dir.size() ||
+           llvm::sys::path::is_separator(Key[Dir.size()])))
+        return true;
+    return false;
+  }
+
+  const CachedEntry &lookup(StringRef Key, bool Open) {
+    CachedEntryRef &Entry = Entries[Key];
+    if (!Entry || (Open && !Entry->isOpened()))
+      Entry = Cache.get(Key, Open);
+    return *Entry;
+  }
+
+  FileSystemCache &Cache;
+  llvm::StringMap<CachedEntryRef> Entries;
+  std::vector<std::string> UncachedDirectories;
+  std::vector<std::string> OutputDirectories;
+};
+
+/// The state shared by the jobs of the server.
+struct ServerState {
+  std::string Executable;
+  std::string WorkingDirectory;
+  std::string Umask;
+  std::vector<std::string> Environment;
+  const char *Argv0;
+  void *MainAddr;
+  FileSystemCache Cache{llvm::vfs::getRealFileSystem()};
+};
+
+/// The fixed-size part of a response. The request is a size followed by the
+/// executable, the working directory, the umask, the job environment followed
+/// by an empty string, and the -cc1 arguments of the client, each terminated by
+/// a null character.
+struct ResponseHeader {
+  /// Zero if the job was not run, and the client has to run it.
+  uint32_t Handled;
+  int32_t Result;
+  /// The size of the diagnostics output that follows.
+  uint32_t OutputSize;
+};
+
+} // end anonymous namespace
+
+/// The environment variables that a -cc1 job reads: those that choose the
+/// directory of temporary files, and the PS4 SDK directory.
+static const char *const JobEnvironmentVariables[] = {
+    "TMPDIR", "TMP", "TEMP", "TEMPDIR", "SCE_ORBIS_SDK_DIR"};
+
+/// Returns the job environment variables that are set, as NAME=VALUE strings.
+static std::vector<std::string> getJobEnvironment() {
+  std::vector<std::string> Environment;
+  for (const char *Name : JobEnvironmentVariables)
+    if (const char *Value = ::getenv(Name))
+      Environment.push_back(std::string(Name) + "=" + Value);
+  return Environment;
+}
+
+/// Returns the umask of the process. This is not thread safe.
+static std::string getUmask() {
+  mode_t Mask = ::umask(0);
+  ::umask(Mask);
+  return std::to_string(Mask);
+}
+
+static bool writeAll(int FD, const char *Data, size_t Size) {
+  int Flags = 0;
+#ifdef MSG_NOSIGNAL
+  Flags = MSG_NOSIGNAL;
+#endif
+  while (Size) {
+    ssize_t Written = ::send(FD, Data, Size, Flags);
+    if (Written < 0 && errno == EINTR)
+      continue;
+    if (Written <= 0)
+      return false;
+    Data += Written;
+    Size -= Written;
+  }
+  return true;
+}
+
+static bool readAll(int FD, char *Data, size_t Size) {
+  while (Size) {
+    ssize_t Read = ::read(FD, Data, Size);
+    if (Read < 0 && errno == EINTR)
+      continue;
+    if (Read <= 0)
+      return false;
+    Data += Read;
+    Size -= Read;
+  }
+  return true;
+}
+
+static bool getSocketAddress(StringRef Path, struct sockaddr_un &Addr) {
+  memset(&Addr, 0, sizeof(Addr));
+  Addr.sun_family = AF_UNIX;
+  if (Path.size() >= sizeof(Addr.sun_path))
+    return false;
+  memcpy(Addr.sun_path, Path.data(), Path.size());
+  return true;
+}
+
+static int connectToServer(StringRef Path) {
+  struct sockaddr_un Addr;
+  if (!getSocketAddress(Path, Addr))
+    return -1;
+  int FD = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (FD < 0)
+    return -1;
+#ifdef SO_NOSIGPIPE
+  int One = 1;
+  setsockopt(FD, SOL_SOCKET, SO_NOSIGPIPE, &One, sizeof(One));
+#endif
+  if (::connect(FD, reinterpret_cast<struct sockaddr *>(&Addr),
+                sizeof(Addr)) != 0) {
+    ::close(FD);
+    return -1;
+  }
+  return FD;
+}
+
+/// Returns true if running \p Invocation does not touch process-wide state,
+/// so that it can run in the server next to other jobs.
+static bool canRunInServer(const CompilerInvocation &Invocation) {
+  const FrontendOptions &FrontendOpts = Invocation.getFrontendOpts();
+  switch (FrontendOpts.ProgramAction) {
+  case frontend::EmitAssembly:
+  case frontend::EmitBC:
+  case frontend::EmitLLVM:
+  case frontend::EmitObj:
+  case frontend::GenerateModule:
+  case frontend::GenerateModuleInterface:
+  case frontend::GeneratePCH:
+  case frontend::ParseSyntaxOnly:
+  case frontend::PrintPreprocessedInput:
+    break;
+  default:
+    return false;
+  }
+  if (FrontendOpts.ShowHelp || FrontendOpts.ShowVersion ||
+      FrontendOpts.ShowStats || FrontendOpts.ShowTimers ||
+      FrontendOpts.TimeTrace || FrontendOpts.PrintSupportedCPUs ||
+      !FrontendOpts.LLVMArgs.empty() || !FrontendOpts.Plugins.empty() ||
+      !FrontendOpts.AddPluginActions.empty())
+    return false;
+
+  // Jobs cannot read the client's stdin or write to its stdout.
+  for (const FrontendInputFile &Input : FrontendOpts.Inputs)
+    if (Input.isFile() && Input.getFile() == "-")
+      return false;
+  if (FrontendOpts.OutputFile == "-" ||
+      (FrontendOpts.OutputFile.empty() &&
+       FrontendOpts.ProgramAction == frontend::PrintPreprocessedInput))
+    return false;
+  const DependencyOutputOptions &DepOpts = Invocation.getDependencyOutputOpts();
+  if (DepOpts.OutputFile == "-" ||
+      DepOpts.ShowIncludesDest != ShowIncludesDestination::None ||
+      (DepOpts.ShowHeaderIncludes && DepOpts.HeaderIncludeOutputFile.empty()))
+    return false;
+  if (Invocation.getHeaderSearchOpts().Verbose ||
+      Invocation.getDiagnosticOpts().DiagnosticLogFile == "-")
+    return false;
+
+  // These are passed to the backend as global options.
+  const CodeGenOptions &CodeGenOpts = Invocation.getCodeGenOpts();
+  return !CodeGenOpts.TimePasses && CodeGenOpts.DebugPass.empty() &&
+         CodeGenOpts.LimitFloatPrecision.empty();
+}
+
+/// Run a -cc1 job with arguments \p Args, writing its diagnostics to \p OS.
+/// Returns false if the job cannot run in the server.
+static bool runJob(ArrayRef<const char *> Args, ServerState &State,
+                   raw_ostream &OS, int &Result) {
+  // Created first, so that the contents it handed out outlive the compiler.
+  IntrusiveRefCntPtr<JobFileSystem> FS(new JobFileSystem(State.Cache));
+
+  std::unique_ptr<CompilerInstance> Clang(new CompilerInstance());
+  IntrusiveRefCntPtr<DiagnosticIDs> DiagID(new DiagnosticIDs());
+
+  // Register the support for object-file-wrapped Clang modules.
+  auto PCHOps = Clang->getPCHContainerOperations();
+  PCHOps->registerWriter(std::make_unique<ObjectFilePCHContainerWriter>());
+  PCHOps->registerReader(std::make_unique<ObjectFilePCHContainerReader>());
+
+  IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts = new DiagnosticOptions();
+  TextDiagnosticBuffer *DiagsBuffer = new TextDiagnosticBuffer;
+  DiagnosticsEngine Diags(DiagID, &*DiagOpts, DiagsBuffer);
+  bool Success =
+      CompilerInvocation::CreateFromArgs(Clang->getInvocation(), Args, Diags);
+  if (!canRunInServer(Clang->getInvocation()))
+    return false;
+
+  if (Clang->getHeaderSearchOpts().UseBuiltinIncludes &&
+      Clang->getHeaderSearchOpts().ResourceDir.empty())
+    Clang->getHeaderSearchOpts().ResourceDir =
+        CompilerInvocation::GetResourcesPath(State.Argv0, State.MainAddr);
+
+  // The driver passes -disable-free, which would leak every job.
+  Clang->getFrontendOpts().DisableFree = false;
+  Clang->getCodeGenOpts().DisableFree = false;
+
+  Clang->createDiagnostics(
+      new TextDiagnosticPrinter(OS, &Clang->getDiagnosticOpts()));
+  Result = 1;
+  if (!Clang->hasDiagnostics())
+    return true;
+  DiagsBuffer->FlushDiagnostics(Clang->getDiagnostics());
+  if (!Success)
+    return true;
+
+  if (Clang->getLangOpts().Modules)
+    FS->addUncachedDirectory(Clang->getHeaderSearchOpts().ModuleCachePath);
+  StringRef OutputFile = Clang->getFrontendOpts().OutputFile;
+  if (!OutputFile.empty()) {
+    SmallString<256> OutputDir(OutputFile);
+    llvm::sys::fs::make_absolute(OutputDir);
+    llvm::sys::path::remove_filename(OutputDir);
+    FS->addOutputDirectory(OutputDir);
+  }
+
+  Clang->createFileManager(createVFSFromCompilerInvocation(
+      Clang->getInvocation(), Clang->getDiagnostics(), FS));
+  Result = !ExecuteCompilerInvocation(Clang.get());
+  return true;
+}
+
+static void serveConnection(int FD, ServerState &State) {
+  uint32_t Size;
+  if (!readAll(FD, reinterpret_cast<char *>(&Size), sizeof(Size)) ||
+      Size > (64u << 20))
+    return;
+  std::vector<char> Request(Size);
+  if (!readAll(FD, Request.data(), Size))
+    return;
+
+  SmallVector<const char *, 256> Args;
+  for (size_t I = 0; I < Request.size();) {
+    const char *Arg = Request.data() + I;
+    size_t Len = strnlen(Arg, Request.size() - I);
+    if (I + Len == Request.size())
+      return;
+    Args.push_back(Arg);
+    I += Len + 1;
+  }
+  if (Args.size() < 4)
+    return;
+  auto EnvEnd = std::find_if(Args.begin() + 3, Args.end(),
+                             [](const char *Arg) { return !*Arg; });
+  if (EnvEnd == Args.end())
+    return;
+  bool SameEnvironment =
+      std::equal(Args.begin() + 3, EnvEnd, State.Environment.begin(),
+                 State.Environment.end(),
+                 [](const char *A, const std::string &B) { return A == B; });
+
+  std::string Output;
+  llvm::raw_string_ostream OS(Output);
+  ResponseHeader Header = {0, 0, 0};
+  if (Args[0] == State.Executable && Args[1] == State.WorkingDirectory &&
+      Args[2] == State.Umask && SameEnvironment) {
+    State.Cache.update();
+    struct JobContext {
+      ArrayRef<const char *> Args;
+      ServerState &State;
+      raw_ostream &OS;
+      int Result;
+      bool Handled;
+    } Job = {makeArrayRef(Args).drop_front(EnvEnd - Args.begin() + 1), State,
+             OS, 1, false};
+    // Run the job on a thread with a large enough stack.
+    llvm::llvm_execute_on_thread(
+        [](void *Data) {
+          auto &Job = *static_cast<JobContext *>(Data);
+          noteBottomOfStack();
+          Job.Handled = runJob(Job.Args, Job.State, Job.OS, Job.Result);
+        },
+        &Job, DesiredStackSize);
+    if (Job.Handled) {
+      Header.Handled = 1;
+      Header.Result = Job.Result;
+    }
+  }
+  OS.flush();
+  if (!Header.Handled)
+    Output.clear();
+  Header.OutputSize = Output.size();
+  if (writeAll(FD, reinterpret_cast<const char *>(&Header), sizeof(Header)))
+    writeAll(FD, Output.data(), Output.size());
+}
+
+static int serve(StringRef SocketPath, unsigned NumThreads, const char *Argv0,
+                 void *MainAddr) {
+  struct sockaddr_un Addr;
+  if (!getSocketAddress(SocketPath, Addr)) {
+    llvm::errs() << "error: socket path '" << SocketPath << "' is too long\n";
+    return 1;
+  }
+  // Take over the socket of a server that went away, but not of a live one.
+  int Existing = connectToServer(SocketPath);
+  if (Existing >= 0) {
+    ::close(Existing);
+    llvm::errs() << "error: a server is already listening on '" << SocketPath
+                 << "'\n";
+    return 1;
+  }
+  ::unlink(Addr.sun_path);
+
+  int ListenFD = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (ListenFD < 0 ||
+      ::bind(ListenFD, reinterpret_cast<struct sockaddr *>(&Addr),
+             sizeof(Addr)) != 0 ||
+      ::listen(ListenFD, SOMAXCONN) != 0) {
+    llvm::errs() << "error: cannot listen on '" << SocketPath
+                 << "': " << strerror(errno) << '\n';
+    return 1;
+  }
+  llvm::sys::RemoveFileOnSignal(SocketPath);
+  signal(SIGPIPE, SIG_IGN);
+
+  llvm::InitializeAllTargets();
+  llvm::InitializeAllTargetMCs();
+  llvm::InitializeAllAsmPrinters();
+  llvm::InitializeAllAsmParsers();
+
+  ServerState State;
+  State.Executable = llvm::sys::fs::getMainExecutable(Argv0, MainAddr);
+  SmallString<256> CWD;
+  llvm::sys::fs::current_path(CWD);
+  State.WorkingDirectory = CWD.str();
+  State.Umask = getUmask();
+  State.Environment = getJobEnvironment();
+  State.Argv0 = Argv0;
+  State.MainAddr = MainAddr;
+
+  llvm::ThreadPool Pool(NumThreads);
+  for (;;) {
+    int FD = ::accept(ListenFD, nullptr, nullptr);
+    if (FD < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+      llvm::errs() << "error: accept failed: " << strerror(errno) << '\n';
+      break;
+    }
+    Pool.async([FD, &State] {
+      serveConnection(FD, State);
+      ::close(FD);
+    });
+  }
+  Pool.wait();
+  ::close(ListenFD);
+  return 1;
+}
+
+#endif // LLVM_ON_UNIX
+
+bool cc1serve_submit(ArrayRef<const char *> Argv, const char *Argv0,
+                     void *MainAddr, int &Result) {
+#ifdef LLVM_ON_UNIX
+  llvm::Optional<std::string> SocketPath =
+      llvm::sys::Process::GetEnv("CLANG_CC1_SERVER");
+  if (!SocketPath || SocketPath->empty())
+    return false;
+  int FD = connectToServer(*SocketPath);
+  if (FD < 0)
+    return false;
+
+  SmallString<256> CWD;
+  llvm::sys::fs::current_path(CWD);
+  std::string Request(sizeof(uint32_t), '\0');
+  Request += llvm::sys::fs::getMainExecutable(Argv0, MainAddr);
+  Request += '\0';
+  Request.append(CWD.data(), CWD.size());
+  Request += '\0';
+  Request += getUmask();
+  Request += '\0';
+  for (const std::string &Var : getJobEnvironment()) {
+    Request += Var;
+    Request += '\0';
+  }
+  Request += '\0';
+  for (const char *Arg : Argv) {
+    Request += Arg;
+    Request += '\0';
+  }
+  uint32_t Size = Request.size() - sizeof(uint32_t);
+  memcpy(&Request[0], &Size, sizeof(Size));
+
+  ResponseHeader Header;
+  std::string Output;
+  bool Received =
+      writeAll(FD, Request.data(), Request.size()) &&
+      readAll(FD, reinterpret_cast<char *>(&Header), sizeof(Header));
+  if (Received && Header.Handled) {
+    Output.resize(Header.OutputSize);
+    Received = readAll(FD, &Output[0], Output.size());
+  }
+  ::close(FD);
+  if (!Received || !Header.Handled)
+    return false;
+  llvm::errs() << Output;
+  Result = Header.Result;
+  return true;
+#else
+  return false;
+#endif
+}
+
+int cc1serve_main(ArrayRef<const char *> Argv, const char *Argv0,
+                  void *MainAddr) {
+  StringRef SocketPath;
+  unsigned NumThreads = llvm::hardware_concurrency();
+  for (size_t I = 0; I < Argv.size(); ++I) {
+    StringRef Arg = Argv[I];
+    if (Arg == "-j" && I + 1 < Argv.size())
+      Arg = Argv[++I];
+    else if (!Arg.consume_front("-j")) {
+      if (!SocketPath.empty()) {
+        llvm::errs() << "error: unexpected argument '" << Arg << "'\n";
+        return 1;
+      }
+      SocketPath = Arg;
+      continue;
+    }
+    if (Arg.getAsInteger(10, NumThreads) || NumThreads == 0) {
+      llvm::errs() << "error: invalid number of jobs '" << Arg << "'\n";
+      return 1;
+    }
+  }
+  if (SocketPath.empty()) {
+    llvm::errs() << "usage: clang -cc1serve [-j <jobs>] <socket>\n";
+    return 1;
+  }
+#ifdef LLVM_ON_UNIX
+  return serve(SocketPath, NumThreads, Argv0, MainAddr);
+#else
+  llvm::errs() << "error: -cc1serve is not supported on this platform\n";
+  return 1;
+#endif
+}
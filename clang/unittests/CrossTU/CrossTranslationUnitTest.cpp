@@ -193,5 +193,40 @@ TEST(CrossTranslationUnit, CTUDirIsHandledCorrectly) {
   EXPECT_EQ(ParsedIndex["a"], "/ctudir/b/c/d");
 }
 
+TEST(CrossTranslationUnit, IndexErrorsReportTheLine) {
+  auto ParseIndex = [](StringRef IndexText) {
+    int IndexFD;
+    llvm::SmallString<256> IndexFileName;
+    EXPECT_FALSE(llvm::sys::fs::createTemporaryFile("index", "txt", IndexFD,
+                                                    IndexFileName));
+    llvm::ToolOutputFile IndexFile(IndexFileName, IndexFD);
+    IndexFile.os() << IndexText;
+    IndexFile.os().flush();
+    return parseCrossTUIndex(IndexFileName, "");
+  };
+  auto ExpectError = [](llvm::Expected<llvm::StringMap<std::string>> E,
+                        index_error_code Code, int LineNo) {
+    ASSERT_FALSE((bool)E);
+    llvm::handleAllErrors(E.takeError(), [&](const IndexError &IE) {
+      EXPECT_EQ(IE.getCode(), Code);
+      EXPECT_EQ(IE.getLineNum(), LineNo);
+    });
+  };
+
+  ExpectError(ParseIndex("a /b\nc /d\na /e\n"),
+              index_error_code::multiple_definitions, 3);
+  ExpectError(ParseIndex("a /b\n\nc /d\n"),
+              index_error_code::invalid_index_format, 2);
+  ExpectError(ParseIndex("a /b\n /c"), index_error_code::invalid_index_format,
+              2);
+
+  // The last line doesn't need a line break.
+  llvm::Expected<llvm::StringMap<std::string>> IndexOrErr =
+      ParseIndex("a /b\nc /d");
+  ASSERT_TRUE((bool)IndexOrErr);
+  EXPECT_EQ(2u, IndexOrErr->size());
+  EXPECT_EQ("/d", IndexOrErr->lookup("c"));
+}
+
 } // end namespace cross_tu
 } // end namespace clang
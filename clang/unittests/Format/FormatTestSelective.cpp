@@ -603,6 +603,44 @@ TEST_F(FormatTestSelective, KeepsIndentAfterCommentSectionImport) {
   EXPECT_EQ(Code, format(Code, 47, 1));
 }
 
+TEST_F(FormatTestSelective, DoesNotFormatUnaffectedTopLevelDeclarations) {
+  EXPECT_EQ("int  a;\n"
+            "\n"
+            "void f() {}\n"
+            "\n"
+            "int  b;",
+            format("int  a;\n"
+                   "\n"
+                   "void  f( ) {\n"
+                   "}\n"
+                   "\n"
+                   "int  b;",
+                   9, 0));
+  // The #endif is shared by both branches, and isn't affected in either.
+  EXPECT_EQ("#if A\n"
+            "void  f( ) {\n"
+            "}\n"
+            "#else\n"
+            "int  b;\n"
+            "\n"
+            "void f() {}\n"
+            " #endif\n"
+            "\n"
+            "int  c;",
+            format("#if A\n"
+                   "void  f( ) {\n"
+                   "}\n"
+                   "#else\n"
+                   "int  b;\n"
+                   "\n"
+                   "void  f( ) {\n"
+                   "}\n"
+                   " #endif\n"
+                   "\n"
+                   "int  c;",
+                   36, 0));
+}
+
 } // end namespace
 } // end namespace format
 } // end namespace clang
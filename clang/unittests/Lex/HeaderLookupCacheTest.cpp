@@ -0,0 +1,141 @@
+//===- unittests/Lex/HeaderLookupCacheTest.cpp - HeaderLookupCache tests --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Lex/HeaderLookupCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "gtest/gtest.h"
+#include <chrono>
+
+using namespace clang;
+using namespace llvm;
+
+namespace {
+
+class HeaderLookupCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("header-lookup-cache", Root));
+    // The last search directory is a header map.
+    Dirs = {makeDir("a"), makeDir("b"), ""};
+    makeDir("a/sub");
+    makeFile("b/x.h");
+    makeDir("b/sub");
+    makeFile("b/sub/y.h");
+    CachePath = (Root + "/cache").str();
+    for (StringRef Dir : {"a", "a/sub", "b", "b/sub"})
+      makeOld(Dir);
+  }
+
+  void TearDown() override { sys::fs::remove_directories(Root); }
+
+  std::string makeDir(StringRef Name) {
+    SmallString<128> Path(Root);
+    sys::path::append(Path, Name);
+    EXPECT_FALSE(sys::fs::create_directory(Path));
+    return Path.str();
+  }
+
+  void makeFile(StringRef Name) {
+    SmallString<128> Path(Root);
+    sys::path::append(Path, Name);
+    int FD;
+    ASSERT_FALSE(sys::fs::openFileForWrite(Path, FD));
+    sys::Process::SafelyCloseFileDescriptor(FD);
+  }
+
+  // Pretend that the directory was last modified an hour ago, so that the
+  // cache trusts its modification time.
+  void makeOld(StringRef Name) {
+    SmallString<128> Path(Root);
+    sys::path::append(Path, Name);
+    int FD;
+    ASSERT_FALSE(sys::fs::openFileForRead(Path, FD));
+    EXPECT_FALSE(sys::fs::setLastAccessAndModificationTime(
+        FD, std::chrono::system_clock::now() - std::chrono::hours(1)));
+    sys::Process::SafelyCloseFileDescriptor(FD);
+  }
+
+  HeaderLookupCache makeCache(uint64_t ConfigHash = 1) {
+    return HeaderLookupCache(CachePath, ConfigHash, Dirs,
+                             *vfs::getRealFileSystem());
+  }
+
+  SmallString<128> Root;
+  std::vector<std::string> Dirs;
+  std::string CachePath;
+};
+
+TEST_F(HeaderLookupCacheTest, RoundTrip) {
+  {
+    HeaderLookupCache Cache = makeCache();
+    EXPECT_EQ(None, Cache.lookup("x.h", 0));
+    Cache.record("x.h", 0, 1);
+    Cache.record("sub/y.h", 0, 1);
+    Cache.record("missing.h", 0, 3);
+    Cache.write();
+  }
+
+  HeaderLookupCache Cache = makeCache();
+  EXPECT_EQ(Optional<unsigned>(1), Cache.lookup("x.h", 0));
+  EXPECT_EQ(Optional<unsigned>(1), Cache.lookup("sub/y.h", 0));
+  EXPECT_EQ(None, Cache.lookup("x.h", 1));
+  // Lookups that skip a directory that isn't a normal one aren't cached.
+  EXPECT_EQ(None, Cache.lookup("missing.h", 0));
+
+  // The lookups are for one list of search directories only.
+  EXPECT_EQ(None, makeCache(2).lookup("x.h", 0));
+}
+
+TEST_F(HeaderLookupCacheTest, Invalidation) {
+  {
+    HeaderLookupCache Cache = makeCache();
+    Cache.record("x.h", 0, 1);
+    Cache.record("sub/y.h", 0, 1);
+    Cache.write();
+  }
+
+  // Creating a file in a skipped directory invalidates the lookups that could
+  // have found it there, but not the ones of files in its subdirectories.
+  makeFile("a/x.h");
+  HeaderLookupCache Cache = makeCache();
+  EXPECT_EQ(None, Cache.lookup("x.h", 0));
+  EXPECT_EQ(Optional<unsigned>(1), Cache.lookup("sub/y.h", 0));
+}
+
+TEST_F(HeaderLookupCacheTest, RecentlyModified) {
+  // A directory that changed during the compilation might have changed after
+  // the lookup.
+  makeFile("a/z.h");
+  {
+    HeaderLookupCache Cache = makeCache();
+    Cache.record("x.h", 0, 1);
+    Cache.write();
+  }
+  EXPECT_EQ(None, makeCache().lookup("x.h", 0));
+}
+
+TEST_F(HeaderLookupCacheTest, Merge) {
+  {
+    HeaderLookupCache Cache1 = makeCache();
+    HeaderLookupCache Cache2 = makeCache();
+    Cache1.record("x.h", 0, 1);
+    Cache2.record("sub/y.h", 0, 1);
+    Cache1.write();
+    Cache2.write();
+  }
+
+  HeaderLookupCache Cache = makeCache();
+  EXPECT_EQ(Optional<unsigned>(1), Cache.lookup("x.h", 0));
+  EXPECT_EQ(Optional<unsigned>(1), Cache.lookup("sub/y.h", 0));
+}
+
+} // end anonymous namespace
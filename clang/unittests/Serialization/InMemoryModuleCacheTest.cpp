@@ -7,8 +7,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Serialization/InMemoryModuleCache.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace llvm;
 using namespace clang;
@@ -116,4 +120,28 @@ TEST(InMemoryModuleCacheTest, finalizePCM) {
   EXPECT_TRUE(Cache.isPCMFinal("B"));
 }
 
+#if LLVM_ENABLE_THREADS
+TEST(InMemoryModuleCacheTest, concurrentBuiltPCMs) {
+  InMemoryModuleCache Cache;
+  std::vector<std::thread> Threads;
+  for (int T = 0; T != 4; ++T)
+    Threads.emplace_back([&Cache, T] {
+      for (int I = 0; I != 100; ++I) {
+        std::string Name = std::to_string(T) + "/" + std::to_string(I);
+        Cache.addBuiltPCM(Name, getBuffer(I));
+        EXPECT_TRUE(Cache.isPCMFinal(Name));
+        // Look at the PCMs the other threads are adding.
+        Cache.lookupPCM(std::to_string((T + 1) % 4) + "/" + std::to_string(I));
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (int T = 0; T != 4; ++T)
+    for (int I = 0; I != 100; ++I)
+      EXPECT_EQ(InMemoryModuleCache::Final,
+                Cache.getPCMState(std::to_string(T) + "/" + std::to_string(I)));
+}
+#endif
+
 } // namespace
@@ -135,7 +135,8 @@ struct AsanChunk: ChunkBase {
 struct QuarantineCallback {
   QuarantineCallback(AllocatorCache *cache, BufferedStackTrace *stack)
       : cache_(cache),
-        stack_(stack) {
+        stack_(stack),
+        thread_stats_(nullptr) {
   }
 
   void Recycle(AsanChunk *m) {
@@ -143,10 +144,12 @@ struct QuarantineCallback {
     atomic_store((atomic_uint8_t*)m, CHUNK_AVAILABLE, memory_order_relaxed);
     CHECK_NE(m->alloc_tid, kInvalidTid);
     CHECK_NE(m->free_tid, kInvalidTid);
-    PoisonShadow(m->Beg(),
-                 RoundUpTo(m->UsedSize(), SHADOW_GRANULARITY),
-                 kAsanHeapLeftRedzoneMagic);
     void *p = reinterpret_cast<void *>(m->AllocBeg());
+    // The secondary allocator unmaps its chunks right away, and the unmap
+    // callback clears their shadow without writing it.
+    if (CanPoisonMemory() && get_allocator().FromPrimary(p))
+      FastPoisonShadow(m->Beg(), RoundUpTo(m->UsedSize(), SHADOW_GRANULARITY),
+                       kAsanHeapLeftRedzoneMagic);
     if (p != m) {
       uptr *alloc_magic = reinterpret_cast<uptr *>(p);
       CHECK_EQ(alloc_magic[0], kAllocBegMagic);
@@ -156,10 +159,12 @@ struct QuarantineCallback {
       CHECK_EQ(alloc_magic[1], reinterpret_cast<uptr>(m));
     }
 
-    // Statistics.
-    AsanStats &thread_stats = GetCurrentThreadStats();
-    thread_stats.real_frees++;
-    thread_stats.really_freed += m->UsedSize();
+    // Statistics. Chunks are recycled a batch at a time, so look up the stats
+    // of the thread once per batch.
+    if (!thread_stats_)
+      thread_stats_ = &GetCurrentThreadStats();
+    thread_stats_->real_frees++;
+    thread_stats_->really_freed += m->UsedSize();
 
     get_allocator().Deallocate(cache_, p);
   }
@@ -179,6 +184,7 @@ struct QuarantineCallback {
  private:
   AllocatorCache* const cache_;
   BufferedStackTrace* const stack_;
+  AsanStats *thread_stats_;
 };
 
 typedef Quarantine<QuarantineCallback, AsanChunk> AsanQuarantine;
@@ -512,7 +518,7 @@ struct Allocator {
         RoundDownTo(size, SHADOW_GRANULARITY);
     // Unpoison the bulk of the memory region.
     if (size_rounded_down_to_granularity)
-      PoisonShadow(user_beg, size_rounded_down_to_granularity, 0);
+      FastPoisonShadow(user_beg, size_rounded_down_to_granularity, 0);
     // Deal with the end of the region if size is not aligned to granularity.
     if (size != size_rounded_down_to_granularity && CanPoisonMemory()) {
       u8 *shadow =
@@ -584,9 +590,9 @@ struct Allocator {
     }
 
     // Poison the region.
-    PoisonShadow(m->Beg(),
-                 RoundUpTo(m->UsedSize(), SHADOW_GRANULARITY),
-                 kAsanHeapFreeMagic);
+    if (CanPoisonMemory())
+      FastPoisonShadow(m->Beg(), RoundUpTo(m->UsedSize(), SHADOW_GRANULARITY),
+                       kAsanHeapFreeMagic);
 
     AsanStats &thread_stats = GetCurrentThreadStats();
     thread_stats.frees++;
@@ -33,6 +33,29 @@ void PoisonShadowPartialRightRedzone(uptr addr,
                                      uptr redzone_size,
                                      u8 value);
 
+// The shadow of most heap chunks fits in this many bytes, which are filled
+// with word-sized stores rather than with a call to memset.
+const uptr kSmallShadowSize = 64;
+
+// Fills a shadow range of at most kSmallShadowSize bytes. The first and last
+// stores may overlap the others.
+ALWAYS_INLINE void FillSmallShadow(uptr shadow_beg, uptr shadow_size,
+                                   u8 value) {
+  const u64 word = value * 0x0101010101010101ULL;
+  if (shadow_size >= sizeof(u64)) {
+    uptr last = shadow_beg + shadow_size - sizeof(u64);
+    for (uptr p = shadow_beg; p < last; p += sizeof(u64))
+      *(uu64 *)p = word;
+    *(uu64 *)last = word;
+  } else if (shadow_size >= sizeof(u32)) {
+    *(uu32 *)shadow_beg = (u32)word;
+    *(uu32 *)(shadow_beg + shadow_size - sizeof(u32)) = (u32)word;
+  } else {
+    for (uptr i = 0; i < shadow_size; i++)
+      ((u8 *)shadow_beg)[i] = value;
+  }
+}
+
 // Fast versions of PoisonShadow and PoisonShadowPartialRightRedzone that
 // assume that memory addresses are properly aligned. Use in
 // performance-critical code with care.
@@ -46,6 +69,10 @@ ALWAYS_INLINE void FastPoisonShadow(uptr aligned_beg, uptr aligned_size,
   uptr shadow_beg = MEM_TO_SHADOW(aligned_beg);
   uptr shadow_end = MEM_TO_SHADOW(
       aligned_beg + aligned_size - SHADOW_GRANULARITY) + 1;
+  if (shadow_end - shadow_beg <= kSmallShadowSize) {
+    FillSmallShadow(shadow_beg, shadow_end - shadow_beg, value);
+    return;
+  }
   // FIXME: Page states are different on Windows, so using the same interface
   // for mapping shadow and zeroing out pages doesn't "just work", so we should
   // probably provide higher-level interface for these operations.
@@ -70,7 +97,14 @@ ALWAYS_INLINE void FastPoisonShadow(uptr aligned_beg, uptr aligned_size,
       if (page_end != shadow_end) {
         REAL(memset)((void *)page_end, 0, shadow_end - page_end);
       }
+#if SANITIZER_LINUX
+      // MADV_DONTNEED zero-fills the pages on their next access. Unlike
+      // mapping them again, it keeps the attributes of the shadow mapping,
+      // and doesn't have to split it.
+      ReleaseMemoryPagesToOS(page_beg, page_end);
+#else
       ReserveShadowMemoryRange(page_beg, page_end - 1, nullptr);
+#endif
     }
   }
 #endif // SANITIZER_FUCHSIA
@@ -78,6 +78,42 @@ TEST(AddressSanitizer, FakeStackBenchmark) {
     Ident(&FunctionWithLargeStack)();
 }
 
+// Allocates and frees chunks of mixed sizes, mostly small ones, with a few
+// that go to the secondary allocator. The chunks stay live for a while, and
+// are freed in a random order, so that the quarantine is recycled often.
+static void *MallocFreeWorker(void *unused) {
+  const size_t kNumLive = 64;
+  void *live[kNumLive] = {};
+  unsigned seed = 12345;
+  for (size_t i = 0; i < (1 << 22); i++) {
+    seed = seed * 1103515245 + 12345;
+    size_t slot = (seed >> 8) % kNumLive;
+    free(live[slot]);
+    size_t size = (seed >> 16) % 8 == 0 ? 512 + (seed >> 20) % 8192
+                                        : 8 + (seed >> 20) % 120;
+    if (i % 4096 == 0)
+      size = 1 << 20;
+    live[slot] = malloc(size);
+    break_optimization(live[slot]);
+  }
+  for (size_t i = 0; i < kNumLive; i++)
+    free(live[i]);
+  return 0;
+}
+
+TEST(AddressSanitizer, MallocFreeBenchmark) {
+  MallocFreeWorker(0);
+}
+
+TEST(AddressSanitizer, ThreadedMallocFreeBenchmark) {
+  const int kNumThreads = 4;
+  pthread_t t[kNumThreads];
+  for (int i = 0; i < kNumThreads; i++)
+    PTHREAD_CREATE(&t[i], 0, MallocFreeWorker, 0);
+  for (int i = 0; i < kNumThreads; i++)
+    PTHREAD_JOIN(t[i], 0);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
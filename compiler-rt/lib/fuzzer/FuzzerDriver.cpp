@@ -709,6 +709,15 @@ int FuzzerDriver(int *argc, char ***argv, UserCallback Callback) {
   if (Flags.collect_data_flow)
     Options.CollectDataFlow = Flags.collect_data_flow;
   Options.LazyCounters = Flags.lazy_counters;
+  if (Flags.snapshot_runs > 0) {
+    if (!LIBFUZZER_POSIX) {
+      Printf("INFO: -snapshot_runs is not supported on this platform\n");
+    } else {
+      Options.SnapshotRuns = Flags.snapshot_runs;
+      // The counters unprotected in a runner would stay disabled here.
+      Options.LazyCounters = false;
+    }
+  }
   if (Flags.stop_file)
     Options.StopFile = Flags.stop_file;
 
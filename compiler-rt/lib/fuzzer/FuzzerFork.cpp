@@ -86,6 +86,11 @@ struct FuzzJob {
 };
 
 struct GlobalEnv {
+  // Guards the state that the workers use to create their jobs: Files, Rand,
+  // FilesWithDFT and NextJobId. The rest is only used by the merging thread.
+  std::mutex Mu;
+  std::atomic<bool> Stopping{false};
+
   Vector<std::string> Args;
   Vector<std::string> CorpusDirs;
   std::string MainCorpusDir;
@@ -96,6 +101,7 @@ struct GlobalEnv {
   Set<std::string> FilesWithDFT;
   Vector<std::string> Files;
   Random *Rand;
+  size_t NextJobId = 1;
   std::chrono::system_clock::time_point ProcessStartTime;
   int Verbosity = 0;
 
@@ -114,7 +120,9 @@ struct GlobalEnv {
         .count();
   }
 
-  FuzzJob *CreateNewJob(size_t JobId) {
+  FuzzJob *CreateNewJob() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    size_t JobId = NextJobId++;
     Command Cmd(Args);
     Cmd.removeFlag("fork");
     Cmd.removeFlag("runs");
@@ -200,10 +208,15 @@ struct GlobalEnv {
         }
       }
     }
+    size_t NumFiles;
+    {
+      std::lock_guard<std::mutex> Lock(Mu);
+      NumFiles = Files.size();
+    }
     // if (!FilesToAdd.empty() || Job->ExitCode != 0)
     Printf("#%zd: cov: %zd ft: %zd corp: %zd exec/s %zd "
            "oom/timeout/crash: %zd/%zd/%zd time: %zds job: %zd dft_time: %d\n",
-           NumRuns, Cov.size(), Features.size(), Files.size(),
+           NumRuns, Cov.size(), Features.size(), NumFiles,
            Stats.average_exec_per_sec, NumOOMs, NumTimeouts, NumCrashes,
            secondsSinceProcessStartUp(), Job->JobId, Job->DftTimeInSeconds);
 
@@ -217,6 +230,7 @@ struct GlobalEnv {
       auto U = FileToVector(Path);
       auto NewPath = DirPlusFile(MainCorpusDir, Hash(U));
       WriteToFile(U, NewPath);
+      std::lock_guard<std::mutex> Lock(Mu);
       Files.push_back(NewPath);
     }
     Features.insert(NewFeatures.begin(), NewFeatures.end());
@@ -260,6 +274,10 @@ struct JobQueue {
     }
     Cv.notify_one();
   }
+  size_t Size() {
+    std::lock_guard<std::mutex> Lock(Mu);
+    return Qu.size();
+  }
   FuzzJob *Pop() {
     std::unique_lock<std::mutex> Lk(Mu);
     // std::lock_guard<std::mutex> Lock(Mu);
@@ -271,8 +289,13 @@ struct JobQueue {
   }
 };
 
-void WorkerThread(JobQueue *FuzzQ, JobQueue *MergeQ) {
-  while (auto Job = FuzzQ->Pop()) {
+// Every worker creates its next job as soon as the last one is done, rather
+// than waiting for the main thread to merge it: merging re-runs the new inputs
+// in a process of its own, and with many workers, they would otherwise spend
+// much of their time waiting for each other's merges.
+void WorkerThread(GlobalEnv *Env, JobQueue *MergeQ) {
+  while (!Env->Stopping) {
+    auto Job = Env->CreateNewJob();
     // Printf("WorkerThread: job %p\n", Job);
     Job->ExitCode = ExecuteCommand(Job->Cmd);
     MergeQ->Push(Job);
@@ -319,26 +342,20 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
 
   int ExitCode = 0;
 
-  JobQueue FuzzQ, MergeQ;
+  JobQueue MergeQ;
 
+  // Jobs that are still running see the stop file and wrap up.
   auto StopJobs = [&]() {
-    for (int i = 0; i < NumJobs; i++)
-      FuzzQ.Push(nullptr);
-    MergeQ.Push(nullptr);
+    Env.Stopping = true;
     WriteToFile(Unit({1}), Env.StopFile());
   };
 
-  size_t JobId = 1;
   Vector<std::thread> Threads;
-  for (int t = 0; t < NumJobs; t++) {
-    Threads.push_back(std::thread(WorkerThread, &FuzzQ, &MergeQ));
-    FuzzQ.Push(Env.CreateNewJob(JobId++));
-  }
+  for (int t = 0; t < NumJobs; t++)
+    Threads.push_back(std::thread(WorkerThread, &Env, &MergeQ));
 
   while (true) {
     std::unique_ptr<FuzzJob> Job(MergeQ.Pop());
-    if (!Job)
-      break;
     ExitCode = Job->ExitCode;
     if (ExitCode == Options.InterruptExitCode) {
       Printf("==%lu== libFuzzer: a child was interrupted; exiting\n", GetPid());
@@ -389,12 +406,13 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
       StopJobs();
       break;
     }
-
-    FuzzQ.Push(Env.CreateNewJob(JobId++));
   }
 
   for (auto &T : Threads)
     T.join();
+  // Delete the jobs that finished after we stopped merging.
+  while (MergeQ.Size())
+    delete MergeQ.Pop();
 
   // The workers have terminated. Don't try to remove the directory before they
   // terminate to avoid a race condition preventing cleanup on Windows.
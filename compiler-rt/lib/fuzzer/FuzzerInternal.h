@@ -107,6 +107,18 @@ private:
   void DumpCurrentUnit(const char *Prefix);
   void DeathCallback();
 
+  // -snapshot_runs, see FuzzerSnapshot.cpp.
+  void ExecuteCallbackInSnapshot(const uint8_t *Data, size_t Size);
+  void StartSnapshotRunner();
+  void StopSnapshotRunner();
+  void SnapshotRunnerDied();
+  void SnapshotRunnerLoop(int Fd);
+  bool InSnapshotRunner = false;
+  int SnapshotRunnerPid = 0;
+  int SnapshotRunnerFd = -1;
+  size_t SnapshotRunnerRuns = 0;
+  uint8_t *SnapshotCoverage = nullptr;
+
   void AllocateCurrentUnitData();
   uint8_t *CurrentUnitData = nullptr;
   std::atomic<size_t> CurrentUnitSize;
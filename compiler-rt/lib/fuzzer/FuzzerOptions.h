@@ -76,6 +76,7 @@ struct FuzzingOptions {
   bool HandleUsr1 = false;
   bool HandleUsr2 = false;
   bool LazyCounters = false;
+  int SnapshotRuns = 0;
 };
 
 }  // namespace fuzzer
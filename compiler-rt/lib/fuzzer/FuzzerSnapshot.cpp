@@ -0,0 +1,203 @@
+//===- FuzzerSnapshot.cpp - run the target in forked processes ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// With -snapshot_runs=N the fuzzing process never runs the target itself, so
+// that its memory keeps the state the target was left in by initialization.
+// The inputs are run by a runner process forked from it, which is replaced
+// by a fresh fork every N runs: a copy-on-write snapshot that only costs the
+// pages the target dirties, instead of repeating an expensive initialization
+// or letting state pile up between runs.
+//
+// The runner gets an input over a socket, runs it and saves the coverage
+// into memory shared with the fuzzing process, which restores it and goes on
+// as if the run had happened there. A runner that fails reports the failure
+// and writes the artifact itself, as the fuzzing process would have; the
+// fuzzing process then exits with the runner's exit code.
+//===----------------------------------------------------------------------===//
+
+#include "FuzzerDefs.h"
+#include "FuzzerInternal.h"
+#include "FuzzerTracePC.h"
+#include "FuzzerUtil.h"
+
+#if LIBFUZZER_POSIX
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // SO_NOSIGPIPE is set on the socket instead.
+#endif
+#endif
+
+namespace fuzzer {
+
+#if LIBFUZZER_POSIX
+
+static bool WriteAll(int Fd, const void *Buf, size_t Size) {
+  auto *P = reinterpret_cast<const uint8_t *>(Buf);
+  while (Size) {
+    ssize_t N = send(Fd, P, Size, MSG_NOSIGNAL);
+    if (N < 0 && errno == EINTR)
+      continue;
+    if (N <= 0)
+      return false;
+    P += N;
+    Size -= N;
+  }
+  return true;
+}
+
+static bool ReadAll(int Fd, void *Buf, size_t Size) {
+  auto *P = reinterpret_cast<uint8_t *>(Buf);
+  while (Size) {
+    ssize_t N = read(Fd, P, Size);
+    if (N < 0 && errno == EINTR)
+      continue;
+    if (N <= 0)
+      return false;
+    P += N;
+    Size -= N;
+  }
+  return true;
+}
+
+// Every input is sent as its size and the run number, followed by its data;
+// the runner answers with a byte once the coverage has been saved.
+struct SnapshotRequest {
+  uint64_t Size;
+  uint64_t RunNumber;
+};
+
+void Fuzzer::ExecuteCallbackInSnapshot(const uint8_t *Data, size_t Size) {
+  if (!SnapshotCoverage) {
+    void *Mem = mmap(nullptr, TPC.MaxSavedCoverageSize(),
+                     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (Mem == MAP_FAILED) {
+      Printf("ERROR: libFuzzer: snapshot_runs: mmap failed with %d\n", errno);
+      exit(1);
+    }
+    SnapshotCoverage = reinterpret_cast<uint8_t *>(Mem);
+  }
+  if (SnapshotRunnerPid && SnapshotRunnerRuns >= (size_t)Options.SnapshotRuns)
+    StopSnapshotRunner();
+  if (!SnapshotRunnerPid)
+    StartSnapshotRunner();
+  SnapshotRunnerRuns++;
+
+  if (CurrentUnitData && CurrentUnitData != Data)
+    memcpy(CurrentUnitData, Data, Size);
+  CurrentUnitSize = Size;
+  UnitStartTime = system_clock::now();
+  TPC.ResetMaps();
+  SnapshotRequest Request = {Size, TotalNumberOfRuns};
+  uint8_t Done;
+  if (!WriteAll(SnapshotRunnerFd, &Request, sizeof(Request)) ||
+      !WriteAll(SnapshotRunnerFd, Data, Size) ||
+      !ReadAll(SnapshotRunnerFd, &Done, sizeof(Done)))
+    SnapshotRunnerDied();
+  TPC.RestoreCoverage(SnapshotCoverage);
+  UnitStopTime = system_clock::now();
+  CurrentUnitSize = 0;
+}
+
+void Fuzzer::StartSnapshotRunner() {
+  int Fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, Fds)) {
+    Printf("ERROR: libFuzzer: snapshot_runs: socketpair failed with %d\n",
+           errno);
+    exit(1);
+  }
+  // Processes the target starts must not keep the runner's end open, or
+  // its death would go unnoticed.
+  fcntl(Fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(Fds[1], F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+  int One = 1;
+  setsockopt(Fds[0], SOL_SOCKET, SO_NOSIGPIPE, &One, sizeof(One));
+  setsockopt(Fds[1], SOL_SOCKET, SO_NOSIGPIPE, &One, sizeof(One));
+#endif
+  pid_t Pid = fork();
+  if (Pid < 0) {
+    Printf("ERROR: libFuzzer: snapshot_runs: fork failed with %d\n", errno);
+    exit(1);
+  }
+  if (Pid == 0) {
+    close(Fds[0]);
+    SnapshotRunnerLoop(Fds[1]);
+  }
+  close(Fds[1]);
+  SnapshotRunnerPid = Pid;
+  SnapshotRunnerFd = Fds[0];
+  SnapshotRunnerRuns = 0;
+}
+
+void Fuzzer::StopSnapshotRunner() {
+  close(SnapshotRunnerFd);
+  waitpid(SnapshotRunnerPid, nullptr, 0);
+  SnapshotRunnerPid = 0;
+  SnapshotRunnerFd = -1;
+}
+
+void Fuzzer::SnapshotRunnerDied() {
+  int Status = 0;
+  while (waitpid(SnapshotRunnerPid, &Status, 0) < 0 && errno == EINTR) {
+  }
+  // Crashes, timeouts, OOMs and leaks have been reported by the runner, and
+  // a target that calls _exit() would have ended this process just the same.
+  if (WIFEXITED(Status))
+    _Exit(WEXITSTATUS(Status));
+  Printf("==%lu== ERROR: libFuzzer: snapshot runner killed by signal %d\n",
+         GetPid(), WIFSIGNALED(Status) ? WTERMSIG(Status) : 0);
+  DumpCurrentUnit("crash-");
+  PrintFinalStats();
+  _Exit(Options.ErrorExitCode);
+}
+
+void Fuzzer::SnapshotRunnerLoop(int Fd) {
+  InSnapshotRunner = true;
+  // Timers and threads are not inherited, so the -timeout timer is armed
+  // again, and -rss_limit_mb is checked after every run instead.
+  if (Options.UnitTimeoutSec > 0)
+    SetTimer(Options.UnitTimeoutSec / 2 + 1);
+  Unit U;
+  while (true) {
+    SnapshotRequest Request;
+    if (!ReadAll(Fd, &Request, sizeof(Request)))
+      _Exit(0);
+    U.resize(Request.Size);
+    if (!ReadAll(Fd, U.data(), U.size()))
+      _Exit(0);
+    TotalNumberOfRuns = Request.RunNumber - 1;
+    ExecuteCallback(U.data(), U.size());
+    TPC.SaveCoverage(SnapshotCoverage, Options.UseCmp || Options.UseMemmem);
+    TryDetectingAMemoryLeak(U.data(), U.size(),
+                            /*DuringInitialCorpusExecution*/ false);
+    if (Options.RssLimitMb > 0 &&
+        GetPeakRSSMb() > static_cast<size_t>(Options.RssLimitMb)) {
+      CurrentUnitSize = U.size();
+      RssLimitCallback();
+    }
+    uint8_t Done = 0;
+    if (!WriteAll(Fd, &Done, sizeof(Done)))
+      _Exit(0);
+  }
+}
+
+#else // LIBFUZZER_POSIX
+
+void Fuzzer::ExecuteCallbackInSnapshot(const uint8_t *Data, size_t Size) {
+  assert(0 && "-snapshot_runs is not supported on this platform");
+}
+
+#endif // LIBFUZZER_POSIX
+
+} // namespace fuzzer
@@ -429,6 +429,97 @@ uintptr_t TracePC::GetMaxStackOffset() const {
   return InitialStack - __sancov_lowest_stack;  // Stack grows down
 }
 
+// Only the non-zero counters and the set bits of the value profile are saved,
+// with the counters indexed as if all the regions, and then the extra
+// counters, were one array.
+struct SavedCoverage {
+  struct Counter {
+    uint32_t Idx, Value;
+  };
+  uintptr_t MaxStackOffset;
+  size_t NumCounters;
+  size_t NumValueProfileBits;
+  bool HasCompares;
+};
+
+size_t TracePC::MaxSavedCoverageSize() {
+  size_t NumCounters = ExtraCountersEnd() - ExtraCountersBegin();
+  IterateCounterRegions([&](const Module::Region &R) {
+    NumCounters += R.Stop - R.Start;
+  });
+  return sizeof(SavedCoverage) + sizeof(TORC4) + sizeof(TORC8) +
+         sizeof(TORCW) + sizeof(MMT) +
+         NumCounters * sizeof(SavedCoverage::Counter) +
+         ValueProfileMap.SizeInBits() * sizeof(uint32_t);
+}
+
+ATTRIBUTE_NO_SANITIZE_ALL
+void TracePC::SaveCoverage(uint8_t *Buf, bool WithCompares) {
+  auto *H = reinterpret_cast<SavedCoverage *>(Buf);
+  uint8_t *P = Buf + sizeof(*H);
+  H->MaxStackOffset = GetMaxStackOffset();
+  H->HasCompares = WithCompares;
+  if (WithCompares) {
+    memcpy(P, &TORC4, sizeof(TORC4));
+    memcpy(P += sizeof(TORC4), &TORC8, sizeof(TORC8));
+    memcpy(P += sizeof(TORC8), &TORCW, sizeof(TORCW));
+    memcpy(P += sizeof(TORCW), &MMT, sizeof(MMT));
+    P += sizeof(MMT);
+  }
+  auto *Counters = reinterpret_cast<SavedCoverage::Counter *>(P);
+  size_t N = 0;
+  size_t Offset = 0;
+  auto SaveCounters = [&](const uint8_t *Begin, const uint8_t *End) {
+    ForEachNonZeroByte(Begin, End, Offset,
+                       [&](size_t FirstIdx, size_t Idx, uint8_t Value) {
+                         Counters[N++] = {static_cast<uint32_t>(FirstIdx + Idx),
+                                          Value};
+                       });
+    Offset += End - Begin;
+  };
+  IterateCounterRegions([&](const Module::Region &R) {
+    SaveCounters(R.Start, R.Stop);
+  });
+  SaveCounters(ExtraCountersBegin(), ExtraCountersEnd());
+  H->NumCounters = N;
+  auto *Bits = reinterpret_cast<uint32_t *>(Counters + N);
+  N = 0;
+  ValueProfileMap.ForEach(
+      [&](size_t Idx) { Bits[N++] = static_cast<uint32_t>(Idx); });
+  H->NumValueProfileBits = N;
+}
+
+// The maps must have been reset; only the saved, non-zero values are set.
+ATTRIBUTE_NO_SANITIZE_ALL
+void TracePC::RestoreCoverage(const uint8_t *Buf) {
+  auto *H = reinterpret_cast<const SavedCoverage *>(Buf);
+  const uint8_t *P = Buf + sizeof(*H);
+  __sancov_lowest_stack = InitialStack - H->MaxStackOffset;
+  if (H->HasCompares) {
+    memcpy(&TORC4, P, sizeof(TORC4));
+    memcpy(&TORC8, P += sizeof(TORC4), sizeof(TORC8));
+    memcpy(&TORCW, P += sizeof(TORC8), sizeof(TORCW));
+    memcpy(&MMT, P += sizeof(TORCW), sizeof(MMT));
+    P += sizeof(MMT);
+  }
+  auto *Counters = reinterpret_cast<const SavedCoverage::Counter *>(P);
+  size_t I = 0;
+  size_t Offset = 0;
+  auto RestoreCounters = [&](uint8_t *Begin, uint8_t *End) {
+    size_t Size = End - Begin;
+    for (; I < H->NumCounters && Counters[I].Idx < Offset + Size; I++)
+      Begin[Counters[I].Idx - Offset] = Counters[I].Value;
+    Offset += Size;
+  };
+  IterateCounterRegions([&](const Module::Region &R) {
+    RestoreCounters(R.Start, R.Stop);
+  });
+  RestoreCounters(ExtraCountersBegin(), ExtraCountersEnd());
+  auto *Bits = reinterpret_cast<const uint32_t *>(Counters + H->NumCounters);
+  for (size_t J = 0; J < H->NumValueProfileBits; J++)
+    ValueProfileMap.AddValue(Bits[J]);
+}
+
 void WarnAboutDeprecatedInstrumentation(const char *flag) {
   // Use RawPrint because Printf cannot be used on Windows before OutputFile is
   // initialized.
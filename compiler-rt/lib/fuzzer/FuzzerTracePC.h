@@ -110,6 +110,13 @@ class TracePC {
   void RecordInitialStack();
   uintptr_t GetMaxStackOffset() const;
 
+  // With -snapshot_runs the target runs in another process, which saves
+  // what the last run left in the maps and tables above for this process to
+  // restore, as if the run had happened here.
+  size_t MaxSavedCoverageSize();
+  void SaveCoverage(uint8_t *Buf, bool WithCompares);
+  void RestoreCoverage(const uint8_t *Buf);
+
   template<class CallBack>
   void ForEachObservedPC(CallBack CB) {
     for (auto PC : ObservedPCs)
@@ -50,6 +50,8 @@ unsigned NumberOfCpuCores();
 // Platform specific functions.
 void SetSignalHandler(const FuzzingOptions& Options);
 
+void SetTimer(int Seconds);
+
 void SleepSeconds(int Seconds);
 
 bool Mprotect(void *Ptr, size_t Size, bool AllowReadWrite);
@@ -0,0 +1,191 @@
+//===-- backtrace_frame_pointer.cpp -----------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// An async-signal-safe backtrace implementation for Linux. Apart from looking
+// up the bounds of a thread's stack the first time it unwinds, it neither
+// allocates nor takes locks. Stacks are unwound through their frame pointers,
+// and the printed frames are module+offset pairs that llvm-symbolizer can
+// resolve offline, as symbolizing in the crashing process isn't safe.
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <link.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/auxv.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "gwp_asan/definitions.h"
+#include "gwp_asan/optional/backtrace.h"
+#include "gwp_asan/options.h"
+
+namespace {
+// A frame record is the caller's frame pointer followed by the return address,
+// on x86 and AArch64 alike.
+#if defined(__i386__) || defined(__x86_64__) || defined(__aarch64__)
+constexpr bool kHasFrameRecords = true;
+#else
+constexpr bool kHasFrameRecords = false;
+#endif
+
+// Frames further apart than this are taken as the end of the chain.
+constexpr uintptr_t kMaxFrameSize = 1 << 20;
+
+// The bounds of the current thread's stack, as reported by
+// pthread_getattr_np(). It may allocate, which re-enters the allocator and may
+// unwind again; such a nested unwind, or one in a signal handler that
+// interrupted the lookup, sees LookingUp and caches nothing.
+struct StackBounds {
+  uintptr_t Begin;
+  uintptr_t End;
+  enum : uint8_t { Unknown, LookingUp, Known, Unavailable } State;
+};
+TLS_INITIAL_EXEC StackBounds Stack = {0, 0, StackBounds::Unknown};
+
+void initStackBounds() {
+  if (LIKELY(Stack.State != StackBounds::Unknown))
+    return;
+  Stack.State = StackBounds::LookingUp;
+  __atomic_signal_fence(__ATOMIC_SEQ_CST);
+  pthread_attr_t Attr;
+  void *Addr;
+  size_t Size;
+  if (pthread_getattr_np(pthread_self(), &Attr) == 0) {
+    if (pthread_attr_getstack(&Attr, &Addr, &Size) == 0) {
+      Stack.Begin = reinterpret_cast<uintptr_t>(Addr);
+      Stack.End = Stack.Begin + Size;
+    }
+    pthread_attr_destroy(&Attr);
+  }
+  __atomic_signal_fence(__ATOMIC_SEQ_CST);
+  Stack.State = Stack.Begin != Stack.End ? StackBounds::Known
+                                         : StackBounds::Unavailable;
+}
+
+// The range of the current thread's stack known to be readable. A frame
+// pointer in a function built without them holds whatever the function put
+// there, so every frame record outside of this range is checked with a
+// syscall before it is read, which fails rather than faults on an unmapped
+// address. The range only grows a page at a time, and then stays valid, as
+// stacks don't move. Pages outside of the thread's stack, e.g. on the heap or
+// on another thread's stack, may be unmapped later, so they are probed again
+// on every unwind.
+struct ReadableRange {
+  uintptr_t Begin;
+  uintptr_t End;
+};
+TLS_INITIAL_EXEC ReadableRange Readable = {0, 0};
+
+bool isReadable(uintptr_t Begin, uintptr_t End) {
+  if (LIKELY(Readable.Begin <= Begin && End <= Readable.End))
+    return true;
+  const uintptr_t PageSize = static_cast<uintptr_t>(getpagesize());
+  const uintptr_t PageBegin = Begin & ~(PageSize - 1);
+  const uintptr_t PageEnd = (End + PageSize - 1) & ~(PageSize - 1);
+  for (uintptr_t Page = PageBegin; Page < PageEnd; Page += PageSize) {
+    if (Readable.Begin <= Page && Page < Readable.End)
+      continue;
+    char Byte;
+    iovec Local = {&Byte, 1};
+    iovec Remote = {reinterpret_cast<void *>(Page), 1};
+    if (syscall(SYS_process_vm_readv, getpid(), &Local, 1, &Remote, 1, 0) != 1)
+      return false;
+  }
+  if (Stack.State != StackBounds::Known || PageBegin < Stack.Begin ||
+      PageEnd > Stack.End)
+    return true;
+  // A signal handler running on this thread may unwind in between, so make
+  // the range empty while it is being changed.
+  const bool Extends =
+      PageBegin <= Readable.End && Readable.Begin <= PageEnd &&
+      Readable.Begin != Readable.End;
+  const uintptr_t NewBegin =
+      Extends && Readable.Begin < PageBegin ? Readable.Begin : PageBegin;
+  const uintptr_t NewEnd =
+      Extends && Readable.End > PageEnd ? Readable.End : PageEnd;
+  Readable.End = 0;
+  __atomic_signal_fence(__ATOMIC_SEQ_CST);
+  Readable.Begin = NewBegin;
+  __atomic_signal_fence(__ATOMIC_SEQ_CST);
+  Readable.End = NewEnd;
+  return true;
+}
+
+// Unwinding stops at the first frame that doesn't look like one: it must be
+// above the previous one, not too far from it, aligned, and readable.
+size_t Backtrace(uintptr_t *TraceBuffer, size_t Size) {
+  if (!kHasFrameRecords)
+    return 0;
+  // Keep errno intact for the allocator's callers.
+  const int SavedErrno = errno;
+  initStackBounds();
+  size_t N = 0;
+  uintptr_t Frame = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+  while (N < Size) {
+    if (Frame % sizeof(uintptr_t) != 0 ||
+        !isReadable(Frame, Frame + 2 * sizeof(uintptr_t)))
+      break;
+    const uintptr_t *Record = reinterpret_cast<const uintptr_t *>(Frame);
+    const uintptr_t ReturnAddress = Record[1];
+    if (ReturnAddress == 0)
+      break;
+    TraceBuffer[N++] = ReturnAddress;
+    const uintptr_t Next = Record[0];
+    if (Next <= Frame || Next - Frame > kMaxFrameSize)
+      break;
+    Frame = Next;
+  }
+  errno = SavedErrno;
+  return N;
+}
+
+// Prints a module+offset pair per frame. Finding the module takes
+// _dl_find_object(), which is async-signal-safe, in glibc 2.35 and later;
+// without it, the raw addresses are printed.
+void PrintBacktrace(uintptr_t *Trace, size_t TraceLength,
+                    gwp_asan::options::Printf_t Printf) {
+  if (TraceLength == 0) {
+    Printf("  <not found (does your allocator support backtracing?)>\n\n");
+    return;
+  }
+
+  for (size_t I = 0; I < TraceLength; ++I) {
+#if defined(DLFO_STRUCT_HAS_EH_DBASE)
+    dl_find_object Object;
+    if (_dl_find_object(reinterpret_cast<void *>(Trace[I]), &Object) == 0 &&
+        Object.dlfo_link_map) {
+      const link_map *Map = Object.dlfo_link_map;
+      // The main program goes by an empty name.
+      const char *Name = Map->l_name && Map->l_name[0]
+                             ? Map->l_name
+                             : reinterpret_cast<const char *>(
+                                   getauxval(AT_EXECFN));
+      Printf("  #%zu 0x%zx (%s+0x%zx)\n", I, Trace[I],
+             Name ? Name : "<unknown module>", Trace[I] - Map->l_addr);
+      continue;
+    }
+#endif
+    Printf("  #%zu 0x%zx\n", I, Trace[I]);
+  }
+  Printf("\n");
+}
+} // anonymous namespace
+
+namespace gwp_asan {
+namespace options {
+Backtrace_t getBacktraceFunction() { return Backtrace; }
+PrintBacktrace_t getPrintBacktraceFunction() { return PrintBacktrace; }
+} // namespace options
+} // namespace gwp_asan
@@ -24,13 +24,17 @@ uptr TagMemoryAligned(uptr p, uptr size, tag_t tag) {
   CHECK(IsAligned(size, kShadowAlignment));
   uptr shadow_start = MemToShadow(p);
   uptr shadow_size = MemToShadowSize(size);
+  uptr threshold = common_flags()->clear_shadow_mmap_threshold;
+  // Most heap chunks are far smaller than the threshold.
+  if (LIKELY(shadow_size < threshold || tag != 0)) {
+    internal_memset((void *)shadow_start, tag, shadow_size);
+    return AddTagToPointer(p, tag);
+  }
 
   uptr page_size = GetPageSizeCached();
   uptr page_start = RoundUpTo(shadow_start, page_size);
   uptr page_end = RoundDownTo(shadow_start + shadow_size, page_size);
-  uptr threshold = common_flags()->clear_shadow_mmap_threshold;
-  if (SANITIZER_LINUX &&
-      UNLIKELY(page_end >= page_start + threshold && tag == 0)) {
+  if (SANITIZER_LINUX && page_end >= page_start + threshold) {
     internal_memset((void *)shadow_start, tag, page_start - shadow_start);
     internal_memset((void *)page_end, tag,
                     shadow_start + shadow_size - page_end);
@@ -291,6 +291,10 @@ u32 ChainOrigin(u32 id, StackTrace *stack) {
   if (t && t->InSignalHandler())
     return id;
 
+  // With heap_origins_only, values from the stack have no origin to chain.
+  if (id == 0 && flags()->heap_origins_only)
+    return id;
+
   Origin o = Origin::FromRawId(id);
   stack->tag = StackTrace::TAG_UNKNOWN;
   Origin chained = Origin::CreateChainedOrigin(o, stack);
@@ -558,6 +562,12 @@ void __msan_set_alloca_origin(void *a, uptr size, char *descr) {
 }
 
 void __msan_set_alloca_origin4(void *a, uptr size, char *descr, uptr pc) {
+  if (flags()->heap_origins_only) {
+    // Still clear the origin, or a stale one from an earlier frame would be
+    // reported.
+    __msan_set_origin(a, size, 0);
+    return;
+  }
   static const u32 dash = '-';
   static const u32 first_timer =
       dash + (dash << 8) + (dash << 16) + (dash << 24);
@@ -119,6 +119,9 @@ class Origin {
       }
     }
 
+    if (flags()->origin_history_limit_mb > 0 && HistoryLimitReached())
+      return prev;
+
     StackDepotHandle h = StackDepotPut_WithHandle(*stack);
     if (!h.valid()) return prev;
 
@@ -154,6 +157,15 @@ class Origin {
 
   explicit Origin(u32 raw_id) : raw_id_(raw_id) {}
 
+  // The depots never shrink, as their ids live on in the origin shadow, so
+  // the limit stops them from growing instead. The stats are only a hint,
+  // read without the depot locks.
+  static bool HistoryLimitReached() {
+    uptr allocated = StackDepotGetStats()->allocated +
+                     ChainedOriginDepotGetStats()->allocated;
+    return allocated >> 20 >= (uptr)flags()->origin_history_limit_mb;
+  }
+
   int depth() const {
     CHECK(isChainedOrigin());
     return (raw_id_ >> kDepthShift) & ((1 << kDepthBits) - 1);
@@ -20,6 +20,19 @@
 
 COMPILER_RT_WEAK uint64_t INSTR_PROF_RAW_VERSION_VAR = INSTR_PROF_RAW_VERSION;
 
+/* Sampled counter updates (-instrprof-sampled-counter-update) count down in
+ * each thread and add the period to a counter when the countdown reaches
+ * zero. */
+#define INSTR_PROF_DEFAULT_SAMPLING_PERIOD 127
+COMPILER_RT_VISIBILITY COMPILER_RT_THREAD_LOCAL uint32_t
+    INSTR_PROF_SAMPLING_COUNTDOWN_VAR;
+COMPILER_RT_VISIBILITY uint32_t INSTR_PROF_SAMPLING_PERIOD_VAR =
+    INSTR_PROF_DEFAULT_SAMPLING_PERIOD;
+
+COMPILER_RT_VISIBILITY void __llvm_profile_set_sampling_period(uint32_t Period) {
+  INSTR_PROF_SAMPLING_PERIOD_VAR = Period ? Period : 1;
+}
+
 COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_magic(void) {
   return sizeof(void *) == sizeof(uint64_t) ? (INSTR_PROF_RAW_MAGIC_64)
                                             : (INSTR_PROF_RAW_MAGIC_32);
@@ -55,6 +68,8 @@ COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
   uint64_t *I = __llvm_profile_begin_counters();
   uint64_t *E = __llvm_profile_end_counters();
 
+  /* This also clears the counters of the threads. */
+  __llvm_profile_merge_thread_counters();
   memset(I, 0, sizeof(uint64_t) * (E - I));
 
   const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
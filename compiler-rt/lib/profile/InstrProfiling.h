@@ -111,6 +111,15 @@ void __llvm_profile_instrument_target_value(uint64_t TargetValue, void *Data,
                                             uint32_t CounterIndex,
                                             uint64_t CounterValue);
 
+/*!
+ * \brief Allocate the counters of the current thread.
+ *
+ * Called by code built with thread-local counters the first time it runs in
+ * a thread. Returns the offset from the profile counters to the counters of
+ * the thread, or 0 if the thread updates the profile counters.
+ */
+intptr_t INSTR_PROF_THREAD_COUNTERS_INIT_FUNC(void);
+
 /*!
  * \brief Write instrumentation data to the current file.
  *
@@ -145,6 +154,42 @@ int __llvm_orderfile_write_file(void);
  */
 int __llvm_profile_dump(void);
 
+/*!
+ * \brief Set the period of sampled counter updates.
+ *
+ * Code built with \c -mllvm \c -instrprof-sampled-counter-update only updates
+ * a profile counter every \c Period times it is reached, counted down in each
+ * thread, and then adds \c Period to it. This trades precision for a lot less
+ * contention on the counters. The default period is 127, and it can also be
+ * set by the environment variable LLVM_PROFILE_SAMPLING_PERIOD.
+ */
+void __llvm_profile_set_sampling_period(uint32_t Period);
+
+/*!
+ * \brief Add the counters of each thread to the profile counters.
+ *
+ * Code built with \c -mllvm \c -instrprof-thread-local-counters updates
+ * counters private to each thread, so that threads never share the cache
+ * lines of the counters. They are added to the profile counters, and
+ * cleared, when a thread exits and before the profile is written. Call this
+ * to see the counts earlier, e.g. in the profile file in continuous mode.
+ */
+void __llvm_profile_merge_thread_counters(void);
+
+/*!
+ * \brief Write the current profile data to \c Filename atomically.
+ *
+ * The profile is written to a temporary file next to \c Filename, which is
+ * then renamed over it, so that readers of \c Filename only ever see a
+ * complete profile. The profile file name and the dumped state are not
+ * changed, so this may be called periodically while the program keeps
+ * running, e.g. to take snapshots of a profile kept in sync by continuous
+ * mode (%c).
+ *
+ * Returns 0 on success.
+ */
+int __llvm_profile_write_snapshot(const char *Filename);
+
 int __llvm_orderfile_dump(void);
 
 /*!
@@ -116,11 +116,22 @@ static uint32_t fileWriter(ProfDataWriter *This, ProfDataIOVec *IOVecs,
                            uint32_t NumIOVecs) {
   uint32_t I;
   FILE *File = (FILE *)This->WriterCtx;
+  char Zeroes[sizeof(uint64_t)] = {0};
   for (I = 0; I < NumIOVecs; I++) {
     if (IOVecs[I].Data) {
       if (fwrite(IOVecs[I].Data, IOVecs[I].ElmSize, IOVecs[I].NumElm, File) !=
           IOVecs[I].NumElm)
         return 1;
+    } else if (IOVecs[I].UseZeroPadding) {
+      size_t BytesToWrite = IOVecs[I].ElmSize * IOVecs[I].NumElm;
+      while (BytesToWrite > 0) {
+        size_t PartialWriteLen =
+            (sizeof(Zeroes) > BytesToWrite) ? BytesToWrite : sizeof(Zeroes);
+        if (fwrite(Zeroes, sizeof(uint8_t), PartialWriteLen, File) !=
+            PartialWriteLen)
+          return 1;
+        BytesToWrite -= PartialWriteLen;
+      }
     } else {
       if (fseek(File, IOVecs[I].ElmSize * IOVecs[I].NumElm, SEEK_CUR) == -1)
         return 1;
@@ -165,21 +176,16 @@ static void setupIOBuffer() {
   }
 }
 
-/* Read profile data in \c ProfileFile and merge with in-memory
-   profile counters. Returns -1 if there is fatal error, otheriwse
-   0 is returned. Returning 0 does not mean merge is actually
-   performed. If merge is actually done, *MergeDone is set to 1.
-*/
-static int doProfileMerging(FILE *ProfileFile, int *MergeDone) {
-  uint64_t ProfileFileSize;
-  char *ProfileBuffer;
-
+/* Get the size of the profile file \c ProfileFile, and rewind it. Returns -1
+ * if there is a fatal error, otherwise 0. */
+static int getProfileFileSizeForMerging(FILE *ProfileFile,
+                                        uint64_t *ProfileFileSize) {
   if (fseek(ProfileFile, 0L, SEEK_END) == -1) {
     PROF_ERR("Unable to merge profile data, unable to get size: %s\n",
              strerror(errno));
     return -1;
   }
-  ProfileFileSize = ftell(ProfileFile);
+  *ProfileFileSize = ftell(ProfileFile);
 
   /* Restore file offset.  */
   if (fseek(ProfileFile, 0L, SEEK_SET) == -1) {
@@ -188,28 +194,58 @@ static int doProfileMerging(FILE *ProfileFile, int *MergeDone) {
     return -1;
   }
 
-  /* Nothing to merge.  */
-  if (ProfileFileSize < sizeof(__llvm_profile_header)) {
-    if (ProfileFileSize)
-      PROF_WARN("Unable to merge profile data: %s\n",
-                "source profile file is too small.");
-    return 0;
+  if (*ProfileFileSize > 0 &&
+      *ProfileFileSize < sizeof(__llvm_profile_header)) {
+    PROF_WARN("Unable to merge profile data: %s\n",
+              "source profile file is too small.");
+    *ProfileFileSize = 0;
   }
+  return 0;
+}
 
-  ProfileBuffer = mmap(NULL, ProfileFileSize, PROT_READ, MAP_SHARED | MAP_FILE,
-                       fileno(ProfileFile), 0);
-  if (ProfileBuffer == MAP_FAILED) {
+/* mmap() the non-empty profile file \c ProfileFile for reading and check
+ * that it is compatible with the current process. Returns -1 if there is a
+ * fatal error, 1 if the profile is not compatible, and otherwise 0 with the
+ * mapping in \c *ProfileBuffer. */
+static int mmapProfileForMerging(FILE *ProfileFile, uint64_t ProfileFileSize,
+                                 char **ProfileBuffer) {
+  *ProfileBuffer = mmap(NULL, ProfileFileSize, PROT_READ, MAP_SHARED | MAP_FILE,
+                        fileno(ProfileFile), 0);
+  if (*ProfileBuffer == MAP_FAILED) {
     PROF_ERR("Unable to merge profile data, mmap failed: %s\n",
              strerror(errno));
     return -1;
   }
 
-  if (__llvm_profile_check_compatibility(ProfileBuffer, ProfileFileSize)) {
-    (void)munmap(ProfileBuffer, ProfileFileSize);
+  if (__llvm_profile_check_compatibility(*ProfileBuffer, ProfileFileSize)) {
+    (void)munmap(*ProfileBuffer, ProfileFileSize);
     PROF_WARN("Unable to merge profile data: %s\n",
               "source profile file is not compatible.");
-    return 0;
+    return 1;
   }
+  return 0;
+}
+
+/* Read profile data in \c ProfileFile and merge with in-memory
+   profile counters. Returns -1 if there is fatal error, otheriwse
+   0 is returned. Returning 0 does not mean merge is actually
+   performed. If merge is actually done, *MergeDone is set to 1.
+*/
+static int doProfileMerging(FILE *ProfileFile, int *MergeDone) {
+  uint64_t ProfileFileSize;
+  char *ProfileBuffer;
+  int rc;
+
+  if (getProfileFileSizeForMerging(ProfileFile, &ProfileFileSize) == -1)
+    return -1;
+
+  /* Nothing to merge.  */
+  if (!ProfileFileSize)
+    return 0;
+
+  rc = mmapProfileForMerging(ProfileFile, ProfileFileSize, &ProfileBuffer);
+  if (rc)
+    return rc == 1 ? 0 : -1;
 
   /* Now start merging */
   __llvm_profile_merge_from_buffer(ProfileBuffer, ProfileFileSize);
@@ -277,6 +313,16 @@ static FILE *getFileObject(const char *OutputName) {
   return fopen(OutputName, "ab");
 }
 
+/* Write profile data to the file object \c File at its current offset. If
+ * \c SkipNameDataWrite is set, the names are already in the file. */
+static int writeProfileWithFileObject(FILE *File, int SkipNameDataWrite) {
+  ProfDataWriter fileWriter;
+  FreeHook = &free;
+  setupIOBuffer();
+  initFileWriter(&fileWriter, File);
+  return lprofWriteData(&fileWriter, lprofGetVPDataReader(), SkipNameDataWrite);
+}
+
 /* Write profile data to file \c OutputName.  */
 static int writeFile(const char *OutputName) {
   int RetVal;
@@ -292,11 +338,7 @@ static int writeFile(const char *OutputName) {
   if (!OutputFile)
     return -1;
 
-  FreeHook = &free;
-  setupIOBuffer();
-  ProfDataWriter fileWriter;
-  initFileWriter(&fileWriter, OutputFile);
-  RetVal = lprofWriteData(&fileWriter, lprofGetVPDataReader(), MergeDone);
+  RetVal = writeProfileWithFileObject(OutputFile, MergeDone);
 
   if (OutputFile == getProfileFile()) {
     fflush(OutputFile);
@@ -331,6 +373,9 @@ static int writeOrderFile(const char *OutputName) {
   return RetVal;
 }
 
+/* Set once the profile file was truncated in continuous mode. */
+#define LPROF_INIT_ONCE_ENV "__LLVM_PROFILE_RT_INIT_ONCE"
+
 static void truncateCurrentFile(void) {
   const char *Filename;
   char *FilenameBuf;
@@ -348,6 +393,20 @@ static void truncateCurrentFile(void) {
   if (lprofCurFilename.MergePoolSize)
     return;
 
+  /* In continuous mode every instrumented module appends its profile to the
+   * file while it is initialized, and keeps it mapped. Only truncate the file
+   * once, so that the profiles of modules initialized earlier (including
+   * those of the parent process) stay in place. */
+  if (__llvm_profile_is_continuous_mode_enabled()) {
+    if (getenv(LPROF_INIT_ONCE_ENV))
+      return;
+#if defined(_WIN32)
+    _putenv(LPROF_INIT_ONCE_ENV "=" LPROF_INIT_ONCE_ENV);
+#else
+    setenv(LPROF_INIT_ONCE_ENV, LPROF_INIT_ONCE_ENV, 1);
+#endif
+  }
+
   createProfileDir(Filename);
 
   /* Truncate the file.  Later we'll reopen and append. */
@@ -383,6 +442,7 @@ static int parseFilenamePattern(const char *FilenamePat,
   char *PidChars = &lprofCurFilename.PidChars[0];
   char *Hostname = &lprofCurFilename.Hostname[0];
   int MergingEnabled = 0;
+  int ContinuousModeRequested = 0;
 
   /* Clean up cached prefix and filename.  */
   if (lprofCurFilename.ProfilePathPrefix)
@@ -422,6 +482,10 @@ static int parseFilenamePattern(const char *FilenamePat,
                       FilenamePat);
             return -1;
           }
+      } else if (FilenamePat[I] == 'c') {
+        /* Keep the counters in sync with the file, see
+         * initializeProfileForContinuousMode(). */
+        ContinuousModeRequested = 1;
       } else if (containsMergeSpecifier(FilenamePat, I)) {
         if (MergingEnabled) {
           PROF_WARN("%%m specifier can only be specified once in %s.\n",
@@ -440,6 +504,8 @@ static int parseFilenamePattern(const char *FilenamePat,
 
   lprofCurFilename.NumPids = NumPids;
   lprofCurFilename.NumHosts = NumHosts;
+  if (ContinuousModeRequested)
+    __llvm_profile_enable_continuous_mode();
   return 0;
 }
 
@@ -490,7 +556,8 @@ static int getCurFilenameLength() {
     return 0;
 
   if (!(lprofCurFilename.NumPids || lprofCurFilename.NumHosts ||
-        lprofCurFilename.MergePoolSize))
+        lprofCurFilename.MergePoolSize ||
+        __llvm_profile_is_continuous_mode_enabled()))
     return strlen(lprofCurFilename.FilenamePat);
 
   Len = strlen(lprofCurFilename.FilenamePat) +
@@ -514,7 +581,8 @@ static const char *getCurFilename(char *FilenameBuf, int ForceUseBuf) {
     return 0;
 
   if (!(lprofCurFilename.NumPids || lprofCurFilename.NumHosts ||
-        lprofCurFilename.MergePoolSize)) {
+        lprofCurFilename.MergePoolSize ||
+        __llvm_profile_is_continuous_mode_enabled())) {
     if (!ForceUseBuf)
       return lprofCurFilename.FilenamePat;
 
@@ -619,6 +687,152 @@ const char *__llvm_profile_get_filename(void) {
   return FilenameBuf;
 }
 
+/* In continuous mode, write the profile of this module to the profile file
+ * and mmap the counters onto it, so that every counter update reaches the
+ * file without an explicit dump. If that is not possible, continuous mode is
+ * disabled and the profile is written at exit as usual. */
+static void initializeProfileForContinuousMode(void) {
+  if (!__llvm_profile_is_continuous_mode_enabled())
+    return;
+
+#if defined(_WIN32)
+  PROF_WARN("%s\n", "Continuous mode is not supported on Windows.");
+  __llvm_profile_disable_continuous_mode();
+#else
+  const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
+  const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  uint64_t *CountersEnd = __llvm_profile_end_counters();
+  const uint64_t DataSize = __llvm_profile_get_data_size(DataBegin, DataEnd);
+  const uint64_t CountersSize = CountersEnd - CountersBegin;
+  const unsigned PageSize = lprofGetPageSize();
+  uint64_t PaddingBytesBeforeCounters, PaddingBytesAfterCounters,
+      PaddingBytesAfterNames, FileOffsetToCounters, ProfileFileSize;
+  uint64_t CurrentFileOffset = 0;
+  const char *Filename;
+  char *FilenameBuf;
+  char *ProfileBuffer;
+  FILE *File;
+  void *CounterMmap;
+  int Length;
+
+  /* Nothing is written for a module without counters. */
+  if (!DataSize || !CountersSize) {
+    __llvm_profile_disable_continuous_mode();
+    return;
+  }
+
+  /* The mapping replaces whole pages, so it must not cover anything but the
+   * counters. */
+  if ((uintptr_t)CountersBegin % PageSize ||
+      (uintptr_t)CountersEnd % PageSize) {
+    PROF_WARN("Continuous mode disabled, the counter section is not "
+              "page-aligned (begin = %p, end = %p, pagesz = %u).\n",
+              (void *)CountersBegin, (void *)CountersEnd, PageSize);
+    __llvm_profile_disable_continuous_mode();
+    return;
+  }
+
+  Length = getCurFilenameLength();
+  FilenameBuf = (char *)COMPILER_RT_ALLOCA(Length + 1);
+  Filename = getCurFilename(FilenameBuf, 0);
+  if (!Filename) {
+    __llvm_profile_disable_continuous_mode();
+    return;
+  }
+
+  __llvm_profile_get_padding_sizes_for_counters(
+      DataSize, CountersSize, __llvm_profile_end_names() -
+                                  __llvm_profile_begin_names(),
+      &PaddingBytesBeforeCounters, &PaddingBytesAfterCounters,
+      &PaddingBytesAfterNames);
+
+  /* Open the file while holding the file lock, so that processes started
+   * from the same binary do not interleave their writes. */
+  createProfileDir(Filename);
+  File = lprofOpenFileEx(Filename);
+  if (!File) {
+    PROF_ERR("Continuous mode disabled, unable to open %s: %s\n", Filename,
+             strerror(errno));
+    __llvm_profile_disable_continuous_mode();
+    return;
+  }
+
+  if (doMerging()) {
+    if (getProfileFileSizeForMerging(File, &ProfileFileSize) == -1)
+      goto Fail;
+  } else {
+    if (fseek(File, 0L, SEEK_END) == -1)
+      goto Fail;
+    ProfileFileSize = ftell(File);
+  }
+
+  if (doMerging() && ProfileFileSize) {
+    /* The processes merging into this file share its counters: map the
+     * counters of the existing profile, which must have the same layout. */
+    const __llvm_profile_header *Header;
+    int rc = mmapProfileForMerging(File, ProfileFileSize, &ProfileBuffer);
+    if (rc)
+      goto Fail;
+    Header = (const __llvm_profile_header *)ProfileBuffer;
+    rc = Header->PaddingBytesBeforeCounters != PaddingBytesBeforeCounters ||
+         Header->PaddingBytesAfterCounters != PaddingBytesAfterCounters;
+    (void)munmap(ProfileBuffer, ProfileFileSize);
+    if (rc) {
+      PROF_WARN("Continuous mode disabled, %s was not written in continuous "
+                "mode.\n",
+                Filename);
+      goto Fail;
+    }
+  } else {
+    /* Append the profile of this module at the next page boundary of the
+     * file, which is empty when merging. The reader skips the zeroes between
+     * profiles. */
+    ProfDataWriter FileWriter;
+    ProfDataIOVec Padding = {NULL, sizeof(uint8_t), 0, 1};
+    if (ProfileFileSize % PageSize)
+      Padding.NumElm = PageSize - ProfileFileSize % PageSize;
+    CurrentFileOffset = ProfileFileSize + Padding.NumElm;
+    initFileWriter(&FileWriter, File);
+    if (COMPILER_RT_FTRUNCATE(File, ProfileFileSize) ||
+        fseek(File, ProfileFileSize, SEEK_SET) == -1 ||
+        FileWriter.Write(&FileWriter, &Padding, 1) ||
+        writeProfileWithFileObject(File, 0) || fflush(File)) {
+      PROF_ERR("Continuous mode disabled, unable to write %s: %s\n", Filename,
+               strerror(errno));
+      (void)COMPILER_RT_FTRUNCATE(File, ProfileFileSize);
+      goto Fail;
+    }
+  }
+
+  FileOffsetToCounters = CurrentFileOffset + sizeof(__llvm_profile_header) +
+                         DataSize * sizeof(__llvm_profile_data) +
+                         PaddingBytesBeforeCounters;
+  CounterMmap = mmap((void *)CountersBegin,
+                     CountersSize * sizeof(uint64_t) + PaddingBytesAfterCounters,
+                     PROT_READ | PROT_WRITE, MAP_FIXED | MAP_SHARED,
+                     fileno(File), FileOffsetToCounters);
+  if (CounterMmap != CountersBegin) {
+    PROF_ERR("Continuous mode disabled, unable to mmap the counters of %s "
+             "(offset = %" PRIu64 "): %s\n",
+             Filename, FileOffsetToCounters, strerror(errno));
+    if (!doMerging() || !ProfileFileSize)
+      (void)COMPILER_RT_FTRUNCATE(File, ProfileFileSize);
+    goto Fail;
+  }
+
+  /* The mapping stays valid after the file is closed. */
+  lprofUnlockFileHandle(File);
+  fclose(File);
+  return;
+
+Fail:
+  __llvm_profile_disable_continuous_mode();
+  lprofUnlockFileHandle(File);
+  fclose(File);
+#endif
+}
+
 /* This method is invoked by the runtime initialization hook
  * InstrProfilingRuntime.o if it is linked in. Both user specified
  * profile path via -fprofile-instr-generate= and LLVM_PROFILE_FILE
@@ -627,15 +841,18 @@ COMPILER_RT_VISIBILITY
 void __llvm_profile_initialize_file(void) {
   const char *EnvFilenamePat;
   const char *SelectedPat = NULL;
+  const char *SamplingPeriod;
   ProfileNameSpecifier PNS = PNS_unknown;
   int hasCommandLineOverrider = (INSTR_PROF_PROFILE_NAME_VAR[0] != 0);
 
+  SamplingPeriod = getenv("LLVM_PROFILE_SAMPLING_PERIOD");
+  if (SamplingPeriod && SamplingPeriod[0])
+    __llvm_profile_set_sampling_period(atoi(SamplingPeriod));
+
   EnvFilenamePat = getFilenamePatFromEnv();
   if (EnvFilenamePat) {
-    /* Pass CopyFilenamePat = 1, to ensure that the filename would be valid
-       at the  moment when __llvm_profile_write_file() gets executed. */
-    parseAndSetFilename(EnvFilenamePat, PNS_environment, 1);
-    return;
+    SelectedPat = EnvFilenamePat;
+    PNS = PNS_environment;
   } else if (hasCommandLineOverrider) {
     SelectedPat = INSTR_PROF_PROFILE_NAME_VAR;
     PNS = PNS_command_line;
@@ -644,7 +861,11 @@ void __llvm_profile_initialize_file(void) {
     PNS = PNS_default;
   }
 
-  parseAndSetFilename(SelectedPat, PNS, 0);
+  /* Pass CopyFilenamePat = 1 for the environment variable, to ensure that the
+     filename would be valid at the moment when __llvm_profile_write_file()
+     gets executed. */
+  parseAndSetFilename(SelectedPat, PNS, PNS == PNS_environment);
+  initializeProfileForContinuousMode();
 }
 
 /* This API is directly called by the user application code. It has the
@@ -653,7 +874,15 @@ void __llvm_profile_initialize_file(void) {
  */
 COMPILER_RT_VISIBILITY
 void __llvm_profile_set_filename(const char *FilenamePat) {
+  /* The counters of this module are already mapped onto the profile file. */
+  if (__llvm_profile_is_continuous_mode_enabled()) {
+    PROF_WARN("Profile file name not changed to %s: continuous mode is "
+              "enabled.\n",
+              FilenamePat ? FilenamePat : "the default");
+    return;
+  }
   parseAndSetFilename(FilenamePat, PNS_runtime_api, 1);
+  initializeProfileForContinuousMode();
 }
 
 /* The public API for writing profile data into the file with name
@@ -672,6 +901,12 @@ int __llvm_profile_write_file(void) {
     return 0;
   }
 
+  /* The counters are always up to date in the file. */
+  if (__llvm_profile_is_continuous_mode_enabled()) {
+    __llvm_profile_merge_thread_counters();
+    return 0;
+  }
+
   Length = getCurFilenameLength();
   FilenameBuf = (char *)COMPILER_RT_ALLOCA(Length + 1);
   Filename = getCurFilename(FilenameBuf, 0);
@@ -708,7 +943,7 @@ int __llvm_profile_write_file(void) {
 
 COMPILER_RT_VISIBILITY
 int __llvm_profile_dump(void) {
-  if (!doMerging())
+  if (!doMerging() && !__llvm_profile_is_continuous_mode_enabled())
     PROF_WARN("Later invocation of __llvm_profile_dump can lead to clobbering "
               " of previously dumped profile data : %s. Either use %%m "
               "in profile name or change profile name before dumping.\n",
@@ -718,6 +953,49 @@ int __llvm_profile_dump(void) {
   return rc;
 }
 
+COMPILER_RT_VISIBILITY
+int __llvm_profile_write_snapshot(const char *Filename) {
+  /* Room for ".tmp" followed by the pid. */
+  const int SuffixLength = 4 + MAX_PID_SIZE;
+  int Length, rc;
+  char *TmpFilename;
+  FILE *File;
+
+  if (!Filename || !Filename[0]) {
+    PROF_ERR("Failed to write snapshot : %s\n", "Filename not set");
+    return -1;
+  }
+
+  Length = strlen(Filename) + SuffixLength;
+  TmpFilename = (char *)COMPILER_RT_ALLOCA(Length + 1);
+  snprintf(TmpFilename, Length + 1, "%s.tmp%ld", Filename, (long)getpid());
+
+  createProfileDir(Filename);
+  File = fopen(TmpFilename, "wb");
+  if (!File) {
+    PROF_ERR("Failed to write snapshot \"%s\": %s\n", TmpFilename,
+             strerror(errno));
+    return -1;
+  }
+  rc = writeProfileWithFileObject(File, 0);
+  if (fclose(File))
+    rc = -1;
+
+#if defined(_WIN32)
+  /* rename() does not replace an existing file on Windows. */
+  if (!rc)
+    (void)remove(Filename);
+#endif
+  if (!rc && rename(TmpFilename, Filename))
+    rc = -1;
+  if (rc) {
+    PROF_ERR("Failed to write snapshot \"%s\": %s\n", Filename,
+             strerror(errno));
+    (void)remove(TmpFilename);
+  }
+  return rc;
+}
+
 /* Order file data will be saved in a file with suffx .order. */
 static const char *OrderFileSuffix = ".order";
 
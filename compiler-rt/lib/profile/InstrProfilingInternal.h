@@ -38,14 +38,26 @@ int __llvm_profile_write_buffer_internal(
     const __llvm_profile_data *DataEnd, const uint64_t *CountersBegin,
     const uint64_t *CountersEnd, const char *NamesBegin, const char *NamesEnd);
 
+/*!
+ * \brief Compute the number of padding bytes needed around the counters so
+ * that they start and end on a page boundary in continuous mode, and the
+ * number of bytes needed to pad the names to a multiple of 8 bytes.
+ */
+void __llvm_profile_get_padding_sizes_for_counters(
+    uint64_t DataSize, uint64_t CountersSize, uint64_t NamesSize,
+    uint64_t *PaddingBytesBeforeCounters, uint64_t *PaddingBytesAfterCounters,
+    uint64_t *PaddingBytesAfterNames);
+
 /*!
  * The data structure describing the data to be written by the
- * low level writer callback function.
+ * low level writer callback function. If \c Data is null, the writer skips
+ * over the bytes, or writes zeroes if \c UseZeroPadding is set.
  */
 typedef struct ProfDataIOVec {
   const void *Data;
   size_t ElmSize;
   size_t NumElm;
+  int UseZeroPadding;
 } ProfDataIOVec;
 
 struct ProfDataWriter;
@@ -177,6 +189,15 @@ uint64_t lprofGetLoadModuleSignature();
 unsigned lprofProfileDumped();
 void lprofSetProfileDumped();
 
+/*
+ * Return non zero value if continuous mode is enabled by the %c specifier in
+ * the profile file name. In continuous mode the counters are mapped onto the
+ * profile file, so they are never dumped explicitly.
+ */
+int __llvm_profile_is_continuous_mode_enabled(void);
+void __llvm_profile_enable_continuous_mode(void);
+void __llvm_profile_disable_continuous_mode(void);
+
 COMPILER_RT_VISIBILITY extern void (*FreeHook)(void *);
 COMPILER_RT_VISIBILITY extern uint8_t *DynamicBufferIOBuffer;
 COMPILER_RT_VISIBILITY extern uint32_t VPBufferSize;
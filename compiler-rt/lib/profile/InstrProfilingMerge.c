@@ -9,6 +9,14 @@
 |* stored in memory buffer.
 \*===---------------------------------------------------------------------===*/
 
+#include <stdlib.h>
+#if !defined(_WIN32)
+#include <pthread.h>
+/* Thread exits are only tracked if the program uses pthreads. */
+#pragma weak pthread_key_create
+#pragma weak pthread_setspecific
+#endif
+
 #include "InstrProfiling.h"
 #include "InstrProfilingInternal.h"
 #include "InstrProfilingUtil.h"
@@ -19,6 +27,116 @@
 COMPILER_RT_VISIBILITY
 void (*VPMergeHook)(ValueProfData *, __llvm_profile_data *);
 
+/* The counters of a thread, with thread-local counters
+ * (-instrprof-thread-local-counters). They are laid out like the profile
+ * counters. Once its thread exited, the buffer is added to the profile
+ * counters and reused by the next thread, so buffers are never freed. */
+typedef struct ThreadCounters {
+  struct ThreadCounters *Next;
+  uint64_t *Counters;
+  /* Points to the buffer itself while it belongs to a thread. */
+  void *Owner;
+} ThreadCounters;
+
+static ThreadCounters *ThreadCountersList = NULL;
+static COMPILER_RT_THREAD_LOCAL int ThreadCountersInitialized = 0;
+COMPILER_RT_VISIBILITY COMPILER_RT_THREAD_LOCAL intptr_t
+    INSTR_PROF_THREAD_COUNTERS_DELTA_VAR;
+
+/* Add the counts in \c Src to \c Dst and clear them. Like the counter
+ * updates themselves this is not atomic, so racing updates may be lost. */
+static void addAndClearCounters(uint64_t *Dst, uint64_t *Src,
+                                uint64_t NumCounters) {
+  uint64_t I;
+  for (I = 0; I < NumCounters; ++I) {
+    uint64_t Count = Src[I];
+    if (!Count)
+      continue;
+    Src[I] = 0;
+    Dst[I] += Count;
+  }
+}
+
+COMPILER_RT_VISIBILITY void __llvm_profile_merge_thread_counters(void) {
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  uint64_t NumCounters = __llvm_profile_end_counters() - CountersBegin;
+  ThreadCounters *TC;
+  for (TC = ThreadCountersList; TC; TC = TC->Next)
+    addAndClearCounters(CountersBegin, TC->Counters, NumCounters);
+}
+
+#if !defined(_WIN32)
+static pthread_key_t ThreadCountersKey;
+/* 0: the key was not created, 1: it is being created, 2: it was created,
+ * 3: it can not be created. */
+static void *ThreadCountersKeyState = (void *)0;
+
+static void releaseThreadCounters(void *Ptr) {
+  ThreadCounters *TC = (ThreadCounters *)Ptr;
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  addAndClearCounters(CountersBegin, TC->Counters,
+                      __llvm_profile_end_counters() - CountersBegin);
+  /* Instrumented code still running in this thread updates the shared
+   * counters from now on. */
+  INSTR_PROF_THREAD_COUNTERS_DELTA_VAR = 0;
+  (void)COMPILER_RT_BOOL_CMPXCHG(&TC->Owner, TC, NULL);
+}
+#endif
+
+/* Arrange for the counters of the current thread to be released when it
+ * exits. Otherwise they are only added to the profile counters when the
+ * profile is written, and never reused. */
+static void registerThreadCounters(ThreadCounters *TC) {
+#if !defined(_WIN32)
+  if (!pthread_key_create || !pthread_setspecific)
+    return;
+  if (COMPILER_RT_BOOL_CMPXCHG(&ThreadCountersKeyState, (void *)0,
+                               (void *)1))
+    ThreadCountersKeyState =
+        pthread_key_create(&ThreadCountersKey, releaseThreadCounters)
+            ? (void *)3
+            : (void *)2;
+  if (ThreadCountersKeyState == (void *)2)
+    pthread_setspecific(ThreadCountersKey, TC);
+#endif
+}
+
+/* Called by instrumented code the first time it runs in a thread. Returns
+ * the offset from the profile counters to the counters of the thread, or 0
+ * if the thread updates the profile counters. */
+COMPILER_RT_VISIBILITY intptr_t INSTR_PROF_THREAD_COUNTERS_INIT_FUNC(void) {
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  uint64_t NumCounters = __llvm_profile_end_counters() - CountersBegin;
+  ThreadCounters *TC;
+
+  if (ThreadCountersInitialized)
+    return INSTR_PROF_THREAD_COUNTERS_DELTA_VAR;
+  ThreadCountersInitialized = 1;
+  if (!NumCounters)
+    return 0;
+
+  /* Reuse the counters of an exited thread, or allocate new ones. */
+  for (TC = ThreadCountersList; TC; TC = TC->Next)
+    if (!TC->Owner && COMPILER_RT_BOOL_CMPXCHG(&TC->Owner, NULL, TC))
+      break;
+  if (!TC) {
+    TC = (ThreadCounters *)calloc(
+        1, sizeof(ThreadCounters) + NumCounters * sizeof(uint64_t));
+    if (!TC)
+      return 0;
+    TC->Counters = (uint64_t *)(TC + 1);
+    TC->Owner = TC;
+    do
+      TC->Next = ThreadCountersList;
+    while (!COMPILER_RT_BOOL_CMPXCHG(&ThreadCountersList, TC->Next, TC));
+  }
+  registerThreadCounters(TC);
+
+  INSTR_PROF_THREAD_COUNTERS_DELTA_VAR =
+      (char *)TC->Counters - (char *)CountersBegin;
+  return INSTR_PROF_THREAD_COUNTERS_DELTA_VAR;
+}
+
 COMPILER_RT_VISIBILITY
 uint64_t lprofGetLoadModuleSignature() {
   /* A very fast way to compute a module signature.  */
@@ -65,7 +183,9 @@ int __llvm_profile_check_compatibility(const char *ProfileData,
 
   if (ProfileSize < sizeof(__llvm_profile_header) +
                         Header->DataSize * sizeof(__llvm_profile_data) +
-                        Header->NamesSize + Header->CountersSize)
+                        Header->PaddingBytesBeforeCounters +
+                        Header->CountersSize * sizeof(uint64_t) +
+                        Header->PaddingBytesAfterCounters + Header->NamesSize)
     return 1;
 
   for (SrcData = SrcDataStart,
@@ -93,8 +213,10 @@ void __llvm_profile_merge_from_buffer(const char *ProfileData,
   SrcDataStart =
       (__llvm_profile_data *)(ProfileData + sizeof(__llvm_profile_header));
   SrcDataEnd = SrcDataStart + Header->DataSize;
-  SrcCountersStart = (uint64_t *)SrcDataEnd;
-  SrcNameStart = (const char *)(SrcCountersStart + Header->CountersSize);
+  SrcCountersStart = (uint64_t *)((const char *)SrcDataEnd +
+                                  Header->PaddingBytesBeforeCounters);
+  SrcNameStart = (const char *)(SrcCountersStart + Header->CountersSize) +
+                 Header->PaddingBytesAfterCounters;
   SrcValueProfDataStart =
       (ValueProfData *)(SrcNameStart + Header->NamesSize +
                         __llvm_profile_get_num_padding_bytes(
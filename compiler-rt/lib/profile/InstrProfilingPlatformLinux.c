@@ -22,6 +22,9 @@
 #define PROF_ORDERFILE_START INSTR_PROF_SECT_START(INSTR_PROF_ORDERFILE_COMMON)
 #define PROF_VNODES_START INSTR_PROF_SECT_START(INSTR_PROF_VNODES_COMMON)
 #define PROF_VNODES_STOP INSTR_PROF_SECT_STOP(INSTR_PROF_VNODES_COMMON)
+/* The page size continuous mode expects. Counters that do not fall on page
+ * boundaries of the actual page size make it fall back to writing at exit. */
+#define PROF_PAGE_ALIGNMENT 4096
 
 /* Declare section start and stop symbols for various sections
  * generated by compiler instrumentation.
@@ -39,8 +42,13 @@ extern ValueProfNode PROF_VNODES_STOP COMPILER_RT_VISIBILITY;
 /* Add dummy data to ensure the section is always created. */
 __llvm_profile_data
     __prof_data_sect_data[0] COMPILER_RT_SECTION(INSTR_PROF_DATA_SECT_NAME);
-uint64_t
-    __prof_cnts_sect_data[0] COMPILER_RT_SECTION(INSTR_PROF_CNTS_SECT_NAME);
+/* The counters dummy is page-aligned so that the counter section starts on a
+ * page boundary. As the runtime is linked after the instrumented objects, the
+ * dummy is also the last thing in the section, which then ends on a page
+ * boundary too. This allows continuous mode to mmap the counters onto the
+ * profile file. */
+uint64_t __prof_cnts_sect_data[0] COMPILER_RT_ALIGNAS(PROF_PAGE_ALIGNMENT)
+    COMPILER_RT_SECTION(INSTR_PROF_CNTS_SECT_NAME);
 uint32_t
     __prof_orderfile_sect_data[0] COMPILER_RT_SECTION(INSTR_PROF_ORDERFILE_SECT_NAME);
 char __prof_nms_sect_data[0] COMPILER_RT_SECTION(INSTR_PROF_NAME_SECT_NAME);
@@ -58,6 +58,9 @@ const char *lprofFindLastDirSeparator(const char *Path);
 
 int lprofGetHostName(char *Name, int Len);
 
+/* Return the size of a page of virtual memory. */
+unsigned lprofGetPageSize(void);
+
 unsigned lprofBoolCmpXchg(void **Ptr, void *OldV, void *NewV);
 void *lprofPtrFetchAdd(void **Mem, long ByteIncr);
 
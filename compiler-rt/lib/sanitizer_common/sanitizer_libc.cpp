@@ -37,9 +37,113 @@ void *internal_memrchr(const void *s, int c, uptr n) {
   return res;
 }
 
+// The mem* functions below work a word, or a pair of words, at a time, with
+// a separate path for each class of small sizes: an unaligned word at each
+// end covers any size between one and two words. The pairs are meant to end
+// up in SIMD registers where the target has them, and loads always happen
+// before the stores they could overlap, which makes the copies safe for
+// memmove.
+#if defined(_MSC_VER) && !defined(__clang__)
+typedef u16 unaligned_u16;
+typedef u32 unaligned_u32;
+typedef u64 unaligned_u64;
+typedef uptr unaligned_uptr;
+#else
+typedef u16 unaligned_u16 __attribute__((aligned(1), may_alias));
+typedef u32 unaligned_u32 __attribute__((aligned(1), may_alias));
+typedef u64 unaligned_u64 __attribute__((aligned(1), may_alias));
+typedef uptr unaligned_uptr __attribute__((aligned(1), may_alias));
+#endif
+
+template <typename T>
+static ALWAYS_INLINE T LoadUnaligned(const char *p) {
+  return *reinterpret_cast<const T *>(p);
+}
+
+template <typename T>
+static ALWAYS_INLINE void StoreUnaligned(char *p, T v) {
+  *reinterpret_cast<T *>(p) = v;
+}
+
+struct Chunk16 {
+  u64 lo, hi;
+};
+
+static ALWAYS_INLINE Chunk16 LoadChunk(const char *p) {
+  return {LoadUnaligned<unaligned_u64>(p), LoadUnaligned<unaligned_u64>(p + 8)};
+}
+
+static ALWAYS_INLINE void StoreChunk(char *p, Chunk16 c) {
+  StoreUnaligned<unaligned_u64>(p, c.lo);
+  StoreUnaligned<unaligned_u64>(p + 8, c.hi);
+}
+
+// Copies n <= 32 bytes.
+static ALWAYS_INLINE void CopySmall(char *d, const char *s, uptr n) {
+  if (n >= 16) {
+    Chunk16 head = LoadChunk(s), tail = LoadChunk(s + n - 16);
+    StoreChunk(d, head);
+    StoreChunk(d + n - 16, tail);
+  } else if (n >= 8) {
+    u64 head = LoadUnaligned<unaligned_u64>(s);
+    u64 tail = LoadUnaligned<unaligned_u64>(s + n - 8);
+    StoreUnaligned<unaligned_u64>(d, head);
+    StoreUnaligned<unaligned_u64>(d + n - 8, tail);
+  } else if (n >= 4) {
+    u32 head = LoadUnaligned<unaligned_u32>(s);
+    u32 tail = LoadUnaligned<unaligned_u32>(s + n - 4);
+    StoreUnaligned<unaligned_u32>(d, head);
+    StoreUnaligned<unaligned_u32>(d + n - 4, tail);
+  } else if (n >= 2) {
+    u16 head = LoadUnaligned<unaligned_u16>(s);
+    u16 tail = LoadUnaligned<unaligned_u16>(s + n - 2);
+    StoreUnaligned<unaligned_u16>(d, head);
+    StoreUnaligned<unaligned_u16>(d + n - 2, tail);
+  } else if (n == 1) {
+    *d = *s;
+  }
+}
+
+// Copies n > 32 bytes. The first and the last chunk are copied unaligned,
+// and the chunks in between are stored to 16-byte aligned addresses, going
+// backwards when the destination overlaps the end of the source.
+static void CopyLarge(char *d, const char *s, uptr n) {
+  Chunk16 head = LoadChunk(s), tail = LoadChunk(s + n - 16);
+  if (d <= s || d >= s + n) {
+    for (uptr i = 16 - (reinterpret_cast<uptr>(d) & 15); i < n - 16; i += 16)
+      StoreChunk(d + i, LoadChunk(s + i));
+  } else {
+    uptr end = reinterpret_cast<uptr>(d + n) & 15;
+    for (uptr i = n - (end ? end : 16); i > 16; i -= 16)
+      StoreChunk(d + i - 16, LoadChunk(s + i - 16));
+  }
+  StoreChunk(d, head);
+  StoreChunk(d + n - 16, tail);
+}
+
 int internal_memcmp(const void* s1, const void* s2, uptr n) {
   const char *t1 = (const char *)s1;
   const char *t2 = (const char *)s2;
+  // Skip equal chunks, then find the difference a word at a time.
+  for (; n >= 16; n -= 16, t1 += 16, t2 += 16) {
+    Chunk16 c1 = LoadChunk(t1), c2 = LoadChunk(t2);
+    if ((c1.lo ^ c2.lo) | (c1.hi ^ c2.hi))
+      break;
+  }
+  const uptr kWordSize = sizeof(uptr);
+  for (; n >= kWordSize; n -= kWordSize, t1 += kWordSize, t2 += kWordSize) {
+    uptr w1 = LoadUnaligned<unaligned_uptr>(t1);
+    uptr w2 = LoadUnaligned<unaligned_uptr>(t2);
+    if (w1 == w2)
+      continue;
+    // The first differing byte in memory order decides.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uptr i = (SANITIZER_WORDSIZE - 1 - MostSignificantSetBitIndex(w1 ^ w2)) / 8;
+#else
+    uptr i = LeastSignificantSetBitIndex(w1 ^ w2) / 8;
+#endif
+    return t1[i] < t2[i] ? -1 : 1;
+  }
   for (uptr i = 0; i < n; ++i, ++t1, ++t2)
     if (*t1 != *t2)
       return *t1 < *t2 ? -1 : 1;
@@ -47,50 +151,41 @@ int internal_memcmp(const void* s1, const void* s2, uptr n) {
 }
 
 void *internal_memcpy(void *dest, const void *src, uptr n) {
-  char *d = (char*)dest;
-  const char *s = (const char *)src;
-  for (uptr i = 0; i < n; ++i)
-    d[i] = s[i];
+  if (n <= 32)
+    CopySmall((char *)dest, (const char *)src, n);
+  else
+    CopyLarge((char *)dest, (const char *)src, n);
   return dest;
 }
 
 void *internal_memmove(void *dest, const void *src, uptr n) {
-  char *d = (char*)dest;
-  const char *s = (const char *)src;
-  sptr i, signed_n = (sptr)n;
-  CHECK_GE(signed_n, 0);
-  if (d < s) {
-    for (i = 0; i < signed_n; ++i)
-      d[i] = s[i];
-  } else {
-    if (d > s && signed_n > 0)
-      for (i = signed_n - 1; i >= 0 ; --i) {
-        d[i] = s[i];
-      }
-  }
-  return dest;
+  CHECK_GE((sptr)n, 0);
+  return internal_memcpy(dest, src, n);
 }
 
 void *internal_memset(void* s, int c, uptr n) {
-  // Optimize for the most performance-critical case:
-  if ((reinterpret_cast<uptr>(s) % 16) == 0 && (n % 16) == 0) {
-    u64 *p = reinterpret_cast<u64*>(s);
-    u64 *e = p + n / 8;
-    u64 v = c;
-    v |= v << 8;
-    v |= v << 16;
-    v |= v << 32;
-    for (; p < e; p += 2)
-      p[0] = p[1] = v;
-    return s;
-  }
-  // The next line prevents Clang from making a call to memset() instead of the
-  // loop below.
-  // FIXME: building the runtime with -ffreestanding is a better idea. However
-  // there currently are linktime problems due to PR12396.
-  char volatile *t = (char*)s;
-  for (uptr i = 0; i < n; ++i, ++t) {
-    *t = c;
+  char *t = (char *)s;
+  u64 v = (u8)c;
+  v |= v << 8;
+  v |= v << 16;
+  v |= v << 32;
+  if (n >= 16) {
+    Chunk16 chunk = {v, v};
+    StoreChunk(t, chunk);
+    for (uptr i = 16 - (reinterpret_cast<uptr>(t) & 15); i < n - 16; i += 16)
+      StoreChunk(t + i, chunk);
+    StoreChunk(t + n - 16, chunk);
+  } else if (n >= 8) {
+    StoreUnaligned<unaligned_u64>(t, v);
+    StoreUnaligned<unaligned_u64>(t + n - 8, v);
+  } else if (n >= 4) {
+    StoreUnaligned<unaligned_u32>(t, (u32)v);
+    StoreUnaligned<unaligned_u32>(t + n - 4, (u32)v);
+  } else if (n >= 2) {
+    StoreUnaligned<unaligned_u16>(t, (u16)v);
+    StoreUnaligned<unaligned_u16>(t + n - 2, (u16)v);
+  } else if (n == 1) {
+    *t = (char)c;
   }
   return s;
 }
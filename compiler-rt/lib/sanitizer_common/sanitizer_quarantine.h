@@ -11,6 +11,9 @@
 // then evicts to global FIFO queue. When the queue reaches specified threshold,
 // oldest memory is recycled.
 //
+// Evicting a per-thread cache doesn't take a lock: its batches are pushed onto
+// a lock-free stack, which the thread recycling memory moves to the queue.
+//
 //===----------------------------------------------------------------------===//
 
 #ifndef SANITIZER_QUARANTINE_H
@@ -90,7 +93,6 @@ class Quarantine {
     atomic_store_relaxed(&min_size_, size / 10 * 9);  // 90% of max size.
     atomic_store_relaxed(&max_cache_size_, cache_size);
 
-    cache_mutex_.Init();
     recycle_mutex_.Init();
   }
 
@@ -113,27 +115,24 @@ class Quarantine {
   }
 
   void NOINLINE Drain(Cache *c, Callback cb) {
-    {
-      SpinMutexLock l(&cache_mutex_);
-      cache_.Transfer(c);
-    }
-    if (cache_.Size() > GetSize() && recycle_mutex_.TryLock())
+    PushDrained(c);
+    if (cache_.Size() + atomic_load_relaxed(&drained_size_) > GetSize() &&
+        recycle_mutex_.TryLock())
       Recycle(atomic_load_relaxed(&min_size_), cb);
   }
 
   void NOINLINE DrainAndRecycle(Cache *c, Callback cb) {
-    {
-      SpinMutexLock l(&cache_mutex_);
-      cache_.Transfer(c);
-    }
+    PushDrained(c);
     recycle_mutex_.Lock();
     Recycle(0, cb);
   }
 
-  void PrintStats() const {
+  void PrintStats() {
     // It assumes that the world is stopped, just as the allocator's PrintStats.
     Printf("Quarantine limits: global: %zdMb; thread local: %zdKb\n",
            GetSize() >> 20, GetCacheSize() >> 10);
+    SpinMutexLock l(&recycle_mutex_);
+    PopDrained();
     cache_.PrintStats();
   }
 
@@ -144,37 +143,82 @@ class Quarantine {
   atomic_uintptr_t min_size_;
   atomic_uintptr_t max_cache_size_;
   char pad1_[kCacheLineSize];
-  StaticSpinMutex cache_mutex_;
+  // Batches evicted from the per-thread caches, linked through their next
+  // field, most recently evicted first.
+  atomic_uintptr_t drained_;
+  atomic_uintptr_t drained_size_;
+  char pad2_[kCacheLineSize];
+  // Guards cache_, which only the thread recycling memory accesses.
   StaticSpinMutex recycle_mutex_;
   Cache cache_;
-  char pad2_[kCacheLineSize];
+  char pad3_[kCacheLineSize];
+
+  void PushDrained(Cache *c) {
+    QuarantineBatch *newest, *oldest;
+    uptr size = c->ExtractBatches(&newest, &oldest);
+    if (!size)
+      return;
+    // Account for the batches before they can be popped, so that the size
+    // never goes below zero.
+    atomic_fetch_add(&drained_size_, size, memory_order_relaxed);
+    uptr head = atomic_load_relaxed(&drained_);
+    do {
+      oldest->next = reinterpret_cast<QuarantineBatch *>(head);
+    } while (!atomic_compare_exchange_weak(&drained_, &head,
+                                           reinterpret_cast<uptr>(newest),
+                                           memory_order_release));
+  }
+
+  // Moves the drained batches to cache_. Requires recycle_mutex_.
+  void PopDrained() {
+    uptr head = atomic_load_relaxed(&drained_);
+    while (head && !atomic_compare_exchange_weak(&drained_, &head, 0,
+                                                 memory_order_acquire)) {
+    }
+    QuarantineBatch *b = reinterpret_cast<QuarantineBatch *>(head);
+    // Reverse the stack, so that the oldest batches are the first to be
+    // recycled.
+    QuarantineBatch *oldest = nullptr;
+    uptr size = 0;
+    while (b) {
+      QuarantineBatch *next = b->next;
+      b->next = oldest;
+      oldest = b;
+      size += b->size;
+      b = next;
+    }
+    while (oldest) {
+      QuarantineBatch *next = oldest->next;
+      cache_.EnqueueBatch(oldest);
+      oldest = next;
+    }
+    atomic_fetch_sub(&drained_size_, size, memory_order_relaxed);
+  }
 
   void NOINLINE Recycle(uptr min_size, Callback cb) {
     Cache tmp;
-    {
-      SpinMutexLock l(&cache_mutex_);
-      // Go over the batches and merge partially filled ones to
-      // save some memory, otherwise batches themselves (since the memory used
-      // by them is counted against quarantine limit) can overcome the actual
-      // user's quarantined chunks, which diminishes the purpose of the
-      // quarantine.
-      uptr cache_size = cache_.Size();
-      uptr overhead_size = cache_.OverheadSize();
-      CHECK_GE(cache_size, overhead_size);
-      // Do the merge only when overhead exceeds this predefined limit (might
-      // require some tuning). It saves us merge attempt when the batch list
-      // quarantine is unlikely to contain batches suitable for merge.
-      const uptr kOverheadThresholdPercents = 100;
-      if (cache_size > overhead_size &&
-          overhead_size * (100 + kOverheadThresholdPercents) >
-              cache_size * kOverheadThresholdPercents) {
-        cache_.MergeBatches(&tmp);
-      }
-      // Extract enough chunks from the quarantine to get below the max
-      // quarantine size and leave some leeway for the newly quarantined chunks.
-      while (cache_.Size() > min_size) {
-        tmp.EnqueueBatch(cache_.DequeueBatch());
-      }
+    PopDrained();
+    // Go over the batches and merge partially filled ones to
+    // save some memory, otherwise batches themselves (since the memory used
+    // by them is counted against quarantine limit) can overcome the actual
+    // user's quarantined chunks, which diminishes the purpose of the
+    // quarantine.
+    uptr cache_size = cache_.Size();
+    uptr overhead_size = cache_.OverheadSize();
+    CHECK_GE(cache_size, overhead_size);
+    // Do the merge only when overhead exceeds this predefined limit (might
+    // require some tuning). It saves us merge attempt when the batch list
+    // quarantine is unlikely to contain batches suitable for merge.
+    const uptr kOverheadThresholdPercents = 100;
+    if (cache_size > overhead_size &&
+        overhead_size * (100 + kOverheadThresholdPercents) >
+            cache_size * kOverheadThresholdPercents) {
+      cache_.MergeBatches(&tmp);
+    }
+    // Extract enough chunks from the quarantine to get below the max
+    // quarantine size and leave some leeway for the newly quarantined chunks.
+    while (cache_.Size() > min_size) {
+      tmp.EnqueueBatch(cache_.DequeueBatch());
     }
     recycle_mutex_.Unlock();
     DoRecycle(&tmp, cb);
@@ -237,6 +281,25 @@ class QuarantineCache {
     atomic_store_relaxed(&from_cache->size_, 0);
   }
 
+  // Detaches all the batches, linked in reverse order from *newest to
+  // *oldest, and returns their total size, which is 0 if there are none.
+  uptr ExtractBatches(QuarantineBatch **newest, QuarantineBatch **oldest) {
+    if (list_.empty())
+      return 0;
+    *oldest = list_.front();
+    QuarantineBatch *reversed = nullptr;
+    for (QuarantineBatch *b = list_.front(), *next; b; b = next) {
+      next = b->next;
+      b->next = reversed;
+      reversed = b;
+    }
+    *newest = reversed;
+    uptr size = Size();
+    list_.clear();
+    atomic_store_relaxed(&size_, 0);
+    return size;
+  }
+
   void EnqueueBatch(QuarantineBatch *b) {
     list_.push_back(b);
     SizeAdd(b->size);
@@ -30,7 +30,11 @@ class StackDepotBase {
   // Retrieves a stored stack trace by the id.
   args_type Get(u32 id);
 
-  StackDepotStats *GetStats() { return &stats; }
+  StackDepotStats *GetStats() {
+    stats.n_uniq_ids = atomic_load(&n_uniq_ids, memory_order_relaxed);
+    stats.allocated = atomic_load(&allocated, memory_order_relaxed);
+    return &stats;
+  }
 
   void LockAll();
   void UnlockAll();
@@ -39,18 +43,26 @@ class StackDepotBase {
   static Node *find(Node *s, args_type args, u32 hash);
   static Node *lock(atomic_uintptr_t *p);
   static void unlock(atomic_uintptr_t *p, Node *s);
+  void map_id(u32 id, Node *s);
 
   static const int kTabSize = 1 << kTabSizeLog;  // Hash table size.
-  static const int kPartBits = 8;
-  static const int kPartShift = sizeof(u32) * 8 - kPartBits - kReservedBits;
-  static const int kPartCount =
-      1 << kPartBits;  // Number of subparts in the table.
-  static const int kPartSize = kTabSize / kPartCount;
-  static const int kMaxId = 1 << kPartShift;
+  static const u32 kMaxId = ((u32)-1) >> kReservedBits;
 
-  atomic_uintptr_t tab[kTabSize];   // Hash table of Node's.
-  atomic_uint32_t seq[kPartCount];  // Unique id generators.
+  // Nodes are also indexed by id, in blocks of kIdMapBlockSize entries that
+  // are mapped on first use, so that Get doesn't have to search for the id.
+  static const int kIdMapBlockSizeLog = 16;
+  static const uptr kIdMapBlockSize = 1 << kIdMapBlockSizeLog;
+  static const uptr kIdMapSize = (kMaxId >> kIdMapBlockSizeLog) + 1;
 
+  atomic_uintptr_t tab[kTabSize];   // Hash table of Node's.
+  atomic_uint32_t last_id;          // Unique id generator.
+  atomic_uintptr_t id_map[kIdMapSize];
+  StaticSpinMutex id_map_mtx;       // Protects mapping of id_map blocks.
+
+  // Put doesn't take a lock, so the statistics are kept in atomics and copied
+  // to stats by GetStats.
+  atomic_uintptr_t n_uniq_ids;
+  atomic_uintptr_t allocated;
   StackDepotStats stats;
 
   friend class StackDepotReverseMap;
@@ -92,6 +104,24 @@ void StackDepotBase<Node, kReservedBits, kTabSizeLog>::unlock(
   atomic_store(p, (uptr)s, memory_order_release);
 }
 
+template <class Node, int kReservedBits, int kTabSizeLog>
+void StackDepotBase<Node, kReservedBits, kTabSizeLog>::map_id(u32 id,
+                                                              Node *s) {
+  atomic_uintptr_t *block = &id_map[id >> kIdMapBlockSizeLog];
+  uptr v = atomic_load(block, memory_order_acquire);
+  if (UNLIKELY(!v)) {
+    SpinMutexLock l(&id_map_mtx);
+    v = atomic_load(block, memory_order_relaxed);
+    if (!v) {
+      v = (uptr)MmapOrDie(kIdMapBlockSize * sizeof(uptr), "stack depot ids");
+      atomic_store(block, v, memory_order_release);
+    }
+  }
+  atomic_uintptr_t *entry =
+      &((atomic_uintptr_t *)v)[id & (kIdMapBlockSize - 1)];
+  atomic_store(entry, (uptr)s, memory_order_release);
+}
+
 template <class Node, int kReservedBits, int kTabSizeLog>
 typename StackDepotBase<Node, kReservedBits, kTabSizeLog>::handle_type
 StackDepotBase<Node, kReservedBits, kTabSizeLog>::Put(args_type args,
@@ -105,31 +135,47 @@ StackDepotBase<Node, kReservedBits, kTabSizeLog>::Put(args_type args,
   // First, try to find the existing stack.
   Node *node = find(s, args, h);
   if (node) return node->get_handle();
-  // If failed, lock, retry and insert new.
-  Node *s2 = lock(p);
-  if (s2 != s) {
-    node = find(s2, args, h);
-    if (node) {
-      unlock(p, s2);
-      return node->get_handle();
-    }
-  }
-  uptr part = (h % kTabSize) / kPartSize;
-  u32 id = atomic_fetch_add(&seq[part], 1, memory_order_relaxed) + 1;
-  stats.n_uniq_ids++;
-  CHECK_LT(id, kMaxId);
-  id |= part << kPartShift;
+  // If failed, build a new node and push it onto the list. Nodes are only
+  // ever pushed, so when the push loses a race, only the nodes pushed since
+  // need to be searched again.
+  u32 id = atomic_fetch_add(&last_id, 1, memory_order_relaxed) + 1;
   CHECK_NE(id, 0);
-  CHECK_EQ(id & (((u32)-1) >> kReservedBits), id);
+  CHECK_LE(id, kMaxId);
   uptr memsz = Node::storage_size(args);
-  s = (Node *)PersistentAlloc(memsz);
-  stats.allocated += memsz;
-  s->id = id;
-  s->store(args, h);
-  s->link = s2;
-  unlock(p, s);
+  node = (Node *)PersistentAlloc(memsz);
+  node->id = id;
+  node->store(args, h);
+  // The id has to be mapped before the node is published: once another
+  // thread finds the node, it may hand out the id to someone who calls Get.
+  // If the push loses to a duplicate, the id is never handed out, so the
+  // stale mapping is harmless.
+  map_id(id, node);
+  for (int i = 0;; i++) {
+    node->link = s;
+    uptr cmp = (uptr)s;
+    if (atomic_compare_exchange_weak(p, &cmp, (uptr)node,
+                                     memory_order_release))
+      break;
+    // The lsb is set while LockAll holds the list.
+    if (cmp & 1) {
+      if (i < 10)
+        proc_yield(10);
+      else
+        internal_sched_yield();
+    }
+    Node *s2 = (Node *)(atomic_load(p, memory_order_consume) & ~1);
+    for (Node *n = s2; n != s; n = n->link) {
+      if (n->eq(h, args)) {
+        // Our node and its id are wasted, which is rare enough.
+        return n->get_handle();
+      }
+    }
+    s = s2;
+  }
+  atomic_fetch_add(&n_uniq_ids, 1, memory_order_relaxed);
+  atomic_fetch_add(&allocated, memsz, memory_order_relaxed);
   if (inserted) *inserted = true;
-  return s->get_handle();
+  return node->get_handle();
 }
 
 template <class Node, int kReservedBits, int kTabSizeLog>
@@ -138,22 +184,13 @@ StackDepotBase<Node, kReservedBits, kTabSizeLog>::Get(u32 id) {
   if (id == 0) {
     return args_type();
   }
-  CHECK_EQ(id & (((u32)-1) >> kReservedBits), id);
-  // High kPartBits contain part id, so we need to scan at most kPartSize lists.
-  uptr part = id >> kPartShift;
-  for (int i = 0; i != kPartSize; i++) {
-    uptr idx = part * kPartSize + i;
-    CHECK_LT(idx, kTabSize);
-    atomic_uintptr_t *p = &tab[idx];
-    uptr v = atomic_load(p, memory_order_consume);
-    Node *s = (Node *)(v & ~1);
-    for (; s; s = s->link) {
-      if (s->id == id) {
-        return s->load();
-      }
-    }
-  }
-  return args_type();
+  CHECK_EQ(id & kMaxId, id);
+  uptr v = atomic_load(&id_map[id >> kIdMapBlockSizeLog], memory_order_consume);
+  if (!v) return args_type();
+  atomic_uintptr_t *entry =
+      &((atomic_uintptr_t *)v)[id & (kIdMapBlockSize - 1)];
+  Node *s = (Node *)atomic_load(entry, memory_order_consume);
+  return s ? s->load() : args_type();
 }
 
 template <class Node, int kReservedBits, int kTabSizeLog>
@@ -161,10 +198,12 @@ void StackDepotBase<Node, kReservedBits, kTabSizeLog>::LockAll() {
   for (int i = 0; i < kTabSize; ++i) {
     lock(&tab[i]);
   }
+  id_map_mtx.Lock();
 }
 
 template <class Node, int kReservedBits, int kTabSizeLog>
 void StackDepotBase<Node, kReservedBits, kTabSizeLog>::UnlockAll() {
+  id_map_mtx.Unlock();
   for (int i = 0; i < kTabSize; ++i) {
     atomic_uintptr_t *p = &tab[i];
     uptr s = atomic_load(p, memory_order_relaxed);
@@ -55,6 +55,31 @@ void SymbolizedStack::ClearAll() {
   InternalFree(this);
 }
 
+static char *StrdupIfNotNull(const char *str) {
+  return str ? internal_strdup(str) : nullptr;
+}
+
+SymbolizedStack *SymbolizedStack::Clone(uptr addr) const {
+  SymbolizedStack *res = New(addr);
+  SymbolizedStack *last = res;
+  for (const SymbolizedStack *frame = this; frame; frame = frame->next) {
+    if (frame != this) {
+      last->next = New(addr);
+      last = last->next;
+    }
+    AddressInfo &info = last->info;
+    info.module = StrdupIfNotNull(frame->info.module);
+    info.module_offset = frame->info.module_offset;
+    info.module_arch = frame->info.module_arch;
+    info.function = StrdupIfNotNull(frame->info.function);
+    info.function_offset = frame->info.function_offset;
+    info.file = StrdupIfNotNull(frame->info.file);
+    info.line = frame->info.line;
+    info.column = frame->info.column;
+  }
+  return res;
+}
+
 DataInfo::DataInfo() {
   internal_memset(this, 0, sizeof(DataInfo));
 }
@@ -112,8 +137,8 @@ const char *Symbolizer::ModuleNameOwner::GetOwnedCopy(const char *str) {
 }
 
 Symbolizer::Symbolizer(IntrusiveList<SymbolizerTool> tools)
-    : module_names_(&mu_), modules_(), modules_fresh_(false), tools_(tools),
-      start_hook_(0), end_hook_(0) {}
+    : module_names_(&mu_), frame_cache_(nullptr), modules_(),
+      modules_fresh_(false), tools_(tools), start_hook_(0), end_hook_(0) {}
 
 Symbolizer::SymbolizerScope::SymbolizerScope(const Symbolizer *sym)
     : sym_(sym) {
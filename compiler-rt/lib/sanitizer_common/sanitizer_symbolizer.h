@@ -55,6 +55,9 @@ struct SymbolizedStack {
   // Deletes current, and all subsequent frames in the linked list.
   // The object cannot be accessed after the call to this function.
   void ClearAll();
+  // Returns a copy of current, and all subsequent frames in the linked list,
+  // with the address set to |addr|.
+  SymbolizedStack *Clone(uptr addr) const;
 
  private:
   SymbolizedStack();
@@ -178,6 +181,22 @@ class Symbolizer final {
   bool FindModuleNameAndOffsetForAddress(uptr address, const char **module_name,
                                          uptr *module_offset,
                                          ModuleArch *module_arch);
+
+  // Frames already symbolized, keyed by module and offset rather than by
+  // address, so that they don't outlive a module unloaded from the address.
+  // Pcs recur a lot across reports, and each one symbolized by an external
+  // symbolizer costs a round trip to its process. Direct-mapped, and
+  // protected by |mu_|.
+  struct CachedFrames {
+    const char *module_name;
+    uptr module_offset;
+    SymbolizedStack *frames;
+  };
+  static const uptr kFrameCacheSize = 4096;
+  CachedFrames *frame_cache_;
+  CachedFrames *GetFrameCacheSlot(const char *module_name, uptr module_offset);
+  void FlushFrameCache();
+
   ListOfModules modules_;
   ListOfModules fallback_modules_;
   // If stale, need to reload the modules before looking up addresses.
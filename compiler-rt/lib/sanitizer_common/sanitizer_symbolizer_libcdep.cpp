@@ -81,20 +81,51 @@ const char *ExtractTokenUpToDelimiter(const char *str, const char *delimiter,
   return prefix_end;
 }
 
+Symbolizer::CachedFrames *Symbolizer::GetFrameCacheSlot(
+    const char *module_name, uptr module_offset) {
+  if (!frame_cache_) {
+    frame_cache_ = (CachedFrames *)MmapOrDie(
+        kFrameCacheSize * sizeof(CachedFrames), "symbolizer frame cache");
+  }
+  uptr hash = module_offset ^ ((uptr)module_name >> 4);
+  hash ^= hash >> 12;
+  return &frame_cache_[hash % kFrameCacheSize];
+}
+
+void Symbolizer::FlushFrameCache() {
+  if (!frame_cache_)
+    return;
+  for (uptr i = 0; i < kFrameCacheSize; i++) {
+    if (frame_cache_[i].frames)
+      frame_cache_[i].frames->ClearAll();
+  }
+  UnmapOrDie(frame_cache_, kFrameCacheSize * sizeof(CachedFrames));
+  frame_cache_ = nullptr;
+}
+
 SymbolizedStack *Symbolizer::SymbolizePC(uptr addr) {
   BlockingMutexLock l(&mu_);
   const char *module_name;
   uptr module_offset;
   ModuleArch arch;
-  SymbolizedStack *res = SymbolizedStack::New(addr);
   if (!FindModuleNameAndOffsetForAddress(addr, &module_name, &module_offset,
                                          &arch))
-    return res;
+    return SymbolizedStack::New(addr);
+  CachedFrames *cached = GetFrameCacheSlot(module_name, module_offset);
+  if (cached->frames && cached->module_name == module_name &&
+      cached->module_offset == module_offset)
+    return cached->frames->Clone(addr);
+  SymbolizedStack *res = SymbolizedStack::New(addr);
   // Always fill data about module name and offset.
   res->info.FillModuleInfo(module_name, module_offset, arch);
   for (auto &tool : tools_) {
     SymbolizerScope sym_scope(this);
     if (tool.SymbolizePC(addr, res)) {
+      if (cached->frames)
+        cached->frames->ClearAll();
+      cached->module_name = module_name;
+      cached->module_offset = module_offset;
+      cached->frames = res->Clone(addr);
       return res;
     }
   }
@@ -154,6 +185,7 @@ bool Symbolizer::GetModuleNameAndOffsetForPC(uptr pc, const char **module_name,
 
 void Symbolizer::Flush() {
   BlockingMutexLock l(&mu_);
+  FlushFrameCache();
   for (auto &tool : tools_) {
     SymbolizerScope sym_scope(this);
     tool.Flush();
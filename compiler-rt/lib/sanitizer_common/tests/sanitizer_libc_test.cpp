@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <vector>
 #include <stdio.h>
+#include <string.h>
 
 #include "sanitizer_common/sanitizer_common.h"
 #include "sanitizer_common/sanitizer_file.h"
@@ -38,6 +39,55 @@ TEST(SanitizerCommon, InternalMemmoveRegression) {
   EXPECT_EQ(dest[4], src[4]);
 }
 
+// The mem* functions have a separate path for every class of small sizes, and
+// align the stores for the larger ones, so try every size up to a few chunks
+// at every misalignment.
+TEST(SanitizerCommon, InternalMemFunctionsSizesAndAlignments) {
+  const uptr kMaxSize = 200, kBufSize = kMaxSize + 64;
+  char src[kBufSize], expected[kBufSize], actual[kBufSize];
+  for (uptr i = 0; i < kBufSize; i++)
+    src[i] = (char)(i * 7 + 1);
+  for (uptr size = 0; size <= kMaxSize; size++) {
+    for (uptr src_off = 0; src_off < 16; src_off++) {
+      for (uptr dst_off = 0; dst_off < 16; dst_off++) {
+        memset(expected, 'x', kBufSize);
+        memset(actual, 'x', kBufSize);
+        memcpy(expected + dst_off, src + src_off, size);
+        internal_memcpy(actual + dst_off, src + src_off, size);
+        ASSERT_EQ(0, memcmp(expected, actual, kBufSize));
+
+        // Overlapping copies in both directions.
+        memcpy(expected, src, kBufSize);
+        memcpy(actual, src, kBufSize);
+        memmove(expected + dst_off, expected + src_off, size);
+        internal_memmove(actual + dst_off, actual + src_off, size);
+        ASSERT_EQ(0, memcmp(expected, actual, kBufSize));
+
+        memset(expected, 'x', kBufSize);
+        memset(actual, 'x', kBufSize);
+        memset(expected + dst_off, 0x80 | (int)src_off, size);
+        internal_memset(actual + dst_off, 0x80 | (int)src_off, size);
+        ASSERT_EQ(0, memcmp(expected, actual, kBufSize));
+
+        memcpy(actual, src, kBufSize);
+        ASSERT_EQ(0, internal_memcmp(src + src_off, actual + src_off, size));
+        if (size) {
+          // Differ at any position, with the sign of the result decided by
+          // the first differing byte only.
+          uptr pos = dst_off * (size - 1) / 15;
+          actual[src_off + pos] = src[src_off + pos] + 1;
+          if (pos + 1 < size)
+            actual[src_off + pos + 1] = src[src_off + pos + 1] - 1;
+          int expected_result =
+              src[src_off + pos] < actual[src_off + pos] ? -1 : 1;
+          ASSERT_EQ(expected_result,
+                    internal_memcmp(src + src_off, actual + src_off, size));
+        }
+      }
+    }
+  }
+}
+
 TEST(SanitizerCommon, mem_is_zero) {
   size_t size = 128;
   char *x = new char[size];
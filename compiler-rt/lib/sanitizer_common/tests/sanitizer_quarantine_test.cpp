@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 #include "sanitizer_common/sanitizer_common.h"
 #include "sanitizer_common/sanitizer_quarantine.h"
+#include "sanitizer_pthread_wrappers.h"
 #include "gtest/gtest.h"
 
 #include <stdlib.h>
@@ -176,4 +177,49 @@ TEST(SanitizerCommon, QuarantineCacheMergeBatchesALotOfBatches) {
   DeallocateCache(&to_deallocate);
 }
 
+static atomic_uintptr_t recycled_count;
+
+struct CountingQuarantineCallback {
+  void Recycle(void *m) {
+    atomic_fetch_add(&recycled_count, 1, memory_order_relaxed);
+  }
+  void *Allocate(uptr size) {
+    return malloc(size);
+  }
+  void Deallocate(void *p) {
+    free(p);
+  }
+};
+
+typedef Quarantine<CountingQuarantineCallback, void> CountingQuarantine;
+
+static CountingQuarantine quarantine(LINKER_INITIALIZED);
+static const uptr kNumThreads = 8;
+static const uptr kNumPutsPerThread = 10000;
+
+static void *QuarantineDrainWorker(void *unused) {
+  CountingQuarantine::Cache cache;
+  for (uptr i = 0; i < kNumPutsPerThread; ++i)
+    quarantine.Put(&cache, CountingQuarantineCallback(), kFakePtr, kBlockSize);
+  quarantine.Drain(&cache, CountingQuarantineCallback());
+  return nullptr;
+}
+
+TEST(SanitizerCommon, QuarantineThreadedDrain) {
+  // The global quarantine is smaller than what the threads put in it, so that
+  // some threads recycle while others drain their caches.
+  quarantine.Init(kBlockSize * kNumPutsPerThread, kBlockSize * 64);
+  pthread_t threads[kNumThreads];
+  for (uptr i = 0; i < kNumThreads; ++i)
+    PTHREAD_CREATE(&threads[i], 0, QuarantineDrainWorker, 0);
+  for (uptr i = 0; i < kNumThreads; ++i)
+    PTHREAD_JOIN(threads[i], 0);
+
+  // Every chunk is recycled exactly once.
+  CountingQuarantine::Cache empty;
+  quarantine.DrainAndRecycle(&empty, CountingQuarantineCallback());
+  ASSERT_EQ(kNumThreads * kNumPutsPerThread,
+            atomic_load_relaxed(&recycled_count));
+}
+
 }  // namespace __sanitizer
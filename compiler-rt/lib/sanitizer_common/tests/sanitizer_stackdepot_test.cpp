@@ -12,6 +12,7 @@
 #include "sanitizer_common/sanitizer_stackdepot.h"
 #include "sanitizer_common/sanitizer_internal_defs.h"
 #include "sanitizer_common/sanitizer_libc.h"
+#include "sanitizer_pthread_wrappers.h"
 #include "gtest/gtest.h"
 
 namespace __sanitizer {
@@ -89,4 +90,33 @@ TEST(SanitizerCommon, StackDepotReverseMap) {
   }
 }
 
+static const int kNumRacingStacks = 1000;
+static const int kNumRacingThreads = 8;
+
+static void *StackDepotRaceWorker(void *arg) {
+  u32 *ids = (u32 *)arg;
+  // All threads put the same stacks, so that they race to insert each one.
+  for (int i = 0; i < kNumRacingStacks; i++) {
+    uptr array[] = {100, 200, 300, (uptr)i};
+    ids[i] = StackDepotPut(StackTrace(array, ARRAY_SIZE(array)));
+  }
+  return 0;
+}
+
+TEST(SanitizerCommon, StackDepotThreaded) {
+  static u32 ids[kNumRacingThreads][kNumRacingStacks];
+  pthread_t threads[kNumRacingThreads];
+  for (int i = 0; i < kNumRacingThreads; i++)
+    PTHREAD_CREATE(&threads[i], 0, StackDepotRaceWorker, ids[i]);
+  for (int i = 0; i < kNumRacingThreads; i++)
+    PTHREAD_JOIN(threads[i], 0);
+  for (int i = 0; i < kNumRacingStacks; i++) {
+    for (int j = 1; j < kNumRacingThreads; j++)
+      EXPECT_EQ(ids[0][i], ids[j][i]);
+    StackTrace stack = StackDepotGet(ids[0][i]);
+    ASSERT_EQ(4U, stack.size);
+    EXPECT_EQ((uptr)i, stack.trace[3]);
+  }
+}
+
 }  // namespace __sanitizer
@@ -34,6 +34,22 @@ struct DefaultConfig {
   template <class A> using TSDRegistryT = TSDRegistryExT<A>; // Exclusive
 };
 
+#if SCUDO_LINUX && !SCUDO_ANDROID
+struct PerCPUConfig {
+  using SizeClassMap = DefaultSizeClassMap;
+#if SCUDO_CAN_USE_PRIMARY64
+  // 1GB Regions
+  typedef SizeClassAllocator64<SizeClassMap, 30U> Primary;
+#else
+  // 512KB regions
+  typedef SizeClassAllocator32<SizeClassMap, 19U> Primary;
+#endif
+  // Shared, one TSD per CPU, up to 256.
+  template <class A>
+  using TSDRegistryT = TSDRegistrySharedT<A, 256U, /*PerCPU=*/true>;
+};
+#endif
+
 struct AndroidConfig {
   using SizeClassMap = AndroidSizeClassMap;
 #if SCUDO_CAN_USE_PRIMARY64
@@ -71,6 +87,8 @@ struct FuchsiaConfig {
 typedef AndroidConfig Config;
 #elif SCUDO_FUCHSIA
 typedef FuchsiaConfig Config;
+#elif SCUDO_PER_CPU_CACHES
+typedef PerCPUConfig Config;
 #else
 typedef DefaultConfig Config;
 #endif
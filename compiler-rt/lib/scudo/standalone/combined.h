@@ -20,8 +20,45 @@
 #include "secondary.h"
 #include "tsd.h"
 
+#include <pthread.h>
+#include <signal.h>
+
+#ifdef GWP_ASAN_HOOKS
+#include "gwp_asan/guarded_pool_allocator.h"
+#include "gwp_asan/optional/backtrace.h"
+#endif // GWP_ASAN_HOOKS
+
 namespace scudo {
 
+#ifdef GWP_ASAN_HOOKS
+// GWP-ASan is a process wide singleton, shared by all the allocators and set up
+// by the first one to be initialised. It requires constant initialisation,
+// which the zero-initialised Allocator can't provide, so it lives in an inline
+// function: the static is then the same in every translation unit, and is
+// accessed without an indirect call.
+INLINE gwp_asan::GuardedPoolAllocator &getGuardedAlloc() {
+  static gwp_asan::GuardedPoolAllocator GuardedAlloc;
+  return GuardedAlloc;
+}
+
+INLINE void initGuardedAllocOnce() {
+  static atomic_u8 Initialized;
+  if (atomic_exchange(&Initialized, 1U, memory_order_acquire))
+    return;
+  gwp_asan::options::Options Opt;
+#define GWP_ASAN_OPTION(Type, Name, DefaultValue, Description)                 \
+  Opt.Name = getFlags()->GWP_ASAN_##Name;
+#include "gwp_asan/options.inc"
+#undef GWP_ASAN_OPTION
+  // The backtrace functions neither allocate nor lock, so they are safe to use
+  // from within the allocator and from the SIGSEGV handler.
+  Opt.Printf = Printf;
+  Opt.Backtrace = gwp_asan::options::getBacktraceFunction();
+  Opt.PrintBacktrace = gwp_asan::options::getPrintBacktraceFunction();
+  getGuardedAlloc().init(Opt);
+}
+#endif // GWP_ASAN_HOOKS
+
 template <class Params> class Allocator {
 public:
   using PrimaryT = typename Params::Primary;
@@ -129,10 +166,19 @@ public:
     Stats.initLinkerInitialized();
     Primary.initLinkerInitialized(getFlags()->release_to_os_interval_ms);
     Secondary.initLinkerInitialized(&Stats);
+    // Creating a thread might allocate, so the release thread is started by the
+    // first call to initThreadMaybe() once we are done.
+    if (getFlags()->release_to_os_in_background &&
+        getFlags()->release_to_os_interval_ms > 0)
+      atomic_store_relaxed(&ReleaseThreadPending, 1U);
 
     Quarantine.init(
         static_cast<uptr>(getFlags()->quarantine_size_kb << 10),
         static_cast<uptr>(getFlags()->thread_local_quarantine_size_kb << 10));
+
+#ifdef GWP_ASAN_HOOKS
+    initGuardedAllocOnce();
+#endif // GWP_ASAN_HOOKS
   }
 
   void reset() { memset(this, 0, sizeof(*this)); }
@@ -170,6 +216,18 @@ public:
     if (Alignment < MinAlignment)
       Alignment = MinAlignment;
 
+#ifdef GWP_ASAN_HOOKS
+    // Guarded allocations are right-aligned to the end of their page, so a
+    // size that is a multiple of the alignment yields an aligned pointer.
+    if (UNLIKELY(getGuardedAlloc().shouldSample())) {
+      if (void *Ptr = getGuardedAlloc().allocate(roundUpTo(Size, Alignment))) {
+        if (&__scudo_allocate_hook)
+          __scudo_allocate_hook(Ptr, Size);
+        return Ptr;
+      }
+    }
+#endif // GWP_ASAN_HOOKS
+
     // If the requested size happens to be 0 (more common than you might think),
     // allocate MinAlignment bytes on top of the header. Then add the extra
     // bytes required to fulfill the alignment requirements: we allocate enough
@@ -259,6 +317,14 @@ public:
 
     if (UNLIKELY(!Ptr))
       return;
+
+#ifdef GWP_ASAN_HOOKS
+    if (UNLIKELY(getGuardedAlloc().pointerIsMine(Ptr))) {
+      getGuardedAlloc().deallocate(Ptr);
+      return;
+    }
+#endif // GWP_ASAN_HOOKS
+
     if (UNLIKELY(!isAligned(reinterpret_cast<uptr>(Ptr), MinAlignment)))
       reportMisalignedPointer(AllocatorAction::Deallocating, Ptr);
 
@@ -293,6 +359,17 @@ public:
     DCHECK_NE(OldPtr, nullptr);
     DCHECK_NE(NewSize, 0);
 
+#ifdef GWP_ASAN_HOOKS
+    if (UNLIKELY(getGuardedAlloc().pointerIsMine(OldPtr))) {
+      const uptr OldSize = getGuardedAlloc().getSize(OldPtr);
+      void *NewPtr = allocate(NewSize, Chunk::Origin::Malloc, Alignment);
+      if (NewPtr)
+        memcpy(NewPtr, OldPtr, Min(NewSize, OldSize));
+      getGuardedAlloc().deallocate(OldPtr);
+      return NewPtr;
+    }
+#endif // GWP_ASAN_HOOKS
+
     if (UNLIKELY(!isAligned(reinterpret_cast<uptr>(OldPtr), MinAlignment)))
       reportMisalignedPointer(AllocatorAction::Reallocating, OldPtr);
 
@@ -403,6 +480,12 @@ public:
     initThreadMaybe();
     if (UNLIKELY(!Ptr))
       return 0;
+
+#ifdef GWP_ASAN_HOOKS
+    if (UNLIKELY(getGuardedAlloc().pointerIsMine(Ptr)))
+      return getGuardedAlloc().getSize(Ptr);
+#endif // GWP_ASAN_HOOKS
+
     Chunk::UnpackedHeader Header;
     Chunk::loadHeader(Cookie, Ptr, &Header);
     // Getting the usable size of a chunk only makes sense if it's allocated.
@@ -438,6 +521,9 @@ private:
   QuarantineT Quarantine;
 
   u32 Cookie;
+  atomic_u8 ReleaseThreadPending;
+  // Next allocator in the list of those with a release thread.
+  ThisT *NextWithReleaseThread;
 
   struct {
     u8 MayReturnNull : 1;       // may_return_null
@@ -500,6 +586,90 @@ private:
 
   ALWAYS_INLINE void initThreadMaybe(bool MinimalInit = false) {
     TSDRegistry.initThreadMaybe(this, MinimalInit);
+    if (UNLIKELY(atomic_load_relaxed(&ReleaseThreadPending)))
+      startReleaseThread();
+  }
+
+  // The release thread lives as long as the process. It blocks all signals,
+  // leaving them to the threads of the application. If it can't be created,
+  // the threads freeing memory keep releasing it.
+  NOINLINE void startReleaseThread() {
+    if (atomic_exchange(&ReleaseThreadPending, 0U, memory_order_relaxed) == 0)
+      return;
+    sigset_t Blocked, Previous;
+    sigfillset(&Blocked);
+    pthread_sigmask(SIG_SETMASK, &Blocked, &Previous);
+    pthread_t Thread;
+    if (pthread_create(&Thread, nullptr, releaseToOSPeriodically, this) == 0) {
+      pthread_detach(Thread);
+      Primary.setReleaseInBackground(true);
+      addToReleaseThreadList();
+    }
+    pthread_sigmask(SIG_SETMASK, &Previous, nullptr);
+  }
+
+  // Allocators with a release thread are kept in a list that is only ever
+  // pushed to, so that the fork handlers can reach them. The handlers are
+  // registered along with the first one.
+  static atomic_uptr *releaseThreadList() {
+    static atomic_uptr Head;
+    return &Head;
+  }
+
+  void addToReleaseThreadList() {
+    // An allocator whose release thread was restarted after a fork is already
+    // in the list.
+    for (ThisT *A = releaseThreadListHead(); A; A = A->NextWithReleaseThread)
+      if (A == this)
+        return;
+    uptr Head = atomic_load(releaseThreadList(), memory_order_relaxed);
+    do {
+      NextWithReleaseThread = reinterpret_cast<ThisT *>(Head);
+    } while (!atomic_compare_exchange_weak(releaseThreadList(), &Head,
+                                           reinterpret_cast<uptr>(this),
+                                           memory_order_release));
+    if (!Head)
+      pthread_atfork(disableBeforeFork, enableAfterForkInParent,
+                     enableAfterForkInChild);
+  }
+
+  static ThisT *releaseThreadListHead() {
+    return reinterpret_cast<ThisT *>(
+        atomic_load(releaseThreadList(), memory_order_acquire));
+  }
+
+  // The release thread may be releasing memory, with a region locked, when
+  // another thread forks. Disabling the allocator waits for it to be done.
+  static void disableBeforeFork() {
+    for (ThisT *A = releaseThreadListHead(); A; A = A->NextWithReleaseThread)
+      A->disable();
+  }
+
+  static void enableAfterForkInParent() {
+    for (ThisT *A = releaseThreadListHead(); A; A = A->NextWithReleaseThread)
+      A->enable();
+  }
+
+  // The release thread doesn't exist in the child. Freed memory is released
+  // inline again until the first call to initThreadMaybe() in the child starts
+  // a new one.
+  static void enableAfterForkInChild() {
+    for (ThisT *A = releaseThreadListHead(); A; A = A->NextWithReleaseThread) {
+      A->Primary.setReleaseInBackground(false);
+      A->enable();
+      atomic_store_relaxed(&A->ReleaseThreadPending, 1U);
+    }
+  }
+
+  static void *releaseToOSPeriodically(void *Arg) {
+    ThisT *Instance = reinterpret_cast<ThisT *>(Arg);
+    const u64 IntervalNs =
+        static_cast<u64>(getFlags()->release_to_os_interval_ms) * 1000000ULL;
+    while (true) {
+      sleepFor(IntervalNs);
+      Instance->Primary.releaseToOS(/*Force=*/false);
+    }
+    return nullptr;
   }
 
   void quarantineOrDeallocateChunk(void *Ptr, Chunk::UnpackedHeader *Header,
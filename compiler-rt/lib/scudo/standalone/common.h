@@ -128,10 +128,16 @@ INLINE uptr getPageSizeCached() {
 
 u32 getNumberOfCPUs();
 
+// Returns the CPU the calling thread is running on, or -1 if it can't be told.
+// The thread might have moved by the time the caller looks at the result.
+s32 getCurrentCPU();
+
 const char *getEnv(const char *Name);
 
 u64 getMonotonicTime();
 
+void sleepFor(u64 Nanoseconds);
+
 // Our randomness gathering function is limited to 256 bytes to ensure we get
 // as many bytes as requested, and avoid interruptions (on Linux).
 constexpr uptr MaxRandomLength = 256U;
@@ -168,8 +168,14 @@ void HybridMutex::unlock() __TA_NO_THREAD_SAFETY_ANALYSIS {
 
 u64 getMonotonicTime() { return _zx_clock_get_monotonic(); }
 
+void sleepFor(u64 Nanoseconds) {
+  _zx_nanosleep(_zx_deadline_after(static_cast<zx_duration_t>(Nanoseconds)));
+}
+
 u32 getNumberOfCPUs() { return _zx_system_get_num_cpus(); }
 
+s32 getCurrentCPU() { return -1; }
+
 bool getRandom(void *Buffer, uptr Length, UNUSED bool Blocking) {
   COMPILER_CHECK(MaxRandomLength <= ZX_CPRNG_DRAW_MAX_LEN);
   if (UNLIKELY(!Buffer || !Length || Length > MaxRandomLength))
@@ -28,6 +28,15 @@
 #include <time.h>
 #include <unistd.h>
 
+// glibc registers every thread for restartable sequences, and through them the
+// kernel keeps the current CPU in a thread local area.
+#if defined(__GLIBC_PREREQ) && defined(__has_include)
+#if __GLIBC_PREREQ(2, 35) && __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define SCUDO_HAS_RSEQ 1
+#endif
+#endif
+
 #if SCUDO_ANDROID
 #include <sys/prctl.h>
 // Definitions of prctl arguments to set a vma name in Android kernels.
@@ -122,12 +131,39 @@ u64 getMonotonicTime() {
          static_cast<u64>(TS.tv_nsec);
 }
 
+void sleepFor(u64 Nanoseconds) {
+  timespec TS;
+  TS.tv_sec = static_cast<time_t>(Nanoseconds / (1000ULL * 1000 * 1000));
+  TS.tv_nsec = static_cast<long>(Nanoseconds % (1000ULL * 1000 * 1000));
+  while (nanosleep(&TS, &TS) != 0 && errno == EINTR) {
+  }
+}
+
 u32 getNumberOfCPUs() {
   cpu_set_t CPUs;
   CHECK_EQ(sched_getaffinity(0, sizeof(cpu_set_t), &CPUs), 0);
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+s32 getCurrentCPU() {
+#if SCUDO_HAS_RSEQ && defined(__has_builtin)
+#if __has_builtin(__builtin_thread_pointer)
+  // The area is registered unless glibc was told not to, in which case its
+  // size is 0. Reading from it saves the getcpu call.
+  if (LIKELY(__rseq_size > 0)) {
+    const struct rseq *Rseq = reinterpret_cast<const struct rseq *>(
+        reinterpret_cast<uptr>(__builtin_thread_pointer()) +
+        static_cast<uptr>(__rseq_offset));
+    const s32 CPU = static_cast<s32>(
+        __atomic_load_n(&Rseq->cpu_id, __ATOMIC_RELAXED));
+    if (LIKELY(CPU >= 0))
+      return CPU;
+  }
+#endif
+#endif
+  return sched_getcpu();
+}
+
 // Blocking is possibly unused if the getrandom block is not compiled in.
 bool getRandom(void *Buffer, uptr Length, UNUSED bool Blocking) {
   if (!Buffer || !Length || Length > MaxRandomLength)
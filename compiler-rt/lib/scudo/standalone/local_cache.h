@@ -151,15 +151,27 @@ private:
       deallocate(SizeClassMap::BatchClassId, B);
   }
 
+  // A batch holds at most half of what a class caches, so an empty cache takes
+  // two of them, which the Primary hands over under one lock.
+  static const u32 MaxRefillBatches = 2U;
+
   NOINLINE bool refill(PerClass *C, uptr ClassId) {
     initCacheMaybe(C);
-    TransferBatch *B = Allocator->popBatch(this, ClassId);
-    if (UNLIKELY(!B))
+    TransferBatch *Batches[MaxRefillBatches];
+    const u32 N =
+        Allocator->popBatches(this, ClassId, Batches, MaxRefillBatches);
+    if (UNLIKELY(N == 0))
       return false;
-    DCHECK_GT(B->getCount(), 0);
-    C->Count = B->getCount();
-    B->copyToArray(C->Chunks);
-    destroyBatch(ClassId, B);
+    // Copy every batch out before destroying any of them: for the batch class,
+    // a batch lives in one of the blocks it holds.
+    for (u32 I = 0; I < N; I++) {
+      DCHECK_GT(Batches[I]->getCount(), 0);
+      DCHECK_LE(C->Count + Batches[I]->getCount(), C->MaxCount);
+      Batches[I]->copyToArray(&C->Chunks[C->Count]);
+      C->Count += Batches[I]->getCount();
+    }
+    for (u32 I = 0; I < N; I++)
+      destroyBatch(ClassId, Batches[I]);
     return true;
   }
 
@@ -51,6 +51,13 @@
 #define SCUDO_MIN_ALIGNMENT_LOG FIRST_32_SECOND_64(3, 4)
 #endif
 
+#ifndef SCUDO_PER_CPU_CACHES
+// Share one cache per CPU between all threads instead of giving each thread
+// its own, which bounds the memory held in caches by processes running many
+// more threads than there are CPUs.
+#define SCUDO_PER_CPU_CACHES 0
+#endif
+
 #if defined(__aarch64__)
 #define SCUDO_MMAP_RANGE_SIZE FIRST_32_SECOND_64(1ULL << 32, 1ULL << 48)
 #else
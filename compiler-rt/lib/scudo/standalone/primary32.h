@@ -83,6 +83,12 @@ public:
     initLinkerInitialized(ReleaseToOsInterval);
   }
 
+  // Leaves releasing memory to periodic calls to releaseToOS(/*Force=*/false)
+  // rather than trying it whenever blocks are freed.
+  void setReleaseInBackground(bool Enabled) {
+    atomic_store_relaxed(&ReleaseInBackground, Enabled ? 1U : 0U);
+  }
+
   void unmapTestOnly() {
     while (NumberOfStashedRegions > 0)
       unmap(reinterpret_cast<void *>(RegionsStash[--NumberOfStashedRegions]),
@@ -95,20 +101,35 @@ public:
   }
 
   TransferBatch *popBatch(CacheT *C, uptr ClassId) {
+    TransferBatch *B;
+    return popBatches(C, ClassId, &B, 1U) ? B : nullptr;
+  }
+
+  // Pops up to MaxBatches batches under a single lock, and returns how many
+  // were popped. The free list is only populated when it's empty to begin
+  // with, so a 0 return means we are out of memory.
+  u32 popBatches(CacheT *C, uptr ClassId, TransferBatch **Batches,
+                 u32 MaxBatches) {
     DCHECK_LT(ClassId, NumClasses);
+    DCHECK_GT(MaxBatches, 0U);
     SizeClassInfo *Sci = getSizeClassInfo(ClassId);
     ScopedLock L(Sci->Mutex);
-    TransferBatch *B = Sci->FreeList.front();
-    if (B) {
-      Sci->FreeList.pop_front();
-    } else {
-      B = populateFreeList(C, ClassId, Sci);
+    u32 N = 0;
+    if (Sci->FreeList.empty()) {
+      TransferBatch *B = populateFreeList(C, ClassId, Sci);
       if (UNLIKELY(!B))
-        return nullptr;
+        return 0;
+      Batches[N++] = B;
     }
-    DCHECK_GT(B->getCount(), 0);
-    Sci->Stats.PoppedBlocks += B->getCount();
-    return B;
+    while (N < MaxBatches && !Sci->FreeList.empty()) {
+      Batches[N++] = Sci->FreeList.front();
+      Sci->FreeList.pop_front();
+    }
+    for (u32 I = 0; I < N; I++) {
+      DCHECK_GT(Batches[I]->getCount(), 0);
+      Sci->Stats.PoppedBlocks += Batches[I]->getCount();
+    }
+    return N;
   }
 
   void pushBatch(uptr ClassId, TransferBatch *B) {
@@ -118,7 +139,7 @@ public:
     ScopedLock L(Sci->Mutex);
     Sci->FreeList.push_front(B);
     Sci->Stats.PushedBlocks += B->getCount();
-    if (Sci->CanRelease)
+    if (Sci->CanRelease && !atomic_load_relaxed(&ReleaseInBackground))
       releaseToOSMaybe(Sci, ClassId);
   }
 
@@ -161,13 +182,16 @@ public:
       printStats(I, 0);
   }
 
-  void releaseToOS() {
+  // Unless forced, skips the size classes released within the last interval.
+  void releaseToOS(bool Force = true) {
     for (uptr I = 0; I < NumClasses; I++) {
       if (I == SizeClassMap::BatchClassId)
         continue;
       SizeClassInfo *Sci = getSizeClassInfo(I);
+      if (!Force && !Sci->CanRelease)
+        continue;
       ScopedLock L(Sci->Mutex);
-      releaseToOSMaybe(Sci, I, /*Force=*/true);
+      releaseToOSMaybe(Sci, I, Force);
     }
   }
 
@@ -354,16 +378,9 @@ private:
       return; // Nothing new to release.
     }
 
-    if (!Force) {
-      const s32 IntervalMs = ReleaseToOsIntervalMs;
-      if (IntervalMs < 0)
-        return;
-      if (Sci->ReleaseInfo.LastReleaseAtNs +
-              static_cast<uptr>(IntervalMs) * 1000000ULL >
-          getMonotonicTime()) {
-        return; // Memory was returned recently.
-      }
-    }
+    if (!Force && !isReleaseDue(Sci->ReleaseInfo.LastReleaseAtNs,
+                                ReleaseToOsIntervalMs, getMonotonicTime()))
+      return; // Memory was returned recently.
 
     // TODO(kostyak): currently not ideal as we loop over all regions and
     // iterate multiple times over the same freelist if a ClassId spans multiple
@@ -391,6 +408,7 @@ private:
   uptr MinRegionIndex;
   uptr MaxRegionIndex;
   s32 ReleaseToOsIntervalMs;
+  atomic_u8 ReleaseInBackground;
   // Unless several threads request regions simultaneously from different size
   // classes, the stash rarely contains more than 1 entry.
   static constexpr uptr MaxStashedRegions = 4;
@@ -91,6 +91,12 @@ public:
     initLinkerInitialized(ReleaseToOsInterval);
   }
 
+  // Leaves releasing memory to periodic calls to releaseToOS(/*Force=*/false)
+  // rather than trying it whenever blocks are freed.
+  void setReleaseInBackground(bool Enabled) {
+    atomic_store_relaxed(&ReleaseInBackground, Enabled ? 1U : 0U);
+  }
+
   void unmapTestOnly() {
     unmap(reinterpret_cast<void *>(PrimaryBase), PrimarySize, UNMAP_ALL, &Data);
     unmap(reinterpret_cast<void *>(RegionInfoArray),
@@ -98,20 +104,35 @@ public:
   }
 
   TransferBatch *popBatch(CacheT *C, uptr ClassId) {
+    TransferBatch *B;
+    return popBatches(C, ClassId, &B, 1U) ? B : nullptr;
+  }
+
+  // Pops up to MaxBatches batches under a single lock, and returns how many
+  // were popped. The free list is only populated when it's empty to begin
+  // with, so a 0 return means we are out of memory.
+  u32 popBatches(CacheT *C, uptr ClassId, TransferBatch **Batches,
+                 u32 MaxBatches) {
     DCHECK_LT(ClassId, NumClasses);
+    DCHECK_GT(MaxBatches, 0U);
     RegionInfo *Region = getRegionInfo(ClassId);
     ScopedLock L(Region->Mutex);
-    TransferBatch *B = Region->FreeList.front();
-    if (B) {
-      Region->FreeList.pop_front();
-    } else {
-      B = populateFreeList(C, ClassId, Region);
+    u32 N = 0;
+    if (Region->FreeList.empty()) {
+      TransferBatch *B = populateFreeList(C, ClassId, Region);
       if (UNLIKELY(!B))
-        return nullptr;
+        return 0;
+      Batches[N++] = B;
     }
-    DCHECK_GT(B->getCount(), 0);
-    Region->Stats.PoppedBlocks += B->getCount();
-    return B;
+    while (N < MaxBatches && !Region->FreeList.empty()) {
+      Batches[N++] = Region->FreeList.front();
+      Region->FreeList.pop_front();
+    }
+    for (u32 I = 0; I < N; I++) {
+      DCHECK_GT(Batches[I]->getCount(), 0);
+      Region->Stats.PoppedBlocks += Batches[I]->getCount();
+    }
+    return N;
   }
 
   void pushBatch(uptr ClassId, TransferBatch *B) {
@@ -120,7 +141,7 @@ public:
     ScopedLock L(Region->Mutex);
     Region->FreeList.push_front(B);
     Region->Stats.PushedBlocks += B->getCount();
-    if (Region->CanRelease)
+    if (Region->CanRelease && !atomic_load_relaxed(&ReleaseInBackground))
       releaseToOSMaybe(Region, ClassId);
   }
 
@@ -167,13 +188,16 @@ public:
       printStats(I, 0);
   }
 
-  void releaseToOS() {
+  // Unless forced, skips the size classes released within the last interval.
+  void releaseToOS(bool Force = true) {
     for (uptr I = 0; I < NumClasses; I++) {
       if (I == SizeClassMap::BatchClassId)
         continue;
       RegionInfo *Region = getRegionInfo(I);
+      if (!Force && !Region->CanRelease)
+        continue;
       ScopedLock L(Region->Mutex);
-      releaseToOSMaybe(Region, I, /*Force=*/true);
+      releaseToOSMaybe(Region, I, Force);
     }
   }
 
@@ -216,6 +240,7 @@ private:
   RegionInfo *RegionInfoArray;
   MapPlatformData Data;
   s32 ReleaseToOsIntervalMs;
+  atomic_u8 ReleaseInBackground;
 
   RegionInfo *getRegionInfo(uptr ClassId) const {
     DCHECK_LT(ClassId, NumClasses);
@@ -354,16 +379,9 @@ private:
       return; // Nothing new to release.
     }
 
-    if (!Force) {
-      const s32 IntervalMs = ReleaseToOsIntervalMs;
-      if (IntervalMs < 0)
-        return;
-      if (Region->ReleaseInfo.LastReleaseAtNs +
-              static_cast<uptr>(IntervalMs) * 1000000ULL >
-          getMonotonicTime()) {
-        return; // Memory was returned recently.
-      }
-    }
+    if (!Force && !isReleaseDue(Region->ReleaseInfo.LastReleaseAtNs,
+                                ReleaseToOsIntervalMs, getMonotonicTime()))
+      return; // Memory was returned recently.
 
     ReleaseRecorder Recorder(Region->RegionBeg, &Region->Data);
     releaseFreeMemoryToOS(&Region->FreeList, Region->RegionBeg,
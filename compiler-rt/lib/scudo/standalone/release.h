@@ -14,6 +14,15 @@
 
 namespace scudo {
 
+// Releases are at least IntervalMs apart, so that a size class going back and
+// forth around a page boundary doesn't pay for a release and the page faults
+// that follow each time. Negative intervals only allow forced releases.
+INLINE bool isReleaseDue(u64 LastReleaseAtNs, s32 IntervalMs, u64 Now) {
+  if (IntervalMs < 0)
+    return false;
+  return LastReleaseAtNs + static_cast<u64>(IntervalMs) * 1000000ULL <= Now;
+}
+
 class ReleaseRecorder {
 public:
   ReleaseRecorder(uptr BaseAddress, MapPlatformData *Data = nullptr)
@@ -15,6 +15,11 @@
 #include <mutex>
 #include <thread>
 
+#if SCUDO_LINUX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 static std::mutex Mutex;
 static std::condition_variable Cv;
 static bool Ready = false;
@@ -25,7 +30,10 @@ static constexpr scudo::Chunk::Origin Origin = scudo::Chunk::Origin::Malloc;
 // parameters are on the low end, to avoid having to loop excessively in some
 // tests.
 static bool UseQuarantine = false;
+static bool UseReleaseThread = false;
 extern "C" const char *__scudo_default_options() {
+  if (UseReleaseThread)
+    return "release_to_os_in_background=1:release_to_os_interval_ms=1";
   if (!UseQuarantine)
     return "";
   return "quarantine_size_kb=256:thread_local_quarantine_size_kb=128:"
@@ -128,6 +136,9 @@ TEST(ScudoCombinedTest, BasicCombined) {
   testAllocator<scudo::DefaultConfig>();
 #if SCUDO_WORDSIZE == 64U
   testAllocator<scudo::FuchsiaConfig>();
+#endif
+#if SCUDO_LINUX && !SCUDO_ANDROID
+  testAllocator<scudo::PerCPUConfig>();
 #endif
   // The following configs should work on all platforms.
   UseQuarantine = true;
@@ -183,6 +194,9 @@ TEST(ScudoCombinedTest, ThreadedCombined) {
   testAllocatorThreaded<scudo::DefaultConfig>();
 #if SCUDO_WORDSIZE == 64U
   testAllocatorThreaded<scudo::FuchsiaConfig>();
+#endif
+#if SCUDO_LINUX && !SCUDO_ANDROID
+  testAllocatorThreaded<scudo::PerCPUConfig>();
 #endif
   UseQuarantine = true;
   testAllocatorThreaded<scudo::AndroidConfig>();
@@ -235,3 +249,85 @@ TEST(ScudoCombinedTest, DeathCombined) {
   EXPECT_DEATH(Allocator->reallocate(P, Size * 2U), "");
   EXPECT_DEATH(Allocator->getUsableSize(P), "");
 }
+
+#ifdef GWP_ASAN_HOOKS
+// A distinct type, so that the thread local caches of the allocators created by
+// the other tests on this thread aren't reused.
+struct GuardedConfig : scudo::DefaultConfig {};
+
+TEST(ScudoCombinedTest, GuardedAllocations) {
+  using AllocatorT = scudo::Allocator<GuardedConfig>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  Allocator->reset();
+  gwp_asan::GuardedPoolAllocator &GuardedAlloc = scudo::getGuardedAlloc();
+
+  // Allocations are sampled at random, so keep allocating until one is.
+  const scudo::uptr Size = 123U;
+  void *P = nullptr;
+  for (scudo::uptr I = 0; I < 1000000U && !P; I++) {
+    void *Q = Allocator->allocate(Size, Origin);
+    EXPECT_NE(Q, nullptr);
+    if (GuardedAlloc.pointerIsMine(Q))
+      P = Q;
+    else
+      Allocator->deallocate(Q, Origin);
+  }
+  ASSERT_NE(P, nullptr);
+  EXPECT_LE(Size, Allocator->getUsableSize(P));
+  memset(P, 0xaa, Size);
+
+  // Reallocating always moves the contents to a new chunk.
+  void *NewP = Allocator->reallocate(P, Size * 2U);
+  EXPECT_NE(NewP, nullptr);
+  EXPECT_NE(NewP, P);
+  for (scudo::uptr I = 0; I < Size; I++)
+    EXPECT_EQ(reinterpret_cast<unsigned char *>(NewP)[I], 0xaa);
+  Allocator->deallocate(NewP, Origin);
+
+  // The guarded allocation is gone, and using it is reported.
+  EXPECT_DEATH(reinterpret_cast<volatile char *>(P)[0] = 0,
+               "Use after free");
+}
+#endif // GWP_ASAN_HOOKS
+
+#if SCUDO_LINUX
+struct ReleaseThreadConfig : scudo::DefaultConfig {};
+
+// The release thread may be releasing memory when the process forks. The child
+// must still be able to allocate and free, and to restart the thread.
+TEST(ScudoCombinedTest, ForkWithReleaseThread) {
+  using AllocatorT = scudo::Allocator<ReleaseThreadConfig>;
+  // The release thread uses the allocator for as long as the process lives.
+  AllocatorT *Allocator = new AllocatorT;
+  UseReleaseThread = true;
+  Allocator->reset();
+  UseReleaseThread = false;
+
+  auto Churn = [Allocator]() {
+    std::vector<void *> V;
+    for (scudo::uptr I = 0; I < 1000U; I++)
+      V.push_back(Allocator->allocate(1U << (I % 12), Origin));
+    for (void *P : V)
+      Allocator->deallocate(P, Origin);
+  };
+  for (scudo::uptr I = 0; I < 20U; I++) {
+    Churn();
+    const pid_t Pid = fork();
+    ASSERT_GE(Pid, 0);
+    if (Pid == 0) {
+      Churn();
+      Churn();
+      _exit(0);
+    }
+    int Status;
+    ASSERT_EQ(waitpid(Pid, &Status, 0), Pid);
+    EXPECT_TRUE(WIFEXITED(Status));
+    EXPECT_EQ(WEXITSTATUS(Status), 0);
+  }
+}
+#endif // SCUDO_LINUX
@@ -91,6 +91,37 @@ TEST(ScudoPrimaryTest, Primary64OOM) {
   Allocator.unmapTestOnly();
 }
 
+template <typename Primary> static void testPopBatches() {
+  using TransferBatch = typename Primary::CacheT::TransferBatch;
+  auto Deleter = [](Primary *P) {
+    P->unmapTestOnly();
+    delete P;
+  };
+  std::unique_ptr<Primary, decltype(Deleter)> Allocator(new Primary, Deleter);
+  Allocator->init(/*ReleaseToOsInterval=*/-1);
+  typename Primary::CacheT Cache;
+  Cache.init(nullptr, Allocator.get());
+  const scudo::uptr ClassId = Primary::SizeClassMap::getClassIdBySize(64U);
+  // Populating the free list leaves batches on it, so a second one is there
+  // for the taking.
+  TransferBatch *Batches[2];
+  EXPECT_EQ(Allocator->popBatches(&Cache, ClassId, Batches, 2U), 2U);
+  EXPECT_NE(Batches[0], Batches[1]);
+  for (TransferBatch *B : Batches) {
+    EXPECT_GT(B->getCount(), 0U);
+    EXPECT_LE(B->getCount(), TransferBatch::getMaxCached(64U));
+  }
+  for (TransferBatch *B : Batches)
+    Allocator->pushBatch(ClassId, B);
+  Cache.destroy(nullptr);
+}
+
+TEST(ScudoPrimaryTest, PrimaryPopBatches) {
+  using SizeClassMap = scudo::DefaultSizeClassMap;
+  testPopBatches<scudo::SizeClassAllocator32<SizeClassMap, 18U>>();
+  testPopBatches<scudo::SizeClassAllocator64<SizeClassMap, 24U>>();
+}
+
 template <typename Primary> static void testIteratePrimary() {
   auto Deleter = [](Primary *P) {
     P->unmapTestOnly();
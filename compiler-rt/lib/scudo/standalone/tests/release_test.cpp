@@ -17,6 +17,16 @@
 #include <algorithm>
 #include <random>
 
+TEST(ScudoReleaseTest, IsReleaseDue) {
+  const scudo::u64 LastReleaseAtNs = 1000000000ULL;
+  EXPECT_FALSE(scudo::isReleaseDue(LastReleaseAtNs, -1, ~0ULL));
+  EXPECT_TRUE(scudo::isReleaseDue(LastReleaseAtNs, 0, LastReleaseAtNs));
+  EXPECT_FALSE(
+      scudo::isReleaseDue(LastReleaseAtNs, 10, LastReleaseAtNs + 9999999ULL));
+  EXPECT_TRUE(
+      scudo::isReleaseDue(LastReleaseAtNs, 10, LastReleaseAtNs + 10000000ULL));
+}
+
 TEST(ScudoReleaseTest, PackedCounterArray) {
   for (scudo::uptr I = 0; I < SCUDO_WORDSIZE; I++) {
     // Various valid counter's max values packed into one word.
@@ -16,7 +16,11 @@
 
 namespace scudo {
 
-template <class Allocator, u32 MaxTSDCount> struct TSDRegistrySharedT {
+// With PerCPU, a thread uses the TSD of the CPU it is running on rather than
+// the one it was last assigned, so that threads only contend for a TSD when
+// one gets preempted or migrated while holding it.
+template <class Allocator, u32 MaxTSDCount, bool PerCPU = false>
+struct TSDRegistrySharedT {
   void initLinkerInitialized(Allocator *Instance) {
     Instance->initLinkerInitialized();
     CHECK_EQ(pthread_key_create(&PThreadKey, nullptr), 0); // For non-TLS
@@ -60,7 +64,7 @@ template <class Allocator, u32 MaxTSDCount> struct TSDRegistrySharedT {
   }
 
   ALWAYS_INLINE TSD<Allocator> *getTSDAndLock(bool *UnlockRequired) {
-    TSD<Allocator> *TSD = getCurrentTSD();
+    TSD<Allocator> *TSD = PerCPU ? getCPUTSD() : getCurrentTSD();
     DCHECK(TSD);
     *UnlockRequired = true;
     // Try to lock the currently associated context.
@@ -93,6 +97,15 @@ private:
 #endif
   }
 
+  // The current TSD still serves when the CPU can't be told.
+  ALWAYS_INLINE TSD<Allocator> *getCPUTSD() {
+    const s32 CPU = getCurrentCPU();
+    if (UNLIKELY(CPU < 0))
+      return getCurrentTSD();
+    const u32 Index = static_cast<u32>(CPU);
+    return &TSDs[LIKELY(Index < NumberOfTSDs) ? Index : Index % NumberOfTSDs];
+  }
+
   void initOnceMaybe(Allocator *Instance) {
     ScopedLock L(Mutex);
     if (LIKELY(Initialized))
@@ -158,9 +171,9 @@ private:
 };
 
 #if SCUDO_LINUX && !SCUDO_ANDROID
-template <class Allocator, u32 MaxTSDCount>
+template <class Allocator, u32 MaxTSDCount, bool PerCPU>
 THREADLOCAL TSD<Allocator>
-    *TSDRegistrySharedT<Allocator, MaxTSDCount>::ThreadTSD;
+    *TSDRegistrySharedT<Allocator, MaxTSDCount, PerCPU>::ThreadTSD;
 #endif
 
 } // namespace scudo
@@ -0,0 +1,87 @@
+// Mini-benchmark for a large pool of threads sharing a work queue.
+// Idea:
+// 1) Spawn N worker threads that all stay alive for the whole run.
+// 2) The workers pop work items off a single mutex-protected queue,
+//    and every item touches a little of a shared array under a second mutex.
+// 3) Report the time it took, and the peak memory usage.
+//
+// Every lock/unlock pair is an acquire and a release of a vector clock with an
+// element per thread, and every thread keeps its own clock and trace, so both
+// the time and the memory usage grow with N under tsan.
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+int n_threads, n_items;
+
+pthread_mutex_t queue_mu = PTHREAD_MUTEX_INITIALIZER;
+int next_item;
+
+const int kNumSlots = 4096;
+pthread_mutex_t data_mu = PTHREAD_MUTEX_INITIALIZER;
+long data[kNumSlots];
+
+pthread_barrier_t all_threads_ready;
+
+void *Worker(void *unused) {
+  pthread_barrier_wait(&all_threads_ready);
+  for (;;) {
+    pthread_mutex_lock(&queue_mu);
+    int item = next_item < n_items ? next_item++ : -1;
+    pthread_mutex_unlock(&queue_mu);
+    if (item < 0)
+      break;
+    pthread_mutex_lock(&data_mu);
+    for (int i = 0; i < 8; i++)
+      data[(item * 8 + i) % kNumSlots] += item;
+    pthread_mutex_unlock(&data_mu);
+  }
+  return 0;
+}
+
+double Now() {
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+int main(int argc, char **argv) {
+  if (argc == 1) {
+    n_threads = 500;
+    n_items = 1000000;
+  } else if (argc == 3) {
+    n_threads = atoi(argv[1]);
+    assert(n_threads > 0 && n_threads <= 7000);
+    n_items = atoi(argv[2]);
+  } else {
+    printf("Usage: %s n_threads n_items\n", argv[0]);
+    return 1;
+  }
+  printf("%s: n_threads=%d n_items=%d\n", __FILE__, n_threads, n_items);
+
+  pthread_barrier_init(&all_threads_ready, NULL, n_threads + 1);
+
+  double start = Now();
+  pthread_t *t = new pthread_t[n_threads];
+  for (int i = 0; i < n_threads; i++) {
+    int status = pthread_create(&t[i], 0, Worker, NULL);
+    assert(status == 0);
+  }
+  double started = Now();
+  pthread_barrier_wait(&all_threads_ready);
+  for (int i = 0; i < n_threads; i++) {
+    pthread_join(t[i], 0);
+  }
+  double done = Now();
+  delete [] t;
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  printf("start: %.3fs, work: %.3fs, max rss: %ldMB\n", started - start,
+         done - started, usage.ru_maxrss / 1024);
+  return 0;
+}
@@ -15,7 +15,8 @@
 
 // SyncClock and ThreadClock implement vector clocks for sync variables
 // (mutexes, atomic variables, file descriptors, etc) and threads, respectively.
-// ThreadClock contains fixed-size vector clock for maximum number of threads.
+// ThreadClock contains fixed-size vector clock for maximum number of threads,
+// of which only the elements up to the largest tid seen are ever touched.
 // SyncClock contains growable vector clock for currently necessary number of
 // threads.
 // Together they implement very simple model of operations, namely:
@@ -82,6 +83,8 @@
 
 namespace __tsan {
 
+static const uptr kClockTableSize = kMaxTidInClock * sizeof(u64);
+
 static atomic_uint32_t *ref_ptr(ClockBlock *cb) {
   return reinterpret_cast<atomic_uint32_t *>(&cb->table[ClockBlock::kRefIdx]);
 }
@@ -114,7 +117,12 @@ ThreadClock::ThreadClock(unsigned tid, unsigned reused)
   CHECK_EQ(reused_, ((u64)reused_ << kClkBits) >> kClkBits);
   nclk_ = tid_ + 1;
   last_acquire_ = 0;
-  internal_memset(clk_, 0, sizeof(clk_));
+  // Fresh pages are zeroed, and stay unpopulated until they are written.
+  clk_ = (u64 *)MmapOrDie(kClockTableSize, "ThreadClock");
+}
+
+ThreadClock::~ThreadClock() {
+  UnmapOrDie(clk_, kClockTableSize);
 }
 
 void ThreadClock::ResetCached(ClockCache *c) {
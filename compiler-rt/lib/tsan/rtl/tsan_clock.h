@@ -126,6 +126,7 @@ class ThreadClock {
   typedef DenseSlabAllocCache Cache;
 
   explicit ThreadClock(unsigned tid, unsigned reused = 0);
+  ~ThreadClock();
 
   u64 get(unsigned tid) const;
   void set(ClockCache *c, unsigned tid, u64 v);
@@ -161,7 +162,13 @@ class ThreadClock {
 
   // Number of active elements in the clk_ table (the rest is zeros).
   uptr nclk_;
-  u64 clk_[kMaxTidInClock];  // Fixed size vector clock.
+  // Fixed size vector clock for kMaxTidInClock threads. It is mapped
+  // separately rather than embedded, so that a thread only pays for the pages
+  // covering the first nclk_ elements.
+  u64 *clk_;
+
+  ThreadClock(const ThreadClock &) = delete;
+  void operator=(const ThreadClock &) = delete;
 
   bool IsAlreadyAcquired(const SyncClock *src) const;
   void UpdateCurrentThread(ClockCache *c, SyncClock *dst) const;
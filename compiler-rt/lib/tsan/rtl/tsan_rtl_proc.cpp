@@ -18,8 +18,9 @@
 namespace __tsan {
 
 Processor *ProcCreate() {
-  void *mem = InternalAlloc(sizeof(Processor));
-  internal_memset(mem, 0, sizeof(Processor));
+  // The allocator caches are large but mostly unused by any one thread;
+  // fresh zeroed pages keep the untouched parts of them unpopulated.
+  void *mem = MmapOrDie(sizeof(Processor), "Processor");
   Processor *proc = new(mem) Processor;
   proc->thr = nullptr;
 #if !SANITIZER_GO
@@ -40,7 +41,7 @@ void ProcDestroy(Processor *proc) {
   if (common_flags()->detect_deadlocks)
      ctx->dd->DestroyPhysicalThread(proc->dd_pt);
   proc->~Processor();
-  InternalFree(proc);
+  UnmapOrDie(proc, sizeof(Processor));
 }
 
 void ProcWire(Processor *proc, ThreadState *thr) {
@@ -29,6 +29,10 @@ template <size_t Version = 5> class FDRController {
   int (*WallClockReader)(clockid_t, struct timespec *) = 0;
   uint64_t CycleThreshold = 0;
 
+  // When set, gets to see every buffer that fills up, before it goes back to
+  // the queue.
+  void (*BufferSink)(const BufferQueue::Buffer &) = nullptr;
+
   uint64_t LastFunctionEntryTSC = 0;
   uint64_t LatestTSC = 0;
   uint16_t LatestCPU = 0;
@@ -111,6 +115,9 @@ template <size_t Version = 5> class FDRController {
       return returnBuffer();
 
     if (UNLIKELY(!hasSpace(S))) {
+      if (BufferSink != nullptr && B.Data != nullptr &&
+          B.Generation == BQ->generation())
+        BufferSink(B);
       if (!returnBuffer())
         return false;
       if (!getNewBuffer())
@@ -234,12 +241,14 @@ template <size_t Version = 5> class FDRController {
 public:
   template <class WallClockFunc>
   FDRController(BufferQueue *BQ, BufferQueue::Buffer &B, FDRLogWriter &W,
-                WallClockFunc R, uint64_t C) XRAY_NEVER_INSTRUMENT
-      : BQ(BQ),
+                WallClockFunc R, uint64_t C,
+                void (*Sink)(const BufferQueue::Buffer &) = nullptr)
+      XRAY_NEVER_INSTRUMENT : BQ(BQ),
         B(B),
         W(W),
         WallClockReader(R),
-        CycleThreshold(C) {}
+        CycleThreshold(C),
+        BufferSink(Sink) {}
 
   bool functionEnter(int32_t FuncId, uint64_t TSC,
                      uint16_t CPU) XRAY_NEVER_INSTRUMENT {
@@ -81,11 +81,13 @@ class FDRLogWriter {
   template <class T> void writeRecord(const T &R) {
     internal_memcpy(NextRecord, reinterpret_cast<const char *>(&R), sizeof(T));
     NextRecord += sizeof(T);
-    // We need this atomic fence here to ensure that other threads attempting to
-    // read the bytes in the buffer will see the writes committed before the
-    // extents are updated.
-    atomic_thread_fence(memory_order_release);
-    atomic_fetch_add(Buffer.Extents, sizeof(T), memory_order_acq_rel);
+    // Only the thread holding the buffer ever changes its extents, so a
+    // release store is enough for other threads attempting to read the bytes
+    // in the buffer to see the writes committed before the extents are
+    // updated, without a locked read-modify-write for every record.
+    atomic_store(Buffer.Extents,
+                 atomic_load_relaxed(Buffer.Extents) + sizeof(T),
+                 memory_order_release);
   }
 
 public:
@@ -221,7 +223,8 @@ public:
   void undoWrites(size_t B) {
     DCHECK_GE(NextRecord - B, reinterpret_cast<char *>(Buffer.Data));
     NextRecord -= B;
-    atomic_fetch_sub(Buffer.Extents, B, memory_order_acq_rel);
+    atomic_store(Buffer.Extents, atomic_load_relaxed(Buffer.Extents) - B,
+                 memory_order_release);
   }
 
 }; // namespace __xray
@@ -19,7 +19,10 @@
 #include <limits>
 #include <memory>
 #include <pthread.h>
+#include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -76,6 +79,12 @@ static_assert(std::is_trivially_destructible<ThreadLocalData>::value,
 // Use a global pthread key to identify thread-local data for logging.
 static pthread_key_t Key;
 
+// Whether this thread's data is set up and registered with Key. The key's
+// destructor clears it, so that a thread still running instrumented code after
+// that (e.g. in other thread-local destructors) registers its data again. This
+// spares the handlers a pthread_getspecific(...) call on every event.
+static thread_local bool TLDRegistered = false;
+
 // Global BufferQueue.
 static std::aligned_storage<sizeof(BufferQueue)>::type BufferQueueStorage;
 static BufferQueue *BQ = nullptr;
@@ -86,6 +95,20 @@ static atomic_uint64_t ThresholdTicks{0};
 // Global for ticks per second.
 static atomic_uint64_t TicksPerSec{0};
 
+// Whether the TSC can be read, probed once when FDR mode is first initialized.
+// The handlers are only installed after that, so they can read it without a
+// pthread_once(...) of their own.
+static atomic_uint8_t TSCSupported{0};
+
+// Socket that buffers are streamed to as they fill up, if the stream_socket
+// flag names one, and -1 otherwise. The socket is shut down on flush but only
+// closed on the next initialization, so that a thread that is late to notice
+// the flush can't send to a file descriptor that has been reused since.
+static atomic_sint32_t StreamFd = {-1};
+
+// Number of buffers that couldn't be streamed.
+static atomic_uint64_t StreamDropped{0};
+
 static atomic_sint32_t LogFlushStatus = {
     XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING};
 
@@ -131,9 +154,10 @@ static ThreadLocalData &getThreadLocalData() {
   thread_local typename std::aligned_storage<
       sizeof(ThreadLocalData), alignof(ThreadLocalData)>::type TLDStorage{};
 
-  if (pthread_getspecific(Key) == NULL) {
+  if (UNLIKELY(!TLDRegistered)) {
     new (reinterpret_cast<ThreadLocalData *>(&TLDStorage)) ThreadLocalData{};
     pthread_setspecific(Key, &TLDStorage);
+    TLDRegistered = true;
   }
 
   return *reinterpret_cast<ThreadLocalData *>(&TLDStorage);
@@ -172,6 +196,78 @@ static XRayFileHeader &fdrCommonHeaderInfo() {
   return reinterpret_cast<XRayFileHeader &>(HStorage);
 }
 
+// Sends the records in B as a single message, laid out like a buffer in a log
+// file: a BufferExtents record followed by the records themselves. A reader
+// that prepends the header sent on connection sees a valid FDR log. Sending
+// never blocks; when the reader falls behind, the buffer stays in the queue as
+// it would without streaming. Once sent, the buffer's extents are reset so
+// that a flush doesn't write the records out again.
+static void streamBuffer(const BufferQueue::Buffer &B) XRAY_NEVER_INSTRUMENT {
+  int Fd = atomic_load(&StreamFd, memory_order_acquire);
+  if (Fd < 0)
+    return;
+
+  uint64_t BufferExtents = atomic_load(B.Extents, memory_order_acquire);
+  if (BufferExtents == 0)
+    return;
+
+  auto ExtentsRecord =
+      createMetadataRecord<MetadataRecord::RecordKinds::BufferExtents>(
+          BufferExtents);
+  iovec Parts[] = {{&ExtentsRecord, sizeof(ExtentsRecord)},
+                   {B.Data, BufferExtents}};
+  msghdr Message{};
+  Message.msg_iov = Parts;
+  Message.msg_iovlen = 2;
+  if (sendmsg(Fd, &Message, MSG_DONTWAIT | MSG_NOSIGNAL) < 0) {
+    atomic_fetch_add(&StreamDropped, 1, memory_order_relaxed);
+    return;
+  }
+  atomic_store(B.Extents, 0, memory_order_release);
+}
+
+// Connects to the socket at Path and sends it the file header, which tells the
+// reader the cycle frequency and buffer size for the buffers that follow.
+static void openStream(const char *Path) XRAY_NEVER_INSTRUMENT {
+  int OldFd = atomic_exchange(&StreamFd, -1, memory_order_acq_rel);
+  if (OldFd >= 0)
+    internal_close(OldFd);
+  atomic_store(&StreamDropped, 0, memory_order_relaxed);
+  if (Path == nullptr || Path[0] == '\0')
+    return;
+
+  sockaddr_un Addr{};
+  Addr.sun_family = AF_UNIX;
+  if (internal_strlen(Path) >= sizeof(Addr.sun_path)) {
+    Report("XRay FDR: Stream socket path '%s' is too long.\n", Path);
+    return;
+  }
+  internal_strncpy(Addr.sun_path, Path, sizeof(Addr.sun_path) - 1);
+
+  int Fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (Fd < 0) {
+    Report("XRay FDR: Failed to create stream socket; errno=%d\n", errno);
+    return;
+  }
+  if (connect(Fd, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) != 0) {
+    Report("XRay FDR: Failed to connect to stream socket '%s'; errno=%d\n",
+           Path, errno);
+    internal_close(Fd);
+    return;
+  }
+
+  XRayFileHeader Header = fdrCommonHeaderInfo();
+  Header.FdrData = FdrAdditionalHeaderData{BQ->ConfiguredBufferSize()};
+  if (send(Fd, &Header, sizeof(Header), MSG_NOSIGNAL) !=
+      static_cast<ssize_t>(sizeof(Header))) {
+    Report("XRay FDR: Failed to write to stream socket '%s'; errno=%d\n", Path,
+           errno);
+    internal_close(Fd);
+    return;
+  }
+  atomic_store(&StreamFd, Fd, memory_order_release);
+}
+
 // This is the iterator implementation, which knows how to handle FDR-mode
 // specific buffers. This is used as an implementation of the iterator function
 // needed by __xray_set_buffer_iterator(...). It maintains a global state of the
@@ -320,6 +416,22 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
       TLD.Controller->flush();
   });
 
+  // The buffers still in the queue go to the stream first, if there is one.
+  // What's left over, because the reader fell behind, goes to the file.
+  int Fd = atomic_load(&StreamFd, memory_order_acquire);
+  if (Fd >= 0) {
+    auto &TLD = getThreadLocalData();
+    if (TLD.Controller != nullptr)
+      TLD.Controller->flush();
+    BQ->apply([](const BufferQueue::Buffer &B) { streamBuffer(B); });
+    shutdown(Fd, SHUT_RDWR);
+    auto Dropped = atomic_load(&StreamDropped, memory_order_relaxed);
+    if (Dropped != 0 && Verbosity())
+      Report("XRay FDR: Dropped %llu buffers the stream reader couldn't keep "
+             "up with.\n",
+             Dropped);
+  }
+
   if (fdrFlags()->no_file_flush) {
     if (Verbosity())
       Report("XRay FDR: Not flushing to file, 'no_file_flush=true'.\n");
@@ -419,13 +531,7 @@ static TSCAndCPU getTimestamp() XRAY_NEVER_INSTRUMENT {
   // to allow for forward progress with the scheduling.
   TSCAndCPU Result;
 
-  // Test once for required CPU features
-  static pthread_once_t OnceProbe = PTHREAD_ONCE_INIT;
-  static bool TSCSupported = true;
-  pthread_once(
-      &OnceProbe, +[] { TSCSupported = probeRequiredCPUFeatures(); });
-
-  if (TSCSupported) {
+  if (atomic_load_relaxed(&TSCSupported)) {
     Result.TSC = __xray::readTSC(Result.CPU);
   } else {
     // FIXME: This code needs refactoring as it appears in multiple locations
@@ -484,7 +590,7 @@ static bool setupTLD(ThreadLocalData &TLD) XRAY_NEVER_INSTRUMENT {
     auto *CStorage = reinterpret_cast<FDRController<> *>(&TLD.CStorage);
     new (CStorage)
         FDRController<>(TLD.BQ, TLD.Buffer, *TLD.Writer, clock_gettime,
-                        atomic_load_relaxed(&ThresholdTicks));
+                        atomic_load_relaxed(&ThresholdTicks), streamBuffer);
     TLD.Controller = CStorage;
   }
 
@@ -677,15 +783,19 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
     }
   }
 
+  openStream(fdrFlags()->stream_socket);
+
   static pthread_once_t OnceInit = PTHREAD_ONCE_INIT;
   pthread_once(
       &OnceInit, +[] {
+        bool HasTSC = probeRequiredCPUFeatures();
+        atomic_store(&TSCSupported, HasTSC, memory_order_release);
         atomic_store(&TicksPerSec,
-                     probeRequiredCPUFeatures() ? getTSCFrequency()
-                                                : __xray::NanosecondsPerSecond,
+                     HasTSC ? getTSCFrequency() : __xray::NanosecondsPerSecond,
                      memory_order_release);
         pthread_key_create(
             &Key, +[](void *TLDPtr) {
+              TLDRegistered = false;
               if (TLDPtr == nullptr)
                 return;
               auto &TLD = *reinterpret_cast<ThreadLocalData *>(TLDPtr);
@@ -693,6 +803,9 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
                 return;
               if (TLD.Buffer.Data == nullptr)
                 return;
+              if (!TLD.BQ->finalizing() &&
+                  TLD.Buffer.Generation == TLD.BQ->generation())
+                streamBuffer(TLD.Buffer);
               auto EC = TLD.BQ->releaseBuffer(TLD.Buffer);
               if (EC != BufferQueue::ErrorCode::Ok)
                 Report("At thread exit, failed to release buffer at %p; "
@@ -0,0 +1,28 @@
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// A target that keeps state between runs: it crashes once it has run more
+// than 10 times since LLVMFuzzerInitialize, which must not run again.
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int NumInitializations;
+static int NumRunsSinceInitialization;
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+  NumInitializations++;
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
+  assert(NumInitializations == 1);
+  if (++NumRunsSinceInitialization > 10) {
+    fprintf(stderr, "STALE STATE after %d runs\n", NumRunsSinceInitialization);
+    abort();
+  }
+  return 0;
+}
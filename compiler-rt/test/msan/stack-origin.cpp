@@ -16,6 +16,10 @@
 // RUN: %clangxx_msan -fsanitize-memory-track-origins -O3 %s -o %t && not %run %t >%t.out 2>&1
 // RUN: FileCheck %s < %t.out && FileCheck %s --check-prefix=CHECK-ORIGINS < %t.out
 
+// RUN: %clangxx_msan -fsanitize-memory-track-origins=2 -O0 %s -o %t
+// RUN: MSAN_OPTIONS=heap_origins_only=1 not %run %t >%t.out 2>&1
+// RUN: FileCheck %s < %t.out && FileCheck %s --check-prefix=CHECK-HEAP-ONLY < %t.out
+
 #include <stdlib.h>
 int main(int argc, char **argv) {
   int x;
@@ -27,5 +31,7 @@ int main(int argc, char **argv) {
   // CHECK-ORIGINS: Uninitialized value was created by an allocation of 'x' in the stack frame of function 'main'
   // CHECK-ORIGINS: {{#0 0x.* in main .*stack-origin.cpp:}}[[@LINE-8]]
 
+  // CHECK-HEAP-ONLY-NOT: Uninitialized value was
+
   // CHECK: SUMMARY: MemorySanitizer: use-of-uninitialized-value {{.*stack-origin.cpp:.* main}}
 }
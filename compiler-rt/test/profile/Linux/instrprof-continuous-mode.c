@@ -0,0 +1,43 @@
+// Check that in continuous mode (%c) the counters are kept in sync with the
+// raw profile, even though the profile is never written at exit.
+// RUN: %clang_profgen -o %t %s
+// RUN: rm -f %t.profraw %t.snapshot.profraw
+// RUN: env LLVM_PROFILE_FILE="%c%t.profraw" %run %t %t.snapshot.profraw
+// RUN: llvm-profdata show --counts --all-functions %t.profraw | FileCheck %s
+// RUN: llvm-profdata show --counts --all-functions %t.snapshot.profraw | FileCheck %s -check-prefix=SNAPSHOT
+
+// Merging processes share the counters in the file.
+// RUN: rm -rf %t.d
+// RUN: env LLVM_PROFILE_FILE="%t.d/%c%m.profraw" %run %t %t.snapshot.profraw
+// RUN: env LLVM_PROFILE_FILE="%t.d/%c%m.profraw" %run %t %t.snapshot.profraw
+// RUN: llvm-profdata show --counts --all-functions %t.d/*.profraw | FileCheck %s -check-prefix=MERGE
+
+#include <unistd.h>
+
+int __llvm_profile_write_snapshot(const char *Filename);
+
+void foo(int N) {
+  for (int I = 0; I < N; ++I)
+    ;
+}
+
+int main(int argc, const char *argv[]) {
+  foo(10);
+  if (__llvm_profile_write_snapshot(argv[1]))
+    return 1;
+  foo(5);
+  // Skip the atexit handlers, which would write the profile otherwise.
+  _exit(0);
+}
+
+// CHECK-LABEL: foo:
+// CHECK: Function count: 2
+// CHECK: Block counts: [15]
+
+// SNAPSHOT-LABEL: foo:
+// SNAPSHOT: Function count: 1
+// SNAPSHOT: Block counts: [10]
+
+// MERGE-LABEL: foo:
+// MERGE: Function count: 4
+// MERGE: Block counts: [30]
@@ -0,0 +1,36 @@
+// Check that thread-local counters are folded into the profile counters when
+// threads exit and when the profile is written.
+// RUN: %clang_profgen -mllvm -instrprof-thread-local-counters -o %t %s -pthread
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --counts --all-functions %t.profraw | FileCheck %s
+
+// With a sampling period of 1 every update is counted.
+// RUN: %clang_profgen -mllvm -instrprof-sampled-counter-update -o %t.sampled %s -pthread
+// RUN: env LLVM_PROFILE_FILE=%t.sampled.profraw LLVM_PROFILE_SAMPLING_PERIOD=1 %run %t.sampled
+// RUN: llvm-profdata show --counts --all-functions %t.sampled.profraw | FileCheck %s
+
+#include <pthread.h>
+
+void foo(int N) {
+  for (int I = 0; I < N; ++I)
+    ;
+}
+
+void *thread(void *Arg) {
+  foo(100);
+  return 0;
+}
+
+int main() {
+  pthread_t Threads[4];
+  for (int I = 0; I < 4; ++I)
+    pthread_create(&Threads[I], 0, thread, 0);
+  for (int I = 0; I < 4; ++I)
+    pthread_join(Threads[I], 0);
+  foo(10);
+  return 0;
+}
+
+// CHECK-LABEL: foo:
+// CHECK: Function count: 5
+// CHECK: Block counts: [410]
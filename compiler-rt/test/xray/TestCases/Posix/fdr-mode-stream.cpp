@@ -0,0 +1,84 @@
+// RUN: %clangxx_xray -g -std=c++11 %s -o %t
+// RUN: rm -f fdr-stream-test.sock fdr-stream-test.xray
+// RUN: XRAY_OPTIONS="patch_premain=false verbosity=1" \
+// RUN: XRAY_FDR_OPTIONS="no_file_flush=true func_duration_threshold_us=0" \
+// RUN:     %run %t fdr-stream-test.sock fdr-stream-test.xray 2>&1 \
+// RUN:     | FileCheck %s
+// RUN: %llvm_xray account -instr_map=%t fdr-stream-test.xray \
+// RUN:     | FileCheck %s --check-prefix=ACCOUNT
+// RUN: rm -f fdr-stream-test.sock fdr-stream-test.xray
+//
+// REQUIRES: x86_64-target-arch
+// REQUIRES: built-in-llvm-tree
+
+#include "xray/xray_log_interface.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+[[clang::xray_always_instrument]] void __attribute__((noinline)) f() {}
+
+int main(int argc, char *argv[]) {
+  assert(argc == 3);
+
+  // Listen before FDR mode connects; we only accept the connection once the
+  // log has been flushed, as the socket holds everything sent until then.
+  int Listener = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+  assert(Listener >= 0);
+  sockaddr_un Addr{};
+  Addr.sun_family = AF_UNIX;
+  strncpy(Addr.sun_path, argv[1], sizeof(Addr.sun_path) - 1);
+  int Result =
+      bind(Listener, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr));
+  assert(Result == 0);
+  Result = listen(Listener, 1);
+  assert(Result == 0);
+
+  char Options[256];
+  snprintf(Options, sizeof(Options),
+           "buffer_size=4096:buffer_max=10:stream_socket=%s", argv[1]);
+  assert(__xray_log_select_mode("xray-fdr") ==
+         XRayLogRegisterStatus::XRAY_REGISTRATION_OK);
+  auto Status = __xray_log_init_mode("xray-fdr", Options);
+  assert(Status == XRayLogInitStatus::XRAY_LOG_INITIALIZED);
+  __xray_patch();
+
+  // Fill up a few buffers.
+  for (int I = 0; I != 1000; ++I)
+    f();
+
+  __xray_unpatch();
+  auto FinalizeStatus = __xray_log_finalize();
+  assert(FinalizeStatus == XRayLogInitStatus::XRAY_LOG_FINALIZED);
+  auto FlushStatus = __xray_log_flushLog();
+  assert(FlushStatus == XRayLogFlushStatus::XRAY_LOG_FLUSHED);
+  // CHECK-NOT: Failed to connect
+  // CHECK-NOT: Dropped
+
+  // The header and the buffers that follow it make up an FDR log file.
+  int Connection = accept(Listener, nullptr, nullptr);
+  assert(Connection >= 0);
+  FILE *Log = fopen(argv[2], "wb");
+  assert(Log != nullptr);
+  static char Message[1 << 16];
+  int Messages = 0;
+  ssize_t Size;
+  while ((Size = recv(Connection, Message, sizeof(Message), 0)) > 0) {
+    fwrite(Message, 1, Size, Log);
+    ++Messages;
+  }
+  fclose(Log);
+  close(Connection);
+  close(Listener);
+  unlink(argv[1]);
+
+  // CHECK: Streamed more than a buffer: yes
+  printf("Streamed more than a buffer: %s\n", Messages > 2 ? "yes" : "no");
+  return 0;
+}
+
+// ACCOUNT: Functions with latencies:
+// ACCOUNT: 1000 [{{.*}}f()
@@ -47,6 +47,22 @@ void BM_ConstructIterIter(benchmark::State& st, Container, GenInputs gen) {
     }
 }
 
+// Grows a fresh container one element at a time, so the cost includes every
+// reallocation (vector) or block allocation (deque) along the way.
+template <class Container, class GenInputs>
+void BM_PushBack(benchmark::State& st, Container, GenInputs gen) {
+    auto in = gen(st.range(0));
+    const auto begin = in.begin();
+    const auto end = in.end();
+    benchmark::DoNotOptimize(&in);
+    while (st.KeepRunning()) {
+        Container c;
+        for (auto it = begin; it != end; ++it)
+            c.push_back(*it);
+        DoNotOptimizeData(c);
+    }
+}
+
 template <class Container, class GenInputs>
 void BM_InsertValue(benchmark::State& st, Container c, GenInputs gen) {
     auto in = gen(st.range(0));
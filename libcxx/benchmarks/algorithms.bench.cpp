@@ -248,6 +248,67 @@ struct PopHeap {
   };
 };
 
+// Linear scans over contiguous arithmetic ranges. The only match, or the only
+// difference, is in the last element, so every element is visited.
+template <class T>
+void BM_Find(benchmark::State& state) {
+  std::vector<T> V(state.range(0), T(1));
+  V.back() = T(2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(V);
+    benchmark::DoNotOptimize(std::find(V.begin(), V.end(), T(2)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class T>
+void BM_Count(benchmark::State& state) {
+  std::vector<T> V(state.range(0), T(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(V);
+    benchmark::DoNotOptimize(std::count(V.begin(), V.end(), T(1)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class T>
+void BM_Mismatch(benchmark::State& state) {
+  std::vector<T> V1(state.range(0), T(1));
+  std::vector<T> V2 = V1;
+  V2.back() = T(2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(V1);
+    benchmark::DoNotOptimize(std::mismatch(V1.begin(), V1.end(), V2.begin()));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class T>
+void BM_Equal(benchmark::State& state) {
+  std::vector<T> V1(state.range(0), T(1));
+  std::vector<T> V2 = V1;
+  V2.back() = T(2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(V1);
+    benchmark::DoNotOptimize(
+        std::equal(V1.begin(), V1.end(), V2.begin(), V2.end()));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define SCAN_BENCHMARKS(Name)                                                  \
+  BENCHMARK_TEMPLATE(Name, uint8_t)->Range(8, 1 << 16);                        \
+  BENCHMARK_TEMPLATE(Name, uint16_t)->Range(8, 1 << 16);                       \
+  BENCHMARK_TEMPLATE(Name, uint32_t)->Range(8, 1 << 16);                       \
+  BENCHMARK_TEMPLATE(Name, uint64_t)->Range(8, 1 << 16);                       \
+  BENCHMARK_TEMPLATE(Name, float)->Range(8, 1 << 16);                          \
+  BENCHMARK_TEMPLATE(Name, double)->Range(8, 1 << 16)
+
+SCAN_BENCHMARKS(BM_Find);
+SCAN_BENCHMARKS(BM_Count);
+SCAN_BENCHMARKS(BM_Mismatch);
+SCAN_BENCHMARKS(BM_Equal);
+
 } // namespace
 
 int main(int argc, char** argv) {
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <version>
+#if defined(__cpp_lib_semaphore)
+#include <semaphore>
+#endif
+
+// Each benchmark passes a token back and forth between the benchmark thread
+// and a partner thread, so one iteration is a full producer -> consumer ->
+// producer round trip: two handoffs, each of which may put a thread to sleep.
+
+static void BM_PingPong_ConditionVariable(benchmark::State& st) {
+  std::mutex M;
+  std::condition_variable CV;
+  int Turn = 0;
+  std::thread Partner([&] {
+    std::unique_lock<std::mutex> L(M);
+    for (int Expected = 1;; Expected += 2) {
+      CV.wait(L, [&] { return Turn != Expected - 1; });
+      if (Turn < 0)
+        return;
+      Turn = Expected + 1;
+      CV.notify_one();
+    }
+  });
+  int Value = 0;
+  for (auto _ : st) {
+    std::unique_lock<std::mutex> L(M);
+    Turn = Value + 1;
+    CV.notify_one();
+    CV.wait(L, [&] { return Turn != Value + 1; });
+    Value += 2;
+  }
+  {
+    std::lock_guard<std::mutex> L(M);
+    Turn = -1;
+  }
+  CV.notify_one();
+  Partner.join();
+}
+BENCHMARK(BM_PingPong_ConditionVariable)->UseRealTime();
+
+#if defined(__cpp_lib_atomic_wait)
+// With libc++ on Linux, atomic<int> waits on its own futex while
+// atomic<long long> goes through the contention table.
+template <class T>
+static void BM_PingPong_AtomicWait(benchmark::State& st) {
+  std::atomic<T> Turn(0);
+  std::thread Partner([&] {
+    for (T Expected = 1;; Expected += 2) {
+      Turn.wait(Expected - 1);
+      if (Turn.load() < 0)
+        return;
+      Turn.store(Expected + 1);
+      Turn.notify_one();
+    }
+  });
+  T Value = 0;
+  for (auto _ : st) {
+    Turn.store(Value + 1);
+    Turn.notify_one();
+    Turn.wait(Value + 1);
+    Value += 2;
+  }
+  Turn.store(-1);
+  Turn.notify_one();
+  Partner.join();
+}
+BENCHMARK_TEMPLATE(BM_PingPong_AtomicWait, int)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong_AtomicWait, long long)->UseRealTime();
+#endif
+
+#if defined(__cpp_lib_semaphore)
+static void BM_PingPong_BinarySemaphore(benchmark::State& st) {
+  std::binary_semaphore Ping(0), Pong(0);
+  std::atomic<bool> Done(false);
+  std::thread Partner([&] {
+    for (;;) {
+      Ping.acquire();
+      if (Done.load(std::memory_order_relaxed))
+        return;
+      Pong.release();
+    }
+  });
+  for (auto _ : st) {
+    Ping.release();
+    Pong.acquire();
+  }
+  Done = true;
+  Ping.release();
+  Partner.join();
+}
+BENCHMARK(BM_PingPong_BinarySemaphore)->UseRealTime();
+#endif
+
+BENCHMARK_MAIN();
@@ -41,7 +41,34 @@ BENCHMARK_CAPTURE(BM_ConstructIterIter,
   std::deque<std::string>{},
   getRandomStringInputs)->Arg(TestNumInputs);
 
+// Each block holds _LIBCPP_DEQUE_BLOCK_BYTES worth of elements (or 16 large
+// ones). Build with different values of it to compare block sizes.
+struct LargeValue {
+  char data[1024];
+};
 
+static std::vector<LargeValue> getLargeValueInputs(size_t N) {
+  return std::vector<LargeValue>(N, LargeValue());
+}
 
+BENCHMARK_CAPTURE(BM_PushBack,
+  deque_char,
+  std::deque<char>{},
+  getRandomIntegerInputs<char>)->Arg(16)->Arg(TestNumInputs * 64);
+
+BENCHMARK_CAPTURE(BM_PushBack,
+  deque_size_t,
+  std::deque<size_t>{},
+  getRandomIntegerInputs<size_t>)->Arg(16)->Arg(TestNumInputs * 64);
+
+BENCHMARK_CAPTURE(BM_PushBack,
+  deque_string,
+  std::deque<std::string>{},
+  getRandomStringInputs)->Arg(TestNumInputs);
+
+BENCHMARK_CAPTURE(BM_PushBack,
+  deque_large,
+  std::deque<LargeValue>{},
+  getLargeValueInputs)->Arg(TestNumInputs);
 
 BENCHMARK_MAIN();
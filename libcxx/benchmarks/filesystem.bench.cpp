@@ -3,6 +3,9 @@
 #include "test_iterators.h"
 #include "filesystem_include.h"
 
+#include <cstdio>
+#include <string>
+
 static const size_t TestNumInputs = 1024;
 
 
@@ -160,4 +163,83 @@ BENCHMARK_CAPTURE(BM_LexicallyNormal, small_path,
 BENCHMARK_CAPTURE(BM_LexicallyNormal, large_path,
   getRandomPaths, /*PathLen*/32)->RangeMultiplier(2)->Range(2, 256)->Complexity();
 
+// Builds a tree of Width directories per level, Depth levels deep, with
+// FilesPerDir empty files in each directory. Removed again on destruction.
+struct TestTree {
+  fs::path Root;
+
+  TestTree(int Depth, int Width, int FilesPerDir)
+      : Root(fs::temp_directory_path() /
+             ("libcxx-bench-tree-" + std::to_string(Depth) + "-" +
+              std::to_string(Width) + "-" + std::to_string(FilesPerDir))) {
+    fs::remove_all(Root);
+    fs::create_directories(Root);
+    populate(Root, Depth, Width, FilesPerDir);
+  }
+  ~TestTree() { fs::remove_all(Root); }
+
+  static void populate(const fs::path& Dir, int Depth, int Width,
+                       int FilesPerDir) {
+    for (int I = 0; I < FilesPerDir; ++I) {
+      std::FILE* F = std::fopen((Dir / ("file" + std::to_string(I))).c_str(), "w");
+      if (F)
+        std::fclose(F);
+    }
+    if (Depth == 0)
+      return;
+    for (int I = 0; I < Width; ++I) {
+      fs::path Sub = Dir / ("dir" + std::to_string(I));
+      fs::create_directory(Sub);
+      populate(Sub, Depth - 1, Width, FilesPerDir);
+    }
+  }
+};
+
+void BM_DirectoryIterate(benchmark::State &st) {
+  TestTree Tree(0, 0, st.range(0));
+  for (auto _ : st) {
+    int N = 0;
+    for (const auto& E : fs::directory_iterator(Tree.Root)) {
+      benchmark::DoNotOptimize(&E);
+      ++N;
+    }
+    benchmark::DoNotOptimize(N);
+  }
+  st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK(BM_DirectoryIterate)->Range(64, 1 << 14);
+
+// Recursion has to know whether each entry is a directory; with a file type
+// from the directory read that needs no stat call.
+void BM_RecursiveDirectoryIterate(benchmark::State &st) {
+  TestTree Tree(st.range(0), 4, 32);
+  int64_t Entries = 0;
+  for (auto _ : st) {
+    Entries = 0;
+    for (const auto& E : fs::recursive_directory_iterator(Tree.Root)) {
+      benchmark::DoNotOptimize(&E);
+      ++Entries;
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * Entries);
+}
+BENCHMARK(BM_RecursiveDirectoryIterate)->DenseRange(1, 5);
+
+// Asking an entry for its type shouldn't cost a stat either.
+void BM_RecursiveDirectoryIterateIsDirectory(benchmark::State &st) {
+  TestTree Tree(st.range(0), 4, 32);
+  int64_t Entries = 0;
+  for (auto _ : st) {
+    Entries = 0;
+    int Dirs = 0;
+    for (const auto& E : fs::recursive_directory_iterator(Tree.Root)) {
+      Dirs += E.is_directory();
+      ++Entries;
+    }
+    benchmark::DoNotOptimize(Dirs);
+  }
+  st.SetItemsProcessed(st.iterations() * Entries);
+}
+BENCHMARK(BM_RecursiveDirectoryIterateIsDirectory)->DenseRange(1, 5);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+
+#include <cstdio>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <version>
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
+// Each benchmark formats the same values into a std::string, so the numbers
+// include building the result but not parsing any input.
+
+static const char Path[] = "/api/v1/items";
+
+static void BM_Int_snprintf(benchmark::State& st) {
+  char Buf[32];
+  int I = 0;
+  for (auto _ : st) {
+    int N = std::snprintf(Buf, sizeof(Buf), "%d", I++ * 7919);
+    std::string S(Buf, N);
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_Int_snprintf);
+
+static void BM_Int_ostringstream(benchmark::State& st) {
+  int I = 0;
+  for (auto _ : st) {
+    std::ostringstream OS;
+    OS << I++ * 7919;
+    std::string S = OS.str();
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_Int_ostringstream);
+
+static void BM_Double_snprintf(benchmark::State& st) {
+  char Buf[64];
+  double D = 0.1;
+  for (auto _ : st) {
+    int N = std::snprintf(Buf, sizeof(Buf), "%.3f", D);
+    D += 1.25;
+    std::string S(Buf, N);
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_Double_snprintf);
+
+static void BM_Double_ostringstream(benchmark::State& st) {
+  double D = 0.1;
+  for (auto _ : st) {
+    std::ostringstream OS;
+    OS.setf(std::ios_base::fixed);
+    OS.precision(3);
+    OS << D;
+    D += 1.25;
+    std::string S = OS.str();
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_Double_ostringstream);
+
+static void BM_LogLine_snprintf(benchmark::State& st) {
+  char Buf[128];
+  int Id = 81723;
+  for (auto _ : st) {
+    int N = std::snprintf(Buf, sizeof(Buf), "request id=%d path=%s took %.1fms status=%#x",
+                          Id++, Path, 12.5, 200);
+    std::string S(Buf, N);
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_LogLine_snprintf);
+
+static void BM_LogLine_ostringstream(benchmark::State& st) {
+  int Id = 81723;
+  for (auto _ : st) {
+    std::ostringstream OS;
+    OS << "request id=" << Id++ << " path=" << Path << " took ";
+    OS.setf(std::ios_base::fixed);
+    OS.precision(1);
+    OS << 12.5 << "ms status=";
+    OS.setf(std::ios_base::hex, std::ios_base::basefield);
+    OS.setf(std::ios_base::showbase);
+    OS << 200;
+    std::string S = OS.str();
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_LogLine_ostringstream);
+
+#if defined(__cpp_lib_format)
+static void BM_Int_format(benchmark::State& st) {
+  int I = 0;
+  for (auto _ : st) {
+    std::string S = std::format("{}", I++ * 7919);
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_Int_format);
+
+static void BM_Double_format(benchmark::State& st) {
+  double D = 0.1;
+  for (auto _ : st) {
+    std::string S = std::format("{:.3f}", D);
+    D += 1.25;
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_Double_format);
+
+static void BM_LogLine_format(benchmark::State& st) {
+  int Id = 81723;
+  for (auto _ : st) {
+    std::string S = std::format("request id={} path={} took {:.1f}ms status={:#x}",
+                                Id++, Path, 12.5, 200);
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_LogLine_format);
+
+// Appending to one string reuses its capacity, which is what a logger that
+// batches lines does.
+static void BM_LogLine_format_to(benchmark::State& st) {
+  int Id = 81723;
+  std::string S;
+  for (auto _ : st) {
+    S.clear();
+    std::format_to(std::back_inserter(S), "request id={} path={} took {:.1f}ms status={:#x}",
+                   Id++, Path, 12.5, 200);
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_LogLine_format_to);
+
+// The same line, parsed at run time.
+static void BM_LogLine_vformat(benchmark::State& st) {
+  int Id = 81723;
+  double Ms = 12.5;
+  int Status = 200;
+  std::string_view P = Path;
+  for (auto _ : st) {
+    std::string S = std::vformat("request id={} path={} took {:.1f}ms status={:#x}",
+                                 std::make_format_args(Id, P, Ms, Status));
+    ++Id;
+    benchmark::DoNotOptimize(S);
+  }
+}
+BENCHMARK(BM_LogLine_vformat);
+#endif
+
+BENCHMARK_MAIN();
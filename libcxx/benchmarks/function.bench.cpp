@@ -24,17 +24,19 @@ enum class FunctionType {
   MemberPointer,
   SmallTrivialFunctor,
   SmallNonTrivialFunctor,
+  MediumTrivialFunctor,
   LargeTrivialFunctor,
   LargeNonTrivialFunctor
 };
 
-struct AllFunctionTypes : EnumValuesAsTuple<AllFunctionTypes, FunctionType, 8> {
+struct AllFunctionTypes : EnumValuesAsTuple<AllFunctionTypes, FunctionType, 9> {
   static constexpr const char* Names[] = {"Null",
                                           "FuncPtr",
                                           "MemFuncPtr",
                                           "MemPtr",
                                           "SmallTrivialFunctor",
                                           "SmallNonTrivialFunctor",
+                                          "MediumTrivialFunctor",
                                           "LargeTrivialFunctor",
                                           "LargeNonTrivialFunctor"};
 };
@@ -61,6 +63,14 @@ struct SmallNonTrivialFunctor {
   ~SmallNonTrivialFunctor() {}
   int operator()(const S*) const { return 0; }
 };
+// Three pointers: what a lambda capturing `this` and a couple of values
+// usually looks like. Whether it is stored inline depends on the
+// implementation and, with _LIBCPP_ABI_OPTIMIZED_FUNCTION, on
+// _LIBCPP_ABI_FUNCTION_INLINE_STORAGE_SIZE.
+struct MediumTrivialFunctor {
+  void* captures[3];
+  int operator()(const S*) const { return 0; }
+};
 struct LargeTrivialFunctor {
   LargeTrivialFunctor() {
       // Do not spend time initializing the padding.
@@ -95,6 +105,8 @@ inline Function MakeFunction(FunctionType type, bool opaque = false) {
       return maybeOpaque(SmallTrivialFunctor{}, opaque);
     case FunctionType::SmallNonTrivialFunctor:
       return maybeOpaque(SmallNonTrivialFunctor{}, opaque);
+    case FunctionType::MediumTrivialFunctor:
+      return maybeOpaque(MediumTrivialFunctor{}, opaque);
     case FunctionType::LargeTrivialFunctor:
       return maybeOpaque(LargeTrivialFunctor{}, opaque);
     case FunctionType::LargeNonTrivialFunctor:
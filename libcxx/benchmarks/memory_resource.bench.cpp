@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+#include "GenerateInput.h"
+
+// Each wrapper owns a resource and knows how to give all of its memory back
+// between batches, so the monotonic resource doesn't grow without bound.
+struct NewDeleteResource {
+  std::pmr::memory_resource* get() { return std::pmr::new_delete_resource(); }
+  void reset() {}
+};
+
+struct MonotonicResource {
+  std::pmr::monotonic_buffer_resource R;
+  std::pmr::memory_resource* get() { return &R; }
+  void reset() { R.release(); }
+};
+
+struct UnsynchronizedPoolResource {
+  std::pmr::unsynchronized_pool_resource R;
+  std::pmr::memory_resource* get() { return &R; }
+  void reset() {}
+};
+
+struct SynchronizedPoolResource {
+  std::pmr::synchronized_pool_resource R;
+  std::pmr::memory_resource* get() { return &R; }
+  void reset() {}
+};
+
+template <class Resource>
+static void BM_AllocateAndDeallocate(benchmark::State& st) {
+  const size_t alloc_size = st.range(0);
+  Resource Res;
+  std::pmr::memory_resource* R = Res.get();
+  size_t Count = 0;
+  for (auto _ : st) {
+    void* p = R->allocate(alloc_size);
+    benchmark::DoNotOptimize(p);
+    R->deallocate(p, alloc_size);
+    if (++Count == 4096) {
+      st.PauseTiming();
+      Res.reset();
+      Count = 0;
+      st.ResumeTiming();
+    }
+  }
+}
+
+// Allocates a batch of blocks and then frees them all, which is where the
+// pools and the monotonic resource differ most from new and delete.
+template <class Resource>
+static void BM_AllocateBatch(benchmark::State& st) {
+  const size_t alloc_size = st.range(0);
+  const size_t BatchSize = 1024;
+  Resource Res;
+  std::pmr::memory_resource* R = Res.get();
+  std::vector<void*> Pointers(BatchSize);
+  for (auto _ : st) {
+    for (auto& p : Pointers) {
+      p = R->allocate(alloc_size);
+      benchmark::DoNotOptimize(p);
+    }
+    for (auto p : Pointers)
+      R->deallocate(p, alloc_size);
+    Res.reset();
+  }
+  st.SetItemsProcessed(st.iterations() * BatchSize);
+}
+
+template <class Resource>
+static void BM_VectorPushBack(benchmark::State& st) {
+  const size_t N = st.range(0);
+  Resource Res;
+  for (auto _ : st) {
+    {
+      std::pmr::vector<int> V(Res.get());
+      for (size_t I = 0; I < N; ++I)
+        V.push_back(static_cast<int>(I));
+      benchmark::DoNotOptimize(V.data());
+    }
+    Res.reset();
+  }
+  st.SetItemsProcessed(st.iterations() * N);
+}
+
+// Node based containers make one small allocation per element.
+template <class Resource>
+static void BM_UnorderedMapChurn(benchmark::State& st) {
+  const size_t N = st.range(0);
+  const std::vector<uint64_t> Keys = getRandomIntegerInputs<uint64_t>(N);
+  Resource Res;
+  for (auto _ : st) {
+    {
+      std::pmr::unordered_map<uint64_t, uint64_t> M(Res.get());
+      for (uint64_t K : Keys)
+        M.emplace(K, K);
+      for (size_t I = 0; I < N; I += 2)
+        M.erase(Keys[I]);
+      for (size_t I = 0; I < N; I += 2)
+        M.emplace(Keys[I], I);
+      benchmark::DoNotOptimize(M.size());
+    }
+    Res.reset();
+  }
+  st.SetItemsProcessed(st.iterations() * N * 2);
+}
+
+static int RegisterMemoryResourceBenchmarks() {
+  using FnType = void(*)(benchmark::State&);
+  struct {
+    const char* name;
+    FnType alloc_dealloc;
+    FnType alloc_batch;
+    FnType vector_push_back;
+    FnType unordered_map_churn;
+  } TestCases[] = {
+      {"NewDelete", &BM_AllocateAndDeallocate<NewDeleteResource>,
+       &BM_AllocateBatch<NewDeleteResource>, &BM_VectorPushBack<NewDeleteResource>,
+       &BM_UnorderedMapChurn<NewDeleteResource>},
+      {"Monotonic", &BM_AllocateAndDeallocate<MonotonicResource>,
+       &BM_AllocateBatch<MonotonicResource>, &BM_VectorPushBack<MonotonicResource>,
+       &BM_UnorderedMapChurn<MonotonicResource>},
+      {"UnsynchronizedPool", &BM_AllocateAndDeallocate<UnsynchronizedPoolResource>,
+       &BM_AllocateBatch<UnsynchronizedPoolResource>,
+       &BM_VectorPushBack<UnsynchronizedPoolResource>,
+       &BM_UnorderedMapChurn<UnsynchronizedPoolResource>},
+      {"SynchronizedPool", &BM_AllocateAndDeallocate<SynchronizedPoolResource>,
+       &BM_AllocateBatch<SynchronizedPoolResource>,
+       &BM_VectorPushBack<SynchronizedPoolResource>,
+       &BM_UnorderedMapChurn<SynchronizedPoolResource>},
+  };
+  for (auto TC : TestCases) {
+    std::string Name = TC.name;
+    benchmark::RegisterBenchmark(("BM_AllocateAndDeallocate_" + Name).c_str(), TC.alloc_dealloc)
+        ->Range(16, 4096 * 2);
+    benchmark::RegisterBenchmark(("BM_AllocateBatch_" + Name).c_str(), TC.alloc_batch)
+        ->Range(16, 4096 * 2);
+    benchmark::RegisterBenchmark(("BM_VectorPushBack_" + Name).c_str(), TC.vector_push_back)
+        ->Range(1 << 4, 1 << 16);
+    benchmark::RegisterBenchmark(("BM_UnorderedMapChurn_" + Name).c_str(), TC.unordered_map_churn)
+        ->Range(1 << 6, 1 << 14);
+  }
+  return 0;
+}
+int Sink = RegisterMemoryResourceBenchmarks();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// Parallel algorithms over the default backend, at 1 to 64 pool threads.
+// Only libc++ built with parallel algorithms can resize its pool.
+#if defined(_LIBCPP_HAS_PARALLEL_ALGORITHMS)
+#include <__thread_pool>
+
+namespace {
+
+constexpr int64_t kSize = 1 << 22;
+
+std::vector<uint32_t> makeInput(size_t n) {
+  std::mt19937 gen(0xBEEF);
+  std::vector<uint32_t> v(n);
+  for (auto& x : v)
+    x = gen();
+  return v;
+}
+
+// Sets the pool size for one benchmark, and the default back afterwards.
+struct ConcurrencyScope {
+  explicit ConcurrencyScope(benchmark::State& state) {
+    std::__thread_pool_set_concurrency(static_cast<unsigned>(state.range(1)));
+  }
+  ~ConcurrencyScope() { std::__thread_pool_set_concurrency(0); }
+};
+
+void BM_ParallelSort(benchmark::State& state) {
+  ConcurrencyScope scope(state);
+  const std::vector<uint32_t> input = makeInput(state.range(0));
+  std::vector<uint32_t> v;
+  for (auto _ : state) {
+    state.PauseTiming();
+    v = input;
+    state.ResumeTiming();
+    std::sort(std::execution::par, v.begin(), v.end());
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ParallelTransformReduce(benchmark::State& state) {
+  ConcurrencyScope scope(state);
+  const std::vector<uint32_t> input = makeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::transform_reduce(
+        std::execution::par, input.begin(), input.end(), uint64_t(0),
+        std::plus<uint64_t>(),
+        [](uint32_t x) { return uint64_t(x) * x; }));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ParallelForEach(benchmark::State& state) {
+  ConcurrencyScope scope(state);
+  std::vector<uint32_t> v = makeInput(state.range(0));
+  for (auto _ : state) {
+    std::for_each(std::execution::par, v.begin(), v.end(),
+                  [](uint32_t& x) { x = x * 2654435761u + 1; });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void ThreadCounts(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"size", "threads"});
+  for (int64_t threads = 1; threads <= 64; threads *= 2)
+    b->Args({kSize, threads});
+}
+
+BENCHMARK(BM_ParallelSort)->Apply(ThreadCounts)->UseRealTime();
+BENCHMARK(BM_ParallelTransformReduce)->Apply(ThreadCounts)->UseRealTime();
+BENCHMARK(BM_ParallelForEach)->Apply(ThreadCounts)->UseRealTime();
+
+} // namespace
+#endif // _LIBCPP_HAS_PARALLEL_ALGORITHMS
+
+BENCHMARK_MAIN();
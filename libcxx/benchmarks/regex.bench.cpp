@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <regex>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+// A few lines that look like a server log, repeated until the input is long
+// enough. Only the last line contains an error.
+static std::string makeLog(size_t Len) {
+  static const char Lines[] =
+      "2020-03-14 12:00:01 INFO  worker-3 request id=81723 path=/index.html took 12ms\n"
+      "2020-03-14 12:00:02 DEBUG worker-1 cache hit key=user:4412 ttl=300\n"
+      "2020-03-14 12:00:02 INFO  worker-2 request id=81724 path=/api/v1/items took 48ms\n";
+  std::string S;
+  while (S.size() < Len)
+    S += Lines;
+  S += "2020-03-14 12:00:03 ERROR worker-2 upstream timeout after 3000ms\n";
+  return S;
+}
+
+static void BM_RegexSearch(benchmark::State &State, const char *Pattern) {
+  std::string Input = makeLog(State.range(0));
+  std::regex Re(Pattern);
+  std::smatch M;
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(std::regex_search(Input, M, Re));
+  }
+  State.SetBytesProcessed(State.iterations() * Input.size());
+}
+BENCHMARK_CAPTURE(BM_RegexSearch, literal, "ERROR")->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_RegexSearch, alternation, "ERROR|FATAL|PANIC")
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_RegexSearch, captures,
+                  "([0-9]+-[0-9]+-[0-9]+) [0-9:]+ ERROR (\\w+)")
+    ->Range(1 << 10, 1 << 16);
+// Back references can only be run by the backtracking matcher.
+BENCHMARK_CAPTURE(BM_RegexSearch, backreference, "(ERROR) \\1")
+    ->Range(1 << 10, 1 << 16);
+
+static void BM_RegexMatch(benchmark::State &State, const char *Pattern) {
+  std::string Input(State.range(0), 'a');
+  Input += '@';
+  Input += "example.com";
+  std::regex Re(Pattern);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(std::regex_match(Input, Re));
+  }
+  State.SetBytesProcessed(State.iterations() * Input.size());
+}
+BENCHMARK_CAPTURE(BM_RegexMatch, email, "[a-z0-9._]+@[a-z0-9.-]+\\.[a-z]+")
+    ->Range(8, 1 << 12);
+
+// Optional items followed by required ones: a backtracking matcher tries
+// every combination of the optional items before it finds the match.
+static void BM_RegexPathological(benchmark::State &State) {
+  std::string Pattern, Input(State.range(0), 'a');
+  for (int I = 0; I < State.range(0); ++I)
+    Pattern += "a?";
+  Pattern += Input;
+  std::regex Re(Pattern);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(std::regex_match(Input, Re));
+  }
+}
+BENCHMARK(BM_RegexPathological)->DenseRange(4, 32, 4);
+
+BENCHMARK_MAIN();
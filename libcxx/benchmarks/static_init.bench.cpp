@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+
+// Every thread runs through the same list of function-local statics, so the
+// threads that lose the race for a static wait in __cxa_guard_acquire while
+// the winner initializes it. A static is only initialized once per process,
+// so each thread count gets its own list, and one iteration uses up one
+// static.
+
+constexpr std::size_t NumStatics = 1024;
+
+static int initialize(std::size_t I) {
+  int Value = static_cast<int>(I);
+  for (int J = 0; J < 1000; ++J)
+    benchmark::DoNotOptimize(Value += J);
+  return Value;
+}
+
+template <int Threads, std::size_t I>
+static int& getStatic() {
+  static int Value = initialize(I);
+  return Value;
+}
+
+template <int Threads, std::size_t... Is>
+static constexpr std::array<int& (*)(), sizeof...(Is)>
+makeStatics(std::index_sequence<Is...>) {
+  return {{&getStatic<Threads, Is>...}};
+}
+
+template <int Threads>
+static void BM_StaticInit(benchmark::State& st) {
+  static constexpr auto Statics =
+      makeStatics<Threads>(std::make_index_sequence<NumStatics>());
+  std::size_t I = 0;
+  for (auto _ : st)
+    benchmark::DoNotOptimize(Statics[I++]());
+}
+BENCHMARK_TEMPLATE(BM_StaticInit, 1)->Threads(1)->Iterations(NumStatics)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_StaticInit, 4)->Threads(4)->Iterations(NumStatics)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_StaticInit, 16)->Threads(16)->Iterations(NumStatics)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_StaticInit, 64)->Threads(64)->Iterations(NumStatics)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -49,6 +49,91 @@ static void BM_StringFindMatch2(benchmark::State &state) {
 }
 BENCHMARK(BM_StringFindMatch2)->Range(1, MAX_STRING_LEN / 4);
 
+// Benchmark finding a single character, which goes straight to
+// char_traits::find.
+static void BM_StringFindChar(benchmark::State &state) {
+  std::string s1(state.range(0), '-');
+  s1.back() = '*';
+  for (auto _ : state)
+    benchmark::DoNotOptimize(s1.find('*'));
+}
+BENCHMARK(BM_StringFindChar)->Range(10, MAX_STRING_LEN);
+
+// Benchmark comparing two equal strings, which goes through
+// char_traits::compare.
+static void BM_StringCompareEqual(benchmark::State &state) {
+  std::string s1(state.range(0), '-');
+  std::string s2(state.range(0), '-');
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s1);
+    benchmark::DoNotOptimize(s1.compare(s2));
+  }
+}
+BENCHMARK(BM_StringCompareEqual)->Range(10, MAX_STRING_LEN);
+
+// Benchmark building a string out of many small appends, starting empty so
+// that the growth policy is part of the measurement.
+static void BM_StringAppendChunks(benchmark::State &state) {
+  static constexpr char Chunk[] = "0123456789abcdef";
+  for (auto _ : state) {
+    std::string s;
+    for (int64_t i = 0; i < state.range(0); ++i)
+      s.append(Chunk, sizeof(Chunk) - 1);
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_StringAppendChunks)->Range(1, 8 << 10);
+
+static void BM_StringPushBack(benchmark::State &state) {
+  for (auto _ : state) {
+    std::string s;
+    for (int64_t i = 0; i < state.range(0); ++i)
+      s.push_back('a');
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_StringPushBack)->Range(1, MAX_STRING_LEN);
+
+// Benchmark a chain of operator+, where every step after the first can
+// reuse the rvalue on its left.
+static void BM_StringConcatChain(benchmark::State &state) {
+  std::string a(state.range(0), 'a');
+  std::string b(state.range(0), 'b');
+  for (auto _ : state) {
+    std::string s = a + b + a + b + a + b + a + b;
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_StringConcatChain)->Range(1, MAX_STRING_LEN / 8);
+
+// Benchmark filling a string of a known size: value initialized and then
+// overwritten, against written once in place.
+static void BM_StringResizeAndFill(benchmark::State &state) {
+  for (auto _ : state) {
+    std::string s;
+    s.resize(state.range(0));
+    for (char &c : s)
+      c = 'x';
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_StringResizeAndFill)->Range(16, MAX_STRING_LEN);
+
+#if defined(_LIBCPP_VERSION)
+static void BM_StringResizeAndOverwrite(benchmark::State &state) {
+  for (auto _ : state) {
+    std::string s;
+    s.__resize_and_overwrite(state.range(0), [](char *p, std::size_t n) {
+      for (std::size_t i = 0; i != n; ++i)
+        p[i] = 'x';
+      return n;
+    });
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_StringResizeAndOverwrite)->Range(16, MAX_STRING_LEN);
+#endif
+
 static void BM_StringCtorDefault(benchmark::State &state) {
   for (auto _ : state) {
     std::string Default;
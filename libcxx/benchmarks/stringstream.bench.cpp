@@ -2,6 +2,7 @@
 #include "test_macros.h"
 
 #include <sstream>
+#include <string>
 
 TEST_NOINLINE double istream_numbers();
 
@@ -37,4 +38,40 @@ static void BM_Istream_numbers(benchmark::State &state) {
 }
 
 BENCHMARK(BM_Istream_numbers)->RangeMultiplier(2)->Range(1024, 4096);
+
+static void BM_Ostream_int(benchmark::State &state) {
+  std::ostringstream s;
+  int i = 0;
+  for (auto _ : state) {
+    s.seekp(0);
+    s << i++ << ' ' << -123456789 << ' ' << 42u;
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_Ostream_int);
+
+static void BM_Ostream_double(benchmark::State &state) {
+  std::ostringstream s;
+  double d = 0.1;
+  for (auto _ : state) {
+    s.seekp(0);
+    s << d << ' ' << std::fixed << 3.14159 << ' ' << std::scientific << 6.02e23;
+    s.unsetf(std::ios_base::floatfield);
+    d += 1.0;
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_Ostream_double);
+
+static void BM_Ostringstream_write(benchmark::State &state) {
+  std::string chunk(state.range(0), 'x');
+  for (auto _ : state) {
+    std::ostringstream s;
+    for (int i = 0; i < 16; ++i)
+      s.write(chunk.data(), chunk.size());
+    benchmark::DoNotOptimize(s);
+  }
+}
+BENCHMARK(BM_Ostringstream_write)->Range(64, 64 << 10);
+
 BENCHMARK_MAIN();
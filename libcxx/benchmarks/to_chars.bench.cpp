@@ -0,0 +1,88 @@
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+template <class T>
+std::vector<T> makeValues() {
+  std::mt19937_64 gen(0xC0FFEE);
+  std::uniform_real_distribution<T> mantissa(1, 10);
+  std::uniform_int_distribution<int> exponent(-30, 30);
+  std::vector<T> values(1024);
+  for (T& v : values)
+    v = static_cast<T>(mantissa(gen) * std::pow(10.0, exponent(gen)));
+  return values;
+}
+
+template <class T>
+void BM_ToCharsShortest(benchmark::State& state) {
+  const std::vector<T> values = makeValues<T>();
+  char buf[64];
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        std::to_chars(buf, buf + sizeof(buf), values[i++ % values.size()]));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_TEMPLATE(BM_ToCharsShortest, float);
+BENCHMARK_TEMPLATE(BM_ToCharsShortest, double);
+
+void BM_ToCharsPrecision(benchmark::State& state) {
+  const std::vector<double> values = makeValues<double>();
+  const auto fmt = static_cast<std::chars_format>(state.range(0));
+  const int precision = static_cast<int>(state.range(1));
+  char buf[512];
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::to_chars(
+        buf, buf + sizeof(buf), values[i++ % values.size()], fmt, precision));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_ToCharsPrecision)
+    ->ArgNames({"fmt", "precision"})
+    ->Args({int(std::chars_format::scientific), 6})
+    ->Args({int(std::chars_format::scientific), 17})
+    ->Args({int(std::chars_format::fixed), 6})
+    ->Args({int(std::chars_format::general), 6})
+    ->Args({int(std::chars_format::hex), 6});
+
+// The printf family is what to_chars replaces.
+void BM_SnprintfShortestRoundTrip(benchmark::State& state) {
+  const std::vector<double> values = makeValues<double>();
+  char buf[64];
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        snprintf(buf, sizeof(buf), "%.17g", values[i++ % values.size()]));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_SnprintfShortestRoundTrip);
+
+void BM_FromChars(benchmark::State& state) {
+  const std::vector<double> values = makeValues<double>();
+  std::vector<std::vector<char>> strings;
+  for (double v : values) {
+    char buf[64];
+    strings.emplace_back(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+  }
+  size_t i = 0;
+  double value;
+  for (auto _ : state) {
+    const std::vector<char>& s = strings[i++ % strings.size()];
+    benchmark::DoNotOptimize(
+        std::from_chars(s.data(), s.data() + s.size(), value));
+  }
+}
+BENCHMARK(BM_FromChars);
+
+} // namespace
+
+BENCHMARK_MAIN();
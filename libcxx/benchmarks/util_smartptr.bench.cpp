@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 
@@ -38,4 +39,26 @@ static void BM_WeakPtrIncDecRef(benchmark::State& st) {
 }
 BENCHMARK(BM_WeakPtrIncDecRef);
 
+static void BM_WeakPtrLock(benchmark::State& st) {
+  auto sp = std::make_shared<int>(42);
+  std::weak_ptr<int> wp(sp);
+  while (st.KeepRunning()) {
+    auto sp2 = wp.lock();
+    benchmark::DoNotOptimize(sp2.get());
+  }
+}
+BENCHMARK(BM_WeakPtrLock);
+
+// Copies a vector of pointers sharing one object, so every element costs an
+// increment on copy and a decrement on destruction. Until the process starts
+// a thread these go through the non-atomic reference count updates.
+static void BM_SharedPtrCopyVector(benchmark::State& st) {
+  std::vector<std::shared_ptr<int> > v(st.range(0), std::make_shared<int>(42));
+  while (st.KeepRunning()) {
+    std::vector<std::shared_ptr<int> > v2(v);
+    benchmark::DoNotOptimize(v2.data());
+  }
+}
+BENCHMARK(BM_SharedPtrCopyVector)->Arg(1024);
+
 BENCHMARK_MAIN();
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <string>
 
 #include "benchmark/benchmark.h"
 
@@ -36,5 +38,38 @@ BENCHMARK_CAPTURE(BM_ConstructIterIter,
   std::vector<std::string>{},
   getRandomStringInputs)->Arg(TestNumInputs);
 
+// Strings, shared_ptrs and vectors are relocated with memcpy when the vector
+// grows; size_t shows the cost of growth alone.
+static std::vector<std::shared_ptr<int> > getSharedPtrInputs(size_t N) {
+  std::vector<std::shared_ptr<int> > inputs;
+  inputs.reserve(N);
+  for (size_t i = 0; i < N; ++i)
+    inputs.push_back(std::make_shared<int>(static_cast<int>(i)));
+  return inputs;
+}
+
+static std::vector<std::vector<int> > getVectorInputs(size_t N) {
+  return std::vector<std::vector<int> >(N, std::vector<int>(4, 42));
+}
+
+BENCHMARK_CAPTURE(BM_PushBack,
+  vector_size_t,
+  std::vector<size_t>{},
+  getRandomIntegerInputs<size_t>)->Arg(TestNumInputs)->Arg(TestNumInputs * 64);
+
+BENCHMARK_CAPTURE(BM_PushBack,
+  vector_string,
+  std::vector<std::string>{},
+  getRandomStringInputs)->Arg(TestNumInputs)->Arg(TestNumInputs * 64);
+
+BENCHMARK_CAPTURE(BM_PushBack,
+  vector_shared_ptr,
+  std::vector<std::shared_ptr<int> >{},
+  getSharedPtrInputs)->Arg(TestNumInputs)->Arg(TestNumInputs * 64);
+
+BENCHMARK_CAPTURE(BM_PushBack,
+  vector_vector,
+  std::vector<std::vector<int> >{},
+  getVectorInputs)->Arg(TestNumInputs)->Arg(TestNumInputs * 64);
 
 BENCHMARK_MAIN();
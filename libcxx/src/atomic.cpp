@@ -0,0 +1,213 @@
+//===------------------------- atomic.cpp ---------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "__config"
+#ifndef _LIBCPP_HAS_NO_THREADS
+
+#include "atomic"
+#include "climits"
+#include "functional"
+#include "thread"
+
+#ifdef __linux__
+
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#else // <- Add other operating systems here
+
+// Baseline needs no new headers
+
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#ifdef __linux__
+
+static void __libcpp_platform_wait_on_address(__cxx_atomic_contention_t const volatile* __ptr,
+                                              __cxx_contention_t __val)
+{
+    syscall(SYS_futex, __ptr, FUTEX_WAIT_PRIVATE, __val, 0, 0, 0);
+}
+
+static void __libcpp_platform_wake_by_address(__cxx_atomic_contention_t const volatile* __ptr,
+                                              bool __notify_one)
+{
+    syscall(SYS_futex, __ptr, FUTEX_WAKE_PRIVATE, __notify_one ? 1 : INT_MAX, 0, 0, 0);
+}
+
+#elif defined(__APPLE__)
+
+extern "C" int __ulock_wait(uint32_t __operation, void* __addr, uint64_t __value,
+                            uint32_t __timeout); /* timeout is in microseconds */
+extern "C" int __ulock_wake(uint32_t __operation, void* __addr, uint64_t __wake_value);
+
+#define UL_COMPARE_AND_WAIT64 5
+#define ULF_WAKE_ALL          0x00000100
+
+static void __libcpp_platform_wait_on_address(__cxx_atomic_contention_t const volatile* __ptr,
+                                              __cxx_contention_t __val)
+{
+    static_assert(sizeof(__cxx_atomic_contention_t) == 8, "Waiting calls require 8-byte contention types");
+    __ulock_wait(UL_COMPARE_AND_WAIT64, const_cast<__cxx_atomic_contention_t*>(__ptr), __val, 0);
+}
+
+static void __libcpp_platform_wake_by_address(__cxx_atomic_contention_t const volatile* __ptr,
+                                              bool __notify_one)
+{
+    __ulock_wake(UL_COMPARE_AND_WAIT64 | (__notify_one ? 0 : ULF_WAKE_ALL),
+                 const_cast<__cxx_atomic_contention_t*>(__ptr), 0);
+}
+
+#else // <- Add other operating systems here
+
+// Baseline is just a timed backoff
+
+static void __libcpp_platform_wait_on_address(__cxx_atomic_contention_t const volatile* __ptr,
+                                              __cxx_contention_t __val)
+{
+    __libcpp_thread_poll_with_backoff([=]() -> bool {
+        return __cxx_atomic_load(__ptr, memory_order_relaxed) != __val;
+    }, __libcpp_timed_backoff_policy());
+}
+
+static void __libcpp_platform_wake_by_address(__cxx_atomic_contention_t const volatile*, bool) { }
+
+#endif // __linux__
+
+// The table is a power of two so the hash can be masked; 256 entries keeps
+// unrelated atomics from sharing an entry without costing much memory.
+static constexpr size_t __libcpp_contention_table_size = (1 << 8);
+
+// Each entry gets its own cache line so that waiters on unrelated atomics
+// don't contend on the counters.
+struct alignas(64) __libcpp_contention_table_entry
+{
+    __cxx_atomic_contention_t __contention_state;
+    __cxx_atomic_contention_t __platform_state;
+    inline constexpr __libcpp_contention_table_entry() :
+        __contention_state(0), __platform_state(0) { }
+};
+
+static __libcpp_contention_table_entry __libcpp_contention_table[ __libcpp_contention_table_size ];
+
+static hash<void const volatile*> __libcpp_contention_hasher;
+
+static __libcpp_contention_table_entry* __libcpp_contention_state(void const volatile * __p)
+{
+    return &__libcpp_contention_table[__libcpp_contention_hasher(__p) & (__libcpp_contention_table_size - 1)];
+}
+
+// Given an atomic to track contention and an atomic to actually wait on, which
+// may be the same atomic, we try to detect contention to avoid spuriously
+// calling the platform.
+
+static void __libcpp_contention_notify(__cxx_atomic_contention_t volatile* __contention_state,
+                                       __cxx_atomic_contention_t const volatile* __platform_state,
+                                       bool __notify_one)
+{
+    // Order the caller's store to the waited-on atomic before the read of
+    // the waiter count. The waiter does the opposite in
+    // __libcpp_contention_wait, so at least one side sees the other.
+    __cxx_atomic_thread_fence(memory_order_seq_cst);
+    if (0 != __cxx_atomic_load(__contention_state, memory_order_seq_cst))
+        __libcpp_platform_wake_by_address(__platform_state, __notify_one);
+}
+
+static __cxx_contention_t __libcpp_contention_monitor_for_wait(__cxx_atomic_contention_t const volatile* __platform_state)
+{
+    // We will monitor this value.
+    return __cxx_atomic_load(__platform_state, memory_order_acquire);
+}
+
+static void __libcpp_contention_wait(__cxx_atomic_contention_t volatile* __contention_state,
+                                     __cxx_atomic_contention_t const volatile* __platform_state,
+                                     __cxx_contention_t __old_value)
+{
+    __cxx_atomic_fetch_add(__contention_state, __cxx_contention_t(1), memory_order_seq_cst);
+    // Order the increment before the platform's read of the monitored value,
+    // which is not an atomic operation of ours. This pairs with the fence in
+    // __libcpp_contention_notify: either the notifier sees the waiter, or the
+    // platform sees the new value and does not sleep.
+    __cxx_atomic_thread_fence(memory_order_seq_cst);
+    // We sleep as long as the monitored value hasn't changed.
+    __libcpp_platform_wait_on_address(__platform_state, __old_value);
+    __cxx_atomic_fetch_sub(__contention_state, __cxx_contention_t(1), memory_order_release);
+}
+
+// When the incoming atomic is the wrong size for the platform wait, waiters
+// park on the table entry's counter instead, and notify has to bump it.
+
+static void __libcpp_atomic_notify(void const volatile* __location)
+{
+    auto const __entry = __libcpp_contention_state(__location);
+    __cxx_atomic_fetch_add(&__entry->__platform_state, __cxx_contention_t(1), memory_order_release);
+    // The counter is shared by every atomic hashing to this entry, so waking
+    // just one waiter might wake the wrong one.
+    __libcpp_contention_notify(&__entry->__contention_state,
+                               &__entry->__platform_state,
+                               false);
+}
+
+void __cxx_atomic_notify_one(void const volatile* __location)
+    { __libcpp_atomic_notify(__location); }
+
+void __cxx_atomic_notify_all(void const volatile* __location)
+    { __libcpp_atomic_notify(__location); }
+
+__cxx_contention_t __libcpp_atomic_monitor(void const volatile* __location)
+{
+    return __libcpp_contention_monitor_for_wait(&__libcpp_contention_state(__location)->__platform_state);
+}
+
+void __libcpp_atomic_wait(void const volatile* __location, __cxx_contention_t __old_value)
+{
+    auto const __entry = __libcpp_contention_state(__location);
+    __libcpp_contention_wait(&__entry->__contention_state, &__entry->__platform_state, __old_value);
+}
+
+// When the incoming atomic happens to be the platform wait size, we still
+// need the table for contention detection, but can wait on the atomic itself.
+
+void __cxx_atomic_notify_one(__cxx_atomic_contention_t const volatile* __location)
+{
+    __libcpp_contention_notify(&__libcpp_contention_state(__location)->__contention_state,
+                               __location,
+                               true);
+}
+
+void __cxx_atomic_notify_all(__cxx_atomic_contention_t const volatile* __location)
+{
+    __libcpp_contention_notify(&__libcpp_contention_state(__location)->__contention_state,
+                               __location,
+                               false);
+}
+
+__cxx_contention_t __libcpp_atomic_monitor(__cxx_atomic_contention_t const volatile* __location)
+{
+    return __libcpp_contention_monitor_for_wait(__location);
+}
+
+void __libcpp_atomic_wait(__cxx_atomic_contention_t const volatile* __location, __cxx_contention_t __old_value)
+{
+    __libcpp_contention_wait(&__libcpp_contention_state(__location)->__contention_state,
+                             __location,
+                             __old_value);
+}
+
+bool __libcpp_atomic_can_spin() _NOEXCEPT
+{
+    // hardware_concurrency() returns 0 when it can't tell; assume we can spin.
+    static const bool __can_spin = thread::hardware_concurrency() != 1;
+    return __can_spin;
+}
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif //_LIBCPP_HAS_NO_THREADS
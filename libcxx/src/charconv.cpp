@@ -7,8 +7,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "charconv"
+#include "locale"
+#include "memory"
+#include <errno.h>
+#include <float.h>
 #include <string.h>
 
+#include "include/ryu_tables.h"
+
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 namespace __itoa
@@ -157,4 +163,1270 @@ __u64toa(uint64_t value, char* buffer)
 
 }  // namespace __itoa
 
+namespace
+{
+
+// Shortest round trip digits (Ryu) -----------------------------------------
+//
+// Ulf Adams, "Ryu: Fast Float-to-String Conversion", PLDI 2018. d2d and f2d
+// find the shortest decimal mantissa and exponent that parse back to the
+// given value, choosing the one closest to it.
+
+struct decimal_fp
+{
+    uint64_t mantissa;
+    int32_t exponent;
+};
+
+inline int32_t pow5bits(int32_t e)
+{
+    // ceil(log2(5^e)) for e in [1, 3528], 1 for e == 0.
+    return static_cast<int32_t>(((static_cast<uint32_t>(e) * 1217359) >> 19) + 1);
+}
+
+inline uint32_t log10_pow2(int32_t e)
+{
+    // floor(log10(2^e)) for e in [0, 1650].
+    return (static_cast<uint32_t>(e) * 78913) >> 18;
+}
+
+inline uint32_t log10_pow5(int32_t e)
+{
+    // floor(log10(5^e)) for e in [0, 2620].
+    return (static_cast<uint32_t>(e) * 732923) >> 20;
+}
+
+inline uint32_t pow5_factor(uint64_t value)
+{
+    uint32_t count = 0;
+    for (;;)
+    {
+        const uint64_t q = value / 5;
+        if (value - 5 * q != 0)
+            break;
+        value = q;
+        ++count;
+    }
+    return count;
+}
+
+inline bool multiple_of_pow5(uint64_t value, uint32_t p)
+{
+    return pow5_factor(value) >= p;
+}
+
+inline bool multiple_of_pow2(uint64_t value, uint32_t p)
+{
+    return (value & ((uint64_t(1) << p) - 1)) == 0;
+}
+
+#ifdef _LIBCPP_HAS_NO_INT128
+inline uint64_t umul128(uint64_t a, uint64_t b, uint64_t* high)
+{
+    const uint64_t a_lo = static_cast<uint32_t>(a);
+    const uint64_t a_hi = a >> 32;
+    const uint64_t b_lo = static_cast<uint32_t>(b);
+    const uint64_t b_hi = b >> 32;
+
+    const uint64_t b00 = a_lo * b_lo;
+    const uint64_t b01 = a_lo * b_hi;
+    const uint64_t b10 = a_hi * b_lo;
+    const uint64_t b11 = a_hi * b_hi;
+
+    const uint64_t mid1 = b10 + (b00 >> 32);
+    const uint64_t mid2 = b01 + static_cast<uint32_t>(mid1);
+
+    *high = b11 + (mid1 >> 32) + (mid2 >> 32);
+    return (mid2 << 32) | static_cast<uint32_t>(b00);
+}
+#endif
+
+// Returns (m * mul) >> j, where mul is a 128-bit {low, high} multiplier and
+// 64 < j < 128.
+inline uint64_t mul_shift64(uint64_t m, const uint64_t* mul, int32_t j)
+{
+#ifndef _LIBCPP_HAS_NO_INT128
+    const __uint128_t b0 = static_cast<__uint128_t>(m) * mul[0];
+    const __uint128_t b2 = static_cast<__uint128_t>(m) * mul[1];
+    return static_cast<uint64_t>(((b0 >> 64) + b2) >> (j - 64));
+#else
+    uint64_t high0;
+    umul128(m, mul[0], &high0);
+    uint64_t high1;
+    const uint64_t low1 = umul128(m, mul[1], &high1);
+    const uint64_t sum = high0 + low1;
+    if (sum < high0)
+        ++high1;
+    const int32_t shift = j - 64;
+    return (high1 << (64 - shift)) | (sum >> shift);
+#endif
+}
+
+decimal_fp d2d(uint64_t ieee_mantissa, uint32_t ieee_exponent)
+{
+    const int mantissa_bits = 52;
+    const int bias = 1023;
+
+    int32_t e2;
+    uint64_t m2;
+    if (ieee_exponent == 0)
+    {
+        // Subtract 2 so that the bounds computation has 2 additional bits.
+        e2 = 1 - bias - mantissa_bits - 2;
+        m2 = ieee_mantissa;
+    }
+    else
+    {
+        e2 = static_cast<int32_t>(ieee_exponent) - bias - mantissa_bits - 2;
+        m2 = (uint64_t(1) << mantissa_bits) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    // The interval of valid decimal representations is [mm, mp] around mv,
+    // all scaled by 4.
+    const uint64_t mv = 4 * m2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    // Convert to a decimal power base.
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    if (e2 >= 0)
+    {
+        const uint32_t q = log10_pow2(e2) - (e2 > 3);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = __ryu::__double_pow5_inv_bitcount +
+                          pow5bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        const uint64_t* mul = __ryu::__double_pow5_inv_split[q];
+        vr = mul_shift64(4 * m2, mul, i);
+        vp = mul_shift64(4 * m2 + 2, mul, i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, mul, i);
+        if (q <= 21)
+        {
+            // Only one of mp, mv, and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            else
+                vp -= multiple_of_pow5(mv + 2, q);
+        }
+    }
+    else
+    {
+        const uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5bits(i) - __ryu::__double_pow5_bitcount;
+        const int32_t j = static_cast<int32_t>(q) - k;
+        const uint64_t* mul = __ryu::__double_pow5_split[i];
+        vr = mul_shift64(4 * m2, mul, j);
+        vp = mul_shift64(4 * m2 + 2, mul, j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, mul, j);
+        if (q <= 1)
+        {
+            // mv = 4 * m2 always has at least two trailing 0 bits.
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                // mm = mv - 1 - mm_shift has 1 trailing 0 bit iff mm_shift == 1.
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                // mp = mv + 2 always has at least one trailing 0 bit.
+                --vp;
+        }
+        else if (q < 63)
+        {
+            // We want to know if the full product has at least q trailing
+            // zeros, i.e. whether mv is a multiple of 2^q (since -e2 >= q).
+            vr_is_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    // Find the shortest representation in the interval.
+    int32_t removed = 0;
+    uint8_t last_removed_digit = 0;
+    uint64_t output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros)
+    {
+        // General case, which happens rarely (~0.7%).
+        while (vp / 10 > vm / 10)
+        {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_is_trailing_zeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+        {
+            // Round even if the exact number is .....50..0.
+            last_removed_digit = 4;
+        }
+        // We need to take vr + 1 if vr is outside bounds or we need to round
+        // up.
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) ||
+                       last_removed_digit >= 5);
+    }
+    else
+    {
+        // Specialized for the common case (~99.3%).
+        bool round_up = false;
+        if (vp / 100 > vm / 100)
+        {
+            // Remove two digits at a time.
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10)
+        {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    return {output, e10 + removed};
+}
+
+// Returns (m * factor) >> shift, where 32 <= shift.
+inline uint32_t mul_shift32(uint32_t m, uint64_t factor, int32_t shift)
+{
+    const uint64_t bits0 = static_cast<uint64_t>(m) * static_cast<uint32_t>(factor);
+    const uint64_t bits1 = static_cast<uint64_t>(m) * (factor >> 32);
+    return static_cast<uint32_t>(((bits0 >> 32) + bits1) >> (shift - 32));
+}
+
+decimal_fp f2d(uint32_t ieee_mantissa, uint32_t ieee_exponent)
+{
+    const int mantissa_bits = 23;
+    const int bias = 127;
+
+    int32_t e2;
+    uint32_t m2;
+    if (ieee_exponent == 0)
+    {
+        e2 = 1 - bias - mantissa_bits - 2;
+        m2 = ieee_mantissa;
+    }
+    else
+    {
+        e2 = static_cast<int32_t>(ieee_exponent) - bias - mantissa_bits - 2;
+        m2 = (uint32_t(1) << mantissa_bits) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    const uint32_t mv = 4 * m2;
+    const uint32_t mp = 4 * m2 + 2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    const uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+    uint32_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false;
+    bool vr_is_trailing_zeros = false;
+    uint8_t last_removed_digit = 0;
+    if (e2 >= 0)
+    {
+        const uint32_t q = log10_pow2(e2);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = __ryu::__float_pow5_inv_bitcount +
+                          pow5bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        vr = mul_shift32(mv, __ryu::__float_pow5_inv_split[q], i);
+        vp = mul_shift32(mp, __ryu::__float_pow5_inv_split[q], i);
+        vm = mul_shift32(mm, __ryu::__float_pow5_inv_split[q], i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10)
+        {
+            // We need to know one removed digit even if we are not going to
+            // loop below.
+            const int32_t l = __ryu::__float_pow5_inv_bitcount +
+                              pow5bits(static_cast<int32_t>(q - 1)) - 1;
+            last_removed_digit = static_cast<uint8_t>(
+                mul_shift32(mv, __ryu::__float_pow5_inv_split[q - 1],
+                            -e2 + static_cast<int32_t>(q) - 1 + l) %
+                10);
+        }
+        if (q <= 9)
+        {
+            // Only one of mp, mv, and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = multiple_of_pow5(mm, q);
+            else
+                vp -= multiple_of_pow5(mp, q);
+        }
+    }
+    else
+    {
+        const uint32_t q = log10_pow5(-e2);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5bits(i) - __ryu::__float_pow5_bitcount;
+        int32_t j = static_cast<int32_t>(q) - k;
+        vr = mul_shift32(mv, __ryu::__float_pow5_split[i], j);
+        vp = mul_shift32(mp, __ryu::__float_pow5_split[i], j);
+        vm = mul_shift32(mm, __ryu::__float_pow5_split[i], j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10)
+        {
+            j = static_cast<int32_t>(q) - 1 -
+                (pow5bits(i + 1) - __ryu::__float_pow5_bitcount);
+            last_removed_digit = static_cast<uint8_t>(
+                mul_shift32(mv, __ryu::__float_pow5_split[i + 1], j) % 10);
+        }
+        if (q <= 1)
+        {
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                --vp;
+        }
+        else if (q < 31)
+        {
+            vr_is_trailing_zeros = multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    int32_t removed = 0;
+    uint32_t output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros)
+    {
+        while (vp / 10 > vm / 10)
+        {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_is_trailing_zeros)
+        {
+            while (vm % 10 == 0)
+            {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = static_cast<uint8_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) ||
+                       last_removed_digit >= 5);
+    }
+    else
+    {
+        while (vp / 10 > vm / 10)
+        {
+            last_removed_digit = static_cast<uint8_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || last_removed_digit >= 5);
+    }
+    return {output, e10 + removed};
+}
+
+// Decimal digits -----------------------------------------------------------
+
+// A finite non-negative value digits * 10^exponent. The digits have no
+// leading or trailing zeros, except for zero, which is the single digit "0"
+// with exponent 0.
+struct decimal_digits
+{
+    char* digits;
+    int length;
+    int exponent;
+
+    bool is_zero() const { return digits[0] == '0'; }
+
+    // The exponent of the first digit in scientific notation.
+    int scientific_exponent() const
+    {
+        return is_zero() ? 0 : length - 1 + exponent;
+    }
+
+    void strip_trailing_zeros()
+    {
+        while (length > 1 && digits[length - 1] == '0')
+        {
+            --length;
+            ++exponent;
+        }
+    }
+
+    void set_zero()
+    {
+        digits[0] = '0';
+        length = 1;
+        exponent = 0;
+    }
+
+    // Returns true if rounding to the first `keep` digits, half to even,
+    // rounds up. keep must be below length.
+    bool rounds_up(int keep) const
+    {
+        if (keep < 0)
+            return false;
+        const char next = digits[keep];
+        if (next != '5')
+            return next > '5';
+        if (keep + 1 < length)
+            return true; // There are no trailing zeros.
+        return keep > 0 && (digits[keep - 1] - '0') % 2 == 1;
+    }
+
+    // Rounds to the first `keep` digits, half to even.
+    void round(int keep)
+    {
+        if (keep < length)
+            truncate(keep, rounds_up(keep));
+    }
+
+    // Drops all but the first `keep` digits, and adds one to the last digit
+    // kept if `up`.
+    void truncate(int keep, bool up)
+    {
+        if (keep >= length)
+            return;
+        if (keep <= 0)
+        {
+            if (!up)
+            {
+                set_zero();
+                return;
+            }
+            exponent += length;
+            digits[0] = '1';
+            length = 1;
+            return;
+        }
+        exponent += length - keep;
+        length = keep;
+        if (up)
+        {
+            int i = keep - 1;
+            while (i >= 0 && digits[i] == '9')
+                --i;
+            if (i < 0)
+            {
+                exponent += keep;
+                digits[0] = '1';
+                length = 1;
+                return;
+            }
+            ++digits[i];
+            exponent += keep - 1 - i;
+            length = i + 1;
+            return;
+        }
+        strip_trailing_zeros();
+    }
+};
+
+// Writes the exact decimal expansion of m * 2^e2 to buffer, where m is the
+// number in the first size elements of words, least significant first. words
+// must have room for m * 2^e2 or m * 5^-e2, and buffer and reversed for its
+// digits, plus eight.
+decimal_digits exact_digits(uint32_t* words, int size, int e2, char* buffer,
+                            char* reversed)
+{
+    decimal_digits d = {buffer, 1, 0};
+    while (size > 0 && words[size - 1] == 0)
+        --size;
+    if (size == 0)
+    {
+        d.set_zero();
+        return d;
+    }
+
+    // m * 2^e2 is m << e2, or m * 5^-e2 * 10^e2.
+    // Multiplies the big integer by factor < 2^32.
+    auto multiply = [&](uint32_t factor) {
+        uint64_t carry = 0;
+        for (int i = 0; i < size; ++i)
+        {
+            const uint64_t product = static_cast<uint64_t>(words[i]) * factor + carry;
+            words[i] = static_cast<uint32_t>(product);
+            carry = product >> 32;
+        }
+        if (carry != 0)
+            words[size++] = static_cast<uint32_t>(carry);
+    };
+    if (e2 >= 0)
+    {
+        for (; e2 >= 31; e2 -= 31)
+            multiply(uint32_t(1) << 31);
+        multiply(uint32_t(1) << e2);
+    }
+    else
+    {
+        d.exponent = e2;
+        int e5 = -e2;
+        for (; e5 >= 13; e5 -= 13)
+            multiply(1220703125); // 5^13
+        uint32_t rest = 1;
+        for (; e5 > 0; --e5)
+            rest *= 5;
+        multiply(rest);
+    }
+
+    // Peel off nine digits at a time, least significant first.
+    int count = 0;
+    while (size > 0)
+    {
+        uint64_t remainder = 0;
+        for (int i = size - 1; i >= 0; --i)
+        {
+            const uint64_t current = (remainder << 32) | words[i];
+            words[i] = static_cast<uint32_t>(current / 1000000000);
+            remainder = current % 1000000000;
+        }
+        while (size > 0 && words[size - 1] == 0)
+            --size;
+        for (int i = 0; i < 9; ++i)
+        {
+            reversed[count++] = static_cast<char>('0' + remainder % 10);
+            remainder /= 10;
+        }
+    }
+    while (reversed[count - 1] == '0')
+        --count;
+    for (int i = 0; i < count; ++i)
+        buffer[i] = reversed[count - 1 - i];
+    d.length = count;
+    d.strip_trailing_zeros();
+    return d;
+}
+
+// Writes the exact decimal expansion of m * 2^e2, for a float or a double, to
+// buffer, which must hold 810 digits.
+decimal_digits exact_digits(uint64_t m, int e2, char* buffer)
+{
+    // Either m << e2 or m * 5^-e2 fits in 2560 bits.
+    uint32_t words[80] = {static_cast<uint32_t>(m),
+                          static_cast<uint32_t>(m >> 32)};
+    char reversed[810];
+    return exact_digits(words, 2, e2, buffer, reversed);
+}
+
+decimal_digits shortest_digits(uint64_t mantissa, int32_t exponent, char* buffer)
+{
+    decimal_digits d = {buffer, 1, exponent};
+    d.length = static_cast<int>(__itoa::__u64toa(mantissa, buffer) - buffer);
+    if (d.is_zero())
+        d.exponent = 0;
+    d.strip_trailing_zeros();
+    return d;
+}
+
+// Formatting ---------------------------------------------------------------
+
+int exponent_length(int exponent, int min_digits)
+{
+    int n = 1;
+    for (int e = exponent < 0 ? -exponent : exponent; e >= 10; e /= 10)
+        ++n;
+    return 2 + (n < min_digits ? min_digits : n);
+}
+
+char* write_exponent(char* p, char marker, int exponent, int min_digits)
+{
+    *p++ = marker;
+    *p++ = exponent < 0 ? '-' : '+';
+    char digits[8];
+    int n = 0;
+    for (unsigned e = exponent < 0 ? -exponent : exponent; e != 0 || n < min_digits;
+         e /= 10)
+        digits[n++] = static_cast<char>('0' + e % 10);
+    while (n > 0)
+        *p++ = digits[--n];
+    return p;
+}
+
+char* fill_zeros(char* p, int count)
+{
+    if (count <= 0)
+        return p;
+    memset(p, '0', static_cast<size_t>(count));
+    return p + count;
+}
+
+size_t scientific_length(const decimal_digits& d, int precision)
+{
+    return 1 + (precision > 0 ? 1 + static_cast<size_t>(precision) : 0) +
+           exponent_length(d.scientific_exponent(), 2);
+}
+
+// Writes d with precision digits after the decimal point. d must not have
+// more digits than that.
+to_chars_result write_scientific(char* first, char* last, const decimal_digits& d,
+                                 int precision)
+{
+    if (static_cast<size_t>(last - first) < scientific_length(d, precision))
+        return {last, errc::value_too_large};
+    char* p = first;
+    *p++ = d.digits[0];
+    if (precision > 0)
+    {
+        *p++ = '.';
+        memcpy(p, d.digits + 1, static_cast<size_t>(d.length - 1));
+        p = fill_zeros(p + d.length - 1, precision - (d.length - 1));
+    }
+    return {write_exponent(p, 'e', d.scientific_exponent(), 2), errc{}};
+}
+
+size_t fixed_length(const decimal_digits& d, int precision)
+{
+    const int integer_digits = d.length + d.exponent;
+    return (integer_digits > 0 ? static_cast<size_t>(integer_digits) : 1) +
+           (precision > 0 ? 1 + static_cast<size_t>(precision) : 0);
+}
+
+// Writes d with precision digits after the decimal point. d must not have
+// digits beyond that.
+to_chars_result write_fixed(char* first, char* last, const decimal_digits& d,
+                            int precision)
+{
+    if (static_cast<size_t>(last - first) < fixed_length(d, precision))
+        return {last, errc::value_too_large};
+    char* p = first;
+    const int integer_digits = d.is_zero() ? 0 : d.length + d.exponent;
+    if (integer_digits <= 0)
+        *p++ = '0';
+    else if (integer_digits <= d.length)
+    {
+        memcpy(p, d.digits, static_cast<size_t>(integer_digits));
+        p += integer_digits;
+    }
+    else
+    {
+        memcpy(p, d.digits, static_cast<size_t>(d.length));
+        p = fill_zeros(p + d.length, integer_digits - d.length);
+    }
+    if (precision > 0)
+    {
+        *p++ = '.';
+        const int leading_zeros =
+            integer_digits < 0 ? (-integer_digits < precision ? -integer_digits
+                                                                : precision)
+                               : 0;
+        p = fill_zeros(p, leading_zeros);
+        const int start = integer_digits > 0 ? integer_digits : 0;
+        int copied = d.is_zero() ? 0 : d.length - start;
+        if (copied < 0)
+            copied = 0;
+        if (copied > precision - leading_zeros)
+            copied = precision - leading_zeros;
+        memcpy(p, d.digits + start, static_cast<size_t>(copied));
+        p = fill_zeros(p + copied, precision - leading_zeros - copied);
+    }
+    return {p, errc{}};
+}
+
+to_chars_result write_special(char* first, char* last, bool negative,
+                              bool is_nan)
+{
+    const char* text = is_nan ? "nan" : "inf";
+    const size_t length = 3 + negative;
+    if (static_cast<size_t>(last - first) < length)
+        return {last, errc::value_too_large};
+    if (negative)
+        *first++ = '-';
+    memcpy(first, text, 3);
+    return {first + 3, errc{}};
+}
+
+// Uses the %g rule that picks fixed notation for exponents in [-4, P).
+bool use_fixed_for_general(int scientific_exponent, int P)
+{
+    return -4 <= scientific_exponent && scientific_exponent < P;
+}
+
+// Writes the shortest digits in the notation fmt asks for. A zero fmt is the
+// plain to_chars(first, last, value) overload.
+to_chars_result write_shortest(char* first, char* last, const decimal_digits& d,
+                               chars_format fmt)
+{
+    const int scientific_precision = d.length - 1;
+    const int fixed_precision = d.exponent < 0 ? -d.exponent : 0;
+    bool fixed;
+    if (fmt == chars_format::fixed)
+        fixed = true;
+    else if (fmt == chars_format::scientific)
+        fixed = false;
+    else if (fmt == chars_format::general)
+        fixed = use_fixed_for_general(d.scientific_exponent(), 6);
+    else
+        fixed = fixed_length(d, fixed_precision) <=
+                scientific_length(d, scientific_precision);
+    if (fixed)
+        return write_fixed(first, last, d, fixed_precision);
+    return write_scientific(first, last, d, scientific_precision);
+}
+
+to_chars_result write_precision(char* first, char* last, decimal_digits d,
+                                chars_format fmt, int precision)
+{
+    if (fmt == chars_format::fixed)
+    {
+        d.round(d.length + d.exponent + precision);
+        return write_fixed(first, last, d, precision);
+    }
+    if (fmt == chars_format::scientific)
+    {
+        d.round(precision + 1);
+        return write_scientific(first, last, d, precision);
+    }
+    // %g removes trailing zeros, and so does round().
+    const int P = precision == 0 ? 1 : precision;
+    d.round(P);
+    if (use_fixed_for_general(d.scientific_exponent(), P))
+        return write_fixed(first, last, d, d.exponent < 0 ? -d.exponent : 0);
+    return write_scientific(first, last, d, d.length - 1);
+}
+
+// Writes leading, followed by the hex digits of the fraction, given as the
+// values of its first nibbles, most significant first.
+to_chars_result write_hex(char* first, char* last, unsigned leading,
+                          char* fraction, int nibbles, int exponent,
+                          int precision)
+{
+    if (precision < 0)
+    {
+        // Shortest: drop the trailing zero nibbles.
+        while (nibbles > 0 && fraction[nibbles - 1] == 0)
+            --nibbles;
+        precision = nibbles;
+    }
+    else if (precision < nibbles)
+    {
+        // Round half to even.
+        bool up = fraction[precision] > 8;
+        if (fraction[precision] == 8)
+        {
+            up = precision > 0 ? fraction[precision - 1] % 2 == 1
+                               : leading % 2 == 1;
+            for (int i = precision + 1; i < nibbles; ++i)
+                if (fraction[i] != 0)
+                    up = true;
+        }
+        nibbles = precision;
+        if (up)
+        {
+            int i = nibbles - 1;
+            while (i >= 0 && fraction[i] == 15)
+                fraction[i--] = 0;
+            if (i >= 0)
+                ++fraction[i];
+            else
+                ++leading;
+        }
+    }
+
+    const size_t length = 1 + (precision > 0 ? 1 + static_cast<size_t>(precision) : 0) +
+                          exponent_length(exponent, 1);
+    if (static_cast<size_t>(last - first) < length)
+        return {last, errc::value_too_large};
+    static const char hex_digits[] = "0123456789abcdef";
+    char* p = first;
+    *p++ = hex_digits[leading];
+    if (precision > 0)
+    {
+        *p++ = '.';
+        for (int i = 0; i < nibbles; ++i)
+            *p++ = hex_digits[static_cast<int>(fraction[i])];
+        p = fill_zeros(p, precision - nibbles);
+    }
+    return {write_exponent(p, 'p', exponent, 1), errc{}};
+}
+
+// IEEE-754 binary32 and binary64 layouts.
+template <class _Fp>
+struct float_layout;
+
+template <>
+struct float_layout<float>
+{
+    typedef uint32_t bits_type;
+    static const int mantissa_bits = 23;
+    static const int exponent_bits = 8;
+    static const int bias = 127;
+    static decimal_fp shortest(uint32_t mantissa, uint32_t exponent)
+    {
+        return f2d(mantissa, exponent);
+    }
+};
+
+template <>
+struct float_layout<double>
+{
+    typedef uint64_t bits_type;
+    static const int mantissa_bits = 52;
+    static const int exponent_bits = 11;
+    static const int bias = 1023;
+    static decimal_fp shortest(uint64_t mantissa, uint32_t exponent)
+    {
+        return d2d(mantissa, exponent);
+    }
+};
+
+// A precision below zero asks for the shortest representation.
+template <class _Fp>
+to_chars_result floating_to_chars(char* first, char* last, _Fp value,
+                                  chars_format fmt, int precision)
+{
+    typedef float_layout<_Fp> layout;
+    typedef typename layout::bits_type bits_type;
+    bits_type bits;
+    static_assert(sizeof(bits) == sizeof(value), "");
+    memcpy(&bits, &value, sizeof(bits));
+
+    const bool negative = (bits >> (sizeof(bits) * 8 - 1)) != 0;
+    const uint32_t ieee_exponent = static_cast<uint32_t>(
+        (bits >> layout::mantissa_bits) & ((1u << layout::exponent_bits) - 1));
+    const bits_type ieee_mantissa =
+        bits & ((bits_type(1) << layout::mantissa_bits) - 1);
+
+    if (ieee_exponent == (1u << layout::exponent_bits) - 1)
+        return write_special(first, last, negative, ieee_mantissa != 0);
+
+    if (negative)
+    {
+        if (first == last)
+            return {last, errc::value_too_large};
+        *first++ = '-';
+    }
+
+    if (fmt == chars_format::hex)
+    {
+        // Pad the mantissa to whole nibbles.
+        const int nibbles = (layout::mantissa_bits + 3) / 4;
+        const uint64_t fraction = static_cast<uint64_t>(ieee_mantissa)
+                                  << (4 * nibbles - layout::mantissa_bits);
+        int exponent = static_cast<int>(ieee_exponent) - layout::bias;
+        unsigned leading = 1;
+        if (ieee_exponent == 0)
+        {
+            leading = 0;
+            exponent = ieee_mantissa == 0 ? 0 : 1 - layout::bias;
+        }
+        char fraction_nibbles[16];
+        for (int i = 0; i < nibbles; ++i)
+            fraction_nibbles[i] =
+                static_cast<char>((fraction >> (4 * (nibbles - 1 - i))) & 0xF);
+        return write_hex(first, last, leading, fraction_nibbles, nibbles,
+                         exponent, precision);
+    }
+
+    char buffer[810];
+    if (precision < 0)
+    {
+        const decimal_fp shortest =
+            ieee_exponent == 0 && ieee_mantissa == 0
+                ? decimal_fp{0, 0}
+                : layout::shortest(ieee_mantissa, ieee_exponent);
+        return write_shortest(first, last,
+                              shortest_digits(shortest.mantissa,
+                                              shortest.exponent, buffer),
+                              fmt);
+    }
+
+    uint64_t m = ieee_mantissa;
+    int e2 = 1 - layout::bias - layout::mantissa_bits;
+    if (ieee_exponent != 0)
+    {
+        m |= uint64_t(1) << layout::mantissa_bits;
+        e2 = static_cast<int>(ieee_exponent) - layout::bias - layout::mantissa_bits;
+    }
+    return write_precision(first, last, exact_digits(m, e2, buffer), fmt,
+                           precision);
+}
+
+#if LDBL_MANT_DIG != DBL_MANT_DIG
+
+// long double is wider than double, and its layout depends on the target: the
+// x87 80-bit format, IEEE-754 binary128, or a pair of doubles. It is converted
+// from its exact value m * 2^e2, taken apart with frexp and ldexp, which works
+// for all of them.
+
+// Bounds on -e2, on the 32-bit words of m * 5^-e2, which is below
+// LDBL_MAX * 10^-e2, and on its decimal digits.
+const int long_double_max_e2 = LDBL_MANT_DIG - LDBL_MIN_EXP + 32;
+const int long_double_words =
+    (LDBL_MAX_EXP + long_double_max_e2 * 10 / 3) / 32 + 2;
+const int long_double_digits = LDBL_MAX_10_EXP + long_double_max_e2 + 18;
+
+// Stores the finite, non-negative value as m * 2^e2, with m in words, least
+// significant first, and returns the number of words.
+int decompose(long double value, uint32_t* words, int& e2)
+{
+    int size = 0;
+    long double fraction = frexpl(value, &e2);
+    // Take 32 bits at a time, most significant first. All steps are exact.
+    while (fraction != 0)
+    {
+        fraction = ldexpl(fraction, 32);
+        const uint32_t word = static_cast<uint32_t>(fraction);
+        fraction -= word;
+        words[size++] = word;
+        e2 -= 32;
+    }
+    for (int i = 0, j = size - 1; i < j; ++i, --j)
+    {
+        const uint32_t word = words[i];
+        words[i] = words[j];
+        words[j] = word;
+    }
+    return size;
+}
+
+// Returns true if strtold reads d back as value.
+bool reads_back(const decimal_digits& d, long double value, char* text,
+                size_t size)
+{
+    to_chars_result r = write_scientific(text, text + size - 1, d, d.length - 1);
+    *r.ptr = '\0';
+    typename remove_reference<decltype(errno)>::type saved_errno = errno;
+    char* end;
+    const bool same = __do_strtod<long double>(text, &end) == value;
+    errno = saved_errno;
+    return same;
+}
+
+// Finds the shortest digits that read back as value, from its exact digits.
+// Of the two candidates with a given number of digits, the ones just below and
+// above the exact value, the nearer one is tried first.
+decimal_digits shortest_digits(long double value, const decimal_digits& exact,
+                               char* buffer, char* text, size_t text_size)
+{
+    for (int keep = 1; keep < exact.length; ++keep)
+    {
+        const bool up = exact.rounds_up(keep);
+        for (int i = 0; i < 2; ++i)
+        {
+            decimal_digits d = {buffer, exact.length, exact.exponent};
+            memcpy(buffer, exact.digits, static_cast<size_t>(keep));
+            d.truncate(keep, i == 0 ? up : !up);
+            if (reads_back(d, value, text, text_size))
+                return d;
+        }
+    }
+    return exact;
+}
+
+to_chars_result long_double_to_chars(char* first, char* last,
+                                     long double value, chars_format fmt,
+                                     int precision)
+{
+    const bool negative = signbit(value);
+    if (value != value)
+        return write_special(first, last, negative, true);
+    if (value == numeric_limits<long double>::infinity() ||
+        value == -numeric_limits<long double>::infinity())
+        return write_special(first, last, negative, false);
+
+    if (negative)
+    {
+        if (first == last)
+            return {last, errc::value_too_large};
+        *first++ = '-';
+        value = -value;
+    }
+
+    unique_ptr<uint32_t[]> words(new uint32_t[long_double_words]);
+    int e2;
+    const int size = decompose(value, words.get(), e2);
+
+    if (fmt == chars_format::hex)
+    {
+        // value is in [2^exponent, 2^(exponent + 1)), or a subnormal with the
+        // exponent of the smallest normal value.
+        int top = 32 * size - 1;
+        while (top >= 0 && !((words[top / 32] >> (top % 32)) & 1))
+            --top;
+        int exponent = 0;
+        int fraction_bits = 0;
+        if (top >= 0)
+        {
+            exponent = top + e2;
+            if (exponent < LDBL_MIN_EXP - 1)
+                exponent = LDBL_MIN_EXP - 1;
+            fraction_bits = exponent - e2;
+        }
+        auto bit = [&](int i) -> unsigned {
+            return i >= 0 && i < 32 * size ? (words[i / 32] >> (i % 32)) & 1 : 0;
+        };
+        int nibbles = (fraction_bits + 3) / 4;
+        if (top >= 0 && nibbles < (LDBL_MANT_DIG + 2) / 4)
+            nibbles = (LDBL_MANT_DIG + 2) / 4;
+        unique_ptr<char[]> fraction(new char[nibbles + 1]);
+        for (int i = 0; i < nibbles; ++i)
+        {
+            const int low = fraction_bits - 4 * (i + 1);
+            fraction[i] = static_cast<char>(bit(low + 3) << 3 | bit(low + 2) << 2 |
+                                            bit(low + 1) << 1 | bit(low));
+        }
+        return write_hex(first, last, bit(fraction_bits), fraction.get(),
+                         nibbles, exponent, precision);
+    }
+
+    unique_ptr<char[]> buffer(new char[3 * long_double_digits]);
+    const decimal_digits exact =
+        exact_digits(words.get(), size, e2, buffer.get(),
+                     buffer.get() + long_double_digits);
+    if (precision >= 0)
+        return write_precision(first, last, exact, fmt, precision);
+    // The candidates and their text take the space of the reversed digits.
+    return write_shortest(
+        first, last,
+        shortest_digits(value, exact, buffer.get() + long_double_digits,
+                        buffer.get() + 2 * long_double_digits,
+                        long_double_digits),
+        fmt);
+}
+
+#endif // LDBL_MANT_DIG != DBL_MANT_DIG
+
+// Parsing ------------------------------------------------------------------
+
+inline bool is_digit(char c, bool hex)
+{
+    if ('0' <= c && c <= '9')
+        return true;
+    return hex && (('a' <= c && c <= 'f') || ('A' <= c && c <= 'F'));
+}
+
+// Matches the case-insensitive lowercase word at p.
+inline bool match_word(const char* p, const char* last, const char* word)
+{
+    for (; *word; ++word, ++p)
+        if (p == last || (*p | 0x20) != *word)
+            return false;
+    return true;
+}
+
+template <class _Fp>
+from_chars_result floating_from_chars(const char* first, const char* last,
+                                      _Fp& value, chars_format fmt)
+{
+    const char* p = first;
+    const bool negative = p != last && *p == '-';
+    if (negative)
+        ++p;
+
+    // Infinity and NaN.
+    if (match_word(p, last, "inf"))
+    {
+        p += 3;
+        if (match_word(p, last, "inity"))
+            p += 5;
+        value = negative ? -numeric_limits<_Fp>::infinity()
+                         : numeric_limits<_Fp>::infinity();
+        return {p, errc{}};
+    }
+    if (match_word(p, last, "nan"))
+    {
+        p += 3;
+        if (p != last && *p == '(')
+        {
+            const char* q = p + 1;
+            while (q != last && (is_digit(*q, true) || ('a' <= (*q | 0x20) &&
+                                                        (*q | 0x20) <= 'z') ||
+                                 *q == '_'))
+                ++q;
+            if (q != last && *q == ')')
+                p = q + 1;
+        }
+        value = negative ? -numeric_limits<_Fp>::quiet_NaN()
+                         : numeric_limits<_Fp>::quiet_NaN();
+        return {p, errc{}};
+    }
+
+    // The subject sequence: digits, an optional fraction, and an exponent
+    // where fmt allows or requires it.
+    const bool hex = fmt == chars_format::hex;
+    const char* digits_begin = p;
+    bool any_digits = false;
+    for (; p != last && is_digit(*p, hex); ++p)
+        any_digits = true;
+    if (p != last && *p == '.')
+        for (++p; p != last && is_digit(*p, hex); ++p)
+            any_digits = true;
+    if (!any_digits)
+        return {first, errc::invalid_argument};
+
+    bool has_exponent = false;
+    const char exponent_marker = hex ? 'p' : 'e';
+    if (fmt != chars_format::fixed && p != last &&
+        (*p | 0x20) == exponent_marker)
+    {
+        const char* q = p + 1;
+        if (q != last && (*q == '+' || *q == '-'))
+            ++q;
+        if (q != last && is_digit(*q, false))
+        {
+            while (q != last && is_digit(*q, false))
+                ++q;
+            p = q;
+            has_exponent = true;
+        }
+    }
+    if (fmt == chars_format::scientific && !has_exponent)
+        return {first, errc::invalid_argument};
+
+    // strtod needs a terminated copy, and the hex prefix.
+    const size_t length = static_cast<size_t>(p - digits_begin);
+    char small_buffer[128];
+    unique_ptr<char[]> large_buffer;
+    char* buffer = small_buffer;
+    if (length + 4 > sizeof(small_buffer))
+    {
+        large_buffer.reset(new char[length + 4]);
+        buffer = large_buffer.get();
+    }
+    char* b = buffer;
+    if (negative)
+        *b++ = '-';
+    if (hex)
+    {
+        *b++ = '0';
+        *b++ = 'x';
+    }
+    memcpy(b, digits_begin, length);
+    b[length] = '\0';
+
+    typename remove_reference<decltype(errno)>::type saved_errno = errno;
+    errno = 0;
+    char* end;
+    const _Fp result = __do_strtod<_Fp>(buffer, &end);
+    const bool out_of_range =
+        errno == ERANGE &&
+        (result == 0 || result == numeric_limits<_Fp>::infinity() ||
+         result == -numeric_limits<_Fp>::infinity());
+    errno = saved_errno;
+    if (out_of_range)
+        return {p, errc::result_out_of_range};
+    value = result;
+    return {p, errc{}};
+}
+
+} // namespace
+
+to_chars_result to_chars(char* __first, char* __last, float __value)
+{
+    return floating_to_chars(__first, __last, __value, chars_format{}, -1);
+}
+
+to_chars_result to_chars(char* __first, char* __last, double __value)
+{
+    return floating_to_chars(__first, __last, __value, chars_format{}, -1);
+}
+
+to_chars_result to_chars(char* __first, char* __last, long double __value)
+{
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+    return floating_to_chars(__first, __last, static_cast<double>(__value),
+                             chars_format{}, -1);
+#else
+    return long_double_to_chars(__first, __last, __value, chars_format{}, -1);
+#endif
+}
+
+to_chars_result to_chars(char* __first, char* __last, float __value,
+                         chars_format __fmt)
+{
+    return floating_to_chars(__first, __last, __value, __fmt, -1);
+}
+
+to_chars_result to_chars(char* __first, char* __last, double __value,
+                         chars_format __fmt)
+{
+    return floating_to_chars(__first, __last, __value, __fmt, -1);
+}
+
+to_chars_result to_chars(char* __first, char* __last, long double __value,
+                         chars_format __fmt)
+{
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+    return floating_to_chars(__first, __last, static_cast<double>(__value),
+                             __fmt, -1);
+#else
+    return long_double_to_chars(__first, __last, __value, __fmt, -1);
+#endif
+}
+
+// A negative precision means the default precision of printf, 6.
+to_chars_result to_chars(char* __first, char* __last, float __value,
+                         chars_format __fmt, int __precision)
+{
+    return floating_to_chars(__first, __last, __value, __fmt,
+                             __precision < 0 ? 6 : __precision);
+}
+
+to_chars_result to_chars(char* __first, char* __last, double __value,
+                         chars_format __fmt, int __precision)
+{
+    return floating_to_chars(__first, __last, __value, __fmt,
+                             __precision < 0 ? 6 : __precision);
+}
+
+to_chars_result to_chars(char* __first, char* __last, long double __value,
+                         chars_format __fmt, int __precision)
+{
+#if LDBL_MANT_DIG == DBL_MANT_DIG
+    return floating_to_chars(__first, __last, static_cast<double>(__value),
+                             __fmt, __precision < 0 ? 6 : __precision);
+#else
+    return long_double_to_chars(__first, __last, __value, __fmt,
+                                __precision < 0 ? 6 : __precision);
+#endif
+}
+
+from_chars_result from_chars(const char* __first, const char* __last,
+                             float& __value, chars_format __fmt)
+{
+    return floating_from_chars(__first, __last, __value, __fmt);
+}
+
+from_chars_result from_chars(const char* __first, const char* __last,
+                             double& __value, chars_format __fmt)
+{
+    return floating_from_chars(__first, __last, __value, __fmt);
+}
+
+from_chars_result from_chars(const char* __first, const char* __last,
+                             long double& __value, chars_format __fmt)
+{
+    return floating_from_chars(__first, __last, __value, __fmt);
+}
+
 _LIBCPP_END_NAMESPACE_STD
@@ -15,6 +15,10 @@
 #include <dirent.h>
 #endif
 #include <errno.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "filesystem_common.h"
 
@@ -58,6 +62,51 @@ static file_type get_file_type(DirEntT* ent, long) {
   return file_type::none;
 }
 
+#if defined(__linux__)
+
+// The record getdents64 fills the buffer with. The kernel doesn't export it
+// to userspace, and glibc only exposes it as dirent64 under
+// _LARGEFILE64_SOURCE.
+struct linux_dirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[1];
+};
+
+// The type of the entry `name` in the directory open as `dir_fd`, as status()
+// or symlink_status() would report it, without resolving the full path again.
+static file_type posix_fstatat_type(int dir_fd, const char* name,
+                                    bool follow_symlinks, error_code& ec) {
+  struct ::stat st;
+  if (::fstatat(dir_fd, name, &st, follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) ==
+      -1) {
+    ec = capture_errno();
+    if (ec.value() == ENOENT || ec.value() == ENOTDIR)
+      return file_type::not_found;
+    return file_type::none;
+  }
+  ec.clear();
+  if (S_ISLNK(st.st_mode))
+    return file_type::symlink;
+  if (S_ISREG(st.st_mode))
+    return file_type::regular;
+  if (S_ISDIR(st.st_mode))
+    return file_type::directory;
+  if (S_ISBLK(st.st_mode))
+    return file_type::block;
+  if (S_ISCHR(st.st_mode))
+    return file_type::character;
+  if (S_ISFIFO(st.st_mode))
+    return file_type::fifo;
+  if (S_ISSOCK(st.st_mode))
+    return file_type::socket;
+  return file_type::unknown;
+}
+
+#else
+
 static pair<string_view, file_type> posix_readdir(DIR* dir_stream,
                                                   error_code& ec) {
   struct dirent* dir_entry_ptr = nullptr;
@@ -71,6 +120,8 @@ static pair<string_view, file_type> posix_readdir(DIR* dir_stream,
     return {dir_entry_ptr->d_name, get_file_type(dir_entry_ptr, 0)};
   }
 }
+
+#endif // defined(__linux__)
 #else
 
 static file_type get_file_type(const WIN32_FIND_DATA& data) {
@@ -160,6 +211,125 @@ private:
   HANDLE __stream_{INVALID_HANDLE_VALUE};
   WIN32_FIND_DATA __data_;
 
+public:
+  path __root_;
+  directory_entry __entry_;
+};
+#elif defined(__linux__)
+// On Linux the stream reads entries straight into a large buffer with
+// getdents64, rather than through readdir's smaller one, and subdirectories
+// are opened relative to their parent's descriptor, so the kernel resolves
+// one path component per level instead of the whole path.
+class __dir_stream {
+public:
+  __dir_stream() = delete;
+  __dir_stream& operator=(const __dir_stream&) = delete;
+
+  __dir_stream(__dir_stream&& other) noexcept
+      : __fd_(other.__fd_), __buf_(move(other.__buf_)), __pos_(other.__pos_),
+        __end_(other.__end_), __name_(other.__name_),
+        __root_(move(other.__root_)), __entry_(move(other.__entry_)) {
+    other.__fd_ = -1;
+  }
+
+  __dir_stream(const path& root, directory_options opts, error_code& ec)
+      : __root_(root) {
+    __open(AT_FDCWD, root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC, opts,
+           ec);
+  }
+
+  // Opens the directory the parent stream is positioned at.
+  __dir_stream(const __dir_stream& parent, directory_options opts,
+               error_code& ec)
+      : __root_(parent.__entry_.path()) {
+    int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+    if (!bool(opts & directory_options::follow_directory_symlink))
+      flags |= O_NOFOLLOW;
+    __open(parent.__fd_, parent.__name_, flags, opts, ec);
+  }
+
+  ~__dir_stream() noexcept {
+    if (__fd_ != -1)
+      close();
+  }
+
+  bool good() const noexcept { return __fd_ != -1; }
+
+  bool advance(error_code& ec) {
+    ec.clear();
+    while (true) {
+      if (__pos_ == __end_) {
+        ssize_t n = ::syscall(SYS_getdents64, __fd_, __buf_.get(), __buf_size);
+        if (n <= 0) {
+          if (n == -1)
+            ec = detail::capture_errno();
+          close();
+          return false;
+        }
+        __pos_ = 0;
+        __end_ = static_cast<size_t>(n);
+      }
+      auto* ent = reinterpret_cast<detail::linux_dirent64*>(__buf_.get() + __pos_);
+      __pos_ += ent->d_reclen;
+      const char* name = ent->d_name;
+      if (name[0] == '.' &&
+          (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+        continue;
+      __name_ = name;
+      __entry_.__assign_iter_entry(
+          __root_ / name,
+          directory_entry::__create_iter_result(detail::get_file_type(ent, 0)));
+      return true;
+    }
+  }
+
+  // The type of the current entry, following symlinks or not. Uses the type
+  // the directory reported when there is one, and otherwise stats the entry
+  // relative to this directory.
+  file_type __entry_type(bool follow_symlinks, error_code& ec) const {
+    const auto cache = __entry_.__data_.__cache_type_;
+    if (!follow_symlinks && cache != directory_entry::_Empty)
+      return __entry_.__get_sym_ft(&ec);
+    if (follow_symlinks && cache == directory_entry::_IterNonSymlink)
+      return __entry_.__get_ft(&ec);
+    return detail::posix_fstatat_type(__fd_, __name_, follow_symlinks, ec);
+  }
+
+private:
+  // Large enough for a few hundred entries per system call.
+  static const size_t __buf_size = 64 * 1024;
+
+  void __open(int dir_fd, const char* name, int flags, directory_options opts,
+              error_code& ec) {
+    if ((__fd_ = ::openat(dir_fd, name, flags)) == -1) {
+      ec = detail::capture_errno();
+      const bool allow_eacess =
+          bool(opts & directory_options::skip_permission_denied);
+      // With O_NOFOLLOW, ELOOP means the entry was replaced by a symlink
+      // since we decided to recurse into it; skip it, as we would have.
+      if ((allow_eacess && ec.value() == EACCES) ||
+          ((flags & O_NOFOLLOW) && ec.value() == ELOOP))
+        ec.clear();
+      return;
+    }
+    __buf_.reset(new char[__buf_size]);
+    advance(ec);
+  }
+
+  error_code close() noexcept {
+    error_code m_ec;
+    if (::close(__fd_) == -1)
+      m_ec = detail::capture_errno();
+    __fd_ = -1;
+    return m_ec;
+  }
+
+  int __fd_{-1};
+  unique_ptr<char[]> __buf_;
+  size_t __pos_{0};
+  size_t __end_{0};
+  const char* __name_{nullptr};
+
 public:
   path __root_;
   directory_entry __entry_;
@@ -360,13 +530,21 @@ bool recursive_directory_iterator::__try_recursion(error_code* ec) {
   bool skip_rec = false;
   error_code m_ec;
   if (!rec_sym) {
+#if defined(__linux__)
+    file_status st(curr_it.__entry_type(false, m_ec));
+#else
     file_status st(curr_it.__entry_.__get_sym_ft(&m_ec));
+#endif
     if (m_ec && status_known(st))
       m_ec.clear();
     if (m_ec || is_symlink(st) || !is_directory(st))
       skip_rec = true;
   } else {
+#if defined(__linux__)
+    file_status st(curr_it.__entry_type(true, m_ec));
+#else
     file_status st(curr_it.__entry_.__get_ft(&m_ec));
+#endif
     if (m_ec && status_known(st))
       m_ec.clear();
     if (m_ec || !is_directory(st))
@@ -374,7 +552,11 @@ bool recursive_directory_iterator::__try_recursion(error_code* ec) {
   }
 
   if (!skip_rec) {
+#if defined(__linux__)
+    __dir_stream new_it(curr_it, __imp_->__options_, m_ec);
+#else
     __dir_stream new_it(curr_it.__entry_.path(), __imp_->__options_, m_ec);
+#endif
     if (new_it.good()) {
       __imp_->__stack_.push(move(new_it));
       return true;
@@ -0,0 +1,454 @@
+//===------------------------ memory_resource.cpp -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "__config"
+#include "memory_resource"
+#include "new"
+#include "include/atomic_support.h"
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace pmr
+{
+
+// memory_resource
+
+memory_resource::~memory_resource() = default;
+
+// new_delete_resource() and null_memory_resource()
+
+namespace {
+
+class __new_delete_memory_resource_imp : public memory_resource
+{
+    void* do_allocate(size_t __bytes, size_t __align) override
+        { return _VSTD::__libcpp_allocate(__bytes, __align); }
+
+    void do_deallocate(void* __p, size_t __bytes, size_t __align) override
+        { _VSTD::__libcpp_deallocate(__p, __bytes, __align); }
+
+    bool do_is_equal(const memory_resource& __other) const _NOEXCEPT override
+        { return &__other == this; }
+};
+
+class __null_memory_resource_imp : public memory_resource
+{
+    void* do_allocate(size_t, size_t) override
+        { __throw_bad_alloc(); }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& __other) const _NOEXCEPT override
+        { return &__other == this; }
+};
+
+// The resources are constant initialized and never destroyed, so that they
+// can be used during the construction and destruction of other statics.
+struct __resource_initializer
+{
+    union { __new_delete_memory_resource_imp __new_delete_res; };
+    union { __null_memory_resource_imp __null_res; };
+
+    _LIBCPP_CONSTEXPR __resource_initializer() : __new_delete_res(), __null_res() {}
+    ~__resource_initializer() {}
+};
+
+_LIBCPP_SAFE_STATIC __resource_initializer __res_init;
+
+_LIBCPP_SAFE_STATIC memory_resource* __default_res = &__res_init.__new_delete_res;
+
+} // namespace
+
+memory_resource* new_delete_resource() _NOEXCEPT
+{
+    return &__res_init.__new_delete_res;
+}
+
+memory_resource* null_memory_resource() _NOEXCEPT
+{
+    return &__res_init.__null_res;
+}
+
+// default_memory_resource()
+
+memory_resource* get_default_resource() _NOEXCEPT
+{
+    return __libcpp_atomic_load(&__default_res, _AO_Acquire);
+}
+
+memory_resource* set_default_resource(memory_resource* __new_res) _NOEXCEPT
+{
+    if (__new_res == nullptr)
+        __new_res = new_delete_resource();
+    return __libcpp_atomic_exchange(&__default_res, __new_res, _AO_Acq_Rel);
+}
+
+// 23.12.5, mem.res.pool
+
+static size_t __roundup(size_t __count, size_t __alignment)
+{
+    size_t __mask = __alignment - 1;
+    return (__count + __mask) & ~__mask;
+}
+
+// Every chunk taken from upstream, by either kind of pool, ends with one of
+// these so that it can be given back.
+struct unsynchronized_pool_resource::__chunk_footer
+{
+    __chunk_footer* __next_;
+    char* __start_;
+    size_t __align_;
+
+    size_t __allocation_size()
+        { return static_cast<size_t>(reinterpret_cast<char*>(this) - __start_) + sizeof(*this); }
+};
+
+void unsynchronized_pool_resource::__adhoc_pool::__release_ptr(memory_resource* __upstream)
+{
+    while (__first_ != nullptr)
+    {
+        __chunk_footer* __next = __first_->__next_;
+        __upstream->deallocate(__first_->__start_, __first_->__allocation_size(), __first_->__align_);
+        __first_ = __next;
+    }
+}
+
+void* unsynchronized_pool_resource::__adhoc_pool::__do_allocate(memory_resource* __upstream, size_t __bytes, size_t __align)
+{
+    const size_t __footer_size = sizeof(__chunk_footer);
+    const size_t __footer_align = _LIBCPP_ALIGNOF(__chunk_footer);
+
+    if (__align < __footer_align)
+        __align = __footer_align;
+
+    size_t __aligned_capacity = __roundup(__bytes, __footer_align);
+    if (__aligned_capacity < __bytes)
+        __throw_bad_alloc();
+
+    void* __result = __upstream->allocate(__aligned_capacity + __footer_size, __align);
+
+    __chunk_footer* __h = (__chunk_footer*)((char*)__result + __aligned_capacity);
+    __h->__next_ = __first_;
+    __h->__start_ = (char*)__result;
+    __h->__align_ = __align;
+    __first_ = __h;
+    return __result;
+}
+
+void unsynchronized_pool_resource::__adhoc_pool::__do_deallocate(memory_resource* __upstream, void* __p, size_t, size_t)
+{
+    _LIBCPP_ASSERT(__first_ != nullptr, "deallocating a block that was not allocated with this allocator");
+    if (__first_->__start_ == __p)
+    {
+        __chunk_footer* __next = __first_->__next_;
+        __upstream->deallocate(__p, __first_->__allocation_size(), __first_->__align_);
+        __first_ = __next;
+        return;
+    }
+    for (__chunk_footer* __h = __first_; __h->__next_ != nullptr; __h = __h->__next_)
+    {
+        if (__h->__next_->__start_ == __p)
+        {
+            __chunk_footer* __next = __h->__next_->__next_;
+            __upstream->deallocate(__p, __h->__next_->__allocation_size(), __h->__next_->__align_);
+            __h->__next_ = __next;
+            return;
+        }
+    }
+    _LIBCPP_ASSERT(false, "deallocating a block that was not allocated with this allocator");
+}
+
+// A pool of blocks of one size. Free blocks are kept on an intrusive list;
+// chunks are only given back to upstream on release().
+class unsynchronized_pool_resource::__fixed_pool
+{
+    struct __vacancy_header
+    {
+        __vacancy_header* __next_vacancy_;
+    };
+
+    __chunk_footer* __first_chunk_ = nullptr;
+    __vacancy_header* __first_vacancy_ = nullptr;
+
+public:
+    static const size_t __default_alignment = _LIBCPP_ALIGNOF(max_align_t);
+
+    explicit __fixed_pool() = default;
+
+    void __release_ptr(memory_resource* __upstream)
+    {
+        __first_vacancy_ = nullptr;
+        while (__first_chunk_ != nullptr)
+        {
+            __chunk_footer* __next = __first_chunk_->__next_;
+            __upstream->deallocate(__first_chunk_->__start_, __first_chunk_->__allocation_size(),
+                                   __first_chunk_->__align_);
+            __first_chunk_ = __next;
+        }
+    }
+
+    void* __try_allocate_from_vacancies()
+    {
+        if (__first_vacancy_ == nullptr)
+            return nullptr;
+        void* __result = __first_vacancy_;
+        __first_vacancy_ = __first_vacancy_->__next_vacancy_;
+        return __result;
+    }
+
+    // Returns the first block of a new chunk of __chunk_size bytes, and puts
+    // the rest of the chunk on the free list.
+    void* __allocate_in_new_chunk(memory_resource* __upstream, size_t __block_size, size_t __chunk_size)
+    {
+        _LIBCPP_ASSERT(__chunk_size % __block_size == 0, "");
+        static_assert(__default_alignment >= _LIBCPP_ALIGNOF(max_align_t), "");
+        static_assert(__default_alignment >= _LIBCPP_ALIGNOF(__chunk_footer), "");
+        static_assert(__default_alignment >= _LIBCPP_ALIGNOF(__vacancy_header), "");
+
+        const size_t __footer_size = sizeof(__chunk_footer);
+        const size_t __footer_align = _LIBCPP_ALIGNOF(__chunk_footer);
+
+        size_t __aligned_capacity = __roundup(__chunk_size, __footer_align);
+
+        char* __result = static_cast<char*>(
+            __upstream->allocate(__aligned_capacity + __footer_size, __default_alignment));
+
+        __chunk_footer* __h = (__chunk_footer*)(__result + __aligned_capacity);
+        __h->__next_ = __first_chunk_;
+        __h->__start_ = __result;
+        __h->__align_ = __default_alignment;
+        __first_chunk_ = __h;
+
+        // Link the blocks back to front, so that they are handed out in
+        // address order.
+        for (size_t __i = __chunk_size; __i != __block_size; )
+        {
+            __i -= __block_size;
+            __vacancy_header* __v = (__vacancy_header*)(__result + __i);
+            __v->__next_vacancy_ = __first_vacancy_;
+            __first_vacancy_ = __v;
+        }
+        return __result;
+    }
+
+    void __evacuate(void* __p)
+    {
+        __vacancy_header* __v = (__vacancy_header*)(__p);
+        __v->__next_vacancy_ = __first_vacancy_;
+        __first_vacancy_ = __v;
+    }
+
+    size_t __previous_chunk_size_in_bytes() const
+    {
+        return __first_chunk_ == nullptr
+                   ? 0
+                   : __first_chunk_->__allocation_size() - sizeof(__chunk_footer);
+    }
+};
+
+size_t unsynchronized_pool_resource::__pool_block_size(int __i) const
+{
+    return size_t(1) << __log2_pool_block_size(__i);
+}
+
+int unsynchronized_pool_resource::__log2_pool_block_size(int __i) const
+{
+    return (__i + __log2_smallest_block_size);
+}
+
+int unsynchronized_pool_resource::__pool_index(size_t __bytes, size_t __align) const
+{
+    if (__align > _LIBCPP_ALIGNOF(max_align_t) || __bytes > (size_t(1) << __log2_pool_block_size(__num_fixed_pools_ - 1)))
+        return __num_fixed_pools_;
+    int __i = 0;
+    __bytes = (__bytes > __align) ? __bytes : __align;
+    __bytes -= 1;
+    __bytes >>= __log2_smallest_block_size;
+    while (__bytes != 0)
+    {
+        __bytes >>= 1;
+        __i += 1;
+    }
+    return __i;
+}
+
+unsynchronized_pool_resource::unsynchronized_pool_resource(const pool_options& __opts, memory_resource* __upstream)
+    : __res_(__upstream), __fixed_pools_(nullptr)
+{
+    size_t __largest_block_size;
+    if (__opts.largest_required_pool_block == 0)
+        __largest_block_size = __default_largest_block_size;
+    else if (__opts.largest_required_pool_block < __smallest_block_size)
+        __largest_block_size = __smallest_block_size;
+    else if (__opts.largest_required_pool_block > __max_largest_block_size)
+        __largest_block_size = __max_largest_block_size;
+    else
+        __largest_block_size = __opts.largest_required_pool_block;
+
+    if (__opts.max_blocks_per_chunk == 0)
+        __options_max_blocks_per_chunk_ = __max_blocks_per_chunk;
+    else if (__opts.max_blocks_per_chunk < __min_blocks_per_chunk)
+        __options_max_blocks_per_chunk_ = __min_blocks_per_chunk;
+    else if (__opts.max_blocks_per_chunk > __max_blocks_per_chunk)
+        __options_max_blocks_per_chunk_ = __max_blocks_per_chunk;
+    else
+        __options_max_blocks_per_chunk_ = __opts.max_blocks_per_chunk;
+
+    __num_fixed_pools_ = 1;
+    size_t __capacity = __smallest_block_size;
+    while (__capacity < __largest_block_size)
+    {
+        __capacity <<= 1;
+        __num_fixed_pools_ += 1;
+    }
+}
+
+pool_options unsynchronized_pool_resource::options() const
+{
+    pool_options __p;
+    __p.max_blocks_per_chunk = __options_max_blocks_per_chunk_;
+    __p.largest_required_pool_block = __pool_block_size(__num_fixed_pools_ - 1);
+    return __p;
+}
+
+void unsynchronized_pool_resource::release()
+{
+    __adhoc_pool_.__release_ptr(__res_);
+    if (__fixed_pools_ != nullptr)
+    {
+        const int __n = __num_fixed_pools_;
+        for (int __i = 0; __i < __n; ++__i)
+            __fixed_pools_[__i].__release_ptr(__res_);
+        __res_->deallocate(__fixed_pools_, __n * sizeof(__fixed_pool), _LIBCPP_ALIGNOF(__fixed_pool));
+        __fixed_pools_ = nullptr;
+    }
+}
+
+void* unsynchronized_pool_resource::do_allocate(size_t __bytes, size_t __align)
+{
+    // Requests too large or too aligned for the pools go straight to
+    // upstream. Otherwise the pool for the smallest block size that fits
+    // hands out a free block, taking a new chunk from upstream if it has none.
+    int __i = __pool_index(__bytes, __align);
+    if (__i == __num_fixed_pools_)
+        return __adhoc_pool_.__do_allocate(__res_, __bytes, __align);
+
+    if (__fixed_pools_ == nullptr)
+    {
+        __fixed_pools_ = static_cast<__fixed_pool*>(
+            __res_->allocate(__num_fixed_pools_ * sizeof(__fixed_pool), _LIBCPP_ALIGNOF(__fixed_pool)));
+        __fixed_pool* __first = __fixed_pools_;
+        __fixed_pool* __last = __fixed_pools_ + __num_fixed_pools_;
+        for (__fixed_pool* __pool = __first; __pool != __last; ++__pool)
+            ::new ((void*)__pool) __fixed_pool;
+    }
+
+    void* __result = __fixed_pools_[__i].__try_allocate_from_vacancies();
+    if (__result == nullptr)
+    {
+        // Each new chunk holds twice as many blocks as the last one, within
+        // the limits of max_blocks_per_chunk and __max_bytes_per_chunk.
+        const int __log2_block_size = __log2_pool_block_size(__i);
+        size_t __prev_chunk_size_in_blocks =
+            __fixed_pools_[__i].__previous_chunk_size_in_bytes() >> __log2_block_size;
+
+        size_t __chunk_size_in_blocks;
+        if (__prev_chunk_size_in_blocks == 0)
+        {
+            __chunk_size_in_blocks = __min_bytes_per_chunk >> __log2_block_size;
+            if (__chunk_size_in_blocks < __min_blocks_per_chunk)
+                __chunk_size_in_blocks = __min_blocks_per_chunk;
+        }
+        else
+        {
+            static_assert(__max_blocks_per_chunk <= numeric_limits<size_t>::max() / 2,
+                          "unsigned overflow is possible");
+            __chunk_size_in_blocks = __prev_chunk_size_in_blocks * 2;
+        }
+
+        size_t __max_blocks = __max_bytes_per_chunk >> __log2_block_size;
+        if (__max_blocks > __options_max_blocks_per_chunk_)
+            __max_blocks = __options_max_blocks_per_chunk_;
+        if (__chunk_size_in_blocks > __max_blocks)
+            __chunk_size_in_blocks = __max_blocks;
+
+        __result = __fixed_pools_[__i].__allocate_in_new_chunk(
+            __res_, __pool_block_size(__i), __chunk_size_in_blocks << __log2_block_size);
+    }
+    return __result;
+}
+
+void unsynchronized_pool_resource::do_deallocate(void* __p, size_t __bytes, size_t __align)
+{
+    int __i = __pool_index(__bytes, __align);
+    if (__i == __num_fixed_pools_)
+        return __adhoc_pool_.__do_deallocate(__res_, __p, __bytes, __align);
+    _LIBCPP_ASSERT(__fixed_pools_ != nullptr, "deallocating a block that was not allocated with this allocator");
+    __fixed_pools_[__i].__evacuate(__p);
+}
+
+synchronized_pool_resource::~synchronized_pool_resource()
+{
+}
+
+bool synchronized_pool_resource::do_is_equal(const memory_resource& __other) const _NOEXCEPT
+{
+    return &__other == this;
+}
+
+// 23.12.6, mem.res.monotonic.buffer
+
+static void* __try_allocate_from_chunk(char*& __cur, char* __end, size_t __bytes, size_t __align)
+{
+    if (__cur == nullptr)
+        return nullptr;
+    uintptr_t __p = reinterpret_cast<uintptr_t>(__cur);
+    uintptr_t __e = reinterpret_cast<uintptr_t>(__end);
+    uintptr_t __aligned = (__p + __align - 1) & ~static_cast<uintptr_t>(__align - 1);
+    if (__aligned < __p || __aligned > __e || __e - __aligned < __bytes)
+        return nullptr;
+    __cur = reinterpret_cast<char*>(__aligned + __bytes);
+    return reinterpret_cast<void*>(__aligned);
+}
+
+void* monotonic_buffer_resource::do_allocate(size_t __bytes, size_t __align)
+{
+    _LIBCPP_ASSERT(__align != 0 && (__align & (__align - 1)) == 0,
+                   "alignment must be a power of two");
+    if (void* __result = __try_allocate_from_chunk(__cur_, __end_, __bytes, __align))
+        return __result;
+
+    const size_t __footer_size = sizeof(__chunk_footer);
+    const size_t __footer_align = _LIBCPP_ALIGNOF(__chunk_footer);
+
+    size_t __new_capacity = __next_size_ < __bytes ? __bytes : __next_size_;
+    if (__new_capacity > numeric_limits<size_t>::max() - __footer_size - __footer_align)
+        __throw_bad_alloc();
+    size_t __aligned_capacity = __roundup(__new_capacity, __footer_align);
+
+    size_t __chunk_align = __align < __footer_align ? __footer_align : __align;
+    char* __start = static_cast<char*>(__res_->allocate(__aligned_capacity + __footer_size, __chunk_align));
+
+    __chunk_footer* __footer = (__chunk_footer*)(__start + __aligned_capacity);
+    __footer->__next_ = __chunks_;
+    __footer->__start_ = __start;
+    __footer->__align_ = __chunk_align;
+    __chunks_ = __footer;
+
+    __cur_ = __start;
+    __end_ = __start + __aligned_capacity;
+    __next_size_ = __aligned_capacity <= numeric_limits<size_t>::max() / 2
+                       ? __aligned_capacity * 2
+                       : __aligned_capacity;
+
+    return __try_allocate_from_chunk(__cur_, __end_, __bytes, __align);
+}
+
+} // namespace pmr
+
+_LIBCPP_END_NAMESPACE_STD
@@ -208,6 +208,54 @@ int __libcpp_thread_create(__libcpp_thread_t *__t, void *(*__func)(void *),
   return GetLastError();
 }
 
+int __libcpp_thread_create(__libcpp_thread_t *__t, void *(*__func)(void *),
+                           void *__arg,
+                           const __libcpp_thread_attributes *__attr)
+{
+  // Threads outside the first processor group are not supported.
+  DWORD_PTR __mask = 0;
+  for (size_t __i = 0; __i < __libcpp_thread_attributes::__max_cpus; ++__i)
+  {
+    if (!((__attr->__cpus_[__i / __libcpp_thread_attributes::__cpus_per_word] >>
+           (__i % __libcpp_thread_attributes::__cpus_per_word)) & 1))
+      continue;
+    if (__i >= sizeof(__mask) * 8)
+      return ENOTSUP;
+    __mask |= DWORD_PTR(1) << __i;
+  }
+
+  auto *__data = new __libcpp_beginthreadex_thunk_data;
+  __data->__func = __func;
+  __data->__arg = __arg;
+
+  *__t = reinterpret_cast<HANDLE>(_beginthreadex(
+      nullptr, static_cast<unsigned>(__attr->__stack_size_),
+      __libcpp_beginthreadex_thunk, __data,
+      (__mask != 0 ? CREATE_SUSPENDED : 0) | STACK_SIZE_PARAM_IS_A_RESERVATION,
+      nullptr));
+
+  if (!*__t)
+  {
+    delete __data;
+    return GetLastError();
+  }
+  if (__mask != 0)
+  {
+    if (!SetThreadAffinityMask(*__t, __mask))
+    {
+      // The thread has not run yet, so nothing but __data refers to __arg.
+      int __ec = GetLastError();
+      TerminateThread(*__t, 0);
+      CloseHandle(*__t);
+      *__t = 0;
+      delete __data;
+      return __ec;
+    }
+    ResumeThread(*__t);
+  }
+  return 0;
+}
+
 __libcpp_thread_id __libcpp_thread_get_current_id()
 {
   return GetCurrentThreadId();
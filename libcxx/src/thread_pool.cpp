@@ -0,0 +1,236 @@
+//===------------------------- thread_pool.cpp ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "__config"
+#ifndef _LIBCPP_HAS_NO_THREADS
+
+#include "__thread_pool"
+#include "atomic"
+#include "condition_variable"
+#include "mutex"
+#include "thread"
+#include <stdlib.h>
+
+#if defined(__unix__) && !defined(__ANDROID__) && defined(__ELF__) && defined(_LIBCPP_HAS_COMMENT_LIB_PRAGMA)
+#pragma comment(lib, "pthread")
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+namespace {
+
+// One call to __thread_pool_run. It lives on the caller's stack, and stays
+// queued until all of its indices have been claimed.
+struct __job
+{
+    void (*__task)(void*, size_t);
+    void* __context;
+    size_t __n;
+    atomic<size_t> __next_index;
+    // Threads working on the job, guarded by the pool mutex. The caller
+    // returns once the job is unqueued and this drops to zero.
+    unsigned __users;
+    bool __queued;
+    __job* __prev;
+    __job* __next;
+
+    // Runs indices until there are none left to claim.
+    void __drain()
+    {
+        for (size_t __i; (__i = __next_index.fetch_add(1)) < __n;)
+            __task(__context, __i);
+    }
+
+    bool __exhausted() const { return __next_index.load() >= __n; }
+};
+
+class __pool
+{
+public:
+    __pool() : __head_(nullptr), __workers_(0), __concurrency_(__default_concurrency()) {}
+
+    unsigned __concurrency() const { return __concurrency_.load(); }
+
+    void __set_concurrency(unsigned __n)
+    {
+        __concurrency_.store(__n == 0 ? __default_concurrency() : __n);
+        __work_cv_.notify_all();
+    }
+
+    void __run(__job& __j);
+
+private:
+    static unsigned __default_concurrency();
+    static void* __worker_main(void* __arg);
+
+    void __worker_loop(unsigned __id);
+    void __spawn_workers(unsigned __count);
+    void __push(__job& __j);
+    void __unqueue(__job& __j);
+
+    mutex __mut_;
+    condition_variable __work_cv_;
+    condition_variable __done_cv_;
+    // Queued jobs, most recent first, so that nested calls are served before
+    // the calls that are waiting on them.
+    __job* __head_;
+    unsigned __workers_;
+    atomic<unsigned> __concurrency_;
+};
+
+struct __worker_start
+{
+    __pool* __p;
+    unsigned __id;
+};
+
+unsigned __pool::__default_concurrency()
+{
+    if (const char* __env = getenv("PSTL_NUM_THREADS"))
+    {
+        unsigned long __n = strtoul(__env, nullptr, 10);
+        if (__n != 0)
+            return static_cast<unsigned>(__n > 1024 ? 1024 : __n);
+    }
+    unsigned __n = thread::hardware_concurrency();
+    return __n == 0 ? 1 : __n;
+}
+
+void* __pool::__worker_main(void* __arg)
+{
+    __worker_start* __start = static_cast<__worker_start*>(__arg);
+    __pool* __p = __start->__p;
+    unsigned __id = __start->__id;
+    delete __start;
+    __p->__worker_loop(__id);
+    return nullptr;
+}
+
+// Worker __id only takes jobs while the caller plus __id + 1 workers fit in
+// the current concurrency.
+void __pool::__worker_loop(unsigned __id)
+{
+    unique_lock<mutex> __lk(__mut_);
+    for (;;)
+    {
+        while (__head_ == nullptr || __id + 1 >= __concurrency_.load())
+            __work_cv_.wait(__lk);
+        __job& __j = *__head_;
+        ++__j.__users;
+        __lk.unlock();
+        __j.__drain();
+        __lk.lock();
+        if (__j.__queued)
+            __unqueue(__j);
+        if (--__j.__users == 0)
+            __done_cv_.notify_all();
+    }
+}
+
+// Called with the mutex held.
+void __pool::__spawn_workers(unsigned __count)
+{
+    for (; __workers_ < __count; ++__workers_)
+    {
+        __worker_start* __start = new __worker_start{this, __workers_};
+        __libcpp_thread_t __t;
+        if (__libcpp_thread_create(&__t, &__worker_main, __start) != 0)
+        {
+            // Make do with the threads we have.
+            delete __start;
+            return;
+        }
+        __libcpp_thread_detach(&__t);
+    }
+}
+
+void __pool::__push(__job& __j)
+{
+    __j.__queued = true;
+    __j.__prev = nullptr;
+    __j.__next = __head_;
+    if (__head_ != nullptr)
+        __head_->__prev = &__j;
+    __head_ = &__j;
+}
+
+void __pool::__unqueue(__job& __j)
+{
+    if (__j.__prev != nullptr)
+        __j.__prev->__next = __j.__next;
+    else
+        __head_ = __j.__next;
+    if (__j.__next != nullptr)
+        __j.__next->__prev = __j.__prev;
+    __j.__queued = false;
+}
+
+void __pool::__run(__job& __j)
+{
+    const unsigned __threads = __concurrency();
+    if (__j.__n <= 1 || __threads <= 1)
+    {
+        __j.__drain();
+        return;
+    }
+
+    {
+        lock_guard<mutex> __lk(__mut_);
+        __spawn_workers(__threads - 1);
+        __push(__j);
+    }
+    __work_cv_.notify_all();
+
+    __j.__drain();
+
+    // Every index is claimed. Wait for the workers still running one.
+    unique_lock<mutex> __lk(__mut_);
+    if (__j.__queued)
+        __unqueue(__j);
+    while (__j.__users != 0)
+        __done_cv_.wait(__lk);
+}
+
+// The pool is never destroyed: its detached workers may still be waiting on
+// it while other static objects are being destroyed at exit.
+__pool& __get_pool()
+{
+    static __pool* __p = new __pool;
+    return *__p;
+}
+
+} // namespace
+
+void __thread_pool_run(size_t __n, void (*__task)(void*, size_t),
+                       void* __context)
+{
+    if (__n == 0)
+        return;
+    __job __j;
+    __j.__task = __task;
+    __j.__context = __context;
+    __j.__n = __n;
+    __j.__next_index.store(0);
+    __j.__users = 0;
+    __j.__queued = false;
+    __get_pool().__run(__j);
+}
+
+unsigned __thread_pool_concurrency() _NOEXCEPT
+{
+    return __get_pool().__concurrency();
+}
+
+void __thread_pool_set_concurrency(unsigned __n) _NOEXCEPT
+{
+    __get_pool().__set_concurrency(__n);
+}
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // !_LIBCPP_HAS_NO_THREADS
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// sort partitions ranges of arithmetic type with the default comparison a
+// block at a time. Check every length around the block size, with few and
+// many distinct values, and with the values the partition sees first already
+// on the right side.
+
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "test_macros.h"
+
+std::mt19937 randomness;
+
+template <class T>
+void test_one(std::vector<T> v)
+{
+    std::vector<T> expected = v;
+    std::stable_sort(expected.begin(), expected.end());
+    std::sort(v.begin(), v.end());
+    assert(v == expected);
+}
+
+template <class T>
+void test_type()
+{
+    for (int n = 0; n < 600; n += (n < 300 ? 1 : 37))
+    {
+        for (int distinct = 1; distinct <= n; distinct = distinct * 4 + 1)
+        {
+            std::vector<T> v(n);
+            for (int i = 0; i < n; ++i)
+                v[i] = T(i % distinct);
+            std::shuffle(v.begin(), v.end(), randomness);
+            test_one(v);
+        }
+        std::vector<T> v(n);
+        for (int i = 0; i < n; ++i)
+            v[i] = T(i % 100);
+        test_one(v);
+        // Small values at the front, large ones at the back.
+        for (int i = 0; i < n; ++i)
+            v[i] = T(i < n / 2 ? i % 50 : 50 + i % 50);
+        test_one(v);
+        std::reverse(v.begin(), v.end());
+        test_one(v);
+    }
+}
+
+int main(int, char**)
+{
+    test_type<char>();
+    test_type<unsigned char>();
+    test_type<short>();
+    test_type<int>();
+    test_type<unsigned>();
+    test_type<long long>();
+    test_type<unsigned long long>();
+    test_type<float>();
+    test_type<double>();
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// find, count, mismatch and equal on contiguous ranges of arithmetic type go
+// through vectorized kernels. Check them against the obvious loops for every
+// length around the vector width, for every match position, and for the
+// lane counters in count overflowing.
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class T>
+void test_type() {
+  for (int n = 0; n < 150; ++n) {
+    std::vector<T> v(n);
+    for (int i = 0; i < n; ++i)
+      v[i] = T(i % 7);
+    std::vector<T> w = v;
+    const T* first = v.data();
+    const T* last = v.data() + n;
+
+    for (int k = 0; k < 8; ++k) {
+      const T* expected = first;
+      while (expected != last && !(*expected == T(k)))
+        ++expected;
+      assert(std::find(first, last, T(k)) == expected);
+      assert(std::find(v.begin(), v.end(), T(k)) - v.begin() == expected - first);
+
+      std::ptrdiff_t matches = 0;
+      for (int i = 0; i < n; ++i)
+        matches += v[i] == T(k);
+      assert(std::count(first, last, T(k)) == matches);
+      assert(std::count(v.begin(), v.end(), T(k)) == matches);
+    }
+
+    assert(std::equal(v.begin(), v.end(), w.begin()));
+    assert(std::mismatch(v.begin(), v.end(), w.begin()).first == v.end());
+    for (int p = 0; p < n; ++p) {
+      w[p] = T(100);
+      std::pair<T*, T*> m = std::mismatch(v.data(), v.data() + n, w.data());
+      assert(m.first == v.data() + p);
+      assert(m.second == w.data() + p);
+      assert(!std::equal(v.begin(), v.end(), w.begin()));
+#if TEST_STD_VER > 11
+      assert(std::mismatch(v.begin(), v.end(), w.begin(), w.begin() + p).first == v.begin() + p);
+      assert(!std::equal(v.begin(), v.end(), w.begin(), w.end()));
+      assert(std::equal(v.begin(), v.begin() + p, w.begin(), w.begin() + p));
+#endif
+      w[p] = v[p];
+    }
+  }
+}
+
+void test_count_overflow() {
+  std::vector<char> c(100000, 'a');
+  assert(std::count(c.begin(), c.end(), 'a') == 100000);
+  std::vector<short> s(200000, 3);
+  assert(std::count(s.begin(), s.end(), short(3)) == 200000);
+}
+
+void test_value_conversion() {
+  // The value isn't the element type, so it must not be truncated to it.
+  std::vector<char> c(40, 44);
+  assert(std::find(c.begin(), c.end(), 300) == c.end());
+  assert(std::count(c.begin(), c.end(), 300) == 0);
+}
+
+void test_floating_point() {
+  std::vector<double> d(40, 1.0);
+  d[20] = -0.0;
+  d[30] = NAN;
+  assert(std::find(d.begin(), d.end(), 0.0) == d.begin() + 20);
+  assert(std::find(d.begin(), d.end(), static_cast<double>(NAN)) == d.end());
+  assert(std::count(d.begin(), d.end(), 0.0) == 1);
+  std::vector<double> e = d;
+  e[20] = 0.0;
+  assert(std::mismatch(d.begin(), d.end(), e.begin()).first == d.begin() + 30);
+}
+
+#if TEST_STD_VER > 17
+constexpr bool test_constexpr() {
+  int a[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18};
+  return std::find(a, a + 18, 17) == a + 16 && std::count(a, a + 18, 17) == 1 &&
+         std::equal(a, a + 18, a) && std::mismatch(a, a + 18, a, a + 18).first == a + 18;
+}
+static_assert(test_constexpr(), "");
+#endif
+
+int main(int, char**) {
+  test_type<char>();
+  test_type<signed char>();
+  test_type<unsigned char>();
+  test_type<short>();
+  test_type<unsigned short>();
+  test_type<int>();
+  test_type<long long>();
+  test_type<float>();
+  test_type<double>();
+  test_count_overflow();
+  test_value_conversion();
+  test_floating_point();
+
+  return 0;
+}
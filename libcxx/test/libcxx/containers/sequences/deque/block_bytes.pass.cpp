@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <deque>
+
+// _LIBCPP_DEQUE_BLOCK_BYTES sets the size of deque's blocks.
+
+#define _LIBCPP_DEQUE_BLOCK_BYTES 256
+
+#include <deque>
+#include <cassert>
+
+#include "test_macros.h"
+
+struct Large {
+  char data[64];
+};
+
+static_assert(std::__deque_block_size<char, long>::value == 256, "");
+static_assert(std::__deque_block_size<int, long>::value == 64, "");
+static_assert(std::__deque_block_size<Large, long>::value == 16, "");
+
+int main(int, char**) {
+  std::deque<int> d;
+  for (int i = 0; i < 1000; ++i) {
+    d.push_back(i);
+    d.push_front(-i);
+  }
+  assert(d.size() == 2000);
+  for (int i = 0; i < 1000; ++i) {
+    assert(d[999 - i] == -i);
+    assert(d[1000 + i] == i);
+  }
+  d.erase(d.begin() + 100, d.begin() + 1900);
+  assert(d.size() == 200);
+  assert(d[99] == -900);
+  assert(d[100] == 900);
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// <vector>
+
+// When the vector grows, trivially relocatable elements are moved to the new
+// buffer with memcpy and the old ones are not destroyed.
+
+#include <vector>
+#include <cassert>
+#include <memory>
+#include <string>
+
+#include "test_macros.h"
+
+static_assert(std::__libcpp_is_trivially_relocatable<int>::value, "");
+static_assert(std::__libcpp_is_trivially_relocatable<std::unique_ptr<int> >::value, "");
+static_assert(std::__libcpp_is_trivially_relocatable<std::unique_ptr<int[]> >::value, "");
+static_assert(std::__libcpp_is_trivially_relocatable<std::shared_ptr<int> >::value, "");
+static_assert(std::__libcpp_is_trivially_relocatable<std::weak_ptr<int> >::value, "");
+#if _LIBCPP_DEBUG_LEVEL < 2
+static_assert(std::__libcpp_is_trivially_relocatable<std::string>::value, "");
+static_assert(std::__libcpp_is_trivially_relocatable<std::vector<int> >::value, "");
+#endif
+
+struct Counted {
+  static int alive;
+  int value;
+  Counted(int v) : value(v) { ++alive; }
+  Counted(const Counted& c) : value(c.value) { ++alive; }
+  ~Counted() { --alive; }
+};
+int Counted::alive = 0;
+
+static_assert(!std::__libcpp_is_trivially_relocatable<Counted>::value, "");
+static_assert(!std::__libcpp_is_trivially_relocatable<
+                  std::unique_ptr<int, void (*)(int*)> >::value, "");
+
+// An allocator with its own construct must see every element constructed.
+template <class T>
+struct ConstructCountingAllocator {
+  typedef T value_type;
+  static int constructed;
+  ConstructCountingAllocator() {}
+  template <class U>
+  ConstructCountingAllocator(const ConstructCountingAllocator<U>&) {}
+  T* allocate(std::size_t n) { return std::allocator<T>().allocate(n); }
+  void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+  template <class U, class... Args>
+  void construct(U* p, Args&&... args) {
+    ++constructed;
+    ::new ((void*)p) U(std::forward<Args>(args)...);
+  }
+  friend bool operator==(ConstructCountingAllocator, ConstructCountingAllocator) { return true; }
+  friend bool operator!=(ConstructCountingAllocator, ConstructCountingAllocator) { return false; }
+};
+template <class T>
+int ConstructCountingAllocator<T>::constructed = 0;
+
+static_assert(!std::__allocator_can_relocate<ConstructCountingAllocator<std::string>,
+                                             std::string>::value, "");
+
+int main(int, char**) {
+  {
+    std::vector<std::unique_ptr<int> > v;
+    for (int i = 0; i < 100; ++i)
+      v.push_back(std::unique_ptr<int>(new int(i)));
+    v.insert(v.begin() + 50, std::unique_ptr<int>(new int(-1)));
+    v.shrink_to_fit();
+    assert(v.size() == 101);
+    for (int i = 0; i < 101; ++i)
+      assert(*v[i] == (i < 50 ? i : i == 50 ? -1 : i - 1));
+  }
+  {
+    std::shared_ptr<int> p = std::make_shared<int>(42);
+    std::vector<std::shared_ptr<int> > v;
+    for (int i = 0; i < 100; ++i)
+      v.push_back(p);
+    v.reserve(1000);
+    assert(p.use_count() == 101);
+    v.clear();
+    assert(p.use_count() == 1);
+  }
+  {
+    // Short strings keep their characters inside the object.
+    std::vector<std::string> v;
+    for (int i = 0; i < 100; ++i)
+      v.push_back(std::string(i % 2 ? 3 : 100, char('a' + i % 26)));
+    v.emplace(v.begin() + 10, "inserted");
+    assert(v.size() == 101);
+    assert(v[10] == "inserted");
+    for (int i = 0; i < 100; ++i) {
+      const std::string& s = v[i < 10 ? i : i + 1];
+      assert(s == std::string(i % 2 ? 3 : 100, char('a' + i % 26)));
+    }
+  }
+  {
+    std::vector<std::vector<int> > v;
+    for (int i = 0; i < 100; ++i)
+      v.push_back(std::vector<int>(i, i));
+    for (int i = 0; i < 100; ++i)
+      assert(v[i] == std::vector<int>(i, i));
+  }
+  {
+    std::vector<Counted> v;
+    for (int i = 0; i < 100; ++i)
+      v.push_back(Counted(i));
+    assert(Counted::alive == 100);
+    v.clear();
+    assert(Counted::alive == 0);
+  }
+  {
+    typedef ConstructCountingAllocator<std::string> Alloc;
+    std::vector<std::string, Alloc> v;
+    v.reserve(1);
+    v.push_back("a");
+    v.push_back("b");
+    assert(Alloc::constructed == 3);
+  }
+
+  return 0;
+}
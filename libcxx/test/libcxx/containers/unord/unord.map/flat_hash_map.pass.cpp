@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// Not a portable test
+
+// <unordered_map>
+
+// class __flat_hash_map
+
+#include <unordered_map>
+#include <cassert>
+#include <string>
+
+#include "test_macros.h"
+
+// Sends every key to the same group, so that lookups have to probe past
+// full groups and erased slots.
+struct BadHash {
+  size_t operator()(int) const { return 0; }
+};
+
+int main(int, char**)
+{
+    {
+        std::__flat_hash_map<int, int> m;
+        assert(m.empty());
+        assert(m.bucket_count() == 0);
+        assert(m.find(1) == m.end());
+        assert(m.begin() == m.end());
+        for (int i = 0; i < 1000; ++i)
+            assert(m.emplace(i, 2 * i).second);
+        assert(m.size() == 1000);
+        assert(!m.emplace(7, 0).second);
+        assert(m.load_factor() <= m.max_load_factor());
+        for (int i = 0; i < 1000; ++i)
+        {
+            assert(m.find(i) != m.end());
+            assert(m.at(i) == 2 * i);
+        }
+        assert(!m.contains(1000));
+        int count = 0;
+        long sum = 0;
+        for (std::__flat_hash_map<int, int>::const_iterator i = m.cbegin(); i != m.cend(); ++i)
+        {
+            ++count;
+            sum += i->first;
+        }
+        assert(count == 1000);
+        assert(sum == 999 * 1000 / 2);
+        for (int i = 0; i < 1000; i += 2)
+            assert(m.erase(i) == 1);
+        assert(m.erase(0) == 0);
+        assert(m.size() == 500);
+        for (int i = 0; i < 1000; ++i)
+            assert(m.count(i) == static_cast<size_t>(i % 2));
+    }
+    {
+        std::__flat_hash_map<int, int, BadHash> m;
+        for (int i = 0; i < 100; ++i)
+            m[i] = i;
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int i = 0; i < 100; i += 3)
+                m.erase(i);
+            for (int i = 0; i < 100; i += 3)
+                assert(m.try_emplace(i, i).second);
+        }
+        assert(m.size() == 100);
+        for (int i = 0; i < 100; ++i)
+            assert(m.at(i) == i);
+    }
+    {
+        std::__flat_hash_map<std::string, std::string> m;
+        m["one"] = "1";
+        m.insert_or_assign("two", "2");
+        m.insert_or_assign("one", "uno");
+        m.insert(std::make_pair(std::string("three"), std::string("3")));
+        assert(m.size() == 3);
+        assert(m["one"] == "uno");
+
+        std::__flat_hash_map<std::string, std::string> c(m);
+        assert(c == m);
+        c.erase(c.find("two"));
+        assert(c != m);
+        c = m;
+        assert(c == m);
+
+        std::__flat_hash_map<std::string, std::string> d(std::move(c));
+        assert(d == m);
+        assert(c.empty());
+        d.clear();
+        assert(d.empty());
+        assert(d.find("one") == d.end());
+        swap(d, m);
+        assert(d.size() == 3);
+        assert(m.empty());
+    }
+    {
+        std::__flat_hash_map<int, int> m = {{1, 1}, {2, 2}, {3, 3}};
+        m.reserve(1000);
+        std::size_t buckets = m.bucket_count();
+        for (int i = 0; i < 1000; ++i)
+            m[i] = i;
+        assert(m.bucket_count() == buckets);
+        for (std::__flat_hash_map<int, int>::iterator i = m.begin(); i != m.end();)
+        {
+            if (i->first % 3 == 0)
+                i = m.erase(i);
+            else
+                ++i;
+        }
+        assert(m.size() == 666);
+        m.rehash(0);
+        assert(m.bucket_count() < buckets);
+        for (int i = 0; i < 1000; ++i)
+            assert(m.contains(i) == (i % 3 != 0));
+    }
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Not a portable test
+
+// <unordered_map>
+
+// With _LIBCPP_ABI_HASH_TABLE_NODE_CACHE, erased nodes are reused by later
+// insertions, reserve() allocates the nodes up front, and every node is
+// freed with the container.
+
+#include <unordered_map>
+#include <cassert>
+
+#include "test_macros.h"
+#include "count_new.h"
+
+int main(int, char**)
+{
+#ifdef _LIBCPP_ABI_HASH_TABLE_NODE_CACHE
+    globalMemCounter.reset();
+    {
+        std::unordered_map<int, int> m;
+        m.reserve(100);
+        int allocated = globalMemCounter.new_called;
+        for (int i = 0; i < 100; ++i)
+            m[i] = i;
+        assert(globalMemCounter.checkNewCalledEq(allocated));
+
+        for (int i = 0; i < 100; i += 2)
+            m.erase(m.find(i));
+        for (int i = 0; i < 100; i += 2)
+            m.insert(std::make_pair(i + 100, i));
+        m.clear();
+        for (int i = 0; i < 100; ++i)
+            m.emplace(i, i);
+        assert(globalMemCounter.checkNewCalledEq(allocated));
+        assert(m.size() == 100);
+
+        std::unordered_map<int, int> m2;
+        m2.swap(m);
+        m2.clear();
+        for (int i = 0; i < 100; ++i)
+            m2[i] = i;
+        assert(globalMemCounter.checkNewCalledEq(allocated));
+
+        // Asking for fewer buckets gives the spare nodes back.
+        m2.clear();
+        m2.rehash(0);
+        assert(globalMemCounter.checkOutstandingNewEq(0));
+        m2[1] = 1;
+        assert(globalMemCounter.checkNewCalledGreaterThan(allocated));
+    }
+    assert(globalMemCounter.checkOutstandingNewEq(0));
+#endif
+
+  return 0;
+}
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// Not a portable test
+
+// <unordered_set>
+
+// class __flat_hash_set
+
+#include <unordered_set>
+#include <cassert>
+#include <string>
+
+#include "test_macros.h"
+#include "min_allocator.h"
+
+template <class Set>
+void test()
+{
+    Set s;
+    for (int i = 0; i < 500; ++i)
+        assert(s.insert(i * 7).second);
+    assert(!s.insert(7).second);
+    assert(s.size() == 500);
+    for (int i = 0; i < 500 * 7; ++i)
+        assert(s.contains(i) == (i % 7 == 0));
+
+    Set t(s.begin(), s.end());
+    assert(t == s);
+    for (typename Set::const_iterator i = t.begin(); i != t.end();)
+        i = t.erase(i);
+    assert(t.empty());
+    assert(t != s);
+
+    s.clear();
+    assert(s.size() == 0);
+    assert(s.begin() == s.end());
+    s.emplace(3);
+    assert(s.count(3) == 1);
+}
+
+int main(int, char**)
+{
+    test<std::__flat_hash_set<int> >();
+    test<std::__flat_hash_set<int, std::hash<int>, std::equal_to<int>, min_allocator<int> > >();
+    {
+        std::__flat_hash_set<std::string> s = {"a", "b", "c"};
+        assert(s.size() == 3);
+        assert(s.find("b") != s.end());
+        assert(s.erase("b") == 1);
+        assert(s.find("b") == s.end());
+    }
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <sstream>
+
+// basic_stringbuf makes room for a whole sputn at once, without going through
+// overflow.
+
+#include <sstream>
+#include <cassert>
+#include <string>
+
+#include "test_macros.h"
+
+int overflow_called = 0;
+
+template <class CharT>
+struct testbuf
+    : public std::basic_stringbuf<CharT>
+{
+    typedef std::basic_stringbuf<CharT> base;
+    explicit testbuf(const std::basic_string<CharT>& str,
+                     std::ios_base::openmode which = std::ios_base::in | std::ios_base::out)
+        : base(str, which) {}
+
+    typename base::int_type
+        overflow(typename base::int_type c = base::traits_type::eof())
+        {++overflow_called; return base::overflow(c);}
+};
+
+template <class CharT>
+void test()
+{
+    std::basic_string<CharT> big(10000, CharT('x'));
+    {
+        overflow_called = 0;
+        testbuf<CharT> sb(std::basic_string<CharT>(), std::ios_base::out);
+        assert(sb.sputn(big.data(), big.size()) == static_cast<std::streamsize>(big.size()));
+        assert(overflow_called == 0);
+        assert(sb.str() == big);
+        assert(sb.sputc(CharT('y')) == CharT('y'));
+        assert(sb.str() == big + CharT('y'));
+    }
+    {
+        // The get area follows the string to its new buffer.
+        overflow_called = 0;
+        testbuf<CharT> sb(std::basic_string<CharT>(3, CharT('a')));
+        assert(sb.sbumpc() == CharT('a'));
+        assert(sb.sputn(big.data(), big.size()) == static_cast<std::streamsize>(big.size()));
+        assert(overflow_called == 0);
+        assert(sb.sbumpc() == CharT('x'));
+        std::basic_string<CharT> rest(big.size(), CharT());
+        assert(sb.sgetn(&rest[0], rest.size()) == static_cast<std::streamsize>(big.size() - 2));
+        assert(rest.substr(0, big.size() - 2) == big.substr(2));
+    }
+    {
+        overflow_called = 0;
+        testbuf<CharT> sb(std::basic_string<CharT>(3, CharT('a')), std::ios_base::out | std::ios_base::app);
+        assert(sb.sputn(big.data(), big.size()) == static_cast<std::streamsize>(big.size()));
+        assert(overflow_called == 0);
+        assert(sb.str() == std::basic_string<CharT>(3, CharT('a')) + big);
+    }
+    {
+        // Reading only: nothing to grow, and sputn writes nothing.
+        testbuf<CharT> sb(std::basic_string<CharT>(3, CharT('a')), std::ios_base::in);
+        assert(sb.sputn(big.data(), big.size()) == 0);
+        assert(sb.str() == std::basic_string<CharT>(3, CharT('a')));
+    }
+}
+
+int main(int, char**)
+{
+    test<char>();
+    test<wchar_t>();
+
+    return 0;
+}
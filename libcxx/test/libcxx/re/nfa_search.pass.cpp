@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// <regex>
+
+// ECMAScript patterns without back references or lookahead are searched by
+// running all alternatives in lock step. The results must be the ones the
+// backtracking matcher would give, and must not depend on how much
+// backtracking the pattern would need.
+
+#include <regex>
+#include <cassert>
+#include <string>
+
+#include "test_macros.h"
+
+static void test_priority()
+{
+    std::cmatch m;
+    // The first alternative that leads to a match wins, not the longest.
+    assert(std::regex_search("abcd", m, std::regex("a|ab|abc")));
+    assert(m.length(0) == 1);
+    assert(std::regex_search("abcd", m, std::regex("(a|ab)(c|bcd)")));
+    assert(m.str(0) == "abcd" && m.str(1) == "a" && m.str(2) == "bcd");
+    // Greedy and non-greedy repeats.
+    assert(std::regex_search("<a><b>", m, std::regex("<.*>")));
+    assert(m.str(0) == "<a><b>");
+    assert(std::regex_search("<a><b>", m, std::regex("<.*?>")));
+    assert(m.str(0) == "<a>");
+    // Captures inside a repeat report the last iteration.
+    assert(std::regex_search("xabcabdy", m, std::regex("(ab[cd])+")));
+    assert(m.position(0) == 1 && m.str(0) == "abcabd" && m.str(1) == "abd");
+    assert(std::regex_search("aaa", m, std::regex("(a)|b")));
+    assert(m.position(0) == 0 && m.str(1) == "a");
+    assert(std::regex_search("b", m, std::regex("(a)|b")));
+    assert(!m[1].matched);
+    // Bounded repeats.
+    assert(std::regex_search("a1b22c333", m, std::regex("[0-9]{2,3}")));
+    assert(m.str(0) == "22");
+    assert(std::regex_search("aaaaa", m, std::regex("a{2,3}?")));
+    assert(m.str(0) == "aa");
+    assert(!std::regex_search("ab", m, std::regex("a{2}")));
+}
+
+static void test_assertions()
+{
+    std::cmatch m;
+    assert(std::regex_search("foo bar", m, std::regex("\\bbar")));
+    assert(m.position(0) == 4);
+    assert(!std::regex_search("foobar", m, std::regex("\\bbar")));
+    assert(!std::regex_search("foobar", m, std::regex("^bar")));
+    assert(std::regex_search("foobar", m, std::regex("o+bar$")));
+    assert(m.position(0) == 1);
+}
+
+static void test_flags()
+{
+    std::cmatch m;
+    // An empty match is rejected, so the search carries on to the next one.
+    assert(std::regex_search("bab", m, std::regex("a*"), std::regex_constants::match_not_null));
+    assert(m.position(0) == 1 && m.length(0) == 1);
+    assert(!std::regex_search("bab", m, std::regex("a"), std::regex_constants::match_continuous));
+    assert(std::regex_search("abab", m, std::regex("ab"), std::regex_constants::match_continuous));
+    assert(m.position(0) == 0);
+    const char s[] = "foo bar";
+    assert(!std::regex_search(s + 4, m, std::regex("\\bbar"), std::regex_constants::match_not_bow));
+    assert(std::regex_search(s + 4, m, std::regex("\\bbar"), std::regex_constants::match_prev_avail));
+    assert(!std::regex_search(s + 5, m, std::regex("\\bar"), std::regex_constants::match_prev_avail));
+    assert(std::regex_match("abc", m, std::regex("a|abc")));
+    assert(m.length(0) == 3);
+    assert(!std::regex_match("abcd", m, std::regex("a|abc")));
+}
+
+static void test_fallback()
+{
+    std::cmatch m;
+    assert(std::regex_search("xabab", m, std::regex("(ab)\\1")));
+    assert(m.position(0) == 1 && m.str(1) == "ab");
+    assert(std::regex_search("foobar foobaz", m, std::regex("foo(?=baz)")));
+    assert(m.position(0) == 7);
+    assert(std::regex_search("foobar foobaz", m, std::regex("foo(?!bar)")));
+    assert(m.position(0) == 7);
+}
+
+static void test_no_blowup()
+{
+    // Each of these makes the backtracking matcher give up with
+    // error_complexity.
+    std::string s(30, 'a');
+    assert(std::regex_match(s, std::regex("(a|aa)*b|(a|aa)*")));
+    assert(!std::regex_search(s, std::regex("(a*)*b")));
+    assert(std::regex_search(s, std::regex(
+        "a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?"
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")));
+    std::string t(20000, 'a');
+    assert(!std::regex_search(t, std::regex("(a|b)*c")));
+}
+
+static void test_wide()
+{
+    std::wcmatch m;
+    assert(std::regex_search(L"xxabcabcyy", m, std::wregex(L"(abc)+")));
+    assert(m.position(0) == 2 && m.length(0) == 6 && m.str(1) == L"abc");
+}
+
+int main(int, char**)
+{
+    test_priority();
+    test_assertions();
+    test_flags();
+    test_fallback();
+    test_no_blowup();
+    test_wide();
+    return 0;
+}
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <string>
+
+// template <class Op> void __resize_and_overwrite(size_type, Op)
+
+#include <string>
+#include <cassert>
+#include <cstring>
+
+#include "test_macros.h"
+
+struct Fill {
+  char c;
+  std::size_t used;
+  std::size_t operator()(char* buf, std::size_t n) const {
+    assert(n >= used);
+    std::memset(buf, c, used);
+    return used;
+  }
+};
+
+void test_basic() {
+  {
+    std::string s;
+    Fill f = {'a', 3};
+    s.__resize_and_overwrite(5, f);
+    assert(s.size() == 3);
+    assert(s == "aaa");
+    assert(s.data()[3] == '\0');
+  }
+  {
+    std::string s("hello");
+    Fill f = {'b', 2};
+    s.__resize_and_overwrite(2, f);
+    assert(s == "bb");
+    assert(s.data()[2] == '\0');
+  }
+}
+
+void test_grow() {
+  // Growing keeps the old contents in place for the operation to see.
+  std::string s("abc");
+  const std::size_t n = 200;
+  struct Append {
+    std::size_t operator()(char* buf, std::size_t len) const {
+      assert(std::memcmp(buf, "abc", 3) == 0);
+      std::memset(buf + 3, 'x', len - 3);
+      return len;
+    }
+  };
+  s.__resize_and_overwrite(n, Append());
+  assert(s.size() == n);
+  assert(s.capacity() >= n);
+  assert(s.compare(0, 3, "abc") == 0);
+  assert(s.find_first_not_of('x', 3) == std::string::npos);
+  assert(s.data()[n] == '\0');
+}
+
+void test_shrink_to_nothing() {
+  std::string s(100, 'z');
+  Fill f = {'q', 0};
+  s.__resize_and_overwrite(50, f);
+  assert(s.empty());
+  assert(s.data()[0] == '\0');
+}
+
+int main(int, char**) {
+  test_basic();
+  test_grow();
+  test_shrink_to_nothing();
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads, libcpp-has-thread-api-external
+// UNSUPPORTED: c++98, c++03
+
+// <thread>
+
+// template <class F, class ...Args>
+//     thread(const __thread_attributes& attr, F&& f, Args&&... args);
+
+#include <thread>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include "test_macros.h"
+
+#if defined(__linux__) && defined(__GLIBC__)
+#  include <pthread.h>
+#  include <sched.h>
+#  define TEST_LINUX_ATTRIBUTES
+#endif
+
+int main(int, char**)
+{
+  {
+    // Default attributes behave like no attributes.
+    int result = 0;
+    std::thread t(std::__thread_attributes(), [&](int x) { result = x; }, 7);
+    t.join();
+    assert(result == 7);
+  }
+#ifndef TEST_HAS_NO_EXCEPTIONS
+  {
+    try {
+      std::__thread_attributes().__add_cpu(1u << 20);
+      assert(false);
+    } catch (const std::out_of_range&) {
+    }
+  }
+#endif
+#ifdef TEST_LINUX_ATTRIBUTES
+  {
+    const std::size_t stack_size = 4 << 20;
+    std::size_t seen_stack_size = 0;
+    bool only_cpu0 = false;
+    char name[16] = {};
+    std::thread t(std::__thread_attributes()
+                      .__set_stack_size(stack_size)
+                      .__add_cpu(0)
+                      .__set_name("attributes-test-thread"),
+                  [&] {
+                    pthread_attr_t attr;
+                    assert(pthread_getattr_np(pthread_self(), &attr) == 0);
+                    assert(pthread_attr_getstacksize(&attr, &seen_stack_size) == 0);
+                    pthread_attr_destroy(&attr);
+                    cpu_set_t cpus;
+                    assert(sched_getaffinity(0, sizeof(cpus), &cpus) == 0);
+                    only_cpu0 = CPU_ISSET(0, &cpus) && CPU_COUNT(&cpus) == 1;
+                  });
+    t.join();
+    assert(seen_stack_size >= stack_size);
+    assert(only_cpu0);
+
+    // The name is cut to what Linux keeps, and set once the thread exists.
+    std::thread named(std::__thread_attributes().__set_name("a-very-long-thread-name"), [] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    });
+    assert(pthread_getname_np(named.native_handle(), name, sizeof(name)) == 0);
+    assert(std::strcmp(name, "a-very-long-thr") == 0);
+    named.join();
+  }
+#  ifndef TEST_HAS_NO_EXCEPTIONS
+  {
+    // A stack too small to run on is reported.
+    try {
+      std::thread t(std::__thread_attributes().__set_stack_size(1), [] {});
+      assert(false);
+    } catch (const std::system_error&) {
+    }
+  }
+#  endif
+#endif
+#if TEST_STD_VER > 17
+  {
+    bool stopped = false;
+    {
+      std::jthread t(std::__thread_attributes().__set_stack_size(1 << 20), [&](std::stop_token st) {
+        while (!st.stop_requested())
+          std::this_thread::yield();
+        stopped = true;
+      });
+    }
+    assert(stopped);
+  }
+#endif
+
+  return 0;
+}
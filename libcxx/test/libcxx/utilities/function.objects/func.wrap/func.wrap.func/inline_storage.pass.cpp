@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+
+// The test suite needs to define the ABI macros on the command line when
+// modules are enabled.
+// UNSUPPORTED: -fmodules
+
+// <functional>
+
+// With _LIBCPP_ABI_OPTIMIZED_FUNCTION, std::function keeps trivially copyable
+// callables of up to _LIBCPP_ABI_FUNCTION_INLINE_STORAGE_SIZE bytes inline, so
+// creating, copying, moving and swapping them never allocates.
+
+#define _LIBCPP_ABI_OPTIMIZED_FUNCTION
+#define _LIBCPP_ABI_FUNCTION_INLINE_STORAGE_SIZE (4 * sizeof(void*))
+
+#include <functional>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "test_macros.h"
+#include "count_new.h"
+
+// The buffer, the call pointer and the policy pointer.
+static_assert(sizeof(std::function<int()>) == 6 * sizeof(void*), "");
+
+struct alignas(2 * alignof(std::max_align_t)) OverAligned {
+    int operator()() const { return 3; }
+};
+
+static int plus_one(int i) { return i + 1; }
+
+template <class F>
+static void check_inline(F fn, int expected)
+{
+    globalMemCounter.reset();
+    {
+        std::function<int()> f = fn;
+        assert(f() == expected);
+        std::function<int()> g = f;
+        assert(g() == expected);
+        std::function<int()> h = std::move(g);
+        assert(h() == expected);
+        std::function<int()> e;
+        e.swap(h);
+        assert(e() == expected && !h);
+        h = e;
+        assert(h() == expected);
+#ifndef TEST_HAS_NO_RTTI
+        assert(f.template target<F>() != nullptr);
+#endif
+    }
+    assert(globalMemCounter.checkNewCalledEq(0));
+}
+
+template <class F>
+static void check_allocated(F fn, int expected)
+{
+    globalMemCounter.reset();
+    {
+        std::function<int()> f = fn;
+        assert(globalMemCounter.checkOutstandingNewEq(1));
+        std::function<int()> g = f;
+        assert(globalMemCounter.checkOutstandingNewEq(2));
+        assert(f() == expected && g() == expected);
+        std::function<int()> h = std::move(g);
+        assert(globalMemCounter.checkOutstandingNewEq(2));
+        assert(h() == expected);
+    }
+    assert(globalMemCounter.checkOutstandingNewEq(0));
+}
+
+int main(int, char**)
+{
+    std::intptr_t a = 1, b = 2, c = 3, d = 4, e = 5;
+    check_inline([] { return 0; }, 0);
+    check_inline([a] { return int(a); }, 1);
+    check_inline([a, b, c, d] { return int(a + b + c + d); }, 10);
+    check_inline(std::bind(plus_one, 41), 42);
+
+    // Too large for the buffer.
+    check_allocated([a, b, c, d, e] { return int(a + b + c + d + e); }, 15);
+    // Small, but not trivially copyable.
+    std::string s = "abc";
+    check_allocated([s] { return int(s.size()); }, 3);
+    // Small, but more strictly aligned than the buffer.
+    check_allocated(OverAligned(), 3);
+
+    globalMemCounter.reset();
+    {
+        std::function<int(int)> f = plus_one;
+        assert(f(1) == 2);
+        std::function<int(int)> g = std::move(f);
+        assert(g(2) == 3);
+    }
+    assert(globalMemCounter.checkNewCalledEq(0));
+
+    return 0;
+}
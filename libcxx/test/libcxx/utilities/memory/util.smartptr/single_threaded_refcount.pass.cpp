@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads, c++98, c++03
+//
+// <memory>
+//
+// class shared_ptr
+//
+// Until the process starts a second thread the reference counts may be
+// updated without atomics. Counts taken before the first thread is started
+// have to carry over to the atomic updates made after it.
+
+#include <memory>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include "test_macros.h"
+
+typedef std::shared_ptr<int> Ptr;
+typedef std::weak_ptr<int> WeakPtr;
+
+int main(int, char**) {
+#if defined(_LIBCPP_HAS_SINGLE_THREADED_REFCOUNT)
+  assert(std::__libcpp_refcount_is_single_threaded());
+#endif
+
+  Ptr p = std::make_shared<int>(42);
+  std::vector<Ptr> copies(10, p);
+  WeakPtr w = p;
+  assert(p.use_count() == 11);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([p, w] {
+      for (int j = 0; j < 10000; ++j) {
+        Ptr copy = p;
+        Ptr locked = w.lock();
+        assert(locked);
+      }
+    });
+  }
+#if defined(_LIBCPP_HAS_SINGLE_THREADED_REFCOUNT)
+  assert(!std::__libcpp_refcount_is_single_threaded());
+#endif
+  for (auto& t : threads)
+    t.join();
+
+  assert(p.use_count() == 11);
+  copies.clear();
+  assert(p.use_count() == 1);
+  p.reset();
+  assert(w.expired());
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// template<RandomAccessIterator Iter, StrictWeakOrder<auto, Iter::value_type> Compare>
+//   requires ShuffleIterator<Iter>
+//         && CopyConstructible<Compare>
+//   void
+//   sort(Iter first, Iter last, Compare comp);
+
+// Complexity: O(N log N) comparisons, also on inputs built to defeat the
+// choice of pivot.
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "test_macros.h"
+
+// McIlroy's adversary: every value starts out undecided, and is only fixed
+// when it has to be. An undecided value compares greater than every fixed
+// one, and of two undecided values the one that looks like the pivot is fixed
+// first, making the pivot as small as possible.
+struct adversary
+{
+    std::vector<int>* values;
+    int* solid;
+    int* candidate;
+    int gas;
+    long* comparisons;
+
+    bool operator()(int x, int y) const
+    {
+        ++*comparisons;
+        std::vector<int>& v = *values;
+        if (v[x] == gas && v[y] == gas)
+            v[x == *candidate ? x : y] = (*solid)++;
+        if (v[x] == gas)
+            *candidate = x;
+        else if (v[y] == gas)
+            *candidate = y;
+        return v[x] < v[y];
+    }
+};
+
+struct counting_less
+{
+    long* comparisons;
+
+    bool operator()(int x, int y) const
+    {
+        ++*comparisons;
+        return x < y;
+    }
+};
+
+long max_comparisons(int n)
+{
+    long log2n = 0;
+    for (int i = n; i > 1; i >>= 1)
+        ++log2n;
+    return 4 * n * (log2n + 1);
+}
+
+void test(int n)
+{
+    // Let the adversary build its input...
+    std::vector<int> values(n, n);
+    std::vector<int> order(n);
+    for (int i = 0; i < n; ++i)
+        order[i] = i;
+    int solid = 0;
+    int candidate = 0;
+    long comparisons = 0;
+    adversary adv = {&values, &solid, &candidate, n, &comparisons};
+    std::sort(order.begin(), order.end(), adv);
+    assert(comparisons <= max_comparisons(n));
+
+    // ... then sort that input for real.
+    comparisons = 0;
+    counting_less less = {&comparisons};
+    std::vector<int> copy = values;
+    std::sort(copy.begin(), copy.end(), less);
+    assert(std::is_sorted(copy.begin(), copy.end()));
+    assert(comparisons <= max_comparisons(n));
+
+    std::sort(values.begin(), values.end());
+    assert(std::is_sorted(values.begin(), values.end()));
+}
+
+int main(int, char**)
+{
+    test(100);
+    test(1000);
+    test(10000);
+    test(100000);
+
+  return 0;
+}
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <atomic>
+
+// struct atomic_flag
+
+// void atomic_flag_wait(const volatile atomic_flag*, bool);
+// void atomic_flag_wait(const atomic_flag*, bool);
+// void atomic_flag_notify_one(atomic_flag*);
+// void atomic_flag_notify_all(atomic_flag*);
+
+#include <atomic>
+#include <thread>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+    {
+        std::atomic_flag f = ATOMIC_FLAG_INIT;
+        // Returns straight away when the value already differs.
+        std::atomic_flag_wait(&f, true);
+        f.wait(true, std::memory_order_acquire);
+
+        std::thread t([&]() {
+            f.test_and_set();
+            std::atomic_flag_notify_one(&f);
+        });
+        std::atomic_flag_wait(&f, false);
+        t.join();
+        assert(f.test_and_set());
+    }
+    {
+        volatile std::atomic_flag f;
+        f.test_and_set();
+        std::thread t([&]() {
+            f.clear();
+            std::atomic_flag_notify_all(&f);
+        });
+        std::atomic_flag_wait_explicit(&f, true, std::memory_order_seq_cst);
+        t.join();
+    }
+
+  return 0;
+}
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <atomic>
+
+// template <class T>
+//     void
+//     atomic_notify_all(volatile atomic<T>* obj);
+//
+// template <class T>
+//     void
+//     atomic_notify_all(atomic<T>* obj);
+
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <cassert>
+
+#include "test_macros.h"
+#include "atomic_helpers.h"
+
+template <class T>
+struct TestFn {
+  void operator()() const {
+    typedef std::atomic<T> A;
+    {
+      A t;
+      std::atomic_init(&t, T(1));
+      std::atomic<int> started(0);
+      auto waiter = [&]() {
+        ++started;
+        t.wait(T(1));
+        assert(t.load() == T(3));
+      };
+      std::thread t1(waiter);
+      std::thread t2(waiter);
+      while (started.load() != 2)
+        std::this_thread::yield();
+      std::atomic_store(&t, T(3));
+      std::atomic_notify_all(&t);
+      t1.join();
+      t2.join();
+    }
+    {
+      volatile A vt;
+      std::atomic_init(&vt, T(2));
+      std::thread t1([&]() {
+        std::atomic_wait(&vt, T(2));
+        assert(std::atomic_load(&vt) == T(4));
+      });
+      std::atomic_store(&vt, T(4));
+      std::atomic_notify_all(&vt);
+      t1.join();
+    }
+  }
+};
+
+int main(int, char**)
+{
+    TestEachAtomicType<TestFn>()();
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <atomic>
+
+// template <class T>
+//     void
+//     atomic_wait(const volatile atomic<T>* obj, T old);
+//
+// template <class T>
+//     void
+//     atomic_wait(const atomic<T>* obj, T old);
+//
+// template <class T>
+//     void
+//     atomic_wait_explicit(const atomic<T>* obj, T old, memory_order m);
+
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <cassert>
+
+#include "test_macros.h"
+#include "atomic_helpers.h"
+
+template <class T>
+struct TestFn {
+  void operator()() const {
+    typedef std::atomic<T> A;
+    {
+      A t;
+      std::atomic_init(&t, T(1));
+      // Returns straight away when the value already differs.
+      std::atomic_wait(&t, T(0));
+      std::atomic_wait_explicit(&t, T(0), std::memory_order_acquire);
+      t.wait(T(0));
+
+      std::thread t1([&]() {
+        std::atomic_store(&t, T(3));
+        std::atomic_notify_one(&t);
+      });
+      std::atomic_wait(&t, T(1));
+      assert(std::atomic_load(&t) == T(3));
+      t1.join();
+    }
+    {
+      volatile A vt;
+      std::atomic_init(&vt, T(2));
+      std::atomic_wait(&vt, T(1));
+
+      std::thread t2([&]() {
+        std::atomic_store(&vt, T(4));
+        std::atomic_notify_one(&vt);
+      });
+      std::atomic_wait_explicit(&vt, T(2), std::memory_order_seq_cst);
+      assert(std::atomic_load(&vt) == T(4));
+      t2.join();
+    }
+  }
+};
+
+int main(int, char**)
+{
+    TestEachAtomicType<TestFn>()();
+
+  return 0;
+}
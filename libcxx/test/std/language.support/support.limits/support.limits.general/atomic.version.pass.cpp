@@ -18,6 +18,7 @@
 /*  Constant                                Value
     __cpp_lib_atomic_is_always_lock_free    201603L [C++17]
     __cpp_lib_atomic_ref                    201806L [C++2a]
+    __cpp_lib_atomic_wait                   201907L [C++2a]
     __cpp_lib_char8_t                       201811L [C++2a]
 */
 
@@ -34,6 +35,10 @@
 #   error "__cpp_lib_atomic_ref should not be defined before c++2a"
 # endif
 
+# ifdef __cpp_lib_atomic_wait
+#   error "__cpp_lib_atomic_wait should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_char8_t
 #   error "__cpp_lib_char8_t should not be defined before c++2a"
 # endif
@@ -48,6 +53,10 @@
 #   error "__cpp_lib_atomic_ref should not be defined before c++2a"
 # endif
 
+# ifdef __cpp_lib_atomic_wait
+#   error "__cpp_lib_atomic_wait should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_char8_t
 #   error "__cpp_lib_char8_t should not be defined before c++2a"
 # endif
@@ -71,6 +80,10 @@
 #   error "__cpp_lib_atomic_ref should not be defined before c++2a"
 # endif
 
+# ifdef __cpp_lib_atomic_wait
+#   error "__cpp_lib_atomic_wait should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_char8_t
 #   error "__cpp_lib_char8_t should not be defined before c++2a"
 # endif
@@ -103,6 +116,19 @@
 #   endif
 # endif
 
+# if !defined(_LIBCPP_HAS_NO_THREADS)
+#   ifndef __cpp_lib_atomic_wait
+#     error "__cpp_lib_atomic_wait should be defined in c++2a"
+#   endif
+#   if __cpp_lib_atomic_wait != 201907L
+#     error "__cpp_lib_atomic_wait should have the value 201907L in c++2a"
+#   endif
+# else
+#   ifdef __cpp_lib_atomic_wait
+#     error "__cpp_lib_atomic_wait should not be defined when !defined(_LIBCPP_HAS_NO_THREADS) is not defined!"
+#   endif
+# endif
+
 # if defined(__cpp_char8_t)
 #   ifndef __cpp_lib_char8_t
 #     error "__cpp_lib_char8_t should be defined in c++2a"
@@ -22,6 +22,8 @@
     __cpp_lib_as_const                             201510L [C++17]
     __cpp_lib_atomic_is_always_lock_free           201603L [C++17]
     __cpp_lib_atomic_ref                           201806L [C++2a]
+    __cpp_lib_atomic_wait                          201907L [C++2a]
+    __cpp_lib_barrier                              201907L [C++2a]
     __cpp_lib_bind_front                           201811L [C++2a]
     __cpp_lib_bit_cast                             201806L [C++2a]
     __cpp_lib_bool_constant                        201505L [C++17]
@@ -41,6 +43,7 @@
     __cpp_lib_exchange_function                    201304L [C++14]
     __cpp_lib_execution                            201603L [C++17]
     __cpp_lib_filesystem                           201703L [C++17]
+    __cpp_lib_format                               201907L [C++2a]
     __cpp_lib_gcd_lcm                              201606L [C++17]
     __cpp_lib_generic_associative_lookup           201304L [C++14]
     __cpp_lib_generic_unordered_lookup             201811L [C++2a]
@@ -58,6 +61,8 @@
     __cpp_lib_is_invocable                         201703L [C++17]
     __cpp_lib_is_null_pointer                      201309L [C++14]
     __cpp_lib_is_swappable                         201603L [C++17]
+    __cpp_lib_jthread                              201911L [C++2a]
+    __cpp_lib_latch                                201907L [C++2a]
     __cpp_lib_launder                              201606L [C++17]
     __cpp_lib_list_remove_return_type              201806L [C++2a]
     __cpp_lib_logical_traits                       201510L [C++17]
@@ -80,6 +85,7 @@
     __cpp_lib_robust_nonmodifying_seq_ops          201304L [C++14]
     __cpp_lib_sample                               201603L [C++17]
     __cpp_lib_scoped_lock                          201703L [C++17]
+    __cpp_lib_semaphore                            201907L [C++2a]
     __cpp_lib_shared_mutex                         201505L [C++17]
     __cpp_lib_shared_ptr_arrays                    201611L [C++17]
     __cpp_lib_shared_ptr_weak_type                 201606L [C++17]
@@ -137,6 +143,14 @@
 #   error "__cpp_lib_atomic_ref should not be defined before c++2a"
 # endif
 
+# ifdef __cpp_lib_atomic_wait
+#   error "__cpp_lib_atomic_wait should not be defined before c++2a"
+# endif
+
+# ifdef __cpp_lib_barrier
+#   error "__cpp_lib_barrier should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_bind_front
 #   error "__cpp_lib_bind_front should not be defined before c++2a"
 # endif
@@ -213,6 +227,10 @@
 #   error "__cpp_lib_filesystem should not be defined before c++17"
 # endif
 
+# ifdef __cpp_lib_format
+#   error "__cpp_lib_format should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_gcd_lcm
 #   error "__cpp_lib_gcd_lcm should not be defined before c++17"
 # endif
@@ -281,6 +299,14 @@
 #   error "__cpp_lib_is_swappable should not be defined before c++17"
 # endif
 
+# ifdef __cpp_lib_jthread
+#   error "__cpp_lib_jthread should not be defined before c++2a"
+# endif
+
+# ifdef __cpp_lib_latch
+#   error "__cpp_lib_latch should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_launder
 #   error "__cpp_lib_launder should not be defined before c++17"
 # endif
@@ -369,6 +395,10 @@
 #   error "__cpp_lib_scoped_lock should not be defined before c++17"
 # endif
 
+# ifdef __cpp_lib_semaphore
+#   error "__cpp_lib_semaphore should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_shared_mutex
 #   error "__cpp_lib_shared_mutex should not be defined before c++17"
 # endif
@@ -471,6 +501,14 @@
 #   error "__cpp_lib_atomic_ref should not be defined before c++2a"
 # endif
 
+# ifdef __cpp_lib_atomic_wait
+#   error "__cpp_lib_atomic_wait should not be defined before c++2a"
+# endif
+
+# ifdef __cpp_lib_barrier
+#   error "__cpp_lib_barrier should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_bind_front
 #   error "__cpp_lib_bind_front should not be defined before c++2a"
 # endif
@@ -556,6 +594,10 @@
 #   error "__cpp_lib_filesystem should not be defined before c++17"
 # endif
 
+# ifdef __cpp_lib_format
+#   error "__cpp_lib_format should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_gcd_lcm
 #   error "__cpp_lib_gcd_lcm should not be defined before c++17"
 # endif
@@ -639,6 +681,14 @@
 #   error "__cpp_lib_is_swappable should not be defined before c++17"
 # endif
 
+# ifdef __cpp_lib_jthread
+#   error "__cpp_lib_jthread should not be defined before c++2a"
+# endif
+
+# ifdef __cpp_lib_latch
+#   error "__cpp_lib_latch should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_launder
 #   error "__cpp_lib_launder should not be defined before c++17"
 # endif
@@ -745,6 +795,10 @@
 #   error "__cpp_lib_scoped_lock should not be defined before c++17"
 # endif
 
+# ifdef __cpp_lib_semaphore
+#   error "__cpp_lib_semaphore should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_shared_mutex
 #   error "__cpp_lib_shared_mutex should not be defined before c++17"
 # endif
@@ -904,6 +958,14 @@
 #   error "__cpp_lib_atomic_ref should not be defined before c++2a"
 # endif
 
+# ifdef __cpp_lib_atomic_wait
+#   error "__cpp_lib_atomic_wait should not be defined before c++2a"
+# endif
+
+# ifdef __cpp_lib_barrier
+#   error "__cpp_lib_barrier should not be defined before c++2a"
+# endif
+
 # ifdef __cpp_lib_bind_front
 #   error "__cpp_lib_bind_front should not be defined before c++2a"
 # endif
@@ -1025,6 +1087,10 @@
 #   error "__cpp_lib_filesystem should have the value 201703L in c++17"
 # endif
 
+# ifdef __cpp_lib_format
+#   error "__cpp_lib_format should not be defined before c++2a"
+# endif
+
 # ifndef __cpp_lib_gcd_lcm
 #   error "__cpp_lib_gcd_lcm should be defined in c++17"
 # endif
@@ -1147,6 +1213,14 @@
 #   error "__cpp_lib_is_swappable should have the value 201603L in c++17"
 # endif
 
+# ifdef __cpp_lib_jthread
+#   error "__cpp_lib_jthread should not be defined before c++2a"
+# endif
+
+# ifdef __cpp_lib_latch
+#   error "__cpp_lib_latch should not be defined before c++2a"
+# endif
+
 # ifndef __cpp_lib_launder
 #   error "__cpp_lib_launder should be defined in c++17"
 # endif
@@ -1206,17 +1280,11 @@
 #   endif
 # endif
 
-# if !defined(_LIBCPP_VERSION)
-#   ifndef __cpp_lib_memory_resource
-#     error "__cpp_lib_memory_resource should be defined in c++17"
-#   endif
-#   if __cpp_lib_memory_resource != 201603L
-#     error "__cpp_lib_memory_resource should have the value 201603L in c++17"
-#   endif
-# else // _LIBCPP_VERSION
-#   ifdef __cpp_lib_memory_resource
-#     error "__cpp_lib_memory_resource should not be defined because it is unimplemented in libc++!"
-#   endif
+# ifndef __cpp_lib_memory_resource
+#   error "__cpp_lib_memory_resource should be defined in c++17"
+# endif
+# if __cpp_lib_memory_resource != 201603L
+#   error "__cpp_lib_memory_resource should have the value 201603L in c++17"
 # endif
 
 # ifndef __cpp_lib_node_extract
@@ -1313,6 +1381,10 @@
 #   error "__cpp_lib_scoped_lock should have the value 201703L in c++17"
 # endif
 
+# ifdef __cpp_lib_semaphore
+#   error "__cpp_lib_semaphore should not be defined before c++2a"
+# endif
+
 # if !defined(_LIBCPP_HAS_NO_THREADS)
 #   ifndef __cpp_lib_shared_mutex
 #     error "__cpp_lib_shared_mutex should be defined in c++17"
@@ -1529,6 +1601,32 @@
 #   endif
 # endif
 
+# if !defined(_LIBCPP_HAS_NO_THREADS)
+#   ifndef __cpp_lib_atomic_wait
+#     error "__cpp_lib_atomic_wait should be defined in c++2a"
+#   endif
+#   if __cpp_lib_atomic_wait != 201907L
+#     error "__cpp_lib_atomic_wait should have the value 201907L in c++2a"
+#   endif
+# else
+#   ifdef __cpp_lib_atomic_wait
+#     error "__cpp_lib_atomic_wait should not be defined when !defined(_LIBCPP_HAS_NO_THREADS) is not defined!"
+#   endif
+# endif
+
+# if !defined(_LIBCPP_HAS_NO_THREADS)
+#   ifndef __cpp_lib_barrier
+#     error "__cpp_lib_barrier should be defined in c++2a"
+#   endif
+#   if __cpp_lib_barrier != 201907L
+#     error "__cpp_lib_barrier should have the value 201907L in c++2a"
+#   endif
+# else
+#   ifdef __cpp_lib_barrier
+#     error "__cpp_lib_barrier should not be defined when !defined(_LIBCPP_HAS_NO_THREADS) is not defined!"
+#   endif
+# endif
+
 # if !defined(_LIBCPP_VERSION)
 #   ifndef __cpp_lib_bind_front
 #     error "__cpp_lib_bind_front should be defined in c++2a"
@@ -1716,6 +1814,13 @@
 #   error "__cpp_lib_filesystem should have the value 201703L in c++2a"
 # endif
 
+# ifndef __cpp_lib_format
+#   error "__cpp_lib_format should be defined in c++2a"
+# endif
+# if __cpp_lib_format != 201907L
+#   error "__cpp_lib_format should have the value 201907L in c++2a"
+# endif
+
 # ifndef __cpp_lib_gcd_lcm
 #   error "__cpp_lib_gcd_lcm should be defined in c++2a"
 # endif
@@ -1859,6 +1964,32 @@
 #   error "__cpp_lib_is_swappable should have the value 201603L in c++2a"
 # endif
 
+# if !defined(_LIBCPP_HAS_NO_THREADS)
+#   ifndef __cpp_lib_jthread
+#     error "__cpp_lib_jthread should be defined in c++2a"
+#   endif
+#   if __cpp_lib_jthread != 201911L
+#     error "__cpp_lib_jthread should have the value 201911L in c++2a"
+#   endif
+# else
+#   ifdef __cpp_lib_jthread
+#     error "__cpp_lib_jthread should not be defined when !defined(_LIBCPP_HAS_NO_THREADS) is not defined!"
+#   endif
+# endif
+
+# if !defined(_LIBCPP_HAS_NO_THREADS)
+#   ifndef __cpp_lib_latch
+#     error "__cpp_lib_latch should be defined in c++2a"
+#   endif
+#   if __cpp_lib_latch != 201907L
+#     error "__cpp_lib_latch should have the value 201907L in c++2a"
+#   endif
+# else
+#   ifdef __cpp_lib_latch
+#     error "__cpp_lib_latch should not be defined when !defined(_LIBCPP_HAS_NO_THREADS) is not defined!"
+#   endif
+# endif
+
 # ifndef __cpp_lib_launder
 #   error "__cpp_lib_launder should be defined in c++2a"
 # endif
@@ -1927,17 +2058,11 @@
 #   endif
 # endif
 
-# if !defined(_LIBCPP_VERSION)
-#   ifndef __cpp_lib_memory_resource
-#     error "__cpp_lib_memory_resource should be defined in c++2a"
-#   endif
-#   if __cpp_lib_memory_resource != 201603L
-#     error "__cpp_lib_memory_resource should have the value 201603L in c++2a"
-#   endif
-# else // _LIBCPP_VERSION
-#   ifdef __cpp_lib_memory_resource
-#     error "__cpp_lib_memory_resource should not be defined because it is unimplemented in libc++!"
-#   endif
+# ifndef __cpp_lib_memory_resource
+#   error "__cpp_lib_memory_resource should be defined in c++2a"
+# endif
+# if __cpp_lib_memory_resource != 201603L
+#   error "__cpp_lib_memory_resource should have the value 201603L in c++2a"
 # endif
 
 # ifndef __cpp_lib_node_extract
@@ -2043,6 +2168,19 @@
 #   error "__cpp_lib_scoped_lock should have the value 201703L in c++2a"
 # endif
 
+# if !defined(_LIBCPP_HAS_NO_THREADS)
+#   ifndef __cpp_lib_semaphore
+#     error "__cpp_lib_semaphore should be defined in c++2a"
+#   endif
+#   if __cpp_lib_semaphore != 201907L
+#     error "__cpp_lib_semaphore should have the value 201907L in c++2a"
+#   endif
+# else
+#   ifdef __cpp_lib_semaphore
+#     error "__cpp_lib_semaphore should not be defined when !defined(_LIBCPP_HAS_NO_THREADS) is not defined!"
+#   endif
+# endif
+
 # if !defined(_LIBCPP_HAS_NO_THREADS)
 #   ifndef __cpp_lib_shared_mutex
 #     error "__cpp_lib_shared_mutex should be defined in c++2a"
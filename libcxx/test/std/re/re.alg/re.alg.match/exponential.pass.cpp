@@ -18,6 +18,8 @@
 //                  regex_constants::match_flag_type flags = regex_constants::match_default);
 
 // Throw exception after spent too many cycles with respect to the length of the input string.
+// libc++ runs ECMAScript patterns without back references in linear time, so
+// only the POSIX grammars give up.
 
 #include <regex>
 #include <cassert>
@@ -33,9 +35,10 @@ int main(int, char**) {
           std::regex(
               "a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?aaaaaaaaaaaaaaaaaaaa",
               op));
-      LIBCPP_ASSERT(false);
+      LIBCPP_ASSERT(op == std::regex::ECMAScript);
       assert(b);
     } catch (const std::regex_error &e) {
+      LIBCPP_ASSERT(op != std::regex::ECMAScript);
       assert(e.code() == std::regex_constants::error_complexity);
     }
   }
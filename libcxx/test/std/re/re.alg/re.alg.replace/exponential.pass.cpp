@@ -30,9 +30,9 @@ int main(int, char**)
         std::regex re("a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?a?aaaaaaaaaaaaaaaaaaaa");
         const char s[] = "aaaaaaaaaaaaaaaaaaaa";
         std::string r = std::regex_replace(s, re, "123-&", std::regex_constants::format_sed);
-        LIBCPP_ASSERT(false);
         assert(r == "123-aaaaaaaaaaaaaaaaaaaa");
     } catch (const std::regex_error &e) {
+      LIBCPP_ASSERT(false);
       assert(e.code() == std::regex_constants::error_complexity);
     }
     return 0;
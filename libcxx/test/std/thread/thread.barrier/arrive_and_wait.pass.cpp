@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <barrier>
+
+#include <barrier>
+#include <thread>
+#include <vector>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  const int Threads = 4;
+  std::barrier<> b(Threads);
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < Threads; ++i)
+    threads.emplace_back([&](){
+      for (int j = 0; j < 10; ++j)
+        b.arrive_and_wait();
+    });
+  for (int j = 0; j < 10; ++j)
+    b.arrive_and_wait();
+  for (auto& t : threads)
+    t.join();
+
+  return 0;
+}
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <barrier>
+
+#include <barrier>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  const int Threads = 3;
+  const int Phases = 20;
+  int completions = 0;
+  int arrivals[Threads] = {};
+  auto comp = [&]() noexcept {
+    // Every thread has arrived by the time the completion runs.
+    for (int i = 0; i < Threads; ++i)
+      assert(arrivals[i] == completions + 1);
+    ++completions;
+  };
+  std::barrier<decltype(comp)> b(Threads, comp);
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < Threads; ++i)
+    threads.emplace_back([&, i](){
+      for (int j = 0; j < Phases; ++j) {
+        ++arrivals[i];
+        b.arrive_and_wait();
+      }
+    });
+  for (int j = 0; j < Phases; ++j) {
+    ++arrivals[0];
+    b.arrive_and_wait();
+  }
+  for (auto& t : threads)
+    t.join();
+  assert(completions == Phases);
+
+  return 0;
+}
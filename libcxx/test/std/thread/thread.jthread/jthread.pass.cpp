@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <thread>
+
+// class jthread
+
+#include <thread>
+#include <atomic>
+#include <cassert>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+
+#include "test_macros.h"
+
+static_assert(std::is_nothrow_default_constructible_v<std::jthread>);
+static_assert(std::is_nothrow_move_constructible_v<std::jthread>);
+static_assert(std::is_nothrow_move_assignable_v<std::jthread>);
+static_assert(!std::is_copy_constructible_v<std::jthread>);
+
+int main(int, char**)
+{
+  {
+    std::jthread t;
+    assert(!t.joinable());
+    assert(!t.get_stop_source().stop_possible());
+    assert(!t.request_stop());
+  }
+  {
+    // The destructor requests a stop and joins.
+    std::atomic<bool> stopped(false);
+    {
+      std::jthread t([&](std::stop_token st, int step) {
+        while (!st.stop_requested())
+          std::this_thread::yield();
+        stopped = step == 3;
+      }, 3);
+      assert(t.joinable());
+      assert(t.get_stop_token().stop_possible());
+    }
+    assert(stopped);
+  }
+  {
+    // Functions that take no stop_token get none.
+    int result = 0;
+    std::jthread t([&](int x) { result = x; }, 42);
+    t.join();
+    assert(result == 42);
+    assert(!t.joinable());
+  }
+  {
+    // Move assignment stops and joins the thread it replaces.
+    std::atomic<bool> first_stopped(false);
+    std::jthread a([&](std::stop_token st) {
+      while (!st.stop_requested())
+        std::this_thread::yield();
+      first_stopped = true;
+    });
+    std::jthread b([](std::stop_token) {});
+    std::jthread::id id = b.get_id();
+    a = std::move(b);
+    assert(first_stopped);
+    assert(a.get_id() == id);
+    assert(!b.joinable());
+    swap(a, b);
+    assert(b.get_id() == id);
+  }
+  {
+    std::jthread t([](std::stop_token st) {
+      std::stop_callback cb(st, [] {});
+      while (!st.stop_requested())
+        std::this_thread::yield();
+    });
+    std::stop_source s = t.get_stop_source();
+    assert(s.request_stop());
+    assert(!t.request_stop());
+    t.join();
+  }
+
+  return 0;
+}
@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <latch>
+
+#include <latch>
+#include <thread>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  std::latch l(2);
+
+  l.count_down();
+  std::thread t([&](){
+    l.count_down();
+  });
+  l.wait();
+  assert(l.try_wait());
+  t.join();
+
+  std::latch l2(3);
+  l2.count_down(3);
+  assert(l2.try_wait());
+
+  return 0;
+}
@@ -0,0 +1,26 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <latch>
+
+#include <latch>
+#include <limits>
+#include <cstddef>
+
+#include "test_macros.h"
+
+static_assert(std::latch::max() > 0, "");
+static_assert(std::latch::max() == std::numeric_limits<std::ptrdiff_t>::max(), "");
+
+int main(int, char**)
+{
+  return 0;
+}
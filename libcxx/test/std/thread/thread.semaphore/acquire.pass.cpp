@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <semaphore>
+
+#include <semaphore>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  {
+    std::counting_semaphore<> s(2);
+    std::thread t([&](){
+      s.acquire();
+    });
+    t.join();
+    s.acquire();
+    assert(!s.try_acquire());
+  }
+  {
+    // Several consumers each block until a producer releases.
+    const int Threads = 4;
+    const int PerThread = 1000;
+    std::counting_semaphore<> s(0);
+    std::atomic<int> acquired(0);
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < Threads; ++i)
+      consumers.emplace_back([&](){
+        for (int j = 0; j < PerThread; ++j) {
+          s.acquire();
+          ++acquired;
+        }
+      });
+    for (int j = 0; j < Threads * PerThread; ++j)
+      s.release();
+    for (auto& t : consumers)
+      t.join();
+    assert(acquired == Threads * PerThread);
+    assert(!s.try_acquire());
+  }
+
+  return 0;
+}
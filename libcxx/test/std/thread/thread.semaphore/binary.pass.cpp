@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <semaphore>
+
+#include <semaphore>
+#include <chrono>
+#include <thread>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  static_assert(std::binary_semaphore::max() >= 1, "");
+
+  std::binary_semaphore s(1);
+
+  assert(s.try_acquire());
+  assert(!s.try_acquire());
+  s.release();
+  s.acquire();
+
+  std::thread t([&](){
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    s.release();
+  });
+  s.acquire();
+  t.join();
+  assert(!s.try_acquire());
+
+  return 0;
+}
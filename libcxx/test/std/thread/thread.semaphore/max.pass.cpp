@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <semaphore>
+
+#include <semaphore>
+#include <limits>
+#include <cstddef>
+
+#include "test_macros.h"
+
+static_assert(std::counting_semaphore<>::max() > 0, "");
+static_assert(std::counting_semaphore<1>::max() >= 1, "");
+static_assert(std::counting_semaphore<std::numeric_limits<int>::max()>::max() >= 1, "");
+static_assert(std::counting_semaphore<std::numeric_limits<std::ptrdiff_t>::max()>::max() >= 1, "");
+static_assert(std::counting_semaphore<1>::max() == std::binary_semaphore::max(), "");
+
+int main(int, char**)
+{
+  return 0;
+}
@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <semaphore>
+
+#include <semaphore>
+#include <thread>
+#include <cassert>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  std::counting_semaphore<> s(0);
+
+  assert(!s.try_acquire());
+  s.release();
+  assert(s.try_acquire());
+  assert(!s.try_acquire());
+  s.release(2);
+  std::thread t([&](){
+    s.acquire();
+  });
+  t.join();
+  s.acquire();
+  assert(!s.try_acquire());
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <stop_token>
+
+#include <stop_token>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  {
+    // Callbacks run once, on the requesting thread.
+    std::stop_source s;
+    int calls = 0;
+    std::stop_callback a(s.get_token(), [&] { ++calls; });
+    std::stop_callback b(s.get_token(), [&] { ++calls; });
+    {
+      std::stop_callback removed(s.get_token(), [&] { calls += 100; });
+    }
+    s.request_stop();
+    assert(calls == 2);
+    s.request_stop();
+    assert(calls == 2);
+  }
+  {
+    // Registered after the request: runs in the constructor.
+    std::stop_source s;
+    s.request_stop();
+    bool called = false;
+    std::stop_callback cb(s.get_token(), [&] { called = true; });
+    assert(called);
+  }
+  {
+    // Without a source no stop can come, and nothing runs.
+    bool called = false;
+    std::stop_token t;
+    {
+      std::stop_source s;
+      t = s.get_token();
+    }
+    std::stop_callback cb(t, [&] { called = true; });
+    std::stop_callback none(std::stop_token(), [&] { called = true; });
+    assert(!called);
+  }
+  {
+    // A callback may destroy its own stop_callback.
+    std::stop_source s;
+    std::optional<std::stop_callback<std::function<void()>>> cb;
+    bool called = false;
+    cb.emplace(s.get_token(), [&] {
+      called = true;
+      cb.reset();
+    });
+    s.request_stop();
+    assert(called);
+    assert(!cb);
+  }
+  {
+    // Callbacks registered and removed concurrently with the request.
+    for (int round = 0; round < 50; ++round) {
+      std::stop_source s;
+      std::atomic<int> calls(0);
+      std::vector<std::thread> threads;
+      for (int i = 0; i < 4; ++i)
+        threads.emplace_back([&] {
+          for (int j = 0; j < 20; ++j) {
+            std::stop_callback cb(s.get_token(), [&] { ++calls; });
+          }
+        });
+      std::stop_callback kept(s.get_token(), [&] { calls += 1000; });
+      s.request_stop();
+      for (auto& t : threads)
+        t.join();
+      assert(calls >= 1000);
+    }
+  }
+  {
+    // The destructor waits for a callback running on another thread.
+    std::stop_source s;
+    std::atomic<bool> running(false), finished(false);
+    std::optional<std::stop_callback<std::function<void()>>> cb;
+    cb.emplace(s.get_token(), [&] {
+      running = true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      finished = true;
+    });
+    std::thread t([&] { s.request_stop(); });
+    while (!running)
+      std::this_thread::yield();
+    cb.reset();
+    assert(finished);
+    t.join();
+  }
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// UNSUPPORTED: libcpp-has-no-threads
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <stop_token>
+
+#include <stop_token>
+#include <cassert>
+#include <utility>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  {
+    std::stop_token t;
+    assert(!t.stop_possible());
+    assert(!t.stop_requested());
+    std::stop_source none(std::nostopstate);
+    assert(!none.stop_possible());
+    assert(!none.request_stop());
+    assert(none.get_token() == t);
+  }
+  {
+    std::stop_source s;
+    std::stop_token t = s.get_token();
+    assert(s.stop_possible());
+    assert(t.stop_possible());
+    assert(!t.stop_requested());
+    assert(s.get_token() == t);
+    assert(s.request_stop());
+    assert(!s.request_stop());
+    assert(s.stop_requested());
+    assert(t.stop_requested());
+    assert(t.stop_possible());
+  }
+  {
+    // A token outlives its sources; it stays possible only if a stop was
+    // requested.
+    std::stop_token t;
+    {
+      std::stop_source s;
+      std::stop_source copy = s;
+      assert(copy == s);
+      t = copy.get_token();
+    }
+    assert(!t.stop_possible());
+    assert(!t.stop_requested());
+  }
+  {
+    std::stop_source a;
+    std::stop_source b;
+    assert(a != b);
+    std::stop_token ta = a.get_token();
+    std::stop_source moved = std::move(a);
+    assert(!a.stop_possible());
+    assert(moved.get_token() == ta);
+    swap(moved, b);
+    assert(b.get_token() == ta);
+    b = std::stop_source(std::nostopstate);
+    assert(!ta.stop_possible());
+  }
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// from_chars_result from_chars(const char* first, const char* last,
+//                              Floating& value,
+//                              chars_format fmt = chars_format::general)
+
+#include <charconv>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "test_macros.h"
+
+template <typename T>
+void test(const char* s, std::chars_format fmt, T expected,
+          std::size_t consumed)
+{
+    T value = 0;
+    std::from_chars_result r =
+        std::from_chars(s, s + std::strlen(s), value, fmt);
+    assert(r.ec == std::errc{});
+    assert(r.ptr == s + consumed);
+    assert(value == expected);
+    assert(std::signbit(value) == std::signbit(expected));
+}
+
+template <typename T>
+void test_error(const char* s, std::chars_format fmt, std::errc ec,
+                std::size_t consumed)
+{
+    T value = 7;
+    std::from_chars_result r =
+        std::from_chars(s, s + std::strlen(s), value, fmt);
+    assert(r.ec == ec);
+    assert(r.ptr == s + consumed);
+    // The value is left alone on errors.
+    assert(value == 7);
+}
+
+template <typename T>
+void test_all()
+{
+    const std::chars_format general = std::chars_format::general;
+    const std::chars_format fixed = std::chars_format::fixed;
+    const std::chars_format scientific = std::chars_format::scientific;
+    const std::chars_format hex = std::chars_format::hex;
+
+    test<T>("0", general, 0, 1);
+    test<T>("-0", general, -T(0), 2);
+    test<T>("1.5", general, T(1.5), 3);
+    test<T>(".5", general, T(0.5), 2);
+    test<T>("5.", general, T(5), 2);
+    test<T>("-2.25e1", general, T(-22.5), 7);
+    test<T>("1e", general, T(1), 1);
+    test<T>("1e+", general, T(1), 1);
+    test<T>("0.125xyz", general, T(0.125), 5);
+
+    // A leading plus sign and the hex prefix are not part of the pattern.
+    test_error<T>("+1", general, std::errc::invalid_argument, 0);
+    test<T>("0x10", general, T(0), 1);
+
+    test<T>("2.5e3", fixed, T(2.5), 3);
+    test<T>("2.5e3", scientific, T(2500), 5);
+    test_error<T>("2.5", scientific, std::errc::invalid_argument, 0);
+
+    test<T>("1p4", hex, T(16), 3);
+    test<T>("a.8", hex, T(10.5), 3);
+    test<T>("-1.8p-1", hex, T(-0.75), 7);
+    test<T>("fe", hex, T(254), 2);
+
+    test<T>("inf", general, std::numeric_limits<T>::infinity(), 3);
+    test<T>("-INFINITY", general, -std::numeric_limits<T>::infinity(), 9);
+    test<T>("infinit", general, std::numeric_limits<T>::infinity(), 3);
+    {
+        T value = 0;
+        const char* s = "nan(payload_1)x";
+        std::from_chars_result r =
+            std::from_chars(s, s + std::strlen(s), value);
+        assert(r.ec == std::errc{});
+        assert(r.ptr == s + 14);
+        assert(std::isnan(value));
+    }
+
+    test_error<T>("", general, std::errc::invalid_argument, 0);
+    test_error<T>("-", general, std::errc::invalid_argument, 0);
+    test_error<T>(".", general, std::errc::invalid_argument, 0);
+    test_error<T>("e5", general, std::errc::invalid_argument, 0);
+    test_error<T>("1e100000", general, std::errc::result_out_of_range, 8);
+    test_error<T>("1e-100000", general, std::errc::result_out_of_range, 9);
+}
+
+int main(int, char**)
+{
+    test_all<float>();
+    test_all<double>();
+    test_all<long double>();
+
+    // A long input does not fit the internal stack buffer.
+    char buf[512];
+    std::memset(buf, '0', sizeof(buf));
+    buf[0] = '1';
+    buf[1] = '.';
+    double value = 0;
+    std::from_chars_result r = std::from_chars(buf, buf + sizeof(buf), value);
+    assert(r.ec == std::errc{});
+    assert(r.ptr == buf + sizeof(buf));
+    assert(value == 1.0);
+
+    return 0;
+}
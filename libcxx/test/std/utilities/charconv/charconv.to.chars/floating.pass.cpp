@@ -0,0 +1,209 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03
+// UNSUPPORTED: !libc++ && c++11
+// UNSUPPORTED: !libc++ && c++14
+
+// XFAIL: with_system_cxx_lib=macosx10.14
+// XFAIL: with_system_cxx_lib=macosx10.13
+// XFAIL: with_system_cxx_lib=macosx10.12
+// XFAIL: with_system_cxx_lib=macosx10.11
+// XFAIL: with_system_cxx_lib=macosx10.10
+// XFAIL: with_system_cxx_lib=macosx10.9
+// XFAIL: with_system_cxx_lib=macosx10.8
+// XFAIL: with_system_cxx_lib=macosx10.7
+
+// <charconv>
+
+// to_chars_result to_chars(char* first, char* last, Floating value);
+// to_chars_result to_chars(char* first, char* last, Floating value,
+//                          chars_format fmt);
+// to_chars_result to_chars(char* first, char* last, Floating value,
+//                          chars_format fmt, int precision);
+
+#include <charconv>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "test_macros.h"
+
+template <typename T>
+void test(T value, const char* expected)
+{
+    char buf[128];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value);
+    assert(r.ec == std::errc{});
+    assert(std::string(buf, r.ptr) == expected);
+}
+
+template <typename T>
+void test(T value, std::chars_format fmt, const char* expected)
+{
+    char buf[512];
+    std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value, fmt);
+    assert(r.ec == std::errc{});
+    assert(std::string(buf, r.ptr) == expected);
+}
+
+template <typename T>
+void test(T value, std::chars_format fmt, int precision, const char* expected)
+{
+    char buf[512];
+    std::to_chars_result r =
+        std::to_chars(buf, buf + sizeof(buf), value, fmt, precision);
+    assert(r.ec == std::errc{});
+    assert(std::string(buf, r.ptr) == expected);
+
+    // Every shorter buffer is too small.
+    const std::size_t length = static_cast<std::size_t>(r.ptr - buf);
+    for (std::size_t n = 0; n < length; ++n)
+    {
+        r = std::to_chars(buf, buf + n, value, fmt, precision);
+        assert(r.ec == std::errc::value_too_large);
+        assert(r.ptr == buf + n);
+    }
+}
+
+void test_shortest()
+{
+    test(0.0, "0");
+    test(-0.0, "-0");
+    test(1.0, "1");
+    test(0.1, "0.1");
+    test(0.3, "0.3");
+    test(1.5, "1.5");
+    test(123456.0, "123456");
+    test(1e22, "1e+22");
+    test(1e23, "1e+23");
+    test(1e-7, "1e-07");
+    test(0.001, "0.001");
+    test(5e-324, "5e-324");
+    test(1.7976931348623157e308, "1.7976931348623157e+308");
+    test(2.2250738585072014e-308, "2.2250738585072014e-308");
+    test(0.1f, "0.1");
+    test(16777216.0f, "16777216");
+    test(3.4028235e38f, "3.4028235e+38");
+    test(1e-45f, "1e-45");
+    test(2.5L, "2.5");
+
+    test(std::numeric_limits<double>::infinity(), "inf");
+    test(-std::numeric_limits<double>::infinity(), "-inf");
+    test(std::numeric_limits<double>::quiet_NaN(), "nan");
+    test(std::numeric_limits<float>::infinity(), "inf");
+
+    test(1234.5, std::chars_format::scientific, "1.2345e+03");
+    test(1e22, std::chars_format::fixed, "10000000000000000000000");
+    test(1e-5, std::chars_format::fixed, "0.00001");
+    test(1e-5, std::chars_format::general, "1e-05");
+    test(123456.0, std::chars_format::general, "123456");
+    test(1234567.0, std::chars_format::general, "1.234567e+06");
+    test(0.0001, std::chars_format::general, "0.0001");
+
+    test(1.0, std::chars_format::hex, "1p+0");
+    test(0.5, std::chars_format::hex, "1p-1");
+    test(-3.0, std::chars_format::hex, "-1.8p+1");
+    test(0.0, std::chars_format::hex, "0p+0");
+    test(5e-324, std::chars_format::hex, "0.0000000000001p-1022");
+    test(0.1f, std::chars_format::hex, "1.99999ap-4");
+
+    test(0.1L, "0.1");
+    test(-0.0L, "-0");
+    test(3.0L, std::chars_format::hex, "1.8p+1");
+    test(std::numeric_limits<long double>::infinity(), "inf");
+#if LDBL_MAX_10_EXP > DBL_MAX_10_EXP
+    test(1e400L, "1e+400");
+    test(-1e-400L, "-1e-400");
+    test(1e400L, std::chars_format::fixed,
+         ("1" + std::string(400, '0')).c_str());
+#endif
+#if LDBL_MANT_DIG == 64
+    test(1.0L + LDBL_EPSILON, "1.0000000000000000001");
+    test(1.0L + LDBL_EPSILON, std::chars_format::hex, "1.0000000000000002p+0");
+    test(LDBL_MAX, "1.189731495357231765e+4932");
+    test(LDBL_TRUE_MIN, "4e-4951");
+#endif
+}
+
+void test_precision()
+{
+    test(1.0, std::chars_format::fixed, 0, "1");
+    test(0.5, std::chars_format::fixed, 0, "0");
+    test(1.5, std::chars_format::fixed, 0, "2");
+    test(2.5, std::chars_format::fixed, 0, "2");
+    test(0.1, std::chars_format::fixed, 20, "0.10000000000000000555");
+    test(1e20, std::chars_format::fixed, 2, "100000000000000000000.00");
+    test(-1.25, std::chars_format::fixed, 1, "-1.2");
+    test(5e-324, std::chars_format::fixed, 3, "0.000");
+
+    test(0.0, std::chars_format::scientific, 2, "0.00e+00");
+    test(1.0, std::chars_format::scientific, 0, "1e+00");
+    test(9.99, std::chars_format::scientific, 1, "1.0e+01");
+    test(123456789.0, std::chars_format::scientific, 3, "1.235e+08");
+    test(1e-300, std::chars_format::scientific, 5, "1.00000e-300");
+    test(5e-324, std::chars_format::scientific, 16, "4.9406564584124654e-324");
+
+    test(0.0001, std::chars_format::general, 6, "0.0001");
+    test(0.00001, std::chars_format::general, 6, "1e-05");
+    test(123456.0, std::chars_format::general, 6, "123456");
+    test(1234567.0, std::chars_format::general, 6, "1.23457e+06");
+    test(1.5, std::chars_format::general, 0, "2");
+    test(100.0, std::chars_format::general, 2, "1e+02");
+    test(1.0, std::chars_format::general, -1, "1");
+
+    test(1.0, std::chars_format::hex, 0, "1p+0");
+    test(1.96875, std::chars_format::hex, 0, "2p+0");
+    test(1.0, std::chars_format::hex, 3, "1.000p+0");
+    test(0.1, std::chars_format::hex, 4, "1.999ap-4");
+
+    test(0.1f, std::chars_format::fixed, 10, "0.1000000015");
+    test(3.0f, std::chars_format::scientific, 2, "3.00e+00");
+    test(0.25L, std::chars_format::fixed, 1, "0.2");
+#if LDBL_MAX_10_EXP > DBL_MAX_10_EXP
+    test(1e400L, std::chars_format::general, 6, "1e+400");
+#endif
+#if LDBL_MANT_DIG == 64
+    test(0.1L, std::chars_format::fixed, 25, "0.1000000000000000000013553");
+    test(1e400L, std::chars_format::scientific, 20,
+         "1.00000000000000000003e+400");
+    test(1.0L + LDBL_EPSILON, std::chars_format::hex, 3, "1.000p+0");
+#endif
+}
+
+// The shortest representation reads back as the same value.
+template <typename T>
+void test_round_trip(T factor)
+{
+    T value = std::numeric_limits<T>::denorm_min();
+    for (int i = 0; i < 2000 && value < std::numeric_limits<T>::infinity();
+         ++i, value *= factor)
+    {
+        char buf[64];
+        std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), value);
+        assert(r.ec == std::errc{});
+        T back = 0;
+        std::from_chars_result fr = std::from_chars(buf, r.ptr, back);
+        assert(fr.ec == std::errc{} && fr.ptr == r.ptr);
+        assert(back == value);
+    }
+}
+
+int main(int, char**)
+{
+    test_shortest();
+    test_precision();
+    test_round_trip<float>(1.7f);
+    test_round_trip<double>(1.7);
+    // Covers the whole range, including the values above DBL_MAX.
+    test_round_trip<long double>(1.7e7L);
+
+    return 0;
+}
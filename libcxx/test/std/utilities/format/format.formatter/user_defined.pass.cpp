@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <format>
+
+// A formatter specialization for a user type is found by format, parses its
+// own part of the replacement field, and is passed through basic_format_arg
+// as a handle.
+
+#include <format>
+#include <cassert>
+#include <string>
+
+#include "test_macros.h"
+
+struct point { int x, y; };
+
+template <>
+struct std::formatter<point>
+{
+    bool brackets = false;
+
+    constexpr auto parse(std::format_parse_context& pc)
+    {
+        auto it = pc.begin();
+        if (it != pc.end() && *it == 'b') {
+            brackets = true;
+            ++it;
+        }
+        if (it != pc.end() && *it != '}')
+            throw std::format_error("bad point spec");
+        return it;
+    }
+
+    auto format(const point& p, std::format_context& ctx) const
+    {
+        if (brackets)
+            return std::format_to(ctx.out(), "[{}, {}]", p.x, p.y);
+        return std::format_to(ctx.out(), "({}, {})", p.x, p.y);
+    }
+};
+
+// Reuses the standard integer formatter, specs and all.
+struct meters { int value; };
+
+template <>
+struct std::formatter<meters> : std::formatter<int>
+{
+    auto format(meters m, std::format_context& ctx) const
+    {
+        auto out = std::formatter<int>::format(m.value, ctx);
+        *out++ = 'm';
+        return out;
+    }
+};
+
+struct visitor
+{
+    bool* is_handle;
+    template <class T>
+    void operator()(T) const { *is_handle = false; }
+    void operator()(std::basic_format_arg<std::format_context>::handle) const { *is_handle = true; }
+};
+
+int main(int, char**)
+{
+    point p{1, -2};
+    assert(std::format("{}", p) == "(1, -2)");
+    assert(std::format("{:b}", p) == "[1, -2]");
+    assert(std::format("{0} {0:b} {1}", p, 3) == "(1, -2) [1, -2] 3");
+
+    assert(std::format("{}", meters{5}) == "5m");
+    assert(std::format("{:>4}", meters{5}) == "   5m");
+    assert(std::format("{:#x}", meters{255}) == "0xffm");
+    assert(std::format("{:{}}", meters{5}, 3) == "  5m");
+
+    // The runtime path parses the handle's spec as well.
+    assert(std::vformat("{:b}", std::make_format_args(p)) == "[1, -2]");
+#ifndef TEST_HAS_NO_EXCEPTIONS
+    try {
+        (void)std::vformat("{:q}", std::make_format_args(p));
+        assert(false);
+    } catch (const std::format_error&) {
+    }
+#endif
+
+    bool is_handle = false;
+    auto args = std::make_format_args(p);
+    std::visit_format_arg(visitor{&is_handle}, std::format_args(args).get(0));
+    assert(is_handle);
+    int i = 1;
+    auto iargs = std::make_format_args(i);
+    std::visit_format_arg(visitor{&is_handle}, std::format_args(iargs).get(0));
+    assert(!is_handle);
+
+    return 0;
+}
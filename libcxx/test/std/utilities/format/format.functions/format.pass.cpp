@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <format>
+
+// template<class... Args>
+//   string format(format_string<Args...> fmt, const Args&... args);
+// template<class... Args>
+//   wstring format(wformat_string<Args...> fmt, const Args&... args);
+// string vformat(string_view fmt, format_args args);
+
+#include <format>
+#include <cassert>
+#include <climits>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "test_macros.h"
+
+static void test_text()
+{
+    assert(std::format("") == "");
+    assert(std::format("hello") == "hello");
+    assert(std::format("{{}}") == "{}");
+    assert(std::format("a{{b}}c{}", 1) == "a{b}c1");
+    assert(std::format("{} {} {}", 1, 2, 3) == "1 2 3");
+    assert(std::format("{2} {0} {1} {0}", 'a', 'b', 'c') == "c a b a");
+}
+
+static void test_integer()
+{
+    assert(std::format("{}", 0) == "0");
+    assert(std::format("{}", -42) == "-42");
+    assert(std::format("{}", INT_MIN) == "-2147483648");
+    assert(std::format("{}", ULLONG_MAX) == "18446744073709551615");
+    assert(std::format("{}", LLONG_MIN) == "-9223372036854775808");
+    assert(std::format("{}", static_cast<signed char>(-5)) == "-5");
+    assert(std::format("{}", static_cast<unsigned short>(65535)) == "65535");
+
+    assert(std::format("{:b}", 5) == "101");
+    assert(std::format("{:#b}", 5) == "0b101");
+    assert(std::format("{:#B}", 5) == "0B101");
+    assert(std::format("{:o}", 8) == "10");
+    assert(std::format("{:#o}", 8) == "010");
+    assert(std::format("{:#o}", 0) == "0");
+    assert(std::format("{:x}", 255) == "ff");
+    assert(std::format("{:#X}", 255) == "0XFF");
+    assert(std::format("{:#x}", -255) == "-0xff");
+    assert(std::format("{:c}", 65) == "A");
+
+    assert(std::format("{:+}", 1) == "+1");
+    assert(std::format("{: }", 1) == " 1");
+    assert(std::format("{:-}", 1) == "1");
+    assert(std::format("{:+}", -1) == "-1");
+
+    assert(std::format("{:6}", 42) == "    42");
+    assert(std::format("{:<6}", 42) == "42    ");
+    assert(std::format("{:^6}", 42) == "  42  ");
+    assert(std::format("{:*^7}", 42) == "**42***");
+    assert(std::format("{:06}", -42) == "-00042");
+    assert(std::format("{:#010x}", 255) == "0x000000ff");
+    // An explicit alignment turns zero padding off.
+    assert(std::format("{:<06}", 42) == "42    ");
+}
+
+static void test_floating()
+{
+    assert(std::format("{}", 0.0) == "0");
+    assert(std::format("{}", 1.5) == "1.5");
+    assert(std::format("{}", -0.25f) == "-0.25");
+    assert(std::format("{}", 1e100) == "1e+100");
+    assert(std::format("{}", 0.1) == "0.1");
+    assert(std::format("{:.3}", 3.14159) == "3.14");
+    assert(std::format("{:.3f}", 3.14159) == "3.142");
+    assert(std::format("{:.2e}", 12345.0) == "1.23e+04");
+    assert(std::format("{:.2E}", 12345.0) == "1.23E+04");
+    assert(std::format("{:g}", 0.0001) == "0.0001");
+    assert(std::format("{:G}", 1e-10) == "1E-10");
+    assert(std::format("{:a}", 1.0) == "1p+0");
+    assert(std::format("{:#}", 1.0) == "1.");
+    assert(std::format("{:#.3g}", 1.0) == "1.00");
+    assert(std::format("{:#.0f}", 2.0) == "2.");
+    assert(std::format("{:+.1f}", 2.25) == "+2.2");
+    assert(std::format("{:010.3f}", -3.14159) == "-00003.142");
+    assert(std::format("{:>8}", 1.5) == "     1.5");
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    assert(std::format("{}", inf) == "inf");
+    assert(std::format("{}", -inf) == "-inf");
+    assert(std::format("{:F}", inf) == "INF");
+    assert(std::format("{}", nan) == "nan");
+    // Zero padding does not apply to infinity and NaN.
+    assert(std::format("{:06}", inf) == "   inf");
+}
+
+static void test_text_types()
+{
+    assert(std::format("{}", true) == "true");
+    assert(std::format("{:>6}", false) == " false");
+    assert(std::format("{:d}", true) == "1");
+    assert(std::format("{:#x}", true) == "0x1");
+
+    assert(std::format("{}", 'x') == "x");
+    assert(std::format("{:3}", 'x') == "x  ");
+    assert(std::format("{:d}", 'A') == "65");
+    assert(std::format("{:>3c}", 'x') == "  x");
+
+    const char* cs = "abc";
+    char buf[] = "def";
+    assert(std::format("{}", cs) == "abc");
+    assert(std::format("{}", buf) == "def");
+    assert(std::format("{}", std::string("str")) == "str");
+    assert(std::format("{}", std::string_view("view")) == "view");
+    assert(std::format("{:.2}", "abcdef") == "ab");
+    assert(std::format("{:>5.2s}", "abcdef") == "   ab");
+    assert(std::format("{:-^9}", "mid") == "---mid---");
+    // Width counts code points, not bytes.
+    assert(std::format("{:4}", "\xc3\xa9t") == "\xc3\xa9t  ");
+}
+
+static void test_pointer()
+{
+    assert(std::format("{}", nullptr) == "0x0");
+    int i = 0;
+    std::string s = std::format("{}", static_cast<void*>(&i));
+    assert(s.size() > 2 && s[0] == '0' && s[1] == 'x');
+    assert(std::format("{:>20}", static_cast<const void*>(&i)) == std::string(20 - s.size(), ' ') + s);
+}
+
+static void test_dynamic()
+{
+    assert(std::format("{:{}}", 7, 4) == "   7");
+    assert(std::format("{:.{}f}", 3.14159, 2) == "3.14");
+    assert(std::format("{0:{1}.{2}f}", 3.14159, 8, 3) == "   3.142");
+    assert(std::format("{:{}.{}}", "abcdef", 5, 3) == "abc  ");
+}
+
+static void test_long_output()
+{
+    // More than the internal staging buffer, and more fields than the
+    // compiled field table holds.
+    std::string big(1000, 'x');
+    assert(std::format("<{}>", big) == "<" + big + ">");
+    assert(std::format("{:>1000}", 1) == std::string(999, ' ') + "1");
+    assert(std::format("{}{}{}{}{}{}{}{}{}{}", 0, 1, 2, 3, 4, 5, 6, 7, 8, 9) == "0123456789");
+}
+
+static void test_vformat()
+{
+    int i = 42;
+    std::string_view name = "x";
+    assert(std::vformat("{} = {:>4}", std::make_format_args(name, i)) == "x =   42");
+    assert(std::vformat(std::string_view("{1}{0}"), std::make_format_args(1, 2)) == "21");
+}
+
+static void test_errors()
+{
+#ifndef TEST_HAS_NO_EXCEPTIONS
+    auto fails = [](std::string_view fmt, auto... args) {
+        try {
+            (void)std::vformat(fmt, std::make_format_args(args...));
+        } catch (const std::format_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(fails("{", 1));
+    assert(fails("}", 1));
+    assert(fails("{} {}", 1));
+    assert(fails("{0} {}", 1));
+    assert(fails("{:d}", "abc"));
+    assert(fails("{:.3}", 1));
+    assert(fails("{:{}}", 1, "w"));
+    assert(fails("{:{}}", 1, -1));
+    assert(fails("{:s}", 1.0));
+    assert(!fails("{:{}}", 1, 3));
+
+    std::format_error e("message");
+    assert(std::string(e.what()) == "message");
+    const std::runtime_error& base = e;
+    (void)base;
+#endif
+}
+
+static void test_wide()
+{
+    assert(std::format(L"{}", 42) == L"42");
+    assert(std::format(L"{:>5}", L"ab") == L"   ab");
+    assert(std::format(L"{}{}", L'x', 'y') == L"xy");
+    assert(std::format(L"{:#x}", 255) == L"0xff");
+    assert(std::format(L"{}", 2.5) == L"2.5");
+    assert(std::format(L"{}", std::wstring(300, L'w')) == std::wstring(300, L'w'));
+    int i = 1;
+    assert(std::vformat(L"{}", std::make_wformat_args(i)) == L"1");
+}
+
+int main(int, char**)
+{
+    test_text();
+    test_integer();
+    test_floating();
+    test_text_types();
+    test_pointer();
+    test_dynamic();
+    test_long_output();
+    test_vformat();
+    test_errors();
+    test_wide();
+
+    return 0;
+}
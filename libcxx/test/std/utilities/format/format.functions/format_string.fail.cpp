@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+// UNSUPPORTED: clang-8, clang-9, clang-10, apple-clang-11, apple-clang-12
+// REQUIRES: verify-support
+
+// <format>
+
+// A format string that does not match its arguments is rejected when the
+// program is compiled.
+
+#include <format>
+
+#include "test_macros.h"
+
+struct point { int x, y; };
+
+template <>
+struct std::formatter<point>
+{
+    constexpr auto parse(std::format_parse_context& pc)
+    {
+        if (pc.begin() != pc.end() && *pc.begin() != '}')
+            throw std::format_error("bad point spec");
+        return pc.begin();
+    }
+    auto format(const point&, std::format_context& ctx) const { return ctx.out(); }
+};
+
+int main(int, char**)
+{
+    (void)std::format("{", 1);          // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format("}", 1);          // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format("{} {}", 1);      // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format("{0} {}", 1, 2);  // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format("{:d}", "text");  // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format("{:.2}", 1);      // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format("{:{}}", 1, 2.0); // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format("{:L}", "text");  // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format("{:x}", point{}); // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+    (void)std::format(L"{:s}", 1);      // expected-error-re {{call to consteval function {{.*}} is not a constant expression}}
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <format>
+
+// template<class Out, class... Args>
+//   Out format_to(Out out, format_string<Args...> fmt, const Args&... args);
+// template<class Out, class... Args>
+//   format_to_n_result<Out> format_to_n(Out out, iter_difference_t<Out> n,
+//                                       format_string<Args...> fmt, const Args&... args);
+// template<class... Args>
+//   size_t formatted_size(format_string<Args...> fmt, const Args&... args);
+// template<class Out>
+//   Out vformat_to(Out out, string_view fmt, format_args args);
+
+#include <format>
+#include <cassert>
+#include <iterator>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class Out>
+static void test_format_to(Out out, const char* expected)
+{
+    Out end = std::format_to(out, "{}-{:>3}-{:.1f}", "a", 7, 2.25);
+    assert(std::string(out, end) == expected);
+}
+
+static void test_iterators()
+{
+    char buf[32] = {};
+    char* end = std::format_to(buf, "{} {}", 12, "ab");
+    assert(end == buf + 5);
+    assert(std::string(buf) == "12 ab");
+
+    test_format_to<char*>(buf, "a-  7-2.2");
+
+    std::string s = "x";
+    std::format_to(std::back_inserter(s), "{}{}", 1, 2);
+    assert(s == "x12");
+
+    std::vector<char> v;
+    std::format_to(std::back_inserter(v), "{:*>4}", 5);
+    assert(std::string(v.begin(), v.end()) == "***5");
+
+    std::list<char> l;
+    std::format_to(std::back_inserter(l), "{}", "list");
+    assert(std::string(l.begin(), l.end()) == "list");
+
+    std::string big;
+    std::format_to(std::back_inserter(big), "{}{:>600}", std::string(600, 'a'), 'b');
+    assert(big == std::string(600, 'a') + std::string(599, ' ') + "b");
+
+    std::wstring w;
+    std::format_to(std::back_inserter(w), L"{}:{}", L"k", 3);
+    assert(w == L"k:3");
+}
+
+static void test_format_to_n()
+{
+    char buf[8] = {};
+    std::format_to_n_result<char*> r = std::format_to_n(buf, 4, "{}", 123456);
+    assert(r.out == buf + 4);
+    assert(r.size == 6);
+    assert(std::string(buf, r.out) == "1234");
+
+    r = std::format_to_n(buf, 8, "{}", 12);
+    assert(r.out == buf + 2 && r.size == 2);
+
+    r = std::format_to_n(buf, 0, "{}", 12);
+    assert(r.out == buf && r.size == 2);
+    r = std::format_to_n(buf, -1, "{}", 12);
+    assert(r.out == buf && r.size == 2);
+
+    std::string s;
+    auto rs = std::format_to_n(std::back_inserter(s), 300, "{:>1000}", 'x');
+    assert(rs.size == 1000);
+    assert(s == std::string(300, ' '));
+
+    wchar_t wbuf[4];
+    auto rw = std::format_to_n(wbuf, 2, L"{}", L"abc");
+    assert(rw.out == wbuf + 2 && rw.size == 3);
+    assert(wbuf[0] == L'a' && wbuf[1] == L'b');
+}
+
+static void test_formatted_size()
+{
+    assert(std::formatted_size("") == 0);
+    assert(std::formatted_size("{}", 123) == 3);
+    assert(std::formatted_size("{:>1000}", 1) == 1000);
+    assert(std::formatted_size("{:.2f}", 3.14159) == 4);
+    assert(std::formatted_size(L"{}", L"abc") == 3);
+}
+
+static void test_vformat_to()
+{
+    std::string s;
+    int i = 7;
+    std::vformat_to(std::back_inserter(s), "[{:03}]", std::make_format_args(i));
+    assert(s == "[007]");
+
+    std::wstring w;
+    std::vformat_to(std::back_inserter(w), L"[{}]", std::make_wformat_args(i));
+    assert(w == L"[7]");
+}
+
+int main(int, char**)
+{
+    test_iterators();
+    test_format_to_n();
+    test_formatted_size();
+    test_vformat_to();
+
+    return 0;
+}
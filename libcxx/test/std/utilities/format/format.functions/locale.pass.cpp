@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14, c++17
+
+// <format>
+
+// template<class... Args>
+//   string format(const locale& loc, format_string<Args...> fmt, const Args&... args);
+
+// The L option takes the digit grouping and the decimal point from the
+// locale's numpunct facet; without it the locale is not consulted.
+
+#include <format>
+#include <cassert>
+#include <locale>
+#include <string>
+
+#include "test_macros.h"
+
+struct punct : std::numpunct<char>
+{
+    char do_decimal_point() const { return ','; }
+    char do_thousands_sep() const { return '.'; }
+    std::string do_grouping() const { return "\3"; }
+    std::string do_truename() const { return "yes"; }
+    std::string do_falsename() const { return "no"; }
+};
+
+int main(int, char**)
+{
+    std::locale loc(std::locale::classic(), new punct);
+
+    assert(std::format(loc, "{}", 1234567) == "1234567");
+    assert(std::format(loc, "{:L}", 1234567) == "1.234.567");
+    assert(std::format(loc, "{:L}", -1234) == "-1.234");
+    assert(std::format(loc, "{:L}", 123) == "123");
+    assert(std::format(loc, "{:>10L}", 1234567) == " 1.234.567");
+    assert(std::format(loc, "{:010L}", 1234567) == "01.234.567");
+    assert(std::format(loc, "{:Lx}", 0x123456) == "123.456");
+    assert(std::format(loc, "{:L}", 1234.5) == "1.234,5");
+    assert(std::format(loc, "{:.2Lf}", 1234567.125) == "1.234.567,12");
+    assert(std::format(loc, "{:L}", true) == "yes");
+    assert(std::format(loc, "{:>4L}", false) == "  no");
+    assert(std::format(loc, "{}", true) == "true");
+
+    std::string s;
+    std::format_to(std::back_inserter(s), loc, "{:L}", 1000);
+    assert(s == "1.000");
+    assert(std::formatted_size(loc, "{:L}", 1000) == 5);
+    int i = 10000;
+    assert(std::vformat(loc, "{:L}", std::make_format_args(i)) == "10.000");
+
+    // The global locale is used when none is given.
+    std::locale old = std::locale::global(loc);
+    assert(std::format("{:L}", 1234) == "1.234");
+    assert(std::format("{}", 1234) == "1234");
+    std::locale::global(old);
+
+    return 0;
+}
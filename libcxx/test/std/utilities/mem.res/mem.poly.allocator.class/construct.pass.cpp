@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// template <class T> class polymorphic_allocator
+
+// template <class U, class... Args>
+//   void construct(U* p, Args&&... args);
+// template <class T1, class T2, class... Args1, class... Args2>
+//   void construct(pair<T1, T2>* p, piecewise_construct_t,
+//                  tuple<Args1...> x, tuple<Args2...> y);
+
+#include <memory_resource>
+#include <cassert>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "test_macros.h"
+
+using Alloc = std::pmr::polymorphic_allocator<char>;
+
+// Takes the allocator as a leading allocator_arg_t pair.
+struct Leading {
+  using allocator_type = Alloc;
+  std::pmr::memory_resource* res;
+  int value;
+  Leading(std::allocator_arg_t, const Alloc& a, int v) : res(a.resource()), value(v) {}
+};
+
+// Takes the allocator as a trailing argument.
+struct Trailing {
+  using allocator_type = Alloc;
+  std::pmr::memory_resource* res;
+  int value;
+  Trailing(int v, const Alloc& a) : res(a.resource()), value(v) {}
+};
+
+struct NoAlloc {
+  int value;
+  NoAlloc(int v) : value(v) {}
+};
+
+int main(int, char**)
+{
+  std::pmr::monotonic_buffer_resource mono;
+  std::pmr::polymorphic_allocator<int> a(&mono);
+
+  {
+    std::pmr::polymorphic_allocator<Leading> la(a);
+    Leading* p = la.allocate(1);
+    la.construct(p, 1);
+    assert(p->res == &mono && p->value == 1);
+    la.destroy(p);
+    la.deallocate(p, 1);
+  }
+  {
+    std::pmr::polymorphic_allocator<Trailing> ta(a);
+    Trailing* p = ta.allocate(1);
+    ta.construct(p, 2);
+    assert(p->res == &mono && p->value == 2);
+    ta.destroy(p);
+    ta.deallocate(p, 1);
+  }
+  {
+    using P = std::pair<Leading, Trailing>;
+    std::pmr::polymorphic_allocator<P> pa(a);
+    P* p = pa.allocate(1);
+    pa.construct(p, std::piecewise_construct, std::make_tuple(3), std::make_tuple(4));
+    assert(p->first.res == &mono && p->first.value == 3);
+    assert(p->second.res == &mono && p->second.value == 4);
+    pa.destroy(p);
+    pa.construct(p, 5, 6);
+    assert(p->first.res == &mono && p->first.value == 5);
+    assert(p->second.res == &mono && p->second.value == 6);
+    pa.destroy(p);
+    pa.deallocate(p, 1);
+  }
+  {
+    using P = std::pair<NoAlloc, std::pmr::string>;
+    std::pmr::polymorphic_allocator<P> pa(a);
+    P* p = pa.allocate(1);
+    const std::pair<int, const char*> src(7, "a string long enough to need the heap");
+    pa.construct(p, src);
+    assert(p->first.value == 7);
+    assert(p->second == src.second);
+    assert(p->second.get_allocator().resource() == &mono);
+    pa.destroy(p);
+    pa.deallocate(p, 1);
+  }
+
+  assert(a.select_on_container_copy_construction().resource() ==
+         std::pmr::get_default_resource());
+  assert(a == std::pmr::polymorphic_allocator<char>(&mono));
+  assert(a != std::pmr::polymorphic_allocator<char>());
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// memory_resource* new_delete_resource() noexcept;
+// memory_resource* null_memory_resource() noexcept;
+// memory_resource* get_default_resource() noexcept;
+// memory_resource* set_default_resource(memory_resource* r) noexcept;
+
+#include <memory_resource>
+#include <cassert>
+#include <new>
+
+#include "test_macros.h"
+
+int main(int, char**)
+{
+  using std::pmr::memory_resource;
+
+  ASSERT_NOEXCEPT(std::pmr::new_delete_resource());
+  ASSERT_NOEXCEPT(std::pmr::null_memory_resource());
+  ASSERT_NOEXCEPT(std::pmr::get_default_resource());
+  ASSERT_NOEXCEPT(std::pmr::set_default_resource(nullptr));
+
+  memory_resource* nd = std::pmr::new_delete_resource();
+  memory_resource* null = std::pmr::null_memory_resource();
+  assert(nd == std::pmr::new_delete_resource());
+  assert(null == std::pmr::null_memory_resource());
+  assert(*nd == *nd);
+  assert(*nd != *null);
+
+  // new_delete_resource() honours the requested alignment.
+  {
+    void* p = nd->allocate(100, 64);
+    assert(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+    nd->deallocate(p, 100, 64);
+  }
+
+#ifndef TEST_HAS_NO_EXCEPTIONS
+  try {
+    (void)null->allocate(1);
+    assert(false);
+  } catch (const std::bad_alloc&) {
+  }
+#endif
+
+  // The default resource starts out as new_delete_resource(), and setting it
+  // to null puts that back.
+  assert(std::pmr::get_default_resource() == nd);
+  assert(std::pmr::set_default_resource(null) == nd);
+  assert(std::pmr::get_default_resource() == null);
+  assert(std::pmr::set_default_resource(nullptr) == null);
+  assert(std::pmr::get_default_resource() == nd);
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// class monotonic_buffer_resource
+
+#include <memory_resource>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "test_macros.h"
+
+struct counting_resource : std::pmr::memory_resource {
+  int outstanding = 0;
+  int allocations = 0;
+
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    ++outstanding;
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    --outstanding;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return &other == this;
+  }
+};
+
+bool is_aligned(void* p, std::size_t align) {
+  return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+int main(int, char**)
+{
+  counting_resource upstream;
+
+  // Allocations are bumped out of a few geometrically growing chunks, and
+  // only go back upstream on release().
+  {
+    std::pmr::monotonic_buffer_resource mono(&upstream);
+    assert(mono.upstream_resource() == &upstream);
+    for (int i = 0; i < 1000; ++i) {
+      std::size_t bytes = i % 100 + 1;
+      std::size_t align = std::size_t(1) << (i % 7);
+      void* p = mono.allocate(bytes, align);
+      assert(is_aligned(p, align));
+      std::memset(p, 0xcd, bytes);
+      mono.deallocate(p, bytes, align);
+    }
+    assert(upstream.outstanding > 0 && upstream.outstanding < 16);
+    mono.release();
+    assert(upstream.outstanding == 0);
+
+    void* p = mono.allocate(1 << 16, 4096);
+    assert(is_aligned(p, 4096));
+    std::memset(p, 0, 1 << 16);
+  }
+  assert(upstream.outstanding == 0);
+
+  // The initial buffer is used first, and again after release().
+  {
+    counting_resource buffer_upstream;
+    alignas(16) char buffer[256];
+    std::pmr::monotonic_buffer_resource mono(buffer, sizeof(buffer), &buffer_upstream);
+    void* p = mono.allocate(100);
+    assert(p == buffer);
+    (void)mono.allocate(100);
+    assert(buffer_upstream.allocations == 0);
+    (void)mono.allocate(100);
+    assert(buffer_upstream.allocations == 1);
+    assert(buffer_upstream.outstanding == 1);
+    mono.release();
+    assert(buffer_upstream.outstanding == 0);
+    assert(mono.allocate(8) == buffer);
+  }
+
+  assert(!(std::pmr::monotonic_buffer_resource(&upstream) ==
+           std::pmr::monotonic_buffer_resource(&upstream)));
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// <memory_resource>
+
+// class synchronized_pool_resource
+// class unsynchronized_pool_resource
+
+#include <memory_resource>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "test_macros.h"
+
+struct counting_resource : std::pmr::memory_resource {
+  int outstanding = 0;
+
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    ++outstanding;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+    --outstanding;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return &other == this;
+  }
+};
+
+struct block {
+  void* p;
+  std::size_t bytes;
+  std::size_t align;
+};
+
+template <class Pool>
+void test_pool(counting_resource& upstream) {
+  Pool pool(std::pmr::pool_options{0, 512}, &upstream);
+  assert(pool.upstream_resource() == &upstream);
+  assert(pool.options().largest_required_pool_block >= 512);
+  assert(pool.options().max_blocks_per_chunk > 0);
+
+  // Mix pooled and oversized requests, freeing some along the way so that
+  // freed blocks get reused.
+  std::vector<block> live;
+  unsigned state = 1;
+  for (int i = 0; i < 20000; ++i) {
+    state = state * 1103515245u + 12345u;
+    if (live.empty() || state % 3 != 0) {
+      std::size_t bytes = (state >> 8) % 2000;
+      std::size_t align = std::size_t(1) << ((state >> 4) % 8);
+      void* p = pool.allocate(bytes, align);
+      assert(reinterpret_cast<std::uintptr_t>(p) % align == 0);
+      std::memset(p, i & 0xff, bytes);
+      live.push_back(block{p, bytes, align});
+    } else {
+      std::size_t k = (state >> 8) % live.size();
+      pool.deallocate(live[k].p, live[k].bytes, live[k].align);
+      live[k] = live.back();
+      live.pop_back();
+    }
+  }
+  for (const block& b : live)
+    pool.deallocate(b.p, b.bytes, b.align);
+
+  // The pools keep their chunks until release().
+  assert(upstream.outstanding > 0);
+  pool.release();
+  assert(upstream.outstanding == 0);
+
+  void* p = pool.allocate(16);
+  pool.deallocate(p, 16);
+}
+
+int main(int, char**)
+{
+  counting_resource upstream;
+  test_pool<std::pmr::unsynchronized_pool_resource>(upstream);
+  assert(upstream.outstanding == 0);
+  test_pool<std::pmr::synchronized_pool_resource>(upstream);
+  assert(upstream.outstanding == 0);
+
+  // Destroying the pool gives everything back.
+  {
+    std::pmr::unsynchronized_pool_resource pool(&upstream);
+    (void)pool.allocate(24);
+    (void)pool.allocate(1 << 24);
+    assert(upstream.outstanding > 0);
+  }
+  assert(upstream.outstanding == 0);
+
+  {
+    std::pmr::synchronized_pool_resource pool;
+    assert(pool.upstream_resource() == std::pmr::get_default_resource());
+    assert(pool == pool);
+    std::pmr::synchronized_pool_resource other;
+    assert(pool != other);
+  }
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+// The std::pmr container aliases.
+
+#include <memory_resource>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <map>
+#include <regex>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cassert>
+
+#include "test_macros.h"
+
+template <class T>
+using PA = std::pmr::polymorphic_allocator<T>;
+
+static_assert(std::is_same<std::pmr::vector<int>, std::vector<int, PA<int>>>::value, "");
+static_assert(std::is_same<std::pmr::deque<int>, std::deque<int, PA<int>>>::value, "");
+static_assert(std::is_same<std::pmr::list<int>, std::list<int, PA<int>>>::value, "");
+static_assert(std::is_same<std::pmr::forward_list<int>, std::forward_list<int, PA<int>>>::value, "");
+static_assert(std::is_same<std::pmr::map<int, long>,
+                           std::map<int, long, std::less<int>, PA<std::pair<const int, long>>>>::value, "");
+static_assert(std::is_same<std::pmr::multimap<int, long>,
+                           std::multimap<int, long, std::less<int>, PA<std::pair<const int, long>>>>::value, "");
+static_assert(std::is_same<std::pmr::set<int>, std::set<int, std::less<int>, PA<int>>>::value, "");
+static_assert(std::is_same<std::pmr::multiset<int>, std::multiset<int, std::less<int>, PA<int>>>::value, "");
+static_assert(std::is_same<std::pmr::unordered_map<int, long>,
+                           std::unordered_map<int, long, std::hash<int>, std::equal_to<int>,
+                                              PA<std::pair<const int, long>>>>::value, "");
+static_assert(std::is_same<std::pmr::unordered_multimap<int, long>,
+                           std::unordered_multimap<int, long, std::hash<int>, std::equal_to<int>,
+                                                   PA<std::pair<const int, long>>>>::value, "");
+static_assert(std::is_same<std::pmr::unordered_set<int>,
+                           std::unordered_set<int, std::hash<int>, std::equal_to<int>, PA<int>>>::value, "");
+static_assert(std::is_same<std::pmr::unordered_multiset<int>,
+                           std::unordered_multiset<int, std::hash<int>, std::equal_to<int>, PA<int>>>::value, "");
+static_assert(std::is_same<std::pmr::string, std::basic_string<char, std::char_traits<char>, PA<char>>>::value, "");
+static_assert(std::is_same<std::pmr::wstring,
+                           std::basic_string<wchar_t, std::char_traits<wchar_t>, PA<wchar_t>>>::value, "");
+static_assert(std::is_same<std::pmr::u16string,
+                           std::basic_string<char16_t, std::char_traits<char16_t>, PA<char16_t>>>::value, "");
+static_assert(std::is_same<std::pmr::u32string,
+                           std::basic_string<char32_t, std::char_traits<char32_t>, PA<char32_t>>>::value, "");
+static_assert(std::is_same<std::pmr::cmatch,
+                           std::match_results<const char*, PA<std::csub_match>>>::value, "");
+static_assert(std::is_same<std::pmr::smatch,
+                           std::match_results<std::pmr::string::const_iterator,
+                                             PA<std::sub_match<std::pmr::string::const_iterator>>>>::value, "");
+
+int main(int, char**)
+{
+  // The elements of nested pmr containers share the outer container's resource.
+  std::pmr::vector<std::pmr::string> v;
+  v.emplace_back("a string long enough to need the heap");
+  assert(v.get_allocator().resource() == std::pmr::get_default_resource());
+  assert(v[0].get_allocator() == v.get_allocator());
+
+  std::pmr::map<int, std::pmr::vector<int>> m;
+  m[1].push_back(1);
+  assert(m[1].get_allocator().resource() == std::pmr::get_default_resource());
+
+  return 0;
+}
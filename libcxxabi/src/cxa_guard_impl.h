@@ -369,16 +369,18 @@ private:
 //                         Futex Implementation
 //===----------------------------------------------------------------------===//
 
-#if defined(SYS_futex)
+#if defined(SYS_futex) && defined(__linux__)
+// Guard variables are never shared between processes, so the private futex
+// operations apply; they skip the lookup of the backing shared mapping.
 void PlatformFutexWait(int* addr, int expect) {
-  constexpr int WAIT = 0;
-  syscall(SYS_futex, addr, WAIT, expect, 0);
+  constexpr int WAIT_PRIVATE = 0 | 128;
+  syscall(SYS_futex, addr, WAIT_PRIVATE, expect, 0);
   __tsan_acquire(addr);
 }
 void PlatformFutexWake(int* addr) {
-  constexpr int WAKE = 1;
+  constexpr int WAKE_PRIVATE = 1 | 128;
   __tsan_release(addr);
-  syscall(SYS_futex, addr, WAKE, INT_MAX);
+  syscall(SYS_futex, addr, WAKE_PRIVATE, INT_MAX);
 }
 #else
 constexpr void (*PlatformFutexWait)(int*, int) = nullptr;
@@ -544,15 +546,17 @@ struct SelectImplementation<Implementation::Futex> {
       InitByteFutex<PlatformFutexWait, PlatformFutexWake, PlatformThreadID>;
 };
 
-// TODO(EricWF): We should prefer the futex implementation when available. But
-// it should be done in a separate step from adding the implementation.
+// Prefer the futex implementation when available: threads wait on the guard
+// they need instead of sharing one mutex and condition variable with every
+// other guard.
 constexpr Implementation CurrentImplementation =
 #if defined(_LIBCXXABI_HAS_NO_THREADS)
     Implementation::NoThreads;
 #elif defined(_LIBCXXABI_USE_FUTEX)
     Implementation::Futex;
 #else
-   Implementation::GlobalLock;
+    PlatformSupportsFutex() ? Implementation::Futex
+                            : Implementation::GlobalLock;
 #endif
 
 static_assert(CurrentImplementation != Implementation::Futex
@@ -617,8 +617,6 @@ extern "C" _LIBCXXABI_FUNC_VIS void *
 __dynamic_cast(const void *static_ptr, const __class_type_info *static_type,
                const __class_type_info *dst_type,
                std::ptrdiff_t src2dst_offset) {
-    // Possible future optimization:  Take advantage of src2dst_offset
-
     // Get (dynamic_ptr, dynamic_type) from static_ptr
     void **vtable = *static_cast<void ** const *>(static_ptr);
     ptrdiff_t offset_to_derived = reinterpret_cast<ptrdiff_t>(vtable[-2]);
@@ -635,6 +633,17 @@ __dynamic_cast(const void *static_ptr, const __class_type_info *static_type,
     // Find out if we can use a giant short cut in the search
     if (is_equal(dynamic_type, dst_type, false))
     {
+        // Casting to the most derived type, the usual case, needs no search
+        //   at all when the compiler's hint answers it.  With an offset, the
+        //   hint says dst_type has exactly one public static_type base, and
+        //   where it is.  If static_ptr isn't that base, it is a non-public
+        //   one, and there is no public path to it.
+        if (src2dst_offset >= 0)
+            return offset_to_derived == -src2dst_offset ?
+                       const_cast<void*>(dynamic_ptr) : nullptr;
+        // static_type is not a public base of dst_type.
+        if (src2dst_offset == -2)
+            return nullptr;
         // Using giant short cut.  Add that information to info.
         info.number_of_dst_type = 1;
         // Do the  search
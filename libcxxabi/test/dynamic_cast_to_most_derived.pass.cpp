@@ -0,0 +1,83 @@
+//===------------------- dynamic_cast_to_most_derived.pass.cpp ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Casting to the dynamic type of the object is answered from the compiler's
+// hint about where the source type sits in the destination type, when there
+// is one. Check the answers against each kind of hint.
+
+#include <cassert>
+
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Winaccessible-base"
+#endif
+
+struct A { virtual ~A() {} int a; };
+struct X { virtual ~X() {} int x; };
+
+// A unique public nonvirtual base at offset 0, and at a nonzero offset.
+struct B : A { int b; };
+struct C : X, A { int c; };
+
+// A public A, and a private one.
+struct Pub : A {};
+struct Priv : A {};
+struct D : Pub, private Priv {
+    A* private_a() { return static_cast<Priv*>(this); }
+};
+
+// Only a private A.
+struct E : private A {
+    A* private_a() { return this; }
+};
+
+// Two public A's.
+struct L : A {};
+struct R : A {};
+struct F : L, R {};
+
+// A virtual A.
+struct V1 : virtual A {};
+struct V2 : virtual A {};
+struct G : V1, V2 {};
+
+int main()
+{
+    B b;
+    A* ab = &b;
+    assert(dynamic_cast<B*>(ab) == &b);
+    assert(&dynamic_cast<B&>(*ab) == &b);
+    assert(dynamic_cast<const B*>(static_cast<const A*>(ab)) == &b);
+
+    C c;
+    A* ac = &c;
+    assert(static_cast<void*>(ac) != static_cast<void*>(&c));
+    assert(dynamic_cast<C*>(ac) == &c);
+    assert(dynamic_cast<B*>(ac) == 0);
+
+    D d;
+    assert(dynamic_cast<D*>(static_cast<A*>(static_cast<Pub*>(&d))) == &d);
+    assert(dynamic_cast<D*>(d.private_a()) == 0);
+
+    E e;
+    assert(dynamic_cast<E*>(e.private_a()) == 0);
+
+    F f;
+    assert(dynamic_cast<F*>(static_cast<A*>(static_cast<L*>(&f))) == &f);
+    assert(dynamic_cast<F*>(static_cast<A*>(static_cast<R*>(&f))) == &f);
+
+    G g;
+    A* ag = &g;
+    assert(dynamic_cast<G*>(ag) == &g);
+    assert(dynamic_cast<V2*>(ag) == static_cast<V2*>(&g));
+
+    A a;
+    assert(dynamic_cast<B*>(&a) == 0);
+    assert(dynamic_cast<C*>(&a) == 0);
+
+    return 0;
+}
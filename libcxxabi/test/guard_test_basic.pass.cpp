@@ -115,14 +115,23 @@ int main() {
     static_assert(
         std::is_same<SelectedImplementation, InitByteNoThreads>::value, "");
 #else
-    static_assert(CurrentImplementation == Implementation::GlobalLock, "");
+    static_assert(PlatformSupportsFutex() ==
+                      (CurrentImplementation == Implementation::Futex),
+                  "");
+    static_assert(
+        std::is_same<SelectedImplementation,
+                     SelectImplementation<CurrentImplementation>::type>::value,
+        "");
     static_assert(
         std::is_same<
-            SelectedImplementation,
+            SelectImplementation<Implementation::GlobalLock>::type,
             InitByteGlobalMutex<LibcppMutex, LibcppCondVar,
                                 GlobalStatic<LibcppMutex>::instance,
                                 GlobalStatic<LibcppCondVar>::instance>>::value,
         "");
+#endif
+#if defined(__linux__) && !defined(_LIBCXXABI_HAS_NO_THREADS)
+    static_assert(CurrentImplementation == Implementation::Futex, "");
 #endif
   }
   {
@@ -12,6 +12,7 @@
 #ifndef __ADDRESSSPACE_HPP__
 #define __ADDRESSSPACE_HPP__
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -149,6 +150,19 @@ extern char __exidx_end;
 #define ElfW(type) Elf_##type
 #endif
 
+// glibc 2.35 and later can find the object containing an address, and its
+// PT_GNU_EH_FRAME segment, without taking the loader lock.
+#if defined(_LIBUNWIND_SUPPORT_DWARF_INDEX) && _LIBUNWIND_USE_DLADDR &&       \
+    defined(DLFO_EH_SEGMENT_TYPE) && DLFO_EH_SEGMENT_TYPE == PT_GNU_EH_FRAME
+#define _LIBUNWIND_USE_DL_FIND_OBJECT 1
+#endif
+
+// glibc runs dl_iterate_phdr() callbacks one at a time, under the loader
+// lock, and reports how many objects have been loaded and unloaded so far.
+#if defined(_LIBUNWIND_SUPPORT_DWARF_INDEX) && defined(__GLIBC__)
+#define _LIBUNWIND_USE_FRAME_HEADER_CACHE 1
+#endif
+
 #endif
 
 namespace libunwind {
@@ -178,6 +192,63 @@ struct UnwindInfoSections {
 #endif
 };
 
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+/// Remembers the sections found for the last few PT_LOAD segments, so that
+/// findUnwindSections() can stop at the first object dl_iterate_phdr() reports
+/// instead of walking the program headers of every object for every frame.
+/// It is only used from inside the dl_iterate_phdr() callback, which the
+/// loader serializes, so it has no lock of its own. When the loader's count
+/// of objects added or removed changes, a dlopen() or dlclose() may have
+/// reused an address, and the cache starts over.
+class _LIBUNWIND_HIDDEN FrameHeaderCache {
+public:
+  bool find(const struct dl_phdr_info *pinfo, size_t pinfoSize,
+            uintptr_t targetAddr, UnwindInfoSections *info) {
+    if (pinfoSize < offsetof(struct dl_phdr_info, dlpi_subs) +
+                        sizeof(pinfo->dlpi_subs))
+      return false;
+    if (pinfo->dlpi_adds != _adds || pinfo->dlpi_subs != _subs) {
+      _adds = pinfo->dlpi_adds;
+      _subs = pinfo->dlpi_subs;
+      _used = 0;
+      _next = 0;
+      return false;
+    }
+    for (size_t i = 0; i < _used; ++i) {
+      if (targetAddr >= _entries[i].low && targetAddr < _entries[i].high) {
+        *info = _entries[i].info;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void add(uintptr_t low, uintptr_t high, const UnwindInfoSections &info) {
+    _entries[_next].low = low;
+    _entries[_next].high = high;
+    _entries[_next].info = info;
+    _next = (_next + 1) % kEntryCount;
+    if (_used < kEntryCount)
+      ++_used;
+  }
+
+private:
+  static const size_t kEntryCount = 8;
+  struct entry {
+    uintptr_t low;
+    uintptr_t high;
+    UnwindInfoSections info;
+  };
+  // No initializers: the only instance is a static, so it is zeroed before
+  // anything can unwind.
+  entry _entries[kEntryCount];
+  size_t _used;
+  size_t _next;
+  unsigned long long _adds;
+  unsigned long long _subs;
+};
+#endif
+
 
 /// LocalAddressSpace is used as a template parameter to UnwindCursor when
 /// unwinding a thread in the same process.  The wrappers compile away,
@@ -226,9 +297,16 @@ public:
   bool findFunctionName(pint_t addr, char *buf, size_t bufLen,
                         unw_word_t *offset);
   bool findUnwindSections(pint_t targetAddr, UnwindInfoSections &info);
+#if defined(_LIBUNWIND_USE_DL_FIND_OBJECT)
+  bool findUnwindSectionsWithoutLock(pint_t targetAddr,
+                                     UnwindInfoSections &info);
+#endif
   bool findOtherFDE(pint_t targetAddr, pint_t &fde);
 
   static LocalAddressSpace sThisAddressSpace;
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+  static FrameHeaderCache sFrameHeaderCache;
+#endif
 };
 
 inline uintptr_t LocalAddressSpace::getP(pint_t addr) {
@@ -471,15 +549,21 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
   if (info.arm_section && info.arm_section_length)
     return true;
 #elif defined(_LIBUNWIND_ARM_EHABI) || defined(_LIBUNWIND_SUPPORT_DWARF_UNWIND)
+#if defined(_LIBUNWIND_USE_DL_FIND_OBJECT)
+  if (findUnwindSectionsWithoutLock(targetAddr, info))
+    return true;
+#endif
+
   struct dl_iterate_cb_data {
     LocalAddressSpace *addressSpace;
     UnwindInfoSections *sects;
     uintptr_t targetAddr;
+    bool checkedCache;
   };
 
-  dl_iterate_cb_data cb_data = {this, &info, targetAddr};
+  dl_iterate_cb_data cb_data = {this, &info, targetAddr, false};
   int found = dl_iterate_phdr(
-      [](struct dl_phdr_info *pinfo, size_t, void *data) -> int {
+      [](struct dl_phdr_info *pinfo, size_t pinfoSize, void *data) -> int {
         auto cbdata = static_cast<dl_iterate_cb_data *>(data);
         bool found_obj = false;
         bool found_hdr = false;
@@ -487,6 +571,17 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
         assert(cbdata);
         assert(cbdata->sects);
 
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+        if (!cbdata->checkedCache) {
+          cbdata->checkedCache = true;
+          if (sFrameHeaderCache.find(pinfo, pinfoSize, cbdata->targetAddr,
+                                     cbdata->sects))
+            return true;
+        }
+#else
+        (void)pinfoSize;
+#endif
+
         if (cbdata->targetAddr < pinfo->dlpi_addr) {
           return false;
         }
@@ -506,6 +601,7 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
    #error "_LIBUNWIND_SUPPORT_DWARF_UNWIND requires _LIBUNWIND_SUPPORT_DWARF_INDEX on this platform."
   #endif
         size_t object_length;
+        uintptr_t object_begin = 0;
 #if defined(__ANDROID__)
         Elf_Addr image_base =
             pinfo->dlpi_phnum
@@ -526,6 +622,7 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
             uintptr_t end = begin + phdr->p_memsz;
             if (cbdata->targetAddr >= begin && cbdata->targetAddr < end) {
               cbdata->sects->dso_base = begin;
+              object_begin = begin;
               object_length = phdr->p_memsz;
               found_obj = true;
             }
@@ -548,6 +645,10 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
 
         if (found_obj && found_hdr) {
           cbdata->sects->dwarf_section_length = object_length;
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+          sFrameHeaderCache.add(object_begin, object_begin + object_length,
+                                *cbdata->sects);
+#endif
           return true;
         } else {
           return false;
@@ -578,6 +679,33 @@ inline bool LocalAddressSpace::findUnwindSections(pint_t targetAddr,
 }
 
 
+#if defined(_LIBUNWIND_USE_DL_FIND_OBJECT)
+/// Like findUnwindSections(), but only asks _dl_find_object(), which is
+/// async-signal-safe.
+inline bool
+LocalAddressSpace::findUnwindSectionsWithoutLock(pint_t targetAddr,
+                                                 UnwindInfoSections &info) {
+  struct dl_find_object object;
+  if (_dl_find_object((void *)targetAddr, &object) != 0 ||
+      object.dlfo_eh_frame == NULL)
+    return false;
+  uintptr_t eh_frame_hdr_start = (uintptr_t)object.dlfo_eh_frame;
+  uintptr_t map_end = (uintptr_t)object.dlfo_map_end;
+  EHHeaderParser<LocalAddressSpace>::EHHeaderInfo hdrInfo;
+  if (!EHHeaderParser<LocalAddressSpace>::decodeEHHdr(
+          *this, eh_frame_hdr_start, map_end, hdrInfo) ||
+      hdrInfo.eh_frame_ptr >= map_end)
+    return false;
+  // Neither section's length is known; the end of the mapping bounds both.
+  info.dso_base = (uintptr_t)object.dlfo_map_start;
+  info.dwarf_index_section = eh_frame_hdr_start;
+  info.dwarf_index_section_length = map_end - eh_frame_hdr_start;
+  info.dwarf_section = hdrInfo.eh_frame_ptr;
+  info.dwarf_section_length = map_end - hdrInfo.eh_frame_ptr;
+  return true;
+}
+#endif
+
 inline bool LocalAddressSpace::findOtherFDE(pint_t targetAddr, pint_t &fde) {
 #ifdef __APPLE__
   return checkKeyMgrRegisteredFDEs(targetAddr, *((void**)&fde));
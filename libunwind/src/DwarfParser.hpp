@@ -93,12 +93,21 @@ public:
   };
 
   struct PrologInfoStackEntry {
+    PrologInfoStackEntry() {}
     PrologInfoStackEntry(PrologInfoStackEntry *n, const PrologInfo &i)
         : next(n), info(i) {}
     PrologInfoStackEntry *next;
     PrologInfo info;
   };
 
+  /// Fixed storage for DW_CFA_remember_state, for callers that must not call
+  /// malloc(). Parsing fails if the FDE nests deeper than the pool.
+  struct PrologInfoStackPool {
+    PrologInfoStackEntry *entries;
+    size_t size;
+    size_t used;
+  };
+
   static bool findFDE(A &addressSpace, pint_t pc, pint_t ehSectionStart,
                       uint32_t sectionLength, pint_t fdeHint, FDE_Info *fdeInfo,
                       CIE_Info *cieInfo);
@@ -106,7 +115,8 @@ public:
                                FDE_Info *fdeInfo, CIE_Info *cieInfo);
   static bool parseFDEInstructions(A &addressSpace, const FDE_Info &fdeInfo,
                                    const CIE_Info &cieInfo, pint_t upToPC,
-                                   int arch, PrologInfo *results);
+                                   int arch, PrologInfo *results,
+                                   PrologInfoStackPool *pool = NULL);
 
   static const char *parseCIE(A &addressSpace, pint_t cie, CIE_Info *cieInfo);
 
@@ -114,7 +124,8 @@ private:
   static bool parseInstructions(A &addressSpace, pint_t instructions,
                                 pint_t instructionsEnd, const CIE_Info &cieInfo,
                                 pint_t pcoffset,
-                                PrologInfoStackEntry *&rememberStack, int arch,
+                                PrologInfoStackEntry *&rememberStack,
+                                PrologInfoStackPool *pool, int arch,
                                 PrologInfo *results);
 };
 
@@ -354,7 +365,8 @@ template <typename A>
 bool CFI_Parser<A>::parseFDEInstructions(A &addressSpace,
                                          const FDE_Info &fdeInfo,
                                          const CIE_Info &cieInfo, pint_t upToPC,
-                                         int arch, PrologInfo *results) {
+                                         int arch, PrologInfo *results,
+                                         PrologInfoStackPool *pool) {
   // clear results
   memset(results, '\0', sizeof(PrologInfo));
   PrologInfoStackEntry *rememberStack = NULL;
@@ -362,11 +374,11 @@ bool CFI_Parser<A>::parseFDEInstructions(A &addressSpace,
   // parse CIE then FDE instructions
   return parseInstructions(addressSpace, cieInfo.cieInstructions,
                            cieInfo.cieStart + cieInfo.cieLength, cieInfo,
-                           (pint_t)(-1), rememberStack, arch, results) &&
+                           (pint_t)(-1), rememberStack, pool, arch, results) &&
          parseInstructions(addressSpace, fdeInfo.fdeInstructions,
                            fdeInfo.fdeStart + fdeInfo.fdeLength, cieInfo,
-                           upToPC - fdeInfo.pcStart, rememberStack, arch,
-                           results);
+                           upToPC - fdeInfo.pcStart, rememberStack, pool,
+                           arch, results);
 }
 
 /// "run" the DWARF instructions
@@ -375,7 +387,8 @@ bool CFI_Parser<A>::parseInstructions(A &addressSpace, pint_t instructions,
                                       pint_t instructionsEnd,
                                       const CIE_Info &cieInfo, pint_t pcoffset,
                                       PrologInfoStackEntry *&rememberStack,
-                                      int arch, PrologInfo *results) {
+                                      PrologInfoStackPool *pool, int arch,
+                                      PrologInfo *results) {
   pint_t p = instructions;
   pint_t codeOffset = 0;
   PrologInfo initialState = *results;
@@ -391,9 +404,7 @@ bool CFI_Parser<A>::parseInstructions(A &addressSpace, pint_t instructions,
     uint64_t length;
     uint8_t opcode = addressSpace.get8(p);
     uint8_t operand;
-#if !defined(_LIBUNWIND_NO_HEAP)
     PrologInfoStackEntry *entry;
-#endif
     ++p;
     switch (opcode) {
     case DW_CFA_nop:
@@ -493,10 +504,17 @@ bool CFI_Parser<A>::parseInstructions(A &addressSpace, pint_t instructions,
       _LIBUNWIND_TRACE_DWARF(
           "DW_CFA_register(reg=%" PRIu64 ", reg2=%" PRIu64 ")\n", reg, reg2);
       break;
-#if !defined(_LIBUNWIND_NO_HEAP)
     case DW_CFA_remember_state:
-      // avoid operator new, because that would be an upward dependency
-      entry = (PrologInfoStackEntry *)malloc(sizeof(PrologInfoStackEntry));
+      if (pool != NULL) {
+        entry = pool->used < pool->size ? &pool->entries[pool->used++] : NULL;
+      } else {
+#if !defined(_LIBUNWIND_NO_HEAP)
+        // avoid operator new, because that would be an upward dependency
+        entry = (PrologInfoStackEntry *)malloc(sizeof(PrologInfoStackEntry));
+#else
+        entry = NULL;
+#endif
+      }
       if (entry != NULL) {
         entry->next = rememberStack;
         entry->info = *results;
@@ -511,13 +529,18 @@ bool CFI_Parser<A>::parseInstructions(A &addressSpace, pint_t instructions,
         PrologInfoStackEntry *top = rememberStack;
         *results = top->info;
         rememberStack = top->next;
-        free((char *)top);
+        if (pool != NULL) {
+          --pool->used;
+        } else {
+#if !defined(_LIBUNWIND_NO_HEAP)
+          free((char *)top);
+#endif
+        }
       } else {
         return false;
       }
       _LIBUNWIND_TRACE_DWARF("DW_CFA_restore_state\n");
       break;
-#endif
     case DW_CFA_def_cfa:
       reg = addressSpace.getULEB128(p, instructionsEnd);
       offset = (int64_t)addressSpace.getULEB128(p, instructionsEnd);
@@ -0,0 +1,253 @@
+//===-------------------------- FastUnwinder.hpp --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//
+//  Collects return addresses without locks or allocation, for profilers that
+//  sample the stack from a signal handler.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef __FAST_UNWINDER_HPP__
+#define __FAST_UNWINDER_HPP__
+
+#include <stdint.h>
+
+#include "AddressSpace.hpp"
+#include "DwarfParser.hpp"
+#include "EHHeaderParser.hpp"
+#include "Registers.hpp"
+#include "config.h"
+
+#if defined(__x86_64__) && defined(__linux__) &&                               \
+    defined(_LIBUNWIND_SUPPORT_DWARF_INDEX)
+#define _LIBUNWIND_USE_FAST_BACKTRACE 1
+#endif
+
+#if defined(_LIBUNWIND_USE_FAST_BACKTRACE)
+
+namespace libunwind {
+
+/// FastUnwinder only tracks the stack pointer, frame pointer and return
+/// address of each frame. Where the rest of the unwinder would run the CFI of
+/// every frame, it reduces the CFI at a return address to a CompactRule once,
+/// and keeps the rule in a fixed-size table that signal handlers can read and
+/// fill without locks. Frames without usable CFI are followed through their
+/// frame pointer, and signal frames through the ucontext the kernel pushed.
+///
+/// Looking up CFI needs _dl_find_object(); without it, every frame is
+/// followed through its frame pointer. Rules are never invalidated, so code
+/// unloaded by dlclose() may leave stale entries behind.
+class _LIBUNWIND_HIDDEN FastUnwinder {
+public:
+  /// Stores up to size return addresses of the callers of the frame that
+  /// registers describes, and returns how many were stored.
+  static int backtrace(const Registers_x86_64 &registers, void **buffer,
+                       int size);
+
+private:
+  typedef LocalAddressSpace::pint_t pint_t;
+  typedef CFI_Parser<LocalAddressSpace> CFI;
+
+  /// How to find the caller's frame from a pc. The CFA is the caller's stack
+  /// pointer; saved registers are 8-byte slots relative to it.
+  struct CompactRule {
+    int32_t cfaOffset;
+    int8_t raSlot;
+    int8_t rbpSlot;
+    uint8_t flags;
+    uint8_t unused;
+  };
+  enum {
+    kValid = 1,          // the entry holds a rule
+    kCFAIsRBP = 2,       // the CFA is RBP + cfaOffset, not RSP + cfaOffset
+    kRBPSaved = 4,       // the caller's RBP is in rbpSlot, not unchanged
+    kLastFrame = 8,      // the return address is undefined
+    kUseFramePointer = 16, // no usable CFI: follow the frame pointer
+    kSignalFrame = 32    // pc returns into the sigreturn trampoline
+  };
+
+  static const size_t kCacheSize = 1024;
+  static const int kMaxRememberState = 4;
+  static const pint_t kMaxFramePointerStep = 1 << 20;
+
+  /// A table slot guarded by a sequence count, odd while it is written.
+  /// Readers never wait: an odd or changed count is a miss, and a writer that
+  /// finds the slot busy drops its rule.
+  struct CacheEntry {
+    uint64_t sequence;
+    pint_t pc;
+    uint64_t rule;
+  };
+
+  static uint64_t pack(CompactRule rule) {
+    uint64_t bits;
+    memcpy(&bits, &rule, sizeof(bits));
+    return bits;
+  }
+  static CompactRule unpack(uint64_t bits) {
+    CompactRule rule;
+    memcpy(&rule, &bits, sizeof(rule));
+    return rule;
+  }
+  static size_t slot(pint_t pc) {
+    return ((pc >> 2) ^ (pc >> 12)) & (kCacheSize - 1);
+  }
+
+  static CompactRule findRule(pint_t pc);
+  static CompactRule computeRule(pint_t pc);
+  static bool isSigreturn(pint_t pc);
+
+  static CacheEntry sCache[kCacheSize];
+};
+
+inline int FastUnwinder::backtrace(const Registers_x86_64 &registers,
+                                   void **buffer, int size) {
+  LocalAddressSpace &addressSpace = LocalAddressSpace::sThisAddressSpace;
+  pint_t pc = registers.getIP();
+  pint_t sp = registers.getSP();
+  pint_t rbp = registers.getRBP();
+  bool isReturnAddress = true;
+  int count = 0;
+  while (count < size) {
+    // A return address follows the call, which may be the last instruction
+    // of the function; the call itself tells where the caller is.
+    CompactRule rule = findRule(isReturnAddress ? pc - 1 : pc);
+    pint_t cfa;
+    if (rule.flags & kSignalFrame) {
+      // The handler returned into __restore_rt with the kernel's ucontext_t
+      // on top of the stack. Its uc_mcontext.gregs start 40 bytes in, and
+      // hold RBP, RSP and RIP at indices 10, 15 and 16.
+      const pint_t gregs = sp + 40;
+      rbp = addressSpace.get64(gregs + 10 * 8);
+      cfa = addressSpace.get64(gregs + 15 * 8);
+      pc = addressSpace.get64(gregs + 16 * 8);
+      // The interrupted instruction has not run yet.
+      isReturnAddress = false;
+      // The interrupted stack need not be above an alternate signal stack.
+      if (pc == 0)
+        break;
+      sp = cfa;
+      buffer[count++] = (void *)pc;
+      continue;
+    }
+    if (rule.flags & kUseFramePointer) {
+      if (rbp < sp || rbp - sp > kMaxFramePointerStep || (rbp & 7) != 0)
+        break;
+      cfa = rbp + 16;
+      pc = addressSpace.get64(rbp + 8);
+      rbp = addressSpace.get64(rbp);
+      isReturnAddress = true;
+    } else {
+      if (rule.flags & kLastFrame)
+        break;
+      cfa = ((rule.flags & kCFAIsRBP) ? rbp : sp) + (pint_t)rule.cfaOffset;
+      if (cfa <= sp)
+        break;
+      pc = addressSpace.get64(cfa + (pint_t)(rule.raSlot * 8));
+      if (rule.flags & kRBPSaved)
+        rbp = addressSpace.get64(cfa + (pint_t)(rule.rbpSlot * 8));
+      isReturnAddress = true;
+    }
+    if (pc == 0 || cfa <= sp)
+      break;
+    sp = cfa;
+    buffer[count++] = (void *)pc;
+  }
+  return count;
+}
+
+inline FastUnwinder::CompactRule FastUnwinder::findRule(pint_t pc) {
+  CacheEntry &entry = sCache[slot(pc)];
+  uint64_t sequence = __atomic_load_n(&entry.sequence, __ATOMIC_ACQUIRE);
+  if ((sequence & 1) == 0) {
+    pint_t key = __atomic_load_n(&entry.pc, __ATOMIC_RELAXED);
+    uint64_t bits = __atomic_load_n(&entry.rule, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (key == pc &&
+        __atomic_load_n(&entry.sequence, __ATOMIC_RELAXED) == sequence)
+      return unpack(bits);
+  }
+
+  CompactRule rule = computeRule(pc);
+  if ((sequence & 1) == 0 &&
+      __atomic_compare_exchange_n(&entry.sequence, &sequence, sequence + 1,
+                                  false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    __atomic_store_n(&entry.pc, pc, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry.rule, pack(rule), __ATOMIC_RELAXED);
+    __atomic_store_n(&entry.sequence, sequence + 2, __ATOMIC_RELEASE);
+  }
+  return rule;
+}
+
+inline FastUnwinder::CompactRule FastUnwinder::computeRule(pint_t pc) {
+  CompactRule rule = {0, 0, 0, kValid | kUseFramePointer, 0};
+#if defined(_LIBUNWIND_USE_DL_FIND_OBJECT)
+  LocalAddressSpace &addressSpace = LocalAddressSpace::sThisAddressSpace;
+  UnwindInfoSections sects;
+  if (!addressSpace.findUnwindSectionsWithoutLock(pc, sects))
+    return rule;
+  // Only look at the code once it is known to be mapped.
+  if (isSigreturn(pc + 1)) {
+    rule.flags = kValid | kSignalFrame;
+    return rule;
+  }
+  CFI::FDE_Info fdeInfo;
+  CFI::CIE_Info cieInfo;
+  if (!EHHeaderParser<LocalAddressSpace>::findFDE(
+          addressSpace, pc, sects.dwarf_index_section,
+          (uint32_t)sects.dwarf_index_section_length, &fdeInfo, &cieInfo) ||
+      cieInfo.isSignalFrame)
+    return rule;
+  CFI::PrologInfoStackEntry entries[kMaxRememberState];
+  CFI::PrologInfoStackPool pool = {entries, kMaxRememberState, 0};
+  CFI::PrologInfo prolog;
+  if (!CFI::parseFDEInstructions(addressSpace, fdeInfo, cieInfo, pc + 1,
+                                 REGISTERS_X86_64, &prolog, &pool) ||
+      prolog.cfaExpression != 0 ||
+      (prolog.cfaRegister != UNW_X86_64_RSP &&
+       prolog.cfaRegister != UNW_X86_64_RBP))
+    return rule;
+
+  CompactRule compact = {prolog.cfaRegisterOffset, 0, 0, kValid, 0};
+  if (prolog.cfaRegister == UNW_X86_64_RBP)
+    compact.flags |= kCFAIsRBP;
+  const CFI::RegisterLocation &ra =
+      prolog.savedRegisters[cieInfo.returnAddressRegister];
+  if (ra.location == CFI::kRegisterUnused) {
+    compact.flags |= kLastFrame;
+  } else if (ra.location == CFI::kRegisterInCFA && ra.value % 8 == 0 &&
+             ra.value / 8 >= INT8_MIN && ra.value / 8 <= INT8_MAX) {
+    compact.raSlot = (int8_t)(ra.value / 8);
+  } else {
+    return rule;
+  }
+  const CFI::RegisterLocation &rbp = prolog.savedRegisters[UNW_X86_64_RBP];
+  if (rbp.location == CFI::kRegisterInCFA && rbp.value % 8 == 0 &&
+      rbp.value / 8 >= INT8_MIN && rbp.value / 8 <= INT8_MAX) {
+    compact.flags |= kRBPSaved;
+    compact.rbpSlot = (int8_t)(rbp.value / 8);
+  } else if (rbp.location != CFI::kRegisterUnused) {
+    return rule;
+  }
+  return compact;
+#else
+  (void)pc;
+  return rule;
+#endif
+}
+
+/// Matches glibc's __restore_rt: mov $__NR_rt_sigreturn, %rax; syscall.
+inline bool FastUnwinder::isSigreturn(pint_t pc) {
+  static const uint8_t kRestoreRT[] = {0x48, 0xc7, 0xc0, 0x0f, 0x00,
+                                       0x00, 0x00, 0x0f, 0x05};
+  return memcmp((const void *)pc, kRestoreRT, sizeof(kRestoreRT)) == 0;
+}
+
+} // namespace libunwind
+
+#endif // defined(_LIBUNWIND_USE_FAST_BACKTRACE)
+
+#endif // __FAST_UNWINDER_HPP__
@@ -19,12 +19,19 @@
 
 #if !defined(__USING_SJLJ_EXCEPTIONS__)
 #include "AddressSpace.hpp"
+#include "FastUnwinder.hpp"
 #include "UnwindCursor.hpp"
 
 using namespace libunwind;
 
 /// internal object to represent this processes address space
 LocalAddressSpace LocalAddressSpace::sThisAddressSpace;
+#if defined(_LIBUNWIND_USE_FRAME_HEADER_CACHE)
+FrameHeaderCache LocalAddressSpace::sFrameHeaderCache;
+#endif
+#if defined(_LIBUNWIND_USE_FAST_BACKTRACE)
+FastUnwinder::CacheEntry FastUnwinder::sCache[FastUnwinder::kCacheSize];
+#endif
 
 _LIBUNWIND_EXPORT unw_addr_space_t unw_local_addr_space =
     (unw_addr_space_t)&LocalAddressSpace::sThisAddressSpace;
@@ -162,6 +169,30 @@ _LIBUNWIND_HIDDEN int __unw_step(unw_cursor_t *cursor) {
 }
 _LIBUNWIND_WEAK_ALIAS(__unw_step, unw_step)
 
+/// Store the return addresses of the caller's frames. Where the fast
+/// unwinder is available, this takes no locks and does not allocate, so it is
+/// async-signal-safe.
+_LIBUNWIND_HIDDEN int __unw_backtrace(void **buffer, int size) {
+  _LIBUNWIND_TRACE_API("__unw_backtrace(buffer=%p, size=%d)",
+                       static_cast<void *>(buffer), size);
+  unw_context_t context;
+  __unw_getcontext(&context);
+#if defined(_LIBUNWIND_USE_FAST_BACKTRACE)
+  return FastUnwinder::backtrace(Registers_x86_64(&context), buffer, size);
+#else
+  unw_cursor_t cursor;
+  __unw_init_local(&cursor, &context);
+  int count = 0;
+  while (count < size && __unw_step(&cursor) > 0) {
+    unw_word_t ip;
+    __unw_get_reg(&cursor, UNW_REG_IP, &ip);
+    buffer[count++] = (void *)ip;
+  }
+  return count;
+#endif
+}
+_LIBUNWIND_WEAK_ALIAS(__unw_backtrace, unw_backtrace)
+
 /// Get unwind info at cursor position in stack frame.
 _LIBUNWIND_HIDDEN int __unw_get_proc_info(unw_cursor_t *cursor,
                                           unw_proc_info_t *info) {
@@ -0,0 +1,74 @@
+// Ensure that unw_backtrace reports the frames unw_step walks, and that on
+// x86-64 Linux it gets out of a signal handler.
+
+#include <libunwind.h>
+#include <signal.h>
+#include <stdlib.h>
+
+// The first frame unw_backtrace reports is its own call site in check(); the
+// first one unw_step reaches is check()'s caller.
+void check(int depth) {
+  void *frames[100];
+  int n = unw_backtrace(frames, 100);
+
+  unw_context_t context;
+  unw_getcontext(&context);
+  unw_cursor_t cursor;
+  unw_init_local(&cursor, &context);
+  int i = 1;
+  while (unw_step(&cursor) > 0) {
+    unw_word_t ip;
+    unw_get_reg(&cursor, UNW_REG_IP, &ip);
+    if (i >= n || (unw_word_t)frames[i] != ip)
+      abort();
+    ++i;
+  }
+  if (i != n || n < depth)
+    abort();
+  if (unw_backtrace(frames, 2) != 2)
+    abort();
+}
+
+__attribute__((noinline)) void recurse(int depth, int remaining) {
+  if (remaining == 0)
+    check(depth);
+  else
+    recurse(depth, remaining - 1);
+  __asm__ volatile("" ::: "memory");
+}
+
+// Getting through the signal frame needs _dl_find_object().
+#if defined(__x86_64__) && defined(__linux__) && defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 35)
+#define TEST_SIGNAL_FRAME
+#endif
+#endif
+
+#ifdef TEST_SIGNAL_FRAME
+volatile int signal_frames;
+
+void handler(int) {
+  void *frames[100];
+  signal_frames = unw_backtrace(frames, 100);
+}
+
+__attribute__((noinline)) void raise_signal(int remaining) {
+  if (remaining == 0)
+    raise(SIGUSR1);
+  else
+    raise_signal(remaining - 1);
+  __asm__ volatile("" ::: "memory");
+}
+#endif
+
+int main() {
+  recurse(5, 5);
+  recurse(50, 50);
+
+#ifdef TEST_SIGNAL_FRAME
+  signal(SIGUSR1, handler);
+  raise_signal(20);
+  if (signal_frames < 20)
+    abort();
+#endif
+}
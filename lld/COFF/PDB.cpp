@@ -71,6 +71,7 @@ static ExitOnError exitOnErr;
 static Timer totalPdbLinkTimer("PDB Emission (Cumulative)", Timer::root());
 
 static Timer addObjectsTimer("Add Objects", totalPdbLinkTimer);
+static Timer typeHashingTimer("Type Hashing", addObjectsTimer);
 static Timer typeMergingTimer("Type Merging", addObjectsTimer);
 static Timer symbolMergingTimer("Symbol Merging", addObjectsTimer);
 static Timer globalsLayoutTimer("Globals Stream Layout", totalPdbLinkTimer);
@@ -101,6 +102,10 @@ public:
   /// Link CodeView from each object file in the symbol table into the PDB.
   void addObjectsToPDB();
 
+  /// Compute global type hashes in parallel for all objects that need them
+  /// and do not provide a .debug$H section.
+  void computeGlobalTypeHashes();
+
   /// Link info for each import file in the symbol table into the PDB.
   void addImportFilesToPDB(ArrayRef<OutputSection *> outputSections);
 
@@ -184,6 +189,10 @@ private:
   /// far.
   std::map<uint32_t, CVIndexMap> precompTypeIndexMappings;
 
+  /// Global type hashes computed ahead of merging for objects without a
+  /// .debug$H section.
+  DenseMap<ObjFile *, std::vector<GloballyHashedType>> ownedTypeHashes;
+
   // For statistics
   uint64_t globalSymbols = 0;
   uint64_t moduleSymbols = 0;
@@ -393,7 +402,10 @@ PDBLinker::mergeDebugT(ObjFile *file, CVIndexMap *objectIndexMap) {
   if (config->debugGHashes) {
     ArrayRef<GloballyHashedType> hashes;
     std::vector<GloballyHashedType> ownedHashes;
-    if (Optional<ArrayRef<uint8_t>> debugH = getDebugH(file))
+    auto it = ownedTypeHashes.find(file);
+    if (it != ownedTypeHashes.end())
+      hashes = it->second;
+    else if (Optional<ArrayRef<uint8_t>> debugH = getDebugH(file))
       hashes = getHashesFromDebugH(*debugH);
     else {
       ownedHashes = GloballyHashedType::hashTypes(types);
@@ -1275,6 +1287,37 @@ static PublicSym32 createPublic(Defined *def) {
   return pub;
 }
 
+// Hashing type records with SHA1 is expensive and the hashes of an object
+// only depend on its own type stream, so compute them for all objects up
+// front. Merging the hashed records into the global table stays serial,
+// which keeps type indices in the output deterministic.
+//
+// Objects compiled with /Yu are excluded because their type streams are
+// rebased onto the precompiled headers object while merging, and type
+// server PDBs are handled separately.
+void PDBLinker::computeGlobalTypeHashes() {
+  ScopedTimer t(typeHashingTimer);
+
+  std::vector<ObjFile *> files;
+  for (ObjFile *file : ObjFile::instances) {
+    if (!file->debugTypesObj)
+      continue;
+    TpiSource::TpiKind kind = file->debugTypesObj->kind;
+    if (kind != TpiSource::Regular && kind != TpiSource::PCH)
+      continue;
+    if (!getDebugH(file))
+      files.push_back(file);
+  }
+
+  std::vector<std::vector<GloballyHashedType>> hashes(files.size());
+  parallelForEachN(0, files.size(), [&](size_t i) {
+    hashes[i] = GloballyHashedType::hashTypes(*files[i]->debugTypes);
+  });
+
+  for (size_t i = 0, e = files.size(); i < e; ++i)
+    ownedTypeHashes[files[i]] = std::move(hashes[i]);
+}
+
 // Add all object files to the PDB. Merge .debug$T sections into IpiData and
 // TpiData.
 void PDBLinker::addObjectsToPDB() {
@@ -1282,6 +1325,9 @@ void PDBLinker::addObjectsToPDB() {
 
   createModuleDBI(builder);
 
+  if (config->debugGHashes)
+    computeGlobalTypeHashes();
+
   for (ObjFile *file : ObjFile::instances)
     addObjFile(file);
 
@@ -15,7 +15,10 @@
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/FileOutputBuffer.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Process.h"
 #if LLVM_ON_UNIX
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 #include <thread>
@@ -78,6 +81,22 @@ void lld::unlinkAsync(StringRef path) {
 #endif
 }
 
+// Tells the kernel that we no longer need the pages of a given read-only
+// file mapping. This only drops them from our resident set; if the memory
+// is touched again, the pages are read back from the file, so this is always
+// safe to call for a memory-mapped input file. It must not be called for
+// memory that is not backed by a file, as the contents of such pages would
+// be lost.
+void lld::releaseMappedMemory(StringRef buf) {
+#if LLVM_ON_UNIX
+  uint64_t pageSize = sys::Process::getPageSizeEstimate();
+  uintptr_t begin = alignTo((uintptr_t)buf.begin(), pageSize);
+  uintptr_t end = alignDown((uintptr_t)buf.end(), pageSize);
+  if (begin < end)
+    ::madvise((void *)begin, end - begin, MADV_DONTNEED);
+#endif
+}
+
 // Simulate file creation to see if Path is writable.
 //
 // Determining whether a file is writable or not is amazingly hard,
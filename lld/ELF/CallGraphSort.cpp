@@ -38,12 +38,24 @@
 ///   * If not, then combine the clusters.
 /// * Sort non-empty clusters by density
 ///
+/// Alternatively, with --call-graph-sort-algorithm=ext-tsp, sections are laid
+/// out with the Extended TSP heuristic from: Improved Basic Block Reordering
+/// https://arxiv.org/abs/1809.04676
+///
+/// Ext-TSP models how likely a call edge is to stay within the same cache
+/// line or page as a function of the distance between the caller and the
+/// callee. Every section starts as its own chain, and the pair of chains whose
+/// concatenation increases the total Ext-TSP score the most is merged until no
+/// merge improves the score. Chains are then sorted by density like clusters
+/// are for C³.
+///
 //===----------------------------------------------------------------------===//
 
 #include "CallGraphSort.h"
 #include "OutputSections.h"
 #include "SymbolTable.h"
 #include "Symbols.h"
+#include <queue>
 
 using namespace llvm;
 using namespace lld;
@@ -96,10 +108,31 @@ using SectionPair =
     std::pair<const InputSectionBase *, const InputSectionBase *>;
 
 // Take the edge list in Config->CallGraphProfile, resolve symbol names to
-// Symbols, and generate a graph between InputSections with the provided
+// Symbols, and call Fn for each edge between InputSections with the provided
 // weights.
+static void forEachProfileEdge(
+    function_ref<void(const InputSectionBase *, const InputSectionBase *,
+                      uint64_t)>
+        fn) {
+  for (std::pair<SectionPair, uint64_t> &c : config->callGraphProfile) {
+    const auto *fromSB = cast<InputSectionBase>(c.first.first->repl);
+    const auto *toSB = cast<InputSectionBase>(c.first.second->repl);
+
+    // Ignore edges between input sections belonging to different output
+    // sections.  This is done because otherwise we would end up with clusters
+    // containing input sections that can't actually be placed adjacently in the
+    // output.  This messes with the cluster size and density calculations.  We
+    // would also end up moving input sections in other output sections without
+    // moving them closer to what calls them.
+    if (fromSB->getOutputSection() != toSB->getOutputSection())
+      continue;
+
+    fn(fromSB, toSB, c.second);
+  }
+}
+
+// Generate a graph between InputSections from the call graph profile.
 CallGraphSort::CallGraphSort() {
-  MapVector<SectionPair, uint64_t> &profile = config->callGraphProfile;
   DenseMap<const InputSectionBase *, int> secToCluster;
 
   auto getOrCreateNode = [&](const InputSectionBase *isec) -> int {
@@ -112,27 +145,15 @@ CallGraphSort::CallGraphSort() {
   };
 
   // Create the graph.
-  for (std::pair<SectionPair, uint64_t> &c : profile) {
-    const auto *fromSB = cast<InputSectionBase>(c.first.first->repl);
-    const auto *toSB = cast<InputSectionBase>(c.first.second->repl);
-    uint64_t weight = c.second;
-
-    // Ignore edges between input sections belonging to different output
-    // sections.  This is done because otherwise we would end up with clusters
-    // containing input sections that can't actually be placed adjacently in the
-    // output.  This messes with the cluster size and density calculations.  We
-    // would also end up moving input sections in other output sections without
-    // moving them closer to what calls them.
-    if (fromSB->getOutputSection() != toSB->getOutputSection())
-      continue;
-
+  forEachProfileEdge([&](const InputSectionBase *fromSB,
+                         const InputSectionBase *toSB, uint64_t weight) {
     int from = getOrCreateNode(fromSB);
     int to = getOrCreateNode(toSB);
 
     clusters[to].weight += weight;
 
     if (from == to)
-      continue;
+      return;
 
     // Remember the best edge.
     Cluster &toC = clusters[to];
@@ -140,7 +161,7 @@ CallGraphSort::CallGraphSort() {
       toC.bestPred.from = from;
       toC.bestPred.weight = weight;
     }
-  }
+  });
   for (Cluster &c : clusters)
     c.initialWeight = c.weight;
 }
@@ -214,38 +235,299 @@ void CallGraphSort::groupClusters() {
   });
 }
 
+// Write the symbols of the given sections, in order, to the file specified
+// by --print-symbol-order.
+static void writeSymbolOrder(ArrayRef<const InputSectionBase *> ordered) {
+  std::error_code ec;
+  raw_fd_ostream os(config->printSymbolOrder, ec, sys::fs::OF_None);
+  if (ec) {
+    error("cannot open " + config->printSymbolOrder + ": " + ec.message());
+    return;
+  }
+
+  for (const InputSectionBase *sec : ordered)
+    // Search all the symbols in the file of the section
+    // and find out a Defined symbol with name that is within the section.
+    for (Symbol *sym : sec->file->getSymbols())
+      if (!sym->isSection()) // Filter out section-type symbols here.
+        if (auto *d = dyn_cast<Defined>(sym))
+          if (sec == d->section)
+            os << sym->getName() << "\n";
+}
+
 DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
   groupClusters();
 
   // Generate order.
   DenseMap<const InputSectionBase *, int> orderMap;
+  std::vector<const InputSectionBase *> ordered;
   ssize_t curOrder = 1;
 
-  for (const Cluster &c : clusters)
-    for (int secIndex : c.sections)
+  for (const Cluster &c : clusters) {
+    for (int secIndex : c.sections) {
       orderMap[sections[secIndex]] = curOrder++;
+      ordered.push_back(sections[secIndex]);
+    }
+  }
+
+  if (!config->printSymbolOrder.empty())
+    writeSymbolOrder(ordered);
+  return orderMap;
+}
+
+namespace {
+struct ExtTspNode {
+  ExtTspNode(int chain, uint64_t size) : chain(chain), size(size) {}
+
+  // The chain this node belongs to and its offset within the chain.
+  int chain;
+  uint64_t offset = 0;
+  uint64_t size;
+  // The sum of the weights of all incoming edges.
+  uint64_t weight = 0;
+};
+
+struct ExtTspEdge {
+  int from;
+  int to;
+  uint64_t weight;
+};
+
+struct ExtTspChain {
+  double getDensity() const {
+    if (size == 0)
+      return 0;
+    return double(weight) / double(size);
+  }
+
+  std::vector<int> nodes;
+  uint64_t size = 0;
+  uint64_t weight = 0;
+  // Incremented every time this chain changes, to invalidate queued merges.
+  uint32_t version = 0;
+  // The edges between this chain and other chains, keyed by the other chain.
+  MapVector<int, std::vector<int>> edges;
+};
+
+// A candidate merge of two chains. If Reversed is true, B is placed before A.
+struct ExtTspMerge {
+  double gain;
+  int a;
+  int b;
+  uint32_t versionA;
+  uint32_t versionB;
+  bool reversed;
+
+  bool operator<(const ExtTspMerge &other) const {
+    if (gain != other.gain)
+      return gain < other.gain;
+    return std::make_pair(a, b) > std::make_pair(other.a, other.b);
+  }
+};
 
-  if (!config->printSymbolOrder.empty()) {
-    std::error_code ec;
-    raw_fd_ostream os(config->printSymbolOrder, ec, sys::fs::OF_None);
-    if (ec) {
-      error("cannot open " + config->printSymbolOrder + ": " + ec.message());
-      return orderMap;
+class ExtTspSort {
+public:
+  ExtTspSort();
+
+  DenseMap<const InputSectionBase *, int> run();
+
+private:
+  double getScore(int a, int b, bool reversed) const;
+  void enqueueMerge(int a, int b);
+  void mergeChains(int a, int b, bool reversed);
+
+  std::vector<ExtTspNode> nodes;
+  std::vector<ExtTspEdge> edges;
+  std::vector<ExtTspChain> chains;
+  std::vector<const InputSectionBase *> sections;
+  std::priority_queue<ExtTspMerge> queue;
+};
+
+// The parameters of the Ext-TSP objective. A call from the end of a section
+// directly to the start of the following section is treated like a
+// fallthrough. Calls over short forward or backward distances get a reduced
+// score that decreases linearly with the distance.
+constexpr double FALLTHROUGH_WEIGHT = 1.0;
+constexpr double FORWARD_WEIGHT = 0.1;
+constexpr double BACKWARD_WEIGHT = 0.1;
+constexpr uint64_t FORWARD_DISTANCE = 1024;
+constexpr uint64_t BACKWARD_DISTANCE = 640;
+} // end anonymous namespace
+
+static double getEdgeScore(uint64_t srcAddr, uint64_t srcSize,
+                           uint64_t dstAddr, uint64_t weight) {
+  uint64_t srcEnd = srcAddr + srcSize;
+  if (srcEnd == dstAddr)
+    return weight * FALLTHROUGH_WEIGHT;
+  if (srcEnd < dstAddr) {
+    uint64_t dist = dstAddr - srcEnd;
+    if (dist <= FORWARD_DISTANCE)
+      return weight * FORWARD_WEIGHT * (1.0 - double(dist) / FORWARD_DISTANCE);
+    return 0;
+  }
+  uint64_t dist = srcEnd - dstAddr;
+  if (dist <= BACKWARD_DISTANCE)
+    return weight * BACKWARD_WEIGHT * (1.0 - double(dist) / BACKWARD_DISTANCE);
+  return 0;
+}
+
+ExtTspSort::ExtTspSort() {
+  DenseMap<const InputSectionBase *, int> secToNode;
+
+  auto getOrCreateNode = [&](const InputSectionBase *isec) -> int {
+    auto res = secToNode.insert(std::make_pair(isec, nodes.size()));
+    if (res.second) {
+      sections.push_back(isec);
+      nodes.emplace_back(nodes.size(), isec->getSize());
     }
+    return res.first->second;
+  };
+
+  forEachProfileEdge([&](const InputSectionBase *fromSB,
+                         const InputSectionBase *toSB, uint64_t weight) {
+    int from = getOrCreateNode(fromSB);
+    int to = getOrCreateNode(toSB);
+    nodes[to].weight += weight;
+    if (from != to)
+      edges.push_back({from, to, weight});
+  });
+
+  // Each node starts as its own chain.
+  chains.resize(nodes.size());
+  for (size_t i = 0, e = nodes.size(); i < e; ++i) {
+    chains[i].nodes.push_back(i);
+    chains[i].size = nodes[i].size;
+    chains[i].weight = nodes[i].weight;
+  }
+
+  for (size_t i = 0, e = edges.size(); i < e; ++i) {
+    const ExtTspEdge &edge = edges[i];
+    chains[edge.from].edges[edge.to].push_back(i);
+    chains[edge.to].edges[edge.from].push_back(i);
+  }
+}
+
+// Returns the Ext-TSP score of the edges between chains A and B if they were
+// concatenated. Edges within A or B keep their scores when the chains are
+// concatenated, so they do not contribute to the gain.
+double ExtTspSort::getScore(int a, int b, bool reversed) const {
+  int first = reversed ? b : a;
+  uint64_t secondStart = chains[first].size;
+  auto getAddr = [&](int n) {
+    return nodes[n].offset + (nodes[n].chain == first ? 0 : secondStart);
+  };
 
-    // Print the symbols ordered by C3, in the order of increasing curOrder
-    // Instead of sorting all the orderMap, just repeat the loops above.
-    for (const Cluster &c : clusters)
-      for (int secIndex : c.sections)
-        // Search all the symbols in the file of the section
-        // and find out a Defined symbol with name that is within the section.
-        for (Symbol *sym: sections[secIndex]->file->getSymbols())
-          if (!sym->isSection()) // Filter out section-type symbols here.
-            if (auto *d = dyn_cast<Defined>(sym))
-              if (sections[secIndex] == d->section)
-                os << sym->getName() << "\n";
+  auto it = chains[a].edges.find(b);
+  if (it == chains[a].edges.end())
+    return 0;
+
+  double score = 0;
+  for (int i : it->second) {
+    const ExtTspEdge &edge = edges[i];
+    score += getEdgeScore(getAddr(edge.from), nodes[edge.from].size,
+                          getAddr(edge.to), edge.weight);
+  }
+  return score;
+}
+
+void ExtTspSort::enqueueMerge(int a, int b) {
+  if (chains[a].size + chains[b].size > MAX_CLUSTER_SIZE)
+    return;
+
+  double forward = getScore(a, b, false);
+  double backward = getScore(a, b, true);
+  bool reversed = backward > forward;
+  double gain = reversed ? backward : forward;
+  if (gain > 0)
+    queue.push({gain, a, b, chains[a].version, chains[b].version, reversed});
+}
+
+// Merge chain B into chain A. If Reversed is true, B is placed before A.
+void ExtTspSort::mergeChains(int a, int b, bool reversed) {
+  ExtTspChain &into = chains[a];
+  ExtTspChain &from = chains[b];
+
+  if (reversed) {
+    for (int n : into.nodes)
+      nodes[n].offset += from.size;
+    for (int n : from.nodes)
+      nodes[n].chain = a;
+    from.nodes.insert(from.nodes.end(), into.nodes.begin(), into.nodes.end());
+    into.nodes = std::move(from.nodes);
+  } else {
+    for (int n : from.nodes) {
+      nodes[n].chain = a;
+      nodes[n].offset += into.size;
+    }
+    into.nodes.insert(into.nodes.end(), from.nodes.begin(), from.nodes.end());
+  }
+  into.size += from.size;
+  into.weight += from.weight;
+  ++into.version;
+
+  // Edges between A and B are now internal to A. Move the other edges of B
+  // to A.
+  for (std::pair<int, std::vector<int>> &p : from.edges) {
+    if (p.first == a)
+      continue;
+    std::vector<int> &dst = into.edges[p.first];
+    dst.insert(dst.end(), p.second.begin(), p.second.end());
+
+    MapVector<int, std::vector<int>> &other = chains[p.first].edges;
+    std::vector<int> &otherDst = other[a];
+    otherDst.insert(otherDst.end(), p.second.begin(), p.second.end());
+    other.erase(b);
+  }
+  into.edges.erase(b);
+
+  from.nodes.clear();
+  from.edges.clear();
+  from.size = 0;
+  from.weight = 0;
+  ++from.version;
+}
+
+DenseMap<const InputSectionBase *, int> ExtTspSort::run() {
+  for (size_t i = 0, e = chains.size(); i < e; ++i)
+    for (std::pair<int, std::vector<int>> &p : chains[i].edges)
+      if ((int)i < p.first)
+        enqueueMerge(i, p.first);
+
+  // Greedily apply the merge with the largest gain. Merges whose chains
+  // changed after they were queued are stale and are skipped; the merges of
+  // the new chain are queued after every merge.
+  while (!queue.empty()) {
+    ExtTspMerge m = queue.top();
+    queue.pop();
+    if (chains[m.a].version != m.versionA || chains[m.b].version != m.versionB)
+      continue;
+
+    mergeChains(m.a, m.b, m.reversed);
+    for (std::pair<int, std::vector<int>> &p : chains[m.a].edges)
+      enqueueMerge(m.a, p.first);
+  }
+
+  std::vector<int> sorted;
+  for (size_t i = 0, e = chains.size(); i < e; ++i)
+    if (!chains[i].nodes.empty())
+      sorted.push_back(i);
+  llvm::stable_sort(sorted, [&](int a, int b) {
+    return chains[a].getDensity() > chains[b].getDensity();
+  });
+
+  DenseMap<const InputSectionBase *, int> orderMap;
+  std::vector<const InputSectionBase *> ordered;
+  ssize_t curOrder = 1;
+
+  for (int c : sorted) {
+    for (int n : chains[c].nodes) {
+      orderMap[sections[n]] = curOrder++;
+      ordered.push_back(sections[n]);
+    }
   }
 
+  if (!config->printSymbolOrder.empty())
+    writeSymbolOrder(ordered);
   return orderMap;
 }
 
@@ -255,5 +537,7 @@ DenseMap<const InputSectionBase *, int> CallGraphSort::run() {
 // according to the C³ huristic. All clusters are then sorted by a density
 // metric to further improve locality.
 DenseMap<const InputSectionBase *, int> elf::computeCallGraphProfileOrder() {
+  if (config->callGraphSortAlgorithm == CallGraphSortAlgorithm::ExtTsp)
+    return ExtTspSort().run();
   return CallGraphSort().run();
 }
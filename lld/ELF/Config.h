@@ -34,9 +34,15 @@ enum ELFKind {
   ELF64BEKind
 };
 
+// For --call-graph-sort-algorithm.
+enum class CallGraphSortAlgorithm { C3, ExtTsp };
+
 // For --build-id.
 enum class BuildIdKind { None, Fast, Md5, Sha1, Hexstring, Uuid };
 
+// For --compress-debug-sections.
+enum class CompressionType { None, Zlib, Zstd };
+
 // For --discard-{all,locals,none}.
 enum class DiscardPolicy { Default, All, Locals, None };
 
@@ -107,6 +113,7 @@ struct Configuration {
   llvm::StringRef sysroot;
   llvm::StringRef thinLTOCacheDir;
   llvm::StringRef thinLTOIndexOnlyArg;
+  llvm::StringRef timeTraceFile;
   std::pair<llvm::StringRef, llvm::StringRef> thinLTOObjectSuffixReplace;
   std::pair<llvm::StringRef, llvm::StringRef> thinLTOPrefixReplace;
   std::string rpath;
@@ -131,8 +138,8 @@ struct Configuration {
   bool bsymbolic;
   bool bsymbolicFunctions;
   bool callGraphProfileSort;
+  CallGraphSortAlgorithm callGraphSortAlgorithm;
   bool checkSections;
-  bool compressDebugSections;
   bool cref;
   bool defineCommon;
   bool demangle = true;
@@ -156,6 +163,7 @@ struct Configuration {
   bool hasDynSymTab;
   bool ignoreDataAddressEquality;
   bool ignoreFunctionAddressEquality;
+  bool incremental;
   bool ltoCSProfileGenerate;
   bool ltoDebugPassManager;
   bool ltoNewPassManager;
@@ -173,6 +181,7 @@ struct Configuration {
   bool printGcSections;
   bool printIcfSections;
   bool relocatable;
+  bool releaseInputs;
   bool relrPackDynRelocs;
   bool saveTemps;
   bool singleRoRx;
@@ -181,8 +190,10 @@ struct Configuration {
   bool sysvHash = false;
   bool target1Rel;
   bool trace;
+  bool thinLTOCacheCodeGen;
   bool thinLTOEmitImportsFiles;
   bool thinLTOIndexOnly;
+  bool timeTraceEnabled;
   bool tocOptimize;
   bool undefinedVersion;
   bool useAndroidRelrTags = false;
@@ -221,6 +232,7 @@ struct Configuration {
   Target2Policy target2;
   ARMVFPArgKind armVFPArgs = ARMVFPArgKind::Default;
   BuildIdKind buildId = BuildIdKind::None;
+  CompressionType compressDebugSections = CompressionType::None;
   ELFKind ekind = ELFNoneKind;
   uint16_t emachine = llvm::ELF::EM_NONE;
   llvm::Optional<uint64_t> imageBase;
@@ -232,6 +244,7 @@ struct Configuration {
   unsigned ltoo;
   unsigned optimize;
   unsigned thinLTOJobs;
+  unsigned timeTraceGranularity;
   int32_t splitStackAdjustSize;
 
   // The following config options do not directly correspond to any
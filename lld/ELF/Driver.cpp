@@ -25,6 +25,7 @@
 #include "Driver.h"
 #include "Config.h"
 #include "ICF.h"
+#include "Incremental.h"
 #include "InputFiles.h"
 #include "InputSection.h"
 #include "LinkerScript.h"
@@ -45,6 +46,7 @@
 #include "lld/Common/TargetOptionsCommandFlags.h"
 #include "lld/Common/Threads.h"
 #include "lld/Common/Version.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSwitch.h"
@@ -55,8 +57,10 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TarWriter.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdlib>
+#include <numeric>
 #include <utility>
 
 using namespace llvm;
@@ -320,6 +324,10 @@ static void checkOptions() {
   if (config->zText && config->zIfuncNoplt)
     error("-z text and -z ifunc-noplt may not be used together");
 
+  if (config->thinLTOCacheCodeGen && config->thinLTOCacheDir.empty())
+    error("--thinlto-cache-codegen may not be used without "
+          "--thinlto-cache-dir");
+
   if (config->relocatable) {
     if (config->shared)
       error("-r and -shared may not be used together");
@@ -453,11 +461,39 @@ void LinkerDriver::main(ArrayRef<const char *> argsArr) {
   if (args.hasArg(OPT_version))
     return;
 
+  // With --time-trace, the phases of the link and the ThinLTO backend jobs
+  // are recorded and written as a Chrome trace when the link is done, or
+  // has failed.
+  if (config->timeTraceEnabled)
+    timeTraceProfilerInitialize(config->timeTraceGranularity,
+                                config->progName);
+  auto writeTimeTrace = llvm::make_scope_exit([] {
+    if (!config->timeTraceEnabled)
+      return;
+    std::string path = config->timeTraceFile.str();
+    if (path.empty())
+      path = (config->outputFile.empty() ? StringRef("a.out")
+                                         : config->outputFile).str() +
+             ".time-trace";
+    std::error_code ec;
+    raw_fd_ostream os(path, ec, sys::fs::OF_Text);
+    if (ec)
+      error("cannot open " + path + ": " + ec.message());
+    else
+      timeTraceProfilerWrite(os);
+    timeTraceProfilerCleanup();
+  });
+
   initLLVM();
   createFiles(args);
   if (errorCount())
     return;
 
+  // With --incremental, the link can be skipped entirely if nothing changed
+  // since the last link.
+  if (config->incremental && isOutputUpToDate(args))
+    return;
+
   inferMachineType();
   setConfigs(args);
   checkOptions();
@@ -472,19 +508,22 @@ void LinkerDriver::main(ArrayRef<const char *> argsArr) {
   switch (config->ekind) {
   case ELF32LEKind:
     link<ELF32LE>(args);
-    return;
+    break;
   case ELF32BEKind:
     link<ELF32BE>(args);
-    return;
+    break;
   case ELF64LEKind:
     link<ELF64LE>(args);
-    return;
+    break;
   case ELF64BEKind:
     link<ELF64BE>(args);
-    return;
+    break;
   default:
     llvm_unreachable("unknown Config->EKind");
   }
+
+  if (config->incremental && !errorCount())
+    writeIncrementalState(args);
 }
 
 static std::string getRpath(opt::InputArgList &args) {
@@ -540,6 +579,16 @@ static Target2Policy getTarget2(opt::InputArgList &args) {
   return Target2Policy::GotRel;
 }
 
+static CallGraphSortAlgorithm
+getCallGraphSortAlgorithm(opt::InputArgList &args) {
+  StringRef s = args.getLastArgValue(OPT_call_graph_sort_algorithm, "c3");
+  if (s == "ext-tsp")
+    return CallGraphSortAlgorithm::ExtTsp;
+  if (s != "c3")
+    error("unknown --call-graph-sort-algorithm: " + s);
+  return CallGraphSortAlgorithm::C3;
+}
+
 static bool isOutputFormatBinary(opt::InputArgList &args) {
   StringRef s = args.getLastArgValue(OPT_oformat, "elf");
   if (s == "binary")
@@ -740,15 +789,22 @@ template <class ELFT> static void readCallGraphsFromObjectFiles() {
   }
 }
 
-static bool getCompressDebugSections(opt::InputArgList &args) {
+static CompressionType getCompressDebugSections(opt::InputArgList &args) {
   StringRef s = args.getLastArgValue(OPT_compress_debug_sections, "none");
   if (s == "none")
-    return false;
-  if (s != "zlib")
-    error("unknown --compress-debug-sections value: " + s);
-  if (!zlib::isAvailable())
-    error("--compress-debug-sections: zlib is not available");
-  return true;
+    return CompressionType::None;
+  if (s == "zlib") {
+    if (!zlib::isAvailable())
+      error("--compress-debug-sections: zlib is not available");
+    return CompressionType::Zlib;
+  }
+  if (s == "zstd") {
+    if (!zstd::isAvailable())
+      error("--compress-debug-sections: zstd is not available");
+    return CompressionType::Zstd;
+  }
+  error("unknown --compress-debug-sections value: " + s);
+  return CompressionType::None;
 }
 
 static std::pair<StringRef, StringRef> getOldNewOptions(opt::InputArgList &args,
@@ -823,6 +879,7 @@ static void readConfigs(opt::InputArgList &args) {
   config->emitRelocs = args.hasArg(OPT_emit_relocs);
   config->callGraphProfileSort = args.hasFlag(
       OPT_call_graph_profile_sort, OPT_no_call_graph_profile_sort, true);
+  config->callGraphSortAlgorithm = getCallGraphSortAlgorithm(args);
   config->enableNewDtags =
       args.hasFlag(OPT_enable_new_dtags, OPT_disable_new_dtags, true);
   config->entry = args.getLastArgValue(OPT_entry);
@@ -843,6 +900,8 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasArg(OPT_ignore_data_address_equality);
   config->ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
+  config->incremental =
+      args.hasFlag(OPT_incremental, OPT_no_incremental, false);
   config->init = args.getLastArgValue(OPT_init, "_init");
   config->ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   config->ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
@@ -880,6 +939,8 @@ static void readConfigs(opt::InputArgList &args) {
       args.getLastArgValue(OPT_print_symbol_order);
   config->rpath = getRpath(args);
   config->relocatable = args.hasArg(OPT_relocatable);
+  config->releaseInputs =
+      args.hasFlag(OPT_release_inputs, OPT_no_release_inputs, false);
   config->saveTemps = args.hasArg(OPT_save_temps);
   config->searchPaths = args::getStrings(args, OPT_library_path);
   config->sectionStartMap = getSectionStartMap(args);
@@ -893,6 +954,7 @@ static void readConfigs(opt::InputArgList &args) {
   config->target1Rel = args.hasFlag(OPT_target1_rel, OPT_target1_abs, false);
   config->target2 = getTarget2(args);
   config->thinLTOCacheDir = args.getLastArgValue(OPT_thinlto_cache_dir);
+  config->thinLTOCacheCodeGen = args.hasArg(OPT_thinlto_cache_codegen);
   config->thinLTOCachePolicy = CHECK(
       parseCachePruningPolicy(args.getLastArgValue(OPT_thinlto_cache_policy)),
       "--thinlto-cache-policy: invalid cache policy");
@@ -907,6 +969,10 @@ static void readConfigs(opt::InputArgList &args) {
       getOldNewOptions(args, OPT_plugin_opt_thinlto_object_suffix_replace_eq);
   config->thinLTOPrefixReplace =
       getOldNewOptions(args, OPT_plugin_opt_thinlto_prefix_replace_eq);
+  config->timeTraceEnabled = args.hasArg(OPT_time_trace);
+  config->timeTraceFile = args.getLastArgValue(OPT_time_trace_file_eq);
+  config->timeTraceGranularity =
+      args::getInteger(args, OPT_time_trace_granularity, 500);
   config->trace = args.hasArg(OPT_trace);
   config->undefined = args::getStrings(args, OPT_undefined);
   config->undefinedVersion =
@@ -1117,10 +1183,42 @@ static bool isFormatBinary(StringRef s) {
   return false;
 }
 
+// Starts reading the input files and libraries named on the command line in
+// the background, so that their I/O overlaps instead of happening one file at
+// a time as createFiles() reaches them.
+void LinkerDriver::prefetchFiles(opt::InputArgList &args) {
+  // -Bstatic and -Bdynamic decide which library searchLibrary() finds.
+  bool isStatic = config->isStatic;
+  for (auto *arg : args) {
+    switch (arg->getOption().getID()) {
+    case OPT_library:
+      if (Optional<std::string> path = searchLibrary(arg->getValue()))
+        prefetchFile(saver.save(*path));
+      break;
+    case OPT_INPUT:
+      prefetchFile(arg->getValue());
+      break;
+    case OPT_Bstatic:
+    case OPT_omagic:
+    case OPT_nmagic:
+      config->isStatic = true;
+      break;
+    case OPT_Bdynamic:
+      config->isStatic = false;
+      break;
+    }
+  }
+  config->isStatic = isStatic;
+}
+
 void LinkerDriver::createFiles(opt::InputArgList &args) {
   // For --{push,pop}-state.
   std::vector<std::tuple<bool, bool, bool>> stack;
 
+  if (threadsEnabled)
+    prefetchFiles(args);
+  auto clearPrefetched = llvm::make_scope_exit(clearPrefetchedFiles);
+
   // Iterate over argv to process input files and positional arguments.
   for (auto *arg : args) {
     switch (arg->getOption().getID()) {
@@ -1221,6 +1319,22 @@ void LinkerDriver::createFiles(opt::InputArgList &args) {
     error("no input files");
 }
 
+// Reading archive symbol tables is independent of symbol resolution, so we
+// do it for all archives in parallel and size the symbol table up front.
+// Links that pull from many large static archives spend a significant
+// amount of time just walking and hashing archive symbol names.
+static void readArchiveSymbols(ArrayRef<InputFile *> files) {
+  std::vector<ArchiveFile *> archives;
+  for (InputFile *f : files)
+    if (auto *a = dyn_cast<ArchiveFile>(f))
+      archives.push_back(a);
+
+  std::vector<size_t> numSyms(archives.size());
+  parallelForEachN(0, archives.size(),
+                   [&](size_t i) { numSyms[i] = archives[i]->readSymbols(); });
+  symtab->reserve(std::accumulate(numSyms.begin(), numSyms.end(), size_t(0)));
+}
+
 // If -m <machine_type> was not given, infer it from object files.
 void LinkerDriver::inferMachineType() {
   if (config->ekind != ELFNoneKind)
@@ -1535,6 +1649,15 @@ static Symbol *addUndefined(StringRef name) {
       Undefined{nullptr, name, STB_GLOBAL, STV_DEFAULT, 0});
 }
 
+// Local symbols are not visible to symbol resolution, so ObjFile::parse()
+// leaves them uninitialized. Now that all of the global symbols are
+// resolved, create them for every object file in parallel.
+template <class ELFT> static void initializeLocalSymbols() {
+  parallelForEach(objectFiles, [](InputFile *file) {
+    cast<ObjFile<ELFT>>(file)->initializeLocalSymbols();
+  });
+}
+
 // This function is where all the optimizations of link-time
 // optimization takes place. When LTO is in use, some input files are
 // not in native object file format but in the LLVM bitcode format.
@@ -1543,6 +1666,7 @@ static Symbol *addUndefined(StringRef name) {
 // Because all bitcode files that the program consists of are passed to
 // the compiler at once, it can do a whole-program optimization.
 template <class ELFT> void LinkerDriver::compileBitcodeFiles() {
+  llvm::TimeTraceScope timeScope("LTO", StringRef(""));
   // Compile bitcode files and replace bitcode symbols.
   lto.reset(new BitcodeCompiler);
   for (BitcodeFile *file : bitcodeFiles)
@@ -1710,12 +1834,17 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   for (auto *arg : args.filtered(OPT_trace_symbol))
     symtab->insert(arg->getValue())->traced = true;
 
+  readArchiveSymbols(files);
+
   // Add all files to the symbol table. This will add almost all
   // symbols that we need to the symbol table. This process might
   // add files to the link, via autolinking, these files are always
   // appended to the Files vector.
-  for (size_t i = 0; i < files.size(); ++i)
-    parseFile(files[i]);
+  {
+    llvm::TimeTraceScope timeScope("Parse input files", StringRef(""));
+    for (size_t i = 0; i < files.size(); ++i)
+      parseFile(files[i]);
+  }
 
   // Now that we have every file, we can decide if we will need a
   // dynamic symbol table.
@@ -1778,6 +1907,10 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   // They also might be exported if referenced by DSOs.
   script->declareSymbols();
 
+  // Symbol resolution for the input files is done, so we can create local
+  // symbols now.
+  initializeLocalSymbols<ELFT>();
+
   // Handle the -exclude-libs option.
   if (args.hasArg(OPT_exclude_libs))
     excludeLibs(args);
@@ -1811,6 +1944,9 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   if (errorCount())
     return;
 
+  // LTO may have added new object files.
+  initializeLocalSymbols<ELFT>();
+
   // If -thinlto-index-only is given, we should create only "index
   // files" and not object files. Index file creation is already done
   // in addCombinedLTOObject, so we are done if that's the case.
@@ -1898,7 +2034,10 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   // Do size optimizations: garbage collection, merging of SHF_MERGE sections
   // and identical code folding.
   splitSections<ELFT>();
-  markLive<ELFT>();
+  {
+    llvm::TimeTraceScope timeScope("Mark live", StringRef(""));
+    markLive<ELFT>();
+  }
   demoteSharedSymbols();
   mergeSections();
 
@@ -1927,6 +2066,7 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   // Two input sections with different output sections should not be folded.
   // ICF runs after processSectionCommands() so that we know the output sections.
   if (config->icf != ICFLevel::None) {
+    llvm::TimeTraceScope timeScope("ICF", StringRef(""));
     findKeepUniqueSections<ELFT>(args);
     doIcf<ELFT>();
   }
@@ -1939,6 +2079,10 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
     readCallGraphsFromObjectFiles<ELFT>();
   }
 
+  if (config->incremental)
+    prepareIncrementalLayout();
+
   // Write the result to the file.
+  llvm::TimeTraceScope timeScope("Write output file", StringRef(""));
   writeResult<ELFT>();
 }
@@ -32,6 +32,7 @@ public:
 
 private:
   void createFiles(llvm::opt::InputArgList &args);
+  void prefetchFiles(llvm::opt::InputArgList &args);
   void inferMachineType();
   template <class ELFT> void link(llvm::opt::InputArgList &args);
   template <class ELFT> void compileBitcodeFiles();
@@ -0,0 +1,446 @@
+//===- Incremental.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the --incremental option. After a successful link,
+// we write a small state file next to the output ("<output>.lldstate")
+// which records the command line and the size and modification time of
+// every file that was opened during the link, including the output itself.
+//
+// On the next link with the same command line, if the command line resolves
+// to the same input files (e.g. -lfoo finds the same archive), none of these
+// files has changed and the output is still the one we wrote, the link is
+// skipped.
+//
+// If only some object files (or archives) changed, the output may still be
+// patched in place. To make that likely, each code section from an object
+// file gets some padding after it, which the next link reuses as long as the
+// section still fits. The next link then does all the usual work except for
+// writing the output. If the resulting layout is the same as the previous
+// one, i.e. every output and input section is at the same place and every
+// global symbol has the same address and GOT and PLT entries, only the
+// sections that may have changed are written to the existing file: the
+// sections of the changed files, the synthetic sections and sections that
+// use the size of a symbol. The symbol and string tables at the end of the
+// file may change in size; they are rewritten as a whole. Otherwise, we do a
+// full link. In both cases, we rewrite the state file.
+//
+// Patching is only supported for x86-64 without SECTIONS commands and
+// without options that make the output depend on more than the layout and
+// the section contents, such as -r, --emit-relocs and --icf.
+//
+// The state file is a text file of the following form:
+//
+//   lld-incremental-v2
+//   <lld version>
+//   <hash of working directory and command line>
+//   <hash of section layout> <hash of symbols>
+//   <number of files>
+//   <size> <mtime> <output path>
+//   <size> <mtime> <input path>
+//   ...
+//   <object file index> <section index> <reserved size>
+//   ...
+//
+//===----------------------------------------------------------------------===//
+
+#include "Incremental.h"
+#include "Config.h"
+#include "Driver.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "LinkerScript.h"
+#include "OutputSections.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "SyntheticSections.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Version.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/TarWriter.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::ELF;
+using namespace llvm::sys;
+
+using namespace lld;
+using namespace lld::elf;
+
+static const char magic[] = "lld-incremental-v2";
+
+// Paths of all files opened by readFile() in this link.
+static std::vector<std::string> inputPaths;
+
+namespace {
+// What the state file tells us about the previous link.
+struct PreviousLink {
+  std::string layoutHash;
+  std::string symbolHash;
+  std::vector<std::string> inputs;
+
+  // Inputs whose size or modification time is not the recorded one.
+  StringSet<> changedInputs;
+
+  // The sizes reserved for input sections, keyed by the index of the object
+  // file in objectFiles and the index of the section in that file.
+  DenseMap<std::pair<uint32_t, uint32_t>, uint64_t> reserved;
+};
+} // namespace
+
+// Set if the state file is valid and the output has not changed since the
+// previous link.
+static std::unique_ptr<PreviousLink> prev;
+
+// The object file and section indices of all input sections of object files.
+static DenseMap<const InputSectionBase *, std::pair<uint32_t, uint32_t>>
+    sectionIds;
+
+// The sizes reserved for the input sections that get padding in this link.
+static DenseMap<const InputSectionBase *, uint64_t> reserved;
+
+static std::string layoutHash = "-";
+static uint64_t tailOffset;
+static std::string symbolHash = "-";
+
+// The object files created from inputs that changed since the previous link.
+static DenseSet<const InputFile *> changedFiles;
+
+void elf::recordIncrementalInput(StringRef path) {
+  inputPaths.push_back(path);
+}
+
+static std::string getStatePath() {
+  return (config->outputFile + ".lldstate").str();
+}
+
+static std::string getCommandLineHash(const opt::InputArgList &args) {
+  SmallString<128> cwd;
+  fs::current_path(cwd);
+  std::string s = (cwd + "\n" + createResponseFile(args)).str();
+  return utohexstr(xxHash64(s));
+}
+
+// Returns a "<size> <mtime>" string for a given file, or an empty string if
+// the file does not exist.
+static std::string getFileStamp(StringRef path) {
+  fs::file_status st;
+  if (fs::status(path, st))
+    return "";
+  return (Twine(st.getSize()) + " " +
+          Twine(st.getLastModificationTime().time_since_epoch().count()))
+      .str();
+}
+
+// Options that print something to stdout or write files other than the
+// output as a side effect of a link. Skipping such a link would lose that
+// output, so we don't.
+static bool hasSideEffects(const opt::InputArgList &args) {
+  return config->outputFile == "-" || !config->mapFile.empty() ||
+         config->cref || config->trace || args.hasArg(OPT_trace_symbol) ||
+         config->printGcSections || config->printIcfSections ||
+         !config->printSymbolOrder.empty() || tar || config->saveTemps ||
+         config->timeTraceEnabled || !config->optRemarksFilename.empty() ||
+         !config->ltoObjPath.empty() || !config->dwoDir.empty() ||
+         config->thinLTOIndexOnly || config->thinLTOEmitImportsFiles ||
+         config->emitLLVM;
+}
+
+// Reads the state file of the previous link. Returns null if there is none
+// or if it is not usable for this link.
+static std::unique_ptr<PreviousLink>
+readState(const opt::InputArgList &args) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      MemoryBuffer::getFile(getStatePath(), -1, false);
+  if (!mbOrErr)
+    return nullptr;
+
+  SmallVector<StringRef, 0> lines;
+  (*mbOrErr)->getBuffer().split(lines, '\n', -1, false);
+  size_t numFiles;
+  if (lines.size() < 6 || lines[0] != magic || lines[1] != getLLDVersion() ||
+      lines[2] != getCommandLineHash(args) ||
+      lines[4].getAsInteger(10, numFiles) || numFiles == 0 ||
+      lines.size() < 5 + numFiles)
+    return nullptr;
+
+  auto state = std::make_unique<PreviousLink>();
+  std::tie(state->layoutHash, state->symbolHash) = lines[3].split(' ');
+
+  for (size_t i = 0; i < numFiles; ++i) {
+    StringRef line = lines[5 + i];
+    StringRef size, mtime, path;
+    std::tie(size, line) = line.split(' ');
+    std::tie(mtime, path) = line.split(' ');
+    if (path.empty())
+      return nullptr;
+    bool changed = getFileStamp(path) != (size + " " + mtime).str();
+
+    // The output must be the one we wrote.
+    if (i == 0) {
+      if (changed)
+        return nullptr;
+      continue;
+    }
+    state->inputs.push_back(path);
+    if (changed)
+      state->changedInputs.insert(path);
+  }
+
+  for (StringRef line : makeArrayRef(lines).slice(5 + numFiles)) {
+    SmallVector<StringRef, 3> fields;
+    line.split(fields, ' ');
+    uint32_t file, sec;
+    uint64_t size;
+    if (fields.size() != 3 || fields[0].getAsInteger(10, file) ||
+        fields[1].getAsInteger(10, sec) || fields[2].getAsInteger(10, size))
+      return nullptr;
+    state->reserved[{file, sec}] = size;
+  }
+  return state;
+}
+
+bool elf::isOutputUpToDate(const opt::InputArgList &args) {
+  if (hasSideEffects(args))
+    return false;
+
+  prev = readState(args);
+  if (!prev || !prev->changedInputs.empty())
+    return false;
+
+  // The files that createFiles() opened in this link must be the first inputs
+  // recorded, in the same order. The same command line can resolve to other
+  // files, e.g. if a library was added to a directory that is searched
+  // earlier. Files that the previous link opened later are only checked for
+  // changes above.
+  if (prev->inputs.size() < inputPaths.size() ||
+      !std::equal(inputPaths.begin(), inputPaths.end(), prev->inputs.begin()))
+    return false;
+  log("--incremental: " + config->outputFile + " is up to date");
+  return true;
+}
+
+static bool isPatchingSupported() {
+  return config->emachine == EM_X86_64 && !script->hasSectionsCommand &&
+         !config->relocatable && !config->emitRelocs &&
+         !config->oFormatBinary && config->icf == ICFLevel::None &&
+         config->compressDebugSections == CompressionType::None &&
+         partitions.size() == 1 && bitcodeFiles.empty();
+}
+
+// Code sections from object files get padding. Other sections are not padded
+// because their contents may be arrays which must not have holes (e.g.
+// .init_array) or fragments of code that fall through to the next fragment
+// (.init and .fini).
+static bool needsPadding(const InputSectionBase *s) {
+  return s->kind() == SectionBase::Regular && (s->flags & SHF_EXECINSTR) &&
+         s->name != ".init" && s->name != ".fini";
+}
+
+void elf::prepareIncrementalLayout() {
+  if (!isPatchingSupported())
+    return;
+
+  for (uint32_t i = 0, e = objectFiles.size(); i != e; ++i) {
+    ArrayRef<InputSectionBase *> sections = objectFiles[i]->getSections();
+    for (uint32_t j = 0, f = sections.size(); j != f; ++j) {
+      InputSectionBase *s = sections[j];
+      if (!s || s == &InputSection::discarded)
+        continue;
+      sectionIds[s] = {i, j};
+      if (needsPadding(s))
+        reserved[s] = prev ? prev->reserved.lookup({i, j}) : 0;
+    }
+  }
+}
+
+uint64_t elf::getIncrementalPadding(const InputSection *s) {
+  auto it = reserved.find(s);
+  if (it == reserved.end())
+    return 0;
+
+  // Reuse the space reserved by the previous link if the section still fits.
+  // Otherwise, reserve 25% more than the section needs, but at least 16 bytes.
+  uint64_t size = s->getSize();
+  if (it->second < size)
+    it->second = size + std::max<uint64_t>(size / 4, 16);
+  return it->second - size;
+}
+
+// Returns a string that identifies an input section across links.
+static std::string getSectionId(const InputSectionBase *s) {
+  auto it = sectionIds.find(s);
+  if (it == sectionIds.end())
+    return s->name.str();
+  return (Twine(it->second.first) + ":" + Twine(it->second.second)).str();
+}
+
+// The output sections at the end of the file that are not loaded into memory
+// and only contain synthetic sections, such as .symtab and .strtab, are
+// rewritten as a whole when patching. They may change in size, e.g. if a
+// changed file has more local symbols.
+static bool isInTail(OutputSection *sec) {
+  return !(sec->flags & SHF_ALLOC) &&
+         llvm::all_of(getInputSections(sec), [](InputSection *isec) {
+           return isa<SyntheticSection>(isec);
+         });
+}
+
+// Computes a hash of everything that determines where things are in the
+// output: the addresses, offsets and sizes of output sections, the positions
+// of input sections in them and the positions of the pieces of mergeable
+// input sections. Only the names of the sections in the tail count.
+static std::string computeLayoutHash() {
+  size_t tail = outputSections.size();
+  while (tail > 0 && isInTail(outputSections[tail - 1]))
+    --tail;
+  tailOffset = tail == outputSections.size() ? 0 : outputSections[tail]->offset;
+
+  std::string s;
+  raw_string_ostream os(s);
+  for (size_t i = 0, e = outputSections.size(); i != e; ++i) {
+    OutputSection *sec = outputSections[i];
+    os << sec->name << " " << sec->type << " " << sec->flags << "\n";
+    if (i >= tail)
+      continue;
+    os << sec->addr << " " << sec->offset << " " << sec->size << " "
+       << sec->alignment << "\n";
+    for (InputSection *isec : getInputSections(sec))
+      os << getSectionId(isec) << " " << isec->outSecOff << "\n";
+  }
+
+  for (InputFile *file : objectFiles)
+    for (InputSectionBase *s : file->getSections())
+      if (auto *ms = dyn_cast_or_null<MergeInputSection>(s))
+        if (ms->isLive() && (!tailOffset ||
+                             ms->getOutputSection()->offset < tailOffset))
+          for (const SectionPiece &piece : ms->pieces)
+            os << (piece.live ? piece.outputOff : -1) << "\n";
+  return utohexstr(xxHash64(os.str()));
+}
+
+// Computes a hash of what code in other sections may depend on: the
+// properties of global symbols, their addresses and their GOT and PLT
+// entries. The sizes of symbols are not included; sections that use them
+// are always rewritten.
+static std::string computeSymbolHash() {
+  std::string s;
+  raw_string_ostream os(s);
+  auto writeEntries = [&](Symbol *sym) {
+    os << sym->gotIndex << " " << sym->pltIndex << " " << sym->globalDynIndex
+       << " " << sym->isInIplt << " " << sym->needsPltAddr << "\n";
+  };
+
+  symtab->forEachSymbol([&](Symbol *sym) {
+    os << sym->getName() << " " << (int)sym->kind() << " "
+       << (int)sym->binding << " " << (int)sym->type << " " << sym->visibility
+       << " " << sym->isPreemptible << " ";
+    if (auto *d = dyn_cast<Defined>(sym))
+      if (!d->section || d->section->getOutputSection())
+        os << d->getVA();
+    os << " ";
+    writeEntries(sym);
+  });
+
+  // Local symbols may have GOT entries too.
+  for (InputFile *file : objectFiles)
+    for (Symbol *sym : file->getSymbols())
+      if (sym && sym->isLocal() && (sym->isInGot() || sym->isInPlt()))
+        writeEntries(sym);
+
+  if (in.got)
+    os << in.got->getTlsIndexOff() << "\n";
+  return utohexstr(xxHash64(os.str()));
+}
+
+bool elf::canPatchOutput() {
+  if (!isPatchingSupported())
+    return false;
+  layoutHash = computeLayoutHash();
+  symbolHash = computeSymbolHash();
+
+  if (!prev || prev->changedInputs.empty())
+    return false;
+  if (prev->inputs != inputPaths) {
+    log("--incremental: input files changed");
+    return false;
+  }
+
+  // Every input that changed must be an object file or an archive whose
+  // members we can rewrite.
+  StringSet<> seen;
+  for (InputFile *file : objectFiles) {
+    StringRef path = file->archiveName.empty() ? file->getName()
+                                               : StringRef(file->archiveName);
+    if (prev->changedInputs.count(path)) {
+      changedFiles.insert(file);
+      seen.insert(path);
+    }
+  }
+  for (const auto &entry : prev->changedInputs) {
+    if (!seen.count(entry.getKey())) {
+      log("--incremental: " + entry.getKey() + " is not an object file");
+      return false;
+    }
+  }
+
+  if (layoutHash != prev->layoutHash) {
+    log("--incremental: section layout changed");
+    return false;
+  }
+  if (symbolHash != prev->symbolHash) {
+    log("--incremental: symbols changed");
+    return false;
+  }
+  return true;
+}
+
+uint64_t elf::getIncrementalTailOffset() { return tailOffset; }
+
+bool elf::needsIncrementalRewrite(const InputSection *isec) {
+  return isa<SyntheticSection>(isec) || changedFiles.count(isec->file) ||
+         llvm::any_of(isec->relocations,
+                      [](const Relocation &rel) { return rel.expr == R_SIZE; });
+}
+
+void elf::writeIncrementalState(const opt::InputArgList &args) {
+  std::string path = getStatePath();
+  if (hasSideEffects(args)) {
+    fs::remove(path);
+    return;
+  }
+
+  std::error_code ec;
+  raw_fd_ostream os(path, ec, fs::OF_None);
+  if (ec) {
+    warn("--incremental: cannot open " + path + ": " + ec.message());
+    return;
+  }
+
+  os << magic << "\n" << getLLDVersion() << "\n"
+     << getCommandLineHash(args) << "\n"
+     << layoutHash << " " << symbolHash << "\n"
+     << inputPaths.size() + 1 << "\n";
+  os << getFileStamp(config->outputFile) << " " << config->outputFile << "\n";
+  for (StringRef input : inputPaths)
+    os << getFileStamp(input) << " " << input << "\n";
+
+  for (uint32_t i = 0, e = objectFiles.size(); i != e; ++i) {
+    ArrayRef<InputSectionBase *> sections = objectFiles[i]->getSections();
+    for (uint32_t j = 0, f = sections.size(); j != f; ++j) {
+      auto it = reserved.find(sections[j]);
+      if (it != reserved.end() && cast<InputSection>(sections[j])->getParent())
+        os << i << " " << j << " " << it->second << "\n";
+    }
+  }
+}
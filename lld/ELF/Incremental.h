@@ -0,0 +1,45 @@
+//===- Incremental.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_INCREMENTAL_H
+#define LLD_ELF_INCREMENTAL_H
+
+#include "lld/Common/LLVM.h"
+
+namespace llvm {
+namespace opt {
+class InputArgList;
+}
+} // namespace llvm
+
+namespace lld {
+namespace elf {
+class InputSection;
+
+void recordIncrementalInput(StringRef path);
+bool isOutputUpToDate(const llvm::opt::InputArgList &args);
+
+// Decides which input sections get padding so that a later link can patch
+// them in place.
+void prepareIncrementalLayout();
+uint64_t getIncrementalPadding(const InputSection *s);
+
+// Returns true if the output of the previous link has the same layout as
+// this one, so that only the sections for which needsIncrementalRewrite()
+// returns true need to be written. Everything from the offset returned by
+// getIncrementalTailOffset() to the end of the file is rewritten too, unless
+// that offset is 0.
+bool canPatchOutput();
+bool needsIncrementalRewrite(const InputSection *isec);
+uint64_t getIncrementalTailOffset();
+
+void writeIncrementalState(const llvm::opt::InputArgList &args);
+} // namespace elf
+} // namespace lld
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "InputFiles.h"
 #include "Driver.h"
+#include "Incremental.h"
 #include "InputSection.h"
 #include "LinkerScript.h"
 #include "SymbolTable.h"
@@ -25,6 +26,7 @@
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Support/ARMAttributeParser.h"
 #include "llvm/Support/ARMBuildAttributes.h"
+#include "llvm/Support/AsyncFileReader.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TarWriter.h"
@@ -49,6 +51,7 @@ std::vector<InputFile *> elf::objectFiles;
 std::vector<SharedFile *> elf::sharedFiles;
 
 std::unique_ptr<TarWriter> elf::tar;
+std::vector<MemoryBufferRef> elf::mappedBuffers;
 
 static ELFKind getELFKind(MemoryBufferRef mb, StringRef archiveName) {
   unsigned char size;
@@ -88,15 +91,44 @@ InputFile::InputFile(Kind k, MemoryBufferRef m)
     ++nextGroupId;
 }
 
-Optional<MemoryBufferRef> elf::readFile(StringRef path) {
+// Files being read in the background by prefetchFile(), keyed by path.
+static std::unique_ptr<AsyncFileReader> prefetcher;
+static StringMap<std::future<AsyncFileReader::ResultTy>> prefetchedFiles;
+
+static StringRef resolveChroot(StringRef path) {
   // The --chroot option changes our virtual root directory.
   // This is useful when you are dealing with files created by --reproduce.
   if (!config->chroot.empty() && path.startswith("/"))
-    path = saver.save(config->chroot + path);
+    return saver.save(config->chroot + path);
+  return path;
+}
+
+void elf::prefetchFile(StringRef path) {
+  path = resolveChroot(path);
+  if (prefetchedFiles.count(path))
+    return;
+  if (!prefetcher)
+    prefetcher = std::make_unique<AsyncFileReader>();
+  prefetchedFiles[path] =
+      prefetcher->read(path, /*RequiresNullTerminator=*/false);
+}
+
+void elf::clearPrefetchedFiles() {
+  prefetchedFiles.clear();
+  prefetcher.reset();
+}
+
+Optional<MemoryBufferRef> elf::readFile(StringRef path) {
+  path = resolveChroot(path);
 
   log(path);
 
-  auto mbOrErr = MemoryBuffer::getFile(path, -1, false);
+  auto it = prefetchedFiles.find(path);
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      it == prefetchedFiles.end() ? MemoryBuffer::getFile(path, -1, false)
+                                  : it->second.get();
+  if (it != prefetchedFiles.end())
+    prefetchedFiles.erase(it);
   if (auto ec = mbOrErr.getError()) {
     error("cannot open " + path + ": " + ec.message());
     return None;
@@ -104,10 +136,14 @@ Optional<MemoryBufferRef> elf::readFile(StringRef path) {
 
   std::unique_ptr<MemoryBuffer> &mb = *mbOrErr;
   MemoryBufferRef mbref = mb->getMemBufferRef();
+  if (mb->getBufferKind() == MemoryBuffer::MemoryBuffer_MMap)
+    mappedBuffers.push_back(mbref);
   make<std::unique_ptr<MemoryBuffer>>(std::move(mb)); // take MB ownership
 
   if (tar)
     tar->append(relativeToRoot(path), mbref.getBuffer());
+  if (config->incremental)
+    recordIncrementalInput(path);
   return mbref;
 }
 
@@ -233,10 +269,31 @@ static std::string getSrcMsgAux(ObjFile<ELFT> &file, const Symbol &sym,
   return file.sourceFile;
 }
 
+void InputFile::ensureLocalSymbols() {
+  if (kind() != ObjKind)
+    return;
+  switch (config->ekind) {
+  default:
+    llvm_unreachable("Invalid kind");
+  case ELF32LEKind:
+    return cast<ObjFile<ELF32LE>>(this)->initializeLocalSymbols();
+  case ELF32BEKind:
+    return cast<ObjFile<ELF32BE>>(this)->initializeLocalSymbols();
+  case ELF64LEKind:
+    return cast<ObjFile<ELF64LE>>(this)->initializeLocalSymbols();
+  case ELF64BEKind:
+    return cast<ObjFile<ELF64BE>>(this)->initializeLocalSymbols();
+  }
+}
+
 std::string InputFile::getSrcMsg(const Symbol &sym, InputSectionBase &sec,
                                  uint64_t offset) {
   if (kind() != ObjKind)
     return "";
+  // The DWARF context resolves relocations against the symbols of this file
+  // and caches the result, so the local symbols must exist before it is
+  // created.
+  ensureLocalSymbols();
   switch (config->ekind) {
   default:
     llvm_unreachable("Invalid kind");
@@ -1046,10 +1103,19 @@ StringRef ObjFile<ELFT>::getSectionName(const Elf_Shdr &sec) {
 
 // Initialize this->Symbols. this->Symbols is a parallel array as
 // its corresponding ELF symbol table.
+//
+// Only global symbols are resolved here. Local symbols below firstGlobal are
+// created later by initializeLocalSymbols(), which does not touch the symbol
+// table and can therefore run for all files in parallel.
 template <class ELFT> void ObjFile<ELFT>::initializeSymbols() {
   ArrayRef<Elf_Sym> eSyms = this->getELFSyms<ELFT>();
   this->symbols.resize(eSyms.size());
 
+  // Memory for local symbols is allocated here because the arena allocator
+  // is not thread-safe.
+  if (this->firstGlobal)
+    localSymStorage = bAlloc.Allocate<SymbolUnion>(this->firstGlobal);
+
   // Our symbol table may have already been partially initialized
   // because of LazyObjFile.
   for (size_t i = 0, end = eSyms.size(); i != end; ++i)
@@ -1061,6 +1127,14 @@ template <class ELFT> void ObjFile<ELFT>::initializeSymbols() {
   for (size_t i = 0, end = eSyms.size(); i != end; ++i) {
     const Elf_Sym &eSym = eSyms[i];
 
+    // Locals in the local part of the symbol table are deferred. We still
+    // need STT_FILE, since it is used to report duplicate symbol errors.
+    if (i < this->firstGlobal && eSym.getBinding() == STB_LOCAL) {
+      if (eSym.getType() == STT_FILE)
+        sourceFile = CHECK(eSym.getName(this->stringTable), this);
+      continue;
+    }
+
     // Read symbol attributes.
     uint32_t secIdx = getSectionIndex(eSym);
     if (secIdx >= this->sections.size())
@@ -1135,13 +1209,63 @@ template <class ELFT> void ObjFile<ELFT>::initializeSymbols() {
   }
 }
 
+template <class ELFT> void ObjFile<ELFT>::initializeLocalSymbols() {
+  if (!localSymStorage)
+    return;
+
+  ArrayRef<Elf_Sym> eSyms = this->getELFSyms<ELFT>();
+  for (size_t i = 0, end = this->firstGlobal; i != end; ++i) {
+    const Elf_Sym &eSym = eSyms[i];
+    uint8_t binding = eSym.getBinding();
+    if (binding != STB_LOCAL)
+      continue;
+
+    uint32_t secIdx = getSectionIndex(eSym);
+    if (secIdx >= this->sections.size())
+      fatal(toString(this) + ": invalid section index: " + Twine(secIdx));
+    if (this->stringTable.size() <= eSym.st_name)
+      fatal(toString(this) + ": invalid symbol name offset");
+
+    InputSectionBase *sec = this->sections[secIdx];
+    uint8_t stOther = eSym.st_other;
+    uint8_t type = eSym.getType();
+    StringRefZ name = this->stringTable.data() + eSym.st_name;
+    void *mem = &localSymStorage[i];
+
+    if (eSym.st_shndx == SHN_UNDEF)
+      this->symbols[i] = new (mem) Undefined(this, name, binding, stOther, type);
+    else if (sec == &InputSection::discarded)
+      this->symbols[i] = new (mem) Undefined(this, name, binding, stOther, type,
+                                             /*DiscardedSecIdx=*/secIdx);
+    else
+      this->symbols[i] = new (mem) Defined(this, name, binding, stOther, type,
+                                           eSym.st_value, eSym.st_size, sec);
+  }
+  localSymStorage = nullptr;
+}
+
 ArchiveFile::ArchiveFile(std::unique_ptr<Archive> &&file)
     : InputFile(ArchiveKind, file->getMemoryBufferRef()),
       file(std::move(file)) {}
 
-void ArchiveFile::parse() {
+size_t ArchiveFile::readSymbols() {
+  if (symbolsRead)
+    return symbols.size();
+  symbolsRead = true;
+
+  symbols.reserve(file->getNumberOfSymbols());
   for (const Archive::Symbol &sym : file->symbols())
-    symtab->addSymbol(LazyArchive{*this, sym});
+    symbols.emplace_back(
+        sym, CachedHashStringRef(stripDefaultVersion(sym.getName())));
+  return symbols.size();
+}
+
+void ArchiveFile::parse() {
+  readSymbols();
+  for (const std::pair<Archive::Symbol, CachedHashStringRef> &p : symbols)
+    symtab->addSymbol(LazyArchive{*this, p.first}, p.second);
+  symbols.clear();
+  symbols.shrink_to_fit();
 }
 
 // Returns a buffer pointing to a member file containing a given symbol.
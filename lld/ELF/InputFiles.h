@@ -46,14 +46,26 @@ namespace elf {
 using llvm::object::Archive;
 
 class Symbol;
+union SymbolUnion;
 
 // If -reproduce option is given, all input files are written
 // to this tar archive.
 extern std::unique_ptr<llvm::TarWriter> tar;
 
+// Input files that are memory-mapped, in the order they were opened.
+// Pages of these buffers can be released with releaseMappedMemory().
+extern std::vector<MemoryBufferRef> mappedBuffers;
+
 // Opens a given file.
 llvm::Optional<MemoryBufferRef> readFile(StringRef path);
 
+// Starts reading a given file in the background. A later readFile() of the
+// same path returns its contents without waiting for the disk.
+void prefetchFile(StringRef path);
+
+// Discards the files prefetched but never read.
+void clearPrefetchedFiles();
+
 // Add symbols in File to the symbol table.
 void parseFile(InputFile *file);
 
@@ -114,6 +126,12 @@ public:
   std::string getSrcMsg(const Symbol &sym, InputSectionBase &sec,
                         uint64_t offset);
 
+  // Creates the local symbols of an object file if the driver has not done so
+  // yet. Diagnostics that can be reported during symbol resolution call this
+  // before they look at getSymbols() or at the relocations of .debug_*
+  // sections. It is a no-op for other kinds of files.
+  void ensureLocalSymbols();
+
   // True if this is an argument for --just-symbols. Usually false.
   bool justSymbols = false;
 
@@ -207,6 +225,12 @@ public:
 
   void parse(bool ignoreComdats = false);
 
+  // Creates symbol objects for local symbols. Local symbols are not added to
+  // the symbol table, so this is done after symbol resolution and is safe to
+  // call for different files in parallel. Calling it more than once for the
+  // same file is a no-op.
+  void initializeLocalSymbols();
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> sections,
                                  const Elf_Shdr &sec);
 
@@ -280,6 +304,10 @@ private:
   // .shstrtab contents.
   StringRef sectionStringTable;
 
+  // Storage for local symbols. It is allocated by initializeSymbols() and
+  // filled by initializeLocalSymbols(). Null once locals are initialized.
+  SymbolUnion *localSymStorage = nullptr;
+
   // Debugging information to retrieve source file and line for error
   // reporting. Linker may find reasonable number of errors in a
   // single object file, so we cache debugging information in order to
@@ -326,6 +354,12 @@ public:
   static bool classof(const InputFile *f) { return f->kind() == ArchiveKind; }
   void parse();
 
+  // Reads the archive symbol table and hashes the symbol names so that
+  // parse() only needs to insert them. This function does not touch the
+  // global symbol table, so it is safe to call for multiple archives in
+  // parallel. Returns the number of symbols.
+  size_t readSymbols();
+
   // Pulls out an object file that contains a definition for Sym and
   // returns it. If the same file was instantiated before, this
   // function does nothing (so we don't instantiate the same file
@@ -335,6 +369,10 @@ public:
 private:
   std::unique_ptr<Archive> file;
   llvm::DenseSet<uint64_t> seen;
+
+  // Symbols read by readSymbols() along with their hashed names.
+  std::vector<std::pair<Archive::Symbol, llvm::CachedHashStringRef>> symbols;
+  bool symbolsRead = false;
 };
 
 class BitcodeFile : public InputFile {
@@ -79,16 +79,12 @@ InputSectionBase::InputSectionBase(InputFile *file, uint64_t flags,
     fatal(toString(this) + ": sh_addralign is not a power of 2");
   this->alignment = v;
 
-  // In ELF, each section can be compressed by zlib, and if compressed,
-  // section name may be mangled by appending "z" (e.g. ".zdebug_info").
-  // If that's the case, demangle section name so that we can handle a
-  // section as if it weren't compressed.
-  if ((flags & SHF_COMPRESSED) || name.startswith(".zdebug")) {
-    if (!zlib::isAvailable())
-      error(toString(file) + ": contains a compressed section, " +
-            "but zlib is not available");
+  // In ELF, each section can be compressed by zlib or zstd, and if
+  // compressed, section name may be mangled by appending "z" (e.g.
+  // ".zdebug_info"). If that's the case, demangle section name so that we
+  // can handle a section as if it weren't compressed.
+  if ((flags & SHF_COMPRESSED) || name.startswith(".zdebug"))
     parseCompressedHeader();
-  }
 }
 
 // Drop SHF_GROUP bit unless we are producing a re-linkable object file.
@@ -142,6 +138,13 @@ size_t InputSectionBase::getSize() const {
   return rawData.size();
 }
 
+static Error uncompressSection(bool useZstd, StringRef in, char *out,
+                               size_t &size) {
+  if (useZstd)
+    return zstd::uncompress(in, out, size);
+  return zlib::uncompress(in, out, size);
+}
+
 void InputSectionBase::uncompress() const {
   size_t size = uncompressedSize;
   char *uncompressedBuf;
@@ -151,7 +154,8 @@ void InputSectionBase::uncompress() const {
     uncompressedBuf = bAlloc.Allocate<char>(size);
   }
 
-  if (Error e = zlib::uncompress(toStringRef(rawData), uncompressedBuf, size))
+  if (Error e = uncompressSection(compressedWithZstd, toStringRef(rawData),
+                                  uncompressedBuf, size))
     fatal(toString(this) +
           ": uncompress failed: " + llvm::toString(std::move(e)));
   rawData = makeArrayRef((uint8_t *)uncompressedBuf, size);
@@ -206,8 +210,29 @@ OutputSection *SectionBase::getOutputSection() {
   return sec ? sec->getParent() : nullptr;
 }
 
+// Returns true if sections compressed with the given ELFCOMPRESS_* type can
+// be read.
+static bool checkCompressionType(const InputSectionBase *sec, uint32_t type) {
+  if (type == ELFCOMPRESS_ZLIB) {
+    if (zlib::isAvailable())
+      return true;
+    error(toString(sec->file) + ": contains a compressed section, " +
+          "but zlib is not available");
+    return false;
+  }
+  if (type == ELFCOMPRESS_ZSTD) {
+    if (zstd::isAvailable())
+      return true;
+    error(toString(sec->file) + ": contains a compressed section, " +
+          "but zstd is not available");
+    return false;
+  }
+  error(toString(sec) + ": unsupported compression type");
+  return false;
+}
+
 // When a section is compressed, `rawData` consists with a header followed
-// by zlib-compressed data. This function parses a header to initialize
+// by zlib- or zstd-compressed data. This function parses a header to initialize
 // `uncompressedSize` member and remove the header from `rawData`.
 void InputSectionBase::parseCompressedHeader() {
   using Chdr64 = typename ELF64LE::Chdr;
@@ -215,6 +240,8 @@ void InputSectionBase::parseCompressedHeader() {
 
   // Old-style header
   if (name.startswith(".zdebug")) {
+    if (!checkCompressionType(this, ELFCOMPRESS_ZLIB))
+      return;
     if (!toStringRef(rawData).startswith("ZLIB")) {
       error(toString(this) + ": corrupted compressed section header");
       return;
@@ -246,10 +273,9 @@ void InputSectionBase::parseCompressedHeader() {
     }
 
     auto *hdr = reinterpret_cast<const Chdr64 *>(rawData.data());
-    if (hdr->ch_type != ELFCOMPRESS_ZLIB) {
-      error(toString(this) + ": unsupported compression type");
+    if (!checkCompressionType(this, hdr->ch_type))
       return;
-    }
+    compressedWithZstd = hdr->ch_type == ELFCOMPRESS_ZSTD;
 
     uncompressedSize = hdr->ch_size;
     alignment = std::max<uint32_t>(hdr->ch_addralign, 1);
@@ -264,10 +290,9 @@ void InputSectionBase::parseCompressedHeader() {
   }
 
   auto *hdr = reinterpret_cast<const Chdr32 *>(rawData.data());
-  if (hdr->ch_type != ELFCOMPRESS_ZLIB) {
-    error(toString(this) + ": unsupported compression type");
+  if (!checkCompressionType(this, hdr->ch_type))
     return;
-  }
+  compressedWithZstd = hdr->ch_type == ELFCOMPRESS_ZSTD;
 
   uncompressedSize = hdr->ch_size;
   alignment = std::max<uint32_t>(hdr->ch_addralign, 1);
@@ -345,7 +370,9 @@ std::string InputSectionBase::getObjMsg(uint64_t off) {
   if (!file->archiveName.empty())
     archive = " in archive " + file->archiveName;
 
-  // Find a symbol that encloses a given location.
+  // Find a symbol that encloses a given location. This can be called during
+  // symbol resolution, before local symbols are created.
+  file->ensureLocalSymbols();
   for (Symbol *b : file->getSymbols())
     if (auto *d = dyn_cast<Defined>(b))
       if (d->section == this && d->value <= off && off < d->value + d->size)
@@ -1122,8 +1149,8 @@ template <class ELFT> void InputSection::writeTo(uint8_t *buf) {
   // to the buffer.
   if (uncompressedSize >= 0) {
     size_t size = uncompressedSize;
-    if (Error e = zlib::uncompress(toStringRef(rawData),
-                                   (char *)(buf + outSecOff), size))
+    if (Error e = uncompressSection(compressedWithZstd, toStringRef(rawData),
+                                    (char *)(buf + outSecOff), size))
       fatal(toString(this) +
             ": uncompress failed: " + llvm::toString(std::move(e)));
     uint8_t *bufEnd = buf + outSecOff + size;
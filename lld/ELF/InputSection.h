@@ -54,7 +54,7 @@ public:
 
   unsigned sectionKind : 3;
 
-  // The next three bit fields are only used by InputSectionBase, but we
+  // The next four bit fields are only used by InputSectionBase, but we
   // put them here so the struct packs better.
 
   // True if this section has already been placed to a linker script
@@ -75,6 +75,9 @@ public:
   // Set for sections that should not be folded by ICF.
   unsigned keepUnique : 1;
 
+  // Set if the compressed contents of this section use zstd instead of zlib.
+  unsigned compressedWithZstd : 1;
+
   // The 1-indexed partition that this section is assigned to by the garbage
   // collector, or 0 if this section is dead. Normally there is only one
   // partition, so this will either be 0 or 1.
@@ -109,8 +112,9 @@ protected:
               uint64_t entsize, uint64_t alignment, uint32_t type,
               uint32_t info, uint32_t link)
       : name(name), repl(this), sectionKind(sectionKind), assigned(false),
-        bss(false), keepUnique(false), partition(0), alignment(alignment),
-        flags(flags), entsize(entsize), type(type), link(link), info(info) {}
+        bss(false), keepUnique(false), compressedWithZstd(false), partition(0),
+        alignment(alignment), flags(flags), entsize(entsize), type(type),
+        link(link), info(info) {}
 };
 
 // This corresponds to a section of an input file.
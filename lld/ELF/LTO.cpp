@@ -106,7 +106,11 @@ static lto::Config createConfig() {
   c.SampleProfile = config->ltoSampleProfile;
   c.UseNewPM = config->ltoNewPassManager;
   c.DebugPassManager = config->ltoDebugPassManager;
+  c.TimeTraceEnabled = config->timeTraceEnabled;
+  c.TimeTraceGranularity = config->timeTraceGranularity;
   c.DwoDir = config->dwoDir;
+  if (config->thinLTOCacheCodeGen)
+    c.CodeGenCacheDir = config->thinLTOCacheDir;
 
   c.CSIRProfile = config->ltoCSProfileFile;
   c.RunCSIRInstr = config->ltoCSProfileGenerate;
@@ -12,6 +12,7 @@
 
 #include "LinkerScript.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "InputSection.h"
 #include "OutputSections.h"
 #include "SymbolTable.h"
@@ -732,6 +733,11 @@ void LinkerScript::output(InputSection *s) {
   uint64_t pos = advance(s->getSize(), s->alignment);
   s->outSecOff = pos - s->getSize() - ctx->outSec->addr;
 
+  // With --incremental, leave room for the section to grow so that the next
+  // link can patch it in place.
+  if (config->incremental)
+    pos = advance(getIncrementalPadding(s), 1);
+
   // Update output section size after adding each section. This is so that
   // SIZEOF works correctly in the case below:
   // .foo { *(.aaa) a = SIZEOF(.foo); *(.bbb) }
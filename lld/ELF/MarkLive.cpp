@@ -29,6 +29,7 @@
 #include "Target.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
+#include "lld/Common/Threads.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Object/ELF.h"
 #include <functional>
@@ -43,6 +44,14 @@ using namespace lld;
 using namespace lld::elf;
 
 namespace {
+// A relocation edge out of a live section. The target section is null if the
+// edge does not keep any section alive by itself.
+struct LiveEdge {
+  Symbol *sym;
+  InputSectionBase *sec;
+  uint64_t offset;
+};
+
 template <class ELFT> class MarkLive {
 public:
   MarkLive(unsigned partition) : partition(partition) {}
@@ -54,9 +63,17 @@ private:
   void enqueue(InputSectionBase *sec, uint64_t offset);
   void markSymbol(Symbol *sym);
   void mark();
+  void markParallel();
 
   template <class RelTy>
-  void resolveReloc(InputSectionBase &sec, RelTy &rel, bool isLSDA);
+  LiveEdge getEdge(InputSectionBase &sec, RelTy &rel, bool isLSDA);
+  void markEdge(const LiveEdge &edge);
+  void collectEdges(InputSection &sec, std::vector<LiveEdge> &edges);
+
+  template <class RelTy>
+  void resolveReloc(InputSectionBase &sec, RelTy &rel, bool isLSDA) {
+    markEdge(getEdge(sec, rel, isLSDA));
+  }
 
   template <class RelTy>
   void scanEhFrameSection(EhInputSection &eh, ArrayRef<RelTy> rels);
@@ -86,26 +103,36 @@ static uint64_t getAddend(InputSectionBase &sec,
   return rel.r_addend;
 }
 
+// Computes the effect of a relocation without touching any shared state, so
+// that this function can be called from multiple threads at once.
 template <class ELFT>
 template <class RelTy>
-void MarkLive<ELFT>::resolveReloc(InputSectionBase &sec, RelTy &rel,
-                                  bool isLSDA) {
+LiveEdge MarkLive<ELFT>::getEdge(InputSectionBase &sec, RelTy &rel,
+                                 bool isLSDA) {
   Symbol &sym = sec.getFile<ELFT>()->getRelocTargetSym(rel);
 
-  // If a symbol is referenced in a live section, it is used.
-  sym.used = true;
-
   if (auto *d = dyn_cast<Defined>(&sym)) {
     auto *relSec = dyn_cast_or_null<InputSectionBase>(d->section);
-    if (!relSec)
-      return;
+    if (!relSec || (isLSDA && (relSec->flags & SHF_EXECINSTR)))
+      return {&sym, nullptr, 0};
 
     uint64_t offset = d->value;
     if (d->isSection())
       offset += getAddend<ELFT>(sec, rel);
+    return {&sym, relSec, offset};
+  }
+  return {&sym, nullptr, 0};
+}
+
+template <class ELFT> void MarkLive<ELFT>::markEdge(const LiveEdge &edge) {
+  Symbol &sym = *edge.sym;
+
+  // If a symbol is referenced in a live section, it is used.
+  sym.used = true;
 
-    if (!isLSDA || !(relSec->flags & SHF_EXECINSTR))
-      enqueue(relSec, offset);
+  if (isa<Defined>(sym)) {
+    if (edge.sec)
+      enqueue(edge.sec, edge.offset);
     return;
   }
 
@@ -268,9 +295,27 @@ template <class ELFT> void MarkLive<ELFT>::run() {
   mark();
 }
 
+template <class ELFT>
+void MarkLive<ELFT>::collectEdges(InputSection &sec,
+                                  std::vector<LiveEdge> &edges) {
+  if (sec.areRelocsRela) {
+    for (const typename ELFT::Rela &rel : sec.template relas<ELFT>())
+      edges.push_back(getEdge(sec, rel, false));
+  } else {
+    for (const typename ELFT::Rel &rel : sec.template rels<ELFT>())
+      edges.push_back(getEdge(sec, rel, false));
+  }
+}
+
 template <class ELFT> void MarkLive<ELFT>::mark() {
   // Mark all reachable sections.
   while (!queue.empty()) {
+    // If the worklist has grown large, process it as a whole in parallel.
+    if (queue.size() >= 64) {
+      markParallel();
+      continue;
+    }
+
     InputSectionBase &sec = *queue.pop_back_val();
 
     if (sec.areRelocsRela) {
@@ -286,6 +331,29 @@ template <class ELFT> void MarkLive<ELFT>::mark() {
   }
 }
 
+// Visits all sections in the current worklist at once. Reading relocations
+// and resolving their targets is what dominates the cost of the mark phase,
+// and it does not depend on the liveness state, so we do that part in
+// parallel. The resulting edges are then applied serially in a fixed order,
+// which keeps Live bits, partition assignments and section piece liveness
+// free of data races and makes the outcome independent of the thread count.
+template <class ELFT> void MarkLive<ELFT>::markParallel() {
+  SmallVector<InputSection *, 256> frontier;
+  std::swap(frontier, queue);
+
+  std::vector<std::vector<LiveEdge>> edges(frontier.size());
+  parallelForEachN(0, frontier.size(), [&](size_t i) {
+    collectEdges(*frontier[i], edges[i]);
+  });
+
+  for (size_t i = 0, e = frontier.size(); i < e; ++i) {
+    for (const LiveEdge &edge : edges[i])
+      markEdge(edge);
+    for (InputSectionBase *isec : frontier[i]->dependentSections)
+      enqueue(isec, 0);
+  }
+}
+
 // Move the sections for some symbols to the main partition, specifically ifuncs
 // (because they can result in an IRELATIVE being added to the main partition's
 // GOT, which means that the ifunc must be available when the main partition is
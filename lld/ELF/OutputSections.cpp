@@ -8,6 +8,7 @@
 
 #include "OutputSections.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "LinkerScript.h"
 #include "SymbolTable.h"
 #include "SyntheticSections.h"
@@ -175,26 +176,36 @@ static void fill(uint8_t *buf, size_t size,
   memcpy(buf + i, filler.data(), size - i);
 }
 
+static Error compressDebugSection(StringRef data, SmallVectorImpl<char> &out,
+                                  unsigned threads) {
+  // zstd can split large sections between several threads.
+  if (config->compressDebugSections == CompressionType::Zstd)
+    return zstd::compress(data, out, zstd::DefaultCompression, threads);
+  return zlib::compress(data, out);
+}
+
 // Compress section contents if this section contains debug info.
-template <class ELFT> void OutputSection::maybeCompress() {
+template <class ELFT> void OutputSection::maybeCompress(unsigned threads) {
   using Elf_Chdr = typename ELFT::Chdr;
 
   // Compress only DWARF debug sections.
-  if (!config->compressDebugSections || (flags & SHF_ALLOC) ||
-      !name.startswith(".debug_"))
+  if (config->compressDebugSections == CompressionType::None ||
+      (flags & SHF_ALLOC) || !name.startswith(".debug_"))
     return;
 
   // Create a section header.
   zDebugHeader.resize(sizeof(Elf_Chdr));
   auto *hdr = reinterpret_cast<Elf_Chdr *>(zDebugHeader.data());
-  hdr->ch_type = ELFCOMPRESS_ZLIB;
+  hdr->ch_type = config->compressDebugSections == CompressionType::Zstd
+                     ? ELFCOMPRESS_ZSTD
+                     : ELFCOMPRESS_ZLIB;
   hdr->ch_size = size;
   hdr->ch_addralign = alignment;
 
   // Write section contents to a temporary buffer and compress it.
   std::vector<uint8_t> buf(size);
   writeTo<ELFT>(buf.data());
-  if (Error e = zlib::compress(toStringRef(buf), compressedData))
+  if (Error e = compressDebugSection(toStringRef(buf), compressedData, threads))
     fatal("compress failed: " + llvm::toString(std::move(e)));
 
   // Update section headers.
@@ -259,6 +270,35 @@ template <class ELFT> void OutputSection::writeTo(uint8_t *buf) {
       writeInt(buf + data->offset, data->expression().getValue(), data->size);
 }
 
+// Rewrites the input sections that may have changed since the previous link
+// in the output of that link. Unlike writeTo(), this cannot assume that the
+// buffer is zero-filled, so each rewritten section is cleared first.
+template <class ELFT> void OutputSection::patchTo(uint8_t *buf) {
+  if (type == SHT_NOBITS)
+    return;
+
+  std::vector<InputSection *> sections = getInputSections(this);
+  std::array<uint8_t, 4> filler = getFiller();
+  bool nonZeroFiller = read32(filler.data()) != 0;
+
+  parallelForEachN(0, sections.size(), [&](size_t i) {
+    InputSection *isec = sections[i];
+    if (!needsIncrementalRewrite(isec))
+      return;
+
+    uint8_t *start = buf + isec->outSecOff + isec->getSize();
+    uint8_t *end;
+    if (i + 1 == sections.size())
+      end = buf + size;
+    else
+      end = buf + sections[i + 1]->outSecOff;
+    memset(buf + isec->outSecOff, 0, end - (buf + isec->outSecOff));
+    isec->writeTo<ELFT>(buf);
+    if (nonZeroFiller)
+      fill(start, end - start, filler);
+  });
+}
+
 static void finalizeShtGroup(OutputSection *os,
                              InputSection *section) {
   assert(config->relocatable);
@@ -415,7 +455,12 @@ template void OutputSection::writeTo<ELF32BE>(uint8_t *Buf);
 template void OutputSection::writeTo<ELF64LE>(uint8_t *Buf);
 template void OutputSection::writeTo<ELF64BE>(uint8_t *Buf);
 
-template void OutputSection::maybeCompress<ELF32LE>();
-template void OutputSection::maybeCompress<ELF32BE>();
-template void OutputSection::maybeCompress<ELF64LE>();
-template void OutputSection::maybeCompress<ELF64BE>();
+template void OutputSection::patchTo<ELF32LE>(uint8_t *Buf);
+template void OutputSection::patchTo<ELF32BE>(uint8_t *Buf);
+template void OutputSection::patchTo<ELF64LE>(uint8_t *Buf);
+template void OutputSection::patchTo<ELF64BE>(uint8_t *Buf);
+
+template void OutputSection::maybeCompress<ELF32LE>(unsigned);
+template void OutputSection::maybeCompress<ELF32BE>(unsigned);
+template void OutputSection::maybeCompress<ELF64LE>(unsigned);
+template void OutputSection::maybeCompress<ELF64BE>(unsigned);
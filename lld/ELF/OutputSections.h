@@ -100,7 +100,10 @@ public:
 
   void finalize();
   template <class ELFT> void writeTo(uint8_t *buf);
-  template <class ELFT> void maybeCompress();
+  template <class ELFT> void patchTo(uint8_t *buf);
+  // Compresses a .debug_* section. With zstd, up to the given number of
+  // worker threads are used.
+  template <class ELFT> void maybeCompress(unsigned threads);
 
   void sort(llvm::function_ref<int(InputSectionBase *s)> order);
   void sortInitFini();
@@ -52,8 +52,11 @@
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
+#include "lld/Common/Threads.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 
@@ -1379,15 +1382,109 @@ static void scanReloc(InputSectionBase &sec, OffsetGetter &getOffset, RelTy *&i,
   processRelocAux<ELFT>(sec, expr, type, offset, sym, rel, addend);
 }
 
+namespace {
+// Relocations that were fully handled by prescanRelocs(). A relocation
+// that is in `handled` but not in `relocs` has no effect (e.g. it refers to
+// a garbage-collected .eh_frame piece or is a relaxation hint).
+struct PrescannedRelocs {
+  llvm::BitVector handled;
+  std::vector<std::pair<size_t, Relocation>> relocs;
+};
+} // namespace
+
+// Returns true if scanReloc() would do nothing but append {Expr, Type,
+// Offset, Addend, Sym} to Sec.relocations for a given relocation. Such
+// relocations don't need GOT, PLT, copy relocations, dynamic relocations or
+// undefined symbol diagnostics, so they can be processed without looking at
+// any state shared between input sections. This is by far the most common
+// case, e.g. a PC-relative call to a non-preemptible function.
+template <class ELFT, class RelTy>
+static bool prescanReloc(InputSectionBase &sec, OffsetGetter &getOffset,
+                         const RelTy &rel, const RelTy *end,
+                         Optional<Relocation> &out) {
+  uint32_t symIndex = rel.getSymbol(config->isMips64EL);
+  Symbol &sym = sec.getFile<ELFT>()->getSymbol(symIndex);
+  if (!sym.isDefined() || sym.isPreemptible || sym.isGnuIFunc() ||
+      sym.isTls())
+    return false;
+
+  uint64_t offset = getOffset.get(rel.r_offset);
+  if (offset == uint64_t(-1))
+    return true;
+
+  RelType type = rel.getType(config->isMips64EL);
+  const uint8_t *relocatedAddr = sec.data().begin() + rel.r_offset;
+  RelExpr expr = target->getRelExpr(type, sym, relocatedAddr);
+  if (oneof<R_HINT, R_NONE>(expr))
+    return true;
+
+  int64_t addend = computeAddend<ELFT>(rel, end, sec, expr, sym.isLocal());
+
+  // Same as the relaxation in scanReloc(). The symbol is known to be
+  // non-preemptible and not an ifunc here.
+  if (expr == R_GOT_PC && !isAbsoluteValue(sym))
+    expr = target->adjustRelaxExpr(type, relocatedAddr, expr);
+  else
+    expr = fromPlt(expr);
+
+  if (!oneof<R_ABS, R_PC, R_SIZE, R_AARCH64_PAGE_PC, R_RELAX_GOT_PC,
+             R_RELAX_GOT_PC_NOPIC>(expr))
+    return false;
+
+  // This is a subset of isStaticLinkTimeConstant() that never reports an
+  // error.
+  if (config->isPic && expr != R_SIZE &&
+      isAbsoluteValue(sym) == isRelExpr(expr))
+    return false;
+
+  out = Relocation{expr, type, offset, addend, &sym};
+  return true;
+}
+
+// Runs prescanReloc() for all relocations of a given section. This function
+// is called from parallelForEach, so it must be thread-safe.
 template <class ELFT, class RelTy>
-static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
+static void prescanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels,
+                          PrescannedRelocs &res) {
+  OffsetGetter getOffset(sec);
+  res.handled.resize(rels.size());
+  for (size_t i = 0, e = rels.size(); i != e; ++i) {
+    Optional<Relocation> r;
+    if (!prescanReloc<ELFT>(sec, getOffset, rels[i], rels.end(), r))
+      continue;
+    res.handled.set(i);
+    if (r)
+      res.relocs.push_back({i, *r});
+  }
+}
+
+template <class ELFT, class RelTy>
+static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels,
+                       const PrescannedRelocs *pre) {
   OffsetGetter getOffset(sec);
 
   // Not all relocations end up in Sec.Relocations, but a lot do.
   sec.relocations.reserve(rels.size());
 
-  for (auto i = rels.begin(), end = rels.end(); i != end;)
+  // Relocations are visited in their original order, so the result is the
+  // same as if none were prescanned. Note that scanReloc() may consume more
+  // than one relocation.
+  size_t next = 0;
+  for (auto i = rels.begin(), end = rels.end(); i != end;) {
+    size_t idx = i - rels.begin();
+    if (pre && pre->handled[idx]) {
+      if (next < pre->relocs.size() && pre->relocs[next].first == idx)
+        sec.relocations.push_back(pre->relocs[next++].second);
+      ++i;
+      continue;
+    }
+
     scanReloc<ELFT>(sec, getOffset, i, end);
+    if (pre)
+      while (next < pre->relocs.size() &&
+             pre->relocs[next].first < size_t(i - rels.begin()))
+        ++next;
+  }
 
   // Sort relocations by offset for more efficient searching for
   // R_RISCV_PCREL_HI20 and R_PPC64_ADDR64.
@@ -1399,11 +1496,43 @@ static void scanRelocs(InputSectionBase &sec, ArrayRef<RelTy> rels) {
                       });
 }
 
-template <class ELFT> void elf::scanRelocations(InputSectionBase &s) {
-  if (s.areRelocsRela)
-    scanRelocs<ELFT>(s, s.relas<ELFT>());
-  else
-    scanRelocs<ELFT>(s, s.rels<ELFT>());
+// Scanning relocations is done in two passes. The first pass handles
+// relocations that don't need any shared state in parallel. The second,
+// serial pass handles the rest (GOT, PLT, copy relocations, dynamic
+// relocations and undefined symbols), merging the results of the first pass
+// in the original relocation order so that the output is deterministic.
+//
+// MIPS and PowerPC have target-specific GOT and TOC handling that is
+// interleaved with relocation scanning, so they always use the serial pass.
+template <class ELFT>
+void elf::scanRelocations(ArrayRef<InputSectionBase *> sections) {
+  llvm::TimeTraceScope timeScope("Scan relocations", StringRef(""));
+  bool canPrescan = config->emachine != EM_MIPS &&
+                    config->emachine != EM_PPC && config->emachine != EM_PPC64;
+
+  std::vector<PrescannedRelocs> pre;
+  if (canPrescan) {
+    pre.resize(sections.size());
+    parallelForEachN(0, sections.size(), [&](size_t i) {
+      InputSectionBase &s = *sections[i];
+      if (s.areRelocsRela)
+        prescanRelocs<ELFT>(s, s.relas<ELFT>(), pre[i]);
+      else
+        prescanRelocs<ELFT>(s, s.rels<ELFT>(), pre[i]);
+    });
+  }
+
+  for (size_t i = 0, e = sections.size(); i != e; ++i) {
+    InputSectionBase &s = *sections[i];
+    const PrescannedRelocs *p = canPrescan ? &pre[i] : nullptr;
+    if (s.areRelocsRela)
+      scanRelocs<ELFT>(s, s.relas<ELFT>(), p);
+    else
+      scanRelocs<ELFT>(s, s.rels<ELFT>(), p);
+    // Free memory as we go.
+    if (p)
+      pre[i] = PrescannedRelocs();
+  }
 }
 
 static bool mergeCmp(const InputSection *a, const InputSection *b) {
@@ -1767,55 +1896,81 @@ bool ThunkCreator::createThunks(ArrayRef<OutputSection *> outputSections) {
   if (pass == 0 && target->getThunkSectionSpacing())
     createInitialThunkSections(outputSections);
 
+  std::vector<std::pair<OutputSection *, InputSectionDescription *>> isds;
+  std::vector<InputSection *> sections;
+  forEachInputSectionDescription(
+      outputSections, [&](OutputSection *os, InputSectionDescription *isd) {
+        isds.push_back({os, isd});
+        sections.insert(sections.end(), isd->sections.begin(),
+                        isd->sections.end());
+      });
+
+  // Find the relocations that need a Thunk or that refer to an existing one.
+  // Addresses don't change until the ThunkSections are merged below, so these
+  // range checks are independent of each other and can run in parallel. Most
+  // relocations are rejected here, which leaves few to be examined serially.
+  std::vector<std::vector<Relocation *>> candidates(sections.size());
+  parallelForEachN(0, sections.size(), [&](size_t i) {
+    InputSection *isec = sections[i];
+    for (Relocation &rel : isec->relocations)
+      if ((pass > 0 && thunks.count(rel.sym)) ||
+          target->needsThunk(rel.expr, rel.type, isec->file,
+                             isec->getVA(rel.offset), *rel.sym))
+        candidates[i].push_back(&rel);
+  });
+
   // Create all the Thunks and insert them into synthetic ThunkSections. The
   // ThunkSections are later inserted back into InputSectionDescriptions.
   // We separate the creation of ThunkSections from the insertion of the
   // ThunkSections as ThunkSections are not always inserted into the same
-  // InputSectionDescription as the caller.
-  forEachInputSectionDescription(
-      outputSections, [&](OutputSection *os, InputSectionDescription *isd) {
-        for (InputSection *isec : isd->sections)
-          for (Relocation &rel : isec->relocations) {
-            uint64_t src = isec->getVA(rel.offset);
-
-            // If we are a relocation to an existing Thunk, check if it is
-            // still in range. If not then Rel will be altered to point to its
-            // original target so another Thunk can be generated.
-            if (pass > 0 && normalizeExistingThunk(rel, src))
-              continue;
-
-            if (!target->needsThunk(rel.expr, rel.type, isec->file, src,
-                                    *rel.sym))
-              continue;
-
-            Thunk *t;
-            bool isNew;
-            std::tie(t, isNew) = getThunk(isec, rel, src);
-
-            if (isNew) {
-              // Find or create a ThunkSection for the new Thunk
-              ThunkSection *ts;
-              if (auto *tis = t->getTargetInputSection())
-                ts = getISThunkSec(tis);
-              else
-                ts = getISDThunkSec(os, isec, isd, rel.type, src);
-              ts->addThunk(t);
-              thunks[t->getThunkTargetSym()] = t;
-            }
-
-            // Redirect relocation to Thunk, we never go via the PLT to a Thunk
-            rel.sym = t->getThunkTargetSym();
-            rel.expr = fromPlt(rel.expr);
-
-            // The addend of R_PPC_PLTREL24 should be ignored after changing to
-            // R_PC.
-            if (config->emachine == EM_PPC && rel.type == R_PPC_PLTREL24)
-              rel.addend = 0;
-          }
+  // InputSectionDescription as the caller. This is done serially and in
+  // section order, as Thunks are shared between callers.
+  size_t secIdx = 0;
+  for (const auto &osAndIsd : isds) {
+    OutputSection *os = osAndIsd.first;
+    InputSectionDescription *isd = osAndIsd.second;
+    for (InputSection *isec : isd->sections)
+      for (Relocation *r : candidates[secIdx++]) {
+        Relocation &rel = *r;
+        uint64_t src = isec->getVA(rel.offset);
+
+        // If we are a relocation to an existing Thunk, check if it is
+        // still in range. If not then Rel will be altered to point to its
+        // original target so another Thunk can be generated.
+        if (pass > 0 && normalizeExistingThunk(rel, src))
+          continue;
+
+        if (!target->needsThunk(rel.expr, rel.type, isec->file, src, *rel.sym))
+          continue;
+
+        Thunk *t;
+        bool isNew;
+        std::tie(t, isNew) = getThunk(isec, rel, src);
+
+        if (isNew) {
+          // Find or create a ThunkSection for the new Thunk
+          ThunkSection *ts;
+          if (auto *tis = t->getTargetInputSection())
+            ts = getISThunkSec(tis);
+          else
+            ts = getISDThunkSec(os, isec, isd, rel.type, src);
+          ts->addThunk(t);
+          thunks[t->getThunkTargetSym()] = t;
+        }
 
-        for (auto &p : isd->thunkSections)
-          addressesChanged |= p.first->assignOffsets();
-      });
+        // Redirect relocation to Thunk, we never go via the PLT to a Thunk
+        rel.sym = t->getThunkTargetSym();
+        rel.expr = fromPlt(rel.expr);
+
+        // The addend of R_PPC_PLTREL24 should be ignored after changing to
+        // R_PC.
+        if (config->emachine == EM_PPC && rel.type == R_PPC_PLTREL24)
+          rel.addend = 0;
+      }
+
+    for (auto &p : isd->thunkSections)
+      addressesChanged |= p.first->assignOffsets();
+  }
 
   for (auto &p : thunkedSections)
     addressesChanged |= p.second->assignOffsets();
@@ -1826,10 +1981,10 @@ bool ThunkCreator::createThunks(ArrayRef<OutputSection *> outputSections) {
   return addressesChanged;
 }
 
-template void elf::scanRelocations<ELF32LE>(InputSectionBase &);
-template void elf::scanRelocations<ELF32BE>(InputSectionBase &);
-template void elf::scanRelocations<ELF64LE>(InputSectionBase &);
-template void elf::scanRelocations<ELF64BE>(InputSectionBase &);
+template void elf::scanRelocations<ELF32LE>(ArrayRef<InputSectionBase *>);
+template void elf::scanRelocations<ELF32BE>(ArrayRef<InputSectionBase *>);
+template void elf::scanRelocations<ELF64LE>(ArrayRef<InputSectionBase *>);
+template void elf::scanRelocations<ELF64BE>(ArrayRef<InputSectionBase *>);
 template void elf::reportUndefinedSymbols<ELF32LE>();
 template void elf::reportUndefinedSymbols<ELF32BE>();
 template void elf::reportUndefinedSymbols<ELF64LE>();
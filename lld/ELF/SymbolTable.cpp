@@ -51,17 +51,14 @@ void SymbolTable::wrap(Symbol *sym, Symbol *real, Symbol *wrap) {
 
 // Find an existing symbol or create a new one.
 Symbol *SymbolTable::insert(StringRef name) {
-  // <name>@@<version> means the symbol is the default version. In that
-  // case <name>@@<version> will be used to resolve references to <name>.
-  //
-  // Since this is a hot path, the following string search code is
-  // optimized for speed. StringRef::find(char) is much faster than
-  // StringRef::find(StringRef).
-  size_t pos = name.find('@');
-  if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
-    name = name.take_front(pos);
-
-  auto p = symMap.insert({CachedHashStringRef(name), (int)symVector.size()});
+  return insert(CachedHashStringRef(stripDefaultVersion(name)));
+}
+
+// Same as above, but takes a name whose hash value has already been
+// computed. The name must not have a default version suffix.
+Symbol *SymbolTable::insert(CachedHashStringRef cachedName) {
+  StringRef name = cachedName.val();
+  auto p = symMap.insert({cachedName, (int)symVector.size()});
   int &symIndex = p.first->second;
   bool isNew = p.second;
 
@@ -94,6 +91,12 @@ Symbol *SymbolTable::addSymbol(const Symbol &newSym) {
   return sym;
 }
 
+Symbol *SymbolTable::addSymbol(const Symbol &newSym, CachedHashStringRef name) {
+  Symbol *sym = symtab->insert(name);
+  sym->resolve(newSym);
+  return sym;
+}
+
 Symbol *SymbolTable::find(StringRef name) {
   auto it = symMap.find(CachedHashStringRef(name));
   if (it == symMap.end())
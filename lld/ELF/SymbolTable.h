@@ -42,8 +42,16 @@ public:
   }
 
   Symbol *insert(StringRef name);
+  Symbol *insert(llvm::CachedHashStringRef name);
 
   Symbol *addSymbol(const Symbol &newSym);
+  Symbol *addSymbol(const Symbol &newSym, llvm::CachedHashStringRef name);
+
+  // Makes room for N more symbols so that bulk insertions do not rehash.
+  void reserve(size_t n) {
+    symMap.reserve(symMap.size() + n);
+    symVector.reserve(symVector.size() + n);
+  }
 
   void scanVersionScript();
 
@@ -87,6 +95,19 @@ private:
 
 extern SymbolTable *symtab;
 
+// <name>@@<version> means the symbol is the default version. In that
+// case <name>@@<version> will be used to resolve references to <name>.
+//
+// Since this is a hot path, the following string search code is
+// optimized for speed. StringRef::find(char) is much faster than
+// StringRef::find(StringRef).
+inline StringRef stripDefaultVersion(StringRef name) {
+  size_t pos = name.find('@');
+  if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
+    return name.take_front(pos);
+  return name;
+}
+
 } // namespace elf
 } // namespace lld
 
@@ -3039,31 +3039,92 @@ void MergeSyntheticSection::addSection(MergeInputSection *ms) {
 
 MergeTailSection::MergeTailSection(StringRef name, uint32_t type,
                                    uint64_t flags, uint32_t alignment)
-    : MergeSyntheticSection(name, type, flags, alignment),
-      builder(StringTableBuilder::RAW, alignment) {}
+    : MergeSyntheticSection(name, type, flags, alignment) {}
 
-size_t MergeTailSection::getSize() const { return builder.getSize(); }
+size_t MergeTailSection::getShardId(StringRef s, size_t entSize) {
+  // S includes its null terminator. An empty string is a suffix of any
+  // string, so it can go to any shard.
+  if (s.size() < entSize * 2)
+    return 0;
+  size_t id = 0;
+  for (char c : s.substr(s.size() - entSize * 2, entSize))
+    id = id * 31 + (uint8_t)c;
+  return id % numShards;
+}
 
-void MergeTailSection::writeTo(uint8_t *buf) { builder.write(buf); }
+void MergeTailSection::writeTo(uint8_t *buf) {
+  for (size_t i = 0; i < numShards; ++i)
+    shards[i].write(buf + shardOffsets[i]);
+}
 
+// Tail merging (StringTableBuilder::finalize) is much slower than plain
+// deduplication because it sorts all strings by their reversed contents.
+// Strings in different shards can never be tail-merged with each other, so
+// we sort and merge shards in parallel. Shard IDs depend only on string
+// contents, so the output does not depend on the number of threads.
 void MergeTailSection::finalizeContents() {
-  // Add all string pieces to the string table builder to create section
-  // contents.
-  for (MergeInputSection *sec : sections)
-    for (size_t i = 0, e = sec->pieces.size(); i != e; ++i)
-      if (sec->pieces[i].live)
-        builder.add(sec->getData(i));
+  for (size_t i = 0; i < numShards; ++i)
+    shards.emplace_back(StringTableBuilder::RAW, alignment);
+
+  // Compute a shard ID for each piece once, since we need it three times.
+  std::vector<std::vector<uint8_t>> shardIds(sections.size());
+  parallelForEachN(0, sections.size(), [&](size_t i) {
+    MergeInputSection *sec = sections[i];
+    shardIds[i].resize(sec->pieces.size());
+    for (size_t j = 0, e = sec->pieces.size(); j != e; ++j)
+      if (sec->pieces[j].live)
+        shardIds[i][j] = getShardId(sec->getData(j).val(), sec->entsize);
+  });
+
+  // Concurrency level. Must be a power of 2 to avoid expensive modulo
+  // operations in the following tight loop.
+  size_t concurrency = 1;
+  if (threadsEnabled)
+    concurrency =
+        std::min<size_t>(PowerOf2Floor(hardware_concurrency()), numShards);
+
+  // Add all string pieces to the string table builders. To make the output
+  // deterministic, strings are added to each shard in input order.
+  parallelForEachN(0, concurrency, [&](size_t threadId) {
+    for (size_t i = 0, e = sections.size(); i != e; ++i) {
+      MergeInputSection *sec = sections[i];
+      for (size_t j = 0, f = sec->pieces.size(); j != f; ++j) {
+        if (!sec->pieces[j].live)
+          continue;
+        size_t shardId = shardIds[i][j];
+        if ((shardId & (concurrency - 1)) == threadId)
+          shards[shardId].add(sec->getData(j));
+      }
+    }
+  });
 
-  // Fix the string table content. After this, the contents will never change.
-  builder.finalize();
+  // Fix the string table contents. After this, the contents will never
+  // change.
+  parallelForEachN(0, numShards, [&](size_t i) { shards[i].finalize(); });
+
+  // Compute an in-section offset for each shard.
+  size_t off = 0;
+  for (size_t i = 0; i < numShards; ++i) {
+    if (shards[i].getSize() > 0)
+      off = alignTo(off, alignment);
+    shardOffsets[i] = off;
+    off += shards[i].getSize();
+  }
+  size = off;
 
   // finalize() fixed tail-optimized strings, so we can now get
   // offsets of strings. Get an offset for each string and save it
   // to a corresponding SectionPiece for easy access.
-  for (MergeInputSection *sec : sections)
-    for (size_t i = 0, e = sec->pieces.size(); i != e; ++i)
-      if (sec->pieces[i].live)
-        sec->pieces[i].outputOff = builder.getOffset(sec->getData(i));
+  parallelForEachN(0, sections.size(), [&](size_t i) {
+    MergeInputSection *sec = sections[i];
+    for (size_t j = 0, e = sec->pieces.size(); j != e; ++j) {
+      if (!sec->pieces[j].live)
+        continue;
+      size_t shardId = shardIds[i][j];
+      sec->pieces[j].outputOff =
+          shardOffsets[shardId] + shards[shardId].getOffset(sec->getData(j));
+    }
+  });
 }
 
 void MergeNoTailSection::writeTo(uint8_t *buf) {
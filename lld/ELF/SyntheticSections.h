@@ -851,12 +851,23 @@ public:
   MergeTailSection(StringRef name, uint32_t type, uint64_t flags,
                    uint32_t alignment);
 
-  size_t getSize() const override;
+  size_t getSize() const override { return size; }
   void writeTo(uint8_t *buf) override;
   void finalizeContents() override;
 
 private:
-  llvm::StringTableBuilder builder;
+  // A string can only be a suffix of another string if both end with the
+  // same character, so we shard strings by their last character and
+  // tail-merge each shard independently.
+  static size_t getShardId(llvm::StringRef s, size_t entSize);
+
+  // Section size
+  size_t size;
+
+  // String table contents
+  constexpr static size_t numShards = 32;
+  std::vector<llvm::StringTableBuilder> shards;
+  size_t shardOffsets[numShards];
 };
 
 class MergeNoTailSection final : public MergeSyntheticSection {
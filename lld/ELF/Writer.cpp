@@ -10,6 +10,7 @@
 #include "AArch64ErrataFix.h"
 #include "CallGraphSort.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "LinkerScript.h"
 #include "MapFile.h"
 #include "OutputSections.h"
@@ -26,6 +27,8 @@
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/RandomNumberGenerator.h"
 #include "llvm/Support/SHA1.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
 #include <climits>
 
@@ -70,6 +73,7 @@ private:
   void checkSections();
   void fixSectionAlignments();
   void openFile();
+  bool patchFile();
   void writeTrapInstr();
   void writeHeader();
   void writeSections();
@@ -551,9 +555,11 @@ template <class ELFT> void Writer<ELFT>::run() {
 
   // If -compressed-debug-sections is specified, we need to compress
   // .debug_* sections. Do it right now because it changes the size of
-  // output sections.
+  // output sections. Sections are compressed one at a time, so zstd can give
+  // each of them a worker per core without oversubscribing the machine.
+  unsigned compressThreads = threadsEnabled ? hardware_concurrency() : 1;
   for (OutputSection *sec : outputSections)
-    sec->maybeCompress<ELFT>();
+    sec->maybeCompress<ELFT>(compressThreads);
 
   script->allocateHeaders(mainPart->phdrs);
 
@@ -581,6 +587,12 @@ template <class ELFT> void Writer<ELFT>::run() {
   // It does not make sense try to open the file if we have error already.
   if (errorCount())
     return;
+
+  // With --incremental, the output of the previous link may differ from this
+  // one only in the contents of some sections. If so, rewrite just those.
+  if (config->incremental && canPatchOutput() && patchFile())
+    return;
+
   // Write the result down to a file.
   openFile();
   if (errorCount())
@@ -1722,7 +1734,9 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
   // after processSymbolAssignments() because it needs to know whether a
   // linker-script-defined symbol is absolute.
   if (!config->relocatable) {
-    forEachRelSec(scanRelocations<ELFT>);
+    std::vector<InputSectionBase *> relSecs;
+    forEachRelSec([&](InputSectionBase &s) { relSecs.push_back(&s); });
+    scanRelocations<ELFT>(relSecs);
     reportUndefinedSymbols<ELFT>();
   }
 
@@ -2580,6 +2594,47 @@ template <class ELFT> void Writer<ELFT>::openFile() {
   Out::bufferStart = buffer->getBufferStart();
 }
 
+// Rewrites the sections that may have changed since the previous link in the
+// existing output file. Returns false if the file cannot be opened, in which
+// case the caller writes a new one.
+template <class ELFT> bool Writer<ELFT>::patchFile() {
+  Expected<std::unique_ptr<FileOutputBuffer>> bufferOrErr =
+      FileOutputBuffer::create(config->outputFile, fileSize,
+                               FileOutputBuffer::F_modify);
+  if (!bufferOrErr) {
+    log("--incremental: cannot patch " + config->outputFile + ": " +
+        llvm::toString(bufferOrErr.takeError()));
+    return false;
+  }
+  buffer = std::move(*bufferOrErr);
+  Out::bufferStart = buffer->getBufferStart();
+
+  // The sections at the end of the file may have moved. Clear them and the
+  // section header table as if this were a new file.
+  if (uint64_t off = getIncrementalTailOffset())
+    memset(Out::bufferStart + off, 0, fileSize - off);
+
+  writeHeader();
+  for (OutputSection *sec : outputSections)
+    if (sec->type == SHT_REL || sec->type == SHT_RELA)
+      sec->patchTo<ELFT>(Out::bufferStart + sec->offset);
+  for (OutputSection *sec : outputSections)
+    if (sec->type != SHT_REL && sec->type != SHT_RELA)
+      sec->patchTo<ELFT>(Out::bufferStart + sec->offset);
+
+  // The build ID is a hash of the whole file, which now includes the
+  // sections written by the previous link.
+  writeBuildId();
+  if (errorCount())
+    return true;
+
+  if (auto e = buffer->commit())
+    error("failed to write to the output file: " + toString(std::move(e)));
+  else
+    log("--incremental: patched " + config->outputFile);
+  return true;
+}
+
 template <class ELFT> void Writer<ELFT>::writeSectionsBinary() {
   for (OutputSection *sec : outputSections)
     if (sec->flags & SHF_ALLOC)
@@ -2624,8 +2679,63 @@ template <class ELFT> void Writer<ELFT>::writeTrapInstr() {
   }
 }
 
+namespace {
+// For --release-inputs. Keeps track of how many sections of each input file
+// are yet to be written, and releases the pages of an input file once all of
+// its sections were copied to the output. This bounds the peak memory usage
+// of links with large inputs (e.g. debug info) to roughly the working set of
+// the output sections being written rather than all inputs.
+class InputReleaser {
+public:
+  InputReleaser();
+  void release(OutputSection *sec);
+
+private:
+  bool isMapped(StringRef buf) const;
+
+  std::vector<MemoryBufferRef> buffers;
+  DenseMap<InputFile *, size_t> numPending;
+};
+} // namespace
+
+InputReleaser::InputReleaser() : buffers(mappedBuffers) {
+  llvm::sort(buffers, [](MemoryBufferRef a, MemoryBufferRef b) {
+    return a.getBufferStart() < b.getBufferStart();
+  });
+
+  for (OutputSection *sec : outputSections)
+    for (InputSection *isec : getInputSections(sec))
+      if (isec->file)
+        ++numPending[isec->file];
+}
+
+// Returns true if Buf is part of a buffer that is memory-mapped from a file.
+// Other buffers (e.g. standard input) must never be released.
+bool InputReleaser::isMapped(StringRef buf) const {
+  auto it = llvm::upper_bound(buffers, buf.begin(),
+                              [](const char *p, MemoryBufferRef mb) {
+                                return p < mb.getBufferStart();
+                              });
+  if (it == buffers.begin())
+    return false;
+  --it;
+  return buf.end() <= it->getBufferEnd();
+}
+
+void InputReleaser::release(OutputSection *sec) {
+  for (InputSection *isec : getInputSections(sec)) {
+    InputFile *file = isec->file;
+    if (!file || --numPending[file])
+      continue;
+    StringRef buf = file->mb.getBuffer();
+    if (isMapped(buf))
+      releaseMappedMemory(buf);
+  }
+}
+
 // Write section contents to a mmap'ed file.
 template <class ELFT> void Writer<ELFT>::writeSections() {
+  llvm::TimeTraceScope timeScope("Write sections", StringRef(""));
   // In -r or -emit-relocs mode, write the relocation sections first as in
   // ELf_Rel targets we might find out that we need to modify the relocated
   // section while doing it.
@@ -2633,9 +2743,35 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
     if (sec->type == SHT_REL || sec->type == SHT_RELA)
       sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
 
+  if (!config->releaseInputs) {
+    for (OutputSection *sec : outputSections)
+      if (sec->type != SHT_REL && sec->type != SHT_RELA)
+        sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+    return;
+  }
+
+  // With --release-inputs, write sections in file offset order so that the
+  // output is produced front to back, and drop input files from memory as
+  // soon as we are done with them. Releasing is only a hint to the kernel;
+  // if an input is read again later, e.g. for string tables, its pages are
+  // just read back from the file.
+  InputReleaser releaser;
+  for (OutputSection *sec : outputSections)
+    if (sec->type == SHT_REL || sec->type == SHT_RELA)
+      releaser.release(sec);
+
+  std::vector<OutputSection *> v;
   for (OutputSection *sec : outputSections)
     if (sec->type != SHT_REL && sec->type != SHT_RELA)
-      sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      v.push_back(sec);
+  llvm::stable_sort(v, [](OutputSection *a, OutputSection *b) {
+    return a->offset < b->offset;
+  });
+
+  for (OutputSection *sec : v) {
+    sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+    releaser.release(sec);
+  }
 }
 
 // Split one uint8 array into small pieces of uint8 arrays.
@@ -2689,7 +2825,7 @@ template <class ELFT> void Writer<ELFT>::writeBuildId() {
   switch (config->buildId) {
   case BuildIdKind::Fast:
     computeHash(buildId, buf, [](uint8_t *dest, ArrayRef<uint8_t> arr) {
-      write64le(dest, xxHash64(arr));
+      write64le(dest, xxh3_64bits(arr));
     });
     break;
   case BuildIdKind::Md5:
@@ -0,0 +1,179 @@
+//===- X86_64.cpp ---------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "InputFiles.h"
+#include "Symbols.h"
+#include "SyntheticSections.h"
+#include "Target.h"
+#include "lld/Common/ErrorHandler.h"
+#include "llvm/BinaryFormat/MachO.h"
+#include "llvm/Support/Endian.h"
+
+using namespace llvm;
+using namespace llvm::MachO;
+using namespace llvm::support::endian;
+using namespace lld;
+using namespace lld::macho;
+
+namespace {
+class X86_64 : public TargetInfo {
+public:
+  X86_64();
+  int64_t getEmbeddedAddend(const uint8_t *loc, const Reloc &r) const override;
+  void relocateOne(uint8_t *loc, const Reloc &r, uint64_t va,
+                   uint64_t pc) const override;
+  void writeStub(uint8_t *buf, const macho::Symbol &sym) const override;
+  void prepareSymbolRelocation(macho::Symbol &sym, const InputSection *isec,
+                               const Reloc &r) override;
+  uint64_t resolveSymbolVA(const macho::Symbol &sym,
+                           uint8_t type) const override;
+  bool isPointerReloc(uint8_t type, uint8_t length) const override;
+  bool isSubtractorReloc(uint8_t type) const override;
+};
+} // namespace
+
+X86_64::X86_64() {
+  cpuType = CPU_TYPE_X86_64;
+  cpuSubtype = CPU_SUBTYPE_X86_64_ALL;
+  stubSize = 6;
+}
+
+// The number of bytes between the end of the 4-byte field of a
+// SIGNED_N relocation and the end of its instruction.
+static int64_t getPCBias(uint8_t type) {
+  switch (type) {
+  case X86_64_RELOC_SIGNED_1:
+    return 1;
+  case X86_64_RELOC_SIGNED_2:
+    return 2;
+  case X86_64_RELOC_SIGNED_4:
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+int64_t X86_64::getEmbeddedAddend(const uint8_t *loc, const Reloc &r) const {
+  switch (r.length) {
+  case 2:
+    return static_cast<int32_t>(read32le(loc)) + getPCBias(r.type);
+  case 3:
+    return read64le(loc);
+  default:
+    error("relocations of " + Twine(1 << r.length) +
+          " bytes are not supported");
+    return 0;
+  }
+}
+
+void X86_64::relocateOne(uint8_t *loc, const Reloc &r, uint64_t va,
+                         uint64_t pc) const {
+  switch (r.type) {
+  case X86_64_RELOC_BRANCH:
+  case X86_64_RELOC_SIGNED:
+  case X86_64_RELOC_SIGNED_1:
+  case X86_64_RELOC_SIGNED_2:
+  case X86_64_RELOC_SIGNED_4:
+  case X86_64_RELOC_GOT_LOAD:
+  case X86_64_RELOC_GOT: {
+    // These references are relative to the end of the instruction.
+    int64_t val = va - (pc + 4 + getPCBias(r.type));
+    if (!isInt<32>(val))
+      error("relocation at " + Twine::utohexstr(pc) + " is out of range: " +
+            Twine(val) + " is not in [-2^31, 2^31)");
+    write32le(loc, val);
+    break;
+  }
+  case X86_64_RELOC_UNSIGNED:
+  case X86_64_RELOC_SUBTRACTOR:
+    if (r.length == 3)
+      write64le(loc, va);
+    else
+      write32le(loc, va);
+    break;
+  default:
+    error("unsupported relocation type " + Twine(r.type));
+  }
+}
+
+// A stub jumps to the address in the GOT entry of its symbol:
+//
+//   jmpq *got_entry(%rip)
+void X86_64::writeStub(uint8_t *buf, const macho::Symbol &sym) const {
+  uint64_t stubAddr = in.stubs->getVA() + sym.stubsIndex * stubSize;
+  buf[0] = 0xff;
+  buf[1] = 0x25;
+  write32le(buf + 2, in.got->getEntryVA(sym) - (stubAddr + stubSize));
+}
+
+void X86_64::prepareSymbolRelocation(macho::Symbol &sym,
+                                     const InputSection *isec, const Reloc &r) {
+  switch (r.type) {
+  case X86_64_RELOC_GOT_LOAD:
+  case X86_64_RELOC_GOT:
+    if (!sym.isInGot())
+      in.got->addEntry(sym);
+    break;
+  case X86_64_RELOC_BRANCH:
+    // Calls to functions of dylibs go through a stub.
+    if (isa<DylibSymbol>(sym) && !sym.isInStubs())
+      in.stubs->addEntry(sym);
+    break;
+  case X86_64_RELOC_SIGNED:
+  case X86_64_RELOC_SIGNED_1:
+  case X86_64_RELOC_SIGNED_2:
+  case X86_64_RELOC_SIGNED_4:
+    // The address of a symbol of a dylib is only known at load time, so code
+    // can only refer to it through the GOT.
+    if (isa<DylibSymbol>(sym))
+      error(toString(isec) + ": PC-relative reference to " + toString(sym) +
+            ", which is defined in a dylib; recompile with -fPIC");
+    break;
+  case X86_64_RELOC_UNSIGNED:
+    // Executables are loaded above 4 GiB.
+    if (r.length == 2)
+      error(toString(isec) + ": 32-bit absolute reference to " +
+            toString(sym) + "; recompile with -fPIC");
+    break;
+  case X86_64_RELOC_SUBTRACTOR:
+    break;
+  case X86_64_RELOC_TLV:
+    error(toString(isec) + ": thread-local variables are not supported");
+    break;
+  default:
+    error(toString(isec) + ": unsupported relocation type " + Twine(r.type));
+  }
+}
+
+uint64_t X86_64::resolveSymbolVA(const macho::Symbol &sym,
+                                 uint8_t type) const {
+  switch (type) {
+  case X86_64_RELOC_GOT_LOAD:
+  case X86_64_RELOC_GOT:
+    return in.got->getEntryVA(sym);
+  case X86_64_RELOC_BRANCH:
+    if (sym.isInStubs())
+      return in.stubs->getVA() + sym.stubsIndex * stubSize;
+    return sym.getVA();
+  default:
+    return sym.getVA();
+  }
+}
+
+bool X86_64::isPointerReloc(uint8_t type, uint8_t length) const {
+  return type == X86_64_RELOC_UNSIGNED && length == 3;
+}
+
+bool X86_64::isSubtractorReloc(uint8_t type) const {
+  return type == X86_64_RELOC_SUBTRACTOR;
+}
+
+TargetInfo *macho::createX86_64TargetInfo() {
+  static X86_64 t;
+  return &t;
+}
@@ -0,0 +1,50 @@
+//===- Config.h -------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_CONFIG_H
+#define LLD_MACHO_CONFIG_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/BinaryFormat/MachO.h"
+#include "llvm/TextAPI/MachO/Architecture.h"
+
+#include <vector>
+
+namespace lld {
+namespace macho {
+
+class Symbol;
+
+// This struct contains the global configuration for the linker.
+// Most fields are direct mapping from the command line options
+// and such fields have the same name as the corresponding options.
+// Most fields are initialized by the driver.
+struct Configuration {
+  Symbol *entry = nullptr;
+  bool adhocCodesign = false;
+  bool allLoad = false;
+  bool emitUUID = true;
+  uint32_t headerPad = 0;
+  llvm::StringRef installName;
+  llvm::StringRef outputFile;
+  uint32_t outputType = llvm::MachO::MH_EXECUTE;
+  llvm::MachO::Architecture arch = llvm::MachO::AK_unknown;
+  llvm::MachO::PlatformType platform = llvm::MachO::PLATFORM_MACOS;
+  uint32_t platformMinVersion = 0;
+  uint32_t sdkVersion = 0;
+  std::vector<llvm::StringRef> librarySearchPaths;
+  std::vector<llvm::StringRef> frameworkSearchPaths;
+  std::vector<llvm::StringRef> systemLibraryRoots;
+};
+
+extern Configuration *config;
+
+} // namespace macho
+} // namespace lld
+
+#endif
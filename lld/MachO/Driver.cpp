@@ -0,0 +1,448 @@
+//===- Driver.cpp ---------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This is the driver of the section-based Mach-O port. A link goes through
+// the following steps:
+//
+//  1. The input files are opened, and the libraries are searched for.
+//  2. The sections of the object files are read, in parallel.
+//  3. The symbols are read and resolved, in command line order. Archive
+//     members are loaded as they are needed.
+//  4. The relocations are read, in parallel; their targets are known then.
+//  5. The Writer lays out and writes the output.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lld/Common/Driver.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "OutputSegment.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "SyntheticSections.h"
+#include "Target.h"
+#include "Writer.h"
+#include "lld/Common/Args.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Memory.h"
+#include "lld/Common/Threads.h"
+#include "lld/Common/Version.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/BinaryFormat/Magic.h"
+#include "llvm/Object/Archive.h"
+#include "llvm/Option/Arg.h"
+#include "llvm/Option/ArgList.h"
+#include "llvm/Option/OptTable.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Path.h"
+#include "llvm/TextAPI/MachO/InterfaceFile.h"
+#include "llvm/TextAPI/MachO/PackedVersion.h"
+#include "llvm/TextAPI/MachO/TextAPIReader.h"
+
+using namespace llvm;
+using namespace llvm::object;
+using namespace llvm::sys;
+using namespace lld;
+using namespace lld::macho;
+
+Configuration *macho::config;
+TargetInfo *macho::target;
+
+namespace {
+
+// Create enum with OPT_xxx values for each option in Options.td
+enum {
+  OPT_INVALID = 0,
+#define OPTION(_1, _2, ID, _4, _5, _6, _7, _8, _9, _10, _11, _12) OPT_##ID,
+#include "Options.inc"
+#undef OPTION
+};
+
+class LinkerDriver {
+public:
+  void link(ArrayRef<const char *> argsArr);
+
+private:
+  void createFiles(opt::InputArgList &args);
+  void addFile(StringRef path, bool forceLoad = false);
+  void addLibrary(StringRef name);
+  void addFramework(StringRef name);
+
+  // The archives whose members are all loaded, because of -all_load or
+  // -force_load.
+  DenseSet<ArchiveFile *> forceLoadArchives;
+};
+} // anonymous namespace
+
+bool macho::link(ArrayRef<const char *> args, bool canExitEarly,
+                 raw_ostream &error) {
+  errorHandler().logName = args::getFilenameWithoutExe(args[0]);
+  errorHandler().errorOS = &error;
+  errorHandler().errorLimitExceededMsg =
+      "too many errors emitted, stopping now";
+  enableColors(error.has_colors());
+
+  config = make<Configuration>();
+  symtab = make<SymbolTable>();
+  inputFiles.clear();
+  inputSections.clear();
+  outputSegments.clear();
+  in = InStruct();
+
+  LinkerDriver().link(args);
+
+  // Exit immediately if we don't need to return to the caller.
+  // This saves time because the overhead of calling destructors
+  // for all globally-allocated objects is not negligible.
+  if (canExitEarly)
+    exitLld(errorCount() ? 1 : 0);
+
+  freeArena();
+  return !errorCount();
+}
+
+// Create prefix string literals used in Options.td
+#define PREFIX(NAME, VALUE) const char *const NAME[] = VALUE;
+#include "Options.inc"
+#undef PREFIX
+
+// Create table mapping all options defined in Options.td
+static const opt::OptTable::Info optInfo[] = {
+#define OPTION(X1, X2, ID, KIND, GROUP, ALIAS, X7, X8, X9, X10, X11, X12)      \
+  {X1, X2, X10,         X11,         OPT_##ID, opt::Option::KIND##Class,       \
+   X9, X8, OPT_##GROUP, OPT_##ALIAS, X7,       X12},
+#include "Options.inc"
+#undef OPTION
+};
+
+namespace {
+class MachOOptTable : public llvm::opt::OptTable {
+public:
+  MachOOptTable() : OptTable(optInfo) {}
+  opt::InputArgList parse(ArrayRef<const char *> argv);
+};
+} // namespace
+
+opt::InputArgList MachOOptTable::parse(ArrayRef<const char *> argv) {
+  SmallVector<const char *, 256> vec(argv.data(), argv.data() + argv.size());
+
+  unsigned missingIndex;
+  unsigned missingCount;
+
+  // Expand response files (arguments in the form of @<filename>)
+  cl::ExpandResponseFiles(saver, cl::TokenizeGNUCommandLine, vec);
+
+  opt::InputArgList args = this->ParseArgs(vec, missingIndex, missingCount);
+
+  if (missingCount)
+    error(Twine(args.getArgString(missingIndex)) + ": missing argument");
+  for (auto *arg : args.filtered(OPT_UNKNOWN))
+    error("unknown argument: " + arg->getAsString(args));
+  return args;
+}
+
+// Find a file by concatenating given paths.
+static Optional<std::string> findFile(StringRef path1, const Twine &path2) {
+  SmallString<261> s;
+  path::append(s, path1, path2);
+  if (fs::exists(s))
+    return s.str().str();
+  return None;
+}
+
+void LinkerDriver::addFile(StringRef path, bool forceLoad) {
+  Optional<MemoryBufferRef> buffer = readFile(path);
+  if (!buffer)
+    return;
+  MemoryBufferRef mbref = *buffer;
+
+  switch (identify_magic(mbref.getBuffer())) {
+  case file_magic::archive: {
+    std::unique_ptr<Archive> file =
+        CHECK(Archive::create(mbref), path + ": failed to parse archive");
+
+    if (!file->isEmpty() && !file->hasSymbolTable())
+      error(path + ": archive has no index; run ranlib to add one");
+
+    // Take ownership of memory buffers created for members of thin archives.
+    for (std::unique_ptr<MemoryBuffer> &mb : file->takeThinBuffers())
+      make<std::unique_ptr<MemoryBuffer>>(std::move(mb));
+
+    auto *archive = make<ArchiveFile>(std::move(file));
+    if (forceLoad || config->allLoad)
+      forceLoadArchives.insert(archive);
+    inputFiles.push_back(archive);
+    break;
+  }
+  case file_magic::macho_object:
+    inputFiles.push_back(make<ObjFile>(mbref));
+    break;
+  case file_magic::macho_dynamically_linked_shared_lib: {
+    auto *dylib = make<DylibFile>(mbref);
+    inputFiles.push_back(dylib);
+    loadReexports(dylib);
+    break;
+  }
+  case file_magic::tapi_file: {
+    Expected<std::unique_ptr<llvm::MachO::InterfaceFile>> result =
+        llvm::MachO::TextAPIReader::get(mbref);
+    if (!result) {
+      error(path + ": " + toString(result.takeError()));
+      return;
+    }
+    auto *dylib = make<DylibFile>(std::move(*result), mbref);
+    inputFiles.push_back(dylib);
+    loadReexports(dylib);
+    break;
+  }
+  default:
+    error(path + ": unhandled file type");
+  }
+}
+
+// Text-based stubs come first, since that is all the SDKs ship. As with
+// -search_paths_first in ld64, each directory is searched for all kinds of
+// libraries before the next one.
+void LinkerDriver::addLibrary(StringRef name) {
+  for (StringRef dir : config->librarySearchPaths) {
+    for (StringRef ext : {".tbd", ".dylib", ".a"}) {
+      if (Optional<std::string> path = findFile(dir, "lib" + name + ext)) {
+        addFile(saver.save(*path));
+        return;
+      }
+    }
+  }
+  error("library not found for -l" + name);
+}
+
+void LinkerDriver::addFramework(StringRef name) {
+  for (StringRef dir : config->frameworkSearchPaths) {
+    SmallString<261> base = dir;
+    path::append(base, name + ".framework", name);
+    for (StringRef ext : {".tbd", ""}) {
+      std::string path = (base + ext).str();
+      if (fs::exists(path)) {
+        addFile(saver.save(path));
+        return;
+      }
+    }
+  }
+  error("framework not found for -framework " + name);
+}
+
+void LinkerDriver::createFiles(opt::InputArgList &args) {
+  for (auto *arg : args) {
+    switch (arg->getOption().getID()) {
+    case OPT_INPUT:
+      addFile(arg->getValue());
+      break;
+    case OPT_force_load:
+      addFile(arg->getValue(), /*forceLoad=*/true);
+      break;
+    case OPT_l:
+      addLibrary(arg->getValue());
+      break;
+    case OPT_framework:
+      addFramework(arg->getValue());
+      break;
+    }
+  }
+}
+
+static Optional<uint32_t> parseVersion(StringRef s) {
+  llvm::MachO::PackedVersion version;
+  if (!version.parse32(s))
+    return None;
+  return version.rawValue();
+}
+
+static void parsePlatformVersion(opt::InputArgList &args) {
+  if (auto *arg = args.getLastArg(OPT_macosx_version_min)) {
+    config->platform = llvm::MachO::PLATFORM_MACOS;
+    if (Optional<uint32_t> v = parseVersion(arg->getValue()))
+      config->platformMinVersion = *v;
+    else
+      error("-macosx_version_min: malformed version: " +
+            StringRef(arg->getValue()));
+  }
+
+  if (auto *arg = args.getLastArg(OPT_platform_version)) {
+    StringRef platform = arg->getValue(0);
+    auto type = StringSwitch<Optional<llvm::MachO::PlatformType>>(platform)
+                    .Cases("macos", "1", llvm::MachO::PLATFORM_MACOS)
+                    .Cases("ios", "2", llvm::MachO::PLATFORM_IOS)
+                    .Cases("tvos", "3", llvm::MachO::PLATFORM_TVOS)
+                    .Cases("watchos", "4", llvm::MachO::PLATFORM_WATCHOS)
+                    .Cases("bridgeos", "5", llvm::MachO::PLATFORM_BRIDGEOS)
+                    .Cases("mac-catalyst", "6",
+                           llvm::MachO::PLATFORM_MACCATALYST)
+                    .Cases("ios-simulator", "7",
+                           llvm::MachO::PLATFORM_IOSSIMULATOR)
+                    .Cases("tvos-simulator", "8",
+                           llvm::MachO::PLATFORM_TVOSSIMULATOR)
+                    .Cases("watchos-simulator", "9",
+                           llvm::MachO::PLATFORM_WATCHOSSIMULATOR)
+                    .Default(None);
+    if (!type) {
+      error("-platform_version: unknown platform: " + platform);
+      return;
+    }
+    config->platform = *type;
+
+    Optional<uint32_t> minVersion = parseVersion(arg->getValue(1));
+    Optional<uint32_t> sdkVersion = parseVersion(arg->getValue(2));
+    if (!minVersion || !sdkVersion) {
+      error("-platform_version: malformed version");
+      return;
+    }
+    config->platformMinVersion = *minVersion;
+    config->sdkVersion = *sdkVersion;
+  }
+
+  // macOS 10.15 is the oldest version that the output is tested on.
+  if (!config->platformMinVersion)
+    config->platformMinVersion = 0x000a0f00;
+}
+
+static void parseSearchPaths(opt::InputArgList &args) {
+  config->systemLibraryRoots = args::getStrings(args, OPT_syslibroot);
+  if (config->systemLibraryRoots.empty())
+    config->systemLibraryRoots.push_back("/");
+
+  config->librarySearchPaths = args::getStrings(args, OPT_L);
+  config->frameworkSearchPaths = args::getStrings(args, OPT_F_path);
+  if (args.hasArg(OPT_Z))
+    return;
+
+  for (StringRef root : config->systemLibraryRoots) {
+    for (StringRef dir : {"/usr/lib", "/usr/local/lib"}) {
+      SmallString<261> path = root;
+      path::append(path, dir);
+      if (fs::is_directory(path))
+        config->librarySearchPaths.push_back(saver.save(path.str()));
+    }
+    for (StringRef dir : {"/Library/Frameworks", "/System/Library/Frameworks"}) {
+      SmallString<261> path = root;
+      path::append(path, dir);
+      if (fs::is_directory(path))
+        config->frameworkSearchPaths.push_back(saver.save(path.str()));
+    }
+  }
+}
+
+void LinkerDriver::link(ArrayRef<const char *> argsArr) {
+  MachOOptTable parser;
+  opt::InputArgList args = parser.parse(argsArr.slice(1));
+
+  // Handle -help
+  if (args.hasArg(OPT_help)) {
+    parser.PrintHelp(outs(),
+                     (std::string(argsArr[0]) + " [options] file...").c_str(),
+                     "LLVM Linker", false);
+    return;
+  }
+
+  // Handle -v and --version
+  if (args.hasArg(OPT_version) || args.hasArg(OPT_v)) {
+    outs() << getLLDVersion() << "\n";
+    return;
+  }
+
+  threadsEnabled = args.hasFlag(OPT_threads, OPT_no_threads, true);
+
+  StringRef archName = args.getLastArgValue(OPT_arch, "x86_64");
+  config->arch = llvm::MachO::getArchitectureFromName(archName);
+  if (config->arch != llvm::MachO::AK_x86_64) {
+    error("missing or unsupported -arch " + archName);
+    return;
+  }
+  target = createX86_64TargetInfo();
+
+  config->outputFile = args.getLastArgValue(OPT_o, "a.out");
+  if (args.hasArg(OPT_dylib)) {
+    config->outputType = llvm::MachO::MH_DYLIB;
+    config->installName =
+        args.getLastArgValue(OPT_install_name, config->outputFile);
+  }
+  config->allLoad = args.hasArg(OPT_all_load);
+  config->adhocCodesign =
+      args.hasFlag(OPT_adhoc_codesign, OPT_no_adhoc_codesign, false);
+  config->emitUUID = !args.hasArg(OPT_no_uuid);
+  if (auto *arg = args.getLastArg(OPT_headerpad)) {
+    StringRef s = arg->getValue();
+    if (s.startswith_lower("0x"))
+      s = s.drop_front(2);
+    if (s.getAsInteger(16, config->headerPad))
+      error("-headerpad: number expected, but got " + StringRef(arg->getValue()));
+  }
+  parsePlatformVersion(args);
+  parseSearchPaths(args);
+  if (errorCount())
+    return;
+
+  createSyntheticSections();
+  createFiles(args);
+  if (errorCount())
+    return;
+
+  // The sections of each object file are independent of everything else.
+  std::vector<ObjFile *> objFiles;
+  for (InputFile *file : inputFiles)
+    if (auto *obj = dyn_cast<ObjFile>(file))
+      objFiles.push_back(obj);
+  parallelForEach(objFiles, [](ObjFile *file) { file->parseSections(); });
+
+  // Symbol resolution depends on the order of the files, so it is serial.
+  // Archive members that get loaded are read and resolved on the spot.
+  for (InputFile *file : std::vector<InputFile *>(inputFiles)) {
+    if (auto *obj = dyn_cast<ObjFile>(file))
+      obj->parseSymbols();
+    else if (auto *archive = dyn_cast<ArchiveFile>(file)) {
+      if (forceLoadArchives.count(archive))
+        archive->fetchAll();
+      else
+        archive->addLazySymbols();
+    }
+  }
+
+  if (config->outputType == llvm::MachO::MH_EXECUTE) {
+    symtab->addSynthetic("__mh_execute_header", in.header, /*value=*/0,
+                         /*isPrivateExtern=*/false);
+    StringRef entryName = args.getLastArgValue(OPT_e, "_main");
+    config->entry = symtab->addUndefined(entryName, /*file=*/nullptr);
+    if (isa<DylibSymbol>(config->entry))
+      error("entry point " + entryName + " must be defined in the output");
+  }
+
+  for (Symbol *sym : symtab->getSymbols())
+    if (auto *undefined = dyn_cast<Undefined>(sym))
+      error("undefined symbol: " + toString(*sym) + "\n>>> referenced by " +
+            (undefined->file ? toString(undefined->file) : "the entry point"));
+  if (errorCount())
+    return;
+
+  // Only the archive members that got loaded are in the output.
+  objFiles.clear();
+  for (InputFile *file : inputFiles) {
+    if (auto *obj = dyn_cast<ObjFile>(file)) {
+      objFiles.push_back(obj);
+      for (InputSection *isec : obj->sections)
+        if (isec)
+          inputSections.push_back(isec);
+    }
+  }
+
+  // The targets of the relocations are known now, and each file only
+  // updates its own sections.
+  parallelForEach(objFiles, [](ObjFile *file) { file->parseRelocations(); });
+  if (errorCount())
+    return;
+
+  writeResult();
+}
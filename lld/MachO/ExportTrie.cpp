@@ -0,0 +1,208 @@
+//===- ExportTrie.cpp -----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This is a partial implementation of the Mach-O export trie format. It's
+// essentially a symbol table encoded as a compressed prefix trie, meaning that
+// the common prefixes of each symbol name are shared for a more compact
+// representation. The prefixes are stored on the edges of the trie, and one
+// edge can represent multiple characters. For example, given two exported
+// symbols _bar and _baz, we will have a trie like this (terminal nodes are
+// marked with an asterisk):
+//
+//              +-+-+
+//              |   | // root node
+//              +-+-+
+//                |
+//                | _ba
+//                |
+//              +-+-+
+//              |   |
+//              +-+-+
+//           r /     | z
+//            /      |
+//        +-+-+       +-+-+
+//        | * |       | * |
+//        +-+-+       +-+-+
+//
+// Re-exports and resolvers aren't supported.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ExportTrie.h"
+#include "Symbols.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Memory.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/BinaryFormat/MachO.h"
+#include "llvm/Support/LEB128.h"
+
+using namespace llvm;
+using namespace llvm::MachO;
+using namespace lld;
+using namespace lld::macho;
+
+namespace {
+struct Edge {
+  Edge(StringRef s, TrieBuilder::TrieNode *node) : substring(s), child(node) {}
+
+  StringRef substring;
+  struct TrieBuilder::TrieNode *child;
+};
+
+struct ExportInfo {
+  uint64_t address;
+  uint8_t flags;
+
+  ExportInfo(const Defined &sym, uint64_t imageBase) {
+    if (sym.isAbsolute()) {
+      address = sym.value;
+      flags = EXPORT_SYMBOL_FLAGS_KIND_ABSOLUTE;
+    } else {
+      address = sym.getVA() - imageBase;
+      flags = EXPORT_SYMBOL_FLAGS_KIND_REGULAR;
+    }
+    if (sym.isWeakDef())
+      flags |= EXPORT_SYMBOL_FLAGS_WEAK_DEFINITION;
+  }
+
+  uint32_t getSize() const {
+    return getULEB128Size(flags) + getULEB128Size(address);
+  }
+};
+} // namespace
+
+struct TrieBuilder::TrieNode {
+  std::vector<Edge> edges;
+  Optional<ExportInfo> info;
+  // The offset of this node in the serialized trie.
+  size_t offset = 0;
+
+  // Sets the offset of this node to nextOffset and advances nextOffset past
+  // the node. Returns true if the offset changed.
+  bool updateOffset(size_t &nextOffset);
+  void writeTo(uint8_t *buf) const;
+};
+
+bool TrieBuilder::TrieNode::updateOffset(size_t &nextOffset) {
+  // Size of the whole node (including the terminalSize and the outgoing edges.)
+  // In contrast, terminalSize only records the size of the other data in the
+  // node.
+  size_t nodeSize;
+  if (info) {
+    uint32_t terminalSize = info->getSize();
+    nodeSize = terminalSize + getULEB128Size(terminalSize);
+  } else {
+    nodeSize = 1; // Size of terminalSize (which has a value of 0)
+  }
+  // Number of edges.
+  ++nodeSize;
+  // Compute size of all child edges.
+  for (const Edge &edge : edges)
+    nodeSize += edge.substring.size() + 1 // String length.
+                + getULEB128Size(edge.child->offset); // Offset len.
+
+  // On input, 'nextOffset' is the new preferred location for this node.
+  bool result = (offset != nextOffset);
+  // Store new location in node object for use by parents.
+  offset = nextOffset;
+  nextOffset += nodeSize;
+  return result;
+}
+
+void TrieBuilder::TrieNode::writeTo(uint8_t *buf) const {
+  buf += offset;
+  if (info) {
+    // TrieNodes with Symbol info: size, flags address
+    uint32_t terminalSize = info->getSize();
+    buf += encodeULEB128(terminalSize, buf);
+    buf += encodeULEB128(info->flags, buf);
+    buf += encodeULEB128(info->address, buf);
+  } else {
+    // TrieNode with no Symbol info.
+    *buf++ = 0; // terminalSize
+  }
+  // Add number of children, which sortAndBuild() has checked fits in a byte.
+  *buf++ = edges.size();
+  // Append each child edge substring and node offset.
+  for (const Edge &edge : edges) {
+    memcpy(buf, edge.substring.data(), edge.substring.size());
+    buf += edge.substring.size();
+    *buf++ = '\0';
+    buf += encodeULEB128(edge.child->offset, buf);
+  }
+}
+
+TrieBuilder::TrieNode *TrieBuilder::makeNode() {
+  auto *node = make<TrieNode>();
+  nodes.emplace_back(node);
+  return node;
+}
+
+// Builds the subtree of \p node from \p vec, the sorted symbols whose names
+// start with the first \p pos characters, which all lead to \p node.
+void TrieBuilder::sortAndBuild(MutableArrayRef<const Defined *> vec,
+                               TrieNode *node, size_t pos) {
+  if (!vec.empty() && vec[0]->getName().size() == pos) {
+    node->info = ExportInfo(*vec[0], imageBase);
+    vec = vec.drop_front();
+  }
+
+  while (!vec.empty()) {
+    // The symbols that continue with the same character share an edge, which
+    // is labeled with their longest common prefix. Since they are sorted, it
+    // is the common prefix of the first and the last one.
+    char c = vec[0]->getName()[pos];
+    size_t n = 1;
+    while (n < vec.size() && vec[n]->getName()[pos] == c)
+      ++n;
+    StringRef first = vec[0]->getName();
+    StringRef last = vec[n - 1]->getName();
+    size_t end = pos + 1;
+    while (end < first.size() && end < last.size() && first[end] == last[end])
+      ++end;
+
+    TrieNode *child = makeNode();
+    node->edges.emplace_back(first.slice(pos, end), child);
+    sortAndBuild(vec.take_front(n), child, end);
+    vec = vec.drop_front(n);
+  }
+
+  // dyld and llvm-objdump read the number of children as a single byte. Each
+  // edge starts with a different non-null character, so there are at most 255.
+  if (node->edges.size() > UINT8_MAX)
+    fatal("export trie node has " + Twine(node->edges.size()) +
+          " children; at most " + Twine(UINT8_MAX) + " are supported");
+}
+
+size_t TrieBuilder::build() {
+  if (exported.empty())
+    return 0;
+
+  llvm::sort(exported, [](const Defined *a, const Defined *b) {
+    return a->getName() < b->getName();
+  });
+  TrieNode *root = makeNode();
+  sortAndBuild(exported, root, 0);
+
+  // Assign each node in the vector an offset in the trie stream, iterating
+  // until all uleb128 sizes have stabilized.
+  bool more;
+  do {
+    size = 0;
+    more = false;
+    for (TrieNode *node : nodes)
+      more |= node->updateOffset(size);
+  } while (more);
+
+  return size;
+}
+
+void TrieBuilder::writeTo(uint8_t *buf) const {
+  for (TrieNode *node : nodes)
+    node->writeTo(buf);
+}
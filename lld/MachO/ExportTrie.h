@@ -0,0 +1,54 @@
+//===- ExportTrie.h ---------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_EXPORT_TRIE_H
+#define LLD_MACHO_EXPORT_TRIE_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <vector>
+
+namespace lld {
+namespace macho {
+
+class Defined;
+
+// Builds the export trie of the output: a prefix tree of the names of the
+// exported symbols, whose terminal nodes hold the flags and the address of
+// each symbol, relative to \p imageBase.
+class TrieBuilder {
+public:
+  explicit TrieBuilder(uint64_t imageBase) : imageBase(imageBase) {}
+
+  void addSymbol(const Defined &sym) { exported.push_back(&sym); }
+
+  // Returns the size of the serialized trie. The offsets of the nodes are
+  // encoded as ULEB128, so their sizes depend on each other; they are
+  // recomputed until they don't change anymore.
+  size_t build();
+
+  void writeTo(uint8_t *buf) const;
+
+  struct TrieNode;
+
+private:
+  TrieNode *makeNode();
+  void sortAndBuild(MutableArrayRef<const Defined *> vec, TrieNode *node,
+                    size_t pos);
+
+  uint64_t imageBase;
+  std::vector<const Defined *> exported;
+  std::vector<TrieNode *> nodes;
+  size_t size = 0;
+};
+
+} // namespace macho
+} // namespace lld
+
+#endif
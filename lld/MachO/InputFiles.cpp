@@ -0,0 +1,751 @@
+//===- InputFiles.cpp -----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file contains functions to parse Mach-O object files. In this comment,
+// we describe the Mach-O file structure and how we parse it.
+//
+// Mach-O is not very different from ELF or COFF. The notion of symbols,
+// sections and relocations exists in Mach-O as it does in ELF and COFF.
+//
+// Perhaps the notion that is new to those who know ELF/COFF is "subsections".
+// In ELF/COFF, sections are an atomic unit of data copied from input files to
+// output files. When we merge or garbage-collect sections, we treat each
+// section as an atomic unit. In Mach-O, that's not the case. Sections can
+// consist of multiple subsections, and subsections are a unit of merging and
+// garbage-collecting. Therefore, Mach-O's subsections are more similar to
+// ELF/COFF's sections than Mach-O's sections are.
+//
+// A section can have multiple symbols. A symbol that does not have the
+// N_ALT_ENTRY attribute indicates a beginning of a subsection. Therefore, by
+// definition, a symbol is always present at the beginning of each subsection.
+// A symbol with N_ALT_ENTRY attribute does not start a new subsection and can
+// point to a middle of a subsection.
+//
+// This linker doesn't do anything that needs subsections yet, so sections are
+// kept whole. Relocations against addresses rather than symbols are resolved
+// to the section that contains the address.
+//
+//===----------------------------------------------------------------------===//
+
+#include "InputFiles.h"
+#include "Config.h"
+#include "InputSection.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "Target.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Memory.h"
+#include "llvm/BinaryFormat/MachO.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/TextAPI/MachO/InterfaceFile.h"
+#include "llvm/TextAPI/MachO/TextAPIReader.h"
+
+using namespace llvm;
+using namespace llvm::MachO;
+using namespace llvm::support::endian;
+using namespace llvm::sys;
+using namespace lld;
+using namespace lld::macho;
+
+std::vector<InputFile *> macho::inputFiles;
+
+// Open a given file path and return it as a memory-mapped file.
+Optional<MemoryBufferRef> macho::readFile(StringRef path) {
+  // Open a file.
+  auto mbOrErr = MemoryBuffer::getFile(path);
+  if (auto ec = mbOrErr.getError()) {
+    error("cannot open " + path + ": " + ec.message());
+    return None;
+  }
+
+  std::unique_ptr<MemoryBuffer> &mb = *mbOrErr;
+  MemoryBufferRef mbref = mb->getMemBufferRef();
+  make<std::unique_ptr<MemoryBuffer>>(std::move(mb)); // take mb ownership
+
+  // If this is a regular non-fat file, return it.
+  const char *buf = mbref.getBufferStart();
+  auto *hdr = reinterpret_cast<const fat_header *>(buf);
+  if (mbref.getBufferSize() < sizeof(fat_header) ||
+      read32be(&hdr->magic) != FAT_MAGIC)
+    return mbref;
+
+  // Object files and archive files may be fat files, which contain multiple
+  // real files for different CPU ISAs. Here, we search for a file that matches
+  // with the current link target and returns it as a MemoryBufferRef.
+  auto *arch = reinterpret_cast<const fat_arch *>(buf + sizeof(*hdr));
+  for (uint32_t i = 0, n = read32be(&hdr->nfat_arch); i < n; ++i) {
+    if (reinterpret_cast<const char *>(arch + i + 1) >
+        buf + mbref.getBufferSize()) {
+      error(path + ": fat_arch struct extends beyond end of file");
+      return None;
+    }
+
+    if (read32be(&arch[i].cputype) != target->cpuType ||
+        (read32be(&arch[i].cpusubtype) & ~CPU_SUBTYPE_MASK) !=
+            target->cpuSubtype)
+      continue;
+
+    uint32_t offset = read32be(&arch[i].offset);
+    uint32_t size = read32be(&arch[i].size);
+    if (offset + size > mbref.getBufferSize()) {
+      error(path + ": slice extends beyond end of file");
+      return None;
+    }
+    return MemoryBufferRef(StringRef(buf + offset, size), path);
+  }
+
+  error("unable to find matching architecture in " + path);
+  return None;
+}
+
+// Returns the load commands of a Mach-O file after checking that they are
+// within bounds, or an empty vector after reporting an error.
+static std::vector<const load_command *>
+getLoadCommands(const InputFile *file, const mach_header_64 *hdr) {
+  std::vector<const load_command *> cmds;
+  MemoryBufferRef mb = file->mb;
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(hdr + 1);
+  const uint8_t *end = p + hdr->sizeofcmds;
+  if (end > reinterpret_cast<const uint8_t *>(mb.getBufferEnd())) {
+    error(toString(file) + ": load commands extend beyond end of file");
+    return {};
+  }
+  for (uint32_t i = 0; i < hdr->ncmds; ++i) {
+    auto *cmd = reinterpret_cast<const load_command *>(p);
+    if (p + sizeof(load_command) > end || cmd->cmdsize < sizeof(load_command) ||
+        p + cmd->cmdsize > end) {
+      error(toString(file) + ": malformed load command " + Twine(i));
+      return {};
+    }
+    cmds.push_back(cmd);
+    p += cmd->cmdsize;
+  }
+  return cmds;
+}
+
+// Checks the header of a Mach-O file and returns it, or null after reporting
+// an error.
+static const mach_header_64 *getHeader(const InputFile *file,
+                                       uint32_t fileType) {
+  MemoryBufferRef mb = file->mb;
+  if (mb.getBufferSize() < sizeof(mach_header_64)) {
+    error(toString(file) + ": file is too small");
+    return nullptr;
+  }
+  auto *hdr = reinterpret_cast<const mach_header_64 *>(mb.getBufferStart());
+  if (hdr->magic != MH_MAGIC_64) {
+    error(toString(file) + ": not a 64-bit little-endian Mach-O file");
+    return nullptr;
+  }
+  if (hdr->cputype != target->cpuType) {
+    error(toString(file) + ": is incompatible with the target architecture");
+    return nullptr;
+  }
+  if (hdr->filetype != fileType) {
+    error(toString(file) + ": unexpected file type " + Twine(hdr->filetype));
+    return nullptr;
+  }
+  return hdr;
+}
+
+ObjFile::ObjFile(MemoryBufferRef mb, StringRef archiveName)
+    : InputFile(ObjKind, mb) {
+  this->archiveName = archiveName;
+  header = getHeader(this, MH_OBJECT);
+  if (!header)
+    return;
+
+  for (const load_command *cmd : getLoadCommands(this, header)) {
+    if (cmd->cmd == LC_SEGMENT_64) {
+      auto *seg = reinterpret_cast<const segment_command_64 *>(cmd);
+      if (sizeof(segment_command_64) + seg->nsects * sizeof(section_64) >
+          seg->cmdsize) {
+        error(toString(this) + ": malformed LC_SEGMENT_64");
+        return;
+      }
+      numSections = seg->nsects;
+    } else if (cmd->cmd == LC_SYMTAB) {
+      symtabCmd = reinterpret_cast<const symtab_command *>(cmd);
+      if (uint64_t(symtabCmd->symoff) +
+                  uint64_t(symtabCmd->nsyms) * sizeof(nlist_64) >
+              mb.getBufferSize() ||
+          uint64_t(symtabCmd->stroff) + symtabCmd->strsize >
+              mb.getBufferSize()) {
+        error(toString(this) + ": symbol table extends beyond end of file");
+        symtabCmd = nullptr;
+      }
+    }
+  }
+}
+
+const section_64 *ObjFile::getSectionHeaders() const {
+  for (const load_command *cmd : getLoadCommands(this, header))
+    if (cmd->cmd == LC_SEGMENT_64)
+      return reinterpret_cast<const section_64 *>(
+          reinterpret_cast<const segment_command_64 *>(cmd) + 1);
+  return nullptr;
+}
+
+void ObjFile::parseSections() {
+  if (!numSections)
+    return;
+  const section_64 *secs = getSectionHeaders();
+  sections.resize(numSections);
+
+  for (uint32_t i = 0; i < numSections; ++i) {
+    const section_64 &sec = secs[i];
+
+    // Debug info is not copied to the output, and the compact unwind info of
+    // the __LD segment is meant to be converted by the linker, which isn't
+    // implemented yet.
+    if ((sec.flags & S_ATTR_DEBUG) ||
+        StringRef(sec.segname, strnlen(sec.segname, 16)) == "__LD")
+      continue;
+
+    auto *isec = make<InputSection>();
+    isec->file = this;
+    isec->name = StringRef(sec.sectname, strnlen(sec.sectname, 16));
+    isec->segname = StringRef(sec.segname, strnlen(sec.segname, 16));
+    isec->flags = sec.flags;
+    isec->addr = sec.addr;
+    if (sec.align >= MaxAlignmentPowerOf2) {
+      error(toString(isec) + ": alignment 2^" + Twine(sec.align) +
+            " is too large");
+      continue;
+    }
+    isec->align = 1u << sec.align;
+
+    if (isec->isZeroFill()) {
+      isec->data = {nullptr, static_cast<size_t>(sec.size)};
+    } else {
+      if (uint64_t(sec.offset) + sec.size > mb.getBufferSize()) {
+        error(toString(isec) + ": section extends beyond end of file");
+        continue;
+      }
+      isec->data = {reinterpret_cast<const uint8_t *>(mb.getBufferStart()) +
+                        sec.offset,
+                    static_cast<size_t>(sec.size)};
+    }
+    sections[i] = isec;
+  }
+}
+
+void ObjFile::parseSymbols() {
+  if (!symtabCmd)
+    return;
+  const char *buf = mb.getBufferStart();
+  auto *nList = reinterpret_cast<const nlist_64 *>(buf + symtabCmd->symoff);
+  const char *strtab = buf + symtabCmd->stroff;
+  symbols.resize(symtabCmd->nsyms);
+
+  for (uint32_t i = 0; i < symtabCmd->nsyms; ++i) {
+    const nlist_64 &sym = nList[i];
+
+    // Skip the debug symbols.
+    if (sym.n_type & N_STAB)
+      continue;
+
+    if (sym.n_strx >= symtabCmd->strsize) {
+      error(toString(this) + ": invalid name for symbol " + Twine(i));
+      continue;
+    }
+    StringRef name = strtab + sym.n_strx;
+    bool isExternal = sym.n_type & N_EXT;
+
+    switch (sym.n_type & N_TYPE) {
+    case N_UNDF:
+      if (!isExternal) {
+        error(toString(this) + ": undefined symbol " + name +
+              " is not external");
+      } else if (sym.n_value != 0) {
+        symbols[i] = symtab->addCommon(name, this, sym.n_value,
+                                       1u << GET_COMM_ALIGN(sym.n_desc));
+      } else {
+        symbols[i] = symtab->addUndefined(name, this);
+      }
+      break;
+    case N_ABS:
+      if (isExternal)
+        symbols[i] =
+            symtab->addDefined(name, this, nullptr, sym.n_value,
+                               sym.n_desc & N_WEAK_DEF, sym.n_type & N_PEXT);
+      else
+        symbols[i] = make<Defined>(name, this, nullptr, sym.n_value,
+                                   /*isWeakDef=*/false, /*isExternal=*/false);
+      break;
+    case N_SECT: {
+      if (sym.n_sect == 0 || sym.n_sect > sections.size()) {
+        error(toString(this) + ": symbol " + name +
+              " has an invalid section index");
+        break;
+      }
+      // Symbols of the sections that we drop are dropped too.
+      InputSection *isec = sections[sym.n_sect - 1];
+      if (!isec)
+        break;
+      uint64_t value = sym.n_value - isec->addr;
+      if (isExternal)
+        symbols[i] =
+            symtab->addDefined(name, this, isec, value,
+                               sym.n_desc & N_WEAK_DEF, sym.n_type & N_PEXT);
+      else
+        symbols[i] = make<Defined>(name, this, isec, value,
+                                   /*isWeakDef=*/false, /*isExternal=*/false);
+      break;
+    }
+    default:
+      error(toString(this) + ": symbol " + name + " has unsupported type " +
+            Twine(sym.n_type & N_TYPE));
+    }
+  }
+}
+
+namespace {
+// The fields of relocation_info, decoded from the little-endian encoding.
+struct RelocInfo {
+  int32_t address;
+  uint32_t symbolnum;
+  bool pcrel;
+  uint8_t length;
+  bool isExtern;
+  uint8_t type;
+  bool isScattered;
+};
+} // namespace
+
+static RelocInfo decodeReloc(const any_relocation_info &rel) {
+  RelocInfo r;
+  r.address = rel.r_word0;
+  r.symbolnum = rel.r_word1 & 0xffffff;
+  r.pcrel = (rel.r_word1 >> 24) & 1;
+  r.length = (rel.r_word1 >> 25) & 3;
+  r.isExtern = (rel.r_word1 >> 27) & 1;
+  r.type = rel.r_word1 >> 28;
+  r.isScattered = rel.r_word0 & R_SCATTERED;
+  return r;
+}
+
+InputSection *ObjFile::findContainingSection(uint64_t addr) const {
+  for (InputSection *isec : sections)
+    if (isec && isec->addr <= addr && addr <= isec->addr + isec->getSize())
+      return isec;
+  return nullptr;
+}
+
+// Reads the relocation at relInfos[i]. A SUBTRACTOR relocation is followed by
+// the UNSIGNED relocation that gives the minuend, and i is advanced past it.
+void ObjFile::parseRelocation(InputSection *isec, const section_64 &sec,
+                              ArrayRef<any_relocation_info> relInfos,
+                              size_t &i) {
+  RelocInfo rel = decodeReloc(relInfos[i]);
+  if (rel.isScattered) {
+    error(toString(isec) + ": scattered relocations are not supported");
+    return;
+  }
+  if (rel.address < 0 ||
+      uint64_t(rel.address) + (1u << rel.length) > isec->data.size()) {
+    error(toString(isec) + ": relocation " + Twine(i) +
+          " is out of bounds");
+    return;
+  }
+
+  auto getSymbol = [&](uint32_t index) -> macho::Symbol * {
+    macho::Symbol *sym = index < symbols.size() ? symbols[index] : nullptr;
+    if (!sym)
+      error(toString(isec) + ": relocation " + Twine(i) +
+            " refers to an invalid or discarded symbol");
+    return sym;
+  };
+
+  Reloc r;
+  r.type = rel.type;
+  r.pcrel = rel.pcrel;
+  r.length = rel.length;
+  r.offset = rel.address;
+  r.addend = target->getEmbeddedAddend(isec->data.data() + r.offset, r);
+
+  // A SUBTRACTOR relocation names the subtrahend and is paired with the
+  // relocation that names the minuend; the two become one Reloc.
+  if (target->isSubtractorReloc(rel.type)) {
+    if (!rel.isExtern) {
+      error(toString(isec) + ": SUBTRACTOR relocation must be extern");
+      return;
+    }
+    macho::Symbol *subtrahend = getSymbol(rel.symbolnum);
+    if (!subtrahend)
+      return;
+    r.subtrahend = subtrahend;
+    if (++i == relInfos.size()) {
+      error(toString(isec) + ": SUBTRACTOR relocation must be followed by "
+                             "an UNSIGNED relocation");
+      return;
+    }
+    RelocInfo minuend = decodeReloc(relInfos[i]);
+    if (minuend.address != rel.address || minuend.length != rel.length ||
+        minuend.pcrel) {
+      error(toString(isec) + ": invalid SUBTRACTOR relocation pair");
+      return;
+    }
+    rel.isExtern = minuend.isExtern;
+    rel.symbolnum = minuend.symbolnum;
+  }
+
+  if (rel.isExtern) {
+    r.referent = getSymbol(rel.symbolnum);
+  } else {
+    // Relocations against addresses use the 1-based ordinal of the section
+    // that contains the target.
+    if (rel.symbolnum == 0 || rel.symbolnum > sections.size()) {
+      error(toString(isec) + ": relocation " + Twine(i) +
+            " has an invalid section ordinal");
+      return;
+    }
+    // The field holds the original address of the target; the pc-relative
+    // ones hold it relative to the end of the field.
+    uint64_t origAddr =
+        r.pcrel ? sec.addr + r.offset + (1u << r.length) + r.addend : r.addend;
+    InputSection *referent = sections[rel.symbolnum - 1];
+    if (!referent || origAddr < referent->addr ||
+        origAddr > referent->addr + referent->getSize())
+      referent = findContainingSection(origAddr);
+    if (!referent) {
+      error(toString(isec) + ": relocation " + Twine(i) +
+            " refers to a discarded section");
+      return;
+    }
+    r.referent = referent;
+    r.addend = origAddr - referent->addr;
+  }
+
+  if (!r.referent.isNull())
+    isec->relocs.push_back(r);
+}
+
+void ObjFile::parseRelocations() {
+  if (!numSections)
+    return;
+  const section_64 *secs = getSectionHeaders();
+  for (uint32_t i = 0; i < numSections; ++i) {
+    const section_64 &sec = secs[i];
+    InputSection *isec = sections[i];
+    if (!isec || !sec.nreloc)
+      continue;
+    if (!symtabCmd) {
+      error(toString(isec) + ": relocations without a symbol table");
+      continue;
+    }
+    if (uint64_t(sec.reloff) + sec.nreloc * sizeof(any_relocation_info) >
+        mb.getBufferSize()) {
+      error(toString(isec) + ": relocations extend beyond end of file");
+      continue;
+    }
+
+    ArrayRef<any_relocation_info> relInfos(
+        reinterpret_cast<const any_relocation_info *>(mb.getBufferStart() +
+                                                      sec.reloff),
+        sec.nreloc);
+    isec->relocs.reserve(relInfos.size());
+    for (size_t j = 0; j < relInfos.size(); ++j)
+      parseRelocation(isec, sec, relInfos, j);
+  }
+}
+
+DylibFile::DylibFile(MemoryBufferRef mb, DylibFile *umbrella)
+    : InputFile(DylibKind, mb), umbrella(umbrella ? umbrella : this) {
+  const mach_header_64 *hdr = getHeader(this, MH_DYLIB);
+  if (!hdr)
+    return;
+
+  const char *buf = mb.getBufferStart();
+  const symtab_command *symtabCmd = nullptr;
+  const dyld_info_command *dyldInfo = nullptr;
+  for (const load_command *cmd : getLoadCommands(this, hdr)) {
+    switch (cmd->cmd) {
+    case LC_ID_DYLIB: {
+      auto *c = reinterpret_cast<const dylib_command *>(cmd);
+      installName = reinterpret_cast<const char *>(cmd) + c->dylib.name;
+      compatibilityVersion = c->dylib.compatibility_version;
+      currentVersion = c->dylib.current_version;
+      break;
+    }
+    case LC_REEXPORT_DYLIB: {
+      auto *c = reinterpret_cast<const dylib_command *>(cmd);
+      reexportedLibraries.push_back(reinterpret_cast<const char *>(cmd) +
+                                    c->dylib.name);
+      break;
+    }
+    case LC_DYLD_INFO:
+    case LC_DYLD_INFO_ONLY:
+      dyldInfo = reinterpret_cast<const dyld_info_command *>(cmd);
+      break;
+    case LC_SYMTAB:
+      symtabCmd = reinterpret_cast<const symtab_command *>(cmd);
+      break;
+    }
+  }
+
+  if (installName.empty()) {
+    error(toString(this) + ": dylib has no LC_ID_DYLIB");
+    return;
+  }
+
+  // The export trie is the authoritative list of the exported symbols; old
+  // dylibs and the ones that use chained fixups only have the symbol table.
+  if (dyldInfo && dyldInfo->export_size) {
+    if (uint64_t(dyldInfo->export_off) + dyldInfo->export_size >
+        mb.getBufferSize()) {
+      error(toString(this) + ": export trie extends beyond end of file");
+      return;
+    }
+    parseExportTrie(reinterpret_cast<const uint8_t *>(buf) +
+                        dyldInfo->export_off,
+                    dyldInfo->export_size);
+    return;
+  }
+
+  if (!symtabCmd)
+    return;
+  if (uint64_t(symtabCmd->symoff) +
+              uint64_t(symtabCmd->nsyms) * sizeof(nlist_64) >
+          mb.getBufferSize() ||
+      uint64_t(symtabCmd->stroff) + symtabCmd->strsize > mb.getBufferSize()) {
+    error(toString(this) + ": symbol table extends beyond end of file");
+    return;
+  }
+  auto *nList = reinterpret_cast<const nlist_64 *>(buf + symtabCmd->symoff);
+  for (uint32_t i = 0; i < symtabCmd->nsyms; ++i) {
+    const nlist_64 &sym = nList[i];
+    if ((sym.n_type & N_STAB) || !(sym.n_type & N_EXT) ||
+        (sym.n_type & N_PEXT) || (sym.n_type & N_TYPE) == N_UNDF ||
+        sym.n_strx >= symtabCmd->strsize)
+      continue;
+    addSymbol(buf + symtabCmd->stroff + sym.n_strx, sym.n_desc & N_WEAK_DEF);
+  }
+}
+
+DylibFile::DylibFile(std::shared_ptr<InterfaceFile> interface,
+                     MemoryBufferRef mb, DylibFile *umbrella)
+    : InputFile(DylibKind, mb), umbrella(umbrella ? umbrella : this) {
+  if (!interface->getArchitectures().has(config->arch)) {
+    error(toString(this) + ": is incompatible with the target architecture");
+    return;
+  }
+
+  installName = saver.save(interface->getInstallName());
+  compatibilityVersion = interface->getCompatibilityVersion().rawValue();
+  currentVersion = interface->getCurrentVersion().rawValue();
+
+  // The names are owned by the interface, which doesn't outlive this
+  // constructor, so they are copied.
+  for (const auto *sym : interface->symbols()) {
+    if (!sym->getArchitectures().has(config->arch) || sym->isUndefined())
+      continue;
+    bool isWeakDef = sym->isWeakDefined();
+    StringRef name = sym->getName();
+    switch (sym->getKind()) {
+    case SymbolKind::GlobalSymbol:
+      addSymbol(saver.save(name), isWeakDef);
+      break;
+    case SymbolKind::ObjectiveCClass:
+      addSymbol(saver.save("_OBJC_CLASS_$_" + name), isWeakDef);
+      addSymbol(saver.save("_OBJC_METACLASS_$_" + name), isWeakDef);
+      break;
+    case SymbolKind::ObjectiveCClassEHType:
+      addSymbol(saver.save("_OBJC_EHTYPE_$_" + name), isWeakDef);
+      break;
+    case SymbolKind::ObjectiveCInstanceVariable:
+      addSymbol(saver.save("_OBJC_IVAR_$_" + name), isWeakDef);
+      break;
+    }
+  }
+
+  for (const InterfaceFileRef &ref : interface->reexportedLibraries())
+    if (ref.hasArchitecture(config->arch))
+      reexportedLibraries.push_back(saver.save(ref.getInstallName()));
+}
+
+void DylibFile::addSymbol(StringRef name, bool isWeakDef) {
+  symbols.push_back(symtab->addDylib(name, umbrella, isWeakDef));
+}
+
+// Walks the export trie of a dylib. Each node has an optional terminal part,
+// which describes the symbol whose name is the concatenation of the edge
+// labels from the root, followed by the edges to the child nodes.
+void DylibFile::parseExportTrie(const uint8_t *start, uint32_t size) {
+  const uint8_t *end = start + size;
+  std::vector<std::pair<uint64_t, std::string>> worklist = {{0, ""}};
+  DenseSet<uint64_t> visited;
+  while (!worklist.empty()) {
+    uint64_t offset;
+    std::string prefix;
+    std::tie(offset, prefix) = worklist.back();
+    worklist.pop_back();
+    if (offset >= size || !visited.insert(offset).second) {
+      error(toString(this) + ": malformed export trie");
+      return;
+    }
+
+    const char *err = nullptr;
+    unsigned n;
+    const uint8_t *p = start + offset;
+    uint64_t terminalSize = decodeULEB128(p, &n, end, &err);
+    p += n;
+    const uint8_t *children = p + terminalSize;
+    if (!err && terminalSize) {
+      uint64_t flags = decodeULEB128(p, &n, end, &err);
+      if (!err)
+        addSymbol(saver.save(prefix),
+                  flags & EXPORT_SYMBOL_FLAGS_WEAK_DEFINITION);
+    }
+    if (err || children >= end) {
+      error(toString(this) + ": malformed export trie");
+      return;
+    }
+
+    p = children;
+    uint8_t numChildren = *p++;
+    for (uint8_t i = 0; i < numChildren; ++i) {
+      const uint8_t *label = p;
+      while (p < end && *p)
+        ++p;
+      if (p == end) {
+        error(toString(this) + ": malformed export trie");
+        return;
+      }
+      std::string childPrefix =
+          prefix + std::string(reinterpret_cast<const char *>(label),
+                               p - label);
+      ++p;
+      uint64_t childOffset = decodeULEB128(p, &n, end, &err);
+      if (err) {
+        error(toString(this) + ": malformed export trie");
+        return;
+      }
+      p += n;
+      worklist.push_back({childOffset, std::move(childPrefix)});
+    }
+  }
+}
+
+// Finds the file of a re-exported library under the system library roots.
+// Text-based stubs take precedence over the dylibs themselves, as the SDKs
+// only ship the former.
+static Optional<std::string> findReexport(StringRef installName) {
+  for (StringRef root : config->systemLibraryRoots) {
+    SmallString<261> path = root;
+    path::append(path, installName);
+    SmallString<261> tbd = path;
+    path::replace_extension(tbd, ".tbd");
+    if (fs::exists(tbd))
+      return tbd.str().str();
+    if (fs::exists(path))
+      return path.str().str();
+  }
+  return None;
+}
+
+static void loadReexportsRecursively(DylibFile *file,
+                                     DenseSet<CachedHashStringRef> &loaded) {
+
+  for (StringRef installName : file->reexportedLibraries) {
+    if (!loaded.insert(CachedHashStringRef(installName)).second)
+      continue;
+    Optional<std::string> path = findReexport(installName);
+    if (!path) {
+      error(toString(file) + ": unable to locate re-export " + installName);
+      continue;
+    }
+    Optional<MemoryBufferRef> mb = readFile(saver.save(*path));
+    if (!mb)
+      continue;
+
+    DylibFile *reexport;
+    if (identify_magic(mb->getBuffer()) == file_magic::tapi_file) {
+      Expected<std::unique_ptr<InterfaceFile>> result =
+          TextAPIReader::get(*mb);
+      if (!result) {
+        error(*path + ": " + toString(result.takeError()));
+        continue;
+      }
+      reexport = make<DylibFile>(std::move(*result), *mb, file);
+    } else {
+      reexport = make<DylibFile>(*mb, file);
+    }
+    file->reexported.push_back(reexport);
+    loadReexportsRecursively(reexport, loaded);
+  }
+}
+
+void macho::loadReexports(DylibFile *file) {
+  // Re-exports may be cyclic.
+  DenseSet<CachedHashStringRef> loaded;
+  loaded.insert(CachedHashStringRef(file->installName));
+  loadReexportsRecursively(file, loaded);
+}
+
+ArchiveFile::ArchiveFile(std::unique_ptr<llvm::object::Archive> &&f)
+    : InputFile(ArchiveKind, f->getMemoryBufferRef()), file(std::move(f)) {}
+
+void ArchiveFile::addLazySymbols() {
+  for (const object::Archive::Symbol &sym : file->symbols())
+    symtab->addLazy(sym.getName(), this, sym);
+}
+
+void ArchiveFile::fetch(const object::Archive::Symbol &sym) {
+  object::Archive::Child c =
+      CHECK(sym.getMember(), toString(this) +
+                                 ": could not get the member for symbol " +
+                                 sym.getName());
+  fetchMember(c);
+}
+
+void ArchiveFile::fetchAll() {
+  Error err = Error::success();
+  for (const object::Archive::Child &c : file->children(err))
+    fetchMember(c);
+  if (err)
+    error(toString(this) + ": Archive::children failed: " +
+          toString(std::move(err)));
+}
+
+void ArchiveFile::fetchMember(const object::Archive::Child &c) {
+  if (!seen.insert(c.getChildOffset()).second)
+    return;
+
+  MemoryBufferRef mb =
+      CHECK(c.getMemoryBufferRef(),
+            toString(this) +
+                ": could not get the buffer for the member defining symbol");
+
+  // The symbol table of the archive lists only object files, but a member
+  // loaded through -all_load or -force_load may be anything.
+  if (identify_magic(mb.getBuffer()) != file_magic::macho_object) {
+    error(toString(this) + ": member " + mb.getBufferIdentifier() +
+          " is not a Mach-O object file");
+    return;
+  }
+
+  auto *obj = make<ObjFile>(mb, getName());
+  inputFiles.push_back(obj);
+  obj->parseSections();
+  obj->parseSymbols();
+}
+
+// Returns "<internal>", "foo.a(bar.o)" or "baz.o".
+std::string lld::toString(const InputFile *f) {
+  if (!f)
+    return "<internal>";
+  if (f->archiveName.empty())
+    return f->getName();
+  return (path::filename(f->archiveName) + "(" +
+          path::filename(f->getName()) + ")")
+      .str();
+}
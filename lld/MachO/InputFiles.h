@@ -0,0 +1,166 @@
+//===- InputFiles.h ---------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_INPUT_FILES_H
+#define LLD_MACHO_INPUT_FILES_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/BinaryFormat/MachO.h"
+#include "llvm/Object/Archive.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <map>
+#include <vector>
+
+namespace llvm {
+namespace MachO {
+class InterfaceFile;
+} // namespace MachO
+} // namespace llvm
+
+namespace lld {
+namespace macho {
+
+class InputSection;
+class Symbol;
+struct Reloc;
+
+class InputFile {
+public:
+  enum Kind {
+    ObjKind,
+    DylibKind,
+    ArchiveKind,
+  };
+
+  virtual ~InputFile() = default;
+  Kind kind() const { return fileKind; }
+  StringRef getName() const { return mb.getBufferIdentifier(); }
+
+  MemoryBufferRef mb;
+
+  // The symbols of the file, indexed by their position in its symbol table.
+  // Entries for symbols that the linker doesn't track, like debug symbols,
+  // are null.
+  std::vector<Symbol *> symbols;
+
+  // The sections of the file, indexed by their ordinal minus one. Entries for
+  // sections that aren't copied to the output are null.
+  std::vector<InputSection *> sections;
+
+  // If this file was read from an archive, the path of the archive.
+  StringRef archiveName;
+
+protected:
+  InputFile(Kind kind, MemoryBufferRef mb) : mb(mb), fileKind(kind) {}
+
+private:
+  const Kind fileKind;
+};
+
+// .o file
+class ObjFile : public InputFile {
+public:
+  explicit ObjFile(MemoryBufferRef mb, StringRef archiveName = "");
+  static bool classof(const InputFile *f) { return f->kind() == ObjKind; }
+
+  // Reads the sections. This doesn't depend on any other file, so it is done
+  // for all object files in parallel.
+  void parseSections();
+
+  // Reads the symbol table and adds the global symbols to the SymbolTable.
+  void parseSymbols();
+
+  // Reads the relocations. Their targets are only looked up, so this runs in
+  // parallel once symbol resolution is done.
+  void parseRelocations();
+
+private:
+  const llvm::MachO::section_64 *getSectionHeaders() const;
+  InputSection *findContainingSection(uint64_t addr) const;
+  void parseRelocation(InputSection *isec, const llvm::MachO::section_64 &sec,
+                       ArrayRef<llvm::MachO::any_relocation_info> relInfos,
+                       size_t &i);
+
+  const llvm::MachO::mach_header_64 *header = nullptr;
+  const llvm::MachO::symtab_command *symtabCmd = nullptr;
+  uint32_t numSections = 0;
+};
+
+// .dylib or .tbd file
+class DylibFile : public InputFile {
+public:
+  // Reads a binary dylib. \p umbrella is the dylib that re-exports this one,
+  // if any; the symbols are then bound through the umbrella.
+  explicit DylibFile(MemoryBufferRef mb, DylibFile *umbrella = nullptr);
+
+  // Reads a text-based stub.
+  explicit DylibFile(std::shared_ptr<llvm::MachO::InterfaceFile> interface,
+                     MemoryBufferRef mb, DylibFile *umbrella = nullptr);
+
+  static bool classof(const InputFile *f) { return f->kind() == DylibKind; }
+
+  StringRef installName;
+  uint32_t compatibilityVersion = 0;
+  uint32_t currentVersion = 0;
+  // The ordinal of this dylib in the output's load commands.
+  uint32_t ordinal = 0;
+  // The install names of the libraries that this one re-exports.
+  std::vector<StringRef> reexportedLibraries;
+  // The dylibs that this one re-exports, once they have been loaded.
+  std::vector<DylibFile *> reexported;
+
+private:
+  void addSymbol(StringRef name, bool isWeakDef);
+  void parseExportTrie(const uint8_t *start, uint32_t size);
+
+  DylibFile *umbrella;
+};
+
+// .a file
+class ArchiveFile : public InputFile {
+public:
+  explicit ArchiveFile(std::unique_ptr<llvm::object::Archive> &&file);
+  static bool classof(const InputFile *f) { return f->kind() == ArchiveKind; }
+
+  // Adds lazy symbols for all the symbols of the archive symbol table.
+  void addLazySymbols();
+
+  // Loads the member that defines \p sym.
+  void fetch(const llvm::object::Archive::Symbol &sym);
+
+  // Loads all the object files of the archive.
+  void fetchAll();
+
+private:
+  void fetchMember(const llvm::object::Archive::Child &c);
+
+  std::unique_ptr<llvm::object::Archive> file;
+  // Keep track of children fetched from the archive by tracking
+  // which address offsets have been fetched already.
+  llvm::DenseSet<uint64_t> seen;
+};
+
+// Returns the contents of the file at \p path, or None after reporting an
+// error.
+llvm::Optional<MemoryBufferRef> readFile(StringRef path);
+
+// Loads the dylibs that \p file re-exports from the system library roots.
+void loadReexports(DylibFile *file);
+
+// All input files, in the order in which they were loaded.
+extern std::vector<InputFile *> inputFiles;
+
+} // namespace macho
+
+std::string toString(const macho::InputFile *file);
+} // namespace lld
+
+#endif
@@ -0,0 +1,54 @@
+//===- InputSection.cpp ---------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "InputSection.h"
+#include "InputFiles.h"
+#include "OutputSection.h"
+#include "Symbols.h"
+#include "Target.h"
+#include "lld/Common/Memory.h"
+
+using namespace llvm;
+using namespace llvm::MachO;
+using namespace lld;
+using namespace lld::macho;
+
+std::vector<InputSection *> macho::inputSections;
+
+uint64_t InputSection::getFileOffset() const {
+  return parent->fileOff + outSecOff;
+}
+
+uint64_t InputSection::getVA() const { return parent->addr + outSecOff; }
+
+static uint64_t resolveVA(PointerUnion<Symbol *, InputSection *> referent,
+                          uint8_t type) {
+  if (auto *sym = referent.dyn_cast<Symbol *>())
+    return target->resolveSymbolVA(*sym, type);
+  return referent.get<InputSection *>()->getVA();
+}
+
+void InputSection::writeTo(uint8_t *buf) {
+  if (isZeroFill())
+    return;
+  memcpy(buf, data.data(), data.size());
+
+  for (const Reloc &r : relocs) {
+    uint64_t va = resolveVA(r.referent, r.type) + r.addend;
+    if (r.subtrahend)
+      va -= resolveVA(r.subtrahend, r.type);
+    target->relocateOne(buf + r.offset, r, va, getVA() + r.offset);
+  }
+}
+
+std::string lld::toString(const InputSection *isec) {
+  std::string name = (isec->segname + "," + isec->name).str();
+  if (!isec->file)
+    return "<internal>:(" + name + ")";
+  return toString(isec->file) + ":(" + name + ")";
+}
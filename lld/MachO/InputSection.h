@@ -0,0 +1,101 @@
+//===- InputSection.h -------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_INPUT_SECTION_H
+#define LLD_MACHO_INPUT_SECTION_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/PointerUnion.h"
+#include "llvm/BinaryFormat/MachO.h"
+
+namespace lld {
+namespace macho {
+
+class InputFile;
+class InputSection;
+class OutputSection;
+class Symbol;
+
+// A relocation, with its target already resolved to a symbol or to a section
+// of the same file. The value written is the address of the referent plus
+// the addend; for SUBTRACTOR relocations the address of the subtrahend is
+// then subtracted.
+struct Reloc {
+  uint8_t type = 0;
+  bool pcrel = false;
+  // log2 of the size of the relocated field.
+  uint8_t length = 0;
+  // The offset of the relocated field from the start of its section.
+  uint32_t offset = 0;
+  int64_t addend = 0;
+  llvm::PointerUnion<Symbol *, InputSection *> referent;
+  llvm::PointerUnion<Symbol *, InputSection *> subtrahend;
+};
+
+// An input section is a contiguous chunk of data that is copied to the output
+// as a whole. Regular sections are read from object files; synthetic sections
+// are created by the linker and derive from this class too, so that both are
+// laid out and written by the same code.
+class InputSection {
+public:
+  enum Kind { RegularKind, SyntheticKind };
+
+  InputSection(Kind k = RegularKind) : sectionKind(k) {}
+  virtual ~InputSection() = default;
+
+  Kind kind() const { return sectionKind; }
+
+  // The size of the section in memory.
+  virtual uint64_t getSize() const { return data.size(); }
+  // The size of the section in the output file; zero for zerofill sections.
+  uint64_t getFileSize() const { return isZeroFill() ? 0 : getSize(); }
+
+  uint64_t getFileOffset() const;
+  uint64_t getVA() const;
+
+  bool isZeroFill() const {
+    return (flags & llvm::MachO::SECTION_TYPE) == llvm::MachO::S_ZEROFILL ||
+           (flags & llvm::MachO::SECTION_TYPE) ==
+               llvm::MachO::S_THREAD_LOCAL_ZEROFILL;
+  }
+
+  // Copies the contents of the section to buf and applies the relocations.
+  virtual void writeTo(uint8_t *buf);
+
+  InputFile *file = nullptr;
+  StringRef name;
+  StringRef segname;
+
+  OutputSection *parent = nullptr;
+  // The offset of this section from the start of its output section.
+  uint64_t outSecOff = 0;
+
+  uint32_t align = 1;
+  uint32_t flags = 0;
+  // The address of the section in its object file, used to resolve the
+  // relocations that refer to addresses rather than to symbols.
+  uint64_t addr = 0;
+
+  // The contents of the section. For zerofill sections only the size is
+  // meaningful.
+  ArrayRef<uint8_t> data;
+  std::vector<Reloc> relocs;
+
+private:
+  Kind sectionKind;
+};
+
+extern std::vector<InputSection *> inputSections;
+
+} // namespace macho
+
+std::string toString(const macho::InputSection *);
+} // namespace lld
+
+#endif
@@ -0,0 +1,60 @@
+//===- OutputSection.cpp --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OutputSection.h"
+#include "InputSection.h"
+#include "OutputSegment.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Threads.h"
+#include "llvm/Support/MathExtras.h"
+
+using namespace llvm;
+using namespace llvm::MachO;
+using namespace lld;
+using namespace lld::macho;
+
+void OutputSection::addInput(InputSection *isec) {
+  if (inputs.empty()) {
+    flags = isec->flags;
+  } else if ((flags & SECTION_TYPE) != (isec->flags & SECTION_TYPE)) {
+    error("cannot merge " + toString(isec) + " with sections of type " +
+          Twine(flags & SECTION_TYPE));
+  } else {
+    // The attributes are the union of the ones of the inputs, except for
+    // S_ATTR_PURE_INSTRUCTIONS which must hold for all of them.
+    uint32_t pure = flags & isec->flags & S_ATTR_PURE_INSTRUCTIONS;
+    flags = ((flags | isec->flags) & ~S_ATTR_PURE_INSTRUCTIONS) | pure;
+  }
+  align = std::max(align, isec->align);
+  isec->parent = this;
+  inputs.push_back(isec);
+}
+
+void OutputSection::finalize() {
+  uint64_t off = 0;
+  for (InputSection *isec : inputs) {
+    off = alignTo(off, isec->align);
+    isec->outSecOff = off;
+    off += isec->getSize();
+  }
+  size = off;
+  fileSize = isZeroFill() ? 0 : size;
+}
+
+bool OutputSection::isZeroFill() const {
+  uint32_t type = flags & SECTION_TYPE;
+  return type == S_ZEROFILL || type == S_THREAD_LOCAL_ZEROFILL;
+}
+
+void OutputSection::writeTo(uint8_t *buf) const {
+  if (isZeroFill())
+    return;
+  parallelForEach(inputs, [&](InputSection *isec) {
+    isec->writeTo(buf + isec->outSecOff);
+  });
+}
@@ -0,0 +1,69 @@
+//===- OutputSection.h ------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_OUTPUT_SECTION_H
+#define LLD_MACHO_OUTPUT_SECTION_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <vector>
+
+namespace lld {
+namespace macho {
+
+class InputSection;
+class OutputSegment;
+
+// An output section is the concatenation of the input sections that have the
+// same segment and section names. Synthetic sections that aren't described by
+// a section header, like the Mach-O header or the contents of __LINKEDIT, get
+// an output section of their own that is marked hidden.
+class OutputSection {
+public:
+  OutputSection(StringRef name) : name(name) {}
+
+  void addInput(InputSection *isec);
+
+  // Assigns the offsets of the input sections and computes the size.
+  void finalize();
+
+  uint64_t getSize() const { return size; }
+  uint64_t getFileSize() const { return fileSize; }
+
+  bool isZeroFill() const;
+
+  // Writes the contents of all input sections. The input sections are
+  // independent of each other, so they are copied and relocated in parallel.
+  void writeTo(uint8_t *buf) const;
+
+  StringRef name;
+  OutputSegment *parent = nullptr;
+  std::vector<InputSection *> inputs;
+
+  // The 1-based index of this section in the output, as used by the n_sect
+  // field of symbols. Hidden sections have no index.
+  uint32_t index = 0;
+  bool hidden = false;
+
+  uint64_t addr = 0;
+  uint64_t fileOff = 0;
+  uint32_t align = 1;
+  uint32_t flags = 0;
+  uint32_t reserved1 = 0;
+  uint32_t reserved2 = 0;
+
+private:
+  uint64_t size = 0;
+  uint64_t fileSize = 0;
+};
+
+} // namespace macho
+} // namespace lld
+
+#endif
@@ -0,0 +1,74 @@
+//===- OutputSegment.cpp --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "OutputSegment.h"
+#include "OutputSection.h"
+#include "lld/Common/Memory.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/BinaryFormat/MachO.h"
+
+using namespace llvm;
+using namespace llvm::MachO;
+using namespace lld;
+using namespace lld::macho;
+
+std::vector<OutputSegment *> macho::outputSegments;
+
+static uint32_t initProt(StringRef name) {
+  if (name == segment_names::pageZero)
+    return 0;
+  if (name == segment_names::text)
+    return VM_PROT_READ | VM_PROT_EXECUTE;
+  if (name == segment_names::linkEdit)
+    return VM_PROT_READ;
+  return VM_PROT_READ | VM_PROT_WRITE;
+}
+
+OutputSegment *macho::getOrCreateOutputSegment(StringRef name) {
+  for (OutputSegment *seg : outputSegments)
+    if (seg->name == name)
+      return seg;
+  auto *seg = make<OutputSegment>(name, initProt(name));
+  outputSegments.push_back(seg);
+  return seg;
+}
+
+OutputSection *OutputSegment::getOrCreateOutputSection(StringRef sectName) {
+  for (OutputSection *osec : sections)
+    if (!osec->hidden && osec->name == sectName)
+      return osec;
+  auto *osec = make<OutputSection>(sectName);
+  addOutputSection(osec);
+  return osec;
+}
+
+void OutputSegment::addOutputSection(OutputSection *osec) {
+  osec->parent = this;
+  sections.push_back(osec);
+}
+
+void OutputSegment::sortOutputSections() {
+  auto rank = [](const OutputSection *osec) {
+    if (osec->hidden)
+      return 0;
+    if (osec->isZeroFill())
+      return 2;
+    return 1;
+  };
+  llvm::stable_sort(sections, [&](OutputSection *a, OutputSection *b) {
+    return rank(a) < rank(b);
+  });
+}
+
+std::vector<OutputSection *> OutputSegment::getVisibleSections() const {
+  std::vector<OutputSection *> v;
+  for (OutputSection *osec : sections)
+    if (!osec->hidden)
+      v.push_back(osec);
+  return v;
+}
@@ -0,0 +1,73 @@
+//===- OutputSegment.h ------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_OUTPUT_SEGMENT_H
+#define LLD_MACHO_OUTPUT_SEGMENT_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <vector>
+
+namespace lld {
+namespace macho {
+
+namespace segment_names {
+
+constexpr const char *pageZero = "__PAGEZERO";
+constexpr const char *text = "__TEXT";
+constexpr const char *dataConst = "__DATA_CONST";
+constexpr const char *data = "__DATA";
+constexpr const char *linkEdit = "__LINKEDIT";
+
+} // namespace segment_names
+
+class InputSection;
+class OutputSection;
+
+class OutputSegment {
+public:
+  OutputSegment(StringRef name, uint32_t prot)
+      : name(name), maxProt(prot), initProt(prot) {}
+
+  // Returns the output section with the given name, creating it if needed.
+  OutputSection *getOrCreateOutputSection(StringRef sectName);
+
+  void addOutputSection(OutputSection *osec);
+
+  // Orders the sections: hidden ones (the Mach-O header) first, zerofill
+  // ones last as the loader requires, the others in creation order.
+  void sortOutputSections();
+
+  // Returns the sections that get a section header.
+  std::vector<OutputSection *> getVisibleSections() const;
+
+  StringRef name;
+  uint32_t maxProt;
+  uint32_t initProt;
+  // The index of the segment in the output, for the dyld info opcodes.
+  uint8_t index = 0;
+
+  uint64_t addr = 0;
+  uint64_t fileOff = 0;
+  uint64_t vmSize = 0;
+  uint64_t fileSize = 0;
+
+  std::vector<OutputSection *> sections;
+};
+
+// Returns the segment with the given name, creating it if needed.
+OutputSegment *getOrCreateOutputSegment(StringRef name);
+
+// All output segments, in the order in which they appear in the output.
+extern std::vector<OutputSegment *> outputSegments;
+
+} // namespace macho
+} // namespace lld
+
+#endif
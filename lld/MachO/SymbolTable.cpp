@@ -0,0 +1,153 @@
+//===- SymbolTable.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SymbolTable.h"
+#include "InputFiles.h"
+#include "Symbols.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Memory.h"
+
+using namespace llvm;
+using namespace lld;
+using namespace lld::macho;
+
+SymbolTable *macho::symtab;
+
+Symbol *SymbolTable::find(StringRef name) {
+  auto it = symMap.find(CachedHashStringRef(name));
+  if (it == symMap.end())
+    return nullptr;
+  return symVector[it->second];
+}
+
+std::pair<Symbol *, bool> SymbolTable::insert(StringRef name) {
+  auto p = symMap.insert({CachedHashStringRef(name), (int)symVector.size()});
+
+  // Name already present in the symbol table.
+  if (!p.second)
+    return {symVector[p.first->second], false};
+
+  // Name is a new symbol.
+  Symbol *sym = reinterpret_cast<Symbol *>(make<SymbolUnion>());
+  symVector.push_back(sym);
+  return {sym, true};
+}
+
+static void reportDuplicate(const Defined *existing, const InputFile *file) {
+  error("duplicate symbol: " + toString(*existing) + "\n>>> defined in " +
+        toString(existing->file) + "\n>>> defined in " + toString(file));
+}
+
+Symbol *SymbolTable::addDefined(StringRef name, InputFile *file,
+                                InputSection *isec, uint64_t value,
+                                bool isWeakDef, bool isPrivateExtern) {
+  Symbol *s;
+  bool wasInserted;
+  std::tie(s, wasInserted) = insert(name);
+
+  if (!wasInserted) {
+    if (auto *defined = dyn_cast<Defined>(s)) {
+      // A weak definition loses against any other definition; of two weak
+      // definitions the first one wins.
+      if (isWeakDef)
+        return s;
+      if (!defined->isWeakDef()) {
+        reportDuplicate(defined, file);
+        return s;
+      }
+    }
+    // Definitions in object files take precedence over tentative definitions,
+    // dylibs and archives.
+  }
+
+  replaceSymbol<Defined>(s, name, file, isec, value, isWeakDef,
+                         /*isExternal=*/true, isPrivateExtern);
+  return s;
+}
+
+Symbol *SymbolTable::addUndefined(StringRef name, InputFile *file) {
+  Symbol *s;
+  bool wasInserted;
+  std::tie(s, wasInserted) = insert(name);
+
+  if (wasInserted)
+    replaceSymbol<Undefined>(s, name, file);
+  else if (auto *lazy = dyn_cast<LazySymbol>(s))
+    lazy->fetch();
+  return s;
+}
+
+Symbol *SymbolTable::addCommon(StringRef name, InputFile *file, uint64_t size,
+                               uint32_t align) {
+  Symbol *s;
+  bool wasInserted;
+  std::tie(s, wasInserted) = insert(name);
+
+  if (!wasInserted) {
+    if (auto *common = dyn_cast<CommonSymbol>(s)) {
+      // Of several tentative definitions, the largest one wins.
+      common->align = std::max(common->align, align);
+      if (size > common->size) {
+        common->size = size;
+        common->file = file;
+      }
+      return s;
+    }
+    if (isa<Defined>(s))
+      return s;
+  }
+
+  replaceSymbol<CommonSymbol>(s, name, file, size, align);
+  return s;
+}
+
+Symbol *SymbolTable::addDylib(StringRef name, DylibFile *file,
+                              bool isWeakDef) {
+  Symbol *s;
+  bool wasInserted;
+  std::tie(s, wasInserted) = insert(name);
+
+  // Files are searched in command line order, so the first library that
+  // provides the symbol is the one that is used.
+  if (wasInserted || isa<Undefined>(s))
+    replaceSymbol<DylibSymbol>(s, file, name, isWeakDef);
+  return s;
+}
+
+Symbol *SymbolTable::addLazy(StringRef name, ArchiveFile *file,
+                             const llvm::object::Archive::Symbol &sym) {
+  Symbol *s;
+  bool wasInserted;
+  std::tie(s, wasInserted) = insert(name);
+
+  if (wasInserted)
+    replaceSymbol<LazySymbol>(s, file, sym);
+  else if (isa<Undefined>(s))
+    file->fetch(sym);
+  return s;
+}
+
+Symbol *SymbolTable::addSynthetic(StringRef name, InputSection *isec,
+                                  uint64_t value, bool isPrivateExtern) {
+  Symbol *s;
+  bool wasInserted;
+  std::tie(s, wasInserted) = insert(name);
+
+  if (!wasInserted) {
+    if (auto *defined = dyn_cast<Defined>(s)) {
+      error("duplicate symbol: " + toString(*s) + "\n>>> defined in " +
+            toString(defined->file) + "\n>>> defined by the linker");
+      return s;
+    }
+  }
+
+  replaceSymbol<Defined>(s, name, /*file=*/nullptr, isec, value,
+                         /*isWeakDef=*/false, /*isExternal=*/true,
+                         isPrivateExtern);
+  return s;
+}
@@ -0,0 +1,73 @@
+//===- SymbolTable.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_SYMBOL_TABLE_H
+#define LLD_MACHO_SYMBOL_TABLE_H
+
+#include "lld/Common/LLVM.h"
+#include "llvm/ADT/CachedHashString.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Object/Archive.h"
+
+namespace lld {
+namespace macho {
+
+class ArchiveFile;
+class DylibFile;
+class InputFile;
+class InputSection;
+class Symbol;
+
+// SymbolTable is a bucket of all known symbols, including defined,
+// undefined, or lazy symbols (the last one is symbols in archive
+// files whose archive members are not yet loaded).
+//
+// We put all symbols of all files to a SymbolTable, and the
+// SymbolTable selects the "best" symbols if there are name
+// conflicts. For example, obviously, a defined symbol is better than
+// an undefined symbol. Or, if there's a conflict between a lazy and a
+// undefined, it'll read an archive member to read a real definition
+// to replace the lazy symbol. The logic is implemented in the
+// add*() functions, which are called by input files as they are parsed.
+// There is one add* function per symbol type.
+class SymbolTable {
+public:
+  Symbol *addDefined(StringRef name, InputFile *file, InputSection *isec,
+                     uint64_t value, bool isWeakDef, bool isPrivateExtern);
+
+  Symbol *addUndefined(StringRef name, InputFile *file);
+
+  Symbol *addCommon(StringRef name, InputFile *file, uint64_t size,
+                    uint32_t align);
+
+  Symbol *addDylib(StringRef name, DylibFile *file, bool isWeakDef);
+
+  Symbol *addLazy(StringRef name, ArchiveFile *file,
+                  const llvm::object::Archive::Symbol &sym);
+
+  // Defines a symbol that the linker synthesizes, like the Mach-O header.
+  Symbol *addSynthetic(StringRef name, InputSection *isec, uint64_t value,
+                       bool isPrivateExtern);
+
+  Symbol *find(StringRef name);
+
+  ArrayRef<Symbol *> getSymbols() const { return symVector; }
+
+private:
+  std::pair<Symbol *, bool> insert(StringRef name);
+
+  llvm::DenseMap<llvm::CachedHashStringRef, int> symMap;
+  std::vector<Symbol *> symVector;
+};
+
+extern SymbolTable *symtab;
+
+} // namespace macho
+} // namespace lld
+
+#endif
@@ -0,0 +1,26 @@
+//===- Symbols.cpp --------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Symbols.h"
+#include "InputFiles.h"
+
+using namespace llvm;
+using namespace lld;
+using namespace lld::macho;
+
+void LazySymbol::fetch() { file->fetch(sym); }
+
+// Returns a symbol for an error message. C and C++ symbol names carry a
+// leading underscore on Darwin, which has to go before demangling.
+std::string lld::toString(const Symbol &sym) {
+  StringRef name = sym.getName();
+  if (name.startswith("__Z"))
+    if (Optional<std::string> s = demangleItanium(name.drop_front()))
+      return *s;
+  return name;
+}
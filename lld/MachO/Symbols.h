@@ -0,0 +1,195 @@
+//===- Symbols.h ------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_SYMBOLS_H
+#define LLD_MACHO_SYMBOLS_H
+
+#include "InputSection.h"
+#include "Target.h"
+#include "lld/Common/LLVM.h"
+#include "lld/Common/Strings.h"
+#include "llvm/Object/Archive.h"
+
+namespace lld {
+namespace macho {
+
+class InputFile;
+class ArchiveFile;
+class DylibFile;
+
+// The base class for all symbols. Symbols that are visible across files are
+// owned by the SymbolTable and are replaced in place as resolution proceeds,
+// so that the pointers held by the input files stay valid. Symbols that are
+// local to a file are allocated separately.
+class Symbol {
+public:
+  enum Kind {
+    DefinedKind,
+    UndefinedKind,
+    CommonKind,
+    DylibKind,
+    LazyKind,
+  };
+
+  Kind kind() const { return static_cast<Kind>(symbolKind); }
+
+  StringRef getName() const { return name; }
+
+  uint64_t getVA() const;
+
+  bool isInGot() const { return gotIndex != UINT32_MAX; }
+
+  bool isInStubs() const { return stubsIndex != UINT32_MAX; }
+
+  // The index of this symbol's entry in the GOT, or UINT32_MAX if it doesn't
+  // have one.
+  uint32_t gotIndex = UINT32_MAX;
+
+  // The index of this symbol's entry in the stubs section, or UINT32_MAX if it
+  // doesn't have one.
+  uint32_t stubsIndex = UINT32_MAX;
+
+  // The index of this symbol in the output symbol table, for the indirect
+  // symbol table.
+  uint32_t symtabIndex = UINT32_MAX;
+
+protected:
+  Symbol(Kind k, StringRef name) : name(name), symbolKind(k) {}
+
+  StringRef name;
+  uint8_t symbolKind;
+};
+
+class Defined : public Symbol {
+public:
+  Defined(StringRef name, InputFile *file, InputSection *isec, uint64_t value,
+          bool isWeakDef, bool isExternal, bool isPrivateExtern = false)
+      : Symbol(DefinedKind, name), file(file), isec(isec), value(value),
+        weakDef(isWeakDef), external(isExternal),
+        privateExtern(isPrivateExtern) {}
+
+  static bool classof(const Symbol *s) { return s->kind() == DefinedKind; }
+
+  bool isWeakDef() const { return weakDef; }
+
+  bool isExternal() const { return external; }
+
+  // Private extern symbols are resolved across files but not exported.
+  bool isPrivateExtern() const { return privateExtern; }
+
+  // Absolute symbols don't belong to any section.
+  bool isAbsolute() const { return isec == nullptr; }
+
+  uint64_t getVA() const {
+    return isAbsolute() ? value : isec->getVA() + value;
+  }
+
+  uint64_t getFileOffset() const { return isec->getFileOffset() + value; }
+
+  // The file that defines the symbol; null for linker-defined symbols.
+  InputFile *file;
+  InputSection *isec;
+  // The offset of the symbol in isec, or its value if it is absolute.
+  uint64_t value;
+
+private:
+  bool weakDef : 1;
+  bool external : 1;
+  bool privateExtern : 1;
+};
+
+class Undefined : public Symbol {
+public:
+  Undefined(StringRef name, InputFile *file)
+      : Symbol(UndefinedKind, name), file(file) {}
+
+  static bool classof(const Symbol *s) { return s->kind() == UndefinedKind; }
+
+  // The first file that referenced the symbol.
+  InputFile *file;
+};
+
+// A tentative definition: an uninitialized global variable that wasn't
+// declared `static` or `extern`. It is merged with the other tentative
+// definitions of the same name, and loses against a real definition.
+class CommonSymbol : public Symbol {
+public:
+  CommonSymbol(StringRef name, InputFile *file, uint64_t size, uint32_t align)
+      : Symbol(CommonKind, name), file(file), size(size), align(align) {}
+
+  static bool classof(const Symbol *s) { return s->kind() == CommonKind; }
+
+  InputFile *file;
+  uint64_t size;
+  uint32_t align;
+};
+
+class DylibSymbol : public Symbol {
+public:
+  DylibSymbol(DylibFile *file, StringRef name, bool isWeakDef)
+      : Symbol(DylibKind, name), file(file), weakDef(isWeakDef) {}
+
+  static bool classof(const Symbol *s) { return s->kind() == DylibKind; }
+
+  bool isWeakDef() const { return weakDef; }
+
+  // The dylib that the symbol is bound to at load time. If the symbol comes
+  // from a library that this dylib re-exports, this is the re-exporting one.
+  DylibFile *file;
+
+private:
+  bool weakDef;
+};
+
+// A symbol of an archive member that hasn't been loaded yet.
+class LazySymbol : public Symbol {
+public:
+  LazySymbol(ArchiveFile *file, const llvm::object::Archive::Symbol &sym)
+      : Symbol(LazyKind, sym.getName()), file(file), sym(sym) {}
+
+  static bool classof(const Symbol *s) { return s->kind() == LazyKind; }
+
+  void fetch();
+
+  ArchiveFile *file;
+  const llvm::object::Archive::Symbol sym;
+};
+
+inline uint64_t Symbol::getVA() const {
+  if (auto *d = dyn_cast<Defined>(this))
+    return d->getVA();
+  return 0;
+}
+
+union SymbolUnion {
+  alignas(Defined) char a[sizeof(Defined)];
+  alignas(Undefined) char b[sizeof(Undefined)];
+  alignas(CommonSymbol) char c[sizeof(CommonSymbol)];
+  alignas(DylibSymbol) char d[sizeof(DylibSymbol)];
+  alignas(LazySymbol) char e[sizeof(LazySymbol)];
+};
+
+template <typename T, typename... ArgT>
+T *replaceSymbol(Symbol *s, ArgT &&... arg) {
+  static_assert(std::is_trivially_destructible<T>(),
+                "Symbol types must be trivially destructible");
+  static_assert(sizeof(T) <= sizeof(SymbolUnion), "SymbolUnion too small");
+  static_assert(alignof(T) <= alignof(SymbolUnion),
+                "SymbolUnion not aligned enough");
+  assert(static_cast<Symbol *>(static_cast<T *>(nullptr)) == nullptr &&
+         "Not a Symbol");
+
+  return new (s) T(std::forward<ArgT>(arg)...);
+}
+
+} // namespace macho
+
+std::string toString(const macho::Symbol &);
+} // namespace lld
+
+#endif
@@ -0,0 +1,464 @@
+//===- SyntheticSections.cpp ---------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SyntheticSections.h"
+#include "Config.h"
+#include "ExportTrie.h"
+#include "InputFiles.h"
+#include "OutputSection.h"
+#include "OutputSegment.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "Writer.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Memory.h"
+#include "lld/Common/Threads.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace llvm::MachO;
+using namespace llvm::support::endian;
+using namespace lld;
+using namespace lld::macho;
+
+InStruct macho::in;
+
+SyntheticSection::SyntheticSection(const char *segname, const char *name)
+    : InputSection(SyntheticKind) {
+  this->segname = segname;
+  this->name = name;
+}
+
+uint8_t macho::getSectionIndex(const Defined &sym) {
+  if (sym.isAbsolute())
+    return NO_SECT;
+  const OutputSection *osec = sym.isec->parent;
+  if (!osec->hidden)
+    return osec->index;
+  // Symbols of hidden sections, like the Mach-O header, are attributed to
+  // the first section that follows them in their segment.
+  for (const OutputSection *s : osec->parent->sections)
+    if (!s->hidden)
+      return s->index;
+  return NO_SECT;
+}
+
+MachHeaderSection::MachHeaderSection()
+    : SyntheticSection(segment_names::text, "__mach_header") {}
+
+void MachHeaderSection::addLoadCommand(LoadCommand *lc) {
+  loadCommands.push_back(lc);
+  sizeOfCmds += lc->getSize();
+}
+
+uint64_t MachHeaderSection::getSize() const {
+  return sizeof(mach_header_64) + sizeOfCmds + config->headerPad;
+}
+
+void MachHeaderSection::writeTo(uint8_t *buf) {
+  auto *hdr = reinterpret_cast<mach_header_64 *>(buf);
+  hdr->magic = MH_MAGIC_64;
+  hdr->cputype = target->cpuType;
+  hdr->cpusubtype = target->cpuSubtype;
+  hdr->filetype = config->outputType;
+  hdr->ncmds = loadCommands.size();
+  hdr->sizeofcmds = sizeOfCmds;
+  hdr->flags = MH_DYLDLINK | MH_TWOLEVEL;
+  if (!in.binding->hasEntries())
+    hdr->flags |= MH_NOUNDEFS;
+  if (config->outputType == MH_EXECUTE) {
+    hdr->cpusubtype |= CPU_SUBTYPE_LIB64;
+    hdr->flags |= MH_PIE;
+  }
+  if (config->outputType == MH_DYLIB)
+    hdr->flags |= MH_NO_REEXPORTED_DYLIBS;
+
+  uint8_t *p = reinterpret_cast<uint8_t *>(hdr + 1);
+  for (LoadCommand *lc : loadCommands) {
+    lc->writeTo(p);
+    p += lc->getSize();
+  }
+}
+
+GotSection::GotSection()
+    : SyntheticSection(segment_names::dataConst, "__got") {
+  align = WordSize;
+  flags = S_NON_LAZY_SYMBOL_POINTERS;
+}
+
+void GotSection::addEntry(Symbol &sym) {
+  if (!entries.insert(&sym))
+    return;
+  sym.gotIndex = entries.size() - 1;
+  uint64_t offset = sym.gotIndex * WordSize;
+  if (auto *dysym = dyn_cast<DylibSymbol>(&sym))
+    in.binding->addEntry(*dysym, this, offset, /*addend=*/0);
+  else if (!cast<Defined>(sym).isAbsolute())
+    in.rebase->addEntry(this, offset);
+}
+
+uint64_t GotSection::getEntryVA(const Symbol &sym) const {
+  return getVA() + sym.gotIndex * WordSize;
+}
+
+void GotSection::writeTo(uint8_t *buf) {
+  // The entries of dylib symbols are filled in by the loader.
+  for (size_t i = 0, e = entries.size(); i != e; ++i)
+    if (auto *defined = dyn_cast<Defined>(entries[i]))
+      write64le(buf + i * WordSize, defined->getVA());
+}
+
+StubsSection::StubsSection()
+    : SyntheticSection(segment_names::text, "__stubs") {
+  align = 2;
+  flags = S_SYMBOL_STUBS | S_ATTR_SOME_INSTRUCTIONS | S_ATTR_PURE_INSTRUCTIONS;
+}
+
+void StubsSection::addEntry(Symbol &sym) {
+  if (!entries.insert(&sym))
+    return;
+  sym.stubsIndex = entries.size() - 1;
+  if (!sym.isInGot())
+    in.got->addEntry(sym);
+}
+
+uint64_t StubsSection::getSize() const {
+  return entries.size() * target->stubSize;
+}
+
+void StubsSection::writeTo(uint8_t *buf) {
+  for (size_t i = 0, e = entries.size(); i != e; ++i)
+    target->writeStub(buf + i * target->stubSize, *entries[i]);
+}
+
+LinkEditSection::LinkEditSection(const char *name)
+    : SyntheticSection(segment_names::linkEdit, name) {
+  align = WordSize;
+}
+
+void LinkEditSection::writeTo(uint8_t *buf) {
+  memcpy(buf, contents.data(), contents.size());
+}
+
+// Returns the index of the segment of a location and the offset of the
+// location in it, which is how the dyld info opcodes address memory.
+static std::pair<uint8_t, uint64_t> getSegmentOffset(const InputSection *isec,
+                                                     uint64_t offset) {
+  const OutputSegment *seg = isec->parent->parent;
+  return {seg->index, isec->getVA() + offset - seg->addr};
+}
+
+RebaseSection::RebaseSection() : LinkEditSection("__rebase") {}
+
+// Consecutive pointers are rebased by a single opcode. There are denser
+// encodings, but this one already makes the common case of a table of
+// pointers cheap.
+void RebaseSection::finalizeContents() {
+  if (locations.empty())
+    return;
+
+  std::vector<std::pair<uint8_t, uint64_t>> locs;
+  locs.reserve(locations.size());
+  for (const auto &loc : locations)
+    locs.push_back(getSegmentOffset(loc.first, loc.second));
+  llvm::sort(locs);
+
+  SmallString<128> buf;
+  raw_svector_ostream os(buf);
+  os << static_cast<uint8_t>(REBASE_OPCODE_SET_TYPE_IMM | REBASE_TYPE_POINTER);
+  for (size_t i = 0, e = locs.size(); i != e;) {
+    size_t j = i + 1;
+    while (j != e && locs[j].first == locs[i].first &&
+           locs[j].second == locs[j - 1].second + WordSize)
+      ++j;
+
+    os << static_cast<uint8_t>(REBASE_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB |
+                               locs[i].first);
+    encodeULEB128(locs[i].second, os);
+    size_t count = j - i;
+    if (count <= REBASE_IMMEDIATE_MASK) {
+      os << static_cast<uint8_t>(REBASE_OPCODE_DO_REBASE_IMM_TIMES | count);
+    } else {
+      os << static_cast<uint8_t>(REBASE_OPCODE_DO_REBASE_ULEB_TIMES);
+      encodeULEB128(count, os);
+    }
+    i = j;
+  }
+  os << static_cast<uint8_t>(REBASE_OPCODE_DONE);
+  contents.assign(buf.begin(), buf.end());
+}
+
+BindingSection::BindingSection() : LinkEditSection("__binding") {}
+
+// The opcodes keep the ordinal, the name and the addend of the previous
+// binding, so only the ones that change are emitted.
+void BindingSection::finalizeContents() {
+  if (bindings.empty())
+    return;
+
+  SmallString<128> buf;
+  raw_svector_ostream os(buf);
+  os << static_cast<uint8_t>(BIND_OPCODE_SET_TYPE_IMM | BIND_TYPE_POINTER);
+
+  uint32_t lastOrdinal = 0;
+  const DylibSymbol *lastSym = nullptr;
+  int64_t lastAddend = 0;
+  for (const BindingEntry &b : bindings) {
+    uint32_t ordinal = b.sym->file->ordinal;
+    if (ordinal != lastOrdinal) {
+      if (ordinal <= BIND_IMMEDIATE_MASK) {
+        os << static_cast<uint8_t>(BIND_OPCODE_SET_DYLIB_ORDINAL_IMM |
+                                   ordinal);
+      } else {
+        os << static_cast<uint8_t>(BIND_OPCODE_SET_DYLIB_ORDINAL_ULEB);
+        encodeULEB128(ordinal, os);
+      }
+      lastOrdinal = ordinal;
+    }
+    if (b.sym != lastSym) {
+      os << static_cast<uint8_t>(BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM)
+         << b.sym->getName() << '\0';
+      lastSym = b.sym;
+    }
+    if (b.addend != lastAddend) {
+      os << static_cast<uint8_t>(BIND_OPCODE_SET_ADDEND_SLEB);
+      encodeSLEB128(b.addend, os);
+      lastAddend = b.addend;
+    }
+
+    std::pair<uint8_t, uint64_t> loc = getSegmentOffset(b.isec, b.offset);
+    os << static_cast<uint8_t>(BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB |
+                               loc.first);
+    encodeULEB128(loc.second, os);
+    os << static_cast<uint8_t>(BIND_OPCODE_DO_BIND);
+  }
+  os << static_cast<uint8_t>(BIND_OPCODE_DONE);
+  contents.assign(buf.begin(), buf.end());
+}
+
+ExportSection::ExportSection() : LinkEditSection("__export") {}
+
+void ExportSection::finalizeContents() {
+  TrieBuilder trieBuilder(in.header->getVA());
+  for (const Symbol *sym : symtab->getSymbols())
+    if (auto *defined = dyn_cast<Defined>(sym))
+      if (!defined->isPrivateExtern())
+        trieBuilder.addSymbol(*defined);
+  contents.resize(trieBuilder.build());
+  trieBuilder.writeTo(contents.data());
+}
+
+StringTableSection::StringTableSection() : LinkEditSection("__string_table") {
+  // Offset 0 is the empty name.
+  contents.push_back('\0');
+}
+
+uint32_t StringTableSection::addString(StringRef str) {
+  uint32_t strx = contents.size();
+  contents.insert(contents.end(), str.begin(), str.end());
+  contents.push_back('\0');
+  return strx;
+}
+
+SymtabSection::SymtabSection(StringTableSection &stringTableSection)
+    : LinkEditSection("__symbol_table"),
+      stringTableSection(stringTableSection) {}
+
+void SymtabSection::finalizeContents() {
+  std::vector<Defined *> locals;
+  std::vector<Defined *> externals;
+  SetVector<DylibSymbol *> undefineds;
+
+  // Only the dylib symbols that the object files refer to are listed; the
+  // symbol table holds every symbol of the dylibs that were loaded.
+  for (InputFile *file : inputFiles) {
+    if (!isa<ObjFile>(file))
+      continue;
+    for (Symbol *sym : file->symbols) {
+      if (auto *defined = dyn_cast_or_null<Defined>(sym)) {
+        if (!defined->isExternal() && !defined->getName().empty())
+          locals.push_back(defined);
+      } else if (auto *dysym = dyn_cast_or_null<DylibSymbol>(sym)) {
+        undefineds.insert(dysym);
+      }
+    }
+  }
+
+  // Private extern symbols are resolved across files but are local to the
+  // output.
+  for (Symbol *sym : symtab->getSymbols()) {
+    if (auto *defined = dyn_cast<Defined>(sym)) {
+      if (defined->isPrivateExtern())
+        locals.push_back(defined);
+      else
+        externals.push_back(defined);
+    }
+  }
+
+  auto byName = [](const Symbol *a, const Symbol *b) {
+    return a->getName() < b->getName();
+  };
+  llvm::stable_sort(externals, byName);
+  std::vector<DylibSymbol *> undefs = undefineds.takeVector();
+  llvm::stable_sort(undefs, byName);
+
+  numLocals = locals.size();
+  numExternals = externals.size();
+  numUndefineds = undefs.size();
+  contents.resize(getNumSymbols() * sizeof(nlist_64));
+  auto *nList = reinterpret_cast<nlist_64 *>(contents.data());
+  uint32_t index = 0;
+
+  auto addDefined = [&](Defined *sym) {
+    nlist_64 &n = nList[index];
+    n.n_strx = stringTableSection.addString(sym->getName());
+    n.n_type = sym->isAbsolute() ? N_ABS : N_SECT;
+    if (sym->isPrivateExtern())
+      n.n_type |= N_PEXT;
+    else if (sym->isExternal())
+      n.n_type |= N_EXT;
+    n.n_sect = getSectionIndex(*sym);
+    n.n_desc = sym->isWeakDef() ? N_WEAK_DEF : 0;
+    n.n_value = sym->getVA();
+    sym->symtabIndex = index++;
+  };
+
+  for (Defined *sym : locals)
+    addDefined(sym);
+  for (Defined *sym : externals)
+    addDefined(sym);
+  for (DylibSymbol *sym : undefs) {
+    nlist_64 &n = nList[index];
+    n.n_strx = stringTableSection.addString(sym->getName());
+    n.n_type = N_UNDF | N_EXT;
+    n.n_sect = NO_SECT;
+    n.n_desc = 0;
+    SET_LIBRARY_ORDINAL(n.n_desc, sym->file->ordinal);
+    n.n_value = 0;
+    sym->symtabIndex = index++;
+  }
+}
+
+IndirectSymtabSection::IndirectSymtabSection()
+    : LinkEditSection("__indirect_symtab") {}
+
+// Each stub and each GOT entry has an entry here, in the order of the
+// sections. The first entry of a section is given by its reserved1 field.
+void IndirectSymtabSection::finalizeContents() {
+  auto getIndex = [](const Symbol *sym) -> uint32_t {
+    if (auto *defined = dyn_cast<Defined>(sym)) {
+      if (!defined->isExternal() || defined->isPrivateExtern())
+        return defined->isAbsolute()
+                   ? INDIRECT_SYMBOL_LOCAL | INDIRECT_SYMBOL_ABS
+                   : INDIRECT_SYMBOL_LOCAL;
+    }
+    return sym->symtabIndex;
+  };
+
+  ArrayRef<Symbol *> stubs = in.stubs->getEntries();
+  ArrayRef<Symbol *> got = in.got->getEntries();
+  contents.resize((stubs.size() + got.size()) * sizeof(uint32_t));
+  uint8_t *p = contents.data();
+
+  if (in.stubs->parent)
+    in.stubs->parent->reserved1 = 0;
+  for (const Symbol *sym : stubs) {
+    write32le(p, getIndex(sym));
+    p += sizeof(uint32_t);
+  }
+  if (in.got->parent)
+    in.got->parent->reserved1 = stubs.size();
+  for (const Symbol *sym : got) {
+    write32le(p, getIndex(sym));
+    p += sizeof(uint32_t);
+  }
+}
+
+CodeSignatureSection::CodeSignatureSection()
+    : LinkEditSection("__code_signature") {
+  align = 16; // required by libstuff
+}
+
+uint32_t CodeSignatureSection::getBlockCount() const {
+  return (getFileOffset() + blockSize - 1) / blockSize;
+}
+
+void CodeSignatureSection::finalizeContents() {
+  allHeadersSize = alignTo<16>(fixedHeadersSize + fileName.size() + 1);
+  size = allHeadersSize + getBlockCount() * hashSize;
+}
+
+void CodeSignatureSection::writeTo(uint8_t *buf) {
+  uint32_t signatureSize = static_cast<uint32_t>(size);
+  auto *superBlob = reinterpret_cast<CS_SuperBlob *>(buf);
+  write32be(&superBlob->magic, CSMAGIC_EMBEDDED_SIGNATURE);
+  write32be(&superBlob->length, signatureSize);
+  write32be(&superBlob->count, 1);
+  auto *blobIndex = reinterpret_cast<CS_BlobIndex *>(&superBlob[1]);
+  write32be(&blobIndex->type, CSSLOT_CODEDIRECTORY);
+  write32be(&blobIndex->offset, blobHeadersSize);
+
+  const OutputSegment *textSeg = in.header->parent->parent;
+  auto *codeDirectory =
+      reinterpret_cast<CS_CodeDirectory *>(buf + blobHeadersSize);
+  memset(codeDirectory, 0, sizeof(CS_CodeDirectory));
+  write32be(&codeDirectory->magic, CSMAGIC_CODEDIRECTORY);
+  write32be(&codeDirectory->length, signatureSize - blobHeadersSize);
+  write32be(&codeDirectory->version, CS_SUPPORTSEXECSEG);
+  write32be(&codeDirectory->flags, CS_ADHOC | CS_LINKER_SIGNED);
+  write32be(&codeDirectory->hashOffset, allHeadersSize - blobHeadersSize);
+  write32be(&codeDirectory->identOffset, sizeof(CS_CodeDirectory));
+  write32be(&codeDirectory->nCodeSlots, getBlockCount());
+  write32be(&codeDirectory->codeLimit, getFileOffset());
+  codeDirectory->hashSize = static_cast<uint8_t>(hashSize);
+  codeDirectory->hashType = CS_HASHTYPE_SHA256;
+  codeDirectory->pageSize = blockSizeShift;
+  write64be(&codeDirectory->execSegBase, textSeg->fileOff);
+  write64be(&codeDirectory->execSegLimit, textSeg->fileSize);
+  write64be(&codeDirectory->execSegFlags,
+            config->outputType == MH_EXECUTE ? CS_EXECSEG_MAIN_BINARY : 0);
+
+  auto *id = reinterpret_cast<char *>(&codeDirectory[1]);
+  memcpy(id, fileName.data(), fileName.size());
+  memset(id + fileName.size(), 0, allHeadersSize - fixedHeadersSize -
+                                      fileName.size());
+}
+
+void CodeSignatureSection::writeHashes(uint8_t *buf) const {
+  uint64_t codeLimit = getFileOffset();
+  uint8_t *hashes = buf + codeLimit + allHeadersSize;
+  // The pages are independent of each other, so they are hashed in parallel.
+  parallelForEachN(0, getBlockCount(), [&](size_t i) {
+    uint64_t begin = i * blockSize;
+    uint64_t end = std::min<uint64_t>(begin + blockSize, codeLimit);
+    std::array<uint8_t, 32> hash =
+        SHA256::hash(makeArrayRef(buf + begin, end - begin));
+    memcpy(hashes + i * hashSize, hash.data(), hashSize);
+  });
+}
+
+void macho::createSyntheticSections() {
+  in.header = make<MachHeaderSection>();
+  in.got = make<GotSection>();
+  in.stubs = make<StubsSection>();
+  in.rebase = make<RebaseSection>();
+  in.binding = make<BindingSection>();
+  in.exports = make<ExportSection>();
+  in.stringTable = make<StringTableSection>();
+  in.symtab = make<SymtabSection>(*in.stringTable);
+  in.indirectSymtab = make<IndirectSymtabSection>();
+  if (config->adhocCodesign) {
+    in.codeSignature = make<CodeSignatureSection>();
+    in.codeSignature->fileName = sys::path::filename(config->outputFile);
+  }
+}
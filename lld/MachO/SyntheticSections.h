@@ -0,0 +1,248 @@
+//===- SyntheticSections.h -------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_SYNTHETIC_SECTIONS_H
+#define LLD_MACHO_SYNTHETIC_SECTIONS_H
+
+#include "InputSection.h"
+#include "OutputSegment.h"
+#include "Target.h"
+#include "llvm/ADT/SetVector.h"
+
+#include <vector>
+
+namespace lld {
+namespace macho {
+
+class Defined;
+class DylibSymbol;
+class LoadCommand;
+
+// A section whose contents are generated by the linker rather than read from
+// an input file.
+class SyntheticSection : public InputSection {
+public:
+  SyntheticSection(const char *segname, const char *name);
+
+  static bool classof(const InputSection *isec) {
+    return isec->kind() == SyntheticKind;
+  }
+
+  // Whether the section needs to be in the output at all.
+  virtual bool isNeeded() const { return true; }
+};
+
+// The Mach-O header, followed by the load commands and by the padding that
+// -headerpad asks for. It is the first thing in __TEXT.
+class MachHeaderSection : public SyntheticSection {
+public:
+  MachHeaderSection();
+  void addLoadCommand(LoadCommand *lc);
+  uint64_t getSize() const override;
+  void writeTo(uint8_t *buf) override;
+
+private:
+  std::vector<LoadCommand *> loadCommands;
+  uint32_t sizeOfCmds = 0;
+};
+
+// The entries of the GOT: the addresses of the symbols that code loads from
+// memory rather than computes. Entries of dylib symbols are bound by the
+// loader, the others are rebased.
+class GotSection : public SyntheticSection {
+public:
+  GotSection();
+
+  void addEntry(Symbol &sym);
+  uint64_t getEntryVA(const Symbol &sym) const;
+  ArrayRef<Symbol *> getEntries() const { return entries.getArrayRef(); }
+
+  bool isNeeded() const override { return !entries.empty(); }
+  uint64_t getSize() const override { return entries.size() * WordSize; }
+  void writeTo(uint8_t *buf) override;
+
+private:
+  llvm::SetVector<Symbol *> entries;
+};
+
+// The stubs through which code calls the functions of dylibs. Each stub jumps
+// to the address in the GOT entry of its function; there is no lazy binding.
+class StubsSection : public SyntheticSection {
+public:
+  StubsSection();
+
+  void addEntry(Symbol &sym);
+  ArrayRef<Symbol *> getEntries() const { return entries.getArrayRef(); }
+
+  bool isNeeded() const override { return !entries.empty(); }
+  uint64_t getSize() const override;
+  void writeTo(uint8_t *buf) override;
+
+private:
+  llvm::SetVector<Symbol *> entries;
+};
+
+// The sections of __LINKEDIT describe the output to the loader. Their
+// contents depend on the addresses of everything that precedes them, so they
+// are computed by finalizeContents() once the other segments are laid out.
+class LinkEditSection : public SyntheticSection {
+public:
+  LinkEditSection(const char *name);
+
+  static bool classof(const InputSection *isec) {
+    return isec->kind() == SyntheticKind &&
+           isec->segname == segment_names::linkEdit;
+  }
+
+  virtual void finalizeContents() = 0;
+
+  uint64_t getSize() const override { return contents.size(); }
+  void writeTo(uint8_t *buf) override;
+
+protected:
+  std::vector<uint8_t> contents;
+};
+
+// The rebase opcodes, which list the pointers that the loader slides by the
+// distance between the preferred and the actual load address.
+class RebaseSection : public LinkEditSection {
+public:
+  RebaseSection();
+  void addEntry(const InputSection *isec, uint64_t offset) {
+    locations.push_back({isec, offset});
+  }
+  void finalizeContents() override;
+
+private:
+  std::vector<std::pair<const InputSection *, uint64_t>> locations;
+};
+
+// The binding opcodes, which list the pointers that the loader sets to the
+// addresses of symbols of dylibs.
+class BindingSection : public LinkEditSection {
+public:
+  BindingSection();
+  void addEntry(const DylibSymbol &sym, const InputSection *isec,
+                uint64_t offset, int64_t addend) {
+    bindings.push_back({&sym, isec, offset, addend});
+  }
+  bool hasEntries() const { return !bindings.empty(); }
+  void finalizeContents() override;
+
+private:
+  struct BindingEntry {
+    const DylibSymbol *sym;
+    const InputSection *isec;
+    uint64_t offset;
+    int64_t addend;
+  };
+  std::vector<BindingEntry> bindings;
+};
+
+// The trie of the exported symbols.
+class ExportSection : public LinkEditSection {
+public:
+  ExportSection();
+  void finalizeContents() override;
+};
+
+class StringTableSection : public LinkEditSection {
+public:
+  StringTableSection();
+  // Returns the offset of the string in the table.
+  uint32_t addString(StringRef str);
+  void finalizeContents() override {}
+};
+
+// The symbol table. Following LC_DYSYMTAB, the local symbols come first, then
+// the external ones, then the undefined ones.
+class SymtabSection : public LinkEditSection {
+public:
+  SymtabSection(StringTableSection &stringTableSection);
+  void finalizeContents() override;
+
+  uint32_t getNumSymbols() const {
+    return numLocals + numExternals + numUndefineds;
+  }
+
+  uint32_t numLocals = 0;
+  uint32_t numExternals = 0;
+  uint32_t numUndefineds = 0;
+
+private:
+  StringTableSection &stringTableSection;
+};
+
+// The indirect symbol table, which maps the stubs and the GOT entries to
+// their symbols for the tools that inspect the output.
+class IndirectSymtabSection : public LinkEditSection {
+public:
+  IndirectSymtabSection();
+  void finalizeContents() override;
+  uint32_t getNumSymbols() const { return contents.size() / sizeof(uint32_t); }
+};
+
+// An ad-hoc code signature: the SHA-256 hashes of the pages of the file,
+// without any certificate. It covers everything that precedes it, so it has
+// to be the last thing in the file, and its hashes the last thing written.
+class CodeSignatureSection : public LinkEditSection {
+public:
+  static constexpr uint8_t blockSizeShift = 12;
+  static constexpr size_t blockSize = (1 << blockSizeShift);
+  static constexpr size_t hashSize = 256 / 8;
+  static constexpr size_t blobHeadersSize =
+      sizeof(llvm::MachO::CS_SuperBlob) + sizeof(llvm::MachO::CS_BlobIndex);
+  static constexpr uint32_t fixedHeadersSize =
+      blobHeadersSize + sizeof(llvm::MachO::CS_CodeDirectory);
+
+  CodeSignatureSection();
+
+  // Computes the size of the signature of the contents that precede it.
+  void finalizeContents() override;
+  uint64_t getSize() const override { return size; }
+
+  // Writes everything but the hashes.
+  void writeTo(uint8_t *buf) override;
+
+  // Hashes the pages of the file, which has to be complete otherwise.
+  void writeHashes(uint8_t *buf) const;
+
+  StringRef fileName;
+
+private:
+  uint32_t getBlockCount() const;
+
+  uint64_t size = 0;
+  uint32_t allHeadersSize = 0;
+};
+
+struct InStruct {
+  MachHeaderSection *header = nullptr;
+  GotSection *got = nullptr;
+  StubsSection *stubs = nullptr;
+  RebaseSection *rebase = nullptr;
+  BindingSection *binding = nullptr;
+  ExportSection *exports = nullptr;
+  SymtabSection *symtab = nullptr;
+  IndirectSymtabSection *indirectSymtab = nullptr;
+  StringTableSection *stringTable = nullptr;
+  CodeSignatureSection *codeSignature = nullptr;
+};
+
+extern InStruct in;
+
+void createSyntheticSections();
+
+// Returns the index of the output section of a symbol, for its symbol table
+// entry, or NO_SECT if it is absolute.
+uint8_t getSectionIndex(const Defined &sym);
+
+} // namespace macho
+} // namespace lld
+
+#endif
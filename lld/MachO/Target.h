@@ -0,0 +1,82 @@
+//===- Target.h -------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_MACHO_TARGET_H
+#define LLD_MACHO_TARGET_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lld {
+namespace macho {
+
+class InputSection;
+class Symbol;
+struct Reloc;
+
+enum {
+  // We are currently only supporting 64-bit targets since macOS and iOS are
+  // deprecating 32-bit apps.
+  WordSize = 8,
+  PageSize = 4096,
+  MaxAlignmentPowerOf2 = 32,
+};
+
+// The size of __PAGEZERO, which is also the address of the Mach-O header of
+// an executable.
+constexpr uint64_t PageZeroSize = 1ULL << 32;
+
+class TargetInfo {
+public:
+  virtual ~TargetInfo() = default;
+
+  // Returns the value that an object file stores at the location of a
+  // relocation. For PC-relative relocations the value is adjusted so that
+  // the address it designates is always relative to the end of the 4-byte
+  // field, which relocateOne() undoes.
+  virtual int64_t getEmbeddedAddend(const uint8_t *loc,
+                                    const Reloc &r) const = 0;
+
+  // Writes the final value of a relocation. \p va is the address of the
+  // referent plus the addend, and \p pc the address of the location.
+  virtual void relocateOne(uint8_t *loc, const Reloc &r, uint64_t va,
+                           uint64_t pc) const = 0;
+
+  // Writes the stub that jumps to \p sym through its GOT entry.
+  virtual void writeStub(uint8_t *buf, const Symbol &sym) const = 0;
+
+  // Creates the GOT and stub entries that the relocation needs.
+  virtual void prepareSymbolRelocation(Symbol &sym, const InputSection *isec,
+                                       const Reloc &r) = 0;
+
+  // Returns the address that a relocation against \p sym resolves to: the
+  // symbol itself, its GOT entry or its stub.
+  virtual uint64_t resolveSymbolVA(const Symbol &sym, uint8_t type) const = 0;
+
+  // Returns true if \p type is a relocation of an absolute pointer, which
+  // needs a rebase or a binding in the output.
+  virtual bool isPointerReloc(uint8_t type, uint8_t length) const = 0;
+
+  // Returns true if \p type is the first relocation of a pair that computes
+  // the difference of two addresses.
+  virtual bool isSubtractorReloc(uint8_t type) const = 0;
+
+  uint32_t cpuType;
+  uint32_t cpuSubtype;
+
+  size_t stubSize;
+};
+
+TargetInfo *createX86_64TargetInfo();
+
+extern TargetInfo *target;
+
+} // namespace macho
+} // namespace lld
+
+#endif
@@ -0,0 +1,563 @@
+//===- Writer.cpp ---------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "Writer.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "OutputSection.h"
+#include "OutputSegment.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "SyntheticSections.h"
+#include "Target.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Memory.h"
+#include "lld/Common/Threads.h"
+#include "llvm/BinaryFormat/MachO.h"
+#include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::MachO;
+using namespace lld;
+using namespace lld::macho;
+
+namespace {
+class LCUuid;
+
+class Writer {
+public:
+  Writer() : buffer(errorHandler().outputBuffer) {}
+
+  void createCommonSections();
+  void scanRelocations();
+  void createOutputSections();
+  void createLoadCommands();
+  void assignAddresses(OutputSegment *seg);
+
+  void openFile();
+  void writeSections();
+  void writeUuid();
+
+  void run();
+
+  std::unique_ptr<FileOutputBuffer> &buffer;
+  uint64_t addr = 0;
+  uint64_t fileOff = 0;
+  uint64_t fileSize = 0;
+  LCUuid *uuidCommand = nullptr;
+};
+
+// LC_DYLD_INFO_ONLY stores the offsets of symbol import/export information.
+class LCDyldInfo : public LoadCommand {
+public:
+  uint32_t getSize() const override { return sizeof(dyld_info_command); }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<dyld_info_command *>(buf);
+    c->cmd = LC_DYLD_INFO_ONLY;
+    c->cmdsize = getSize();
+    if (in.rebase->getSize()) {
+      c->rebase_off = in.rebase->getFileOffset();
+      c->rebase_size = in.rebase->getSize();
+    }
+    if (in.binding->getSize()) {
+      c->bind_off = in.binding->getFileOffset();
+      c->bind_size = in.binding->getSize();
+    }
+    if (in.exports->getSize()) {
+      c->export_off = in.exports->getFileOffset();
+      c->export_size = in.exports->getSize();
+    }
+  }
+};
+
+class LCSymtab : public LoadCommand {
+public:
+  uint32_t getSize() const override { return sizeof(symtab_command); }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<symtab_command *>(buf);
+    c->cmd = LC_SYMTAB;
+    c->cmdsize = getSize();
+    c->symoff = in.symtab->getFileOffset();
+    c->nsyms = in.symtab->getNumSymbols();
+    c->stroff = in.stringTable->getFileOffset();
+    c->strsize = in.stringTable->getSize();
+  }
+};
+
+class LCDysymtab : public LoadCommand {
+public:
+  uint32_t getSize() const override { return sizeof(dysymtab_command); }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<dysymtab_command *>(buf);
+    c->cmd = LC_DYSYMTAB;
+    c->cmdsize = getSize();
+    c->ilocalsym = 0;
+    c->nlocalsym = in.symtab->numLocals;
+    c->iextdefsym = c->ilocalsym + c->nlocalsym;
+    c->nextdefsym = in.symtab->numExternals;
+    c->iundefsym = c->iextdefsym + c->nextdefsym;
+    c->nundefsym = in.symtab->numUndefineds;
+    if (uint32_t n = in.indirectSymtab->getNumSymbols()) {
+      c->indirectsymoff = in.indirectSymtab->getFileOffset();
+      c->nindirectsyms = n;
+    }
+  }
+};
+
+class LCSegment : public LoadCommand {
+public:
+  LCSegment(const OutputSegment *seg)
+      : seg(seg), sections(seg->getVisibleSections()) {}
+
+  uint32_t getSize() const override {
+    return sizeof(segment_command_64) + sections.size() * sizeof(section_64);
+  }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<segment_command_64 *>(buf);
+    buf += sizeof(segment_command_64);
+
+    c->cmd = LC_SEGMENT_64;
+    c->cmdsize = getSize();
+    memcpy(c->segname, seg->name.data(), seg->name.size());
+    c->vmaddr = seg->addr;
+    c->vmsize = seg->vmSize;
+    c->fileoff = seg->fileOff;
+    c->filesize = seg->fileSize;
+    c->maxprot = seg->maxProt;
+    c->initprot = seg->initProt;
+    c->nsects = sections.size();
+
+    for (const OutputSection *osec : sections) {
+      auto *sectHdr = reinterpret_cast<section_64 *>(buf);
+      buf += sizeof(section_64);
+
+      memcpy(sectHdr->sectname, osec->name.data(), osec->name.size());
+      memcpy(sectHdr->segname, seg->name.data(), seg->name.size());
+      sectHdr->addr = osec->addr;
+      sectHdr->size = osec->getSize();
+      sectHdr->offset = osec->isZeroFill() ? 0 : osec->fileOff;
+      sectHdr->align = Log2_32(osec->align);
+      sectHdr->flags = osec->flags;
+      sectHdr->reserved1 = osec->reserved1;
+      sectHdr->reserved2 = osec->reserved2;
+    }
+  }
+
+private:
+  const OutputSegment *seg;
+  std::vector<OutputSection *> sections;
+};
+
+class LCMain : public LoadCommand {
+public:
+  uint32_t getSize() const override { return sizeof(entry_point_command); }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<entry_point_command *>(buf);
+    c->cmd = LC_MAIN;
+    c->cmdsize = getSize();
+    c->entryoff = config->entry->getVA() - in.header->getVA();
+    c->stacksize = 0;
+  }
+};
+
+// LC_ID_DYLIB and LC_LOAD_DYLIB.
+class LCDylib : public LoadCommand {
+public:
+  LCDylib(LoadCommandType type, StringRef path, uint32_t compatibilityVersion,
+          uint32_t currentVersion)
+      : type(type), path(path), compatibilityVersion(compatibilityVersion),
+        currentVersion(currentVersion) {}
+
+  uint32_t getSize() const override {
+    return alignTo(sizeof(dylib_command) + path.size() + 1, 8);
+  }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<dylib_command *>(buf);
+    buf += sizeof(dylib_command);
+
+    c->cmd = type;
+    c->cmdsize = getSize();
+    c->dylib.name = sizeof(dylib_command);
+    c->dylib.compatibility_version = compatibilityVersion;
+    c->dylib.current_version = currentVersion;
+
+    memcpy(buf, path.data(), path.size());
+    buf[path.size()] = '\0';
+  }
+
+private:
+  LoadCommandType type;
+  StringRef path;
+  uint32_t compatibilityVersion;
+  uint32_t currentVersion;
+};
+
+class LCLoadDylinker : public LoadCommand {
+public:
+  uint32_t getSize() const override {
+    return alignTo(sizeof(dylinker_command) + path.size() + 1, 8);
+  }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<dylinker_command *>(buf);
+    buf += sizeof(dylinker_command);
+
+    c->cmd = LC_LOAD_DYLINKER;
+    c->cmdsize = getSize();
+    c->name = sizeof(dylinker_command);
+
+    memcpy(buf, path.data(), path.size());
+    buf[path.size()] = '\0';
+  }
+
+private:
+  // Recent versions of Darwin won't run any binary that has dyld at a
+  // different location.
+  const StringRef path = "/usr/lib/dyld";
+};
+
+class LCBuildVersion : public LoadCommand {
+public:
+  uint32_t getSize() const override { return sizeof(build_version_command); }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<build_version_command *>(buf);
+    c->cmd = LC_BUILD_VERSION;
+    c->cmdsize = getSize();
+    c->platform = config->platform;
+    c->minos = config->platformMinVersion;
+    c->sdk = config->sdkVersion;
+    c->ntools = 0;
+  }
+};
+
+// The UUID is a hash of the output, so it is filled in after everything else
+// is written.
+class LCUuid : public LoadCommand {
+public:
+  uint32_t getSize() const override { return sizeof(uuid_command); }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<uuid_command *>(buf);
+    c->cmd = LC_UUID;
+    c->cmdsize = getSize();
+    uuidBuf = c->uuid;
+  }
+
+  void writeUuid(const MD5::MD5Result &digest) const {
+    memcpy(uuidBuf, digest.Bytes.data(), 16);
+    // Make it an RFC 4122 name-based UUID that uses MD5, as ld64 does.
+    uuidBuf[6] = (uuidBuf[6] & 0x0f) | 0x30;
+    uuidBuf[8] = (uuidBuf[8] & 0x3f) | 0x80;
+  }
+
+  mutable uint8_t *uuidBuf;
+};
+
+class LCCodeSignature : public LoadCommand {
+public:
+  uint32_t getSize() const override { return sizeof(linkedit_data_command); }
+
+  void writeTo(uint8_t *buf) const override {
+    auto *c = reinterpret_cast<linkedit_data_command *>(buf);
+    c->cmd = LC_CODE_SIGNATURE;
+    c->cmdsize = getSize();
+    c->dataoff = in.codeSignature->getFileOffset();
+    c->datasize = in.codeSignature->getSize();
+  }
+};
+} // namespace
+
+// Tentative definitions that haven't been replaced by a real definition are
+// allocated in zerofill sections of their own.
+void Writer::createCommonSections() {
+  for (Symbol *sym : symtab->getSymbols()) {
+    auto *common = dyn_cast<CommonSymbol>(sym);
+    if (!common)
+      continue;
+
+    auto *isec = make<InputSection>();
+    isec->file = common->file;
+    isec->name = "__common";
+    isec->segname = segment_names::data;
+    isec->align = common->align;
+    isec->flags = S_ZEROFILL;
+    isec->data = {nullptr, static_cast<size_t>(common->size)};
+    inputSections.push_back(isec);
+
+    replaceSymbol<Defined>(sym, sym->getName(), isec->file, isec,
+                           /*value=*/0, /*isWeakDef=*/false,
+                           /*isExternal=*/true);
+  }
+}
+
+// Creates the GOT entries, the stubs, the rebases and the bindings that the
+// relocations need. This mutates the synthetic sections, so unlike the rest
+// of the processing of relocations it is done serially.
+void Writer::scanRelocations() {
+  for (InputSection *isec : inputSections) {
+    for (const Reloc &r : isec->relocs) {
+      auto *sym = r.referent.dyn_cast<Symbol *>();
+      if (sym)
+        target->prepareSymbolRelocation(*sym, isec, r);
+
+      if (!target->isPointerReloc(r.type, r.length) || r.subtrahend)
+        continue;
+      if (auto *defined = dyn_cast_or_null<Defined>(sym))
+        if (defined->isAbsolute())
+          continue;
+
+      // The loader doesn't write to __TEXT.
+      if (isec->segname == segment_names::text) {
+        error(toString(isec) + ": absolute pointer in __TEXT; recompile "
+                               "with -fPIC or move it to __DATA");
+        continue;
+      }
+      if (auto *dysym = dyn_cast_or_null<DylibSymbol>(sym))
+        in.binding->addEntry(*dysym, isec, r.offset, r.addend);
+      else
+        in.rebase->addEntry(isec, r.offset);
+    }
+  }
+}
+
+// Hidden sections have no section header, so they get an output section of
+// their own.
+static void addHiddenSection(SyntheticSection *isec) {
+  auto *osec = make<OutputSection>(isec->name);
+  osec->hidden = true;
+  osec->addInput(isec);
+  getOrCreateOutputSegment(isec->segname)->addOutputSection(osec);
+}
+
+static void addSection(InputSection *isec) {
+  getOrCreateOutputSegment(isec->segname)
+      ->getOrCreateOutputSection(isec->name)
+      ->addInput(isec);
+}
+
+static int segmentOrder(const OutputSegment *seg) {
+  if (seg->name == segment_names::pageZero)
+    return 0;
+  if (seg->name == segment_names::text)
+    return 1;
+  if (seg->name == segment_names::dataConst)
+    return 2;
+  if (seg->name == segment_names::data)
+    return 3;
+  if (seg->name == segment_names::linkEdit)
+    return 5;
+  return 4;
+}
+
+void Writer::createOutputSections() {
+  if (config->outputType == MH_EXECUTE)
+    getOrCreateOutputSegment(segment_names::pageZero);
+  addHiddenSection(in.header);
+
+  for (InputSection *isec : inputSections)
+    addSection(isec);
+  if (in.stubs->isNeeded())
+    addSection(in.stubs);
+  if (in.got->isNeeded())
+    addSection(in.got);
+
+  // The code signature covers the rest of the file, so it comes last.
+  addHiddenSection(in.rebase);
+  addHiddenSection(in.binding);
+  addHiddenSection(in.exports);
+  addHiddenSection(in.symtab);
+  addHiddenSection(in.indirectSymtab);
+  addHiddenSection(in.stringTable);
+  if (in.codeSignature)
+    addHiddenSection(in.codeSignature);
+
+  llvm::stable_sort(outputSegments, [](OutputSegment *a, OutputSegment *b) {
+    return segmentOrder(a) < segmentOrder(b);
+  });
+
+  uint32_t sectionIndex = 0;
+  for (size_t i = 0, e = outputSegments.size(); i != e; ++i) {
+    OutputSegment *seg = outputSegments[i];
+    seg->index = i;
+    seg->sortOutputSections();
+    for (OutputSection *osec : seg->sections)
+      if (!osec->hidden)
+        osec->index = ++sectionIndex;
+  }
+  if (sectionIndex > MAX_SECT)
+    error("too many output sections: " + Twine(sectionIndex));
+
+  if (in.stubs->isNeeded())
+    in.stubs->parent->reserved2 = target->stubSize;
+}
+
+void Writer::createLoadCommands() {
+  for (OutputSegment *seg : outputSegments)
+    in.header->addLoadCommand(make<LCSegment>(seg));
+  in.header->addLoadCommand(make<LCDyldInfo>());
+  in.header->addLoadCommand(make<LCSymtab>());
+  in.header->addLoadCommand(make<LCDysymtab>());
+
+  if (config->outputType == MH_DYLIB) {
+    in.header->addLoadCommand(make<LCDylib>(LC_ID_DYLIB, config->installName,
+                                            /*compatibilityVersion=*/1 << 16,
+                                            /*currentVersion=*/1 << 16));
+  } else {
+    in.header->addLoadCommand(make<LCLoadDylinker>());
+    in.header->addLoadCommand(make<LCMain>());
+  }
+
+  if (config->emitUUID) {
+    uuidCommand = make<LCUuid>();
+    in.header->addLoadCommand(uuidCommand);
+  }
+  in.header->addLoadCommand(make<LCBuildVersion>());
+
+  uint32_t ordinal = 1;
+  for (InputFile *file : inputFiles) {
+    if (auto *dylibFile = dyn_cast<DylibFile>(file)) {
+      dylibFile->ordinal = ordinal++;
+      in.header->addLoadCommand(make<LCDylib>(
+          LC_LOAD_DYLIB, dylibFile->installName,
+          dylibFile->compatibilityVersion, dylibFile->currentVersion));
+    }
+  }
+
+  if (in.codeSignature)
+    in.header->addLoadCommand(make<LCCodeSignature>());
+}
+
+// Segments start on page boundaries, both in memory and in the file, and the
+// sections of a segment are at the same offsets from its start in both. The
+// zerofill sections come last, so that they take no space in the file.
+void Writer::assignAddresses(OutputSegment *seg) {
+  if (seg->name == segment_names::pageZero) {
+    seg->vmSize = PageZeroSize;
+    addr = PageZeroSize;
+    return;
+  }
+
+  bool isLinkEdit = seg->name == segment_names::linkEdit;
+  seg->addr = addr;
+  seg->fileOff = fileOff;
+  uint64_t fileEnd = fileOff;
+
+  for (OutputSection *osec : seg->sections) {
+    addr = alignTo(addr, osec->align);
+    osec->addr = addr;
+    osec->fileOff = seg->fileOff + (addr - seg->addr);
+    // The contents of __LINKEDIT depend on the layout of everything that
+    // precedes them, including their own offsets for the code signature.
+    if (isLinkEdit)
+      for (InputSection *isec : osec->inputs)
+        cast<LinkEditSection>(isec)->finalizeContents();
+    osec->finalize();
+
+    addr += osec->getSize();
+    if (!osec->isZeroFill())
+      fileEnd = osec->fileOff + osec->getFileSize();
+  }
+
+  seg->vmSize = alignTo(addr - seg->addr, PageSize);
+  seg->fileSize = fileEnd - seg->fileOff;
+  if (!isLinkEdit)
+    seg->fileSize = alignTo(seg->fileSize, PageSize);
+  addr = seg->addr + seg->vmSize;
+  fileOff = seg->fileOff + seg->fileSize;
+}
+
+void Writer::openFile() {
+  Expected<std::unique_ptr<FileOutputBuffer>> bufferOrErr =
+      FileOutputBuffer::create(config->outputFile, fileSize,
+                               FileOutputBuffer::F_executable);
+
+  if (!bufferOrErr)
+    error("failed to open " + config->outputFile + ": " +
+          llvm::toString(bufferOrErr.takeError()));
+  else
+    buffer = std::move(*bufferOrErr);
+}
+
+// The sections are written one after the other, and the input sections of
+// each one in parallel, since copying and relocating them is most of the
+// work.
+void Writer::writeSections() {
+  uint8_t *buf = buffer->getBufferStart();
+  for (const OutputSegment *seg : outputSegments)
+    for (const OutputSection *osec : seg->sections)
+      osec->writeTo(buf + osec->fileOff);
+}
+
+// The UUID is the MD5 hash of the hashes of 1 MiB chunks of the output, so
+// that the chunks can be hashed in parallel. The code signature is excluded,
+// since it is computed afterwards and covers the UUID.
+void Writer::writeUuid() {
+  const size_t chunkSize = 1024 * 1024;
+  uint8_t *buf = buffer->getBufferStart();
+  uint64_t end = in.codeSignature ? in.codeSignature->getFileOffset()
+                                  : fileSize;
+  size_t numChunks = divideCeil(end, chunkSize);
+
+  std::vector<uint64_t> hashes(numChunks);
+  parallelForEachN(0, numChunks, [&](size_t i) {
+    uint64_t begin = i * chunkSize;
+    hashes[i] = xxh3_64bits(
+        makeArrayRef(buf + begin, std::min<uint64_t>(chunkSize, end - begin)));
+  });
+
+  MD5 hash;
+  hash.update(makeArrayRef(reinterpret_cast<const uint8_t *>(hashes.data()),
+                           hashes.size() * sizeof(uint64_t)));
+  MD5::MD5Result digest;
+  hash.final(digest);
+  uuidCommand->writeUuid(digest);
+}
+
+void Writer::run() {
+  createCommonSections();
+  scanRelocations();
+  if (errorCount())
+    return;
+
+  createOutputSections();
+  createLoadCommands();
+
+  // __LINKEDIT is the last segment; its contents are computed once the
+  // addresses of the others are known.
+  for (OutputSegment *seg : outputSegments)
+    assignAddresses(seg);
+  fileSize = fileOff;
+  if (errorCount())
+    return;
+
+  openFile();
+  if (errorCount())
+    return;
+
+  writeSections();
+  if (uuidCommand)
+    writeUuid();
+  if (in.codeSignature)
+    in.codeSignature->writeHashes(buffer->getBufferStart());
+
+  if (auto e = buffer->commit())
+    error("failed to write to the output file: " + toString(std::move(e)));
+}
+
+void macho::writeResult() { Writer().run(); }
@@ -14,6 +14,7 @@
 
 namespace lld {
 void unlinkAsync(StringRef path);
+void releaseMappedMemory(StringRef buf);
 std::error_code tryCreateFile(StringRef path);
 } // namespace lld
 
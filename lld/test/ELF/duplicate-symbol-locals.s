@@ -0,0 +1,23 @@
+# REQUIRES: x86
+## Duplicate symbols are reported during symbol resolution, before the driver
+## creates local symbols. The source location is found through .debug_line,
+## whose relocations refer to the local .text section symbol, and the object
+## location names the local symbol that encloses the definition.
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64-pc-linux -g %s -o %t.o
+# RUN: not ld.lld %t.o %t.o -o /dev/null 2>&1 | FileCheck %s
+
+# CHECK:      error: duplicate symbol: foo
+# CHECK-NEXT: >>> defined at {{.*}}duplicate-symbol-locals.s:[[#LINE:]]
+# CHECK-NEXT: >>>            {{.*}}.o:(local)
+# CHECK-NEXT: >>> defined at {{.*}}duplicate-symbol-locals.s:[[#LINE]]
+# CHECK-NEXT: >>>            {{.*}}.o:(local)
+
+.text
+.type local, @function
+local:
+  nop
+.globl foo
+foo:
+  nop
+.size local, 2
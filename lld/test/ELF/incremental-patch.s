@@ -0,0 +1,80 @@
+# REQUIRES: x86
+## With --incremental, if only object files changed since the previous link
+## and the layout of the output stays the same, the sections of the changed
+## files are rewritten in the previous output. Code sections are followed by
+## padding so that they can grow a little without changing the layout.
+
+# RUN: rm -rf %t && mkdir -p %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 %s -o %t/main.o
+# RUN: echo '.globl foo; foo: ret' | llvm-mc -filetype=obj -triple=x86_64 - -o %t/foo.o
+# RUN: ld.lld --incremental --verbose %t/foo.o %t/main.o -o %t/out 2>&1 | \
+# RUN:   FileCheck --check-prefix=LINK %s
+# RUN: llvm-objdump -d --no-show-raw-insn %t/out | FileCheck --check-prefix=DIS1 %s
+
+# LINK-NOT: --incremental:
+
+# DIS1:      <foo>:
+# DIS1-NEXT:   201000: retq
+# DIS1-NEXT:   201001: int3
+# DIS1:      <_start>:
+# DIS1-NEXT:   201014: callq 0x201000 <foo>
+
+## foo grows, but still fits in the space reserved after it. The output is
+## patched; _start stays where it was.
+# RUN: echo '.globl foo; foo: nop; ret; foo_end:' | llvm-mc -filetype=obj -triple=x86_64 - -o %t/foo.o
+# RUN: ld.lld --incremental --verbose %t/foo.o %t/main.o -o %t/out 2>&1 | \
+# RUN:   FileCheck --check-prefix=PATCH %s
+# RUN: llvm-objdump -d --no-show-raw-insn %t/out | FileCheck --check-prefix=DIS2 %s
+
+# PATCH: --incremental: patched {{.*}}out
+
+# DIS2:      <foo>:
+# DIS2-NEXT:   201000: nop
+# DIS2-NEXT:   201001: retq
+# DIS2:      <foo_end>:
+# DIS2-NEXT:   201002: int3
+# DIS2:      <_start>:
+# DIS2-NEXT:   201014: callq 0x201000 <foo>
+
+## foo moves within its section. This still fits, but _start calls foo, so
+## we do a full link.
+# RUN: echo '.globl foo; nop; nop; foo: ret' | llvm-mc -filetype=obj -triple=x86_64 - -o %t/foo.o
+# RUN: ld.lld --incremental --verbose %t/foo.o %t/main.o -o %t/out 2>&1 | \
+# RUN:   FileCheck --check-prefix=SYMBOLS %s
+# RUN: llvm-objdump -d --no-show-raw-insn %t/out | FileCheck --check-prefix=DIS3 %s
+
+# SYMBOLS:     --incremental: symbols changed
+# SYMBOLS-NOT: patched
+
+# DIS3:      <_start>:
+# DIS3-NEXT:   201014: callq 0x201002 <foo>
+
+## foo outgrows the space reserved after it, which moves _start. We do a full
+## link, which reserves more space after foo.
+# RUN: echo '.globl foo; foo: .fill 32, 1, 0x90; ret' | llvm-mc -filetype=obj -triple=x86_64 - -o %t/foo.o
+# RUN: ld.lld --incremental --verbose %t/foo.o %t/main.o -o %t/out 2>&1 | \
+# RUN:   FileCheck --check-prefix=LAYOUT %s
+# RUN: llvm-objdump -d --no-show-raw-insn %t/out | FileCheck --check-prefix=DIS4 %s
+
+# LAYOUT:     --incremental: section layout changed
+# LAYOUT-NOT: patched
+
+# DIS4:      201020: retq
+# DIS4-NEXT: 201021: int3
+# DIS4:      <_start>:
+# DIS4-NEXT:   201034: callq 0x201000 <foo>
+
+## So foo can grow again without a full link.
+# RUN: echo '.globl foo; foo: .fill 40, 1, 0x90; ret' | llvm-mc -filetype=obj -triple=x86_64 - -o %t/foo.o
+# RUN: ld.lld --incremental --verbose %t/foo.o %t/main.o -o %t/out 2>&1 | \
+# RUN:   FileCheck --check-prefix=PATCH %s
+# RUN: llvm-objdump -d --no-show-raw-insn %t/out | FileCheck --check-prefix=DIS5 %s
+
+# DIS5:      201028: retq
+# DIS5-NEXT: 201029: int3
+# DIS5:      <_start>:
+# DIS5-NEXT:   201034: callq 0x201000 <foo>
+
+.globl _start
+_start:
+  call foo
@@ -0,0 +1,51 @@
+# REQUIRES: x86
+## With --incremental, a link is skipped only if the same command line resolves
+## to the same input files and none of them has changed.
+
+# RUN: rm -rf %t && mkdir -p %t/dir1 %t/dir2
+# RUN: llvm-mc -filetype=obj -triple=x86_64 %s -o %t/main.o
+# RUN: echo '.globl foo; foo: ret' | llvm-mc -filetype=obj -triple=x86_64 - -o %t/foo.o
+# RUN: rm -f %t/dir2/libfoo.a && llvm-ar rcs %t/dir2/libfoo.a %t/foo.o
+
+## The first link writes the output and the state file.
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out 2>&1 | FileCheck --check-prefix=LINK %s
+# RUN: ls %t/out.lldstate
+
+## Nothing changed.
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out 2>&1 | FileCheck --check-prefix=SKIP %s
+
+## An input changed.
+# RUN: echo '.globl foo; foo: nop; ret' | llvm-mc -filetype=obj -triple=x86_64 - -o %t/foo.o
+# RUN: rm -f %t/dir2/libfoo.a && llvm-ar rcs %t/dir2/libfoo.a %t/foo.o
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out 2>&1 | FileCheck --check-prefix=LINK %s
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out 2>&1 | FileCheck --check-prefix=SKIP %s
+
+## The same command line now finds another archive.
+# RUN: cp %t/dir2/libfoo.a %t/dir1/libfoo.a
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out 2>&1 | FileCheck --check-prefix=LINK %s
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out 2>&1 | FileCheck --check-prefix=SKIP %s
+
+## Links with side effects other than the output are never skipped.
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out -Map=%t/out.map 2>&1 | FileCheck --check-prefix=LINK %s
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out -Map=%t/out.map 2>&1 | FileCheck --check-prefix=LINK %s
+# RUN: not ls %t/out.lldstate
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out 2>&1 | FileCheck --check-prefix=LINK %s
+# RUN: ld.lld --incremental --verbose %t/main.o -L%t/dir1 -L%t/dir2 -lfoo \
+# RUN:   -o %t/out --reproduce=%t/repro.tar 2>&1 | FileCheck --check-prefix=LINK %s
+# RUN: ls %t/repro.tar
+
+# LINK-NOT: is up to date
+# SKIP: --incremental: {{.*}}out is up to date
+
+.globl _start
+_start:
+  call foo
@@ -0,0 +1,12 @@
+# REQUIRES: x86
+## The code generation cache lives in the ThinLTO cache directory.
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64 %s -o %t.o
+# RUN: not ld.lld --thinlto-cache-codegen %t.o -o /dev/null 2>&1 | FileCheck %s
+# RUN: ld.lld --thinlto-cache-codegen --thinlto-cache-dir=%t.cache %t.o -o /dev/null
+
+# CHECK: error: --thinlto-cache-codegen may not be used without --thinlto-cache-dir
+
+.globl _start
+_start:
+  ret
@@ -0,0 +1,68 @@
+# REQUIRES: x86
+## An executable gets a zero page, its entry point in LC_MAIN and a load
+## command for each dylib that it links against.
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64-apple-darwin %s -o %t.o
+# RUN: ld64.lld.darwinnew -arch x86_64 -o %t %t.o %S/Inputs/libSystem.tbd
+# RUN: llvm-objdump --section-headers --syms --private-headers %t | FileCheck %s
+
+# CHECK:      Sections:
+# CHECK-NEXT: Idx Name Size VMA Type
+# CHECK-NEXT:   0 __text 00000002 0000000100000280 TEXT
+
+# CHECK:      SYMBOL TABLE:
+# CHECK-DAG:  0000000100000000 {{.*}} __mh_execute_header
+# CHECK-DAG:  0000000100000280 {{.*}} _main
+
+# CHECK:      MH_MAGIC_64 X86_64 ALL LIB64 EXECUTE
+# CHECK-SAME: DYLDLINK TWOLEVEL PIE
+
+# CHECK:        segname __PAGEZERO
+# CHECK-NEXT:    vmaddr 0x0000000000000000
+# CHECK-NEXT:    vmsize 0x0000000100000000
+# CHECK:        segname __TEXT
+# CHECK-NEXT:    vmaddr 0x0000000100000000
+# CHECK:        segname __LINKEDIT
+
+# CHECK:            cmd LC_MAIN
+# CHECK-NEXT:   cmdsize 24
+# CHECK-NEXT:  entryoff 640
+
+# CHECK:            cmd LC_LOAD_DYLIB
+# CHECK-NEXT:   cmdsize
+# CHECK-NEXT:      name /usr/lib/libSystem.B.dylib (offset 24)
+
+## -e picks another entry point, which must be defined.
+# RUN: ld64.lld.darwinnew -arch x86_64 -o %t2 -e _start %t.o %S/Inputs/libSystem.tbd
+# RUN: llvm-objdump --private-headers %t2 | FileCheck --check-prefix=START %s
+# START:      cmd LC_MAIN
+# START-NEXT: cmdsize 24
+# START-NEXT: entryoff 641
+
+# RUN: not ld64.lld.darwinnew -arch x86_64 -o %t3 -e _puts %t.o \
+# RUN:   %S/Inputs/libSystem.tbd 2>&1 | FileCheck --check-prefix=DYLIB-ENTRY %s
+# DYLIB-ENTRY: error: entry point _puts must be defined in the output
+
+## Undefined symbols are reported with the file that refers to them.
+# RUN: echo '.globl _main; _main: callq _missing; retq' | \
+# RUN:   llvm-mc -filetype=obj -triple=x86_64-apple-darwin - -o %t-undef.o
+# RUN: not ld64.lld.darwinnew -arch x86_64 -o %t3 %t-undef.o \
+# RUN:   %S/Inputs/libSystem.tbd 2>&1 | FileCheck --check-prefix=UNDEF %s
+# UNDEF:      error: undefined symbol: _missing
+# UNDEF-NEXT: >>> referenced by {{.*}}-undef.o
+
+# RUN: not ld64.lld.darwinnew -arch x86_64 -o %t3 %S/Inputs/libSystem.tbd \
+# RUN:   2>&1 | FileCheck --check-prefix=NO-MAIN %s
+# NO-MAIN:      error: undefined symbol: _main
+# NO-MAIN-NEXT: >>> referenced by the entry point
+
+# RUN: not ld64.lld.darwinnew -arch arm64 -o %t3 %t.o 2>&1 | \
+# RUN:   FileCheck --check-prefix=ARCH %s
+# ARCH: error: missing or unsupported -arch arm64
+
+.text
+.globl _main, _start
+_main:
+  retq
+_start:
+  retq
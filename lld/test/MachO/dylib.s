@@ -0,0 +1,64 @@
+# REQUIRES: x86
+## A dylib carries its install name and exports its global symbols through the
+## export trie, and an executable that links against it binds to them.
+
+# RUN: rm -rf %t && mkdir -p %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64-apple-darwin %s -o %t/foo.o
+# RUN: ld64.lld.darwinnew -arch x86_64 -dylib -install_name @rpath/libfoo.dylib \
+# RUN:   %t/foo.o -o %t/libfoo.dylib
+# RUN: llvm-objdump --private-headers --exports-trie %t/libfoo.dylib | \
+# RUN:   FileCheck --check-prefix=DYLIB %s
+
+# DYLIB:      MH_MAGIC_64 X86_64 ALL {{.*}} DYLIB
+# DYLIB-NOT:  segname __PAGEZERO
+# DYLIB:            cmd LC_ID_DYLIB
+# DYLIB-NEXT:   cmdsize
+# DYLIB-NEXT:      name @rpath/libfoo.dylib (offset 24)
+# DYLIB-NOT:        cmd LC_MAIN
+
+## _foo is a prefix of _foobar, so its node in the trie has both an export and
+## a child. Local and private extern symbols are not exported.
+# DYLIB:      Exports trie:
+# DYLIB-NEXT: 0x00000290  _bar
+# DYLIB-NEXT: 0x00000291  _baz
+# DYLIB-NEXT: 0x00000292  _foo
+# DYLIB-NEXT: 0x00001000  _foobar
+
+## The executable loads the dylib by its install name, calls _foo through a
+## stub and binds the GOT entry of _bar and the pointer to _foobar.
+# RUN: echo '.globl _main; _main: callq _foo; movq _bar@GOTPCREL(%rip), %rax; retq' \
+# RUN:   > %t/main.s
+# RUN: echo '.data; .quad _foobar' >> %t/main.s
+# RUN: llvm-mc -filetype=obj -triple=x86_64-apple-darwin %t/main.s -o %t/main.o
+# RUN: ld64.lld.darwinnew -arch x86_64 -o %t/main %t/main.o -L%t -lfoo
+# RUN: llvm-objdump --private-headers --bind %t/main | \
+# RUN:   FileCheck --check-prefix=MAIN %s
+
+# MAIN:            cmd LC_LOAD_DYLIB
+# MAIN-NEXT:   cmdsize
+# MAIN-NEXT:      name @rpath/libfoo.dylib (offset 24)
+# MAIN:       Bind table:
+# MAIN-NEXT:  segment section address type addend dylib symbol
+# MAIN-DAG:   __DATA_CONST __got {{.*}} pointer 0 libfoo _bar
+# MAIN-DAG:   __DATA_CONST __got {{.*}} pointer 0 libfoo _foo
+# MAIN-DAG:   __DATA __data {{.*}} pointer 0 libfoo _foobar
+
+.text
+.globl _bar, _baz, _foo, _hidden
+.private_extern _hidden
+_bar:
+  retq
+_baz:
+  retq
+_foo:
+  retq
+_hidden:
+  retq
+_local:
+  retq
+
+.data
+.p2align 3
+.globl _foobar
+_foobar:
+  .quad 0
@@ -0,0 +1,73 @@
+# REQUIRES: x86
+## Calls to functions of dylibs go through a stub, GOT loads go through a GOT
+## entry that the loader binds, and absolute pointers in __DATA are rebased or
+## bound.
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64-apple-darwin %s -o %t.o
+# RUN: ld64.lld.darwinnew -arch x86_64 -o %t %t.o %S/Inputs/libSystem.tbd
+# RUN: llvm-objdump --section-headers --full-contents --rebase --bind %t | \
+# RUN:   FileCheck %s
+
+# CHECK:      Sections:
+# CHECK-NEXT: Idx Name Size VMA Type
+# CHECK-NEXT:   0 __text 0000001a 0000000100000400 TEXT
+# CHECK-NEXT:   1 __stubs 00000006 000000010000041a TEXT
+# CHECK-NEXT:   2 __got 00000008 0000000100001000 DATA
+# CHECK-NEXT:   3 __data 00000010 0000000100002000 DATA
+
+## callq _helper:                  0x100000405 + 0x14 = 0x100000419
+## callq _puts:                    0x10000040a + 0x10 = 0x10000041a (the stub)
+## leaq _data(%rip), %rax:         0x100000411 + 0x1bef = 0x100002000
+## movq _puts@GOTPCREL(%rip), %rax: 0x100000418 + 0xbe8 = 0x100001000
+# CHECK:      Contents of section __text:
+# CHECK-NEXT:  100000400 e8140000 00e81000 0000488d 05ef1b00
+# CHECK-NEXT:  100000410 00488b05 e80b0000 c3c3
+
+## jmpq *0xbe0(%rip):              0x100000420 + 0xbe0 = 0x100001000
+# CHECK:      Contents of section __stubs:
+# CHECK-NEXT:  10000041a ff25e00b 0000
+
+## The pointer to _main holds its unslid address, and the pointer to _puts is
+## left to the loader.
+# CHECK:      Contents of section __data:
+# CHECK-NEXT:  100002000 00040000 01000000 00000000 00000000
+
+# CHECK:      Rebase table:
+# CHECK-NEXT: segment section address type
+# CHECK-NEXT: __DATA __data 0x100002000 pointer
+# CHECK-NEXT: Bind table:
+# CHECK-NEXT: segment section address type addend dylib symbol
+# CHECK-DAG:  __DATA_CONST __got 0x100001000 pointer 0 libSystem _puts
+# CHECK-DAG:  __DATA __data 0x100002008 pointer 0 libSystem _puts
+
+## Code can only refer to a symbol of a dylib through the GOT or a stub.
+# RUN: echo '.globl _main; _main: leaq _puts(%rip), %rax; retq' | \
+# RUN:   llvm-mc -filetype=obj -triple=x86_64-apple-darwin - -o %t-pcrel.o
+# RUN: not ld64.lld.darwinnew -arch x86_64 -o %t2 %t-pcrel.o \
+# RUN:   %S/Inputs/libSystem.tbd 2>&1 | FileCheck --check-prefix=PCREL %s
+# PCREL: error: {{.*}}-pcrel.o:(__TEXT,__text): PC-relative reference to _puts, which is defined in a dylib; recompile with -fPIC
+
+## The loader doesn't write to __TEXT.
+# RUN: echo '.globl _main; _main: retq; .quad _main' | \
+# RUN:   llvm-mc -filetype=obj -triple=x86_64-apple-darwin - -o %t-text.o
+# RUN: not ld64.lld.darwinnew -arch x86_64 -o %t2 %t-text.o \
+# RUN:   %S/Inputs/libSystem.tbd 2>&1 | FileCheck --check-prefix=TEXT %s
+# TEXT: error: {{.*}}-text.o:(__TEXT,__text): absolute pointer in __TEXT; recompile with -fPIC or move it to __DATA
+
+.text
+.globl _main, _helper
+_main:
+  callq _helper
+  callq _puts
+  leaq _data(%rip), %rax
+  movq _puts@GOTPCREL(%rip), %rax
+  retq
+_helper:
+  retq
+
+.data
+.p2align 3
+.globl _data
+_data:
+  .quad _main
+  .quad _puts
@@ -43,10 +43,11 @@ using namespace llvm::sys;
 
 enum Flavor {
   Invalid,
-  Gnu,     // -flavor gnu
-  WinLink, // -flavor link
-  Darwin,  // -flavor darwin
-  Wasm,    // -flavor wasm
+  Gnu,       // -flavor gnu
+  WinLink,   // -flavor link
+  Darwin,    // -flavor darwin
+  DarwinNew, // -flavor darwinnew
+  Wasm,      // -flavor wasm
 };
 
 LLVM_ATTRIBUTE_NORETURN static void die(const Twine &s) {
@@ -60,6 +61,7 @@ static Flavor getFlavor(StringRef s) {
       .CasesLower("wasm", "ld-wasm", Wasm)
       .CaseLower("link", WinLink)
       .CasesLower("ld64", "ld64.lld", "darwin", Darwin)
+      .CasesLower("ld64.lld.darwinnew", "darwinnew", DarwinNew)
       .Default(Invalid);
 }
 
@@ -155,6 +157,8 @@ int main(int argc, const char **argv) {
     return !coff::link(args, canExitEarly());
   case Darwin:
     return !mach_o::link(args, canExitEarly());
+  case DarwinNew:
+    return !macho::link(args, canExitEarly());
   case Wasm:
     return !wasm::link(args, canExitEarly());
   default:
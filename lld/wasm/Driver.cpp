@@ -711,6 +711,13 @@ void LinkerDriver::link(ArrayRef<const char *> argsArr) {
   if (errorCount())
     return;
 
+  // Decoding the object files is independent of symbol resolution, so do it
+  // for all of them in parallel first.
+  parallelForEach(files, [](InputFile *f) {
+    if (auto *obj = dyn_cast<ObjFile>(f))
+      obj->parseBinary();
+  });
+
   // Add all files to the symbol table. This will add almost all
   // symbols that we need to the symbol table.
   for (InputFile *f : files)
@@ -229,19 +229,36 @@ static void setRelocs(const std::vector<T *> &chunks,
   }
 }
 
-void ObjFile::parse(bool ignoreComdats) {
+void ObjFile::parseBinary() {
+  if (wasmObj || !binaryError.empty())
+    return;
+
   // Parse a memory buffer as a wasm file.
-  LLVM_DEBUG(dbgs() << "Parsing object: " << toString(this) << "\n");
-  std::unique_ptr<Binary> bin = CHECK(createBinary(mb), toString(this));
+  Expected<std::unique_ptr<Binary>> bin = createBinary(mb);
+  if (!bin) {
+    binaryError = toString(bin.takeError());
+    return;
+  }
 
-  auto *obj = dyn_cast<WasmObjectFile>(bin.get());
-  if (!obj)
-    fatal(toString(this) + ": not a wasm file");
-  if (!obj->isRelocatableObject())
-    fatal(toString(this) + ": not a relocatable wasm file");
+  auto *obj = dyn_cast<WasmObjectFile>(bin->get());
+  if (!obj) {
+    binaryError = "not a wasm file";
+    return;
+  }
+  if (!obj->isRelocatableObject()) {
+    binaryError = "not a relocatable wasm file";
+    return;
+  }
 
-  bin.release();
+  bin->release();
   wasmObj.reset(obj);
+}
+
+void ObjFile::parse(bool ignoreComdats) {
+  LLVM_DEBUG(dbgs() << "Parsing object: " << toString(this) << "\n");
+  parseBinary();
+  if (!binaryError.empty())
+    fatal(toString(this) + ": " + binaryError);
 
   // Build up a map of function indices to table indices for use when
   // verifying the existing table index relocations
@@ -97,6 +97,10 @@ public:
 
   void parse(bool ignoreComdats = false);
 
+  // Parses the underlying wasm binary. This doesn't touch the symbol table,
+  // so it can be done for all object files in parallel before parse().
+  void parseBinary();
+
   // Returns the underlying wasm file.
   const WasmObjectFile *getWasmObj() const { return wasmObj.get(); }
 
@@ -140,6 +144,10 @@ private:
   bool isExcludedByComdat(InputChunk *chunk) const;
 
   std::unique_ptr<WasmObjectFile> wasmObj;
+
+  // The error found by parseBinary(), if any. It is reported by parse() so
+  // that diagnostics come out in the same order as the input files.
+  std::string binaryError;
 };
 
 // .so file.
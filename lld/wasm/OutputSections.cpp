@@ -109,8 +109,8 @@ void CodeSection::writeTo(uint8_t *buf) {
   memcpy(buf, codeSectionHeader.data(), codeSectionHeader.size());
 
   // Write code section bodies
-  for (const InputChunk *chunk : functions)
-    chunk->writeTo(buf);
+  parallelForEach(functions,
+                  [&](const InputChunk *chunk) { chunk->writeTo(buf); });
 }
 
 uint32_t CodeSection::getNumRelocations() const {
@@ -185,8 +185,8 @@ void DataSection::writeTo(uint8_t *buf) {
     memcpy(segStart, segment->header.data(), segment->header.size());
 
     // Write segment data payload
-    for (const InputChunk *chunk : segment->inputSegments)
-      chunk->writeTo(buf);
+    parallelForEach(segment->inputSegments,
+                    [&](const InputChunk *chunk) { chunk->writeTo(buf); });
   }
 }
 
@@ -233,8 +233,8 @@ void CustomSection::writeTo(uint8_t *buf) {
   buf += nameData.size();
 
   // Write custom sections payload
-  for (const InputSection *section : inputSections)
-    section->writeTo(buf);
+  parallelForEach(inputSections,
+                  [&](const InputSection *section) { section->writeTo(buf); });
 }
 
 uint32_t CustomSection::getNumRelocations() const {
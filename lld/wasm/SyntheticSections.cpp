@@ -17,6 +17,7 @@
 #include "InputGlobal.h"
 #include "OutputSegment.h"
 #include "SymbolTable.h"
+#include "lld/Common/Threads.h"
 #include "llvm/Support/Path.h"
 
 using namespace llvm;
@@ -518,13 +519,25 @@ void NameSection::writeBody() {
       writeStr(sub.os, toString(*s), "symbol name");
     }
   }
-  for (const InputFunction *f : out.functionSec->inputFunctions) {
+
+  // Demangling the names of the defined functions dominates the cost of this
+  // section, so it is done in parallel before they are written out in order.
+  ArrayRef<InputFunction *> funcs = out.functionSec->inputFunctions;
+  std::vector<std::string> names(funcs.size());
+  parallelForEachN(0, funcs.size(), [&](size_t i) {
+    const InputFunction *f = funcs[i];
+    if (!f->getName().empty() && f->getDebugName().empty())
+      names[i] = maybeDemangleSymbol(f->getName());
+  });
+
+  for (size_t i = 0, e = funcs.size(); i != e; ++i) {
+    const InputFunction *f = funcs[i];
     if (!f->getName().empty()) {
       writeUleb128(sub.os, f->getFunctionIndex(), "func index");
       if (!f->getDebugName().empty()) {
         writeStr(sub.os, f->getDebugName(), "symbol name");
       } else {
-        writeStr(sub.os, maybeDemangleSymbol(f->getName()), "symbol name");
+        writeStr(sub.os, names[i], "symbol name");
       }
     }
   }
@@ -53,6 +53,10 @@ public:
   bool SetClangModulesCachePath(llvm::StringRef path);
   bool GetEnableExternalLookup() const;
   bool SetEnableExternalLookup(bool new_value);
+  bool GetEnableDWARFIndexCache() const;
+  bool SetEnableDWARFIndexCache(bool new_value);
+  FileSpec GetDWARFIndexCachePath() const;
+  bool SetDWARFIndexCachePath(llvm::StringRef path);
 }; 
 
 /// \class ModuleList ModuleList.h "lldb/Core/ModuleList.h"
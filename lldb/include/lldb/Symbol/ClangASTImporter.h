@@ -9,6 +9,7 @@
 #ifndef liblldb_ClangASTImporter_h_
 #define liblldb_ClangASTImporter_h_
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <set>
@@ -27,6 +28,8 @@
 #include "lldb/lldb-types.h"
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringMap.h"
 
 namespace lldb_private {
 
@@ -65,6 +68,11 @@ public:
     ++local_counters.m_record_layout_count;
   }
 
+  /// Record that importing or completing the type \a type_name took
+  /// \a duration. The slowest types are part of the dumped metrics.
+  static void RegisterTypeImport(llvm::StringRef type_name,
+                                 std::chrono::nanoseconds duration);
+
 private:
   struct Counters {
     uint64_t m_visible_query_count;
@@ -78,6 +86,13 @@ private:
   static Counters global_counters;
   static Counters local_counters;
 
+  struct TypeImportStats {
+    uint64_t m_count = 0;
+    std::chrono::nanoseconds m_duration{0};
+  };
+
+  static llvm::StringMap<TypeImportStats> type_import_stats;
+
   static void DumpCounters(Log *log, Counters &counters);
 };
 
@@ -342,6 +357,10 @@ private:
 
     NamespaceMetaMap m_namespace_maps;
     MapCompleter *m_map_completer;
+
+    /// The tag decls whose children CompleteAndFetchChildren() already
+    /// imported, so they are not imported again for every expression.
+    llvm::DenseSet<const clang::Decl *> m_fetched_children;
   };
 
   typedef std::shared_ptr<ASTContextMetadata> ASTContextMetadataSP;
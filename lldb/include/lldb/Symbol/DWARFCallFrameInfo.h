@@ -21,6 +21,8 @@
 #include "lldb/Utility/VMRange.h"
 #include "lldb/lldb-private.h"
 
+#include "llvm/Support/Threading.h"
+
 namespace lldb_private {
 
 // DWARFCallFrameInfo is a class which can read eh_frame and DWARF Call Frame
@@ -126,6 +128,26 @@ private:
 
   void GetFDEIndex();
 
+  /// Locate the .eh_frame_hdr section of an eh_frame and check that its
+  /// binary search table can be used to find FDEs.
+  void GetEHFrameHdr();
+
+  /// Returns true if FDEs can be found with the .eh_frame_hdr table.
+  bool HasEHFrameHdr() {
+    GetEHFrameHdr();
+    return m_eh_frame_hdr_fde_count != 0;
+  }
+
+  /// Find the FDE that contains or follows \a file_addr in the binary search
+  /// table of the .eh_frame_hdr section, without indexing all of the FDEs.
+  /// Returns llvm::None if there is no such FDE or no usable table, so
+  /// callers fall back to m_fde_index.
+  llvm::Optional<FDEEntryMap::Entry>
+  FindFDEEntryInEHFrameHdr(lldb::addr_t file_addr, bool allow_following);
+
+  /// Decode the address range of the FDE at \a fde_offset.
+  llvm::Optional<FDEEntryMap::Entry> ParseFDEEntry(dw_offset_t fde_offset);
+
   bool FDEToUnwindPlan(uint32_t offset, Address startaddr,
                        UnwindPlan &unwind_plan);
 
@@ -146,14 +168,24 @@ private:
   lldb::SectionSP m_section_sp;
   Flags m_flags = 0;
   cie_map_t m_cie_map;
+  std::mutex m_cie_map_mutex;
 
   DataExtractor m_cfi_data;
-  bool m_cfi_data_initialized = false; // only copy the section into the DE once
+  llvm::once_flag m_cfi_data_once; // only copy the section into the DE once
 
   FDEEntryMap m_fde_index;
   bool m_fde_index_initialized = false; // only scan the section for FDEs once
   std::mutex m_fde_index_mutex; // and isolate the thread that does it
 
+  // The binary search table of the .eh_frame_hdr section, if there is one
+  // that uses the DW_EH_PE_datarel | DW_EH_PE_sdata4 encoding. Each entry is
+  // a pair of initial location and FDE address, relative to the section.
+  DataExtractor m_eh_frame_hdr_data;
+  lldb::addr_t m_eh_frame_hdr_addr = LLDB_INVALID_ADDRESS;
+  lldb::offset_t m_eh_frame_hdr_table_offset = 0;
+  uint64_t m_eh_frame_hdr_fde_count = 0;
+  llvm::once_flag m_eh_frame_hdr_once;
+
   Type m_type;
 
   CIESP
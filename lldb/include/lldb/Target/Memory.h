@@ -57,6 +57,16 @@ protected:
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  /// The end of the lines that were read into the L2 cache by the last miss,
+  /// and how many lines that read covered. A miss right at that address
+  /// reads ahead more lines.
+  lldb::addr_t m_L2_read_ahead_end = LLDB_INVALID_ADDRESS;
+  uint32_t m_L2_read_ahead_lines = 1;
+
+  /// Read the L2 cache line at \a line_addr from the process, along with the
+  /// following lines if the misses so far look sequential. Returns the number
+  /// of bytes read.
+  size_t FillL2Cache(lldb::addr_t line_addr, Status &error);
 
 private:
   DISALLOW_COPY_AND_ASSIGN(MemoryCache);
@@ -12,6 +12,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -135,6 +136,8 @@ public:
 
   bool GetEnableNotifyAboutFixIts() const;
 
+  bool GetEnableExprVariablePathFastPath() const;
+
   bool GetEnableSaveObjects() const;
 
   bool GetEnableSyntheticValue() const;
@@ -531,6 +534,18 @@ public:
   lldb::ModuleSP GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr = nullptr);
 
+  /// Start a batch of module loads.
+  ///
+  /// Until the matching EndModuleBatch() call, the modules that
+  /// GetOrCreateModule() creates don't have their symbols preloaded right
+  /// away. EndModuleBatch() preloads the symbols of all of them in parallel
+  /// instead. Dynamic loaders use this when they discover many modules at
+  /// once, e.g. when attaching to a process. Batches can nest.
+  void BeginModuleBatch();
+
+  /// End a batch of module loads started with BeginModuleBatch().
+  void EndModuleBatch();
+
   // Settings accessors
 
   static const lldb::TargetPropertiesSP &GetGlobalProperties();
@@ -1291,6 +1306,11 @@ protected:
   Arch m_arch;
   ModuleList m_images; ///< The list of images for this process (shared
                        /// libraries and anything dynamically loaded).
+  std::mutex m_module_batch_mutex;
+  uint32_t m_module_batch_depth = 0;
+  /// Modules created in the current module batch whose symbols still need to
+  /// be preloaded.
+  std::vector<lldb::ModuleSP> m_modules_to_preload;
   SectionLoadHistory m_section_load_history;
   BreakpointList m_breakpoint_list;
   BreakpointList m_internal_breakpoint_list;
@@ -139,7 +139,7 @@ class TestGdbRemoteThreadsInStopReply(
         hw_info["little_endian"] = (endian == "little")
         return hw_info
 
-    def gather_threads_info_pcs(self, pc_register, little_endian):
+    def gather_threads_info(self):
         self.reset_test_sequence()
         self.test_sequence.add_log_lines(
                 [
@@ -155,10 +155,13 @@ class TestGdbRemoteThreadsInStopReply(
         context = self.expect_gdbremote_sequence()
         self.assertIsNotNone(context)
         threads_info = context.get("threads_info")
-        register = str(pc_register)
         # The jThreadsInfo response is not valid JSON data, so we have to
         # clean it up first.
-        jthreads_info = json.loads(re.sub(r"}]", "}", threads_info))
+        return json.loads(re.sub(r"}]", "}", threads_info))
+
+    def gather_threads_info_pcs(self, pc_register, little_endian):
+        jthreads_info = self.gather_threads_info()
+        register = str(pc_register)
         thread_pcs = dict()
         for thread_info in jthreads_info:
             tid = thread_info["tid"]
@@ -309,3 +312,28 @@ class TestGdbRemoteThreadsInStopReply(
         self.build()
         self.set_inferior_startup_launch()
         self.stop_reply_contains_thread_pcs(5)
+
+    def threads_info_expedites_requested_state(self, thread_count):
+        self.gather_stop_reply_fields(
+                self.ENABLE_THREADS_IN_STOP_REPLY_ENTRIES, thread_count, [])
+
+        jthreads_info = self.gather_threads_info()
+        self.assertEqual(len(jthreads_info), thread_count)
+        for thread_info in jthreads_info:
+            # The whole GPR set is more than the generic pc, sp, fp and ra.
+            self.assertGreater(len(thread_info["registers"]), 4)
+            # A thread whose frame pointer doesn't point at a frame record
+            # has no stack memory, so only check what was sent.
+            for memory in thread_info.get("memory", []):
+                self.assertNotEqual(memory["address"], 0)
+                self.assertIn(len(memory["bytes"]), [16, 32])
+
+    @skipUnlessPlatform(["linux"])
+    @llgs_test
+    def test_threads_info_expedites_requested_state_llgs(self):
+        self.init_llgs_test()
+        self.debug_monitor_extra_args += ["--expedited-registers=gpr",
+                                          "--expedited-stack-frames=16"]
+        self.build()
+        self.set_inferior_startup_launch()
+        self.threads_info_expedites_requested_state(5)
@@ -32,6 +32,7 @@
 #include "clang/Driver/Driver.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -83,6 +84,11 @@ ModuleListProperties::ModuleListProperties() {
   llvm::SmallString<128> path;
   clang::driver::Driver::getDefaultModuleCachePath(path);
   SetClangModulesCachePath(path);
+
+  path.clear();
+  llvm::sys::path::system_temp_directory(/*erasedOnReboot=*/false, path);
+  llvm::sys::path::append(path, "lldb", "DWARFIndexCache");
+  SetDWARFIndexCachePath(path);
 }
 
 bool ModuleListProperties::GetEnableExternalLookup() const {
@@ -108,6 +114,29 @@ bool ModuleListProperties::SetClangModulesCachePath(llvm::StringRef path) {
       nullptr, ePropertyClangModulesCachePath, path);
 }
 
+bool ModuleListProperties::GetEnableDWARFIndexCache() const {
+  const uint32_t idx = ePropertyEnableDWARFIndexCache;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_modulelist_properties[idx].default_uint_value != 0);
+}
+
+bool ModuleListProperties::SetEnableDWARFIndexCache(bool new_value) {
+  return m_collection_sp->SetPropertyAtIndexAsBoolean(
+      nullptr, ePropertyEnableDWARFIndexCache, new_value);
+}
+
+FileSpec ModuleListProperties::GetDWARFIndexCachePath() const {
+  return m_collection_sp
+      ->GetPropertyAtIndexAsOptionValueFileSpec(nullptr, false,
+                                                ePropertyDWARFIndexCachePath)
+      ->GetCurrentValue();
+}
+
+bool ModuleListProperties::SetDWARFIndexCachePath(llvm::StringRef path) {
+  return m_collection_sp->SetPropertyAtIndexAsString(
+      nullptr, ePropertyDWARFIndexCachePath, path);
+}
+
 ModuleList::ModuleList()
     : m_modules(), m_modules_mutex(), m_notifier(nullptr) {}
 
@@ -35,6 +35,7 @@
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/Language.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
@@ -138,6 +139,70 @@ lldb::addr_t UserExpression::GetObjectPointer(lldb::StackFrameSP frame_sp,
   return ret;
 }
 
+/// Returns true if \a expr is only a variable path, i.e. an identifier
+/// followed by any number of ".member", "->member" and "[index]" accesses
+/// with literal decimal indexes.
+static bool IsSimpleVariablePath(llvm::StringRef expr) {
+  const size_t size = expr.size();
+  size_t pos = 0;
+  auto consume_identifier = [&]() {
+    if (pos == size || !(isalpha(expr[pos]) || expr[pos] == '_'))
+      return false;
+    while (pos < size && (isalnum(expr[pos]) || expr[pos] == '_'))
+      ++pos;
+    return true;
+  };
+
+  if (!consume_identifier())
+    return false;
+  while (pos < size) {
+    if (expr[pos] == '.') {
+      ++pos;
+      if (!consume_identifier())
+        return false;
+    } else if (expr.substr(pos).startswith("->")) {
+      pos += 2;
+      if (!consume_identifier())
+        return false;
+    } else if (expr[pos] == '[') {
+      const size_t index_pos = ++pos;
+      while (pos < size && isdigit(expr[pos]))
+        ++pos;
+      if (pos == index_pos || pos == size || expr[pos] != ']')
+        return false;
+      ++pos;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Evaluate the variable path \a expr in \a frame the way "frame variable"
+/// does, without compiling it. Synthetic children are not used so that
+/// "[]" and "->" keep their C meaning. Returns the result, made persistent
+/// unless the options ask for an internal result, or null if the path could
+/// not be evaluated this way.
+static lldb::ValueObjectSP
+EvaluateVariablePath(StackFrame &frame,
+                     const EvaluateExpressionOptions &options,
+                     llvm::StringRef expr) {
+  const uint32_t path_options =
+      StackFrame::eExpressionPathOptionCheckPtrVsMember |
+      StackFrame::eExpressionPathOptionsNoSyntheticChildren |
+      StackFrame::eExpressionPathOptionsNoSyntheticArrayRange;
+  lldb::VariableSP var_sp;
+  Status error;
+  lldb::ValueObjectSP valobj_sp = frame.GetValueForVariableExpressionPath(
+      expr, lldb::eNoDynamicValues, path_options, var_sp, error);
+  if (error.Fail() || !valobj_sp || !valobj_sp->UpdateValueIfNeeded() ||
+      valobj_sp->GetError().Fail())
+    return lldb::ValueObjectSP();
+  if (options.GetResultIsInternal())
+    return valobj_sp;
+  return valobj_sp->Persist();
+}
+
 lldb::ExpressionResults UserExpression::Evaluate(
     ExecutionContext &exe_ctx, const EvaluateExpressionOptions &options,
     llvm::StringRef expr, llvm::StringRef prefix,
@@ -219,6 +284,27 @@ lldb::ExpressionResults UserExpression::Evaluate(
       language = frame->GetLanguage();
   }
 
+  // Expressions that are only a variable path, such as "foo->bar[3]", can be
+  // evaluated from the debug info of the frame without running the compiler.
+  StackFrame *frame = exe_ctx.GetFramePtr();
+  if (frame && !ctx_obj && full_prefix.empty() &&
+      desired_type == UserExpression::eResultTypeAny &&
+      execution_policy != eExecutionPolicyTopLevel &&
+      (Language::LanguageIsC(language) ||
+       Language::LanguageIsCPlusPlus(language)) &&
+      target->GetEnableExprVariablePathFastPath() &&
+      IsSimpleVariablePath(expr)) {
+    if (lldb::ValueObjectSP valobj_sp =
+            EvaluateVariablePath(*frame, options, expr)) {
+      LLDB_LOGF(log,
+                "== [UserExpression::Evaluate] Evaluated variable path %s "
+                "without compiling it ==",
+                expr.str().c_str());
+      result_valobj_sp = valobj_sp;
+      return lldb::eExpressionCompleted;
+    }
+  }
+
   lldb::UserExpressionSP user_expression_sp(
       target->GetUserExpressionForLanguage(expr, full_prefix, language,
                                            desired_type, options, ctx_obj,
@@ -419,6 +419,7 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
   if (m_rendezvous.ModulesDidLoad()) {
     ModuleList new_modules;
 
+    m_process->GetTarget().BeginModuleBatch();
     E = m_rendezvous.loaded_end();
     for (I = m_rendezvous.loaded_begin(); I != E; ++I) {
       ModuleSP module_sp =
@@ -428,6 +429,7 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
         new_modules.Append(module_sp);
       }
     }
+    m_process->GetTarget().EndModuleBatch();
     m_process->GetTarget().ModulesDidLoad(new_modules);
   }
 
@@ -574,6 +576,8 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
 
+  // Preload the symbols of all the modules in parallel once they are loaded.
+  m_process->GetTarget().BeginModuleBatch();
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     ModuleSP module_sp =
         LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -589,6 +593,7 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
           __FUNCTION__, I->file_spec.GetCString(), I->base_addr);
     }
   }
+  m_process->GetTarget().EndModuleBatch();
 
   m_process->GetTarget().ModulesDidLoad(module_list);
 }
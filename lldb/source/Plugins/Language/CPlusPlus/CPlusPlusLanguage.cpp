@@ -549,12 +549,12 @@ static void LoadLibCxxFormatters(lldb::TypeCategoryImplSP cpp_category_sp) {
       "libc++ std::atomic synthetic children",
       ConstString("^std::__[[:alnum:]]+::atomic<.+>$"), stl_synth_flags, true);
 
-  cpp_category_sp->GetRegexTypeSyntheticsContainer()->Add(
-      RegularExpression(
-          llvm::StringRef("^(std::__[[:alnum:]]+::)deque<.+>(( )?&)?$")),
-      SyntheticChildrenSP(new ScriptedSyntheticChildren(
-          stl_synth_flags,
-          "lldb.formatters.cpp.libcxx.stddeque_SynthProvider")));
+  AddCXXSynthetic(
+      cpp_category_sp,
+      lldb_private::formatters::LibcxxStdDequeSyntheticFrontEndCreator,
+      "libc++ std::deque synthetic children",
+      ConstString("^std::__[[:alnum:]]+::deque<.+>(( )?&)?$"), stl_deref_flags,
+      true);
 
   AddCXXSynthetic(
       cpp_category_sp,
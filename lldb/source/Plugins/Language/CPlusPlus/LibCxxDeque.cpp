@@ -0,0 +1,116 @@
+//===-- LibCxxDeque.cpp -----------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibCxx.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
+#include "lldb/Target/Process.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+// A libc++ deque keeps its elements in fixed size blocks. __map_ is a
+// __split_buffer of pointers to the blocks, and element i of the deque lives
+// at index (__start_ + i) of the concatenated blocks.
+class DequeFrontEnd : public SyntheticChildrenFrontEnd {
+public:
+  DequeFrontEnd(ValueObject &valobj) : SyntheticChildrenFrontEnd(valobj) {
+    Update();
+  }
+
+  size_t GetIndexOfChildWithName(ConstString name) override {
+    return formatters::ExtractIndexFromString(name.GetCString());
+  }
+
+  bool MightHaveChildren() override { return true; }
+  bool Update() override;
+  size_t CalculateNumChildren() override { return m_size; }
+  ValueObjectSP GetChildAtIndex(size_t idx) override;
+
+private:
+  CompilerType m_element_type;
+  uint64_t m_element_size = 0;
+  uint64_t m_block_size = 0;
+  uint64_t m_start = 0;
+  size_t m_size = 0;
+  lldb::addr_t m_map_begin = 0;
+};
+} // namespace
+
+bool DequeFrontEnd::Update() {
+  m_size = 0;
+  m_start = 0;
+  m_map_begin = 0;
+  m_element_size = 0;
+  m_block_size = 0;
+
+  ValueObjectSP map_sp =
+      m_backend.GetChildMemberWithName(ConstString("__map_"), true);
+  ValueObjectSP start_sp =
+      m_backend.GetChildMemberWithName(ConstString("__start_"), true);
+  ValueObjectSP size_pair_sp =
+      m_backend.GetChildMemberWithName(ConstString("__size_"), true);
+  if (!map_sp || !start_sp || !size_pair_sp)
+    return false;
+
+  ValueObjectSP map_begin_sp =
+      map_sp->GetChildMemberWithName(ConstString("__begin_"), true);
+  ValueObjectSP size_sp =
+      formatters::GetValueOfLibCXXCompressedPair(*size_pair_sp);
+  if (!map_begin_sp || !size_sp)
+    return false;
+
+  // __begin_ is a pointer to the block pointers.
+  m_element_type =
+      map_begin_sp->GetCompilerType().GetPointeeType().GetPointeeType();
+  llvm::Optional<uint64_t> element_size = m_element_type.GetByteSize(nullptr);
+  if (!element_size || *element_size == 0)
+    return false;
+  m_element_size = *element_size;
+  // This matches __deque_block_size in <deque>.
+  m_block_size = m_element_size < 256 ? 4096 / m_element_size : 16;
+
+  m_map_begin = map_begin_sp->GetValueAsUnsigned(0);
+  if (m_map_begin == 0)
+    return false;
+  m_start = start_sp->GetValueAsUnsigned(0);
+  m_size = size_sp->GetValueAsUnsigned(0);
+  return false;
+}
+
+ValueObjectSP DequeFrontEnd::GetChildAtIndex(size_t idx) {
+  if (idx >= m_size || m_block_size == 0)
+    return ValueObjectSP();
+
+  ProcessSP process_sp = m_backend.GetProcessSP();
+  if (!process_sp)
+    return ValueObjectSP();
+
+  const uint64_t pos = m_start + idx;
+  const lldb::addr_t block_ptr_addr =
+      m_map_begin + (pos / m_block_size) * process_sp->GetAddressByteSize();
+  Status error;
+  const lldb::addr_t block =
+      process_sp->ReadPointerFromMemory(block_ptr_addr, error);
+  if (error.Fail() || block == 0)
+    return ValueObjectSP();
+
+  return CreateValueObjectFromAddress(
+      llvm::formatv("[{0}]", idx).str(),
+      block + (pos % m_block_size) * m_element_size,
+      m_backend.GetExecutionContextRef(), m_element_type);
+}
+
+SyntheticChildrenFrontEnd *
+formatters::LibcxxStdDequeSyntheticFrontEndCreator(
+    CXXSyntheticChildren *, lldb::ValueObjectSP valobj_sp) {
+  if (valobj_sp)
+    return new DequeFrontEnd(*valobj_sp);
+  return nullptr;
+}
@@ -171,10 +171,9 @@ Status ProcessElfCore::DoLoadCore() {
   /// PT_NOTE - Contains Thread and Register information
   /// PT_LOAD - Contains a contiguous range of Process Address Space
   for (const elf::ELFProgramHeader &H : segments) {
-    DataExtractor data = core->GetSegmentData(H);
-
     // Parse thread contexts and auxv structure
     if (H.p_type == llvm::ELF::PT_NOTE) {
+      DataExtractor data = core->GetSegmentData(H);
       if (llvm::Error error = ParseThreadContextsFromNoteSegment(H, data))
         return Status(std::move(error));
     }
@@ -331,53 +330,54 @@ size_t ProcessElfCore::DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
   if (core_objfile == nullptr)
     return 0;
 
-  // Get the address range
-  const VMRangeToFileOffset::Entry *address_range =
-      m_core_aranges.FindEntryThatContains(addr);
-  if (address_range == nullptr || address_range->GetRangeEnd() < addr) {
-    error.SetErrorStringWithFormat("core file does not contain 0x%" PRIx64,
-                                   addr);
-    return 0;
-  }
-
-  // Convert the address into core file offset
-  const lldb::addr_t offset = addr - address_range->GetRangeBase();
-  const lldb::addr_t file_start = address_range->data.GetRangeBase();
-  const lldb::addr_t file_end = address_range->data.GetRangeEnd();
-  size_t bytes_to_read = size; // Number of bytes to read from the core file
-  size_t bytes_copied = 0;   // Number of bytes actually read from the core file
-  size_t zero_fill_size = 0; // Padding
-  lldb::addr_t bytes_left =
-      0; // Number of bytes available in the core file from the given address
-
-  // Don't proceed if core file doesn't contain the actual data for this
-  // address range.
-  if (file_start == file_end)
-    return 0;
+  // The core file is memory mapped, so the data is copied straight out of
+  // the mapping. A read can span several consecutive PT_LOAD segments.
+  uint8_t *dst = static_cast<uint8_t *>(buf);
+  size_t bytes_read = 0;
+  while (bytes_read < size) {
+    const lldb::addr_t cur_addr = addr + bytes_read;
+    const VMRangeToFileOffset::Entry *address_range =
+        m_core_aranges.FindEntryThatContains(cur_addr);
+    if (address_range == nullptr)
+      break;
 
-  // Figure out how many on-disk bytes remain in this segment starting at the
-  // given offset
-  if (file_end > file_start + offset)
-    bytes_left = file_end - (file_start + offset);
+    // Convert the address into core file offset
+    const lldb::addr_t offset = cur_addr - address_range->GetRangeBase();
+    const lldb::addr_t file_start = address_range->data.GetRangeBase();
+    const lldb::addr_t file_end = address_range->data.GetRangeEnd();
 
-  // Figure out how many bytes we need to zero-fill if we are reading more
-  // bytes than available in the on-disk segment
-  if (bytes_to_read > bytes_left) {
-    zero_fill_size = bytes_to_read - bytes_left;
-    bytes_to_read = bytes_left;
-  }
+    // Don't proceed if core file doesn't contain the actual data for this
+    // address range.
+    if (file_start == file_end)
+      break;
 
-  // If there is data available on the core file read it
-  if (bytes_to_read)
-    bytes_copied =
-        core_objfile->CopyData(offset + file_start, bytes_to_read, buf);
+    // Number of bytes of the read that fall into this segment, and how many
+    // of them are on disk. The rest of the segment is zero-filled.
+    const size_t segment_bytes = std::min<lldb::addr_t>(
+        size - bytes_read, address_range->GetRangeEnd() - cur_addr);
+    size_t bytes_to_copy = 0;
+    if (file_end > file_start + offset)
+      bytes_to_copy = std::min<lldb::addr_t>(segment_bytes,
+                                             file_end - (file_start + offset));
+
+    size_t bytes_copied = 0;
+    if (bytes_to_copy)
+      bytes_copied = core_objfile->CopyData(offset + file_start, bytes_to_copy,
+                                            dst + bytes_read);
+    if (bytes_copied < bytes_to_copy) {
+      bytes_read += bytes_copied;
+      break;
+    }
 
-  assert(zero_fill_size <= size);
-  // Pad remaining bytes
-  if (zero_fill_size)
-    memset(((char *)buf) + bytes_copied, 0, zero_fill_size);
+    // Pad remaining bytes
+    memset(dst + bytes_read + bytes_copied, 0, segment_bytes - bytes_copied);
+    bytes_read += segment_bytes;
+  }
 
-  return bytes_copied + zero_fill_size;
+  if (bytes_read == 0)
+    error.SetErrorStringWithFormat("core file does not contain 0x%" PRIx64,
+                                   addr);
+  return bytes_read;
 }
 
 void ProcessElfCore::Clear() {
@@ -31,6 +31,7 @@
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Utility/Args.h"
 #include "lldb/Utility/DataBuffer.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Endian.h"
 #include "lldb/Utility/JSON.h"
 #include "lldb/Utility/LLDBAssert.h"
@@ -402,37 +403,40 @@ static void WriteRegisterValueInHexFixedWidth(
   }
 }
 
-static JSONObject::SP GetRegistersAsJSON(NativeThreadProtocol &thread) {
+static JSONObject::SP GetRegistersAsJSON(NativeThreadProtocol &thread,
+                                         bool full_register_set) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
 
   NativeRegisterContext& reg_ctx = thread.GetRegisterContext();
 
   JSONObject::SP register_object_sp = std::make_shared<JSONObject>();
 
-#ifdef LLDB_JTHREADSINFO_FULL_REGISTER_SET
-  // Expedite all registers in the first register set (i.e. should be GPRs)
-  // that are not contained in other registers.
-  const RegisterSet *reg_set_p = reg_ctx_sp->GetRegisterSet(0);
-  if (!reg_set_p)
-    return nullptr;
-  for (const uint32_t *reg_num_p = reg_set_p->registers;
-       *reg_num_p != LLDB_INVALID_REGNUM; ++reg_num_p) {
-    uint32_t reg_num = *reg_num_p;
-#else
-  // Expedite only a couple of registers until we figure out why sending
-  // registers is expensive.
+  // By default expedite only the registers the unwinder needs for the first
+  // frame. Sending the whole first register set (i.e. should be GPRs) saves
+  // the client from reading the callee saved registers of older frames, at
+  // the cost of a larger packet for every thread.
   static const uint32_t k_expedited_registers[] = {
       LLDB_REGNUM_GENERIC_PC, LLDB_REGNUM_GENERIC_SP, LLDB_REGNUM_GENERIC_FP,
-      LLDB_REGNUM_GENERIC_RA, LLDB_INVALID_REGNUM};
-
-  for (const uint32_t *generic_reg_p = k_expedited_registers;
-       *generic_reg_p != LLDB_INVALID_REGNUM; ++generic_reg_p) {
-    uint32_t reg_num = reg_ctx.ConvertRegisterKindToRegisterNumber(
-        eRegisterKindGeneric, *generic_reg_p);
-    if (reg_num == LLDB_INVALID_REGNUM)
-      continue; // Target does not support the given register.
-#endif
+      LLDB_REGNUM_GENERIC_RA};
+
+  std::vector<uint32_t> reg_nums;
+  const RegisterSet *reg_set_p = nullptr;
+  if (full_register_set && reg_ctx.GetRegisterSetCount() > 0)
+    reg_set_p = reg_ctx.GetRegisterSet(0);
+  if (reg_set_p) {
+    reg_nums.assign(reg_set_p->registers,
+                    reg_set_p->registers + reg_set_p->num_registers);
+  } else {
+    for (uint32_t generic_reg : k_expedited_registers) {
+      uint32_t reg_num = reg_ctx.ConvertRegisterKindToRegisterNumber(
+          eRegisterKindGeneric, generic_reg);
+      if (reg_num == LLDB_INVALID_REGNUM)
+        continue; // Target does not support the given register.
+      reg_nums.push_back(reg_num);
+    }
+  }
 
+  for (uint32_t reg_num : reg_nums) {
     const RegisterInfo *const reg_info_p =
         reg_ctx.GetRegisterInfoAtIndex(reg_num);
     if (reg_info_p == nullptr) {
@@ -468,6 +472,56 @@ static JSONObject::SP GetRegistersAsJSON(NativeThreadProtocol &thread) {
   return register_object_sp;
 }
 
+static JSONArray::SP GetStackMemoryAsJSON(NativeProcessProtocol &process,
+                                          NativeThreadProtocol &thread,
+                                          uint32_t frame_limit) {
+  NativeRegisterContext &reg_ctx = thread.GetRegisterContext();
+  const uint32_t fp_reg_num = reg_ctx.ConvertRegisterKindToRegisterNumber(
+      eRegisterKindGeneric, LLDB_REGNUM_GENERIC_FP);
+  if (fp_reg_num == LLDB_INVALID_REGNUM)
+    return nullptr;
+  const RegisterInfo *const fp_reg_info_p =
+      reg_ctx.GetRegisterInfoAtIndex(fp_reg_num);
+  RegisterValue fp_value;
+  if (!fp_reg_info_p || reg_ctx.ReadRegister(fp_reg_info_p, fp_value).Fail())
+    return nullptr;
+
+  const uint32_t addr_size = process.GetAddressByteSize();
+  if (addr_size != 4 && addr_size != 8)
+    return nullptr;
+
+  // Send the saved frame pointer and return address of every frame in the
+  // frame pointer backchain, so backtracing doesn't have to read them.
+  JSONArray::SP memory_array_sp = std::make_shared<JSONArray>();
+  lldb::addr_t fp = fp_value.GetAsUInt64(0);
+  for (uint32_t frame = 0; frame < frame_limit && fp != 0; ++frame) {
+    uint8_t bytes[16];
+    const size_t read_size = addr_size * 2;
+    size_t bytes_read = 0;
+    Status error = process.ReadMemory(fp, bytes, read_size, bytes_read);
+    if (error.Fail() || bytes_read != read_size)
+      break;
+
+    StreamString stream;
+    stream.PutBytesAsRawHex8(bytes, read_size);
+    JSONObject::SP memory_object_sp = std::make_shared<JSONObject>();
+    memory_object_sp->SetObject("address", std::make_shared<JSONNumber>(fp));
+    memory_object_sp->SetObject(
+        "bytes", std::make_shared<JSONString>(stream.GetString()));
+    memory_array_sp->AppendObject(memory_object_sp);
+
+    DataExtractor data(bytes, read_size, process.GetByteOrder(), addr_size);
+    lldb::offset_t offset = 0;
+    const lldb::addr_t caller_fp = data.GetAddress(&offset);
+    // The stack grows down, so a caller's frame is always above its callee's.
+    // Stopping otherwise also keeps us from looping on a corrupt chain.
+    if (caller_fp <= fp)
+      break;
+    fp = caller_fp;
+  }
+  return memory_array_sp;
+}
+
 static const char *GetStopReasonString(StopReason stop_reason) {
   switch (stop_reason) {
   case eStopReasonTrace:
@@ -493,7 +547,9 @@ static const char *GetStopReasonString(StopReason stop_reason) {
 }
 
 static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
-                                        bool abridged) {
+                                        bool abridged,
+                                        bool full_register_set = false,
+                                        uint32_t stack_frame_limit = 0) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
 
   JSONArray::SP threads_array_sp = std::make_shared<JSONArray>();
@@ -526,8 +582,15 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
     threads_array_sp->AppendObject(thread_obj_sp);
 
     if (!abridged) {
-      if (JSONObject::SP registers_sp = GetRegistersAsJSON(*thread))
+      if (JSONObject::SP registers_sp =
+              GetRegistersAsJSON(*thread, full_register_set))
         thread_obj_sp->SetObject("registers", registers_sp);
+      if (stack_frame_limit > 0) {
+        JSONArray::SP memory_sp =
+            GetStackMemoryAsJSON(process, *thread, stack_frame_limit);
+        if (memory_sp && memory_sp->GetNumElements() > 0)
+          thread_obj_sp->SetObject("memory", memory_sp);
+      }
     }
 
     thread_obj_sp->SetObject("tid", std::make_shared<JSONNumber>(tid));
@@ -561,8 +624,6 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
       }
       thread_obj_sp->SetObject("medata", medata_array_sp);
     }
-
-    // TODO: Expedite interesting regions of inferior memory
   }
 
   return threads_array_sp;
@@ -930,6 +991,12 @@ Status GDBRemoteCommunicationServerLLGS::InitializeConnection(
   return error;
 }
 
+void GDBRemoteCommunicationServerLLGS::SetExpeditedThreadsInfo(
+    bool full_register_set, uint32_t stack_frame_limit) {
+  m_expedite_full_register_set = full_register_set;
+  m_expedited_stack_frame_limit = stack_frame_limit;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendONotification(const char *buffer,
                                                     uint32_t len) {
@@ -3080,7 +3147,8 @@ GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo(
   StreamString response;
   const bool threads_with_valid_stop_info_only = false;
   JSONArray::SP threads_array_sp = GetJSONThreadsInfo(
-      *m_debugged_process_up, threads_with_valid_stop_info_only);
+      *m_debugged_process_up, threads_with_valid_stop_info_only,
+      m_expedite_full_register_set, m_expedited_stack_frame_limit);
   if (!threads_array_sp) {
     LLDB_LOG(log, "failed to prepare a packet for pid {0}",
              m_debugged_process_up->GetID());
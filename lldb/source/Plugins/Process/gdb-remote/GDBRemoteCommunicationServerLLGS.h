@@ -69,6 +69,18 @@ public:
 
   Status InitializeConnection(std::unique_ptr<Connection> &&connection);
 
+  /// Configure what the jThreadsInfo reply expedites for each thread.
+  ///
+  /// \param[in] full_register_set
+  ///     If true, send every register of the first (general purpose)
+  ///     register set instead of only the pc, sp, fp and ra registers.
+  ///
+  /// \param[in] stack_frame_limit
+  ///     The number of frames of the frame pointer backchain to send as
+  ///     expedited stack memory. Zero sends no stack memory.
+  void SetExpeditedThreadsInfo(bool full_register_set,
+                               uint32_t stack_frame_limit);
+
 protected:
   MainLoop &m_mainloop;
   MainLoop::ReadHandleUP m_network_handle_up;
@@ -87,6 +99,8 @@ protected:
   std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
   uint32_t m_next_saved_registers_id = 1;
   bool m_handshake_completed = false;
+  bool m_expedite_full_register_set = false;
+  uint32_t m_expedited_stack_frame_limit = 0;
 
   PacketResult SendONotification(const char *buffer, uint32_t len);
 
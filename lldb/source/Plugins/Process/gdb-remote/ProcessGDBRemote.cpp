@@ -1783,6 +1783,16 @@ bool ProcessGDBRemote::CalculateThreadStopInfo(ThreadGDBRemote *thread) {
     return true;
   }
 
+  // Without a stop reply that describes the other threads, fetch the stop
+  // info of all of them with one "jThreadsInfo" packet instead of sending a
+  // "qThreadStopInfo" packet for each thread. The reply is kept until we
+  // resume, so the remaining threads and WillPublicStop() reuse it.
+  if (!m_jthreadsinfo_sp) {
+    m_jthreadsinfo_sp = m_gdb_comm.GetThreadsInfo();
+    if (GetThreadStopInfoFromJSON(thread, m_jthreadsinfo_sp))
+      return true;
+  }
+
   // Fall back to using the qThreadStopInfo packet
   StringExtractorGDBRemote stop_packet;
   if (GetGDBRemote().GetThreadStopInfo(thread->GetProtocolID(), stop_packet))
@@ -2736,8 +2746,10 @@ void ProcessGDBRemote::WillPublicStop() {
   // gather stop info for all threads, expedited registers, expedited memory,
   // runtime queue information (iOS and MacOSX only), and more. Expediting
   // memory will help stack backtracing be much faster. Expediting registers
-  // will make sure we don't have to read the thread registers for GPRs.
-  m_jthreadsinfo_sp = m_gdb_comm.GetThreadsInfo();
+  // will make sure we don't have to read the thread registers for GPRs. A
+  // private stop may already have fetched the info for this stop.
+  if (!m_jthreadsinfo_sp)
+    m_jthreadsinfo_sp = m_gdb_comm.GetThreadsInfo();
 
   if (m_jthreadsinfo_sp) {
     // Now set the stop info for each thread and also expedite any registers
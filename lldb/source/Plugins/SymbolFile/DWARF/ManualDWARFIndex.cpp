@@ -13,10 +13,18 @@
 #include "Plugins/SymbolFile/DWARF/LogChannelDWARF.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARFDwo.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace lldb_private;
 using namespace lldb;
@@ -41,6 +49,11 @@ void ManualDWARFIndex::Index() {
   if (units_to_index.empty())
     return;
 
+  std::string cache_key = GetCacheKey();
+  std::string cache_path = GetCacheFilePath(cache_key);
+  if (!cache_path.empty() && LoadFromCache(cache_path, cache_key))
+    return;
+
   std::vector<IndexSet> sets(units_to_index.size());
 
   // Keep memory down by clearing DIEs for any units if indexing
@@ -85,6 +98,130 @@ void ManualDWARFIndex::Index() {
                      [&]() { finalize_fn(&IndexSet::globals); },
                      [&]() { finalize_fn(&IndexSet::types); },
                      [&]() { finalize_fn(&IndexSet::namespaces); });
+
+  // The index of a unit with split DWARF includes the DIEs of its .dwo file,
+  // which the cache key doesn't cover, so only cache modules without them.
+  if (!cache_path.empty() &&
+      llvm::none_of(units_to_index, [](DWARFUnit *unit) {
+        return unit->GetDwoSymbolFile() != nullptr;
+      }))
+    SaveToCache(cache_path, cache_key);
+}
+
+static const char g_cache_magic[] = "LLDBDWIX";
+static const uint32_t g_cache_version = 1;
+
+std::string ManualDWARFIndex::GetCacheKey() {
+  ConstString object_name = m_module.GetObjectName();
+  const llvm::sys::TimePoint<> &mod_time =
+      object_name ? m_module.GetObjectModificationTime()
+                  : m_module.GetModificationTime();
+  if (mod_time == llvm::sys::TimePoint<>())
+    return std::string();
+
+  std::string key;
+  llvm::raw_string_ostream os(key);
+  os << m_module.GetFileSpec().GetPath();
+  if (object_name)
+    os << '(' << object_name.GetStringRef() << ')';
+  os << ' ' << m_module.GetUUID().GetAsString() << ' '
+     << mod_time.time_since_epoch().count();
+  return os.str();
+}
+
+std::string ManualDWARFIndex::GetCacheFilePath(llvm::StringRef key) {
+  ModuleListProperties &properties =
+      ModuleList::GetGlobalModuleListProperties();
+  // A partial index that skips some units can't be reused by a full one.
+  if (key.empty() || !m_units_to_avoid.empty() ||
+      !properties.GetEnableDWARFIndexCache())
+    return std::string();
+  FileSpec cache_dir = properties.GetDWARFIndexCachePath();
+  if (!cache_dir)
+    return std::string();
+
+  llvm::MD5 hash;
+  hash.update(key);
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+
+  llvm::SmallString<256> path(cache_dir.GetPath());
+  llvm::sys::path::append(
+      path, m_module.GetFileSpec().GetFilename().GetStringRef() + "-" +
+                result.digest() + ".dwarfindex");
+  return path.str();
+}
+
+bool ManualDWARFIndex::LoadFromCache(llvm::StringRef path,
+                                     llvm::StringRef key) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer_or =
+      llvm::MemoryBuffer::getFile(path, /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!buffer_or)
+    return false;
+
+  llvm::DataExtractor data((*buffer_or)->getBuffer(),
+                           /*IsLittleEndian=*/true, /*AddressSize=*/8);
+  uint64_t offset = 0;
+  if (data.getCStrRef(&offset) != g_cache_magic ||
+      !data.isValidOffsetForDataOfSize(offset, 4) ||
+      data.getU32(&offset) != g_cache_version ||
+      data.getCStrRef(&offset) != key)
+    return false;
+
+  IndexSet set;
+  bool success = true;
+  set.ForEachMap([&](NameToDIE &map) {
+    success = success && map.Decode(data, &offset);
+  });
+
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  if (!success) {
+    LLDB_LOG(log, "Ignoring truncated DWARF index cache file {0}", path);
+    return false;
+  }
+  LLDB_LOG(log, "Loaded DWARF index of {0} from {1}",
+           m_module.GetFileSpec(), path);
+  m_set = std::move(set);
+  return true;
+}
+
+void ManualDWARFIndex::SaveToCache(llvm::StringRef path, llvm::StringRef key) {
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  llvm::StringRef cache_dir = llvm::sys::path::parent_path(path);
+  if (std::error_code ec = llvm::sys::fs::create_directories(cache_dir)) {
+    LLDB_LOG(log, "Unable to create DWARF index cache directory for {0}: {1}",
+             path, ec.message());
+    return;
+  }
+
+  // Write to a temporary file and rename it into place, so that concurrent
+  // debug sessions never see a partially written index.
+  llvm::Expected<llvm::sys::fs::TempFile> temp =
+      llvm::sys::fs::TempFile::create(path + ".tmp-%%%%%%");
+  if (!temp) {
+    LLDB_LOG_ERROR(log, temp.takeError(),
+                   "Unable to create DWARF index cache file: {0}");
+    return;
+  }
+
+  llvm::raw_fd_ostream os(temp->FD, /*shouldClose=*/false);
+  llvm::support::endian::Writer writer(os, llvm::support::little);
+  os << g_cache_magic << '\0';
+  writer.write<uint32_t>(g_cache_version);
+  os << key << '\0';
+  m_set.ForEachMap([&](NameToDIE &map) { map.Encode(os); });
+  os.flush();
+  if (os.has_error()) {
+    os.clear_error();
+    LLDB_LOG(log, "Unable to write DWARF index cache file {0}", path);
+    llvm::consumeError(temp->discard());
+    return;
+  }
+
+  if (llvm::Error error = temp->keep(path))
+    LLDB_LOG_ERROR(log, std::move(error),
+                   "Unable to save DWARF index cache file: {0}");
 }
 
 void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, IndexSet &set) {
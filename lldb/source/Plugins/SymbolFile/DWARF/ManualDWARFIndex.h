@@ -54,10 +54,38 @@ private:
     NameToDIE globals;
     NameToDIE types;
     NameToDIE namespaces;
+
+    /// Call \a fn on each of the maps of this set, in a fixed order.
+    template <typename Fn> void ForEachMap(Fn fn) {
+      fn(function_basenames);
+      fn(function_fullnames);
+      fn(function_methods);
+      fn(function_selectors);
+      fn(objc_class_selectors);
+      fn(globals);
+      fn(types);
+      fn(namespaces);
+    }
   };
   void Index();
   void IndexUnit(DWARFUnit &unit, IndexSet &set);
 
+  /// Return a string that identifies the exact contents of the module, or an
+  /// empty string if the module can't be identified.
+  std::string GetCacheKey();
+
+  /// Return the path of the file in the DWARF index cache that holds the
+  /// index of the module identified by \a key, or an empty string if the
+  /// index shouldn't be cached.
+  std::string GetCacheFilePath(llvm::StringRef key);
+
+  /// Fill m_set from the cache file at \a path. Returns false if the file
+  /// doesn't exist, is malformed, or was written for a different \a key.
+  bool LoadFromCache(llvm::StringRef path, llvm::StringRef key);
+
+  /// Write m_set to the cache file at \a path.
+  void SaveToCache(llvm::StringRef path, llvm::StringRef key);
+
   static void IndexUnitImpl(DWARFUnit &unit,
                             const lldb::LanguageType cu_language,
                             IndexSet &set);
@@ -13,6 +13,9 @@
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -76,3 +79,53 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+// A DIERef is encoded as two 32-bit words: the first holds the dwo number in
+// the low 30 bits, whether it is valid in bit 30 and the section in bit 31,
+// the second holds the DIE offset.
+static const uint32_t k_dwo_num_valid_bit = 1u << 30;
+static const uint32_t k_debug_types_bit = 1u << 31;
+static const uint32_t k_dwo_num_mask = k_dwo_num_valid_bit - 1;
+
+void NameToDIE::Encode(llvm::raw_ostream &os) const {
+  llvm::support::endian::Writer writer(os, llvm::support::little);
+  const uint32_t size = m_map.GetSize();
+  writer.write<uint32_t>(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    const DIERef &die_ref = m_map.GetValueAtIndexUnchecked(i);
+    uint32_t id = die_ref.dwo_num().getValueOr(0) & k_dwo_num_mask;
+    if (die_ref.dwo_num())
+      id |= k_dwo_num_valid_bit;
+    if (die_ref.section() == DIERef::DebugTypes)
+      id |= k_debug_types_bit;
+    os << m_map.GetCStringAtIndexUnchecked(i).GetStringRef() << '\0';
+    writer.write<uint32_t>(id);
+    writer.write<uint32_t>(die_ref.die_offset());
+  }
+}
+
+bool NameToDIE::Decode(const llvm::DataExtractor &data, uint64_t *offset_ptr) {
+  m_map.Clear();
+  if (!data.isValidOffsetForDataOfSize(*offset_ptr, 4))
+    return false;
+  const uint32_t size = data.getU32(offset_ptr);
+  for (uint32_t i = 0; i < size; ++i) {
+    const uint64_t name_offset = *offset_ptr;
+    llvm::StringRef name = data.getCStrRef(offset_ptr);
+    if (*offset_ptr == name_offset ||
+        !data.isValidOffsetForDataOfSize(*offset_ptr, 8))
+      return false;
+    const uint32_t id = data.getU32(offset_ptr);
+    const dw_offset_t die_offset = data.getU32(offset_ptr);
+    llvm::Optional<uint32_t> dwo_num;
+    if (id & k_dwo_num_valid_bit)
+      dwo_num = id & k_dwo_num_mask;
+    DIERef::Section section =
+        (id & k_debug_types_bit) ? DIERef::DebugTypes : DIERef::DebugInfo;
+    m_map.Append(ConstString(name), DIERef(dwo_num, section, die_offset));
+  }
+  // The order of the entries depends on the addresses of the interned strings,
+  // so it has to be recomputed.
+  Finalize();
+  return true;
+}
@@ -18,6 +18,11 @@
 
 class DWARFUnit;
 
+namespace llvm {
+class DataExtractor;
+class raw_ostream;
+} // namespace llvm
+
 class NameToDIE {
 public:
   NameToDIE() : m_map() {}
@@ -46,6 +51,15 @@ public:
                              const DIERef &die_ref)> const
               &callback) const;
 
+  /// Write the entries of this map to \a os in a form that Decode() can read
+  /// back in a later debug session.
+  void Encode(llvm::raw_ostream &os) const;
+
+  /// Replace the contents of this map with the entries encoded at
+  /// \a *offset_ptr in \a data and finalize the map. Returns false if the
+  /// data is truncated.
+  bool Decode(const llvm::DataExtractor &data, uint64_t *offset_ptr);
+
 protected:
   lldb_private::UniqueCStringMap<DIERef> m_map;
 };
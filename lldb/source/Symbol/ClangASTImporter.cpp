@@ -18,8 +18,10 @@
 #include "clang/AST/DeclObjC.h"
 #include "clang/Sema/Lookup.h"
 #include "clang/Sema/Sema.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <memory>
 
 using namespace lldb_private;
@@ -27,6 +29,15 @@ using namespace clang;
 
 ClangASTMetrics::Counters ClangASTMetrics::global_counters = {0, 0, 0, 0, 0, 0};
 ClangASTMetrics::Counters ClangASTMetrics::local_counters = {0, 0, 0, 0, 0, 0};
+llvm::StringMap<ClangASTMetrics::TypeImportStats>
+    ClangASTMetrics::type_import_stats;
+
+void ClangASTMetrics::RegisterTypeImport(llvm::StringRef type_name,
+                                         std::chrono::nanoseconds duration) {
+  TypeImportStats &stats = type_import_stats[type_name];
+  ++stats.m_count;
+  stats.m_duration += duration;
+}
 
 void ClangASTMetrics::DumpCounters(Log *log,
                                    ClangASTMetrics::Counters &counters) {
@@ -53,11 +64,58 @@ void ClangASTMetrics::DumpCounters(Log *log) {
   DumpCounters(log, global_counters);
   LLDB_LOGF(log, "-- Local metrics --");
   DumpCounters(log, local_counters);
+
+  if (type_import_stats.empty())
+    return;
+
+  std::vector<const llvm::StringMapEntry<TypeImportStats> *> slowest;
+  for (const auto &entry : type_import_stats)
+    slowest.push_back(&entry);
+  const size_t num_slowest = std::min<size_t>(slowest.size(), 10);
+  std::partial_sort(slowest.begin(), slowest.begin() + num_slowest,
+                    slowest.end(), [](const auto *lhs, const auto *rhs) {
+                      return lhs->second.m_duration > rhs->second.m_duration;
+                    });
+  LLDB_LOGF(log, "-- Slowest type imports --");
+  for (size_t i = 0; i < num_slowest; ++i)
+    LLDB_LOG(log, "  {0,10:f3} ms in {1,6} imports : {2}",
+             std::chrono::duration<double, std::milli>(
+                 slowest[i]->second.m_duration)
+                 .count(),
+             slowest[i]->second.m_count, slowest[i]->first());
 }
 
+namespace {
+/// Registers the time spent in its scope importing or completing a type with
+/// ClangASTMetrics. Nothing is measured unless the expression log is on, as
+/// only the log shows the metrics and naming the type is not free.
+class ScopedTypeImportTimer {
+public:
+  ScopedTypeImportTimer(llvm::function_ref<std::string()> get_name)
+      : m_get_name(get_name),
+        m_log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_EXPRESSIONS)) {
+    if (m_log)
+      m_start = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedTypeImportTimer() {
+    if (m_log)
+      ClangASTMetrics::RegisterTypeImport(
+          m_get_name(), std::chrono::steady_clock::now() - m_start);
+  }
+
+private:
+  llvm::function_ref<std::string()> m_get_name;
+  Log *m_log;
+  std::chrono::steady_clock::time_point m_start;
+};
+} // namespace
+
 clang::QualType ClangASTImporter::CopyType(clang::ASTContext *dst_ast,
                                            clang::ASTContext *src_ast,
                                            clang::QualType type) {
+  ScopedTypeImportTimer timer([&]() { return type.getAsString(); });
+
   ImporterDelegateSP delegate_sp(GetDelegate(dst_ast, src_ast));
 
   ASTImporterDelegate::CxxModuleScope std_scope(*delegate_sp, dst_ast);
@@ -560,6 +618,8 @@ void ClangASTImporter::CompleteDecl(clang::Decl *decl) {
 
 bool ClangASTImporter::CompleteTagDecl(clang::TagDecl *decl) {
   ClangASTMetrics::RegisterDeclCompletion();
+  ScopedTypeImportTimer timer(
+      [&]() { return decl->getQualifiedNameAsString(); });
 
   DeclOrigin decl_origin = GetDeclOrigin(decl);
 
@@ -637,6 +697,11 @@ bool ClangASTImporter::CompleteAndFetchChildren(clang::QualType type) {
   if (const TagType *tag_type = type->getAs<TagType>()) {
     TagDecl *tag_decl = tag_type->getDecl();
 
+    ASTContextMetadataSP context_md =
+        GetContextMetadata(&tag_decl->getASTContext());
+    if (context_md->m_fetched_children.count(tag_decl))
+      return true;
+
     DeclOrigin decl_origin = GetDeclOrigin(tag_decl);
 
     if (!decl_origin.Valid())
@@ -664,6 +729,7 @@ bool ClangASTImporter::CompleteAndFetchChildren(clang::QualType type) {
       record_decl->setHasLoadedFieldsFromExternalStorage(true);
     }
 
+    context_md->m_fetched_children.insert(tag_decl);
     return true;
   }
 
@@ -843,10 +909,12 @@ void ClangASTImporter::ForgetSource(clang::ASTContext *dst_ast,
 
   for (OriginMap::iterator iter = md->m_origins.begin();
        iter != md->m_origins.end();) {
-    if (iter->second.ctx == src_ast)
+    if (iter->second.ctx == src_ast) {
+      md->m_fetched_children.erase(iter->first);
       md->m_origins.erase(iter++);
-    else
+    } else {
       ++iter;
+    }
   }
 }
 
@@ -180,9 +180,16 @@ bool DWARFCallFrameInfo::GetAddressRange(Address addr, AddressRange &range) {
 
   if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
     return false;
-  GetFDEIndex();
-  FDEEntryMap::Entry *fde_entry =
-      m_fde_index.FindEntryThatContains(addr.GetFileAddress());
+
+  llvm::Optional<FDEEntryMap::Entry> fde_entry;
+  if (HasEHFrameHdr()) {
+    fde_entry = FindFDEEntryInEHFrameHdr(addr.GetFileAddress(), false);
+  } else {
+    GetFDEIndex();
+    if (const FDEEntryMap::Entry *entry =
+            m_fde_index.FindEntryThatContains(addr.GetFileAddress()))
+      fde_entry = *entry;
+  }
   if (!fde_entry)
     return false;
 
@@ -196,13 +203,24 @@ DWARFCallFrameInfo::GetFirstFDEEntryInRange(const AddressRange &range) {
   if (!m_section_sp || m_section_sp->IsEncrypted())
     return llvm::None;
 
+  addr_t start_file_addr = range.GetBaseAddress().GetFileAddress();
+  const FDEEntryMap::Range file_range(start_file_addr, range.GetByteSize());
+
+  // The binary search table of .eh_frame_hdr finds the FDE without
+  // decoding all of the others first.
+  if (HasEHFrameHdr()) {
+    llvm::Optional<FDEEntryMap::Entry> fde =
+        FindFDEEntryInEHFrameHdr(start_file_addr, true);
+    if (fde && fde->DoesIntersect(file_range))
+      return fde;
+    return llvm::None;
+  }
+
   GetFDEIndex();
 
-  addr_t start_file_addr = range.GetBaseAddress().GetFileAddress();
   const FDEEntryMap::Entry *fde =
       m_fde_index.FindEntryThatContainsOrFollows(start_file_addr);
-  if (fde && fde->DoesIntersect(
-                 FDEEntryMap::Range(start_file_addr, range.GetByteSize())))
+  if (fde && fde->DoesIntersect(file_range))
     return *fde;
 
   return llvm::None;
@@ -228,6 +246,7 @@ void DWARFCallFrameInfo::GetFunctionAddressAndSizeVector(
 
 const DWARFCallFrameInfo::CIE *
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset) {
+  std::lock_guard<std::mutex> guard(m_cie_map_mutex);
   cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
   if (pos != m_cie_map.end()) {
@@ -237,15 +256,31 @@ DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset) {
 
     return pos->second.get();
   }
-  return nullptr;
+
+  // FDEs found through the .eh_frame_hdr table refer to CIEs that the FDE
+  // index may not have seen yet.
+  if (m_type != EH || !HasEHFrameHdr())
+    return nullptr;
+  GetCFIData();
+  lldb::offset_t offset = cie_offset;
+  if (!m_cfi_data.ValidOffsetForDataOfSize(offset, 8))
+    return nullptr;
+  const uint32_t len = m_cfi_data.GetU32(&offset);
+  const uint64_t cie_id = len == UINT32_MAX ? m_cfi_data.GetU64(&offset)
+                                            : m_cfi_data.GetU32(&offset);
+  if (len == 0 || cie_id != 0)
+    return nullptr;
+  CIESP cie_sp = ParseCIE(cie_offset);
+  if (!cie_sp)
+    return nullptr;
+  return (m_cie_map[cie_offset] = std::move(cie_sp)).get();
 }
 
 DWARFCallFrameInfo::CIESP
 DWARFCallFrameInfo::ParseCIE(const dw_offset_t cie_offset) {
   CIESP cie_sp(new CIE(cie_offset));
   lldb::offset_t offset = cie_offset;
-  if (!m_cfi_data_initialized)
-    GetCFIData();
+  GetCFIData();
   uint32_t length = m_cfi_data.GetU32(&offset);
   dw_offset_t cie_id, end_offset;
   bool is_64bit = (length == UINT32_MAX);
@@ -395,13 +430,143 @@ DWARFCallFrameInfo::ParseCIE(const dw_offset_t cie_offset) {
 }
 
 void DWARFCallFrameInfo::GetCFIData() {
-  if (!m_cfi_data_initialized) {
+  llvm::call_once(m_cfi_data_once, [this]() {
     Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_UNWIND));
     if (log)
       m_objfile.GetModule()->LogMessage(log, "Reading EH frame info");
     m_objfile.ReadSectionData(m_section_sp.get(), m_cfi_data);
-    m_cfi_data_initialized = true;
+  });
+}
+
+void DWARFCallFrameInfo::GetEHFrameHdr() {
+  llvm::call_once(m_eh_frame_hdr_once, [this]() {
+    if (m_type != EH || !m_section_sp || m_section_sp->IsEncrypted())
+      return;
+
+    // The FDE index clears the zeroth bit of ARM addresses, which the table
+    // doesn't, so keep using the index there.
+    if (ArchSpec arch = m_objfile.GetArchitecture()) {
+      if (arch.GetTriple().getArch() == llvm::Triple::arm ||
+          arch.GetTriple().getArch() == llvm::Triple::thumb)
+        return;
+    }
+
+    SectionList *section_list = m_objfile.GetSectionList();
+    if (!section_list)
+      return;
+    SectionSP hdr_sp =
+        section_list->FindSectionByName(ConstString(".eh_frame_hdr"));
+    if (!hdr_sp || hdr_sp->IsEncrypted())
+      return;
+
+    DataExtractor data;
+    m_objfile.ReadSectionData(hdr_sp.get(), data);
+    lldb::offset_t offset = 0;
+    if (!data.ValidOffsetForDataOfSize(offset, 4))
+      return;
+    const uint8_t version = data.GetU8(&offset);
+    const uint8_t eh_frame_ptr_enc = data.GetU8(&offset);
+    const uint8_t fde_count_enc = data.GetU8(&offset);
+    const uint8_t table_enc = data.GetU8(&offset);
+    // Only tables with fixed size entries can be binary searched. This is
+    // the encoding that the linkers use.
+    if (version != 1 || fde_count_enc == DW_EH_PE_omit ||
+        table_enc != (DW_EH_PE_datarel | DW_EH_PE_sdata4))
+      return;
+
+    const lldb::addr_t hdr_addr = hdr_sp->GetFileAddress();
+    const lldb::addr_t eh_frame_addr =
+        GetGNUEHPointer(data, &offset, eh_frame_ptr_enc, hdr_addr,
+                        LLDB_INVALID_ADDRESS, hdr_addr);
+    if (eh_frame_addr != m_section_sp->GetFileAddress())
+      return;
+    const uint64_t fde_count =
+        GetGNUEHPointer(data, &offset, fde_count_enc, hdr_addr,
+                        LLDB_INVALID_ADDRESS, hdr_addr);
+    if (fde_count == 0 || fde_count > data.GetByteSize() / 8 ||
+        !data.ValidOffsetForDataOfSize(offset, fde_count * 8))
+      return;
+
+    m_eh_frame_hdr_data = data;
+    m_eh_frame_hdr_addr = hdr_addr;
+    m_eh_frame_hdr_table_offset = offset;
+    m_eh_frame_hdr_fde_count = fde_count;
+  });
+}
+
+llvm::Optional<DWARFCallFrameInfo::FDEEntryMap::Entry>
+DWARFCallFrameInfo::FindFDEEntryInEHFrameHdr(lldb::addr_t file_addr,
+                                             bool allow_following) {
+  if (!HasEHFrameHdr())
+    return llvm::None;
+
+  // Each table entry is a pair of signed 32 bit values.
+  auto get_table_value = [this](uint64_t index, uint32_t field) {
+    lldb::offset_t offset = m_eh_frame_hdr_table_offset + index * 8 + field;
+    return m_eh_frame_hdr_addr +
+           static_cast<int32_t>(m_eh_frame_hdr_data.GetU32(&offset));
+  };
+  auto get_fde_entry = [&](uint64_t index) {
+    const lldb::addr_t fde_addr = get_table_value(index, 4);
+    const lldb::addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+    if (fde_addr < eh_frame_addr)
+      return llvm::Optional<FDEEntryMap::Entry>();
+    return ParseFDEEntry(fde_addr - eh_frame_addr);
+  };
+
+  // Find the first entry whose initial location follows file_addr.
+  uint64_t low = 0, high = m_eh_frame_hdr_fde_count;
+  while (low < high) {
+    const uint64_t mid = low + (high - low) / 2;
+    if (get_table_value(mid, 0) <= file_addr)
+      low = mid + 1;
+    else
+      high = mid;
   }
+
+  if (low > 0) {
+    llvm::Optional<FDEEntryMap::Entry> entry = get_fde_entry(low - 1);
+    if (entry && entry->Contains(file_addr))
+      return entry;
+  }
+  if (allow_following && low < m_eh_frame_hdr_fde_count)
+    return get_fde_entry(low);
+  return llvm::None;
+}
+
+llvm::Optional<DWARFCallFrameInfo::FDEEntryMap::Entry>
+DWARFCallFrameInfo::ParseFDEEntry(dw_offset_t fde_offset) {
+  GetCFIData();
+
+  lldb::offset_t offset = fde_offset;
+  if (!m_cfi_data.ValidOffsetForDataOfSize(offset, 8))
+    return llvm::None;
+  dw_offset_t cie_id, cie_offset;
+  uint32_t len = m_cfi_data.GetU32(&offset);
+  if (len == UINT32_MAX) {
+    len = m_cfi_data.GetU64(&offset);
+    cie_id = m_cfi_data.GetU64(&offset);
+    cie_offset = fde_offset + 12 - cie_id;
+  } else {
+    cie_id = m_cfi_data.GetU32(&offset);
+    cie_offset = fde_offset + 4 - cie_id;
+  }
+  if (cie_id == 0 || len == 0)
+    return llvm::None;
+
+  const CIE *cie = GetCIE(cie_offset);
+  if (!cie)
+    return llvm::None;
+
+  const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
+  const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
+  const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
+  lldb::addr_t addr = GetGNUEHPointer(m_cfi_data, &offset, cie->ptr_encoding,
+                                      pc_rel_addr, text_addr, data_addr);
+  lldb::addr_t length = GetGNUEHPointer(
+      m_cfi_data, &offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING,
+      pc_rel_addr, text_addr, data_addr);
+  return FDEEntryMap::Entry(addr, length, fde_offset);
 }
 // Scan through the eh_frame or debug_frame section looking for FDEs and noting
 // the start/end addresses of the functions and a pointer back to the
@@ -431,8 +596,7 @@ void DWARFCallFrameInfo::GetFDEIndex() {
   }
 
   lldb::offset_t offset = 0;
-  if (!m_cfi_data_initialized)
-    GetCFIData();
+  GetCFIData();
   while (m_cfi_data.ValidOffsetForDataOfSize(offset, 8)) {
     const dw_offset_t current_entry = offset;
     dw_offset_t cie_id, next_entry, cie_offset;
@@ -474,7 +638,10 @@ void DWARFCallFrameInfo::GetFDEIndex() {
         return;
       }
 
-      m_cie_map[current_entry] = std::move(cie_sp);
+      {
+        std::lock_guard<std::mutex> cie_guard(m_cie_map_mutex);
+        m_cie_map.emplace(current_entry, std::move(cie_sp));
+      }
       offset = next_entry;
       continue;
     }
@@ -533,8 +700,7 @@ bool DWARFCallFrameInfo::FDEToUnwindPlan(dw_offset_t dwarf_offset,
   if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
     return false;
 
-  if (!m_cfi_data_initialized)
-    GetCFIData();
+  GetCFIData();
 
   uint32_t length = m_cfi_data.GetU32(&offset);
   dw_offset_t cie_offset;
@@ -15,6 +15,7 @@
 #include "lldb/Core/RichManglingContext.h"
 #include "lldb/Core/STLUtils.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
@@ -266,9 +267,42 @@ void Symtab::InitNameIndexes() {
     std::vector<std::pair<NameToIndexMap::Entry, const char *>> backlog;
     backlog.reserve(num_symbols / 2);
 
-    // Instantiation of the demangler is expensive, so better use a single one
-    // for all entries during batch processing.
-    RichManglingContext rmc;
+    // Demangling is the most expensive part of building the indexes and every
+    // symbol can be demangled on its own, so do that up front in parallel.
+    // The demangled names are cached in the symbols' Mangled objects.
+    std::vector<RichNameInfo> rich_infos(num_symbols);
+    const size_t batch_size = 1024;
+    const size_t num_batches = (num_symbols + batch_size - 1) / batch_size;
+    TaskMapOverInt(0, num_batches, [&](size_t batch) {
+      // Instantiation of the demangler is expensive, so better use a single
+      // one for all entries of a batch.
+      RichManglingContext rmc;
+      const size_t end = std::min(num_symbols, (batch + 1) * batch_size);
+      for (size_t value = batch * batch_size; value < end; ++value) {
+        Symbol &symbol = m_symbols[value];
+        if (symbol.IsTrampoline())
+          continue;
+
+        Mangled &mangled = symbol.GetMangled();
+        const SymbolType type = symbol.GetType();
+        if (mangled.GetMangledName() &&
+            (type == eSymbolTypeCode || type == eSymbolTypeResolver) &&
+            mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name)) {
+          // Only functions that have a base name get registered.
+          rmc.ParseFunctionBaseName();
+          llvm::StringRef base_name = rmc.GetBufferRef();
+          if (!base_name.empty()) {
+            RichNameInfo &info = rich_infos[value];
+            info.base_name = ConstString(base_name);
+            rmc.ParseFunctionDeclContextName();
+            info.decl_context = ConstString(rmc.GetBufferRef());
+            info.is_ctor_or_dtor = rmc.IsCtorOrDtor();
+          }
+        }
+        mangled.GetDemangledName(symbol.GetLanguage());
+      }
+    });
+
     for (uint32_t value = 0; value < num_symbols; ++value) {
       Symbol *symbol = &m_symbols[value];
 
@@ -293,11 +327,9 @@ void Symtab::InitNameIndexes() {
           m_name_to_index.Append(stripped, value);
         }
 
-        const SymbolType type = symbol->GetType();
-        if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
-          if (mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name))
-            RegisterMangledNameEntry(value, class_contexts, backlog, rmc);
-        }
+        if (rich_infos[value].base_name)
+          RegisterMangledNameEntry(value, rich_infos[value], class_contexts,
+                                   backlog);
       }
 
       // Symbol name strings that didn't match a Mangled::ManglingScheme, are
@@ -342,23 +374,14 @@ void Symtab::InitNameIndexes() {
 }
 
 void Symtab::RegisterMangledNameEntry(
-    uint32_t value, std::set<const char *> &class_contexts,
-    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-    RichManglingContext &rmc) {
-  // Only register functions that have a base name.
-  rmc.ParseFunctionBaseName();
-  llvm::StringRef base_name = rmc.GetBufferRef();
-  if (base_name.empty())
-    return;
-
+    uint32_t value, const RichNameInfo &info,
+    std::set<const char *> &class_contexts,
+    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog) {
   // The base name will be our entry's name.
-  NameToIndexMap::Entry entry(ConstString(base_name), value);
-
-  rmc.ParseFunctionDeclContextName();
-  llvm::StringRef decl_context = rmc.GetBufferRef();
+  NameToIndexMap::Entry entry(info.base_name, value);
 
   // Register functions with no context.
-  if (decl_context.empty()) {
+  if (info.decl_context.IsEmpty()) {
     // This has to be a basename
     m_basename_to_index.Append(entry);
     // If there is no context (no namespaces or class scopes that come before
@@ -367,14 +390,13 @@ void Symtab::RegisterMangledNameEntry(
     return;
   }
 
-  // Make sure we have a pool-string pointer and see if we already know the
-  // context name.
-  const char *decl_context_ccstr = ConstString(decl_context).GetCString();
+  // See if we already know the context name.
+  const char *decl_context_ccstr = info.decl_context.GetCString();
   auto it = class_contexts.find(decl_context_ccstr);
 
   // Register constructors and destructors. They are methods and create
   // declaration contexts.
-  if (rmc.IsCtorOrDtor()) {
+  if (info.is_ctor_or_dtor) {
     m_method_to_index.Append(entry);
     if (it == class_contexts.end())
       class_contexts.insert(it, decl_context_ccstr);
@@ -35,6 +35,8 @@ void MemoryCache::Clear(bool clear_invalid_ranges) {
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
   m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_L2_read_ahead_end = LLDB_INVALID_ADDRESS;
+  m_L2_read_ahead_lines = 1;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -224,17 +226,8 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
 
       if (bytes_left > 0) {
         assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
-            new DataBufferHeap(cache_line_byte_size, 0));
-        size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_up->GetBytes(),
-            data_buffer_heap_up->GetByteSize(), error);
-        if (process_bytes_read == 0)
+        if (FillL2Cache(curr_addr, error) == 0)
           return dst_len - bytes_left;
-
-        if (process_bytes_read != cache_line_byte_size)
-          data_buffer_heap_up->SetByteSize(process_bytes_read);
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_up.release());
         // We have read data and put it into the cache, continue through the
         // loop again to get the data out of the cache...
       }
@@ -244,6 +237,59 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   return dst_len - bytes_left;
 }
 
+// Every L2 cache miss costs a round trip to the process, which is expensive
+// for remote targets, and misses are often sequential: walking the stack or
+// reading a large structure a few bytes at a time. So the number of lines read
+// on a miss doubles for each miss that directly follows the lines read by the
+// previous one, up to this many lines.
+static const uint32_t g_max_L2_read_ahead_lines = 16;
+
+size_t MemoryCache::FillL2Cache(addr_t line_addr, Status &error) {
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+  uint32_t wanted_lines = 1;
+  if (line_addr == m_L2_read_ahead_end)
+    wanted_lines =
+        std::min(m_L2_read_ahead_lines * 2, g_max_L2_read_ahead_lines);
+
+  // Don't read ahead into lines that are already cached or known to be
+  // unreadable, or past the end of the address space.
+  uint32_t num_lines = 1;
+  while (num_lines < wanted_lines) {
+    const addr_t next_line_addr = line_addr + num_lines * cache_line_byte_size;
+    if (next_line_addr < line_addr || m_L2_cache.count(next_line_addr) ||
+        m_invalid_ranges.FindEntryThatContains(next_line_addr))
+      break;
+    ++num_lines;
+  }
+
+  DataBufferHeap data(num_lines * cache_line_byte_size, 0);
+  size_t bytes_read = m_process.ReadMemoryFromInferior(
+      line_addr, data.GetBytes(), data.GetByteSize(), error);
+  if (bytes_read == 0 && num_lines > 1) {
+    // The read ahead may have run into unreadable memory, so retry with only
+    // the line that is needed.
+    error.Clear();
+    num_lines = 1;
+    bytes_read = m_process.ReadMemoryFromInferior(line_addr, data.GetBytes(),
+                                                  cache_line_byte_size, error);
+  }
+  if (bytes_read == 0) {
+    m_L2_read_ahead_end = LLDB_INVALID_ADDRESS;
+    m_L2_read_ahead_lines = 1;
+    return 0;
+  }
+
+  for (size_t offset = 0; offset < bytes_read; offset += cache_line_byte_size) {
+    const size_t line_size =
+        std::min<size_t>(cache_line_byte_size, bytes_read - offset);
+    m_L2_cache[line_addr + offset] =
+        std::make_shared<DataBufferHeap>(data.GetBytes() + offset, line_size);
+  }
+  m_L2_read_ahead_end = line_addr + num_lines * cache_line_byte_size;
+  m_L2_read_ahead_lines = num_lines;
+  return bytes_read;
+}
+
 AllocatedBlock::AllocatedBlock(lldb::addr_t addr, uint32_t byte_size,
                                uint32_t permissions, uint32_t chunk_size)
     : m_range(addr, byte_size), m_permissions(permissions),
@@ -58,6 +58,8 @@
 #include "lldb/Utility/Timer.h"
 
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 #include <memory>
 #include <mutex>
@@ -2071,8 +2073,15 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
 
         // Preload symbols outside of any lock, so hopefully we can do this for
         // each library in parallel.
-        if (GetPreloadSymbols())
-          module_sp->PreloadSymbols();
+        if (GetPreloadSymbols()) {
+          std::unique_lock<std::mutex> lock(m_module_batch_mutex);
+          if (m_module_batch_depth > 0) {
+            m_modules_to_preload.push_back(module_sp);
+          } else {
+            lock.unlock();
+            module_sp->PreloadSymbols();
+          }
+        }
 
         if (old_module_sp && m_images.GetIndexForModule(old_module_sp.get()) !=
                                  LLDB_INVALID_INDEX32) {
@@ -2092,6 +2101,38 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
   return module_sp;
 }
 
+void Target::BeginModuleBatch() {
+  std::lock_guard<std::mutex> guard(m_module_batch_mutex);
+  ++m_module_batch_depth;
+}
+
+void Target::EndModuleBatch() {
+  std::vector<ModuleSP> modules;
+  {
+    std::lock_guard<std::mutex> guard(m_module_batch_mutex);
+    lldbassert(m_module_batch_depth > 0 && "Unbalanced EndModuleBatch()");
+    if (m_module_batch_depth == 0 || --m_module_batch_depth > 0)
+      return;
+    modules.swap(m_modules_to_preload);
+  }
+
+  if (modules.size() <= 1) {
+    for (const ModuleSP &module_sp : modules)
+      module_sp->PreloadSymbols();
+    return;
+  }
+
+  // Every module is preloaded on its own, so do them all in parallel. This
+  // uses dedicated threads rather than the TaskPool: indexing the symbols of
+  // a module runs tasks on the TaskPool and waits for them, which could
+  // deadlock if all of the TaskPool threads were busy preloading modules.
+  llvm::ThreadPool pool(
+      std::min<unsigned>(modules.size(), llvm::hardware_concurrency()));
+  for (const ModuleSP &module_sp : modules)
+    pool.async([module_sp]() { module_sp->PreloadSymbols(); });
+  pool.wait();
+}
+
 TargetSP Target::CalculateTarget() { return shared_from_this(); }
 
 ProcessSP Target::CalculateProcess() { return m_process_sp; }
@@ -3777,6 +3818,12 @@ bool TargetProperties::GetEnableNotifyAboutFixIts() const {
       nullptr, idx, g_target_properties[idx].default_uint_value != 0);
 }
 
+bool TargetProperties::GetEnableExprVariablePathFastPath() const {
+  const uint32_t idx = ePropertyExprVariablePathFastPath;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_target_properties[idx].default_uint_value != 0);
+}
+
 bool TargetProperties::GetEnableSaveObjects() const {
   const uint32_t idx = ePropertySaveObjects;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
@@ -24,6 +24,7 @@
 
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/LEB128.h"
 #include "llvm/Support/MD5.h"
 #include "llvm/Support/MathExtras.h"
 
@@ -881,8 +882,17 @@ uint64_t DataExtractor::GetULEB128(offset_t *offset_ptr) const {
 
   const uint8_t *end = m_end;
 
+  // Well-formed values are usually decoded a word at a time. Truncated and
+  // oversized values take the lenient path below.
+  uint64_t result;
+  if (const uint8_t *value_end =
+          llvm::decodeULEB128Array(src, end, &result, 1)) {
+    *offset_ptr = value_end - m_start;
+    return result;
+  }
+
   if (src < end) {
-    uint64_t result = *src++;
+    result = *src++;
     if (result >= 0x80) {
       result &= 0x7f;
       int shift = 7;
@@ -106,6 +106,12 @@ static struct option g_long_options[] = {
     {"setsid", no_argument, nullptr,
      'S'}, // Call setsid() to make llgs run in its own session.
     {"fd", required_argument, nullptr, 'F'},
+    {"expedited-registers", required_argument, nullptr,
+     'E'}, // Registers to send for each thread in jThreadsInfo replies:
+           // "generic" (pc, sp, fp and ra) or "gpr" (the first register set).
+    {"expedited-stack-frames", required_argument, nullptr,
+     'M'}, // Number of frame pointer backchain records to send as stack
+           // memory for each thread in jThreadsInfo replies.
     {nullptr, 0, nullptr, 0}};
 
 // Watch for signals
@@ -132,6 +138,8 @@ static void display_usage(const char *progname, const char *subcommand) {
                   "[--fd file-descriptor]"
                   "[--named-pipe named-pipe-path] "
                   "[--native-regs] "
+                  "[--expedited-registers generic|gpr] "
+                  "[--expedited-stack-frames count] "
                   "[--attach pid] "
                   "[[HOST]:PORT] "
                   "[-- PROGRAM ARG1 ARG2 ...]\n",
@@ -380,6 +388,8 @@ int main_gdbserver(int argc, char *argv[]) {
   lldb::pipe_t unnamed_pipe = LLDB_INVALID_PIPE;
   bool reverse_connect = false;
   int connection_fd = -1;
+  bool expedite_full_register_set = false;
+  uint32_t expedited_stack_frame_limit = 0;
 
   // ProcessLaunchInfo launch_info;
   ProcessAttachInfo attach_info;
@@ -433,6 +443,27 @@ int main_gdbserver(int argc, char *argv[]) {
       connection_fd = StringConvert::ToUInt32(optarg, -1);
       break;
 
+    case 'E':
+      if (optarg && StringRef(optarg) == "gpr")
+        expedite_full_register_set = true;
+      else if (optarg && StringRef(optarg) == "generic")
+        expedite_full_register_set = false;
+      else {
+        fprintf(stderr, "error: invalid expedited register set '%s'\n",
+                optarg ? optarg : "");
+        option_error = 1;
+      }
+      break;
+
+    case 'M':
+      if (!optarg ||
+          StringRef(optarg).getAsInteger(0, expedited_stack_frame_limit)) {
+        fprintf(stderr, "error: invalid expedited stack frame count '%s'\n",
+                optarg ? optarg : "");
+        option_error = 1;
+      }
+      break;
+
 #ifndef _WIN32
     case 'S':
       // Put llgs into a new session. Terminals group processes
@@ -500,6 +531,8 @@ int main_gdbserver(int argc, char *argv[]) {
 
   NativeProcessFactory factory;
   GDBRemoteCommunicationServerLLGS gdb_server(mainloop, factory);
+  gdb_server.SetExpeditedThreadsInfo(expedite_full_register_set,
+                                     expedited_stack_frame_limit);
 
   const char *const host_and_port = argv[0];
   argc -= 1;
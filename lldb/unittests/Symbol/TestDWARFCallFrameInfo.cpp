@@ -48,7 +48,8 @@ public:
   }
 
 protected:
-  void TestBasic(DWARFCallFrameInfo::Type type, llvm::StringRef symbol);
+  void TestBasic(DWARFCallFrameInfo::Type type, llvm::StringRef symbol,
+                 llvm::StringRef extra_sections = "");
 };
 
 namespace lldb_private {
@@ -86,8 +87,9 @@ static UnwindPlan::Row GetExpectedRow2() {
 }
 
 void DWARFCallFrameInfoTest::TestBasic(DWARFCallFrameInfo::Type type,
-                                       llvm::StringRef symbol) {
-  auto ExpectedFile = TestFile::fromYaml(R"(
+                                       llvm::StringRef symbol,
+                                       llvm::StringRef extra_sections) {
+  std::string yaml = R"(
 --- !ELF
 FileHeader:
   Class:           ELFCLASS64
@@ -228,7 +230,9 @@ Symbols:
     Size:            0x000000000000000C
     Binding:         STB_GLOBAL
 ...
-)");
+)";
+  yaml.insert(yaml.find("Symbols:"), extra_sections.str());
+  auto ExpectedFile = TestFile::fromYaml(yaml);
   ASSERT_THAT_EXPECTED(ExpectedFile, llvm::Succeeded());
 
   auto module_sp =
@@ -254,6 +258,12 @@ Symbols:
   EXPECT_EQ(GetExpectedRow0(), *plan.GetRowAtIndex(0));
   EXPECT_EQ(GetExpectedRow1(), *plan.GetRowAtIndex(1));
   EXPECT_EQ(GetExpectedRow2(), *plan.GetRowAtIndex(2));
+
+  AddressRange range;
+  ASSERT_TRUE(cfi.GetAddressRange(sym->GetAddress(), range));
+  EXPECT_EQ(sym->GetAddress().GetFileAddress(),
+            range.GetBaseAddress().GetFileAddress());
+  EXPECT_EQ(0x0Cu, range.GetByteSize());
 }
 
 TEST_F(DWARFCallFrameInfoTest, Basic_dwarf3) {
@@ -267,3 +277,19 @@ TEST_F(DWARFCallFrameInfoTest, Basic_dwarf4) {
 TEST_F(DWARFCallFrameInfoTest, Basic_eh) {
   TestBasic(DWARFCallFrameInfo::EH, "eh_frame");
 }
+
+TEST_F(DWARFCallFrameInfoTest, Basic_eh_frame_hdr) {
+  TestBasic(DWARFCallFrameInfo::EH, "eh_frame", R"(
+  - Name:            .eh_frame_hdr
+    Type:            SHT_PROGBITS
+    Flags:           [ SHF_ALLOC ]
+    Address:         0x00000000000002C8
+    AddressAlign:    0x0000000000000004
+    Content:         011B033BC4FFFFFF0100000098FFFFFFE0FFFFFF
+# version 1, eh_frame_ptr_enc pcrel|sdata4, fde_count_enc udata4,
+# table_enc datarel|sdata4
+# eh_frame_ptr: 0x290
+# fde_count: 1
+# table: [0x260 => FDE at 0x2a8]
+)");
+}
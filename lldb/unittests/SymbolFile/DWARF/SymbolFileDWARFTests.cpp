@@ -11,6 +11,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolData.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolExe.h"
+#include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 
@@ -18,6 +19,7 @@
 #include "Plugins/SymbolFile/DWARF/DWARFAbbreviationDeclaration.h"
 #include "Plugins/SymbolFile/DWARF/DWARFDataExtractor.h"
 #include "Plugins/SymbolFile/DWARF/DWARFDebugAbbrev.h"
+#include "Plugins/SymbolFile/DWARF/NameToDIE.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
 #include "Plugins/SymbolFile/PDB/SymbolFilePDB.h"
 #include "TestingSupport/TestUtilities.h"
@@ -326,3 +328,48 @@ TEST_F(SymbolFileDWARFTests, TestAbbrevMissingTerminator) {
   EXPECT_EQ("abbreviation declaration attribute list not terminated with a "
             "null entry", llvm::toString(std::move(error)));
 }
+
+TEST_F(SymbolFileDWARFTests, TestNameToDIEEncodeDecode) {
+  NameToDIE map;
+  map.Insert(ConstString("main"), DIERef(llvm::None, DIERef::DebugInfo, 0x10));
+  map.Insert(ConstString("foo"), DIERef(3, DIERef::DebugTypes, 0x20));
+  map.Insert(ConstString("foo"), DIERef(llvm::None, DIERef::DebugInfo, 0x30));
+  map.Finalize();
+
+  std::string encoded;
+  llvm::raw_string_ostream os(encoded);
+  map.Encode(os);
+  os.flush();
+
+  NameToDIE decoded;
+  llvm::DataExtractor data(encoded, /*IsLittleEndian=*/true,
+                           /*AddressSize=*/8);
+  uint64_t offset = 0;
+  ASSERT_TRUE(decoded.Decode(data, &offset));
+  EXPECT_EQ(encoded.size(), offset);
+
+  DIEArray dies;
+  ASSERT_EQ(1u, decoded.Find(ConstString("main"), dies));
+  EXPECT_EQ(llvm::None, dies[0].dwo_num());
+  EXPECT_EQ(DIERef::DebugInfo, dies[0].section());
+  EXPECT_EQ(0x10u, dies[0].die_offset());
+
+  dies.clear();
+  ASSERT_EQ(2u, decoded.Find(ConstString("foo"), dies));
+  llvm::sort(dies, [](const DIERef &lhs, const DIERef &rhs) {
+    return lhs.die_offset() < rhs.die_offset();
+  });
+  EXPECT_EQ(llvm::Optional<uint32_t>(3), dies[0].dwo_num());
+  EXPECT_EQ(DIERef::DebugTypes, dies[0].section());
+  EXPECT_EQ(0x20u, dies[0].die_offset());
+  EXPECT_EQ(llvm::None, dies[1].dwo_num());
+  EXPECT_EQ(0x30u, dies[1].die_offset());
+
+  // Truncated data is rejected.
+  NameToDIE truncated;
+  llvm::DataExtractor truncated_data(llvm::StringRef(encoded).drop_back(),
+                                     /*IsLittleEndian=*/true,
+                                     /*AddressSize=*/8);
+  offset = 0;
+  EXPECT_FALSE(truncated.Decode(truncated_data, &offset));
+}
@@ -0,0 +1,101 @@
+//===- ConcurrentStringMap.cpp - Concurrent string interning --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Interns a list of strings with many duplicates from several threads, once
+// with ConcurrentStringMap and once with DenseMaps sharded by hash and guarded
+// by one mutex per shard.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/CachedHashString.h"
+#include "llvm/ADT/ConcurrentStringMap.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/StringSaver.h"
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+static const std::vector<std::string> &getStrings() {
+  static const std::vector<std::string> Strings = [] {
+    // One million strings, a quarter of them distinct.
+    std::vector<std::string> Strings;
+    for (unsigned I = 0; I != 1 << 20; ++I)
+      Strings.push_back("_ZN4llvm5symbol" +
+                        std::to_string((I * 2654435761U) % (1 << 18)));
+    return Strings;
+  }();
+  return Strings;
+}
+
+// Runs Fn(String) for every string, split across NumThreads threads.
+template <typename FnTy> static void runThreads(unsigned NumThreads, FnTy Fn) {
+  const std::vector<std::string> &Strings = getStrings();
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      for (size_t I = T; I < Strings.size(); I += NumThreads)
+        Fn(Strings[I]);
+    });
+  for (std::thread &T : Threads)
+    T.join();
+}
+
+static void BM_ConcurrentStringMap(benchmark::State &State) {
+  getStrings();
+  for (auto _ : State) {
+    ConcurrentStringMap<unsigned> Map;
+    runThreads(State.range(0), [&](StringRef S) { Map.try_emplace(S, 0); });
+    benchmark::DoNotOptimize(Map.size());
+  }
+  State.SetItemsProcessed(State.iterations() * getStrings().size());
+}
+BENCHMARK(BM_ConcurrentStringMap)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+namespace {
+struct Shard {
+  std::mutex Mutex;
+  DenseMap<CachedHashStringRef, unsigned> Map;
+  BumpPtrAllocator Alloc;
+};
+} // namespace
+
+static void BM_ShardedDenseMap(benchmark::State &State) {
+  getStrings();
+  const unsigned NumShards = 64;
+  for (auto _ : State) {
+    std::vector<Shard> Shards(NumShards);
+    runThreads(State.range(0), [&](StringRef S) {
+      CachedHashStringRef Key(S);
+      Shard &Sh = Shards[Key.hash() % NumShards];
+      std::lock_guard<std::mutex> Lock(Sh.Mutex);
+      // Intern the key like ConcurrentStringMap does.
+      if (Sh.Map.find(Key) == Sh.Map.end())
+        Sh.Map.try_emplace(
+            CachedHashStringRef(StringSaver(Sh.Alloc).save(S), Key.hash()), 0);
+    });
+    benchmark::DoNotOptimize(Shards.data());
+  }
+  State.SetItemsProcessed(State.iterations() * getStrings().size());
+}
+BENCHMARK(BM_ShardedDenseMap)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
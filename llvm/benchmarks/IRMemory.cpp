@@ -0,0 +1,117 @@
+//===- IRMemory.cpp - Memory footprint of in-memory IR --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures how many bytes of heap a parsed module keeps alive per instruction.
+// The corpus is generated, so the numbers are stable across runs and hosts
+// with the same pointer size, and a change in the layout of Value, User, Use or
+// the instruction classes shows up directly in the BytesPerInst counter.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace llvm;
+
+// Every allocation is prefixed with its size so that the number of live bytes
+// can be tracked without relying on the allocator.
+static std::atomic<size_t> LiveBytes(0);
+
+namespace {
+union alignas(alignof(std::max_align_t)) AllocHeader {
+  size_t Size;
+  std::max_align_t Align;
+};
+} // namespace
+
+void *operator new(size_t Size) {
+  auto *H = static_cast<AllocHeader *>(std::malloc(sizeof(AllocHeader) + Size));
+  if (!H)
+    throw std::bad_alloc();
+  H->Size = Size;
+  LiveBytes += Size;
+  return H + 1;
+}
+
+void operator delete(void *P) noexcept {
+  if (!P)
+    return;
+  auto *H = static_cast<AllocHeader *>(P) - 1;
+  LiveBytes -= H->Size;
+  std::free(H);
+}
+
+void *operator new[](size_t Size) { return operator new(Size); }
+void operator delete[](void *P) noexcept { operator delete(P); }
+void operator delete(void *P, size_t) noexcept { operator delete(P); }
+void operator delete[](void *P, size_t) noexcept { operator delete(P); }
+
+// Builds a module with a mix of instructions similar to optimized code: address
+// arithmetic, loads and stores, integer arithmetic, compares, calls, branches
+// and phis.
+static std::string buildCorpus(unsigned NumFunctions) {
+  std::string Corpus;
+  raw_string_ostream OS(Corpus);
+  OS << "declare i32 @ext(i32*, i32)\n";
+  for (unsigned F = 0; F != NumFunctions; ++F) {
+    OS << "define i32 @f" << F << "(i32* %p, i32 %n) {\n"
+       << "entry:\n"
+       << "  br label %loop\n"
+       << "loop:\n"
+       << "  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]\n"
+       << "  %acc = phi i32 [ 0, %entry ], [ %acc.next, %loop ]\n"
+       << "  %idx = sext i32 %i to i64\n"
+       << "  %gep = getelementptr inbounds i32, i32* %p, i64 %idx\n"
+       << "  %v = load i32, i32* %gep, align 4\n"
+       << "  %mul = mul nsw i32 %v, " << F + 3 << "\n"
+       << "  %add = add nsw i32 %mul, %acc\n"
+       << "  %c = call i32 @ext(i32* %gep, i32 %add)\n"
+       << "  %xor = xor i32 %c, %i\n"
+       << "  store i32 %xor, i32* %gep, align 4\n"
+       << "  %acc.next = add i32 %add, %xor\n"
+       << "  %i.next = add nuw nsw i32 %i, 1\n"
+       << "  %cmp = icmp slt i32 %i.next, %n\n"
+       << "  br i1 %cmp, label %loop, label %exit\n"
+       << "exit:\n"
+       << "  %sel = select i1 %cmp, i32 %acc.next, i32 0\n"
+       << "  ret i32 %sel\n"
+       << "}\n";
+  }
+  return OS.str();
+}
+
+static void BM_IRBytesPerInstruction(benchmark::State &State) {
+  std::string Corpus = buildCorpus(State.range(0));
+  size_t Bytes = 0, Insts = 0;
+  for (auto _ : State) {
+    size_t Before = LiveBytes;
+    auto Context = std::make_unique<LLVMContext>();
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(Corpus, Err, *Context);
+    if (!M) {
+      State.SkipWithError("failed to parse the corpus");
+      break;
+    }
+    Bytes = LiveBytes - Before;
+    Insts = M->getInstructionCount();
+    M.reset();
+    Context.reset();
+  }
+  if (Insts)
+    State.counters["BytesPerInst"] = double(Bytes) / Insts;
+}
+BENCHMARK(BM_IRBytesPerInstruction)->Arg(1 << 10)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,79 @@
+//===- ItaniumDemangle.cpp - Bulk demangling throughput -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Demangle/Demangle.h"
+
+#include <cstdlib>
+
+using namespace llvm;
+
+// Symbols taken from libc++, libstdc++ and LLVM itself, the kind of names nm,
+// symbolizers and debuggers demangle by the million.
+static const char *const Symbols[] = {
+    "_ZNSt3__112basic_stringIcNS_11char_traitsIcEENS_9allocatorIcEEE6appendEPK"
+    "cm",
+    "_ZNSt3__16vectorIiNS_9allocatorIiEEE21__push_back_slow_pathIRKiEEvOT_",
+    "_ZNKSt3__16locale9use_facetERNS0_2idE",
+    "_ZNSt3__113basic_filebufIcNS_11char_traitsIcEEE4openEPKcj",
+    "_ZNSt3__112__hash_tableINS_17__hash_value_typeINS_12basic_stringIcNS_11ch"
+    "ar_traitsIcEENS_9allocatorIcEEEEiEENS_22__unordered_map_hasherIS7_S8_NS_"
+    "4hashIS7_EELb1EEENS_21__unordered_map_equalIS7_S8_NS_8equal_toIS7_EELb1E"
+    "EENS5_IS8_EEE6rehashEm",
+    "_ZNSt3__110shared_ptrIN4llvm6ModuleEE11make_sharedIJRNS1_11LLVMContextEEE"
+    "ES3_DpOT_",
+    "_ZN4llvm12DenseMapBaseINS_8DenseMapIPKNS_5ValueEjNS_12DenseMapInfoIS4_EEN"
+    "S_6detail12DenseMapPairIS4_jEEEES4_jS6_S9_E16FindAndConstructERKS4_",
+    "_ZNK4llvm12FunctionPass17createPrinterPassERNS_11raw_ostreamERKNSt3__112b"
+    "asic_stringIcNS3_11char_traitsIcEENS3_9allocatorIcEEEE",
+    "_ZZN5clang4Sema22CheckCompletedCXXClassEPNS_13CXXRecordDeclEENK3$_0clEPNS"
+    "_13CXXMethodDeclE",
+    "_ZNSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEE7replaceEN9__gnu_cxx"
+    "17__normal_iteratorIPcS4_EES8_RKS4_",
+    "_ZNKSt8time_getIwSt19istreambuf_iteratorIwSt11char_traitsIwEEE15_M_extrac"
+    "t_nameES3_S3_RiPPKwmRSt8ios_baseRSt12_Ios_Iostate",
+    "_ZNSt10filesystem9copy_fileERKNS_4pathES2_NS_12copy_optionsERSt10error_co"
+    "de",
+    "_ZTv0_n24_NSt7__cxx1119basic_ostringstreamIcSt11char_traitsIcESaIcEED0Ev",
+    "_ZNSt6thread15_M_start_threadESt10shared_ptrINS_10_Impl_baseEEPFvvE",
+    "_ZN9__gnu_cxx18stdio_sync_filebufIwSt11char_traitsIwEEC2EP8_IO_FILE",
+    "_ZNSt10moneypunctIwLb0EEC2EPSt18__moneypunct_cacheIwLb0EEm",
+};
+
+// A fresh demangler and output buffer for every symbol.
+static void BM_ItaniumDemangle(benchmark::State &State) {
+  for (auto _ : State) {
+    for (const char *Symbol : Symbols) {
+      char *Demangled = itaniumDemangle(Symbol, nullptr, nullptr, nullptr);
+      benchmark::DoNotOptimize(Demangled);
+      std::free(Demangled);
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * array_lengthof(Symbols));
+}
+BENCHMARK(BM_ItaniumDemangle);
+
+// One demangler and output buffer for all symbols.
+static void BM_ItaniumPartialDemanglerReused(benchmark::State &State) {
+  ItaniumPartialDemangler Demangler;
+  char *Buf = nullptr;
+  size_t N = 0;
+  for (auto _ : State) {
+    for (const char *Symbol : Symbols) {
+      Demangler.partialDemangle(Symbol);
+      Buf = Demangler.finishDemangle(Buf, &N);
+      benchmark::DoNotOptimize(Buf);
+    }
+  }
+  std::free(Buf);
+  State.SetItemsProcessed(State.iterations() * array_lengthof(Symbols));
+}
+BENCHMARK(BM_ItaniumPartialDemanglerReused);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,120 @@
+//===- RegexMatch.cpp - Regex and SpecialCaseList matching ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/Support/SpecialCaseList.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+// Lines of IR-like text, as seen by FileCheck.
+static const std::vector<std::string> &getLines() {
+  static const std::vector<std::string> Lines = [] {
+    std::vector<std::string> Lines;
+    for (unsigned I = 0; I < 4096; ++I)
+      Lines.push_back("  %v" + std::to_string(I) + " = add i32 %a" +
+                      std::to_string(I % 97) + ", " + std::to_string(I) +
+                      " ; foo bar baz");
+    return Lines;
+  }();
+  return Lines;
+}
+
+// Mangled-looking function names, as seen by sanitizer special case lists.
+static const std::vector<std::string> &getNames() {
+  static const std::vector<std::string> Names = [] {
+    std::vector<std::string> Names;
+    for (unsigned I = 0; I < 4096; ++I)
+      Names.push_back("_ZN4llvm" + std::to_string(I % 37) + "detail" +
+                      std::to_string(I) + "E");
+    return Names;
+  }();
+  return Names;
+}
+
+static void matchLines(benchmark::State &State, StringRef Pattern,
+                       bool WithGroups) {
+  const Regex R(Pattern, Regex::Newline);
+  SmallVector<StringRef, 4> Matches;
+  for (auto _ : State)
+    for (const std::string &Line : getLines())
+      benchmark::DoNotOptimize(R.match(Line, WithGroups ? &Matches : nullptr));
+  State.SetItemsProcessed(State.iterations() * getLines().size());
+}
+
+static void BM_RegexMatch(benchmark::State &State) {
+  matchLines(State, "add i32 %a[0-9]+, 4095", /*WithGroups=*/false);
+}
+BENCHMARK(BM_RegexMatch);
+
+static void BM_RegexMatchGroups(benchmark::State &State) {
+  matchLines(State, "%(v[0-9]+) = add i32 (%a[0-9]+), ([0-9]+)",
+             /*WithGroups=*/true);
+}
+BENCHMARK(BM_RegexMatchGroups);
+
+static void BM_RegexMatchAnchored(benchmark::State &State) {
+  matchLines(State, "^ *%v[0-9]+ = add i32 %a[0-9]+, [0-9]+ ; foo bar baz *$",
+             /*WithGroups=*/false);
+}
+BENCHMARK(BM_RegexMatchAnchored);
+
+// A special case list of State.range(0) rules, of which one in eight has
+// metacharacters other than '*'. None of them match the queried names.
+static void BM_SpecialCaseList(benchmark::State &State) {
+  std::string List;
+  for (int64_t I = 0; I < State.range(0); ++I) {
+    std::string N = std::to_string(I);
+    switch (I % 8) {
+    case 0:
+      List += "fun:_ZN5clang" + N + "*\n";
+      break;
+    case 1:
+      List += "fun:*Sema" + N + "*\n";
+      break;
+    case 2:
+      List += "fun:*" + N + "Parser*Action\n";
+      break;
+    case 3:
+      List += "fun:_ZN5clang*detail" + N + "E\n";
+      break;
+    case 4:
+      List += "src:*/lib/Foo" + N + ".cpp\n";
+      break;
+    case 5:
+      List += "fun:_ZN5clang*Lexer" + N + "*\n";
+      break;
+    case 6:
+      List += "global:*g_" + N + "*\n";
+      break;
+    default:
+      List += "fun:_ZN[0-9]+clang" + N + "[a-z]+E\n";
+      break;
+    }
+  }
+  std::unique_ptr<MemoryBuffer> MB = MemoryBuffer::getMemBuffer(List);
+  std::string Error;
+  std::unique_ptr<SpecialCaseList> SCL =
+      SpecialCaseList::create(MB.get(), Error);
+  if (!SCL) {
+    State.SkipWithError(Error.c_str());
+    return;
+  }
+  for (auto _ : State)
+    for (const std::string &Name : getNames())
+      benchmark::DoNotOptimize(SCL->inSection("", "fun", Name));
+  State.SetItemsProcessed(State.iterations() * getNames().size());
+}
+BENCHMARK(BM_SpecialCaseList)->Arg(16)->Arg(128)->Arg(512);
+
+BENCHMARK_MAIN();
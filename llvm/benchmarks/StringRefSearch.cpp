@@ -0,0 +1,104 @@
+//===- StringRefSearch.cpp - StringRef and line_iterator searching --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+using namespace llvm;
+
+// Source-like text: lines of identifiers and punctuation of varying length.
+static std::string buildText(size_t Size) {
+  static const char *const Words[] = {"define", "i32",    "%x",   "=",
+                                      "load",   "align",  "4",    "{",
+                                      "}",      "return", "call", "@foo",
+                                      "(",      ")",      ",",    "; comment"};
+  std::string Text;
+  Text.reserve(Size + 16);
+  for (unsigned I = 0; Text.size() < Size; ++I) {
+    Text += Words[(I * 7 + I / 5) % 16];
+    Text += (I % 9 == 8) ? '\n' : ' ';
+  }
+  return Text;
+}
+
+static const std::string &getText() {
+  static const std::string Text = buildText(1 << 20);
+  return Text;
+}
+
+static void BM_FindChar(benchmark::State &State) {
+  StringRef Text = getText();
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Text.find('~'));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_FindChar);
+
+static void BM_FindString(benchmark::State &State) {
+  StringRef Text = getText();
+  // Common first character, never matched.
+  std::string Needle = std::string(State.range(0) - 1, 'a') + '~';
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Text.find(Needle));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_FindString)->Arg(2)->Arg(4)->Arg(13);
+
+static void BM_FindFirstOf(benchmark::State &State) {
+  StringRef Text = getText();
+  StringRef Chars = StringRef("~^|").take_front(State.range(0));
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Text.find_first_of(Chars));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_FindFirstOf)->Arg(1)->Arg(3);
+
+static void BM_CountChar(benchmark::State &State) {
+  StringRef Text = getText();
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Text.count('\n'));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_CountChar);
+
+static void BM_CountString(benchmark::State &State) {
+  StringRef Text = getText();
+  for (auto _ : State)
+    benchmark::DoNotOptimize(Text.count("load"));
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_CountString);
+
+static void BM_SplitLines(benchmark::State &State) {
+  StringRef Text = getText();
+  SmallVector<StringRef, 0> Lines;
+  for (auto _ : State) {
+    Lines.clear();
+    Text.split(Lines, '\n');
+    benchmark::DoNotOptimize(Lines.data());
+  }
+  State.SetBytesProcessed(State.iterations() * Text.size());
+}
+BENCHMARK(BM_SplitLines);
+
+static void BM_LineIterator(benchmark::State &State) {
+  std::unique_ptr<MemoryBuffer> Buffer = MemoryBuffer::getMemBuffer(getText());
+  for (auto _ : State) {
+    size_t Length = 0;
+    for (line_iterator I(*Buffer, /*SkipBlanks=*/true, ';'), E; I != E; ++I)
+      Length += I->size();
+    benchmark::DoNotOptimize(Length);
+  }
+  State.SetBytesProcessed(State.iterations() * Buffer->getBufferSize());
+}
+BENCHMARK(BM_LineIterator);
+
+BENCHMARK_MAIN();
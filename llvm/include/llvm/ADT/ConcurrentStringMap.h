@@ -0,0 +1,262 @@
+//===- ConcurrentStringMap.h - Lock-free string hash map --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the ConcurrentStringMap class.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_CONCURRENTSTRINGMAP_H
+#define LLVM_ADT_CONCURRENTSTRINGMAP_H
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/iterator.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/ThreadSafeAllocator.h"
+#include "llvm/Support/xxhash.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace llvm {
+
+/// ConcurrentStringMap - An insert-only hash map from strings to values that
+/// may be used from several threads at once. Like StringMap it copies the keys
+/// into the entries, so it is suitable for interning strings.
+///
+/// Insertions and lookups take no lock. The table uses open addressing with
+/// quadratic probing, and a bucket never changes again once it holds an entry.
+/// When the table gets too full, the thread that noticed moves the entries to
+/// a table twice the size while holding a lock. Other threads inserting into
+/// the old table in the meantime wait for it and then retry; lookups carry on.
+///
+/// Entries are never moved or freed before the map is destroyed, so pointers to
+/// them stay valid. Iteration must not overlap with insertions.
+template <typename ValueTy, typename AllocatorTy = ThreadSafeBumpPtrAllocator>
+class ConcurrentStringMap {
+public:
+  using MapEntryTy = StringMapEntry<ValueTy>;
+
+private:
+  /// Set in every bucket of a table being replaced, so that no thread can
+  /// insert into it any more.
+  enum : uintptr_t { MovedBit = 1 };
+
+  struct Table {
+    Table(unsigned NumBuckets, Table *Prev)
+        : NumBuckets(NumBuckets),
+          Buckets(new std::atomic<uintptr_t>[NumBuckets]()),
+          Hashes(new std::atomic<uint32_t>[NumBuckets]()), Prev(Prev) {}
+
+    unsigned NumBuckets;
+    /// The MapEntryTy pointers, possibly with MovedBit set.
+    std::unique_ptr<std::atomic<uintptr_t>[]> Buckets;
+    /// The hash of the key in each bucket, or zero if it was not stored yet.
+    /// This only saves key comparisons.
+    std::unique_ptr<std::atomic<uint32_t>[]> Hashes;
+    /// The table this one replaced. Other threads may still be probing it.
+    std::unique_ptr<Table> Prev;
+  };
+
+  std::atomic<Table *> Current;
+  std::atomic<size_t> NumItems;
+  std::mutex GrowMutex;
+  AllocatorTy Allocator;
+
+  static uint32_t hashKey(StringRef Key) {
+    // Zero marks a hash that is not known yet.
+    uint32_t Hash = static_cast<uint32_t>(xxHash64(Key));
+    return Hash ? Hash : 1;
+  }
+
+  static bool isMatch(const MapEntryTy *Entry, uint32_t EntryHash,
+                      uint32_t Hash, StringRef Key) {
+    return (EntryHash == 0 || EntryHash == Hash) && Entry->getKey() == Key;
+  }
+
+  /// Replace \p T by a table twice the size, unless another thread already
+  /// did. Returns once \p T is not the current table any more.
+  void grow(Table *T) {
+    std::lock_guard<std::mutex> Lock(GrowMutex);
+    if (Current.load(std::memory_order_relaxed) != T)
+      return;
+
+    Table *NewTable = new Table(T->NumBuckets * 2, T);
+    unsigned Mask = NewTable->NumBuckets - 1;
+    for (unsigned I = 0; I != T->NumBuckets; ++I) {
+      uintptr_t Value =
+          T->Buckets[I].fetch_or(MovedBit, std::memory_order_acq_rel);
+      if (!Value)
+        continue;
+      uint32_t Hash = T->Hashes[I].load(std::memory_order_relaxed);
+      if (!Hash)
+        Hash = hashKey(reinterpret_cast<MapEntryTy *>(Value)->getKey());
+      unsigned BucketNo = Hash & Mask;
+      for (unsigned ProbeAmt = 1;
+           NewTable->Buckets[BucketNo].load(std::memory_order_relaxed);
+           ++ProbeAmt)
+        BucketNo = (BucketNo + ProbeAmt) & Mask;
+      NewTable->Buckets[BucketNo].store(Value, std::memory_order_relaxed);
+      NewTable->Hashes[BucketNo].store(Hash, std::memory_order_relaxed);
+    }
+    Current.store(NewTable, std::memory_order_release);
+  }
+
+public:
+  /// Create a map that holds \p InitialSize entries without growing.
+  explicit ConcurrentStringMap(unsigned InitialSize = 0) : NumItems(0) {
+    unsigned NumBuckets =
+        std::max(16u, unsigned(NextPowerOf2(InitialSize * uint64_t(4) / 3)));
+    Current.store(new Table(NumBuckets, nullptr), std::memory_order_relaxed);
+  }
+
+  ConcurrentStringMap(const ConcurrentStringMap &) = delete;
+  ConcurrentStringMap &operator=(const ConcurrentStringMap &) = delete;
+
+  ~ConcurrentStringMap() {
+    Table *T = Current.load(std::memory_order_relaxed);
+    for (unsigned I = 0; I != T->NumBuckets; ++I)
+      if (uintptr_t Value = T->Buckets[I].load(std::memory_order_relaxed))
+        reinterpret_cast<MapEntryTy *>(Value)->Destroy(Allocator);
+    delete T;
+  }
+
+  AllocatorTy &getAllocator() { return Allocator; }
+
+  size_t size() const { return NumItems.load(std::memory_order_relaxed); }
+  bool empty() const { return size() == 0; }
+
+  /// Return the entry for \p Key, or null if there is none.
+  MapEntryTy *find(StringRef Key) const {
+    uint32_t Hash = hashKey(Key);
+    const Table *T = Current.load(std::memory_order_acquire);
+    unsigned Mask = T->NumBuckets - 1;
+    unsigned BucketNo = Hash & Mask;
+    for (unsigned ProbeAmt = 1; ProbeAmt <= T->NumBuckets; ++ProbeAmt) {
+      uintptr_t Value = T->Buckets[BucketNo].load(std::memory_order_acquire) &
+                        ~uintptr_t(MovedBit);
+      // Keys inserted into a newer table were inserted after this lookup
+      // started.
+      if (!Value)
+        return nullptr;
+      auto *Entry = reinterpret_cast<MapEntryTy *>(Value);
+      if (isMatch(Entry, T->Hashes[BucketNo].load(std::memory_order_relaxed),
+                  Hash, Key))
+        return Entry;
+      BucketNo = (BucketNo + ProbeAmt) & Mask;
+    }
+    return nullptr;
+  }
+
+  size_t count(StringRef Key) const { return find(Key) ? 1 : 0; }
+
+  /// Return the value for \p Key, or a default-constructed value if there is
+  /// none.
+  ValueTy lookup(StringRef Key) const {
+    if (MapEntryTy *Entry = find(Key))
+      return Entry->getValue();
+    return ValueTy();
+  }
+
+  /// Insert an entry for \p Key with a value constructed from \p Args, unless
+  /// the map already contains \p Key. Returns the entry for \p Key, and whether
+  /// it was inserted. If another thread inserts \p Key at the same time, \p Args
+  /// may have been moved from even though nothing was inserted.
+  template <typename... ArgsTy>
+  std::pair<MapEntryTy *, bool> try_emplace(StringRef Key, ArgsTy &&... Args) {
+    uint32_t Hash = hashKey(Key);
+    MapEntryTy *NewEntry = nullptr;
+    for (;;) {
+      Table *T = Current.load(std::memory_order_acquire);
+      unsigned Mask = T->NumBuckets - 1;
+      unsigned BucketNo = Hash & Mask;
+      for (unsigned ProbeAmt = 1; ProbeAmt <= T->NumBuckets; ++ProbeAmt) {
+        std::atomic<uintptr_t> &Bucket = T->Buckets[BucketNo];
+        uintptr_t Value = Bucket.load(std::memory_order_acquire);
+        if (!Value) {
+          if (!NewEntry)
+            NewEntry = MapEntryTy::Create(Key, Allocator,
+                                          std::forward<ArgsTy>(Args)...);
+          if (Bucket.compare_exchange_strong(
+                  Value, reinterpret_cast<uintptr_t>(NewEntry),
+                  std::memory_order_acq_rel, std::memory_order_acquire)) {
+            T->Hashes[BucketNo].store(Hash, std::memory_order_relaxed);
+            if (++NumItems * 4 > size_t(T->NumBuckets) * 3)
+              grow(T);
+            return std::make_pair(NewEntry, true);
+          }
+          // Another thread filled the bucket first; look at what it stored.
+        }
+        if (Value & MovedBit)
+          break;
+        auto *Entry = reinterpret_cast<MapEntryTy *>(Value);
+        if (isMatch(Entry, T->Hashes[BucketNo].load(std::memory_order_relaxed),
+                    Hash, Key)) {
+          if (NewEntry)
+            NewEntry->Destroy(Allocator);
+          return std::make_pair(Entry, false);
+        }
+        BucketNo = (BucketNo + ProbeAmt) & Mask;
+      }
+      // The table is being replaced, or is full. Retry once it was replaced.
+      grow(T);
+    }
+  }
+
+  std::pair<MapEntryTy *, bool> insert(std::pair<StringRef, ValueTy> KV) {
+    return try_emplace(KV.first, std::move(KV.second));
+  }
+
+  /// Iterates over the entries in no particular order.
+  class iterator
+      : public iterator_facade_base<iterator, std::forward_iterator_tag,
+                                    MapEntryTy> {
+    const std::atomic<uintptr_t> *Ptr = nullptr;
+    const std::atomic<uintptr_t> *End = nullptr;
+
+    void advancePastEmptyBuckets() {
+      while (Ptr != End && !Ptr->load(std::memory_order_relaxed))
+        ++Ptr;
+    }
+
+  public:
+    iterator() = default;
+    iterator(const std::atomic<uintptr_t> *Ptr,
+             const std::atomic<uintptr_t> *End)
+        : Ptr(Ptr), End(End) {
+      advancePastEmptyBuckets();
+    }
+
+    bool operator==(const iterator &RHS) const { return Ptr == RHS.Ptr; }
+
+    MapEntryTy &operator*() const {
+      return *reinterpret_cast<MapEntryTy *>(
+          Ptr->load(std::memory_order_relaxed));
+    }
+
+    iterator &operator++() {
+      ++Ptr;
+      advancePastEmptyBuckets();
+      return *this;
+    }
+  };
+
+  iterator begin() const {
+    Table *T = Current.load(std::memory_order_acquire);
+    return iterator(T->Buckets.get(), T->Buckets.get() + T->NumBuckets);
+  }
+  iterator end() const {
+    Table *T = Current.load(std::memory_order_acquire);
+    return iterator(T->Buckets.get() + T->NumBuckets,
+                    T->Buckets.get() + T->NumBuckets);
+  }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_CONCURRENTSTRINGMAP_H
@@ -470,9 +470,10 @@ namespace llvm {
     LLVM_NODISCARD
     size_t count(char C) const {
       size_t Count = 0;
+      // Branch-free, which avoids mispredictions and lets compilers vectorize
+      // the loop.
       for (size_t i = 0, e = Length; i != e; ++i)
-        if (Data[i] == C)
-          ++Count;
+        Count += Data[i] == C;
       return Count;
     }
 
@@ -0,0 +1,124 @@
+//===- InlineAdvisor.h - Pluggable inlining decisions -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the interface the inliners consult to decide whether to
+// inline a call site, and the features of a call site such a decision can
+// depend on.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ANALYSIS_INLINEADVISOR_H
+#define LLVM_ANALYSIS_INLINEADVISOR_H
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <memory>
+
+namespace llvm {
+class BlockFrequencyInfo;
+class CallBase;
+class InlineCost;
+class ProfileSummaryInfo;
+class raw_ostream;
+
+/// The properties of a call site and of its surroundings that an inlining
+/// decision can depend on.
+struct InlineFeatures {
+  /// The cost the inline cost model computed for the call site, and the
+  /// threshold below which it would inline it.
+  int Cost = 0;
+  int Threshold = 0;
+
+  /// The size of the callee and of the caller.
+  unsigned CalleeInstructions = 0;
+  unsigned CalleeBlocks = 0;
+  unsigned CallerInstructions = 0;
+
+  /// The number of uses of the callee, and whether it has local linkage: a
+  /// local callee whose only use is inlined goes away.
+  unsigned CalleeUses = 0;
+  bool CalleeHasLocalLinkage = false;
+
+  /// The number of arguments of the call, and how many of them are constants.
+  unsigned NumArgs = 0;
+  unsigned NumConstantArgs = 0;
+
+  /// The frequency of the block of the call site relative to the entry of the
+  /// caller, scaled by \c FrequencyScale, or 0 if it isn't known.
+  uint64_t CallSiteFrequency = 0;
+  static constexpr uint64_t FrequencyScale = 1000;
+
+  /// The profile count of the call site, if there is a profile.
+  Optional<uint64_t> CallSiteCount;
+
+  /// The number of functions of the SCC of the caller, and whether the callee
+  /// is one of them.
+  unsigned SCCSize = 0;
+  bool CalleeInSameSCC = false;
+};
+
+/// Extracts the features of the call site \p CB, for which the cost model
+/// computed \p IC.
+///
+/// \param CallerBFI The block frequencies of the caller, if available.
+/// \param PSI The profile summary, if available.
+InlineFeatures getInlineFeatures(CallBase &CB, const InlineCost &IC,
+                                 BlockFrequencyInfo *CallerBFI,
+                                 ProfileSummaryInfo *PSI, unsigned SCCSize,
+                                 bool CalleeInSameSCC);
+
+/// The interface the inliners consult for the call sites for which the cost
+/// model computed a cost, that is those that aren't always or never inlined
+/// for correctness or because of attributes.
+///
+/// The default implementation follows the cost model. Others can, for
+/// instance, evaluate a model trained with the decisions and outcomes that
+/// \c InlineDecisionLogger writes.
+class InlineAdvisor {
+public:
+  virtual ~InlineAdvisor();
+
+  /// Returns whether to inline the call site with the features \p Features.
+  virtual bool shouldInline(const InlineFeatures &Features);
+
+  /// Called once the inliner acted on the advice for the call site with the
+  /// features \p Features: \p Advised is the advice, and \p Inlined whether
+  /// the call site was inlined.
+  virtual void recordOutcome(const InlineFeatures &Features, bool Advised,
+                             bool Inlined) {}
+};
+
+/// An advisor that follows another one and writes each decision and its
+/// outcome, along with the features it was made with, as a line of comma
+/// separated values.
+class InlineDecisionLogger : public InlineAdvisor {
+public:
+  /// \param WriteHeader Whether to start with a line that names the values.
+  InlineDecisionLogger(std::unique_ptr<InlineAdvisor> Advisor,
+                       std::unique_ptr<raw_ostream> OS, bool WriteHeader);
+  ~InlineDecisionLogger() override;
+
+  bool shouldInline(const InlineFeatures &Features) override;
+  void recordOutcome(const InlineFeatures &Features, bool Advised,
+                     bool Inlined) override;
+
+  /// Opens the log file \p Path, which the decisions are appended to, and
+  /// returns a logger that follows \p Advisor, or null if the file can't be
+  /// opened.
+  static std::unique_ptr<InlineDecisionLogger>
+  create(StringRef Path, std::unique_ptr<InlineAdvisor> Advisor);
+
+private:
+  std::unique_ptr<InlineAdvisor> Advisor;
+  std::unique_ptr<raw_ostream> OS;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ANALYSIS_INLINEADVISOR_H
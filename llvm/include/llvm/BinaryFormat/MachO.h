@@ -1991,6 +1991,109 @@ inline void swapStruct(ppc_thread_state_t &x) {
 const uint32_t PPC_THREAD_STATE_COUNT =
     sizeof(ppc_thread_state32_t) / sizeof(uint32_t);
 
+// Definitions for code signatures, from <kern/cs_blobs.h>. Unlike the rest of
+// a Mach-O file, all the fields of these structures are big-endian.
+
+enum CodeSignMagic {
+  CSMAGIC_REQUIREMENT = 0xfade0c00,
+  CSMAGIC_REQUIREMENTS = 0xfade0c01,
+  CSMAGIC_CODEDIRECTORY = 0xfade0c02,
+  CSMAGIC_EMBEDDED_SIGNATURE = 0xfade0cc0,
+  CSMAGIC_DETACHED_SIGNATURE = 0xfade0cc1,
+  CSMAGIC_ENTITLEMENTS = 0xfade7171,
+  CSMAGIC_BLOBWRAPPER = 0xfade0b01
+};
+
+enum CodeSignVersion {
+  CS_SUPPORTSSCATTER = 0x20100,
+  CS_SUPPORTSTEAMID = 0x20200,
+  CS_SUPPORTSCODELIMIT64 = 0x20300,
+  CS_SUPPORTSEXECSEG = 0x20400
+};
+
+enum CodeSignSlot {
+  CSSLOT_CODEDIRECTORY = 0,
+  CSSLOT_INFOSLOT = 1,
+  CSSLOT_REQUIREMENTS = 2,
+  CSSLOT_RESOURCEDIR = 3,
+  CSSLOT_APPLICATION = 4,
+  CSSLOT_ENTITLEMENTS = 5,
+  CSSLOT_SIGNATURESLOT = 0x10000
+};
+
+enum CodeSignHashType {
+  CS_HASHTYPE_SHA1 = 1,
+  CS_HASHTYPE_SHA256 = 2,
+  CS_HASHTYPE_SHA256_TRUNCATED = 3,
+  CS_HASHTYPE_SHA384 = 4
+};
+
+enum { CS_SHA1_LEN = 20, CS_SHA256_LEN = 32 };
+
+// Values for CS_CodeDirectory.flags.
+enum CodeSignFlags {
+  CS_VALID = 0x00000001,
+  CS_ADHOC = 0x00000002,
+  CS_LINKER_SIGNED = 0x00020000
+};
+
+// Values for CS_CodeDirectory.execSegFlags.
+enum CodeSignExecSegFlags {
+  CS_EXECSEG_MAIN_BINARY = 0x1,
+  CS_EXECSEG_ALLOW_UNSIGNED = 0x10,
+  CS_EXECSEG_DEBUGGER = 0x20,
+  CS_EXECSEG_JIT = 0x40
+};
+
+struct CS_BlobIndex {
+  uint32_t type;   // type of entry
+  uint32_t offset; // offset of entry
+};
+
+struct CS_SuperBlob {
+  uint32_t magic;  // magic number
+  uint32_t length; // total length of SuperBlob
+  uint32_t count;  // number of index entries following
+  // followed by CS_BlobIndex index[count]
+};
+
+LLVM_PACKED_START
+struct CS_CodeDirectory {
+  uint32_t magic;         // magic number (CSMAGIC_CODEDIRECTORY)
+  uint32_t length;        // total length of CodeDirectory blob
+  uint32_t version;       // compatibility version
+  uint32_t flags;         // setup and mode flags
+  uint32_t hashOffset;    // offset of hash slot element at index zero
+  uint32_t identOffset;   // offset of identifier string
+  uint32_t nSpecialSlots; // number of special hash slots
+  uint32_t nCodeSlots;    // number of ordinary (code) hash slots
+  uint32_t codeLimit;     // limit to main image signature range
+  uint8_t hashSize;       // size of each hash in bytes
+  uint8_t hashType;       // type of hash (CS_HASHTYPE_*)
+  uint8_t platform;       // platform identifier; zero if not platform binary
+  uint8_t pageSize;       // log2(page size in bytes); 0 => infinite
+  uint32_t spare2;        // unused (must be zero)
+
+  // Version 0x20100
+  uint32_t scatterOffset; // offset of optional scatter vector
+
+  // Version 0x20200
+  uint32_t teamOffset; // offset of optional team identifier
+
+  // Version 0x20300
+  uint32_t spare3;      // unused (must be zero)
+  uint64_t codeLimit64; // limit to main image signature range, 64 bits
+
+  // Version 0x20400
+  uint64_t execSegBase;  // offset of executable segment
+  uint64_t execSegLimit; // limit of executable segment
+  uint64_t execSegFlags; // executable segment flags
+};
+LLVM_PACKED_END
+
+static_assert(sizeof(CS_CodeDirectory) == 88,
+              "unexpected CS_CodeDirectory size");
+
 // Define a union of all load command structs
 #define LOAD_COMMAND_STRUCT(LCStruct) LCStruct LCStruct##_data;
 
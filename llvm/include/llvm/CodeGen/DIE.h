@@ -760,6 +760,10 @@ public:
   /// eventually used to call \a setAbbrevNumber().
   DIEAbbrev generateAbbrev() const;
 
+  /// Add the abbreviation of this DIE to \p ID, as \a DIEAbbrev::Profile()
+  /// would, without generating it.
+  void profileAbbrev(FoldingSetNodeID &ID) const;
+
   /// Set the abbreviation number for this DIE.
   void setAbbrevNumber(unsigned I) { AbbrevNumber = I; }
 
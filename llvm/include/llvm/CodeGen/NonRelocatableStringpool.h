@@ -6,26 +6,29 @@
 //
 //===----------------------------------------------------------------------===//
 
-#ifndef LLVM_TOOLS_DSYMUTIL_NONRELOCATABLESTRINGPOOL_H
-#define LLVM_TOOLS_DSYMUTIL_NONRELOCATABLESTRINGPOOL_H
-
-#include "SymbolMap.h"
+#ifndef LLVM_CODEGEN_NONRELOCATABLESTRINGPOOL_H
+#define LLVM_CODEGEN_NONRELOCATABLESTRINGPOOL_H
 
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/CodeGen/DwarfStringPoolEntry.h"
 #include "llvm/Support/Allocator.h"
 #include <cstdint>
+#include <functional>
+#include <mutex>
 #include <vector>
 
 namespace llvm {
-namespace dsymutil {
 
 /// A string table that doesn't need relocations.
 ///
 /// We are doing a final link, no need for a string table that has relocation
 /// entries for every reference to it. This class provides this ability by just
 /// associating offsets with strings.
+///
+/// Strings can be added concurrently, but the offsets then depend on the
+/// order of the insertions, so only the uniquing pool should be shared
+/// between threads.
 class NonRelocatableStringpool {
 public:
   /// Entries are stored into the StringMap and simply linked together through
@@ -33,9 +36,12 @@ public:
   /// order.
   using MapTy = StringMap<DwarfStringPoolEntry, BumpPtrAllocator>;
 
-  NonRelocatableStringpool(
-      SymbolMapTranslator Translator = SymbolMapTranslator())
-      : Translator(Translator) {
+  /// A function applied to every string before it is added to the pool, for
+  /// example to translate obfuscated symbol names.
+  using TranslatorTy = std::function<StringRef(StringRef)>;
+
+  NonRelocatableStringpool(TranslatorTy Translator = nullptr)
+      : Translator(std::move(Translator)) {
     // Legacy dsymutil puts an empty string at the start of the line table.
     EmptyString = getEntry("");
   }
@@ -54,18 +60,23 @@ public:
   /// in place of \p S.
   StringRef internString(StringRef S);
 
-  uint64_t getSize() { return CurrentEndOffset; }
+  uint64_t getSize() {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return CurrentEndOffset;
+  }
 
   /// Return the list of strings to be emitted. This does not contain the
   /// strings which were added via internString only.
   std::vector<DwarfStringPoolEntryRef> getEntriesForEmission() const;
 
 private:
+  /// Guards all the members below.
+  mutable std::mutex Mutex;
   MapTy Strings;
   uint32_t CurrentEndOffset = 0;
   unsigned NumEntries = 0;
   DwarfStringPoolEntryRef EmptyString;
-  SymbolMapTranslator Translator;
+  TranslatorTy Translator;
 };
 
 /// Helper for making strong types.
@@ -83,7 +94,6 @@ struct OffsetsTag {};
 using UniquingStringPool = StrongType<NonRelocatableStringpool, UniqueTag>;
 using OffsetsStringPool = StrongType<NonRelocatableStringpool, OffsetsTag>;
 
-} // end namespace dsymutil
 } // end namespace llvm
 
-#endif // LLVM_TOOLS_DSYMUTIL_NONRELOCATABLESTRINGPOOL_H
+#endif // LLVM_CODEGEN_NONRELOCATABLESTRINGPOOL_H
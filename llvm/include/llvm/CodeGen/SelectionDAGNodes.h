@@ -611,6 +611,10 @@ private:
   /// Unique id per SDNode in the DAG.
   int NodeId = -1;
 
+  /// Index of the node in the worklist of the DAGCombiner, or -1 if it isn't
+  /// in the worklist, or -2 if it isn't but was already combined.
+  int CombinerWorklistIndex = -1;
+
   /// The values that are used by this operation.
   SDUse *OperandList = nullptr;
 
@@ -752,6 +756,12 @@ public:
   /// Set unique node id.
   void setNodeId(int Id) { NodeId = Id; }
 
+  /// Get the index of the node in the worklist of the DAGCombiner.
+  int getCombinerWorklistIndex() const { return CombinerWorklistIndex; }
+
+  /// Set the index of the node in the worklist of the DAGCombiner.
+  void setCombinerWorklistIndex(int Index) { CombinerWorklistIndex = Index; }
+
   /// Return the node ordering.
   unsigned getIROrder() const { return IROrder; }
 
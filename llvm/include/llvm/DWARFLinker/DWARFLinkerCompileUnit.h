@@ -1,4 +1,4 @@
-//===- tools/dsymutil/CompileUnit.h - Dwarf debug info linker ---*- C++ -*-===//
+//===- DWARFLinkerCompileUnit.h ---------------------------------*- C++ -*-===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,15 +6,15 @@
 //
 //===----------------------------------------------------------------------===//
 
-#ifndef LLVM_TOOLS_DSYMUTIL_COMPILEUNIT_H
-#define LLVM_TOOLS_DSYMUTIL_COMPILEUNIT_H
+#ifndef LLVM_DWARFLINKER_DWARFLINKERCOMPILEUNIT_H
+#define LLVM_DWARFLINKER_DWARFLINKERCOMPILEUNIT_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/IntervalMap.h"
 #include "llvm/CodeGen/DIE.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
 
 namespace llvm {
-namespace dsymutil {
 
 class DeclContext;
 
@@ -77,25 +77,8 @@ public:
   };
 
   CompileUnit(DWARFUnit &OrigUnit, unsigned ID, bool CanUseODR,
-              StringRef ClangModuleName)
-      : OrigUnit(OrigUnit), ID(ID), Ranges(RangeAlloc),
-        ClangModuleName(ClangModuleName) {
-    Info.resize(OrigUnit.getNumDIEs());
-
-    auto CUDie = OrigUnit.getUnitDIE(false);
-    if (!CUDie) {
-      HasODR = false;
-      return;
-    }
-    if (auto Lang = dwarf::toUnsigned(CUDie.find(dwarf::DW_AT_language)))
-      HasODR = CanUseODR && (*Lang == dwarf::DW_LANG_C_plus_plus ||
-                             *Lang == dwarf::DW_LANG_C_plus_plus_03 ||
-                             *Lang == dwarf::DW_LANG_C_plus_plus_11 ||
-                             *Lang == dwarf::DW_LANG_C_plus_plus_14 ||
-                             *Lang == dwarf::DW_LANG_ObjC_plus_plus);
-    else
-      HasODR = false;
-  }
+              StringRef ClangModuleName);
+  ~CompileUnit();
 
   DWARFUnit &getOrigUnit() const { return OrigUnit; }
 
@@ -248,6 +231,15 @@ public:
     ResolvedPaths[FileNum] = Path;
   }
 
+  /// Remember that the DIE at index \p Idx belongs to the ODR context \p Ctxt.
+  ///
+  /// \returns the index of the first DIE of this unit that was seen in
+  /// \p Ctxt, which is \p Idx if there is none.
+  uint32_t noteODRContext(const DeclContext *Ctxt, uint32_t Idx);
+
+  /// Forget about the ODR contexts seen so far, once the unit is analyzed.
+  void clearODRContexts();
+
   MCSymbol *getLabelBegin() { return LabelBegin; }
   void setLabelBegin(MCSymbol *S) { LabelBegin = S; }
 
@@ -312,6 +304,11 @@ private:
   /// for the purposes of getting a unique address for each string.
   std::vector<StringRef> ResolvedPaths;
 
+  /// The ODR contexts seen while analyzing this unit, along with the index of
+  /// the first DIE they were seen at. This is kept per unit rather than in the
+  /// contexts so that units can be analyzed concurrently.
+  DenseMap<const DeclContext *, uint32_t> SeenODRContexts;
+
   /// Is this unit subject to the ODR rule?
   bool HasODR;
 
@@ -325,7 +322,6 @@ private:
   std::string ClangModuleName;
 };
 
-} // end namespace dsymutil
 } // end namespace llvm
 
-#endif // LLVM_TOOLS_DSYMUTIL_COMPILEUNIT_H
+#endif // LLVM_DWARFLINKER_DWARFLINKERCOMPILEUNIT_H
@@ -1,4 +1,4 @@
-//===- tools/dsymutil/DeclContext.h - Dwarf debug info linker ---*- C++ -*-===//
+//===- DWARFLinkerDeclContext.h ---------------------------------*- C++ -*-===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,20 +6,21 @@
 //
 //===----------------------------------------------------------------------===//
 
-#ifndef LLVM_TOOLS_DSYMUTIL_DECLCONTEXT_H
-#define LLVM_TOOLS_DSYMUTIL_DECLCONTEXT_H
+#ifndef LLVM_DWARFLINKER_DWARFLINKERDECLCONTEXT_H
+#define LLVM_DWARFLINKER_DWARFLINKERDECLCONTEXT_H
 
-#include "CompileUnit.h"
-#include "NonRelocatableStringpool.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseMapInfo.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/CodeGen/NonRelocatableStringpool.h"
+#include "llvm/DWARFLinker/DWARFLinkerCompileUnit.h"
 #include "llvm/DebugInfo/DWARF/DWARFDie.h"
 #include "llvm/Support/Path.h"
+#include <atomic>
+#include <mutex>
 
 namespace llvm {
-namespace dsymutil {
 
 struct DeclMapInfo;
 
@@ -75,24 +76,30 @@ class DeclContext {
 public:
   using Map = DenseSet<DeclContext *, DeclMapInfo>;
 
-  DeclContext() : DefinedInClangModule(0), Parent(*this) {}
+  DeclContext() : Parent(*this) {}
 
   DeclContext(unsigned Hash, uint32_t Line, uint32_t ByteSize, uint16_t Tag,
-              StringRef Name, StringRef File, const DeclContext &Parent,
-              DWARFDie LastSeenDIE = DWARFDie(), unsigned CUId = 0)
+              StringRef Name, StringRef File, const DeclContext &Parent)
       : QualifiedNameHash(Hash), Line(Line), ByteSize(ByteSize), Tag(Tag),
-        DefinedInClangModule(0), Name(Name), File(File), Parent(Parent),
-        LastSeenDIE(LastSeenDIE), LastSeenCompileUnitID(CUId) {}
+        Name(Name), File(File), Parent(Parent) {}
 
   uint32_t getQualifiedNameHash() const { return QualifiedNameHash; }
 
   bool setLastSeenDIE(CompileUnit &U, const DWARFDie &Die);
 
-  uint32_t getCanonicalDIEOffset() const { return CanonicalDIEOffset; }
-  void setCanonicalDIEOffset(uint32_t Offset) { CanonicalDIEOffset = Offset; }
+  uint32_t getCanonicalDIEOffset() const {
+    return CanonicalDIEOffset.load(std::memory_order_relaxed);
+  }
+  void setCanonicalDIEOffset(uint32_t Offset) {
+    CanonicalDIEOffset.store(Offset, std::memory_order_relaxed);
+  }
 
-  bool isDefinedInClangModule() const { return DefinedInClangModule; }
-  void setDefinedInClangModule(bool Val) { DefinedInClangModule = Val; }
+  bool isDefinedInClangModule() const {
+    return DefinedInClangModule.load(std::memory_order_relaxed);
+  }
+  void setDefinedInClangModule(bool Val) {
+    DefinedInClangModule.store(Val, std::memory_order_relaxed);
+  }
 
   uint16_t getTag() const { return Tag; }
   StringRef getName() const { return Name; }
@@ -104,13 +111,15 @@ private:
   uint32_t Line = 0;
   uint32_t ByteSize = 0;
   uint16_t Tag = dwarf::DW_TAG_compile_unit;
-  unsigned DefinedInClangModule : 1;
   StringRef Name;
   StringRef File;
   const DeclContext &Parent;
-  DWARFDie LastSeenDIE;
-  uint32_t LastSeenCompileUnitID = 0;
-  uint32_t CanonicalDIEOffset = 0;
+  /// These are read by the analysis of an object while the previous objects
+  /// are being cloned.
+  /// @{
+  std::atomic<bool> DefinedInClangModule{false};
+  std::atomic<uint32_t> CanonicalDIEOffset{0};
+  /// @}
 };
 
 /// This class gives a tree-like API to the DenseMap that stores the
@@ -127,6 +136,8 @@ public:
   /// not returning null, because some children of that context might be
   /// uniquing candidates.
   ///
+  /// This can be called concurrently for different units.
+  ///
   /// FIXME: The invalid bit along the return value is to emulate some
   /// dsymutil-classic functionality.
   PointerIntPair<DeclContext *, 1>
@@ -137,6 +148,8 @@ public:
   DeclContext &getRoot() { return Root; }
 
 private:
+  /// Guards the allocator, the contexts map and the path resolver.
+  std::mutex Mutex;
   BumpPtrAllocator Allocator;
   DeclContext Root;
   DeclContext::Map Contexts;
@@ -165,7 +178,6 @@ struct DeclMapInfo : private DenseMapInfo<DeclContext *> {
   }
 };
 
-} // end namespace dsymutil
 } // end namespace llvm
 
-#endif // LLVM_TOOLS_DSYMUTIL_DECLCONTEXT_H
+#endif // LLVM_DWARFLINKER_DWARFLINKERDECLCONTEXT_H
@@ -40,6 +40,7 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 
 namespace llvm {
 
@@ -64,6 +65,9 @@ class DWARFContext : public DIContext {
   std::unique_ptr<DWARFDebugLoc> Loc;
   std::unique_ptr<DWARFDebugAranges> Aranges;
   std::unique_ptr<DWARFDebugLine> Line;
+  /// Guards Line, so that units can get their line tables from several
+  /// threads.
+  std::mutex LineMutex;
   std::unique_ptr<DWARFDebugFrame> DebugFrame;
   std::unique_ptr<DWARFDebugFrame> EHFrame;
   std::unique_ptr<DWARFDebugMacro> Macro;
@@ -131,6 +135,20 @@ public:
 
   bool verify(raw_ostream &OS, DIDumpOptions DumpOpts = {}) override;
 
+  /// Verify the debug info, checking the contents of the units in the
+  /// .debug_info and .debug_types sections on \p NumThreads threads. Zero
+  /// means one thread per hardware thread.
+  bool verify(raw_ostream &OS, DIDumpOptions DumpOpts, unsigned NumThreads);
+
+  /// Parse the headers of the units in the .debug_info and .debug_types
+  /// sections, and extract all of their DIEs on \p NumThreads threads. Zero
+  /// means one thread per hardware thread.
+  ///
+  /// This does up front, in parallel, what walking all of the units would
+  /// otherwise do one unit at a time. Afterwards, the DIEs of the units don't
+  /// move anymore, so the units can be walked from several threads.
+  void extractAllUnitDIEs(unsigned NumThreads);
+
   using unit_iterator_range = DWARFUnitVector::iterator_range;
 
   /// Get units from .debug_info in this context.
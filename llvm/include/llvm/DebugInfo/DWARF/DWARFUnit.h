@@ -25,11 +25,13 @@
 #include "llvm/DebugInfo/DWARF/DWARFUnitIndex.h"
 #include "llvm/Support/DataExtractor.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -221,11 +223,19 @@ class DWARFUnit {
   /// A table of range lists (DWARF v5 and later).
   Optional<DWARFDebugRnglistTable> RngListTable;
 
-  mutable const DWARFAbbreviationDeclarationSet *Abbrevs;
+  mutable std::atomic<const DWARFAbbreviationDeclarationSet *> Abbrevs;
   llvm::Optional<object::SectionedAddress> BaseAddr;
   /// The compile unit debug information entry items.
   std::vector<DWARFDebugInfoEntry> DieArray;
 
+  /// Set once the unit DIE, or all of the DIEs, have been extracted into
+  /// DieArray. These let threads skip ExtractDIEsMutex once the DIEs they
+  /// need are there, so that the DIEs of a unit can be extracted by any
+  /// thread that needs them.
+  std::atomic<bool> ExtractedUnitDIE{false};
+  std::atomic<bool> ExtractedAllDIEs{false};
+  std::mutex ExtractDIEsMutex;
+
   /// Map from range's start address to end address and corresponding DIE.
   /// IntervalMap does not support range removal, as a result, we use the
   /// std::map::upper_bound for address range lookup.
@@ -497,6 +507,11 @@ public:
 
   virtual void dump(raw_ostream &OS, DIDumpOptions DumpOpts) = 0;
 
+  /// Extract the unit DIE, or all DIEs, if that hasn't been done yet.
+  ///
+  /// This is thread safe, so units can be extracted concurrently. Extracting
+  /// all DIEs after only the unit DIE moves the unit DIE though, so threads
+  /// that share a unit should extract all of its DIEs before using any.
   Error tryExtractDIEsIfNeeded(bool CUDieOnly);
 
 private:
@@ -514,7 +529,8 @@ private:
   void extractDIEsToVector(bool AppendCUDie, bool AppendNonCUDIEs,
                            std::vector<DWARFDebugInfoEntry> &DIEs) const;
 
-  /// clearDIEs - Clear parsed DIEs to keep memory usage low.
+  /// clearDIEs - Clear parsed DIEs to keep memory usage low. Unlike the
+  /// extraction of DIEs, this isn't thread safe.
   void clearDIEs(bool KeepCUDie);
 
   /// parseDWO - Parses .dwo file for current compile unit. Returns true if
@@ -96,6 +96,9 @@ private:
   /// lies between to valid DIEs.
   std::map<uint64_t, std::set<uint64_t>> ReferenceToDIEOffsets;
   uint32_t NumDebugLineErrors = 0;
+  /// The number of threads to verify the contents of units on, zero meaning
+  /// one thread per hardware thread.
+  unsigned NumThreads;
   // Used to relax some checks that do not currently work portably
   bool IsObjectFile;
   bool IsMachOObject;
@@ -158,6 +161,15 @@ private:
   /// \returns The number of errors that occurred during verification.
   unsigned verifyUnitContents(DWARFUnit &Unit);
 
+  /// Verifies the contents of \p Units on NumThreads threads.
+  ///
+  /// Each unit is verified by its own DWARFVerifier writing to a buffer. The
+  /// buffers are printed, and the references that were found are merged, in
+  /// the order of the units, so the output doesn't depend on the scheduling.
+  ///
+  /// \returns The number of errors that occurred during verification.
+  unsigned verifyUnitContentsInParallel(ArrayRef<DWARFUnit *> Units);
+
   /// Verifies the unit headers and contents in a .debug_info or .debug_types
   /// section.
   ///
@@ -287,8 +299,14 @@ private:
                             const DataExtractor &StrData);
 
 public:
+  /// \param NumThreads The number of threads to verify the contents of the
+  /// units of the .debug_info and .debug_types sections on, zero meaning one
+  /// thread per hardware thread. With more than one thread, the errors in
+  /// the contents of the units of a section are reported after the errors in
+  /// its unit headers.
   DWARFVerifier(raw_ostream &S, DWARFContext &D,
-                DIDumpOptions DumpOpts = DIDumpOptions::getForSingleDIE());
+                DIDumpOptions DumpOpts = DIDumpOptions::getForSingleDIE(),
+                unsigned NumThreads = 1);
 
   /// Verify the information in any of the following sections, if available:
   /// .debug_abbrev, debug_abbrev.dwo
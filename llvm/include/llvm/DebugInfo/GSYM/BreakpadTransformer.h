@@ -0,0 +1,53 @@
+//===- BreakpadTransformer.h ------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFO_GSYM_BREAKPADTRANSFORMER_H
+#define LLVM_DEBUGINFO_GSYM_BREAKPADTRANSFORMER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+namespace llvm {
+
+class raw_ostream;
+
+namespace gsym {
+
+class GsymCreator;
+
+/// Converts the text of a Breakpad symbol file into gsym::FunctionInfo
+/// objects.
+///
+/// FUNC records and the line records that follow them become FunctionInfo
+/// objects with line tables, and the INLINE records of a FUNC become its
+/// InlineInfo, using the names of the INLINE_ORIGIN records. FILE records
+/// give the files of the line and INLINE records. PUBLIC records become
+/// FunctionInfo objects without a size, which GsymCreator::finalize()
+/// extends to the next function. The id of the MODULE record is used as the
+/// UUID. Other records are ignored.
+class BreakpadTransformer {
+public:
+  /// Convert the Breakpad symbol file contents \a Text into \a Gsym.
+  ///
+  /// \param Text The contents of the Breakpad symbol file.
+  ///
+  /// \param Log The stream to log warnings about malformed records to. The
+  /// malformed records are skipped.
+  ///
+  /// \param Gsym The GSYM creator to populate.
+  ///
+  /// \returns An error indicating any fatal issues, or Error::success() if
+  /// all goes well.
+  static llvm::Error convert(StringRef Text, raw_ostream &Log,
+                             GsymCreator &Gsym);
+};
+
+} // namespace gsym
+} // namespace llvm
+
+#endif // #ifndef LLVM_DEBUGINFO_GSYM_BREAKPADTRANSFORMER_H
@@ -0,0 +1,72 @@
+//===- DwarfTransformer.h ---------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFO_GSYM_DWARFTRANSFORMER_H
+#define LLVM_DEBUGINFO_GSYM_DWARFTRANSFORMER_H
+
+#include "llvm/Support/Error.h"
+
+namespace llvm {
+
+class raw_ostream;
+class DWARFContext;
+class DWARFDie;
+
+namespace gsym {
+
+struct CUInfo;
+class GsymCreator;
+
+/// A DWARF transformer that is used to convert DWARF debug info into
+/// gsym::FunctionInfo objects.
+///
+/// One gsym::FunctionInfo object is created for each contiguous address range
+/// of each DW_TAG_subprogram DIE, with the line table rows of that range and
+/// the DW_TAG_inlined_subroutine DIEs it contains. The function infos are
+/// added to the gsym::GsymCreator object that is passed in, so the
+/// information can be combined with the function infos from other sources,
+/// like the symbol table.
+class DwarfTransformer {
+public:
+  /// Create a DWARF transformer.
+  ///
+  /// \param D The DWARF to use when converting to GSYM.
+  ///
+  /// \param OS The stream to log warnings and non fatal issues to.
+  ///
+  /// \param G The GSYM creator to populate with the function information
+  /// from the debug info.
+  DwarfTransformer(DWARFContext &D, raw_ostream &OS, GsymCreator &G)
+      : DICtx(D), Log(OS), Gsym(G) {}
+
+  /// Extract the DWARF from the supplied object file and convert it into the
+  /// GSYM format in the GsymCreator object that is passed in. Returns an
+  /// error if something fatal is encountered.
+  ///
+  /// \param NumThreads The number of threads that the conversion process can
+  /// use. Compile units are converted in parallel when this is not one, and
+  /// zero means one thread per hardware thread.
+  ///
+  /// \returns An error indicating any fatal issues that happen when parsing
+  /// the DWARF, or Error::success() if all goes well.
+  llvm::Error convert(uint32_t NumThreads);
+
+private:
+  /// Convert the subprograms in \a Die and its children into the
+  /// GsymCreator, logging issues to \a OS.
+  void handleDie(raw_ostream &OS, CUInfo &CUI, DWARFDie Die);
+
+  DWARFContext &DICtx;
+  raw_ostream &Log;
+  GsymCreator &Gsym;
+};
+
+} // namespace gsym
+} // namespace llvm
+
+#endif // #ifndef LLVM_DEBUGINFO_GSYM_DWARFTRANSFORMER_H
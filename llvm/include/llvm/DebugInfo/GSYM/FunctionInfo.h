@@ -29,7 +29,26 @@ namespace gsym {
 /// range, it will be split into two gsym::FunctionInfo objects. If the
 /// function has inline functions, the information will be encoded in
 /// the "Inline" member, see gsym::InlineInfo for more information.
+///
+/// ENCODING
+///
+/// When saved to disk, the FunctionInfo is encoded as:
+/// - UINT32 size of the function in bytes. The start address is stored in
+///   the address table of the GSYM file.
+/// - UINT32 string table offset of the name of the function.
+/// - A list of info chunks, each made of a UINT32 info type, a UINT32 length
+///   in bytes and that many bytes of data, terminated by an EndOfList (zero)
+///   info type with a zero length. The other info types are LineTableInfo
+///   (one) and InlineInfo (two). Chunks of unknown types are skipped so the
+///   list can be extended without breaking older readers.
+///
+/// The LineTableInfo chunk encodes the line table as a ULEB128 number of
+/// entries, followed by each entry as a ULEB128 address delta from the
+/// previous entry (or from the function start address for the first entry),
+/// a ULEB128 file index and a SLEB128 line delta from the previous entry.
+/// The InlineInfo chunk holds the encoded "Inline" member.
 struct FunctionInfo {
+
   AddressRange Range;
   uint32_t Name; ///< String table offset in the string table.
   std::vector<gsym::LineEntry> Lines;
@@ -68,6 +87,29 @@ struct FunctionInfo {
     Lines.clear();
     Inline.clear();
   }
+
+  /// Decode a FunctionInfo object from a binary data stream.
+  ///
+  /// \param Data The binary stream to read the data from. This object must
+  /// have the data for the FunctionInfo object starting at offset zero. The
+  /// data can contain more data than needed.
+  ///
+  /// \param BaseAddr The FunctionInfo's start address, which is stored in the
+  /// address table of the GSYM file rather than in the FunctionInfo itself.
+  ///
+  /// \returns A FunctionInfo or an error describing the issue that was
+  /// encountered during decoding.
+  static llvm::Expected<FunctionInfo> decode(DataExtractor &Data,
+                                             uint64_t BaseAddr);
+
+  /// Encode this FunctionInfo object into FileWriter stream.
+  ///
+  /// \param O The binary stream to write the data to at the current file
+  /// position.
+  ///
+  /// \returns The file offset the FunctionInfo was encoded at, or an error
+  /// that indicates why the encoding failed.
+  llvm::Expected<uint64_t> encode(FileWriter &O) const;
 };
 
 inline bool operator==(const FunctionInfo &LHS, const FunctionInfo &RHS) {
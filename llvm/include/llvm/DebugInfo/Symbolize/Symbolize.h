@@ -19,6 +19,7 @@
 #include "llvm/Support/Error.h"
 #include <algorithm>
 #include <cstdint>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -44,6 +45,16 @@ public:
     std::vector<std::string> DsymHints;
     std::string FallbackDebugPath;
     std::string DWPName;
+    /// Approximate number of bytes of object files and debug info that may
+    /// stay loaded between queries, or zero for no limit. When the limit is
+    /// exceeded, the least recently used modules are unloaded.
+    uint64_t MaxCacheSize = 0;
+  };
+
+  /// A code address to symbolize as part of a batch.
+  struct BatchRequest {
+    std::string ModuleName;
+    object::SectionedAddress ModuleOffset;
   };
 
   LLVMSymbolizer() = default;
@@ -65,6 +76,23 @@ public:
   Expected<std::vector<DILocal>>
   symbolizeFrame(const std::string &ModuleName,
                  object::SectionedAddress ModuleOffset);
+
+  /// Symbolize a batch of code addresses.
+  ///
+  /// The requests are grouped by module and sorted by address within each
+  /// module, so that consecutive lookups stay in the same compile unit and
+  /// line table whatever the order of the requests. Different modules are
+  /// symbolized in parallel on \p NumThreads threads, where zero means one
+  /// per hardware thread.
+  ///
+  /// \returns The results in the order of \p Requests. Like for single
+  /// queries, an error is only returned for the first request in a module
+  /// that fails to load, and the other requests in it get empty results.
+  std::vector<Expected<DILineInfo>>
+  symbolizeCodeBatch(ArrayRef<BatchRequest> Requests, unsigned NumThreads = 1);
+  std::vector<Expected<DIInliningInfo>>
+  symbolizeInlinedCodeBatch(ArrayRef<BatchRequest> Requests,
+                            unsigned NumThreads = 1);
   void flush();
 
   static std::string
@@ -80,6 +108,12 @@ private:
   symbolizeCodeCommon(SymbolizableModule *Info,
                       object::SectionedAddress ModuleOffset);
 
+  /// Loads the modules of all of \p Requests and returns one module per
+  /// request. \p Errors gets the load error of each request.
+  std::vector<SymbolizableModule *>
+  getModulesForBatch(ArrayRef<BatchRequest> Requests,
+                     std::vector<Error> &Errors);
+
   /// Returns a SymbolizableModule or an error if loading debug info failed.
   /// Only one attempt is made to load a module, and errors during loading are
   /// only reported once. Subsequent calls to get module info for a module that
@@ -92,6 +126,19 @@ private:
                    std::unique_ptr<DIContext> Context,
                    StringRef ModuleName);
 
+  /// Records that \p ModuleName was loaded from \p Objects, which hold about
+  /// \p Size bytes, and makes it the most recently used module.
+  void recordModule(const std::string &ModuleName, ObjectPair Objects,
+                    uint64_t Size);
+
+  /// Marks \p ModuleName as the most recently used module.
+  void touchModule(const std::string &ModuleName);
+
+  /// Unloads the least recently used modules and the binaries that no other
+  /// module uses until the cache fits in Options::MaxCacheSize. The most
+  /// recently used module is always kept.
+  void pruneCache();
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
@@ -111,6 +158,20 @@ private:
 
   std::map<std::string, std::unique_ptr<SymbolizableModule>> Modules;
 
+  /// Cache bookkeeping for each successfully loaded module.
+  struct ModuleCacheEntry {
+    ObjectPair Objects;
+    uint64_t Size;
+    std::list<std::string>::iterator LRUPos;
+  };
+  std::map<std::string, ModuleCacheEntry> ModuleCache;
+
+  /// Names of the loaded modules, the most recently used first.
+  std::list<std::string> ModuleLRU;
+
+  /// Sum of the sizes of the modules in ModuleCache.
+  uint64_t CacheSize = 0;
+
   /// Contains cached results of getOrCreateObjectPair().
   std::map<std::pair<std::string, std::string>, ObjectPair>
       ObjectPairForPathArch;
@@ -18,6 +18,9 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/Memory.h"
 #include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace llvm {
 namespace jitlink {
@@ -93,6 +96,54 @@ public:
   allocate(const SegmentsRequestMap &Request) override;
 };
 
+/// A JITLinkMemoryManager that sub-allocates in-process memory from large
+/// slabs.
+///
+/// Each protection class has its own slabs, so segments with the same
+/// protections are packed next to each other across allocations. This keeps
+/// JIT'd code dense (fewer iTLB entries and memory mappings) and maps memory
+/// once per slab rather than once per segment. Memory is handed out with page
+/// granularity since protections apply to whole pages, lowest address first.
+/// Deallocated memory is made writable again and reused by later allocations,
+/// e.g. once the modules of a removed JITDylib have been removed from the
+/// ObjectLinkingLayer.
+///
+/// The memory manager must outlive all of its allocations.
+class SlabMemoryManager : public JITLinkMemoryManager {
+public:
+  /// Create a memory manager that maps slabs of at least SlabSize bytes.
+  ///
+  /// If UseHugePages is true, the slabs for executable segments are mapped
+  /// with the MF_HUGE_HINT flag. This works best if SlabSize is a multiple of
+  /// the huge page size.
+  SlabMemoryManager(uint64_t SlabSize = 64 * 1024 * 1024,
+                    bool UseHugePages = false);
+
+  ~SlabMemoryManager() override;
+
+  Expected<std::unique_ptr<Allocation>>
+  allocate(const SegmentsRequestMap &Request) override;
+
+private:
+  class SlabAllocation;
+
+  struct ProtectionClass {
+    std::vector<sys::MemoryBlock> Slabs;
+    // The unused memory in the slabs, as sizes by start address.
+    std::map<uintptr_t, uint64_t> FreeRanges;
+  };
+
+  Expected<sys::MemoryBlock> allocateBlock(ProtectionFlags Prot,
+                                           uint64_t Size);
+  Error releaseBlock(ProtectionFlags Prot, sys::MemoryBlock Block);
+
+  std::mutex SlabsMutex;
+  uint64_t SlabSize;
+  uint64_t PageSize;
+  bool UseHugePages;
+  DenseMap<unsigned, ProtectionClass> ProtectionClasses;
+};
+
 } // end namespace jitlink
 } // end namespace llvm
 
@@ -94,6 +94,13 @@ public:
 
   /// Sets the ImplSymbolMap
   void setImplMap(ImplSymbolMap *Imp);
+
+  /// Points the stub for the given symbol at a new address, e.g. that of a
+  /// recompiled version of the function. ImplJD is the implementation
+  /// JITDylib that the symbol's definition was emitted to.
+  Error updateStubPointer(JITDylib &ImplJD, const SymbolStringPtr &Name,
+                          JITTargetAddress NewAddr);
+
   /// Emits the given module. This should not be called by clients: it will be
   /// called by the JIT when a definition added via the add method is requested.
   void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
@@ -71,8 +71,10 @@ private:
 
 /// A thread-safe version of SimpleCompiler.
 ///
-/// This class creates a new TargetMachine and SimpleCompiler instance for each
-/// compile.
+/// This class uses a SimpleCompiler instance for each compile, with a
+/// TargetMachine that no other compile uses at the same time. The target
+/// machines are created on demand and reused by later compiles, as creating
+/// one costs about as much as compiling a small module.
 class ConcurrentIRCompiler {
 public:
   ConcurrentIRCompiler(JITTargetMachineBuilder JTMB,
@@ -83,8 +85,13 @@ public:
   std::unique_ptr<MemoryBuffer> operator()(Module &M);
 
 private:
+  class TargetMachinePool;
+
   JITTargetMachineBuilder JTMB;
   ObjectCache *ObjCache = nullptr;
+  // Shared because std::functions (and consequently
+  // IRCompileLayer::CompileFunction) are not moveable.
+  std::shared_ptr<TargetMachinePool> TMs;
 };
 
 } // end namespace orc
@@ -21,6 +21,7 @@
 #include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/ObjectTransformLayer.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
 #include "llvm/Support/ThreadPool.h"
 
 namespace llvm {
@@ -158,6 +159,15 @@ public:
     TransformLayer->setTransform(std::move(Transform));
   }
 
+  /// Set an IR transform to run on each function when it is recompiled by
+  /// tiered compilation. By default, the -O2 pipeline is run.
+  ///
+  /// Tiered compilation must have been enabled with setTierUpThreshold.
+  void setTier1CompileTransform(IRTransformLayer::TransformFunction Transform) {
+    assert(Tier1TransformLayer && "Tiered compilation is not enabled");
+    Tier1TransformLayer->setTransform(std::move(Transform));
+  }
+
   /// Sets the partition function.
   void
   setPartitionFunction(CompileOnDemandLayer::PartitionFunction Partition) {
@@ -179,6 +189,9 @@ private:
 
   std::unique_ptr<LazyCallThroughManager> LCTMgr;
   std::unique_ptr<IRTransformLayer> TransformLayer;
+  std::unique_ptr<IRCompileLayer> Tier1CompileLayer;
+  std::unique_ptr<IRTransformLayer> Tier1TransformLayer;
+  std::unique_ptr<TieredCompileLayer> TieredLayer;
   std::unique_ptr<CompileOnDemandLayer> CODLayer;
 };
 
@@ -195,6 +208,7 @@ public:
   Optional<JITTargetMachineBuilder> JTMB;
   ObjectLinkingLayerCreator CreateObjectLinkingLayer;
   CompileFunctionCreator CreateCompileFunction;
+  ObjectCache *ObjCache = nullptr;
   unsigned NumCompileThreads = 0;
 
   /// Called prior to JIT class construcion to fix up defaults.
@@ -241,6 +255,16 @@ public:
     return impl();
   }
 
+  /// Set an ObjectCache for the default compile function to use.
+  ///
+  /// The cache is not owned by the JIT and must outlive it. It is ignored if a
+  /// CompileFunctionCreator is set. See PersistentObjectCache for an on-disk
+  /// cache that can be shared between JIT sessions.
+  SetterImpl &setObjectCache(ObjectCache *ObjCache) {
+    impl().ObjCache = ObjCache;
+    return impl();
+  }
+
   /// Set the number of compile threads to use.
   ///
   /// If set to zero, compilation will be performed on the execution thread when
@@ -286,6 +310,8 @@ public:
   JITTargetAddress LazyCompileFailureAddr = 0;
   std::unique_ptr<LazyCallThroughManager> LCTMgr;
   IndirectStubsManagerBuilderFunction ISMBuilder;
+  unsigned TierUpThreshold = 0;
+  Optional<JITTargetMachineBuilder> Tier1JTMB;
 
   Error prepareForConstruction();
 };
@@ -321,6 +347,21 @@ public:
     this->impl().ISMBuilder = std::move(ISMBuilder);
     return this->impl();
   }
+
+  /// Enable tiered compilation.
+  ///
+  /// Functions are first compiled with CodeGen optimizations disabled. Once a
+  /// function has been called TierUpThreshold times it is recompiled in the
+  /// background (if there are compile threads), with the -O2 pipeline and
+  /// the default CodeGen optimization level, and its stub is repointed to the
+  /// new code.
+  ///
+  /// If this method is not called, or is called with zero, functions are
+  /// compiled once at the JITTargetMachineBuilder's optimization level.
+  SetterImpl &setTierUpThreshold(unsigned TierUpThreshold) {
+    this->impl().TierUpThreshold = TierUpThreshold;
+    return this->impl();
+  }
 };
 
 /// Constructs LLLazyJIT instances.
@@ -19,7 +19,9 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
 #include "llvm/ExecutionEngine/Orc/OrcRemoteTargetRPCAPI.h"
 #include "llvm/ExecutionEngine/RuntimeDyld.h"
@@ -329,6 +331,202 @@ public:
     std::vector<EHFrame> RegisteredEHFrames;
   };
 
+  /// Remote-mapped JITLink memory manager, for use with an ObjectLinkingLayer.
+  ///
+  /// Each allocation lays out its segments in a single block of remote memory,
+  /// and is linked in local working memory. Finalizing an allocation writes the
+  /// contents of all of its segments and applies their protections with a
+  /// single RPC call. Zero-fill memory is not transferred.
+  ///
+  /// Like the client itself, instances must not be used from several threads
+  /// at once.
+  class RemoteJITLinkMemoryManager : public jitlink::JITLinkMemoryManager {
+  public:
+    RemoteJITLinkMemoryManager(OrcRemoteTargetClient &Client)
+        : Client(Client) {}
+
+    Expected<std::unique_ptr<Allocation>>
+    allocate(const SegmentsRequestMap &Request) override {
+      uint32_t PageSize = Client.getPageSize();
+      DenseMap<unsigned, RemoteAllocation::Segment> Segments;
+      uint64_t TotalSize = 0;
+
+      // Lay out each segment on its own pages, so that it can be protected
+      // independently.
+      for (auto &KV : Request) {
+        auto &Seg = KV.second;
+
+        if (Seg.getContentAlignment() > PageSize)
+          return make_error<StringError>("Cannot request higher than page "
+                                         "alignment",
+                                         inconvertibleErrorCode());
+
+        if (PageSize % Seg.getContentAlignment() != 0)
+          return make_error<StringError>("Page size is not a multiple of "
+                                         "alignment",
+                                         inconvertibleErrorCode());
+
+        uint64_t ZeroFillStart =
+            alignTo(Seg.getContentSize(), Seg.getZeroFillAlignment());
+        uint64_t SegmentSize =
+            alignTo(ZeroFillStart + Seg.getZeroFillSize(), PageSize);
+
+        Segments[KV.first] = {TotalSize, Seg.getContentSize(), SegmentSize};
+        TotalSize += SegmentSize;
+      }
+
+      auto Id = Client.AllocatorIds.getNext();
+      if (auto Err = Client.callB<mem::CreateRemoteAllocator>(Id))
+        return std::move(Err);
+
+      JITTargetAddress RemoteAddr = 0;
+      if (TotalSize != 0) {
+        auto AddrOrErr =
+            Client.callB<mem::ReserveMem>(Id, TotalSize, PageSize);
+        if (!AddrOrErr) {
+          Client.destroyRemoteAllocator(Id);
+          return AddrOrErr.takeError();
+        }
+        RemoteAddr = *AddrOrErr;
+      }
+
+      LLVM_DEBUG(dbgs() << "Allocator " << Id << " reserved " << TotalSize
+                        << " bytes at " << format("0x%016" PRIx64, RemoteAddr)
+                        << "\n");
+
+      // Working memory is value-initialized, so zero-fill is already zeroed.
+      return std::unique_ptr<Allocation>(new RemoteAllocation(
+          Client, Id, RemoteAddr, std::make_unique<char[]>(TotalSize),
+          std::move(Segments)));
+    }
+
+  private:
+    class RemoteAllocation : public Allocation {
+    public:
+      struct Segment {
+        uint64_t Offset;
+        uint64_t ContentSize;
+        uint64_t Size;
+      };
+
+      RemoteAllocation(OrcRemoteTargetClient &Client,
+                       ResourceIdMgr::ResourceId Id,
+                       JITTargetAddress RemoteAddr,
+                       std::unique_ptr<char[]> WorkingMem,
+                       DenseMap<unsigned, Segment> Segments)
+          : Client(Client), Id(Id), RemoteAddr(RemoteAddr),
+            WorkingMem(std::move(WorkingMem)), Segments(std::move(Segments)) {}
+
+      MutableArrayRef<char> getWorkingMemory(ProtectionFlags Seg) override {
+        assert(Segments.count(Seg) && "No allocation for segment");
+        assert(WorkingMem && "Allocation has already been finalized");
+        auto &S = Segments[Seg];
+        return {WorkingMem.get() + S.Offset, S.Size};
+      }
+
+      JITTargetAddress getTargetMemory(ProtectionFlags Seg) override {
+        assert(Segments.count(Seg) && "No allocation for segment");
+        return RemoteAddr + Segments[Seg].Offset;
+      }
+
+      void finalizeAsync(FinalizeContinuation OnFinalize) override {
+        std::vector<DirectBufferWriter> Writes;
+        std::vector<std::tuple<JITTargetAddress, uint64_t, uint32_t>>
+            Protections;
+        for (auto &KV : Segments) {
+          auto &S = KV.second;
+          if (S.ContentSize != 0)
+            Writes.push_back(DirectBufferWriter(WorkingMem.get() + S.Offset,
+                                                RemoteAddr + S.Offset,
+                                                S.ContentSize));
+          if (S.Size != 0)
+            Protections.push_back(
+                std::make_tuple(RemoteAddr + S.Offset, S.Size, KV.first));
+        }
+
+        Error Err = Client.callB<mem::FinalizeMem>(Id, Writes, Protections);
+        WorkingMem.reset();
+        OnFinalize(std::move(Err));
+      }
+
+      Error deallocate() override {
+        Error Err = Client.callB<mem::DestroyRemoteAllocator>(Id);
+        if (!Err)
+          Client.AllocatorIds.release(Id);
+        return Err;
+      }
+
+    private:
+      OrcRemoteTargetClient &Client;
+      ResourceIdMgr::ResourceId Id;
+      JITTargetAddress RemoteAddr;
+      std::unique_ptr<char[]> WorkingMem;
+      DenseMap<unsigned, Segment> Segments;
+    };
+
+    OrcRemoteTargetClient &Client;
+  };
+
+  /// A JITDylib definition generator that looks up symbols in the remote
+  /// process. The symbols requested by one lookup are resolved with a single
+  /// RPC call.
+  class RemoteSymbolGenerator : public JITDylib::DefinitionGenerator {
+  public:
+    /// Create a generator that strips the given global prefix from symbol
+    /// names before looking them up, and ignores symbols without it. A
+    /// GlobalPrefix of '\0' means that symbols have no global prefix.
+    RemoteSymbolGenerator(OrcRemoteTargetClient &Client, char GlobalPrefix)
+        : Client(Client), GlobalPrefix(GlobalPrefix) {}
+
+    Expected<SymbolNameSet> tryToGenerate(JITDylib &JD,
+                                          const SymbolNameSet &Names) override {
+      bool HasGlobalPrefix = (GlobalPrefix != '\0');
+      std::vector<SymbolStringPtr> Requested;
+      std::vector<std::string> RemoteNames;
+
+      for (auto &Name : Names) {
+        if ((*Name).empty())
+          continue;
+        if (HasGlobalPrefix && (*Name).front() != GlobalPrefix)
+          continue;
+        Requested.push_back(Name);
+        RemoteNames.push_back((*Name).drop_front(HasGlobalPrefix).str());
+      }
+
+      if (Requested.empty())
+        return SymbolNameSet();
+
+      auto Addrs = Client.lookupSymbols(RemoteNames);
+      if (!Addrs)
+        return Addrs.takeError();
+      if (Addrs->size() != Requested.size())
+        return make_error<StringError>("Remote returned the wrong number of "
+                                       "symbol addresses",
+                                       inconvertibleErrorCode());
+
+      SymbolNameSet Added;
+      SymbolMap NewSymbols;
+      for (size_t I = 0, E = Requested.size(); I != E; ++I) {
+        if (JITTargetAddress Addr = (*Addrs)[I]) {
+          Added.insert(Requested[I]);
+          NewSymbols[Requested[I]] =
+              JITEvaluatedSymbol(Addr, JITSymbolFlags::Exported);
+        }
+      }
+
+      // The generator is only called for symbols that are not defined yet,
+      // so this cannot fail.
+      if (!NewSymbols.empty())
+        cantFail(JD.define(absoluteSymbols(std::move(NewSymbols))));
+
+      return Added;
+    }
+
+  private:
+    OrcRemoteTargetClient &Client;
+    char GlobalPrefix;
+  };
+
   /// Remote indirect stubs manager.
   class RemoteIndirectStubsManager : public IndirectStubsManager {
   public:
@@ -546,6 +744,13 @@ public:
         new RemoteRTDyldMemoryManager(*this, Id));
   }
 
+  /// Create a JITLinkMemoryManager which will allocate its memory on the
+  /// remote target.
+  std::unique_ptr<RemoteJITLinkMemoryManager>
+  createRemoteJITLinkMemoryManager() {
+    return std::make_unique<RemoteJITLinkMemoryManager>(*this);
+  }
+
   /// Create an RCIndirectStubsManager that will allocate stubs on the remote
   /// target.
   Expected<std::unique_ptr<RemoteIndirectStubsManager>>
@@ -577,6 +782,13 @@ public:
     return callB<utils::GetSymbolAddress>(Name);
   }
 
+  /// Search for several symbols in the remote process with a single RPC call.
+  /// The address of each symbol that was not found is zero.
+  Expected<std::vector<JITTargetAddress>>
+  lookupSymbols(const std::vector<std::string> &Names) {
+    return callB<utils::LookupSymbols>(Names);
+  }
+
   /// Get the triple for the remote target.
   const std::string &getTargetTriple() const { return RemoteTargetTriple; }
 
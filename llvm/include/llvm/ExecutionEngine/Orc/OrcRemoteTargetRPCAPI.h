@@ -234,6 +234,21 @@ namespace mem {
     static const char *getName() { return "DestroyRemoteAllocator"; }
   };
 
+  /// Write the given buffers, then set the protections of the given
+  /// (address, size, flags) ranges. All ranges must lie within memory
+  /// reserved via the given allocator. This does all the work of finalizing
+  /// a JITLink allocation in one call.
+  class FinalizeMem
+      : public rpc::Function<
+            FinalizeMem,
+            void(ResourceIdMgr::ResourceId AllocID,
+                 std::vector<remote::DirectBufferWriter> Writes,
+                 std::vector<std::tuple<JITTargetAddress, uint64_t, uint32_t>>
+                     Protections)> {
+  public:
+    static const char *getName() { return "FinalizeMem"; }
+  };
+
   /// Read a remote memory block.
   class ReadMem
       : public rpc::Function<ReadMem, std::vector<uint8_t>(JITTargetAddress Src,
@@ -343,6 +358,16 @@ namespace utils {
     static const char *getName() { return "GetSymbolAddress"; }
   };
 
+  /// Get the addresses of several remote symbols, or zero for the symbols
+  /// that were not found.
+  class LookupSymbols
+      : public rpc::Function<LookupSymbols,
+                             std::vector<JITTargetAddress>(
+                                 std::vector<std::string> Names)> {
+  public:
+    static const char *getName() { return "LookupSymbols"; }
+  };
+
   /// Request that the host execute a compile callback.
   class RequestCompile
       : public rpc::Function<
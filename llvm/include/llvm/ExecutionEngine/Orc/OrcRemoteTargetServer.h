@@ -68,6 +68,7 @@ public:
                                            &ThisT::handleCreateRemoteAllocator);
     addHandler<mem::DestroyRemoteAllocator>(
         *this, &ThisT::handleDestroyRemoteAllocator);
+    addHandler<mem::FinalizeMem>(*this, &ThisT::handleFinalizeMem);
     addHandler<mem::ReadMem>(*this, &ThisT::handleReadMem);
     addHandler<mem::ReserveMem>(*this, &ThisT::handleReserveMem);
     addHandler<mem::SetProtections>(*this, &ThisT::handleSetProtections);
@@ -87,6 +88,7 @@ public:
                                            &ThisT::handleEmitTrampolineBlock);
     addHandler<utils::GetSymbolAddress>(*this, &ThisT::handleGetSymbolAddress);
     addHandler<utils::GetRemoteInfo>(*this, &ThisT::handleGetRemoteInfo);
+    addHandler<utils::LookupSymbols>(*this, &ThisT::handleLookupSymbols);
     addHandler<utils::TerminateSession>(*this, &ThisT::handleTerminateSession);
   }
 
@@ -139,6 +141,22 @@ private:
           sys::Memory::protectMappedMemory(I->second, Flags));
     }
 
+    Error setProtections(void *Addr, uint64_t Size, unsigned Flags) {
+      // Find the allocation containing the range.
+      auto I = Allocs.upper_bound(Addr);
+      if (I == Allocs.begin())
+        return errorCodeToError(
+            orcError(OrcErrorCode::RemoteMProtectAddrUnrecognized));
+      --I;
+      char *Base = static_cast<char *>(I->second.base());
+      char *Start = static_cast<char *>(Addr);
+      if (Start + Size > Base + I->second.allocatedSize())
+        return errorCodeToError(
+            orcError(OrcErrorCode::RemoteMProtectAddrUnrecognized));
+      return errorCodeToError(sys::Memory::protectMappedMemory(
+          sys::MemoryBlock(Addr, Size), Flags));
+    }
+
   private:
     std::map<void *, sys::MemoryBlock> Allocs;
   };
@@ -242,6 +260,38 @@ private:
     return Error::success();
   }
 
+  Error handleFinalizeMem(
+      ResourceIdMgr::ResourceId Id, std::vector<DirectBufferWriter> Writes,
+      std::vector<std::tuple<JITTargetAddress, uint64_t, uint32_t>>
+          Protections) {
+    auto I = Allocators.find(Id);
+    if (I == Allocators.end())
+      return errorCodeToError(
+               orcError(OrcErrorCode::RemoteAllocatorDoesNotExist));
+    auto &Allocator = I->second;
+
+    // The buffers were written to their destinations as they were received.
+    LLVM_DEBUG(dbgs() << "  Allocator " << Id << " wrote " << Writes.size()
+                      << " buffers\n");
+
+    for (auto &P : Protections) {
+      JITTargetAddress Addr;
+      uint64_t Size;
+      uint32_t Flags;
+      std::tie(Addr, Size, Flags) = P;
+      void *LocalAddr = reinterpret_cast<void *>(static_cast<uintptr_t>(Addr));
+      LLVM_DEBUG(dbgs() << "  Allocator " << Id << " set permissions on "
+                        << LocalAddr << " (" << Size << " bytes) to "
+                        << (Flags & sys::Memory::MF_READ ? 'R' : '-')
+                        << (Flags & sys::Memory::MF_WRITE ? 'W' : '-')
+                        << (Flags & sys::Memory::MF_EXEC ? 'X' : '-') << "\n");
+      if (auto Err = Allocator.setProtections(LocalAddr, Size, Flags))
+        return Err;
+    }
+
+    return Error::success();
+  }
+
   Error handleDestroyIndirectStubsOwner(ResourceIdMgr::ResourceId Id) {
     auto I = IndirectStubsOwners.find(Id);
     if (I == IndirectStubsOwners.end())
@@ -349,6 +399,18 @@ private:
                            IndirectStubSize);
   }
 
+  Expected<std::vector<JITTargetAddress>>
+  handleLookupSymbols(const std::vector<std::string> &Names) {
+    std::vector<JITTargetAddress> Addrs;
+    Addrs.reserve(Names.size());
+    for (auto &Name : Names) {
+      Addrs.push_back(SymbolLookup(Name));
+      LLVM_DEBUG(dbgs() << "  Symbol '" << Name
+                        << "' =  " << format("0x%016x", Addrs.back()) << "\n");
+    }
+    return Addrs;
+  }
+
   Expected<std::vector<uint8_t>> handleReadMem(JITTargetAddress RSrc,
                                                uint64_t Size) {
     uint8_t *Src = reinterpret_cast<uint8_t *>(static_cast<uintptr_t>(RSrc));
@@ -0,0 +1,81 @@
+//===- PersistentObjectCache.h - On-disk cache of JIT objects -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that persists the objects compiled by the JIT on disk.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Error.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+class JITTargetMachineBuilder;
+
+/// An ObjectCache that keeps the objects compiled from IR modules in a
+/// directory, so that they can be reused by later JIT sessions and shared
+/// between processes.
+///
+/// Entries are keyed on a hash of the module's bitcode, the LLVM version and
+/// the target description of the JITTargetMachineBuilder: triple, CPU,
+/// subtarget features, relocation and code model, and CodeGen optimization
+/// level. TargetOptions other than EmulatedTLS are not part of the key, so
+/// clients that vary them should use distinct cache directories.
+///
+/// Entries are written to a temporary file that is then renamed into place, so
+/// readers never see a partially written entry and concurrent writers of the
+/// same entry are harmless. The directory is pruned according to the given
+/// CachePruningPolicy when the cache is created.
+///
+/// One instance may be shared by several compile threads, e.g. through a
+/// ConcurrentIRCompiler.
+class PersistentObjectCache : public ObjectCache {
+public:
+  /// Create a cache in the given directory, creating the directory if it does
+  /// not exist yet.
+  static Expected<std::unique_ptr<PersistentObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB,
+         CachePruningPolicy Policy = CachePruningPolicy());
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+  /// Prune the cache directory according to the cache's pruning policy.
+  void prune();
+
+private:
+  PersistentObjectCache(std::string CacheDir, std::string TargetKey,
+                        CachePruningPolicy Policy);
+
+  std::string getEntryPath(const Module &M) const;
+
+  std::string CacheDir;
+  std::string TargetKey;
+  CachePruningPolicy Policy;
+
+  // The entry paths of the modules that missed in getObject, by module. They
+  // are computed before compilation because CodeGen modifies the module.
+  std::mutex PendingEntriesMutex;
+  DenseMap<const Module *, std::string> PendingEntries;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
@@ -0,0 +1,84 @@
+//===- TieredCompileLayer.h - Recompile hot functions -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Contains the TieredCompileLayer, which counts the calls to JIT'd functions
+// and recompiles the hot ones with a second, optimizing layer.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+
+#include "llvm/ExecutionEngine/Orc/Core.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace orc {
+
+/// An IR layer that implements tiered compilation.
+///
+/// Modules are emitted through the tier-0 layer, which is typically set up to
+/// compile quickly at a low optimization level, with a call counter at the
+/// entry of each function. The first time a function reaches TierUpThreshold
+/// calls, a copy of its original IR is added to the tier-1 layer, which is
+/// typically set up to optimize, as <function>$tier1. NotifyTierUp is called
+/// with the tier-1 address once it is ready, and should repoint the stub that
+/// callers go through (see CompileOnDemandLayer::updateStubPointer).
+///
+/// The tier-1 lookup is asynchronous: if the ExecutionSession dispatches
+/// materialization to other threads, the function keeps running its tier-0
+/// code until its tier-1 code has been compiled.
+///
+/// The call counters call directly into this layer, so the JIT'd code must run
+/// in the JIT process. Functions in modules that define local variables are not
+/// tiered, since their tier-1 copies would get their own copies of these.
+class TieredCompileLayer : public IRLayer {
+public:
+  using NotifyTierUpFunction =
+      std::function<Error(JITDylib &JD, const SymbolStringPtr &Name,
+                          JITTargetAddress Tier1Addr)>;
+
+  TieredCompileLayer(ExecutionSession &ES, IRLayer &Tier0Layer,
+                     IRLayer &Tier1Layer, unsigned TierUpThreshold,
+                     NotifyTierUpFunction NotifyTierUp);
+
+  void emit(MaterializationResponsibility R, ThreadSafeModule TSM) override;
+
+private:
+  struct TierUpCandidate {
+    // The original IR of the function's module. Reset when the function is
+    // tiered up.
+    std::shared_ptr<ThreadSafeModule> Source;
+    JITDylib *JD;
+    std::string FunctionName;
+    SymbolStringPtr Name;
+  };
+
+  static void tierUpEntryPoint(TieredCompileLayer *Layer, uint64_t Id);
+  void tierUp(uint64_t Id);
+
+  IRLayer &Tier0Layer;
+  IRLayer &Tier1Layer;
+  unsigned TierUpThreshold;
+  NotifyTierUpFunction NotifyTierUp;
+
+  std::mutex CandidatesMutex;
+  std::vector<TierUpCandidate> Candidates;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
@@ -245,24 +245,26 @@ public:
 
   /// Returns the ordering constraint of this load instruction.
   AtomicOrdering getOrdering() const {
-    return AtomicOrdering((getSubclassDataFromInstruction() >> 7) & 7);
+    return AtomicOrdering((getSubclassDataFromInstruction() >> 6) & 7);
   }
 
   /// Sets the ordering constraint of this load instruction.  May not be Release
   /// or AcquireRelease.
   void setOrdering(AtomicOrdering Ordering) {
-    setInstructionSubclassData((getSubclassDataFromInstruction() & ~(7 << 7)) |
-                               ((unsigned)Ordering << 7));
+    setInstructionSubclassData((getSubclassDataFromInstruction() & ~(7 << 6)) |
+                               ((unsigned)Ordering << 6));
   }
 
   /// Returns the synchronization scope ID of this load instruction.
   SyncScope::ID getSyncScopeID() const {
-    return SSID;
+    return SyncScope::ID(getSubclassDataFromInstruction() >> 9);
   }
 
   /// Sets the synchronization scope ID of this load instruction.
   void setSyncScopeID(SyncScope::ID SSID) {
-    this->SSID = SSID;
+    assert(SSID < SyncScope::MaxNumScopes && "Invalid synchronization scope");
+    setInstructionSubclassData((getSubclassDataFromInstruction() & ~(63 << 9)) |
+                               ((unsigned)SSID << 9));
   }
 
   /// Sets the ordering constraint and the synchronization scope ID of this load
@@ -305,11 +307,6 @@ private:
   void setInstructionSubclassData(unsigned short D) {
     Instruction::setInstructionSubclassData(D);
   }
-
-  /// The synchronization scope ID of this load instruction.  Not quite enough
-  /// room in SubClassData for everything, so synchronization scope ID gets its
-  /// own field.
-  SyncScope::ID SSID;
 };
 
 //===----------------------------------------------------------------------===//
@@ -370,24 +367,26 @@ public:
 
   /// Returns the ordering constraint of this store instruction.
   AtomicOrdering getOrdering() const {
-    return AtomicOrdering((getSubclassDataFromInstruction() >> 7) & 7);
+    return AtomicOrdering((getSubclassDataFromInstruction() >> 6) & 7);
   }
 
   /// Sets the ordering constraint of this store instruction.  May not be
   /// Acquire or AcquireRelease.
   void setOrdering(AtomicOrdering Ordering) {
-    setInstructionSubclassData((getSubclassDataFromInstruction() & ~(7 << 7)) |
-                               ((unsigned)Ordering << 7));
+    setInstructionSubclassData((getSubclassDataFromInstruction() & ~(7 << 6)) |
+                               ((unsigned)Ordering << 6));
   }
 
   /// Returns the synchronization scope ID of this store instruction.
   SyncScope::ID getSyncScopeID() const {
-    return SSID;
+    return SyncScope::ID(getSubclassDataFromInstruction() >> 9);
   }
 
   /// Sets the synchronization scope ID of this store instruction.
   void setSyncScopeID(SyncScope::ID SSID) {
-    this->SSID = SSID;
+    assert(SSID < SyncScope::MaxNumScopes && "Invalid synchronization scope");
+    setInstructionSubclassData((getSubclassDataFromInstruction() & ~(63 << 9)) |
+                               ((unsigned)SSID << 9));
   }
 
   /// Sets the ordering constraint and the synchronization scope ID of this
@@ -433,11 +432,6 @@ private:
   void setInstructionSubclassData(unsigned short D) {
     Instruction::setInstructionSubclassData(D);
   }
-
-  /// The synchronization scope ID of this store instruction.  Not quite enough
-  /// room in SubClassData for everything, so synchronization scope ID gets its
-  /// own field.
-  SyncScope::ID SSID;
 };
 
 template <>
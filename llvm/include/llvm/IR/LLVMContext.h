@@ -51,7 +51,11 @@ enum {
   SingleThread = 0,
 
   /// Synchronized with respect to all concurrently executing threads.
-  System = 1
+  System = 1,
+
+  /// Number of synchronization scope IDs a context can hold.  Load and store
+  /// instructions keep the ID in six bits of their subclass data.
+  MaxNumScopes = 64
 };
 
 } // end namespace SyncScope
@@ -39,12 +39,14 @@
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassInstrumentation.h"
 #include "llvm/IR/PassManagerInternal.h"
+#include "llvm/IR/ValueHandle.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/TypeName.h"
 #include "llvm/Support/raw_ostream.h"
@@ -438,6 +440,38 @@ getAnalysisResult(AnalysisManager<IRUnitT, AnalysisArgTs...> &AM, IRUnitT &IR,
                            std::index_sequence_for<AnalysisArgTs...>{});
 }
 
+/// Keeps the CFG analyses of a pass that did not change the CFG.
+///
+/// Passes often return \c PreservedAnalyses::none() although they only changed
+/// instructions, or nothing at all, which forces the dominator tree and loop
+/// info to be recomputed. When -preserve-unchanged-cfg-analyses is given, the
+/// function pass manager records the basic blocks and successors of a function
+/// before each pass and marks \c CFGAnalyses as preserved if they are the same
+/// afterwards. Blocks are held through value handles, so that a block deleted
+/// by the pass is not mistaken for a new block allocated at its address. This
+/// relies on passes not caching an analysis of a CFG they change and then
+/// change back, which would not be a sensible thing to do.
+///
+/// The primary template does nothing; it covers all units of IR but functions.
+template <typename IRUnitT> class CFGChangeTracker {
+public:
+  explicit CFGChangeTracker(IRUnitT &) {}
+  void preserveCFGIfUnchanged(IRUnitT &, PreservedAnalyses &) {}
+};
+
+template <> class CFGChangeTracker<Function> {
+public:
+  explicit CFGChangeTracker(Function &F);
+  void preserveCFGIfUnchanged(Function &F, PreservedAnalyses &PA);
+
+private:
+  /// The blocks of the function, in order; deleted blocks become null.
+  SmallVector<WeakVH, 16> Blocks;
+  /// Each block followed by its successors and a null terminator, in order.
+  SmallVector<const BasicBlock *, 32> CFG;
+  bool Enabled;
+};
+
 } // namespace detail
 
 // Forward declare the pass instrumentation analysis explicitly queried in
@@ -512,7 +546,9 @@ public:
       if (!PI.runBeforePass<IRUnitT>(*P, IR))
         continue;
 
+      detail::CFGChangeTracker<IRUnitT> CFGTracker(IR);
       PreservedAnalyses PassPA = P->run(IR, AM, ExtraArgs...);
+      CFGTracker.preserveCFGIfUnchanged(IR, PassPA);
 
       // Call onto PassInstrumentation's AfterPass callbacks immediately after
       // running the pass.
@@ -51,6 +51,10 @@ public:
   Error setFilter(StringRef Filter);
   /// Emit a diagnostic through the streamer.
   void emit(const DiagnosticInfoOptimizationBase &Diag);
+  /// Emit what the serializer can only emit once all the remarks are known.
+  /// This needs to be called before the remark file is closed, and no remark
+  /// can be emitted after.
+  void finalize() { RemarkSerializer->finalize(); }
 };
 
 template <typename ThisError>
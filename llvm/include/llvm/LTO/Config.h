@@ -88,6 +88,12 @@ struct Config {
   /// The directory to store .dwo files.
   std::string DwoDir;
 
+  /// If not empty, ThinLTO backends cache the native object of each module in
+  /// this directory after optimization, keyed by the contents of the
+  /// optimized module. Jobs whose inputs changed but whose optimized IR did
+  /// not then skip code generation.
+  std::string CodeGenCacheDir;
+
   /// The name for the split debug info file used for the DW_AT_[GNU_]dwo_name
   /// attribute in the skeleton CU. This should generally only be used when
   /// running an individual backend directly via thinBackend(), as otherwise
@@ -108,6 +114,10 @@ struct Config {
   /// Whether to emit optimization remarks with hotness informations.
   bool RemarksWithHotness = false;
 
+  /// The minimum hotness value a remark needs to be emitted. Remarks below it
+  /// are dropped before they reach the serializer.
+  unsigned RemarksHotnessThreshold = 0;
+
   /// The format used for serializing remarks (default: YAML).
   std::string RemarksFormat = "";
 
@@ -117,6 +127,13 @@ struct Config {
   /// Statistics output file path.
   std::string StatsFile;
 
+  /// Whether the ThinLTO backend threads record time trace sections. The
+  /// caller must have initialized the time trace profiler of its own thread.
+  bool TimeTraceEnabled = false;
+
+  /// Time trace granularity of the backend threads (in microseconds).
+  unsigned TimeTraceGranularity = 500;
+
   bool ShouldDiscardValueNames = true;
   DiagnosticHandlerFunction DiagHandler;
 
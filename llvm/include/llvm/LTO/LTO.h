@@ -76,6 +76,12 @@ void computeLTOCacheKey(
     const std::set<GlobalValue::GUID> &CfiFunctionDefs = {},
     const std::set<GlobalValue::GUID> &CfiFunctionDecls = {});
 
+/// Computes a unique hash for the native object of \p M, an optimized module
+/// that is ready for code generation. This keys the code generation cache
+/// selected by Config::CodeGenCacheDir. The hash is produced in \p Key.
+void computeLTOCodeGenCacheKey(SmallString<40> &Key, const lto::Config &Conf,
+                               const Module &M);
+
 namespace lto {
 
 /// Given the original \p Path to an output file, replace any path
@@ -85,11 +91,14 @@ std::string getThinLTOOutputFile(const std::string &Path,
                                  const std::string &OldPrefix,
                                  const std::string &NewPrefix);
 
-/// Setup optimization remarks.
+/// Setup optimization remarks. If \p Count is not -1, the remarks of the
+/// ThinLTO backend \p Count are written to a file of their own, with an
+/// extension matching \p RemarksFormat.
 Expected<std::unique_ptr<ToolOutputFile>>
 setupOptimizationRemarks(LLVMContext &Context, StringRef RemarksFilename,
                          StringRef RemarksPasses, StringRef RemarksFormat,
-                         bool RemarksWithHotness, int Count = -1);
+                         bool RemarksWithHotness,
+                         unsigned RemarksHotnessThreshold, int Count = -1);
 
 /// Setups the output file for saving statistics.
 Expected<std::unique_ptr<ToolOutputFile>>
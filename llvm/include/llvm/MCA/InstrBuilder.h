@@ -21,6 +21,7 @@
 #include "llvm/MCA/Instruction.h"
 #include "llvm/MCA/Support.h"
 #include "llvm/Support/Error.h"
+#include <mutex>
 
 namespace llvm {
 namespace mca {
@@ -35,6 +36,9 @@ namespace mca {
 /// descriptors (i.e. InstrDesc objects).
 /// Information from the machine scheduling model is used to identify processor
 /// resources that are consumed by an instruction.
+///
+/// Instructions can be created from several threads at once, so that the code
+/// regions of a file are simulated in parallel while sharing the descriptors.
 class InstrBuilder {
   const MCSubtargetInfo &STI;
   const MCInstrInfo &MCII;
@@ -44,6 +48,9 @@ class InstrBuilder {
 
   DenseMap<unsigned short, std::unique_ptr<const InstrDesc>> Descriptors;
   DenseMap<const MCInst *, std::unique_ptr<const InstrDesc>> VariantDescriptors;
+  // Guards the descriptors and the warnings below. Descriptors are never
+  // removed while instructions are created, so they can be used unlocked.
+  std::mutex Lock;
 
   bool FirstCallInst;
   bool FirstReturnInst;
@@ -62,6 +69,8 @@ public:
   InstrBuilder(const MCSubtargetInfo &STI, const MCInstrInfo &MCII,
                const MCRegisterInfo &RI, const MCInstrAnalysis *IA);
 
+  /// Drop the descriptors of variant instructions. Must not be called while
+  /// instructions are being created.
   void clear() {
     VariantDescriptors.shrink_and_clear();
     FirstCallInst = true;
@@ -10,12 +10,17 @@
 /// code sequence (a sequence of MCInst), and assings unique identifiers to
 /// every instruction in the sequence.
 ///
+/// The sequence is the body of a loop, which is repeated for a number of
+/// iterations. The body may contain forward branches, which skip over part of
+/// it in some of the iterations.
+///
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_MCA_SOURCEMGR_H
 #define LLVM_MCA_SOURCEMGR_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/MCA/Instruction.h"
 
 namespace llvm {
@@ -25,6 +30,15 @@ namespace mca {
 // prevent compiler error C2139 about intrinsic type trait '__is_assignable'.
 typedef std::pair<unsigned, const Instruction &> SourceRef;
 
+/// A forward branch in the sequence, from the instruction at \p Index to the
+/// one at \p Target. It is taken in \p TakenPercent percent of the
+/// iterations, spread evenly over them, starting with a not taken one.
+struct BranchInfo {
+  unsigned Index;
+  unsigned Target;
+  unsigned TakenPercent;
+};
+
 class SourceMgr {
   using UniqueInst = std::unique_ptr<Instruction>;
   ArrayRef<UniqueInst> Sequence;
@@ -32,14 +46,42 @@ class SourceMgr {
   const unsigned Iterations;
   static const unsigned DefaultIterations = 100;
 
+  // For every instruction of the sequence, the branch it is, if any. These
+  // point into the branches given to the constructor, which must outlive the
+  // SourceMgr, as the sequence does.
+  SmallVector<const BranchInfo *, 0> Branches;
+
 public:
-  SourceMgr(ArrayRef<UniqueInst> S, unsigned Iter)
-      : Sequence(S), Current(0), Iterations(Iter ? Iter : DefaultIterations) {}
+  SourceMgr(ArrayRef<UniqueInst> S, unsigned Iter,
+            ArrayRef<BranchInfo> B = None)
+      : Sequence(S), Current(0), Iterations(Iter ? Iter : DefaultIterations) {
+    if (B.empty())
+      return;
+    Branches.resize(Sequence.size());
+    for (const BranchInfo &BI : B) {
+      assert(BI.Index < BI.Target && BI.Target <= Sequence.size() &&
+             "Only forward branches within the sequence are supported!");
+      Branches[BI.Index] = &BI;
+    }
+  }
 
   unsigned getNumIterations() const { return Iterations; }
   unsigned size() const { return Sequence.size(); }
   bool hasNext() const { return Current < (Iterations * Sequence.size()); }
-  void updateNext() { ++Current; }
+
+  void updateNext() {
+    unsigned Index = Current % Sequence.size();
+    unsigned Iteration = Current / Sequence.size();
+    ++Current;
+    if (Branches.empty() || !Branches[Index])
+      return;
+    // Skip to the target of a taken branch. Instructions keep the identifier
+    // of their position in the sequence, so the views can tell them apart.
+    const BranchInfo &BI = *Branches[Index];
+    if ((Iteration + 1) * BI.TakenPercent / 100 !=
+        Iteration * BI.TakenPercent / 100)
+      Current = Iteration * Sequence.size() + BI.Target;
+  }
 
   SourceRef peekNext() const {
     assert(hasNext() && "Already at end of sequence!");
@@ -151,6 +151,31 @@ inline StringRef getInstrProfRuntimeHookVarName() {
   return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_RUNTIME_VAR);
 }
 
+/// Return the name of the thread-local countdown of sampled counter updates
+/// defined in profile runtime library.
+inline StringRef getInstrProfSamplingCountdownVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_SAMPLING_COUNTDOWN_VAR);
+}
+
+/// Return the name of the sampling period variable defined in profile runtime
+/// library.
+inline StringRef getInstrProfSamplingPeriodVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_SAMPLING_PERIOD_VAR);
+}
+
+/// Return the name of the thread-local variable defined in profile runtime
+/// library that holds the offset from the profile counters to the counters of
+/// the current thread.
+inline StringRef getInstrProfThreadCountersDeltaVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_THREAD_COUNTERS_DELTA_VAR);
+}
+
+/// Return the name of the runtime function that allocates the counters of the
+/// current thread and returns their offset from the profile counters.
+inline StringRef getInstrProfThreadCountersInitFuncName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_THREAD_COUNTERS_INIT_FUNC);
+}
+
 /// Return the name of the compiler generated function that references the
 /// runtime hook variable. The function is a weak global.
 inline StringRef getInstrProfRuntimeHookVarUseFuncName() {
@@ -1095,7 +1120,9 @@ namespace RawInstrProf {
 // Version 4: ValueDataBegin and ValueDataSizes fields are removed from the
 // raw header.
 // Version 5: Bit 60 of FuncHash is reserved for the flag for the context
-// sensitive records.
+// sensitive records. The raw header gains the PaddingBytesBeforeCounters and
+// PaddingBytesAfterCounters fields, which page-align the counter section in
+// continuous mode.
 const uint64_t Version = INSTR_PROF_RAW_VERSION;
 
 template <class IntPtrT> inline uint64_t getMagic();
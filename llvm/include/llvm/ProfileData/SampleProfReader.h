@@ -467,7 +467,8 @@ public:
 /// attributes. The format in each section is defined by the section itself.
 ///
 /// It is easy to add a new section while maintaining the backward
-/// compatibility of the profile. Nothing extra needs to be done. If we want
+/// compatibility of the profile. Nothing extra needs to be done, readers skip
+/// the sections they do not know. If we want
 /// to extend an existing section, like add cache misses information in
 /// addition to the sample count in the profile body, we can add a new section
 /// with the extension and retire the existing section, and we could choose
@@ -504,6 +505,16 @@ private:
   virtual std::error_code readOneSection(const uint8_t *Start, uint64_t Size,
                                          SecType Type) override;
   std::error_code readProfileSymbolList();
+  std::error_code readFuncOffsetTable();
+  std::error_code readFuncProfiles(const uint8_t *Start, uint64_t Size);
+
+  /// The table mapping from function name to the offset of its FunctionSample
+  /// towards the start of the SecLBRProfile section.
+  DenseMap<StringRef, uint64_t> FuncOffsetTable;
+  /// The set containing the functions to use when compiling a module.
+  DenseSet<StringRef> FuncsToUse;
+  /// Use all functions from the input profile.
+  bool UseAllFuncs = true;
 
 public:
   SampleProfileReaderExtBinary(std::unique_ptr<MemoryBuffer> B, LLVMContext &C,
@@ -516,6 +527,10 @@ public:
   virtual std::unique_ptr<ProfileSymbolList> getProfileSymbolList() override {
     return std::move(ProfSymList);
   };
+
+  /// Collect functions to be used when compiling Module \p M. If the profile
+  /// has a SecFuncOffsetTable section, only their profiles are read.
+  void collectFuncsToUse(const Module &M) override;
 };
 
 class SampleProfileReaderCompactBinary : public SampleProfileReaderBinary {
@@ -182,14 +182,25 @@ public:
     ProfSymList = PSL;
   };
 
+  virtual std::error_code writeSample(const FunctionSamples &S) override;
+
 private:
+  // SecFuncOffsetTable is written after SecLBRProfile, but the reader needs to
+  // see it before.
   virtual void initSectionLayout() override {
-    SectionLayout = {SecProfSummary, SecNameTable, SecLBRProfile,
-                     SecProfileSymbolList};
+    SectionLayout = {SecProfSummary, SecNameTable, SecFuncOffsetTable,
+                     SecLBRProfile, SecProfileSymbolList};
   };
   virtual std::error_code
   writeSections(const StringMap<FunctionSamples> &ProfileMap) override;
+  std::error_code writeFuncOffsetTable();
   ProfileSymbolList *ProfSymList = nullptr;
+
+  /// The start of the SecLBRProfile section in the output stream.
+  uint64_t SecLBRProfileStart = 0;
+  /// The table mapping from function name to the offset of its FunctionSample
+  /// towards the start of the SecLBRProfile section.
+  MapVector<StringRef, uint64_t> FuncOffsetTable;
 };
 
 // CompactBinary is a compact format of binary profile which both reduces
@@ -43,6 +43,9 @@ enum class BitstreamRemarkContainerType {
   /// This will contain the following:
   /// * Container version and type
   /// * Remark version
+  /// and, once the remarks are emitted, a second metadata block with:
+  /// * String table
+  /// so that the file can be read without the separate metadata.
   SeparateRemarksFile,
   /// Everything is emitted together.
   /// This will contain the following:
@@ -37,6 +37,7 @@ namespace remarks {
 ///                         | Remark1
 ///                         | Remark2
 ///                         | ...
+///                         | String table (on finalize())
 ///
 /// * The standalone model: | Container info
 ///                         | String table
@@ -110,6 +111,9 @@ struct BitstreamRemarkSerializerHelper {
 
   /// Emit a remark block. The string table is required.
   void emitRemarkBlock(const Remark &Remark, StringTable &StrTab);
+  /// Emit the metadata block that follows the remarks of a separate remark
+  /// file, holding the string table they use.
+  void emitTrailingMetaBlock(const StringTable &StrTab);
   /// Finalize the writing to \p OS.
   void flushToStream(raw_ostream &OS);
   /// Finalize the writing to a buffer.
@@ -142,6 +146,9 @@ struct BitstreamRemarkSerializer : public RemarkSerializer {
   /// the remarks based on the SerializerMode specified at construction.
   /// This writes the serialized output to the provided stream.
   void emit(const Remark &Remark) override;
+  /// In the separate mode, emit the string table after the remarks, so that
+  /// the remark file doesn't depend on the metadata emitted elsewhere.
+  void finalize() override;
   /// The metadata serializer associated to this remark serializer. Based on the
   /// container type of the current serializer, the container type of the
   /// metadata serializer will change.
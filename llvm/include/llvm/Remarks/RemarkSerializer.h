@@ -51,6 +51,9 @@ struct RemarkSerializer {
   virtual ~RemarkSerializer() = default;
   /// Emit a remark to the stream.
   virtual void emit(const Remark &Remark) = 0;
+  /// Emit what can only be emitted once all the remarks are known, like the
+  /// string table of a separate remark file. No remark can be emitted after.
+  virtual void finalize() {}
   /// Return the corresponding metadata serializer.
   virtual std::unique_ptr<MetaSerializer>
   metaSerializer(raw_ostream &OS,
@@ -0,0 +1,64 @@
+//===- llvm/Support/AsyncFileReader.h - Read files ahead of use -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares AsyncFileReader, which opens files and brings their
+// contents into memory on a thread pool, so that tools which know the whole
+// set of their inputs up front don't pay for one synchronous read at a time.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_ASYNCFILEREADER_H
+#define LLVM_SUPPORT_ASYNCFILEREADER_H
+
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
+#include <future>
+#include <memory>
+
+namespace llvm {
+
+/// Reads files in the background.
+///
+/// Each call to read() queues a job that opens the file with
+/// MemoryBuffer::getFile and faults its pages in, so that the I/O of several
+/// inputs overlaps and the consumer finds the data resident once it asks for
+/// it. When LLVM is built without thread support the file is read
+/// synchronously.
+class AsyncFileReader {
+public:
+  using ResultTy = ErrorOr<std::unique_ptr<MemoryBuffer>>;
+
+  /// Construct a reader with the number of threads found by
+  /// hardware_concurrency().
+  AsyncFileReader() = default;
+
+  /// Construct a reader using \p ThreadCount threads.
+  explicit AsyncFileReader(unsigned ThreadCount) : Pool(ThreadCount) {}
+
+  /// Blocks until all pending reads have finished.
+  ~AsyncFileReader();
+
+  /// Start reading \p Filename. The arguments have the same meaning as for
+  /// MemoryBuffer::getFile. The returned future holds the buffer, or the error
+  /// that occurred while opening the file.
+  std::future<ResultTy> read(const Twine &Filename,
+                             bool RequiresNullTerminator = true,
+                             bool IsVolatile = false);
+
+  /// Blocks until all pending reads have finished.
+  void wait();
+
+private:
+  ThreadPool Pool;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_ASYNCFILEREADER_H
@@ -13,12 +13,13 @@
 #ifndef LLVM_SUPPORT_COMPRESSION_H
 #define LLVM_SUPPORT_COMPRESSION_H
 
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/DataTypes.h"
 
 namespace llvm {
-template <typename T> class SmallVectorImpl;
 class Error;
 class StringRef;
+class raw_ostream;
 
 namespace zlib {
 
@@ -43,6 +44,77 @@ uint32_t crc32(StringRef Buffer);
 
 }  // End of namespace zlib
 
+namespace zstd {
+
+static constexpr int NoCompression = -5;
+static constexpr int BestSpeedCompression = 1;
+static constexpr int DefaultCompression = 3;
+static constexpr int BestSizeCompression = 19;
+
+bool isAvailable();
+
+/// Compress \p InputBuffer into a single zstd frame. If \p Threads is greater
+/// than one and the zstd library was built with multithreading support, large
+/// inputs are compressed by that many threads in parallel.
+Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
+               int Level = DefaultCompression, unsigned Threads = 1);
+
+Error uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                 size_t &UncompressedSize);
+
+Error uncompress(StringRef InputBuffer,
+                 SmallVectorImpl<char> &UncompressedBuffer,
+                 size_t UncompressedSize);
+
+/// Compresses data passed in pieces to write() and writes a single zstd frame
+/// to a stream, without holding all of the input in memory.
+class Compressor {
+public:
+  Compressor(raw_ostream &OS, int Level = DefaultCompression,
+             unsigned Threads = 1);
+  Compressor(const Compressor &) = delete;
+  Compressor &operator=(const Compressor &) = delete;
+  ~Compressor();
+
+  /// Compress \p Data. Output may be buffered until a later call.
+  Error write(StringRef Data);
+
+  /// Write the remaining output and end the frame. Must be called exactly
+  /// once, after the last call to write().
+  Error finish();
+
+private:
+  Error stream(StringRef Data, bool End);
+
+  raw_ostream &OS;
+  void *Ctx;
+  SmallVector<char, 0> OutBuffer;
+};
+
+/// Decompresses zstd frames passed in pieces to write() and writes the
+/// decompressed data to a stream.
+class Decompressor {
+public:
+  Decompressor(raw_ostream &OS);
+  Decompressor(const Decompressor &) = delete;
+  Decompressor &operator=(const Decompressor &) = delete;
+  ~Decompressor();
+
+  /// Decompress the next piece of the compressed input.
+  Error write(StringRef Data);
+
+  /// Check that the input ended at the end of a frame.
+  Error finish();
+
+private:
+  raw_ostream &OS;
+  void *Ctx;
+  SmallVector<char, 0> OutBuffer;
+  bool InFrame = false;
+};
+
+}  // End of namespace zstd
+
 } // End of namespace llvm
 
 #endif
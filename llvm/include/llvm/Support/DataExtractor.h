@@ -521,6 +521,48 @@ public:
   /// state, zero is returned.
   uint64_t getULEB128(Cursor &C) const { return getULEB128(&C.Offset, &C.Err); }
 
+  /// Extract \a count consecutive unsigned LEB128 values from \a *offset_ptr
+  /// into \a dst. This is faster than extracting them one at a time.
+  ///
+  /// @param[in,out] offset_ptr
+  ///     A pointer to an offset within the data that will be advanced
+  ///     past the last value if all values are extracted correctly, and
+  ///     left unmodified otherwise.
+  ///
+  /// @param[out] dst
+  ///     A buffer for at least \a count values.
+  ///
+  /// @param[in] count
+  ///     The number of values to extract.
+  ///
+  /// @param[in,out] Err
+  ///     A pointer to an Error object. Upon return the Error object is set to
+  ///     indicate the result (success/failure) of the function. If the Error
+  ///     object is already set when calling this function, no extraction is
+  ///     performed.
+  ///
+  /// @return
+  ///     \a dst if all values were properly extracted, NULL otherwise.
+  uint64_t *getULEB128(uint64_t *offset_ptr, uint64_t *dst, uint32_t count,
+                       llvm::Error *Err = nullptr) const;
+
+  /// Extract \a Count unsigned LEB128 values from the location given by the
+  /// cursor and store them into the destination vector. The vector is resized
+  /// to fit the extracted values. In case of an extraction error, or if the
+  /// cursor is already in an error state, the destination vector is left
+  /// unchanged and the cursor is placed into an error state.
+  void getULEB128(Cursor &C, SmallVectorImpl<uint64_t> &Dst,
+                  uint32_t Count) const;
+
+  /// Advance \a *offset_ptr past a signed or unsigned LEB128 value without
+  /// decoding it. If the value extends past the end of the data, the offset
+  /// is left unmodified and \a Err is set.
+  void skipLEB128(uint64_t *offset_ptr, llvm::Error *Err = nullptr) const;
+
+  /// Advance the cursor past a signed or unsigned LEB128 value. No-op if the
+  /// cursor is in an error state.
+  void skipLEB128(Cursor &C) const { skipLEB128(&C.Offset, &C.Err); }
+
   /// Advance the Cursor position by the given number of bytes. No-op if the
   /// cursor is in an error state.
   void skip(Cursor &C, uint64_t Length) const;
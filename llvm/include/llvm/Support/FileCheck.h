@@ -21,6 +21,7 @@
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/SourceMgr.h"
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -427,6 +428,16 @@ class FileCheckPattern {
   /// a fixed string to match.
   std::string RegExStr;
 
+  /// The compiled form of RegExStr, or null if the regex can only be built at
+  /// match time because it has substitutions. Shared between the copies of
+  /// the pattern made while building the check strings.
+  std::shared_ptr<Regex> CompiledRegEx;
+
+  /// The longest literal substring that any match of RegExStr must contain,
+  /// or empty if there is none. Used to skip the lines of the input that
+  /// cannot match before running the regex.
+  StringRef RequiredStr;
+
   /// Entries in this vector represent a substitution of a string variable or
   /// an expression in the RegExStr regex at match time. For example, in the
   /// case of a CHECK directive with the pattern "foo[[bar]]baz[[#N+1]]",
@@ -568,6 +579,11 @@ public:
 private:
   bool AddRegExToRegEx(StringRef RS, unsigned &CurParen, SourceMgr &SM);
   void AddBackrefToRegEx(unsigned BackrefNum);
+  /// Matches \p RegExToMatch, the regex of this pattern after substitutions,
+  /// against \p Buffer and fills \p MatchInfo with the leftmost match and its
+  /// groups. \returns whether a match was found.
+  bool matchRegEx(StringRef RegExToMatch, StringRef Buffer,
+                  SmallVectorImpl<StringRef> &MatchInfo) const;
   /// Computes an arbitrary estimate for the quality of matching this pattern
   /// at the start of \p Buffer; a distance of zero should correspond to a
   /// perfect match.
@@ -32,6 +32,9 @@ public:
   enum {
     /// set the 'x' bit on the resulting file
     F_executable = 1,
+
+    /// map the existing file and modify it in place
+    F_modify = 2,
   };
 
   /// Factory method to create an OutputBuffer object which manages a read/write
@@ -42,7 +45,10 @@ public:
   /// file \p Size may be set to -1, in which case the entire file is used.
   /// Otherwise, the file shrinks or grows as necessary based on the value of
   /// \p Size.  It is an error to specify F_modify and Size=-1 if \p FilePath
-  /// does not exist.
+  /// does not exist. With F_modify, the buffer starts out with the contents
+  /// of the file and writes go to the file directly, so unlike the other
+  /// modes, the update is not atomic and is not undone if the buffer is not
+  /// committed.
   static Expected<std::unique_ptr<FileOutputBuffer>>
   create(StringRef FilePath, size_t Size, unsigned Flags = 0);
 
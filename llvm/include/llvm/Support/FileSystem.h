@@ -1194,6 +1194,10 @@ public:
   /// behavior.
   const char *const_data() const;
 
+  /// Hint that the whole region will be accessed soon, so that the system can
+  /// start reading it in the background.
+  void willNeed() const;
+
   /// \returns The minimum alignment offset must be.
   static int alignment();
 };
@@ -187,6 +187,19 @@ inline int64_t decodeSLEB128(const uint8_t *p, unsigned *n = nullptr,
   return Value;
 }
 
+/// Decode \p Count consecutive ULEB128 values starting at \p p into \p Out.
+/// Values that end within eight bytes of their start are decoded from a single
+/// word load instead of byte by byte. Returns a pointer past the last decoded
+/// byte, or null if a value is malformed, in which case \p error is set.
+extern const uint8_t *decodeULEB128Array(const uint8_t *p, const uint8_t *end,
+                                          uint64_t *Out, size_t Count,
+                                          const char **error = nullptr);
+
+/// Returns a pointer past the LEB128 value at \p p, signed or unsigned, without
+/// decoding it, or null if the value extends past \p end. Unlike the decoders
+/// this does not check that the value fits in 64 bits.
+extern const uint8_t *skipLEB128(const uint8_t *p, const uint8_t *end);
+
 /// Utility function to get the size of the ULEB128-encoded value.
 extern unsigned getULEB128Size(uint64_t Value);
 
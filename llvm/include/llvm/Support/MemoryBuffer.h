@@ -145,6 +145,10 @@ public:
   /// MemoryBuffer.
   virtual BufferKind getBufferKind() const = 0;
 
+  /// For a memory-mapped buffer, hint that its contents will be accessed soon
+  /// so that the pages not yet in memory are read in the background.
+  virtual void willNeedIfMmap() const {}
+
   MemoryBufferRef getMemBufferRef() const;
 };
 
@@ -69,8 +69,16 @@ public:
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
   }
+
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
 };
 
+/// A set of tasks run by the default executor. Tasks may create and wait for
+/// task groups of their own: a thread waiting in sync() runs queued tasks
+/// until the group is done, instead of blocking an executor thread.
 class TaskGroup {
   Latch L;
   bool Parallel;
@@ -81,7 +89,7 @@ public:
 
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  void sync() const;
 };
 
 #if defined(_MSC_VER)
@@ -0,0 +1,60 @@
+//===-- llvm/Support/PerfCounters.h - Hardware event counters ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+/// \file Counts of hardware events of the calling thread, as counted by the
+/// performance monitoring unit of the processor. With -track-perf-counters,
+/// -time-passes and -ftime-trace report them next to the time of every pass
+/// and section, which tells a compile time regression that comes from running
+/// more code apart from one that comes from running the same code worse.
+///
+/// The counters are read through perf_event_open on Linux, and are all zero
+/// elsewhere or when the kernel does not allow them to be opened.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_PERFCOUNTERS_H
+#define LLVM_SUPPORT_PERFCOUNTERS_H
+
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm {
+namespace sys {
+
+struct PerfCounts {
+  uint64_t Instructions = 0; ///< Instructions retired.
+  uint64_t Cycles = 0;       ///< Core cycles.
+  uint64_t CacheMisses = 0;  ///< Last level cache misses.
+  uint64_t BranchMisses = 0; ///< Mispredicted branches.
+
+  void operator+=(const PerfCounts &RHS) {
+    Instructions += RHS.Instructions;
+    Cycles += RHS.Cycles;
+    CacheMisses += RHS.CacheMisses;
+    BranchMisses += RHS.BranchMisses;
+  }
+  void operator-=(const PerfCounts &RHS) {
+    Instructions -= RHS.Instructions;
+    Cycles -= RHS.Cycles;
+    CacheMisses -= RHS.CacheMisses;
+    BranchMisses -= RHS.BranchMisses;
+  }
+};
+
+/// Whether -track-perf-counters was given.
+bool perfCountersEnabled();
+
+/// Read the counters of the calling thread, which are opened on the first call
+/// from every thread. The counts only make sense as the difference between two
+/// reads from the same thread. This is a single read system call, cheap enough
+/// to be done around every pass.
+PerfCounts readPerfCounters();
+
+} // end namespace sys
+} // end namespace llvm
+
+#endif
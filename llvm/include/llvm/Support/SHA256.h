@@ -0,0 +1,76 @@
+//==- SHA256.h - SHA256 implementation for LLVM                  --*- C++ -*-==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This is an implementation of SHA-256 as specified in FIPS 180-4, with the
+// same interface as llvm::SHA1.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_SHA256_H
+#define LLVM_SUPPORT_SHA256_H
+
+#include "llvm/ADT/ArrayRef.h"
+
+#include <array>
+#include <cstdint>
+
+namespace llvm {
+class StringRef;
+
+/// A class that wraps the SHA256 algorithm.
+class SHA256 {
+public:
+  SHA256() { init(); }
+
+  /// Reinitialize the internal state
+  void init();
+
+  /// Digest more data.
+  void update(ArrayRef<uint8_t> Data);
+
+  /// Digest more data.
+  void update(StringRef Str);
+
+  /// Return a reference to the current raw 256-bits SHA256 for the digested
+  /// data since the last call to init(). This call will add data to the
+  /// internal state and as such is not suited for getting an intermediate
+  /// result (see result()).
+  StringRef final();
+
+  /// Return a reference to the current raw 256-bits SHA256 for the digested
+  /// data since the last call to init(). This is suitable for getting the
+  /// SHA256 at any time without invalidating the internal state so that more
+  /// calls can be made into update.
+  StringRef result();
+
+  /// Returns a raw 256-bit SHA256 hash for the given data.
+  static std::array<uint8_t, 32> hash(ArrayRef<uint8_t> Data);
+
+private:
+  enum { BLOCK_LENGTH = 64 };
+  enum { HASH_LENGTH = 32 };
+
+  // Internal State
+  struct {
+    uint8_t Buffer[BLOCK_LENGTH];
+    uint32_t State[HASH_LENGTH / 4];
+    uint64_t ByteCount;
+    uint8_t BufferOffset;
+  } InternalState;
+
+  // Internal copy of the hash, populated and accessed on calls to result()
+  uint8_t HashResult[HASH_LENGTH];
+
+  // Helper
+  void hashBlock(const uint8_t *Block);
+  void pad();
+};
+
+} // end llvm namespace
+
+#endif
@@ -51,6 +51,9 @@
 #ifndef LLVM_SUPPORT_SPECIALCASELIST_H
 #define LLVM_SUPPORT_SPECIALCASELIST_H
 
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/Regex.h"
@@ -113,7 +116,11 @@ protected:
   /// Represents a set of regular expressions.  Regular expressions which are
   /// "literal" (i.e. no regex metacharacters) are stored in Strings.  The
   /// reason for doing so is efficiency; StringMap is much faster at matching
-  /// literal strings than Regex.
+  /// literal strings than Regex.  Likewise, expressions whose only
+  /// metacharacters are '*' and '.' are matched as globs, without the regex
+  /// engine.  Expressions are indexed by their literal prefix, or else by
+  /// their literal suffix or a trigram of one of their parts, so that a query
+  /// is only matched against the expressions it could match.
   class Matcher {
   public:
     bool insert(std::string Regexp, unsigned LineNumber, std::string &REError);
@@ -122,9 +129,46 @@ protected:
     unsigned match(StringRef Query) const;
 
   private:
+    /// A non-literal expression: either a glob, or a compiled regex if the
+    /// expression has other metacharacters than '*' and '.'.
+    struct Pattern {
+      std::string Glob;
+      std::unique_ptr<Regex> RegEx;
+      unsigned LineNumber;
+
+      bool match(StringRef Query) const;
+    };
+
+    /// Sets \p Best to the index of the first pattern of \p Indices, which is
+    /// sorted, that matches \p Query if it is lower than \p Best.
+    void matchFirst(ArrayRef<unsigned> Indices, StringRef Query,
+                    unsigned &Best) const;
+    /// Calls matchFirst on the expressions of \p Index whose key is a prefix
+    /// of \p Query, or a suffix if \p Suffixes is set. \p Lengths holds the
+    /// distinct lengths of the keys of \p Index, sorted.
+    void matchAffixes(const StringMap<std::vector<unsigned>> &Index,
+                      ArrayRef<size_t> Lengths, bool Suffixes, StringRef Query,
+                      unsigned &Best) const;
+
     StringMap<unsigned> Strings;
     TrigramIndex Trigrams;
-    std::vector<std::pair<std::unique_ptr<Regex>, unsigned>> RegExes;
+    /// The non-literal expressions, in insertion order.
+    std::vector<Pattern> Patterns;
+    /// The indices in Patterns of the expressions starting with a literal
+    /// prefix, keyed by that prefix.
+    StringMap<std::vector<unsigned>> PrefixIndex;
+    /// The distinct lengths of the keys of PrefixIndex.
+    SmallVector<size_t, 4> PrefixLengths;
+    /// The indices in Patterns of some of the expressions ending with a
+    /// literal suffix, keyed by that suffix.
+    StringMap<std::vector<unsigned>> SuffixIndex;
+    /// The distinct lengths of the keys of SuffixIndex.
+    SmallVector<size_t, 4> SuffixLengths;
+    /// The indices in Patterns of some of the globs, keyed by a trigram that
+    /// any match contains.
+    DenseMap<unsigned, std::vector<unsigned>> InfixIndex;
+    /// The indices in Patterns of the other expressions.
+    std::vector<unsigned> Unindexed;
   };
 
   using SectionEntries = StringMap<StringMap<Matcher>>;
@@ -13,6 +13,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/ThreadSafeAllocator.h"
 
 namespace llvm {
 
@@ -31,6 +32,22 @@ public:
   StringRef save(const std::string &S) { return save(StringRef(S)); }
 };
 
+/// Saves strings in the provided stable storage and returns a StringRef with a
+/// stable character pointer. Unlike StringSaver, save() may be called from
+/// several threads at once.
+class ConcurrentStringSaver final {
+  ThreadSafeBumpPtrAllocator &Alloc;
+
+public:
+  ConcurrentStringSaver(ThreadSafeBumpPtrAllocator &Alloc) : Alloc(Alloc) {}
+
+  // All returned strings are null-terminated: *save(S).end() == 0.
+  StringRef save(const char *S) { return save(StringRef(S)); }
+  StringRef save(StringRef S);
+  StringRef save(const Twine &S) { return save(StringRef(S.str())); }
+  StringRef save(const std::string &S) { return save(StringRef(S)); }
+};
+
 /// Saves strings in the provided stable storage and returns a StringRef with a
 /// stable character pointer. Saving the same string yields the same StringRef.
 ///
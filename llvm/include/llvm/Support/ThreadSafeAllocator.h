@@ -0,0 +1,80 @@
+//===- llvm/Support/ThreadSafeAllocator.h -----------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines ThreadSafeBumpPtrAllocator, a bump pointer allocator that
+// may be used from several threads at once.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_THREADSAFEALLOCATOR_H
+#define LLVM_SUPPORT_THREADSAFEALLOCATOR_H
+
+#include "llvm/Support/Allocator.h"
+#include <memory>
+
+namespace llvm {
+
+/// A bump pointer allocator whose Allocate() may be called concurrently.
+///
+/// Every thread allocates from its own BumpPtrAllocator, which is created on
+/// the thread's first allocation. Later allocations by the same thread take no
+/// lock. All memory is owned by this allocator and is freed when it is reset
+/// or destroyed, so pointers may be handed to and used from any thread.
+///
+/// Reset() and the statistics accessors must not run concurrently with
+/// Allocate().
+class ThreadSafeBumpPtrAllocator
+    : public AllocatorBase<ThreadSafeBumpPtrAllocator> {
+public:
+  ThreadSafeBumpPtrAllocator();
+  ThreadSafeBumpPtrAllocator(const ThreadSafeBumpPtrAllocator &) = delete;
+  ThreadSafeBumpPtrAllocator &
+  operator=(const ThreadSafeBumpPtrAllocator &) = delete;
+  ~ThreadSafeBumpPtrAllocator();
+
+  LLVM_ATTRIBUTE_RETURNS_NONNULL LLVM_ATTRIBUTE_RETURNS_NOALIAS void *
+  Allocate(size_t Size, size_t Alignment) {
+    return getThreadAllocator().Allocate(Size, Alignment);
+  }
+
+  // Pull in base class overloads.
+  using AllocatorBase<ThreadSafeBumpPtrAllocator>::Allocate;
+
+  // Memory is only freed by Reset() and the destructor.
+  void Deallocate(const void *Ptr, size_t Size) {}
+
+  // Pull in base class overloads.
+  using AllocatorBase<ThreadSafeBumpPtrAllocator>::Deallocate;
+
+  /// Deallocate all memory of all threads, but keep the first slab of each
+  /// thread.
+  void Reset();
+
+  /// Returns the number of bytes in the slabs of all threads.
+  size_t getTotalMemory() const;
+
+  /// Returns the number of bytes allocated by all threads.
+  size_t getBytesAllocated() const;
+
+  void PrintStats() const;
+
+private:
+  /// Returns the allocator of the calling thread, creating it if needed.
+  BumpPtrAllocator &getThreadAllocator();
+
+  struct ThreadAllocators;
+  std::unique_ptr<ThreadAllocators> Allocators;
+
+  /// Identifies this allocator in the per-thread cache. Unlike the address of
+  /// the allocator it is never reused.
+  uint64_t ID;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_THREADSAFEALLOCATOR_H
@@ -9,19 +9,30 @@
 #ifndef LLVM_SUPPORT_TIME_PROFILER_H
 #define LLVM_SUPPORT_TIME_PROFILER_H
 
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
 
 struct TimeTraceProfiler;
-extern TimeTraceProfiler *TimeTraceProfilerInstance;
+extern LLVM_THREAD_LOCAL TimeTraceProfiler *TimeTraceProfilerInstance;
 
 /// Initialize the time trace profiler.
-/// This sets up the global \p TimeTraceProfilerInstance
-/// variable to be the profiler instance.
-void timeTraceProfilerInitialize(unsigned TimeTraceGranularity);
+/// This sets up the thread-local \p TimeTraceProfilerInstance
+/// variable to be the profiler instance of the calling thread. Every thread
+/// that records sections initializes its own instance, so recording never
+/// takes a lock; the first thread to do so is the main one, whose start time
+/// the others are reported against, and \p ProcName names the process.
+void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
+                                 StringRef ProcName);
 
-/// Cleanup the time trace profiler, if it was initialized.
+/// Hand the profiler instance of the calling thread over to the main one, so
+/// that its sections are included by \p timeTraceProfilerWrite. Must be
+/// called by every thread but the main one before it exits.
+void timeTraceProfilerFinishThread();
+
+/// Cleanup the time trace profiler, if it was initialized. Must be called by
+/// the main thread, once every other thread has finished.
 void timeTraceProfilerCleanup();
 
 /// Is the time trace profiler enabled, i.e. initialized?
@@ -29,7 +40,9 @@ inline bool timeTraceProfilerEnabled() {
   return TimeTraceProfilerInstance != nullptr;
 }
 
-/// Write profiling data to output file.
+/// Write profiling data to output file, one Chrome thread per profiler
+/// instance. Must be called by the main thread, once every other thread has
+/// finished.
 /// Data produced is JSON, in Chrome "Trace Event" format, see
 /// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
 void timeTraceProfilerWrite(raw_pwrite_stream &OS);
@@ -12,6 +12,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DataTypes.h"
+#include "llvm/Support/PerfCounters.h"
 #include <cassert>
 #include <string>
 #include <utility>
@@ -28,6 +29,7 @@ class TimeRecord {
   double UserTime;       ///< User time elapsed.
   double SystemTime;     ///< System time elapsed.
   ssize_t MemUsed;       ///< Memory allocated (in bytes).
+  sys::PerfCounts Counts; ///< Hardware events (with -track-perf-counters).
 public:
   TimeRecord() : WallTime(0), UserTime(0), SystemTime(0), MemUsed(0) {}
 
@@ -42,6 +44,7 @@ public:
   double getSystemTime() const { return SystemTime; }
   double getWallTime() const { return WallTime; }
   ssize_t getMemUsed() const { return MemUsed; }
+  const sys::PerfCounts &getPerfCounts() const { return Counts; }
 
   bool operator<(const TimeRecord &T) const {
     // Sort by Wall Time elapsed, as it is the only thing really accurate
@@ -53,12 +56,14 @@ public:
     UserTime   += RHS.UserTime;
     SystemTime += RHS.SystemTime;
     MemUsed    += RHS.MemUsed;
+    Counts     += RHS.Counts;
   }
   void operator-=(const TimeRecord &RHS) {
     WallTime   -= RHS.WallTime;
     UserTime   -= RHS.UserTime;
     SystemTime -= RHS.SystemTime;
     MemUsed    -= RHS.MemUsed;
+    Counts     -= RHS.Counts;
   }
 
   /// Print the current time record to \p OS, with a breakdown showing
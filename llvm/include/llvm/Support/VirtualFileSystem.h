@@ -14,10 +14,12 @@
 #ifndef LLVM_SUPPORT_VIRTUALFILESYSTEM_H
 #define LLVM_SUPPORT_VIRTUALFILESYSTEM_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/None.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/Chrono.h"
@@ -29,6 +31,7 @@
 #include <cstdint>
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <string>
 #include <system_error>
@@ -404,6 +407,51 @@ private:
   virtual void anchor();
 };
 
+/// A file system that remembers the results of status(), including the
+/// failed ones, and forwards all other calls to the underlying file system.
+///
+/// The results are kept in a StatCache, which may be shared by several
+/// instances (e.g. by the compiler invocations of one build, which all look
+/// up the same headers). The cache assumes that the files don't change while
+/// it's in use: clear it when they may have.
+class StatCachingFileSystem : public ProxyFileSystem {
+public:
+  /// The results of status(), keyed by absolute path. Thread-safe.
+  class StatCache {
+  public:
+    /// Forget all results.
+    void clear();
+
+    /// Returns the number of paths with a result.
+    size_t size() const;
+
+  private:
+    friend class StatCachingFileSystem;
+
+    struct Entry {
+      ErrorOr<Status> S;
+      /// Whether the status was named after the path that was queried,
+      /// rather than, e.g., the external path of a redirected file.
+      bool HasQueriedName;
+    };
+
+    mutable std::mutex Mutex;
+    StringMap<Entry> Entries;
+  };
+
+  explicit StatCachingFileSystem(
+      IntrusiveRefCntPtr<FileSystem> FS,
+      std::shared_ptr<StatCache> Cache = std::make_shared<StatCache>())
+      : ProxyFileSystem(std::move(FS)), Cache(std::move(Cache)) {}
+
+  llvm::ErrorOr<Status> status(const Twine &Path) override;
+
+  StatCache &getCache() { return *Cache; }
+
+private:
+  std::shared_ptr<StatCache> Cache;
+};
+
 namespace detail {
 
 class InMemoryDirectory;
@@ -590,6 +638,12 @@ public:
   class RedirectingDirectoryEntry : public Entry {
     std::vector<std::unique_ptr<Entry>> Contents;
     Status S;
+    /// Maps the (lowercased, if the index is case-insensitive) names of the
+    /// contents to the entries with that name, in the order of \c Contents.
+    /// Only built for directories with many entries; see buildIndex().
+    StringMap<SmallVector<Entry *, 1>> Index;
+    bool HasIndex = false;
+    bool IndexIsCaseSensitive = true;
 
   public:
     RedirectingDirectoryEntry(StringRef Name,
@@ -604,8 +658,23 @@ public:
 
     void addContent(std::unique_ptr<Entry> Content) {
       Contents.push_back(std::move(Content));
+      if (HasIndex) {
+        Index.clear();
+        HasIndex = false;
+      }
     }
 
+    /// Index the contents by name, so that findContents() doesn't need to
+    /// compare \p Name against every entry. Directories with few entries are
+    /// left unindexed, a linear scan is faster for them.
+    void buildIndex(bool CaseSensitive);
+
+    /// Return the entries named \p Name, in the order in which they were
+    /// added. Returns None if the directory has no index for \p CaseSensitive,
+    /// in which case the caller has to scan the contents itself.
+    Optional<ArrayRef<Entry *>> findContents(StringRef Name,
+                                             bool CaseSensitive) const;
+
     Entry *getLastContent() const { return Contents.back().get(); }
 
     using iterator = decltype(Contents)::iterator;
@@ -33,7 +33,10 @@
 */
 
 /* based on revision d2df04efcbef7d7f6886d345861e5dfda4edacc1 Removed
- * everything but a simple interface for computing XXh64. */
+ * everything but a simple interface for computing XXh64.
+ *
+ * XXH3_64bits is based on xxHash 0.8.1, reduced to the default secret and
+ * seed 0. */
 
 #ifndef LLVM_SUPPORT_XXHASH_H
 #define LLVM_SUPPORT_XXHASH_H
@@ -44,6 +47,15 @@
 namespace llvm {
 uint64_t xxHash64(llvm::StringRef Data);
 uint64_t xxHash64(llvm::ArrayRef<uint8_t> Data);
+
+/// Computes XXH3_64bits with the default secret and seed 0. This is
+/// considerably faster than xxHash64 for large inputs since the inner loop
+/// is written so that it can be auto-vectorized (SSE2/AVX2 on x86, NEON on
+/// AArch64).
+uint64_t xxh3_64bits(llvm::ArrayRef<uint8_t> Data);
+inline uint64_t xxh3_64bits(llvm::StringRef Data) {
+  return xxh3_64bits(llvm::makeArrayRef(Data.bytes_begin(), Data.size()));
+}
 }
 
 #endif
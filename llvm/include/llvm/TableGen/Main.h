@@ -24,6 +24,16 @@ using TableGenMainFn = bool (raw_ostream &OS, RecordKeeper &Records);
 
 int TableGenMain(char *argv0, TableGenMainFn *MainFn);
 
+/// Perform the action of backend number Backend using Records, and write
+/// output to OS. Returns true on error, false otherwise.
+using TableGenMultiMainFn = bool (raw_ostream &OS, RecordKeeper &Records,
+                                  unsigned Backend);
+
+/// Parse the input once and run NumBackends backends on the records, each
+/// writing to the output file given by the -o option of the same position.
+int TableGenMain(char *argv0, unsigned NumBackends,
+                 TableGenMultiMainFn *MainFn);
+
 } // end namespace llvm
 
 #endif // LLVM_TABLEGEN_MAIN_H
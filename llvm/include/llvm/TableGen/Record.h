@@ -513,6 +513,8 @@ public:
 class BitsInit final : public TypedInit, public FoldingSetNode,
                        public TrailingObjects<BitsInit, Init *> {
   unsigned NumBits;
+  // Whether all the bits are concrete, computed once the bits are interned.
+  bool Concrete = false;
 
   BitsInit(unsigned N)
     : TypedInit(IK_BitsInit, BitsRecTy::get(N)), NumBits(N) {}
@@ -549,7 +551,7 @@ public:
     return true;
   }
 
-  bool isConcrete() const override;
+  bool isConcrete() const override { return Concrete; }
   std::string getAsString() const override;
 
   Init *resolveReferences(Resolver &R) const override;
@@ -661,6 +663,8 @@ public:
 class ListInit final : public TypedInit, public FoldingSetNode,
                        public TrailingObjects<ListInit, Init *> {
   unsigned NumValues;
+  // Whether all the elements are concrete, computed once the list is interned.
+  bool Concrete = false;
 
 public:
   using const_iterator = Init *const *;
@@ -704,7 +708,7 @@ public:
   ///
   Init *resolveReferences(Resolver &R) const override;
 
-  bool isConcrete() const override;
+  bool isConcrete() const override { return Concrete; }
   std::string getAsString() const override;
 
   ArrayRef<Init*> getValues() const {
@@ -1307,6 +1311,9 @@ class DagInit final : public TypedInit, public FoldingSetNode,
   StringInit *ValName;
   unsigned NumArgs;
   unsigned NumArgNames;
+  // Whether the operator and all the arguments are concrete, computed once the
+  // dag is interned.
+  bool Concrete = false;
 
   DagInit(Init *V, StringInit *VN, unsigned NumArgs, unsigned NumArgNames)
       : TypedInit(IK_DagInit, DagRecTy::get()), Val(V), ValName(VN),
@@ -1364,7 +1371,7 @@ public:
 
   Init *resolveReferences(Resolver &R) const override;
 
-  bool isConcrete() const override;
+  bool isConcrete() const override { return Concrete; }
   std::string getAsString() const override;
 
   using const_arg_iterator = SmallVectorImpl<Init*>::const_iterator;
@@ -11,6 +11,7 @@
 
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/CallGraphSCCPass.h"
+#include "llvm/Analysis/InlineAdvisor.h"
 #include "llvm/Analysis/InlineCost.h"
 #include "llvm/Analysis/LazyCallGraph.h"
 #include "llvm/IR/CallSite.h"
@@ -67,6 +68,12 @@ struct LegacyInlinerBase : public CallGraphSCCPass {
   /// this function unconditionally.
   bool inlineCalls(CallGraphSCC &SCC);
 
+  /// Makes the inliner consult \p A for the call sites the cost model weighs,
+  /// instead of following the cost model.
+  void setInlineAdvisor(std::unique_ptr<InlineAdvisor> A) {
+    Advisor = std::move(A);
+  }
+
 private:
   // Insert @llvm.lifetime intrinsics.
   bool InsertLifetime = true;
@@ -75,6 +82,7 @@ protected:
   AssumptionCacheTracker *ACT;
   ProfileSummaryInfo *PSI;
   ImportedFunctionsInliningStatistics ImportedFunctionsStats;
+  std::unique_ptr<InlineAdvisor> Advisor;
 };
 
 /// The inliner pass for the new pass manager.
@@ -98,14 +106,22 @@ public:
   ~InlinerPass();
   InlinerPass(InlinerPass &&Arg)
       : Params(std::move(Arg.Params)),
-        ImportedFunctionsStats(std::move(Arg.ImportedFunctionsStats)) {}
+        ImportedFunctionsStats(std::move(Arg.ImportedFunctionsStats)),
+        Advisor(std::move(Arg.Advisor)) {}
 
   PreservedAnalyses run(LazyCallGraph::SCC &C, CGSCCAnalysisManager &AM,
                         LazyCallGraph &CG, CGSCCUpdateResult &UR);
 
+  /// Makes the inliner consult \p A for the call sites the cost model weighs,
+  /// instead of following the cost model.
+  void setInlineAdvisor(std::unique_ptr<InlineAdvisor> A) {
+    Advisor = std::move(A);
+  }
+
 private:
   InlineParams Params;
   std::unique_ptr<ImportedFunctionsInliningStatistics> ImportedFunctionsStats;
+  std::unique_ptr<InlineAdvisor> Advisor;
 };
 
 } // end namespace llvm
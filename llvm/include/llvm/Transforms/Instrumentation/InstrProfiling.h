@@ -68,6 +68,10 @@ private:
   // vector of counter load/store pairs to be register promoted.
   std::vector<LoadStorePair> PromotionCandidates;
 
+  // The offset to the counters of the current thread in the function being
+  // lowered, if thread-local counters are enabled.
+  Value *ThreadCountersDelta = nullptr;
+
   // The start value of precise value profile range for memory intrinsic sizes.
   int64_t MemOPSizeRangeStart;
   // The end value of precise value profile range for memory intrinsic sizes.
@@ -94,6 +98,16 @@ private:
   /// Replace instrprof_increment with an increment of the appropriate value.
   void lowerIncrement(InstrProfIncrementInst *Inc);
 
+  /// Get the declaration of the variable \p Name defined in the profile
+  /// runtime, creating it if necessary.
+  GlobalVariable *getOrCreateRuntimeVar(StringRef Name, Type *Ty,
+                                        bool IsThreadLocal);
+
+  /// Emit code at the entry of \p F that computes the offset from the
+  /// shared counters to the counters of the current thread, asking the
+  /// runtime to allocate them on the first call in a thread.
+  Value *getThreadCountersDelta(Function *F);
+
   /// Force emitting of name vars for unused functions.
   void lowerCoverageData(GlobalVariable *CoverageNamesVar);
 
@@ -20,6 +20,7 @@
 
 namespace llvm {
 
+class GlobalValue;
 class Module;
 
 /// Splits the module M into N linkable partitions. The function ModuleCallback
@@ -37,6 +38,21 @@ void SplitModule(
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
     bool PreserveLocals = false);
 
+/// Assigns the global values defined in the module M to the N partitions that
+/// SplitModule would split it into, without creating them. The function
+/// PartitionCallback is called for each global value defined in M, passing
+/// the index of its partition.
+///
+/// M is prepared as it is for SplitModule: unnamed global values are named,
+/// and local ones are externalized unless PreserveLocals is set, so that a
+/// partition can later be created from any copy of the prepared module by
+/// dropping the definitions of the global values that aren't in it.
+void computeModulePartitions(
+    Module &M, unsigned N,
+    function_ref<void(const GlobalValue &GV, unsigned Partition)>
+        PartitionCallback,
+    bool PreserveLocals = false);
+
 } // end namespace llvm
 
 #endif // LLVM_TRANSFORMS_UTILS_SPLITMODULE_H
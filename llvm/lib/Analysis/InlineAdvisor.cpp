@@ -0,0 +1,116 @@
+//===- InlineAdvisor.cpp - Pluggable inlining decisions -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the feature extraction of call sites and the inline
+// advisors that follow the inline cost model.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/InlineAdvisor.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/InlineCost.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/InstrTypes.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+constexpr uint64_t InlineFeatures::FrequencyScale;
+
+InlineFeatures llvm::getInlineFeatures(CallBase &CB, const InlineCost &IC,
+                                       BlockFrequencyInfo *CallerBFI,
+                                       ProfileSummaryInfo *PSI,
+                                       unsigned SCCSize,
+                                       bool CalleeInSameSCC) {
+  assert(IC.isVariable() && "Expected a call site the cost model weighed");
+  Function &Callee = *CB.getCalledFunction();
+  Function &Caller = *CB.getCaller();
+
+  InlineFeatures Features;
+  Features.Cost = IC.getCost();
+  Features.Threshold = IC.getThreshold();
+  Features.CalleeInstructions = Callee.getInstructionCount();
+  Features.CalleeBlocks = Callee.size();
+  Features.CallerInstructions = Caller.getInstructionCount();
+  Features.CalleeUses = Callee.getNumUses();
+  Features.CalleeHasLocalLinkage = Callee.hasLocalLinkage();
+  Features.NumArgs = CB.arg_size();
+  for (const Use &Arg : CB.args())
+    if (isa<Constant>(Arg))
+      ++Features.NumConstantArgs;
+
+  if (CallerBFI) {
+    uint64_t EntryFreq = CallerBFI->getEntryFreq();
+    uint64_t Freq = CallerBFI->getBlockFreq(CB.getParent()).getFrequency();
+    if (EntryFreq)
+      Features.CallSiteFrequency =
+          (double)Freq / EntryFreq * InlineFeatures::FrequencyScale;
+  }
+  if (PSI)
+    Features.CallSiteCount = PSI->getProfileCount(&CB, CallerBFI);
+
+  Features.SCCSize = SCCSize;
+  Features.CalleeInSameSCC = CalleeInSameSCC;
+  return Features;
+}
+
+InlineAdvisor::~InlineAdvisor() = default;
+
+bool InlineAdvisor::shouldInline(const InlineFeatures &Features) {
+  return Features.Cost < Features.Threshold;
+}
+
+InlineDecisionLogger::InlineDecisionLogger(
+    std::unique_ptr<InlineAdvisor> Advisor, std::unique_ptr<raw_ostream> OS,
+    bool WriteHeader)
+    : Advisor(std::move(Advisor)), OS(std::move(OS)) {
+  if (WriteHeader)
+    *this->OS << "cost,threshold,callee_instructions,callee_blocks,"
+                 "caller_instructions,callee_uses,callee_local,num_args,"
+                 "num_constant_args,call_site_frequency,call_site_count,"
+                 "scc_size,callee_in_same_scc,advised,inlined\n";
+}
+
+InlineDecisionLogger::~InlineDecisionLogger() = default;
+
+bool InlineDecisionLogger::shouldInline(const InlineFeatures &Features) {
+  return Advisor->shouldInline(Features);
+}
+
+void InlineDecisionLogger::recordOutcome(const InlineFeatures &Features,
+                                         bool Advised, bool Inlined) {
+  Advisor->recordOutcome(Features, Advised, Inlined);
+  // An empty count is a call site without profile.
+  *OS << Features.Cost << ',' << Features.Threshold << ','
+      << Features.CalleeInstructions << ',' << Features.CalleeBlocks << ','
+      << Features.CallerInstructions << ',' << Features.CalleeUses << ','
+      << Features.CalleeHasLocalLinkage << ',' << Features.NumArgs << ','
+      << Features.NumConstantArgs << ',' << Features.CallSiteFrequency << ',';
+  if (Features.CallSiteCount)
+    *OS << *Features.CallSiteCount;
+  *OS << ',' << Features.SCCSize << ',' << Features.CalleeInSameSCC << ','
+      << Advised << ',' << Inlined << '\n';
+}
+
+std::unique_ptr<InlineDecisionLogger>
+InlineDecisionLogger::create(StringRef Path,
+                             std::unique_ptr<InlineAdvisor> Advisor) {
+  // Several inliner passes or compilations can log to the same file, only the
+  // first one to write to it names the values.
+  uint64_t Size;
+  bool WriteHeader = sys::fs::file_size(Path, Size) || Size == 0;
+  std::error_code EC;
+  auto OS = std::make_unique<raw_fd_ostream>(Path, EC, sys::fs::OF_Append);
+  if (EC)
+    return nullptr;
+  return std::make_unique<InlineDecisionLogger>(std::move(Advisor),
+                                                std::move(OS), WriteHeader);
+}
@@ -145,6 +145,14 @@ STATISTIC(NumTripCountsNotComputed,
           "Number of loops without predictable loop counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumSCEVsCreated, "Number of SCEV expressions created");
+STATISTIC(MaxSCEVsPerFunction,
+          "Largest number of SCEV expressions created for a function");
+STATISTIC(MaxSCEVAllocatorKB,
+          "Largest memory allocated for the SCEVs of a function, in KB");
+STATISTIC(NumSCEVBudgetExhausted,
+          "Number of values left unanalyzed because the function exceeded "
+          "its SCEV budget");
 
 static cl::opt<unsigned>
 MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
@@ -206,6 +214,13 @@ static cl::opt<unsigned>
                  cl::desc("Maximum depth of recursive SExt/ZExt/Trunc"),
                  cl::init(8));
 
+static cl::opt<unsigned> MaxSCEVsPerFunctionBudget(
+    "scalar-evolution-max-exprs-per-function", cl::Hidden,
+    cl::desc("Once this many SCEV expressions were created for a function, "
+             "treat the values that aren't analyzed yet as unknown "
+             "(0 = unlimited)"),
+    cl::init(0));
+
 static cl::opt<unsigned>
     MaxAddRecSize("scalar-evolution-max-add-rec-size", cl::Hidden,
                   cl::desc("Max coefficients in AddRec during evolving"),
@@ -6115,6 +6130,14 @@ const SCEV *ScalarEvolution::createSCEV(Value *V) {
   if (!isSCEVable(V->getType()))
     return getUnknown(V);
 
+  // Bound the memory used for huge functions: an unknown is always correct,
+  // just less precise.
+  if (MaxSCEVsPerFunctionBudget &&
+      UniqueSCEVs.size() >= MaxSCEVsPerFunctionBudget && !isa<Constant>(V)) {
+    ++NumSCEVBudgetExhausted;
+    return getUnknown(V);
+  }
+
   if (Instruction *I = dyn_cast<Instruction>(V)) {
     // Don't attempt to analyze instructions in blocks that aren't
     // reachable. Such instructions don't matter, and they aren't required
@@ -11377,6 +11400,10 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
 }
 
 ScalarEvolution::~ScalarEvolution() {
+  NumSCEVsCreated += UniqueSCEVs.size();
+  MaxSCEVsPerFunction.updateMax(UniqueSCEVs.size());
+  MaxSCEVAllocatorKB.updateMax(SCEVAllocator.getTotalMemory() / 1024);
+
   // Iterate through all the SCEVUnknown instances and call their
   // destructors, so that they release their references to their values.
   for (SCEVUnknown *U = FirstUnknown; U;) {
@@ -144,10 +144,10 @@ DIEAbbrevSet::~DIEAbbrevSet() {
 }
 
 DIEAbbrev &DIEAbbrevSet::uniqueAbbreviation(DIE &Die) {
-
+  // Most DIEs share their abbreviation with an earlier one, so only generate
+  // it when it is new.
   FoldingSetNodeID ID;
-  DIEAbbrev Abbrev = Die.generateAbbrev();
-  Abbrev.Profile(ID);
+  Die.profileAbbrev(ID);
 
   void *InsertPos;
   if (DIEAbbrev *Existing =
@@ -157,7 +157,7 @@ DIEAbbrev &DIEAbbrevSet::uniqueAbbreviation(DIE &Die) {
   }
 
   // Move the abbreviation to the heap and assign a number.
-  DIEAbbrev *New = new (Alloc) DIEAbbrev(std::move(Abbrev));
+  DIEAbbrev *New = new (Alloc) DIEAbbrev(Die.generateAbbrev());
   Abbreviations.push_back(New);
   New->setNumber(Abbreviations.size());
   Die.setAbbrevNumber(Abbreviations.size());
@@ -194,6 +194,18 @@ DIEAbbrev DIE::generateAbbrev() const {
   return Abbrev;
 }
 
+void DIE::profileAbbrev(FoldingSetNodeID &ID) const {
+  // Keep in sync with DIEAbbrev::Profile() and DIEAbbrevData::Profile().
+  ID.AddInteger(unsigned(Tag));
+  ID.AddInteger(unsigned(hasChildren()));
+  for (const DIEValue &V : values()) {
+    ID.AddInteger(unsigned(V.getAttribute()));
+    ID.AddInteger(unsigned(V.getForm()));
+    if (V.getForm() == dwarf::DW_FORM_implicit_const)
+      ID.AddInteger(V.getDIEInteger().getValue());
+  }
+}
+
 unsigned DIE::getDebugSectionOffset() const {
   const DIEUnit *Unit = getUnit();
   assert(Unit && "DIE must be owned by a DIEUnit to get its absolute offset");
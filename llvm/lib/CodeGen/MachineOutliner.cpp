@@ -96,6 +96,14 @@ static cl::opt<bool> EnableLinkOnceODROutlining(
     cl::desc("Enable the machine outliner on linkonceodr functions"),
     cl::init(false));
 
+/// Number of times to re-run the outliner. This is not the total number of runs
+/// as the outliner will run at least one time. The default value is set to 0,
+/// meaning the outliner will run one time and rerun zero times after that.
+static cl::opt<unsigned> OutlinerReruns(
+    "machine-outliner-reruns", cl::init(0), cl::Hidden,
+    cl::desc(
+        "Number of times to rerun the outliner after the initial outline"));
+
 namespace {
 
 /// Represents an undefined index in the suffix tree.
@@ -843,6 +851,10 @@ struct MachineOutliner : public ModulePass {
   /// Set when the pass is constructed in TargetPassConfig.
   bool RunOnAllFunctions = true;
 
+  /// The number of times the outliner ran on the module before the current
+  /// run. It distinguishes the names of the functions outlined in each run.
+  unsigned OutlineRepeatedNum = 0;
+
   StringRef getPassName() const override { return "Machine Outliner"; }
 
   void getAnalysisUsage(AnalysisUsage &AU) const override {
@@ -899,6 +911,9 @@ struct MachineOutliner : public ModulePass {
   /// strings from that tree.
   bool runOnModule(Module &M) override;
 
+  /// Runs the outliner once over \p M. Returns true if anything was outlined.
+  bool doOutline(Module &M);
+
   /// Return a DISubprogram for OF if one exists, and null otherwise. Helper
   /// function for remark emission.
   DISubprogram *getSubprogramOrNull(const OutlinedFunction &OF) {
@@ -1095,7 +1110,10 @@ MachineOutliner::createOutlinedFunction(Module &M, OutlinedFunction &OF,
   // Create the function name. This should be unique.
   // FIXME: We should have a better naming scheme. This should be stable,
   // regardless of changes to the outliner's cost model/traversal order.
-  std::string FunctionName = ("OUTLINED_FUNCTION_" + Twine(Name)).str();
+  std::string FunctionName = "OUTLINED_FUNCTION_";
+  if (OutlineRepeatedNum > 0)
+    FunctionName += std::to_string(OutlineRepeatedNum + 1) + "_";
+  FunctionName += std::to_string(Name);
 
   // Create the function using an IR-level function.
   LLVMContext &C = M.getContext();
@@ -1421,6 +1439,23 @@ bool MachineOutliner::runOnModule(Module &M) {
   if (M.empty())
     return false;
 
+  // The code outlined in a run can contain repeated sequences itself, and the
+  // calls it left behind can form new ones, so each rerun can find more.
+  bool Changed = false;
+  for (OutlineRepeatedNum = 0; OutlineRepeatedNum <= OutlinerReruns;
+       ++OutlineRepeatedNum) {
+    if (!doOutline(M)) {
+      LLVM_DEBUG(dbgs() << "Did not outline on iteration "
+                        << OutlineRepeatedNum + 1 << " out of "
+                        << OutlinerReruns + 1 << "\n");
+      break;
+    }
+    Changed = true;
+  }
+  return Changed;
+}
+
+bool MachineOutliner::doOutline(Module &M) {
   MachineModuleInfo &MMI = getAnalysis<MachineModuleInfo>();
 
   // If the user passed -enable-machine-outliner=always or
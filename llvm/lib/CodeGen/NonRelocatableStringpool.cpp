@@ -6,12 +6,12 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "NonRelocatableStringpool.h"
+#include "llvm/CodeGen/NonRelocatableStringpool.h"
 
 namespace llvm {
-namespace dsymutil {
 
 DwarfStringPoolEntryRef NonRelocatableStringpool::getEntry(StringRef S) {
+  std::lock_guard<std::mutex> Lock(Mutex);
   if (S.empty() && !Strings.empty())
     return EmptyString;
 
@@ -31,6 +31,7 @@ DwarfStringPoolEntryRef NonRelocatableStringpool::getEntry(StringRef S) {
 StringRef NonRelocatableStringpool::internString(StringRef S) {
   DwarfStringPoolEntry Entry{nullptr, 0, DwarfStringPoolEntry::NotIndexed};
 
+  std::lock_guard<std::mutex> Lock(Mutex);
   if (Translator)
     S = Translator(S);
 
@@ -40,6 +41,7 @@ StringRef NonRelocatableStringpool::internString(StringRef S) {
 
 std::vector<DwarfStringPoolEntryRef>
 NonRelocatableStringpool::getEntriesForEmission() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
   std::vector<DwarfStringPoolEntryRef> Result;
   Result.reserve(Strings.size());
   for (const auto &E : Strings)
@@ -52,5 +54,4 @@ NonRelocatableStringpool::getEntriesForEmission() const {
   return Result;
 }
 
-} // namespace dsymutil
 } // namespace llvm
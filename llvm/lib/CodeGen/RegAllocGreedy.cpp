@@ -136,6 +136,13 @@ CSRFirstTimeCost("regalloc-csr-first-time-cost",
               cl::desc("Cost for first time use of callee-saved register."),
               cl::init(0), cl::Hidden);
 
+static cl::opt<unsigned> AttemptBudgetPerVReg(
+    "regalloc-attempt-budget-per-vreg", cl::Hidden,
+    cl::desc("Number of eviction and split attempts per virtual register "
+             "after which greedy register allocation falls back to cheaper "
+             "strategies for the rest of the function (0 = unlimited)"),
+    cl::init(0));
+
 static cl::opt<bool> ConsiderLocalIntervalCost(
     "consider-local-interval-cost", cl::Hidden,
     cl::desc("Consider the cost of local intervals created by a split "
@@ -411,6 +418,42 @@ class RAGreedy : public MachineFunctionPass,
   /// Set of broken hints that may be reconciled later because of eviction.
   SmallSetVector<LiveInterval *, 8> SetOfBrokenHints;
 
+  /// Keeps the compile time of huge functions in check. Once the eviction and
+  /// split attempts exceed the budget, region splitting is disabled, and once
+  /// they exceed twice the budget, live ranges that can't be assigned are
+  /// spilled right away, as by a linear scan allocator.
+  class AttemptBudget {
+  public:
+    enum Stage { AB_Full, AB_NoRegionSplit, AB_AssignOrSpill };
+
+    /// Starts over with a budget of \p Budget attempts, or no limit if 0.
+    void reset(uint64_t Budget) {
+      Limit = Budget;
+      Used = 0;
+      CurStage = AB_Full;
+    }
+
+    /// Records an eviction or split attempt.
+    void recordAttempt() {
+      ++Used;
+      if (!Limit || CurStage == AB_AssignOrSpill)
+        return;
+      if (Used > Limit * (CurStage + 1))
+        CurStage = Stage(CurStage + 1);
+    }
+
+    Stage getStage() const { return CurStage; }
+    uint64_t getLimit() const { return Limit; }
+    uint64_t getUsed() const { return Used; }
+
+  private:
+    uint64_t Limit = 0;
+    uint64_t Used = 0;
+    Stage CurStage = AB_Full;
+  };
+
+  AttemptBudget Budget;
+
 public:
   RAGreedy();
 
@@ -553,6 +596,9 @@ private:
                                    FoldedSpills);
     }
   }
+
+  /// Report the time allocation took and whether it ran out of budget.
+  void reportCompileTime(double Seconds);
 };
 
 } // end anonymous namespace
@@ -2494,7 +2540,8 @@ unsigned RAGreedy::trySplit(LiveInterval &VirtReg, AllocationOrder &Order,
   // First try to split around a region spanning multiple blocks. RS_Split2
   // ranges already made dubious progress with region splitting, so they go
   // straight to single block splitting.
-  if (getStage(VirtReg) < RS_Split2) {
+  if (getStage(VirtReg) < RS_Split2 &&
+      Budget.getStage() == AttemptBudget::AB_Full) {
     unsigned PhysReg = tryRegionSplit(VirtReg, Order, NewVRegs);
     if (PhysReg || !NewVRegs.empty())
       return PhysReg;
@@ -3060,10 +3107,17 @@ unsigned RAGreedy::selectOrSplitImpl(LiveInterval &VirtReg,
   LLVM_DEBUG(dbgs() << StageName[Stage] << " Cascade "
                     << ExtraRegInfo[VirtReg.reg].Cascade << '\n');
 
+  // Out of budget, spill what can't be assigned. Unspillable ranges still get
+  // to evict, as they might not be allocatable otherwise.
+  bool AssignOrSpill =
+      Budget.getStage() == AttemptBudget::AB_AssignOrSpill &&
+      VirtReg.isSpillable() && Stage < RS_Done;
+
   // Try to evict a less worthy live range, but only for ranges from the primary
   // queue. The RS_Split ranges already failed to do this, and they should not
   // get a second chance until they have been split.
-  if (Stage != RS_Split)
+  if (Stage != RS_Split && !AssignOrSpill) {
+    Budget.recordAttempt();
     if (unsigned PhysReg =
             tryEvict(VirtReg, Order, NewVRegs, CostPerUseLimit,
                      FixedRegisters)) {
@@ -3080,21 +3134,23 @@ unsigned RAGreedy::selectOrSplitImpl(LiveInterval &VirtReg,
       LastEvicted.clearEvicteeInfo(VirtReg.reg);
       return PhysReg;
     }
+  }
 
   assert((NewVRegs.empty() || Depth) && "Cannot append to existing NewVRegs");
 
   // The first time we see a live range, don't try to split or spill.
   // Wait until the second time, when all smaller ranges have been allocated.
   // This gives a better picture of the interference to split around.
-  if (Stage < RS_Split) {
+  if (Stage < RS_Split && !AssignOrSpill) {
     setStage(VirtReg, RS_Split);
     LLVM_DEBUG(dbgs() << "wait for second round\n");
     NewVRegs.push_back(VirtReg.reg);
     return 0;
   }
 
-  if (Stage < RS_Spill) {
+  if (Stage < RS_Spill && !AssignOrSpill) {
     // Try splitting VirtReg or interferences.
+    Budget.recordAttempt();
     unsigned NewVRegSizeBefore = NewVRegs.size();
     unsigned PhysReg = trySplit(VirtReg, Order, NewVRegs, FixedRegisters);
     if (PhysReg || (NewVRegs.size() - NewVRegSizeBefore)) {
@@ -3207,10 +3263,31 @@ void RAGreedy::reportNumberOfSplillsReloads(MachineLoop *L, unsigned &Reloads,
   }
 }
 
+void RAGreedy::reportCompileTime(double Seconds) {
+  using namespace ore;
+
+  ORE->emit([&]() {
+    MachineOptimizationRemarkAnalysis R(DEBUG_TYPE, "CompileTime",
+                                        MF->getFunction().getSubprogram(),
+                                        &MF->front());
+    R << "allocated registers in "
+      << NV("Milliseconds", uint64_t(Seconds * 1000)) << " ms with "
+      << NV("NumAttempts", Budget.getUsed()) << " eviction and split attempts";
+    if (Budget.getStage() != AttemptBudget::AB_Full)
+      R << ", exceeding the budget of " << NV("Budget", Budget.getLimit())
+        << (Budget.getStage() == AttemptBudget::AB_NoRegionSplit
+                ? ": disabled region splitting"
+                : ": spilled live ranges that could not be assigned");
+    return R;
+  });
+}
+
 bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   LLVM_DEBUG(dbgs() << "********** GREEDY REGISTER ALLOCATION **********\n"
                     << "********** Function: " << mf.getName() << '\n');
 
+  double StartTime = TimeRecord::getCurrentTime(/*Start=*/true).getWallTime();
+
   MF = &mf;
   TRI = MF->getSubtarget().getRegisterInfo();
   TII = MF->getSubtarget().getInstrInfo();
@@ -3255,11 +3332,14 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   GlobalCand.resize(32);  // This will grow as needed.
   SetOfBrokenHints.clear();
   LastEvicted.clear();
+  Budget.reset(uint64_t(AttemptBudgetPerVReg) * MRI->getNumVirtRegs());
 
   allocatePhysRegs();
   tryHintsRecoloring();
   postOptimization();
   reportNumberOfSplillsReloads();
+  reportCompileTime(
+      TimeRecord::getCurrentTime(/*Start=*/false).getWallTime() - StartTime);
 
   releaseMemory();
   return true;
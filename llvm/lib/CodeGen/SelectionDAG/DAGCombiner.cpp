@@ -144,23 +144,21 @@ namespace {
     /// due to nodes being deleted from the underlying DAG.
     SmallVector<SDNode *, 64> Worklist;
 
-    /// Mapping from an SDNode to its position on the worklist.
+    /// The position of each node on the worklist is kept in the node itself,
+    /// see SDNode::getCombinerWorklistIndex(), rather than in a map, as it is
+    /// queried for every node added to the worklist.
     ///
     /// This is used to find and remove nodes from the worklist (by nulling
     /// them) when they are deleted from the underlying DAG. It relies on
-    /// stable indices of nodes within the worklist.
-    DenseMap<SDNode *, unsigned> WorklistMap;
+    /// stable indices of nodes within the worklist. Nodes that were combined
+    /// (at least once) and aren't on the worklist have the index -2, which
+    /// allows us to reliably add any operands of a DAG node which have not yet
+    /// been combined to the worklist.
     /// This records all nodes attempted to add to the worklist since we
     /// considered a new worklist entry. As we keep do not add duplicate nodes
     /// in the worklist, this is different from the tail of the worklist.
     SmallSetVector<SDNode *, 32> PruningList;
 
-    /// Set of nodes which have been combined (at least once).
-    ///
-    /// This is used to allow us to reliably add any operands of a DAG node
-    /// which have not yet been combined to the worklist.
-    SmallPtrSet<SDNode *, 32> CombinedNodes;
-
     /// Map from candidate StoreNode to the pair of RootNode and count.
     /// The count is used to track how many times we have seen the StoreNode
     /// with the same RootNode bail out in dependence check. If we have seen
@@ -202,10 +200,10 @@ namespace {
       }
 
       if (N) {
-        bool GoodWorklistEntry = WorklistMap.erase(N);
-        (void)GoodWorklistEntry;
-        assert(GoodWorklistEntry &&
-               "Found a worklist entry without a corresponding map entry!");
+        assert(N->getCombinerWorklistIndex() >= 0 &&
+               "Found a worklist entry without a corresponding index!");
+        // The node is about to be combined.
+        N->setCombinerWorklistIndex(-2);
       }
       return N;
     }
@@ -234,7 +232,10 @@ namespace {
 
     /// Add to the worklist making sure its instance is at the back (next to be
     /// processed.)
-    void AddToWorklist(SDNode *N) {
+    ///
+    /// If \p SkipIfCombined is set, nodes that were already combined are left
+    /// alone.
+    void AddToWorklist(SDNode *N, bool SkipIfCombined = false) {
       assert(N->getOpcode() != ISD::DELETED_NODE &&
              "Deleted Node added to Worklist");
 
@@ -243,25 +244,31 @@ namespace {
       if (N->getOpcode() == ISD::HANDLENODE)
         return;
 
+      int Index = N->getCombinerWorklistIndex();
+      if (SkipIfCombined && Index == -2)
+        return;
+
       ConsiderForPruning(N);
 
-      if (WorklistMap.insert(std::make_pair(N, Worklist.size())).second)
-        Worklist.push_back(N);
+      if (Index >= 0)
+        return;
+      N->setCombinerWorklistIndex(Worklist.size());
+      Worklist.push_back(N);
     }
 
     /// Remove all instances of N from the worklist.
     void removeFromWorklist(SDNode *N) {
-      CombinedNodes.erase(N);
       PruningList.remove(N);
       StoreRootCountMap.erase(N);
 
-      auto It = WorklistMap.find(N);
-      if (It == WorklistMap.end())
+      int Index = N->getCombinerWorklistIndex();
+      // The node might be combined again if its storage is reused.
+      N->setCombinerWorklistIndex(-1);
+      if (Index < 0)
         return; // Not in the worklist.
 
       // Null out the entry rather than erasing it to avoid a linear operation.
-      Worklist[It->second] = nullptr;
-      WorklistMap.erase(It);
+      Worklist[Index] = nullptr;
     }
 
     void deleteAndRecombine(SDNode *N);
@@ -1675,12 +1682,11 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
     LLVM_DEBUG(dbgs() << "\nCombining: "; N->dump(&DAG));
 
     // Add any operands of the new node which have not yet been combined to the
-    // worklist as well. Because the worklist uniques things already, this
-    // won't repeatedly process the same operand.
-    CombinedNodes.insert(N);
+    // worklist as well. getNextWorklistEntry() flagged N as combined. Because
+    // the worklist uniques things already, this won't repeatedly process the
+    // same operand.
     for (const SDValue &ChildN : N->op_values())
-      if (!CombinedNodes.count(ChildN.getNode()))
-        AddToWorklist(ChildN.getNode());
+      AddToWorklist(ChildN.getNode(), /*SkipIfCombined=*/true);
 
     SDValue RV = combine(N);
 
@@ -1,4 +1,4 @@
-//===- tools/dsymutil/CompileUnit.h - Dwarf compile unit ------------------===//
+//===- DWARFLinkerCompileUnit.cpp -----------------------------------------===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,11 +6,10 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "CompileUnit.h"
-#include "DeclContext.h"
+#include "llvm/DWARFLinker/DWARFLinkerCompileUnit.h"
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
 
 namespace llvm {
-namespace dsymutil {
 
 /// Check if the DIE at \p Idx is in the scope of a function.
 static bool inFunctionScope(CompileUnit &U, unsigned Idx) {
@@ -22,6 +21,35 @@ static bool inFunctionScope(CompileUnit &U, unsigned Idx) {
   return false;
 }
 
+CompileUnit::CompileUnit(DWARFUnit &OrigUnit, unsigned ID, bool CanUseODR,
+                         StringRef ClangModuleName)
+    : OrigUnit(OrigUnit), ID(ID), Ranges(RangeAlloc),
+      ClangModuleName(ClangModuleName) {
+  Info.resize(OrigUnit.getNumDIEs());
+
+  auto CUDie = OrigUnit.getUnitDIE(false);
+  if (!CUDie) {
+    HasODR = false;
+    return;
+  }
+  if (auto Lang = dwarf::toUnsigned(CUDie.find(dwarf::DW_AT_language)))
+    HasODR = CanUseODR && (*Lang == dwarf::DW_LANG_C_plus_plus ||
+                           *Lang == dwarf::DW_LANG_C_plus_plus_03 ||
+                           *Lang == dwarf::DW_LANG_C_plus_plus_11 ||
+                           *Lang == dwarf::DW_LANG_C_plus_plus_14 ||
+                           *Lang == dwarf::DW_LANG_ObjC_plus_plus);
+  else
+    HasODR = false;
+}
+
+CompileUnit::~CompileUnit() = default;
+
+uint32_t CompileUnit::noteODRContext(const DeclContext *Ctxt, uint32_t Idx) {
+  return SeenODRContexts.try_emplace(Ctxt, Idx).first->second;
+}
+
+void CompileUnit::clearODRContexts() { SeenODRContexts.shrink_and_clear(); }
+
 uint16_t CompileUnit::getLanguage() {
   if (!Language) {
     DWARFDie CU = getOrigUnit().getUnitDIE();
@@ -142,5 +170,4 @@ void CompileUnit::addTypeAccelerator(const DIE *Die,
   Pubtypes.emplace_back(Name, Die, QualifiedNameHash, ObjcClassImplementation);
 }
 
-} // namespace dsymutil
 } // namespace llvm
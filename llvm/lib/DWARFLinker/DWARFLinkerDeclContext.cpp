@@ -1,4 +1,4 @@
-//===- tools/dsymutil/DeclContext.cpp - Declaration context ---------------===//
+//===- DWARFLinkerDeclContext.cpp -----------------------------------------===//
 //
 // Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
 // See https://llvm.org/LICENSE.txt for license information.
@@ -6,15 +6,14 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "DeclContext.h"
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFDie.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
 
 namespace llvm {
-namespace dsymutil {
 
-/// Set the last DIE/CU a context was seen in and, possibly invalidate the
+/// Record the DIE a context was seen at in \p U and, possibly invalidate the
 /// context if it is ambiguous.
 ///
 /// In the current implementation, we don't handle overloaded functions well,
@@ -29,16 +28,13 @@ namespace dsymutil {
 /// If a context that is not a namespace appears twice in the same CU, we know
 /// it is ambiguous. Make it invalid.
 bool DeclContext::setLastSeenDIE(CompileUnit &U, const DWARFDie &Die) {
-  if (LastSeenCompileUnitID == U.getUniqueID()) {
-    DWARFUnit &OrigUnit = U.getOrigUnit();
-    uint32_t FirstIdx = OrigUnit.getDIEIndex(LastSeenDIE);
-    U.getInfo(FirstIdx).Ctxt = nullptr;
-    return false;
-  }
+  uint32_t Idx = U.getOrigUnit().getDIEIndex(Die);
+  uint32_t FirstIdx = U.noteODRContext(this, Idx);
+  if (FirstIdx == Idx)
+    return true;
 
-  LastSeenCompileUnitID = U.getUniqueID();
-  LastSeenDIE = Die;
-  return true;
+  U.getInfo(FirstIdx).Ctxt = nullptr;
+  return false;
 }
 
 PointerIntPair<DeclContext *, 1> DeclContextTree::getChildDeclContext(
@@ -146,6 +142,7 @@ PointerIntPair<DeclContext *, 1> DeclContextTree::getChildDeclContext(
               assert(FoundFileName && "Must get file name from line table");
               // Second level of caching, this time based on the file's parent
               // path.
+              std::lock_guard<std::mutex> Lock(Mutex);
               FileRef = PathResolver.resolve(File, StringPool);
               U.setResolvedPath(FileNum, FileRef);
             }
@@ -176,35 +173,37 @@ PointerIntPair<DeclContext *, 1> DeclContextTree::getChildDeclContext(
     Hash = hash_combine(Hash, FileRef);
 
   // Now look if this context already exists.
-  DeclContext Key(Hash, Line, ByteSize, Tag, NameRef, FileRef, Context);
-  auto ContextIter = Contexts.find(&Key);
-
-  if (ContextIter == Contexts.end()) {
-    // The context wasn't found.
-    bool Inserted;
-    DeclContext *NewContext =
-        new (Allocator) DeclContext(Hash, Line, ByteSize, Tag, NameRef, FileRef,
-                                    Context, DIE, U.getUniqueID());
-    std::tie(ContextIter, Inserted) = Contexts.insert(NewContext);
-    assert(Inserted && "Failed to insert DeclContext");
-    (void)Inserted;
-  } else if (Tag != dwarf::DW_TAG_namespace &&
-             !(*ContextIter)->setLastSeenDIE(U, DIE)) {
+  DeclContext *Ctxt;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    DeclContext Key(Hash, Line, ByteSize, Tag, NameRef, FileRef, Context);
+    auto ContextIter = Contexts.find(&Key);
+    if (ContextIter == Contexts.end()) {
+      // The context wasn't found.
+      bool Inserted;
+      DeclContext *NewContext = new (Allocator)
+          DeclContext(Hash, Line, ByteSize, Tag, NameRef, FileRef, Context);
+      std::tie(ContextIter, Inserted) = Contexts.insert(NewContext);
+      assert(Inserted && "Failed to insert DeclContext");
+      (void)Inserted;
+    }
+    Ctxt = *ContextIter;
+  }
+
+  if (Tag != dwarf::DW_TAG_namespace && !Ctxt->setLastSeenDIE(U, DIE)) {
     // The context was found, but it is ambiguous with another context
     // in the same file. Mark it invalid.
-    return PointerIntPair<DeclContext *, 1>(*ContextIter, /* Invalid= */ 1);
+    return PointerIntPair<DeclContext *, 1>(Ctxt, /* Invalid= */ 1);
   }
 
-  assert(ContextIter != Contexts.end());
   // FIXME: dsymutil-classic compatibility. Union types aren't
   // uniques, but their children might be.
   if ((Tag == dwarf::DW_TAG_subprogram &&
        Context.getTag() != dwarf::DW_TAG_structure_type &&
        Context.getTag() != dwarf::DW_TAG_class_type) ||
       (Tag == dwarf::DW_TAG_union_type))
-    return PointerIntPair<DeclContext *, 1>(*ContextIter, /* Invalid= */ 1);
+    return PointerIntPair<DeclContext *, 1>(Ctxt, /* Invalid= */ 1);
 
-  return PointerIntPair<DeclContext *, 1>(*ContextIter);
+  return PointerIntPair<DeclContext *, 1>(Ctxt);
 }
-} // namespace dsymutil
 } // namespace llvm
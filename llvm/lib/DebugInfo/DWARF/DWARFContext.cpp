@@ -45,6 +45,8 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -642,8 +644,13 @@ DWARFDie DWARFContext::getDIEForOffset(uint64_t Offset) {
 }
 
 bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts) {
+  return verify(OS, DumpOpts, 1);
+}
+
+bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts,
+                          unsigned NumThreads) {
   bool Success = true;
-  DWARFVerifier verifier(OS, *this, DumpOpts);
+  DWARFVerifier verifier(OS, *this, DumpOpts, NumThreads);
 
   Success &= verifier.handleDebugAbbrev();
   if (DumpOpts.DumpType & DIDT_DebugInfo)
@@ -654,6 +661,22 @@ bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts) {
   return Success;
 }
 
+void DWARFContext::extractAllUnitDIEs(unsigned NumThreads) {
+  parseNormalUnits();
+  if (NumThreads == 1) {
+    for (const auto &U : NormalUnits)
+      U->getUnitDIE(/*ExtractUnitDIEOnly=*/false);
+    return;
+  }
+  ThreadPool Pool(NumThreads ? NumThreads
+                             : llvm::heavyweight_hardware_concurrency());
+  for (const auto &U : NormalUnits) {
+    DWARFUnit *Unit = U.get();
+    Pool.async([Unit] { Unit->getUnitDIE(/*ExtractUnitDIEOnly=*/false); });
+  }
+  Pool.wait();
+}
+
 const DWARFUnitIndex &DWARFContext::getCUIndex() {
   if (CUIndex)
     return *CUIndex;
@@ -840,6 +863,7 @@ DWARFContext::getLineTableForUnit(DWARFUnit *U) {
 
 Expected<const DWARFDebugLine::LineTable *> DWARFContext::getLineTableForUnit(
     DWARFUnit *U, std::function<void(Error)> RecoverableErrorCallback) {
+  std::lock_guard<std::mutex> Lock(LineMutex);
   if (!Line)
     Line.reset(new DWARFDebugLine);
 
@@ -177,9 +177,6 @@ bool DWARFFormValue::skipValue(dwarf::Form Form, DataExtractor DebugInfoData,
 
     // signed or unsigned LEB 128 values.
     case DW_FORM_sdata:
-      DebugInfoData.getSLEB128(OffsetPtr);
-      return true;
-
     case DW_FORM_udata:
     case DW_FORM_ref_udata:
     case DW_FORM_strx:
@@ -188,7 +185,7 @@ bool DWARFFormValue::skipValue(dwarf::Form Form, DataExtractor DebugInfoData,
     case DW_FORM_rnglistx:
     case DW_FORM_GNU_addr_index:
     case DW_FORM_GNU_str_index:
-      DebugInfoData.getULEB128(OffsetPtr);
+      DebugInfoData.skipLEB128(OffsetPtr);
       return true;
 
     case DW_FORM_indirect:
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/DebugInfo/DWARF/DWARFUnit.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/DebugInfo/DWARF/DWARFAbbreviationDeclaration.h"
@@ -409,10 +410,22 @@ void DWARFUnit::extractDIEsIfNeeded(bool CUDieOnly) {
 }
 
 Error DWARFUnit::tryExtractDIEsIfNeeded(bool CUDieOnly) {
-  if ((CUDieOnly && !DieArray.empty()) ||
-      DieArray.size() > 1)
+  if (ExtractedAllDIEs.load(std::memory_order_acquire) ||
+      (CUDieOnly && ExtractedUnitDIE.load(std::memory_order_acquire)))
     return Error::success(); // Already parsed.
 
+  std::lock_guard<std::mutex> Lock(ExtractDIEsMutex);
+  if (ExtractedAllDIEs || (CUDieOnly && ExtractedUnitDIE))
+    return Error::success(); // Parsed by another thread.
+
+  // Only publish the DIEs once the unit is set up from the unit DIE below.
+  auto SetExtracted = make_scope_exit([&] {
+    if (!DieArray.empty())
+      ExtractedUnitDIE.store(true, std::memory_order_release);
+    if (!CUDieOnly)
+      ExtractedAllDIEs.store(true, std::memory_order_release);
+  });
+
   bool HasCUDie = !DieArray.empty();
   extractDIEsToVector(!HasCUDie, !CUDieOnly, DieArray);
 
@@ -549,6 +562,8 @@ void DWARFUnit::clearDIEs(bool KeepCUDie) {
     DieArray.resize((unsigned)KeepCUDie);
     DieArray.shrink_to_fit();
   }
+  ExtractedUnitDIE = !DieArray.empty();
+  ExtractedAllDIEs = false;
 }
 
 Expected<DWARFAddressRangesVector>
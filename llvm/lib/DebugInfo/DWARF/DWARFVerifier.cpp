@@ -16,6 +16,8 @@
 #include "llvm/DebugInfo/DWARF/DWARFSection.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -282,6 +284,8 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
   bool hasDIE = DebugInfoData.isValidOffset(Offset);
   DWARFUnitVector TypeUnitVector;
   DWARFUnitVector CompileUnitVector;
+  // The units whose contents are left to verify in parallel.
+  std::vector<DWARFUnit *> Units;
   while (hasDIE) {
     OffsetStart = Offset;
     if (!verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
@@ -320,7 +324,10 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
       }
       default: { llvm_unreachable("Invalid UnitType."); }
       }
-      NumDebugInfoErrors += verifyUnitContents(*Unit);
+      if (NumThreads == 1)
+        NumDebugInfoErrors += verifyUnitContents(*Unit);
+      else
+        Units.push_back(Unit);
     }
     hasDIE = DebugInfoData.isValidOffset(Offset);
     ++UnitIdx;
@@ -331,10 +338,55 @@ unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S,
   }
   if (!isHeaderChainValid)
     ++NumDebugInfoErrors;
+  if (!Units.empty())
+    NumDebugInfoErrors += verifyUnitContentsInParallel(Units);
   NumDebugInfoErrors += verifyDebugInfoReferences();
   return NumDebugInfoErrors;
 }
 
+unsigned
+DWARFVerifier::verifyUnitContentsInParallel(ArrayRef<DWARFUnit *> Units) {
+  ThreadPool Pool(NumThreads ? NumThreads
+                             : llvm::heavyweight_hardware_concurrency());
+
+  // Extract all DIEs first, so that none of them move while another unit
+  // refers to them.
+  for (DWARFUnit *Unit : Units)
+    Pool.async([Unit] { Unit->getUnitDIE(/*ExtractUnitDIEOnly=*/false); });
+  Pool.wait();
+
+  // Create the tables that the checks parse lazily up front.
+  DCtx.getDebugLoc();
+
+  struct UnitResult {
+    std::string Output;
+    unsigned NumErrors = 0;
+    std::map<uint64_t, std::set<uint64_t>> References;
+  };
+  std::vector<UnitResult> Results(Units.size());
+  for (size_t I = 0, E = Units.size(); I != E; ++I) {
+    Pool.async([this, &Units, &Results, I] {
+      UnitResult &Result = Results[I];
+      raw_string_ostream UnitOS(Result.Output);
+      DWARFVerifier UnitVerifier(UnitOS, DCtx, DumpOpts);
+      Result.NumErrors = UnitVerifier.verifyUnitContents(*Units[I]);
+      UnitOS.flush();
+      Result.References = std::move(UnitVerifier.ReferenceToDIEOffsets);
+    });
+  }
+  Pool.wait();
+
+  unsigned NumErrors = 0;
+  for (UnitResult &Result : Results) {
+    OS << Result.Output;
+    NumErrors += Result.NumErrors;
+    for (auto &Ref : Result.References)
+      ReferenceToDIEOffsets[Ref.first].insert(Ref.second.begin(),
+                                              Ref.second.end());
+  }
+  return NumErrors;
+}
+
 bool DWARFVerifier::handleDebugInfo() {
   const DWARFObject &DObj = DCtx.getDWARFObj();
   unsigned NumErrors = 0;
@@ -788,9 +840,9 @@ void DWARFVerifier::verifyDebugLineRows() {
 }
 
 DWARFVerifier::DWARFVerifier(raw_ostream &S, DWARFContext &D,
-                             DIDumpOptions DumpOpts)
-    : OS(S), DCtx(D), DumpOpts(std::move(DumpOpts)), IsObjectFile(false),
-      IsMachOObject(false) {
+                             DIDumpOptions DumpOpts, unsigned NumThreads)
+    : OS(S), DCtx(D), DumpOpts(std::move(DumpOpts)), NumThreads(NumThreads),
+      IsObjectFile(false), IsMachOObject(false) {
   if (const auto *F = DCtx.getDWARFObj().getFile()) {
     IsObjectFile = F->isRelocatableObject();
     IsMachOObject = F->isMachO();
@@ -0,0 +1,188 @@
+//===- BreakpadTransformer.cpp ----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/BreakpadTransformer.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/Header.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
+
+using namespace llvm;
+using namespace gsym;
+
+/// Remove the first space separated token from \a Rest and return it.
+static StringRef consumeToken(StringRef &Rest) {
+  StringRef Token;
+  std::tie(Token, Rest) = Rest.split(' ');
+  return Token;
+}
+
+/// Remove the first token from \a Rest and parse it as a number.
+static bool consumeNumber(StringRef &Rest, unsigned Radix, uint64_t &Value) {
+  return !consumeToken(Rest).getAsInteger(Radix, Value);
+}
+
+/// Remove the optional "m" marker of FUNC and PUBLIC records, which says
+/// that the function has several names.
+static void consumeMultiple(StringRef &Rest) {
+  if (Rest.startswith("m "))
+    Rest = Rest.drop_front(2);
+}
+
+llvm::Error BreakpadTransformer::convert(StringRef Text, raw_ostream &Log,
+                                         GsymCreator &Gsym) {
+  DenseMap<uint64_t, uint32_t> Files;
+  DenseMap<uint64_t, uint32_t> InlineOrigins;
+  Optional<FunctionInfo> Func;
+  // The innermost InlineInfo of each nesting level of the current function.
+  std::vector<InlineInfo *> InlinePath;
+  const size_t NumBefore = Gsym.getNumFunctionInfos();
+
+  auto FinishFunction = [&]() {
+    if (!Func)
+      return;
+    llvm::sort(Func->Lines);
+    if (Func->Inline.Children.empty())
+      Func->Inline.clear();
+    Gsym.addFunctionInfo(std::move(*Func));
+    Func.reset();
+    InlinePath.clear();
+  };
+
+  uint64_t LineNo = 0;
+  while (!Text.empty()) {
+    StringRef Line;
+    std::tie(Line, Text) = Text.split('\n');
+    ++LineNo;
+    Line = Line.rtrim();
+    if (Line.empty())
+      continue;
+
+    auto Malformed = [&](StringRef Kind) {
+      Log << "warning: line " << LineNo << ": malformed " << Kind
+          << " record\n";
+    };
+
+    StringRef Rest = Line;
+    StringRef Record = consumeToken(Rest);
+
+    if (Record == "MODULE") {
+      // MODULE <os> <arch> <id> <name>
+      consumeToken(Rest);
+      consumeToken(Rest);
+      StringRef ID = consumeToken(Rest);
+      std::vector<uint8_t> UUID;
+      for (size_t I = 0; I + 1 < ID.size() && UUID.size() < GSYM_MAX_UUID_SIZE;
+           I += 2) {
+        uint8_t Byte;
+        if (ID.substr(I, 2).getAsInteger(16, Byte))
+          break;
+        UUID.push_back(Byte);
+      }
+      Gsym.setUUID(UUID);
+    } else if (Record == "FILE") {
+      // FILE <number> <name>
+      uint64_t FileNum;
+      if (!consumeNumber(Rest, 10, FileNum)) {
+        Malformed("FILE");
+        continue;
+      }
+      Files[FileNum] = Gsym.insertFile(Rest);
+    } else if (Record == "INLINE_ORIGIN") {
+      // INLINE_ORIGIN <id> <name>
+      uint64_t ID;
+      if (!consumeNumber(Rest, 10, ID)) {
+        Malformed("INLINE_ORIGIN");
+        continue;
+      }
+      InlineOrigins[ID] = Gsym.insertString(Rest);
+    } else if (Record == "FUNC") {
+      // FUNC [m] <address> <size> <parameter size> <name>
+      FinishFunction();
+      consumeMultiple(Rest);
+      uint64_t Addr, Size, ParamSize;
+      if (!consumeNumber(Rest, 16, Addr) || !consumeNumber(Rest, 16, Size) ||
+          !consumeNumber(Rest, 16, ParamSize) || Rest.empty()) {
+        Malformed("FUNC");
+        continue;
+      }
+      Func = FunctionInfo(Addr, Size, Gsym.insertString(Rest));
+      // The top level InlineInfo stands for the function itself.
+      Func->Inline.Ranges.insert(Func->Range);
+    } else if (Record == "INLINE" && Func) {
+      // INLINE <nest level> <call line> <call file> <origin id>
+      //        [<address> <size>]+
+      uint64_t Depth, CallLine, CallFile, Origin;
+      if (!consumeNumber(Rest, 10, Depth) ||
+          !consumeNumber(Rest, 10, CallLine) ||
+          !consumeNumber(Rest, 10, CallFile) ||
+          !consumeNumber(Rest, 10, Origin) || Depth > InlinePath.size()) {
+        Malformed("INLINE");
+        continue;
+      }
+      InlineInfo &Parent = Depth == 0 ? Func->Inline : *InlinePath[Depth - 1];
+      InlineInfo II;
+      II.Name = InlineOrigins.lookup(Origin);
+      II.CallFile = Files.lookup(CallFile);
+      II.CallLine = static_cast<uint32_t>(CallLine);
+      while (!Rest.empty()) {
+        uint64_t Addr, Size;
+        if (!consumeNumber(Rest, 16, Addr) || !consumeNumber(Rest, 16, Size))
+          break;
+        // Only keep the ranges that are inside the parent, as the encoding
+        // requires it.
+        AddressRange Range(Addr, Addr + Size);
+        if (Parent.Ranges.contains(Range))
+          II.Ranges.insert(Range);
+      }
+      if (II.Ranges.empty()) {
+        Malformed("INLINE");
+        continue;
+      }
+      Parent.Children.push_back(std::move(II));
+      InlinePath.resize(Depth);
+      InlinePath.push_back(&Parent.Children.back());
+    } else if (Record == "PUBLIC") {
+      // PUBLIC [m] <address> <parameter size> <name>
+      FinishFunction();
+      consumeMultiple(Rest);
+      uint64_t Addr, ParamSize;
+      if (!consumeNumber(Rest, 16, Addr) ||
+          !consumeNumber(Rest, 16, ParamSize) || Rest.empty()) {
+        Malformed("PUBLIC");
+        continue;
+      }
+      Gsym.addFunctionInfo(FunctionInfo(Addr, 0, Gsym.insertString(Rest)));
+    } else if (Func && isHexDigit(Record[0])) {
+      // Line records have no name and only appear after a FUNC record:
+      // <address> <size> <line> <file number>
+      uint64_t Addr, Size, LineNum, FileNum;
+      if (Record.getAsInteger(16, Addr) || !consumeNumber(Rest, 16, Size) ||
+          !consumeNumber(Rest, 10, LineNum) ||
+          !consumeNumber(Rest, 10, FileNum)) {
+        Malformed("line");
+        continue;
+      }
+      Func->Lines.push_back(LineEntry(Addr, Files.lookup(FileNum),
+                                      static_cast<uint32_t>(LineNum)));
+    } else {
+      // Any other record, like STACK or INFO, ends the current function.
+      FinishFunction();
+    }
+  }
+  FinishFunction();
+
+  const size_t FunctionsAdded = Gsym.getNumFunctionInfos() - NumBefore;
+  Log << "Loaded " << FunctionsAdded << " functions from Breakpad.\n";
+  return Error::success();
+}
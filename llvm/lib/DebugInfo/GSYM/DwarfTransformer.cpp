@@ -0,0 +1,249 @@
+//===- DwarfTransformer.cpp -------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/DwarfTransformer.h"
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/InlineInfo.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace gsym;
+
+/// The per compile unit state needed while converting the DIEs of a compile
+/// unit: its line table, and the cache of the GSYM file indexes of the files
+/// of that line table.
+struct llvm::gsym::CUInfo {
+  const DWARFDebugLine::LineTable *LineTable;
+  const char *CompDir;
+  std::vector<uint32_t> FileCache;
+
+  CUInfo(DWARFContext &DICtx, DWARFUnit *CU) {
+    LineTable = DICtx.getLineTableForUnit(CU);
+    CompDir = CU->getCompilationDir();
+  }
+
+  /// Convert a DWARF file index of the line table of this compile unit into
+  /// a GSYM file index, adding the file to \a Gsym if needed.
+  uint32_t DWARFToGSYMFileIndex(GsymCreator &Gsym, uint64_t DwarfFileIdx) {
+    if (!LineTable)
+      return 0;
+    if (DwarfFileIdx >= FileCache.size())
+      FileCache.resize(DwarfFileIdx + 1, UINT32_MAX);
+    uint32_t &GsymFileIdx = FileCache[DwarfFileIdx];
+    if (GsymFileIdx != UINT32_MAX)
+      return GsymFileIdx;
+    std::string File;
+    if (LineTable->getFileNameByIndex(
+            DwarfFileIdx, CompDir,
+            DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath, File))
+      GsymFileIdx = Gsym.insertFile(File);
+    else
+      GsymFileIdx = 0;
+    return GsymFileIdx;
+  }
+};
+
+/// Returns true if \a Die contains DW_TAG_inlined_subroutine DIEs, without
+/// looking into nested subprograms.
+static bool hasInlineInfo(DWARFDie Die, uint32_t Depth) {
+  switch (Die.getTag()) {
+  case dwarf::DW_TAG_inlined_subroutine:
+    return true;
+  case dwarf::DW_TAG_subprogram:
+    if (Depth > 0)
+      return false;
+    break;
+  default:
+    break;
+  }
+  for (DWARFDie ChildDie : Die.children())
+    if (hasInlineInfo(ChildDie, Depth + 1))
+      return true;
+  return false;
+}
+
+static void parseInlineInfo(GsymCreator &Gsym, CUInfo &CUI, DWARFDie Die,
+                            uint32_t Depth, InlineInfo &Parent) {
+  const dwarf::Tag Tag = Die.getTag();
+  if (Tag == dwarf::DW_TAG_inlined_subroutine) {
+    InlineInfo II;
+    if (Expected<DWARFAddressRangesVector> RangesOrError =
+            Die.getAddressRanges()) {
+      // Only keep the ranges that are inside the parent, as the encoding
+      // requires it.
+      for (const DWARFAddressRange &Range : RangesOrError.get()) {
+        AddressRange InlineRange(Range.LowPC, Range.HighPC);
+        if (Parent.Ranges.contains(InlineRange))
+          II.Ranges.insert(InlineRange);
+      }
+    } else {
+      consumeError(RangesOrError.takeError());
+    }
+    if (II.Ranges.empty())
+      return;
+    if (const char *Name = Die.getName(DINameKind::LinkageName))
+      II.Name = Gsym.insertString(Name);
+    II.CallFile = CUI.DWARFToGSYMFileIndex(
+        Gsym, dwarf::toUnsigned(Die.find(dwarf::DW_AT_call_file), 0));
+    II.CallLine = dwarf::toUnsigned(Die.find(dwarf::DW_AT_call_line), 0);
+    for (DWARFDie ChildDie : Die.children())
+      parseInlineInfo(Gsym, CUI, ChildDie, Depth + 1, II);
+    Parent.Children.emplace_back(std::move(II));
+    return;
+  }
+  if (Tag == dwarf::DW_TAG_subprogram && Depth > 0)
+    return;
+  if (Tag == dwarf::DW_TAG_subprogram || Tag == dwarf::DW_TAG_lexical_block)
+    for (DWARFDie ChildDie : Die.children())
+      parseInlineInfo(Gsym, CUI, ChildDie, Depth + 1, Parent);
+}
+
+static void convertFunctionLineTable(GsymCreator &Gsym, CUInfo &CUI,
+                                     DWARFDie Die, uint64_t SectionIndex,
+                                     FunctionInfo &FI) {
+  if (!CUI.LineTable)
+    return;
+  std::vector<uint32_t> RowVector;
+  const uint64_t StartAddress = FI.startAddress();
+  const uint64_t EndAddress = FI.endAddress();
+  if (!CUI.LineTable->lookupAddressRange({StartAddress, SectionIndex},
+                                         FI.size(), RowVector)) {
+    // Use the declaration location if there are no line table rows, so that
+    // the function at least has a source file.
+    Optional<uint64_t> DeclFile =
+        dwarf::toUnsigned(Die.findRecursively(dwarf::DW_AT_decl_file));
+    Optional<uint64_t> DeclLine =
+        dwarf::toUnsigned(Die.findRecursively(dwarf::DW_AT_decl_line));
+    if (DeclFile && DeclLine)
+      FI.Lines.push_back(
+          LineEntry(StartAddress, CUI.DWARFToGSYMFileIndex(Gsym, *DeclFile),
+                    static_cast<uint32_t>(*DeclLine)));
+    return;
+  }
+
+  for (uint32_t RowIndex : RowVector) {
+    const DWARFDebugLine::Row &Row = CUI.LineTable->Rows[RowIndex];
+    const uint64_t RowAddress = Row.Address.Address;
+    if (Row.EndSequence || RowAddress < StartAddress ||
+        RowAddress >= EndAddress)
+      continue;
+    LineEntry LE(RowAddress, CUI.DWARFToGSYMFileIndex(Gsym, Row.File),
+                 Row.Line);
+    if (!FI.Lines.empty()) {
+      LineEntry &Prev = FI.Lines.back();
+      // The last row for an address is the one that applies.
+      if (Prev.Addr == LE.Addr) {
+        Prev = LE;
+        continue;
+      }
+      // Rows that don't change the location don't need an entry.
+      if (Prev.File == LE.File && Prev.Line == LE.Line)
+        continue;
+    }
+    FI.Lines.push_back(LE);
+  }
+}
+
+void DwarfTransformer::handleDie(raw_ostream &OS, CUInfo &CUI, DWARFDie Die) {
+  if (Die.getTag() == dwarf::DW_TAG_subprogram) {
+    Expected<DWARFAddressRangesVector> RangesOrError = Die.getAddressRanges();
+    if (!RangesOrError) {
+      consumeError(RangesOrError.takeError());
+    } else if (!RangesOrError->empty()) {
+      const char *Name = Die.getName(DINameKind::LinkageName);
+      if (!Name) {
+        OS << "warning: function DIE at " << HEX64(Die.getOffset())
+           << " has no name\n";
+      } else {
+        const bool HasInlineInfo = hasInlineInfo(Die, 0);
+        for (const DWARFAddressRange &Range : *RangesOrError) {
+          // Skip empty ranges and the ranges of functions that were dead
+          // stripped by the linker.
+          if (Range.LowPC >= Range.HighPC ||
+              !Gsym.isValidTextAddress(Range.LowPC))
+            continue;
+          FunctionInfo FI(Range.LowPC, Range.HighPC - Range.LowPC,
+                          Gsym.insertString(Name));
+          convertFunctionLineTable(Gsym, CUI, Die, Range.SectionIndex, FI);
+          if (HasInlineInfo) {
+            // The top level InlineInfo stands for the function itself and
+            // has no name.
+            FI.Inline.Ranges.insert(FI.Range);
+            parseInlineInfo(Gsym, CUI, Die, 0, FI.Inline);
+            if (FI.Inline.Children.empty())
+              FI.Inline.clear();
+          }
+          Gsym.addFunctionInfo(std::move(FI));
+        }
+      }
+    }
+  }
+  for (DWARFDie ChildDie : Die.children())
+    handleDie(OS, CUI, ChildDie);
+}
+
+llvm::Error DwarfTransformer::convert(uint32_t NumThreads) {
+  const size_t NumBefore = Gsym.getNumFunctionInfos();
+  if (NumThreads == 1) {
+    // Parse all DWARF data from this thread, use the same code as the
+    // multi-threaded case below.
+    for (const auto &CU : DICtx.compile_units()) {
+      DWARFDie Die = CU->getUnitDIE(false);
+      if (!Die)
+        continue;
+      CUInfo CUI(DICtx, CU.get());
+      handleDie(Log, CUI, Die);
+    }
+  } else {
+    // The DWARF parser is not thread safe, and DIEs can refer to DIEs of
+    // other compile units. So the abbreviations are parsed first, serially,
+    // then the DIEs of each unit are extracted in parallel, and only then are
+    // the units converted in parallel.
+    for (const auto &CU : DICtx.compile_units())
+      CU->getAbbreviations();
+
+    ThreadPool Pool(NumThreads ? NumThreads
+                               : llvm::heavyweight_hardware_concurrency());
+    for (const auto &CU : DICtx.compile_units())
+      Pool.async([&CU]() { CU->getUnitDIE(false /*CUDieOnly*/); });
+    Pool.wait();
+
+    // The line tables are parsed here, serially, as parsing them updates
+    // the DWARFContext.
+    std::mutex LogMutex;
+    for (const auto &CU : DICtx.compile_units()) {
+      DWARFDie Die = CU->getUnitDIE(false);
+      if (!Die)
+        continue;
+      CUInfo CUI(DICtx, CU.get());
+      Pool.async([this, CUI, &LogMutex, Die]() mutable {
+        std::string ThreadLogStorage;
+        raw_string_ostream ThreadOS(ThreadLogStorage);
+        handleDie(ThreadOS, CUI, Die);
+        ThreadOS.flush();
+        if (!ThreadLogStorage.empty()) {
+          std::lock_guard<std::mutex> Guard(LogMutex);
+          Log << ThreadLogStorage;
+        }
+      });
+    }
+    Pool.wait();
+  }
+  const size_t FunctionsAdded = Gsym.getNumFunctionInfos() - NumBefore;
+  Log << "Loaded " << FunctionsAdded << " functions from DWARF.\n";
+  return Error::success();
+}
@@ -8,10 +8,23 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/FileWriter.h"
+#include "llvm/Support/DataExtractor.h"
+#include <inttypes.h>
 
 using namespace llvm;
 using namespace gsym;
 
+/// FunctionInfo information type that is used to encode the optional data
+/// that is associated with a FunctionInfo object.
+namespace InfoType {
+enum : uint32_t {
+  EndOfList = 0u,
+  LineTableInfo = 1u,
+  InlineInfo = 2u
+};
+} // namespace InfoType
+
 raw_ostream &llvm::gsym::operator<<(raw_ostream &OS, const FunctionInfo &FI) {
   OS << '[' << HEX64(FI.Range.Start) << '-' << HEX64(FI.Range.End) << "): "
      << "Name=" << HEX32(FI.Name) << '\n';
@@ -20,3 +33,144 @@ raw_ostream &llvm::gsym::operator<<(raw_ostream &OS, const FunctionInfo &FI) {
   OS << FI.Inline;
   return OS;
 }
+
+static llvm::Error decodeLines(DataExtractor &Data, uint64_t BaseAddr,
+                               std::vector<LineEntry> &Lines) {
+  uint64_t Offset = 0;
+  if (!Data.isValidOffset(Offset))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx64 ": missing LineTable number of entries", Offset);
+  uint64_t NumLines = Data.getULEB128(&Offset);
+  LineEntry Row(BaseAddr, 0, 0);
+  for (uint64_t I = 0; I < NumLines; ++I) {
+    if (!Data.isValidOffset(Offset))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx64 ": missing LineTable entry", Offset);
+    Row.Addr += Data.getULEB128(&Offset);
+    Row.File = (uint32_t)Data.getULEB128(&Offset);
+    Row.Line = (uint32_t)(Row.Line + Data.getSLEB128(&Offset));
+    Lines.push_back(Row);
+  }
+  return Error::success();
+}
+
+static llvm::Error encodeLines(FileWriter &O, uint64_t BaseAddr,
+                               const std::vector<LineEntry> &Lines) {
+  O.writeULEB(Lines.size());
+  LineEntry Prev(BaseAddr, 0, 0);
+  for (const auto &Row : Lines) {
+    if (Row.Addr < Prev.Addr)
+      return createStringError(std::errc::invalid_argument,
+                               "line table entries are not sorted by address");
+    O.writeULEB(Row.Addr - Prev.Addr);
+    O.writeULEB(Row.File);
+    O.writeSLEB((int64_t)Row.Line - (int64_t)Prev.Line);
+    Prev = Row;
+  }
+  return Error::success();
+}
+
+llvm::Expected<FunctionInfo> FunctionInfo::decode(DataExtractor &Data,
+                                                  uint64_t BaseAddr) {
+  FunctionInfo FI;
+  FI.Range.Start = BaseAddr;
+  uint64_t Offset = 0;
+  if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx64 ": missing FunctionInfo Size", Offset);
+  FI.Range.End = FI.Range.Start + Data.getU32(&Offset);
+  if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx64 ": missing FunctionInfo Name", Offset);
+  FI.Name = Data.getU32(&Offset);
+  if (FI.Name == 0)
+    return createStringError(std::errc::io_error,
+        "0x%8.8" PRIx64 ": invalid FunctionInfo Name value 0x%8.8x",
+        Offset - 4, FI.Name);
+  while (true) {
+    if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx64 ": missing FunctionInfo InfoType value", Offset);
+    const uint32_t IT = Data.getU32(&Offset);
+    if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx64 ": missing FunctionInfo InfoType length", Offset);
+    const uint32_t InfoLength = Data.getU32(&Offset);
+    if (!Data.isValidOffsetForDataOfSize(Offset, InfoLength))
+      return createStringError(std::errc::io_error,
+          "0x%8.8" PRIx64 ": missing FunctionInfo data for InfoType %u",
+          Offset, IT);
+    DataExtractor InfoData(Data.getData().substr(Offset, InfoLength),
+                           Data.isLittleEndian(),
+                           Data.getAddressSize());
+    switch (IT) {
+    case InfoType::EndOfList:
+      return std::move(FI);
+
+    case InfoType::LineTableInfo:
+      if (llvm::Error Err = decodeLines(InfoData, BaseAddr, FI.Lines))
+        return std::move(Err);
+      break;
+
+    case InfoType::InlineInfo:
+      if (Expected<gsym::InlineInfo> II =
+              InlineInfo::decode(InfoData, BaseAddr))
+        FI.Inline = std::move(II.get());
+      else
+        return II.takeError();
+      break;
+
+    default:
+      // Skip info types this reader doesn't know about.
+      break;
+    }
+    Offset += InfoLength;
+  }
+}
+
+llvm::Expected<uint64_t> FunctionInfo::encode(FileWriter &O) const {
+  if (!isValid())
+    return createStringError(std::errc::invalid_argument,
+        "attempted to encode invalid FunctionInfo object");
+  if (size() > UINT32_MAX)
+    return createStringError(std::errc::invalid_argument,
+        "FunctionInfo size is greater than UINT32_MAX");
+  // Users will need to know the offset of the FunctionInfo to put it into
+  // the address info offsets table.
+  const uint64_t FuncInfoOffset = O.tell();
+  O.writeU32(static_cast<uint32_t>(size()));
+  O.writeU32(Name);
+
+  // Each chunk is written with a zero length first, and the length is fixed
+  // up once the chunk data has been written.
+  auto EncodeChunk = [&](uint32_t IT,
+                         function_ref<llvm::Error()> Encode) -> llvm::Error {
+    O.writeU32(IT);
+    O.writeU32(0);
+    const uint64_t StartOffset = O.tell();
+    if (llvm::Error Err = Encode())
+      return Err;
+    const uint64_t Length = O.tell() - StartOffset;
+    if (Length > UINT32_MAX)
+      return createStringError(std::errc::invalid_argument,
+                               "FunctionInfo data is greater than UINT32_MAX");
+    O.fixup32(static_cast<uint32_t>(Length), StartOffset - 4);
+    return Error::success();
+  };
+
+  if (!Lines.empty())
+    if (llvm::Error Err = EncodeChunk(InfoType::LineTableInfo, [&] {
+          return encodeLines(O, startAddress(), Lines);
+        }))
+      return std::move(Err);
+
+  if (Inline.isValid())
+    if (llvm::Error Err = EncodeChunk(InfoType::InlineInfo, [&] {
+          return Inline.encode(O, startAddress());
+        }))
+      return std::move(Err);
+
+  O.writeU32(InfoType::EndOfList);
+  O.writeU32(0);
+  return FuncInfoOffset;
+}
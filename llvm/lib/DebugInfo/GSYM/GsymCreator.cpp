@@ -0,0 +1,234 @@
+//===- GsymCreator.cpp ------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/FileWriter.h"
+#include "llvm/DebugInfo/GSYM/Header.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+using namespace llvm;
+using namespace gsym;
+
+GsymCreator::GsymCreator() : StrTab(1, '\0') {
+  // The empty string is always at offset zero and the empty file is always
+  // at index zero.
+  StringOffsets[""] = 0;
+  Files.push_back(FileEntry());
+  FileEntryToIndex[FileEntry()] = 0;
+}
+
+uint32_t GsymCreator::insertString(StringRef S) {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  auto R = StringOffsets.try_emplace(S, StrTab.size());
+  if (R.second) {
+    StrTab.append(S.begin(), S.end());
+    StrTab.push_back('\0');
+  }
+  return R.first->second;
+}
+
+uint32_t GsymCreator::insertFile(StringRef Path, sys::path::Style Style) {
+  FileEntry FE(insertString(sys::path::parent_path(Path, Style)),
+               insertString(sys::path::filename(Path, Style)));
+  std::lock_guard<std::mutex> Guard(Mutex);
+  auto R = FileEntryToIndex.insert(std::make_pair(FE, Files.size()));
+  if (R.second)
+    Files.push_back(FE);
+  return R.first->second;
+}
+
+void GsymCreator::addFunctionInfo(FunctionInfo &&FI) {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  Funcs.emplace_back(std::move(FI));
+}
+
+bool GsymCreator::isValidTextAddress(uint64_t Addr) const {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  if (ValidTextRanges)
+    return ValidTextRanges->contains(Addr);
+  return true;
+}
+
+size_t GsymCreator::getNumFunctionInfos() const {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  return Funcs.size();
+}
+
+llvm::Error GsymCreator::save(StringRef Path,
+                              llvm::support::endianness ByteOrder) const {
+  std::error_code EC;
+  raw_fd_ostream OutStrm(Path, EC);
+  if (EC)
+    return llvm::errorCodeToError(EC);
+  FileWriter O(OutStrm, ByteOrder);
+  return encode(O);
+}
+
+llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  if (Finalized)
+    return createStringError(std::errc::invalid_argument,
+                             "already finalized");
+  Finalized = true;
+
+  // Sort function infos so we can emit sorted functions. Function infos for
+  // the same range sort the one with the most information last.
+  llvm::sort(Funcs);
+
+  std::vector<FunctionInfo> FinalFuncs;
+  FinalFuncs.reserve(Funcs.size());
+  for (auto &Curr : Funcs) {
+    if (!FinalFuncs.empty()) {
+      FunctionInfo &Prev = FinalFuncs.back();
+      if (Prev.Range == Curr.Range) {
+        // Keep the best of the function infos for the same range, which is
+        // the last one.
+        if (Prev.hasRichInfo() && Curr.hasRichInfo() && Prev != Curr)
+          OS << "warning: duplicate function info entries for range: "
+             << Curr.Range << '\n';
+        Prev = std::move(Curr);
+        continue;
+      }
+      // A function info without a size followed by one at the same address
+      // is a symbol for the same function: use the one with the size.
+      if (Prev.size() == 0 && Prev.startAddress() == Curr.startAddress()) {
+        Prev = std::move(Curr);
+        continue;
+      }
+      // A function info without a size that is inside the previous function
+      // is usually a label in that function, drop it.
+      if (Curr.size() == 0 && Prev.Range.contains(Curr.startAddress()))
+        continue;
+      // Symbols without a size extend to the next function, as this is the
+      // best guess of their extent.
+      if (Prev.size() == 0)
+        Prev.setEndAddress(Curr.startAddress());
+      else if (Prev.Range.intersects(Curr.Range))
+        OS << "warning: function info ranges overlap: " << Prev.Range
+           << " and " << Curr.Range << '\n';
+    }
+    FinalFuncs.emplace_back(std::move(Curr));
+  }
+  std::swap(Funcs, FinalFuncs);
+  return Error::success();
+}
+
+llvm::Error GsymCreator::encode(FileWriter &O) const {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  if (Funcs.empty())
+    return createStringError(std::errc::invalid_argument,
+                             "no functions to encode");
+  if (!Finalized)
+    return createStringError(std::errc::invalid_argument,
+                             "GsymCreator wasn't finalized prior to encoding");
+  if (Funcs.size() > UINT32_MAX)
+    return createStringError(std::errc::invalid_argument,
+                             "too many FunctionInfos");
+  if (UUID.size() > GSYM_MAX_UUID_SIZE)
+    return createStringError(std::errc::invalid_argument,
+                             "invalid UUID size %u", (uint32_t)UUID.size());
+
+  const uint64_t MinAddr = Funcs.front().startAddress();
+  const uint64_t MaxAddr = Funcs.back().startAddress();
+  const uint64_t AddrDelta = MaxAddr - MinAddr;
+  Header Hdr;
+  Hdr.Magic = GSYM_MAGIC;
+  Hdr.Version = GSYM_VERSION;
+  if (AddrDelta <= UINT8_MAX)
+    Hdr.AddrOffSize = 1;
+  else if (AddrDelta <= UINT16_MAX)
+    Hdr.AddrOffSize = 2;
+  else if (AddrDelta <= UINT32_MAX)
+    Hdr.AddrOffSize = 4;
+  else
+    Hdr.AddrOffSize = 8;
+  Hdr.UUIDSize = static_cast<uint8_t>(UUID.size());
+  Hdr.BaseAddress = MinAddr;
+  Hdr.NumAddresses = static_cast<uint32_t>(Funcs.size());
+  // The string table offset and size are fixed up once they are known.
+  Hdr.StrtabOffset = 0;
+  Hdr.StrtabSize = 0;
+  memset(Hdr.UUID, 0, sizeof(Hdr.UUID));
+  if (!UUID.empty())
+    memcpy(Hdr.UUID, UUID.data(), UUID.size());
+
+  // All offsets in the GSYM data are relative to the start of the header.
+  const uint64_t HeaderOffset = O.tell();
+  if (llvm::Error Err = Hdr.encode(O))
+    return Err;
+
+  // Write out the address offsets.
+  O.alignTo(Hdr.AddrOffSize);
+  for (const auto &FuncInfo : Funcs) {
+    uint64_t AddrOffset = FuncInfo.startAddress() - Hdr.BaseAddress;
+    switch (Hdr.AddrOffSize) {
+    case 1:
+      O.writeU8(static_cast<uint8_t>(AddrOffset));
+      break;
+    case 2:
+      O.writeU16(static_cast<uint16_t>(AddrOffset));
+      break;
+    case 4:
+      O.writeU32(static_cast<uint32_t>(AddrOffset));
+      break;
+    case 8:
+      O.writeU64(AddrOffset);
+      break;
+    }
+  }
+
+  // Write out all zeros for the address info offsets, which are fixed up as
+  // the function infos are written.
+  O.alignTo(4);
+  const uint64_t AddrInfoOffsetsOffset = O.tell();
+  for (size_t I = 0, E = Funcs.size(); I < E; ++I)
+    O.writeU32(0);
+
+  // Write out the file table.
+  O.alignTo(4);
+  assert(!Files.empty() && Files[0] == FileEntry() &&
+         "File table must start with the empty file");
+  O.writeU32(static_cast<uint32_t>(Files.size()));
+  for (const auto &File : Files) {
+    O.writeU32(File.Dir);
+    O.writeU32(File.Base);
+  }
+
+  // Write out the string table.
+  const uint64_t StrtabOffset = O.tell() - HeaderOffset;
+  O.writeData(ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(StrTab.data()), StrTab.size()));
+  if (StrtabOffset > UINT32_MAX || StrTab.size() > UINT32_MAX)
+    return createStringError(std::errc::invalid_argument,
+                             "string table is too large");
+  O.fixup32(static_cast<uint32_t>(StrtabOffset),
+            HeaderOffset + offsetof(Header, StrtabOffset));
+  O.fixup32(static_cast<uint32_t>(StrTab.size()),
+            HeaderOffset + offsetof(Header, StrtabSize));
+
+  // Write out the function infos and fix up their offsets.
+  uint64_t AddrInfoOffset = AddrInfoOffsetsOffset;
+  for (const auto &FuncInfo : Funcs) {
+    O.alignTo(4);
+    Expected<uint64_t> OffsetOrErr = FuncInfo.encode(O);
+    if (!OffsetOrErr)
+      return OffsetOrErr.takeError();
+    const uint64_t Offset = *OffsetOrErr - HeaderOffset;
+    if (Offset > UINT32_MAX)
+      return createStringError(std::errc::invalid_argument,
+                               "GSYM data is too large");
+    O.fixup32(static_cast<uint32_t>(Offset), AddrInfoOffset);
+    AddrInfoOffset += 4;
+  }
+  return Error::success();
+}
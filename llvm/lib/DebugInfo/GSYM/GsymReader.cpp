@@ -0,0 +1,304 @@
+//===- GsymReader.cpp -------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <cassert>
+#include <cstring>
+
+using namespace llvm;
+using namespace gsym;
+
+static_assert(sizeof(FileEntry) == 8,
+              "FileEntry objects are mapped directly from GSYM files");
+
+GsymReader::GsymReader(std::unique_ptr<MemoryBuffer> Buffer)
+    : MemBuffer(std::move(Buffer)),
+      Endian(support::endian::system_endianness()) {}
+
+GsymReader::GsymReader(GsymReader &&RHS) = default;
+
+GsymReader::~GsymReader() = default;
+
+llvm::Expected<GsymReader> GsymReader::openFile(StringRef Filename) {
+  // Don't require a null terminator so that the file can be memory mapped.
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
+      MemoryBuffer::getFile(Filename, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (std::error_code EC = BuffOrErr.getError())
+    return createFileError(Filename, errorCodeToError(EC));
+  return create(std::move(BuffOrErr.get()));
+}
+
+llvm::Expected<GsymReader> GsymReader::copyBuffer(StringRef Bytes) {
+  return create(MemoryBuffer::getMemBufferCopy(Bytes, "GSYM bytes"));
+}
+
+llvm::Expected<GsymReader>
+GsymReader::create(std::unique_ptr<MemoryBuffer> MemBuffer) {
+  if (!MemBuffer)
+    return createStringError(std::errc::invalid_argument,
+                             "invalid memory buffer");
+  GsymReader GR(std::move(MemBuffer));
+  if (llvm::Error Err = GR.parse())
+    return std::move(Err);
+  return std::move(GR);
+}
+
+/// Copy \a Count address offsets of type T out of \a Data into native byte
+/// order.
+template <class T>
+static void swapAddrOffsets(DataExtractor &Data, uint64_t Offset,
+                            uint32_t Count, std::vector<uint8_t> &Out) {
+  Out.resize(uint64_t(Count) * sizeof(T));
+  T *Dest = reinterpret_cast<T *>(Out.data());
+  for (uint32_t I = 0; I < Count; ++I)
+    Dest[I] = static_cast<T>(Data.getUnsigned(&Offset, sizeof(T)));
+}
+
+llvm::Error GsymReader::parse() {
+  GsymBytes = MemBuffer->getBuffer();
+  if (GsymBytes.size() < sizeof(Header))
+    return createStringError(std::errc::invalid_argument,
+                             "not enough data for a GSYM header");
+
+  const auto HostByteOrder = support::endian::system_endianness();
+  uint32_t Magic;
+  memcpy(&Magic, GsymBytes.data(), sizeof(Magic));
+  if (Magic == GSYM_MAGIC) {
+    // The header, the tables and the file entries can be used in place.
+    Endian = HostByteOrder;
+    Hdr = reinterpret_cast<const Header *>(GsymBytes.data());
+    if (llvm::Error Err = Hdr->checkForError())
+      return Err;
+  } else if (Magic == GSYM_CIGAM) {
+    // This is a GSYM file that has a different byte order than the host, so
+    // the header and the tables are swapped into local storage.
+    Endian = HostByteOrder == support::big ? support::little : support::big;
+    Swap.reset(new SwappedData);
+    DataExtractor Data(GsymBytes, Endian == support::little, 4);
+    if (auto ExpectedHdr = Header::decode(Data))
+      Swap->Hdr = ExpectedHdr.get();
+    else
+      return ExpectedHdr.takeError();
+    Hdr = &Swap->Hdr;
+  } else {
+    return createStringError(std::errc::invalid_argument,
+                             "not a GSYM file");
+  }
+
+  DataExtractor Data(GsymBytes, Endian == support::little, 4);
+  const uint64_t NumAddresses = Hdr->NumAddresses;
+
+  // Read the address offsets.
+  uint64_t Offset = alignTo(sizeof(Header), Hdr->AddrOffSize);
+  const uint64_t AddrOffsetsSize = NumAddresses * Hdr->AddrOffSize;
+  if (!Data.isValidOffsetForDataOfSize(Offset, AddrOffsetsSize))
+    return createStringError(std::errc::invalid_argument,
+                             "failed to read address table");
+  if (!Swap) {
+    AddrOffsets = makeArrayRef(
+        reinterpret_cast<const uint8_t *>(GsymBytes.data() + Offset),
+        AddrOffsetsSize);
+  } else {
+    switch (Hdr->AddrOffSize) {
+    case 1:
+      swapAddrOffsets<uint8_t>(Data, Offset, NumAddresses,
+                               Swap->AddrOffsets);
+      break;
+    case 2:
+      swapAddrOffsets<uint16_t>(Data, Offset, NumAddresses,
+                                Swap->AddrOffsets);
+      break;
+    case 4:
+      swapAddrOffsets<uint32_t>(Data, Offset, NumAddresses,
+                                Swap->AddrOffsets);
+      break;
+    case 8:
+      swapAddrOffsets<uint64_t>(Data, Offset, NumAddresses,
+                                Swap->AddrOffsets);
+      break;
+    }
+    AddrOffsets = Swap->AddrOffsets;
+  }
+  Offset += AddrOffsetsSize;
+
+  // Read the address info offsets.
+  Offset = alignTo(Offset, 4);
+  if (!Data.isValidOffsetForDataOfSize(Offset, NumAddresses * 4))
+    return createStringError(std::errc::invalid_argument,
+                             "failed to read address info offsets table");
+  if (!Swap) {
+    AddrInfoOffsets = makeArrayRef(
+        reinterpret_cast<const uint32_t *>(GsymBytes.data() + Offset),
+        NumAddresses);
+  } else {
+    uint64_t SwapOffset = Offset;
+    Swap->AddrInfoOffsets.resize(NumAddresses);
+    for (auto &AddrInfoOffset : Swap->AddrInfoOffsets)
+      AddrInfoOffset = Data.getU32(&SwapOffset);
+    AddrInfoOffsets = Swap->AddrInfoOffsets;
+  }
+  Offset += NumAddresses * 4;
+
+  // Read the file table.
+  Offset = alignTo(Offset, 4);
+  if (!Data.isValidOffsetForDataOfSize(Offset, 4))
+    return createStringError(std::errc::invalid_argument,
+                             "failed to read file table count");
+  const uint64_t NumFiles = Data.getU32(&Offset);
+  if (!Data.isValidOffsetForDataOfSize(Offset, NumFiles * 8))
+    return createStringError(std::errc::invalid_argument,
+                             "failed to read file table");
+  if (!Swap) {
+    Files = makeArrayRef(
+        reinterpret_cast<const FileEntry *>(GsymBytes.data() + Offset),
+        NumFiles);
+  } else {
+    Swap->Files.resize(NumFiles);
+    for (auto &File : Swap->Files) {
+      File.Dir = Data.getU32(&Offset);
+      File.Base = Data.getU32(&Offset);
+    }
+    Files = Swap->Files;
+  }
+
+  // Get the string table.
+  const uint64_t StrtabOffset = Hdr->StrtabOffset;
+  if (!Data.isValidOffsetForDataOfSize(StrtabOffset, Hdr->StrtabSize))
+    return createStringError(std::errc::invalid_argument,
+                             "failed to read string table");
+  StrTab.Data = GsymBytes.substr(StrtabOffset, Hdr->StrtabSize);
+  return Error::success();
+}
+
+const Header &GsymReader::getHeader() const {
+  // The only way to get a GsymReader is from GsymReader::openFile(...) or
+  // GsymReader::copyBuffer() and the header must be valid and initialized to
+  // a valid pointer value, so the assert below should not trigger.
+  assert(Hdr);
+  return *Hdr;
+}
+
+Optional<uint64_t> GsymReader::getAddress(size_t Index) const {
+  switch (Hdr->AddrOffSize) {
+  case 1: return addressForIndex<uint8_t>(Index);
+  case 2: return addressForIndex<uint16_t>(Index);
+  case 4: return addressForIndex<uint32_t>(Index);
+  case 8: return addressForIndex<uint64_t>(Index);
+  }
+  return llvm::None;
+}
+
+Expected<uint64_t> GsymReader::getAddressIndex(const uint64_t Addr) const {
+  if (Addr >= Hdr->BaseAddress) {
+    const uint64_t AddrOffset = Addr - Hdr->BaseAddress;
+    Optional<uint64_t> AddrOffsetIndex;
+    switch (Hdr->AddrOffSize) {
+    case 1:
+      AddrOffsetIndex = getAddressOffsetIndex<uint8_t>(AddrOffset);
+      break;
+    case 2:
+      AddrOffsetIndex = getAddressOffsetIndex<uint16_t>(AddrOffset);
+      break;
+    case 4:
+      AddrOffsetIndex = getAddressOffsetIndex<uint32_t>(AddrOffset);
+      break;
+    case 8:
+      AddrOffsetIndex = getAddressOffsetIndex<uint64_t>(AddrOffset);
+      break;
+    default:
+      return createStringError(std::errc::invalid_argument,
+                               "unsupported address offset size %u",
+                               Hdr->AddrOffSize);
+    }
+    if (AddrOffsetIndex)
+      return *AddrOffsetIndex;
+  }
+  return createStringError(std::errc::invalid_argument,
+                           "address 0x%" PRIx64 " is not in GSYM", Addr);
+}
+
+Expected<DataExtractor>
+GsymReader::getFunctionInfoData(uint64_t Index) const {
+  if (Index >= AddrInfoOffsets.size())
+    return createStringError(std::errc::invalid_argument,
+                             "invalid address index %" PRIu64, Index);
+  const uint32_t AddrInfoOffset = AddrInfoOffsets[Index];
+  if (AddrInfoOffset >= GsymBytes.size())
+    return createStringError(std::errc::invalid_argument,
+                             "invalid address info offset 0x%8.8x",
+                             AddrInfoOffset);
+  return DataExtractor(GsymBytes.substr(AddrInfoOffset),
+                       Endian == support::little, 4);
+}
+
+llvm::Expected<FunctionInfo> GsymReader::getFunctionInfo(uint64_t Addr) const {
+  Expected<uint64_t> AddressIndex = getAddressIndex(Addr);
+  if (!AddressIndex)
+    return AddressIndex.takeError();
+  Expected<DataExtractor> Data = getFunctionInfoData(*AddressIndex);
+  if (!Data)
+    return Data.takeError();
+  // The address index came from the address table, so the address is valid.
+  const uint64_t FuncAddr = *getAddress(*AddressIndex);
+  auto ExpectedFI = FunctionInfo::decode(*Data, FuncAddr);
+  if (!ExpectedFI)
+    return ExpectedFI.takeError();
+  // Functions without a size only contain their start address.
+  if (ExpectedFI->Range.contains(Addr) ||
+      (ExpectedFI->size() == 0 && Addr == FuncAddr))
+    return ExpectedFI;
+  return createStringError(std::errc::invalid_argument,
+                           "address 0x%" PRIx64 " is not in GSYM", Addr);
+}
+
+llvm::Expected<LookupResult> GsymReader::lookup(uint64_t Addr) const {
+  Expected<FunctionInfo> FI = getFunctionInfo(Addr);
+  if (!FI)
+    return FI.takeError();
+
+  LookupResult LR;
+  LR.LookupAddr = Addr;
+  LR.FuncRange = FI->Range;
+  LR.FuncName = getString(FI->Name);
+
+  auto SetFile = [&](SourceLocation &Loc, uint32_t FileIdx) {
+    if (Optional<FileEntry> File = getFile(FileIdx)) {
+      Loc.Dir = getString(File->Dir);
+      Loc.Base = getString(File->Base);
+    }
+  };
+
+  // The location of the address itself comes from the line table.
+  SourceLocation Loc;
+  auto LineIt = llvm::upper_bound(FI->Lines, LineEntry(Addr));
+  if (LineIt != FI->Lines.begin()) {
+    const LineEntry &Line = LineIt[-1];
+    SetFile(Loc, Line.File);
+    Loc.Line = Line.Line;
+  }
+
+  // Each inlined function gets a location, and its call site is the location
+  // of the function it was inlined into. The deepest function comes first.
+  if (Optional<InlineInfo::InlineArray> InlineStack =
+          FI->Inline.getInlineStack(Addr)) {
+    for (const InlineInfo *II : *InlineStack) {
+      Loc.Name = getString(II->Name);
+      LR.Locations.push_back(Loc);
+      Loc = SourceLocation();
+      SetFile(Loc, II->CallFile);
+      Loc.Line = II->CallLine;
+    }
+  }
+  Loc.Name = LR.FuncName;
+  LR.Locations.push_back(Loc);
+  return LR;
+}
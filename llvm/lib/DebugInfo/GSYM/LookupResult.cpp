@@ -0,0 +1,60 @@
+//===- LookupResult.cpp -----------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/LookupResult.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace gsym;
+
+std::string LookupResult::getSourceFile(uint32_t Index) const {
+  if (Index >= Locations.size())
+    return std::string();
+  const SourceLocation &Loc = Locations[Index];
+  if (Loc.Base.empty())
+    return std::string();
+  if (Loc.Dir.empty())
+    return Loc.Base;
+  SmallString<64> Storage(Loc.Dir);
+  llvm::sys::path::append(Storage, Loc.Base);
+  return Storage.str();
+}
+
+raw_ostream &llvm::gsym::operator<<(raw_ostream &OS,
+                                    const SourceLocation &SL) {
+  OS << SL.Name;
+  if (!SL.Base.empty()) {
+    OS << " @ ";
+    if (!SL.Dir.empty()) {
+      OS << SL.Dir;
+      if (!SL.Dir.endswith("/"))
+        OS << '/';
+    }
+    OS << SL.Base << ':' << SL.Line;
+  }
+  return OS;
+}
+
+raw_ostream &llvm::gsym::operator<<(raw_ostream &OS, const LookupResult &LR) {
+  OS << HEX64(LR.LookupAddr) << ": ";
+  auto NumLocations = LR.Locations.size();
+  for (size_t I = 0; I < NumLocations; ++I) {
+    if (I > 0) {
+      OS << '\n';
+      OS.indent(20);
+    }
+    const bool IsInlined = I + 1 != NumLocations;
+    OS << LR.Locations[I];
+    if (IsInlined)
+      OS << " [inlined]";
+  }
+  OS << '\n';
+  return OS;
+}
@@ -0,0 +1,103 @@
+//===- ObjectFileTransformer.cpp --------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/ObjectFileTransformer.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Object/MachO.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Object/SymbolSize.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <vector>
+
+using namespace llvm;
+using namespace gsym;
+
+template <class ELFT>
+static std::vector<uint8_t> getBuildID(const object::ELFFile<ELFT> &Obj) {
+  auto Sections = Obj.sections();
+  if (!Sections) {
+    consumeError(Sections.takeError());
+    return {};
+  }
+  for (const auto &Shdr : *Sections) {
+    if (Shdr.sh_type != ELF::SHT_NOTE)
+      continue;
+    Error Err = Error::success();
+    for (const auto &Note : Obj.notes(Shdr, Err)) {
+      if (Note.getType() == ELF::NT_GNU_BUILD_ID &&
+          Note.getName() == ELF::ELF_NOTE_GNU) {
+        ArrayRef<uint8_t> Desc = Note.getDesc();
+        consumeError(std::move(Err));
+        return std::vector<uint8_t>(Desc.begin(), Desc.end());
+      }
+    }
+    consumeError(std::move(Err));
+  }
+  return {};
+}
+
+/// Returns the UUID of \a Obj, which is the build ID for ELF files and the
+/// LC_UUID for mach-o files.
+static std::vector<uint8_t> getUUID(const object::ObjectFile &Obj) {
+  if (auto *MachO = dyn_cast<object::MachOObjectFile>(&Obj)) {
+    ArrayRef<uint8_t> UUID = MachO->getUuid();
+    return std::vector<uint8_t>(UUID.begin(), UUID.end());
+  }
+  if (auto *ELF = dyn_cast<object::ELF32LEObjectFile>(&Obj))
+    return getBuildID(*ELF->getELFFile());
+  if (auto *ELF = dyn_cast<object::ELF32BEObjectFile>(&Obj))
+    return getBuildID(*ELF->getELFFile());
+  if (auto *ELF = dyn_cast<object::ELF64LEObjectFile>(&Obj))
+    return getBuildID(*ELF->getELFFile());
+  if (auto *ELF = dyn_cast<object::ELF64BEObjectFile>(&Obj))
+    return getBuildID(*ELF->getELFFile());
+  return {};
+}
+
+llvm::Error ObjectFileTransformer::convert(const object::ObjectFile &Obj,
+                                           raw_ostream &Log,
+                                           GsymCreator &Gsym) {
+  std::vector<uint8_t> UUID = getUUID(Obj);
+  if (!UUID.empty())
+    Gsym.setUUID(UUID);
+
+  const size_t NumBefore = Gsym.getNumFunctionInfos();
+  for (const auto &SymIter : object::computeSymbolSizes(Obj)) {
+    const object::SymbolRef &Sym = SymIter.first;
+    Expected<object::SymbolRef::Type> SymType = Sym.getType();
+    if (!SymType) {
+      consumeError(SymType.takeError());
+      continue;
+    }
+    if (*SymType != object::SymbolRef::Type::ST_Function)
+      continue;
+    Expected<uint64_t> AddrOrErr = Sym.getAddress();
+    if (!AddrOrErr)
+      return AddrOrErr.takeError();
+    const uint64_t Addr = *AddrOrErr;
+    // Skip undefined symbols and symbols outside of the code.
+    if (Sym.getFlags() & object::SymbolRef::SF_Undefined ||
+        !Gsym.isValidTextAddress(Addr))
+      continue;
+    Expected<StringRef> Name = Sym.getName();
+    if (!Name) {
+      logAllUnhandledErrors(Name.takeError(), Log, "ObjectFileTransformer: ");
+      continue;
+    }
+    if (Name->empty())
+      continue;
+    Gsym.addFunctionInfo(
+        FunctionInfo(Addr, SymIter.second, Gsym.insertString(*Name)));
+  }
+  const size_t FunctionsAdded = Gsym.getNumFunctionInfos() - NumBefore;
+  Log << "Loaded " << FunctionsAdded << " functions from symbol table.\n";
+  return Error::success();
+}
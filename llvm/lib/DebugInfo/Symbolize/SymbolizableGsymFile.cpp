@@ -0,0 +1,70 @@
+//===- SymbolizableGsymFile.cpp -------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementation of SymbolizableGsymFile class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "SymbolizableGsymFile.h"
+
+using namespace llvm;
+using namespace symbolize;
+
+static DILineInfo getLineInfo(const gsym::LookupResult &LR, uint32_t Index,
+                              FunctionNameKind FNKind) {
+  DILineInfo Info;
+  const gsym::SourceLocation &Loc = LR.Locations[Index];
+  if (FNKind != FunctionNameKind::None)
+    Info.FunctionName = Loc.Name;
+  std::string File = LR.getSourceFile(Index);
+  if (!File.empty())
+    Info.FileName = File;
+  Info.Line = Loc.Line;
+  return Info;
+}
+
+DILineInfo
+SymbolizableGsymFile::symbolizeCode(object::SectionedAddress ModuleOffset,
+                                    FunctionNameKind FNKind,
+                                    bool UseSymbolTable) const {
+  Expected<gsym::LookupResult> LR = Reader.lookup(ModuleOffset.Address);
+  if (!LR) {
+    consumeError(LR.takeError());
+    return DILineInfo();
+  }
+  if (LR->Locations.empty())
+    return DILineInfo();
+  return getLineInfo(*LR, 0, FNKind);
+}
+
+DIInliningInfo SymbolizableGsymFile::symbolizeInlinedCode(
+    object::SectionedAddress ModuleOffset, FunctionNameKind FNKind,
+    bool UseSymbolTable) const {
+  DIInliningInfo InlinedContext;
+  Expected<gsym::LookupResult> LR = Reader.lookup(ModuleOffset.Address);
+  if (!LR) {
+    consumeError(LR.takeError());
+  } else {
+    for (uint32_t I = 0, E = LR->Locations.size(); I != E; ++I)
+      InlinedContext.addFrame(getLineInfo(*LR, I, FNKind));
+  }
+  // Make sure there is at least one frame in context.
+  if (InlinedContext.getNumberOfFrames() == 0)
+    InlinedContext.addFrame(DILineInfo());
+  return InlinedContext;
+}
+
+DIGlobal SymbolizableGsymFile::symbolizeData(
+    object::SectionedAddress ModuleOffset) const {
+  return DIGlobal();
+}
+
+std::vector<DILocal> SymbolizableGsymFile::symbolizeFrame(
+    object::SectionedAddress ModuleOffset) const {
+  return {};
+}
@@ -0,0 +1,55 @@
+//===- SymbolizableGsymFile.h -----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the SymbolizableGsymFile class.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZABLEGSYMFILE_H
+#define LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZABLEGSYMFILE_H
+
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+namespace symbolize {
+
+/// A module that is symbolized from a GSYM file instead of an object file and
+/// its debug info. GSYM files only contain functions, line tables and inline
+/// call stacks, so data and frame queries never return anything.
+class SymbolizableGsymFile : public SymbolizableModule {
+public:
+  explicit SymbolizableGsymFile(gsym::GsymReader Reader)
+      : Reader(std::move(Reader)) {}
+
+  DILineInfo symbolizeCode(object::SectionedAddress ModuleOffset,
+                           FunctionNameKind FNKind,
+                           bool UseSymbolTable) const override;
+  DIInliningInfo symbolizeInlinedCode(object::SectionedAddress ModuleOffset,
+                                      FunctionNameKind FNKind,
+                                      bool UseSymbolTable) const override;
+  DIGlobal symbolizeData(object::SectionedAddress ModuleOffset) const override;
+  std::vector<DILocal>
+  symbolizeFrame(object::SectionedAddress ModuleOffset) const override;
+
+  // GSYM files don't record where the original binary came from.
+  bool isWin32Module() const override { return false; }
+
+  // Addresses in GSYM files are the file addresses of the original binary.
+  uint64_t getModulePreferredBase() const override { return 0; }
+
+private:
+  gsym::GsymReader Reader;
+};
+
+} // end namespace symbolize
+} // end namespace llvm
+
+#endif // LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZABLEGSYMFILE_H
@@ -12,9 +12,11 @@
 
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
 
+#include "SymbolizableGsymFile.h"
 #include "SymbolizableObjectFile.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/PDB/PDB.h"
@@ -31,9 +33,12 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <tuple>
 
 #if defined(_MSC_VER)
 #include <Windows.h>
@@ -76,8 +81,11 @@ LLVMSymbolizer::symbolizeCode(const ObjectFile &Obj,
                               object::SectionedAddress ModuleOffset) {
   StringRef ModuleName = Obj.getFileName();
   auto I = Modules.find(ModuleName);
-  if (I != Modules.end())
+  if (I != Modules.end()) {
+    if (I->second)
+      touchModule(ModuleName);
     return symbolizeCodeCommon(I->second.get(), ModuleOffset);
+  }
 
   std::unique_ptr<DIContext> Context =
         DWARFContext::create(Obj, nullptr, DWARFContext::defaultErrorHandler);
@@ -85,7 +93,10 @@ LLVMSymbolizer::symbolizeCode(const ObjectFile &Obj,
                      createModuleInfo(&Obj, std::move(Context), ModuleName);
   if (!InfoOrErr)
     return InfoOrErr.takeError();
-  return symbolizeCodeCommon(*InfoOrErr, ModuleOffset);
+  recordModule(ModuleName, ObjectPair(&Obj, &Obj), Obj.getData().size());
+  Expected<DILineInfo> LineInfo = symbolizeCodeCommon(*InfoOrErr, ModuleOffset);
+  pruneCache();
+  return LineInfo;
 }
 
 Expected<DILineInfo>
@@ -94,7 +105,9 @@ LLVMSymbolizer::symbolizeCode(const std::string &ModuleName,
   Expected<SymbolizableModule *> InfoOrErr = getOrCreateModuleInfo(ModuleName);
   if (!InfoOrErr)
     return InfoOrErr.takeError();
-  return symbolizeCodeCommon(*InfoOrErr, ModuleOffset);
+  Expected<DILineInfo> LineInfo = symbolizeCodeCommon(*InfoOrErr, ModuleOffset);
+  pruneCache();
+  return LineInfo;
 }
 
 Expected<DIInliningInfo>
@@ -124,6 +137,7 @@ LLVMSymbolizer::symbolizeInlinedCode(const std::string &ModuleName,
       Frame->FunctionName = DemangleName(Frame->FunctionName, Info);
     }
   }
+  pruneCache();
   return InlinedContext;
 }
 
@@ -150,6 +164,7 @@ LLVMSymbolizer::symbolizeData(const std::string &ModuleName,
   DIGlobal Global = Info->symbolizeData(ModuleOffset);
   if (Opts.Demangle)
     Global.Name = DemangleName(Global.Name, Info);
+  pruneCache();
   return Global;
 }
 
@@ -173,7 +188,142 @@ LLVMSymbolizer::symbolizeFrame(const std::string &ModuleName,
   if (Opts.RelativeAddresses)
     ModuleOffset.Address += Info->getModulePreferredBase();
 
-  return Info->symbolizeFrame(ModuleOffset);
+  std::vector<DILocal> Locals = Info->symbolizeFrame(ModuleOffset);
+  pruneCache();
+  return Locals;
+}
+
+std::vector<SymbolizableModule *>
+LLVMSymbolizer::getModulesForBatch(ArrayRef<BatchRequest> Requests,
+                                   std::vector<Error> &Errors) {
+  std::vector<SymbolizableModule *> Infos;
+  Infos.reserve(Requests.size());
+  Errors.reserve(Requests.size());
+  for (const BatchRequest &Request : Requests) {
+    Expected<SymbolizableModule *> InfoOrErr =
+        getOrCreateModuleInfo(Request.ModuleName);
+    if (InfoOrErr) {
+      Infos.push_back(*InfoOrErr);
+      Errors.push_back(Error::success());
+    } else {
+      Infos.push_back(nullptr);
+      Errors.push_back(InfoOrErr.takeError());
+    }
+  }
+  return Infos;
+}
+
+/// Calls \p Query for each request that has a module, grouped by module and
+/// in address order within each module. Different modules are queried in
+/// parallel, which is safe as long as \p Query only touches its module.
+/// Requests without a module get a default constructed result.
+template <typename T, typename QueryFn>
+static std::vector<T>
+runBatch(ArrayRef<SymbolizableModule *> Infos,
+         ArrayRef<LLVMSymbolizer::BatchRequest> Requests, unsigned NumThreads,
+         QueryFn Query) {
+  std::vector<T> Results(Requests.size());
+  std::vector<size_t> Order;
+  for (size_t I = 0, E = Requests.size(); I != E; ++I)
+    if (Infos[I])
+      Order.push_back(I);
+  llvm::sort(Order, [&](size_t LHS, size_t RHS) {
+    const object::SectionedAddress &L = Requests[LHS].ModuleOffset;
+    const object::SectionedAddress &R = Requests[RHS].ModuleOffset;
+    return std::make_tuple(Infos[LHS], L.SectionIndex, L.Address) <
+           std::make_tuple(Infos[RHS], R.SectionIndex, R.Address);
+  });
+
+  auto QueryRange = [&](size_t Begin, size_t End) {
+    for (size_t I = Begin; I != End; ++I) {
+      size_t Index = Order[I];
+      Results[Index] = Query(Infos[Index], Requests[Index].ModuleOffset);
+    }
+  };
+  if (NumThreads == 1) {
+    QueryRange(0, Order.size());
+    return Results;
+  }
+
+  ThreadPool Pool(NumThreads ? NumThreads
+                             : llvm::heavyweight_hardware_concurrency());
+  for (size_t Begin = 0, E = Order.size(); Begin != E;) {
+    size_t End = Begin + 1;
+    while (End != E && Infos[Order[End]] == Infos[Order[Begin]])
+      ++End;
+    Pool.async(QueryRange, Begin, End);
+    Begin = End;
+  }
+  Pool.wait();
+  return Results;
+}
+
+/// Pairs up the results of a batch with the errors of loading their modules.
+template <typename T>
+static std::vector<Expected<T>> collectBatch(std::vector<T> &&Results,
+                                             std::vector<Error> &Errors) {
+  std::vector<Expected<T>> Collected;
+  Collected.reserve(Results.size());
+  for (size_t I = 0, E = Results.size(); I != E; ++I) {
+    if (Errors[I])
+      Collected.push_back(std::move(Errors[I]));
+    else
+      Collected.push_back(std::move(Results[I]));
+  }
+  return Collected;
+}
+
+std::vector<Expected<DILineInfo>>
+LLVMSymbolizer::symbolizeCodeBatch(ArrayRef<BatchRequest> Requests,
+                                   unsigned NumThreads) {
+  std::vector<Error> Errors;
+  std::vector<SymbolizableModule *> Infos =
+      getModulesForBatch(Requests, Errors);
+  std::vector<DILineInfo> Results = runBatch<DILineInfo>(
+      Infos, Requests, NumThreads,
+      [&](SymbolizableModule *Info, object::SectionedAddress ModuleOffset) {
+        if (Opts.RelativeAddresses)
+          ModuleOffset.Address += Info->getModulePreferredBase();
+        return Info->symbolizeCode(ModuleOffset, Opts.PrintFunctions,
+                                   Opts.UseSymbolTable);
+      });
+  // Demangle on this thread, as not all demanglers are thread safe.
+  if (Opts.Demangle)
+    for (size_t I = 0, E = Results.size(); I != E; ++I)
+      if (Infos[I])
+        Results[I].FunctionName =
+            DemangleName(Results[I].FunctionName, Infos[I]);
+  pruneCache();
+  return collectBatch(std::move(Results), Errors);
+}
+
+std::vector<Expected<DIInliningInfo>>
+LLVMSymbolizer::symbolizeInlinedCodeBatch(ArrayRef<BatchRequest> Requests,
+                                          unsigned NumThreads) {
+  std::vector<Error> Errors;
+  std::vector<SymbolizableModule *> Infos =
+      getModulesForBatch(Requests, Errors);
+  std::vector<DIInliningInfo> Results = runBatch<DIInliningInfo>(
+      Infos, Requests, NumThreads,
+      [&](SymbolizableModule *Info, object::SectionedAddress ModuleOffset) {
+        if (Opts.RelativeAddresses)
+          ModuleOffset.Address += Info->getModulePreferredBase();
+        return Info->symbolizeInlinedCode(ModuleOffset, Opts.PrintFunctions,
+                                          Opts.UseSymbolTable);
+      });
+  // Demangle on this thread, as not all demanglers are thread safe.
+  if (Opts.Demangle) {
+    for (size_t I = 0, E = Results.size(); I != E; ++I) {
+      if (!Infos[I])
+        continue;
+      for (int J = 0, N = Results[I].getNumberOfFrames(); J < N; J++) {
+        auto *Frame = Results[I].getMutableFrame(J);
+        Frame->FunctionName = DemangleName(Frame->FunctionName, Infos[I]);
+      }
+    }
+  }
+  pruneCache();
+  return collectBatch(std::move(Results), Errors);
 }
 
 void LLVMSymbolizer::flush() {
@@ -181,6 +331,78 @@ void LLVMSymbolizer::flush() {
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
+  ModuleCache.clear();
+  ModuleLRU.clear();
+  CacheSize = 0;
+}
+
+void LLVMSymbolizer::recordModule(const std::string &ModuleName,
+                                  ObjectPair Objects, uint64_t Size) {
+  ModuleLRU.push_front(ModuleName);
+  ModuleCacheEntry &Entry = ModuleCache[ModuleName];
+  Entry.Objects = Objects;
+  Entry.Size = Size;
+  Entry.LRUPos = ModuleLRU.begin();
+  CacheSize += Size;
+}
+
+void LLVMSymbolizer::touchModule(const std::string &ModuleName) {
+  auto I = ModuleCache.find(ModuleName);
+  if (I != ModuleCache.end())
+    ModuleLRU.splice(ModuleLRU.begin(), ModuleLRU, I->second.LRUPos);
+}
+
+void LLVMSymbolizer::pruneCache() {
+  if (!Opts.MaxCacheSize || CacheSize <= Opts.MaxCacheSize)
+    return;
+  while (CacheSize > Opts.MaxCacheSize && ModuleLRU.size() > 1) {
+    const std::string &ModuleName = ModuleLRU.back();
+    auto I = ModuleCache.find(ModuleName);
+    CacheSize -= I->second.Size;
+    ModuleCache.erase(I);
+    Modules.erase(ModuleName);
+    ModuleLRU.pop_back();
+  }
+
+  // Unload the objects and binaries that no remaining module uses. Entries
+  // for files that failed to load are kept, so errors are still only
+  // reported once.
+  SmallPtrSet<const Binary *, 16> Live;
+  for (const auto &Entry : ModuleCache) {
+    if (Entry.second.Objects.first)
+      Live.insert(Entry.second.Objects.first);
+    if (Entry.second.Objects.second)
+      Live.insert(Entry.second.Objects.second);
+  }
+  for (auto I = ObjectPairForPathArch.begin();
+       I != ObjectPairForPathArch.end();) {
+    if (I->second.first && !Live.count(I->second.first))
+      I = ObjectPairForPathArch.erase(I);
+    else
+      ++I;
+  }
+  for (auto I = ObjectForUBPathAndArch.begin();
+       I != ObjectForUBPathAndArch.end();) {
+    if (I->second && !Live.count(I->second.get()))
+      I = ObjectForUBPathAndArch.erase(I);
+    else
+      ++I;
+  }
+  for (auto I = BinaryForPath.begin(); I != BinaryForPath.end();) {
+    const Binary *Bin = I->second.getBinary();
+    bool Used = !Bin || Live.count(Bin);
+    if (!Used && isa<MachOUniversalBinary>(Bin)) {
+      // Universal binaries are used through the objects of their slices.
+      auto Slice = ObjectForUBPathAndArch.lower_bound(
+          std::make_pair(I->first, std::string()));
+      Used = Slice != ObjectForUBPathAndArch.end() &&
+             Slice->first.first == I->first;
+    }
+    if (Used)
+      ++I;
+    else
+      I = BinaryForPath.erase(I);
+  }
 }
 
 namespace {
@@ -438,8 +660,11 @@ LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   auto I = Modules.find(ModuleName);
-  if (I != Modules.end())
+  if (I != Modules.end()) {
+    if (I->second)
+      touchModule(ModuleName);
     return I->second.get();
+  }
 
   std::string BinaryName = ModuleName;
   std::string ArchName = Opts.DefaultArch;
@@ -452,6 +677,24 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
       ArchName = ArchStr;
     }
   }
+
+  // GSYM files already contain everything that is needed to symbolize, so
+  // they are used directly instead of looking for an object file.
+  if (StringRef(BinaryName).endswith(".gsym")) {
+    auto ReaderOrErr = gsym::GsymReader::openFile(BinaryName);
+    if (!ReaderOrErr) {
+      Modules.emplace(ModuleName, std::unique_ptr<SymbolizableModule>());
+      return createFileError(BinaryName, ReaderOrErr.takeError());
+    }
+    auto InsertResult = Modules.emplace(
+        ModuleName,
+        std::make_unique<SymbolizableGsymFile>(std::move(*ReaderOrErr)));
+    uint64_t Size = 0;
+    sys::fs::file_size(BinaryName, Size);
+    recordModule(ModuleName, ObjectPair(nullptr, nullptr), Size);
+    return InsertResult.first->second.get();
+  }
+
   auto ObjectsOrErr = getOrCreateObjectPair(BinaryName, ArchName);
   if (!ObjectsOrErr) {
     // Failed to find valid object file.
@@ -483,7 +726,15 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
     Context =
         DWARFContext::create(*Objects.second, nullptr,
                              DWARFContext::defaultErrorHandler, Opts.DWPName);
-  return createModuleInfo(Objects.first, std::move(Context), ModuleName);
+  Expected<SymbolizableModule *> InfoOrErr =
+      createModuleInfo(Objects.first, std::move(Context), ModuleName);
+  if (InfoOrErr) {
+    uint64_t Size = Objects.first->getData().size();
+    if (Objects.second != Objects.first)
+      Size += Objects.second->getData().size();
+    recordModule(ModuleName, Objects, Size);
+  }
+  return InfoOrErr;
 }
 
 namespace {
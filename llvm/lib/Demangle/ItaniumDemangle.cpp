@@ -261,14 +261,25 @@ class BumpPointerAllocator {
 
   static constexpr size_t AllocSize = 4096;
   static constexpr size_t UsableAllocSize = AllocSize - sizeof(BlockMeta);
+  // The Current of a block that holds a single oversized allocation.
+  static constexpr size_t MassiveBlock = ~size_t(0);
 
   alignas(long double) char InitialBuffer[AllocSize];
   BlockMeta* BlockList = nullptr;
+  // Blocks released by reset(), kept so that demangling one name after
+  // another does not go back to malloc.
+  BlockMeta* FreeList = nullptr;
 
   void grow() {
-    char* NewMeta = static_cast<char *>(std::malloc(AllocSize));
-    if (NewMeta == nullptr)
-      std::terminate();
+    char* NewMeta;
+    if (FreeList != nullptr) {
+      NewMeta = reinterpret_cast<char*>(FreeList);
+      FreeList = FreeList->Next;
+    } else {
+      NewMeta = static_cast<char *>(std::malloc(AllocSize));
+      if (NewMeta == nullptr)
+        std::terminate();
+    }
     BlockList = new (NewMeta) BlockMeta{BlockList, 0};
   }
 
@@ -277,7 +288,7 @@ class BumpPointerAllocator {
     BlockMeta* NewMeta = reinterpret_cast<BlockMeta*>(std::malloc(NBytes));
     if (NewMeta == nullptr)
       std::terminate();
-    BlockList->Next = new (NewMeta) BlockMeta{BlockList->Next, 0};
+    BlockList->Next = new (NewMeta) BlockMeta{BlockList->Next, MassiveBlock};
     return static_cast<void*>(NewMeta + 1);
   }
 
@@ -301,13 +312,26 @@ public:
     while (BlockList) {
       BlockMeta* Tmp = BlockList;
       BlockList = BlockList->Next;
-      if (reinterpret_cast<char*>(Tmp) != InitialBuffer)
+      if (reinterpret_cast<char*>(Tmp) == InitialBuffer)
+        continue;
+      if (Tmp->Current == MassiveBlock) {
         std::free(Tmp);
+      } else {
+        Tmp->Next = FreeList;
+        FreeList = Tmp;
+      }
     }
     BlockList = new (InitialBuffer) BlockMeta{nullptr, 0};
   }
 
-  ~BumpPointerAllocator() { reset(); }
+  ~BumpPointerAllocator() {
+    reset();
+    while (FreeList) {
+      BlockMeta* Tmp = FreeList;
+      FreeList = FreeList->Next;
+      std::free(Tmp);
+    }
+  }
 };
 
 class DefaultAllocator {
@@ -0,0 +1,345 @@
+//=---------- ELFAtomGraphBuilder.cpp - ELF AtomGraph builder -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Generic ELF AtomGraph building code.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ELFAtomGraphBuilder.h"
+
+#define DEBUG_TYPE "jitlink"
+
+namespace llvm {
+namespace jitlink {
+
+ELFAtomGraphBuilder::~ELFAtomGraphBuilder() {}
+
+Expected<std::unique_ptr<AtomGraph>> ELFAtomGraphBuilder::buildGraph() {
+  if (auto Err = parseSections())
+    return std::move(Err);
+
+  if (auto Err = addAtoms())
+    return std::move(Err);
+
+  if (auto Err = addRelocations())
+    return std::move(Err);
+
+  return std::move(G);
+}
+
+ELFAtomGraphBuilder::ELFAtomGraphBuilder(const ELFFile &Obj,
+                                         StringRef FileName)
+    : Obj(Obj), G(std::make_unique<AtomGraph>(FileName, 8, support::little)) {}
+
+Expected<ELFAtomGraphBuilder::SymbolTarget>
+ELFAtomGraphBuilder::getSymbolTarget(uint32_t SymbolIndex) const {
+  if (SymbolIndex >= SymbolTargets.size())
+    return make_error<JITLinkError>("Symbol index out of range");
+  if (!SymbolTargets[SymbolIndex].A)
+    return make_error<JITLinkError>("Symbol index " + Twine(SymbolIndex) +
+                                    " does not refer to a linked symbol");
+  return SymbolTargets[SymbolIndex];
+}
+
+bool ELFAtomGraphBuilder::isEHFrameSection(const Elf_Shdr &Sec,
+                                           StringRef Name) {
+  return Sec.sh_type == ELF::SHT_X86_64_UNWIND || Name == ".eh_frame";
+}
+
+Section &ELFAtomGraphBuilder::getCommonSection() {
+  if (!CommonSection) {
+    auto Prot = static_cast<sys::Memory::ProtectionFlags>(
+        sys::Memory::MF_READ | sys::Memory::MF_WRITE);
+    CommonSection = &G->createSection("<common>", 1, Prot, true);
+  }
+  return *CommonSection;
+}
+
+Error ELFAtomGraphBuilder::parseSections() {
+  auto ELFSections = Obj.sections();
+  if (!ELFSections)
+    return ELFSections.takeError();
+
+  // Sections of relocatable objects all start at address zero. Lay the
+  // allocatable ones out one after the other instead, so that every atom gets
+  // a unique address.
+  JITTargetAddress NextAddress = 0;
+
+  for (auto &Sec : *ELFSections) {
+    if (Sec.sh_type == ELF::SHT_SYMTAB) {
+      if (SymTab)
+        return make_error<JITLinkError>("Multiple symbol tables in ELF "
+                                        "object");
+      SymTab = &Sec;
+      continue;
+    }
+
+    // Sections that are not loaded (debug info, relocations, string tables,
+    // ...) are not part of the graph.
+    if (!(Sec.sh_flags & ELF::SHF_ALLOC))
+      continue;
+
+    auto NameOrErr = Obj.getSectionName(&Sec);
+    if (!NameOrErr)
+      return NameOrErr.takeError();
+    StringRef Name = *NameOrErr;
+
+    if (Sec.sh_flags & ELF::SHF_TLS)
+      return make_error<JITLinkError>("Thread-local section " + Name +
+                                      " is not supported");
+
+    uint64_t Align = std::max<uint64_t>(Sec.sh_addralign, 1);
+    if (!isPowerOf2_64(Align) || Align > std::numeric_limits<uint32_t>::max())
+      return make_error<JITLinkError>("Section " + Name +
+                                      " has unsupported alignment");
+
+    sys::Memory::ProtectionFlags Prot;
+    if (Sec.sh_flags & ELF::SHF_EXECINSTR)
+      Prot = static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
+                                                       sys::Memory::MF_EXEC);
+    else if (Sec.sh_flags & ELF::SHF_WRITE)
+      Prot = static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
+                                                       sys::Memory::MF_WRITE);
+    else
+      Prot = sys::Memory::MF_READ;
+
+    bool IsZeroFill = Sec.sh_type == ELF::SHT_NOBITS;
+    auto &GenericSection = G->createSection(Name, Align, Prot, IsZeroFill);
+
+    NextAddress = alignTo(NextAddress, Align);
+
+    LLVM_DEBUG({
+      dbgs() << "Adding section " << Name << ": "
+             << format("0x%016" PRIx64, NextAddress) << ", align: " << Align
+             << "\n";
+    });
+
+    unsigned SectionIndex = &Sec - &ELFSections->front();
+    auto &ELFSec =
+        Sections.try_emplace(SectionIndex, GenericSection, Sec, NextAddress)
+            .first->second;
+
+    NextAddress += Sec.sh_size;
+
+    // Leave room for the terminator added to eh-frame sections.
+    if (isEHFrameSection(Sec, Name))
+      NextAddress += 4;
+
+    if (!IsZeroFill) {
+      auto Content = Obj.getSectionContents(&Sec);
+      if (!Content)
+        return Content.takeError();
+      ELFSec.setContent(
+          StringRef(reinterpret_cast<const char *>(Content->data()),
+                    Content->size()));
+    }
+  }
+
+  return Error::success();
+}
+
+Error ELFAtomGraphBuilder::addAtoms() {
+  using SecAtomMap = std::map<uint64_t, DefinedAtom *>;
+  DenseMap<const ELFSection *, SecAtomMap> SecToAtoms;
+  std::vector<std::pair<uint32_t, const ELFSection *>> LocalSymbols;
+
+  if (SymTab) {
+    auto Syms = Obj.symbols(SymTab);
+    if (!Syms)
+      return Syms.takeError();
+
+    auto StrTab = Obj.getStringTableForSymtab(*SymTab);
+    if (!StrTab)
+      return StrTab.takeError();
+
+    ArrayRef<ELFT::Word> ShndxTable;
+    auto ELFSections = Obj.sections();
+    if (!ELFSections)
+      return ELFSections.takeError();
+    for (auto &Sec : *ELFSections)
+      if (Sec.sh_type == ELF::SHT_SYMTAB_SHNDX) {
+        auto TableOrErr = Obj.getSHNDXTable(Sec);
+        if (!TableOrErr)
+          return TableOrErr.takeError();
+        ShndxTable = *TableOrErr;
+      }
+
+    SymbolTargets.resize(Syms->size());
+
+    // Symbol zero is the null symbol.
+    for (uint32_t SymIdx = 1, NumSyms = Syms->size(); SymIdx != NumSyms;
+         ++SymIdx) {
+      auto &Sym = (*Syms)[SymIdx];
+
+      if (Sym.getType() == ELF::STT_FILE)
+        continue;
+
+      auto Name = Sym.getName(*StrTab);
+      if (!Name)
+        return Name.takeError();
+
+      if (Sym.getType() == ELF::STT_TLS)
+        return make_error<JITLinkError>("Thread-local symbol " + *Name +
+                                        " is not supported");
+
+      bool IsGlobal = Sym.getBinding() != ELF::STB_LOCAL;
+      bool IsExported = IsGlobal &&
+                        Sym.getVisibility() != ELF::STV_HIDDEN &&
+                        Sym.getVisibility() != ELF::STV_INTERNAL;
+      bool IsWeak = Sym.getBinding() == ELF::STB_WEAK;
+
+      if (Sym.isUndefined()) {
+        LLVM_DEBUG(dbgs() << "Adding undef atom \"" << *Name << "\"\n");
+        SymbolTargets[SymIdx].A = &G->addExternalAtom(*Name);
+        continue;
+      }
+
+      if (Sym.isAbsolute()) {
+        // Local absolute symbols can not be referred to by relocations.
+        if (!IsGlobal)
+          continue;
+        LLVM_DEBUG(dbgs() << "Adding absolute \"" << *Name << "\" addr: "
+                          << format("0x%016" PRIx64,
+                                    static_cast<uint64_t>(Sym.st_value))
+                          << "\n");
+        auto &A = G->addAbsoluteAtom(*Name, Sym.st_value);
+        A.setGlobal(true);
+        A.setExported(IsExported);
+        A.setWeak(IsWeak);
+        SymbolTargets[SymIdx].A = &A;
+        continue;
+      }
+
+      if (Sym.isCommon()) {
+        LLVM_DEBUG(dbgs() << "Adding common \"" << *Name << "\"\n");
+        auto &A = G->addCommonAtom(getCommonSection(), *Name, 0,
+                                   std::max<uint64_t>(Sym.st_value, 1),
+                                   Sym.st_size);
+        A.setGlobal(true);
+        A.setExported(IsExported);
+        SymbolTargets[SymIdx].A = &A;
+        continue;
+      }
+
+      auto SecIdx = Obj.getSectionIndex(&Sym, *Syms, ShndxTable);
+      if (!SecIdx)
+        return SecIdx.takeError();
+
+      // Skip symbols in sections that are not loaded.
+      auto SecItr = Sections.find(*SecIdx);
+      if (SecItr == Sections.end())
+        continue;
+      auto &S = SecItr->second;
+
+      // Local and section symbols resolve to an offset in their section, see
+      // below.
+      if (!IsGlobal || Sym.getType() == ELF::STT_SECTION) {
+        SymbolTargets[SymIdx].Offset = Sym.st_value;
+        LocalSymbols.push_back(std::make_pair(SymIdx, &S));
+        continue;
+      }
+
+      if (Sym.st_value >= S.getSize())
+        return make_error<JITLinkError>("Symbol " + *Name +
+                                        " does not point into section " +
+                                        S.getName());
+
+      auto &SecAtoms = SecToAtoms[&S];
+      if (SecAtoms.count(Sym.st_value))
+        return make_error<JITLinkError>("Symbol " + *Name +
+                                        " aliases another global symbol, "
+                                        "which is not supported");
+
+      LLVM_DEBUG(dbgs() << "Adding defined atom \"" << *Name << "\"\n");
+
+      // Only the atom at the start of the section needs the section alignment:
+      // the others stay at their original offset from it.
+      uint32_t Align =
+          Sym.st_value == 0 ? S.getGenericSection().getAlignment() : 1;
+      auto &DA = G->addDefinedAtom(S.getGenericSection(), *Name,
+                                   S.getAddress() + Sym.st_value, Align);
+      DA.setGlobal(true);
+      DA.setExported(IsExported);
+      DA.setWeak(IsWeak);
+      DA.setCallable(Sym.getType() == ELF::STT_FUNC);
+
+      SecAtoms[Sym.st_value] = &DA;
+      SymbolTargets[SymIdx].A = &DA;
+    }
+  }
+
+  for (auto &KV : Sections) {
+    auto &S = KV.second;
+
+    // Skip empty sections.
+    if (S.empty())
+      continue;
+
+    // Make sure the section has an atom at offset zero.
+    auto &SecAtoms = SecToAtoms[&S];
+    if (!SecAtoms.count(0))
+      SecAtoms[0] = &G->addAnonymousAtom(
+          S.getGenericSection(), S.getAddress(),
+          S.getGenericSection().getAlignment());
+    S.setHeadAtom(*SecAtoms[0]);
+
+    // Set the atom contents, iterating in reverse order.
+    uint64_t LastAtomOffset = S.getSize();
+    for (auto I = SecAtoms.rbegin(), E = SecAtoms.rend(); I != E; ++I) {
+      auto Offset = I->first;
+      auto &A = *I->second;
+      if (S.isZeroFill())
+        A.setZeroFill(LastAtomOffset - Offset);
+      else
+        A.setContent(S.getContent().substr(Offset, LastAtomOffset - Offset));
+      LastAtomOffset = Offset;
+    }
+
+    // Lock the atoms of the section in their original order. Each atom keeps
+    // the previous one alive, and is kept alive by it through the layout-next
+    // edge.
+    DefinedAtom *Prev = nullptr;
+    for (auto &OffsetAndAtom : SecAtoms) {
+      auto &A = *OffsetAndAtom.second;
+      if (Prev) {
+        Prev->setLayoutNext(A);
+        A.addEdge(Edge::KeepAlive, 0, *Prev, 0);
+      }
+      Prev = &A;
+    }
+
+    // The eh-frame section is registered as a whole, which requires a zero
+    // terminator that relocatable objects do not contain.
+    const auto &Header = S.getHeader();
+    if (isEHFrameSection(Header, S.getName())) {
+      static const char NullTerminator[4] = {0, 0, 0, 0};
+      auto &Terminator = G->addAnonymousAtom(
+          S.getGenericSection(), S.getAddress() + S.getSize(), 1);
+      Terminator.setContent(StringRef(NullTerminator, 4));
+      Prev->setLayoutNext(Terminator);
+      Terminator.addEdge(Edge::KeepAlive, 0, *Prev, 0);
+    }
+
+    // Nothing refers to the unwind info and the static initializers, but they
+    // are needed at runtime.
+    if (isEHFrameSection(Header, S.getName()) ||
+        Header.sh_type == ELF::SHT_INIT_ARRAY ||
+        Header.sh_type == ELF::SHT_FINI_ARRAY ||
+        Header.sh_type == ELF::SHT_PREINIT_ARRAY)
+      S.getHeadAtom().setLive(true);
+  }
+
+  for (auto &KV : LocalSymbols)
+    if (!KV.second->empty())
+      SymbolTargets[KV.first].A = &KV.second->getHeadAtom();
+
+  return Error::success();
+}
+
+} // end namespace jitlink
+} // end namespace llvm
@@ -0,0 +1,142 @@
+//===------- ELFAtomGraphBuilder.h - ELF AtomGraph builder ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Generic ELF AtomGraph building code.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIB_EXECUTIONENGINE_JITLINK_ELFATOMGRAPHBUILDER_H
+#define LIB_EXECUTIONENGINE_JITLINK_ELFATOMGRAPHBUILDER_H
+
+#include "llvm/ExecutionEngine/JITLink/JITLink.h"
+
+#include "JITLinkGeneric.h"
+
+#include "llvm/Object/ELF.h"
+
+namespace llvm {
+namespace jitlink {
+
+/// Builds an AtomGraph from a relocatable 64-bit little-endian ELF object.
+///
+/// Relocatable ELF objects place all sections at address zero, so the builder
+/// assigns each allocatable section a distinct address in a synthetic address
+/// space before atomizing it.
+///
+/// Unlike MachO there is no .subsections_via_symbols guarantee: relocations
+/// routinely refer to local symbols or section symbols plus an offset that may
+/// cross symbol boundaries. The builder therefore splits sections into atoms
+/// at their global symbols only, and chains the atoms of each section with
+/// layout-next and keep-alive edges, so that a section is laid out (and dead
+/// stripped) as a whole.
+class ELFAtomGraphBuilder {
+public:
+  virtual ~ELFAtomGraphBuilder();
+  Expected<std::unique_ptr<AtomGraph>> buildGraph();
+
+protected:
+  using ELFT = object::ELF64LE;
+  using ELFFile = object::ELFFile<ELFT>;
+  using Elf_Shdr = ELFT::Shdr;
+  using Elf_Sym = ELFT::Sym;
+  using Elf_Rela = ELFT::Rela;
+
+  /// The atom a symbol resolves to, and the offset of the symbol in it.
+  struct SymbolTarget {
+    Atom *A = nullptr;
+    uint64_t Offset = 0;
+  };
+
+  class ELFSection {
+  public:
+    ELFSection() = default;
+
+    ELFSection(Section &GenericSection, const Elf_Shdr &Header,
+               JITTargetAddress Address)
+        : Header(&Header), GenericSection(&GenericSection), Address(Address) {}
+
+    Section &getGenericSection() const {
+      assert(GenericSection && "Section is null");
+      return *GenericSection;
+    }
+
+    const Elf_Shdr &getHeader() const { return *Header; }
+
+    StringRef getName() const { return getGenericSection().getName(); }
+
+    JITTargetAddress getAddress() const { return Address; }
+
+    uint64_t getSize() const { return Header->sh_size; }
+
+    bool empty() const { return getSize() == 0; }
+
+    bool isZeroFill() const { return Header->sh_type == ELF::SHT_NOBITS; }
+
+    ELFSection &setContent(StringRef Content) {
+      this->Content = Content;
+      return *this;
+    }
+
+    StringRef getContent() const {
+      assert(!isZeroFill() && "getContent() called on zero-fill section");
+      return Content;
+    }
+
+    /// Returns the atom at offset zero of this section.
+    DefinedAtom &getHeadAtom() const {
+      assert(HeadAtom && "Section has not been atomized");
+      return *HeadAtom;
+    }
+
+    void setHeadAtom(DefinedAtom &A) { HeadAtom = &A; }
+
+  private:
+    const Elf_Shdr *Header = nullptr;
+    Section *GenericSection = nullptr;
+    JITTargetAddress Address = 0;
+    StringRef Content;
+    DefinedAtom *HeadAtom = nullptr;
+  };
+
+  ELFAtomGraphBuilder(const ELFFile &Obj, StringRef FileName);
+
+  AtomGraph &getGraph() const { return *G; }
+
+  const ELFFile &getObject() const { return Obj; }
+
+  /// Returns the sections that were added to the graph by ELF section index.
+  const DenseMap<unsigned, ELFSection> &getSections() const {
+    return Sections;
+  }
+
+  /// Returns the atom and offset that the symbol with the given index of the
+  /// symbol table resolves to.
+  Expected<SymbolTarget> getSymbolTarget(uint32_t SymbolIndex) const;
+
+  virtual Error addRelocations() = 0;
+
+private:
+  static bool isEHFrameSection(const Elf_Shdr &Sec, StringRef Name);
+
+  Section &getCommonSection();
+
+  Error parseSections();
+  Error addAtoms();
+
+  const ELFFile &Obj;
+  std::unique_ptr<AtomGraph> G;
+  DenseMap<unsigned, ELFSection> Sections;
+  Section *CommonSection = nullptr;
+  std::vector<SymbolTarget> SymbolTargets;
+  const Elf_Shdr *SymTab = nullptr;
+};
+
+} // end namespace jitlink
+} // end namespace llvm
+
+#endif // LIB_EXECUTIONENGINE_JITLINK_ELFATOMGRAPHBUILDER_H
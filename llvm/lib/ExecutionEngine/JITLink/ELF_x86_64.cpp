@@ -0,0 +1,408 @@
+//===----- ELF_x86_64.cpp - JIT linker implementation for ELF/x86-64 ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// ELF/x86-64 jit-link implementation.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/ELF_x86_64.h"
+
+#include "BasicGOTAndStubsBuilder.h"
+#include "ELFAtomGraphBuilder.h"
+
+#define DEBUG_TYPE "jitlink"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::jitlink::ELF_x86_64_Edges;
+
+namespace {
+
+class ELFAtomGraphBuilder_x86_64 : public ELFAtomGraphBuilder {
+public:
+  ELFAtomGraphBuilder_x86_64(const ELFFile &Obj, StringRef FileName)
+      : ELFAtomGraphBuilder(Obj, FileName) {}
+
+private:
+  static Expected<ELFX86RelocationKind> getRelocationKind(uint32_t Type) {
+    switch (Type) {
+    case ELF::R_X86_64_64:
+      return Pointer64;
+    case ELF::R_X86_64_32:
+      return Pointer32;
+    case ELF::R_X86_64_32S:
+      return Pointer32Signed;
+    case ELF::R_X86_64_PC32:
+      return PCRel32;
+    case ELF::R_X86_64_PC64:
+      return PCRel64;
+    case ELF::R_X86_64_PLT32:
+      return Branch32;
+    case ELF::R_X86_64_GOTPCREL:
+      return PCRel32GOTLoad;
+    case ELF::R_X86_64_GOTPCRELX:
+    case ELF::R_X86_64_REX_GOTPCRELX:
+      return PCRel32GOTLoadRelaxable;
+    case ELF::R_X86_64_TPOFF32:
+    case ELF::R_X86_64_TPOFF64:
+    case ELF::R_X86_64_DTPOFF32:
+    case ELF::R_X86_64_DTPOFF64:
+    case ELF::R_X86_64_DTPMOD64:
+    case ELF::R_X86_64_GOTTPOFF:
+    case ELF::R_X86_64_TLSGD:
+    case ELF::R_X86_64_TLSLD:
+      return make_error<JITLinkError>(
+          "Thread-local x86-64 relocations are not supported: kind=" +
+          formatv("{0:d}", Type));
+    }
+
+    return make_error<JITLinkError>("Unsupported x86-64 relocation: kind=" +
+                                    formatv("{0:d}", Type));
+  }
+
+  Error addRelocations() override {
+    auto &G = getGraph();
+    auto &Obj = getObject();
+
+    auto ELFSections = Obj.sections();
+    if (!ELFSections)
+      return ELFSections.takeError();
+
+    for (auto &RelSec : *ELFSections) {
+      if (RelSec.sh_type != ELF::SHT_RELA && RelSec.sh_type != ELF::SHT_REL)
+        continue;
+
+      // Skip the relocations of sections that are not loaded, e.g. debug info.
+      auto TargetSecItr = getSections().find(RelSec.sh_info);
+      if (TargetSecItr == getSections().end())
+        continue;
+      auto &TargetSec = TargetSecItr->second;
+
+      if (RelSec.sh_type == ELF::SHT_REL)
+        return make_error<JITLinkError>("x86-64 REL relocations are not "
+                                        "supported");
+
+      if (TargetSec.isZeroFill())
+        return make_error<JITLinkError>("Relocations in zero-fill section " +
+                                        TargetSec.getName());
+
+      auto Relas = Obj.relas(&RelSec);
+      if (!Relas)
+        return Relas.takeError();
+
+      for (auto &Rela : *Relas) {
+        uint32_t Type = Rela.getType(false);
+        if (Type == ELF::R_X86_64_NONE)
+          continue;
+
+        // Sanity check the relocation kind.
+        auto Kind = getRelocationKind(Type);
+        if (!Kind)
+          return Kind.takeError();
+
+        // Find the address of the value to fix up.
+        JITTargetAddress FixupAddress = TargetSec.getAddress() + Rela.r_offset;
+
+        LLVM_DEBUG({
+          dbgs() << "Processing relocation at "
+                 << format("0x%016" PRIx64, FixupAddress) << "\n";
+        });
+
+        // Find the atom that the fixup points to.
+        DefinedAtom *AtomToFix = nullptr;
+        {
+          auto AtomToFixOrErr = G.findAtomByAddress(FixupAddress);
+          if (!AtomToFixOrErr)
+            return AtomToFixOrErr.takeError();
+          AtomToFix = &*AtomToFixOrErr;
+        }
+
+        unsigned FixupSize =
+            (*Kind == Pointer64 || *Kind == PCRel64) ? 8 : 4;
+        if (FixupAddress + FixupSize >
+            AtomToFix->getAddress() + AtomToFix->getContent().size())
+          return make_error<JITLinkError>(
+              "Relocation content extends past end of fixup atom");
+
+        auto Target = getSymbolTarget(Rela.getSymbol(false));
+        if (!Target)
+          return Target.takeError();
+
+        if ((*Kind == PCRel32GOTLoad || *Kind == PCRel32GOTLoadRelaxable) &&
+            !Target->A->hasName())
+          return make_error<JITLinkError>(
+              "GOT relocation at " + formatv("{0:x16}", FixupAddress) +
+              " refers to a local symbol, which is not supported");
+
+        int64_t Addend = Rela.r_addend + Target->Offset;
+
+        LLVM_DEBUG({
+          Edge GE(*Kind, FixupAddress - AtomToFix->getAddress(), *Target->A,
+                  Addend);
+          printEdge(dbgs(), *AtomToFix, GE,
+                    getELFX86RelocationKindName(*Kind));
+          dbgs() << "\n";
+        });
+        AtomToFix->addEdge(*Kind, FixupAddress - AtomToFix->getAddress(),
+                           *Target->A, Addend);
+      }
+    }
+    return Error::success();
+  }
+};
+
+/// Rewrites GOT loads of targets that are defined in the graph into direct
+/// address computations, i.e. "movq foo@GOTPCREL(%rip), %reg" into
+/// "leaq foo(%rip), %reg", so that they need no GOT entry at all. This is the
+/// relaxation the static linker performs for the small code model.
+static void relaxGOTLoads(AtomGraph &G) {
+  for (auto *DA : G.defined_atoms())
+    for (auto &E : DA->edges()) {
+      if (E.getKind() != PCRel32GOTLoadRelaxable || !E.getTarget().isDefined())
+        continue;
+
+      // Only the mov opcode can be relaxed. It precedes the ModRM byte.
+      if (E.getOffset() < 2 ||
+          static_cast<uint8_t>(DA->getContent()[E.getOffset() - 2]) != 0x8b)
+        continue;
+
+      LLVM_DEBUG({
+        dbgs() << "Relaxing GOT load ";
+        printEdge(dbgs(), *DA, E, getELFX86RelocationKindName(E.getKind()));
+        dbgs() << "\n";
+      });
+      E.setKind(PCRel32GOTLoadRelaxed);
+    }
+}
+
+class ELF_x86_64_GOTAndStubsBuilder
+    : public BasicGOTAndStubsBuilder<ELF_x86_64_GOTAndStubsBuilder> {
+public:
+  ELF_x86_64_GOTAndStubsBuilder(AtomGraph &G)
+      : BasicGOTAndStubsBuilder<ELF_x86_64_GOTAndStubsBuilder>(G) {}
+
+  bool isGOTEdge(Edge &E) const {
+    return E.getKind() == PCRel32GOTLoad ||
+           E.getKind() == PCRel32GOTLoadRelaxable;
+  }
+
+  DefinedAtom &createGOTEntry(Atom &Target) {
+    auto &GOTEntryAtom = G.addAnonymousAtom(getGOTSection(), 0x0, 8);
+    GOTEntryAtom.setContent(
+        StringRef(reinterpret_cast<const char *>(NullGOTEntryContent), 8));
+    GOTEntryAtom.addEdge(Pointer64, 0, Target, 0);
+    return GOTEntryAtom;
+  }
+
+  void fixGOTEdge(Edge &E, Atom &GOTEntry) {
+    assert(isGOTEdge(E) && "Not a GOT edge?");
+    E.setKind(PCRel32);
+    E.setTarget(GOTEntry);
+    // Leave the edge addend as-is.
+  }
+
+  bool isExternalBranchEdge(Edge &E) {
+    return E.getKind() == Branch32 && !E.getTarget().isDefined();
+  }
+
+  DefinedAtom &createStub(Atom &Target) {
+    auto &StubAtom = G.addAnonymousAtom(getStubsSection(), 0x0, 2);
+    StubAtom.setContent(
+        StringRef(reinterpret_cast<const char *>(StubContent), 6));
+
+    // Re-use GOT entries for stub targets. The jmp displacement is relative
+    // to the end of the stub.
+    auto &GOTEntryAtom = getGOTEntryAtom(Target);
+    StubAtom.addEdge(PCRel32, 2, GOTEntryAtom, -4);
+
+    return StubAtom;
+  }
+
+  void fixExternalBranchEdge(Edge &E, Atom &Stub) {
+    assert(E.getKind() == Branch32 && "Not a Branch32 edge?");
+    E.setTarget(Stub);
+    // Leave the edge addend as-is.
+  }
+
+private:
+  Section &getGOTSection() {
+    if (!GOTSection)
+      GOTSection = &G.createSection("$__GOT", 8, sys::Memory::MF_READ, false);
+    return *GOTSection;
+  }
+
+  Section &getStubsSection() {
+    if (!StubsSection) {
+      auto StubsProt = static_cast<sys::Memory::ProtectionFlags>(
+          sys::Memory::MF_READ | sys::Memory::MF_EXEC);
+      StubsSection = &G.createSection("$__STUBS", 8, StubsProt, false);
+    }
+    return *StubsSection;
+  }
+
+  static const uint8_t NullGOTEntryContent[8];
+  static const uint8_t StubContent[6];
+  Section *GOTSection = nullptr;
+  Section *StubsSection = nullptr;
+};
+
+const uint8_t ELF_x86_64_GOTAndStubsBuilder::NullGOTEntryContent[8] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+const uint8_t ELF_x86_64_GOTAndStubsBuilder::StubContent[6] = {
+    0xFF, 0x25, 0x00, 0x00, 0x00, 0x00};
+} // namespace
+
+namespace llvm {
+namespace jitlink {
+
+class ELFJITLinker_x86_64 : public JITLinker<ELFJITLinker_x86_64> {
+  friend class JITLinker<ELFJITLinker_x86_64>;
+
+public:
+  ELFJITLinker_x86_64(std::unique_ptr<JITLinkContext> Ctx,
+                      PassConfiguration PassConfig)
+      : JITLinker(std::move(Ctx), std::move(PassConfig)) {}
+
+private:
+  StringRef getEdgeKindName(Edge::Kind R) const override {
+    return getELFX86RelocationKindName(R);
+  }
+
+  Expected<std::unique_ptr<AtomGraph>>
+  buildGraph(MemoryBufferRef ObjBuffer) override {
+    auto ELFObj =
+        object::ELFFile<object::ELF64LE>::create(ObjBuffer.getBuffer());
+    if (!ELFObj)
+      return ELFObj.takeError();
+    if (ELFObj->getHeader()->e_type != ELF::ET_REL)
+      return make_error<JITLinkError>("Only relocatable ELF objects can be "
+                                      "jit-linked");
+    return ELFAtomGraphBuilder_x86_64(*ELFObj, ObjBuffer.getBufferIdentifier())
+        .buildGraph();
+  }
+
+  static Error targetOutOfRangeError(const Atom &A, const Edge &E) {
+    std::string ErrMsg;
+    {
+      raw_string_ostream ErrStream(ErrMsg);
+      ErrStream << "Relocation target out of range: ";
+      printEdge(ErrStream, A, E, getELFX86RelocationKindName(E.getKind()));
+      ErrStream << "\n";
+    }
+    return make_error<JITLinkError>(std::move(ErrMsg));
+  }
+
+  Error applyFixup(DefinedAtom &A, const Edge &E, char *AtomWorkingMem) const {
+    using namespace support;
+
+    char *FixupPtr = AtomWorkingMem + E.getOffset();
+    JITTargetAddress FixupAddress = A.getAddress() + E.getOffset();
+
+    switch (E.getKind()) {
+    case PCRel32GOTLoadRelaxed:
+      // Turn the mov into a lea.
+      FixupPtr[-2] = static_cast<char>(0x8d);
+      LLVM_FALLTHROUGH;
+    case Branch32:
+    case PCRel32: {
+      int64_t Value =
+          E.getTarget().getAddress() + E.getAddend() - FixupAddress;
+      if (Value < std::numeric_limits<int32_t>::min() ||
+          Value > std::numeric_limits<int32_t>::max())
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    case PCRel64: {
+      int64_t Value =
+          E.getTarget().getAddress() + E.getAddend() - FixupAddress;
+      *(little64_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer64: {
+      uint64_t Value = E.getTarget().getAddress() + E.getAddend();
+      *(ulittle64_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer32: {
+      uint64_t Value = E.getTarget().getAddress() + E.getAddend();
+      if (Value > std::numeric_limits<uint32_t>::max())
+        return targetOutOfRangeError(A, E);
+      *(ulittle32_t *)FixupPtr = Value;
+      break;
+    }
+    case Pointer32Signed: {
+      int64_t Value = E.getTarget().getAddress() + E.getAddend();
+      if (Value < std::numeric_limits<int32_t>::min() ||
+          Value > std::numeric_limits<int32_t>::max())
+        return targetOutOfRangeError(A, E);
+      *(little32_t *)FixupPtr = Value;
+      break;
+    }
+    default:
+      llvm_unreachable("Unrecognized edge kind");
+    }
+
+    return Error::success();
+  }
+};
+
+void jitLink_ELF_x86_64(std::unique_ptr<JITLinkContext> Ctx) {
+  PassConfiguration Config;
+  Triple TT("x86_64-unknown-linux");
+
+  if (Ctx->shouldAddDefaultTargetPasses(TT)) {
+    // Add a mark-live pass.
+    if (auto MarkLive = Ctx->getMarkLivePass(TT))
+      Config.PrePrunePasses.push_back(std::move(MarkLive));
+    else
+      Config.PrePrunePasses.push_back(markAllAtomsLive);
+
+    // Add an in-place GOT/Stubs pass, relaxing GOT loads first so that they
+    // do not get GOT entries.
+    Config.PostPrunePasses.push_back([](AtomGraph &G) -> Error {
+      relaxGOTLoads(G);
+      ELF_x86_64_GOTAndStubsBuilder(G).run();
+      return Error::success();
+    });
+  }
+
+  if (auto Err = Ctx->modifyPassConfig(TT, Config))
+    return Ctx->notifyFailed(std::move(Err));
+
+  // Construct a JITLinker and run the link function.
+  ELFJITLinker_x86_64::link(std::move(Ctx), std::move(Config));
+}
+
+StringRef getELFX86RelocationKindName(Edge::Kind R) {
+  switch (R) {
+  case Branch32:
+    return "Branch32";
+  case Pointer32:
+    return "Pointer32";
+  case Pointer32Signed:
+    return "Pointer32Signed";
+  case Pointer64:
+    return "Pointer64";
+  case PCRel32:
+    return "PCRel32";
+  case PCRel64:
+    return "PCRel64";
+  case PCRel32GOTLoad:
+    return "PCRel32GOTLoad";
+  case PCRel32GOTLoadRelaxable:
+    return "PCRel32GOTLoadRelaxable";
+  case PCRel32GOTLoadRelaxed:
+    return "PCRel32GOTLoadRelaxed";
+  default:
+    return getGenericEdgeKindName(static_cast<Edge::Kind>(R));
+  }
+}
+
+} // end namespace jitlink
+} // end namespace llvm
@@ -10,17 +10,51 @@
 #include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
 #include "llvm/Support/Process.h"
 
+#include <algorithm>
+
 namespace llvm {
 namespace jitlink {
 
 JITLinkMemoryManager::~JITLinkMemoryManager() = default;
 JITLinkMemoryManager::Allocation::~Allocation() = default;
 
+using AllocationMap = DenseMap<unsigned, sys::MemoryBlock>;
+
+static const sys::Memory::ProtectionFlags ReadWrite =
+    static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
+                                              sys::Memory::MF_WRITE);
+
+static Error applyProtections(AllocationMap &SegBlocks) {
+  for (auto &KV : SegBlocks) {
+    auto &Prot = KV.first;
+    auto &Block = KV.second;
+    if (auto EC = sys::Memory::protectMappedMemory(Block, Prot))
+      return errorCodeToError(EC);
+    if (Prot & sys::Memory::MF_EXEC)
+      sys::Memory::InvalidateInstructionCache(Block.base(),
+                                              Block.allocatedSize());
+  }
+  return Error::success();
+}
+
+static Error
+checkSegmentAlignment(const JITLinkMemoryManager::SegmentRequest &Seg) {
+  if (Seg.getContentAlignment() > sys::Process::getPageSizeEstimate())
+    return make_error<StringError>("Cannot request higher than page "
+                                   "alignment",
+                                   inconvertibleErrorCode());
+
+  if (sys::Process::getPageSizeEstimate() % Seg.getContentAlignment() != 0)
+    return make_error<StringError>("Page size is not a multiple of "
+                                   "alignment",
+                                   inconvertibleErrorCode());
+
+  return Error::success();
+}
+
 Expected<std::unique_ptr<JITLinkMemoryManager::Allocation>>
 InProcessMemoryManager::allocate(const SegmentsRequestMap &Request) {
 
-  using AllocationMap = DenseMap<unsigned, sys::MemoryBlock>;
-
   // Local class for allocation.
   class IPMMAlloc : public Allocation {
   public:
@@ -35,7 +69,7 @@ InProcessMemoryManager::allocate(const SegmentsRequestMap &Request) {
       return reinterpret_cast<JITTargetAddress>(SegBlocks[Seg].base());
     }
     void finalizeAsync(FinalizeContinuation OnFinalize) override {
-      OnFinalize(applyProtections());
+      OnFinalize(applyProtections(SegBlocks));
     }
     Error deallocate() override {
       for (auto &KV : SegBlocks)
@@ -45,39 +79,16 @@ InProcessMemoryManager::allocate(const SegmentsRequestMap &Request) {
     }
 
   private:
-    Error applyProtections() {
-      for (auto &KV : SegBlocks) {
-        auto &Prot = KV.first;
-        auto &Block = KV.second;
-        if (auto EC = sys::Memory::protectMappedMemory(Block, Prot))
-          return errorCodeToError(EC);
-        if (Prot & sys::Memory::MF_EXEC)
-          sys::Memory::InvalidateInstructionCache(Block.base(),
-                                                  Block.allocatedSize());
-      }
-      return Error::success();
-    }
-
     AllocationMap SegBlocks;
   };
 
   AllocationMap Blocks;
-  const sys::Memory::ProtectionFlags ReadWrite =
-      static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
-                                                sys::Memory::MF_WRITE);
 
   for (auto &KV : Request) {
     auto &Seg = KV.second;
 
-    if (Seg.getContentAlignment() > sys::Process::getPageSizeEstimate())
-      return make_error<StringError>("Cannot request higher than page "
-                                     "alignment",
-                                     inconvertibleErrorCode());
-
-    if (sys::Process::getPageSizeEstimate() % Seg.getContentAlignment() != 0)
-      return make_error<StringError>("Page size is not a multiple of "
-                                     "alignment",
-                                     inconvertibleErrorCode());
+    if (auto Err = checkSegmentAlignment(Seg))
+      return std::move(Err);
 
     uint64_t ZeroFillStart =
         alignTo(Seg.getContentSize(), Seg.getZeroFillAlignment());
@@ -101,5 +112,173 @@ InProcessMemoryManager::allocate(const SegmentsRequestMap &Request) {
       new IPMMAlloc(std::move(Blocks)));
 }
 
+class SlabMemoryManager::SlabAllocation : public Allocation {
+public:
+  SlabAllocation(SlabMemoryManager &MemMgr, AllocationMap SegBlocks)
+      : MemMgr(MemMgr), SegBlocks(std::move(SegBlocks)) {}
+
+  MutableArrayRef<char> getWorkingMemory(ProtectionFlags Seg) override {
+    assert(SegBlocks.count(Seg) && "No allocation for segment");
+    return {static_cast<char *>(SegBlocks[Seg].base()),
+            SegBlocks[Seg].allocatedSize()};
+  }
+
+  JITTargetAddress getTargetMemory(ProtectionFlags Seg) override {
+    assert(SegBlocks.count(Seg) && "No allocation for segment");
+    return reinterpret_cast<JITTargetAddress>(SegBlocks[Seg].base());
+  }
+
+  void finalizeAsync(FinalizeContinuation OnFinalize) override {
+    OnFinalize(applyProtections(SegBlocks));
+  }
+
+  Error deallocate() override {
+    Error Err = Error::success();
+    for (auto &KV : SegBlocks)
+      Err = joinErrors(
+          std::move(Err),
+          MemMgr.releaseBlock(static_cast<ProtectionFlags>(KV.first),
+                              KV.second));
+    SegBlocks.clear();
+    return Err;
+  }
+
+private:
+  SlabMemoryManager &MemMgr;
+  AllocationMap SegBlocks;
+};
+
+SlabMemoryManager::SlabMemoryManager(uint64_t SlabSize, bool UseHugePages)
+    : SlabSize(alignTo(SlabSize, sys::Process::getPageSizeEstimate())),
+      PageSize(sys::Process::getPageSizeEstimate()),
+      UseHugePages(UseHugePages) {}
+
+SlabMemoryManager::~SlabMemoryManager() {
+  for (auto &KV : ProtectionClasses)
+    for (auto &Slab : KV.second.Slabs)
+      sys::Memory::releaseMappedMemory(Slab);
+}
+
+Expected<std::unique_ptr<JITLinkMemoryManager::Allocation>>
+SlabMemoryManager::allocate(const SegmentsRequestMap &Request) {
+  AllocationMap Blocks;
+
+  // Returns the segments allocated so far to the slabs on failure.
+  auto ReleaseBlocks = [&]() {
+    for (auto &KV : Blocks)
+      consumeError(
+          releaseBlock(static_cast<ProtectionFlags>(KV.first), KV.second));
+  };
+
+  for (auto &KV : Request) {
+    auto &Seg = KV.second;
+
+    if (auto Err = checkSegmentAlignment(Seg)) {
+      ReleaseBlocks();
+      return std::move(Err);
+    }
+
+    uint64_t ZeroFillStart =
+        alignTo(Seg.getContentSize(), Seg.getZeroFillAlignment());
+    uint64_t SegmentSize = ZeroFillStart + Seg.getZeroFillSize();
+
+    auto SegMem = allocateBlock(static_cast<ProtectionFlags>(KV.first),
+                                alignTo(SegmentSize, PageSize));
+    if (!SegMem) {
+      ReleaseBlocks();
+      return SegMem.takeError();
+    }
+
+    // Zero out the zero-fill memory. Unlike freshly mapped memory, reused
+    // memory may hold the contents of an earlier allocation.
+    memset(static_cast<char *>(SegMem->base()) + ZeroFillStart, 0,
+           Seg.getZeroFillSize());
+
+    // Record the block for this segment.
+    Blocks[KV.first] = *SegMem;
+  }
+
+  return std::unique_ptr<JITLinkMemoryManager::Allocation>(
+      new SlabAllocation(*this, std::move(Blocks)));
+}
+
+Expected<sys::MemoryBlock>
+SlabMemoryManager::allocateBlock(ProtectionFlags Prot, uint64_t Size) {
+  if (Size == 0)
+    return sys::MemoryBlock();
+
+  std::lock_guard<std::mutex> Lock(SlabsMutex);
+  auto &PC = ProtectionClasses[Prot];
+
+  // Take the lowest free range that is large enough, so that memory is bump
+  // allocated from the start of the slabs while nothing has been freed.
+  auto I = std::find_if(PC.FreeRanges.begin(), PC.FreeRanges.end(),
+                        [&](const std::pair<const uintptr_t, uint64_t> &R) {
+                          return R.second >= Size;
+                        });
+
+  if (I == PC.FreeRanges.end()) {
+    // Slabs are writable until their segments are finalized.
+    unsigned Flags = ReadWrite;
+    if (UseHugePages && (Prot & sys::Memory::MF_EXEC))
+      Flags |= sys::Memory::MF_HUGE_HINT;
+
+    std::error_code EC;
+    auto Slab = sys::Memory::allocateMappedMemory(std::max(SlabSize, Size),
+                                                  nullptr, Flags, EC);
+    if (EC)
+      return errorCodeToError(EC);
+
+    PC.Slabs.push_back(Slab);
+    I = PC.FreeRanges
+            .insert({reinterpret_cast<uintptr_t>(Slab.base()),
+                     Slab.allocatedSize()})
+            .first;
+  }
+
+  uintptr_t Start = I->first;
+  uint64_t Remaining = I->second - Size;
+  PC.FreeRanges.erase(I);
+  if (Remaining)
+    PC.FreeRanges[Start + Size] = Remaining;
+
+  return sys::MemoryBlock(reinterpret_cast<void *>(Start), Size);
+}
+
+Error SlabMemoryManager::releaseBlock(ProtectionFlags Prot,
+                                      sys::MemoryBlock Block) {
+  if (Block.allocatedSize() == 0)
+    return Error::success();
+
+  // Make the memory writable again for the allocations that will reuse it.
+  if (auto EC = sys::Memory::protectMappedMemory(Block, ReadWrite))
+    return errorCodeToError(EC);
+
+  uintptr_t Start = reinterpret_cast<uintptr_t>(Block.base());
+  uint64_t Size = Block.allocatedSize();
+
+  std::lock_guard<std::mutex> Lock(SlabsMutex);
+  auto &FreeRanges = ProtectionClasses[Prot].FreeRanges;
+
+  // Coalesce with the free ranges either side of the block.
+  auto Next = FreeRanges.find(Start + Size);
+  if (Next != FreeRanges.end()) {
+    Size += Next->second;
+    FreeRanges.erase(Next);
+  }
+
+  auto I = FreeRanges.lower_bound(Start);
+  if (I != FreeRanges.begin()) {
+    auto Prev = std::prev(I);
+    if (Prev->first + Prev->second == Start) {
+      Prev->second += Size;
+      return Error::success();
+    }
+  }
+
+  FreeRanges[Start] = Size;
+  return Error::success();
+}
+
 } // end namespace jitlink
 } // end namespace llvm
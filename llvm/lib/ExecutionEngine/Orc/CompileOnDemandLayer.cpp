@@ -121,6 +121,17 @@ void CompileOnDemandLayer::setPartitionFunction(PartitionFunction Partition) {
 void CompileOnDemandLayer::setImplMap(ImplSymbolMap *Imp) {
   this->AliaseeImpls = Imp;
 }
+Error CompileOnDemandLayer::updateStubPointer(JITDylib &ImplJD,
+                                              const SymbolStringPtr &Name,
+                                              JITTargetAddress NewAddr) {
+  std::lock_guard<std::mutex> Lock(CODLayerMutex);
+  for (auto &KV : DylibResources)
+    if (&KV.second.getImplDylib() == &ImplJD)
+      return KV.second.getISManager().updatePointer(*Name, NewAddr);
+  return make_error<StringError>("No stubs for JITDylib " + ImplJD.getName(),
+                                 inconvertibleErrorCode());
+}
+
 void CompileOnDemandLayer::emit(MaterializationResponsibility R,
                                 ThreadSafeModule TSM) {
   assert(TSM && "Null module");
@@ -169,6 +180,7 @@ void CompileOnDemandLayer::emit(MaterializationResponsibility R,
 
 CompileOnDemandLayer::PerDylibResources &
 CompileOnDemandLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(CODLayerMutex);
   auto I = DylibResources.find(&TargetD);
   if (I == DylibResources.end()) {
     auto &ImplD = getExecutionSession().createJITDylib(
@@ -20,6 +20,8 @@
 #include "llvm/Target/TargetMachine.h"
 
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 namespace llvm {
 namespace orc {
@@ -72,14 +74,43 @@ void SimpleCompiler::notifyObjectCompiled(const Module &M,
     ObjCache->notifyObjectCompiled(&M, ObjBuffer.getMemBufferRef());
 }
 
+/// The target machines that no compile currently uses.
+class ConcurrentIRCompiler::TargetMachinePool {
+public:
+  /// Returns an unused target machine, or null if there is none.
+  std::unique_ptr<TargetMachine> take() {
+    std::lock_guard<std::mutex> Lock(PoolMutex);
+    if (Free.empty())
+      return nullptr;
+    auto TM = std::move(Free.back());
+    Free.pop_back();
+    return TM;
+  }
+
+  /// Makes \p TM available to the next compile.
+  void give(std::unique_ptr<TargetMachine> TM) {
+    std::lock_guard<std::mutex> Lock(PoolMutex);
+    Free.push_back(std::move(TM));
+  }
+
+private:
+  std::mutex PoolMutex;
+  std::vector<std::unique_ptr<TargetMachine>> Free;
+};
+
 ConcurrentIRCompiler::ConcurrentIRCompiler(JITTargetMachineBuilder JTMB,
                                            ObjectCache *ObjCache)
-    : JTMB(std::move(JTMB)), ObjCache(ObjCache) {}
+    : JTMB(std::move(JTMB)), ObjCache(ObjCache),
+      TMs(std::make_shared<TargetMachinePool>()) {}
 
 std::unique_ptr<MemoryBuffer> ConcurrentIRCompiler::operator()(Module &M) {
-  auto TM = cantFail(JTMB.createTargetMachine());
+  auto TM = TMs->take();
+  if (!TM)
+    TM = cantFail(JTMB.createTargetMachine());
   SimpleCompiler C(*TM, ObjCache);
-  return C(M);
+  auto Obj = C(M);
+  TMs->give(std::move(TM));
+  return Obj;
 }
 
 } // end namespace orc
@@ -11,6 +11,7 @@
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/Mangler.h"
+#include "llvm/Passes/PassBuilder.h"
 
 namespace llvm {
 namespace orc {
@@ -92,13 +93,13 @@ LLJIT::createCompileFunction(LLJITBuilderState &S,
   // Otherwise default to creating a SimpleCompiler, or ConcurrentIRCompiler,
   // depending on the number of threads requested.
   if (S.NumCompileThreads > 0)
-    return ConcurrentIRCompiler(std::move(JTMB));
+    return ConcurrentIRCompiler(std::move(JTMB), S.ObjCache);
 
   auto TM = JTMB.createTargetMachine();
   if (!TM)
     return TM.takeError();
 
-  return TMOwningSimpleCompiler(std::move(*TM));
+  return TMOwningSimpleCompiler(std::move(*TM), S.ObjCache);
 }
 
 LLJIT::LLJIT(LLJITBuilderState &S, Error &Err)
@@ -170,9 +171,39 @@ Error LLLazyJITBuilderState::prepareForConstruction() {
   if (auto Err = LLJITBuilderState::prepareForConstruction())
     return Err;
   TT = JTMB->getTargetTriple();
+
+  // Tier zero compiles quickly; tier one gets the optimizations.
+  if (TierUpThreshold != 0) {
+    Tier1JTMB = *JTMB;
+    Tier1JTMB->setCodeGenOptLevel(CodeGenOpt::Default);
+    JTMB->setCodeGenOptLevel(CodeGenOpt::None);
+  }
+
   return Error::success();
 }
 
+static Expected<ThreadSafeModule>
+optimizeTier1Module(ThreadSafeModule TSM,
+                    const MaterializationResponsibility &R) {
+  TSM.withModuleDo([](Module &M) {
+    PassBuilder PB;
+    LoopAnalysisManager LAM;
+    FunctionAnalysisManager FAM;
+    CGSCCAnalysisManager CGAM;
+    ModuleAnalysisManager MAM;
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+    ModulePassManager MPM =
+        PB.buildPerModuleDefaultPipeline(PassBuilder::OptimizationLevel::O2);
+    MPM.run(M, MAM);
+  });
+  return std::move(TSM);
+}
+
 Error LLLazyJIT::addLazyIRModule(JITDylib &JD, ThreadSafeModule TSM) {
   assert(TSM && "Can not add null module");
 
@@ -228,9 +259,32 @@ LLLazyJIT::LLLazyJIT(LLLazyJITBuilderState &S, Error &Err) : LLJIT(S, Err) {
   // Create the transform layer.
   TransformLayer = std::make_unique<IRTransformLayer>(*ES, *CompileLayer);
 
+  // If tiered compilation is enabled, put the tiered layer between the COD
+  // layer and the transform layer, with a second compile layer for tier one.
+  IRLayer *CODBaseLayer = TransformLayer.get();
+  if (S.TierUpThreshold != 0) {
+    auto Tier1CompileFunction =
+        createCompileFunction(S, std::move(*S.Tier1JTMB));
+    if (!Tier1CompileFunction) {
+      Err = Tier1CompileFunction.takeError();
+      return;
+    }
+    Tier1CompileLayer = std::make_unique<IRCompileLayer>(
+        *ES, *ObjLinkingLayer, std::move(*Tier1CompileFunction));
+    Tier1TransformLayer = std::make_unique<IRTransformLayer>(
+        *ES, *Tier1CompileLayer, optimizeTier1Module);
+    TieredLayer = std::make_unique<TieredCompileLayer>(
+        *ES, *TransformLayer, *Tier1TransformLayer, S.TierUpThreshold,
+        [this](JITDylib &JD, const SymbolStringPtr &Name,
+               JITTargetAddress Tier1Addr) {
+          return CODLayer->updateStubPointer(JD, Name, Tier1Addr);
+        });
+    CODBaseLayer = TieredLayer.get();
+  }
+
   // Create the COD layer.
   CODLayer = std::make_unique<CompileOnDemandLayer>(
-      *ES, *TransformLayer, *LCTMgr, std::move(ISMBuilder));
+      *ES, *CODBaseLayer, *LCTMgr, std::move(ISMBuilder));
 
   if (S.NumCompileThreads > 0)
     CODLayer->setCloneToNewContextOnEmit(true);
@@ -0,0 +1,133 @@
+//===---- PersistentObjectCache.cpp - On-disk cache for JIT'd objects -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace orc {
+
+static std::string getTargetKey(const JITTargetMachineBuilder &JTMB) {
+  std::string Key;
+  raw_string_ostream OS(Key);
+  OS << LLVM_VERSION_STRING << '\0' << JTMB.getTargetTriple().str() << '\0'
+     << JTMB.getCPU() << '\0' << JTMB.getFeatures().getString() << '\0';
+  if (auto &RM = JTMB.getRelocationModel())
+    OS << static_cast<int>(*RM);
+  OS << '\0';
+  if (auto &CM = JTMB.getCodeModel())
+    OS << static_cast<int>(*CM);
+  OS << '\0' << static_cast<int>(JTMB.getCodeGenOptLevel()) << '\0'
+     << JTMB.getOptions().EmulatedTLS;
+  return OS.str();
+}
+
+Expected<std::unique_ptr<PersistentObjectCache>>
+PersistentObjectCache::Create(StringRef CacheDir,
+                              const JITTargetMachineBuilder &JTMB,
+                              CachePruningPolicy Policy) {
+  if (auto EC = sys::fs::create_directories(CacheDir))
+    return createFileError(CacheDir, EC);
+
+  std::unique_ptr<PersistentObjectCache> Cache(new PersistentObjectCache(
+      CacheDir, getTargetKey(JTMB), std::move(Policy)));
+  Cache->prune();
+  return std::move(Cache);
+}
+
+PersistentObjectCache::PersistentObjectCache(std::string CacheDir,
+                                             std::string TargetKey,
+                                             CachePruningPolicy Policy)
+    : CacheDir(std::move(CacheDir)), TargetKey(std::move(TargetKey)),
+      Policy(std::move(Policy)) {}
+
+void PersistentObjectCache::notifyObjectCompiled(const Module *M,
+                                                 MemoryBufferRef Obj) {
+  std::string EntryPath;
+  {
+    std::lock_guard<std::mutex> Lock(PendingEntriesMutex);
+    auto I = PendingEntries.find(M);
+    if (I == PendingEntries.end())
+      return;
+    EntryPath = std::move(I->second);
+    PendingEntries.erase(I);
+  }
+
+  // Failing to write an entry only means that the object will be compiled
+  // again next time, so errors are dropped here. The "llvmcache-" prefix of the
+  // temporary file lets pruning clean up after writers that crashed.
+  auto Temp = sys::fs::TempFile::create(EntryPath + ".%%%%%%.tmp");
+  if (!Temp) {
+    consumeError(Temp.takeError());
+    return;
+  }
+
+  {
+    raw_fd_ostream OS(Temp->FD, /*shouldClose=*/false);
+    OS << Obj.getBuffer();
+    OS.flush();
+    if (OS.has_error()) {
+      OS.clear_error();
+      consumeError(Temp->discard());
+      return;
+    }
+  }
+
+  // Renaming is atomic, so a concurrent reader either sees the complete entry
+  // or no entry at all. If another process wrote the same entry in the
+  // meantime, its contents are identical.
+  consumeError(Temp->keep(EntryPath));
+}
+
+std::unique_ptr<MemoryBuffer>
+PersistentObjectCache::getObject(const Module *M) {
+  std::string EntryPath = getEntryPath(*M);
+
+  auto Obj = MemoryBuffer::getFile(EntryPath, /*FileSize=*/-1,
+                                   /*RequiresNullTerminator=*/false);
+  if (Obj)
+    return std::move(*Obj);
+
+  // This is a miss: Remember where to put the object once it is compiled.
+  // SimpleCompiler always asks for an object before compiling, so any stale
+  // entry for a module that failed to compile is replaced here.
+  std::lock_guard<std::mutex> Lock(PendingEntriesMutex);
+  PendingEntries[M] = std::move(EntryPath);
+  return nullptr;
+}
+
+void PersistentObjectCache::prune() { pruneCache(CacheDir, Policy); }
+
+std::string PersistentObjectCache::getEntryPath(const Module &M) const {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(M, OS);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(TargetKey);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+
+  SmallString<128> EntryPath(CacheDir);
+  sys::path::append(EntryPath, "llvmcache-" + toHex(Hasher.final()));
+  return EntryPath.str();
+}
+
+} // end namespace orc
+} // end namespace llvm
@@ -0,0 +1,194 @@
+//===------ TieredCompileLayer.cpp - Recompile hot functions --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+TieredCompileLayer::TieredCompileLayer(ExecutionSession &ES,
+                                       IRLayer &Tier0Layer,
+                                       IRLayer &Tier1Layer,
+                                       unsigned TierUpThreshold,
+                                       NotifyTierUpFunction NotifyTierUp)
+    : IRLayer(ES), Tier0Layer(Tier0Layer), Tier1Layer(Tier1Layer),
+      TierUpThreshold(TierUpThreshold), NotifyTierUp(std::move(NotifyTierUp)) {
+  assert(TierUpThreshold != 0 && "Tier-up threshold must be non-zero");
+}
+
+void TieredCompileLayer::emit(MaterializationResponsibility R,
+                              ThreadSafeModule TSM) {
+  assert(TSM && "Null module");
+
+  auto &ES = getExecutionSession();
+
+  // Find the functions that this responsibility covers.
+  std::vector<std::pair<std::string, SymbolStringPtr>> Functions;
+  TSM.withModuleDo([&](Module &M) {
+    if (any_of(M.globals(), [](const GlobalVariable &GV) {
+          return !GV.isDeclaration() && GV.hasLocalLinkage();
+        }))
+      return;
+
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    for (auto &F : M) {
+      if (F.isDeclaration() || F.hasLocalLinkage() ||
+          F.hasAvailableExternallyLinkage() ||
+          F.hasFnAttribute(Attribute::Naked))
+        continue;
+      auto Name = Mangle(F.getName());
+      if (R.getSymbols().count(Name))
+        Functions.push_back(std::make_pair(F.getName().str(), Name));
+    }
+  });
+
+  if (Functions.empty()) {
+    Tier0Layer.emit(std::move(R), std::move(TSM));
+    return;
+  }
+
+  // Keep the original IR around for tier one, and register the candidates.
+  auto Source = std::make_shared<ThreadSafeModule>(cloneToNewContext(TSM));
+  uint64_t FirstId;
+  {
+    std::lock_guard<std::mutex> Lock(CandidatesMutex);
+    FirstId = Candidates.size();
+    for (auto &KV : Functions)
+      Candidates.push_back({Source, &R.getTargetJITDylib(), KV.first,
+                            KV.second});
+  }
+
+  // Count the calls at the entry of each function, and call tierUpEntryPoint
+  // when the count reaches the threshold.
+  TSM.withModuleDo([&](Module &M) {
+    auto &Ctx = M.getContext();
+    auto *Int32Ty = Type::getInt32Ty(Ctx);
+    auto *Int64Ty = Type::getInt64Ty(Ctx);
+    auto *TierUpTy =
+        FunctionType::get(Type::getVoidTy(Ctx), {Int64Ty, Int64Ty}, false);
+    auto *TierUpFn = ConstantExpr::getIntToPtr(
+        ConstantInt::get(Int64Ty,
+                         pointerToJITTargetAddress(&tierUpEntryPoint)),
+        TierUpTy->getPointerTo());
+    auto *LayerAddr =
+        ConstantInt::get(Int64Ty, pointerToJITTargetAddress(this));
+
+    for (size_t I = 0, E = Functions.size(); I != E; ++I) {
+      Function &F = *M.getFunction(Functions[I].first);
+
+      auto *Counter = new GlobalVariable(
+          M, Int32Ty, false, GlobalValue::InternalLinkage,
+          ConstantInt::get(Int32Ty, 0), "__orc_tier_up.count." + F.getName());
+
+      // Keep the static allocas in the entry block.
+      BasicBlock &Entry = F.getEntryBlock();
+      auto IP = Entry.begin();
+      while (isa<AllocaInst>(IP))
+        ++IP;
+      BasicBlock *Body = Entry.splitBasicBlock(IP, "tier_up.body");
+      Entry.getTerminator()->eraseFromParent();
+      BasicBlock *TierUp = BasicBlock::Create(Ctx, "tier_up", &F, Body);
+
+      IRBuilder<> Builder(&Entry);
+      auto *Count = Builder.CreateAdd(Builder.CreateLoad(Int32Ty, Counter),
+                                      ConstantInt::get(Int32Ty, 1));
+      Builder.CreateStore(Count, Counter);
+      Builder.CreateCondBr(
+          Builder.CreateICmpEQ(Count,
+                               ConstantInt::get(Int32Ty, TierUpThreshold)),
+          TierUp, Body);
+
+      Builder.SetInsertPoint(TierUp);
+      Builder.CreateCall(TierUpTy, TierUpFn,
+                         {LayerAddr, ConstantInt::get(Int64Ty, FirstId + I)});
+      Builder.CreateBr(Body);
+    }
+  });
+
+  Tier0Layer.emit(std::move(R), std::move(TSM));
+}
+
+void TieredCompileLayer::tierUpEntryPoint(TieredCompileLayer *Layer,
+                                          uint64_t Id) {
+  Layer->tierUp(Id);
+}
+
+void TieredCompileLayer::tierUp(uint64_t Id) {
+  TierUpCandidate C;
+  {
+    std::lock_guard<std::mutex> Lock(CandidatesMutex);
+    assert(Id < Candidates.size() && "Invalid tier-up candidate");
+    // The counter reaches the threshold again after wrapping around.
+    if (!Candidates[Id].Source)
+      return;
+    C = Candidates[Id];
+    Candidates[Id].Source = nullptr;
+  }
+
+  LLVM_DEBUG(dbgs() << "Tiering up " << *C.Name << "\n");
+
+  auto &ES = getExecutionSession();
+
+  // Copy the function and the local functions that it might call. Everything
+  // else is referenced in the original JITDylib.
+  auto TSM = cloneToNewContext(*C.Source, [&](const GlobalValue &GV) {
+    return GV.getName() == C.FunctionName ||
+           (isa<Function>(GV) && GV.hasLocalLinkage());
+  });
+  C.Source = nullptr;
+
+  SymbolStringPtr Tier1Name;
+  TSM.withModuleDo([&](Module &M) {
+    // Declarations of intrinsic globals like llvm.global_ctors are invalid.
+    for (auto &GV : make_early_inc_range(M.globals()))
+      if (GV.isDeclaration() && GV.getName().startswith("llvm.") &&
+          GV.use_empty())
+        GV.eraseFromParent();
+
+    // Make sure that the optimizer keeps the tier-1 definition.
+    Function &F = *M.getFunction(C.FunctionName);
+    F.setName(C.FunctionName + "$tier1");
+    F.setLinkage(GlobalValue::ExternalLinkage);
+    F.setComdat(nullptr);
+    Tier1Name = MangleAndInterner(ES, M.getDataLayout())(F.getName());
+  });
+
+  if (auto Err = Tier1Layer.add(*C.JD, std::move(TSM), ES.allocateVModule())) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+
+  JITDylib &JD = *C.JD;
+  SymbolStringPtr Name = std::move(C.Name);
+  ES.lookup(JITDylibSearchList({{&JD, true}}), SymbolNameSet({Tier1Name}),
+            SymbolState::Ready,
+            [this, &JD, Name, Tier1Name](Expected<SymbolMap> Result) {
+              auto &ES = getExecutionSession();
+              if (!Result) {
+                ES.reportError(Result.takeError());
+                return;
+              }
+              if (auto Err =
+                      NotifyTierUp(JD, Name, (*Result)[Tier1Name].getAddress()))
+                ES.reportError(std::move(Err));
+            },
+            NoDependenciesToRegister);
+}
+
+} // end namespace orc
+} // end namespace llvm
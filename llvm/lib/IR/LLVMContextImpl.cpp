@@ -14,6 +14,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/OptBisect.h"
 #include "llvm/IR/Type.h"
+#include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ManagedStatic.h"
 #include <cassert>
 #include <utility>
@@ -215,9 +216,11 @@ uint32_t LLVMContextImpl::getOperandBundleTagID(StringRef Tag) const {
 
 SyncScope::ID LLVMContextImpl::getOrInsertSyncScopeID(StringRef SSN) {
   auto NewSSID = SSC.size();
-  assert(NewSSID < std::numeric_limits<SyncScope::ID>::max() &&
-         "Hit the maximum number of synchronization scopes allowed!");
-  return SSC.insert(std::make_pair(SSN, SyncScope::ID(NewSSID))).first->second;
+  auto Insertion = SSC.insert(std::make_pair(SSN, SyncScope::ID(NewSSID)));
+  if (Insertion.second && NewSSID >= SyncScope::MaxNumScopes)
+    report_fatal_error("Hit the maximum number of synchronization scopes "
+                       "allowed!");
+  return Insertion.first->second;
 }
 
 void LLVMContextImpl::getSyncScopeNames(
@@ -8,10 +8,17 @@
 
 #include "llvm/IR/PassManager.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/CFG.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/CommandLine.h"
 
 using namespace llvm;
 
+static cl::opt<bool> PreserveUnchangedCFGAnalyses(
+    "preserve-unchanged-cfg-analyses", cl::init(false), cl::Hidden,
+    cl::desc("Keep the CFG analyses of a function pass that did not change "
+             "the CFG, even if the pass did not preserve them"));
+
 // Explicit template instantiations and specialization defininitions for core
 // template typedefs.
 namespace llvm {
@@ -92,4 +99,39 @@ bool FunctionAnalysisManagerModuleProxy::Result::invalidate(
 
 AnalysisSetKey CFGAnalyses::SetKey;
 
+static void snapshotCFG(Function &F, SmallVectorImpl<const BasicBlock *> &CFG) {
+  for (const BasicBlock &BB : F) {
+    CFG.push_back(&BB);
+    CFG.append(succ_begin(&BB), succ_end(&BB));
+    CFG.push_back(nullptr);
+  }
+}
+
+detail::CFGChangeTracker<Function>::CFGChangeTracker(Function &F)
+    : Enabled(PreserveUnchangedCFGAnalyses) {
+  if (!Enabled)
+    return;
+  for (BasicBlock &BB : F)
+    Blocks.push_back(&BB);
+  snapshotCFG(F, CFG);
+}
+
+void detail::CFGChangeTracker<Function>::preserveCFGIfUnchanged(
+    Function &F, PreservedAnalyses &PA) {
+  if (!Enabled)
+    return;
+  if (PA.allAnalysesInSetPreserved<CFGAnalyses>() ||
+      PA.allAnalysesInSetPreserved<AllAnalysesOn<Function>>())
+    return;
+
+  // The successors are compared by address below, which is only meaningful if
+  // none of the blocks was deleted.
+  if (any_of(Blocks, [](const WeakVH &BB) { return !BB; }))
+    return;
+  SmallVector<const BasicBlock *, 32> NewCFG;
+  snapshotCFG(F, NewCFG);
+  if (NewCFG == CFG)
+    PA.preserveSet<CFGAnalyses>();
+}
+
 AnalysisSetKey PreservedAnalyses::AllAnalysesKey;
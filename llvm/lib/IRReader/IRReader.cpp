@@ -53,15 +53,25 @@ std::unique_ptr<Module> llvm::getLazyIRFileModule(StringRef Filename,
                                                   SMDiagnostic &Err,
                                                   LLVMContext &Context,
                                                   bool ShouldLazyLoadMetadata) {
+  // Bitcode does not need a null terminator, so don't ask for one: this lets
+  // large files always be mapped, and only the function bodies and metadata
+  // that are materialized get paged in. Textual IR is copied into a
+  // terminated buffer for the lexer.
   ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
-      MemoryBuffer::getFileOrSTDIN(Filename);
+      MemoryBuffer::getFileOrSTDIN(Filename, /*FileSize=*/-1,
+                                   /*RequiresNullTerminator=*/false);
   if (std::error_code EC = FileOrErr.getError()) {
     Err = SMDiagnostic(Filename, SourceMgr::DK_Error,
                        "Could not open input file: " + EC.message());
     return nullptr;
   }
 
-  return getLazyIRModule(std::move(FileOrErr.get()), Err, Context,
+  std::unique_ptr<MemoryBuffer> Buffer = std::move(FileOrErr.get());
+  if (!isBitcode((const unsigned char *)Buffer->getBufferStart(),
+                 (const unsigned char *)Buffer->getBufferEnd()))
+    Buffer = MemoryBuffer::getMemBufferCopy(Buffer->getBuffer(),
+                                            Buffer->getBufferIdentifier());
+  return getLazyIRModule(std::move(Buffer), Err, Context,
                          ShouldLazyLoadMetadata);
 }
 
@@ -38,6 +38,7 @@
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/VCSRevision.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
@@ -65,23 +66,9 @@ cl::opt<bool> EnableLTOInternalization(
     "enable-lto-internalization", cl::init(true), cl::Hidden,
     cl::desc("Enable global value internalization in LTO"));
 
-// Computes a unique hash for the Module considering the current list of
-// export/import and other global analysis results.
-// The hash is produced in \p Key.
-void llvm::computeLTOCacheKey(
-    SmallString<40> &Key, const Config &Conf, const ModuleSummaryIndex &Index,
-    StringRef ModuleID, const FunctionImporter::ImportMapTy &ImportList,
-    const FunctionImporter::ExportSetTy &ExportList,
-    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
-    const GVSummaryMapTy &DefinedGlobals,
-    const std::set<GlobalValue::GUID> &CfiFunctionDefs,
-    const std::set<GlobalValue::GUID> &CfiFunctionDecls) {
-  // Compute the unique hash for this entry.
-  // This is based on the current compiler version, the module itself, the
-  // export list, the hash for every single module in the import list, the
-  // list of ResolvedODR for the module, and the list of preserved symbols.
-  SHA1 Hasher;
-
+// Adds the compiler revision and the parts of the LTO configuration that
+// affect code generation to \p Hasher.
+static void addConfigToHash(SHA1 &Hasher, const Config &Conf) {
   // Start with the compiler revision
   Hasher.update(LLVM_VERSION_STRING);
 #ifdef LLVM_REVISION
@@ -101,18 +88,6 @@ void llvm::computeLTOCacheKey(
     Data[3] = I >> 24;
     Hasher.update(ArrayRef<uint8_t>{Data, 4});
   };
-  auto AddUint64 = [&](uint64_t I) {
-    uint8_t Data[8];
-    Data[0] = I;
-    Data[1] = I >> 8;
-    Data[2] = I >> 16;
-    Data[3] = I >> 24;
-    Data[4] = I >> 32;
-    Data[5] = I >> 40;
-    Data[6] = I >> 48;
-    Data[7] = I >> 56;
-    Hasher.update(ArrayRef<uint8_t>{Data, 8});
-  };
   AddString(Conf.CPU);
   // FIXME: Hash more of Options. For now all clients initialize Options from
   // command-line flags (which is unsupported in production), but may set
@@ -142,6 +117,50 @@ void llvm::computeLTOCacheKey(
   AddString(Conf.OverrideTriple);
   AddString(Conf.DefaultTriple);
   AddString(Conf.DwoDir);
+}
+
+// Computes a unique hash for the Module considering the current list of
+// export/import and other global analysis results.
+// The hash is produced in \p Key.
+void llvm::computeLTOCacheKey(
+    SmallString<40> &Key, const Config &Conf, const ModuleSummaryIndex &Index,
+    StringRef ModuleID, const FunctionImporter::ImportMapTy &ImportList,
+    const FunctionImporter::ExportSetTy &ExportList,
+    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
+    const GVSummaryMapTy &DefinedGlobals,
+    const std::set<GlobalValue::GUID> &CfiFunctionDefs,
+    const std::set<GlobalValue::GUID> &CfiFunctionDecls) {
+  // Compute the unique hash for this entry.
+  // This is based on the current compiler version, the module itself, the
+  // export list, the hash for every single module in the import list, the
+  // list of ResolvedODR for the module, and the list of preserved symbols.
+  SHA1 Hasher;
+  addConfigToHash(Hasher, Conf);
+
+  auto AddString = [&](StringRef Str) {
+    Hasher.update(Str);
+    Hasher.update(ArrayRef<uint8_t>{0});
+  };
+  auto AddUnsigned = [&](unsigned I) {
+    uint8_t Data[4];
+    Data[0] = I;
+    Data[1] = I >> 8;
+    Data[2] = I >> 16;
+    Data[3] = I >> 24;
+    Hasher.update(ArrayRef<uint8_t>{Data, 4});
+  };
+  auto AddUint64 = [&](uint64_t I) {
+    uint8_t Data[8];
+    Data[0] = I;
+    Data[1] = I >> 8;
+    Data[2] = I >> 16;
+    Data[3] = I >> 24;
+    Data[4] = I >> 32;
+    Data[5] = I >> 40;
+    Data[6] = I >> 48;
+    Data[7] = I >> 56;
+    Hasher.update(ArrayRef<uint8_t>{Data, 8});
+  };
 
   // Include the hash for the current module
   auto ModHash = Index.getModuleHash(ModuleID);
@@ -298,6 +317,25 @@ void llvm::computeLTOCacheKey(
   Key = toHex(Hasher.result());
 }
 
+void llvm::computeLTOCodeGenCacheKey(SmallString<40> &Key,
+                                     const Config &Conf, const Module &M) {
+  SHA1 Hasher;
+  addConfigToHash(Hasher, Conf);
+  // Keep these keys apart from the ones of whole backend jobs.
+  Hasher.update("codegen");
+  Hasher.update(ArrayRef<uint8_t>{0});
+
+  // Hash the module as bitcode. The symbol table is not needed for that.
+  SmallVector<char, 0> Buffer;
+  BitcodeWriter Writer(Buffer);
+  Writer.writeModule(M);
+  Writer.writeStrtab();
+  Hasher.update(ArrayRef<uint8_t>((const uint8_t *)Buffer.data(),
+                                  Buffer.size()));
+
+  Key = toHex(Hasher.result());
+}
+
 static void thinLTOResolvePrevailingGUID(
     ValueInfo VI, DenseSet<GlobalValueSummary *> &GlobalInvolvedWithAlias,
     function_ref<bool(GlobalValue::GUID, const GlobalValueSummary *)>
@@ -1036,6 +1074,23 @@ public:
 };
 
 namespace {
+// Estimates how long the backend job for a module takes, as the number of
+// instructions in the functions that it defines or imports.
+uint64_t getThinBackendCost(const ModuleSummaryIndex &CombinedIndex,
+                            const GVSummaryMapTy &DefinedGlobals,
+                            const FunctionImporter::ImportMapTy &ImportList) {
+  uint64_t Cost = 0;
+  for (auto &GV : DefinedGlobals)
+    if (auto *FS = dyn_cast<FunctionSummary>(GV.second))
+      Cost += FS->instCount();
+  for (auto &FromModule : ImportList)
+    for (GlobalValue::GUID GUID : FromModule.second)
+      if (auto *FS = dyn_cast_or_null<FunctionSummary>(
+              CombinedIndex.findSummaryInModule(GUID, FromModule.first())))
+        Cost += FS->instCount();
+  return Cost;
+}
+
 class InProcessThinBackend : public ThinBackendProc {
   ThreadPool BackendThreadPool;
   AddStreamFn AddStream;
@@ -1043,6 +1098,10 @@ class InProcessThinBackend : public ThinBackendProc {
   std::set<GlobalValue::GUID> CfiFunctionDefs;
   std::set<GlobalValue::GUID> CfiFunctionDecls;
 
+  /// The jobs queued by start() with their estimated cost. wait() runs them.
+  using Job = std::pair<uint64_t, std::function<void()>>;
+  std::vector<Job> Jobs;
+
   Optional<Error> Err;
   std::mutex ErrMu;
 
@@ -1111,17 +1170,23 @@ public:
     assert(ModuleToDefinedGVSummaries.count(ModulePath));
     const GVSummaryMapTy &DefinedGlobals =
         ModuleToDefinedGVSummaries.find(ModulePath)->second;
-    BackendThreadPool.async(
-        [=](BitcodeModule BM, ModuleSummaryIndex &CombinedIndex,
-            const FunctionImporter::ImportMapTy &ImportList,
-            const FunctionImporter::ExportSetTy &ExportList,
-            const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes>
-                &ResolvedODR,
-            const GVSummaryMapTy &DefinedGlobals,
-            MapVector<StringRef, BitcodeModule> &ModuleMap) {
-          Error E = runThinLTOBackendThread(
-              AddStream, Cache, Task, BM, CombinedIndex, ImportList, ExportList,
-              ResolvedODR, DefinedGlobals, ModuleMap);
+    Jobs.emplace_back(
+        getThinBackendCost(CombinedIndex, DefinedGlobals, ImportList),
+        [=, &ImportList, &ExportList, &ResolvedODR, &DefinedGlobals,
+         &ModuleMap] {
+          // Each job records into a profiler of its own, handed over to the
+          // one of the calling thread when it is done.
+          if (Conf.TimeTraceEnabled)
+            timeTraceProfilerInitialize(Conf.TimeTraceGranularity,
+                                        "thin backend");
+          Error E = [&] {
+            TimeTraceScope Scope("ThinLTO backend", ModulePath);
+            return runThinLTOBackendThread(
+                AddStream, Cache, Task, BM, CombinedIndex, ImportList,
+                ExportList, ResolvedODR, DefinedGlobals, ModuleMap);
+          }();
+          if (Conf.TimeTraceEnabled)
+            timeTraceProfilerFinishThread();
           if (E) {
             std::unique_lock<std::mutex> L(ErrMu);
             if (Err)
@@ -1129,13 +1194,19 @@ public:
             else
               Err = std::move(E);
           }
-        },
-        BM, std::ref(CombinedIndex), std::ref(ImportList), std::ref(ExportList),
-        std::ref(ResolvedODR), std::ref(DefinedGlobals), std::ref(ModuleMap));
+        });
     return Error::success();
   }
 
   Error wait() override {
+    // Start the most expensive jobs first. Job times vary widely, and a long
+    // job started last would finish well after all the others.
+    llvm::stable_sort(Jobs, [](const Job &L, const Job &R) {
+      return L.first > R.first;
+    });
+    for (Job &J : Jobs)
+      BackendThreadPool.async(std::move(J.second));
+    Jobs.clear();
     BackendThreadPool.wait();
     if (Err)
       return std::move(*Err);
@@ -1365,13 +1436,16 @@ Error LTO::runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache,
 Expected<std::unique_ptr<ToolOutputFile>>
 lto::setupOptimizationRemarks(LLVMContext &Context, StringRef RemarksFilename,
                               StringRef RemarksPasses, StringRef RemarksFormat,
-                              bool RemarksWithHotness, int Count) {
+                              bool RemarksWithHotness,
+                              unsigned RemarksHotnessThreshold, int Count) {
   std::string Filename = RemarksFilename;
   if (!Filename.empty() && Count != -1)
-    Filename += ".thin." + llvm::utostr(Count) + ".yaml";
+    Filename += ".thin." + llvm::utostr(Count) + "." +
+                (RemarksFormat.empty() ? "yaml" : RemarksFormat.str());
 
   auto ResultOrErr = llvm::setupOptimizationRemarks(
-      Context, Filename, RemarksPasses, RemarksFormat, RemarksWithHotness);
+      Context, Filename, RemarksPasses, RemarksFormat, RemarksWithHotness,
+      RemarksHotnessThreshold);
   if (Error E = ResultOrErr.takeError())
     return std::move(E);
 
@@ -24,6 +24,7 @@
 #include "llvm/IR/PassManager.h"
 #include "llvm/IR/RemarkStreamer.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/LTO/Caching.h"
 #include "llvm/LTO/LTO.h"
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Object/ModuleSymbolTable.h"
@@ -350,51 +351,78 @@ void codegen(Config &Conf, TargetMachine *TM, AddStreamFn AddStream,
     DwoOut->keep();
 }
 
+// Turns M, a lazily loaded copy of the module splitCodeGen prepared, into its
+// partition I.
+void extractPartition(Module &M, const StringMap<unsigned> &Partitions,
+                      unsigned I) {
+  std::vector<GlobalValue *> OtherPartitions;
+  for (GlobalValue &GV : M.global_values()) {
+    if (GV.isDeclaration())
+      continue;
+    auto It = Partitions.find(GV.getName());
+    if (It == Partitions.end() || It->second != I)
+      OtherPartitions.push_back(&GV);
+  }
+
+  // Aliases can't be turned into declarations: they are replaced by new ones,
+  // and only removed once all of them were visited.
+  std::vector<GlobalValue *> Replaced;
+  for (GlobalValue *GV : OtherPartitions)
+    if (!convertToDeclaration(*GV))
+      Replaced.push_back(GV);
+  for (GlobalValue *GV : Replaced) {
+    GV->removeDeadConstantUsers();
+    GV->eraseFromParent();
+  }
+
+  if (I != 0)
+    M.setModuleInlineAsm("");
+}
+
 void splitCodeGen(Config &C, TargetMachine *TM, AddStreamFn AddStream,
                   unsigned ParallelCodeGenParallelismLevel,
                   std::unique_ptr<Module> Mod) {
   ThreadPool CodegenThreadPool(ParallelCodeGenParallelismLevel);
-  unsigned ThreadCount = 0;
   const Target *T = &TM->getTarget();
 
-  SplitModule(
-      std::move(Mod), ParallelCodeGenParallelismLevel,
-      [&](std::unique_ptr<Module> MPart) {
-        // We want to clone the module in a new context to multi-thread the
-        // codegen. We do it by serializing partition modules to bitcode
-        // (while still on the main thread, in order to avoid data races) and
-        // spinning up new threads which deserialize the partitions into
-        // separate contexts.
-        // FIXME: Provide a more direct way to do this in LLVM.
-        SmallString<0> BC;
-        raw_svector_ostream BCOS(BC);
-        WriteBitcodeToFile(*MPart, BCOS);
-
-        // Enqueue the task
-        CodegenThreadPool.async(
-            [&](const SmallString<0> &BC, unsigned ThreadId) {
-              LTOLLVMContext Ctx(C);
-              Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
-                  MemoryBufferRef(StringRef(BC.data(), BC.size()), "ld-temp.o"),
-                  Ctx);
-              if (!MOrErr)
-                report_fatal_error("Failed to read bitcode");
-              std::unique_ptr<Module> MPartInCtx = std::move(MOrErr.get());
-
-              std::unique_ptr<TargetMachine> TM =
-                  createTargetMachine(C, T, *MPartInCtx);
-
-              codegen(C, TM.get(), AddStream, ThreadId, *MPartInCtx);
-            },
-            // Pass BC using std::move to ensure that it get moved rather than
-            // copied into the thread's context.
-            std::move(BC), ThreadCount++);
-      },
-      false);
-
-  // Because the inner lambda (which runs in a worker thread) captures our local
-  // variables, we need to wait for the worker threads to terminate before we
-  // can leave the function scope.
+  // We want to create the partitions in new contexts to multi-thread the
+  // codegen. Rather than cloning and serializing each partition on the main
+  // thread, we only partition the module here and serialize it once; each
+  // worker thread then lazily loads it into its own context and materializes
+  // nothing but the definitions of its partition.
+  StringMap<unsigned> Partitions;
+  computeModulePartitions(*Mod, ParallelCodeGenParallelismLevel,
+                          [&](const GlobalValue &GV, unsigned Partition) {
+                            Partitions[GV.getName()] = Partition;
+                          });
+
+  SmallString<0> BC;
+  raw_svector_ostream BCOS(BC);
+  WriteBitcodeToFile(*Mod, BCOS);
+  Mod.reset();
+
+  for (unsigned I = 0; I != ParallelCodeGenParallelismLevel; ++I)
+    CodegenThreadPool.async([&, I] {
+      LTOLLVMContext Ctx(C);
+      Expected<std::unique_ptr<Module>> MOrErr = getLazyBitcodeModule(
+          MemoryBufferRef(StringRef(BC.data(), BC.size()), "ld-temp.o"), Ctx);
+      if (!MOrErr)
+        report_fatal_error("Failed to read bitcode");
+      std::unique_ptr<Module> MPartInCtx = std::move(MOrErr.get());
+
+      extractPartition(*MPartInCtx, Partitions, I);
+      if (Error E = MPartInCtx->materializeAll())
+        report_fatal_error("Failed to read bitcode: " +
+                           toString(std::move(E)));
+
+      std::unique_ptr<TargetMachine> TM =
+          createTargetMachine(C, T, *MPartInCtx);
+
+      codegen(C, TM.get(), AddStream, I, *MPartInCtx);
+    });
+
+  // Because the worker threads use our local variables, we need to wait for
+  // them to terminate before we can leave the function scope.
   CodegenThreadPool.wait();
 }
 
@@ -414,11 +442,14 @@ Expected<const Target *> initAndLookupTarget(Config &C, Module &Mod) {
 }
 
 static Error
-finalizeOptimizationRemarks(std::unique_ptr<ToolOutputFile> DiagOutputFile) {
+finalizeOptimizationRemarks(LLVMContext &Context,
+                            std::unique_ptr<ToolOutputFile> DiagOutputFile) {
   // Make sure we flush the diagnostic remarks file in case the linker doesn't
   // call the global destructors before exiting.
   if (!DiagOutputFile)
     return Error::success();
+  if (RemarkStreamer *RS = Context.getRemarkStreamer())
+    RS->finalize();
   DiagOutputFile->keep();
   DiagOutputFile->os().flush();
   return Error::success();
@@ -434,10 +465,12 @@ Error lto::backend(Config &C, AddStreamFn AddStream,
 
   std::unique_ptr<TargetMachine> TM = createTargetMachine(C, *TOrErr, *Mod);
 
-  // Setup optimization remarks.
+  // Setup optimization remarks. The context outlives the module, which may be
+  // handed over to splitCodeGen.
+  LLVMContext &Context = Mod->getContext();
   auto DiagFileOrErr = lto::setupOptimizationRemarks(
-      Mod->getContext(), C.RemarksFilename, C.RemarksPasses, C.RemarksFormat,
-      C.RemarksWithHotness);
+      Context, C.RemarksFilename, C.RemarksPasses, C.RemarksFormat,
+      C.RemarksWithHotness, C.RemarksHotnessThreshold);
   if (!DiagFileOrErr)
     return DiagFileOrErr.takeError();
   auto DiagnosticOutputFile = std::move(*DiagFileOrErr);
@@ -445,7 +478,8 @@ Error lto::backend(Config &C, AddStreamFn AddStream,
   if (!C.CodeGenOnly) {
     if (!opt(C, TM.get(), 0, *Mod, /*IsThinLTO=*/false,
              /*ExportSummary=*/&CombinedIndex, /*ImportSummary=*/nullptr))
-      return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+      return finalizeOptimizationRemarks(Context,
+                                         std::move(DiagnosticOutputFile));
   }
 
   if (ParallelCodeGenParallelismLevel == 1) {
@@ -454,7 +488,7 @@ Error lto::backend(Config &C, AddStreamFn AddStream,
     splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel,
                  std::move(Mod));
   }
-  return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+  return finalizeOptimizationRemarks(Context, std::move(DiagnosticOutputFile));
 }
 
 static void dropDeadSymbols(Module &Mod, const GVSummaryMapTy &DefinedGlobals,
@@ -478,6 +512,34 @@ static void dropDeadSymbols(Module &Mod, const GVSummaryMapTy &DefinedGlobals,
   }
 }
 
+// Runs code generation for a ThinLTO backend, reusing the object from
+// Conf.CodeGenCacheDir if the same optimized module was compiled before.
+static Error cachedCodegen(Config &Conf, TargetMachine *TM,
+                           AddStreamFn AddStream, unsigned Task, Module &Mod) {
+  // Split DWARF output is written next to the object and not cached.
+  if (Conf.CodeGenCacheDir.empty() || !Conf.DwoDir.empty() ||
+      !Conf.SplitDwarfOutput.empty()) {
+    codegen(Conf, TM, AddStream, Task, Mod);
+    return Error::success();
+  }
+
+  // Both cached and newly generated objects are copied to the output of the
+  // job, which may itself be an entry of the backend cache.
+  Expected<NativeObjectCache> CacheOrErr = localCache(
+      Conf.CodeGenCacheDir,
+      [&](unsigned Task, std::unique_ptr<MemoryBuffer> MB) {
+        *AddStream(Task)->OS << MB->getBuffer();
+      });
+  if (!CacheOrErr)
+    return CacheOrErr.takeError();
+
+  SmallString<40> Key;
+  computeLTOCodeGenCacheKey(Key, Conf, Mod);
+  if (AddStreamFn CacheAddStream = (*CacheOrErr)(Task, Key))
+    codegen(Conf, TM, CacheAddStream, Task, Mod);
+  return Error::success();
+}
+
 Error lto::thinBackend(Config &Conf, unsigned Task, AddStreamFn AddStream,
                        Module &Mod, const ModuleSummaryIndex &CombinedIndex,
                        const FunctionImporter::ImportMapTy &ImportList,
@@ -492,18 +554,21 @@ Error lto::thinBackend(Config &Conf, unsigned Task, AddStreamFn AddStream,
   // Setup optimization remarks.
   auto DiagFileOrErr = lto::setupOptimizationRemarks(
       Mod.getContext(), Conf.RemarksFilename, Conf.RemarksPasses,
-      Conf.RemarksFormat, Conf.RemarksWithHotness, Task);
+      Conf.RemarksFormat, Conf.RemarksWithHotness,
+      Conf.RemarksHotnessThreshold, Task);
   if (!DiagFileOrErr)
     return DiagFileOrErr.takeError();
   auto DiagnosticOutputFile = std::move(*DiagFileOrErr);
 
   if (Conf.CodeGenOnly) {
     codegen(Conf, TM.get(), AddStream, Task, Mod);
-    return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+    return finalizeOptimizationRemarks(Mod.getContext(),
+                                       std::move(DiagnosticOutputFile));
   }
 
   if (Conf.PreOptModuleHook && !Conf.PreOptModuleHook(Task, Mod))
-    return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+    return finalizeOptimizationRemarks(Mod.getContext(),
+                                       std::move(DiagnosticOutputFile));
 
   renameModuleForThinLTO(Mod, CombinedIndex);
 
@@ -512,14 +577,16 @@ Error lto::thinBackend(Config &Conf, unsigned Task, AddStreamFn AddStream,
   thinLTOResolvePrevailingInModule(Mod, DefinedGlobals);
 
   if (Conf.PostPromoteModuleHook && !Conf.PostPromoteModuleHook(Task, Mod))
-    return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+    return finalizeOptimizationRemarks(Mod.getContext(),
+                                       std::move(DiagnosticOutputFile));
 
   if (!DefinedGlobals.empty())
     thinLTOInternalizeModule(Mod, DefinedGlobals);
 
   if (Conf.PostInternalizeModuleHook &&
       !Conf.PostInternalizeModuleHook(Task, Mod))
-    return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+    return finalizeOptimizationRemarks(Mod.getContext(),
+                                       std::move(DiagnosticOutputFile));
 
   auto ModuleLoader = [&](StringRef Identifier) {
     assert(Mod.getContext().isODRUniquingDebugTypes() &&
@@ -536,12 +603,16 @@ Error lto::thinBackend(Config &Conf, unsigned Task, AddStreamFn AddStream,
     return Err;
 
   if (Conf.PostImportModuleHook && !Conf.PostImportModuleHook(Task, Mod))
-    return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+    return finalizeOptimizationRemarks(Mod.getContext(),
+                                       std::move(DiagnosticOutputFile));
 
   if (!opt(Conf, TM.get(), Task, Mod, /*IsThinLTO=*/true,
            /*ExportSummary=*/nullptr, /*ImportSummary=*/&CombinedIndex))
-    return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+    return finalizeOptimizationRemarks(Mod.getContext(),
+                                       std::move(DiagnosticOutputFile));
 
-  codegen(Conf, TM.get(), AddStream, Task, Mod);
-  return finalizeOptimizationRemarks(std::move(DiagnosticOutputFile));
+  if (Error Err = cachedCodegen(Conf, TM.get(), AddStream, Task, Mod))
+    return Err;
+  return finalizeOptimizationRemarks(Mod.getContext(),
+                                       std::move(DiagnosticOutputFile));
 }
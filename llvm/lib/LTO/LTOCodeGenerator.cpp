@@ -86,6 +86,12 @@ cl::opt<bool> RemarksWithHotness(
     cl::desc("With PGO, include profile count in optimization remarks"),
     cl::Hidden);
 
+cl::opt<unsigned> RemarksHotnessThreshold(
+    "lto-pass-remarks-hotness-threshold",
+    cl::desc("Minimum profile count required for an optimization remark to be "
+             "output"),
+    cl::Hidden);
+
 cl::opt<std::string>
     RemarksFilename("lto-pass-remarks-output",
                     cl::desc("Output filename for pass remarks"),
@@ -509,6 +515,7 @@ void LTOCodeGenerator::verifyMergedModuleOnce() {
 
 void LTOCodeGenerator::finishOptimizationRemarks() {
   if (DiagnosticOutputFile) {
+    Context.getRemarkStreamer()->finalize();
     DiagnosticOutputFile->keep();
     // FIXME: LTOCodeGenerator dtor is not invoked on Darwin
     DiagnosticOutputFile->os().flush();
@@ -524,7 +531,8 @@ bool LTOCodeGenerator::optimize(bool DisableVerify, bool DisableInline,
 
   auto DiagFileOrErr =
       lto::setupOptimizationRemarks(Context, RemarksFilename, RemarksPasses,
-                                    RemarksFormat, RemarksWithHotness);
+                                    RemarksFormat, RemarksWithHotness,
+                                    RemarksHotnessThreshold);
   if (!DiagFileOrErr) {
     errs() << "Error: " << toString(DiagFileOrErr.takeError()) << "\n";
     report_fatal_error("Can't get an output file for the remarks");
@@ -1093,6 +1093,10 @@ void IRLinker::flushRAUWWorklist() {
     Value *New;
     std::tie(Old, New) = Elem;
 
+    // Appending variables are replaced on every move, and each replacement
+    // leaves a constant cast of the new variable behind. Drop the unused ones
+    // first so that they don't pile up and get rewritten by every later RAUW.
+    Old->removeDeadConstantUsers();
     Old->replaceAllUsesWith(New);
     Old->eraseFromParent();
   }
@@ -480,21 +480,26 @@ bool ModuleLinker::run() {
     ReplacedDstComdats.insert(DstC);
   }
 
-  // Alias have to go first, since we are not able to find their comdats
-  // otherwise.
-  for (auto I = DstM.alias_begin(), E = DstM.alias_end(); I != E;) {
-    GlobalAlias &GV = *I++;
-    dropReplacedComdat(GV, ReplacedDstComdats);
-  }
+  // Walking the whole destination module for every source module makes
+  // linking many modules quadratic, so only do it if there is something to
+  // drop.
+  if (!ReplacedDstComdats.empty()) {
+    // Alias have to go first, since we are not able to find their comdats
+    // otherwise.
+    for (auto I = DstM.alias_begin(), E = DstM.alias_end(); I != E;) {
+      GlobalAlias &GV = *I++;
+      dropReplacedComdat(GV, ReplacedDstComdats);
+    }
 
-  for (auto I = DstM.global_begin(), E = DstM.global_end(); I != E;) {
-    GlobalVariable &GV = *I++;
-    dropReplacedComdat(GV, ReplacedDstComdats);
-  }
+    for (auto I = DstM.global_begin(), E = DstM.global_end(); I != E;) {
+      GlobalVariable &GV = *I++;
+      dropReplacedComdat(GV, ReplacedDstComdats);
+    }
 
-  for (auto I = DstM.begin(), E = DstM.end(); I != E;) {
-    Function &GV = *I++;
-    dropReplacedComdat(GV, ReplacedDstComdats);
+    for (auto I = DstM.begin(), E = DstM.end(); I != E;) {
+      Function &GV = *I++;
+      dropReplacedComdat(GV, ReplacedDstComdats);
+    }
   }
 
   for (GlobalVariable &GV : SrcM->globals())
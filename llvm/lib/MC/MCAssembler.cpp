@@ -8,6 +8,7 @@
 
 #include "llvm/MC/MCAssembler.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -754,6 +755,22 @@ MCAssembler::handleFixup(const MCAsmLayout &Layout, MCFragment &F,
   return std::make_tuple(Target, FixedValue, IsResolved);
 }
 
+/// Returns whether layoutSectionOnce() may relax \p F.
+static bool isRelaxableFragment(const MCFragment &F) {
+  switch (F.getKind()) {
+  case MCFragment::FT_Relaxable:
+  case MCFragment::FT_Dwarf:
+  case MCFragment::FT_DwarfFrame:
+  case MCFragment::FT_LEB:
+  case MCFragment::FT_Padding:
+  case MCFragment::FT_CVInlineLines:
+  case MCFragment::FT_CVDefRange:
+    return true;
+  default:
+    return false;
+  }
+}
+
 void MCAssembler::layout(MCAsmLayout &Layout) {
   assert(getBackendPtr() && "Expected assembler backend");
   DEBUG_WITH_TYPE("mc-dump", {
@@ -781,8 +798,16 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
       Frag.setLayoutOrder(FragmentIndex++);
   }
 
+  // Only the sections with fragments that may need relaxation take part in
+  // the relaxation loop, the offsets in the others are computed on demand.
+  // With one section per function, many sections have none.
+  SmallVector<MCSection *, 0> RelaxableSections;
+  for (MCSection &Sec : *this)
+    if (llvm::any_of(Sec, isRelaxableFragment))
+      RelaxableSections.push_back(&Sec);
+
   // Layout until everything fits.
-  while (layoutOnce(Layout))
+  while (layoutOnce(Layout, RelaxableSections))
     if (getContext().hadError())
       return;
 
@@ -1105,15 +1130,14 @@ bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
   return false;
 }
 
-bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
+bool MCAssembler::layoutOnce(MCAsmLayout &Layout,
+                             ArrayRef<MCSection *> Sections) {
   ++stats::RelaxationSteps;
 
   bool WasRelaxed = false;
-  for (iterator it = begin(), ie = end(); it != ie; ++it) {
-    MCSection &Sec = *it;
-    while (layoutSectionOnce(Layout, Sec))
+  for (MCSection *Sec : Sections)
+    while (layoutSectionOnce(Layout, *Sec))
       WasRelaxed = true;
-  }
 
   return WasRelaxed;
 }
@@ -597,6 +597,7 @@ InstrBuilder::createInstrDescImpl(const MCInst &MCI) {
 
 Expected<const InstrDesc &>
 InstrBuilder::getOrCreateInstrDesc(const MCInst &MCI) {
+  std::lock_guard<std::mutex> Guard(Lock);
   if (Descriptors.find_as(MCI.getOpcode()) != Descriptors.end())
     return *Descriptors[MCI.getOpcode()];
 
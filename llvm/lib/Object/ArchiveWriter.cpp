@@ -12,6 +12,8 @@
 
 #include "llvm/Object/ArchiveWriter.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/BinaryFormat/Magic.h"
 #include "llvm/IR/LLVMContext.h"
@@ -23,6 +25,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -384,10 +387,54 @@ getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
   return Ret;
 }
 
+namespace {
+/// The archive symbols of a single member, with the offsets of the names
+/// relative to the start of Names.
+struct MemberSymbols {
+  std::vector<unsigned> Offsets;
+  std::string Names;
+  bool HasObject = false;
+};
+} // namespace
+
+// Reading the symbol table of a member means parsing it as an object file,
+// which dominates the time it takes to write archives of many members. The
+// members are independent, so they are read in parallel.
+static Expected<std::vector<MemberSymbols>>
+computeMemberSymbols(ArrayRef<NewArchiveMember> NewMembers) {
+  std::vector<MemberSymbols> Ret(NewMembers.size());
+  std::vector<Optional<Error>> Errors(NewMembers.size());
+
+  parallel::for_each_n(parallel::par, size_t(0), NewMembers.size(),
+                       [&](size_t I) {
+                         raw_string_ostream Names(Ret[I].Names);
+                         Expected<std::vector<unsigned>> Offsets = getSymbols(
+                             NewMembers[I].Buf->getMemBufferRef(), Names,
+                             Ret[I].HasObject);
+                         Names.flush();
+                         if (Offsets)
+                           Ret[I].Offsets = std::move(*Offsets);
+                         else
+                           Errors[I] = Offsets.takeError();
+                       });
+
+  // Report the error of the first member that failed, in member order.
+  auto Failed = llvm::find_if(Errors, [](const Optional<Error> &E) {
+    return E.hasValue();
+  });
+  if (Failed == Errors.end())
+    return std::move(Ret);
+  Error Err = std::move(**Failed);
+  for (auto I = std::next(Failed), E = Errors.end(); I != E; ++I)
+    if (*I)
+      consumeError(std::move(**I));
+  return std::move(Err);
+}
+
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, bool Deterministic,
-                  ArrayRef<NewArchiveMember> NewMembers) {
+                  bool NeedSymbols, ArrayRef<NewArchiveMember> NewMembers) {
   static char PaddingData[8] = {'\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n'};
 
   // This ignores the symbol table, but we only need the value mod 8 and the
@@ -452,7 +499,17 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  std::vector<MemberSymbols> Symbols;
+  if (NeedSymbols) {
+    Expected<std::vector<MemberSymbols>> SymbolsOrErr =
+        computeMemberSymbols(NewMembers);
+    if (Error E = SymbolsOrErr.takeError())
+      return std::move(E);
+    Symbols = std::move(*SymbolsOrErr);
+  }
+
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -487,13 +544,20 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       ModTime, Size);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    std::vector<unsigned> MemberSymbolOffsets;
+    if (NeedSymbols) {
+      MemberSymbols &MS = Symbols[I];
+      HasObject |= MS.HasObject;
+      uint64_t NamesStart = SymNames.tell();
+      for (unsigned &Offset : MS.Offsets)
+        Offset += NamesStart;
+      SymNames << MS.Names;
+      MemberSymbolOffsets = std::move(MS.Offsets);
+    }
 
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
+    Ret.push_back(
+        {std::move(MemberSymbolOffsets), std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
@@ -557,8 +621,9 @@ Error writeArchive(StringRef ArcName, ArrayRef<NewArchiveMember> NewMembers,
   SmallString<0> StringTableBuf;
   raw_svector_ostream StringTable(StringTableBuf);
 
-  Expected<std::vector<MemberData>> DataOrErr = computeMemberData(
-      StringTable, SymNames, Kind, Thin, Deterministic, NewMembers);
+  Expected<std::vector<MemberData>> DataOrErr =
+      computeMemberData(StringTable, SymNames, Kind, Thin, Deterministic,
+                        WriteSymtab, NewMembers);
   if (Error E = DataOrErr.takeError())
     return E;
   std::vector<MemberData> &Data = *DataOrErr;
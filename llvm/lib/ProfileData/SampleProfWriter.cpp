@@ -119,10 +119,15 @@ std::error_code SampleProfileWriterExtBinary::writeSections(
   writeNameTable();
   SectionStart = addNewSection(SecNameTable, SectionStart);
 
+  SecLBRProfileStart = OutputStream->tell();
   if (std::error_code EC = writeFuncProfiles(ProfileMap))
     return EC;
   SectionStart = addNewSection(SecLBRProfile, SectionStart);
 
+  if (std::error_code EC = writeFuncOffsetTable())
+    return EC;
+  SectionStart = addNewSection(SecFuncOffsetTable, SectionStart);
+
   if (ProfSymList && ProfSymList->size() > 0)
     if (std::error_code EC = ProfSymList->write(*OutputStream))
       return EC;
@@ -268,6 +273,21 @@ std::error_code SampleProfileWriterCompactBinary::writeFuncOffsetTable() {
   return sampleprof_error::success;
 }
 
+std::error_code SampleProfileWriterExtBinary::writeFuncOffsetTable() {
+  auto &OS = *OutputStream;
+
+  // Write out the table size.
+  encodeULEB128(FuncOffsetTable.size(), OS);
+
+  // Write out FuncOffsetTable.
+  for (auto Entry : FuncOffsetTable) {
+    if (std::error_code EC = writeNameIdx(Entry.first))
+      return EC;
+    encodeULEB128(Entry.second, OS);
+  }
+  return sampleprof_error::success;
+}
+
 std::error_code SampleProfileWriterCompactBinary::writeNameTable() {
   auto &OS = *OutputStream;
   std::set<StringRef> V;
@@ -458,6 +478,13 @@ SampleProfileWriterCompactBinary::writeSample(const FunctionSamples &S) {
   return writeBody(S);
 }
 
+std::error_code
+SampleProfileWriterExtBinary::writeSample(const FunctionSamples &S) {
+  uint64_t Offset = OutputStream->tell();
+  FuncOffsetTable[S.getName()] = Offset - SecLBRProfileStart;
+  return SampleProfileWriterBinary::writeSample(S);
+}
+
 /// Create a sample profile file writer based on the specified format.
 ///
 /// \param Filename The file to create.
@@ -0,0 +1,331 @@
+//===- BitstreamRemarkParser.cpp ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides utility methods used by clients that want to use the
+// parser for remark diagnostics in LLVM.
+//
+//===----------------------------------------------------------------------===//
+
+#include "BitstreamRemarkParser.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+static Error malformed(StringRef What) {
+  return createStringError(std::errc::illegal_byte_sequence,
+                           "Error while parsing bitstream remarks: %s.",
+                           What.str().c_str());
+}
+
+BitstreamRemarkParser::BitstreamRemarkParser(StringRef Buf)
+    : RemarkParser(Format::Bitstream), Stream(Buf) {}
+
+BitstreamRemarkParser::BitstreamRemarkParser(StringRef Buf,
+                                             ParsedStringTable StrTab)
+    : RemarkParser(Format::Bitstream), Stream(Buf), StrTab(std::move(StrTab)) {
+}
+
+Error BitstreamRemarkParser::parseMagic() {
+  for (const char C : ContainerMagic) {
+    if (Stream.AtEndOfStream())
+      return malformed("unknown magic number");
+    Expected<SimpleBitstreamCursor::word_t> MaybeC = Stream.Read(8);
+    if (!MaybeC)
+      return MaybeC.takeError();
+    if (static_cast<char>(*MaybeC) != C)
+      return malformed("unknown magic number");
+  }
+  return Error::success();
+}
+
+Error BitstreamRemarkParser::parseBlockInfo() {
+  Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+  if (!MaybeEntry)
+    return MaybeEntry.takeError();
+  if (MaybeEntry->Kind != BitstreamEntry::SubBlock ||
+      MaybeEntry->ID != bitc::BLOCKINFO_BLOCK_ID)
+    return malformed("expecting the block info block");
+
+  Expected<Optional<BitstreamBlockInfo>> MaybeBlockInfo =
+      Stream.ReadBlockInfoBlock();
+  if (!MaybeBlockInfo)
+    return MaybeBlockInfo.takeError();
+  if (!*MaybeBlockInfo)
+    return malformed("missing the block info block");
+  BlockInfo = std::move(**MaybeBlockInfo);
+  Stream.setBlockInfo(&BlockInfo);
+  return Error::success();
+}
+
+Error BitstreamRemarkParser::parseMetaRecords(bool &SawContainerInfo) {
+  if (Error E = Stream.EnterSubBlock(META_BLOCK_ID))
+    return E;
+
+  while (true) {
+    Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+    if (!MaybeEntry)
+      return MaybeEntry.takeError();
+    if (MaybeEntry->Kind == BitstreamEntry::EndBlock)
+      break;
+    if (MaybeEntry->Kind != BitstreamEntry::Record)
+      return malformed("unexpected entry in the metadata block");
+
+    Record.clear();
+    Blob = StringRef();
+    Expected<unsigned> MaybeCode =
+        Stream.readRecord(MaybeEntry->ID, Record, &Blob);
+    if (!MaybeCode)
+      return MaybeCode.takeError();
+
+    switch (*MaybeCode) {
+    case RECORD_META_CONTAINER_INFO:
+      if (Record.size() != 2)
+        return malformed("malformed container info record");
+      if (Record[0] != CurrentContainerVersion)
+        return malformed("unsupported container version");
+      if (Record[1] > static_cast<uint64_t>(BitstreamRemarkContainerType::Last))
+        return malformed("unknown container type");
+      ContainerType = static_cast<BitstreamRemarkContainerType>(Record[1]);
+      SawContainerInfo = true;
+      break;
+    case RECORD_META_REMARK_VERSION:
+      if (Record.size() != 1)
+        return malformed("malformed remark version record");
+      if (Record[0] != CurrentRemarkVersion)
+        return malformed("unsupported remark version");
+      break;
+    case RECORD_META_STRTAB:
+      if (StrTab)
+        return createStringError(std::errc::illegal_byte_sequence,
+                                 "String table already provided.");
+      StrTab.emplace(Blob);
+      break;
+    case RECORD_META_EXTERNAL_FILE:
+      ExternalFilePath = Blob;
+      break;
+    default:
+      return malformed("unknown record in the metadata block");
+    }
+  }
+  return Error::success();
+}
+
+Error BitstreamRemarkParser::parseMetaBlock() {
+  Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+  if (!MaybeEntry)
+    return MaybeEntry.takeError();
+  if (MaybeEntry->Kind != BitstreamEntry::SubBlock ||
+      MaybeEntry->ID != META_BLOCK_ID)
+    return malformed("expecting the metadata block");
+
+  bool SawContainerInfo = false;
+  if (Error E = parseMetaRecords(SawContainerInfo))
+    return E;
+  if (!SawContainerInfo)
+    return malformed("missing container info");
+  return Error::success();
+}
+
+Error BitstreamRemarkParser::parseTrailingMetaBlock() {
+  // Skip over the remarks, which only requires reading the size of each
+  // block, then come back to the first one.
+  uint64_t RemarksBitNo = Stream.GetCurrentBitNo();
+  while (!Stream.AtEndOfStream()) {
+    Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+    if (!MaybeEntry)
+      return MaybeEntry.takeError();
+    if (MaybeEntry->Kind != BitstreamEntry::SubBlock)
+      return malformed("expecting a remark block");
+    if (MaybeEntry->ID != META_BLOCK_ID) {
+      if (Error E = Stream.SkipBlock())
+        return E;
+      continue;
+    }
+
+    bool SawContainerInfo = false;
+    if (Error E = parseMetaRecords(SawContainerInfo))
+      return E;
+    if (SawContainerInfo)
+      return malformed("unexpected container info after the remarks");
+    break;
+  }
+  return Stream.JumpToBit(RemarksBitNo);
+}
+
+Error BitstreamRemarkParser::parseMeta() {
+  if (Error E = parseMagic())
+    return E;
+  if (Error E = parseBlockInfo())
+    return E;
+  if (Error E = parseMetaBlock())
+    return E;
+  // Separate remark files end with their string table, unless it was
+  // provided by the metadata they are used with.
+  if (ContainerType == BitstreamRemarkContainerType::SeparateRemarksFile &&
+      !StrTab)
+    if (Error E = parseTrailingMetaBlock())
+      return E;
+  ReadyToParseRemarks = true;
+  return Error::success();
+}
+
+Expected<StringRef> BitstreamRemarkParser::getString(uint64_t Index) {
+  if (!StrTab)
+    return createStringError(std::errc::invalid_argument,
+                             "Bitstream remarks require a string table.");
+  return (*StrTab)[Index];
+}
+
+Expected<std::unique_ptr<Remark>> BitstreamRemarkParser::parseRemark() {
+  if (Error E = Stream.EnterSubBlock(REMARK_BLOCK_ID))
+    return std::move(E);
+
+  auto Result = std::make_unique<Remark>();
+  Remark &R = *Result;
+  bool SawHeader = false;
+  while (true) {
+    Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+    if (!MaybeEntry)
+      return MaybeEntry.takeError();
+    if (MaybeEntry->Kind == BitstreamEntry::EndBlock)
+      break;
+    if (MaybeEntry->Kind != BitstreamEntry::Record)
+      return malformed("unexpected entry in a remark block");
+
+    Record.clear();
+    Expected<unsigned> MaybeCode = Stream.readRecord(MaybeEntry->ID, Record);
+    if (!MaybeCode)
+      return MaybeCode.takeError();
+
+    switch (*MaybeCode) {
+    case RECORD_REMARK_HEADER: {
+      if (Record.size() != 4)
+        return malformed("malformed remark header");
+      if (Record[0] > static_cast<uint64_t>(Type::Last))
+        return malformed("unknown remark type");
+      R.RemarkType = static_cast<Type>(Record[0]);
+      Expected<StringRef> RemarkName = getString(Record[1]);
+      if (!RemarkName)
+        return RemarkName.takeError();
+      Expected<StringRef> PassName = getString(Record[2]);
+      if (!PassName)
+        return PassName.takeError();
+      Expected<StringRef> FunctionName = getString(Record[3]);
+      if (!FunctionName)
+        return FunctionName.takeError();
+      R.RemarkName = *RemarkName;
+      R.PassName = *PassName;
+      R.FunctionName = *FunctionName;
+      SawHeader = true;
+      break;
+    }
+    case RECORD_REMARK_DEBUG_LOC: {
+      if (Record.size() != 3)
+        return malformed("malformed remark debug location");
+      Expected<StringRef> File = getString(Record[0]);
+      if (!File)
+        return File.takeError();
+      R.Loc = RemarkLocation{*File, static_cast<unsigned>(Record[1]),
+                             static_cast<unsigned>(Record[2])};
+      break;
+    }
+    case RECORD_REMARK_HOTNESS:
+      if (Record.size() != 1)
+        return malformed("malformed remark hotness");
+      R.Hotness = Record[0];
+      break;
+    case RECORD_REMARK_ARG_WITH_DEBUGLOC:
+    case RECORD_REMARK_ARG_WITHOUT_DEBUGLOC: {
+      bool HasDebugLoc = *MaybeCode == RECORD_REMARK_ARG_WITH_DEBUGLOC;
+      if (Record.size() != (HasDebugLoc ? 5u : 2u))
+        return malformed("malformed remark argument");
+      Expected<StringRef> Key = getString(Record[0]);
+      if (!Key)
+        return Key.takeError();
+      Expected<StringRef> Val = getString(Record[1]);
+      if (!Val)
+        return Val.takeError();
+      R.Args.emplace_back();
+      R.Args.back().Key = *Key;
+      R.Args.back().Val = *Val;
+      if (HasDebugLoc) {
+        Expected<StringRef> File = getString(Record[2]);
+        if (!File)
+          return File.takeError();
+        R.Args.back().Loc =
+            RemarkLocation{*File, static_cast<unsigned>(Record[3]),
+                           static_cast<unsigned>(Record[4])};
+      }
+      break;
+    }
+    default:
+      return malformed("unknown record in a remark block");
+    }
+  }
+
+  if (!SawHeader)
+    return malformed("missing remark header");
+  return std::move(Result);
+}
+
+Expected<std::unique_ptr<Remark>> BitstreamRemarkParser::next() {
+  if (!ReadyToParseRemarks)
+    if (Error E = parseMeta())
+      return std::move(E);
+
+  if (ContainerType == BitstreamRemarkContainerType::SeparateRemarksMeta)
+    return createStringError(
+        std::errc::invalid_argument,
+        "The buffer only contains remark metadata. Use "
+        "createRemarkParserFromMeta to parse the remarks it points to.");
+
+  // Skip the blocks that are not remarks: newer producers may add some.
+  while (!Stream.AtEndOfStream()) {
+    Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+    if (!MaybeEntry)
+      return MaybeEntry.takeError();
+    if (MaybeEntry->Kind != BitstreamEntry::SubBlock)
+      return malformed("expecting a remark block");
+    if (MaybeEntry->ID == REMARK_BLOCK_ID)
+      return parseRemark();
+    if (Error E = Stream.SkipBlock())
+      return std::move(E);
+  }
+  return make_error<EndOfFileError>();
+}
+
+Expected<std::unique_ptr<BitstreamRemarkParser>>
+remarks::createBitstreamParserFromMeta(StringRef Buf,
+                                       Optional<ParsedStringTable> StrTab) {
+  auto Parser =
+      StrTab ? std::make_unique<BitstreamRemarkParser>(Buf, std::move(*StrTab))
+             : std::make_unique<BitstreamRemarkParser>(Buf);
+  if (Error E = Parser->parseMeta())
+    return std::move(E);
+
+  // Standalone containers and remark files are parsed from here on.
+  if (Parser->ContainerType != BitstreamRemarkContainerType::SeparateRemarksMeta)
+    return std::move(Parser);
+
+  // Otherwise, the metadata points to the file containing the remarks, and
+  // holds the string table they use.
+  if (!Parser->ExternalFilePath)
+    return malformed("missing the external remark file");
+  if (!Parser->StrTab)
+    return malformed("missing the string table");
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+      MemoryBuffer::getFile(*Parser->ExternalFilePath);
+  if (std::error_code EC = BufferOrErr.getError())
+    return errorCodeToError(EC);
+
+  std::unique_ptr<MemoryBuffer> SeparateBuf = std::move(*BufferOrErr);
+  auto Result = std::make_unique<BitstreamRemarkParser>(
+      SeparateBuf->getBuffer(), std::move(*Parser->StrTab));
+  Result->SeparateBuf = std::move(SeparateBuf);
+  return std::move(Result);
+}
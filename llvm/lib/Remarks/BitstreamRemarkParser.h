@@ -0,0 +1,90 @@
+//===-- BitstreamRemarkParser.h - Parser for Bitstream remarks --*- C++/-*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file provides the impementation of the Bitstream remark parser.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_BITSTREAM_REMARK_PARSER_H
+#define LLVM_REMARKS_BITSTREAM_REMARK_PARSER_H
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Bitstream/BitstreamReader.h"
+#include "llvm/Remarks/BitstreamRemarkContainer.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkParser.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <memory>
+
+namespace llvm {
+namespace remarks {
+
+/// Parse remarks serialized by the BitstreamRemarkSerializer.
+///
+/// The block info block and the metadata block are parsed lazily, on the
+/// first call to next(), unless parseMeta() is called explicitly before.
+/// Remarks are then read one REMARK_BLOCK at a time, so that the memory used
+/// by the parser doesn't depend on the size of the input.
+struct BitstreamRemarkParser : public RemarkParser {
+  /// The buffer of the external remark file, if the metadata pointed to one.
+  /// It needs to stay alive as long as the parser is used.
+  std::unique_ptr<MemoryBuffer> SeparateBuf;
+  /// The cursor over the bitstream.
+  BitstreamCursor Stream;
+  /// The block info block, referenced by the cursor.
+  BitstreamBlockInfo BlockInfo;
+  /// The string table used to read the strings referenced by the remarks.
+  /// It's either provided by the user or read from the metadata.
+  Optional<ParsedStringTable> StrTab;
+  /// The type of the container, read from the metadata.
+  BitstreamRemarkContainerType ContainerType =
+      BitstreamRemarkContainerType::Standalone;
+  /// The path to the remark file, if the metadata points to one.
+  Optional<StringRef> ExternalFilePath;
+  /// Set once the block info and metadata blocks have been parsed.
+  bool ReadyToParseRemarks = false;
+
+  /// Create a parser that expects to find a string table in the buffer.
+  explicit BitstreamRemarkParser(StringRef Buf);
+  /// Create a parser that uses a pre-parsed string table.
+  BitstreamRemarkParser(StringRef Buf, ParsedStringTable StrTab);
+
+  Expected<std::unique_ptr<Remark>> next() override;
+
+  static bool classof(const RemarkParser *P) {
+    return P->ParserFormat == Format::Bitstream;
+  }
+
+  /// Parse the magic number, the block info block and the metadata block.
+  Error parseMeta();
+
+private:
+  /// Scratch storage for the records being read.
+  SmallVector<uint64_t, 8> Record;
+  /// The blob of the last record read, if any.
+  StringRef Blob;
+
+  Error parseMagic();
+  Error parseBlockInfo();
+  Error parseMetaBlock();
+  Error parseTrailingMetaBlock();
+  Error parseMetaRecords(bool &SawContainerInfo);
+  Expected<std::unique_ptr<Remark>> parseRemark();
+  Expected<StringRef> getString(uint64_t Index);
+};
+
+Expected<std::unique_ptr<BitstreamRemarkParser>>
+createBitstreamParserFromMeta(StringRef Buf,
+                              Optional<ParsedStringTable> StrTab = None);
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif /* LLVM_REMARKS_BITSTREAM_REMARK_PARSER_H */
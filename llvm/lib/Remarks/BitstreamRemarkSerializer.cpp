@@ -214,6 +214,8 @@ void BitstreamRemarkSerializerHelper::setupBlockInfo() {
   case BitstreamRemarkContainerType::SeparateRemarksFile:
     // Contains remarks: emit the version.
     setupMetaRemarkVersion();
+    // Ends with the string table used by the remarks.
+    setupMetaStrTab();
     // Contains remarks: emit the remark abbrevs.
     setupRemarkBlockInfo();
     break;
@@ -315,6 +317,14 @@ void BitstreamRemarkSerializerHelper::emitRemarkBlock(const Remark &Remark,
   Bitstream.ExitBlock();
 }
 
+void BitstreamRemarkSerializerHelper::emitTrailingMetaBlock(
+    const StringTable &StrTab) {
+  assert(ContainerType == BitstreamRemarkContainerType::SeparateRemarksFile);
+  Bitstream.EnterSubblock(META_BLOCK_ID, 3);
+  emitMetaStrTab(StrTab);
+  Bitstream.ExitBlock();
+}
+
 void BitstreamRemarkSerializerHelper::flushToStream(raw_ostream &OS) {
   OS.write(Encoded.data(), Encoded.size());
   Encoded.clear();
@@ -365,6 +375,21 @@ void BitstreamRemarkSerializer::emit(const Remark &Remark) {
   Helper.flushToStream(OS);
 }
 
+void BitstreamRemarkSerializer::finalize() {
+  // Standalone containers already start with their string table.
+  if (Helper.ContainerType != BitstreamRemarkContainerType::SeparateRemarksFile)
+    return;
+
+  if (!DidSetUp) {
+    BitstreamMetaSerializer MetaSerializer(OS, Helper);
+    MetaSerializer.emit();
+    DidSetUp = true;
+  }
+
+  Helper.emitTrailingMetaBlock(*StrTab);
+  Helper.flushToStream(OS);
+}
+
 std::unique_ptr<MetaSerializer> BitstreamRemarkSerializer::metaSerializer(
     raw_ostream &OS, Optional<StringRef> ExternalFilename) {
   assert(Helper.ContainerType !=
@@ -0,0 +1,58 @@
+//===- AsyncFileReader.cpp - Read files ahead of use ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/AsyncFileReader.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Process.h"
+
+using namespace llvm;
+
+static AsyncFileReader::ResultTy readFile(const std::string &Filename,
+                                          bool RequiresNullTerminator,
+                                          bool IsVolatile) {
+  AsyncFileReader::ResultTy MBOrErr = MemoryBuffer::getFile(
+      Filename, /*FileSize=*/-1, RequiresNullTerminator, IsVolatile);
+  if (!MBOrErr)
+    return MBOrErr;
+
+  // Let the kernel read the mapping ahead, then touch every page so that the
+  // faults are taken on this thread rather than by the consumer.
+  const MemoryBuffer &MB = **MBOrErr;
+  MB.willNeedIfMmap();
+  if (MB.getBufferKind() == MemoryBuffer::MemoryBuffer_MMap) {
+    const volatile char *Start = MB.getBufferStart();
+    size_t Size = MB.getBufferSize();
+    size_t PageSize = sys::Process::getPageSizeEstimate();
+    for (size_t I = 0; I < Size; I += PageSize)
+      (void)Start[I];
+  }
+  return MBOrErr;
+}
+
+AsyncFileReader::~AsyncFileReader() { wait(); }
+
+std::future<AsyncFileReader::ResultTy>
+AsyncFileReader::read(const Twine &Filename, bool RequiresNullTerminator,
+                      bool IsVolatile) {
+  // The task is shared because ThreadPool only takes copyable callables.
+  auto Task = std::make_shared<std::packaged_task<ResultTy()>>(
+      [Filename = Filename.str(), RequiresNullTerminator, IsVolatile] {
+        return readFile(Filename, RequiresNullTerminator, IsVolatile);
+      });
+  std::future<ResultTy> Result = Task->get_future();
+#if LLVM_ENABLE_THREADS
+  Pool.async([Task] { (*Task)(); });
+#else
+  // Without threads the pool defers its tasks until wait() is called, which
+  // would leave the returned future blocked forever.
+  (*Task)();
+#endif
+  return Result;
+}
+
+void AsyncFileReader::wait() { Pool.wait(); }
@@ -17,9 +17,13 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/raw_ostream.h"
 #if LLVM_ENABLE_ZLIB == 1 && HAVE_ZLIB_H
 #include <zlib.h>
 #endif
+#if LLVM_ENABLE_ZSTD == 1
+#include <zstd.h>
+#endif
 
 using namespace llvm;
 
@@ -104,3 +108,168 @@ uint32_t zlib::crc32(StringRef Buffer) {
   llvm_unreachable("zlib::crc32 is unavailable");
 }
 #endif
+
+#if LLVM_ENABLE_ZSTD == 1
+static Error createZstdError(size_t Code) {
+  return make_error<StringError>(Twine("zstd error: ") + ZSTD_getErrorName(Code),
+                                 inconvertibleErrorCode());
+}
+
+static ZSTD_CCtx *createCompressionContext(int Level, unsigned Threads) {
+  ZSTD_CCtx *Ctx = ZSTD_createCCtx();
+  ZSTD_CCtx_setParameter(Ctx, ZSTD_c_compressionLevel, Level);
+  // This fails if the library was built without multithreading support. The
+  // input is then compressed by the calling thread.
+  if (Threads > 1)
+    ZSTD_CCtx_setParameter(Ctx, ZSTD_c_nbWorkers, Threads);
+  return Ctx;
+}
+
+bool zstd::isAvailable() { return true; }
+
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer, int Level,
+                     unsigned Threads) {
+  ZSTD_CCtx *Ctx = createCompressionContext(Level, Threads);
+  size_t CompressedSize = ZSTD_compressBound(InputBuffer.size());
+  CompressedBuffer.reserve(CompressedSize);
+  size_t Res = ZSTD_compress2(Ctx, CompressedBuffer.data(), CompressedSize,
+                              InputBuffer.data(), InputBuffer.size());
+  ZSTD_freeCCtx(Ctx);
+  if (ZSTD_isError(Res))
+    return createZstdError(Res);
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented zstd.
+  __msan_unpoison(CompressedBuffer.data(), Res);
+  CompressedBuffer.set_size(Res);
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  size_t Res = ZSTD_decompress(UncompressedBuffer, UncompressedSize,
+                               InputBuffer.data(), InputBuffer.size());
+  if (ZSTD_isError(Res))
+    return createZstdError(Res);
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented zstd.
+  __msan_unpoison(UncompressedBuffer, Res);
+  UncompressedSize = Res;
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  UncompressedBuffer.resize(UncompressedSize);
+  Error E =
+      uncompress(InputBuffer, UncompressedBuffer.data(), UncompressedSize);
+  UncompressedBuffer.resize(UncompressedSize);
+  return E;
+}
+
+zstd::Compressor::Compressor(raw_ostream &OS, int Level, unsigned Threads)
+    : OS(OS), Ctx(createCompressionContext(Level, Threads)) {
+  OutBuffer.resize(ZSTD_CStreamOutSize());
+}
+
+zstd::Compressor::~Compressor() {
+  ZSTD_freeCCtx(static_cast<ZSTD_CCtx *>(Ctx));
+}
+
+Error zstd::Compressor::stream(StringRef Data, bool End) {
+  ZSTD_inBuffer In = {Data.data(), Data.size(), 0};
+  for (;;) {
+    ZSTD_outBuffer Out = {OutBuffer.data(), OutBuffer.size(), 0};
+    size_t Res = ZSTD_compressStream2(static_cast<ZSTD_CCtx *>(Ctx), &Out, &In,
+                                      End ? ZSTD_e_end : ZSTD_e_continue);
+    if (ZSTD_isError(Res))
+      return createZstdError(Res);
+    __msan_unpoison(OutBuffer.data(), Out.pos);
+    OS.write(OutBuffer.data(), Out.pos);
+    // When ending the frame, Res is the number of bytes left to flush.
+    if (End ? Res == 0 : In.pos == In.size)
+      return Error::success();
+  }
+}
+
+Error zstd::Compressor::write(StringRef Data) { return stream(Data, false); }
+
+Error zstd::Compressor::finish() { return stream(StringRef(), true); }
+
+zstd::Decompressor::Decompressor(raw_ostream &OS)
+    : OS(OS), Ctx(ZSTD_createDCtx()) {
+  OutBuffer.resize(ZSTD_DStreamOutSize());
+}
+
+zstd::Decompressor::~Decompressor() {
+  ZSTD_freeDCtx(static_cast<ZSTD_DCtx *>(Ctx));
+}
+
+Error zstd::Decompressor::write(StringRef Data) {
+  ZSTD_inBuffer In = {Data.data(), Data.size(), 0};
+  ZSTD_outBuffer Out;
+  // Keep going while there is input, or while a full output buffer means that
+  // zstd may still hold decompressed data.
+  do {
+    Out = {OutBuffer.data(), OutBuffer.size(), 0};
+    size_t Res =
+        ZSTD_decompressStream(static_cast<ZSTD_DCtx *>(Ctx), &Out, &In);
+    if (ZSTD_isError(Res))
+      return createZstdError(Res);
+    __msan_unpoison(OutBuffer.data(), Out.pos);
+    OS.write(OutBuffer.data(), Out.pos);
+    // Zero means that a frame was completely decoded and flushed.
+    InFrame = Res != 0;
+  } while (In.pos != In.size || Out.pos == Out.size);
+  return Error::success();
+}
+
+Error zstd::Decompressor::finish() {
+  if (InFrame)
+    return make_error<StringError>("zstd error: truncated input",
+                                   inconvertibleErrorCode());
+  return Error::success();
+}
+
+#else
+bool zstd::isAvailable() { return false; }
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer, int Level,
+                     unsigned Threads) {
+  llvm_unreachable("zstd::compress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+zstd::Compressor::Compressor(raw_ostream &OS, int Level, unsigned Threads)
+    : OS(OS), Ctx(nullptr) {
+  llvm_unreachable("zstd::Compressor is unavailable");
+}
+zstd::Compressor::~Compressor() {}
+Error zstd::Compressor::stream(StringRef Data, bool End) {
+  llvm_unreachable("zstd::Compressor is unavailable");
+}
+Error zstd::Compressor::write(StringRef Data) {
+  llvm_unreachable("zstd::Compressor is unavailable");
+}
+Error zstd::Compressor::finish() {
+  llvm_unreachable("zstd::Compressor is unavailable");
+}
+zstd::Decompressor::Decompressor(raw_ostream &OS) : OS(OS), Ctx(nullptr) {
+  llvm_unreachable("zstd::Decompressor is unavailable");
+}
+zstd::Decompressor::~Decompressor() {}
+Error zstd::Decompressor::write(StringRef Data) {
+  llvm_unreachable("zstd::Decompressor is unavailable");
+}
+Error zstd::Decompressor::finish() {
+  llvm_unreachable("zstd::Decompressor is unavailable");
+}
+#endif
@@ -173,23 +173,39 @@ StringRef DataExtractor::getCStrRef(uint64_t *offset_ptr) const {
 
 uint64_t DataExtractor::getULEB128(uint64_t *offset_ptr,
                                    llvm::Error *Err) const {
+  uint64_t result;
+  if (!getULEB128(offset_ptr, &result, 1, Err))
+    return 0;
+  return result;
+}
+
+uint64_t *DataExtractor::getULEB128(uint64_t *offset_ptr, uint64_t *dst,
+                                    uint32_t count, llvm::Error *Err) const {
   assert(*offset_ptr <= Data.size());
   ErrorAsOutParameter ErrAsOut(Err);
   if (isError(Err))
-    return 0;
+    return nullptr;
 
   const char *error;
-  unsigned bytes_read;
-  uint64_t result = decodeULEB128(
-      reinterpret_cast<const uint8_t *>(Data.data() + *offset_ptr), &bytes_read,
-      reinterpret_cast<const uint8_t *>(Data.data() + Data.size()), &error);
-  if (error) {
+  const uint8_t *start =
+      reinterpret_cast<const uint8_t *>(Data.data() + *offset_ptr);
+  const uint8_t *end = decodeULEB128Array(
+      start, reinterpret_cast<const uint8_t *>(Data.data() + Data.size()), dst,
+      count, &error);
+  if (!end) {
     if (Err)
       *Err = createStringError(errc::illegal_byte_sequence, error);
-    return 0;
+    return nullptr;
   }
-  *offset_ptr += bytes_read;
-  return result;
+  *offset_ptr += end - start;
+  return dst;
+}
+
+void DataExtractor::getULEB128(Cursor &C, SmallVectorImpl<uint64_t> &Dst,
+                               uint32_t Count) const {
+  SmallVector<uint64_t, 16> Values(Count);
+  if (getULEB128(&C.Offset, Values.data(), Count, &C.Err))
+    Dst.assign(Values.begin(), Values.end());
 }
 
 int64_t DataExtractor::getSLEB128(uint64_t *offset_ptr) const {
@@ -206,6 +222,25 @@ int64_t DataExtractor::getSLEB128(uint64_t *offset_ptr) const {
   return result;
 }
 
+void DataExtractor::skipLEB128(uint64_t *offset_ptr, llvm::Error *Err) const {
+  assert(*offset_ptr <= Data.size());
+  ErrorAsOutParameter ErrAsOut(Err);
+  if (isError(Err))
+    return;
+
+  const uint8_t *start =
+      reinterpret_cast<const uint8_t *>(Data.data() + *offset_ptr);
+  const uint8_t *end = llvm::skipLEB128(
+      start, reinterpret_cast<const uint8_t *>(Data.data() + Data.size()));
+  if (!end) {
+    if (Err)
+      *Err = createStringError(errc::illegal_byte_sequence,
+                               "malformed leb128, extends past end");
+    return;
+  }
+  *offset_ptr += end - start;
+}
+
 void DataExtractor::skip(Cursor &C, uint64_t Length) const {
   ErrorAsOutParameter ErrAsOut(&C.Err);
   if (isError(&C.Err))
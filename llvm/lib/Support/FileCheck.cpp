@@ -345,6 +345,7 @@ bool FileCheckPattern::parsePattern(StringRef PatternStr, StringRef Prefix,
 
   if (CheckTy == Check::CheckEmpty) {
     RegExStr = "(\n$)";
+    CompiledRegEx = std::make_shared<Regex>(RegExStr, Regex::Newline);
     return false;
   }
 
@@ -574,8 +575,14 @@ bool FileCheckPattern::parsePattern(StringRef PatternStr, StringRef Prefix,
     // Find the end, which is the start of the next regex.
     size_t FixedMatchEnd = PatternStr.find("{{");
     FixedMatchEnd = std::min(FixedMatchEnd, PatternStr.find("[["));
-    RegExStr += Regex::escape(PatternStr.substr(0, FixedMatchEnd));
+    StringRef FixedPart = PatternStr.substr(0, FixedMatchEnd);
+    RegExStr += Regex::escape(FixedPart);
     PatternStr = PatternStr.substr(FixedMatchEnd);
+
+    // Every {{}} and [[]] block is parenthesized, so the fixed parts are
+    // concatenated at the top level of the regex and any match contains them.
+    if (FixedPart.size() > RequiredStr.size())
+      RequiredStr = FixedPart;
   }
 
   if (MatchFullLinesHere) {
@@ -584,6 +591,11 @@ bool FileCheckPattern::parsePattern(StringRef PatternStr, StringRef Prefix,
     RegExStr += '$';
   }
 
+  // Without substitutions the regex is known now, so compile it once rather
+  // than on every match attempt.
+  if (Substitutions.empty())
+    CompiledRegEx = std::make_shared<Regex>(RegExStr, Regex::Newline);
+
   return false;
 }
 
@@ -607,6 +619,39 @@ void FileCheckPattern::AddBackrefToRegEx(unsigned BackrefNum) {
   RegExStr += Backref;
 }
 
+bool FileCheckPattern::matchRegEx(StringRef RegExToMatch, StringRef Buffer,
+                                  SmallVectorImpl<StringRef> &MatchInfo) const {
+  Optional<Regex> TmpRegEx;
+  Regex *R = CompiledRegEx.get();
+  if (!R) {
+    TmpRegEx.emplace(RegExToMatch, Regex::Newline);
+    R = TmpRegEx.getPointer();
+  }
+
+  // Without a literal to look for, or if the regex itself can match a
+  // newline, run the regex over the whole buffer.
+  if (RequiredStr.empty() || RegExToMatch.find('\n') != StringRef::npos)
+    return R->match(Buffer, &MatchInfo);
+
+  // Since '.' and bracket expressions don't match newlines in newline
+  // sensitive mode, a match never spans several lines and the line holding
+  // it also holds RequiredStr. Only run the regex on those lines, in order, so
+  // that the first line matching gives the leftmost match. The anchors behave
+  // the same on a line as on the buffer since lines are newline delimited.
+  size_t Pos = Buffer.find(RequiredStr);
+  while (Pos != StringRef::npos) {
+    size_t LineStart = Buffer.rfind('\n', Pos);
+    LineStart = LineStart == StringRef::npos ? 0 : LineStart + 1;
+    size_t LineEnd = Buffer.find('\n', Pos + RequiredStr.size());
+    if (R->match(Buffer.slice(LineStart, LineEnd), &MatchInfo))
+      return true;
+    if (LineEnd == StringRef::npos)
+      break;
+    Pos = Buffer.find(RequiredStr, LineEnd + 1);
+  }
+  return false;
+}
+
 Expected<size_t> FileCheckPattern::match(StringRef Buffer, size_t &MatchLen,
                                          const SourceMgr &SM) const {
   // If this is the EOF pattern, match it immediately.
@@ -656,7 +701,7 @@ Expected<size_t> FileCheckPattern::match(StringRef Buffer, size_t &MatchLen,
   }
 
   SmallVector<StringRef, 4> MatchInfo;
-  if (!Regex(RegExToMatch, Regex::Newline).match(Buffer, &MatchInfo))
+  if (!matchRegEx(RegExToMatch, Buffer, MatchInfo))
     return make_error<FileCheckNotFoundError>();
 
   // Successful regex match.
@@ -12,10 +12,12 @@
 
 #include "llvm/Support/FileOutputBuffer.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Memory.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include <system_error>
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
@@ -71,6 +73,31 @@ private:
   fs::TempFile Temp;
 };
 
+// A FileOutputBuffer which maps an existing file and modifies it in place.
+// This is used for F_modify.
+class InPlaceBuffer : public FileOutputBuffer {
+public:
+  InPlaceBuffer(StringRef Path, std::unique_ptr<fs::mapped_file_region> Buf)
+      : FileOutputBuffer(Path), Buffer(std::move(Buf)) {}
+
+  uint8_t *getBufferStart() const override { return (uint8_t *)Buffer->data(); }
+
+  uint8_t *getBufferEnd() const override {
+    return (uint8_t *)Buffer->data() + Buffer->size();
+  }
+
+  size_t getBufferSize() const override { return Buffer->size(); }
+
+  Error commit() override {
+    // Unmap buffer, letting OS flush dirty pages to file on disk.
+    Buffer.reset();
+    return Error::success();
+  }
+
+private:
+  std::unique_ptr<fs::mapped_file_region> Buffer;
+};
+
 // A FileOutputBuffer which keeps data in memory and writes to the final
 // output file on commit(). This is used only when we cannot use OnDiskBuffer.
 class InMemoryBuffer : public FileOutputBuffer {
@@ -161,6 +188,34 @@ createOnDiskBuffer(StringRef Path, size_t Size, unsigned Mode) {
                                          std::move(MappedFile));
 }
 
+static Expected<std::unique_ptr<FileOutputBuffer>>
+createInPlaceBuffer(StringRef Path, size_t Size) {
+  int FD;
+  if (auto EC = fs::openFileForReadWrite(Path, FD, fs::CD_OpenExisting,
+                                         fs::OF_None))
+    return errorCodeToError(EC);
+  auto CloseFD =
+      make_scope_exit([&] { Process::SafelyCloseFileDescriptor(FD); });
+
+  if (Size == size_t(-1)) {
+    fs::file_status Stat;
+    if (auto EC = fs::status(FD, Stat))
+      return errorCodeToError(EC);
+    Size = Stat.getSize();
+  } else if (auto EC = fs::resize_file(FD, Size)) {
+    return errorCodeToError(EC);
+  }
+
+  // The mapping stays valid after the file is closed.
+  std::error_code EC;
+  auto MappedFile = std::make_unique<fs::mapped_file_region>(
+      fs::convertFDToNativeFile(FD), fs::mapped_file_region::readwrite, Size, 0,
+      EC);
+  if (EC)
+    return errorCodeToError(EC);
+  return std::make_unique<InPlaceBuffer>(Path, std::move(MappedFile));
+}
+
 // Create an instance of FileOutputBuffer.
 Expected<std::unique_ptr<FileOutputBuffer>>
 FileOutputBuffer::create(StringRef Path, size_t Size, unsigned Flags) {
@@ -168,6 +223,9 @@ FileOutputBuffer::create(StringRef Path, size_t Size, unsigned Flags) {
   if (Path == "-")
     return createInMemoryBuffer("-", Size, /*Mode=*/0);
 
+  if (Flags & F_modify)
+    return createInPlaceBuffer(Path, Size);
+
   unsigned Mode = fs::all_read | fs::all_write;
   if (Flags & F_executable)
     Mode |= fs::all_exe;
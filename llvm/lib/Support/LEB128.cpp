@@ -12,9 +12,67 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
 
 namespace llvm {
 
+/// The top bit of every byte in a word. A byte of a LEB128 value with its top
+/// bit clear is the last byte of the value.
+static const uint64_t ContinuationBits = 0x8080808080808080ULL;
+
+/// Decode the ULEB128 value at \p p if it is at most eight bytes long. \p p
+/// must be followed by at least eight readable bytes.
+static inline bool decodeULEB128Word(const uint8_t *p, uint64_t &Value,
+                                     unsigned &Length) {
+  uint64_t Word = support::endian::read64le(p);
+  uint64_t Stops = ~Word & ContinuationBits;
+  if (!Stops)
+    return false;
+  // Drop the bytes after the value and the continuation bits, then pack the
+  // seven-bit groups together.
+  Word &= (Stops ^ (Stops - 1)) & ~ContinuationBits;
+  Word = (Word & 0x007f007f007f007fULL) | ((Word & 0x7f007f007f007f00ULL) >> 1);
+  Word = (Word & 0x00003fff00003fffULL) | ((Word & 0x3fff00003fff0000ULL) >> 2);
+  Word = (Word & 0x000000000fffffffULL) | ((Word & 0x0fffffff00000000ULL) >> 4);
+  Value = Word;
+  Length = countTrailingZeros(Stops) / 8 + 1;
+  return true;
+}
+
+const uint8_t *decodeULEB128Array(const uint8_t *p, const uint8_t *end,
+                                  uint64_t *Out, size_t Count,
+                                  const char **error) {
+  if (error)
+    *error = nullptr;
+  for (size_t I = 0; I != Count; ++I) {
+    unsigned Length;
+    if (end - p >= 8 && decodeULEB128Word(p, Out[I], Length)) {
+      p += Length;
+      continue;
+    }
+    const char *Err;
+    Out[I] = decodeULEB128(p, &Length, end, &Err);
+    if (Err) {
+      if (error)
+        *error = Err;
+      return nullptr;
+    }
+    p += Length;
+  }
+  return p;
+}
+
+const uint8_t *skipLEB128(const uint8_t *p, const uint8_t *end) {
+  for (; end - p >= 8; p += 8)
+    if (uint64_t Stops = ~support::endian::read64le(p) & ContinuationBits)
+      return p + countTrailingZeros(Stops) / 8 + 1;
+  while (p != end)
+    if (*p++ < 128)
+      return p;
+  return nullptr;
+}
+
 /// Utility function to get the size of the ULEB128-encoded value.
 unsigned getULEB128Size(uint64_t Value) {
   unsigned Size = 0;
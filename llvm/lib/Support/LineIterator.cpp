@@ -8,6 +8,7 @@
 
 #include "llvm/Support/LineIterator.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include <cstring>
 
 using namespace llvm;
 
@@ -31,6 +32,20 @@ static bool skipIfAtLineEnd(const char *&P) {
   return false;
 }
 
+/// Returns the number of characters before the line end or the terminating
+/// null character at \p P.
+static size_t measureLine(const char *P) {
+  // strcspn stops at '\0' and is typically vectorized by the C library.
+  size_t Length = 0;
+  for (;;) {
+    Length += std::strcspn(P + Length, "\n\r");
+    if (P[Length] != '\r' || P[Length + 1] == '\n')
+      return Length;
+    // A lone '\r' is part of the line.
+    ++Length;
+  }
+}
+
 line_iterator::line_iterator(const MemoryBuffer &Buffer, bool SkipBlanks,
                              char CommentMarker)
     : Buffer(Buffer.getBufferSize() ? &Buffer : nullptr),
@@ -67,9 +82,7 @@ void line_iterator::advance() {
       if (isAtLineEnd(Pos) && !SkipBlanks)
         break;
       if (*Pos == CommentMarker)
-        do {
-          ++Pos;
-        } while (*Pos != '\0' && !isAtLineEnd(Pos));
+        Pos += 1 + measureLine(Pos + 1);
       if (!skipIfAtLineEnd(Pos))
         break;
       ++LineNumber;
@@ -83,11 +96,5 @@ void line_iterator::advance() {
     return;
   }
 
-  // Measure the line.
-  size_t Length = 0;
-  while (Pos[Length] != '\0' && !isAtLineEnd(&Pos[Length])) {
-    ++Length;
-  }
-
-  CurrentLine = StringRef(Pos, Length);
+  CurrentLine = StringRef(Pos, measureLine(Pos));
 }
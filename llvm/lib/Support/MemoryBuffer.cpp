@@ -204,6 +204,8 @@ public:
   MemoryBuffer::BufferKind getBufferKind() const override {
     return MemoryBuffer::MemoryBuffer_MMap;
   }
+
+  void willNeedIfMmap() const override { MFR.willNeed(); }
 };
 }
 
@@ -14,8 +14,9 @@
 #include "llvm/Support/Threading.h"
 
 #include <atomic>
-#include <stack>
+#include <deque>
 #include <thread>
+#include <vector>
 
 namespace llvm {
 namespace parallel {
@@ -29,6 +30,12 @@ public:
   virtual ~Executor() = default;
   virtual void add(std::function<void()> func) = 0;
 
+  /// Called after a task released its TaskGroup's latch.
+  virtual void taskDone() {}
+
+  /// Returns once \p L is released.
+  virtual void wait(const Latch &L) { L.sync(); }
+
   static Executor *getDefaultExecutor();
 };
 
@@ -60,19 +67,32 @@ Executor *Executor::getDefaultExecutor() {
 }
 
 #else
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+struct WorkQueue {
+  std::mutex Mutex;
+  std::deque<std::function<void()>> Tasks;
+};
+
+/// The queue owned by the current thread, if it is a ThreadPoolExecutor
+/// thread.
+static LLVM_THREAD_LOCAL WorkQueue *CurrentQueue = nullptr;
+
+/// An implementation of an Executor that runs closures on a thread pool.
+///
+/// Every thread has its own queue. It runs the tasks it added itself in filo
+/// order, which keeps their data in its cache, and steals the oldest task of
+/// another queue when its own one is empty. A thread waiting for a latch runs
+/// queued tasks meanwhile, so that tasks can wait for the tasks they added.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(unsigned ThreadCount = hardware_concurrency())
-      : Done(ThreadCount) {
+      : Queues(ThreadCount), Done(ThreadCount) {
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     std::thread([&, ThreadCount] {
       for (size_t i = 1; i < ThreadCount; ++i) {
-        std::thread([=] { work(); }).detach();
+        std::thread([=] { work(i); }).detach();
       }
-      work();
+      work(0);
     }).detach();
   }
 
@@ -85,31 +105,96 @@ public:
   }
 
   void add(std::function<void()> F) override {
-    std::unique_lock<std::mutex> Lock(Mutex);
-    WorkStack.push(F);
-    Lock.unlock();
+    // Tasks added by a thread of this executor are likely to use the data that
+    // thread just worked on; the others are spread over all queues.
+    WorkQueue &Queue =
+        CurrentQueue ? *CurrentQueue : Queues[NextQueue++ % Queues.size()];
+    {
+      std::lock_guard<std::mutex> Lock(Queue.Mutex);
+      Queue.Tasks.push_back(std::move(F));
+    }
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      ++QueuedTasks;
+    }
     Cond.notify_one();
+    if (Waiters)
+      WaitCond.notify_all();
+  }
+
+  void taskDone() override {
+    if (!Waiters)
+      return;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    WaitCond.notify_all();
+  }
+
+  void wait(const Latch &L) override {
+    while (!L.isDone()) {
+      if (runTask())
+        continue;
+      // Waiters is incremented before the condition is checked, so that add()
+      // and taskDone() see it whenever this thread may miss their change.
+      ++Waiters;
+      {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        WaitCond.wait(Lock, [&] { return QueuedTasks > 0 || L.isDone(); });
+      }
+      --Waiters;
+    }
   }
 
 private:
-  void work() {
+  void work(size_t Index) {
+    CurrentQueue = &Queues[Index];
     while (true) {
+      if (runTask())
+        continue;
       std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
+      Cond.wait(Lock, [&] { return Stop || QueuedTasks > 0; });
       if (Stop)
         break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
-      Lock.unlock();
-      Task();
     }
     Done.dec();
   }
 
+  /// Runs the newest task of the current thread's queue, or else the oldest
+  /// task of another queue. Returns false if all queues were empty.
+  bool runTask() {
+    std::function<void()> Task;
+    if (CurrentQueue) {
+      std::lock_guard<std::mutex> Lock(CurrentQueue->Mutex);
+      if (!CurrentQueue->Tasks.empty()) {
+        Task = std::move(CurrentQueue->Tasks.back());
+        CurrentQueue->Tasks.pop_back();
+      }
+    }
+    size_t Start = CurrentQueue ? CurrentQueue - Queues.data() + 1 : 0;
+    for (size_t I = 0; I < Queues.size() && !Task; ++I) {
+      WorkQueue &Queue = Queues[(Start + I) % Queues.size()];
+      std::lock_guard<std::mutex> Lock(Queue.Mutex);
+      if (!Queue.Tasks.empty()) {
+        Task = std::move(Queue.Tasks.front());
+        Queue.Tasks.pop_front();
+      }
+    }
+    if (!Task)
+      return false;
+    --QueuedTasks;
+    Task();
+    return true;
+  }
+
   std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
+  std::vector<WorkQueue> Queues;
+  std::atomic<size_t> NextQueue{0};
+  // Incremented with Mutex held, so that a thread checking it before waiting
+  // on Cond or WaitCond is woken up by the notification of the increment.
+  std::atomic<size_t> QueuedTasks{0};
+  std::atomic<unsigned> Waiters{0};
   std::mutex Mutex;
   std::condition_variable Cond;
+  std::condition_variable WaitCond;
   parallel::detail::Latch Done;
 };
 
@@ -120,6 +205,7 @@ Executor *Executor::getDefaultExecutor() {
 #endif
 }
 
+#if defined(_MSC_VER)
 static std::atomic<int> TaskGroupInstances;
 
 // Latch::sync() called by the dtor may cause one thread to block. If is a dead
@@ -128,19 +214,29 @@ static std::atomic<int> TaskGroupInstances;
 // of nested parallel_for_each(), only the outermost one runs parallelly.
 TaskGroup::TaskGroup() : Parallel(TaskGroupInstances++ == 0) {}
 TaskGroup::~TaskGroup() { --TaskGroupInstances; }
+#else
+// Threads waiting for a TaskGroup run queued tasks, so nested groups cannot
+// block all threads of the executor and may run in parallel too.
+TaskGroup::TaskGroup() : Parallel(true) {}
+TaskGroup::~TaskGroup() { sync(); }
+#endif
 
 void TaskGroup::spawn(std::function<void()> F) {
   if (Parallel) {
     L.inc();
-    Executor::getDefaultExecutor()->add([&, F] {
+    Executor *E = Executor::getDefaultExecutor();
+    E->add([&, E, F] {
       F();
       L.dec();
+      E->taskDone();
     });
   } else {
     F();
   }
 }
 
+void TaskGroup::sync() const { Executor::getDefaultExecutor()->wait(L); }
+
 } // namespace detail
 } // namespace parallel
 } // namespace llvm
@@ -0,0 +1,115 @@
+//===-- PerfCounters.cpp - Hardware event counters ------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The counters are the generic hardware events of perf_event_open, so unlike
+// llvm-exegesis, which names raw events through libpfm, this needs nothing but
+// the kernel headers. They are opened as a single group, so that one read
+// returns all of them, and they are scheduled onto the PMU all together or not
+// at all.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/PerfCounters.h"
+#include "llvm/Support/CommandLine.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+using namespace llvm;
+using namespace llvm::sys;
+
+static cl::opt<bool>
+    TrackPerfCounters("track-perf-counters",
+                      cl::desc("Count instructions, cycles, cache misses and "
+                               "branch misses in -time-passes and "
+                               "-ftime-trace (Linux only)"),
+                      cl::Hidden);
+
+bool sys::perfCountersEnabled() { return TrackPerfCounters; }
+
+#if defined(__linux__)
+namespace {
+// The counters of one thread. A perf_event counts the thread that opened it
+// (pid 0, any cpu), so every thread opens its own.
+class ThreadCounters {
+  enum { NumEvents = 4 };
+  static constexpr uint64_t Events[NumEvents] = {
+      PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+  int Fds[NumEvents];
+  // Position of every event in the values read from the group, or -1 if the
+  // event could not be opened.
+  int Index[NumEvents];
+
+public:
+  ThreadCounters() {
+    for (int I = 0; I < NumEvents; ++I)
+      Fds[I] = Index[I] = -1;
+    int NumOpen = 0;
+    for (int I = 0; I < NumEvents; ++I) {
+      perf_event_attr Attr;
+      memset(&Attr, 0, sizeof(Attr));
+      Attr.size = sizeof(Attr);
+      Attr.type = PERF_TYPE_HARDWARE;
+      Attr.config = Events[I];
+      Attr.read_format = PERF_FORMAT_GROUP;
+      // Counting user space only is allowed by the default
+      // perf_event_paranoid setting, and is what the compiler does.
+      Attr.exclude_kernel = 1;
+      Attr.exclude_hv = 1;
+      Fds[I] = syscall(__NR_perf_event_open, &Attr, /*pid=*/0, /*cpu=*/-1,
+                       /*group_fd=*/NumOpen ? Fds[0] : -1, /*flags=*/0);
+      // Without the leader, there is nothing to read.
+      if (I == 0 && Fds[I] < 0)
+        return;
+      Index[I] = Fds[I] < 0 ? -1 : NumOpen++;
+    }
+  }
+
+  ~ThreadCounters() {
+    for (int Fd : Fds)
+      if (Fd >= 0)
+        close(Fd);
+  }
+
+  PerfCounts read() const {
+    PerfCounts Counts;
+    if (Index[0] < 0)
+      return Counts;
+    // { nr, values[nr] } with PERF_FORMAT_GROUP.
+    uint64_t Values[1 + NumEvents];
+    if (::read(Fds[0], Values, sizeof(Values)) < (ssize_t)sizeof(uint64_t))
+      return Counts;
+    auto Get = [&](int Event) {
+      return Index[Event] < 0 || (uint64_t)Index[Event] >= Values[0]
+                 ? 0
+                 : Values[1 + Index[Event]];
+    };
+    Counts.Instructions = Get(0);
+    Counts.Cycles = Get(1);
+    Counts.CacheMisses = Get(2);
+    Counts.BranchMisses = Get(3);
+    return Counts;
+  }
+};
+
+constexpr uint64_t ThreadCounters::Events[];
+} // end anonymous namespace
+
+PerfCounts sys::readPerfCounters() {
+  static thread_local ThreadCounters Counters;
+  return Counters.read();
+}
+#else
+PerfCounts sys::readPerfCounters() { return PerfCounts(); }
+#endif
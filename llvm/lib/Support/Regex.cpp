@@ -69,8 +69,14 @@ unsigned Regex::getNumMatches() const {
   return preg->re_nsub;
 }
 
-bool Regex::match(StringRef String, SmallVectorImpl<StringRef> *Matches){
-  if (error)
+bool Regex::match(StringRef String, SmallVectorImpl<StringRef> *Matches,
+                  std::string *Error) const {
+  // Reset error, if given.
+  if (Error && !Error->empty())
+    *Error = "";
+
+  // Check if the regex itself didn't successfully compile.
+  if (Error ? !isValid(*Error) : !isValid())
     return false;
 
   unsigned nmatch = Matches ? preg->re_nsub+1 : 0;
@@ -87,7 +93,11 @@ bool Regex::match(StringRef String, SmallVectorImpl<StringRef> *Matches){
     return false;
   if (rc != 0) {
     // regexec can fail due to invalid pattern or running out of memory.
-    error = rc;
+    if (Error) {
+      size_t len = llvm_regerror(rc, preg, nullptr, 0);
+      Error->resize(len - 1);
+      llvm_regerror(rc, preg, &(*Error)[0], len);
+    }
     return false;
   }
 
@@ -112,14 +122,11 @@ bool Regex::match(StringRef String, SmallVectorImpl<StringRef> *Matches){
 }
 
 std::string Regex::sub(StringRef Repl, StringRef String,
-                       std::string *Error) {
+                       std::string *Error) const {
   SmallVector<StringRef, 8> Matches;
 
-  // Reset error, if given.
-  if (Error && !Error->empty()) *Error = "";
-
   // Return the input if there was no match.
-  if (!match(String, &Matches))
+  if (!match(String, &Matches, Error))
     return String;
 
   // Otherwise splice in the replacement string, starting with the prefix before
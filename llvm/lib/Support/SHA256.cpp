@@ -0,0 +1,173 @@
+//====- SHA256.cpp - SHA256 implementation ---------------------*- C++ -* ======//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This code implements SHA-256 as described in FIPS 180-4, section 6.2. Whole
+// blocks are hashed directly from the input; only the trailing part of an
+// update() is copied into the internal buffer.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SHA256.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Endian.h"
+#include <string.h>
+
+using namespace llvm;
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static uint32_t ror(uint32_t Number, int Bits) {
+  return (Number >> Bits) | (Number << (32 - Bits));
+}
+
+void SHA256::init() {
+  InternalState.State[0] = 0x6a09e667;
+  InternalState.State[1] = 0xbb67ae85;
+  InternalState.State[2] = 0x3c6ef372;
+  InternalState.State[3] = 0xa54ff53a;
+  InternalState.State[4] = 0x510e527f;
+  InternalState.State[5] = 0x9b05688c;
+  InternalState.State[6] = 0x1f83d9ab;
+  InternalState.State[7] = 0x5be0cd19;
+  InternalState.ByteCount = 0;
+  InternalState.BufferOffset = 0;
+}
+
+void SHA256::hashBlock(const uint8_t *Block) {
+  uint32_t W[64];
+  for (int I = 0; I < 16; ++I)
+    W[I] = support::endian::read32be(Block + 4 * I);
+  for (int I = 16; I < 64; ++I) {
+    uint32_t S0 = ror(W[I - 15], 7) ^ ror(W[I - 15], 18) ^ (W[I - 15] >> 3);
+    uint32_t S1 = ror(W[I - 2], 17) ^ ror(W[I - 2], 19) ^ (W[I - 2] >> 10);
+    W[I] = W[I - 16] + S0 + W[I - 7] + S1;
+  }
+
+  uint32_t A = InternalState.State[0];
+  uint32_t B = InternalState.State[1];
+  uint32_t C = InternalState.State[2];
+  uint32_t D = InternalState.State[3];
+  uint32_t E = InternalState.State[4];
+  uint32_t F = InternalState.State[5];
+  uint32_t G = InternalState.State[6];
+  uint32_t H = InternalState.State[7];
+
+  for (int I = 0; I < 64; ++I) {
+    uint32_t S1 = ror(E, 6) ^ ror(E, 11) ^ ror(E, 25);
+    uint32_t Ch = (E & F) ^ (~E & G);
+    uint32_t T1 = H + S1 + Ch + K[I] + W[I];
+    uint32_t S0 = ror(A, 2) ^ ror(A, 13) ^ ror(A, 22);
+    uint32_t Maj = (A & B) ^ (A & C) ^ (B & C);
+    uint32_t T2 = S0 + Maj;
+    H = G;
+    G = F;
+    F = E;
+    E = D + T1;
+    D = C;
+    C = B;
+    B = A;
+    A = T1 + T2;
+  }
+
+  InternalState.State[0] += A;
+  InternalState.State[1] += B;
+  InternalState.State[2] += C;
+  InternalState.State[3] += D;
+  InternalState.State[4] += E;
+  InternalState.State[5] += F;
+  InternalState.State[6] += G;
+  InternalState.State[7] += H;
+}
+
+void SHA256::update(ArrayRef<uint8_t> Data) {
+  InternalState.ByteCount += Data.size();
+
+  // Finish the block that was started by a previous update.
+  if (InternalState.BufferOffset) {
+    size_t N = std::min<size_t>(BLOCK_LENGTH - InternalState.BufferOffset,
+                                Data.size());
+    memcpy(InternalState.Buffer + InternalState.BufferOffset, Data.data(), N);
+    InternalState.BufferOffset += N;
+    Data = Data.drop_front(N);
+    if (InternalState.BufferOffset != BLOCK_LENGTH)
+      return;
+    hashBlock(InternalState.Buffer);
+    InternalState.BufferOffset = 0;
+  }
+
+  while (Data.size() >= BLOCK_LENGTH) {
+    hashBlock(Data.data());
+    Data = Data.drop_front(BLOCK_LENGTH);
+  }
+
+  memcpy(InternalState.Buffer, Data.data(), Data.size());
+  InternalState.BufferOffset = Data.size();
+}
+
+void SHA256::update(StringRef Str) {
+  update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(Str.data()),
+                           Str.size()));
+}
+
+void SHA256::pad() {
+  // Implement SHA-256 padding (FIPS 180-4 5.1.1): a 1 bit, zeros up to 56
+  // bytes modulo the block length, then the message length in bits.
+  uint64_t BitCount = InternalState.ByteCount * 8;
+  InternalState.Buffer[InternalState.BufferOffset++] = 0x80;
+  if (InternalState.BufferOffset > BLOCK_LENGTH - 8) {
+    memset(InternalState.Buffer + InternalState.BufferOffset, 0,
+           BLOCK_LENGTH - InternalState.BufferOffset);
+    hashBlock(InternalState.Buffer);
+    InternalState.BufferOffset = 0;
+  }
+  memset(InternalState.Buffer + InternalState.BufferOffset, 0,
+         BLOCK_LENGTH - 8 - InternalState.BufferOffset);
+  support::endian::write64be(InternalState.Buffer + BLOCK_LENGTH - 8, BitCount);
+  hashBlock(InternalState.Buffer);
+  InternalState.BufferOffset = 0;
+}
+
+StringRef SHA256::final() {
+  pad();
+  for (int I = 0; I < 8; ++I)
+    support::endian::write32be(HashResult + 4 * I, InternalState.State[I]);
+  return StringRef(reinterpret_cast<char *>(HashResult), HASH_LENGTH);
+}
+
+StringRef SHA256::result() {
+  auto StateToRestore = InternalState;
+
+  auto Hash = final();
+
+  // Restore the state
+  InternalState = StateToRestore;
+
+  // Return pointer to hash (32 characters)
+  return Hash;
+}
+
+std::array<uint8_t, 32> SHA256::hash(ArrayRef<uint8_t> Data) {
+  SHA256 Hash;
+  Hash.update(Data);
+  StringRef S = Hash.final();
+
+  std::array<uint8_t, 32> Arr;
+  memcpy(Arr.data(), S.data(), S.size());
+  return Arr;
+}
@@ -14,17 +14,124 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/SpecialCaseList.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Regex.h"
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <system_error>
+#include <tuple>
 #include <utility>
 
 #include <stdio.h>
 namespace llvm {
 
+/// Returns true if '*' and '.' are the only metacharacters of the expression
+/// \p Regexp.
+static bool isGlob(StringRef Regexp) {
+  return Regexp.find_first_of("()^$|+?[]\\{}") == StringRef::npos;
+}
+
+/// Returns the literal prefix of any string matching the expression
+/// \p Regexp, in which '*' matches any sequence of characters.
+static StringRef getLiteralPrefix(StringRef Regexp) {
+  // The branches of an alternation don't share the prefix of the first one.
+  if (Regexp.find('|') != StringRef::npos)
+    return StringRef();
+  size_t End = Regexp.find_first_of("()^$*+?.[]\\{}");
+  StringRef Prefix = Regexp.take_front(End);
+  // A quantified character may be absent from a match.
+  if (End != StringRef::npos &&
+      (Regexp[End] == '+' || Regexp[End] == '?' || Regexp[End] == '{'))
+    Prefix = Prefix.drop_back();
+  return Prefix;
+}
+
+/// Returns the literal suffix of any string matching the expression
+/// \p Regexp, in which '*' matches any sequence of characters.
+static StringRef getLiteralSuffix(StringRef Regexp) {
+  if (Regexp.find('|') != StringRef::npos)
+    return StringRef();
+  // Quantifiers follow what they apply to, so the characters after the last
+  // metacharacter are always matched literally. An escaped character is
+  // literal too.
+  size_t Begin = Regexp.find_last_of("()^$*+?.[]\\{}");
+  return Begin == StringRef::npos ? Regexp : Regexp.drop_front(Begin + 1);
+}
+
+/// Returns the first three characters of \p Str packed in an integer.
+static unsigned getTrigram(StringRef Str) {
+  return (unsigned)(unsigned char)Str[0] << 16 |
+         (unsigned)(unsigned char)Str[1] << 8 | (unsigned char)Str[2];
+}
+
+/// Returns true if \p Str, which has the size of \p Part, matches \p Part,
+/// in which '.' matches any character.
+static bool matchPart(StringRef Part, StringRef Str) {
+  for (size_t I = 0, E = Part.size(); I != E; ++I)
+    if (Part[I] != '.' && Part[I] != Str[I])
+      return false;
+  return true;
+}
+
+/// Returns the position of the first substring of \p Str matching \p Part,
+/// in which '.' matches any character.
+static size_t findPart(StringRef Str, StringRef Part) {
+  if (Part.find('.') == StringRef::npos)
+    return Str.find(Part);
+  for (size_t I = 0; I + Part.size() <= Str.size(); ++I)
+    if (matchPart(Part, Str.substr(I, Part.size())))
+      return I;
+  return StringRef::npos;
+}
+
+/// Returns true if \p Query matches \p Glob, in which '*' matches any
+/// sequence of characters and '.' any character.
+static bool matchGlob(StringRef Glob, StringRef Query) {
+  if (Glob.find('*') == StringRef::npos)
+    return Glob.size() == Query.size() && matchPart(Glob, Query);
+
+  // The part before the first '*' is a prefix of any match, and the part
+  // after the last '*' a suffix.
+  StringRef Prefix, Suffix;
+  std::tie(Prefix, Glob) = Glob.split('*');
+  size_t Last = Glob.rfind('*');
+  Suffix = Last == StringRef::npos ? Glob : Glob.drop_front(Last + 1);
+  Glob = Last == StringRef::npos ? StringRef() : Glob.take_front(Last);
+  if (Query.size() < Prefix.size() + Suffix.size() ||
+      !matchPart(Prefix, Query.take_front(Prefix.size())) ||
+      !matchPart(Suffix, Query.take_back(Suffix.size())))
+    return false;
+  Query = Query.drop_front(Prefix.size()).drop_back(Suffix.size());
+
+  // Glob is now the middle of the expression, without its first and last
+  // '*'. Matching each of its parts as early as possible leaves the most room
+  // for the next ones.
+  while (!Glob.empty()) {
+    StringRef Part;
+    std::tie(Part, Glob) = Glob.split('*');
+    size_t Pos = findPart(Query, Part);
+    if (Pos == StringRef::npos)
+      return false;
+    Query = Query.drop_front(Pos + Part.size());
+  }
+  return true;
+}
+
+/// Adds \p I to the entry of \p Index for \p Key, and the length of \p Key
+/// to the sorted \p Lengths.
+static void addToIndex(StringMap<std::vector<unsigned>> &Index,
+                       SmallVectorImpl<size_t> &Lengths, StringRef Key,
+                       unsigned I) {
+  Index[Key].push_back(I);
+  auto It = std::lower_bound(Lengths.begin(), Lengths.end(), Key.size());
+  if (It == Lengths.end() || *It != Key.size())
+    Lengths.insert(It, Key.size());
+}
+
 bool SpecialCaseList::Matcher::insert(std::string Regexp,
                                       unsigned LineNumber,
                                       std::string &REError) {
@@ -39,6 +146,50 @@ bool SpecialCaseList::Matcher::insert(std::string Regexp,
   }
   Trigrams.insert(Regexp);
 
+  // Index the expression by its literal prefix if it has one. Otherwise use
+  // its literal suffix or, for globs, the trigram of its parts, whichever has
+  // the fewest expressions so far.
+  unsigned Index = Patterns.size();
+  bool IsGlob = isGlob(Regexp);
+  StringRef Prefix = getLiteralPrefix(Regexp);
+  if (!Prefix.empty()) {
+    addToIndex(PrefixIndex, PrefixLengths, Prefix, Index);
+  } else {
+    StringRef Suffix = getLiteralSuffix(Regexp);
+    size_t SuffixCount = std::numeric_limits<size_t>::max();
+    if (!Suffix.empty()) {
+      auto It = SuffixIndex.find(Suffix);
+      SuffixCount = It == SuffixIndex.end() ? 0 : It->second.size();
+    }
+    Optional<unsigned> Trigram;
+    size_t TrigramCount = std::numeric_limits<size_t>::max();
+    for (size_t I = 0; IsGlob && I + 3 <= Regexp.size(); ++I) {
+      if (StringRef(Regexp).substr(I, 3).find_first_of("*.") !=
+          StringRef::npos)
+        continue;
+      unsigned Key = getTrigram(StringRef(Regexp).substr(I));
+      auto It = InfixIndex.find(Key);
+      size_t Count = It == InfixIndex.end() ? 0 : It->second.size();
+      if (Count < TrigramCount) {
+        Trigram = Key;
+        TrigramCount = Count;
+      }
+    }
+    if (!Suffix.empty() && SuffixCount <= TrigramCount)
+      addToIndex(SuffixIndex, SuffixLengths, Suffix, Index);
+    else if (Trigram)
+      InfixIndex[*Trigram].push_back(Index);
+    else
+      Unindexed.push_back(Index);
+  }
+
+  // Expressions made of literal parts, '*' and '.' don't need the regex
+  // engine.
+  if (IsGlob) {
+    Patterns.push_back({std::move(Regexp), nullptr, LineNumber});
+    return true;
+  }
+
   // Replace * with .*
   for (size_t pos = 0; (pos = Regexp.find('*', pos)) != std::string::npos;
        pos += strlen(".*")) {
@@ -52,8 +203,8 @@ bool SpecialCaseList::Matcher::insert(std::string Regexp,
   if (!CheckRE.isValid(REError))
     return false;
 
-  RegExes.emplace_back(
-      std::make_pair(std::make_unique<Regex>(std::move(CheckRE)), LineNumber));
+  Patterns.push_back(
+      {std::string(), std::make_unique<Regex>(std::move(CheckRE)), LineNumber});
   return true;
 }
 
@@ -63,10 +214,52 @@ unsigned SpecialCaseList::Matcher::match(StringRef Query) const {
     return It->second;
   if (Trigrams.isDefinitelyOut(Query))
     return false;
-  for (auto& RegExKV : RegExes)
-    if (RegExKV.first->match(Query))
-      return RegExKV.second;
-  return 0;
+
+  // Find the first matching expression among the ones whose prefix starts the
+  // query, whose suffix ends it, whose trigram is in it, and the unindexed
+  // ones.
+  unsigned Best = Patterns.size();
+  matchAffixes(PrefixIndex, PrefixLengths, /*Suffixes=*/false, Query, Best);
+  matchAffixes(SuffixIndex, SuffixLengths, /*Suffixes=*/true, Query, Best);
+  if (!InfixIndex.empty()) {
+    for (size_t I = 0; I + 3 <= Query.size(); ++I) {
+      auto It = InfixIndex.find(getTrigram(Query.substr(I)));
+      if (It != InfixIndex.end())
+        matchFirst(It->second, Query, Best);
+    }
+  }
+  matchFirst(Unindexed, Query, Best);
+  return Best < Patterns.size() ? Patterns[Best].LineNumber : 0;
+}
+
+bool SpecialCaseList::Matcher::Pattern::match(StringRef Query) const {
+  return RegEx ? RegEx->match(Query) : matchGlob(Glob, Query);
+}
+
+void SpecialCaseList::Matcher::matchAffixes(
+    const StringMap<std::vector<unsigned>> &Index, ArrayRef<size_t> Lengths,
+    bool Suffixes, StringRef Query, unsigned &Best) const {
+  for (size_t Len : Lengths) {
+    if (Len > Query.size())
+      return;
+    auto It = Index.find(Suffixes ? Query.take_back(Len)
+                                  : Query.take_front(Len));
+    if (It != Index.end())
+      matchFirst(It->second, Query, Best);
+  }
+}
+
+void SpecialCaseList::Matcher::matchFirst(ArrayRef<unsigned> Indices,
+                                          StringRef Query,
+                                          unsigned &Best) const {
+  for (unsigned I : Indices) {
+    if (I >= Best)
+      return;
+    if (Patterns[I].match(Query)) {
+      Best = I;
+      return;
+    }
+  }
 }
 
 std::unique_ptr<SpecialCaseList>
@@ -149,13 +149,18 @@ size_t StringRef::find(StringRef Str, size_t From) const {
 
   const char *Stop = Start + (Size - N + 1);
 
-  // For short haystacks or unsupported needles fall back to the naive algorithm
-  if (Size < 16 || N > 255) {
-    do {
-      if (std::memcmp(Start, Needle, N) == 0)
-        return Start - Data;
-      ++Start;
-    } while (Start < Stop);
+  // For short haystacks, short needles or unsupported needles fall back to the
+  // naive algorithm, using memchr to find the candidate positions. For short
+  // needles in text this beats the bad char heuristic, whose skips are bounded
+  // by the needle length, even though it is slower when the first character of
+  // the needle is very frequent.
+  if (Size < 16 || N < 8 || N > 255) {
+    while (const char *P =
+               (const char *)::memchr(Start, Needle[0], Stop - Start)) {
+      if (std::memcmp(P, Needle, N) == 0)
+        return P - Data;
+      Start = P + 1;
+    }
     return npos;
   }
 
@@ -234,6 +239,9 @@ size_t StringRef::rfind_lower(StringRef Str) const {
 /// Note: O(size() + Chars.size())
 StringRef::size_type StringRef::find_first_of(StringRef Chars,
                                               size_t From) const {
+  if (Chars.size() == 1)
+    return find(Chars[0], From);
+
   std::bitset<1 << CHAR_BIT> CharBits;
   for (size_type i = 0; i != Chars.size(); ++i)
     CharBits.set((unsigned char)Chars[i]);
@@ -372,11 +380,10 @@ void StringRef::split(SmallVectorImpl<StringRef> &A, char Separator,
 size_t StringRef::count(StringRef Str) const {
   size_t Count = 0;
   size_t N = Str.size();
-  if (N > Length)
-    return 0;
-  for (size_t i = 0, e = Length - N + 1; i != e; ++i)
-    if (substr(i, N).equals(Str))
-      ++Count;
+  if (N == 0 || N > Length)
+    return N == 0 ? Length + 1 : 0;
+  for (size_t i = find(Str); i != npos; i = find(Str, i + 1))
+    ++Count;
   return Count;
 }
 
@@ -18,6 +18,14 @@ StringRef StringSaver::save(StringRef S) {
   return StringRef(P, S.size());
 }
 
+StringRef ConcurrentStringSaver::save(StringRef S) {
+  char *P = Alloc.Allocate<char>(S.size() + 1);
+  if (!S.empty())
+    memcpy(P, S.data(), S.size());
+  P[S.size()] = '\0';
+  return StringRef(P, S.size());
+}
+
 StringRef UniqueStringSaver::save(StringRef S) {
   auto R = Unique.insert(S);
   if (R.second)                 // cache miss, need to actually save the string
@@ -0,0 +1,81 @@
+//===- ThreadSafeAllocator.cpp - Concurrent bump pointer allocator --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the ThreadSafeBumpPtrAllocator class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/ThreadSafeAllocator.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Threading.h"
+#include <atomic>
+#include <mutex>
+
+using namespace llvm;
+
+struct ThreadSafeBumpPtrAllocator::ThreadAllocators {
+  mutable std::mutex Mutex;
+  DenseMap<uint64_t, std::unique_ptr<BumpPtrAllocator>> ByThread;
+};
+
+// The allocator most recently used by this thread. Threads usually allocate
+// from one allocator at a time, so this avoids the lock in the common case.
+static LLVM_THREAD_LOCAL uint64_t CachedID;
+static LLVM_THREAD_LOCAL BumpPtrAllocator *CachedAllocator;
+
+static std::atomic<uint64_t> NextID(1);
+
+ThreadSafeBumpPtrAllocator::ThreadSafeBumpPtrAllocator()
+    : Allocators(std::make_unique<ThreadAllocators>()), ID(NextID++) {}
+
+ThreadSafeBumpPtrAllocator::~ThreadSafeBumpPtrAllocator() = default;
+
+BumpPtrAllocator &ThreadSafeBumpPtrAllocator::getThreadAllocator() {
+  if (CachedID == ID)
+    return *CachedAllocator;
+
+  std::lock_guard<std::mutex> Lock(Allocators->Mutex);
+  // Thread IDs may be reused once a thread exits. The new thread then simply
+  // continues with the allocator of the old one.
+  std::unique_ptr<BumpPtrAllocator> &Alloc =
+      Allocators->ByThread[get_threadid()];
+  if (!Alloc)
+    Alloc = std::make_unique<BumpPtrAllocator>();
+  CachedID = ID;
+  CachedAllocator = Alloc.get();
+  return *Alloc;
+}
+
+void ThreadSafeBumpPtrAllocator::Reset() {
+  // Keep the per-thread allocators alive, they may be cached by their threads.
+  std::lock_guard<std::mutex> Lock(Allocators->Mutex);
+  for (auto &KV : Allocators->ByThread)
+    KV.second->Reset();
+}
+
+size_t ThreadSafeBumpPtrAllocator::getTotalMemory() const {
+  std::lock_guard<std::mutex> Lock(Allocators->Mutex);
+  size_t TotalMemory = 0;
+  for (const auto &KV : Allocators->ByThread)
+    TotalMemory += KV.second->getTotalMemory();
+  return TotalMemory;
+}
+
+size_t ThreadSafeBumpPtrAllocator::getBytesAllocated() const {
+  std::lock_guard<std::mutex> Lock(Allocators->Mutex);
+  size_t BytesAllocated = 0;
+  for (const auto &KV : Allocators->ByThread)
+    BytesAllocated += KV.second->getBytesAllocated();
+  return BytesAllocated;
+}
+
+void ThreadSafeBumpPtrAllocator::PrintStats() const {
+  std::lock_guard<std::mutex> Lock(Allocators->Mutex);
+  for (const auto &KV : Allocators->ByThread)
+    KV.second->PrintStats();
+}
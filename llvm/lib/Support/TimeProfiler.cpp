@@ -15,16 +15,37 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/PerfCounters.h"
+#include "llvm/Support/Threading.h"
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <mutex>
 #include <string>
 #include <vector>
 
 using namespace std::chrono;
 
+namespace {
+using namespace llvm;
+
+// The instances of the threads that have finished, waiting to be written by
+// the main one. Only handing an instance over takes the lock; recording
+// sections in it never does.
+std::mutex Mu;
+ManagedStatic<std::vector<TimeTraceProfiler *>>
+    ThreadTimeTraceProfilerInstances;
+
+// The instance of the main thread, which finished instances are handed over
+// to and whose start time the events of every thread are relative to.
+TimeTraceProfiler *MainTimeTraceProfilerInstance = nullptr;
+} // namespace
+
 namespace llvm {
 
-TimeTraceProfiler *TimeTraceProfilerInstance = nullptr;
+LLVM_THREAD_LOCAL TimeTraceProfiler *TimeTraceProfilerInstance = nullptr;
 
 typedef duration<steady_clock::rep, steady_clock::period> DurationType;
 typedef time_point<steady_clock> TimePointType;
@@ -37,6 +58,8 @@ struct Entry {
   TimePointType End;
   std::string Name;
   std::string Detail;
+  // Hardware events counted over the section, with -track-perf-counters.
+  sys::PerfCounts Counts;
 
   Entry(TimePointType &&S, TimePointType &&E, std::string &&N, std::string &&Dt)
       : Start(std::move(S)), End(std::move(E)), Name(std::move(N)),
@@ -59,18 +82,26 @@ struct Entry {
 };
 
 struct TimeTraceProfiler {
-  TimeTraceProfiler() {
-    StartTime = steady_clock::now();
+  TimeTraceProfiler(unsigned TimeTraceGranularity, StringRef ProcName)
+      : StartTime(steady_clock::now()), ProcName(ProcName),
+        Tid(llvm::get_threadid()), TimeTraceGranularity(TimeTraceGranularity) {
   }
 
   void begin(std::string Name, llvm::function_ref<std::string()> Detail) {
     Stack.emplace_back(steady_clock::now(), TimePointType(), std::move(Name),
                        Detail());
+    if (sys::perfCountersEnabled())
+      Stack.back().Counts = sys::readPerfCounters();
   }
 
   void end() {
     assert(!Stack.empty() && "Must call begin() first");
     auto &E = Stack.back();
+    if (sys::perfCountersEnabled()) {
+      sys::PerfCounts StartCounts = E.Counts;
+      E.Counts = sys::readPerfCounters();
+      E.Counts -= StartCounts;
+    }
     E.End = steady_clock::now();
 
     // Check that end times monotonically increase.
@@ -103,36 +134,74 @@ struct TimeTraceProfiler {
     Stack.pop_back();
   }
 
+  // Write the events of this instance and of all the finished thread
+  // instances.
   void Write(raw_pwrite_stream &OS) {
     assert(Stack.empty() &&
            "All profiler sections should be ended when calling Write");
+    std::lock_guard<std::mutex> Lock(Mu);
+    assert(llvm::all_of(*ThreadTimeTraceProfilerInstances,
+                        [](const TimeTraceProfiler *TTP) {
+                          return TTP->Stack.empty();
+                        }) &&
+           "All profiler sections should be ended when calling Write");
     json::OStream J(OS);
     J.objectBegin();
     J.attributeBegin("traceEvents");
     J.arrayBegin();
 
-    // Emit all events for the main flame graph.
-    for (const auto &E : Entries) {
-      auto StartUs = E.getFlameGraphStartUs(StartTime);
-      auto DurUs = E.getFlameGraphDurUs();
-
-      J.object([&]{
-        J.attribute("pid", 1);
-        J.attribute("tid", 0);
-        J.attribute("ph", "X");
-        J.attribute("ts", StartUs);
-        J.attribute("dur", DurUs);
-        J.attribute("name", E.Name);
-        J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
-      });
-    }
+    // Emit all events for the main flame graph of every thread, relative to
+    // the start of the main thread.
+    auto WriteEvents = [&](const TimeTraceProfiler &TTP) {
+      for (const auto &E : TTP.Entries) {
+        auto StartUs = E.getFlameGraphStartUs(StartTime);
+        auto DurUs = E.getFlameGraphDurUs();
+
+        J.object([&] {
+          J.attribute("pid", 1);
+          J.attribute("tid", int64_t(TTP.Tid));
+          J.attribute("ph", "X");
+          J.attribute("ts", StartUs);
+          J.attribute("dur", DurUs);
+          J.attribute("name", E.Name);
+          J.attributeObject("args", [&] {
+            J.attribute("detail", E.Detail);
+            if (E.Counts.Instructions) {
+              J.attribute("instructions", int64_t(E.Counts.Instructions));
+              J.attribute("cycles", int64_t(E.Counts.Cycles));
+              J.attribute("cache misses", int64_t(E.Counts.CacheMisses));
+              J.attribute("branch misses", int64_t(E.Counts.BranchMisses));
+            }
+          });
+        });
+      }
+    };
+    WriteEvents(*this);
+    for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
+      WriteEvents(*TTP);
+
+    // Sum the totals by section name over all threads.
+    StringMap<CountAndDurationType> AllCountAndTotalPerName;
+    auto CombineTotals = [&](const TimeTraceProfiler &TTP) {
+      for (const auto &E : TTP.CountAndTotalPerName) {
+        auto &CountAndTotal = AllCountAndTotalPerName[E.getKey()];
+        CountAndTotal.first += E.getValue().first;
+        CountAndTotal.second += E.getValue().second;
+      }
+    };
+    CombineTotals(*this);
+    for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
+      CombineTotals(*TTP);
 
     // Emit totals by section name as additional "thread" events, sorted from
-    // longest one.
-    int Tid = 1;
+    // longest one. Their tids follow the largest one of a real thread.
+    uint64_t MaxTid = Tid;
+    for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
+      MaxTid = std::max(MaxTid, TTP->Tid);
+    uint64_t TotalTid = MaxTid + 1;
     std::vector<NameAndCountAndDurationType> SortedTotals;
-    SortedTotals.reserve(CountAndTotalPerName.size());
-    for (const auto &E : CountAndTotalPerName)
+    SortedTotals.reserve(AllCountAndTotalPerName.size());
+    for (const auto &E : AllCountAndTotalPerName)
       SortedTotals.emplace_back(E.getKey(), E.getValue());
 
     llvm::sort(SortedTotals.begin(), SortedTotals.end(),
@@ -142,11 +211,11 @@ struct TimeTraceProfiler {
                });
     for (const auto &E : SortedTotals) {
       auto DurUs = duration_cast<microseconds>(E.second.second).count();
-      auto Count = CountAndTotalPerName[E.first].first;
+      auto Count = E.second.first;
 
       J.object([&]{
         J.attribute("pid", 1);
-        J.attribute("tid", Tid);
+        J.attribute("tid", int64_t(TotalTid));
         J.attribute("ph", "X");
         J.attribute("ts", 0);
         J.attribute("dur", DurUs);
@@ -157,19 +226,34 @@ struct TimeTraceProfiler {
         });
       });
 
-      ++Tid;
+      ++TotalTid;
     }
 
-    // Emit metadata event with process name.
+    // Emit metadata events with the process name and the name of every
+    // thread.
     J.object([&] {
       J.attribute("cat", "");
       J.attribute("pid", 1);
-      J.attribute("tid", 0);
+      J.attribute("tid", int64_t(Tid));
       J.attribute("ts", 0);
       J.attribute("ph", "M");
       J.attribute("name", "process_name");
-      J.attributeObject("args", [&] { J.attribute("name", "clang"); });
+      J.attributeObject("args", [&] { J.attribute("name", ProcName); });
     });
+    auto WriteThreadName = [&](const TimeTraceProfiler &TTP, StringRef Name) {
+      J.object([&] {
+        J.attribute("cat", "");
+        J.attribute("pid", 1);
+        J.attribute("tid", int64_t(TTP.Tid));
+        J.attribute("ts", 0);
+        J.attribute("ph", "M");
+        J.attribute("name", "thread_name");
+        J.attributeObject("args", [&] { J.attribute("name", Name); });
+      });
+    };
+    WriteThreadName(*this, ProcName);
+    for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
+      WriteThreadName(*TTP, TTP->ProcName);
 
     J.arrayEnd();
     J.attributeEnd();
@@ -179,27 +263,51 @@ struct TimeTraceProfiler {
   SmallVector<Entry, 16> Stack;
   SmallVector<Entry, 128> Entries;
   StringMap<CountAndDurationType> CountAndTotalPerName;
-  TimePointType StartTime;
+  const TimePointType StartTime;
+  const std::string ProcName;
+  const uint64_t Tid;
 
   // Minimum time granularity (in microseconds)
-  unsigned TimeTraceGranularity;
+  const unsigned TimeTraceGranularity;
 };
 
-void timeTraceProfilerInitialize(unsigned TimeTraceGranularity) {
+void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
+                                 StringRef ProcName) {
   assert(TimeTraceProfilerInstance == nullptr &&
          "Profiler should not be initialized");
-  TimeTraceProfilerInstance = new TimeTraceProfiler();
-  TimeTraceProfilerInstance->TimeTraceGranularity = TimeTraceGranularity;
+  TimeTraceProfilerInstance = new TimeTraceProfiler(
+      TimeTraceGranularity, llvm::sys::path::filename(ProcName));
+  std::lock_guard<std::mutex> Lock(Mu);
+  if (!MainTimeTraceProfilerInstance)
+    MainTimeTraceProfilerInstance = TimeTraceProfilerInstance;
+}
+
+void timeTraceProfilerFinishThread() {
+  assert(TimeTraceProfilerInstance != MainTimeTraceProfilerInstance &&
+         "The main thread is finished by timeTraceProfilerCleanup");
+  if (TimeTraceProfilerInstance == nullptr)
+    return;
+  std::lock_guard<std::mutex> Lock(Mu);
+  ThreadTimeTraceProfilerInstances->push_back(TimeTraceProfilerInstance);
+  TimeTraceProfilerInstance = nullptr;
 }
 
 void timeTraceProfilerCleanup() {
+  assert(TimeTraceProfilerInstance == MainTimeTraceProfilerInstance &&
+         "Profiler should be cleaned up by the main thread");
   delete TimeTraceProfilerInstance;
   TimeTraceProfilerInstance = nullptr;
+  std::lock_guard<std::mutex> Lock(Mu);
+  MainTimeTraceProfilerInstance = nullptr;
+  for (TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
+    delete TTP;
+  ThreadTimeTraceProfilerInstances->clear();
 }
 
 void timeTraceProfilerWrite(raw_pwrite_stream &OS) {
   assert(TimeTraceProfilerInstance != nullptr &&
-         "Profiler object can't be null");
+         TimeTraceProfilerInstance == MainTimeTraceProfilerInstance &&
+         "Profiler should be written by the main thread");
   TimeTraceProfilerInstance->Write(OS);
 }
 
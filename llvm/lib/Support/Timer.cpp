@@ -120,10 +120,16 @@ TimeRecord TimeRecord::getCurrentTime(bool Start) {
   sys::TimePoint<> now;
   std::chrono::nanoseconds user, sys;
 
+  // The counters are read innermost, so that they count as little of the
+  // timer itself as possible.
   if (Start) {
     Result.MemUsed = getMemUsage();
     sys::Process::GetTimeUsage(now, user, sys);
+    if (sys::perfCountersEnabled())
+      Result.Counts = sys::readPerfCounters();
   } else {
+    if (sys::perfCountersEnabled())
+      Result.Counts = sys::readPerfCounters();
     sys::Process::GetTimeUsage(now, user, sys);
     Result.MemUsed = getMemUsage();
   }
@@ -169,6 +175,10 @@ void TimeRecord::print(const TimeRecord &Total, raw_ostream &OS) const {
   if (Total.getProcessTime())
     printVal(getProcessTime(), Total.getProcessTime(), OS);
   printVal(getWallTime(), Total.getWallTime(), OS);
+  if (Total.Counts.Instructions)
+    OS << format("  %14" PRIu64 "  %14" PRIu64 "  %14" PRIu64 "  %14" PRIu64,
+                 Counts.Instructions, Counts.Cycles, Counts.CacheMisses,
+                 Counts.BranchMisses);
 
   OS << "  ";
 
@@ -329,6 +339,8 @@ void TimerGroup::PrintQueuedTimers(raw_ostream &OS) {
   if (Total.getProcessTime())
     OS << "   --User+System--";
   OS << "   ---Wall Time---";
+  if (Total.getPerfCounts().Instructions)
+    OS << "  -Instructions-  ----Cycles----  -Cache Misses-  -Branch Misses";
   if (Total.getMemUsed())
     OS << "  ---Mem---";
   OS << "  --- Name ---\n";
@@ -425,6 +437,17 @@ const char *TimerGroup::printJSONValues(raw_ostream &OS, const char *delim) {
       OS << delim;
       printJSONValue(OS, R, ".mem", T.getMemUsed());
     }
+    const sys::PerfCounts &Counts = T.getPerfCounts();
+    if (Counts.Instructions) {
+      OS << delim;
+      printJSONValue(OS, R, ".instructions", Counts.Instructions);
+      OS << delim;
+      printJSONValue(OS, R, ".cycles", Counts.Cycles);
+      OS << delim;
+      printJSONValue(OS, R, ".cache-misses", Counts.CacheMisses);
+      OS << delim;
+      printJSONValue(OS, R, ".branch-misses", Counts.BranchMisses);
+    }
   }
   TimersToPrint.clear();
   return delim;
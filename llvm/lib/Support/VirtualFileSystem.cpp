@@ -520,6 +520,49 @@ directory_iterator OverlayFileSystem::dir_begin(const Twine &Dir,
 
 void ProxyFileSystem::anchor() {}
 
+//===-----------------------------------------------------------------------===/
+// StatCachingFileSystem implementation
+//===-----------------------------------------------------------------------===/
+
+void StatCachingFileSystem::StatCache::clear() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Entries.clear();
+}
+
+size_t StatCachingFileSystem::StatCache::size() const {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return Entries.size();
+}
+
+ErrorOr<Status> StatCachingFileSystem::status(const Twine &Path) {
+  SmallString<256> Queried;
+  Path.toVector(Queried);
+  SmallString<256> Key(Queried);
+  // Relative paths are only meaningful together with the working directory.
+  if (makeAbsolute(Key))
+    return ProxyFileSystem::status(Queried);
+
+  {
+    std::lock_guard<std::mutex> Lock(Cache->Mutex);
+    auto I = Cache->Entries.find(Key);
+    if (I != Cache->Entries.end()) {
+      const StatCache::Entry &E = I->second;
+      if (E.HasQueriedName)
+        return Status::copyWithNewName(*E.S, Queried);
+      return E.S;
+    }
+  }
+
+  // Don't hold the lock while querying the file system. Another thread may
+  // get there first, in which case both results are the same.
+  ErrorOr<Status> S = ProxyFileSystem::status(Queried);
+  bool HasQueriedName = S && S->getName() == Queried;
+  std::lock_guard<std::mutex> Lock(Cache->Mutex);
+  Cache->Entries.insert(
+      std::make_pair(Key, StatCache::Entry{S, HasQueriedName}));
+  return S;
+}
+
 namespace llvm {
 namespace vfs {
 
@@ -1259,6 +1302,16 @@ class llvm::vfs::RedirectingFileSystemParser {
     }
   }
 
+  void indexOverlayTree(RedirectingFileSystem::Entry *E, bool CaseSensitive) {
+    auto *DE = dyn_cast<RedirectingFileSystem::RedirectingDirectoryEntry>(E);
+    if (!DE)
+      return;
+    DE->buildIndex(CaseSensitive);
+    for (std::unique_ptr<RedirectingFileSystem::Entry> &SubEntry :
+         llvm::make_range(DE->contents_begin(), DE->contents_end()))
+      indexOverlayTree(SubEntry.get(), CaseSensitive);
+  }
+
   std::unique_ptr<RedirectingFileSystem::Entry>
   parseEntry(yaml::Node *N, RedirectingFileSystem *FS, bool IsRootEntry) {
     auto *M = dyn_cast<yaml::MappingNode>(N);
@@ -1550,6 +1603,10 @@ public:
     for (auto &E : RootEntries)
       uniqueOverlayTree(FS, E.get());
 
+    // The tree won't change anymore: index the large directories.
+    for (auto &E : FS->Roots)
+      indexOverlayTree(E.get(), FS->CaseSensitive);
+
     return true;
   }
 };
@@ -1664,6 +1721,22 @@ RedirectingFileSystem::lookupPath(sys::path::const_iterator Start,
   if (!DE)
     return make_error_code(llvm::errc::not_a_directory);
 
+  // Only the entries named *Start can match. Non-canonical paths may contain
+  // "." components, which the index doesn't know about.
+  if (UseCanonicalizedPaths) {
+    if (Optional<ArrayRef<RedirectingFileSystem::Entry *>> Candidates =
+            DE->findContents(*Start, CaseSensitive)) {
+      for (RedirectingFileSystem::Entry *DirEntry : *Candidates) {
+        ErrorOr<RedirectingFileSystem::Entry *> Result =
+            lookupPath(Start, End, DirEntry);
+        if (Result ||
+            Result.getError() != llvm::errc::no_such_file_or_directory)
+          return Result;
+      }
+      return make_error_code(llvm::errc::no_such_file_or_directory);
+    }
+  }
+
   for (const std::unique_ptr<RedirectingFileSystem::Entry> &DirEntry :
        llvm::make_range(DE->contents_begin(), DE->contents_end())) {
     ErrorOr<RedirectingFileSystem::Entry *> Result =
@@ -1674,6 +1747,41 @@ RedirectingFileSystem::lookupPath(sys::path::const_iterator Start,
   return make_error_code(llvm::errc::no_such_file_or_directory);
 }
 
+void RedirectingFileSystem::RedirectingDirectoryEntry::buildIndex(
+    bool CaseSensitive) {
+  Index.clear();
+  HasIndex = false;
+  // Below this, comparing every name is cheaper than hashing one.
+  if (Contents.size() < 16)
+    return;
+  // An entry with an empty name forwards the lookup to its own contents, so
+  // it can't be filed under a single name.
+  if (llvm::any_of(Contents, [](const std::unique_ptr<Entry> &E) {
+        return E->getName().empty();
+      }))
+    return;
+  for (const std::unique_ptr<Entry> &E : Contents) {
+    StringRef Name = E->getName();
+    if (CaseSensitive)
+      Index[Name].push_back(E.get());
+    else
+      Index[Name.lower()].push_back(E.get());
+  }
+  HasIndex = true;
+  IndexIsCaseSensitive = CaseSensitive;
+}
+
+Optional<ArrayRef<RedirectingFileSystem::Entry *>>
+RedirectingFileSystem::RedirectingDirectoryEntry::findContents(
+    StringRef Name, bool CaseSensitive) const {
+  if (!HasIndex || IndexIsCaseSensitive != CaseSensitive)
+    return None;
+  auto I = CaseSensitive ? Index.find(Name) : Index.find(Name.lower());
+  if (I == Index.end())
+    return ArrayRef<Entry *>();
+  return makeArrayRef(I->second);
+}
+
 static Status getRedirectedFileStatus(const Twine &Path, bool UseExternalNames,
                                       Status ExternalStatus) {
   Status S = ExternalStatus;
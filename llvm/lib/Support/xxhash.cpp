@@ -33,11 +33,15 @@
 */
 
 /* based on revision d2df04efcbef7d7f6886d345861e5dfda4edacc1 Removed
- * everything but a simple interface for computing XXh64. */
+ * everything but a simple interface for computing XXh64.
+ *
+ * XXH3_64bits is based on xxHash 0.8.1, reduced to the default secret and
+ * seed 0. */
 
 #include "llvm/Support/xxhash.h"
 #include "llvm/Support/Endian.h"
 
+#include <cassert>
 #include <stdlib.h>
 #include <string.h>
 
@@ -136,3 +140,260 @@ uint64_t llvm::xxHash64(StringRef Data) {
 uint64_t llvm::xxHash64(ArrayRef<uint8_t> Data) {
   return xxHash64({(const char *)Data.data(), Data.size()});
 }
+
+// XXH3 wants a 32-bit prime as well.
+static const uint64_t PRIME32_1 = 0x9E3779B1U;
+static const uint64_t PRIME32_2 = 0x85EBCA77U;
+static const uint64_t PRIME32_3 = 0xC2B2AE3DU;
+
+static const uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+static const uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+constexpr size_t XXH3_SECRETSIZE_DEFAULT = 192;
+constexpr size_t XXH3_SECRETSIZE_MIN = 136;
+constexpr size_t XXH3_STRIPE_LEN = 64;
+constexpr size_t XXH3_SECRET_CONSUME_RATE = 8;
+constexpr size_t XXH3_ACC_NB = XXH3_STRIPE_LEN / sizeof(uint64_t);
+constexpr size_t XXH3_SECRET_LASTACC_START = 7;
+constexpr size_t XXH3_SECRET_MERGEACCS_START = 11;
+constexpr size_t XXH3_MIDSIZE_MAX = 240;
+
+// Pseudorandom secret taken directly from FARSH.
+static const uint8_t Kkey[XXH3_SECRETSIZE_DEFAULT] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c,
+    0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+    0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e,
+    0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6,
+    0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+    0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97,
+    0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7,
+    0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+    0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83,
+    0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26,
+    0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+    0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f,
+    0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+// Calculates a 64-bit to 128-bit multiply, then XOR folds it.
+static uint64_t XXH3_mul128_fold64(uint64_t Lhs, uint64_t Rhs) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t Product = (__uint128_t)Lhs * (__uint128_t)Rhs;
+  return uint64_t(Product) ^ uint64_t(Product >> 64);
+#else
+  // First calculate all of the cross products.
+  uint64_t LoLo = (Lhs & 0xFFFFFFFF) * (Rhs & 0xFFFFFFFF);
+  uint64_t HiLo = (Lhs >> 32) * (Rhs & 0xFFFFFFFF);
+  uint64_t LoHi = (Lhs & 0xFFFFFFFF) * (Rhs >> 32);
+  uint64_t HiHi = (Lhs >> 32) * (Rhs >> 32);
+
+  // Now add the products together. These will never overflow.
+  uint64_t Cross = (LoLo >> 32) + (HiLo & 0xFFFFFFFF) + LoHi;
+  uint64_t Upper = (HiLo >> 32) + (Cross >> 32) + HiHi;
+  uint64_t Lower = (Cross << 32) | (LoLo & 0xFFFFFFFF);
+
+  return Upper ^ Lower;
+#endif
+}
+
+static uint64_t XXH64_avalanche(uint64_t Hash) {
+  Hash ^= Hash >> 33;
+  Hash *= PRIME64_2;
+  Hash ^= Hash >> 29;
+  Hash *= PRIME64_3;
+  Hash ^= Hash >> 32;
+  return Hash;
+}
+
+static uint64_t XXH3_avalanche(uint64_t Hash) {
+  Hash ^= Hash >> 37;
+  Hash *= PRIME_MX1;
+  Hash ^= Hash >> 32;
+  return Hash;
+}
+
+static uint64_t XXH3_len_1to3_64b(const uint8_t *Input, size_t Len,
+                                  const uint8_t *Secret) {
+  const uint8_t C1 = Input[0];
+  const uint8_t C2 = Input[Len >> 1];
+  const uint8_t C3 = Input[Len - 1];
+  uint32_t Combined = ((uint32_t)C1 << 16) | ((uint32_t)C2 << 24) |
+                      ((uint32_t)C3 << 0) | ((uint32_t)Len << 8);
+  uint64_t Bitflip =
+      (uint64_t)(endian::read32le(Secret) ^ endian::read32le(Secret + 4));
+  return XXH64_avalanche(uint64_t(Combined) ^ Bitflip);
+}
+
+static uint64_t XXH3_len_4to8_64b(const uint8_t *Input, size_t Len,
+                                  const uint8_t *Secret) {
+  uint32_t Input1 = endian::read32le(Input);
+  uint32_t Input2 = endian::read32le(Input + Len - 4);
+  uint64_t Acc = endian::read64le(Secret + 8) ^ endian::read64le(Secret + 16);
+  uint64_t Input64 = (uint64_t)Input2 | ((uint64_t)Input1 << 32);
+  Acc ^= Input64;
+  // XXH3_rrmxmx(Acc, Len)
+  Acc ^= rotl64(Acc, 49) ^ rotl64(Acc, 24);
+  Acc *= PRIME_MX2;
+  Acc ^= (Acc >> 35) + (uint64_t)Len;
+  Acc *= PRIME_MX2;
+  return Acc ^ (Acc >> 28);
+}
+
+static uint64_t XXH3_len_9to16_64b(const uint8_t *Input, size_t Len,
+                                   const uint8_t *Secret) {
+  uint64_t InputLo =
+      endian::read64le(Input) ^
+      (endian::read64le(Secret + 24) ^ endian::read64le(Secret + 32));
+  uint64_t InputHi =
+      endian::read64le(Input + Len - 8) ^
+      (endian::read64le(Secret + 40) ^ endian::read64le(Secret + 48));
+  uint64_t Acc = uint64_t(Len) + ByteSwap_64(InputLo) + InputHi +
+                 XXH3_mul128_fold64(InputLo, InputHi);
+  return XXH3_avalanche(Acc);
+}
+
+static uint64_t XXH3_len_0to16_64b(const uint8_t *Input, size_t Len,
+                                   const uint8_t *Secret) {
+  if (Len > 8)
+    return XXH3_len_9to16_64b(Input, Len, Secret);
+  if (Len >= 4)
+    return XXH3_len_4to8_64b(Input, Len, Secret);
+  if (Len != 0)
+    return XXH3_len_1to3_64b(Input, Len, Secret);
+  return XXH64_avalanche(endian::read64le(Secret + 56) ^
+                         endian::read64le(Secret + 64));
+}
+
+static uint64_t XXH3_mix16B(const uint8_t *Input, uint8_t const *Secret) {
+  uint64_t Lhs = endian::read64le(Input) ^ endian::read64le(Secret);
+  uint64_t Rhs = endian::read64le(Input + 8) ^ endian::read64le(Secret + 8);
+  return XXH3_mul128_fold64(Lhs, Rhs);
+}
+
+// For mid range keys, XXH3 uses a Mum-hash variant.
+static uint64_t XXH3_len_17to128_64b(const uint8_t *Input, size_t Len,
+                                     const uint8_t *Secret) {
+  uint64_t Acc = Len * PRIME64_1;
+  if (Len > 32) {
+    if (Len > 64) {
+      if (Len > 96) {
+        Acc += XXH3_mix16B(Input + 48, Secret + 96);
+        Acc += XXH3_mix16B(Input + Len - 64, Secret + 112);
+      }
+      Acc += XXH3_mix16B(Input + 32, Secret + 64);
+      Acc += XXH3_mix16B(Input + Len - 48, Secret + 80);
+    }
+    Acc += XXH3_mix16B(Input + 16, Secret + 32);
+    Acc += XXH3_mix16B(Input + Len - 32, Secret + 48);
+  }
+  Acc += XXH3_mix16B(Input + 0, Secret + 0);
+  Acc += XXH3_mix16B(Input + Len - 16, Secret + 16);
+  return XXH3_avalanche(Acc);
+}
+
+static uint64_t XXH3_len_129to240_64b(const uint8_t *Input, size_t Len,
+                                      const uint8_t *Secret) {
+  constexpr size_t XXH3_MIDSIZE_STARTOFFSET = 3;
+  constexpr size_t XXH3_MIDSIZE_LASTOFFSET = 17;
+  uint64_t Acc = (uint64_t)Len * PRIME64_1;
+  const unsigned NbRounds = Len / 16;
+  for (unsigned I = 0; I < 8; ++I)
+    Acc += XXH3_mix16B(Input + 16 * I, Secret + 16 * I);
+  Acc = XXH3_avalanche(Acc);
+
+  for (unsigned I = 8; I < NbRounds; ++I) {
+    Acc += XXH3_mix16B(Input + 16 * I,
+                       Secret + 16 * (I - 8) + XXH3_MIDSIZE_STARTOFFSET);
+  }
+  // Last bytes
+  Acc += XXH3_mix16B(Input + Len - 16,
+                     Secret + XXH3_SECRETSIZE_MIN - XXH3_MIDSIZE_LASTOFFSET);
+  return XXH3_avalanche(Acc);
+}
+
+// This is the hot loop for large inputs. It is written with plain loops over
+// the eight 64-bit lanes so that compilers turn it into SIMD code.
+static void XXH3_accumulate_512_scalar(uint64_t *Acc, const uint8_t *Input,
+                                       const uint8_t *Secret) {
+  for (size_t I = 0; I < XXH3_ACC_NB; ++I) {
+    uint64_t DataVal = endian::read64le(Input + 8 * I);
+    uint64_t DataKey = DataVal ^ endian::read64le(Secret + 8 * I);
+    Acc[I ^ 1] += DataVal;
+    Acc[I] += uint32_t(DataKey) * (DataKey >> 32);
+  }
+}
+
+static void XXH3_accumulate_scalar(uint64_t *Acc, const uint8_t *Input,
+                                   const uint8_t *Secret, size_t NbStripes) {
+  for (size_t N = 0; N < NbStripes; ++N)
+    XXH3_accumulate_512_scalar(Acc, Input + N * XXH3_STRIPE_LEN,
+                               Secret + N * XXH3_SECRET_CONSUME_RATE);
+}
+
+static void XXH3_scrambleAcc(uint64_t *Acc, const uint8_t *Secret) {
+  for (size_t I = 0; I < XXH3_ACC_NB; ++I) {
+    Acc[I] ^= Acc[I] >> 47;
+    Acc[I] ^= endian::read64le(Secret + 8 * I);
+    Acc[I] *= PRIME32_1;
+  }
+}
+
+static uint64_t XXH3_mix2Accs(const uint64_t *Acc, const uint8_t *Secret) {
+  return XXH3_mul128_fold64(Acc[0] ^ endian::read64le(Secret),
+                            Acc[1] ^ endian::read64le(Secret + 8));
+}
+
+static uint64_t XXH3_mergeAccs(const uint64_t *Acc, const uint8_t *Key,
+                               uint64_t Start) {
+  uint64_t Result64 = Start;
+  for (size_t I = 0; I < 4; ++I)
+    Result64 += XXH3_mix2Accs(Acc + 2 * I, Key + 16 * I);
+  return XXH3_avalanche(Result64);
+}
+
+LLVM_ATTRIBUTE_NOINLINE
+static uint64_t XXH3_hashLong_64b(const uint8_t *Input, size_t Len,
+                                  const uint8_t *Secret, size_t SecretSize) {
+  const size_t NbStripesPerBlock =
+      (SecretSize - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE;
+  const size_t BlockLen = XXH3_STRIPE_LEN * NbStripesPerBlock;
+  const size_t NbBlocks = (Len - 1) / BlockLen;
+  alignas(16) uint64_t Acc[XXH3_ACC_NB] = {
+      PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+      PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1,
+  };
+  for (size_t N = 0; N < NbBlocks; ++N) {
+    XXH3_accumulate_scalar(Acc, Input + N * BlockLen, Secret,
+                           NbStripesPerBlock);
+    XXH3_scrambleAcc(Acc, Secret + SecretSize - XXH3_STRIPE_LEN);
+  }
+
+  // Last partial block
+  const size_t NbStripes = (Len - 1 - (BlockLen * NbBlocks)) / XXH3_STRIPE_LEN;
+  assert(NbStripes <= SecretSize / XXH3_SECRET_CONSUME_RATE);
+  XXH3_accumulate_scalar(Acc, Input + NbBlocks * BlockLen, Secret, NbStripes);
+
+  // Last stripe
+  XXH3_accumulate_512_scalar(Acc, Input + Len - XXH3_STRIPE_LEN,
+                             Secret + SecretSize - XXH3_STRIPE_LEN -
+                                 XXH3_SECRET_LASTACC_START);
+
+  // Converge into final hash
+  return XXH3_mergeAccs(Acc, Secret + XXH3_SECRET_MERGEACCS_START,
+                        (uint64_t)Len * PRIME64_1);
+}
+
+uint64_t llvm::xxh3_64bits(ArrayRef<uint8_t> Data) {
+  auto *In = Data.data();
+  size_t Len = Data.size();
+  if (Len <= 16)
+    return XXH3_len_0to16_64b(In, Len, Kkey);
+  if (Len <= 128)
+    return XXH3_len_17to128_64b(In, Len, Kkey);
+  if (Len <= XXH3_MIDSIZE_MAX)
+    return XXH3_len_129to240_64b(In, Len, Kkey);
+  return XXH3_hashLong_64b(In, Len, Kkey, sizeof(Kkey));
+}
@@ -16,7 +16,9 @@
 
 #include "llvm/TableGen/Main.h"
 #include "TGParser.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -24,13 +26,23 @@
 #include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Record.h"
 #include <algorithm>
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <system_error>
+#if LLVM_ON_UNIX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 using namespace llvm;
 
-static cl::opt<std::string>
-OutputFilename("o", cl::desc("Output filename"), cl::value_desc("filename"),
-               cl::init("-"));
+static cl::list<std::string>
+OutputFilenames("o", cl::desc("Output filename, one for each backend"),
+                cl::value_desc("filename"));
+
+static cl::opt<unsigned>
+NumJobs("j", cl::desc("Number of backends to run in parallel"),
+        cl::init(1));
 
 static cl::opt<std::string>
 DependFilename("d",
@@ -59,8 +71,9 @@ static int reportError(const char *ProgName, Twine Msg) {
 ///
 /// This functionality is really only for the benefit of the build system.
 /// It is similar to GCC's `-M*` family of options.
-static int createDependencyFile(const TGParser &Parser, const char *argv0) {
-  if (OutputFilename == "-")
+static int createDependencyFile(const TGParser &Parser, const char *argv0,
+                                ArrayRef<std::string> Outputs) {
+  if (llvm::is_contained(Outputs, "-"))
     return reportError(argv0, "the option -d must be used together with -o\n");
 
   std::error_code EC;
@@ -68,7 +81,7 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   if (EC)
     return reportError(argv0, "error opening " + DependFilename + ":" +
                                   EC.message() + "\n");
-  DepOut.os() << OutputFilename << ":";
+  DepOut.os() << join(Outputs, " ") << ":";
   for (const auto &Dep : Parser.getDependencies()) {
     DepOut.os() << ' ' << Dep.first;
   }
@@ -77,43 +90,19 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
-int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
-  RecordKeeper Records;
-
-  // Parse the input file.
-  ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
-      MemoryBuffer::getFileOrSTDIN(InputFilename);
-  if (std::error_code EC = FileOrErr.getError())
-    return reportError(argv0, "Could not open input file '" + InputFilename +
-                                  "': " + EC.message() + "\n");
-
-  // Tell SrcMgr about this buffer, which is what TGParser will pick up.
-  SrcMgr.AddNewSourceBuffer(std::move(*FileOrErr), SMLoc());
-
-  // Record the location of the include directory so that the lexer can find
-  // it later.
-  SrcMgr.setIncludeDirs(IncludeDirs);
-
-  TGParser Parser(SrcMgr, MacroNames, Records);
-
-  if (Parser.ParseFile())
-    return 1;
+using BackendFn =
+    function_ref<bool(raw_ostream &OS, RecordKeeper &Records, unsigned)>;
 
+/// Run backend number \p Backend and write its output to \p OutputFilename.
+static int runBackend(const char *argv0, RecordKeeper &Records,
+                      BackendFn MainFn, unsigned Backend,
+                      StringRef OutputFilename) {
   // Write output to memory.
   std::string OutString;
   raw_string_ostream Out(OutString);
-  if (MainFn(Out, Records))
+  if (MainFn(Out, Records, Backend))
     return 1;
 
-  // Always write the depfile, even if the main output hasn't changed.
-  // If it's missing, Ninja considers the output dirty.  If this was below
-  // the early exit below and someone deleted the .inc.d file but not the .inc
-  // file, tablegen would never write the depfile.
-  if (!DependFilename.empty()) {
-    if (int Ret = createDependencyFile(Parser, argv0))
-      return Ret;
-  }
-
   // Only updates the real output file if there are any differences.
   // This prevents recompilation of all the files depending on it if there
   // aren't any.
@@ -135,3 +124,103 @@ int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
   OutFile.keep();
   return 0;
 }
+
+#if LLVM_ON_UNIX
+/// Wait for a backend process to finish, and return its exit code.
+static int waitForBackend() {
+  int Status;
+  while (wait(&Status) < 0)
+    if (errno != EINTR)
+      return 1;
+  return WIFEXITED(Status) ? WEXITSTATUS(Status) : 1;
+}
+#endif
+
+static int runTableGen(char *argv0, unsigned NumBackends, BackendFn MainFn) {
+  std::vector<std::string> Outputs(OutputFilenames.begin(),
+                                   OutputFilenames.end());
+  if (Outputs.empty())
+    Outputs.push_back("-");
+  if (Outputs.size() != NumBackends)
+    return reportError(argv0, "expected one output file for each of the " +
+                                  Twine(NumBackends) + " backends\n");
+
+  RecordKeeper Records;
+
+  // Parse the input file.
+  ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
+      MemoryBuffer::getFileOrSTDIN(InputFilename);
+  if (std::error_code EC = FileOrErr.getError())
+    return reportError(argv0, "Could not open input file '" + InputFilename +
+                                  "': " + EC.message() + "\n");
+
+  // Tell SrcMgr about this buffer, which is what TGParser will pick up.
+  SrcMgr.AddNewSourceBuffer(std::move(*FileOrErr), SMLoc());
+
+  // Record the location of the include directory so that the lexer can find
+  // it later.
+  SrcMgr.setIncludeDirs(IncludeDirs);
+
+  TGParser Parser(SrcMgr, MacroNames, Records);
+
+  if (Parser.ParseFile())
+    return 1;
+
+#if LLVM_ON_UNIX
+  // Once the input is parsed, every backend runs in a process of its own:
+  // the records are parsed only once for all of them, the backends cannot see
+  // each other's changes to the records, and up to -j of them run at once.
+  if (NumBackends > 1) {
+    outs().flush();
+    errs().flush();
+    unsigned Running = 0;
+    int Ret = 0;
+    for (unsigned I = 0; I != NumBackends; ++I) {
+      if (Running == std::max(1u, unsigned(NumJobs))) {
+        Ret |= waitForBackend();
+        --Running;
+      }
+      pid_t Pid = fork();
+      if (Pid < 0) {
+        Ret = reportError(argv0, "cannot fork: " +
+                                     Twine(std::strerror(errno)) + "\n");
+        break;
+      }
+      if (Pid == 0) {
+        int BackendRet = runBackend(argv0, Records, MainFn, I, Outputs[I]);
+        outs().flush();
+        errs().flush();
+        _exit(BackendRet);
+      }
+      ++Running;
+    }
+    for (; Running; --Running)
+      Ret |= waitForBackend();
+    if (Ret)
+      return 1;
+  } else
+#endif
+  {
+    // Elsewhere, the backends run one after the other on the same records.
+    for (unsigned I = 0; I != NumBackends; ++I)
+      if (int Ret = runBackend(argv0, Records, MainFn, I, Outputs[I]))
+        return Ret;
+  }
+
+  // The outputs are only written when they change, but the depfile is always
+  // written: if it's missing, Ninja considers the outputs dirty.
+  if (!DependFilename.empty())
+    return createDependencyFile(Parser, argv0, Outputs);
+  return 0;
+}
+
+int llvm::TableGenMain(char *argv0, TableGenMainFn *MainFn) {
+  return runTableGen(argv0, 1,
+                     [MainFn](raw_ostream &OS, RecordKeeper &Records,
+                              unsigned) { return MainFn(OS, Records); });
+}
+
+int llvm::TableGenMain(char *argv0, unsigned NumBackends,
+                       TableGenMultiMainFn *MainFn) {
+  return runTableGen(argv0, NumBackends, MainFn);
+}
@@ -13,6 +13,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/FoldingSet.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -354,6 +355,8 @@ BitsInit *BitsInit::get(ArrayRef<Init *> Range) {
   BitsInit *I = new(Mem) BitsInit(Range.size());
   std::uninitialized_copy(Range.begin(), Range.end(),
                           I->getTrailingObjects<Init *>());
+  I->Concrete = llvm::all_of(
+      Range, [](const Init *Bit) { return Bit && Bit->isConcrete(); });
   ThePool.InsertNode(I, IP);
   return I;
 }
@@ -400,14 +403,6 @@ BitsInit::convertInitializerBitRange(ArrayRef<unsigned> Bits) const {
   return BitsInit::get(NewBits);
 }
 
-bool BitsInit::isConcrete() const {
-  for (unsigned i = 0, e = getNumBits(); i != e; ++i) {
-    if (!getBit(i)->isConcrete())
-      return false;
-  }
-  return true;
-}
-
 std::string BitsInit::getAsString() const {
   std::string Result = "{ ";
   for (unsigned i = 0, e = getNumBits(); i != e; ++i) {
@@ -423,6 +418,10 @@ std::string BitsInit::getAsString() const {
 // resolveReferences - If there are any field references that refer to fields
 // that have been filled in, we can propagate the values now.
 Init *BitsInit::resolveReferences(Resolver &R) const {
+  // Concrete values have nothing left to resolve.
+  if (Concrete)
+    return const_cast<BitsInit *>(this);
+
   bool Changed = false;
   SmallVector<Init *, 16> NewBits(getNumBits());
 
@@ -585,6 +584,8 @@ ListInit *ListInit::get(ArrayRef<Init *> Range, RecTy *EltTy) {
   ListInit *I = new(Mem) ListInit(Range.size(), EltTy);
   std::uninitialized_copy(Range.begin(), Range.end(),
                           I->getTrailingObjects<Init *>());
+  I->Concrete = llvm::all_of(
+      Range, [](const Init *Element) { return Element->isConcrete(); });
   ThePool.InsertNode(I, IP);
   return I;
 }
@@ -643,6 +644,10 @@ Record *ListInit::getElementAsRecord(unsigned i) const {
 }
 
 Init *ListInit::resolveReferences(Resolver &R) const {
+  // Concrete values have nothing left to resolve.
+  if (Concrete)
+    return const_cast<ListInit *>(this);
+
   SmallVector<Init*, 8> Resolved;
   Resolved.reserve(size());
   bool Changed = false;
@@ -658,14 +663,6 @@ Init *ListInit::resolveReferences(Resolver &R) const {
   return const_cast<ListInit *>(this);
 }
 
-bool ListInit::isConcrete() const {
-  for (Init *Element : *this) {
-    if (!Element->isConcrete())
-      return false;
-  }
-  return true;
-}
-
 std::string ListInit::getAsString() const {
   std::string Result = "[";
   const char *sep = "";
@@ -1908,6 +1905,10 @@ DagInit::get(Init *V, StringInit *VN, ArrayRef<Init *> ArgRange,
                           I->getTrailingObjects<Init *>());
   std::uninitialized_copy(NameRange.begin(), NameRange.end(),
                           I->getTrailingObjects<StringInit *>());
+  I->Concrete = V->isConcrete() &&
+                llvm::all_of(ArgRange, [](const Init *Arg) {
+                  return Arg->isConcrete();
+                });
   ThePool.InsertNode(I, IP);
   return I;
 }
@@ -1931,6 +1932,10 @@ void DagInit::Profile(FoldingSetNodeID &ID) const {
 }
 
 Init *DagInit::resolveReferences(Resolver &R) const {
+  // Concrete values have nothing left to resolve.
+  if (Concrete)
+    return const_cast<DagInit *>(this);
+
   SmallVector<Init*, 8> NewArgs;
   NewArgs.reserve(arg_size());
   bool ArgsChanged = false;
@@ -1947,16 +1952,6 @@ Init *DagInit::resolveReferences(Resolver &R) const {
   return const_cast<DagInit *>(this);
 }
 
-bool DagInit::isConcrete() const {
-  if (!Val->isConcrete())
-    return false;
-  for (const Init *Elt : getArgs()) {
-    if (!Elt->isConcrete())
-      return false;
-  }
-  return true;
-}
-
 std::string DagInit::getAsString() const {
   std::string Result = "(" + Val->getAsString();
   if (ValName)
@@ -166,6 +166,13 @@ void X86LegalizerInfo::setLegalizerInfo32bit() {
   // Control-flow
   setAction({G_BRCOND, s1}, Legal);
 
+  // Select
+  if (!Subtarget.is64Bit() && Subtarget.hasCMov())
+    getActionDefinitionsBuilder(G_SELECT)
+        .legalFor({{s16, s1}, {s32, s1}, {p0, s1}})
+        .clampScalar(0, s16, s32)
+        .widenScalarToNextPow2(0);
+
   // Constants
   for (auto Ty : {s8, s16, s32, p0})
     setAction({TargetOpcode::G_CONSTANT, Ty}, Legal);
@@ -252,6 +259,12 @@ void X86LegalizerInfo::setLegalizerInfo64bit() {
       .clampScalar(0, s32, s64)
       .widenScalarToNextPow2(1);
 
+  // Select
+  getActionDefinitionsBuilder(G_SELECT)
+      .legalFor({{s16, s1}, {s32, s1}, {s64, s1}, {p0, s1}})
+      .clampScalar(0, s16, s64)
+      .widenScalarToNextPow2(0);
+
   // Comparison
   setAction({G_ICMP, 1, s64}, Legal);
 
@@ -15,6 +15,7 @@
 
 #include "llvm/Transforms/IPO/Attributor.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DepthFirstIterator.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallPtrSet.h"
@@ -32,6 +33,7 @@
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/Local.h"
@@ -48,6 +50,9 @@ STATISTIC(NumFnWithoutExactDefinition,
           "Number of function without exact definitions");
 STATISTIC(NumAttributesTimedOut,
           "Number of abstract attributes timed out before fixpoint");
+STATISTIC(NumAttributesOverBudget,
+          "Number of abstract attributes fixed when their function exceeded "
+          "its update budget");
 STATISTIC(NumAttributesValidFixpoint,
           "Number of abstract attributes in a valid fixpoint state");
 STATISTIC(NumAttributesManifested,
@@ -109,6 +114,12 @@ static cl::opt<unsigned>
     MaxFixpointIterations("attributor-max-iterations", cl::Hidden,
                           cl::desc("Maximal number of fixpoint iterations."),
                           cl::init(32));
+static cl::opt<unsigned> MaxUpdatesPerFunction(
+    "attributor-max-updates-per-function", cl::Hidden,
+    cl::desc("Maximal number of updates of the abstract attributes of a "
+             "function before they are fixed pessimistically (0 = unlimited)"),
+    cl::init(0));
+
 static cl::opt<bool> VerifyMaxFixpointIterations(
     "attributor-max-iterations-verify", cl::Hidden,
     cl::desc("Verify that max-iterations is a tight bound for a fixpoint"),
@@ -3352,6 +3363,11 @@ ChangeStatus Attributor::run(Module &M) {
 
   bool RecomputeDependences = false;
 
+  // The number of updates of the abstract attributes of each function, for
+  // the update budget.
+  DenseMap<const Function *, unsigned> NumUpdates;
+
+  TimeTraceScope TimeScope("AttributorFixpoint", M.getName());
   do {
     // Remember the size to determine new attributes.
     size_t NumAAs = AllAbstractAttributes.size();
@@ -3385,10 +3401,32 @@ ChangeStatus Attributor::run(Module &M) {
 
     // Update all abstract attribute in the work list and record the ones that
     // changed.
-    for (AbstractAttribute *AA : Worklist)
-      if (!isAssumedDead(*AA, nullptr))
-        if (AA->update(*this) == ChangeStatus::CHANGED)
+    for (AbstractAttribute *AA : Worklist) {
+      if (isAssumedDead(*AA, nullptr))
+        continue;
+      // Once the attributes of a function used up their budget, give up on the
+      // ones that aren't settled. The dependent attributes are updated again
+      // as this one changed.
+      if (MaxUpdatesPerFunction &&
+          ++NumUpdates[AA->getIRPosition().getAnchorScope()] >
+              MaxUpdatesPerFunction) {
+        AbstractState &State = AA->getState();
+        if (!State.isAtFixpoint()) {
+          State.indicatePessimisticFixpoint();
           ChangedAAs.push_back(AA);
+          NumAttributesOverBudget++;
+        }
+        continue;
+      }
+      TimeTraceScope UpdateScope("AttributorUpdate", [&]() {
+        std::string Str;
+        raw_string_ostream OS(Str);
+        AA->print(OS);
+        return OS.str();
+      });
+      if (AA->update(*this) == ChangeStatus::CHANGED)
+        ChangedAAs.push_back(AA);
+    }
 
     // Check if we recompute the dependences in the next iteration.
     RecomputeDependences = (DepRecomputeInterval > 0 &&
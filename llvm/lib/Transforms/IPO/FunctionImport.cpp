@@ -42,13 +42,17 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 #include "llvm/Transforms/Utils/ValueMapper.h"
 #include <cassert>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <system_error>
@@ -83,6 +87,11 @@ static cl::opt<int> ImportCutoff(
     "import-cutoff", cl::init(-1), cl::Hidden, cl::value_desc("N"),
     cl::desc("Only import first N functions if N>=0 (default -1)"));
 
+static cl::opt<unsigned> ImportThreads(
+    "import-threads", cl::init(0), cl::Hidden, cl::value_desc("N"),
+    cl::desc("Compute the imports of the modules in the thin link on N "
+             "threads (default 0 = hardware concurrency)"));
+
 static cl::opt<float>
     ImportInstrFactor("import-instr-evolution-factor", cl::init(0.7),
                       cl::Hidden, cl::value_desc("x"),
@@ -353,7 +362,8 @@ static void computeImportForFunction(
     FunctionImporter::ImportThresholdsTy &ImportThresholds) {
   computeImportForReferencedGlobals(Summary, DefinedGVSummaries, ImportList,
                                     ExportLists);
-  static int ImportCount = 0;
+  // Modules may be processed on several threads, see ComputeCrossModuleImport.
+  static std::atomic<int> ImportCount(0);
   for (auto &Edge : Summary.calls()) {
     ValueInfo VI = Edge.first;
     LLVM_DEBUG(dbgs() << " edge -> " << VI << " Threshold:" << Threshold
@@ -614,36 +624,86 @@ static unsigned numGlobalVarSummaries(const ModuleSummaryIndex &Index,
 }
 #endif
 
+/// Remove from \p ExportList the GUIDs not defined in module \p ModulePath.
+static void
+pruneExportList(FunctionImporter::ExportSetTy &ExportList, StringRef ModulePath,
+                const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries) {
+  auto DefinedIt = ModuleToDefinedGVSummaries.find(ModulePath);
+  if (DefinedIt == ModuleToDefinedGVSummaries.end()) {
+    ExportList.clear();
+    return;
+  }
+  const GVSummaryMapTy &DefinedGVSummaries = DefinedIt->second;
+  for (auto EI = ExportList.begin(); EI != ExportList.end();) {
+    if (!DefinedGVSummaries.count(*EI))
+      EI = ExportList.erase(EI);
+    else
+      ++EI;
+  }
+}
+
 /// Compute all the import and export for every module using the Index.
 void llvm::ComputeCrossModuleImport(
     const ModuleSummaryIndex &Index,
     const StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries,
     StringMap<FunctionImporter::ImportMapTy> &ImportLists,
     StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
-  // For each module that has function defined, compute the import/export lists.
-  for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
-    auto &ImportList = ImportLists[DefinedGVSummaries.first()];
-    LLVM_DEBUG(dbgs() << "Computing import for Module '"
-                      << DefinedGVSummaries.first() << "'\n");
-    ComputeImportForModule(DefinedGVSummaries.second, Index,
-                           DefinedGVSummaries.first(), ImportList,
-                           &ExportLists);
-  }
+  unsigned ThreadCount =
+      ImportThreads ? ImportThreads : heavyweight_hardware_concurrency();
+  ThreadCount = std::min<size_t>(ThreadCount, ModuleToDefinedGVSummaries.size());
+  // The debugging output and the import cutoff depend on the order in which
+  // the modules are processed, so keep it deterministic when they are used.
+  bool Serial = ThreadCount <= 1 || ImportCutoff >= 0 || PrintImportFailures ||
+                (DebugFlag && isCurrentDebugType(DEBUG_TYPE));
+
+  if (Serial) {
+    // For each module that has function defined, compute the import/export
+    // lists.
+    for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
+      auto &ImportList = ImportLists[DefinedGVSummaries.first()];
+      LLVM_DEBUG(dbgs() << "Computing import for Module '"
+                        << DefinedGVSummaries.first() << "'\n");
+      ComputeImportForModule(DefinedGVSummaries.second, Index,
+                             DefinedGVSummaries.first(), ImportList,
+                             &ExportLists);
+    }
 
-  // When computing imports we added all GUIDs referenced by anything
-  // imported from the module to its ExportList. Now we prune each ExportList
-  // of any not defined in that module. This is more efficient than checking
-  // while computing imports because some of the summary lists may be long
-  // due to linkonce (comdat) copies.
-  for (auto &ELI : ExportLists) {
-    const auto &DefinedGVSummaries =
-        ModuleToDefinedGVSummaries.lookup(ELI.first());
-    for (auto EI = ELI.second.begin(); EI != ELI.second.end();) {
-      if (!DefinedGVSummaries.count(*EI))
-        EI = ELI.second.erase(EI);
-      else
-        ++EI;
+    // When computing imports we added all GUIDs referenced by anything
+    // imported from the module to its ExportList. Now we prune each ExportList
+    // of any not defined in that module. This is more efficient than checking
+    // while computing imports because some of the summary lists may be long
+    // due to linkonce (comdat) copies.
+    for (auto &ELI : ExportLists)
+      pruneExportList(ELI.second, ELI.first(), ModuleToDefinedGVSummaries);
+  } else {
+    // The import list of a module only depends on the index, so the modules
+    // are independent. Each task only touches the import list of its module,
+    // which is created before the task starts. A task collects the exports
+    // its module causes in a private map, prunes them and only then merges
+    // them into ExportLists, which keeps the unpruned sets small.
+    std::mutex ExportListsMutex;
+    ThreadPool Pool(ThreadCount);
+    for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
+      auto &ImportList = ImportLists[DefinedGVSummaries.first()];
+      Pool.async([&]() {
+        StringMap<FunctionImporter::ExportSetTy> ModuleExportLists;
+        ComputeImportForModule(DefinedGVSummaries.second, Index,
+                               DefinedGVSummaries.first(), ImportList,
+                               &ModuleExportLists);
+        for (auto &ELI : ModuleExportLists)
+          pruneExportList(ELI.second, ELI.first(), ModuleToDefinedGVSummaries);
+
+        std::lock_guard<std::mutex> Lock(ExportListsMutex);
+        for (auto &ELI : ModuleExportLists) {
+          auto &ExportList = ExportLists[ELI.first()];
+          if (ExportList.empty())
+            ExportList = std::move(ELI.second);
+          else
+            ExportList.insert(ELI.second.begin(), ELI.second.end());
+        }
+      });
     }
+    Pool.wait();
   }
 
 #ifndef NDEBUG
@@ -28,6 +28,7 @@
 #include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
 #include "llvm/Analysis/CallGraph.h"
+#include "llvm/Analysis/InlineAdvisor.h"
 #include "llvm/Analysis/InlineCost.h"
 #include "llvm/Analysis/LazyCallGraph.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
@@ -120,6 +121,12 @@ static cl::opt<bool>
                                    " callsites processed by inliner but decided"
                                    " to be not inlined"));
 
+/// Flag to log the decisions of the inline cost model, to train models with.
+static cl::opt<std::string> InlineDecisionLog(
+    "inline-decision-log", cl::Hidden,
+    cl::desc("Append the features, the decision and the outcome of the call "
+             "sites the inline cost model weighs to this file"));
+
 LegacyInlinerBase::LegacyInlinerBase(char &ID) : CallGraphSCCPass(ID) {}
 
 LegacyInlinerBase::LegacyInlinerBase(char &ID, bool InsertLifetime)
@@ -477,6 +484,38 @@ shouldInline(CallSite CS, function_ref<InlineCost(CallSite CS)> GetInlineCost,
   return IC;
 }
 
+/// Returns the advisor to use when none was set: one that logs the decisions
+/// of the cost model if requested, or null to just follow the cost model.
+static std::unique_ptr<InlineAdvisor> getDefaultInlineAdvisor() {
+  if (InlineDecisionLog.empty())
+    return nullptr;
+  return InlineDecisionLogger::create(InlineDecisionLog,
+                                      std::make_unique<InlineAdvisor>());
+}
+
+/// Consults \p Advisor about the call site \p CS, if the decision \p OIC of
+/// the cost model was based on its cost, and updates the decision with the
+/// advice. Returns the features of the call site if the advisor was consulted.
+static Optional<InlineFeatures>
+consultInlineAdvisor(InlineAdvisor *Advisor, CallSite CS,
+                     Optional<InlineCost> &OIC, BlockFrequencyInfo *CallerBFI,
+                     ProfileSummaryInfo *PSI, unsigned SCCSize,
+                     bool CalleeInSameSCC) {
+  if (!Advisor || !OIC || !OIC->isVariable())
+    return None;
+  InlineFeatures Features =
+      getInlineFeatures(*cast<CallBase>(CS.getInstruction()), *OIC, CallerBFI,
+                        PSI, SCCSize, CalleeInSameSCC);
+  bool Advice = Advisor->shouldInline(Features);
+  if (Advice != bool(*OIC)) {
+    LLVM_DEBUG(dbgs() << "    Inline advisor overrides the cost model: "
+                      << (Advice ? "inlining" : "not inlining") << "\n");
+    OIC = Advice ? InlineCost::getAlways("advised by the inline advisor")
+                 : InlineCost::getNever("not advised by the inline advisor");
+  }
+  return Features;
+}
+
 /// Return true if the specified inline history ID
 /// indicates an inline history that includes the specified function.
 static bool InlineHistoryIncludes(
@@ -495,6 +534,8 @@ static bool InlineHistoryIncludes(
 bool LegacyInlinerBase::doInitialization(CallGraph &CG) {
   if (InlinerFunctionImportStats != InlinerFunctionImportStatsOpts::No)
     ImportedFunctionsStats.setModuleInfo(CG.getModule());
+  if (!Advisor)
+    Advisor = getDefaultInlineAdvisor();
   return false; // No changes to CallGraph.
 }
 
@@ -532,7 +573,8 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
                 bool InsertLifetime,
                 function_ref<InlineCost(CallSite CS)> GetInlineCost,
                 function_ref<AAResults &(Function &)> AARGetter,
-                ImportedFunctionsInliningStatistics &ImportedFunctionsStats) {
+                ImportedFunctionsInliningStatistics &ImportedFunctionsStats,
+                InlineAdvisor *Advisor) {
   SmallPtrSet<Function *, 8> SCCFunctions;
   LLVM_DEBUG(dbgs() << "Inliner visiting SCC:");
   for (CallGraphNode *Node : SCC) {
@@ -651,6 +693,13 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
       OptimizationRemarkEmitter ORE(Caller);
 
       Optional<InlineCost> OIC = shouldInline(CS, GetInlineCost, ORE);
+      Optional<InlineFeatures> Features = consultInlineAdvisor(
+          Advisor, CS, OIC, /*CallerBFI=*/nullptr, PSI, SCCFunctions.size(),
+          SCCFunctions.count(Callee));
+      auto RecordOutcome = [&](bool Inlined) {
+        if (Features)
+          Advisor->recordOutcome(*Features, bool(*OIC), Inlined);
+      };
       // If the policy determines that we should inline this function,
       // delete the call instead.
       if (!OIC.hasValue()) {
@@ -662,6 +711,7 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
         // shouldInline() call returned a negative inline cost that explains
         // why this callsite should not be inlined.
         setInlineRemark(CS, inlineCostStr(*OIC));
+        RecordOutcome(/*Inlined=*/false);
         continue;
       }
 
@@ -673,6 +723,7 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
         LLVM_DEBUG(dbgs() << "    -> Deleting dead call: " << *Instr << "\n");
         // Update the call graph by deleting the edge from Callee to Caller.
         setInlineRemark(CS, "trivially dead");
+        RecordOutcome(/*Inlined=*/false);
         CG[Caller]->removeCallEdgeFor(*cast<CallBase>(CS.getInstruction()));
         Instr->eraseFromParent();
         ++NumCallsDeleted;
@@ -687,6 +738,7 @@ inlineCallsImpl(CallGraphSCC &SCC, CallGraph &CG,
         InlineResult IR = InlineCallIfPossible(
             CS, InlineInfo, InlinedArrayAllocas, InlineHistoryID,
             InsertLifetime, AARGetter, ImportedFunctionsStats);
+        RecordOutcome(bool(IR));
         if (!IR) {
           setInlineRemark(CS, std::string(IR) + "; " + inlineCostStr(*OIC));
           ORE.emit([&]() {
@@ -768,7 +820,7 @@ bool LegacyInlinerBase::inlineCalls(CallGraphSCC &SCC) {
   return inlineCallsImpl(
       SCC, CG, GetAssumptionCache, PSI, GetTLI, InsertLifetime,
       [this](CallSite CS) { return getInlineCost(CS); }, LegacyAARGetter(*this),
-      ImportedFunctionsStats);
+      ImportedFunctionsStats, Advisor.get());
 }
 
 /// Remove now-dead linkonce functions at the end of
@@ -888,6 +940,9 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
     ImportedFunctionsStats->setModuleInfo(M);
   }
 
+  if (!Advisor)
+    Advisor = getDefaultInlineAdvisor();
+
   // We use a single common worklist for calls across the entire SCC. We
   // process these in-order and append new calls introduced during inlining to
   // the end.
@@ -1049,6 +1104,15 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       }
 
       Optional<InlineCost> OIC = shouldInline(CS, GetInlineCost, ORE);
+      Optional<InlineFeatures> Features;
+      if (Advisor)
+        Features = consultInlineAdvisor(
+            Advisor.get(), CS, OIC, &FAM.getResult<BlockFrequencyAnalysis>(F),
+            PSI, C->size(), CG.lookupSCC(*CG.lookup(Callee)) == C);
+      auto RecordOutcome = [&](bool Inlined) {
+        if (Features)
+          Advisor->recordOutcome(*Features, bool(*OIC), Inlined);
+      };
       // Check whether we want to inline this callsite.
       if (!OIC.hasValue()) {
         setInlineRemark(CS, "deferred");
@@ -1059,6 +1123,7 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
         // shouldInline() call returned a negative inline cost that explains
         // why this callsite should not be inlined.
         setInlineRemark(CS, inlineCostStr(*OIC));
+        RecordOutcome(/*Inlined=*/false);
         continue;
       }
 
@@ -1076,6 +1141,7 @@ PreservedAnalyses InlinerPass::run(LazyCallGraph::SCC &InitialC,
       using namespace ore;
 
       InlineResult IR = InlineFunction(CS, IFI);
+      RecordOutcome(bool(IR));
       if (!IR) {
         setInlineRemark(CS, std::string(IR) + "; " + inlineCostStr(*OIC));
         ORE.emit([&]() {
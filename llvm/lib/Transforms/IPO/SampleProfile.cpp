@@ -1636,7 +1636,10 @@ bool SampleProfileLoader::doInitialization(Module &M) {
     return false;
   }
   Reader = std::move(ReaderOrErr.get());
-  Reader->collectFuncsToUse(M);
+  // The remapped names of the module's functions are not known before the
+  // profile is read, so only narrow down the profile without remapping.
+  if (RemappingFilename.empty())
+    Reader->collectFuncsToUse(M);
   ProfileIsValid = (Reader->read() == sampleprof_error::success);
   PSL = Reader->getProfileSymbolList();
 
@@ -175,6 +175,11 @@ static cl::opt<bool> ClInlineAllChecks("hwasan-inline-all-checks",
                                        cl::desc("inline all checks"),
                                        cl::Hidden, cl::init(false));
 
+static cl::opt<bool> ClOptSameTemp(
+    "hwasan-opt-same-temp",
+    cl::desc("check the same pointer just once in a basic block, until a call"),
+    cl::Hidden, cl::init(true));
+
 namespace {
 
 /// An instrumentation pass implementing detection of addressability bugs
@@ -1097,11 +1102,16 @@ bool HWAddressSanitizer::sanitizeFunction(Function &F) {
   LLVM_DEBUG(dbgs() << "Function: " << F.getName() << "\n");
 
   SmallVector<Instruction*, 16> ToInstrument;
+  SmallVector<Instruction*, 16> ToUntag;
   SmallVector<AllocaInst*, 8> AllocasToInstrument;
   SmallVector<Instruction*, 8> RetVec;
   SmallVector<Instruction*, 8> LandingPadVec;
   DenseMap<AllocaInst *, std::vector<DbgDeclareInst *>> AllocaDeclareMap;
   for (auto &BB : F) {
+    // Pointers already checked in this block, with the size of the largest
+    // access checked. A call may free or retag the memory, so it forgets
+    // them all.
+    SmallDenseMap<Value *, uint64_t, 16> CheckedPtrs;
     for (auto &Inst : BB) {
       if (ClInstrumentStack)
         if (AllocaInst *AI = dyn_cast<AllocaInst>(&Inst)) {
@@ -1127,8 +1137,19 @@ bool HWAddressSanitizer::sanitizeFunction(Function &F) {
       uint64_t TypeSize;
       Value *Addr = isInterestingMemoryAccess(&Inst, &IsWrite, &TypeSize,
                                               &Alignment, &MaybeMask);
+      if (Addr && !MaybeMask && ClOptSameTemp) {
+        // The check of an access covers any smaller one at the same address.
+        uint64_t &CheckedSize = CheckedPtrs[Addr];
+        if (CheckedSize >= TypeSize) {
+          ToUntag.push_back(&Inst);
+          continue;
+        }
+        CheckedSize = TypeSize;
+      }
       if (Addr || isa<MemIntrinsic>(Inst))
         ToInstrument.push_back(&Inst);
+      if (isa<CallBase>(Inst) && !isa<DbgInfoIntrinsic>(Inst))
+        CheckedPtrs.clear();
     }
   }
 
@@ -1224,6 +1245,8 @@ bool HWAddressSanitizer::sanitizeFunction(Function &F) {
 
   for (auto Inst : ToInstrument)
     Changed |= instrumentMemAccess(Inst);
+  for (auto Inst : ToUntag)
+    untagPointerOperand(Inst, Inst->getOperand(getPointerOperandIndex(Inst)));
 
   LocalDynamicShadow = nullptr;
   StackBaseTag = nullptr;
@@ -35,6 +35,7 @@
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/Pass.h"
@@ -102,6 +103,18 @@ cl::opt<bool> AtomicCounterUpdateAll(
     cl::desc("Make all profile counter updates atomic (for testing only)"),
     cl::init(false));
 
+cl::opt<bool> SampledCounterUpdate(
+    "instrprof-sampled-counter-update", cl::ZeroOrMore,
+    cl::desc("Only update the profile counters once per sampling period, "
+             "counted down per thread, and scale the updates by the period"),
+    cl::init(false));
+
+cl::opt<bool> ThreadLocalCounters(
+    "instrprof-thread-local-counters", cl::ZeroOrMore,
+    cl::desc("Update per-thread copies of the profile counters, which the "
+             "runtime adds to the shared counters when writing the profile"),
+    cl::init(false));
+
 cl::opt<bool> AtomicCounterUpdatePromoted(
     "atomic-counter-update-promoted", cl::ZeroOrMore,
     cl::desc("Do counter update using atomic fetch add "
@@ -407,25 +420,30 @@ static InstrProfIncrementInst *castToIncrementInst(Instruction *Instr) {
 }
 
 bool InstrProfiling::lowerIntrinsics(Function *F) {
-  bool MadeChange = false;
   PromotionCandidates.clear();
+  ThreadCountersDelta = nullptr;
+  // Collect the intrinsics first, lowering sampled increments splits blocks.
+  SmallVector<InstrProfIncrementInst *, 16> Increments;
+  SmallVector<InstrProfValueProfileInst *, 4> ValueProfiles;
   for (BasicBlock &BB : *F) {
-    for (auto I = BB.begin(), E = BB.end(); I != E;) {
-      auto Instr = I++;
-      InstrProfIncrementInst *Inc = castToIncrementInst(&*Instr);
-      if (Inc) {
-        lowerIncrement(Inc);
-        MadeChange = true;
-      } else if (auto *Ind = dyn_cast<InstrProfValueProfileInst>(Instr)) {
-        lowerValueProfileInst(Ind);
-        MadeChange = true;
-      }
+    for (Instruction &Instr : BB) {
+      if (InstrProfIncrementInst *Inc = castToIncrementInst(&Instr))
+        Increments.push_back(Inc);
+      else if (auto *Ind = dyn_cast<InstrProfValueProfileInst>(&Instr))
+        ValueProfiles.push_back(Ind);
     }
   }
 
-  if (!MadeChange)
+  if (Increments.empty() && ValueProfiles.empty())
     return false;
 
+  if (ThreadLocalCounters && !Increments.empty())
+    ThreadCountersDelta = getThreadCountersDelta(F);
+  for (InstrProfIncrementInst *Inc : Increments)
+    lowerIncrement(Inc);
+  for (InstrProfValueProfileInst *Ind : ValueProfiles)
+    lowerValueProfileInst(Ind);
+
   promoteCounterLoadStores(F);
   return true;
 }
@@ -632,6 +650,60 @@ void InstrProfiling::lowerValueProfileInst(InstrProfValueProfileInst *Ind) {
   Ind->eraseFromParent();
 }
 
+GlobalVariable *InstrProfiling::getOrCreateRuntimeVar(StringRef Name,
+                                                     Type *Ty,
+                                                     bool IsThreadLocal) {
+  if (GlobalVariable *GV = M->getNamedGlobal(Name))
+    return GV;
+  auto *GV = new GlobalVariable(*M, Ty, /*isConstant=*/false,
+                                GlobalValue::ExternalLinkage, nullptr, Name);
+  // Each instrumented binary or shared library has its own runtime copy.
+  GV->setVisibility(GlobalValue::HiddenVisibility);
+  if (IsThreadLocal)
+    GV->setThreadLocalMode(GlobalValue::InitialExecTLSModel);
+  return GV;
+}
+
+Value *InstrProfiling::getThreadCountersDelta(Function *F) {
+  LLVMContext &Ctx = M->getContext();
+  Type *IntPtrTy = M->getDataLayout().getIntPtrType(Ctx);
+  GlobalVariable *DeltaVar = getOrCreateRuntimeVar(
+      getInstrProfThreadCountersDeltaVarName(), IntPtrTy, true);
+
+  // Static allocas have to stay in the entry block, or they become dynamic.
+  // Move those that are not at its start yet above the point where it is
+  // split; their sizes are constants, so nothing above them is needed.
+  BasicBlock &Entry = F->getEntryBlock();
+  BasicBlock::iterator IP = Entry.getFirstInsertionPt();
+  while (isa<AllocaInst>(IP) && cast<AllocaInst>(IP)->isStaticAlloca())
+    ++IP;
+  for (Instruction &I : make_early_inc_range(make_range(IP, Entry.end())))
+    if (auto *AI = dyn_cast<AllocaInst>(&I))
+      if (AI->isStaticAlloca())
+        AI->moveBefore(&*IP);
+
+  // The delta is zero until the counters of the thread are allocated, so a
+  // thread whose allocation failed keeps updating the shared counters.
+  IRBuilder<> Builder(&*IP);
+  LoadInst *Delta = Builder.CreateLoad(IntPtrTy, DeltaVar, "pgodelta");
+  Instruction *InitTerm = SplitBlockAndInsertIfThen(
+      Builder.CreateIsNull(Delta), &*IP, /*Unreachable=*/false,
+      MDBuilder(Ctx).createBranchWeights(1, (1U << 20) - 1));
+  Builder.SetInsertPoint(InitTerm);
+  FunctionCallee InitF = M->getOrInsertFunction(
+      getInstrProfThreadCountersInitFuncName(), IntPtrTy);
+  CallInst *NewDelta = Builder.CreateCall(InitF, {});
+  if (Options.NoRedZone)
+    NewDelta->addAttribute(AttributeList::FunctionIndex,
+                           Attribute::NoRedZone);
+
+  Builder.SetInsertPoint(&IP->getParent()->front());
+  PHINode *Phi = Builder.CreatePHI(IntPtrTy, 2, "pgodelta");
+  Phi->addIncoming(Delta, Delta->getParent());
+  Phi->addIncoming(NewDelta, InitTerm->getParent());
+  return Phi;
+}
+
 void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
   GlobalVariable *Counters = getOrCreateRegionCounters(Inc);
 
@@ -639,16 +711,57 @@ void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
   uint64_t Index = Inc->getIndex()->getZExtValue();
   Value *Addr = Builder.CreateConstInBoundsGEP2_64(Counters->getValueType(),
                                                    Counters, 0, Index);
+  Value *IncStep = Inc->getStep();
+  // Only plain updates of the shared counters are promoted.
+  bool Promote = isCounterPromotionEnabled();
+
+  if (ThreadCountersDelta) {
+    // The counters of the thread are laid out like the shared counters.
+    Type *Int8PtrTy = Builder.getInt8PtrTy();
+    Value *ThreadAddr = Builder.CreateGEP(
+        Builder.getInt8Ty(), Builder.CreateBitCast(Addr, Int8PtrTy),
+        ThreadCountersDelta);
+    Addr = Builder.CreateBitCast(ThreadAddr, Addr->getType());
+    Promote = false;
+  }
+
+  if (SampledCounterUpdate) {
+    // Count down on every pass, and update the counter by Step * Period
+    // when the countdown reaches zero:
+    //   if (countdown-- == 0) {
+    //     countdown = period - 1;
+    //     counter += step * period;
+    //   }
+    LLVMContext &Ctx = M->getContext();
+    Type *Int32Ty = Builder.getInt32Ty();
+    GlobalVariable *CountdownVar = getOrCreateRuntimeVar(
+        getInstrProfSamplingCountdownVarName(), Int32Ty, true);
+    GlobalVariable *PeriodVar = getOrCreateRuntimeVar(
+        getInstrProfSamplingPeriodVarName(), Int32Ty, false);
+    LoadInst *Countdown =
+        Builder.CreateLoad(Int32Ty, CountdownVar, "pgocountdown");
+    Builder.CreateStore(Builder.CreateSub(Countdown, Builder.getInt32(1)),
+                        CountdownVar);
+    Instruction *SampleTerm = SplitBlockAndInsertIfThen(
+        Builder.CreateIsNull(Countdown), Inc, /*Unreachable=*/false,
+        MDBuilder(Ctx).createBranchWeights(1, 100));
+    Builder.SetInsertPoint(SampleTerm);
+    LoadInst *Period = Builder.CreateLoad(Int32Ty, PeriodVar, "pgoperiod");
+    Builder.CreateStore(Builder.CreateSub(Period, Builder.getInt32(1)),
+                        CountdownVar);
+    IncStep = Builder.CreateMul(
+        IncStep, Builder.CreateZExt(Period, IncStep->getType()));
+    Promote = false;
+  }
 
   if (Options.Atomic || AtomicCounterUpdateAll) {
-    Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr, Inc->getStep(),
+    Builder.CreateAtomicRMW(AtomicRMWInst::Add, Addr, IncStep,
                             AtomicOrdering::Monotonic);
   } else {
-    Value *IncStep = Inc->getStep();
     Value *Load = Builder.CreateLoad(IncStep->getType(), Addr, "pgocount");
-    auto *Count = Builder.CreateAdd(Load, Inc->getStep());
+    auto *Count = Builder.CreateAdd(Load, IncStep);
     auto *Store = Builder.CreateStore(Count, Addr);
-    if (isCounterPromotionEnabled())
+    if (Promote)
       PromotionCandidates.emplace_back(cast<Instruction>(Load), Store);
   }
   Inc->eraseFromParent();
@@ -12,16 +12,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/DependenceAnalysis.h"
+#include "llvm/Analysis/LoopCacheAnalysis.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/LoopPass.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/Analysis/ScalarEvolution.h"
 #include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DiagnosticInfo.h"
@@ -57,6 +61,11 @@ static cl::opt<int> LoopInterchangeCostThreshold(
     "loop-interchange-threshold", cl::init(0), cl::Hidden,
     cl::desc("Interchange if you gain more than this number"));
 
+static cl::opt<bool> LoopInterchangeUseCacheCost(
+    "loop-interchange-use-cache-cost", cl::init(true), cl::Hidden,
+    cl::desc("Use the cache cost model of LoopCacheAnalysis to decide "
+             "whether an interchange is profitable"));
+
 namespace {
 
 using LoopVector = SmallVector<Loop *, 8>;
@@ -64,6 +73,11 @@ using LoopVector = SmallVector<Loop *, 8>;
 // TODO: Check if we can use a sparse matrix here.
 using CharMatrix = std::vector<std::vector<char>>;
 
+/// The rank of each loop of a nest in the cache cost model: the loops with the
+/// largest cost, which should go outermost, come first. Loops with the same
+/// cost have the same rank.
+using LoopCostRankMap = DenseMap<const Loop *, unsigned>;
+
 } // end anonymous namespace
 
 // Maximum number of dependencies that can be handled in the dependency matrix.
@@ -372,8 +386,10 @@ private:
 class LoopInterchangeProfitability {
 public:
   LoopInterchangeProfitability(Loop *Outer, Loop *Inner, ScalarEvolution *SE,
-                               OptimizationRemarkEmitter *ORE)
-      : OuterLoop(Outer), InnerLoop(Inner), SE(SE), ORE(ORE) {}
+                               OptimizationRemarkEmitter *ORE,
+                               const LoopCostRankMap &CostRanks)
+      : OuterLoop(Outer), InnerLoop(Inner), SE(SE), ORE(ORE),
+        CostRanks(CostRanks) {}
 
   /// Check if the loop interchange is profitable.
   bool isProfitable(unsigned InnerLoopId, unsigned OuterLoopId,
@@ -382,6 +398,10 @@ public:
 private:
   int getInstrOrderCost();
 
+  /// Returns whether the cache cost model prefers the inner loop outside, or
+  /// None if it can't tell.
+  Optional<bool> isProfitablePerCacheCost();
+
   Loop *OuterLoop;
   Loop *InnerLoop;
 
@@ -390,6 +410,9 @@ private:
 
   /// Interface to emit optimization remarks.
   OptimizationRemarkEmitter *ORE;
+
+  /// The cache cost ranks of the loops of the nest, if they could be computed.
+  const LoopCostRankMap &CostRanks;
 };
 
 /// LoopInterchangeTransform interchanges the loop.
@@ -436,10 +459,15 @@ struct LoopInterchange : public LoopPass {
   LoopInfo *LI = nullptr;
   DependenceInfo *DI = nullptr;
   DominatorTree *DT = nullptr;
+  TargetTransformInfo *TTI = nullptr;
+  AliasAnalysis *AA = nullptr;
 
   /// Interface to emit optimization remarks.
   OptimizationRemarkEmitter *ORE;
 
+  /// The cache cost ranks of the loops of the nest being processed.
+  LoopCostRankMap CostRanks;
+
   LoopInterchange() : LoopPass(ID) {
     initializeLoopInterchangePass(*PassRegistry::getPassRegistry());
   }
@@ -447,6 +475,7 @@ struct LoopInterchange : public LoopPass {
   void getAnalysisUsage(AnalysisUsage &AU) const override {
     AU.addRequired<DependenceAnalysisWrapperPass>();
     AU.addRequired<OptimizationRemarkEmitterWrapperPass>();
+    AU.addRequired<TargetTransformInfoWrapperPass>();
 
     getLoopAnalysisUsage(AU);
   }
@@ -459,6 +488,9 @@ struct LoopInterchange : public LoopPass {
     LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
     DI = &getAnalysis<DependenceAnalysisWrapperPass>().getDI();
     DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+    TTI = &getAnalysis<TargetTransformInfoWrapperPass>().getTTI(
+        *L->getHeader()->getParent());
+    AA = &getAnalysis<AAResultsWrapperPass>().getAAResults();
     ORE = &getAnalysis<OptimizationRemarkEmitterWrapperPass>().getORE();
 
     return processLoopList(populateWorklist(*L));
@@ -483,6 +515,28 @@ struct LoopInterchange : public LoopPass {
     return true;
   }
 
+  /// Ranks the loops of the nest \p LoopList by their cache cost, or leaves
+  /// \c CostRanks empty if the cost of one of them is unknown.
+  void computeCostRanks(const LoopVector &LoopList) {
+    CostRanks.clear();
+    if (!LoopInterchangeUseCacheCost)
+      return;
+    CacheCost CC(LoopList, *LI, *SE, *TTI, *AA, *DI);
+    auto LoopCosts = CC.getLoopCosts();
+    if (LoopCosts.size() != LoopList.size() ||
+        any_of(LoopCosts, [](const std::pair<const Loop *, CacheCostTy> &LC) {
+          return LC.second == CacheCost::InvalidCost;
+        }))
+      return;
+    // The costs are sorted in decreasing order.
+    unsigned Rank = 0;
+    for (unsigned I = 0, E = LoopCosts.size(); I != E; ++I) {
+      if (I && LoopCosts[I].second != LoopCosts[I - 1].second)
+        Rank = I;
+      CostRanks[LoopCosts[I].first] = Rank;
+    }
+  }
+
   unsigned selectLoopForInterchange(const LoopVector &LoopList) {
     // TODO: Add a better heuristic to select the loop to be interchanged based
     // on the dependence matrix. Currently we select the innermost loop.
@@ -521,6 +575,8 @@ struct LoopInterchange : public LoopPass {
     printDepMatrix(DependencyMatrix);
 #endif
 
+    computeCostRanks(LoopList);
+
     // Get the Outermost loop exit.
     BasicBlock *LoopNestExit = OuterMostLoop->getExitBlock();
     if (!LoopNestExit) {
@@ -563,7 +619,7 @@ struct LoopInterchange : public LoopPass {
       return false;
     }
     LLVM_DEBUG(dbgs() << "Loops are legal to interchange\n");
-    LoopInterchangeProfitability LIP(OuterLoop, InnerLoop, SE, ORE);
+    LoopInterchangeProfitability LIP(OuterLoop, InnerLoop, SE, ORE, CostRanks);
     if (!LIP.isProfitable(InnerLoopId, OuterLoopId, DependencyMatrix)) {
       LLVM_DEBUG(dbgs() << "Interchanging loops not profitable.\n");
       return false;
@@ -1097,6 +1153,17 @@ static bool isProfitableForVectorization(unsigned InnerLoopId,
   return !DepMatrix.empty();
 }
 
+Optional<bool> LoopInterchangeProfitability::isProfitablePerCacheCost() {
+  auto InnerIt = CostRanks.find(InnerLoop);
+  auto OuterIt = CostRanks.find(OuterLoop);
+  if (InnerIt == CostRanks.end() || OuterIt == CostRanks.end() ||
+      InnerIt->second == OuterIt->second)
+    return None;
+  LLVM_DEBUG(dbgs() << "Cache cost rank of inner loop = " << InnerIt->second
+                    << ", of outer loop = " << OuterIt->second << "\n");
+  return InnerIt->second < OuterIt->second;
+}
+
 bool LoopInterchangeProfitability::isProfitable(unsigned InnerLoopId,
                                                 unsigned OuterLoopId,
                                                 CharMatrix &DepMatrix) {
@@ -1105,6 +1172,21 @@ bool LoopInterchangeProfitability::isProfitable(unsigned InnerLoopId,
   // 1) Construct dependency matrix and move the one with no loop carried dep
   //    inside to enable vectorization.
 
+  // The cache cost model accounts for the strides and the reuse of all the
+  // memory accesses of the nest, so it has the final word when it can tell.
+  if (Optional<bool> Profitable = isProfitablePerCacheCost()) {
+    if (*Profitable)
+      return true;
+    ORE->emit([&]() {
+      return OptimizationRemarkMissed(DEBUG_TYPE, "InterchangeNotProfitable",
+                                      InnerLoop->getStartLoc(),
+                                      InnerLoop->getHeader())
+             << "Interchanging loops is not profitable as per the cache cost "
+                "model.";
+    });
+    return false;
+  }
+
   // This is rough cost estimation algorithm. It counts the good and bad order
   // of induction variables in the instruction and allows reordering if number
   // of bad orders is more than good.
@@ -1554,6 +1636,7 @@ INITIALIZE_PASS_BEGIN(LoopInterchange, "loop-interchange",
 INITIALIZE_PASS_DEPENDENCY(LoopPass)
 INITIALIZE_PASS_DEPENDENCY(DependenceAnalysisWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(OptimizationRemarkEmitterWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(TargetTransformInfoWrapperPass)
 
 INITIALIZE_PASS_END(LoopInterchange, "loop-interchange",
                     "Interchanges loops for cache reuse", false, false)
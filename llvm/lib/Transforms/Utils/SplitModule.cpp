@@ -91,10 +91,19 @@ static void addAllGlobalValueUsers(ClusterMapType &GVtoClusterMap,
   }
 }
 
+// Returns the estimated cost of generating code for GV.
+static uint64_t getCodeGenCost(const GlobalValue *GV) {
+  if (const Function *F = dyn_cast<Function>(GV))
+    return std::max(F->getInstructionCount(), 1u);
+  return 1;
+}
+
 // Find partitions for module in the way that no locals need to be
 // globalized.
 // Try to balance pack those partitions into N files since this roughly equals
-// thread balancing for the backend codegen step.
+// thread balancing for the backend codegen step. Every defined global is part
+// of a cluster, and the clusters are distributed by their estimated codegen
+// cost, largest first, each to the partition with the lowest cost so far.
 static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
                            unsigned N) {
   // At this point module should have the proper mix of globals and locals.
@@ -112,6 +121,8 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
     if (!GV.hasName())
       GV.setName("__llvmsplit_unnamed");
 
+    GVtoClusterMap.insert(&GV);
+
     // Comdat groups must not be partitioned. For comdat groups that contain
     // locals, record all their members here so we can keep them together.
     // Comdat groups that only contain external globals are already handled by
@@ -148,37 +159,40 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
   llvm::for_each(M->globals(), recordGVSet);
   llvm::for_each(M->aliases(), recordGVSet);
 
-  // Assigned all GVs to merged clusters while balancing number of objects in
-  // each.
-  auto CompareClusters = [](const std::pair<unsigned, unsigned> &a,
-                            const std::pair<unsigned, unsigned> &b) {
+  // Assigned all GVs to merged clusters while balancing the estimated codegen
+  // cost of each.
+  auto CompareClusters = [](const std::pair<unsigned, uint64_t> &a,
+                            const std::pair<unsigned, uint64_t> &b) {
     if (a.second || b.second)
       return a.second > b.second;
     else
       return a.first > b.first;
   };
 
-  std::priority_queue<std::pair<unsigned, unsigned>,
-                      std::vector<std::pair<unsigned, unsigned>>,
+  std::priority_queue<std::pair<unsigned, uint64_t>,
+                      std::vector<std::pair<unsigned, uint64_t>>,
                       decltype(CompareClusters)>
       BalancinQueue(CompareClusters);
   // Pre-populate priority queue with N slot blanks.
   for (unsigned i = 0; i < N; ++i)
     BalancinQueue.push(std::make_pair(i, 0));
 
-  using SortType = std::pair<unsigned, ClusterMapType::iterator>;
+  using SortType = std::pair<uint64_t, ClusterMapType::iterator>;
 
   SmallVector<SortType, 64> Sets;
   SmallPtrSet<const GlobalValue *, 32> Visited;
 
-  // To guarantee determinism, we have to sort SCC according to size.
-  // When size is the same, use leader's name.
+  // To guarantee determinism, we have to sort SCC according to cost.
+  // When cost is the same, use leader's name.
   for (ClusterMapType::iterator I = GVtoClusterMap.begin(),
                                 E = GVtoClusterMap.end(); I != E; ++I)
-    if (I->isLeader())
-      Sets.push_back(
-          std::make_pair(std::distance(GVtoClusterMap.member_begin(I),
-                                       GVtoClusterMap.member_end()), I));
+    if (I->isLeader()) {
+      uint64_t Cost = 0;
+      for (ClusterMapType::member_iterator MI = GVtoClusterMap.member_begin(I);
+           MI != GVtoClusterMap.member_end(); ++MI)
+        Cost += getCodeGenCost(*MI);
+      Sets.push_back(std::make_pair(Cost, I));
+    }
 
   llvm::sort(Sets, [](const SortType &a, const SortType &b) {
     if (a.first == b.first)
@@ -189,10 +203,10 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
 
   for (auto &I : Sets) {
     unsigned CurrentClusterID = BalancinQueue.top().first;
-    unsigned CurrentClusterSize = BalancinQueue.top().second;
+    uint64_t CurrentClusterCost = BalancinQueue.top().second;
     BalancinQueue.pop();
 
-    LLVM_DEBUG(dbgs() << "Root[" << CurrentClusterID << "] cluster_size("
+    LLVM_DEBUG(dbgs() << "Root[" << CurrentClusterID << "] cluster_cost("
                       << I.first << ") ----> " << I.second->getData()->getName()
                       << "\n");
 
@@ -205,10 +219,10 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
                         << ((*MI)->hasLocalLinkage() ? " l " : " e ") << "\n");
       Visited.insert(*MI);
       ClusterIDMap[*MI] = CurrentClusterID;
-      CurrentClusterSize++;
     }
-    // Add this set size to the number of entries in this cluster.
-    BalancinQueue.push(std::make_pair(CurrentClusterID, CurrentClusterSize));
+    // Add the cost of this set to the cost of this cluster.
+    BalancinQueue.push(
+        std::make_pair(CurrentClusterID, CurrentClusterCost + I.first));
   }
 }
 
@@ -224,8 +238,9 @@ static void externalize(GlobalValue *GV) {
     GV->setName("__llvmsplit_unnamed");
 }
 
-// Returns whether GV should be in partition (0-based) I of N.
-static bool isInPartition(const GlobalValue *GV, unsigned I, unsigned N) {
+// Returns the partition (0-based) of N that GV should be in, if it isn't part
+// of a cluster.
+static unsigned getHashPartition(const GlobalValue *GV, unsigned N) {
   if (auto *GIS = dyn_cast<GlobalIndirectSymbol>(GV))
     if (const GlobalObject *Base = GIS->getBaseObject())
       GV = Base;
@@ -243,23 +258,31 @@ static bool isInPartition(const GlobalValue *GV, unsigned I, unsigned N) {
   MD5::MD5Result R;
   H.update(Name);
   H.final(R);
-  return (R[0] | (R[1] << 8)) % N == I;
+  return (R[0] | (R[1] << 8)) % N;
+}
+
+// Returns whether GV should be in partition (0-based) I of N.
+static bool isInPartition(const GlobalValue *GV, unsigned I, unsigned N) {
+  return getHashPartition(GV, N) == I;
+}
+
+static void externalizeAll(Module &M) {
+  for (Function &F : M)
+    externalize(&F);
+  for (GlobalVariable &GV : M.globals())
+    externalize(&GV);
+  for (GlobalAlias &GA : M.aliases())
+    externalize(&GA);
+  for (GlobalIFunc &GIF : M.ifuncs())
+    externalize(&GIF);
 }
 
 void llvm::SplitModule(
     std::unique_ptr<Module> M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
     bool PreserveLocals) {
-  if (!PreserveLocals) {
-    for (Function &F : *M)
-      externalize(&F);
-    for (GlobalVariable &GV : M->globals())
-      externalize(&GV);
-    for (GlobalAlias &GA : M->aliases())
-      externalize(&GA);
-    for (GlobalIFunc &GIF : M->ifuncs())
-      externalize(&GIF);
-  }
+  if (!PreserveLocals)
+    externalizeAll(*M);
 
   // This performs splitting without a need for externalization, which might not
   // always be possible.
@@ -282,3 +305,25 @@ void llvm::SplitModule(
     ModuleCallback(std::move(MPart));
   }
 }
+
+void llvm::computeModulePartitions(
+    Module &M, unsigned N,
+    function_ref<void(const GlobalValue &GV, unsigned Partition)>
+        PartitionCallback,
+    bool PreserveLocals) {
+  if (!PreserveLocals)
+    externalizeAll(M);
+
+  ClusterIDMapType ClusterIDMap;
+  findPartitions(&M, ClusterIDMap, N);
+
+  // Report the global values in module order, as the iteration order of the
+  // map isn't deterministic.
+  for (const GlobalValue &GV : M.global_values()) {
+    if (GV.isDeclaration())
+      continue;
+    auto It = ClusterIDMap.find(&GV);
+    PartitionCallback(GV, It != ClusterIDMap.end() ? It->second
+                                                  : getHashPartition(&GV, N));
+  }
+}
@@ -190,6 +190,11 @@ static cl::opt<bool> MaximizeBandwidth(
     cl::desc("Maximize bandwidth when selecting vectorization factor which "
              "will be determined by the smallest type in loop."));
 
+static cl::opt<unsigned> MaxCostedVectorVFs(
+    "vectorizer-max-costed-vfs", cl::init(0), cl::Hidden,
+    cl::desc("Limits the number of vectorization factors that are costed, and "
+             "for which VPlans are built, to the widest ones (0 = no limit)."));
+
 static cl::opt<bool> EnableInterleavedMemAccesses(
     "enable-interleaved-mem-accesses", cl::init(false), cl::Hidden,
     cl::desc("Enable vectorization on interleaved memory accesses in a loop"));
@@ -948,10 +953,11 @@ public:
   bool runtimeChecksRequired();
 
   /// \return The most profitable vectorization factor and the cost of that VF.
-  /// This method checks every power of two up to MaxVF. If UserVF is not ZERO
-  /// then this vectorization factor will be selected if vectorization is
-  /// possible.
-  VectorizationFactor selectVectorizationFactor(unsigned MaxVF);
+  /// This method checks the scalar loop and every power of two from MinVF up
+  /// to MaxVF. If UserVF is not ZERO then this vectorization factor will be
+  /// selected if vectorization is possible.
+  VectorizationFactor selectVectorizationFactor(unsigned MinVF,
+                                                unsigned MaxVF);
 
   /// Setup cost-based decisions for user vectorization factor.
   void selectUserVectorizationFactor(unsigned UserVF) {
@@ -4970,7 +4976,8 @@ LoopVectorizationCostModel::computeFeasibleMaxVF(unsigned ConstTripCount) {
 }
 
 VectorizationFactor
-LoopVectorizationCostModel::selectVectorizationFactor(unsigned MaxVF) {
+LoopVectorizationCostModel::selectVectorizationFactor(unsigned MinVF,
+                                                      unsigned MaxVF) {
   float Cost = expectedCost(1).first;
   const float ScalarCost = Cost;
   unsigned Width = 1;
@@ -4984,7 +4991,7 @@ LoopVectorizationCostModel::selectVectorizationFactor(unsigned MaxVF) {
     Cost = std::numeric_limits<float>::max();
   }
 
-  for (unsigned i = 2; i <= MaxVF; i *= 2) {
+  for (unsigned i = MinVF; i <= MaxVF; i *= 2) {
     // Notice that the vector loop needs to be executed less times, so
     // we need to divide the cost of the vector loops by the width of
     // the vector elements.
@@ -6287,7 +6294,9 @@ static unsigned determineVPlanVF(const unsigned WidestVectorRegBits,
                                  LoopVectorizationCostModel &CM) {
   unsigned WidestType;
   std::tie(std::ignore, WidestType) = CM.getSmallestAndWidestTypes();
-  return WidestVectorRegBits / WidestType;
+  // Types that aren't a power of two wide, or targets without vector
+  // registers, must not lead to a VF that isn't a power of two.
+  return PowerOf2Floor(WidestVectorRegBits / WidestType);
 }
 
 VectorizationFactor
@@ -6310,6 +6319,13 @@ LoopVectorizationPlanner::planInVPlanNativePath(unsigned UserVF) {
                           << "overriding computed VF.\n");
         VF = 4;
       }
+
+      // There is nothing to gain from "vectorizing" with a single lane.
+      if (VF < 2) {
+        LLVM_DEBUG(dbgs() << "LV: Not vectorizing. The outer loop doesn't "
+                             "fit more than one lane in a vector register.\n");
+        return VectorizationFactor::Disabled();
+      }
     }
     assert(EnableVPlanNativePath && "VPlan-native path is not enabled.");
     assert(isPowerOf2_32(VF) && "VF needs to be a power of two");
@@ -6360,7 +6376,17 @@ Optional<VectorizationFactor> LoopVectorizationPlanner::plan(unsigned UserVF) {
   unsigned MaxVF = MaybeMaxVF.getValue();
   assert(MaxVF != 0 && "MaxVF is zero.");
 
-  for (unsigned VF = 1; VF <= MaxVF; VF *= 2) {
+  // Costing a VF means analyzing the whole loop for it and building a VPlan,
+  // so when asked to, only consider the widest VFs besides the scalar loop.
+  unsigned MinVF = 2;
+  if (MaxCostedVectorVFs && MaxVF > 1 &&
+      Log2_32(MaxVF) > MaxCostedVectorVFs) {
+    MinVF = MaxVF >> (MaxCostedVectorVFs - 1);
+    LLVM_DEBUG(dbgs() << "LV: Only costing VFs from " << MinVF << " to "
+                      << MaxVF << ".\n");
+  }
+
+  for (unsigned VF = 1; VF <= MaxVF; VF = VF == 1 ? MinVF : VF * 2) {
     // Collect Uniform and Scalar instructions after vectorization with VF.
     CM.collectUniformsAndScalars(VF);
 
@@ -6370,13 +6396,18 @@ Optional<VectorizationFactor> LoopVectorizationPlanner::plan(unsigned UserVF) {
       CM.collectInstsToScalarize(VF);
   }
 
-  buildVPlansWithVPRecipes(1, MaxVF);
+  if (MinVF == 2) {
+    buildVPlansWithVPRecipes(1, MaxVF);
+  } else {
+    buildVPlansWithVPRecipes(1, 1);
+    buildVPlansWithVPRecipes(MinVF, MaxVF);
+  }
   LLVM_DEBUG(printPlans(dbgs()));
   if (MaxVF == 1)
     return VectorizationFactor::Disabled();
 
   // Select the optimal vectorization factor.
-  return CM.selectVectorizationFactor(MaxVF);
+  return CM.selectVectorizationFactor(MinVF, MaxVF);
 }
 
 void LoopVectorizationPlanner::setBestPlan(unsigned VF, unsigned UF) {
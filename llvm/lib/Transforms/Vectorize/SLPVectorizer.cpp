@@ -135,6 +135,14 @@ static cl::opt<int>
 ScheduleRegionSizeBudget("slp-schedule-budget", cl::init(100000), cl::Hidden,
     cl::desc("Limit the size of the SLP scheduling region per block"));
 
+/// Limits the number of tree entries built per function, over all the seeds.
+/// It avoids long compile times for huge functions with many seeds, where
+/// most trees are built only to be rejected. This limit is way higher than
+/// needed by real-world functions.
+static cl::opt<unsigned>
+TreeEntryBudget("slp-tree-entry-budget", cl::init(1000000), cl::Hidden,
+    cl::desc("Limit the number of SLP tree entries built per function"));
+
 static cl::opt<int> MinVectorRegSizeOption(
     "slp-min-reg-size", cl::init(128), cl::Hidden,
     cl::desc("Attempt to vectorize for this register size in bits"));
@@ -1945,6 +1953,10 @@ private:
   unsigned MaxVecRegSize; // This is set by TTI or overridden by cl::opt.
   unsigned MinVecRegSize; // Set by cl::opt (default: 128).
 
+  /// The number of tree entries built for this function so far, see
+  /// TreeEntryBudget.
+  unsigned NumTreeEntriesBuilt = 0;
+
   /// Instruction builder to construct the vectorized tree.
   IRBuilder<> Builder;
 
@@ -2065,7 +2077,13 @@ void BoUpSLP::buildTree(ArrayRef<Value *> Roots,
   UserIgnoreList = UserIgnoreLst;
   if (!allSameType(Roots))
     return;
+  if (NumTreeEntriesBuilt >= TreeEntryBudget) {
+    LLVM_DEBUG(dbgs() << "SLP: Tree entry budget exhausted, not building a "
+                         "tree for the remaining seeds.\n");
+    return;
+  }
   buildTree_rec(Roots, 0, EdgeInfo());
+  NumTreeEntriesBuilt += VectorizableTree.size();
 
   // Collect the values that we need to extract from the tree.
   for (auto &TEPtr : VectorizableTree) {
@@ -9,10 +9,8 @@
 #include "DwarfLinker.h"
 #include "BinaryHolder.h"
 #include "DebugMap.h"
-#include "DeclContext.h"
 #include "DwarfStreamer.h"
 #include "MachOUtils.h"
-#include "NonRelocatableStringpool.h"
 #include "dsymutil.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/BitVector.h"
@@ -36,7 +34,9 @@
 #include "llvm/CodeGen/AccelTable.h"
 #include "llvm/CodeGen/AsmPrinter.h"
 #include "llvm/CodeGen/DIE.h"
+#include "llvm/CodeGen/NonRelocatableStringpool.h"
 #include "llvm/Config/config.h"
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
 #include "llvm/DebugInfo/DIContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFAbbreviationDeclaration.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
@@ -2333,6 +2333,7 @@ Error DwarfLinker::loadClangModule(
                          [&](const Twine &Warning, const DWARFDie &DIE) {
                            reportWarning(Warning, DMO, &DIE);
                          });
+      Unit->clearODRContexts();
       // Keep everything.
       Unit->markEverythingAsKept();
     }
@@ -2565,7 +2566,10 @@ bool DwarfLinker::link(const DebugMap &Map) {
   // This Dwarf string pool which is used for emission. It must be used
   // serially as the order of calling getStringOffset matters for
   // reproducibility.
-  OffsetsStringPool OffsetsStringPool(Options.Translator);
+  OffsetsStringPool OffsetsStringPool(
+      Options.Translator
+          ? NonRelocatableStringpool::TranslatorTy(Options.Translator)
+          : nullptr);
 
   // ODR Contexts for the link.
   DeclContextTree ODRContexts;
@@ -2676,6 +2680,15 @@ bool DwarfLinker::link(const DebugMap &Map) {
   if (MaxDwarfVersion == 0)
     MaxDwarfVersion = 3;
 
+  // Reserve the unit IDs of every object up front, so that the objects can be
+  // analyzed concurrently.
+  for (LinkContext &LinkContext : ObjectContexts) {
+    if (!LinkContext.ObjectFile || !LinkContext.DwarfContext)
+      continue;
+    LinkContext.FirstUnitID = UnitID;
+    UnitID += LinkContext.DwarfContext->getNumCompileUnits();
+  }
+
   // At this point we know how much data we have emitted. We use this value to
   // compare canonical DIE offsets in analyzeContextInfo to see if a definition
   // is already emitted, without being affected by canonical die offsets set
@@ -2690,15 +2703,18 @@ bool DwarfLinker::link(const DebugMap &Map) {
   BitVector ProcessedFiles(NumObjects, false);
 
   //  Analyzing the context info is particularly expensive so it is executed in
-  //  parallel with emitting the previous compile unit.
+  //  parallel with emitting the previous compile unit. Several objects can be
+  //  analyzed at the same time: the ODR contexts and the uniquing string pool
+  //  are thread safe, and everything else an analysis writes to is local to
+  //  its object.
   auto AnalyzeLambda = [&](size_t i) {
     auto &LinkContext = ObjectContexts[i];
 
     if (!LinkContext.ObjectFile || !LinkContext.DwarfContext)
       return;
 
+    unsigned UnitID = LinkContext.FirstUnitID;
     for (const auto &CU : LinkContext.DwarfContext->compile_units()) {
-      updateDwarfVersion(CU->getVersion());
       // The !registerModuleReference() condition effectively skips
       // over fully resolved skeleton units. This second pass of
       // registerModuleReferences doesn't do any new work, but it
@@ -2724,10 +2740,11 @@ bool DwarfLinker::link(const DebugMap &Map) {
       analyzeContextInfo(CurrentUnit->getOrigUnit().getUnitDIE(), 0,
                          *CurrentUnit, &ODRContexts.getRoot(),
                          UniquingStringPool, ODRContexts, ModulesEndOffset,
-                         ParseableSwiftInterfaces,
+                         LinkContext.ParseableSwiftInterfaces,
                          [&](const Twine &Warning, const DWARFDie &DIE) {
                            reportWarning(Warning, LinkContext.DMO, &DIE);
                          });
+      CurrentUnit->clearODRContexts();
     }
   };
 
@@ -2740,6 +2757,18 @@ bool DwarfLinker::link(const DebugMap &Map) {
     if (!LinkContext.ObjectFile)
       return;
 
+    // Merge the Swift interfaces in object order to keep the choice between
+    // conflicting interfaces independent of the analysis scheduling.
+    for (const auto &Interface : LinkContext.ParseableSwiftInterfaces) {
+      auto &Entry = ParseableSwiftInterfaces[Interface.first];
+      if (!Entry.empty() && Entry != Interface.second)
+        reportWarning(
+            Twine("Conflicting parseable interfaces for Swift Module ") +
+                Interface.first + ": " + Entry + " and " + Interface.second,
+            LinkContext.DMO);
+      Entry = Interface.second;
+    }
+
     // Then mark all the DIEs that need to be present in the linked output
     // and collect some information about them.
     // Note that this loop can not be merged with the previous one because
@@ -2799,14 +2828,12 @@ bool DwarfLinker::link(const DebugMap &Map) {
     }
   };
 
-  auto AnalyzeAll = [&]() {
-    for (unsigned i = 0, e = NumObjects; i != e; ++i) {
-      AnalyzeLambda(i);
+  auto AnalyzeOne = [&](size_t i) {
+    AnalyzeLambda(i);
 
-      std::unique_lock<std::mutex> LockGuard(ProcessedFilesMutex);
-      ProcessedFiles.set(i);
-      ProcessedFilesConditionVariable.notify_one();
-    }
+    std::unique_lock<std::mutex> LockGuard(ProcessedFilesMutex);
+    ProcessedFiles.set(i);
+    ProcessedFilesConditionVariable.notify_one();
   };
 
   auto CloneAll = [&]() {
@@ -2827,6 +2854,9 @@ bool DwarfLinker::link(const DebugMap &Map) {
   // To limit memory usage in the single threaded case, analyze and clone are
   // run sequentially so the LinkContext is freed after processing each object
   // in endDebugObject.
+  //
+  // Otherwise one thread clones the objects in order, which keeps the output
+  // deterministic, while the other threads analyze the objects ahead of it.
   if (Options.Threads == 1) {
     for (unsigned i = 0, e = NumObjects; i != e; ++i) {
       AnalyzeLambda(i);
@@ -2834,9 +2864,10 @@ bool DwarfLinker::link(const DebugMap &Map) {
     }
     EmitLambda();
   } else {
-    ThreadPool pool(2);
-    pool.async(AnalyzeAll);
+    ThreadPool pool(std::max(2u, Options.Threads));
     pool.async(CloneAll);
+    for (unsigned i = 0, e = NumObjects; i != e; ++i)
+      pool.async([&AnalyzeOne, i] { AnalyzeOne(i); });
     pool.wait();
   }
 
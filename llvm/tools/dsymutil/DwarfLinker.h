@@ -10,11 +10,11 @@
 #define LLVM_TOOLS_DSYMUTIL_DWARFLINKER_H
 
 #include "BinaryHolder.h"
-#include "CompileUnit.h"
 #include "DebugMap.h"
-#include "DeclContext.h"
 #include "DwarfStreamer.h"
 #include "LinkUtils.h"
+#include "llvm/DWARFLinker/DWARFLinkerCompileUnit.h"
+#include "llvm/DWARFLinker/DWARFLinkerDeclContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 
 namespace llvm {
@@ -147,6 +147,12 @@ private:
     std::unique_ptr<DWARFContext> DwarfContext;
     RangesTy Ranges;
     UnitListTy CompileUnits;
+    /// The first of the unique IDs reserved for the compile units of this
+    /// object, so that objects can be analyzed in any order.
+    unsigned FirstUnitID = 0;
+    /// The parseable Swift interfaces found while analyzing this object. They
+    /// are merged into DwarfLinker::ParseableSwiftInterfaces in object order.
+    std::map<std::string, std::string> ParseableSwiftInterfaces;
 
     LinkContext(const DebugMap &Map, DwarfLinker &Linker, DebugMapObject &DMO)
         : DMO(DMO), RelocMgr(Linker) {
@@ -166,6 +172,7 @@ private:
       DwarfContext.reset(nullptr);
       CompileUnits.clear();
       Ranges.clear();
+      ParseableSwiftInterfaces.clear();
     }
   };
 
@@ -117,7 +117,7 @@ static cl::opt<AccelTableKind> AcceleratorTable(
 static opt<unsigned> NumThreads(
     "num-threads",
     desc("Specifies the maximum number (n) of simultaneous threads to use\n"
-         "when linking multiple architectures."),
+         "when linking multiple architectures and analyzing object files."),
     value_desc("n"), init(0), cat(DsymCategory));
 static alias NumThreadsA("j", desc("Alias for --num-threads"),
                          aliasopt(NumThreads));
@@ -209,6 +209,7 @@ namespace options {
   static std::string RemarksFilename;
   static std::string RemarksPasses;
   static bool RemarksWithHotness = false;
+  static unsigned RemarksHotnessThreshold = 0;
   static std::string RemarksFormat;
 
   // Context sensitive PGO options.
@@ -291,6 +292,10 @@ namespace options {
       RemarksPasses = opt.substr(strlen("opt-remarks-passes="));
     } else if (opt == "opt-remarks-with-hotness") {
       RemarksWithHotness = true;
+    } else if (opt.startswith("opt-remarks-hotness-threshold=")) {
+      if (opt.substr(strlen("opt-remarks-hotness-threshold="))
+              .getAsInteger(10, RemarksHotnessThreshold))
+        message(LDPL_FATAL, "Invalid remarks hotness threshold: %s", opt_);
     } else if (opt.startswith("opt-remarks-format=")) {
       RemarksFormat = opt.substr(strlen("opt-remarks-format="));
     } else if (opt.startswith("stats-file=")) {
@@ -916,6 +921,7 @@ static std::unique_ptr<LTO> createLTO(IndexWriteCallback OnIndexWrite,
   Conf.RemarksFilename = options::RemarksFilename;
   Conf.RemarksPasses = options::RemarksPasses;
   Conf.RemarksWithHotness = options::RemarksWithHotness;
+  Conf.RemarksHotnessThreshold = options::RemarksHotnessThreshold;
   Conf.RemarksFormat = options::RemarksFormat;
 
   // Use new pass manager if set in driver
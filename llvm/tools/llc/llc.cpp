@@ -355,8 +355,10 @@ int main(int argc, char **argv) {
     if (int RetVal = compileModule(argv, Context))
       return RetVal;
 
-  if (RemarksFile)
+  if (RemarksFile) {
+    Context.getRemarkStreamer()->finalize();
     RemarksFile->keep();
+  }
   return 0;
 }
 
@@ -110,6 +110,12 @@ namespace {
                "rather than individual functions"),
       cl::init(false));
 
+  cl::opt<unsigned> TierUpThreshold(
+      "tier-up-threshold",
+      cl::desc("Recompiles functions with optimizations after this many "
+               "calls, 0 to compile once (jit-kind=orc-lazy only)"),
+      cl::init(0));
+
   cl::list<std::string>
       JITDylibs("jd",
                 cl::desc("Specifies the JITDylib to be used for any subsequent "
@@ -773,6 +779,7 @@ int runOrcLazyJIT(const char *ProgName) {
   Builder.setLazyCompileFailureAddr(
       pointerToJITTargetAddress(exitOnLazyCallThroughFailure));
   Builder.setNumCompileThreads(LazyJITCompileThreads);
+  Builder.setTierUpThreshold(TierUpThreshold);
 
   auto J = ExitOnErr(Builder.create());
 
@@ -910,6 +917,11 @@ void disallowOrcOptions() {
     errs() << "-per-module-lazy requires -jit-kind=orc-lazy\n";
     exit(1);
   }
+
+  if (TierUpThreshold != 0) {
+    errs() << "-tier-up-threshold requires -jit-kind=orc-lazy\n";
+    exit(1);
+  }
 }
 
 std::unique_ptr<FDRawChannel> launchRemote() {
@@ -4,7 +4,9 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCStreamer.h"
+#include "llvm/Support/Allocator.h"
 #include <cassert>
+#include <cstring>
 
 namespace llvm {
 class DWPStringPool {
@@ -32,6 +34,9 @@ class DWPStringPool {
 
   MCStreamer &Out;
   MCSection *Sec;
+  /// The pool owns copies of its strings, so that the input files they come
+  /// from can be released as soon as they have been merged.
+  BumpPtrAllocator Alloc;
   DenseMap<const char *, uint32_t, CStrDenseMapInfo> Pool;
   uint32_t Offset = 0;
 
@@ -41,14 +46,18 @@ public:
   uint32_t getOffset(const char *Str, unsigned Length) {
     assert(strlen(Str) + 1 == Length && "Ensure length hint is correct");
 
-    auto Pair = Pool.insert(std::make_pair(Str, Offset));
-    if (Pair.second) {
-      Out.SwitchSection(Sec);
-      Out.EmitBytes(StringRef(Str, Length));
-      Offset += Length;
-    }
+    auto It = Pool.find(Str);
+    if (It != Pool.end())
+      return It->second;
 
-    return Pair.first->second;
+    char *Copy = Alloc.Allocate<char>(Length);
+    memcpy(Copy, Str, Length);
+    Pool.insert(std::make_pair(Copy, Offset));
+    Out.SwitchSection(Sec);
+    Out.EmitBytes(StringRef(Str, Length));
+    uint32_t StrOffset = Offset;
+    Offset += Length;
+    return StrOffset;
   }
 };
 }
@@ -15,6 +15,7 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFFormValue.h"
 #include "llvm/DebugInfo/DWARF/DWARFUnitIndex.h"
@@ -39,6 +40,8 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
@@ -61,6 +64,13 @@ static cl::opt<std::string> OutputFilename(cl::Required, "o",
                                            cl::value_desc("filename"),
                                            cl::cat(DwpCategory));
 
+static cl::opt<unsigned> NumThreads(
+    "j", cl::init(0),
+    cl::desc("Number of threads to read and decompress the input files on, 0 "
+             "meaning one per hardware thread. At most this many input files "
+             "are held in memory at once."),
+    cl::value_desc("threads"), cl::cat(DwpCategory));
+
 static void writeStringsAndOffsets(MCStreamer &Out, DWPStringPool &Strings,
                                    MCSection *StrOffsetSection,
                                    StringRef CurStrSection,
@@ -389,36 +399,59 @@ handleCompressedSection(std::deque<SmallString<32>> &UncompressedSections,
   return Error::success();
 }
 
-static Error handleSection(
-    const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
-    const MCSection *StrSection, const MCSection *StrOffsetSection,
-    const MCSection *TypesSection, const MCSection *CUIndexSection,
-    const MCSection *TUIndexSection, const SectionRef &Section, MCStreamer &Out,
-    std::deque<SmallString<32>> &UncompressedSections,
-    uint32_t (&ContributionOffsets)[8], UnitIndexEntry &CurEntry,
-    StringRef &CurStrSection, StringRef &CurStrOffsetSection,
-    std::vector<StringRef> &CurTypesSection, StringRef &InfoSection,
-    StringRef &AbbrevSection, StringRef &CurCUIndexSection,
-    StringRef &CurTUIndexSection) {
-  if (Section.isBSS())
-    return Error::success();
+namespace {
+/// An input .dwo or .dwp file, read in along with its decompressed sections.
+struct InputDWO {
+  OwningBinary<object::ObjectFile> Obj;
+  std::deque<SmallString<32>> UncompressedSections;
+  /// The name and contents of the sections that have contents, with
+  /// compressed sections already decompressed.
+  std::vector<std::pair<StringRef, StringRef>> Sections;
+};
+} // namespace
 
-  if (Section.isVirtual())
-    return Error::success();
+/// Read in the object file \p Input and decompress its sections. This only
+/// touches \p Input, so several inputs can be loaded concurrently.
+static Expected<std::unique_ptr<InputDWO>> loadInput(StringRef Input) {
+  auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
+  if (!ErrOrObj)
+    return ErrOrObj.takeError();
 
-  Expected<StringRef> NameOrErr = Section.getName();
-  if (!NameOrErr)
-    return NameOrErr.takeError();
-  StringRef Name = *NameOrErr;
+  auto DWO = std::make_unique<InputDWO>();
+  DWO->Obj = std::move(*ErrOrObj);
+  for (const auto &Section : DWO->Obj.getBinary()->sections()) {
+    if (Section.isBSS() || Section.isVirtual())
+      continue;
 
-  Expected<StringRef> ContentsOrErr = Section.getContents();
-  if (!ContentsOrErr)
-    return ContentsOrErr.takeError();
-  StringRef Contents = *ContentsOrErr;
+    Expected<StringRef> NameOrErr = Section.getName();
+    if (!NameOrErr)
+      return NameOrErr.takeError();
+    StringRef Name = *NameOrErr;
 
-  if (auto Err = handleCompressedSection(UncompressedSections, Name, Contents))
-    return Err;
+    Expected<StringRef> ContentsOrErr = Section.getContents();
+    if (!ContentsOrErr)
+      return ContentsOrErr.takeError();
+    StringRef Contents = *ContentsOrErr;
 
+    if (auto Err =
+            handleCompressedSection(DWO->UncompressedSections, Name, Contents))
+      return std::move(Err);
+
+    DWO->Sections.emplace_back(Name, Contents);
+  }
+  return std::move(DWO);
+}
+
+static Error handleSection(
+    const StringMap<std::pair<MCSection *, DWARFSectionKind>> &KnownSections,
+    const MCSection *StrSection, const MCSection *StrOffsetSection,
+    const MCSection *TypesSection, const MCSection *CUIndexSection,
+    const MCSection *TUIndexSection, StringRef Name, StringRef Contents,
+    MCStreamer &Out, uint32_t (&ContributionOffsets)[8],
+    UnitIndexEntry &CurEntry, StringRef &CurStrSection,
+    StringRef &CurStrOffsetSection, std::vector<StringRef> &CurTypesSection,
+    StringRef &InfoSection, StringRef &AbbrevSection,
+    StringRef &CurCUIndexSection, StringRef &CurTUIndexSection) {
   Name = Name.substr(Name.find_first_not_of("._"));
 
   auto SectionPair = KnownSections.find(Name);
@@ -502,7 +535,8 @@ getDWOFilenames(StringRef ExecFilename) {
   return std::move(DWOPaths);
 }
 
-static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
+static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
+                   unsigned NumThreads) {
   const auto &MCOFI = *Out.getContext().getObjectFileInfo();
   MCSection *const StrSection = MCOFI.getDwarfStrDWOSection();
   MCSection *const StrOffsetSection = MCOFI.getDwarfStrOffDWOSection();
@@ -527,18 +561,49 @@ static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
 
   DWPStringPool Strings(Out, StrSection);
 
-  SmallVector<OwningBinary<object::ObjectFile>, 128> Objects;
-  Objects.reserve(Inputs.size());
-
-  std::deque<SmallString<32>> UncompressedSections;
+  // The inputs are read and decompressed ahead on a thread pool, but they are
+  // merged one at a time and in order: the output doesn't depend on the
+  // scheduling, and each input is released once it has been merged, so at
+  // most NumThreads of them are in memory at once.
+  if (NumThreads == 0)
+    NumThreads = llvm::heavyweight_hardware_concurrency();
+  std::vector<Optional<Expected<std::unique_ptr<InputDWO>>>> Loaded(
+      Inputs.size());
+  std::vector<std::shared_future<void>> Pending(Inputs.size());
+  Optional<ThreadPool> Pool;
+  if (NumThreads > 1)
+    Pool.emplace(NumThreads);
+  auto ConsumeLoaded = make_scope_exit([&] {
+    if (Pool)
+      Pool->wait();
+    for (auto &DWO : Loaded)
+      if (DWO && !*DWO)
+        consumeError(DWO->takeError());
+  });
+
+  size_t NextToLoad = 0;
+  for (size_t InputIdx = 0, E = Inputs.size(); InputIdx != E; ++InputIdx) {
+    for (; NextToLoad != E && NextToLoad < InputIdx + NumThreads;
+         ++NextToLoad) {
+      auto Load = [&Loaded, Inputs, I = NextToLoad] {
+        Loaded[I].emplace(loadInput(Inputs[I]));
+      };
+      if (Pool)
+        Pending[NextToLoad] = Pool->async(Load);
+      else
+        Load();
+    }
+    if (Pool)
+      Pending[InputIdx].wait();
 
-  for (const auto &Input : Inputs) {
-    auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
-    if (!ErrOrObj)
-      return ErrOrObj.takeError();
+    Expected<std::unique_ptr<InputDWO>> &DWOOrErr = *Loaded[InputIdx];
+    if (!DWOOrErr)
+      return DWOOrErr.takeError();
+    std::unique_ptr<InputDWO> DWO = std::move(*DWOOrErr);
+    Loaded[InputIdx].reset();
 
-    auto &Obj = *ErrOrObj->getBinary();
-    Objects.push_back(std::move(*ErrOrObj));
+    StringRef Input = Inputs[InputIdx];
+    auto &Obj = *DWO->Obj.getBinary();
 
     UnitIndexEntry CurEntry = {};
 
@@ -550,13 +615,13 @@ static Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
     StringRef CurCUIndexSection;
     StringRef CurTUIndexSection;
 
-    for (const auto &Section : Obj.sections())
+    for (const auto &Section : DWO->Sections)
       if (auto Err = handleSection(
               KnownSections, StrSection, StrOffsetSection, TypesSection,
-              CUIndexSection, TUIndexSection, Section, Out,
-              UncompressedSections, ContributionOffsets, CurEntry,
-              CurStrSection, CurStrOffsetSection, CurTypesSection, InfoSection,
-              AbbrevSection, CurCUIndexSection, CurTUIndexSection))
+              CUIndexSection, TUIndexSection, Section.first, Section.second,
+              Out, ContributionOffsets, CurEntry, CurStrSection,
+              CurStrOffsetSection, CurTypesSection, InfoSection, AbbrevSection,
+              CurCUIndexSection, CurTUIndexSection))
         return Err;
 
     if (InfoSection.empty())
@@ -737,7 +802,7 @@ int main(int argc, char **argv) {
                         std::make_move_iterator(DWOs->end()));
   }
 
-  if (auto Err = write(*MS, DWOFilenames)) {
+  if (auto Err = write(*MS, DWOFilenames, NumThreads)) {
     logAllUnhandledErrors(std::move(Err), WithColor::error());
     return 1;
   }
@@ -250,6 +250,29 @@ Analysis::makePointsPerSchedClass() const {
   return Entries;
 }
 
+std::vector<Analysis::SchedClassCluster> Analysis::makeSchedClassClusters(
+    const ResolvedSchedClassAndPoints &RSCAndPoints) const {
+  std::vector<SchedClassCluster> SchedClassClusters;
+  for (const size_t PointId : RSCAndPoints.PointIds) {
+    const auto &ClusterId = Clustering_.getClusterIdForPoint(PointId);
+    if (!ClusterId.isValid())
+      continue; // Ignore noise and errors. FIXME: take noise into account ?
+    if (ClusterId.isUnstable() ^ AnalysisDisplayUnstableOpcodes_)
+      continue; // Either display stable or unstable clusters only.
+    auto SchedClassClusterIt =
+        std::find_if(SchedClassClusters.begin(), SchedClassClusters.end(),
+                     [ClusterId](const SchedClassCluster &C) {
+                       return C.id() == ClusterId;
+                     });
+    if (SchedClassClusterIt == SchedClassClusters.end()) {
+      SchedClassClusters.emplace_back();
+      SchedClassClusterIt = std::prev(SchedClassClusters.end());
+    }
+    SchedClassClusterIt->addPoint(PointId, Clustering_);
+  }
+  return SchedClassClusters;
+}
+
 // Uops repeat the same opcode over again. Just show this opcode and show the
 // whole snippet only on hover.
 static void writeUopsSnippetHtml(llvm::raw_ostream &OS,
@@ -514,25 +537,8 @@ llvm::Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
     if (!RSCAndPoints.RSC.SCDesc)
       continue;
-    // Bucket sched class points into sched class clusters.
-    std::vector<SchedClassCluster> SchedClassClusters;
-    for (const size_t PointId : RSCAndPoints.PointIds) {
-      const auto &ClusterId = Clustering_.getClusterIdForPoint(PointId);
-      if (!ClusterId.isValid())
-        continue; // Ignore noise and errors. FIXME: take noise into account ?
-      if (ClusterId.isUnstable() ^ AnalysisDisplayUnstableOpcodes_)
-        continue; // Either display stable or unstable clusters only.
-      auto SchedClassClusterIt =
-          std::find_if(SchedClassClusters.begin(), SchedClassClusters.end(),
-                       [ClusterId](const SchedClassCluster &C) {
-                         return C.id() == ClusterId;
-                       });
-      if (SchedClassClusterIt == SchedClassClusters.end()) {
-        SchedClassClusters.emplace_back();
-        SchedClassClusterIt = std::prev(SchedClassClusters.end());
-      }
-      SchedClassClusterIt->addPoint(PointId, Clustering_);
-    }
+    const std::vector<SchedClassCluster> SchedClassClusters =
+        makeSchedClassClusters(RSCAndPoints);
 
     // Print any scheduling class that has at least one cluster that does not
     // match the checked-in data.
@@ -563,5 +569,69 @@ llvm::Error Analysis::run<Analysis::PrintSchedClassInconsistencies>(
   return llvm::Error::success();
 }
 
+template <>
+llvm::Error
+Analysis::run<Analysis::PrintSchedModelDiff>(llvm::raw_ostream &OS) const {
+  const auto &Points = Clustering_.getPoints();
+  if (Points.empty())
+    return llvm::Error::success();
+  const InstructionBenchmark::ModeE Mode = Points.front().Mode;
+
+  // Write the header: the measured value of every measurement, followed by
+  // the value predicted by the scheduling model.
+  OS << "sched_class" << kCsvSep << "cluster_id" << kCsvSep << "opcode_names"
+     << kCsvSep << "matches";
+  for (const auto &Measurement : Points.front().Measurements) {
+    OS << kCsvSep;
+    writeEscaped<kEscapeCsv>(OS, Measurement.Key);
+    OS << kCsvSep;
+    writeEscaped<kEscapeCsv>(OS, Measurement.Key + "_model");
+  }
+  OS << "\n";
+
+  // Write one row per sched class cluster.
+  for (const auto &RSCAndPoints : makePointsPerSchedClass()) {
+    if (!RSCAndPoints.RSC.SCDesc)
+      continue;
+    for (const SchedClassCluster &Cluster :
+         makeSchedClassClusters(RSCAndPoints)) {
+#if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
+      writeEscaped<kEscapeCsv>(OS, RSCAndPoints.RSC.SCDesc->Name);
+#else
+      OS << RSCAndPoints.RSC.SchedClassId;
+#endif
+      OS << kCsvSep;
+      writeClusterId<kEscapeCsv>(OS, Cluster.id());
+      OS << kCsvSep;
+      std::set<llvm::StringRef> OpcodeNames;
+      for (const size_t PointId : Cluster.getPointIds())
+        OpcodeNames.insert(InstrInfo_->getName(
+            Points[PointId].keyInstruction().getOpcode()));
+      writeEscaped<kEscapeCsv>(OS, llvm::join(OpcodeNames, " "));
+      OS << kCsvSep
+         << Cluster.measurementsMatch(*SubtargetInfo_, RSCAndPoints.RSC,
+                                      Clustering_,
+                                      AnalysisInconsistencyEpsilonSquared_);
+      const auto &Stats = Cluster.getCentroid().getStats();
+      // The model may not be able to predict anything (e.g. in uops mode),
+      // in which case the predicted values are left empty.
+      const std::vector<BenchmarkMeasure> SchedClassPoint =
+          Cluster.getCentroid().validate(Mode)
+              ? RSCAndPoints.RSC.getAsPoint(Mode, *SubtargetInfo_, Stats)
+              : std::vector<BenchmarkMeasure>();
+      for (size_t I = 0, E = Stats.size(); I < E; ++I) {
+        OS << kCsvSep;
+        writeMeasurementValue<kEscapeCsv>(OS, Stats[I].avg());
+        OS << kCsvSep;
+        if (I < SchedClassPoint.size())
+          writeMeasurementValue<kEscapeCsv>(
+              OS, SchedClassPoint[I].PerInstructionValue);
+      }
+      OS << "\n";
+    }
+  }
+  return llvm::Error::success();
+}
+
 } // namespace exegesis
 } // namespace llvm
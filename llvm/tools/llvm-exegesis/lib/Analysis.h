@@ -46,6 +46,9 @@ public:
   struct PrintClusters {};
   // Find potential errors in the scheduling information given measurements.
   struct PrintSchedClassInconsistencies {};
+  // Prints a csv comparing the measurements of every cluster of every sched
+  // class with the values predicted by the scheduling model.
+  struct PrintSchedModelDiff {};
 
   template <typename Pass> llvm::Error run(llvm::raw_ostream &OS) const;
 
@@ -102,6 +105,10 @@ private:
   // Builds a list of ResolvedSchedClassAndPoints.
   std::vector<ResolvedSchedClassAndPoints> makePointsPerSchedClass() const;
 
+  // Buckets the valid points of a sched class into sched class clusters.
+  std::vector<SchedClassCluster>
+  makeSchedClassClusters(const ResolvedSchedClassAndPoints &RSCAndPoints) const;
+
   template <typename EscapeTag, EscapeTag Tag>
   void writeSnippet(llvm::raw_ostream &OS, llvm::ArrayRef<uint8_t> Bytes,
                     const char *Separator) const;
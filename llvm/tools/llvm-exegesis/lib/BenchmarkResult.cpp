@@ -404,9 +404,9 @@ llvm::Error InstructionBenchmark::writeYaml(const LLVMState &State,
       return Err;
   } else {
     int ResultFD = 0;
-    if (auto E = llvm::errorCodeToError(
-            openFileForWrite(Filename, ResultFD, llvm::sys::fs::CD_CreateAlways,
-                             llvm::sys::fs::OF_Text))) {
+    if (auto E = llvm::errorCodeToError(openFileForWrite(
+            Filename, ResultFD, llvm::sys::fs::CD_OpenAlways,
+            llvm::sys::fs::OF_Append | llvm::sys::fs::OF_Text))) {
       return E;
     }
     llvm::raw_fd_ostream Ostr(ResultFD, true /*shouldClose*/);
@@ -85,6 +85,7 @@ struct InstructionBenchmark {
   // Write functions, non-const because of YAML traits.
   llvm::Error writeYamlTo(const LLVMState &State, llvm::raw_ostream &S);
 
+  // Appends the benchmark to `Filename` as a new document.
   llvm::Error writeYaml(const LLVMState &State, const llvm::StringRef Filename);
 };
 
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <array>
+#include <mutex>
 #include <string>
 
 #include "Assembler.h"
@@ -73,13 +74,15 @@ private:
       Scratch->clear();
       {
         llvm::CrashRecoveryContext CRC;
+        // Crash recovery is left enabled afterwards: the handlers are process
+        // wide, and disabling them would break the recovery of snippets that
+        // other benchmark runners execute in parallel.
         llvm::CrashRecoveryContext::Enable();
         const bool Crashed = !CRC.RunSafely([this, &Counter, ScratchPtr]() {
           Counter.start();
           this->Function(ScratchPtr);
           Counter.stop();
         });
-        llvm::CrashRecoveryContext::Disable();
         // FIXME: Better diagnosis.
         if (Crashed)
           return llvm::make_error<BenchmarkFailure>(
@@ -139,8 +142,12 @@ BenchmarkRunner::runConfiguration(const BenchmarkCode &BC,
       InstrBenchmark.Error = llvm::toString(std::move(E));
       return InstrBenchmark;
     }
-    llvm::outs() << "Check generated assembly with: /usr/bin/objdump -d "
-                 << *ObjectFilePath << "\n";
+    {
+      static std::mutex OutputLock;
+      std::lock_guard<std::mutex> Lock(OutputLock);
+      llvm::outs() << "Check generated assembly with: /usr/bin/objdump -d "
+                   << *ObjectFilePath << "\n";
+    }
     ObjectFile = getObjectFromFile(*ObjectFilePath);
   } else {
     llvm::SmallString<0> Buffer;
@@ -19,7 +19,9 @@
 #include "lib/PerfHelper.h"
 #include "lib/Target.h"
 #include "lib/TargetSelect.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/MC/MCInstBuilder.h"
 #include "llvm/MC/MCObjectFileInfo.h"
@@ -36,7 +38,13 @@
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 namespace llvm {
 namespace exegesis {
@@ -144,6 +152,24 @@ static cl::opt<bool>
                               "and prints a message to access it"),
                      cl::cat(BenchmarkOptions), cl::init(true));
 
+static cl::list<unsigned> BenchmarkCpus(
+    "benchmark-cpus",
+    cl::desc("comma-separated list of cpus to measure on in parallel, with one "
+             "worker pinned to each (preferably isolated) cpu"),
+    cl::cat(BenchmarkOptions), cl::CommaSeparated);
+
+static cl::opt<bool> IncrementalBenchmarks(
+    "incremental",
+    cl::desc("keep the results already in the benchmarks file, and only "
+             "measure the configurations that are not in there yet"),
+    cl::cat(BenchmarkOptions), cl::init(false));
+
+static cl::opt<std::string> AnalysisSchedModelDiffOutputFile(
+    "analysis-sched-model-diff-output-file",
+    cl::desc("csv file comparing every cluster of every sched class with the "
+             "scheduling model"),
+    cl::cat(AnalysisOptions), cl::init(""));
+
 static ExitOnError ExitOnErr;
 
 // Checks that only one of OpcodeNames, OpcodeIndex or SnippetsFile is provided,
@@ -355,6 +381,73 @@ readSnippets(const LLVMState &State, llvm::StringRef Filename) {
   return std::vector<BenchmarkCode>{std::move(Result)};
 }
 
+// Identifies the configurations that are measured the same way: the opcodes
+// of their instructions, how they were generated, and the mode and cpu they are
+// measured with. Registers are left out, as snippet generation randomizes them.
+static std::string getBenchmarkId(const llvm::MCInstrInfo &InstrInfo,
+                                  InstructionBenchmark::ModeE Mode,
+                                  llvm::StringRef CpuName,
+                                  llvm::ArrayRef<llvm::MCInst> Instructions,
+                                  llvm::StringRef Info) {
+  std::string Id;
+  llvm::raw_string_ostream OS(Id);
+  OS << Mode << '/' << CpuName << '/';
+  for (const llvm::MCInst &Inst : Instructions)
+    OS << InstrInfo.getName(Inst.getOpcode()) << ',';
+  OS << '/' << Info;
+  return OS.str();
+}
+
+// Removes the configurations whose results are already in `BenchmarkFile`.
+static void removeMeasuredConfigurations(
+    const LLVMState &State, std::vector<BenchmarkCode> &Configurations) {
+  if (!llvm::sys::fs::exists(BenchmarkFile))
+    return;
+  const llvm::MCInstrInfo &InstrInfo = State.getInstrInfo();
+  llvm::StringSet<> Measured;
+  for (const InstructionBenchmark &Result :
+       ExitOnErr(InstructionBenchmark::readYamls(State, BenchmarkFile))) {
+    // Failed measurements are tried again.
+    if (Result.Error.empty())
+      Measured.insert(getBenchmarkId(InstrInfo, Result.Mode, Result.CpuName,
+                                     Result.Key.Instructions, Result.Info));
+  }
+  const std::string CpuName = State.getTargetMachine().getTargetCPU();
+  const size_t NumConfigurations = Configurations.size();
+  llvm::erase_if(Configurations, [&](const BenchmarkCode &BC) {
+    return Measured.count(getBenchmarkId(InstrInfo, BenchmarkMode, CpuName,
+                                         BC.Instructions, BC.Info));
+  });
+  llvm::errs() << "skipping " << NumConfigurations - Configurations.size()
+               << " configurations already measured in '" << BenchmarkFile
+               << "'\n";
+}
+
+// Pins the calling thread to `Cpu`, so that its measurements are neither
+// disturbed by migrations nor by the workers on other cpus.
+static void pinCurrentThreadToCpu(unsigned Cpu) {
+#ifdef __linux__
+  cpu_set_t CpuSet;
+  CPU_ZERO(&CpuSet);
+  CPU_SET(Cpu, &CpuSet);
+  if (sched_setaffinity(0, sizeof(CpuSet), &CpuSet) != 0)
+    llvm::report_fatal_error(llvm::Twine("cannot pin benchmark worker to cpu ")
+                                 .concat(llvm::Twine(Cpu)));
+#else
+  llvm::report_fatal_error("--benchmark-cpus is only supported on Linux");
+#endif
+}
+
+static std::unique_ptr<BenchmarkRunner>
+createBenchmarkRunnerOrDie(const LLVMState &State) {
+  std::unique_ptr<BenchmarkRunner> Runner =
+      State.getExegesisTarget().createBenchmarkRunner(BenchmarkMode, State);
+  if (!Runner) {
+    llvm::report_fatal_error("cannot create benchmark runner");
+  }
+  return Runner;
+}
+
 void benchmarkMain() {
 #ifndef HAVE_LIBPFM
   llvm::report_fatal_error(
@@ -397,12 +490,6 @@ void benchmarkMain() {
     Configurations = ExitOnErr(readSnippets(State, SnippetsFile));
   }
 
-  const std::unique_ptr<BenchmarkRunner> Runner =
-      State.getExegesisTarget().createBenchmarkRunner(BenchmarkMode, State);
-  if (!Runner) {
-    llvm::report_fatal_error("cannot create benchmark runner");
-  }
-
   if (NumRepetitions == 0)
     llvm::report_fatal_error("--num-repetitions must be greater than zero");
 
@@ -410,10 +497,51 @@ void benchmarkMain() {
   if (BenchmarkFile.empty())
     BenchmarkFile = "-";
 
-  for (const BenchmarkCode &Conf : Configurations) {
-    InstructionBenchmark Result =
-        Runner->runConfiguration(Conf, NumRepetitions, DumpObjectToDisk);
-    ExitOnErr(Result.writeYaml(State, BenchmarkFile));
+  // Results are appended to the benchmarks file as they are measured, so that
+  // an interrupted sweep can be resumed with --incremental.
+  if (BenchmarkFile != "-") {
+    if (IncrementalBenchmarks)
+      removeMeasuredConfigurations(State, Configurations);
+    else if (std::error_code EC = llvm::sys::fs::remove(BenchmarkFile))
+      llvm::report_fatal_error("cannot remove '" + BenchmarkFile +
+                               "': " + EC.message());
+  } else if (IncrementalBenchmarks) {
+    llvm::report_fatal_error("--incremental requires --benchmarks-file");
+  }
+
+  if (BenchmarkCpus.empty()) {
+    const std::unique_ptr<BenchmarkRunner> Runner =
+        createBenchmarkRunnerOrDie(State);
+    for (const BenchmarkCode &Conf : Configurations) {
+      InstructionBenchmark Result =
+          Runner->runConfiguration(Conf, NumRepetitions, DumpObjectToDisk);
+      ExitOnErr(Result.writeYaml(State, BenchmarkFile));
+    }
+  } else {
+    // Standard output is where the runners report the objects they dump.
+    if (BenchmarkFile == "-")
+      llvm::report_fatal_error("--benchmark-cpus requires --benchmarks-file");
+    // Every worker has a runner of its own, and takes the next configuration
+    // to measure off a shared queue; results are written in completion order.
+    std::atomic<size_t> NextConfiguration(0);
+    std::mutex ResultLock;
+    std::vector<std::thread> Workers;
+    for (const unsigned Cpu : BenchmarkCpus) {
+      Workers.emplace_back([&, Cpu]() {
+        pinCurrentThreadToCpu(Cpu);
+        const std::unique_ptr<BenchmarkRunner> Runner =
+            createBenchmarkRunnerOrDie(State);
+        for (size_t I = NextConfiguration++; I < Configurations.size();
+             I = NextConfiguration++) {
+          InstructionBenchmark Result = Runner->runConfiguration(
+              Configurations[I], NumRepetitions, DumpObjectToDisk);
+          std::lock_guard<std::mutex> Lock(ResultLock);
+          ExitOnErr(Result.writeYaml(State, BenchmarkFile));
+        }
+      });
+    }
+    for (std::thread &Worker : Workers)
+      Worker.join();
   }
   exegesis::pfm::pfmTerminate();
 }
@@ -444,10 +572,12 @@ static void analysisMain() {
     llvm::report_fatal_error("--benchmarks-file must be set.");
 
   if (AnalysisClustersOutputFile.empty() &&
-      AnalysisInconsistenciesOutputFile.empty()) {
+      AnalysisInconsistenciesOutputFile.empty() &&
+      AnalysisSchedModelDiffOutputFile.empty()) {
     llvm::report_fatal_error(
-        "At least one of --analysis-clusters-output-file and "
-        "--analysis-inconsistencies-output-file must be specified.");
+        "At least one of --analysis-clusters-output-file, "
+        "--analysis-inconsistencies-output-file and "
+        "--analysis-sched-model-diff-output-file must be specified.");
   }
 
   llvm::InitializeNativeTarget();
@@ -488,6 +618,8 @@ static void analysisMain() {
   maybeRunAnalysis<Analysis::PrintSchedClassInconsistencies>(
       Analyzer, "sched class consistency analysis",
       AnalysisInconsistenciesOutputFile);
+  maybeRunAnalysis<Analysis::PrintSchedModelDiff>(
+      Analyzer, "sched model diff", AnalysisSchedModelDiffOutputFile);
 }
 
 } // namespace exegesis
@@ -138,9 +138,12 @@ int main(int argc, char **argv) {
   cl::HideUnrelatedOptions(ExtractCat);
   cl::ParseCommandLineOptions(argc, argv, "llvm extractor\n");
 
-  // Use lazy loading, since we only care about selected global values.
+  // Use lazy loading, since we only care about selected global values. This
+  // includes the metadata, which is then only read for the functions that are
+  // extracted.
   SMDiagnostic Err;
-  std::unique_ptr<Module> M = getLazyIRFileModule(InputFilename, Err, Context);
+  std::unique_ptr<Module> M = getLazyIRFileModule(
+      InputFilename, Err, Context, /*ShouldLazyLoadMetadata=*/true);
 
   if (!M.get()) {
     Err.print(argv[0], errs());
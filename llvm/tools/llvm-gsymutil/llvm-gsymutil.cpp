@@ -0,0 +1,209 @@
+//===-- llvm-gsymutil.cpp - GSYM dumping and creation utility for llvm ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This program converts DWARF, symbol tables and Breakpad symbol files into
+// GSYM files, and dumps and looks up addresses in GSYM files.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/BreakpadTransformer.h"
+#include "llvm/DebugInfo/GSYM/DwarfTransformer.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/ObjectFileTransformer.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace gsym;
+using namespace object;
+
+namespace {
+cl::OptionCategory GeneralOptions("Options");
+cl::OptionCategory ConversionOptions("Conversion Options");
+cl::OptionCategory LookupOptions("Lookup Options");
+
+static cl::list<std::string> InputFilenames(cl::Positional,
+                                            cl::desc("<input GSYM files>"),
+                                            cl::ZeroOrMore,
+                                            cl::cat(GeneralOptions));
+
+static cl::opt<bool> Verbose("verbose",
+                             cl::desc("Enable verbose logging and encoding "
+                                      "details."),
+                             cl::cat(GeneralOptions));
+
+static cl::opt<std::string>
+    ConvertFilename("convert", cl::init(""),
+                    cl::desc("Convert the specified object file or Breakpad "
+                             "symbol file into GSYM format."),
+                    cl::value_desc("path"), cl::cat(ConversionOptions));
+
+static cl::opt<std::string>
+    OutputFilename("out-file", cl::init(""),
+                   cl::desc("Specify the path where the converted GSYM file "
+                            "will be saved. When not specified, a '.gsym' "
+                            "extension will be appended to the file name "
+                            "specified in the --convert option."),
+                   cl::value_desc("path"), cl::cat(ConversionOptions));
+static cl::alias OutputFilenameAlias("o", cl::desc("Alias for --out-file."),
+                                     cl::aliasopt(OutputFilename),
+                                     cl::cat(ConversionOptions));
+
+static cl::opt<unsigned>
+    NumThreads("num-threads",
+               cl::desc("Specify the maximum number of threads that can be "
+                        "used to convert the debug info, 0 means one per "
+                        "hardware thread."),
+               cl::init(0), cl::cat(ConversionOptions));
+
+static cl::list<unsigned long long> LookupAddresses(
+    "address", cl::desc("Lookup an address in a GSYM file"), cl::ZeroOrMore,
+    cl::value_desc("addr"), cl::cat(LookupOptions));
+static cl::alias LookupAddressesAlias("a", cl::desc("Alias for --address."),
+                                      cl::aliasopt(LookupAddresses),
+                                      cl::cat(LookupOptions));
+} // namespace
+
+static void error(StringRef Prefix, llvm::Error Err) {
+  if (!Err)
+    return;
+  WithColor::error() << Prefix << ": " << toString(std::move(Err)) << '\n';
+  exit(1);
+}
+
+static void error(StringRef Prefix, std::error_code EC) {
+  if (!EC)
+    return;
+  WithColor::error() << Prefix << ": " << EC.message() << '\n';
+  exit(1);
+}
+
+static llvm::Error convertObject(ObjectFile &Obj, raw_ostream &Log,
+                                 StringRef OutFile) {
+  GsymCreator Gsym;
+
+  // Only functions that are in the text sections are converted.
+  AddressRanges TextRanges;
+  for (const SectionRef &Sect : Obj.sections()) {
+    if (!Sect.isText())
+      continue;
+    const uint64_t Size = Sect.getSize();
+    if (Size == 0)
+      continue;
+    const uint64_t StartAddr = Sect.getAddress();
+    TextRanges.insert(AddressRange(StartAddr, StartAddr + Size));
+  }
+  if (!TextRanges.empty())
+    Gsym.setValidTextRanges(TextRanges);
+
+  // The debug info is converted first, so that the symbol table only fills in
+  // the functions that it doesn't describe.
+  std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(Obj);
+  DwarfTransformer DT(*DICtx, Log, Gsym);
+  if (auto Err = DT.convert(NumThreads))
+    return Err;
+  if (auto Err = ObjectFileTransformer::convert(Obj, Log, Gsym))
+    return Err;
+  if (auto Err = Gsym.finalize(Log))
+    return Err;
+  return Gsym.save(OutFile, Obj.isLittleEndian() ? support::little
+                                                 : support::big);
+}
+
+static llvm::Error convertBreakpad(StringRef Text, raw_ostream &Log,
+                                   StringRef OutFile) {
+  GsymCreator Gsym;
+  if (auto Err = BreakpadTransformer::convert(Text, Log, Gsym))
+    return Err;
+  if (auto Err = Gsym.finalize(Log))
+    return Err;
+  // Breakpad files don't say which byte order the binary used.
+  return Gsym.save(OutFile, support::endian::system_endianness());
+}
+
+static void convertFile(StringRef InFile, StringRef OutFile) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
+      MemoryBuffer::getFileOrSTDIN(InFile);
+  error(InFile, BuffOrErr.getError());
+  std::unique_ptr<MemoryBuffer> Buffer = std::move(BuffOrErr.get());
+
+  raw_ostream &Log = Verbose ? outs() : nulls();
+  if (Buffer->getBuffer().startswith("MODULE ")) {
+    error(InFile, convertBreakpad(Buffer->getBuffer(), Log, OutFile));
+    return;
+  }
+
+  Expected<std::unique_ptr<ObjectFile>> ObjOrErr =
+      ObjectFile::createObjectFile(Buffer->getMemBufferRef());
+  error(InFile, ObjOrErr.takeError());
+  error(InFile, convertObject(**ObjOrErr, Log, OutFile));
+}
+
+static void dumpFile(StringRef Path) {
+  Expected<GsymReader> ReaderOrErr = GsymReader::openFile(Path);
+  error(Path, ReaderOrErr.takeError());
+  GsymReader &Reader = *ReaderOrErr;
+
+  if (LookupAddresses.empty()) {
+    outs() << Reader.getHeader() << '\n';
+    if (!Verbose)
+      return;
+    for (uint32_t I = 0, E = Reader.getNumAddresses(); I != E; ++I) {
+      Expected<FunctionInfo> FI = Reader.getFunctionInfo(*Reader.getAddress(I));
+      if (FI)
+        outs() << *FI << '\n';
+      else
+        WithColor::warning() << toString(FI.takeError()) << '\n';
+    }
+    return;
+  }
+
+  for (uint64_t Addr : LookupAddresses) {
+    if (Expected<LookupResult> LR = Reader.lookup(Addr))
+      outs() << *LR;
+    else
+      outs() << HEX64(Addr) << ": " << toString(LR.takeError()) << '\n';
+  }
+}
+
+int main(int argc, char const *argv[]) {
+  InitLLVM X(argc, argv);
+
+  cl::HideUnrelatedOptions(
+      {&GeneralOptions, &ConversionOptions, &LookupOptions});
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "Convert debug info, symbol tables and Breakpad symbol files into GSYM "
+      "files, and dump and lookup addresses in GSYM files.\n");
+
+  if (!ConvertFilename.empty()) {
+    std::string OutFile = OutputFilename;
+    if (OutFile.empty())
+      OutFile = ConvertFilename + ".gsym";
+    convertFile(ConvertFilename, OutFile);
+    // Lookup addresses in the new GSYM file if any were requested.
+    if (!LookupAddresses.empty())
+      dumpFile(OutFile);
+    return 0;
+  }
+
+  if (InputFilenames.empty()) {
+    WithColor::error() << "no input files\n";
+    return 1;
+  }
+  for (const std::string &Path : InputFilenames)
+    dumpFile(Path);
+  return 0;
+}
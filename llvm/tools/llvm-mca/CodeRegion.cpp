@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "CodeRegion.h"
+#include "llvm/MC/MCExpr.h"
 
 namespace llvm {
 namespace mca {
@@ -44,17 +45,17 @@ void CodeRegions::beginRegion(StringRef Description, SMLoc Loc) {
     if (It != ActiveRegions.end()) {
       const CodeRegion &R = *Regions[It->second];
       if (Description.empty()) {
-        SM.PrintMessage(Loc, SourceMgr::DK_Error,
+        SM.PrintMessage(Loc, llvm::SourceMgr::DK_Error,
                         "found multiple overlapping anonymous regions");
-        SM.PrintMessage(R.startLoc(), SourceMgr::DK_Note,
+        SM.PrintMessage(R.startLoc(), llvm::SourceMgr::DK_Note,
                         "Previous anonymous region was defined here");
         FoundErrors = true;
         return;
       }
 
-      SM.PrintMessage(Loc, SourceMgr::DK_Error,
+      SM.PrintMessage(Loc, llvm::SourceMgr::DK_Error,
                       "overlapping regions cannot have the same name");
-      SM.PrintMessage(R.startLoc(), SourceMgr::DK_Note,
+      SM.PrintMessage(R.startLoc(), llvm::SourceMgr::DK_Note,
                       "region " + Description + " was previously defined here");
       FoundErrors = true;
       return;
@@ -95,22 +96,82 @@ void CodeRegions::endRegion(StringRef Description, SMLoc Loc) {
   }
 
   FoundErrors = true;
-  SM.PrintMessage(Loc, SourceMgr::DK_Error,
+  SM.PrintMessage(Loc, llvm::SourceMgr::DK_Error,
                   "found an invalid region end directive");
   if (!Description.empty()) {
-    SM.PrintMessage(Loc, SourceMgr::DK_Note,
+    SM.PrintMessage(Loc, llvm::SourceMgr::DK_Note,
                     "unable to find an active region named " + Description);
   } else {
-    SM.PrintMessage(Loc, SourceMgr::DK_Note,
+    SM.PrintMessage(Loc, llvm::SourceMgr::DK_Note,
                     "unable to find an active anonymous region");
   }
 }
 
 void CodeRegions::addInstruction(const MCInst &Instruction) {
   SMLoc Loc = Instruction.getLoc();
+  // The comments on the line of an instruction are parsed before the
+  // instruction is added, so an annotation applies to the first instruction
+  // that follows it in the source.
+  unsigned TakenPercent = 0;
+  bool IsTaken = false;
+  if (!PendingTaken.empty() &&
+      PendingTaken.back().first.getPointer() < Loc.getPointer()) {
+    TakenPercent = PendingTaken.back().second;
+    IsTaken = true;
+    PendingTaken.clear();
+  }
+
+  for (UniqueCodeRegion &Region : Regions) {
+    if (Region->isLocInRange(Loc)) {
+      Region->addInstruction(Instruction);
+      if (IsTaken)
+        Region->addTakenBranch(TakenPercent);
+    }
+  }
+}
+
+void CodeRegions::addLabel(const MCSymbol *Symbol, SMLoc Loc) {
   for (UniqueCodeRegion &Region : Regions)
     if (Region->isLocInRange(Loc))
-      Region->addInstruction(Instruction);
+      Region->addLabel(Symbol);
+}
+
+void CodeRegions::addTakenAnnotation(StringRef Percent, SMLoc Loc) {
+  unsigned Value;
+  if (Percent.trim().getAsInteger(10, Value) || Value > 100) {
+    SM.PrintMessage(Loc, llvm::SourceMgr::DK_Error,
+                    "LLVM-MCA-TAKEN expects a percentage between 0 and 100");
+    FoundErrors = true;
+    return;
+  }
+  PendingTaken.emplace_back(Loc, Value);
+}
+
+bool CodeRegion::getBranches(std::vector<BranchInfo> &Branches,
+                             llvm::SourceMgr &SM) const {
+  for (const std::pair<unsigned, unsigned> &TB : TakenBranches) {
+    const MCInst &MCI = Instructions[TB.first];
+    // The target is the first symbol operand of the branch.
+    const MCSymbol *Target = nullptr;
+    for (const MCOperand &Op : MCI) {
+      if (!Op.isExpr())
+        continue;
+      if (const auto *SRE = dyn_cast<MCSymbolRefExpr>(Op.getExpr())) {
+        Target = &SRE->getSymbol();
+        break;
+      }
+    }
+
+    auto It = Target ? Labels.find(Target) : Labels.end();
+    if (It == Labels.end() || It->second <= TB.first) {
+      SM.PrintMessage(MCI.getLoc(), llvm::SourceMgr::DK_Error,
+                      "a branch annotated with LLVM-MCA-TAKEN must branch "
+                      "forward to a label in the same code region");
+      return false;
+    }
+    Branches.push_back({TB.first, It->second, TB.second});
+  }
+  return true;
 }
 
 } // namespace mca
@@ -27,6 +27,17 @@
 ///
 /// An instruction (a MCInst) is added to a region R only if its location is in
 /// range [R.RangeStart, R.RangeEnd].
+///
+/// A region is simulated as the body of a loop. A forward branch to a label
+/// later in the region can be annotated with the percentage of the iterations
+/// in which it is taken, on the line before it:
+///
+///   # LLVM-MCA-TAKEN 25
+///     jne .Lskip
+///     ...  ## asm run in 75% of the iterations
+///   .Lskip:
+///
+/// Branches that are not annotated are never taken.
 //
 //===----------------------------------------------------------------------===//
 
@@ -34,9 +45,12 @@
 #define LLVM_TOOLS_LLVM_MCA_CODEREGION_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCSymbol.h"
+#include "llvm/MCA/SourceMgr.h"
 #include "llvm/Support/SMLoc.h"
 #include "llvm/Support/SourceMgr.h"
 #include <vector>
@@ -55,6 +69,12 @@ class CodeRegion {
   // Source location range.
   llvm::SMLoc RangeStart;
   llvm::SMLoc RangeEnd;
+  // Labels in this region, with the index of the instruction that follows
+  // each of them.
+  llvm::DenseMap<const llvm::MCSymbol *, unsigned> Labels;
+  // Branches annotated with LLVM-MCA-TAKEN: the index of the instruction and
+  // the percentage of the iterations in which it is taken.
+  llvm::SmallVector<std::pair<unsigned, unsigned>, 2> TakenBranches;
 
   CodeRegion(const CodeRegion &) = delete;
   CodeRegion &operator=(const CodeRegion &) = delete;
@@ -67,6 +87,22 @@ public:
     Instructions.emplace_back(Instruction);
   }
 
+  void addLabel(const llvm::MCSymbol *Symbol) {
+    Labels[Symbol] = Instructions.size();
+  }
+
+  // Mark the last instruction added as a branch taken in \p TakenPercent
+  // percent of the iterations.
+  void addTakenBranch(unsigned TakenPercent) {
+    TakenBranches.emplace_back(Instructions.size() - 1, TakenPercent);
+  }
+
+  /// Resolve the targets of the annotated branches. Reports an error to \p SM
+  /// and returns false if one of them does not branch to a label later in the
+  /// region.
+  bool getBranches(std::vector<BranchInfo> &Branches,
+                   llvm::SourceMgr &SM) const;
+
   llvm::SMLoc startLoc() const { return RangeStart; }
   llvm::SMLoc endLoc() const { return RangeEnd; }
 
@@ -88,6 +124,8 @@ class CodeRegions {
   using UniqueCodeRegion = std::unique_ptr<CodeRegion>;
   std::vector<UniqueCodeRegion> Regions;
   llvm::StringMap<unsigned> ActiveRegions;
+  // LLVM-MCA-TAKEN annotations not yet applied to a branch.
+  llvm::SmallVector<std::pair<llvm::SMLoc, unsigned>, 1> PendingTaken;
   bool FoundErrors;
 
   CodeRegions(const CodeRegions &) = delete;
@@ -107,6 +145,8 @@ public:
   void beginRegion(llvm::StringRef Description, llvm::SMLoc Loc);
   void endRegion(llvm::StringRef Description, llvm::SMLoc Loc);
   void addInstruction(const llvm::MCInst &Instruction);
+  void addLabel(const llvm::MCSymbol *Symbol, llvm::SMLoc Loc);
+  void addTakenAnnotation(llvm::StringRef Percent, llvm::SMLoc Loc);
   llvm::SourceMgr &getSourceMgr() const { return SM; }
 
   llvm::ArrayRef<llvm::MCInst> getInstructionSequence(unsigned Idx) const {
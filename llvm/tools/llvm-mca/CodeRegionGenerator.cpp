@@ -52,6 +52,12 @@ public:
     Regions.addInstruction(Inst);
   }
 
+  // Labels are the targets of the branches annotated with LLVM-MCA-TAKEN.
+  void EmitLabel(MCSymbol *Symbol, SMLoc Loc) override {
+    MCStreamer::EmitLabel(Symbol, Loc);
+    Regions.addLabel(Symbol, Loc);
+  }
+
   bool EmitSymbolAttribute(MCSymbol *Symbol, MCSymbolAttr Attribute) override {
     return true;
   }
@@ -85,6 +91,11 @@ void MCACommentConsumer::HandleComment(SMLoc Loc, StringRef CommentText) {
     return;
 
   Comment = Comment.drop_front(Position);
+  if (Comment.consume_front("LLVM-MCA-TAKEN")) {
+    Regions.addTakenAnnotation(Comment, Loc);
+    return;
+  }
+
   if (Comment.consume_front("LLVM-MCA-END")) {
     // Skip spaces and tabs.
     Position = Comment.find_first_not_of(" \t");
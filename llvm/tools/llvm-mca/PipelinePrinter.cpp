@@ -21,5 +21,13 @@ void PipelinePrinter::printReport(llvm::raw_ostream &OS) const {
   for (const auto &V : Views)
     V->printView(OS);
 }
+
+void PipelinePrinter::printReport(llvm::json::Object &JO) const {
+  for (const auto &V : Views) {
+    StringRef Name = V->getNameAsString();
+    if (!Name.empty())
+      JO[Name] = V->toJSON();
+  }
+}
 } // namespace mca.
 } // namespace llvm
@@ -46,6 +46,9 @@ public:
   }
 
   void printReport(llvm::raw_ostream &OS) const;
+
+  /// Add the views that are part of the JSON report to \p JO.
+  void printReport(llvm::json::Object &JO) const;
 };
 } // namespace mca
 } // namespace llvm
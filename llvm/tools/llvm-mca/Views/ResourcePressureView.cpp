@@ -180,5 +180,31 @@ void ResourcePressureView::printResourcePressurePerInst(raw_ostream &OS) const {
     ++InstrIndex;
   }
 }
+
+json::Value ResourcePressureView::toJSON() const {
+  // The average number of cycles every resource unit is busy per iteration,
+  // keyed by the name of the resource and the index of the unit.
+  json::Object ResourcePressure;
+  const MCSchedModel &SM = STI.getSchedModel();
+  const unsigned Executions = LastInstructionIdx / Source.size() + 1;
+  for (unsigned I = 1, E = SM.getNumProcResourceKinds(); I < E; ++I) {
+    const MCProcResourceDesc &ProcResource = *SM.getProcResource(I);
+    unsigned NumUnits = ProcResource.NumUnits;
+    // Skip groups and invalid resources with zero units.
+    if (ProcResource.SubUnitsIdxBegin || !NumUnits)
+      continue;
+
+    unsigned R2VIndex = Resource2VecIndex.find(I)->second;
+    for (unsigned J = 0; J < NumUnits; ++J) {
+      std::string Name = ProcResource.Name;
+      if (NumUnits > 1)
+        Name += "." + std::to_string(J);
+      double Usage =
+          ResourceUsage[R2VIndex + J + Source.size() * NumResourceUnits];
+      ResourcePressure[Name] = Usage / Executions;
+    }
+  }
+  return json::Object({{"ResourcePressure", std::move(ResourcePressure)}});
+}
 } // namespace mca
 } // namespace llvm
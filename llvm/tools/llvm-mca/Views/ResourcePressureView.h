@@ -96,6 +96,10 @@ public:
     printResourcePressurePerIter(OS);
     printResourcePressurePerInst(OS);
   }
+  llvm::StringRef getNameAsString() const override {
+    return "ResourcePressureView";
+  }
+  llvm::json::Value toJSON() const override;
 };
 } // namespace mca
 } // namespace llvm
@@ -26,7 +26,7 @@ SummaryView::SummaryView(const MCSchedModel &Model, ArrayRef<MCInst> S,
                          unsigned Width)
     : SM(Model), Source(S), DispatchWidth(Width?Width: Model.IssueWidth),
       LastInstructionIdx(0),
-      TotalCycles(0), NumMicroOps(0),
+      TotalCycles(0), NumMicroOps(0), TotalInstructions(0), TotalMicroOps(0),
       ProcResourceUsage(Model.getNumProcResourceKinds(), 0),
       ProcResourceMasks(Model.getNumProcResourceKinds()),
       ResIdx2ProcResID(Model.getNumProcResourceKinds(), 0) {
@@ -41,8 +41,14 @@ void SummaryView::onEvent(const HWInstructionEvent &Event) {
   if (Event.Type == HWInstructionEvent::Dispatched)
     LastInstructionIdx = Event.IR.getSourceIndex();
 
-  // We are only interested in the "instruction retired" events generated by
-  // the retire stage for instructions that are part of iteration #0.
+  if (Event.Type == HWInstructionEvent::Retired) {
+    ++TotalInstructions;
+    TotalMicroOps += Event.IR.getInstruction()->getDesc().NumMicroOps;
+  }
+
+  // The block throughput is computed from the "instruction retired" events
+  // generated by the retire stage for instructions that are part of iteration
+  // #0, which runs every instruction of the block.
   if (Event.Type != HWInstructionEvent::Retired ||
       Event.IR.getSourceIndex() >= Source.size())
     return;
@@ -62,33 +68,52 @@ void SummaryView::onEvent(const HWInstructionEvent &Event) {
   }
 }
 
-void SummaryView::printView(raw_ostream &OS) const {
-  unsigned Instructions = Source.size();
-  unsigned Iterations = (LastInstructionIdx / Instructions) + 1;
-  unsigned TotalInstructions = Instructions * Iterations;
-  unsigned TotalUOps = NumMicroOps * Iterations;
-  double IPC = (double)TotalInstructions / TotalCycles;
-  double UOpsPerCycle = (double)TotalUOps / TotalCycles;
-  double BlockRThroughput = computeBlockRThroughput(
+void SummaryView::collectData(DisplayValues &DV) const {
+  DV.Iterations = (LastInstructionIdx / Source.size()) + 1;
+  DV.TotalInstructions = TotalInstructions;
+  DV.TotalCycles = TotalCycles;
+  DV.DispatchWidth = DispatchWidth;
+  DV.TotalUOps = TotalMicroOps;
+  DV.IPC = (double)DV.TotalInstructions / DV.TotalCycles;
+  DV.UOpsPerCycle = (double)DV.TotalUOps / DV.TotalCycles;
+  DV.BlockRThroughput = computeBlockRThroughput(
       SM, DispatchWidth, NumMicroOps, ProcResourceUsage);
+}
+
+void SummaryView::printView(raw_ostream &OS) const {
+  DisplayValues DV;
+  collectData(DV);
 
   std::string Buffer;
   raw_string_ostream TempStream(Buffer);
-  TempStream << "Iterations:        " << Iterations;
-  TempStream << "\nInstructions:      " << TotalInstructions;
-  TempStream << "\nTotal Cycles:      " << TotalCycles;
-  TempStream << "\nTotal uOps:        " << TotalUOps << '\n';
-  TempStream << "\nDispatch Width:    " << DispatchWidth;
+  TempStream << "Iterations:        " << DV.Iterations;
+  TempStream << "\nInstructions:      " << DV.TotalInstructions;
+  TempStream << "\nTotal Cycles:      " << DV.TotalCycles;
+  TempStream << "\nTotal uOps:        " << DV.TotalUOps << '\n';
+  TempStream << "\nDispatch Width:    " << DV.DispatchWidth;
   TempStream << "\nuOps Per Cycle:    "
-             << format("%.2f", floor((UOpsPerCycle * 100) + 0.5) / 100);
+             << format("%.2f", floor((DV.UOpsPerCycle * 100) + 0.5) / 100);
   TempStream << "\nIPC:               "
-             << format("%.2f", floor((IPC * 100) + 0.5) / 100);
+             << format("%.2f", floor((DV.IPC * 100) + 0.5) / 100);
   TempStream << "\nBlock RThroughput: "
-             << format("%.1f", floor((BlockRThroughput * 10) + 0.5) / 10)
+             << format("%.1f", floor((DV.BlockRThroughput * 10) + 0.5) / 10)
              << '\n';
   TempStream.flush();
   OS << Buffer;
 }
 
+json::Value SummaryView::toJSON() const {
+  DisplayValues DV;
+  collectData(DV);
+  return json::Object({{"Iterations", DV.Iterations},
+                       {"Instructions", DV.TotalInstructions},
+                       {"TotalCycles", DV.TotalCycles},
+                       {"TotaluOps", DV.TotalUOps},
+                       {"DispatchWidth", DV.DispatchWidth},
+                       {"uOpsPerCycle", DV.UOpsPerCycle},
+                       {"IPC", DV.IPC},
+                       {"BlockRThroughput", DV.BlockRThroughput}});
+}
+
 } // namespace mca.
 } // namespace llvm
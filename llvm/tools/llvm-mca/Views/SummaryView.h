@@ -45,6 +45,11 @@ class SummaryView : public View {
   unsigned TotalCycles;
   // The total number of micro opcodes contributed by a block of instructions.
   unsigned NumMicroOps;
+  // The number of instructions and micro opcodes retired over all the
+  // iterations. Forward branches in the block make these smaller than the
+  // size of the block times the number of iterations.
+  unsigned TotalInstructions;
+  unsigned TotalMicroOps;
 
   // For each processor resource, this vector stores the cumulative number of
   // resource cycles consumed by the analyzed code block.
@@ -65,6 +70,19 @@ class SummaryView : public View {
   //   - Total Resource Cycles / #Units   (for every resource consumed).
   double getBlockRThroughput() const;
 
+  struct DisplayValues {
+    unsigned Iterations;
+    unsigned TotalInstructions;
+    unsigned TotalCycles;
+    unsigned DispatchWidth;
+    unsigned TotalUOps;
+    double IPC;
+    double UOpsPerCycle;
+    double BlockRThroughput;
+  };
+
+  void collectData(DisplayValues &DV) const;
+
 public:
   SummaryView(const llvm::MCSchedModel &Model, llvm::ArrayRef<llvm::MCInst> S,
               unsigned Width);
@@ -72,6 +90,8 @@ public:
   void onCycleEnd() override { ++TotalCycles; }
   void onEvent(const HWInstructionEvent &Event) override;
   void printView(llvm::raw_ostream &OS) const override;
+  llvm::StringRef getNameAsString() const override { return "SummaryView"; }
+  llvm::json::Value toJSON() const override;
 };
 
 } // namespace mca
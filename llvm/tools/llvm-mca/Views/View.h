@@ -16,6 +16,7 @@
 #define LLVM_TOOLS_LLVM_MCA_VIEW_H
 
 #include "llvm/MCA/HWEventListener.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/raw_ostream.h"
 
 namespace llvm {
@@ -24,6 +25,13 @@ namespace mca {
 class View : public HWEventListener {
 public:
   virtual void printView(llvm::raw_ostream &OS) const = 0;
+
+  /// The name of the view in the JSON report, or an empty string if the view
+  /// is not part of it.
+  virtual llvm::StringRef getNameAsString() const { return ""; }
+  /// The numbers of the view, as written to the JSON report.
+  virtual llvm::json::Value toJSON() const { return nullptr; }
+
   virtual ~View() = default;
   void anchor() override;
 };
@@ -51,14 +51,19 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
+#include <mutex>
 
 using namespace llvm;
 
@@ -102,6 +107,21 @@ static cl::opt<unsigned> Iterations("iterations",
                                     cl::desc("Number of iterations to run"),
                                     cl::cat(ToolOptions), cl::init(0));
 
+static cl::opt<unsigned>
+    NumJobs("jobs",
+            cl::desc("Number of code regions to simulate in parallel "
+                     "(0 = all cores, default = 1)"),
+            cl::cat(ToolOptions), cl::init(1));
+
+static cl::alias NumJobsA("j", cl::desc("Alias for -jobs"),
+                          cl::aliasopt(NumJobs));
+
+static cl::opt<bool>
+    PrintJson("json",
+              cl::desc("Print the summary and resource pressure of every "
+                       "code region in JSON format"),
+              cl::cat(ToolOptions), cl::init(false));
+
 static cl::opt<unsigned>
     DispatchWidth("dispatch", cl::desc("Override the processor dispatch width"),
                   cl::cat(ToolOptions), cl::init(0));
@@ -422,45 +442,37 @@ int main(int argc, char **argv) {
   // Create an instruction builder.
   mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get());
 
-  // Create a context to control ownership of the pipeline hardware.
-  mca::Context MCA(*MRI, *STI);
-
   mca::PipelineOptions PO(MicroOpQueue, DecoderThroughput, DispatchWidth,
                           RegisterFileSize, LoadQueueSize, StoreQueueSize,
                           AssumeNoAlias, EnableBottleneckAnalysis);
 
-  // Number each region in the sequence.
-  unsigned RegionIdx = 0;
-
-  std::unique_ptr<MCCodeEmitter> MCE(
-      TheTarget->createMCCodeEmitter(*MCII, *MRI, Ctx));
-
   std::unique_ptr<MCAsmBackend> MAB(TheTarget->createMCAsmBackend(
       *STI, *MRI, InitMCTargetOptionsFromFlags()));
 
-  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions) {
-    // Skip empty code regions.
-    if (Region->empty())
-      continue;
-
-    // Don't print the header of this region if it is the default region, and
-    // it doesn't have an end location.
-    if (Region->startLoc().isValid() || Region->endLoc().isValid()) {
-      TOF->os() << "\n[" << RegionIdx++ << "] Code Region";
-      StringRef Desc = Region->getDescription();
-      if (!Desc.empty())
-        TOF->os() << " - " << Desc;
-      TOF->os() << "\n\n";
-    }
+  // Errors of regions simulated in parallel are reported one at a time.
+  std::mutex ErrorLock;
+
+  // Simulate one region, and write its report to OS, or add its views to JO
+  // with -json. Regions can be simulated in parallel, so every one gets its own
+  // hardware, instruction printer and code emitter; only the instruction
+  // descriptors are shared.
+  auto AnalyzeRegion = [&](const mca::CodeRegion &Region, raw_ostream &OS,
+                           json::Object &JO) {
+    std::unique_ptr<MCInstPrinter> IP(TheTarget->createMCInstPrinter(
+        Triple(TripleName), AssemblerDialect, *MAI, *MCII, *MRI));
+    IP->setPrintImmHex(PrintImmHex);
+    std::unique_ptr<MCCodeEmitter> MCE(
+        TheTarget->createMCCodeEmitter(*MCII, *MRI, Ctx));
 
     // Lower the MCInst sequence into an mca::Instruction sequence.
-    ArrayRef<MCInst> Insts = Region->getInstructions();
+    ArrayRef<MCInst> Insts = Region.getInstructions();
     mca::CodeEmitter CE(*STI, *MAB, *MCE, Insts);
     std::vector<std::unique_ptr<mca::Instruction>> LoweredSequence;
     for (const MCInst &MCI : Insts) {
       Expected<std::unique_ptr<mca::Instruction>> Inst =
           IB.createInstruction(MCI);
       if (!Inst) {
+        std::lock_guard<std::mutex> Guard(ErrorLock);
         if (auto NewE = handleErrors(
                 Inst.takeError(),
                 [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
@@ -475,13 +487,21 @@ int main(int argc, char **argv) {
           // Default case.
           WithColor::error() << toString(std::move(NewE));
         }
-        return 1;
+        return false;
       }
 
       LoweredSequence.emplace_back(std::move(Inst.get()));
     }
 
-    mca::SourceMgr S(LoweredSequence, PrintInstructionTables ? 1 : Iterations);
+    std::vector<mca::BranchInfo> Branches;
+    {
+      std::lock_guard<std::mutex> Guard(ErrorLock);
+      if (!Region.getBranches(Branches, SrcMgr))
+        return false;
+    }
+
+    mca::SourceMgr S(LoweredSequence, PrintInstructionTables ? 1 : Iterations,
+                     Branches);
 
     if (PrintInstructionTables) {
       //  Create a pipeline, stages, and a printer.
@@ -499,13 +519,18 @@ int main(int argc, char **argv) {
           std::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
 
       if (!runPipeline(*P))
-        return 1;
+        return false;
 
-      Printer.printReport(TOF->os());
-      continue;
+      if (PrintJson)
+        Printer.printReport(JO);
+      else
+        Printer.printReport(OS);
+      return true;
     }
 
-    // Create a basic pipeline simulating an out-of-order backend.
+    // Create a basic pipeline simulating an out-of-order backend, with a
+    // context to control ownership of the pipeline hardware.
+    mca::Context MCA(*MRI, *STI);
     auto P = MCA.createDefaultPipeline(PO, S);
     mca::PipelinePrinter Printer(*P);
 
@@ -547,12 +572,87 @@ int main(int argc, char **argv) {
     }
 
     if (!runPipeline(*P))
-      return 1;
+      return false;
+
+    if (PrintJson)
+      Printer.printReport(JO);
+    else
+      Printer.printReport(OS);
+    return true;
+  };
 
-    Printer.printReport(TOF->os());
+  // Number each region in the sequence.
+  unsigned RegionIdx = 0;
+
+  // The report of every region, in the order of the input.
+  struct RegionReport {
+    const mca::CodeRegion *Region;
+    std::string Header;
+    std::string Text;
+    json::Object JSON;
+    bool Success = false;
+  };
+  std::vector<RegionReport> Reports;
+  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions) {
+    // Skip empty code regions.
+    if (Region->empty())
+      continue;
+
+    RegionReport R;
+    R.Region = Region.get();
+    // Don't print the header of this region if it is the default region, and
+    // it doesn't have an end location.
+    if (Region->startLoc().isValid() || Region->endLoc().isValid()) {
+      raw_string_ostream HS(R.Header);
+      HS << "\n[" << RegionIdx++ << "] Code Region";
+      StringRef Desc = Region->getDescription();
+      if (!Desc.empty())
+        HS << " - " << Desc;
+      HS << "\n\n";
+    }
+    R.JSON["Name"] = Region->getDescription();
+    Reports.push_back(std::move(R));
+  }
+
+  json::Array JSONRegions;
+  if (NumJobs == 1) {
+    // Print every report as soon as it is ready.
+    for (RegionReport &R : Reports) {
+      if (!PrintJson)
+        TOF->os() << R.Header;
+      if (!AnalyzeRegion(*R.Region, TOF->os(), R.JSON))
+        return 1;
+      if (PrintJson)
+        JSONRegions.push_back(std::move(R.JSON));
+
+      // Clear the InstrBuilder internal state in preparation for another
+      // round.
+      IB.clear();
+    }
+  } else {
+    {
+      ThreadPool Pool(NumJobs ? NumJobs.getValue() : hardware_concurrency());
+      for (RegionReport &R : Reports)
+        Pool.async([&] {
+          raw_string_ostream OS(R.Text);
+          R.Success = AnalyzeRegion(*R.Region, OS, R.JSON);
+        });
+    }
+    for (RegionReport &R : Reports) {
+      if (!R.Success)
+        return 1;
+      if (PrintJson)
+        JSONRegions.push_back(std::move(R.JSON));
+      else
+        TOF->os() << R.Header << R.Text;
+    }
+  }
 
-    // Clear the InstrBuilder internal state in preparation for another round.
-    IB.clear();
+  if (PrintJson) {
+    json::Object TargetInfo({{"TripleName", TripleName}, {"CPU", MCPU}});
+    json::Object JSONReport({{"CodeRegions", std::move(JSONRegions)},
+                             {"TargetInfo", std::move(TargetInfo)}});
+    TOF->os() << formatv("{0:2}", json::Value(std::move(JSONReport))) << "\n";
   }
 
   TOF->keep();
@@ -34,6 +34,7 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
@@ -692,10 +693,12 @@ static Optional<std::string> demangle(StringRef Name, bool StripUnderscore) {
   if (!Name.startswith("_Z"))
     return None;
 
-  int Status;
-  char *Undecorated =
-      itaniumDemangle(Name.str().c_str(), nullptr, nullptr, &Status);
-  if (Status != 0)
+  // Keep one demangler for all symbols, so that its allocations are reused.
+  static ItaniumPartialDemangler Demangler;
+  if (Demangler.partialDemangle(Name.str().c_str()))
+    return None;
+  char *Undecorated = Demangler.finishDemangle(nullptr, nullptr);
+  if (!Undecorated)
     return None;
 
   std::string S(Undecorated);
@@ -720,12 +723,15 @@ static void sortAndPrintSymbolList(SymbolicFile &Obj, bool printName,
     else
       Cmp = &compareSymbolName;
 
+    // Sorting dominates the run time for binaries with millions of symbols,
+    // so sort in parallel. Small lists are sorted on the calling thread.
     if (ReverseSort)
-      llvm::sort(SymbolList, [=](const NMSymbol &A, const NMSymbol &B) -> bool {
-        return Cmp(B, A);
-      });
+      parallel::sort(parallel::par, SymbolList.begin(), SymbolList.end(),
+                     [=](const NMSymbol &A, const NMSymbol &B) -> bool {
+                       return Cmp(B, A);
+                     });
     else
-      llvm::sort(SymbolList, Cmp);
+      parallel::sort(parallel::par, SymbolList.begin(), SymbolList.end(), Cmp);
   }
 
   if (!PrintFileName) {
@@ -793,11 +799,14 @@ static void sortAndPrintSymbolList(SymbolicFile &Obj, bool printName,
 
   for (const NMSymbol &S : SymbolList) {
     uint32_t SymFlags;
-    std::string Name = S.Name.str();
+    StringRef Name = S.Name;
+    std::string DemangledName;
     MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(&Obj);
     if (Demangle) {
-      if (Optional<std::string> Opt = demangle(S.Name, MachO))
-        Name = *Opt;
+      if (Optional<std::string> Opt = demangle(S.Name, MachO)) {
+        DemangledName = std::move(*Opt);
+        Name = DemangledName;
+      }
     }
     if (S.Sym.getRawDataRefImpl().p)
       SymFlags = S.Sym.getFlags();
@@ -1234,25 +1243,35 @@ dumpSymbolNamesFromObject(SymbolicFile &Obj, bool printName,
       }
       S.TypeName = getNMTypeName(Obj, Sym);
       S.TypeChar = getNMSectionTagAndName(Obj, Sym, S.SectionName);
-      if (Error E = Sym.printName(OS)) {
-        if (MachO) {
-          OS << "bad string index";
-          consumeError(std::move(E));
+      if (isa<ObjectFile>(Obj)) {
+        // The names of object file symbols live in the mapped file, so refer
+        // to them directly instead of copying them into NameBuffer.
+        Expected<StringRef> NameOrErr = SymbolRef(Sym).getName();
+        if (NameOrErr) {
+          S.Name = *NameOrErr;
+        } else if (MachO) {
+          S.Name = "bad string index";
+          consumeError(NameOrErr.takeError());
         } else
+          error(NameOrErr.takeError(), Obj.getFileName());
+      } else {
+        if (Error E = Sym.printName(OS))
           error(std::move(E), Obj.getFileName());
+        OS << '\0';
       }
-      OS << '\0';
       S.Sym = Sym;
       SymbolList.push_back(S);
     }
   }
 
   OS.flush();
-  const char *P = NameBuffer.c_str();
-  unsigned I;
-  for (I = 0; I < SymbolList.size(); ++I) {
-    SymbolList[I].Name = P;
-    P += strlen(P) + 1;
+  unsigned I = SymbolList.size();
+  if (!isa<ObjectFile>(Obj)) {
+    const char *P = NameBuffer.c_str();
+    for (I = 0; I < SymbolList.size(); ++I) {
+      SymbolList[I].Name = P;
+      P += strlen(P) + 1;
+    }
   }
 
   // If this is a Mach-O file where the nlist symbol table is out of sync
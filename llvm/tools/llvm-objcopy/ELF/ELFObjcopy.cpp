@@ -33,6 +33,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -41,6 +42,7 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -338,6 +340,21 @@ static void replaceDebugSections(
   };
 }
 
+// Compress the contents of the new sections. Each section is compressed on its
+// own, so this is done in parallel.
+static Error compressSections(ArrayRef<CompressedSection *> Sections) {
+  std::mutex ErrMutex;
+  Error Err = Error::success();
+  parallel::for_each_n(parallel::par, size_t(0), Sections.size(),
+                       [&](size_t I) {
+                         if (Error E = Sections[I]->compress()) {
+                           std::lock_guard<std::mutex> Lock(ErrMutex);
+                           Err = joinErrors(std::move(Err), std::move(E));
+                         }
+                       });
+  return Err;
+}
+
 static bool isUnneededSymbol(const Symbol &Sym) {
   return !Sym.Referenced &&
          (Sym.Binding == STB_LOCAL || Sym.getShndx() == SHN_UNDEF) &&
@@ -565,13 +582,18 @@ static Error replaceAndRemoveSections(const CopyConfig &Config, Object &Obj) {
     };
   }
 
-  if (Config.CompressionType != DebugCompressionType::None)
-    replaceDebugSections(Obj, RemovePred, isCompressable, 
-                         [&Config, &Obj](const SectionBase *S) {
-                           return &Obj.addSection<CompressedSection>(
-                                *S, Config.CompressionType);
-                        });
-  else if (Config.DecompressDebugSections)
+  if (Config.CompressionType != DebugCompressionType::None) {
+    std::vector<CompressedSection *> ToCompress;
+    replaceDebugSections(Obj, RemovePred, isCompressable,
+                         [&Config, &Obj, &ToCompress](const SectionBase *S) {
+                           ToCompress.push_back(
+                               &Obj.addSection<CompressedSection>(
+                                   *S, Config.CompressionType));
+                           return ToCompress.back();
+                         });
+    if (Error E = compressSections(ToCompress))
+      return E;
+  } else if (Config.DecompressDebugSections)
     replaceDebugSections(
         Obj, RemovePred,
         [](const SectionBase &S) { return isa<CompressedSection>(&S); },
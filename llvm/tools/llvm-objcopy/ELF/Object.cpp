@@ -20,6 +20,7 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
 #include <cstddef>
@@ -430,13 +431,15 @@ void ELFSectionWriter<ELFT>::visit(const DecompressedSection &Sec) {
       reinterpret_cast<const char *>(Sec.OriginalData.data()) + DataOffset,
       Sec.OriginalData.size() - DataOffset);
 
-  SmallVector<char, 128> DecompressedContent;
-  if (Error E = zlib::uncompress(CompressedContent, DecompressedContent,
-                                 static_cast<size_t>(Sec.Size)))
+  // Inflate straight into the output buffer, which has exactly Sec.Size bytes
+  // reserved for this section.
+  char *Buf = reinterpret_cast<char *>(Out.getBufferStart() + Sec.Offset);
+  size_t DecompressedSize = static_cast<size_t>(Sec.Size);
+  if (Error E = zlib::uncompress(CompressedContent, Buf, DecompressedSize))
     reportError(Sec.Name, std::move(E));
-
-  uint8_t *Buf = Out.getBufferStart() + Sec.Offset;
-  std::copy(DecompressedContent.begin(), DecompressedContent.end(), Buf);
+  if (DecompressedSize != Sec.Size)
+    error("section '" + Sec.Name + "': decompressed size does not match the "
+          "size in the compression header");
 }
 
 void BinarySectionWriter::visit(const DecompressedSection &Sec) {
@@ -504,26 +507,31 @@ CompressedSection::CompressedSection(const SectionBase &Sec,
                                      DebugCompressionType CompressionType)
     : SectionBase(Sec), CompressionType(CompressionType),
       DecompressedSize(Sec.OriginalData.size()), DecompressedAlign(Sec.Align) {
+  if (CompressionType == DebugCompressionType::GNU)
+    Name = ".z" + Sec.Name.substr(1);
+  else
+    Flags |= ELF::SHF_COMPRESSED;
+  Align = 8;
+}
+
+Error CompressedSection::compress() {
   if (Error E = zlib::compress(
           StringRef(reinterpret_cast<const char *>(OriginalData.data()),
                     OriginalData.size()),
           CompressedData))
-    reportError(Name, std::move(E));
+    return createFileError(Name, std::move(E));
 
   size_t ChdrSize;
-  if (CompressionType == DebugCompressionType::GNU) {
-    Name = ".z" + Sec.Name.substr(1);
+  if (CompressionType == DebugCompressionType::GNU)
     ChdrSize = sizeof("ZLIB") - 1 + sizeof(uint64_t);
-  } else {
-    Flags |= ELF::SHF_COMPRESSED;
+  else
     ChdrSize =
         std::max(std::max(sizeof(object::Elf_Chdr_Impl<object::ELF64LE>),
                           sizeof(object::Elf_Chdr_Impl<object::ELF64BE>)),
                  std::max(sizeof(object::Elf_Chdr_Impl<object::ELF32LE>),
                           sizeof(object::Elf_Chdr_Impl<object::ELF32BE>)));
-  }
   Size = ChdrSize + CompressedData.size();
-  Align = 8;
+  return Error::success();
 }
 
 CompressedSection::CompressedSection(ArrayRef<uint8_t> CompressedData,
@@ -1754,12 +1762,19 @@ template <class ELFT> void ELFWriter<ELFT>::writeShdrs() {
 }
 
 template <class ELFT> void ELFWriter<ELFT>::writeSectionData() {
+  // Segments are responsible for writing their contents, so only write the
+  // section data if the section is not in a segment. Note that this renders
+  // sections in segments effectively immutable.
+  std::vector<SectionBase *> ToWrite;
   for (SectionBase &Sec : Obj.sections())
-    // Segments are responsible for writing their contents, so only write the
-    // section data if the section is not in a segment. Note that this renders
-    // sections in segments effectively immutable.
     if (Sec.ParentSegment == nullptr)
-      Sec.accept(*SecWriter);
+      ToWrite.push_back(&Sec);
+
+  // Every section only writes to its own range of the output buffer, so the
+  // sections can be written concurrently. This matters most for decompressed
+  // debug sections, which are inflated while they are written.
+  parallel::for_each_n(parallel::par, size_t(0), ToWrite.size(),
+                       [&](size_t I) { ToWrite[I]->accept(*SecWriter); });
 }
 
 template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
@@ -523,6 +523,11 @@ public:
   CompressedSection(ArrayRef<uint8_t> CompressedData, uint64_t DecompressedSize,
                     uint64_t DecompressedAlign);
 
+  // Compress the contents of the original section and compute the final size
+  // of this section. This only touches this section, so several sections can
+  // be compressed concurrently.
+  Error compress();
+
   uint64_t getDecompressedSize() const { return DecompressedSize; }
   uint64_t getDecompressedAlign() const { return DecompressedAlign; }
 
@@ -60,6 +60,8 @@
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -243,6 +245,12 @@ cl::opt<bool> NoLeadingAddr("no-leading-addr",
                             cl::desc("Print no leading address"),
                             cl::cat(ObjdumpCat));
 
+static cl::opt<unsigned>
+    NumThreads("num-threads",
+               cl::desc("Disassemble on N threads, 0 meaning one thread per "
+                        "hardware thread"),
+               cl::value_desc("N"), cl::init(1), cl::cat(ObjdumpCat));
+
 static cl::opt<bool> RawClangAST(
     "raw-clang-ast",
     cl::desc("Dump the raw binary contents of the clang AST section"),
@@ -627,6 +635,59 @@ void SourcePrinter::printSourceLine(raw_ostream &OS,
   OldLineInfo = LineInfo;
 }
 
+// Output of the disassembly of a symbol that depends on what was printed for
+// the previous symbols, and is only printed once they have been.
+struct DeferredOutput {
+  enum { SourceLine, Relocations } Kind;
+  // The offset in the disassembly of the symbol to insert the output at.
+  size_t Offset;
+  // For SourceLine, the address to print the source line of.
+  object::SectionedAddress Address;
+  StringRef Delimiter;
+  // For Relocations, the instruction to print the relocations of, as an
+  // offset in its section and a size.
+  uint64_t Index;
+  uint64_t Size;
+};
+
+// The disassembly of one symbol. Symbols are disassembled independently,
+// possibly on several threads, and printed in order.
+struct SymbolDisassembly {
+  unsigned SymbolIndex;
+  std::string SymbolName;
+  // The range to disassemble, as offsets in the section.
+  uint64_t Start;
+  uint64_t End;
+  std::string Text;
+  std::vector<DeferredOutput> Deferred;
+};
+
+// Records the source lines to print in the disassembly of a symbol, as the
+// source printer keeps track of the last line printed and is not thread-safe.
+class DeferredSourcePrinter : public SourcePrinter {
+  std::vector<DeferredOutput> &Deferred;
+
+public:
+  DeferredSourcePrinter(std::vector<DeferredOutput> &Deferred)
+      : Deferred(Deferred) {}
+  void printSourceLine(raw_ostream &OS, object::SectionedAddress Address,
+                       StringRef ObjectFilename,
+                       StringRef Delimiter = "; ") override {
+    DeferredOutput D;
+    D.Kind = DeferredOutput::SourceLine;
+    D.Offset = OS.tell();
+    D.Address = Address;
+    D.Delimiter = Delimiter;
+    Deferred.push_back(D);
+  }
+};
+
+// A disassembler and an instruction printer for one thread.
+struct ThreadDisassembler {
+  std::unique_ptr<MCDisassembler> DisAsm;
+  std::unique_ptr<MCInstPrinter> IP;
+};
+
 static bool isAArch64Elf(const ObjectFile *Obj) {
   const auto *Elf = dyn_cast<ELFObjectFileBase>(Obj);
   return Elf && Elf->getEMachine() == ELF::EM_AARCH64;
@@ -641,15 +702,16 @@ static bool hasMappingSymbols(const ObjectFile *Obj) {
   return isArmElf(Obj) || isAArch64Elf(Obj);
 }
 
-static void printRelocation(StringRef FileName, const RelocationRef &Rel,
-                            uint64_t Address, bool Is64Bits) {
+static void printRelocation(raw_ostream &OS, StringRef FileName,
+                            const RelocationRef &Rel, uint64_t Address,
+                            bool Is64Bits) {
   StringRef Fmt = Is64Bits ? "\t\t%016" PRIx64 ":  " : "\t\t\t%08" PRIx64 ":  ";
   SmallString<16> Name;
   SmallString<32> Val;
   Rel.getTypeName(Name);
   if (Error E = getRelocationValueString(Rel, Val))
     reportError(std::move(E), FileName);
-  outs() << format(Fmt.data(), Address) << Name << "\t" << Val << "\n";
+  OS << format(Fmt.data(), Address) << Name << "\t" << Val << "\n";
 }
 
 class PrettyPrinter {
@@ -732,7 +794,7 @@ public:
     auto PrintReloc = [&]() -> void {
       while ((RelCur != RelEnd) && (RelCur->getOffset() <= Address.Address)) {
         if (RelCur->getOffset() == Address.Address) {
-          printRelocation(ObjectFilename, *RelCur, Address.Address, false);
+          printRelocation(OS, ObjectFilename, *RelCur, Address.Address, false);
           return;
         }
         ++RelCur;
@@ -1006,40 +1068,40 @@ static char getMappingSymbolKind(ArrayRef<MappingSymbolPair> MappingSymbols,
 }
 
 static uint64_t
-dumpARMELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
-               const ObjectFile *Obj, ArrayRef<uint8_t> Bytes,
+dumpARMELFData(raw_ostream &OS, uint64_t SectionAddr, uint64_t Index,
+               uint64_t End, const ObjectFile *Obj, ArrayRef<uint8_t> Bytes,
                ArrayRef<MappingSymbolPair> MappingSymbols) {
   support::endianness Endian =
       Obj->isLittleEndian() ? support::little : support::big;
   while (Index < End) {
-    outs() << format("%8" PRIx64 ":", SectionAddr + Index);
-    outs() << "\t";
+    OS << format("%8" PRIx64 ":", SectionAddr + Index);
+    OS << "\t";
     if (Index + 4 <= End) {
-      dumpBytes(Bytes.slice(Index, 4), outs());
-      outs() << "\t.word\t"
-             << format_hex(
-                    support::endian::read32(Bytes.data() + Index, Endian), 10);
+      dumpBytes(Bytes.slice(Index, 4), OS);
+      OS << "\t.word\t"
+         << format_hex(
+                support::endian::read32(Bytes.data() + Index, Endian), 10);
       Index += 4;
     } else if (Index + 2 <= End) {
-      dumpBytes(Bytes.slice(Index, 2), outs());
-      outs() << "\t\t.short\t"
-             << format_hex(
-                    support::endian::read16(Bytes.data() + Index, Endian), 6);
+      dumpBytes(Bytes.slice(Index, 2), OS);
+      OS << "\t\t.short\t"
+         << format_hex(
+                support::endian::read16(Bytes.data() + Index, Endian), 6);
       Index += 2;
     } else {
-      dumpBytes(Bytes.slice(Index, 1), outs());
-      outs() << "\t\t.byte\t" << format_hex(Bytes[0], 4);
+      dumpBytes(Bytes.slice(Index, 1), OS);
+      OS << "\t\t.byte\t" << format_hex(Bytes[0], 4);
       ++Index;
     }
-    outs() << "\n";
+    OS << "\n";
     if (getMappingSymbolKind(MappingSymbols, Index) != 'd')
       break;
   }
   return Index;
 }
 
-static void dumpELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
-                        ArrayRef<uint8_t> Bytes) {
+static void dumpELFData(raw_ostream &OS, uint64_t SectionAddr, uint64_t Index,
+                        uint64_t End, ArrayRef<uint8_t> Bytes) {
   // print out data up to 8 bytes at a time in hex and ascii
   uint8_t AsciiData[9] = {'\0'};
   uint8_t Byte;
@@ -1047,9 +1109,9 @@ static void dumpELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
 
   for (; Index < End; ++Index) {
     if (NumBytes == 0)
-      outs() << format("%8" PRIx64 ":", SectionAddr + Index);
+      OS << format("%8" PRIx64 ":", SectionAddr + Index);
     Byte = Bytes.slice(Index)[0];
-    outs() << format(" %02x", Byte);
+    OS << format(" %02x", Byte);
     AsciiData[NumBytes] = isPrint(Byte) ? Byte : '.';
 
     uint8_t IndentOffset = 0;
@@ -1064,9 +1126,9 @@ static void dumpELFData(uint64_t SectionAddr, uint64_t Index, uint64_t End,
     }
     if (NumBytes == 8) {
       AsciiData[8] = '\0';
-      outs() << std::string(IndentOffset, ' ') << "         ";
-      outs() << reinterpret_cast<char *>(AsciiData);
-      outs() << '\n';
+      OS << std::string(IndentOffset, ' ') << "         ";
+      OS << reinterpret_cast<char *>(AsciiData);
+      OS << '\n';
       NumBytes = 0;
     }
   }
@@ -1078,8 +1140,9 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
                               const MCInstrAnalysis *MIA, MCInstPrinter *IP,
                               const MCSubtargetInfo *PrimarySTI,
                               const MCSubtargetInfo *SecondarySTI,
-                              PrettyPrinter &PIP,
-                              SourcePrinter &SP, bool InlineRelocs) {
+                              PrettyPrinter &PIP, SourcePrinter &SP,
+                              bool InlineRelocs, ThreadPool *Pool,
+                              MutableArrayRef<ThreadDisassembler> Workers) {
   const MCSubtargetInfo *STI = PrimarySTI;
   MCDisassembler *DisAsm = PrimaryDisAsm;
   bool PrimaryIsThumb = false;
@@ -1220,9 +1283,6 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
                           Section.isText() ? ELF::STT_FUNC : ELF::STT_OBJECT));
     }
 
-    SmallString<40> Comments;
-    raw_svector_ostream CommentStream(Comments);
-
     ArrayRef<uint8_t> Bytes = arrayRefFromStringRef(
         unwrapOrError(Section.getContents(), Obj->getFileName()));
 
@@ -1230,13 +1290,8 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
     if (shouldAdjustVA(Section))
       VMAAdjustment = AdjustVMA;
 
-    uint64_t Size;
-    uint64_t Index;
-    bool PrintedSection = false;
     std::vector<RelocationRef> Rels = RelocMap[Section];
-    std::vector<RelocationRef>::const_iterator RelCur = Rels.begin();
-    std::vector<RelocationRef>::const_iterator RelEnd = Rels.end();
-    // Disassemble symbol by symbol.
+    std::vector<SymbolDisassembly> Disassemblies;
     for (unsigned SI = 0, SE = Symbols.size(); SI != SE; ++SI) {
       std::string SymbolName = std::get<1>(Symbols[SI]).str();
       if (Demangle)
@@ -1263,14 +1318,6 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
       Start -= SectionAddr;
       End -= SectionAddr;
 
-      if (!PrintedSection) {
-        PrintedSection = true;
-        outs() << "\nDisassembly of section ";
-        if (!SegmentName.empty())
-          outs() << SegmentName << ",";
-        outs() << SectionName << ":\n";
-      }
-
       if (Obj->isELF() && Obj->getArch() == Triple::amdgcn) {
         if (std::get<2>(Symbols[SI]) == ELF::STT_AMDGPU_HSA_KERNEL) {
           // skip amd_kernel_code_t at the begining of kernel symbol (256 bytes)
@@ -1288,18 +1335,35 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
         }
       }
 
-      outs() << '\n';
+      Disassemblies.push_back({SI, std::move(SymbolName), Start, End, {}, {}});
+    }
+
+    // Disassemble a symbol into D.Text. This only reads the state shared by
+    // the symbols of the section, so that several symbols can be disassembled
+    // at the same time with different disassemblers and printers. The source
+    // lines and the relocations are printed by printDisassembly instead.
+    auto Disassemble = [&](SymbolDisassembly &D, MCDisassembler *&DisAsm,
+                           const MCSubtargetInfo *&STI, MCInstPrinter &IP) {
+      raw_string_ostream OS(D.Text);
+      DeferredSourcePrinter DSP(D.Deferred);
+      SmallString<40> Comments;
+      raw_svector_ostream CommentStream(Comments);
+      unsigned SI = D.SymbolIndex;
+      uint64_t Start = D.Start;
+      uint64_t End = D.End;
+
+      OS << '\n';
       if (!NoLeadingAddr)
-        outs() << format(Is64Bits ? "%016" PRIx64 " " : "%08" PRIx64 " ",
-                         SectionAddr + Start + VMAAdjustment);
+        OS << format(Is64Bits ? "%016" PRIx64 " " : "%08" PRIx64 " ",
+                     SectionAddr + Start + VMAAdjustment);
 
-      outs() << SymbolName << ":\n";
+      OS << D.SymbolName << ":\n";
 
       // Don't print raw contents of a virtual section. A virtual section
       // doesn't have any contents in the file.
       if (Section.isVirtual()) {
-        outs() << "...\n";
-        continue;
+        OS << "...\n";
+        return;
       }
 
 #ifndef NDEBUG
@@ -1310,11 +1374,12 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
 
       // Some targets (like WebAssembly) have a special prelude at the start
       // of each symbol.
-      DisAsm->onSymbolStart(SymbolName, Size, Bytes.slice(Start, End - Start),
+      uint64_t Size;
+      DisAsm->onSymbolStart(D.SymbolName, Size, Bytes.slice(Start, End - Start),
                             SectionAddr + Start, DebugOut, CommentStream);
       Start += Size;
 
-      Index = Start;
+      uint64_t Index = Start;
       if (SectionAddr < StartAddress)
         Index = std::max<uint64_t>(Index, StartAddress - SectionAddr);
 
@@ -1324,11 +1389,25 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
       if (Obj->isELF() && !DisassembleAll && Section.isText()) {
         uint8_t SymTy = std::get<2>(Symbols[SI]);
         if (SymTy == ELF::STT_OBJECT || SymTy == ELF::STT_COMMON) {
-          dumpELFData(SectionAddr, Index, End, Bytes);
+          dumpELFData(OS, SectionAddr, Index, End, Bytes);
           Index = End;
         }
       }
 
+      // The next relocation to print, which ends the blocks of zeroes that
+      // can be skipped.
+      auto RelCur = partition_point(Rels, [&](const RelocationRef &Rel) {
+        return Rel.getOffset() < Index;
+      });
+      auto RelEnd = Rels.end();
+      auto SkipRelocations = [&](uint64_t Offset) {
+        while (RelCur != RelEnd &&
+               (RelCur->getOffset() < Offset || getHidden(*RelCur) ||
+                SectionAddr + RelCur->getOffset() < StartAddress))
+          ++RelCur;
+      };
+      SkipRelocations(Index);
+
       bool CheckARMELFData = hasMappingSymbols(Obj) &&
                              std::get<2>(Symbols[SI]) != ELF::STT_OBJECT &&
                              !DisassembleAll;
@@ -1339,7 +1418,7 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
         // denoted as a word/short etc.
         if (CheckARMELFData &&
             getMappingSymbolKind(MappingSymbols, Index) == 'd') {
-          Index = dumpARMELFData(SectionAddr, Index, End, Obj, Bytes,
+          Index = dumpARMELFData(OS, SectionAddr, Index, End, Obj, Bytes,
                                  MappingSymbols);
           continue;
         }
@@ -1355,7 +1434,7 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
 
           if (size_t N =
                   countSkippableZeroBytes(Bytes.slice(Index, MaxOffset))) {
-            outs() << "\t\t..." << '\n';
+            OS << "\t\t..." << '\n';
             Index += N;
             continue;
           }
@@ -1380,11 +1459,11 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
         if (Size == 0)
           Size = 1;
 
-        PIP.printInst(*IP, Disassembled ? &Inst : nullptr,
+        PIP.printInst(IP, Disassembled ? &Inst : nullptr,
                       Bytes.slice(Index, Size),
                       {SectionAddr + Index + VMAAdjustment, Section.getIndex()},
-                      outs(), "", *STI, &SP, Obj->getFileName(), &Rels);
-        outs() << CommentStream.str();
+                      OS, "", *STI, &DSP, Obj->getFileName(), &Rels);
+        OS << CommentStream.str();
         Comments.clear();
 
         // Try to resolve the target of a call, tail call, etc. to a specific
@@ -1407,12 +1486,16 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
                   [=](const std::pair<uint64_t, SectionRef> &O) {
                     return O.first <= Target;
                   });
-              if (It != SectionAddresses.begin()) {
-                --It;
-                TargetSectionSymbols = &AllSymbols[It->second];
-              } else {
+              // A section without symbols has no entry in AllSymbols, which
+              // isn't modified here since other symbols may be disassembled
+              // at the same time.
+              auto SecSyms = AllSymbols.end();
+              if (It != SectionAddresses.begin())
+                SecSyms = AllSymbols.find(std::prev(It)->second);
+              if (SecSyms != AllSymbols.end())
+                TargetSectionSymbols = &SecSyms->second;
+              else
                 TargetSectionSymbols = &AbsoluteSymbols;
-              }
             }
 
             // Find the last symbol in the section whose offset is less than
@@ -1435,48 +1518,137 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
               --TargetSym;
               uint64_t TargetAddress = std::get<0>(*TargetSym);
               StringRef TargetName = std::get<1>(*TargetSym);
-              outs() << " <" << TargetName;
+              OS << " <" << TargetName;
               uint64_t Disp = Target - TargetAddress;
               if (Disp)
-                outs() << "+0x" << Twine::utohexstr(Disp);
-              outs() << '>';
+                OS << "+0x" << Twine::utohexstr(Disp);
+              OS << '>';
             }
           }
         }
-        outs() << "\n";
+        OS << "\n";
 
         // Hexagon does this in pretty printer
         if (Obj->getArch() != Triple::hexagon) {
-          // Print relocation for instruction.
-          while (RelCur != RelEnd) {
-            uint64_t Offset = RelCur->getOffset();
-            // If this relocation is hidden, skip it.
-            if (getHidden(*RelCur) || SectionAddr + Offset < StartAddress) {
-              ++RelCur;
-              continue;
-            }
+          if (!Rels.empty()) {
+            DeferredOutput Relocs;
+            Relocs.Kind = DeferredOutput::Relocations;
+            Relocs.Offset = OS.tell();
+            Relocs.Index = Index;
+            Relocs.Size = Size;
+            D.Deferred.push_back(Relocs);
+          }
+          SkipRelocations(Index + Size);
+        }
 
-            // Stop when RelCur's offset is past the current instruction.
-            if (Offset >= Index + Size)
-              break;
-
-            // When --adjust-vma is used, update the address printed.
-            if (RelCur->getSymbol() != Obj->symbol_end()) {
-              Expected<section_iterator> SymSI =
-                  RelCur->getSymbol()->getSection();
-              if (SymSI && *SymSI != Obj->section_end() &&
-                  shouldAdjustVA(**SymSI))
-                Offset += AdjustVMA;
-            }
+        Index += Size;
+      }
+    };
+
+    // Print the disassembly of a symbol, along with its source lines and
+    // relocations, which depend on what was printed for the previous symbols.
+    bool PrintedSection = false;
+    std::vector<RelocationRef>::const_iterator RelCur = Rels.begin();
+    std::vector<RelocationRef>::const_iterator RelEnd = Rels.end();
+    auto PrintDisassembly = [&](SymbolDisassembly &D) {
+      if (!PrintedSection) {
+        PrintedSection = true;
+        outs() << "\nDisassembly of section ";
+        if (!SegmentName.empty())
+          outs() << SegmentName << ",";
+        outs() << SectionName << ":\n";
+      }
 
-            printRelocation(Obj->getFileName(), *RelCur, SectionAddr + Offset,
-                            Is64Bits);
+      StringRef Text = D.Text;
+      size_t Pos = 0;
+      for (const DeferredOutput &Output : D.Deferred) {
+        outs() << Text.slice(Pos, Output.Offset);
+        Pos = Output.Offset;
+        if (Output.Kind == DeferredOutput::SourceLine) {
+          SP.printSourceLine(outs(), Output.Address, FileName,
+                             Output.Delimiter);
+          continue;
+        }
+
+        // Print relocation for instruction.
+        uint64_t Index = Output.Index;
+        uint64_t Size = Output.Size;
+        while (RelCur != RelEnd) {
+          uint64_t Offset = RelCur->getOffset();
+          // If this relocation is hidden, skip it.
+          if (getHidden(*RelCur) || SectionAddr + Offset < StartAddress) {
             ++RelCur;
+            continue;
+          }
+
+          // Stop when RelCur's offset is past the current instruction.
+          if (Offset >= Index + Size)
+            break;
+
+          // When --adjust-vma is used, update the address printed.
+          if (RelCur->getSymbol() != Obj->symbol_end()) {
+            Expected<section_iterator> SymSI =
+                RelCur->getSymbol()->getSection();
+            if (SymSI && *SymSI != Obj->section_end() &&
+                shouldAdjustVA(**SymSI))
+              Offset += AdjustVMA;
           }
+
+          printRelocation(outs(), Obj->getFileName(), *RelCur,
+                          SectionAddr + Offset, Is64Bits);
+          ++RelCur;
         }
+      }
+      outs() << Text.substr(Pos);
 
-        Index += Size;
+      D.Text.clear();
+      D.Text.shrink_to_fit();
+      D.Deferred.clear();
+      D.Deferred.shrink_to_fit();
+    };
+
+    if (!Pool) {
+      for (SymbolDisassembly &D : Disassemblies) {
+        Disassemble(D, DisAsm, STI, *IP);
+        PrintDisassembly(D);
+      }
+      continue;
+    }
+
+    // Split the symbols into tasks of about TaskSize bytes of code. Each task
+    // in flight uses its own worker, and the tasks are printed in order as
+    // soon as they are done.
+    const uint64_t TaskSize = 64 * 1024;
+    std::vector<size_t> TaskBegins;
+    uint64_t CodeSize = 0;
+    for (size_t I = 0, E = Disassemblies.size(); I != E; ++I) {
+      if (TaskBegins.empty() || CodeSize >= TaskSize) {
+        TaskBegins.push_back(I);
+        CodeSize = 0;
       }
+      CodeSize += Disassemblies[I].End - Disassemblies[I].Start;
+    }
+    size_t NumTasks = TaskBegins.size();
+    TaskBegins.push_back(Disassemblies.size());
+
+    std::vector<std::shared_future<void>> Tasks(NumTasks);
+    auto StartTask = [&](size_t T) {
+      ThreadDisassembler *Worker = &Workers[T % Workers.size()];
+      Tasks[T] = Pool->async([&, T, Worker] {
+        MCDisassembler *TaskDisAsm = Worker->DisAsm.get();
+        const MCSubtargetInfo *TaskSTI = PrimarySTI;
+        for (size_t I = TaskBegins[T]; I != TaskBegins[T + 1]; ++I)
+          Disassemble(Disassemblies[I], TaskDisAsm, TaskSTI, *Worker->IP);
+      });
+    };
+    for (size_t T = 0; T != NumTasks && T != Workers.size(); ++T)
+      StartTask(T);
+    for (size_t T = 0; T != NumTasks; ++T) {
+      Tasks[T].wait();
+      if (T + Workers.size() < NumTasks)
+        StartTask(T + Workers.size());
+      for (size_t I = TaskBegins[T]; I != TaskBegins[T + 1]; ++I)
+        PrintDisassembly(Disassemblies[I]);
     }
   }
   StringSet<> MissingDisasmFuncsSet =
@@ -1546,24 +1718,50 @@ static void disassembleObject(const ObjectFile *Obj, bool InlineRelocs) {
       TheTarget->createMCInstrAnalysis(MII.get()));
 
   int AsmPrinterVariant = AsmInfo->getAssemblerDialect();
-  std::unique_ptr<MCInstPrinter> IP(TheTarget->createMCInstPrinter(
-      Triple(TripleName), AsmPrinterVariant, *AsmInfo, *MII, *MRI));
-  if (!IP)
-    reportError(Obj->getFileName(),
-                "no instruction printer for target " + TripleName);
-  IP->setPrintImmHex(PrintImmHex);
+  auto CreateInstPrinter = [&]() {
+    std::unique_ptr<MCInstPrinter> IP(TheTarget->createMCInstPrinter(
+        Triple(TripleName), AsmPrinterVariant, *AsmInfo, *MII, *MRI));
+    if (!IP)
+      reportError(Obj->getFileName(),
+                  "no instruction printer for target " + TripleName);
+    IP->setPrintImmHex(PrintImmHex);
+
+    for (StringRef Opt : DisassemblerOptions)
+      if (!IP->applyTargetSpecificCLOption(Opt))
+        reportError(Obj->getFileName(),
+                    "Unrecognized disassembler option: " + Opt);
+    return IP;
+  };
+  std::unique_ptr<MCInstPrinter> IP = CreateInstPrinter();
 
   PrettyPrinter &PIP = selectPrettyPrinter(Triple(TripleName));
   SourcePrinter SP(Obj, TheTarget->getName());
 
-  for (StringRef Opt : DisassemblerOptions)
-    if (!IP->applyTargetSpecificCLOption(Opt))
-      reportError(Obj->getFileName(),
-                  "Unrecognized disassembler option: " + Opt);
+  // Symbols are disassembled on several threads with one disassembler and
+  // one instruction printer per task in flight, twice as many as threads so
+  // that the threads are kept busy while the tasks are printed. Targets whose
+  // disassembler keeps state from one instruction to the next (ARM IT blocks
+  // and modes, Hexagon packets) or adds symbols to the context (AMDGPU) are
+  // disassembled on one thread.
+  std::unique_ptr<ThreadPool> Pool;
+  std::vector<ThreadDisassembler> Workers;
+  Triple TheTriple(TripleName);
+  if (NumThreads != 1 && !DebugFlag && !TheTriple.isARM() &&
+      !TheTriple.isThumb() && TheTriple.getArch() != Triple::hexagon &&
+      TheTriple.getArch() != Triple::amdgcn) {
+    unsigned ThreadCount =
+        NumThreads ? NumThreads : llvm::heavyweight_hardware_concurrency();
+    Pool = std::make_unique<ThreadPool>(ThreadCount);
+    Workers.resize(2 * ThreadCount);
+    for (ThreadDisassembler &Worker : Workers) {
+      Worker.DisAsm.reset(TheTarget->createMCDisassembler(*STI, Ctx));
+      Worker.IP = CreateInstPrinter();
+    }
+  }
 
   disassembleObject(TheTarget, Obj, Ctx, DisAsm.get(), SecondaryDisAsm.get(),
                     MIA.get(), IP.get(), STI.get(), SecondarySTI.get(), PIP,
-                    SP, InlineRelocs);
+                    SP, InlineRelocs, Pool.get(), Workers);
 }
 
 void printRelocations(const ObjectFile *Obj) {
@@ -28,6 +28,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 
@@ -219,10 +220,13 @@ static void overlapInput(const std::string &BaseFilename,
   }
 }
 
-/// Load an input into a writer context.
+/// Load an input into the writer contexts \p Shards. If there is more than one
+/// shard, every function goes to the shard picked by the hash of its name, so
+/// that each function is only held by one writer. The errors and the profile
+/// kind are recorded in the first shard, guarded by its ErrLock.
 static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
-                      WriterContext *WC) {
-  std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+                      ArrayRef<WriterContext *> Shards) {
+  WriterContext *WC = Shards[0];
 
   // Copy the filename, because llvm::ThreadPool copied the input "const
   // WeightedFile &" by value, making a reference to the filename within it
@@ -233,29 +237,33 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   if (Error E = ReaderOrErr.takeError()) {
     // Skip the empty profiles by returning sliently.
     instrprof_error IPE = InstrProfError::take(std::move(E));
-    if (IPE != instrprof_error::empty_raw_profile)
+    if (IPE != instrprof_error::empty_raw_profile) {
+      std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
       WC->Errors.emplace_back(make_error<InstrProfError>(IPE), Filename);
+    }
     return;
   }
 
   auto Reader = std::move(ReaderOrErr.get());
   bool IsIRProfile = Reader->isIRLevelProfile();
   bool HasCSIRProfile = Reader->hasCSIRLevelProfile();
-  if (WC->Writer.setIsIRLevelProfile(IsIRProfile, HasCSIRProfile)) {
-    WC->Errors.emplace_back(
-        make_error<StringError>(
-            "Merge IR generated profile with Clang generated profile.",
-            std::error_code()),
-        Filename);
-    return;
+  {
+    std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
+    if (WC->Writer.setIsIRLevelProfile(IsIRProfile, HasCSIRProfile)) {
+      WC->Errors.emplace_back(
+          make_error<StringError>(
+              "Merge IR generated profile with Clang generated profile.",
+              std::error_code()),
+          Filename);
+      return;
+    }
   }
 
-  for (auto &I : *Reader) {
-    if (Remapper)
-      I.Name = (*Remapper)(I.Name);
+  // Add a record to the writer of Shard. The caller holds the lock of Shard.
+  auto AddRecord = [&](WriterContext &Shard, NamedInstrProfRecord &&I) {
     const StringRef FuncName = I.Name;
     bool Reported = false;
-    WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
+    Shard.Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
       if (Reported) {
         consumeError(std::move(E));
         return;
@@ -268,10 +276,43 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
       handleMergeWriterError(make_error<InstrProfError>(IPE), Input.Filename,
                              FuncName, firstTime);
     });
+  };
+
+  if (Shards.size() == 1) {
+    std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+    for (auto &I : *Reader) {
+      if (Remapper)
+        I.Name = (*Remapper)(I.Name);
+      AddRecord(*WC, std::move(I));
+    }
+  } else {
+    // Hand the records to their shards in batches, so that the lock of a
+    // shard is not taken for every record. The names stay valid as long as
+    // the reader is alive.
+    const size_t BatchSize = 1024;
+    std::vector<std::vector<NamedInstrProfRecord>> Batches(Shards.size());
+    auto Flush = [&](unsigned Shard) {
+      std::unique_lock<std::mutex> CtxGuard{Shards[Shard]->Lock};
+      for (NamedInstrProfRecord &I : Batches[Shard])
+        AddRecord(*Shards[Shard], std::move(I));
+      Batches[Shard].clear();
+    };
+    for (auto &I : *Reader) {
+      if (Remapper)
+        I.Name = (*Remapper)(I.Name);
+      unsigned Shard = xxHash64(I.Name) % Shards.size();
+      Batches[Shard].push_back(std::move(I));
+      if (Batches[Shard].size() == BatchSize)
+        Flush(Shard);
+    }
+    for (unsigned Shard = 0; Shard < Shards.size(); ++Shard)
+      Flush(Shard);
   }
   if (Reader->hasError())
-    if (Error E = Reader->getError())
+    if (Error E = Reader->getError()) {
+      std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
       WC->Errors.emplace_back(std::move(E), Filename);
+    }
 }
 
 /// Merge the \p Src writer context into \p Dst.
@@ -319,33 +360,25 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
     for (const auto &Input : Inputs)
       loadInput(Input, Remapper, Contexts[0].get());
   } else {
-    ThreadPool Pool(NumThreads);
+    // Every context holds the functions of one shard of the name hash, so
+    // the profile is kept in memory only once however many threads load the
+    // inputs.
+    SmallVector<WriterContext *, 4> Shards;
+    for (std::unique_ptr<WriterContext> &WC : Contexts)
+      Shards.push_back(WC.get());
 
-    // Load the inputs in parallel (N/NumThreads serial steps).
-    unsigned Ctx = 0;
-    for (const auto &Input : Inputs) {
-      Pool.async(loadInput, Input, Remapper, Contexts[Ctx].get());
-      Ctx = (Ctx + 1) % NumThreads;
-    }
+    ThreadPool Pool(NumThreads);
+    for (const auto &Input : Inputs)
+      Pool.async(loadInput, Input, Remapper, ArrayRef<WriterContext *>(Shards));
     Pool.wait();
 
-    // Merge the writer contexts together (~ lg(NumThreads) serial steps).
-    unsigned Mid = Contexts.size() / 2;
-    unsigned End = Contexts.size();
-    assert(Mid > 0 && "Expected more than one context");
-    do {
-      for (unsigned I = 0; I < Mid; ++I)
-        Pool.async(mergeWriterContexts, Contexts[I].get(),
-                   Contexts[I + Mid].get());
-      Pool.wait();
-      if (End & 1) {
-        Pool.async(mergeWriterContexts, Contexts[0].get(),
-                   Contexts[End - 1].get());
-        Pool.wait();
-      }
-      End = Mid;
-      Mid /= 2;
-    } while (Mid > 0);
+    // The shards hold disjoint sets of functions, so collecting them in the
+    // first one only moves the records.
+    for (unsigned I = 1; I < NumThreads; ++I) {
+      mergeWriterContexts(Contexts[0].get(), Contexts[I].get());
+      Contexts[I].reset();
+    }
+    Contexts.resize(1);
   }
 
   // Handle deferred errors encountered during merging. If the number of errors
@@ -0,0 +1,361 @@
+//===- llvm-remark-util.cpp - Remark file utility -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements a tool that works on the optimization remark files
+/// produced by -fsave-optimization-record or -pass-remarks-output:
+///
+/// * summary: count the remarks of each pass and kind, with their total
+///            hotness, over any number of files parsed in parallel.
+/// * merge:   combine remark files, e.g. the ones written by the backends of a
+///            ThinLTO link, into a single file using one string table.
+///
+/// Both YAML and bitstream remarks are accepted, and the format of each input
+/// is detected from its contents unless -parser is given.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Remarks/BitstreamRemarkContainer.h"
+#include "llvm/Remarks/RemarkFormat.h"
+#include "llvm/Remarks/RemarkParser.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "llvm/Remarks/RemarkStringTable.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+#include <mutex>
+
+using namespace llvm;
+
+static cl::SubCommand SummarySub("summary",
+                                 "Count the remarks of each pass and kind");
+static cl::SubCommand
+    MergeSub("merge", "Merge remark files into one, with one string table");
+
+static cl::list<std::string> InputFileNames(cl::Positional, cl::OneOrMore,
+                                            cl::desc("<input files>"),
+                                            cl::sub(SummarySub),
+                                            cl::sub(MergeSub));
+
+static cl::opt<std::string> OutputFileName("o", cl::desc("Output file"),
+                                           cl::init("-"), cl::sub(SummarySub),
+                                           cl::sub(MergeSub));
+
+static cl::opt<std::string>
+    InputFormat("parser",
+                cl::desc("The format of the input remarks (default: detected "
+                         "from the contents of each file)"),
+                cl::sub(SummarySub), cl::sub(MergeSub));
+
+static cl::opt<std::string>
+    OutputFormat("serializer",
+                 cl::desc("The format of the merged remarks (default: "
+                          "bitstream)"),
+                 cl::init("bitstream"), cl::sub(MergeSub));
+
+static cl::opt<std::string>
+    PassFilter("pass-filter",
+               cl::desc("Only consider remarks from passes whose names match "
+                        "the given regular expression"),
+               cl::value_desc("regex"), cl::sub(SummarySub),
+               cl::sub(MergeSub));
+
+static cl::opt<uint64_t> HotnessThreshold(
+    "hotness-threshold",
+    cl::desc("Only consider remarks with at least this profile count"),
+    cl::init(0), cl::sub(SummarySub), cl::sub(MergeSub));
+
+static cl::opt<unsigned>
+    NumThreads("j", cl::desc("Number of files to parse in parallel (0 = all "
+                             "available cores)"),
+               cl::init(0), cl::sub(SummarySub), cl::sub(MergeSub));
+
+static cl::opt<bool>
+    SortByHotness("sort-by-hotness",
+                  cl::desc("Sort the summary by total hotness instead of by "
+                           "number of remarks"),
+                  cl::sub(SummarySub));
+
+static const char *ToolName;
+static Optional<Regex> PassRegex;
+
+static void reportError(Twine Message) {
+  WithColor::error(errs(), ToolName) << Message << "\n";
+}
+
+static Expected<remarks::Format> getInputFormat(StringRef Buf) {
+  if (!InputFormat.empty())
+    return remarks::parseFormat(InputFormat);
+  // Bitstream containers start with a magic number. Anything else is YAML,
+  // with or without a string table.
+  if (Buf.startswith(remarks::ContainerMagic))
+    return remarks::Format::Bitstream;
+  return remarks::Format::YAML;
+}
+
+static bool isSelected(const remarks::Remark &R) {
+  if (R.Hotness.getValueOr(0) < HotnessThreshold)
+    return false;
+  return !PassRegex || PassRegex->match(R.PassName);
+}
+
+/// Parse the file \p FileName and call \p Handle with every remark that is
+/// selected by the -pass-filter and -hotness-threshold options.
+static Error
+forEachRemark(StringRef FileName,
+              function_ref<void(const remarks::Remark &)> Handle) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buf =
+      MemoryBuffer::getFileOrSTDIN(FileName);
+  if (std::error_code EC = Buf.getError())
+    return createFileError(FileName, EC);
+
+  Expected<remarks::Format> Format = getInputFormat((*Buf)->getBuffer());
+  if (!Format)
+    return createFileError(FileName, Format.takeError());
+
+  Expected<std::unique_ptr<remarks::RemarkParser>> MaybeParser =
+      remarks::createRemarkParserFromMeta(*Format, (*Buf)->getBuffer());
+  if (!MaybeParser)
+    return createFileError(FileName, MaybeParser.takeError());
+  remarks::RemarkParser &Parser = **MaybeParser;
+
+  while (true) {
+    Expected<std::unique_ptr<remarks::Remark>> MaybeRemark = Parser.next();
+    if (!MaybeRemark) {
+      Error E = MaybeRemark.takeError();
+      if (E.isA<remarks::EndOfFileError>()) {
+        consumeError(std::move(E));
+        return Error::success();
+      }
+      return createFileError(FileName, std::move(E));
+    }
+    if (isSelected(**MaybeRemark))
+      Handle(**MaybeRemark);
+  }
+}
+
+/// Run \p Fn on every input file, in parallel, and report the errors in the
+/// order of the inputs. Returns false if any of the files could not be parsed.
+static bool parallelForEachInput(function_ref<Error(unsigned)> Fn) {
+  std::vector<std::string> Errors(InputFileNames.size());
+  {
+    ThreadPool Pool(NumThreads ? NumThreads : hardware_concurrency());
+    for (unsigned I = 0, E = InputFileNames.size(); I != E; ++I)
+      Pool.async([&, I] {
+        if (Error Err = Fn(I))
+          Errors[I] = toString(std::move(Err));
+      });
+    Pool.wait();
+  }
+
+  bool Success = true;
+  for (const std::string &Message : Errors)
+    if (!Message.empty()) {
+      reportError(Message);
+      Success = false;
+    }
+  return Success;
+}
+
+static StringRef typeName(remarks::Type Type) {
+  switch (Type) {
+  case remarks::Type::Unknown:
+    return "Unknown";
+  case remarks::Type::Passed:
+    return "Passed";
+  case remarks::Type::Missed:
+    return "Missed";
+  case remarks::Type::Analysis:
+    return "Analysis";
+  case remarks::Type::AnalysisFPCommute:
+    return "AnalysisFPCommute";
+  case remarks::Type::AnalysisAliasing:
+    return "AnalysisAliasing";
+  case remarks::Type::Failure:
+    return "Failure";
+  }
+  llvm_unreachable("Unknown remark type");
+}
+
+namespace {
+/// The remarks of one kind, emitted by one pass.
+struct SummaryEntry {
+  remarks::Type RemarkType = remarks::Type::Unknown;
+  uint64_t Count = 0;
+  uint64_t Hotness = 0;
+};
+
+/// The remarks of some files, keyed by "<pass>\0<remark name>\0<type>".
+struct Summary {
+  StringMap<SummaryEntry> Entries;
+
+  void add(const remarks::Remark &R) {
+    std::string Key = (R.PassName + Twine('\0') + R.RemarkName + Twine('\0') +
+                       Twine(static_cast<unsigned>(R.RemarkType)))
+                          .str();
+    SummaryEntry &Entry = Entries[Key];
+    Entry.RemarkType = R.RemarkType;
+    ++Entry.Count;
+    Entry.Hotness += R.Hotness.getValueOr(0);
+  }
+
+  void add(const Summary &Other) {
+    for (const StringMapEntry<SummaryEntry> &KV : Other.Entries) {
+      SummaryEntry &Entry = Entries[KV.first()];
+      Entry.RemarkType = KV.second.RemarkType;
+      Entry.Count += KV.second.Count;
+      Entry.Hotness += KV.second.Hotness;
+    }
+  }
+};
+} // end anonymous namespace
+
+static int summary(raw_ostream &OS) {
+  // Every file is summarized on its own, then merged in the total, so that
+  // the threads only contend once per file.
+  Summary Total;
+  std::mutex TotalMutex;
+  bool Success = parallelForEachInput([&](unsigned I) -> Error {
+    Summary FileSummary;
+    if (Error E = forEachRemark(
+            InputFileNames[I],
+            [&](const remarks::Remark &R) { FileSummary.add(R); }))
+      return E;
+    std::lock_guard<std::mutex> Lock(TotalMutex);
+    Total.add(FileSummary);
+    return Error::success();
+  });
+
+  std::vector<const StringMapEntry<SummaryEntry> *> Sorted;
+  uint64_t TotalCount = 0;
+  for (const StringMapEntry<SummaryEntry> &KV : Total.Entries) {
+    Sorted.push_back(&KV);
+    TotalCount += KV.second.Count;
+  }
+  llvm::sort(Sorted, [](const StringMapEntry<SummaryEntry> *LHS,
+                        const StringMapEntry<SummaryEntry> *RHS) {
+    uint64_t L = SortByHotness ? LHS->second.Hotness : LHS->second.Count;
+    uint64_t R = SortByHotness ? RHS->second.Hotness : RHS->second.Count;
+    if (L != R)
+      return L > R;
+    return LHS->first() < RHS->first();
+  });
+
+  OS << formatv("{0,12} {1,16}  {2,-18} {3}\n", "Count", "Hotness", "Type",
+                "Pass:Remark");
+  for (const StringMapEntry<SummaryEntry> *KV : Sorted) {
+    StringRef PassName, RemarkName;
+    std::tie(PassName, RemarkName) = KV->first().split('\0');
+    RemarkName = RemarkName.split('\0').first;
+    OS << formatv("{0,12} {1,16}  {2,-18} {3}:{4}\n", KV->second.Count,
+                  KV->second.Hotness, typeName(KV->second.RemarkType),
+                  PassName, RemarkName);
+  }
+  OS << formatv("{0,12} remarks in {1} files\n", TotalCount,
+                InputFileNames.size());
+  return Success ? 0 : 1;
+}
+
+static int merge(raw_ostream &OS) {
+  Expected<remarks::Format> Format = remarks::parseFormat(OutputFormat);
+  if (!Format) {
+    reportError(toString(Format.takeError()));
+    return 1;
+  }
+
+  // Formats with a string table emit it before the remarks, so it has to be
+  // complete before the first remark is written. Build one table per file in
+  // parallel, then merge them in the order of the inputs so that the output
+  // doesn't depend on the scheduling.
+  bool UsesStrTab = *Format != remarks::Format::YAML;
+  remarks::StringTable StrTab;
+  if (UsesStrTab) {
+    std::vector<remarks::StringTable> FileStrTabs(InputFileNames.size());
+    if (!parallelForEachInput([&](unsigned I) {
+          return forEachRemark(InputFileNames[I],
+                               [&](const remarks::Remark &R) {
+                                 remarks::Remark Copy = R.clone();
+                                 FileStrTabs[I].internalize(Copy);
+                               });
+        }))
+      return 1;
+    for (const remarks::StringTable &FileStrTab : FileStrTabs)
+      for (StringRef Str : FileStrTab.serialize())
+        StrTab.add(Str);
+  }
+
+  Expected<std::unique_ptr<remarks::RemarkSerializer>> MaybeSerializer =
+      UsesStrTab ? remarks::createRemarkSerializer(
+                       *Format, remarks::SerializerMode::Standalone, OS,
+                       std::move(StrTab))
+                 : remarks::createRemarkSerializer(
+                       *Format, remarks::SerializerMode::Standalone, OS);
+  if (!MaybeSerializer) {
+    reportError(toString(MaybeSerializer.takeError()));
+    return 1;
+  }
+  remarks::RemarkSerializer &Serializer = **MaybeSerializer;
+
+  // The remarks are streamed to the output one file at a time, so that only
+  // the string table is kept in memory.
+  for (const std::string &FileName : InputFileNames)
+    if (Error E = forEachRemark(FileName, [&](const remarks::Remark &R) {
+          Serializer.emit(R);
+        })) {
+      reportError(toString(std::move(E)));
+      return 1;
+    }
+  return 0;
+}
+
+int main(int argc, const char **argv) {
+  InitLLVM X(argc, argv);
+  ToolName = argv[0];
+
+  cl::ParseCommandLineOptions(argc, argv, "LLVM remark file utility\n");
+
+  if (!PassFilter.empty()) {
+    PassRegex.emplace(PassFilter);
+    std::string RegexError;
+    if (!PassRegex->isValid(RegexError)) {
+      reportError("invalid -pass-filter: " + RegexError);
+      return 1;
+    }
+  }
+
+  std::error_code EC;
+  ToolOutputFile Out(OutputFileName, EC, sys::fs::OF_None);
+  if (EC) {
+    reportError(OutputFileName + ": " + EC.message());
+    return 1;
+  }
+
+  int Result;
+  if (SummarySub)
+    Result = summary(Out.os());
+  else if (MergeSub)
+    Result = merge(Out.os());
+  else {
+    cl::PrintHelpMessage(false, true);
+    return 1;
+  }
+
+  if (Result == 0)
+    Out.keep();
+  return Result;
+}
@@ -158,6 +158,21 @@ static cl::opt<DIPrinter::OutputStyle>
                              clEnumValN(DIPrinter::OutputStyle::GNU, "GNU",
                                         "GNU addr2line style")));
 
+static cl::opt<bool>
+    ClBatch("batch", cl::init(false),
+            cl::desc("Read all of the input before symbolizing, and look up "
+                     "the code addresses of each module in address order"));
+
+static cl::opt<unsigned>
+    ClThreads("threads", cl::init(1),
+              cl::desc("Number of threads to symbolize different modules with "
+                       "in batch mode, 0 means one per hardware thread"));
+
+static cl::opt<uint64_t> ClCacheSize(
+    "cache-size", cl::init(0), cl::value_desc("bytes"),
+    cl::desc("Approximate maximum size of the object files and debug info "
+             "to keep loaded between addresses, 0 means no limit"));
+
 static cl::extrahelp
     HelpResponse("\nPass @FILE as argument to read options from FILE.\n");
 
@@ -216,8 +231,13 @@ static bool parseCommand(StringRef InputString, Command &Cmd,
   return !StringRef(pos, offset_length).getAsInteger(0, ModuleOffset);
 }
 
+/// Symbolizes and prints one line of input. In batch mode, the results of
+/// code addresses that were already symbolized are passed in as \p Inlined or
+/// \p Code, depending on the kind of query that the options need.
 static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
-                           DIPrinter &Printer) {
+                           DIPrinter &Printer,
+                           Expected<DIInliningInfo> *Inlined = nullptr,
+                           Expected<DILineInfo> *Code = nullptr) {
   Command Cmd;
   std::string ModuleName;
   uint64_t Offset = 0;
@@ -233,13 +253,13 @@ static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
     outs() << Delimiter;
   }
   Offset -= ClAdjustVMA;
+  object::SectionedAddress Address = {Offset,
+                                      object::SectionedAddress::UndefSection};
   if (Cmd == Command::Data) {
-    auto ResOrErr = Symbolizer.symbolizeData(
-        ModuleName, {Offset, object::SectionedAddress::UndefSection});
+    auto ResOrErr = Symbolizer.symbolizeData(ModuleName, Address);
     Printer << (error(ResOrErr) ? DIGlobal() : ResOrErr.get());
   } else if (Cmd == Command::Frame) {
-    auto ResOrErr = Symbolizer.symbolizeFrame(
-        ModuleName, {Offset, object::SectionedAddress::UndefSection});
+    auto ResOrErr = Symbolizer.symbolizeFrame(ModuleName, Address);
     if (!error(ResOrErr)) {
       for (DILocal Local : *ResOrErr)
         Printer << Local;
@@ -247,8 +267,9 @@ static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
         outs() << "??\n";
     }
   } else if (ClPrintInlining) {
-    auto ResOrErr = Symbolizer.symbolizeInlinedCode(
-        ModuleName, {Offset, object::SectionedAddress::UndefSection});
+    auto ResOrErr = Inlined ? std::move(*Inlined)
+                            : Symbolizer.symbolizeInlinedCode(ModuleName,
+                                                              Address);
     Printer << (error(ResOrErr) ? DIInliningInfo() : ResOrErr.get());
   } else if (ClOutputStyle == DIPrinter::OutputStyle::GNU) {
     // With ClPrintFunctions == FunctionNameKind::LinkageName (default)
@@ -257,18 +278,60 @@ static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
     // caller function in the inlining chain. This contradicts the existing
     // behavior of addr2line. Symbolizer.symbolizeInlinedCode() overrides only
     // the topmost function, which suits our needs better.
-    auto ResOrErr = Symbolizer.symbolizeInlinedCode(
-        ModuleName, {Offset, object::SectionedAddress::UndefSection});
+    auto ResOrErr = Inlined ? std::move(*Inlined)
+                            : Symbolizer.symbolizeInlinedCode(ModuleName,
+                                                              Address);
     Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get().getFrame(0));
   } else {
-    auto ResOrErr = Symbolizer.symbolizeCode(
-        ModuleName, {Offset, object::SectionedAddress::UndefSection});
+    auto ResOrErr = Code ? std::move(*Code)
+                         : Symbolizer.symbolizeCode(ModuleName, Address);
     Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get());
   }
   if (ClOutputStyle == DIPrinter::OutputStyle::LLVM)
     outs() << "\n";
 }
 
+/// Symbolizes all of \p Inputs, looking up the code addresses as a batch and
+/// printing the results in the order of the input.
+static void symbolizeInputBatch(ArrayRef<std::string> Inputs,
+                                LLVMSymbolizer &Symbolizer,
+                                DIPrinter &Printer) {
+  const size_t NoRequest = ~size_t(0);
+  std::vector<LLVMSymbolizer::BatchRequest> Requests;
+  std::vector<size_t> RequestForInput;
+  for (const std::string &Input : Inputs) {
+    Command Cmd;
+    std::string ModuleName;
+    uint64_t Offset = 0;
+    if (!parseCommand(Input, Cmd, ModuleName, Offset) ||
+        Cmd != Command::Code) {
+      RequestForInput.push_back(NoRequest);
+      continue;
+    }
+    RequestForInput.push_back(Requests.size());
+    Requests.push_back({ModuleName,
+                        {Offset - ClAdjustVMA,
+                         object::SectionedAddress::UndefSection}});
+  }
+
+  std::vector<Expected<DIInliningInfo>> Inlined;
+  std::vector<Expected<DILineInfo>> Code;
+  if (ClPrintInlining || ClOutputStyle == DIPrinter::OutputStyle::GNU)
+    Inlined = Symbolizer.symbolizeInlinedCodeBatch(Requests, ClThreads);
+  else
+    Code = Symbolizer.symbolizeCodeBatch(Requests, ClThreads);
+
+  for (size_t I = 0, E = Inputs.size(); I != E; ++I) {
+    size_t Request = RequestForInput[I];
+    if (Request == NoRequest)
+      symbolizeInput(Inputs[I], Symbolizer, Printer);
+    else if (!Inlined.empty())
+      symbolizeInput(Inputs[I], Symbolizer, Printer, &Inlined[Request]);
+    else
+      symbolizeInput(Inputs[I], Symbolizer, Printer, nullptr, &Code[Request]);
+  }
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
 
@@ -299,6 +362,7 @@ int main(int argc, char **argv) {
   Opts.DefaultArch = ClDefaultArch;
   Opts.FallbackDebugPath = ClFallbackDebugPath;
   Opts.DWPName = ClDwpName;
+  Opts.MaxCacheSize = ClCacheSize;
 
   for (const auto &hint : ClDsymHint) {
     if (sys::path::extension(hint) == ".dSYM") {
@@ -314,7 +378,17 @@ int main(int argc, char **argv) {
                     ClPrettyPrint, ClPrintSourceContextLines, ClVerbose,
                     ClBasenames, ClOutputStyle);
 
-  if (ClInputAddresses.empty()) {
+  if (ClBatch) {
+    std::vector<std::string> Inputs(ClInputAddresses.begin(),
+                                    ClInputAddresses.end());
+    if (Inputs.empty()) {
+      const int kMaxInputStringLength = 1024;
+      char InputString[kMaxInputStringLength];
+      while (fgets(InputString, sizeof(InputString), stdin))
+        Inputs.push_back(InputString);
+    }
+    symbolizeInputBatch(Inputs, Symbolizer, Printer);
+  } else if (ClInputAddresses.empty()) {
     const int kMaxInputStringLength = 1024;
     char InputString[kMaxInputStringLength];
 
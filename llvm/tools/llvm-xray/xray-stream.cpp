@@ -0,0 +1,450 @@
+//===- xray-stream.cpp: XRay Live Trace Aggregation -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the "stream" subcommand, which listens on a Unix socket
+// for the buffers that the XRay runtime's FDR mode streams out (see the
+// stream_socket FDR flag), and keeps function latency histograms and call stack
+// totals across every process that connects, reporting them as it goes.
+//
+// Every connection starts with a message holding the FDR file header, followed
+// by one message per buffer, laid out like a buffer in an FDR log file. The
+// latencies are kept in fixed-size histograms, so that memory use doesn't grow
+// with the number of calls, and function ids are only meaningful across
+// processes that run the same binary.
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "func-id-helper.h"
+#include "xray-registry.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Errc.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/XRay/FileHeaderReader.h"
+#include "llvm/XRay/InstrumentationMap.h"
+#include "llvm/XRay/Trace.h"
+
+#ifdef LLVM_ON_UNIX
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+using namespace llvm::xray;
+
+static cl::SubCommand Stream("stream",
+                            "Live function latency and call stack accounting");
+static cl::opt<std::string> StreamSocket(cl::Positional,
+                                         cl::desc("<unix socket path>"),
+                                         cl::Required, cl::sub(Stream));
+static cl::opt<std::string>
+    StreamInstrMap("instr_map",
+                   cl::desc("binary with the instrumentation map, or "
+                            "a separate instrumentation map"),
+                   cl::value_desc("binary with xray_instr_map"),
+                   cl::sub(Stream), cl::init(""));
+static cl::alias StreamInstrMap2("m", cl::aliasopt(StreamInstrMap),
+                                 cl::desc("Alias for -instr_map"),
+                                 cl::sub(Stream));
+static cl::opt<unsigned>
+    StreamInterval("interval",
+                   cl::desc("seconds between reports; 0 only reports on exit"),
+                   cl::value_desc("seconds"), cl::sub(Stream), cl::init(10));
+static cl::alias StreamInterval2("i", cl::aliasopt(StreamInterval),
+                                 cl::desc("Alias for -interval"),
+                                 cl::sub(Stream));
+static cl::opt<unsigned>
+    StreamTop("top", cl::desc("number of call stacks to report"),
+              cl::value_desc("N"), cl::sub(Stream), cl::init(10));
+static cl::alias StreamTop2("p", cl::aliasopt(StreamTop),
+                            cl::desc("Alias for -top"), cl::sub(Stream));
+static cl::opt<bool> StreamExitWhenIdle(
+    "exit-when-idle",
+    cl::desc("report and exit once every process that connected is gone"),
+    cl::sub(Stream), cl::init(false));
+
+#ifdef LLVM_ON_UNIX
+
+namespace {
+
+// A latency histogram with a bucket for each of the first 16 nanoseconds, and
+// then 8 buckets for each power of two, which bounds the error of a percentile
+// to an eighth of its value.
+class LatencyHistogram {
+  static constexpr unsigned kLinearBuckets = 16;
+  static constexpr unsigned kSubBuckets = 8;
+  static constexpr unsigned kNumBuckets =
+      kLinearBuckets + (64 - 4) * kSubBuckets;
+
+  std::array<uint64_t, kNumBuckets> Buckets{};
+  uint64_t Count = 0;
+  uint64_t Sum = 0;
+  uint64_t Min = std::numeric_limits<uint64_t>::max();
+  uint64_t Max = 0;
+
+  static unsigned bucket(uint64_t Nanos) {
+    if (Nanos < kLinearBuckets)
+      return Nanos;
+    unsigned Log = 63 - countLeadingZeros(Nanos);
+    unsigned Sub = (Nanos >> (Log - 3)) & (kSubBuckets - 1);
+    return kLinearBuckets + (Log - 4) * kSubBuckets + Sub;
+  }
+
+  static uint64_t lowerBound(unsigned Bucket) {
+    if (Bucket < kLinearBuckets)
+      return Bucket;
+    unsigned Log = (Bucket - kLinearBuckets) / kSubBuckets + 4;
+    unsigned Sub = (Bucket - kLinearBuckets) % kSubBuckets;
+    return (uint64_t{1} << Log) + (uint64_t{Sub} << (Log - 3));
+  }
+
+public:
+  void add(uint64_t Nanos) {
+    ++Buckets[bucket(Nanos)];
+    ++Count;
+    Sum += Nanos;
+    Min = std::min(Min, Nanos);
+    Max = std::max(Max, Nanos);
+  }
+
+  uint64_t count() const { return Count; }
+  uint64_t sum() const { return Sum; }
+  uint64_t min() const { return Count ? Min : 0; }
+  uint64_t max() const { return Max; }
+
+  uint64_t percentile(double P) const {
+    uint64_t Rank = static_cast<uint64_t>(P * Count);
+    uint64_t Seen = 0;
+    for (unsigned I = 0; I < kNumBuckets; ++I) {
+      Seen += Buckets[I];
+      if (Seen > Rank)
+        return std::max(std::min(lowerBound(I), Max), min());
+    }
+    return Max;
+  }
+};
+
+struct StackTotals {
+  uint64_t Count = 0;
+  uint64_t Sum = 0;
+};
+
+// The functions a thread has entered but not exited yet, and when.
+using ThreadStack = std::vector<std::pair<int32_t, uint64_t>>;
+
+// A process streaming its buffers to us.
+struct Connection {
+  int FD = -1;
+  bool HaveHeader = false;
+  std::string Header;
+  double NanosPerCycle = 1.0;
+  std::map<uint32_t, ThreadStack> Threads;
+};
+
+class StreamAggregator {
+  FuncIdConversionHelper &FuncIdHelper;
+  std::map<int32_t, LatencyHistogram> Functions;
+  std::map<std::vector<int32_t>, StackTotals> Stacks;
+  uint64_t BufferCount = 0;
+  uint64_t BadBufferCount = 0;
+
+public:
+  explicit StreamAggregator(FuncIdConversionHelper &FuncIdHelper)
+      : FuncIdHelper(FuncIdHelper) {}
+
+  // Accounts for the records in a buffer message. Records of calls entered in
+  // buffers that we never got, because they were sent before we were
+  // listening or dropped when we fell behind, are skipped.
+  void accountBuffer(Connection &C, StringRef Message);
+
+  void report(raw_ostream &OS, size_t Connections) const;
+};
+
+void StreamAggregator::accountBuffer(Connection &C, StringRef Message) {
+  // Each buffer starts with the records naming its thread and process, so a
+  // buffer behind the header reads like a log file of its own.
+  std::string Data = C.Header;
+  Data.append(Message.begin(), Message.end());
+  DataExtractor DE(StringRef(Data), true, 8);
+  auto TraceOrErr = loadTrace(DE, /*Sort=*/false);
+  if (!TraceOrErr) {
+    consumeError(TraceOrErr.takeError());
+    ++BadBufferCount;
+    return;
+  }
+  ++BufferCount;
+
+  for (const auto &Record : *TraceOrErr) {
+    auto &Stack = C.Threads[Record.TId];
+    switch (Record.Type) {
+    case RecordTypes::ENTER:
+    case RecordTypes::ENTER_ARG:
+      Stack.emplace_back(Record.FuncId, Record.TSC);
+      break;
+    case RecordTypes::EXIT:
+    case RecordTypes::TAIL_EXIT: {
+      auto It = std::find_if(Stack.rbegin(), Stack.rend(),
+                             [&](const std::pair<int32_t, uint64_t> &E) {
+                               return E.first == Record.FuncId;
+                             });
+      if (It == Stack.rend())
+        break;
+      size_t Depth = Stack.rend() - It;
+      if (Record.TSC >= It->second) {
+        uint64_t Nanos = (Record.TSC - It->second) * C.NanosPerCycle;
+        Functions[Record.FuncId].add(Nanos);
+        std::vector<int32_t> Path;
+        Path.reserve(Depth);
+        for (size_t I = 0; I < Depth; ++I)
+          Path.push_back(Stack[I].first);
+        auto &Totals = Stacks[std::move(Path)];
+        ++Totals.Count;
+        Totals.Sum += Nanos;
+      }
+      // Functions entered since are left without a matching exit; drop them.
+      Stack.resize(Depth - 1);
+      break;
+    }
+    case RecordTypes::CUSTOM_EVENT:
+    case RecordTypes::TYPED_EVENT:
+      break;
+    }
+  }
+}
+
+void StreamAggregator::report(raw_ostream &OS, size_t Connections) const {
+  OS << formatv("Processes connected: {0}; buffers: {1}; unreadable: {2}\n",
+                Connections, BufferCount, BadBufferCount);
+
+  // Functions go from the most time spent in them down, in seconds, like the
+  // "account" subcommand reports them.
+  std::vector<std::pair<int32_t, const LatencyHistogram *>> Rows;
+  for (const auto &F : Functions)
+    Rows.emplace_back(F.first, &F.second);
+  llvm::sort(Rows, [](const std::pair<int32_t, const LatencyHistogram *> &L,
+                      const std::pair<int32_t, const LatencyHistogram *> &R) {
+    return L.second->sum() > R.second->sum();
+  });
+
+  static constexpr char HeaderFormat[] =
+      "{0,+9} {1,+10} [{2,+9}, {3,+9}, {4,+9}, {5,+9}, {6,+9}] {7,+9}";
+  static constexpr char RowFormat[] =
+      R"({0,+9} {1,+10} [{2,+9:f6}, {3,+9:f6}, {4,+9:f6}, {5,+9:f6}, {6,+9:f6}] {7,+9:f6})";
+  OS << "Functions with latencies: " << Rows.size() << "\n";
+  OS << formatv(HeaderFormat, "funcid", "count", "min", "med", "90p", "99p",
+                "max", "sum")
+     << formatv("  {0,-12}\n", "function");
+  for (const auto &Row : Rows) {
+    const LatencyHistogram &H = *Row.second;
+    OS << formatv(RowFormat, Row.first, H.count(), H.min() / 1e9,
+                  H.percentile(0.5) / 1e9, H.percentile(0.9) / 1e9,
+                  H.percentile(0.99) / 1e9, H.max() / 1e9, H.sum() / 1e9)
+       << "  " << FuncIdHelper.FileLineAndColumn(Row.first) << ": "
+       << FuncIdHelper.SymbolOrNumber(Row.first) << "\n";
+  }
+
+  std::vector<std::pair<const std::vector<int32_t> *, StackTotals>> Top;
+  for (const auto &S : Stacks)
+    Top.emplace_back(&S.first, S.second);
+  size_t N = std::min<size_t>(StreamTop, Top.size());
+  std::partial_sort(
+      Top.begin(), Top.begin() + N, Top.end(),
+      [](const std::pair<const std::vector<int32_t> *, StackTotals> &L,
+         const std::pair<const std::vector<int32_t> *, StackTotals> &R) {
+        return L.second.Sum > R.second.Sum;
+      });
+  OS << "Top " << N << " call stacks by time spent:\n";
+  for (size_t I = 0; I < N; ++I) {
+    const auto &Path = *Top[I].first;
+    OS << formatv("count: {0}; sum: {1:f6}\n", Top[I].second.Count,
+                  Top[I].second.Sum / 1e9);
+    size_t Level = Path.size();
+    for (int32_t FuncId : llvm::reverse(Path))
+      OS << "  #" << --Level << "\t" << FuncIdHelper.SymbolOrNumber(FuncId)
+         << "\n";
+  }
+  OS << "\n";
+  OS.flush();
+}
+
+static std::atomic<bool> Interrupted(false);
+
+} // namespace
+
+static Expected<int> listenOn(StringRef Path) {
+  sockaddr_un Addr{};
+  Addr.sun_family = AF_UNIX;
+  if (Path.size() >= sizeof(Addr.sun_path))
+    return createStringError(std::make_error_code(std::errc::invalid_argument),
+                             "Socket path '%s' is too long.",
+                             Path.str().c_str());
+  std::copy(Path.begin(), Path.end(), Addr.sun_path);
+
+  int FD = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (FD < 0)
+    return errorCodeToError(std::error_code(errno, std::generic_category()));
+  if (bind(FD, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) != 0 ||
+      listen(FD, SOMAXCONN) != 0) {
+    std::error_code EC(errno, std::generic_category());
+    close(FD);
+    return createStringError(EC, "Cannot listen on '%s'.", Path.str().c_str());
+  }
+  return FD;
+}
+
+// Reads the messages waiting on C, until there are none left, and closes C
+// when the process is gone or doesn't speak the protocol.
+static void readMessages(Connection &C, StreamAggregator &Aggregator,
+                         std::vector<char> &Message) {
+  while (true) {
+    iovec Part = {Message.data(), Message.size()};
+    msghdr Header{};
+    Header.msg_iov = &Part;
+    Header.msg_iovlen = 1;
+    ssize_t Size = recvmsg(C.FD, &Header, MSG_DONTWAIT);
+    if (Size < 0 && errno == EINTR)
+      continue;
+    if (Size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      return;
+    if (Size <= 0)
+      break;
+    if (Header.msg_flags & MSG_TRUNC) {
+      errs() << "Skipping a buffer larger than " << Message.size()
+             << " bytes.\n";
+      continue;
+    }
+
+    StringRef Data(Message.data(), Size);
+    if (C.HaveHeader) {
+      Aggregator.accountBuffer(C, Data);
+      continue;
+    }
+    DataExtractor DE(Data, true, 8);
+    uint64_t Offset = 0;
+    auto FileHeaderOrErr = readBinaryFormatHeader(DE, Offset);
+    if (!FileHeaderOrErr || Offset != Data.size()) {
+      consumeError(FileHeaderOrErr.takeError());
+      errs() << "Dropping a connection that didn't start with a header.\n";
+      break;
+    }
+    C.Header = Data.str();
+    C.HaveHeader = true;
+    if (FileHeaderOrErr->CycleFrequency != 0)
+      C.NanosPerCycle = 1e9 / FileHeaderOrErr->CycleFrequency;
+  }
+  close(C.FD);
+  C.FD = -1;
+}
+
+static CommandRegistration Unused(&Stream, []() -> Error {
+  InstrumentationMap Map;
+  if (!StreamInstrMap.empty()) {
+    auto InstrumentationMapOrError = loadInstrumentationMap(StreamInstrMap);
+    if (!InstrumentationMapOrError)
+      return joinErrors(
+          make_error<StringError>(
+              Twine("Cannot open instrumentation map: ") + StreamInstrMap,
+              std::make_error_code(std::errc::invalid_argument)),
+          InstrumentationMapOrError.takeError());
+    Map = std::move(*InstrumentationMapOrError);
+  }
+
+  auto ListenFDOrErr = listenOn(StreamSocket);
+  if (!ListenFDOrErr)
+    return ListenFDOrErr.takeError();
+  int ListenFD = *ListenFDOrErr;
+  sys::RemoveFileOnSignal(StreamSocket);
+  sys::SetInterruptFunction([] { Interrupted = true; });
+
+  symbolize::LLVMSymbolizer Symbolizer;
+  FuncIdConversionHelper FuncIdHelper(StreamInstrMap, Symbolizer,
+                                      Map.getFunctionAddresses());
+  StreamAggregator Aggregator(FuncIdHelper);
+  std::vector<std::unique_ptr<Connection>> Connections;
+  bool HadConnections = false;
+
+  // Buffers are 16KiB by default, and can't be much larger than the socket's
+  // send buffer for the runtime to be able to send them at all.
+  std::vector<char> Message(1 << 20);
+  using Clock = std::chrono::steady_clock;
+  auto NextReport = Clock::now() + std::chrono::seconds(StreamInterval);
+
+  while (!Interrupted) {
+    if (StreamExitWhenIdle && HadConnections && Connections.empty())
+      break;
+
+    std::vector<pollfd> FDs;
+    FDs.push_back({ListenFD, POLLIN, 0});
+    for (const auto &C : Connections)
+      FDs.push_back({C->FD, POLLIN, 0});
+    int Timeout = -1;
+    if (StreamInterval != 0)
+      Timeout = std::max<int64_t>(
+          0, std::chrono::duration_cast<std::chrono::milliseconds>(
+                 NextReport - Clock::now())
+                 .count());
+    if (poll(FDs.data(), FDs.size(), Timeout) < 0 && errno != EINTR)
+      return errorCodeToError(std::error_code(errno, std::generic_category()));
+
+    if (FDs[0].revents & POLLIN) {
+      int FD = accept4(ListenFD, nullptr, nullptr, SOCK_CLOEXEC);
+      if (FD >= 0) {
+        Connections.push_back(std::make_unique<Connection>());
+        Connections.back()->FD = FD;
+        HadConnections = true;
+      }
+    }
+
+    for (size_t I = 1; I < FDs.size(); ++I)
+      if (FDs[I].revents != 0)
+        readMessages(*Connections[I - 1], Aggregator, Message);
+    Connections.erase(std::remove_if(Connections.begin(), Connections.end(),
+                                     [](const std::unique_ptr<Connection> &C) {
+                                       return C->FD < 0;
+                                     }),
+                      Connections.end());
+
+    if (StreamInterval != 0 && Clock::now() >= NextReport) {
+      Aggregator.report(outs(), Connections.size());
+      NextReport = Clock::now() + std::chrono::seconds(StreamInterval);
+    }
+  }
+
+  Aggregator.report(outs(), Connections.size());
+  for (const auto &C : Connections)
+    close(C->FD);
+  close(ListenFD);
+  unlink(StreamSocket.c_str());
+  return Error::success();
+});
+
+#else // !LLVM_ON_UNIX
+
+static CommandRegistration Unused(&Stream, []() -> Error {
+  return make_error<StringError>(
+      "The stream subcommand needs Unix domain sockets.",
+      std::make_error_code(std::errc::not_supported));
+});
+
+#endif // LLVM_ON_UNIX
@@ -913,8 +913,10 @@ int main(int argc, char **argv) {
              "the compile-twice option\n";
       Out->os() << BOS->str();
       Out->keep();
-      if (RemarksFile)
+      if (RemarksFile) {
+        Context.getRemarkStreamer()->finalize();
         RemarksFile->keep();
+      }
       return 1;
     }
     Out->os() << BOS->str();
@@ -927,8 +929,10 @@ int main(int argc, char **argv) {
   if (!NoOutput || PrintBreakpoints)
     Out->keep();
 
-  if (RemarksFile)
+  if (RemarksFile) {
+    Context.getRemarkStreamer()->finalize();
     RemarksFile->keep();
+  }
 
   if (ThinLinkOut)
     ThinLinkOut->keep();
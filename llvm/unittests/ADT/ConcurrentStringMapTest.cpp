@@ -0,0 +1,121 @@
+//===- llvm/unittest/ADT/ConcurrentStringMapTest.cpp ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/ConcurrentStringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Config/llvm-config.h"
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentStringMapTest, Basics) {
+  ConcurrentStringMap<unsigned> Map;
+  EXPECT_TRUE(Map.empty());
+  EXPECT_EQ(nullptr, Map.find("a"));
+  EXPECT_EQ(0U, Map.lookup("a"));
+
+  auto R = Map.try_emplace("a", 1U);
+  EXPECT_TRUE(R.second);
+  EXPECT_EQ("a", R.first->getKey());
+  EXPECT_EQ(1U, R.first->getValue());
+  EXPECT_EQ('\0', R.first->getKeyData()[1]);
+
+  auto R2 = Map.insert(std::make_pair("a", 2U));
+  EXPECT_FALSE(R2.second);
+  EXPECT_EQ(R.first, R2.first);
+  EXPECT_EQ(1U, Map.lookup("a"));
+
+  EXPECT_TRUE(Map.try_emplace("", 3U).second);
+  EXPECT_EQ(3U, Map.lookup(""));
+  EXPECT_EQ(1U, Map.count(""));
+  EXPECT_EQ(2U, Map.size());
+}
+
+TEST(ConcurrentStringMapTest, Grow) {
+  ConcurrentStringMap<unsigned> Map;
+  std::vector<StringMapEntry<unsigned> *> Entries;
+  for (unsigned I = 0; I != 1000; ++I)
+    Entries.push_back(Map.try_emplace(std::to_string(I), I).first);
+  EXPECT_EQ(1000U, Map.size());
+
+  // Entries do not move when the table grows.
+  for (unsigned I = 0; I != 1000; ++I) {
+    EXPECT_EQ(Entries[I], Map.find(std::to_string(I)));
+    EXPECT_EQ(I, Entries[I]->getValue());
+  }
+  EXPECT_EQ(nullptr, Map.find("1000"));
+
+  StringSet<> Seen;
+  for (auto &Entry : Map) {
+    EXPECT_EQ(std::to_string(Entry.getValue()), Entry.getKey());
+    EXPECT_TRUE(Seen.insert(Entry.getKey()).second);
+  }
+  EXPECT_EQ(1000U, Seen.size());
+}
+
+TEST(ConcurrentStringMapTest, NonTrivialValues) {
+  auto Value = std::make_shared<int>(1);
+  {
+    ConcurrentStringMap<std::shared_ptr<int>> Map(100);
+    Map.try_emplace("a", Value);
+    Map.try_emplace("a", Value);
+    EXPECT_EQ(2, Value.use_count());
+  }
+  // The map destroys its values.
+  EXPECT_EQ(1, Value.use_count());
+}
+
+#if LLVM_ENABLE_THREADS
+// Insert overlapping sets of keys from several threads, starting from a small
+// table so that it grows while the threads insert.
+TEST(ConcurrentStringMapTest, ConcurrentInsertion) {
+  const unsigned NumThreads = 8, NumKeys = 20000;
+  std::vector<std::string> Keys;
+  for (unsigned I = 0; I != NumKeys; ++I)
+    Keys.push_back("key" + std::to_string(I));
+
+  ConcurrentStringMap<unsigned> Map;
+  std::vector<std::vector<StringMapEntry<unsigned> *>> Entries(NumThreads);
+  std::vector<unsigned> NumInserted(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      for (unsigned I = 0; I != NumKeys; ++I) {
+        unsigned K = (I + T * NumKeys / NumThreads) % NumKeys;
+        auto R = Map.try_emplace(Keys[K], K);
+        Entries[T].push_back(R.first);
+        NumInserted[T] += R.second;
+        EXPECT_EQ(R.first, Map.find(Keys[K]));
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  unsigned TotalInserted = 0;
+  for (unsigned N : NumInserted)
+    TotalInserted += N;
+  EXPECT_EQ(NumKeys, TotalInserted);
+  EXPECT_EQ(NumKeys, Map.size());
+
+  // Every thread got the same entry for each key.
+  for (unsigned T = 0; T != NumThreads; ++T)
+    for (unsigned I = 0; I != NumKeys; ++I) {
+      unsigned K = (I + T * NumKeys / NumThreads) % NumKeys;
+      EXPECT_EQ(Map.find(Keys[K]), Entries[T][I]);
+      EXPECT_EQ(K, Entries[T][I]->getValue());
+    }
+}
+#endif
+
+} // end anonymous namespace
@@ -505,6 +505,21 @@ TEST(StringRefTest, Count) {
   EXPECT_EQ(1U, Str.count("hello"));
   EXPECT_EQ(1U, Str.count("ello"));
   EXPECT_EQ(0U, Str.count("zz"));
+
+  StringRef LongStr("abcabcabcabcabcabcabcab");
+  EXPECT_EQ(7U, LongStr.count("abc"));
+  EXPECT_EQ(7U, LongStr.count("cab"));
+  EXPECT_EQ(1U, LongStr.count(LongStr));
+}
+
+TEST(StringRefTest, FindLongNeedle) {
+  std::string Needle(300, 'a');
+  Needle.back() = 'b';
+  std::string Haystack = std::string(400, 'a') + Needle + "c";
+  StringRef Str(Haystack);
+  EXPECT_EQ(400U, Str.find(Needle));
+  EXPECT_EQ(StringRef::npos, Str.find(Needle, 401));
+  EXPECT_EQ(StringRef::npos, Str.drop_back(2).find(Needle));
 }
 
 TEST(StringRefTest, EditDistance) {
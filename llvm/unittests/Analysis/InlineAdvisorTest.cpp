@@ -0,0 +1,121 @@
+//===- InlineAdvisorTest.cpp - InlineAdvisor unit tests -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/InlineAdvisor.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/InlineCost.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+const char *ModuleString = "define internal i32 @callee(i32 %x) {\n"
+                           "entry:\n"
+                           "  %c = icmp eq i32 %x, 0\n"
+                           "  br i1 %c, label %a, label %b\n"
+                           "a:\n"
+                           "  ret i32 1\n"
+                           "b:\n"
+                           "  ret i32 %x\n"
+                           "}\n"
+                           "define i32 @caller(i32 %x) {\n"
+                           "entry:\n"
+                           "  %r = call i32 @callee(i32 %x)\n"
+                           "  %s = call i32 @callee(i32 7)\n"
+                           "  %t = add i32 %r, %s\n"
+                           "  ret i32 %t\n"
+                           "}\n";
+
+class InlineAdvisorTest : public testing::Test {
+protected:
+  void SetUp() override {
+    SMDiagnostic Err;
+    M = parseAssemblyString(ModuleString, Err, C);
+    ASSERT_TRUE(M);
+    Caller = M->getFunction("caller");
+    DT.reset(new DominatorTree(*Caller));
+    LI.reset(new LoopInfo(*DT));
+    BPI.reset(new BranchProbabilityInfo(*Caller, *LI));
+    BFI.reset(new BlockFrequencyInfo(*Caller, *BPI, *LI));
+  }
+
+  CallBase &getCall(unsigned N) {
+    for (Instruction &I : instructions(Caller))
+      if (auto *CB = dyn_cast<CallBase>(&I))
+        if (N-- == 0)
+          return *CB;
+    llvm_unreachable("No such call");
+  }
+
+  LLVMContext C;
+  std::unique_ptr<Module> M;
+  Function *Caller;
+  std::unique_ptr<DominatorTree> DT;
+  std::unique_ptr<LoopInfo> LI;
+  std::unique_ptr<BranchProbabilityInfo> BPI;
+  std::unique_ptr<BlockFrequencyInfo> BFI;
+};
+
+TEST_F(InlineAdvisorTest, Features) {
+  InlineFeatures Features =
+      getInlineFeatures(getCall(1), InlineCost::get(10, 20), BFI.get(),
+                        /*PSI=*/nullptr, /*SCCSize=*/1,
+                        /*CalleeInSameSCC=*/false);
+  EXPECT_EQ(10, Features.Cost);
+  EXPECT_EQ(20, Features.Threshold);
+  EXPECT_EQ(4u, Features.CalleeInstructions);
+  EXPECT_EQ(3u, Features.CalleeBlocks);
+  EXPECT_EQ(4u, Features.CallerInstructions);
+  EXPECT_EQ(2u, Features.CalleeUses);
+  EXPECT_TRUE(Features.CalleeHasLocalLinkage);
+  EXPECT_EQ(1u, Features.NumArgs);
+  EXPECT_EQ(1u, Features.NumConstantArgs);
+  EXPECT_EQ(InlineFeatures::FrequencyScale, Features.CallSiteFrequency);
+  EXPECT_FALSE(Features.CallSiteCount);
+  EXPECT_EQ(1u, Features.SCCSize);
+  EXPECT_FALSE(Features.CalleeInSameSCC);
+
+  // The default advisor follows the cost model.
+  InlineAdvisor Advisor;
+  EXPECT_TRUE(Advisor.shouldInline(Features));
+  Features.Cost = 30;
+  EXPECT_FALSE(Advisor.shouldInline(Features));
+}
+
+TEST_F(InlineAdvisorTest, Logger) {
+  std::string Log;
+  {
+    InlineDecisionLogger Logger(std::make_unique<InlineAdvisor>(),
+                                std::make_unique<raw_string_ostream>(Log),
+                                /*WriteHeader=*/true);
+    InlineFeatures Features =
+        getInlineFeatures(getCall(0), InlineCost::get(30, 20), BFI.get(),
+                          /*PSI=*/nullptr, /*SCCSize=*/2,
+                          /*CalleeInSameSCC=*/true);
+    EXPECT_FALSE(Logger.shouldInline(Features));
+    Logger.recordOutcome(Features, /*Advised=*/false, /*Inlined=*/false);
+  }
+  StringRef Header, Line;
+  std::tie(Header, Line) = StringRef(Log).split('\n');
+  EXPECT_TRUE(Header.startswith("cost,threshold,"));
+  EXPECT_EQ("30,20,4,3,4,2,1,1,0,1000,,2,1,0,0\n", Line);
+}
+
+} // end anonymous namespace
@@ -9,9 +9,13 @@
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/DebugInfo/GSYM/BreakpadTransformer.h"
 #include "llvm/DebugInfo/GSYM/FileEntry.h"
 #include "llvm/DebugInfo/GSYM/FileWriter.h"
 #include "llvm/DebugInfo/GSYM/FunctionInfo.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/Header.h"
 #include "llvm/DebugInfo/GSYM/InlineInfo.h"
 #include "llvm/DebugInfo/GSYM/Range.h"
 #include "llvm/DebugInfo/GSYM/StringTable.h"
@@ -633,3 +637,367 @@ TEST(GSYMTest, TestAddressRangesEncodeDecode) {
   Ranges.insert(AddressRange(0x1050, 0x1070));
   TestAddressRangeEncodeDecodeHelper(Ranges, BaseAddr);
 }
+
+static void TestFunctionInfoEncodeDecode(llvm::support::endianness ByteOrder,
+                                         const FunctionInfo &FI) {
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, ByteOrder);
+  llvm::Expected<uint64_t> ExpectedOffset = FI.encode(FW);
+  ASSERT_TRUE(bool(ExpectedOffset));
+  EXPECT_EQ(*ExpectedOffset, 0u);
+  std::string Bytes(OutStrm.str());
+  uint8_t AddressSize = 4;
+  DataExtractor Data(Bytes, ByteOrder == llvm::support::little, AddressSize);
+  llvm::Expected<FunctionInfo> Decoded =
+      FunctionInfo::decode(Data, FI.startAddress());
+  ASSERT_TRUE(bool(Decoded));
+  EXPECT_EQ(FI, Decoded.get());
+}
+
+TEST(GSYMTest, TestFunctionInfoEncodeDecode) {
+  const uint64_t FuncAddr = 0x1000;
+  const uint64_t FuncSize = 0x100;
+  // Test a FunctionInfo with only a name and a range.
+  FunctionInfo FI(FuncAddr, FuncSize, 7);
+  TestFunctionInfoEncodeDecode(llvm::support::little, FI);
+  TestFunctionInfoEncodeDecode(llvm::support::big, FI);
+  // Add a line table whose lines go up and down.
+  FI.Lines.push_back(LineEntry(FuncAddr, 1, 20));
+  FI.Lines.push_back(LineEntry(FuncAddr + 0x10, 1, 12));
+  FI.Lines.push_back(LineEntry(FuncAddr + 0x40, 2, 1000));
+  TestFunctionInfoEncodeDecode(llvm::support::little, FI);
+  TestFunctionInfoEncodeDecode(llvm::support::big, FI);
+  // Add inline info.
+  FI.Inline.Ranges.insert(FI.Range);
+  InlineInfo Inline;
+  Inline.Name = 9;
+  Inline.CallFile = 1;
+  Inline.CallLine = 14;
+  Inline.Ranges.insert(AddressRange(FuncAddr + 0x10, FuncAddr + 0x20));
+  FI.Inline.Children.push_back(Inline);
+  TestFunctionInfoEncodeDecode(llvm::support::little, FI);
+  TestFunctionInfoEncodeDecode(llvm::support::big, FI);
+}
+
+TEST(GSYMTest, TestFunctionInfoErrors) {
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  const auto ByteOrder = llvm::support::endian::system_endianness();
+  FileWriter FW(OutStrm, ByteOrder);
+  // A FunctionInfo without a name can't be encoded.
+  FunctionInfo Invalid;
+  checkError("attempted to encode invalid FunctionInfo object",
+             Invalid.encode(FW).takeError());
+  // Line table entries must be sorted.
+  FunctionInfo Unsorted(0x1000, 0x100, 1);
+  Unsorted.Lines.push_back(LineEntry(0x1010, 1, 1));
+  Unsorted.Lines.push_back(LineEntry(0x1000, 1, 2));
+  checkError("line table entries are not sorted by address",
+             Unsorted.encode(FW).takeError());
+
+  // Check the errors of truncated data.
+  auto CheckDecodeError = [&](StringRef Bytes, std::string ExpectedErrorMsg) {
+    DataExtractor Data(Bytes, ByteOrder == llvm::support::little, 4);
+    checkError(ExpectedErrorMsg,
+               FunctionInfo::decode(Data, 0x1000).takeError());
+  };
+  Str.clear();
+  CheckDecodeError(OutStrm.str(),
+                   "0x00000000: missing FunctionInfo Size");
+  FW.writeU32(0x100);
+  CheckDecodeError(OutStrm.str(),
+                   "0x00000004: missing FunctionInfo Name");
+  FW.writeU32(0);
+  CheckDecodeError(OutStrm.str(),
+                   "0x00000004: invalid FunctionInfo Name value 0x00000000");
+  FW.fixup32(1, 4);
+  CheckDecodeError(OutStrm.str(),
+                   "0x00000008: missing FunctionInfo InfoType value");
+  FW.writeU32(1);
+  CheckDecodeError(OutStrm.str(),
+                   "0x0000000c: missing FunctionInfo InfoType length");
+  FW.writeU32(4);
+  CheckDecodeError(OutStrm.str(),
+                   "0x00000010: missing FunctionInfo data for InfoType 1");
+}
+
+TEST(GSYMTest, TestHeader) {
+  Header H;
+  H.Magic = GSYM_MAGIC;
+  H.Version = GSYM_VERSION;
+  H.AddrOffSize = 4;
+  H.UUIDSize = 16;
+  H.BaseAddress = 0x1000;
+  H.NumAddresses = 2;
+  H.StrtabOffset = 0x100;
+  H.StrtabSize = 0x20;
+  for (size_t I = 0; I < GSYM_MAX_UUID_SIZE; ++I)
+    H.UUID[I] = I < H.UUIDSize ? I : 0;
+  EXPECT_FALSE(bool(H.checkForError()));
+
+  for (auto ByteOrder : {llvm::support::little, llvm::support::big}) {
+    SmallString<512> Str;
+    raw_svector_ostream OutStrm(Str);
+    FileWriter FW(OutStrm, ByteOrder);
+    ASSERT_FALSE(bool(H.encode(FW)));
+    EXPECT_EQ(Str.size(), sizeof(Header));
+    std::string Bytes(OutStrm.str());
+    DataExtractor Data(Bytes, ByteOrder == llvm::support::little, 4);
+    llvm::Expected<Header> Decoded = Header::decode(Data);
+    ASSERT_TRUE(bool(Decoded));
+    EXPECT_EQ(H, Decoded.get());
+  }
+
+  Header Bad = H;
+  Bad.Magic = 1;
+  checkError("invalid GSYM magic 0x00000001", Bad.checkForError());
+  Bad = H;
+  Bad.Version = 2;
+  checkError("unsupported GSYM version 2", Bad.checkForError());
+  Bad = H;
+  Bad.AddrOffSize = 3;
+  checkError("invalid address offset size 3", Bad.checkForError());
+  Bad = H;
+  Bad.UUIDSize = GSYM_MAX_UUID_SIZE + 1;
+  checkError("invalid UUID size 21", Bad.checkForError());
+}
+
+TEST(GSYMTest, TestGsymCreatorStrings) {
+  GsymCreator GC;
+  // The empty string is always at offset zero.
+  EXPECT_EQ(GC.insertString(""), 0u);
+  const uint32_t Hello = GC.insertString("hello");
+  EXPECT_NE(Hello, 0u);
+  EXPECT_EQ(GC.insertString("hello"), Hello);
+  EXPECT_NE(GC.insertString("world"), Hello);
+  // Files share their directories, and are uniqued.
+  const uint32_t FileA = GC.insertFile("/tmp/a.c", sys::path::Style::posix);
+  const uint32_t FileB = GC.insertFile("/tmp/b.c", sys::path::Style::posix);
+  EXPECT_NE(FileA, 0u);
+  EXPECT_NE(FileA, FileB);
+  EXPECT_EQ(GC.insertFile("/tmp/a.c", sys::path::Style::posix), FileA);
+}
+
+static void TestGsymCreatorReader(llvm::support::endianness ByteOrder,
+                                  uint64_t FuncSpacing) {
+  GsymCreator GC;
+  const uint32_t Main = GC.insertString("main");
+  const uint32_t Foo = GC.insertString("foo");
+  const uint32_t Bar = GC.insertString("bar");
+  const uint32_t File = GC.insertFile("/tmp/main.c", sys::path::Style::posix);
+  const uint64_t MainAddr = 0x1000;
+  const uint64_t FooAddr = MainAddr + FuncSpacing;
+  const uint64_t BarAddr = FooAddr + FuncSpacing;
+
+  // main has a line table and a call to foo that was inlined.
+  FunctionInfo MainFI(MainAddr, 0x50, Main);
+  MainFI.Lines.push_back(LineEntry(MainAddr, File, 10));
+  MainFI.Lines.push_back(LineEntry(MainAddr + 0x10, File, 3));
+  MainFI.Lines.push_back(LineEntry(MainAddr + 0x20, File, 12));
+  MainFI.Inline.Ranges.insert(MainFI.Range);
+  InlineInfo InlinedFoo;
+  InlinedFoo.Name = Foo;
+  InlinedFoo.CallFile = File;
+  InlinedFoo.CallLine = 11;
+  InlinedFoo.Ranges.insert(AddressRange(MainAddr + 0x10, MainAddr + 0x20));
+  MainFI.Inline.Children.push_back(InlinedFoo);
+  // foo only comes from the symbol table, once without debug info and once
+  // without a size. bar has no size either.
+  GC.addFunctionInfo(FunctionInfo(FooAddr, 0, Foo));
+  GC.addFunctionInfo(FunctionInfo(FooAddr, 0x20, Foo));
+  GC.addFunctionInfo(FunctionInfo(BarAddr, 0, Bar));
+  // Add main twice with less information the second time.
+  GC.addFunctionInfo(FunctionInfo(MainAddr, 0x50, Main));
+  GC.addFunctionInfo(FunctionInfo(MainFI));
+
+  // Encoding requires finalization.
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, ByteOrder);
+  checkError("GsymCreator wasn't finalized prior to encoding",
+             GC.encode(FW));
+  std::string Log;
+  raw_string_ostream LogStrm(Log);
+  ASSERT_FALSE(bool(GC.finalize(LogStrm)));
+  EXPECT_EQ(LogStrm.str(), "");
+  ASSERT_FALSE(bool(GC.encode(FW)));
+
+  Expected<GsymReader> GR = GsymReader::copyBuffer(OutStrm.str());
+  ASSERT_TRUE(bool(GR));
+  const Header &Hdr = GR->getHeader();
+  EXPECT_EQ(Hdr.BaseAddress, MainAddr);
+  EXPECT_EQ(Hdr.NumAddresses, 3u);
+  EXPECT_EQ(GR->getAddress(0), Optional<uint64_t>(MainAddr));
+  EXPECT_EQ(GR->getAddress(2), Optional<uint64_t>(BarAddr));
+  EXPECT_EQ(GR->getAddress(3), None);
+
+  // The best FunctionInfo was kept for main.
+  Expected<FunctionInfo> DecodedMain = GR->getFunctionInfo(MainAddr + 0x4f);
+  ASSERT_TRUE(bool(DecodedMain));
+  EXPECT_EQ(*DecodedMain, MainFI);
+
+  // A lookup in the inlined function unwinds to main.
+  Expected<LookupResult> LR = GR->lookup(MainAddr + 0x18);
+  ASSERT_TRUE(bool(LR));
+  EXPECT_EQ(LR->FuncName, "main");
+  EXPECT_EQ(LR->FuncRange, MainFI.Range);
+  ASSERT_EQ(LR->Locations.size(), 2u);
+  EXPECT_EQ(LR->Locations[0].Name, "foo");
+  EXPECT_EQ(LR->Locations[0].Dir, "/tmp");
+  EXPECT_EQ(LR->Locations[0].Base, "main.c");
+  EXPECT_EQ(LR->Locations[0].Line, 3u);
+  EXPECT_EQ(LR->Locations[1].Name, "main");
+  EXPECT_EQ(LR->Locations[1].Line, 11u);
+  EXPECT_EQ(LR->getSourceFile(1), "/tmp/main.c");
+
+  // A lookup outside of the inlined function has a single location.
+  LR = GR->lookup(MainAddr + 0x24);
+  ASSERT_TRUE(bool(LR));
+  ASSERT_EQ(LR->Locations.size(), 1u);
+  EXPECT_EQ(LR->Locations[0].Name, "main");
+  EXPECT_EQ(LR->Locations[0].Line, 12u);
+
+  // foo has a size and no line table.
+  LR = GR->lookup(FooAddr + 0x1f);
+  ASSERT_TRUE(bool(LR));
+  EXPECT_EQ(LR->FuncName, "foo");
+  ASSERT_EQ(LR->Locations.size(), 1u);
+  EXPECT_EQ(LR->Locations[0].Base, "");
+  EXPECT_EQ(LR->Locations[0].Line, 0u);
+
+  // bar has no size, so it only contains its address.
+  LR = GR->lookup(BarAddr);
+  ASSERT_TRUE(bool(LR));
+  EXPECT_EQ(LR->FuncName, "bar");
+
+  // Addresses in between functions or outside of all functions fail.
+  for (uint64_t Addr : {MainAddr - 1, MainAddr + 0x50, FooAddr + 0x20,
+                        BarAddr + 1}) {
+    std::string Msg;
+    raw_string_ostream(Msg) << "address " << format_hex(Addr, 1)
+                            << " is not in GSYM";
+    checkError(Msg, GR->lookup(Addr).takeError());
+  }
+}
+
+TEST(GSYMTest, TestGsymCreatorReader) {
+  // Test each size of address offsets in both byte orders.
+  for (auto ByteOrder : {llvm::support::little, llvm::support::big}) {
+    TestGsymCreatorReader(ByteOrder, 0x60);
+    TestGsymCreatorReader(ByteOrder, 0x1000);
+    TestGsymCreatorReader(ByteOrder, 0x100000);
+    TestGsymCreatorReader(ByteOrder, 0x100000000ULL);
+  }
+}
+
+TEST(GSYMTest, TestGsymCreatorFinalize) {
+  GsymCreator GC;
+  const uint32_t Foo = GC.insertString("foo");
+  const uint32_t Bar = GC.insertString("bar");
+  GC.addFunctionInfo(FunctionInfo(0x1000, 0x100, Foo));
+  // A symbol without a size inside foo is dropped.
+  GC.addFunctionInfo(FunctionInfo(0x1010, 0, Bar));
+  // A symbol without a size extends up to the next function.
+  GC.addFunctionInfo(FunctionInfo(0x1100, 0, Bar));
+  GC.addFunctionInfo(FunctionInfo(0x1200, 0x10, Foo));
+  // Overlapping functions are reported.
+  GC.addFunctionInfo(FunctionInfo(0x1208, 0x10, Bar));
+  std::string Log;
+  raw_string_ostream LogStrm(Log);
+  ASSERT_FALSE(bool(GC.finalize(LogStrm)));
+  EXPECT_EQ(LogStrm.str(),
+            "warning: function info ranges overlap: "
+            "[0x0000000000001200 - 0x0000000000001210) and "
+            "[0x0000000000001208 - 0x0000000000001218)\n");
+  EXPECT_EQ(GC.getNumFunctionInfos(), 4u);
+  checkError("already finalized", GC.finalize(LogStrm));
+
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, llvm::support::endian::system_endianness());
+  ASSERT_FALSE(bool(GC.encode(FW)));
+  Expected<GsymReader> GR = GsymReader::copyBuffer(OutStrm.str());
+  ASSERT_TRUE(bool(GR));
+  Expected<FunctionInfo> FI = GR->getFunctionInfo(0x11ff);
+  ASSERT_TRUE(bool(FI));
+  EXPECT_EQ(FI->Range, AddressRange(0x1100, 0x1200));
+  EXPECT_EQ(GR->getString(FI->Name), "bar");
+
+  // Nothing can be encoded without functions.
+  GsymCreator Empty;
+  ASSERT_FALSE(bool(Empty.finalize(LogStrm)));
+  checkError("no functions to encode", Empty.encode(FW));
+}
+
+TEST(GSYMTest, TestGsymReaderErrors) {
+  checkError("not enough data for a GSYM header",
+             GsymReader::copyBuffer("GSYM").takeError());
+  std::string Bytes(sizeof(Header), '\0');
+  checkError("not a GSYM file", GsymReader::copyBuffer(Bytes).takeError());
+
+  // A header without the tables that follow it.
+  Header H;
+  memset(&H, 0, sizeof(H));
+  H.Magic = GSYM_MAGIC;
+  H.Version = GSYM_VERSION;
+  H.AddrOffSize = 4;
+  H.NumAddresses = 1;
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, llvm::support::endian::system_endianness());
+  ASSERT_FALSE(bool(H.encode(FW)));
+  checkError("failed to read address table",
+             GsymReader::copyBuffer(OutStrm.str()).takeError());
+}
+
+TEST(GSYMTest, TestBreakpadTransformer) {
+  const char *Breakpad = R"(MODULE Linux x86_64 000102030405060708090A0B0C0D0E0F0 a.out
+INFO CODE_ID 00010203
+FILE 0 /tmp/main.c
+FILE 1 /tmp/foo.h
+INLINE_ORIGIN 0 foo
+FUNC 1000 50 0 main
+INLINE 0 11 0 0 1010 10
+1000 10 10 0
+1010 10 3 1
+1020 30 12 0
+FUNC m 1050 20 0 baz(int)
+PUBLIC 1070 0 bar
+garbage
+STACK CFI INIT 1000 50 .cfa: $rsp 8 +
+)";
+  GsymCreator GC;
+  std::string Log;
+  raw_string_ostream LogStrm(Log);
+  ASSERT_FALSE(bool(BreakpadTransformer::convert(Breakpad, LogStrm, GC)));
+  EXPECT_EQ(GC.getNumFunctionInfos(), 3u);
+  ASSERT_FALSE(bool(GC.finalize(LogStrm)));
+  EXPECT_EQ(LogStrm.str(), "Loaded 3 functions from Breakpad.\n");
+
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, llvm::support::endian::system_endianness());
+  ASSERT_FALSE(bool(GC.encode(FW)));
+  Expected<GsymReader> GR = GsymReader::copyBuffer(OutStrm.str());
+  ASSERT_TRUE(bool(GR));
+  EXPECT_EQ(GR->getHeader().UUIDSize, 16u);
+  EXPECT_EQ(GR->getHeader().UUID[15], 0x0f);
+
+  Expected<LookupResult> LR = GR->lookup(0x1014);
+  ASSERT_TRUE(bool(LR));
+  ASSERT_EQ(LR->Locations.size(), 2u);
+  EXPECT_EQ(LR->Locations[0].Name, "foo");
+  EXPECT_EQ(LR->getSourceFile(0), "/tmp/foo.h");
+  EXPECT_EQ(LR->Locations[0].Line, 3u);
+  EXPECT_EQ(LR->Locations[1].Name, "main");
+  EXPECT_EQ(LR->getSourceFile(1), "/tmp/main.c");
+  EXPECT_EQ(LR->Locations[1].Line, 11u);
+
+  LR = GR->lookup(0x1060);
+  ASSERT_TRUE(bool(LR));
+  EXPECT_EQ(LR->FuncName, "baz(int)");
+  LR = GR->lookup(0x1070);
+  ASSERT_TRUE(bool(LR));
+  EXPECT_EQ(LR->FuncName, "bar");
+}
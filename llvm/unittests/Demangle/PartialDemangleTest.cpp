@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstdlib>
+#include <string>
 #include "llvm/Demangle/Demangle.h"
 #include "gtest/gtest.h"
 
@@ -191,3 +192,27 @@ TEST(PartialDemanglerTest, TestPrintCases) {
 
   std::free(Buf);
 }
+
+TEST(PartialDemanglerTest, ReuseAcrossNames) {
+  // Enough template arguments to outgrow the demangler's inline buffer, and
+  // an argument list too large for one of its blocks.
+  std::string Big = "_Z1fI";
+  for (int I = 0; I != 2000; ++I)
+    Big += (I % 2) ? "i" : "1aIcE";
+  Big += "Evv";
+  const char *Names[] = {Big.c_str(), "_ZN1a1b1cIiiiEEvm", Big.c_str(),
+                         "_ZNKSt3__16locale9use_facetERNS0_2idE"};
+
+  llvm::ItaniumPartialDemangler D;
+  for (int Round = 0; Round != 3; ++Round) {
+    for (const char *Name : Names) {
+      char *Expected = llvm::itaniumDemangle(Name, nullptr, nullptr, nullptr);
+      ASSERT_NE(nullptr, Expected);
+      EXPECT_FALSE(D.partialDemangle(Name));
+      char *Res = D.finishDemangle(nullptr, nullptr);
+      EXPECT_STREQ(Expected, Res);
+      std::free(Res);
+      std::free(Expected);
+    }
+  }
+}
@@ -0,0 +1,189 @@
+//===---------- ELF_x86_64.cpp - Tests for JITLink ELF/x86-64 -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "JITLinkTestCommon.h"
+
+#include "llvm/ExecutionEngine/JITLink/ELF_x86_64.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+using namespace llvm::jitlink::ELF_x86_64_Edges;
+
+namespace {
+
+class JITLinkTest_ELF_x86_64 : public JITLinkTestCommon,
+                               public testing::Test {
+public:
+  using BasicVerifyGraphFunction =
+      std::function<void(AtomGraph &, const MCDisassembler &)>;
+
+  void runBasicVerifyGraphTest(StringRef AsmSrc, StringRef Triple,
+                               StringMap<JITEvaluatedSymbol> Externals,
+                               bool PIC, bool LargeCodeModel,
+                               MCTargetOptions Options,
+                               BasicVerifyGraphFunction RunGraphTest) {
+    auto TR = getTestResources(AsmSrc, Triple, PIC, LargeCodeModel,
+                               std::move(Options));
+    if (!TR) {
+      dbgs() << "Skipping JITLink unit test: " << toString(TR.takeError())
+             << "\n";
+      return;
+    }
+
+    auto JTCtx = std::make_unique<TestJITLinkContext>(
+        **TR, [&](AtomGraph &G) { RunGraphTest(G, (*TR)->getDisassembler()); });
+
+    JTCtx->externals() = std::move(Externals);
+
+    jitLink_ELF_x86_64(std::move(JTCtx));
+  }
+
+protected:
+  static Edge *findEdge(DefinedAtom &A, Edge::OffsetT Offset) {
+    for (auto &E : A.edges())
+      if (E.isRelocation() && E.getOffset() == Offset)
+        return &E;
+    return nullptr;
+  }
+
+  static void verifyIsPointerTo(AtomGraph &G, DefinedAtom &A, Atom &Target) {
+    // Atoms also have layout and keep-alive edges to their neighbours.
+    size_t NumRelocations = countEdgesMatching(
+        A, [](const Edge &E) { return E.isRelocation(); });
+    EXPECT_EQ(NumRelocations, 1U)
+        << "Incorrect number of relocations for pointer";
+    auto *E = findEdge(A, 0);
+    ASSERT_NE(E, nullptr) << "Missing relocation for pointer";
+    EXPECT_EQ(E->getKind(), Pointer64)
+        << "Expected pointer to have a pointer64 relocation";
+    EXPECT_EQ(&E->getTarget(), &Target) << "Expected edge to point at target";
+    EXPECT_THAT_EXPECTED(readInt<uint64_t>(G, A), HasValue(Target.getAddress()))
+        << "Pointer does not point to target";
+  }
+
+  static void verifyPCRel(AtomGraph &G, DefinedAtom &A, Edge &E,
+                          JITTargetAddress Target) {
+    JITTargetAddress FixupAddress = A.getAddress() + E.getOffset();
+    EXPECT_THAT_EXPECTED(readInt<uint32_t>(G, A, E.getOffset()),
+                         HasValue(static_cast<uint32_t>(
+                             Target - (FixupAddress + 4))))
+        << "PC-relative fixup does not reference expected target";
+  }
+};
+
+} // end anonymous namespace
+
+TEST_F(JITLinkTest_ELF_x86_64, BasicRelocations) {
+  runBasicVerifyGraphTest(
+      R"(
+            .text
+            .globl  bar
+            .p2align        4, 0x90
+            .type   bar,@function
+    bar:
+            callq   baz@PLT
+
+            .globl  foo
+            .p2align        4, 0x90
+            .type   foo,@function
+    foo:
+            callq   bar@PLT
+            movq    y@GOTPCREL(%rip), %rcx
+            movq    x@GOTPCREL(%rip), %rdx
+            movq    p(%rip), %rsi
+
+            .data
+            .globl  x
+            .p2align        2
+    x:
+            .long   42
+
+            .globl  p
+            .p2align        3
+    p:
+            .quad   x)",
+      "x86_64-unknown-linux",
+      {{"y", JITEvaluatedSymbol(0xdeadbeef, JITSymbolFlags::Exported)},
+       {"baz", JITEvaluatedSymbol(0xcafef00d, JITSymbolFlags::Exported)}},
+      true, false, MCTargetOptions(),
+      [](AtomGraph &G, const MCDisassembler &Dis) {
+        // Name the atoms in the asm above.
+        auto &Baz = atom(G, "baz");
+        auto &Y = atom(G, "y");
+
+        auto &Bar = definedAtom(G, "bar");
+        auto &Foo = definedAtom(G, "foo");
+        auto &X = definedAtom(G, "x");
+        auto &P = definedAtom(G, "p");
+
+        // Check the pointer to x in p.
+        verifyIsPointerTo(G, P, X);
+
+        // Check that bar calls baz via a stub, whose GOT entry points to baz.
+        {
+          auto *E = findEdge(Bar, 1);
+          ASSERT_NE(E, nullptr) << "Missing edge for call in bar";
+          EXPECT_EQ(E->getKind(), Branch32);
+          ASSERT_TRUE(E->getTarget().isDefined()) << "Call is not via a stub";
+          auto &Stub = static_cast<DefinedAtom &>(E->getTarget());
+          verifyPCRel(G, Bar, *E, Stub.getAddress());
+
+          EXPECT_EQ(Stub.edges_size(), 1U) << "Expected one edge in the stub";
+          auto &StubEdge = *Stub.edges().begin();
+          EXPECT_EQ(StubEdge.getKind(), PCRel32);
+          ASSERT_TRUE(StubEdge.getTarget().isDefined());
+          auto &GOTEntry = static_cast<DefinedAtom &>(StubEdge.getTarget());
+          verifyIsPointerTo(G, GOTEntry, Baz);
+          verifyPCRel(G, Stub, StubEdge, GOTEntry.getAddress());
+        }
+
+        // Check that foo calls bar directly.
+        {
+          auto *E = findEdge(Foo, 1);
+          ASSERT_NE(E, nullptr) << "Missing edge for call in foo";
+          EXPECT_EQ(E->getKind(), Branch32);
+          EXPECT_EQ(&E->getTarget(), &Bar);
+          EXPECT_THAT_EXPECTED(decodeImmediateOperand(Dis, Foo, 0, 0),
+                               HasValue(Bar.getAddress() -
+                                        (Foo.getAddress() + 5)));
+        }
+
+        // Check that the load of y goes through the GOT.
+        {
+          auto *E = findEdge(Foo, 8);
+          ASSERT_NE(E, nullptr) << "Missing edge for GOT load of y";
+          EXPECT_EQ(E->getKind(), PCRel32);
+          ASSERT_TRUE(E->getTarget().isDefined());
+          auto &GOTEntry = static_cast<DefinedAtom &>(E->getTarget());
+          verifyIsPointerTo(G, GOTEntry, Y);
+          verifyPCRel(G, Foo, *E, GOTEntry.getAddress());
+        }
+
+        // Check that the load of x was relaxed into a lea of x.
+        {
+          auto *E = findEdge(Foo, 15);
+          ASSERT_NE(E, nullptr) << "Missing edge for GOT load of x";
+          EXPECT_EQ(E->getKind(), PCRel32GOTLoadRelaxed);
+          EXPECT_EQ(&E->getTarget(), &X);
+          EXPECT_THAT_EXPECTED(readInt<uint8_t>(G, Foo, 13), HasValue(0x8d))
+              << "GOT load was not turned into a lea";
+          verifyPCRel(G, Foo, *E, X.getAddress());
+        }
+
+        // Check the PC-relative load of p.
+        {
+          auto *E = findEdge(Foo, 22);
+          ASSERT_NE(E, nullptr) << "Missing edge for load of p";
+          EXPECT_EQ(E->getKind(), PCRel32);
+          verifyPCRel(G, Foo, *E, P.getAddress());
+        }
+      });
+}
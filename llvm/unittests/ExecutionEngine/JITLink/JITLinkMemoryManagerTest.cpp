@@ -0,0 +1,92 @@
+//===------ JITLinkMemoryManagerTest.cpp - Tests for JIT memory managers --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/JITLink/JITLinkMemoryManager.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::jitlink;
+
+namespace {
+
+const sys::Memory::ProtectionFlags ReadExec =
+    static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
+                                              sys::Memory::MF_EXEC);
+const sys::Memory::ProtectionFlags ReadWrite =
+    static_cast<sys::Memory::ProtectionFlags>(sys::Memory::MF_READ |
+                                              sys::Memory::MF_WRITE);
+
+std::unique_ptr<JITLinkMemoryManager::Allocation>
+allocateCodeAndData(JITLinkMemoryManager &MemMgr) {
+  JITLinkMemoryManager::SegmentsRequestMap Request;
+  Request[ReadExec] = JITLinkMemoryManager::SegmentRequest(16, 16, 0, 1);
+  Request[ReadWrite] = JITLinkMemoryManager::SegmentRequest(8, 8, 8, 8);
+  auto Alloc = MemMgr.allocate(Request);
+  EXPECT_THAT_EXPECTED(Alloc, Succeeded());
+  return Alloc ? std::move(*Alloc) : nullptr;
+}
+
+void finalize(JITLinkMemoryManager::Allocation &Alloc) {
+  Alloc.finalizeAsync(
+      [](Error Err) { EXPECT_THAT_ERROR(std::move(Err), Succeeded()); });
+}
+
+} // end anonymous namespace
+
+TEST(SlabMemoryManagerTest, PacksAndReusesSegments) {
+  SlabMemoryManager MemMgr(1024 * 1024);
+  uint64_t PageSize = sys::Process::getPageSizeEstimate();
+
+  auto A = allocateCodeAndData(MemMgr);
+  auto B = allocateCodeAndData(MemMgr);
+  ASSERT_TRUE(A && B);
+
+  // Code segments are adjacent to each other rather than to data.
+  EXPECT_EQ(B->getTargetMemory(ReadExec),
+            A->getTargetMemory(ReadExec) + PageSize);
+  EXPECT_EQ(B->getTargetMemory(ReadWrite),
+            A->getTargetMemory(ReadWrite) + PageSize);
+
+  // Zero-fill memory is zeroed.
+  auto Data = A->getWorkingMemory(ReadWrite);
+  EXPECT_EQ(Data.size(), PageSize);
+  EXPECT_EQ(*reinterpret_cast<uint64_t *>(Data.data() + 8), 0U);
+  *reinterpret_cast<uint64_t *>(Data.data() + 8) = 42;
+
+  finalize(*A);
+  finalize(*B);
+
+  // Memory freed by a deallocation is reused, and zero-fill is zeroed again.
+  JITTargetAddress ACode = A->getTargetMemory(ReadExec);
+  EXPECT_THAT_ERROR(A->deallocate(), Succeeded());
+  auto C = allocateCodeAndData(MemMgr);
+  ASSERT_TRUE(C);
+  EXPECT_EQ(C->getTargetMemory(ReadExec), ACode);
+  EXPECT_EQ(*reinterpret_cast<uint64_t *>(
+                C->getWorkingMemory(ReadWrite).data() + 8),
+            0U);
+
+  EXPECT_THAT_ERROR(B->deallocate(), Succeeded());
+  EXPECT_THAT_ERROR(C->deallocate(), Succeeded());
+}
+
+TEST(SlabMemoryManagerTest, LargeSegment) {
+  // Segments larger than the slab size get a slab of their own.
+  uint64_t PageSize = sys::Process::getPageSizeEstimate();
+  SlabMemoryManager MemMgr(PageSize);
+  JITLinkMemoryManager::SegmentsRequestMap Request;
+  Request[ReadWrite] =
+      JITLinkMemoryManager::SegmentRequest(4 * PageSize, 8, 0, 1);
+  auto Alloc = MemMgr.allocate(Request);
+  ASSERT_THAT_EXPECTED(Alloc, Succeeded());
+  EXPECT_EQ((*Alloc)->getWorkingMemory(ReadWrite).size(), 4 * PageSize);
+  EXPECT_THAT_ERROR((*Alloc)->deallocate(), Succeeded());
+}
@@ -0,0 +1,87 @@
+//===- PersistentObjectCacheTest.cpp - Tests for PersistentObjectCache ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+class PersistentObjectCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("orc-object-cache", CacheDir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(CacheDir); }
+
+  std::unique_ptr<PersistentObjectCache>
+  makeCache(StringRef TT = "x86_64-unknown-linux-gnu") {
+    auto Cache = PersistentObjectCache::Create(
+        CacheDir, JITTargetMachineBuilder(Triple(TT)));
+    EXPECT_THAT_EXPECTED(Cache, Succeeded());
+    return Cache ? std::move(*Cache) : nullptr;
+  }
+
+  std::unique_ptr<Module> makeModule(StringRef FunctionName) {
+    auto M = std::make_unique<Module>("M", Ctx);
+    Function::Create(FunctionType::get(Type::getVoidTy(Ctx), false),
+                     GlobalValue::ExternalLinkage, FunctionName, *M);
+    return M;
+  }
+
+  SmallString<128> CacheDir;
+  LLVMContext Ctx;
+};
+
+TEST_F(PersistentObjectCacheTest, RoundTrip) {
+  auto M = makeModule("foo");
+  {
+    auto Cache = makeCache();
+    ASSERT_NE(Cache, nullptr);
+    EXPECT_EQ(Cache->getObject(M.get()), nullptr);
+    Cache->notifyObjectCompiled(M.get(),
+                                MemoryBufferRef("object", "<object>"));
+  }
+
+  // A new cache for the same directory, e.g. in a later JIT session, finds
+  // the object.
+  auto Cache = makeCache();
+  ASSERT_NE(Cache, nullptr);
+  auto Obj = Cache->getObject(M.get());
+  ASSERT_NE(Obj, nullptr);
+  EXPECT_EQ(Obj->getBuffer(), "object");
+
+  // Different IR or a different target miss.
+  auto M2 = makeModule("bar");
+  EXPECT_EQ(Cache->getObject(M2.get()), nullptr);
+  auto ARMCache = makeCache("armv7-unknown-linux-gnueabihf");
+  ASSERT_NE(ARMCache, nullptr);
+  EXPECT_EQ(ARMCache->getObject(M.get()), nullptr);
+}
+
+TEST_F(PersistentObjectCacheTest, OnlyStoresMisses) {
+  auto Cache = makeCache();
+  ASSERT_NE(Cache, nullptr);
+  auto M = makeModule("foo");
+
+  // Objects for modules that were not looked up are not stored, since their
+  // key is not known.
+  Cache->notifyObjectCompiled(M.get(), MemoryBufferRef("object", "<object>"));
+  EXPECT_EQ(Cache->getObject(M.get()), nullptr);
+}
+
+} // end anonymous namespace
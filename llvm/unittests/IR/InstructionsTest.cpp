@@ -1112,5 +1112,48 @@ if.end:
   EXPECT_EQ(ArgBA->getBasicBlock(), &IfThen);
 }
 
+TEST(InstructionsTest, LoadStoreAtomicFields) {
+  LLVMContext C;
+  std::unique_ptr<Module> M = parseIR(C, R"(
+define void @foo(i32* %p) {
+  %v = load atomic volatile i32, i32* %p syncscope("agent") acquire, align 16
+  store atomic volatile i32 %v, i32* %p syncscope("agent") release, align 8
+  ret void
+}
+)");
+  ASSERT_TRUE(M);
+  SyncScope::ID Agent = C.getOrInsertSyncScopeID("agent");
+  BasicBlock &BB = M->getFunction("foo")->front();
+  auto *LI = cast<LoadInst>(&BB.front());
+  auto *SI = cast<StoreInst>(LI->getNextNode());
+
+  // The ordering, synchronization scope, alignment and volatility share the
+  // subclass data, so check that they round-trip independently.
+  EXPECT_TRUE(LI->isVolatile());
+  EXPECT_EQ(16u, LI->getAlignment());
+  EXPECT_EQ(AtomicOrdering::Acquire, LI->getOrdering());
+  EXPECT_EQ(Agent, LI->getSyncScopeID());
+  EXPECT_TRUE(SI->isVolatile());
+  EXPECT_EQ(8u, SI->getAlignment());
+  EXPECT_EQ(AtomicOrdering::Release, SI->getOrdering());
+  EXPECT_EQ(Agent, SI->getSyncScopeID());
+
+  SyncScope::ID Last = SyncScope::MaxNumScopes - 1;
+  for (unsigned I = C.getOrInsertSyncScopeID("agent") + 1; I <= Last; ++I)
+    C.getOrInsertSyncScopeID(("scope" + Twine(I)).str());
+  LI->setSyncScopeID(Last);
+  LI->setAlignment(1);
+  EXPECT_EQ(Last, LI->getSyncScopeID());
+  EXPECT_EQ(1u, LI->getAlignment());
+  EXPECT_EQ(AtomicOrdering::Acquire, LI->getOrdering());
+  EXPECT_TRUE(LI->isVolatile());
+  SI->setOrdering(AtomicOrdering::SequentiallyConsistent);
+  SI->setVolatile(false);
+  EXPECT_EQ(AtomicOrdering::SequentiallyConsistent, SI->getOrdering());
+  EXPECT_EQ(Agent, SI->getSyncScopeID());
+  EXPECT_EQ(8u, SI->getAlignment());
+  EXPECT_FALSE(SI->isVolatile());
+}
+
 } // end anonymous namespace
 } // end namespace llvm
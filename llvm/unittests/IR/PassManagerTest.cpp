@@ -9,8 +9,10 @@
 #include "llvm/IR/PassManager.h"
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
 
@@ -780,4 +782,82 @@ TEST_F(PassManagerTest, IndirectAnalysisInvalidation) {
   // three functions.
   EXPECT_EQ(3 * 4 * 3, FunctionCount);
 }
+
+// An analysis that only depends on the CFG, like the dominator tree.
+struct TestCFGAnalysis : public AnalysisInfoMixin<TestCFGAnalysis> {
+  struct Result {
+    bool invalidate(Function &, const PreservedAnalyses &PA,
+                    FunctionAnalysisManager::Invalidator &) {
+      auto PAC = PA.getChecker<TestCFGAnalysis>();
+      return !PAC.preserved() && !PAC.preservedSet<AllAnalysesOn<Function>>() &&
+             !PAC.preservedSet<CFGAnalyses>();
+    }
+  };
+
+  TestCFGAnalysis(int &Runs) : Runs(Runs) {}
+
+  Result run(Function &, FunctionAnalysisManager &) {
+    ++Runs;
+    return Result();
+  }
+
+private:
+  friend AnalysisInfoMixin<TestCFGAnalysis>;
+  static AnalysisKey Key;
+
+  int &Runs;
+};
+
+AnalysisKey TestCFGAnalysis::Key;
+
+TEST_F(PassManagerTest, PreserveUnchangedCFGAnalyses) {
+  auto *Opt = static_cast<cl::opt<bool> *>(
+      cl::getRegisteredOptions()["preserve-unchanged-cfg-analyses"]);
+  ASSERT_NE(Opt, nullptr);
+  *Opt = true;
+
+  FunctionAnalysisManager FAM;
+  int CFGAnalysisRuns = 0;
+  FAM.registerPass([&] { return TestCFGAnalysis(CFGAnalysisRuns); });
+  FAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+
+  // Uses the analysis and preserves nothing, although it changes nothing.
+  auto UseAnalysis = [](Function &F, FunctionAnalysisManager &AM) {
+    AM.getResult<TestCFGAnalysis>(F);
+    return PreservedAnalyses::none();
+  };
+  FunctionPassManager FPM;
+  FPM.addPass(LambdaPass(UseAnalysis));
+  FPM.addPass(LambdaPass(UseAnalysis));
+  // Changes an instruction, but not the CFG.
+  FPM.addPass(LambdaPass([](Function &F, FunctionAnalysisManager &) {
+    F.getEntryBlock().front().eraseFromParent();
+    return PreservedAnalyses::none();
+  }));
+  FPM.addPass(LambdaPass(UseAnalysis));
+  // Changes the CFG.
+  FPM.addPass(LambdaPass([](Function &F, FunctionAnalysisManager &) {
+    BasicBlock &Entry = F.getEntryBlock();
+    Entry.splitBasicBlock(Entry.getTerminator());
+    return PreservedAnalyses::none();
+  }));
+  FPM.addPass(LambdaPass(UseAnalysis));
+  // Replaces a block with a new one, which may be allocated at the same
+  // address.
+  FPM.addPass(LambdaPass([](Function &F, FunctionAnalysisManager &) {
+    BasicBlock &Entry = F.getEntryBlock();
+    BasicBlock *Exit = Entry.getSingleSuccessor();
+    Entry.getTerminator()->eraseFromParent();
+    Exit->eraseFromParent();
+    BasicBlock *NewExit = BasicBlock::Create(F.getContext(), "exit", &F);
+    ReturnInst::Create(F.getContext(), NewExit);
+    BranchInst::Create(NewExit, &Entry);
+    return PreservedAnalyses::none();
+  }));
+  FPM.addPass(LambdaPass(UseAnalysis));
+  FPM.run(*M->getFunction("f"), FAM);
+  *Opt = false;
+
+  EXPECT_EQ(3, CFGAnalysisRuns);
+}
 }
@@ -359,4 +359,37 @@ TEST_F(LinkModuleTest, RemangleIntrinsics) {
   ASSERT_EQ(F->getNumUses(), (unsigned)2);
 }
 
+TEST_F(LinkModuleTest, AppendingVarsManyModules) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  auto Dst = std::make_unique<Module>("Linked", C);
+  Linker L(*Dst);
+
+  // Each linked module grows @llvm.global_ctors, which replaces the previous
+  // variable. Check that the constant users left behind by the replacements
+  // don't accumulate, as every later replacement would have to visit them.
+  auto LinkCtor = [&](unsigned I) {
+    std::string Str =
+        "@llvm.global_ctors = appending global [1 x { i32, void ()*, i8* }] "
+        "[{ i32, void ()*, i8* } { i32 65535, void ()* @ctor" +
+        std::to_string(I) +
+        ", i8* null }]\n"
+        "define internal void @ctor" +
+        std::to_string(I) + "() {\n  ret void\n}\n";
+    std::unique_ptr<Module> M = parseAssemblyString(Str, Err, C);
+    ASSERT_TRUE(M.get());
+    ASSERT_FALSE(L.linkInModule(std::move(M)));
+  };
+
+  for (unsigned I = 0; I < 4; ++I)
+    LinkCtor(I);
+  unsigned NumUses = Dst->getNamedGlobal("llvm.global_ctors")->getNumUses();
+  for (unsigned I = 4; I < 16; ++I)
+    LinkCtor(I);
+
+  GlobalVariable *Ctors = Dst->getNamedGlobal("llvm.global_ctors");
+  EXPECT_EQ(16u, cast<ArrayType>(Ctors->getValueType())->getNumElements());
+  EXPECT_EQ(NumUses, Ctors->getNumUses());
+}
+
 } // end anonymous namespace
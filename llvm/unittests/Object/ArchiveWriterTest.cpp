@@ -0,0 +1,83 @@
+//===- ArchiveWriterTest.cpp - Tests for ArchiveWriter.cpp ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Object/ArchiveWriter.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/ObjectYAML/yaml2obj.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace object;
+
+namespace {
+
+// An object file whose only symbol has a name beyond the end of the string
+// table.
+const char *const MalformedObjectYAML = R"(
+--- !ELF
+FileHeader:
+  Class:   ELFCLASS64
+  Data:    ELFDATA2LSB
+  Type:    ET_REL
+  Machine: EM_X86_64
+Sections:
+  - Name: .text
+    Type: SHT_PROGBITS
+    Flags: [ SHF_ALLOC, SHF_EXECINSTR ]
+Symbols:
+  - NameIndex: 0x1000
+    Section:   .text
+    Binding:   STB_GLOBAL
+)";
+
+const char *const ObjectYAML = R"(
+--- !ELF
+FileHeader:
+  Class:   ELFCLASS64
+  Data:    ELFDATA2LSB
+  Type:    ET_REL
+  Machine: EM_X86_64
+Sections:
+  - Name: .text
+    Type: SHT_PROGBITS
+    Flags: [ SHF_ALLOC, SHF_EXECINSTR ]
+Symbols:
+  - Name:    foo
+    Section: .text
+    Binding: STB_GLOBAL
+)";
+
+TEST(ArchiveWriter, UnreadableSymbolTable) {
+  SmallString<0> Good, Bad;
+  ASSERT_THAT_EXPECTED(yaml::yaml2ObjectFile(Good, ObjectYAML), Succeeded());
+  ASSERT_THAT_EXPECTED(yaml::yaml2ObjectFile(Bad, MalformedObjectYAML),
+                       Succeeded());
+
+  // Several members, so that the symbol tables are read in parallel, of which
+  // more than one fails.
+  std::vector<NewArchiveMember> Members;
+  for (int I = 0; I != 8; ++I) {
+    StringRef Contents = I % 3 == 1 ? Bad.str() : Good.str();
+    Members.emplace_back(MemoryBufferRef(Contents, "member.o"));
+  }
+
+  SmallString<128> Path;
+  ASSERT_FALSE(
+      sys::fs::createTemporaryFile("ArchiveWriterTest", "a", Path));
+  EXPECT_THAT_ERROR(writeArchive(Path, Members, /*WriteSymtab=*/true,
+                                 Archive::K_GNU, /*Deterministic=*/true,
+                                 /*Thin=*/false),
+                    Failed());
+  sys::fs::remove(Path);
+}
+
+} // namespace
@@ -315,6 +315,35 @@ TEST_F(SampleProfTest, remap_ext_binary_profile) {
   testRoundTrip(SampleProfileFormat::SPF_Ext_Binary, true);
 }
 
+TEST_F(SampleProfTest, ext_binary_reads_funcs_to_use) {
+  SmallVector<char, 128> ProfilePath;
+  ASSERT_TRUE(NoError(
+      llvm::sys::fs::createTemporaryFile("profile", "", ProfilePath)));
+  StringRef Profile(ProfilePath.data(), ProfilePath.size());
+  createWriter(SampleProfileFormat::SPF_Ext_Binary, Profile);
+
+  StringMap<FunctionSamples> Profiles;
+  addFunctionSamples(&Profiles, "foo", uint64_t(20301), uint64_t(1437));
+  addFunctionSamples(&Profiles, "bar", uint64_t(30301), uint64_t(2437));
+  addFunctionSamples(&Profiles, "baz", uint64_t(40301), uint64_t(3437));
+  ASSERT_TRUE(NoError(Writer->write(Profiles)));
+  Writer->getOutputStream().flush();
+
+  // Only the profile of the function in the module is read.
+  Module M("my_module", Context);
+  FunctionType *FnType =
+      FunctionType::get(Type::getVoidTy(Context), {}, false);
+  M.getOrInsertFunction("bar", FnType);
+  readProfile(M, Profile);
+  ASSERT_TRUE(NoError(Reader->read()));
+
+  ASSERT_EQ(1u, Reader->getProfiles().size());
+  FunctionSamples *Samples = Reader->getSamplesFor("bar");
+  ASSERT_TRUE(Samples != nullptr);
+  ASSERT_EQ(30301u, Samples->getTotalSamples());
+  ASSERT_EQ(2437u, Samples->getHeadSamples());
+}
+
 TEST_F(SampleProfTest, sample_overflow_saturation) {
   const uint64_t Max = std::numeric_limits<uint64_t>::max();
   sampleprof_error Result;
@@ -0,0 +1,200 @@
+//===- unittest/Support/BitstreamRemarksParsingTest.cpp -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm-c/Remarks.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkParser.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+static remarks::Remark makeRemark() {
+  remarks::Remark R;
+  R.RemarkType = remarks::Type::Missed;
+  R.PassName = "pass";
+  R.RemarkName = "remark";
+  R.FunctionName = "function";
+  R.Loc.emplace();
+  R.Loc->SourceFilePath = "path";
+  R.Loc->SourceLine = 99;
+  R.Loc->SourceColumn = 55;
+  R.Hotness.emplace(999999999);
+  R.Args.emplace_back();
+  R.Args.back().Key = "key";
+  R.Args.back().Val = "value";
+  R.Args.back().Loc.emplace();
+  R.Args.back().Loc->SourceFilePath = "argpath";
+  R.Args.back().Loc->SourceLine = 11;
+  R.Args.back().Loc->SourceColumn = 66;
+  R.Args.emplace_back();
+  R.Args.back().Key = "key2";
+  R.Args.back().Val = "value2";
+  return R;
+}
+
+static std::string serializeStandalone(ArrayRef<const remarks::Remark *> Rs) {
+  // The string table is emitted before the remarks in standalone mode, so it
+  // has to be filled in first.
+  remarks::StringTable StrTab;
+  for (const remarks::Remark *R : Rs) {
+    remarks::Remark Copy = R->clone();
+    StrTab.internalize(Copy);
+  }
+
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  Expected<std::unique_ptr<remarks::RemarkSerializer>> MaybeSerializer =
+      remarks::createRemarkSerializer(remarks::Format::Bitstream,
+                                      remarks::SerializerMode::Standalone, OS,
+                                      std::move(StrTab));
+  EXPECT_FALSE(errorToBool(MaybeSerializer.takeError()));
+  for (const remarks::Remark *R : Rs)
+    (*MaybeSerializer)->emit(*R);
+  return OS.str();
+}
+
+TEST(BitstreamRemarks, ParsingStandalone) {
+  remarks::Remark R1 = makeRemark();
+  remarks::Remark R2;
+  R2.RemarkType = remarks::Type::Passed;
+  R2.PassName = "inline";
+  R2.RemarkName = "Inlined";
+  R2.FunctionName = "foo";
+  std::string Buf = serializeStandalone({&R1, &R2});
+
+  Expected<std::unique_ptr<remarks::RemarkParser>> MaybeParser =
+      remarks::createRemarkParser(remarks::Format::Bitstream, Buf);
+  EXPECT_FALSE(errorToBool(MaybeParser.takeError()));
+  remarks::RemarkParser &Parser = **MaybeParser;
+
+  Expected<std::unique_ptr<remarks::Remark>> MaybeRemark = Parser.next();
+  EXPECT_FALSE(errorToBool(MaybeRemark.takeError()));
+  EXPECT_EQ(**MaybeRemark, R1);
+
+  MaybeRemark = Parser.next();
+  EXPECT_FALSE(errorToBool(MaybeRemark.takeError()));
+  EXPECT_EQ(**MaybeRemark, R2);
+  EXPECT_FALSE((*MaybeRemark)->Loc);
+  EXPECT_FALSE((*MaybeRemark)->Hotness);
+
+  MaybeRemark = Parser.next();
+  Error E = MaybeRemark.takeError();
+  EXPECT_TRUE(E.isA<remarks::EndOfFileError>());
+  consumeError(std::move(E));
+}
+
+TEST(BitstreamRemarks, ParsingFromMeta) {
+  remarks::Remark R = makeRemark();
+  std::string Buf = serializeStandalone({&R});
+
+  // A standalone container is its own metadata.
+  Expected<std::unique_ptr<remarks::RemarkParser>> MaybeParser =
+      remarks::createRemarkParserFromMeta(remarks::Format::Bitstream, Buf);
+  EXPECT_FALSE(errorToBool(MaybeParser.takeError()));
+  Expected<std::unique_ptr<remarks::Remark>> MaybeRemark =
+      (*MaybeParser)->next();
+  EXPECT_FALSE(errorToBool(MaybeRemark.takeError()));
+  EXPECT_EQ(**MaybeRemark, R);
+}
+
+TEST(BitstreamRemarks, ParsingSeparateWithStrTab) {
+  remarks::Remark R = makeRemark();
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  Expected<std::unique_ptr<remarks::RemarkSerializer>> MaybeSerializer =
+      remarks::createRemarkSerializer(remarks::Format::Bitstream,
+                                      remarks::SerializerMode::Separate, OS);
+  EXPECT_FALSE(errorToBool(MaybeSerializer.takeError()));
+  remarks::RemarkSerializer &Serializer = **MaybeSerializer;
+  Serializer.emit(R);
+
+  // The remark file doesn't contain the strings: they live in the metadata.
+  Expected<std::unique_ptr<remarks::RemarkParser>> MaybeParser =
+      remarks::createRemarkParser(remarks::Format::Bitstream, OS.str());
+  EXPECT_FALSE(errorToBool(MaybeParser.takeError()));
+  Expected<std::unique_ptr<remarks::Remark>> MaybeRemark =
+      (*MaybeParser)->next();
+  EXPECT_TRUE(errorToBool(MaybeRemark.takeError()));
+
+  std::string StrTabBuf;
+  raw_string_ostream StrTabOS(StrTabBuf);
+  Serializer.StrTab->serialize(StrTabOS);
+  MaybeParser = remarks::createRemarkParser(
+      remarks::Format::Bitstream, OS.str(),
+      remarks::ParsedStringTable(StrTabOS.str()));
+  EXPECT_FALSE(errorToBool(MaybeParser.takeError()));
+  MaybeRemark = (*MaybeParser)->next();
+  EXPECT_FALSE(errorToBool(MaybeRemark.takeError()));
+  EXPECT_EQ(**MaybeRemark, R);
+}
+
+TEST(BitstreamRemarks, ParsingSeparateFinalized) {
+  remarks::Remark R1 = makeRemark();
+  remarks::Remark R2 = makeRemark();
+  R2.FunctionName = "function2";
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  Expected<std::unique_ptr<remarks::RemarkSerializer>> MaybeSerializer =
+      remarks::createRemarkSerializer(remarks::Format::Bitstream,
+                                      remarks::SerializerMode::Separate, OS);
+  EXPECT_FALSE(errorToBool(MaybeSerializer.takeError()));
+  (*MaybeSerializer)->emit(R1);
+  (*MaybeSerializer)->emit(R2);
+  // The string table follows the remarks once the serializer is finalized.
+  (*MaybeSerializer)->finalize();
+
+  Expected<std::unique_ptr<remarks::RemarkParser>> MaybeParser =
+      remarks::createRemarkParser(remarks::Format::Bitstream, OS.str());
+  EXPECT_FALSE(errorToBool(MaybeParser.takeError()));
+  remarks::RemarkParser &Parser = **MaybeParser;
+  Expected<std::unique_ptr<remarks::Remark>> MaybeRemark = Parser.next();
+  EXPECT_FALSE(errorToBool(MaybeRemark.takeError()));
+  EXPECT_EQ(**MaybeRemark, R1);
+  MaybeRemark = Parser.next();
+  EXPECT_FALSE(errorToBool(MaybeRemark.takeError()));
+  EXPECT_EQ(**MaybeRemark, R2);
+  MaybeRemark = Parser.next();
+  Error E = MaybeRemark.takeError();
+  EXPECT_TRUE(E.isA<remarks::EndOfFileError>());
+  consumeError(std::move(E));
+}
+
+TEST(BitstreamRemarks, ParsingBadMagic) {
+  Expected<std::unique_ptr<remarks::RemarkParser>> MaybeParser =
+      remarks::createRemarkParser(remarks::Format::Bitstream, "RMRX1234");
+  EXPECT_FALSE(errorToBool(MaybeParser.takeError()));
+  Expected<std::unique_ptr<remarks::Remark>> MaybeRemark =
+      (*MaybeParser)->next();
+  Error E = MaybeRemark.takeError();
+  EXPECT_FALSE(E.isA<remarks::EndOfFileError>());
+  EXPECT_TRUE(errorToBool(std::move(E)));
+}
+
+TEST(BitstreamRemarks, ParsingCAPI) {
+  remarks::Remark R = makeRemark();
+  std::string Buf = serializeStandalone({&R});
+
+  LLVMRemarkParserRef Parser =
+      LLVMRemarkParserCreateBitstream(Buf.data(), Buf.size());
+  LLVMRemarkEntryRef Remark = LLVMRemarkParserGetNext(Parser);
+  EXPECT_FALSE(Remark == nullptr);
+  EXPECT_EQ(LLVMRemarkEntryGetType(Remark), LLVMRemarkTypeMissed);
+  LLVMRemarkStringRef PassName = LLVMRemarkEntryGetPassName(Remark);
+  EXPECT_EQ(StringRef(LLVMRemarkStringGetData(PassName),
+                      LLVMRemarkStringGetLen(PassName)),
+            "pass");
+  EXPECT_EQ(LLVMRemarkEntryGetHotness(Remark), 999999999U);
+  EXPECT_EQ(LLVMRemarkEntryGetNumArgs(Remark), 2U);
+  LLVMRemarkEntryDispose(Remark);
+
+  EXPECT_TRUE(LLVMRemarkParserGetNext(Parser) == nullptr);
+  EXPECT_FALSE(LLVMRemarkParserHasError(Parser));
+  LLVMRemarkParserDispose(Parser);
+}
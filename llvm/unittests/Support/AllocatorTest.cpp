@@ -7,8 +7,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/ThreadSafeAllocator.h"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <thread>
+#include <vector>
 
 using namespace llvm;
 
@@ -184,4 +189,56 @@ TEST(AllocatorTest, TestBigAlignment) {
   EXPECT_GT(MockSlabAllocator::GetLastSlabSize(), 4096u);
 }
 
+TEST(AllocatorTest, ThreadSafeBasics) {
+  ThreadSafeBumpPtrAllocator Alloc;
+  int *a = Alloc.Allocate<int>();
+  int *b = Alloc.Allocate<int>(10);
+  *a = 1;
+  b[9] = 2;
+  EXPECT_EQ(1, *a);
+  EXPECT_EQ(2, b[9]);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(Alloc.Allocate(8, 64)) & 63);
+  EXPECT_LE(sizeof(int) * 11 + 8, Alloc.getBytesAllocated());
+
+  ConcurrentStringSaver Saver(Alloc);
+  StringRef S = Saver.save(Twine("foo") + "bar");
+  EXPECT_EQ("foobar", S);
+  EXPECT_EQ('\0', *S.end());
+
+  Alloc.Reset();
+  EXPECT_EQ(0U, Alloc.getBytesAllocated());
+}
+
+#if LLVM_ENABLE_THREADS
+// Allocate from several threads at once and check that no two threads were
+// handed the same memory.
+TEST(AllocatorTest, ThreadSafeConcurrentAllocation) {
+  ThreadSafeBumpPtrAllocator Alloc;
+  ConcurrentStringSaver Saver(Alloc);
+  const unsigned NumThreads = 4, NumAllocs = 10000;
+  std::vector<std::vector<unsigned *>> Ptrs(NumThreads);
+  std::vector<StringRef> Strings(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      for (unsigned I = 0; I != NumAllocs; ++I) {
+        unsigned *P = Alloc.Allocate<unsigned>(1 + I % 7);
+        *P = T * NumAllocs + I;
+        Ptrs[T].push_back(P);
+      }
+      Strings[T] = Saver.save(Twine(T));
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (unsigned T = 0; T != NumThreads; ++T) {
+    EXPECT_EQ(std::to_string(T), Strings[T]);
+    for (unsigned I = 0; I != NumAllocs; ++I)
+      EXPECT_EQ(T * NumAllocs + I, *Ptrs[T][I]);
+  }
+  EXPECT_LE(NumThreads * NumAllocs * sizeof(unsigned),
+            Alloc.getBytesAllocated());
+}
+#endif
+
 }  // anonymous namespace
@@ -0,0 +1,52 @@
+//===- llvm/unittest/Support/AsyncFileReaderTest.cpp ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/AsyncFileReader.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(AsyncFileReaderTest, Read) {
+  // Write a few files, large enough to be memory-mapped.
+  std::vector<SmallString<64>> Paths(4);
+  for (unsigned I = 0; I < Paths.size(); ++I) {
+    int FD;
+    ASSERT_FALSE(
+        sys::fs::createTemporaryFile("AsyncFileReaderTest", "", FD, Paths[I]));
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    for (unsigned J = 0; J < 64 * 1024; ++J)
+      OS << char('a' + I);
+  }
+
+  AsyncFileReader Reader(2);
+  std::vector<std::future<AsyncFileReader::ResultTy>> Futures;
+  for (const SmallString<64> &Path : Paths)
+    Futures.push_back(Reader.read(Path));
+  Futures.push_back(Reader.read(Paths[0] + ".missing"));
+
+  for (unsigned I = 0; I < Paths.size(); ++I) {
+    AsyncFileReader::ResultTy MB = Futures[I].get();
+    ASSERT_TRUE(bool(MB));
+    EXPECT_EQ(64u * 1024, (*MB)->getBufferSize());
+    EXPECT_EQ(std::string(64 * 1024, char('a' + I)), (*MB)->getBuffer());
+    EXPECT_EQ(Paths[I], (*MB)->getBufferIdentifier());
+  }
+  AsyncFileReader::ResultTy Missing = Futures.back().get();
+  EXPECT_EQ(std::errc::no_such_file_or_directory, Missing.getError());
+
+  for (const SmallString<64> &Path : Paths)
+    ASSERT_FALSE(sys::fs::remove(Path));
+}
+
+} // end anonymous namespace
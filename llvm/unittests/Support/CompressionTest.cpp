@@ -15,6 +15,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/config.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -73,4 +74,96 @@ TEST(CompressionTest, ZlibCRC32) {
 
 #endif
 
+
+void TestZstdCompression(StringRef Input, int Level, unsigned Threads = 1) {
+  SmallString<32> Compressed;
+  SmallString<32> Uncompressed;
+
+  Error E = zstd::compress(Input, Compressed, Level, Threads);
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+
+  // Check that uncompressed buffer is the same as original.
+  E = zstd::uncompress(Compressed, Uncompressed, Input.size());
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+
+  EXPECT_EQ(Input, Uncompressed);
+  if (Input.size() > 0) {
+    // Uncompression fails if expected length is too short.
+    E = zstd::uncompress(Compressed, Uncompressed, Input.size() - 1);
+    EXPECT_EQ("zstd error: Destination buffer is too small",
+              llvm::toString(std::move(E)));
+  }
+}
+
+TEST(CompressionTest, Zstd) {
+  if (!zstd::isAvailable())
+    return;
+
+  TestZstdCompression("", zstd::DefaultCompression);
+
+  TestZstdCompression("hello, world!", zstd::NoCompression);
+  TestZstdCompression("hello, world!", zstd::BestSizeCompression);
+  TestZstdCompression("hello, world!", zstd::BestSpeedCompression);
+  TestZstdCompression("hello, world!", zstd::DefaultCompression);
+
+  const size_t kSize = 1024;
+  char BinaryData[kSize];
+  for (size_t i = 0; i < kSize; ++i) {
+    BinaryData[i] = i & 255;
+  }
+  StringRef BinaryDataStr(BinaryData, kSize);
+
+  TestZstdCompression(BinaryDataStr, zstd::NoCompression);
+  TestZstdCompression(BinaryDataStr, zstd::BestSizeCompression);
+  TestZstdCompression(BinaryDataStr, zstd::BestSpeedCompression);
+  TestZstdCompression(BinaryDataStr, zstd::DefaultCompression);
+
+  // Large enough to be split into several jobs if zstd supports threads.
+  std::string Large;
+  for (unsigned i = 0; Large.size() < (8 << 20); ++i)
+    Large += std::to_string(i * 2654435761U);
+  TestZstdCompression(Large, zstd::DefaultCompression, 4);
+}
+
+TEST(CompressionTest, ZstdStreaming) {
+  if (!zstd::isAvailable())
+    return;
+
+  std::string Input;
+  for (unsigned i = 0; Input.size() < (1 << 20); ++i)
+    Input += std::to_string(i);
+
+  // Compress in uneven pieces.
+  std::string Compressed;
+  raw_string_ostream CompressedOS(Compressed);
+  zstd::Compressor C(CompressedOS);
+  for (size_t Pos = 0, Step = 1; Pos < Input.size(); Pos += Step, Step *= 3)
+    EXPECT_FALSE(errorToBool(C.write(StringRef(Input).slice(Pos, Pos + Step))));
+  EXPECT_FALSE(errorToBool(C.finish()));
+  CompressedOS.flush();
+
+  SmallString<32> Uncompressed;
+  EXPECT_FALSE(errorToBool(zstd::uncompress(Compressed, Uncompressed,
+                                            Input.size())));
+  EXPECT_EQ(Input, Uncompressed);
+
+  // Decompress one byte at a time.
+  std::string Streamed;
+  raw_string_ostream StreamedOS(Streamed);
+  zstd::Decompressor D(StreamedOS);
+  for (char Byte : Compressed)
+    EXPECT_FALSE(errorToBool(D.write(StringRef(&Byte, 1))));
+  EXPECT_FALSE(errorToBool(D.finish()));
+  EXPECT_EQ(Input, StreamedOS.str());
+
+  // A truncated frame is diagnosed.
+  std::string Truncated;
+  raw_string_ostream TruncatedOS(Truncated);
+  zstd::Decompressor D2(TruncatedOS);
+  EXPECT_FALSE(errorToBool(D2.write(StringRef(Compressed).drop_back())));
+  EXPECT_EQ("zstd error: truncated input", llvm::toString(D2.finish()));
+}
+
 }
@@ -128,6 +128,54 @@ TEST(DataExtractorTest, LEB128_error) {
   EXPECT_EQ(0U, Offset);
 }
 
+TEST(DataExtractorTest, getULEB128_array) {
+  // Short values, a value too long for one word, and one that needs the
+  // byte-by-byte path because it is close to the end.
+  const char Data[] = "\x01\xA6\x49\x80\x80\x80\x80\x80\x80\x80\x80\x01"
+                      "\x7F\xFF\x01";
+  DataExtractor DE(StringRef(Data, sizeof(Data) - 1), false, 8);
+  uint64_t Offset = 0;
+  uint64_t Values[5];
+  EXPECT_EQ(Values, DE.getULEB128(&Offset, Values, 5));
+  EXPECT_EQ(15U, Offset);
+  EXPECT_EQ(1U, Values[0]);
+  EXPECT_EQ(9382U, Values[1]);
+  EXPECT_EQ(1ULL << 56, Values[2]);
+  EXPECT_EQ(0x7fU, Values[3]);
+  EXPECT_EQ(0xffU, Values[4]);
+
+  Offset = 0;
+  EXPECT_EQ(nullptr, DE.getULEB128(&Offset, Values, 6));
+  EXPECT_EQ(0U, Offset);
+
+  DataExtractor::Cursor C(0);
+  SmallVector<uint64_t, 2> V;
+  DE.getULEB128(C, V, 6);
+  EXPECT_THAT_ERROR(C.takeError(), Failed());
+  EXPECT_TRUE(V.empty());
+
+  DE.getULEB128(C, V, 2);
+  EXPECT_THAT_ERROR(C.takeError(), Succeeded());
+  EXPECT_EQ(3U, C.tell());
+  EXPECT_EQ((SmallVector<uint64_t, 2>{1, 9382}), V);
+}
+
+TEST(DataExtractorTest, skipLEB128) {
+  const char Data[] = "\xA6\x49\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x7F"
+                      "\x81";
+  DataExtractor DE(StringRef(Data, sizeof(Data) - 1), false, 8);
+  DataExtractor::Cursor C(0);
+  DE.skipLEB128(C);
+  EXPECT_EQ(2U, C.tell());
+  DE.skipLEB128(C);
+  EXPECT_EQ(13U, C.tell());
+  EXPECT_THAT_ERROR(C.takeError(), Succeeded());
+
+  DE.skipLEB128(C);
+  EXPECT_THAT_ERROR(C.takeError(), Failed());
+  EXPECT_EQ(13U, C.tell());
+}
+
 TEST(DataExtractorTest, Cursor_tell) {
   DataExtractor DE(StringRef("AB"), false, 8);
   DataExtractor::Cursor C(0);
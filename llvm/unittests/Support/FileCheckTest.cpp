@@ -396,6 +396,19 @@ TEST_F(FileCheckTest, Match) {
   // Check that @LINE is 7 as expected.
   EXPECT_FALSE(Tester.parsePatternExpect("[[#@LINE]]"));
   EXPECT_FALSE(Tester.matchExpect("7"));
+
+  // Check that a regex is matched on the lines holding its literal parts,
+  // with anchors matching at the line boundaries.
+  Tester.initNextPattern();
+  EXPECT_FALSE(Tester.parsePatternExpect("{{^}}foo{{[0-9]+$}}"));
+  EXPECT_TRUE(Tester.matchExpect("foo"));
+  EXPECT_TRUE(Tester.matchExpect("xfoo1\nfoo1x"));
+  EXPECT_FALSE(Tester.matchExpect("xfoo1\nfoo1x\nfoo1"));
+  EXPECT_FALSE(Tester.matchExpect("foo1\nfoo"));
+  Tester.initNextPattern();
+  EXPECT_FALSE(Tester.parsePatternExpect("[[VAR:[a-z]+]] bar [[VAR]]"));
+  EXPECT_TRUE(Tester.matchExpect("abc bar\nabc"));
+  EXPECT_FALSE(Tester.matchExpect("abc bar abd\nbar\nabc bar abc"));
 }
 
 TEST_F(FileCheckTest, Substitution) {
@@ -118,6 +118,42 @@ TEST(FileOutputBuffer, Test) {
   EXPECT_TRUE(IsExecutable);
   ASSERT_NO_ERROR(fs::remove(File4.str()));
 
+  // TEST 5: Verify that an existing file can be modified in place.
+  SmallString<128> File5(TestDirectory);
+  File5.append("/file5");
+  {
+    std::error_code EC;
+    raw_fd_ostream OS(File5, EC);
+    ASSERT_NO_ERROR(EC);
+    OS << "AABBCCDDEEFFGGHHIIJJ";
+  }
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File5, size_t(-1), FileOutputBuffer::F_modify);
+    ASSERT_NO_ERROR(errorToErrorCode(BufferOrErr.takeError()));
+    std::unique_ptr<FileOutputBuffer> &Buffer = *BufferOrErr;
+    // The buffer starts out with the contents of the file.
+    ASSERT_EQ(Buffer->getBufferSize(), 20U);
+    ASSERT_EQ(0, memcmp(Buffer->getBufferStart(), "AABBCCDDEEFFGGHHIIJJ", 20));
+    memcpy(Buffer->getBufferStart() + 4, "XXYY", 4);
+    ASSERT_NO_ERROR(errorToErrorCode(Buffer->commit()));
+  }
+  {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+        MemoryBuffer::getFile(File5);
+    ASSERT_NO_ERROR(MBOrErr.getError());
+    EXPECT_EQ((*MBOrErr)->getBuffer(), "AABBXXYYEEFFGGHHIIJJ");
+  }
+  ASSERT_NO_ERROR(fs::remove(File5.str()));
+
+  // TEST 6: Verify that F_modify fails if the file does not exist.
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File5, size_t(-1), FileOutputBuffer::F_modify);
+    ASSERT_EQ(errorToErrorCode(BufferOrErr.takeError()),
+              errc::no_such_file_or_directory);
+  }
+
   // Clean up.
   ASSERT_NO_ERROR(fs::remove(TestDirectory.str()));
 }
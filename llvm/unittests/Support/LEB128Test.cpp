@@ -11,6 +11,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 #include <string>
+#include <vector>
 using namespace llvm;
 
 namespace {
@@ -138,6 +139,49 @@ TEST(LEB128Test, DecodeULEB128) {
 #undef EXPECT_DECODE_ULEB128_EQ
 }
 
+TEST(LEB128Test, DecodeULEB128Array) {
+  // Every value from one to ten bytes, with and without padding after it, so
+  // that both the word-at-a-time and the byte-by-byte decoding are used.
+  std::string Encoded;
+  std::vector<uint64_t> Expected;
+  for (unsigned Bits = 0; Bits <= 64; ++Bits) {
+    uint64_t Value = Bits == 64 ? ~0ULL : (1ULL << Bits) - 1;
+    raw_string_ostream OS(Encoded);
+    encodeULEB128(Value, OS);
+    OS.flush();
+    Expected.push_back(Value);
+  }
+  const uint8_t *Begin = reinterpret_cast<const uint8_t *>(Encoded.data());
+  const uint8_t *End = Begin + Encoded.size();
+  std::vector<uint64_t> Actual(Expected.size());
+  const char *Error = "not set";
+  EXPECT_EQ(End, decodeULEB128Array(Begin, End, Actual.data(), Actual.size(),
+                                    &Error));
+  EXPECT_EQ(nullptr, Error);
+  EXPECT_EQ(Expected, Actual);
+
+  // Values that run past the end or overflow are errors.
+  EXPECT_EQ(nullptr, decodeULEB128Array(Begin, End - 1, Actual.data(),
+                                        Actual.size(), &Error));
+  EXPECT_STREQ("malformed uleb128, extends past end", Error);
+  const uint8_t TooBig[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                            0xff, 0xff, 0xff, 0xff, 0x01};
+  EXPECT_EQ(nullptr, decodeULEB128Array(TooBig, std::end(TooBig),
+                                        Actual.data(), 1, &Error));
+  EXPECT_STREQ("uleb128 too big for uint64", Error);
+}
+
+TEST(LEB128Test, SkipLEB128) {
+  const uint8_t Data[] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+                          0x80, 0x00, 0x7f, 0xc0, 0x80};
+  const uint8_t *End = std::end(Data);
+  EXPECT_EQ(Data + 10, skipLEB128(Data, End));
+  EXPECT_EQ(Data + 10, skipLEB128(Data + 7, End));
+  EXPECT_EQ(Data + 11, skipLEB128(Data + 10, End));
+  EXPECT_EQ(nullptr, skipLEB128(Data + 11, End));
+  EXPECT_EQ(nullptr, skipLEB128(End, End));
+}
+
 TEST(LEB128Test, DecodeSLEB128) {
 #define EXPECT_DECODE_SLEB128_EQ(EXPECTED, VALUE) \
   do { \
@@ -165,6 +165,26 @@ TEST(LineIteratorTest, BlankKeeping) {
   EXPECT_EQ(E, I);
 }
 
+TEST(LineIteratorTest, CarriageReturns) {
+  std::unique_ptr<MemoryBuffer> Buffer(
+      MemoryBuffer::getMemBuffer("line\r1\r\n"
+                                 "# Comment\r\n"
+                                 "line 3\r"));
+
+  line_iterator I = line_iterator(*Buffer, true, '#'), E;
+
+  // Only "\r\n" ends a line; a lone '\r' is part of it.
+  EXPECT_EQ("line\r1", *I);
+  EXPECT_EQ(1, I.line_number());
+  ++I;
+  EXPECT_EQ("line 3\r", *I);
+  EXPECT_EQ(3, I.line_number());
+  ++I;
+
+  EXPECT_TRUE(I.is_at_eof());
+  EXPECT_EQ(E, I);
+}
+
 TEST(LineIteratorTest, EmptyBuffers) {
   std::unique_ptr<MemoryBuffer> Buffer = MemoryBuffer::getMemBuffer("");
   EXPECT_TRUE(line_iterator(*Buffer).is_at_eof());
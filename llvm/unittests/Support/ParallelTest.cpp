@@ -14,6 +14,7 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
 #include <random>
 
 uint32_t array[1024 * 1024];
@@ -49,4 +50,34 @@ TEST(Parallel, parallel_for) {
   ASSERT_EQ(range[2049], 1u);
 }
 
+TEST(Parallel, nested) {
+  // Every task waits for a task group of its own. As the waiting threads run
+  // queued tasks, this finishes even with more outer tasks than threads.
+  std::atomic<unsigned> Count(0);
+  for_each_n(parallel::par, 0, 64, [&](size_t) {
+    for_each_n(parallel::par, 0, 64, [&](size_t) {
+      for_each_n(parallel::par, 0, 16, [&](size_t) { ++Count; });
+    });
+  });
+  ASSERT_EQ(Count, 64u * 64u * 16u);
+}
+
+TEST(Parallel, nested_sort) {
+  std::vector<std::vector<uint32_t>> Vectors(32);
+  std::mt19937 randEngine;
+  std::uniform_int_distribution<uint32_t> dist;
+  for (std::vector<uint32_t> &V : Vectors) {
+    V.resize(8192);
+    for (uint32_t &I : V)
+      I = dist(randEngine);
+  }
+
+  for_each(parallel::par, Vectors.begin(), Vectors.end(),
+           [](std::vector<uint32_t> &V) {
+             sort(parallel::par, V.begin(), V.end());
+           });
+  for (const std::vector<uint32_t> &V : Vectors)
+    ASSERT_TRUE(std::is_sorted(V.begin(), V.end()));
+}
+
 #endif
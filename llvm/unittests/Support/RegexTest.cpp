@@ -168,6 +168,13 @@ TEST_F(RegexTest, MatchInvalid) {
   std::string Error;
   EXPECT_FALSE(r1.isValid(Error));
   EXPECT_FALSE(r1.match("X"));
+  EXPECT_FALSE(r1.match("X", nullptr, &Error));
+  EXPECT_EQ("invalid regular expression", Error);
+
+  const Regex r2("X");
+  Error = "stale";
+  EXPECT_TRUE(r2.match("X", nullptr, &Error));
+  EXPECT_EQ("", Error);
 }
 
 // https://bugs.chromium.org/p/oss-fuzz/issues/detail?id=3727
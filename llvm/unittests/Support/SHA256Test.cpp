@@ -0,0 +1,62 @@
+//===- llvm/unittest/Support/SHA256Test.cpp - SHA256 tests ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SHA256.h"
+#include "llvm/ADT/StringExtras.h"
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace llvm;
+
+static std::string hashToHex(StringRef Input) {
+  SHA256 Hash;
+  Hash.update(Input);
+  return toHex(Hash.final(), /*LowerCase=*/true);
+}
+
+TEST(SHA256Test, Basic) {
+  EXPECT_EQ("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+            hashToHex(""));
+  EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+            hashToHex("abc"));
+  EXPECT_EQ("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+            hashToHex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+}
+
+TEST(SHA256Test, Hash) {
+  ArrayRef<uint8_t> Input((const uint8_t *)"abc", 3);
+  std::array<uint8_t, 32> Vec = SHA256::hash(Input);
+  EXPECT_EQ("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+            toHex(StringRef((const char *)Vec.data(), 32), true));
+}
+
+// Feeding the data in pieces that straddle block boundaries must give the
+// same result as hashing it in one go.
+TEST(SHA256Test, Split) {
+  std::string Data;
+  for (int I = 0; I < 1000; ++I)
+    Data += char('a' + I % 26);
+
+  for (size_t Step : {1, 7, 63, 64, 65, 200}) {
+    SHA256 Hash;
+    for (size_t I = 0; I < Data.size(); I += Step)
+      Hash.update(StringRef(Data).substr(I, Step));
+    EXPECT_EQ(hashToHex(Data), toHex(Hash.final(), true)) << "Step " << Step;
+  }
+}
+
+// Check that getting the intermediate hash in the middle of the stream does
+// not invalidate the final result.
+TEST(SHA256Test, Intermediate) {
+  SHA256 Hash;
+  Hash.update(StringRef("ab"));
+  EXPECT_EQ(hashToHex("ab"), toHex(Hash.result(), true));
+  Hash.update(StringRef("c"));
+  EXPECT_EQ(hashToHex("abc"), toHex(Hash.final(), true));
+}
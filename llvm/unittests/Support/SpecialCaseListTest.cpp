@@ -243,4 +243,72 @@ TEST_F(SpecialCaseListTest, EscapedSymbols) {
   EXPECT_FALSE(SCL->inSection("", "src", "hello\\\\world"));
 }
 
+TEST_F(SpecialCaseListTest, Globs) {
+  std::unique_ptr<SpecialCaseList> SCL = makeSpecialCaseList("fun:a*b\n"
+                                                             "fun:*x*y*z\n"
+                                                             "fun:p*p*\n"
+                                                             "fun:**\n"
+                                                             "fun:q.*=dot\n"
+                                                             "fun:*qq*=dot\n");
+  EXPECT_EQ(1u, SCL->inSectionBlame("", "fun", "ab"));
+  EXPECT_EQ(1u, SCL->inSectionBlame("", "fun", "abab"));
+  EXPECT_EQ(2u, SCL->inSectionBlame("", "fun", "xyz"));
+  EXPECT_EQ(2u, SCL->inSectionBlame("", "fun", "xxyyzzyxz"));
+  EXPECT_EQ(3u, SCL->inSectionBlame("", "fun", "pp"));
+  EXPECT_EQ(4u, SCL->inSectionBlame("", "fun", "xzy"));
+  EXPECT_EQ(4u, SCL->inSectionBlame("", "fun", ""));
+
+  // Expressions with other metacharacters keep their order with the globs.
+  EXPECT_EQ(5u, SCL->inSectionBlame("", "fun", "qqq", "dot"));
+  EXPECT_EQ(6u, SCL->inSectionBlame("", "fun", "aqqa", "dot"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "fun", "q", "dot"));
+}
+
+TEST_F(SpecialCaseListTest, Prefixes) {
+  std::unique_ptr<SpecialCaseList> SCL = makeSpecialCaseList("fun:abc*\n"
+                                                             "fun:ab?x*\n"
+                                                             "fun:a*\n"
+                                                             "fun:ab+y\n"
+                                                             "fun:b|abz\n"
+                                                             "fun:abcd*\n");
+  EXPECT_EQ(1u, SCL->inSectionBlame("", "fun", "abcd"));
+  EXPECT_EQ(2u, SCL->inSectionBlame("", "fun", "ax"));
+  EXPECT_EQ(2u, SCL->inSectionBlame("", "fun", "abxx"));
+  EXPECT_EQ(3u, SCL->inSectionBlame("", "fun", "abby"));
+  EXPECT_EQ(3u, SCL->inSectionBlame("", "fun", "abz"));
+  EXPECT_EQ(5u, SCL->inSectionBlame("", "fun", "b"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "fun", "bcd"));
+}
+
+TEST_F(SpecialCaseListTest, Infixes) {
+  std::unique_ptr<SpecialCaseList> SCL = makeSpecialCaseList("fun:*foo*\n"
+                                                             "fun:*fo*\n"
+                                                             "fun:*bar*baz\n"
+                                                             "fun:*barbaz*\n"
+                                                             "fun:*o\n");
+  EXPECT_EQ(1u, SCL->inSectionBlame("", "fun", "xfoox"));
+  EXPECT_EQ(2u, SCL->inSectionBlame("", "fun", "xfox"));
+  EXPECT_EQ(3u, SCL->inSectionBlame("", "fun", "barbaz"));
+  EXPECT_EQ(4u, SCL->inSectionBlame("", "fun", "barbazz"));
+  EXPECT_EQ(5u, SCL->inSectionBlame("", "fun", "bo"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "fun", "bar"));
+}
+
+TEST_F(SpecialCaseListTest, Suffixes) {
+  std::unique_ptr<SpecialCaseList> SCL =
+      makeSpecialCaseList("src:*/lib/Foo.cpp\n"
+                          "src:*.h\n"
+                          "src:*[0-9]Bar\\.cpp\n"
+                          "src:*/include/foo.h\n"
+                          "src:x.y\n");
+  EXPECT_EQ(1u, SCL->inSectionBlame("", "src", "/src/lib/Foo.cpp"));
+  EXPECT_EQ(1u, SCL->inSectionBlame("", "src", "/src/lib/Foo_cpp"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "src", "lib/Foo.cpp"));
+  EXPECT_EQ(2u, SCL->inSectionBlame("", "src", "/src/include/foo.h"));
+  EXPECT_EQ(3u, SCL->inSectionBlame("", "src", "/src/lib/1Bar.cpp"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "src", "/src/lib/1Bar_cpp"));
+  EXPECT_EQ(5u, SCL->inSectionBlame("", "src", "xzy"));
+  EXPECT_EQ(0u, SCL->inSectionBlame("", "src", "xzyy"));
+}
+
 }
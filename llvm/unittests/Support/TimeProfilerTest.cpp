@@ -0,0 +1,78 @@
+//===- unittests/TimeProfilerTest.cpp - Time trace profiler tests ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/JSON.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(TimeProfiler, SectionsOfEveryThreadAreWritten) {
+  timeTraceProfilerInitialize(/*TimeTraceGranularity=*/0, "/path/to/main");
+  {
+    TimeTraceScope Scope("Main", "main detail");
+    std::vector<std::thread> Threads;
+    for (int I = 0; I < 4; ++I)
+      Threads.emplace_back([] {
+        timeTraceProfilerInitialize(/*TimeTraceGranularity=*/0, "worker");
+        {
+          TimeTraceScope Scope("Worker", "worker detail");
+        }
+        timeTraceProfilerFinishThread();
+        EXPECT_FALSE(timeTraceProfilerEnabled());
+      });
+    for (std::thread &T : Threads)
+      T.join();
+  }
+
+  SmallString<1024> Buffer;
+  raw_svector_ostream OS(Buffer);
+  timeTraceProfilerWrite(OS);
+  timeTraceProfilerCleanup();
+  EXPECT_FALSE(timeTraceProfilerEnabled());
+
+  Expected<json::Value> Trace = json::parse(Buffer);
+  ASSERT_TRUE(bool(Trace));
+  const json::Array *Events = Trace->getAsObject()->getArray("traceEvents");
+  ASSERT_NE(Events, nullptr);
+
+  int64_t MainTid = -1;
+  std::set<int64_t> WorkerTids;
+  int ThreadNames = 0;
+  bool SawProcessName = false;
+  bool SawWorkerTotal = false;
+  for (const json::Value &V : *Events) {
+    const json::Object *E = V.getAsObject();
+    StringRef Name = *E->getString("name");
+    int64_t Tid = *E->getInteger("tid");
+    if (Name == "Main")
+      MainTid = Tid;
+    else if (Name == "Worker")
+      WorkerTids.insert(Tid);
+    else if (Name == "thread_name")
+      ++ThreadNames;
+    else if (Name == "process_name")
+      SawProcessName = *E->getObject("args")->getString("name") == "main";
+    else if (Name == "Total Worker")
+      SawWorkerTotal = *E->getObject("args")->getInteger("count") == 4;
+  }
+  EXPECT_NE(MainTid, -1);
+  EXPECT_EQ(WorkerTids.size(), 4u);
+  EXPECT_EQ(WorkerTids.count(MainTid), 0u);
+  EXPECT_EQ(ThreadNames, 5);
+  EXPECT_TRUE(SawProcessName);
+  EXPECT_TRUE(SawWorkerTotal);
+}
+
+} // end anonymous namespace
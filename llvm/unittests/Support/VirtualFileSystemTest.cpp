@@ -1314,6 +1314,76 @@ TEST_F(InMemoryFileSystemTest, RecursiveIterationWithHardLink) {
 
 // NOTE: in the tests below, we use '//root/' as our root directory, since it is
 // a legal *absolute* path on Windows as well as *nix.
+namespace {
+class StatCountingFileSystem : public vfs::ProxyFileSystem {
+public:
+  unsigned NumStatus = 0;
+
+  explicit StatCountingFileSystem(IntrusiveRefCntPtr<vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  ErrorOr<vfs::Status> status(const Twine &Path) override {
+    ++NumStatus;
+    return ProxyFileSystem::status(Path);
+  }
+};
+} // end anonymous namespace
+
+TEST(StatCachingFileSystemTest, Basic) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  Base->addFile("/a/b", 0, MemoryBuffer::getMemBuffer("test"));
+  IntrusiveRefCntPtr<StatCountingFileSystem> Counting(
+      new StatCountingFileSystem(Base));
+  vfs::StatCachingFileSystem FS(Counting);
+
+  auto Stat = FS.status("/a/b");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ(1u, Counting->NumStatus);
+  Stat = FS.status("/a/b");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ("/a/b", Stat->getName());
+  EXPECT_EQ(1u, Counting->NumStatus);
+
+  // Failures are cached as well.
+  EXPECT_EQ(errc::no_such_file_or_directory, FS.status("/a/c").getError());
+  EXPECT_EQ(errc::no_such_file_or_directory, FS.status("/a/c").getError());
+  EXPECT_EQ(2u, Counting->NumStatus);
+
+  // Relative paths share the entry of the absolute path, but keep their name.
+  ASSERT_FALSE(FS.setCurrentWorkingDirectory("/a"));
+  Stat = FS.status("b");
+  ASSERT_FALSE(Stat.getError());
+  EXPECT_EQ("b", Stat->getName());
+  EXPECT_EQ(2u, Counting->NumStatus);
+
+  // Files opened through the cache are read from the underlying file system.
+  auto File = FS.openFileForRead("/a/b");
+  ASSERT_FALSE(File.getError());
+  EXPECT_EQ("test", (*(*File)->getBuffer("ignored"))->getBuffer());
+
+  EXPECT_EQ(2u, FS.getCache().size());
+  FS.getCache().clear();
+  EXPECT_EQ(0u, FS.getCache().size());
+  ASSERT_FALSE(FS.status("/a/b").getError());
+  EXPECT_EQ(3u, Counting->NumStatus);
+}
+
+TEST(StatCachingFileSystemTest, SharedCache) {
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> Base(
+      new vfs::InMemoryFileSystem());
+  Base->addFile("/a", 0, MemoryBuffer::getMemBuffer("test"));
+  IntrusiveRefCntPtr<StatCountingFileSystem> Counting(
+      new StatCountingFileSystem(Base));
+  auto Cache = std::make_shared<vfs::StatCachingFileSystem::StatCache>();
+  vfs::StatCachingFileSystem FS1(Counting, Cache);
+  vfs::StatCachingFileSystem FS2(Counting, Cache);
+
+  ASSERT_FALSE(FS1.status("/a").getError());
+  ASSERT_FALSE(FS2.status("/a").getError());
+  EXPECT_EQ(1u, Counting->NumStatus);
+}
+
 class VFSFromYAMLTest : public ::testing::Test {
 public:
   int NumDiagnostics;
@@ -1455,6 +1525,51 @@ TEST_F(VFSFromYAMLTest, CaseInsensitive) {
   EXPECT_EQ(0, NumDiagnostics);
 }
 
+TEST_F(VFSFromYAMLTest, LargeDirectory) {
+  IntrusiveRefCntPtr<DummyFileSystem> Lower(new DummyFileSystem());
+  std::string Contents;
+  for (unsigned I = 0; I < 64; ++I) {
+    std::string N = std::to_string(I);
+    Lower->addRegularFile("//root/external/f" + N);
+    if (I)
+      Contents += ",\n";
+    Contents += "{ 'type': 'file', 'name': 'F" + N +
+                "', 'external-contents': '//root/external/f" + N + "' }";
+  }
+  // A second directory with the name of a file, after it.
+  Contents += ",\n{ 'type': 'directory', 'name': 'F3', 'contents': [\n"
+              "  { 'type': 'file', 'name': 'g',\n"
+              "    'external-contents': '//root/external/f0' } ] }";
+
+  for (bool CaseSensitive : {true, false}) {
+    IntrusiveRefCntPtr<vfs::FileSystem> FS = getFromYAMLString(
+        std::string("{ 'case-sensitive': '") +
+            (CaseSensitive ? "true" : "false") +
+            "',\n"
+            "  'use-external-names': false,\n"
+            "  'fallthrough': false,\n"
+            "  'roots': [ { 'type': 'directory', 'name': '//root/big',\n"
+            "               'contents': [\n" +
+            Contents + "] } ] }",
+        Lower);
+    ASSERT_TRUE(FS.get() != nullptr);
+
+    ErrorOr<vfs::Status> S = FS->status("//root/big/F42");
+    ASSERT_FALSE(S.getError());
+    EXPECT_EQ("//root/big/F42", S->getName());
+    EXPECT_TRUE(S->equivalent(*Lower->status("//root/external/f42")));
+
+    S = FS->status("//root/big/f42");
+    EXPECT_EQ(CaseSensitive, !!S.getError());
+    EXPECT_EQ(errc::no_such_file_or_directory,
+              FS->status("//root/big/F64").getError());
+
+    // The file F3 comes first and isn't a directory.
+    EXPECT_EQ(errc::not_a_directory, FS->status("//root/big/F3/g").getError());
+  }
+  EXPECT_EQ(0, NumDiagnostics);
+}
+
 TEST_F(VFSFromYAMLTest, CaseSensitive) {
   IntrusiveRefCntPtr<DummyFileSystem> Lower(new DummyFileSystem());
   Lower->addRegularFile("//root/foo/bar/a");
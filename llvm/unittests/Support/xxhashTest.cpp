@@ -17,3 +17,32 @@ TEST(xxhashTest, Basic) {
   EXPECT_EQ(0x69196c1b3af0bff9U,
             xxHash64("0123456789abcdefghijklmnopqrstuvwxyz"));
 }
+
+TEST(xxhashTest, xxh3) {
+  constexpr size_t size = 2243;
+  uint8_t a[size];
+  uint64_t x = 1;
+  for (size_t i = 0; i < size; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    a[i] = uint8_t(x);
+  }
+
+#define F(len, expected)                                                       \
+  EXPECT_EQ(uint64_t(expected), xxh3_64bits(makeArrayRef(a, size_t(len))))
+  F(0, 0x2d06800538d394c2);
+  F(1, 0xd0d496e05c553485);
+  F(3, 0x6ea2d59aca5c3778);
+  F(4, 0xbf65290914e80242);
+  F(8, 0xabc1413da6cd0209);
+  F(9, 0x8bc89400bfed51f6);
+  F(16, 0x7e46916754d7c9b8);
+  F(17, 0xed4be912ba5f836d);
+  F(128, 0x06a146ee9a2da378);
+  F(129, 0xbc7138129bf065da);
+  F(240, 0x6a459e3c9a0ca573);
+  F(241, 0xd20eaf952a68efc8);
+  F(2243, 0x0979f786a24edde7);
+#undef F
+}
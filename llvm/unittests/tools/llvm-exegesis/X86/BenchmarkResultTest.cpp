@@ -122,6 +122,15 @@ TEST(BenchmarkResultTest, WriteToAndReadFromDisk) {
     EXPECT_THAT(FromDisk.Error, ToDisk.Error);
     EXPECT_EQ(FromDisk.Info, ToDisk.Info);
   }
+  {
+    // Benchmarks are appended to the file.
+    ExitOnErr(ToDisk.writeYaml(State, Filename));
+    const auto FromDiskVector =
+        ExitOnErr(InstructionBenchmark::readYamls(State, Filename));
+    ASSERT_EQ(FromDiskVector.size(), size_t{2});
+    EXPECT_EQ(FromDiskVector[1].Mode, ToDisk.Mode);
+    EXPECT_EQ(FromDiskVector[1].Info, ToDisk.Info);
+  }
 }
 
 TEST(BenchmarkResultTest, PerInstructionStats) {
@@ -62,8 +62,10 @@ bool TimeRegions = false;
 } // end namespace llvm
 
 namespace {
-  cl::opt<ActionType>
-  Action(cl::desc("Action to perform:"),
+  // Several actions can be given, each with an -o option of its own: the input
+  // is then parsed once for all of them.
+  cl::list<ActionType>
+  Actions(cl::desc("Action to perform:"),
          cl::values(clEnumValN(PrintRecords, "print-records",
                                "Print all records to stdout (default)"),
                     clEnumValN(DumpJSON, "dump-json",
@@ -137,8 +139,9 @@ cl::opt<bool, true>
                    cl::desc("Time regions of tablegens execution"),
                    cl::location(TimeRegions));
 
-bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records) {
-  switch (Action) {
+bool LLVMTableGenMain(raw_ostream &OS, RecordKeeper &Records,
+                      unsigned Backend) {
+  switch (Actions.empty() ? PrintRecords : Actions[Backend]) {
   case PrintRecords:
     OS << Records;           // No argument, dump all contents
     break;
@@ -260,7 +263,8 @@ int main(int argc, char **argv) {
 
   llvm_shutdown_obj Y;
 
-  return TableGenMain(argv[0], &LLVMTableGenMain);
+  return TableGenMain(argv[0], std::max<unsigned>(Actions.size(), 1),
+                      &LLVMTableGenMain);
 }
 
 #ifdef __has_feature
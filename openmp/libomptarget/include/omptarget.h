@@ -111,6 +111,15 @@ struct __tgt_target_table {
       *EntriesEnd; // End of the table with all the entries (non inclusive)
 };
 
+/// This struct carries the plugin queue that the operations of one target
+/// construct are issued to when the plugin supports asynchronous execution.
+/// Queue starts out as NULL and is created by the plugin on first use; the
+/// operations are only guaranteed to have completed after
+/// __tgt_rtl_synchronize, which also sets it back to NULL.
+struct __tgt_async_info {
+  void *Queue;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
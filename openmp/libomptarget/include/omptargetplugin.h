@@ -63,11 +63,29 @@ void *__tgt_rtl_data_alloc(int32_t ID, int64_t Size, void *HostPtr);
 int32_t __tgt_rtl_data_submit(int32_t ID, void *TargetPtr, void *HostPtr,
                               int64_t Size);
 
+// Pass the data content to the target device using the target address, as an
+// operation queued on AsyncInfo. The host data may only be reused once
+// __tgt_rtl_synchronize has been called on AsyncInfo. This function and the
+// other _async ones are optional; libomptarget falls back to the synchronous
+// versions when a plugin does not provide them. In case of success, return
+// zero. Otherwise, return an error code.
+int32_t __tgt_rtl_data_submit_async(int32_t ID, void *TargetPtr, void *HostPtr,
+                                    int64_t Size,
+                                    __tgt_async_info *AsyncInfo);
+
 // Retrieve the data content from the target device using its address.
 // In case of success, return zero. Otherwise, return an error code.
 int32_t __tgt_rtl_data_retrieve(int32_t ID, void *HostPtr, void *TargetPtr,
                                 int64_t Size);
 
+// Retrieve the data content from the target device using its address, as an
+// operation queued on AsyncInfo. The host data is only valid once
+// __tgt_rtl_synchronize has been called on AsyncInfo. In case of success,
+// return zero. Otherwise, return an error code.
+int32_t __tgt_rtl_data_retrieve_async(int32_t ID, void *HostPtr,
+                                      void *TargetPtr, int64_t Size,
+                                      __tgt_async_info *AsyncInfo);
+
 // De-allocate the data referenced by target ptr on the device. In case of
 // success, return zero. Otherwise, return an error code.
 int32_t __tgt_rtl_data_delete(int32_t ID, void *TargetPtr);
@@ -87,6 +105,23 @@ int32_t __tgt_rtl_run_target_team_region(int32_t ID, void *Entry, void **Args,
                                          int32_t NumTeams, int32_t ThreadLimit,
                                          uint64_t loop_tripcount);
 
+// Asynchronous versions of the two functions above: the region is launched
+// on AsyncInfo, after the operations already queued on it, and is only
+// guaranteed to have finished after __tgt_rtl_synchronize.
+int32_t __tgt_rtl_run_target_region_async(int32_t ID, void *Entry, void **Args,
+                                          ptrdiff_t *Offsets, int32_t NumArgs,
+                                          __tgt_async_info *AsyncInfo);
+
+int32_t __tgt_rtl_run_target_team_region_async(
+    int32_t ID, void *Entry, void **Args, ptrdiff_t *Offsets, int32_t NumArgs,
+    int32_t NumTeams, int32_t ThreadLimit, uint64_t loop_tripcount,
+    __tgt_async_info *AsyncInfo);
+
+// Wait for all the operations queued on AsyncInfo to complete, and release
+// its queue. In case of success, return zero. Otherwise, return an error
+// code, which may come from any of the queued operations.
+int32_t __tgt_rtl_synchronize(int32_t ID, __tgt_async_info *AsyncInfo);
+
 #ifdef __cplusplus
 }
 #endif
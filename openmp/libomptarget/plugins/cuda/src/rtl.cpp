@@ -12,8 +12,10 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <cuda.h>
 #include <list>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -83,6 +85,60 @@ struct omptarget_device_environmentTy {
   int32_t debug_level;
 };
 
+/// A stream handed out to libomptarget as the queue of a __tgt_async_info.
+/// Small transfers queued on it are staged through pinned host memory, which
+/// the copy engines can read and write directly, so the stream goes on without
+/// waiting for the driver to stage pageable memory. The staging memory is
+/// carved out of chunks owned by the stream, and reused once it has been
+/// synchronized.
+struct StreamTy {
+  static const size_t StagingChunkSize = 1 << 20;
+  static const size_t StagingMaxChunks = 16;
+
+  CUstream Stream = nullptr;
+  std::vector<void *> StagingChunks;
+  size_t StagingChunk = 0; // Index of the chunk being carved.
+  size_t StagingUsed = 0;  // Bytes of it already in use.
+
+  // Retrieves staged on the stream, to be copied to their destination once
+  // the stream has been synchronized.
+  struct StagedRetrieveTy {
+    void *HstPtr;
+    void *StagingPtr;
+    int64_t Size;
+  };
+  std::vector<StagedRetrieveTy> StagedRetrieves;
+
+  // Return staging memory for Size bytes, or NULL if the transfer is to be
+  // done from the user's memory.
+  void *allocStaging(int64_t Size) {
+    size_t AlignedSize = ((size_t)Size + 63) & ~(size_t)63;
+    if (AlignedSize > StagingChunkSize)
+      return NULL;
+    if (StagingChunk < StagingChunks.size() &&
+        StagingUsed + AlignedSize > StagingChunkSize) {
+      ++StagingChunk;
+      StagingUsed = 0;
+    }
+    if (StagingChunk == StagingChunks.size()) {
+      void *Chunk;
+      if (StagingChunks.size() == StagingMaxChunks ||
+          cuMemAllocHost(&Chunk, StagingChunkSize) != CUDA_SUCCESS)
+        return NULL;
+      StagingChunks.push_back(Chunk);
+    }
+    void *Ptr = (char *)StagingChunks[StagingChunk] + StagingUsed;
+    StagingUsed += AlignedSize;
+    return Ptr;
+  }
+
+  void resetStaging() {
+    StagingChunk = 0;
+    StagingUsed = 0;
+    StagedRetrieves.clear();
+  }
+};
+
 /// List that contains all the kernels.
 /// FIXME: we may need this to be per device and per library.
 std::list<KernelTy> KernelsList;
@@ -112,6 +168,10 @@ public:
   // OpenMP Requires Flags
   int64_t RequiresFlags;
 
+  // Streams not handed out to libomptarget, per device.
+  std::vector<std::vector<StreamTy *>> FreeStreams;
+  std::mutex StreamsMtx;
+
   //static int EnvNumThreads;
   static const int HardTeamLimit = 1<<16; // 64k
   static const int HardThreadLimit = 1024;
@@ -163,6 +223,36 @@ public:
     return &E.Table;
   }
 
+  // Return a stream of the device, whose context must be current, to queue
+  // the operations of a __tgt_async_info on.
+  StreamTy *getStream(int32_t device_id) {
+    {
+      std::lock_guard<std::mutex> Lock(StreamsMtx);
+      if (!FreeStreams[device_id].empty()) {
+        StreamTy *S = FreeStreams[device_id].back();
+        FreeStreams[device_id].pop_back();
+        return S;
+      }
+    }
+    // The stream is a blocking one so that the synchronous functions, which
+    // use the NULL stream, stay ordered with respect to it.
+    StreamTy *S = new StreamTy();
+    CUresult err = cuStreamCreate(&S->Stream, CU_STREAM_DEFAULT);
+    if (err != CUDA_SUCCESS) {
+      DP("Error when creating CUDA stream\n");
+      CUDA_ERR_STRING(err);
+      delete S;
+      return NULL;
+    }
+    return S;
+  }
+
+  void returnStream(int32_t device_id, StreamTy *S) {
+    S->resetStaging();
+    std::lock_guard<std::mutex> Lock(StreamsMtx);
+    FreeStreams[device_id].push_back(S);
+  }
+
   // Clear entries table for a device
   void clearOffloadEntriesTable(int32_t device_id) {
     assert(device_id < (int32_t)FuncGblEntries.size() &&
@@ -210,6 +300,7 @@ public:
     WarpSize.resize(NumberOfDevices);
     NumTeams.resize(NumberOfDevices);
     NumThreads.resize(NumberOfDevices);
+    FreeStreams.resize(NumberOfDevices);
 
     // Get environment variables regarding teams
     char *envStr = getenv("OMP_TEAM_LIMIT");
@@ -244,6 +335,18 @@ public:
         }
       }
 
+    // Destroy streams and their staging memory
+    for (int32_t i = 0; i < (int32_t)FreeStreams.size(); ++i) {
+      if (FreeStreams[i].empty() || cuCtxSetCurrent(Contexts[i]) != CUDA_SUCCESS)
+        continue;
+      for (StreamTy *S : FreeStreams[i]) {
+        for (void *Chunk : S->StagingChunks)
+          cuMemFreeHost(Chunk);
+        cuStreamDestroy(S->Stream);
+        delete S;
+      }
+    }
+
     // Destroy contexts
     for (auto &ctx : Contexts)
       if (ctx) {
@@ -639,6 +742,107 @@ int32_t __tgt_rtl_data_retrieve(int32_t device_id, void *hst_ptr, void *tgt_ptr,
   return OFFLOAD_SUCCESS;
 }
 
+// Return the stream AsyncInfo queues on, taking one for it if it has none
+// yet. The device's context must be current.
+static StreamTy *getAsyncStream(int32_t device_id,
+                                __tgt_async_info *async_info) {
+  if (!async_info->Queue)
+    async_info->Queue = DeviceInfo.getStream(device_id);
+  return (StreamTy *)async_info->Queue;
+}
+
+int32_t __tgt_rtl_data_submit_async(int32_t device_id, void *tgt_ptr,
+    void *hst_ptr, int64_t size, __tgt_async_info *async_info) {
+  // Set the context we are using.
+  CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when setting CUDA context\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+
+  StreamTy *S = getAsyncStream(device_id, async_info);
+  if (!S)
+    return OFFLOAD_FAIL;
+
+  // A staged copy is done with the host data as soon as it returns.
+  void *src_ptr = hst_ptr;
+  if (void *staging_ptr = S->allocStaging(size)) {
+    memcpy(staging_ptr, hst_ptr, size);
+    src_ptr = staging_ptr;
+  }
+
+  err = cuMemcpyHtoDAsync((CUdeviceptr)tgt_ptr, src_ptr, size, S->Stream);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when copying data from host to device. Pointers: host = " DPxMOD
+       ", device = " DPxMOD ", size = %" PRId64 "\n", DPxPTR(hst_ptr),
+       DPxPTR(tgt_ptr), size);
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+  return OFFLOAD_SUCCESS;
+}
+
+int32_t __tgt_rtl_data_retrieve_async(int32_t device_id, void *hst_ptr,
+    void *tgt_ptr, int64_t size, __tgt_async_info *async_info) {
+  // Set the context we are using.
+  CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when setting CUDA context\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+
+  StreamTy *S = getAsyncStream(device_id, async_info);
+  if (!S)
+    return OFFLOAD_FAIL;
+
+  // A staged copy reaches the host data in __tgt_rtl_synchronize.
+  void *dst_ptr = hst_ptr;
+  if (void *staging_ptr = S->allocStaging(size)) {
+    S->StagedRetrieves.push_back({hst_ptr, staging_ptr, size});
+    dst_ptr = staging_ptr;
+  }
+
+  err = cuMemcpyDtoHAsync(dst_ptr, (CUdeviceptr)tgt_ptr, size, S->Stream);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when copying data from device to host. Pointers: host = " DPxMOD
+        ", device = " DPxMOD ", size = %" PRId64 "\n", DPxPTR(hst_ptr),
+        DPxPTR(tgt_ptr), size);
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+  return OFFLOAD_SUCCESS;
+}
+
+int32_t __tgt_rtl_synchronize(int32_t device_id, __tgt_async_info *async_info) {
+  StreamTy *S = (StreamTy *)async_info->Queue;
+  if (!S)
+    return OFFLOAD_SUCCESS;
+
+  // Set the context we are using.
+  CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when setting CUDA context\n");
+    CUDA_ERR_STRING(err);
+    return OFFLOAD_FAIL;
+  }
+
+  err = cuStreamSynchronize(S->Stream);
+  if (err != CUDA_SUCCESS) {
+    DP("Error when synchronizing stream. Kernel execution or a data transfer "
+       "may have failed.\n");
+    CUDA_ERR_STRING(err);
+  } else {
+    for (auto &R : S->StagedRetrieves)
+      memcpy(R.HstPtr, R.StagingPtr, R.Size);
+  }
+
+  DeviceInfo.returnStream(device_id, S);
+  async_info->Queue = NULL;
+  return err == CUDA_SUCCESS ? OFFLOAD_SUCCESS : OFFLOAD_FAIL;
+}
+
 int32_t __tgt_rtl_data_delete(int32_t device_id, void *tgt_ptr) {
   // Set the context we are using.
   CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
@@ -657,9 +861,10 @@ int32_t __tgt_rtl_data_delete(int32_t device_id, void *tgt_ptr) {
   return OFFLOAD_SUCCESS;
 }
 
-int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
-    void **tgt_args, ptrdiff_t *tgt_offsets, int32_t arg_num, int32_t team_num,
-    int32_t thread_limit, uint64_t loop_tripcount) {
+int32_t __tgt_rtl_run_target_team_region_async(int32_t device_id,
+    void *tgt_entry_ptr, void **tgt_args, ptrdiff_t *tgt_offsets,
+    int32_t arg_num, int32_t team_num, int32_t thread_limit,
+    uint64_t loop_tripcount, __tgt_async_info *async_info) {
   // Set the context we are using.
   CUresult err = cuCtxSetCurrent(DeviceInfo.Contexts[device_id]);
   if (err != CUDA_SUCCESS) {
@@ -668,6 +873,10 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
     return OFFLOAD_FAIL;
   }
 
+  StreamTy *S = getAsyncStream(device_id, async_info);
+  if (!S)
+    return OFFLOAD_FAIL;
+
   // All args are references.
   std::vector<void *> args(arg_num);
   std::vector<void *> ptrs(arg_num);
@@ -755,8 +964,10 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
   DP("Launch kernel with %d blocks and %d threads\n", cudaBlocksPerGrid,
      cudaThreadsPerBlock);
 
+  // The kernel parameters are copied by the launch, args may go away.
   err = cuLaunchKernel(KernelInfo->Func, cudaBlocksPerGrid, 1, 1,
-      cudaThreadsPerBlock, 1, 1, 0 /*bytes of shared memory*/, 0, &args[0], 0);
+      cudaThreadsPerBlock, 1, 1, 0 /*bytes of shared memory*/, S->Stream,
+      &args[0], 0);
   if (err != CUDA_SUCCESS) {
     DP("Device kernel launch failed!\n");
     CUDA_ERR_STRING(err);
@@ -766,16 +977,35 @@ int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
   DP("Launch of entry point at " DPxMOD " successful!\n",
       DPxPTR(tgt_entry_ptr));
 
-  CUresult sync_err = cuCtxSynchronize();
-  if (sync_err != CUDA_SUCCESS) {
+  return OFFLOAD_SUCCESS;
+}
+
+int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
+    void **tgt_args, ptrdiff_t *tgt_offsets, int32_t arg_num, int32_t team_num,
+    int32_t thread_limit, uint64_t loop_tripcount) {
+  // Only wait for this kernel, not for everything running in the context.
+  __tgt_async_info async_info = {};
+  int32_t rc = __tgt_rtl_run_target_team_region_async(device_id, tgt_entry_ptr,
+      tgt_args, tgt_offsets, arg_num, team_num, thread_limit, loop_tripcount,
+      &async_info);
+  if (__tgt_rtl_synchronize(device_id, &async_info) != OFFLOAD_SUCCESS)
+    rc = OFFLOAD_FAIL;
+  if (rc != OFFLOAD_SUCCESS) {
     DP("Kernel execution error at " DPxMOD "!\n", DPxPTR(tgt_entry_ptr));
-    CUDA_ERR_STRING(sync_err);
-    return OFFLOAD_FAIL;
   } else {
     DP("Kernel execution at " DPxMOD " successful!\n", DPxPTR(tgt_entry_ptr));
   }
+  return rc;
+}
 
-  return OFFLOAD_SUCCESS;
+int32_t __tgt_rtl_run_target_region_async(int32_t device_id,
+    void *tgt_entry_ptr, void **tgt_args, ptrdiff_t *tgt_offsets,
+    int32_t arg_num, __tgt_async_info *async_info) {
+  // use one team and the default number of threads.
+  const int32_t team_num = 1;
+  const int32_t thread_limit = 0;
+  return __tgt_rtl_run_target_team_region_async(device_id, tgt_entry_ptr,
+      tgt_args, tgt_offsets, arg_num, team_num, thread_limit, 0, async_info);
 }
 
 int32_t __tgt_rtl_run_target_region(int32_t device_id, void *tgt_entry_ptr,
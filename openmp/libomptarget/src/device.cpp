@@ -16,6 +16,7 @@
 
 #include <cassert>
 #include <climits>
+#include <iterator>
 #include <string>
 
 /// Map between Device ID (i.e. openmp device id) and its DeviceTy.
@@ -25,22 +26,22 @@ int DeviceTy::associatePtr(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size) {
   DataMapMtx.lock();
 
   // Check if entry exists
-  for (auto &HT : HostDataToTargetMap) {
-    if ((uintptr_t)HstPtrBegin == HT.HstPtrBegin) {
-      // Mapping already exists
-      bool isValid = HT.HstPtrBegin == (uintptr_t) HstPtrBegin &&
-                     HT.HstPtrEnd == (uintptr_t) HstPtrBegin + Size &&
-                     HT.TgtPtrBegin == (uintptr_t) TgtPtrBegin;
-      DataMapMtx.unlock();
-      if (isValid) {
-        DP("Attempt to re-associate the same device ptr+offset with the same "
-            "host ptr, nothing to do\n");
-        return OFFLOAD_SUCCESS;
-      } else {
-        DP("Not allowed to re-associate a different device ptr+offset with the "
-            "same host ptr\n");
-        return OFFLOAD_FAIL;
-      }
+  auto search = HostDataToTargetMap.find((uintptr_t)HstPtrBegin);
+  if (search != HostDataToTargetMap.end()) {
+    auto &HT = *search;
+    // Mapping already exists
+    bool isValid = HT.HstPtrBegin == (uintptr_t) HstPtrBegin &&
+                   HT.HstPtrEnd == (uintptr_t) HstPtrBegin + Size &&
+                   HT.TgtPtrBegin == (uintptr_t) TgtPtrBegin;
+    DataMapMtx.unlock();
+    if (isValid) {
+      DP("Attempt to re-associate the same device ptr+offset with the same "
+          "host ptr, nothing to do\n");
+      return OFFLOAD_SUCCESS;
+    } else {
+      DP("Not allowed to re-associate a different device ptr+offset with the "
+          "same host ptr\n");
+      return OFFLOAD_FAIL;
     }
   }
 
@@ -59,7 +60,7 @@ int DeviceTy::associatePtr(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size) {
       DPxMOD ", TgtBegin=" DPxMOD "\n", DPxPTR(newEntry.HstPtrBase),
       DPxPTR(newEntry.HstPtrBegin), DPxPTR(newEntry.HstPtrEnd),
       DPxPTR(newEntry.TgtPtrBegin));
-  HostDataToTargetMap.push_front(newEntry);
+  insertMapping(newEntry);
 
   DataMapMtx.unlock();
 
@@ -70,20 +71,17 @@ int DeviceTy::disassociatePtr(void *HstPtrBegin) {
   DataMapMtx.lock();
 
   // Check if entry exists
-  for (HostDataToTargetListTy::iterator ii = HostDataToTargetMap.begin();
-      ii != HostDataToTargetMap.end(); ++ii) {
-    if ((uintptr_t)HstPtrBegin == ii->HstPtrBegin) {
-      // Mapping exists
-      if (CONSIDERED_INF(ii->RefCount)) {
-        DP("Association found, removing it\n");
-        HostDataToTargetMap.erase(ii);
-        DataMapMtx.unlock();
-        return OFFLOAD_SUCCESS;
-      } else {
-        DP("Trying to disassociate a pointer which was not mapped via "
-            "omp_target_associate_ptr\n");
-        break;
-      }
+  auto search = HostDataToTargetMap.find((uintptr_t)HstPtrBegin);
+  if (search != HostDataToTargetMap.end()) {
+    // Mapping exists
+    if (CONSIDERED_INF(search->RefCount)) {
+      DP("Association found, removing it\n");
+      HostDataToTargetMap.erase(search);
+      DataMapMtx.unlock();
+      return OFFLOAD_SUCCESS;
+    } else {
+      DP("Trying to disassociate a pointer which was not mapped via "
+          "omp_target_associate_ptr\n");
     }
   }
 
@@ -98,15 +96,16 @@ long DeviceTy::getMapEntryRefCnt(void *HstPtrBegin) {
   uintptr_t hp = (uintptr_t)HstPtrBegin;
   long RefCnt = -1;
 
-  DataMapMtx.lock();
-  for (auto &HT : HostDataToTargetMap) {
-    if (hp >= HT.HstPtrBegin && hp < HT.HstPtrEnd) {
+  DataMapMtx.lock_shared();
+  auto upper = HostDataToTargetMap.upper_bound(hp);
+  if (upper != HostDataToTargetMap.begin()) {
+    auto &HT = *std::prev(upper);
+    if (hp < HT.HstPtrEnd) {
       DP("DeviceTy::getMapEntry: requested entry found\n");
       RefCnt = HT.RefCount;
-      break;
     }
   }
-  DataMapMtx.unlock();
+  DataMapMtx.unlock_shared();
 
   if (RefCnt < 0) {
     DP("DeviceTy::getMapEntry: requested entry not found\n");
@@ -121,21 +120,26 @@ LookupResult DeviceTy::lookupMapping(void *HstPtrBegin, int64_t Size) {
 
   DP("Looking up mapping(HstPtrBegin=" DPxMOD ", Size=%ld)...\n", DPxPTR(hp),
       Size);
-  for (lr.Entry = HostDataToTargetMap.begin();
-      lr.Entry != HostDataToTargetMap.end(); ++lr.Entry) {
+#ifdef OMPTARGET_DEBUG
+  MapStats.Lookups.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+  // The only entries the section can touch are the last one that begins at
+  // or before hp, and the first one that begins after it.
+  auto upper = HostDataToTargetMap.upper_bound(hp);
+  if (upper != HostDataToTargetMap.begin()) {
+    lr.Entry = std::prev(upper);
     auto &HT = *lr.Entry;
     // Is it contained?
-    lr.Flags.IsContained = hp >= HT.HstPtrBegin && hp < HT.HstPtrEnd &&
-        (hp+Size) <= HT.HstPtrEnd;
-    // Does it extend into an already mapped region?
-    lr.Flags.ExtendsBefore = hp < HT.HstPtrBegin && (hp+Size) > HT.HstPtrBegin;
+    lr.Flags.IsContained = hp < HT.HstPtrEnd && (hp+Size) <= HT.HstPtrEnd;
     // Does it extend beyond the mapped region?
     lr.Flags.ExtendsAfter = hp < HT.HstPtrEnd && (hp+Size) > HT.HstPtrEnd;
-
-    if (lr.Flags.IsContained || lr.Flags.ExtendsBefore ||
-        lr.Flags.ExtendsAfter) {
-      break;
-    }
+  }
+  if (!lr.Flags.IsContained && !lr.Flags.ExtendsAfter) {
+    lr.Entry = upper;
+    // Does it extend into an already mapped region?
+    lr.Flags.ExtendsBefore = upper != HostDataToTargetMap.end() &&
+        (hp+Size) > upper->HstPtrBegin;
   }
 
   if (lr.Flags.ExtendsBefore) {
@@ -150,6 +154,15 @@ LookupResult DeviceTy::lookupMapping(void *HstPtrBegin, int64_t Size) {
   return lr;
 }
 
+// Add an entry to the mapping table, which must be locked exclusively.
+void DeviceTy::insertMapping(const HostDataToTargetTy &Entry) {
+  HostDataToTargetMap.insert(Entry);
+#ifdef OMPTARGET_DEBUG
+  if (HostDataToTargetMap.size() > MapStats.PeakEntries)
+    MapStats.PeakEntries = HostDataToTargetMap.size();
+#endif
+}
+
 // Used by target_data_begin
 // Return the target pointer begin (where the data will be moved).
 // Allocate memory if this is the first occurrence of this mapping.
@@ -206,7 +219,7 @@ void *DeviceTy::getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase,
       DP("Creating new map entry: HstBase=" DPxMOD ", HstBegin=" DPxMOD ", "
          "HstEnd=" DPxMOD ", TgtBegin=" DPxMOD "\n", DPxPTR(HstPtrBase),
          DPxPTR(HstPtrBegin), DPxPTR((uintptr_t)HstPtrBegin + Size), DPxPTR(tp));
-      HostDataToTargetMap.push_front(HostDataToTargetTy((uintptr_t)HstPtrBase,
+      insertMapping(HostDataToTargetTy((uintptr_t)HstPtrBase,
           (uintptr_t)HstPtrBegin, (uintptr_t)HstPtrBegin + Size, tp));
       rc = (void *)tp;
     }
@@ -224,7 +237,10 @@ void *DeviceTy::getTgtPtrBegin(void *HstPtrBegin, int64_t Size, bool &IsLast,
   void *rc = NULL;
   IsHostPtr = false;
   IsLast = false;
-  DataMapMtx.lock();
+  if (UpdateRefCount)
+    DataMapMtx.lock();
+  else
+    DataMapMtx.lock_shared();
   LookupResult lr = lookupMapping(HstPtrBegin, Size);
 
   if (lr.Flags.IsContained || lr.Flags.ExtendsBefore || lr.Flags.ExtendsAfter) {
@@ -251,7 +267,10 @@ void *DeviceTy::getTgtPtrBegin(void *HstPtrBegin, int64_t Size, bool &IsLast,
     rc = HstPtrBegin;
   }
 
-  DataMapMtx.unlock();
+  if (UpdateRefCount)
+    DataMapMtx.unlock();
+  else
+    DataMapMtx.unlock_shared();
   return rc;
 }
 
@@ -339,19 +358,29 @@ __tgt_target_table *DeviceTy::load_binary(void *Img) {
 
 // Submit data to device.
 int32_t DeviceTy::data_submit(void *TgtPtrBegin, void *HstPtrBegin,
-    int64_t Size) {
+    int64_t Size, __tgt_async_info *AsyncInfoPtr) {
+  if (AsyncInfoPtr && RTL->data_submit_async)
+    return RTL->data_submit_async(RTLDeviceID, TgtPtrBegin, HstPtrBegin, Size,
+        AsyncInfoPtr);
   return RTL->data_submit(RTLDeviceID, TgtPtrBegin, HstPtrBegin, Size);
 }
 
 // Retrieve data from device.
 int32_t DeviceTy::data_retrieve(void *HstPtrBegin, void *TgtPtrBegin,
-    int64_t Size) {
+    int64_t Size, __tgt_async_info *AsyncInfoPtr) {
+  if (AsyncInfoPtr && RTL->data_retrieve_async)
+    return RTL->data_retrieve_async(RTLDeviceID, HstPtrBegin, TgtPtrBegin,
+        Size, AsyncInfoPtr);
   return RTL->data_retrieve(RTLDeviceID, HstPtrBegin, TgtPtrBegin, Size);
 }
 
 // Run region on device
 int32_t DeviceTy::run_region(void *TgtEntryPtr, void **TgtVarsPtr,
-    ptrdiff_t *TgtOffsets, int32_t TgtVarsSize) {
+    ptrdiff_t *TgtOffsets, int32_t TgtVarsSize,
+    __tgt_async_info *AsyncInfoPtr) {
+  if (AsyncInfoPtr && RTL->run_region_async)
+    return RTL->run_region_async(RTLDeviceID, TgtEntryPtr, TgtVarsPtr,
+        TgtOffsets, TgtVarsSize, AsyncInfoPtr);
   return RTL->run_region(RTLDeviceID, TgtEntryPtr, TgtVarsPtr, TgtOffsets,
       TgtVarsSize);
 }
@@ -359,11 +388,24 @@ int32_t DeviceTy::run_region(void *TgtEntryPtr, void **TgtVarsPtr,
 // Run team region on device.
 int32_t DeviceTy::run_team_region(void *TgtEntryPtr, void **TgtVarsPtr,
     ptrdiff_t *TgtOffsets, int32_t TgtVarsSize, int32_t NumTeams,
-    int32_t ThreadLimit, uint64_t LoopTripCount) {
+    int32_t ThreadLimit, uint64_t LoopTripCount,
+    __tgt_async_info *AsyncInfoPtr) {
+  if (AsyncInfoPtr && RTL->run_team_region_async)
+    return RTL->run_team_region_async(RTLDeviceID, TgtEntryPtr, TgtVarsPtr,
+        TgtOffsets, TgtVarsSize, NumTeams, ThreadLimit, LoopTripCount,
+        AsyncInfoPtr);
   return RTL->run_team_region(RTLDeviceID, TgtEntryPtr, TgtVarsPtr, TgtOffsets,
       TgtVarsSize, NumTeams, ThreadLimit, LoopTripCount);
 }
 
+// Wait for the operations queued on AsyncInfoPtr. Nothing has been queued if
+// the RTL is synchronous or no operation has been issued yet.
+int32_t DeviceTy::synchronize(__tgt_async_info *AsyncInfoPtr) {
+  if (RTL->synchronize && AsyncInfoPtr && AsyncInfoPtr->Queue)
+    return RTL->synchronize(RTLDeviceID, AsyncInfoPtr);
+  return OFFLOAD_SUCCESS;
+}
+
 /// Check whether a device has an associated RTL and initialize it if it's not
 /// already initialized.
 bool device_is_ready(int device_num) {
@@ -13,15 +13,19 @@
 #ifndef _OMPTARGET_DEVICE_H
 #define _OMPTARGET_DEVICE_H
 
+#include <atomic>
 #include <cstddef>
 #include <climits>
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
+#include <shared_mutex>
 #include <vector>
 
 // Forward declarations.
 struct RTLInfoTy;
+struct __tgt_async_info;
 struct __tgt_bin_desc;
 struct __tgt_target_table;
 
@@ -36,7 +40,9 @@ struct HostDataToTargetTy {
 
   uintptr_t TgtPtrBegin; // target info.
 
-  long RefCount;
+  // Entries are kept sorted on HstPtrBegin; the ref count is the only part
+  // updated in place.
+  mutable long RefCount;
 
   HostDataToTargetTy()
       : HstPtrBase(0), HstPtrBegin(0), HstPtrEnd(0),
@@ -50,7 +56,39 @@ struct HostDataToTargetTy {
         TgtPtrBegin(TB), RefCount(RF) {}
 };
 
-typedef std::list<HostDataToTargetTy> HostDataToTargetListTy;
+inline bool operator<(const HostDataToTargetTy &lhs, const uintptr_t &rhs) {
+  return lhs.HstPtrBegin < rhs;
+}
+
+inline bool operator<(const uintptr_t &lhs, const HostDataToTargetTy &rhs) {
+  return lhs < rhs.HstPtrBegin;
+}
+
+inline bool operator<(const HostDataToTargetTy &lhs,
+                      const HostDataToTargetTy &rhs) {
+  return lhs.HstPtrBegin < rhs.HstPtrBegin;
+}
+
+/// Mapped regions never overlap, so the entries sorted on HstPtrBegin are
+/// sorted on HstPtrEnd as well, and a lookup only has to look at the entries
+/// on either side of an address.
+typedef std::set<HostDataToTargetTy, std::less<>> HostDataToTargetListTy;
+
+/// Statistics on the use of a device's mapping table. They are only collected
+/// in debug builds, and reported when an image is unregistered from the device.
+struct MappingStatsTy {
+  std::atomic<uint64_t> Lookups;
+  size_t PeakEntries;
+
+  MappingStatsTy() : Lookups(0), PeakEntries(0) {}
+  MappingStatsTy(const MappingStatsTy &s)
+      : Lookups(s.Lookups.load()), PeakEntries(s.PeakEntries) {}
+  MappingStatsTy &operator=(const MappingStatsTy &s) {
+    Lookups = s.Lookups.load();
+    PeakEntries = s.PeakEntries;
+    return *this;
+  }
+};
 
 struct LookupResult {
   struct {
@@ -90,11 +128,14 @@ struct DeviceTy {
   bool HasPendingGlobals;
 
   HostDataToTargetListTy HostDataToTargetMap;
+  MappingStatsTy MapStats;
   PendingCtorsDtorsPerLibrary PendingCtorsDtors;
 
   ShadowPtrListTy ShadowPtrMap;
 
-  std::mutex DataMapMtx, PendingGlobalsMtx, ShadowMtx;
+  // Lookups that leave the ref counts alone only take DataMapMtx shared.
+  std::shared_timed_mutex DataMapMtx;
+  std::mutex PendingGlobalsMtx, ShadowMtx;
 
   // NOTE: Once libomp gains full target-task support, this state should be
   // moved into the target task in libomp.
@@ -102,7 +143,8 @@ struct DeviceTy {
 
   DeviceTy(RTLInfoTy *RTL)
       : DeviceID(-1), RTL(RTL), RTLDeviceID(-1), IsInit(false), InitFlag(),
-        HasPendingGlobals(false), HostDataToTargetMap(), PendingCtorsDtors(),
+        HasPendingGlobals(false), HostDataToTargetMap(), MapStats(),
+        PendingCtorsDtors(),
         ShadowPtrMap(), DataMapMtx(), PendingGlobalsMtx(), ShadowMtx() {}
 
   // The existence of mutexes makes DeviceTy non-copyable. We need to
@@ -110,7 +152,7 @@ struct DeviceTy {
   DeviceTy(const DeviceTy &d)
       : DeviceID(d.DeviceID), RTL(d.RTL), RTLDeviceID(d.RTLDeviceID),
         IsInit(d.IsInit), InitFlag(), HasPendingGlobals(d.HasPendingGlobals),
-        HostDataToTargetMap(d.HostDataToTargetMap),
+        HostDataToTargetMap(d.HostDataToTargetMap), MapStats(d.MapStats),
         PendingCtorsDtors(d.PendingCtorsDtors), ShadowPtrMap(d.ShadowPtrMap),
         DataMapMtx(), PendingGlobalsMtx(), ShadowMtx(),
         LoopTripCnt(d.LoopTripCnt) {}
@@ -122,6 +164,7 @@ struct DeviceTy {
     IsInit = d.IsInit;
     HasPendingGlobals = d.HasPendingGlobals;
     HostDataToTargetMap = d.HostDataToTargetMap;
+    MapStats = d.MapStats;
     PendingCtorsDtors = d.PendingCtorsDtors;
     ShadowPtrMap = d.ShadowPtrMap;
     LoopTripCnt = d.LoopTripCnt;
@@ -131,6 +174,7 @@ struct DeviceTy {
 
   long getMapEntryRefCnt(void *HstPtrBegin);
   LookupResult lookupMapping(void *HstPtrBegin, int64_t Size);
+  void insertMapping(const HostDataToTargetTy &Entry);
   void *getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase, int64_t Size,
       bool &IsNew, bool &IsHostPtr, bool IsImplicit, bool UpdateRefCount = true,
       bool HasCloseModifier = false);
@@ -146,14 +190,22 @@ struct DeviceTy {
   int32_t initOnce();
   __tgt_target_table *load_binary(void *Img);
 
-  int32_t data_submit(void *TgtPtrBegin, void *HstPtrBegin, int64_t Size);
-  int32_t data_retrieve(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size);
+  // With an AsyncInfo the operation is queued on it if the RTL supports
+  // asynchronous execution, and is only complete after synchronize().
+  int32_t data_submit(void *TgtPtrBegin, void *HstPtrBegin, int64_t Size,
+      __tgt_async_info *AsyncInfoPtr = nullptr);
+  int32_t data_retrieve(void *HstPtrBegin, void *TgtPtrBegin, int64_t Size,
+      __tgt_async_info *AsyncInfoPtr = nullptr);
 
   int32_t run_region(void *TgtEntryPtr, void **TgtVarsPtr,
-      ptrdiff_t *TgtOffsets, int32_t TgtVarsSize);
+      ptrdiff_t *TgtOffsets, int32_t TgtVarsSize,
+      __tgt_async_info *AsyncInfoPtr = nullptr);
   int32_t run_team_region(void *TgtEntryPtr, void **TgtVarsPtr,
       ptrdiff_t *TgtOffsets, int32_t TgtVarsSize, int32_t NumTeams,
-      int32_t ThreadLimit, uint64_t LoopTripCount);
+      int32_t ThreadLimit, uint64_t LoopTripCount,
+      __tgt_async_info *AsyncInfoPtr = nullptr);
+
+  int32_t synchronize(__tgt_async_info *AsyncInfoPtr);
 
 private:
   // Call to RTL
@@ -118,8 +118,11 @@ EXTERN void __tgt_target_data_begin(int64_t device_id, int32_t arg_num,
   }
 #endif
 
+  __tgt_async_info AsyncInfo = {};
   int rc = target_data_begin(Device, arg_num, args_base,
-      args, arg_sizes, arg_types);
+      args, arg_sizes, arg_types, &AsyncInfo);
+  if (Device.synchronize(&AsyncInfo) != OFFLOAD_SUCCESS)
+    rc = OFFLOAD_FAIL;
   HandleTargetOutcome(rc == OFFLOAD_SUCCESS);
 }
 
@@ -171,8 +174,11 @@ EXTERN void __tgt_target_data_end(int64_t device_id, int32_t arg_num,
   }
 #endif
 
+  __tgt_async_info AsyncInfo = {};
   int rc = target_data_end(Device, arg_num, args_base,
-      args, arg_sizes, arg_types);
+      args, arg_sizes, arg_types, &AsyncInfo);
+  if (Device.synchronize(&AsyncInfo) != OFFLOAD_SUCCESS)
+    rc = OFFLOAD_FAIL;
   HandleTargetOutcome(rc == OFFLOAD_SUCCESS);
 }
 
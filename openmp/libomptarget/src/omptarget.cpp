@@ -134,7 +134,7 @@ static int InitLibrary(DeviceTy& Device) {
         DP("Add mapping from host " DPxMOD " to device " DPxMOD " with size %zu"
             "\n", DPxPTR(CurrHostEntry->addr), DPxPTR(CurrDeviceEntry->addr),
             CurrDeviceEntry->size);
-        Device.HostDataToTargetMap.push_front(HostDataToTargetTy(
+        Device.insertMapping(HostDataToTargetTy(
             (uintptr_t)CurrHostEntry->addr /*HstPtrBase*/,
             (uintptr_t)CurrHostEntry->addr /*HstPtrBegin*/,
             (uintptr_t)CurrHostEntry->addr + CurrHostEntry->size /*HstPtrEnd*/,
@@ -209,9 +209,23 @@ static int32_t member_of(int64_t type) {
   return ((type & OMP_TGT_MAPTYPE_MEMBER_OF) >> 48) - 1;
 }
 
-/// Internal function to do the mapping and transfer the data to the device
+// Copy a value that lives on the caller's stack to the device. It is queued
+// on AsyncInfo so that it lands after the copies already queued there, which
+// may cover the same target memory, and it is waited for since the value is
+// gone by the time the caller synchronizes.
+static int submitStackValue(DeviceTy &Device, void *TgtPtrBegin,
+    void *HstPtrBegin, int64_t Size, __tgt_async_info *AsyncInfo) {
+  int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, Size, AsyncInfo);
+  if (rt != OFFLOAD_SUCCESS)
+    return rt;
+  return Device.synchronize(AsyncInfo);
+}
+
+/// Internal function to do the mapping and transfer the data to the device.
+/// With an AsyncInfo the transfers may still be in flight on return.
 int target_data_begin(DeviceTy &Device, int32_t arg_num,
-    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types) {
+    void **args_base, void **args, int64_t *arg_sizes, int64_t *arg_types,
+    __tgt_async_info *AsyncInfo) {
   // process each input.
   for (int32_t i = 0; i < arg_num; ++i) {
     // Ignore private variables and arrays - there is no mapping for them.
@@ -312,7 +326,8 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
       if (copy && !IsHostPtr) {
         DP("Moving %" PRId64 " bytes (hst:" DPxMOD ") -> (tgt:" DPxMOD ")\n",
             data_size, DPxPTR(HstPtrBegin), DPxPTR(TgtPtrBegin));
-        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, data_size);
+        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, data_size,
+            AsyncInfo);
         if (rt != OFFLOAD_SUCCESS) {
           DP("Copying data to device failed.\n");
           return OFFLOAD_FAIL;
@@ -325,8 +340,8 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
           DPxPTR(Pointer_TgtPtrBegin), DPxPTR(TgtPtrBegin));
       uint64_t Delta = (uint64_t)HstPtrBegin - (uint64_t)HstPtrBase;
       void *TgtPtrBase = (void *)((uint64_t)TgtPtrBegin - Delta);
-      int rt = Device.data_submit(Pointer_TgtPtrBegin, &TgtPtrBase,
-          sizeof(void *));
+      int rt = submitStackValue(Device, Pointer_TgtPtrBegin, &TgtPtrBase,
+          sizeof(void *), AsyncInfo);
       if (rt != OFFLOAD_SUCCESS) {
         DP("Copying data to device failed.\n");
         return OFFLOAD_FAIL;
@@ -343,8 +358,10 @@ int target_data_begin(DeviceTy &Device, int32_t arg_num,
 }
 
 /// Internal function to undo the mapping and retrieve the data from the device.
+/// With an AsyncInfo the retrieved data is only valid once it is synchronized.
 int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
-    void **args, int64_t *arg_sizes, int64_t *arg_types) {
+    void **args, int64_t *arg_sizes, int64_t *arg_types,
+    __tgt_async_info *AsyncInfo) {
   // process each input.
   for (int32_t i = arg_num - 1; i >= 0; --i) {
     // Ignore private variables and arrays - there is no mapping for them.
@@ -415,7 +432,8 @@ int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
               TgtPtrBegin == HstPtrBegin)) {
           DP("Moving %" PRId64 " bytes (tgt:" DPxMOD ") -> (hst:" DPxMOD ")\n",
               data_size, DPxPTR(TgtPtrBegin), DPxPTR(HstPtrBegin));
-          int rt = Device.data_retrieve(HstPtrBegin, TgtPtrBegin, data_size);
+          int rt = Device.data_retrieve(HstPtrBegin, TgtPtrBegin, data_size,
+              AsyncInfo);
           if (rt != OFFLOAD_SUCCESS) {
             DP("Copying data from device failed.\n");
             return OFFLOAD_FAIL;
@@ -429,6 +447,19 @@ int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
       // shadow pointer entries for this struct.
       uintptr_t lb = (uintptr_t) HstPtrBegin;
       uintptr_t ub = (uintptr_t) HstPtrBegin + data_size;
+      // The pointers can only be restored once the struct has arrived.
+      if (arg_types[i] & OMP_TGT_MAPTYPE_FROM) {
+        Device.ShadowMtx.lock();
+        ShadowPtrListTy::iterator it =
+            Device.ShadowPtrMap.lower_bound((void *) lb);
+        bool HasShadowPtrs = it != Device.ShadowPtrMap.end() &&
+            (uintptr_t) it->first < ub;
+        Device.ShadowMtx.unlock();
+        if (HasShadowPtrs && Device.synchronize(AsyncInfo) != OFFLOAD_SUCCESS) {
+          DP("Copying data from device failed.\n");
+          return OFFLOAD_FAIL;
+        }
+      }
       Device.ShadowMtx.lock();
       for (ShadowPtrListTy::iterator it = Device.ShadowPtrMap.begin();
            it != Device.ShadowPtrMap.end();) {
@@ -460,8 +491,12 @@ int target_data_end(DeviceTy &Device, int32_t arg_num, void **args_base,
       }
       Device.ShadowMtx.unlock();
 
-      // Deallocate map
+      // Deallocate map, once nothing queued can still access it.
       if (DelEntry) {
+        if (Device.synchronize(AsyncInfo) != OFFLOAD_SUCCESS) {
+          DP("Copying data from device failed.\n");
+          return OFFLOAD_FAIL;
+        }
         int rt = Device.deallocTgtPtr(HstPtrBegin, data_size, ForceDelete,
                                       HasCloseModifier);
         if (rt != OFFLOAD_SUCCESS) {
@@ -633,11 +668,16 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
   TrlTblMtx.unlock();
   assert(TargetTable && "Global data has not been mapped\n");
 
+  // The transfers and the launch are all queued on AsyncInfo, which is
+  // synchronized before returning, on success or failure alike.
+  __tgt_async_info AsyncInfo = {};
+
   // Move data to device.
   int rc = target_data_begin(Device, arg_num, args_base, args, arg_sizes,
-      arg_types);
+      arg_types, &AsyncInfo);
   if (rc != OFFLOAD_SUCCESS) {
     DP("Call to target_data_begin failed, abort target.\n");
+    Device.synchronize(&AsyncInfo);
     return OFFLOAD_FAIL;
   }
 
@@ -685,10 +725,11 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
         }
         DP("Update lambda reference (" DPxMOD ") -> [" DPxMOD "]\n",
            DPxPTR(Pointer_TgtPtrBegin), DPxPTR(TgtPtrBegin));
-        int rt = Device.data_submit(TgtPtrBegin, &Pointer_TgtPtrBegin,
-                                    sizeof(void *));
+        int rt = submitStackValue(Device, TgtPtrBegin, &Pointer_TgtPtrBegin,
+                                  sizeof(void *), &AsyncInfo);
         if (rt != OFFLOAD_SUCCESS) {
           DP("Copying data to device failed.\n");
+          Device.synchronize(&AsyncInfo);
           return OFFLOAD_FAIL;
         }
       }
@@ -713,6 +754,7 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
             "abort target.\n",
             (arg_types[i] & OMP_TGT_MAPTYPE_TO ? "first-" : ""),
             DPxPTR(HstPtrBegin));
+        Device.synchronize(&AsyncInfo);
         return OFFLOAD_FAIL;
       }
       fpArrays.push_back(TgtPtrBegin);
@@ -727,9 +769,11 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
 #endif
       // If first-private, copy data from host
       if (arg_types[i] & OMP_TGT_MAPTYPE_TO) {
-        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, arg_sizes[i]);
+        int rt = Device.data_submit(TgtPtrBegin, HstPtrBegin, arg_sizes[i],
+            &AsyncInfo);
         if (rt != OFFLOAD_SUCCESS) {
           DP ("Copying data to device failed, failed.\n");
+          Device.synchronize(&AsyncInfo);
           return OFFLOAD_FAIL;
         }
       }
@@ -776,13 +820,31 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
   if (IsTeamConstruct) {
     rc = Device.run_team_region(TargetTable->EntriesBegin[TM->Index].addr,
         &tgt_args[0], &tgt_offsets[0], tgt_args.size(), team_num,
-        thread_limit, ltc);
+        thread_limit, ltc, &AsyncInfo);
   } else {
     rc = Device.run_region(TargetTable->EntriesBegin[TM->Index].addr,
-        &tgt_args[0], &tgt_offsets[0], tgt_args.size());
+        &tgt_args[0], &tgt_offsets[0], tgt_args.size(), &AsyncInfo);
   }
   if (rc != OFFLOAD_SUCCESS) {
     DP ("Executing target region abort target.\n");
+    Device.synchronize(&AsyncInfo);
+    return OFFLOAD_FAIL;
+  }
+
+  // Move data from device.
+  int rt = target_data_end(Device, arg_num, args_base, args, arg_sizes,
+      arg_types, &AsyncInfo);
+  if (rt != OFFLOAD_SUCCESS) {
+    DP("Call to target_data_end failed, abort targe.\n");
+    Device.synchronize(&AsyncInfo);
+    return OFFLOAD_FAIL;
+  }
+
+  // Wait for the region and the transfers; failures in the region itself
+  // show up here.
+  rt = Device.synchronize(&AsyncInfo);
+  if (rt != OFFLOAD_SUCCESS) {
+    DP("Executing target region abort target.\n");
     return OFFLOAD_FAIL;
   }
 
@@ -795,13 +857,5 @@ int target(int64_t device_id, void *host_ptr, int32_t arg_num,
     }
   }
 
-  // Move data from device.
-  int rt = target_data_end(Device, arg_num, args_base, args, arg_sizes,
-      arg_types);
-  if (rt != OFFLOAD_SUCCESS) {
-    DP("Call to target_data_end failed, abort targe.\n");
-    return OFFLOAD_FAIL;
-  }
-
   return OFFLOAD_SUCCESS;
 }
@@ -111,6 +111,29 @@ void RTLsTy::LoadRTLs() {
     *((void**) &R.init_requires) = dlsym(
         dynlib_handle, "__tgt_rtl_init_requires");
 
+    // The asynchronous interface is only used if the plugin provides all of
+    // it; otherwise every operation goes through the synchronous functions.
+    *((void**) &R.data_submit_async) = dlsym(
+        dynlib_handle, "__tgt_rtl_data_submit_async");
+    *((void**) &R.data_retrieve_async) = dlsym(
+        dynlib_handle, "__tgt_rtl_data_retrieve_async");
+    *((void**) &R.run_region_async) = dlsym(
+        dynlib_handle, "__tgt_rtl_run_target_region_async");
+    *((void**) &R.run_team_region_async) = dlsym(
+        dynlib_handle, "__tgt_rtl_run_target_team_region_async");
+    *((void**) &R.synchronize) = dlsym(
+        dynlib_handle, "__tgt_rtl_synchronize");
+    if (!R.data_submit_async || !R.data_retrieve_async ||
+        !R.run_region_async || !R.run_team_region_async || !R.synchronize) {
+      R.data_submit_async = 0;
+      R.data_retrieve_async = 0;
+      R.run_region_async = 0;
+      R.run_team_region_async = 0;
+      R.synchronize = 0;
+    } else {
+      DP("RTL supports asynchronous execution\n");
+    }
+
     // No devices are supported by this RTL?
     if (!(R.NumberOfDevices = R.number_of_devices())) {
       DP("No devices supported in this RTL\n");
@@ -362,6 +385,9 @@ void RTLsTy::UnregisterLib(__tgt_bin_desc *desc) {
           Device.PendingCtorsDtors.erase(desc);
         }
         Device.PendingGlobalsMtx.unlock();
+        DP("Device %d mapping table: %" PRIu64 " lookups, at most %zu "
+            "entries\n", Device.DeviceID, Device.MapStats.Lookups.load(),
+            Device.MapStats.PeakEntries);
       }
 
       DP("Unregistered image " DPxMOD " from RTL " DPxMOD "!\n",
@@ -412,7 +412,9 @@ enum sched_type : kmp_int32 {
      modifier, nonmonotonic modifier), we need separate bits for each modifier.
      The absence of monotonic does not imply nonmonotonic, especially since 4.5
      says that the behaviour of the "no modifier" case is implementation defined
-     in 4.5, but will become "nonmonotonic" in 5.0.
+     in 4.5, but will become "nonmonotonic" in 5.0. We follow 5.0: a dynamic
+     schedule without modifiers is treated as nonmonotonic unless the loop is
+     ordered or KMP_FORCE_MONOTONIC_DYNAMIC_SCHEDULE is set.
 
      Since we're passing a full 32 bit value, we can use a couple of high bits
      for these flags; out of paranoia we avoid the sign bit.
@@ -788,6 +790,7 @@ extern int __kmp_affinity_respect_mask; // Respect process' init affinity mask?
 extern char *__kmp_affinity_proclist; /* proc ID list */
 extern kmp_affin_mask_t *__kmp_affinity_masks;
 extern unsigned __kmp_affinity_num_masks;
+extern int *__kmp_affinity_place_pkgs; /* package of each mask, or NULL */
 extern void __kmp_affinity_bind_thread(int which);
 
 extern kmp_affin_mask_t *__kmp_affin_fullMask;
@@ -2062,6 +2065,8 @@ extern kmp_tasking_mode_t
     __kmp_tasking_mode; /* determines how/when to execute tasks */
 extern int __kmp_task_stealing_constraint;
 extern int __kmp_enable_task_throttling;
+extern int __kmp_region_stats; /* KMP_REGION_STATS */
+extern int __kmp_force_monotonic; /* KMP_FORCE_MONOTONIC_DYNAMIC_SCHEDULE */
 extern kmp_int32 __kmp_default_device; // Set via OMP_DEFAULT_DEVICE if
 // specified, defaults to 0 otherwise
 // Set via OMP_MAX_TASK_PRIORITY if specified, defaults to 0 otherwise
@@ -2416,6 +2421,19 @@ typedef struct kmp_cg_root {
 
 // OpenMP thread data structures
 
+/* Counters a thread keeps for the parallel region it is running when
+   KMP_REGION_STATS is set. The master adds them up at the join barrier, into
+   the statistics of the region in its kmp_region_stats_t, and clears those of
+   the workers; its own are compared with a copy taken at the fork, so that
+   they stay valid for an enclosing region. */
+typedef struct kmp_region_counters {
+  kmp_uint64 arrive; /* arrival at the join barrier */
+  kmp_uint64 barrier; /* time spent in barriers inside the region */
+  kmp_uint64 tasks; /* explicit tasks executed */
+} kmp_region_counters_t;
+
+typedef struct kmp_region_stats kmp_region_stats_t;
+
 typedef struct KMP_ALIGN_CACHE kmp_base_info {
   /* Start with the readonly data which is cache aligned and padded. This is
      written before the thread starts working by the master. Uber masters may
@@ -2469,6 +2487,8 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
 #endif
   int th_prev_level; /* previous level for affinity format */
   int th_prev_num_threads; /* previous num_threads for affinity format */
+  kmp_region_counters_t th_region_counters;
+  kmp_region_stats_t *th_region_stats; /* regions this thread was master of */
 #if USE_ITT_BUILD
   kmp_uint64 th_bar_arrive_time; /* arrival to barrier timestamp */
   kmp_uint64 th_bar_min_time; /* minimum arrival time at the barrier */
@@ -2626,6 +2646,9 @@ typedef struct KMP_ALIGN_CACHE kmp_base_team {
 #if USE_ITT_BUILD
   kmp_uint64 t_region_time; // region begin timestamp
 #endif /* USE_ITT_BUILD */
+  ident_t *t_stats_ident; // region being timed for KMP_REGION_STATS
+  kmp_uint64 t_stats_start; // its fork timestamp
+  kmp_region_counters_t t_stats_master; // master's counters at the fork
 
   // Master write, workers read
   // --------------------------------------------------------------------------
@@ -3484,6 +3507,7 @@ extern void __kmp_join_call(ident_t *loc, int gtid
 extern void __kmp_serialized_parallel(ident_t *id, kmp_int32 gtid);
 extern void __kmp_internal_fork(ident_t *id, int gtid, kmp_team_t *team);
 extern void __kmp_internal_join(ident_t *id, int gtid, kmp_team_t *team);
+extern void __kmp_region_stats_print(void);
 extern int __kmp_invoke_task_func(int gtid);
 extern void __kmp_run_before_invoked_task(int gtid, int tid,
                                           kmp_info_t *this_thr,
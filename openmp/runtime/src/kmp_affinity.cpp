@@ -4612,6 +4612,8 @@ static void __kmp_aux_affinity_initialize(void) {
     }
 
     KMP_CPU_ALLOC_ARRAY(__kmp_affinity_masks, __kmp_affinity_num_masks);
+    __kmp_affinity_place_pkgs =
+        (int *)__kmp_allocate(__kmp_affinity_num_masks * sizeof(int));
 
     // Sort the address2os table according to the current setting of
     // __kmp_affinity_compact, then fill out __kmp_affinity_masks.
@@ -4629,6 +4631,7 @@ static void __kmp_aux_affinity_initialize(void) {
         kmp_affin_mask_t *dest = KMP_CPU_INDEX(__kmp_affinity_masks, j);
         KMP_ASSERT(KMP_CPU_ISSET(osId, src));
         KMP_CPU_COPY(dest, src);
+        __kmp_affinity_place_pkgs[j] = address2os[i].first.labels[0];
         if (++j >= __kmp_affinity_num_masks) {
           break;
         }
@@ -4642,7 +4645,20 @@ static void __kmp_aux_affinity_initialize(void) {
   }
 
   KMP_CPU_FREE_ARRAY(osId2Mask, maxIndex + 1);
-  machine_hierarchy.init(address2os, __kmp_avail_proc);
+
+  // Threads are bound in the sorted order only for the types above that sort
+  // by child number; build the barrier hierarchy in that order too.
+  int hier_compact = 0, hier_skip_levels = 0;
+  if (__kmp_affinity_type == affinity_logical ||
+      __kmp_affinity_type == affinity_physical ||
+      __kmp_affinity_type == affinity_scatter ||
+      __kmp_affinity_type == affinity_compact) {
+    hier_compact = __kmp_affinity_compact;
+    if (!__kmp_affinity_dups && __kmp_affinity_gran_levels < depth)
+      hier_skip_levels = __kmp_affinity_gran_levels;
+  }
+  machine_hierarchy.init(address2os, __kmp_avail_proc, hier_compact,
+                         hier_skip_levels);
 }
 #undef KMP_EXIT_AFF_NONE
 
@@ -4673,6 +4689,10 @@ void __kmp_affinity_uninitialize(void) {
     KMP_CPU_FREE_ARRAY(__kmp_affinity_masks, __kmp_affinity_num_masks);
     __kmp_affinity_masks = NULL;
   }
+  if (__kmp_affinity_place_pkgs != NULL) {
+    __kmp_free(__kmp_affinity_place_pkgs);
+    __kmp_affinity_place_pkgs = NULL;
+  }
   if (__kmp_affin_fullMask != NULL) {
     KMP_CPU_FREE(__kmp_affin_fullMask);
     __kmp_affin_fullMask = NULL;
@@ -657,10 +657,19 @@ public:
   kmp_uint32 *numPerLevel;
   kmp_uint32 *skipPerLevel;
 
-  void deriveLevels(AddrUnsPair *adr2os, int num_addrs) {
+  /* The barrier tree groups consecutive thread ids, so the levels are taken
+     in the order threads are placed on them: with a permute (compact) value of
+     c, the c innermost machine levels vary slowest between consecutive
+     threads. Levels below the affinity granularity are left out when each
+     thread gets a granule of its own (skip_levels). */
+  void deriveLevels(AddrUnsPair *adr2os, int num_addrs, int compact,
+                    int skip_levels) {
     int hier_depth = adr2os[0].first.depth;
     int level = 0;
-    for (int i = hier_depth - 1; i >= 0; --i) {
+    for (int k = 0; k < hier_depth; ++k) {
+      int i = k < hier_depth - compact ? hier_depth - compact - 1 - k : k;
+      if (i >= hier_depth - skip_levels)
+        continue;
       int max = -1;
       for (int j = 0; j < num_addrs; ++j) {
         int next = adr2os[j].first.childNums[i];
@@ -683,7 +692,8 @@ public:
     }
   }
 
-  void init(AddrUnsPair *adr2os, int num_addrs) {
+  void init(AddrUnsPair *adr2os, int num_addrs, int compact = 0,
+            int skip_levels = 0) {
     kmp_int8 bool_result = KMP_COMPARE_AND_STORE_ACQ8(
         &uninitialized, not_initialized, initializing);
     if (bool_result == 0) { // Wait for initialization
@@ -713,7 +723,7 @@ public:
     if (adr2os) {
       qsort(adr2os, num_addrs, sizeof(*adr2os),
             __kmp_affinity_cmp_Address_labels);
-      deriveLevels(adr2os, num_addrs);
+      deriveLevels(adr2os, num_addrs, compact, skip_levels);
     } else {
       numPerLevel[0] = maxLeaves;
       numPerLevel[1] = num_addrs / maxLeaves;
@@ -1585,6 +1585,13 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
 int __kmp_barrier(enum barrier_type bt, int gtid, int is_split,
                   size_t reduce_size, void *reduce_data,
                   void (*reduce)(void *, void *)) {
+  if (UNLIKELY(__kmp_region_stats)) {
+    kmp_uint64 start = KMP_NOW();
+    int status = __kmp_barrier_template<>(bt, gtid, is_split, reduce_size,
+                                          reduce_data, reduce);
+    __kmp_threads[gtid]->th.th_region_counters.barrier += KMP_NOW() - start;
+    return status;
+  }
   return __kmp_barrier_template<>(bt, gtid, is_split, reduce_size, reduce_data,
                                   reduce);
 }
@@ -1675,6 +1682,9 @@ void __kmp_join_barrier(int gtid) {
 #endif /* USE_ITT_BUILD */
   KMP_MB();
 
+  if (UNLIKELY(__kmp_region_stats))
+    this_thr->th.th_region_counters.arrive = KMP_NOW();
+
   // Get current info
   team = this_thr->th.th_team;
   nproc = this_thr->th.th_team_nproc;
@@ -73,9 +73,13 @@ static inline int __kmp_get_monotonicity(enum sched_type schedule,
                                          bool use_hier = false) {
   // Pick up the nonmonotonic/monotonic bits from the scheduling type
   int monotonicity;
-  // default to monotonic
-  monotonicity = SCHEDULE_MONOTONIC;
-  if (SCHEDULE_HAS_NONMONOTONIC(schedule))
+  // default to nonmonotonic, as OpenMP 5.0 does for non-static schedules
+  monotonicity = SCHEDULE_NONMONOTONIC;
+  // hierarchical scheduling has no stealing, and the user may ask for the
+  // pre-5.0 behaviour of shared-counter dynamic loops
+  if (use_hier || __kmp_force_monotonic)
+    monotonicity = SCHEDULE_MONOTONIC;
+  else if (SCHEDULE_HAS_NONMONOTONIC(schedule))
     monotonicity = SCHEDULE_NONMONOTONIC;
   else if (SCHEDULE_HAS_MONOTONIC(schedule))
     monotonicity = SCHEDULE_MONOTONIC;
@@ -178,6 +182,8 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
       // not specified)
       schedule = team->t.t_sched.r_sched_type;
       monotonicity = __kmp_get_monotonicity(schedule, use_hier);
+      if (pr->flags.ordered) // ordered overrides nonmonotonic
+        monotonicity = SCHEDULE_MONOTONIC;
       schedule = SCHEDULE_WITHOUT_MODIFIERS(schedule);
       // Detail the schedule if needed (global controls are differentiated
       // appropriately)
@@ -245,6 +251,8 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
       // compiler provides simd_width in the chunk parameter
       schedule = team->t.t_sched.r_sched_type;
       monotonicity = __kmp_get_monotonicity(schedule, use_hier);
+      if (pr->flags.ordered) // ordered overrides nonmonotonic
+        monotonicity = SCHEDULE_MONOTONIC;
       schedule = SCHEDULE_WITHOUT_MODIFIERS(schedule);
       // Detail the schedule if needed (global controls are differentiated
       // appropriately)
@@ -378,12 +386,22 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
         __kmp_init_lock(th->th.th_dispatch->th_steal_lock);
       }
       break;
+    } else if (nproc > 1) {
+      /* too few chunks to give every thread one: a shared counter hands them
+         out without splitting any of them, and is cheap at this trip count */
+      KD_TRACE(100, ("__kmp_dispatch_init_algorithm: T#%d switching to "
+                     "kmp_sch_dynamic_chunked\n",
+                     gtid));
+      schedule = kmp_sch_dynamic_chunked;
+      if (pr->u.p.parm1 <= 0)
+        pr->u.p.parm1 = KMP_DEFAULT_CHUNK;
+      break;
     } else {
       KD_TRACE(100, ("__kmp_dispatch_init_algorithm: T#%d falling-through to "
                      "kmp_sch_static_balanced\n",
                      gtid));
       schedule = kmp_sch_static_balanced;
-      /* too few iterations: fall-through to kmp_sch_static_balanced */
+      /* single thread: fall-through to kmp_sch_static_balanced */
     } // if
     /* FALL-THROUGH to static balanced */
     KMP_FALLTHROUGH();
@@ -966,8 +984,9 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
   // schedule kind all the parm3 variables will contain the same value. Even if
   // all parm3 will be the same, it still exists a bad case like using 0 and 1
   // rather than program life-time increment. So the dedicated variable is
-  // required. The 'static_steal_counter' is used.
-  if (schedule == kmp_sch_static_steal) {
+  // required. The 'static_steal_counter' is used. Test the schedule chosen
+  // for the loop, not the requested one: nonmonotonic dynamic loops steal too.
+  if (pr->schedule == kmp_sch_static_steal) {
     // Other threads will inspect this variable when searching for a victim.
     // This is a flag showing that other threads may steal from this thread
     // since then.
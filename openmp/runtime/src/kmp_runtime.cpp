@@ -5964,6 +5964,8 @@ static void __kmp_internal_end(void) {
   /* First, unregister the library */
   __kmp_unregister_library();
 
+  __kmp_region_stats_print();
+
 #if KMP_OS_WINDOWS
   /* In Win static library, we can't tell when a root actually dies, so we
      reclaim the data structures for any root threads that have died but not
@@ -7240,6 +7242,186 @@ void __kmp_push_proc_bind(ident_t *id, int gtid, kmp_proc_bind_t proc_bind) {
 
 /* Launch the worker threads into the microtask. */
 
+/* ------------------------------------------------------------------------ */
+// KMP_REGION_STATS: statistics on each parallel region, recorded by the master
+// of every instance of the region into a table of its own, so that no lock is
+// needed. The tables are allocated on a thread's first join, outlive the
+// threads, and are merged and printed at shutdown.
+
+#define KMP_REGION_STATS_BITS 8
+#define KMP_REGION_STATS_SIZE (1 << KMP_REGION_STATS_BITS)
+
+typedef struct kmp_region_stats_entry {
+  ident_t *loc; // only valid if count != 0
+  kmp_uint64 count; // instances of the region
+  kmp_uint64 threads; // sum of their team sizes
+  kmp_uint64 wall; // fork to end of the join barrier
+  kmp_uint64 work; // per thread, fork to arrival at the join barrier
+  kmp_uint64 imbalance; // per thread, arrival to the last arrival
+  kmp_uint64 barrier; // per thread, time in barriers inside the region
+  kmp_uint64 tasks; // explicit tasks executed
+} kmp_region_stats_entry_t;
+
+struct kmp_region_stats {
+  kmp_region_stats_t *next;
+  kmp_region_stats_entry_t other; // regions that did not fit in the table
+  kmp_region_stats_entry_t entries[KMP_REGION_STATS_SIZE];
+};
+
+static kmp_region_stats_t *__kmp_region_stats_list = NULL;
+static kmp_bootstrap_lock_t __kmp_region_stats_lock =
+    KMP_BOOTSTRAP_LOCK_INITIALIZER(__kmp_region_stats_lock);
+
+static kmp_region_stats_entry_t *
+__kmp_region_stats_find(kmp_region_stats_t *stats, ident_t *loc) {
+  kmp_uint64 hash = ((kmp_uint64)(kmp_uintptr_t)loc * 0x9E3779B97F4A7C15ULL) >>
+                    (64 - KMP_REGION_STATS_BITS);
+  for (int i = 0; i < KMP_REGION_STATS_SIZE; ++i) {
+    kmp_region_stats_entry_t *entry =
+        &stats->entries[(hash + i) & (KMP_REGION_STATS_SIZE - 1)];
+    if (entry->count == 0) {
+      entry->loc = loc;
+      return entry;
+    }
+    if (entry->loc == loc)
+      return entry;
+  }
+  return &stats->other;
+}
+
+static void __kmp_region_stats_add(kmp_region_stats_entry_t *to,
+                                   const kmp_region_stats_entry_t *from) {
+  to->count += from->count;
+  to->threads += from->threads;
+  to->wall += from->wall;
+  to->work += from->work;
+  to->imbalance += from->imbalance;
+  to->barrier += from->barrier;
+  to->tasks += from->tasks;
+}
+
+// Called by the master once the whole team has arrived at the join barrier.
+static void __kmp_region_stats_join(kmp_info_t *this_thr, kmp_team_t *team) {
+  kmp_uint64 now = KMP_NOW();
+  kmp_uint64 start = team->t.t_stats_start;
+  int nproc = team->t.t_nproc;
+  kmp_info_t **threads = team->t.t_threads;
+  kmp_region_stats_t *stats = this_thr->th.th_region_stats;
+
+  if (stats == NULL) {
+    stats = (kmp_region_stats_t *)__kmp_allocate(sizeof(kmp_region_stats_t));
+    __kmp_acquire_bootstrap_lock(&__kmp_region_stats_lock);
+    stats->next = __kmp_region_stats_list;
+    __kmp_region_stats_list = stats;
+    __kmp_release_bootstrap_lock(&__kmp_region_stats_lock);
+    this_thr->th.th_region_stats = stats;
+  }
+
+  kmp_region_stats_entry_t sample = {};
+  kmp_uint64 last = start;
+  for (int i = 0; i < nproc; ++i)
+    last = KMP_MAX(last, threads[i]->th.th_region_counters.arrive);
+  for (int i = 0; i < nproc; ++i) {
+    kmp_region_counters_t *counters = &threads[i]->th.th_region_counters;
+    // Timestamps of different cores may be slightly off.
+    kmp_uint64 arrive = KMP_MAX(counters->arrive, start);
+    sample.work += arrive - start;
+    sample.imbalance += last - arrive;
+    if (i == 0) {
+      sample.barrier += counters->barrier - team->t.t_stats_master.barrier;
+      sample.tasks += counters->tasks - team->t.t_stats_master.tasks;
+    } else {
+      sample.barrier += counters->barrier;
+      sample.tasks += counters->tasks;
+      counters->barrier = 0;
+      counters->tasks = 0;
+    }
+  }
+  sample.count = 1;
+  sample.threads = nproc;
+  sample.wall = now - start;
+  __kmp_region_stats_add(
+      __kmp_region_stats_find(stats, team->t.t_stats_ident), &sample);
+}
+
+static double __kmp_region_stats_seconds(kmp_uint64 time) {
+#if KMP_OS_UNIX && (KMP_ARCH_X86 || KMP_ARCH_X86_64)
+  return __kmp_ticks_per_msec ? time / (__kmp_ticks_per_msec * 1e3) : 0;
+#else
+  return time * 1e-9;
+#endif
+}
+
+static int __kmp_region_stats_cmp(const void *a, const void *b) {
+  const kmp_region_stats_entry_t *ea = *(kmp_region_stats_entry_t *const *)a;
+  const kmp_region_stats_entry_t *eb = *(kmp_region_stats_entry_t *const *)b;
+  return ea->wall < eb->wall ? 1 : ea->wall > eb->wall ? -1 : 0;
+}
+
+// Print the statistics of all regions, the longest running first.
+void __kmp_region_stats_print(void) {
+  if (!__kmp_region_stats)
+    return;
+
+  kmp_region_stats_t *all =
+      (kmp_region_stats_t *)__kmp_allocate(sizeof(kmp_region_stats_t));
+  __kmp_acquire_bootstrap_lock(&__kmp_region_stats_lock);
+  for (kmp_region_stats_t *stats = __kmp_region_stats_list; stats;
+       stats = stats->next) {
+    for (int i = 0; i < KMP_REGION_STATS_SIZE; ++i)
+      if (stats->entries[i].count)
+        __kmp_region_stats_add(
+            __kmp_region_stats_find(all, stats->entries[i].loc),
+            &stats->entries[i]);
+    __kmp_region_stats_add(&all->other, &stats->other);
+  }
+  __kmp_release_bootstrap_lock(&__kmp_region_stats_lock);
+
+  kmp_region_stats_entry_t *sorted[KMP_REGION_STATS_SIZE + 1];
+  int n = 0;
+  for (int i = 0; i < KMP_REGION_STATS_SIZE; ++i)
+    if (all->entries[i].count)
+      sorted[n++] = &all->entries[i];
+  if (all->other.count)
+    sorted[n++] = &all->other;
+  qsort(sorted, n, sizeof(*sorted), __kmp_region_stats_cmp);
+
+  kmp_str_buf_t buffer;
+  __kmp_str_buf_init(&buffer);
+  __kmp_str_buf_print(&buffer,
+                      "KMP_REGION_STATS: %10s %8s %12s %10s %9s %10s  %s\n",
+                      "runs", "threads", "time (s)", "imbalance", "barriers",
+                      "tasks", "region");
+  for (int i = 0; i < n; ++i) {
+    kmp_region_stats_entry_t *entry = sorted[i];
+    // Imbalance and barrier time are shares of the threads' time in the
+    // region, up to the last arrival at the join barrier.
+    double thread_time = (double)(entry->work + entry->imbalance);
+    double imbalance = thread_time ? 100.0 * entry->imbalance / thread_time : 0;
+    double barriers = thread_time ? 100.0 * entry->barrier / thread_time : 0;
+    __kmp_str_buf_print(&buffer,
+                        "KMP_REGION_STATS: %10llu %8.1f %12.6f %9.1f%% %8.1f%% "
+                        "%10llu  ",
+                        (unsigned long long)entry->count,
+                        (double)entry->threads / entry->count,
+                        __kmp_region_stats_seconds(entry->wall), imbalance,
+                        barriers, (unsigned long long)entry->tasks);
+    if (entry == &all->other) {
+      __kmp_str_buf_print(&buffer, "(other regions)\n");
+    } else if (entry->loc && entry->loc->psource) {
+      kmp_str_loc_t loc = __kmp_str_loc_init(entry->loc->psource, 0);
+      __kmp_str_buf_print(&buffer, "%s:%d %s\n", loc.file ? loc.file : "?",
+                          loc.line, loc.func ? loc.func : "?");
+      __kmp_str_loc_free(&loc);
+    } else {
+      __kmp_str_buf_print(&buffer, "(unknown)\n");
+    }
+  }
+  __kmp_printf("%s", buffer.str);
+  __kmp_str_buf_free(&buffer);
+  __kmp_free(all);
+}
+
 void __kmp_internal_fork(ident_t *id, int gtid, kmp_team_t *team) {
   kmp_info_t *this_thr = __kmp_threads[gtid];
 
@@ -7279,6 +7461,12 @@ void __kmp_internal_fork(ident_t *id, int gtid, kmp_team_t *team) {
   }
 #endif /* KMP_DEBUG */
 
+  if (UNLIKELY(__kmp_region_stats)) {
+    team->t.t_stats_ident = id;
+    team->t.t_stats_master = this_thr->th.th_region_counters;
+    team->t.t_stats_start = KMP_NOW();
+  }
+
   /* release the worker threads so they may begin working */
   __kmp_fork_barrier(gtid, 0);
 }
@@ -7309,6 +7497,8 @@ void __kmp_internal_join(ident_t *id, int gtid, kmp_team_t *team) {
 #endif /* KMP_DEBUG */
 
   __kmp_join_barrier(gtid); /* wait for everyone */
+  if (UNLIKELY(__kmp_region_stats))
+    __kmp_region_stats_join(this_thr, team);
 #if OMPT_SUPPORT
   if (ompt_enabled.enabled &&
       this_thr->th.ompt_thread_info.state == ompt_state_wait_barrier_implicit) {
@@ -4621,6 +4621,32 @@ static void __kmp_stg_print_task_throttling(kmp_str_buf_t *buffer,
   __kmp_stg_print_bool(buffer, name, __kmp_enable_task_throttling);
 } // __kmp_stg_print_task_throttling
 
+// -----------------------------------------------------------------------------
+// KMP_REGION_STATS
+
+static void __kmp_stg_parse_region_stats(char const *name, char const *value,
+                                         void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_region_stats);
+} // __kmp_stg_parse_region_stats
+
+static void __kmp_stg_print_region_stats(kmp_str_buf_t *buffer,
+                                         char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_region_stats);
+} // __kmp_stg_print_region_stats
+
+// -----------------------------------------------------------------------------
+// KMP_FORCE_MONOTONIC_DYNAMIC_SCHEDULE
+
+static void __kmp_stg_parse_force_monotonic(char const *name,
+                                            char const *value, void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_force_monotonic);
+} // __kmp_stg_parse_force_monotonic
+
+static void __kmp_stg_print_force_monotonic(kmp_str_buf_t *buffer,
+                                            char const *name, void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_force_monotonic);
+} // __kmp_stg_print_force_monotonic
+
 // -----------------------------------------------------------------------------
 // OMP_DISPLAY_ENV
 
@@ -4924,6 +4950,10 @@ static kmp_setting_t __kmp_stg_table[] = {
 #endif
     {"KMP_ENABLE_TASK_THROTTLING", __kmp_stg_parse_task_throttling,
      __kmp_stg_print_task_throttling, NULL, 0, 0},
+    {"KMP_REGION_STATS", __kmp_stg_parse_region_stats,
+     __kmp_stg_print_region_stats, NULL, 0, 0},
+    {"KMP_FORCE_MONOTONIC_DYNAMIC_SCHEDULE", __kmp_stg_parse_force_monotonic,
+     __kmp_stg_print_force_monotonic, NULL, 0, 0},
 
     {"OMP_DISPLAY_ENV", __kmp_stg_parse_omp_display_env,
      __kmp_stg_print_omp_display_env, NULL, 0, 0},
@@ -1439,6 +1439,9 @@ static void __kmp_invoke_task(kmp_int32 gtid, kmp_task_t *task,
     return;
   }
 
+  if (UNLIKELY(__kmp_region_stats))
+    __kmp_threads[gtid]->th.th_region_counters.tasks++;
+
 #if OMPT_SUPPORT
   // For untied tasks, the first task executed only calls __kmpc_omp_task and
   // does not execute code.
@@ -2638,6 +2641,29 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   return task;
 }
 
+#if KMP_AFFINITY_SUPPORTED
+// Number of random victims on another package a thief passes over before it
+// takes whichever victim comes next.
+#define KMP_TASK_STEAL_LOCAL_TRIES 4
+
+// __kmp_task_victim_is_remote: returns true if the victim is bound to a place
+// on another package than the thief, so that its tasks' data are likely in
+// another socket's caches and memory. Returns false when placement is unknown.
+static inline bool __kmp_task_victim_is_remote(kmp_info_t *thread,
+                                               kmp_info_t *victim_thr) {
+  if (__kmp_affinity_place_pkgs == NULL)
+    return false;
+  int place = thread->th.th_current_place;
+  int victim_place = victim_thr->th.th_current_place;
+  if (place < 0 || victim_place < 0 ||
+      (unsigned)place >= __kmp_affinity_num_masks ||
+      (unsigned)victim_place >= __kmp_affinity_num_masks)
+    return false;
+  return __kmp_affinity_place_pkgs[place] !=
+         __kmp_affinity_place_pkgs[victim_place];
+}
+#endif // KMP_AFFINITY_SUPPORTED
+
 // __kmp_steal_task: remove a task from another thread's deque
 // Assume that calling thread has already checked existence of
 // task_team thread_data before calling this routine.
@@ -2833,6 +2859,9 @@ static inline int __kmp_execute_tasks_template(
           asleep = 0;
         } else if (!new_victim) { // no recent steals and we haven't already
           // used a new victim; select a random thread
+#if KMP_AFFINITY_SUPPORTED
+          int local_tries = KMP_TASK_STEAL_LOCAL_TRIES;
+#endif
           do { // Find a different thread to steal work from.
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
@@ -2843,6 +2872,16 @@ static inline int __kmp_execute_tasks_template(
             }
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
+#if KMP_AFFINITY_SUPPORTED
+            // Prefer victims on our own package, but do not insist, or work
+            // on the other packages would never be balanced.
+            if (local_tries > 0 &&
+                __kmp_task_victim_is_remote(thread, other_thread)) {
+              --local_tries;
+              asleep = 1; // pick another victim
+              continue;
+            }
+#endif
             // There is a slight chance that __kmp_enable_tasking() did not wake
             // up all threads waiting at the barrier.  If victim is sleeping,
             // then wake it up. Since we were going to pay the cache miss
@@ -0,0 +1,58 @@
+// RUN: %libomp-compile
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=linear,linear %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=tree,tree %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hyper,hyper %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hierarchical,hierarchical %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hier,hier KMP_BLOCKTIME=infinite %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hier,hier KMP_BLOCKTIME=0 %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hier,hier KMP_AFFINITY=scatter %libomp-run
+// RUN: env KMP_PLAIN_BARRIER_PATTERN=hier,hier KMP_AFFINITY=core,compact,1 %libomp-run
+//
+// Checks that every barrier pattern keeps the threads in step over many
+// back-to-back barriers, and prints the average time per barrier, so the
+// test doubles as a microbenchmark: run it with OMP_NUM_THREADS, KMP_AFFINITY
+// and KMP_BLOCKTIME set to compare the patterns on a given machine.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define NUM_BARRIERS 20000
+#define MAX_THREADS 1024
+
+int main() {
+  static int phase[MAX_THREADS];
+  int num_failed = 0;
+  double start, time;
+  int nthreads = 0;
+
+  omp_set_dynamic(0);
+  if (omp_get_max_threads() > MAX_THREADS)
+    omp_set_num_threads(MAX_THREADS);
+
+  start = omp_get_wtime();
+  #pragma omp parallel reduction(+:num_failed)
+  {
+    int i, j, tid = omp_get_thread_num(), n = omp_get_num_threads();
+    #pragma omp single
+    nthreads = n;
+    for (i = 0; i < NUM_BARRIERS; i++) {
+      phase[tid] = i;
+      #pragma omp barrier
+      // Everyone has finished phase i, and no one can start i + 1 until
+      // everyone has checked.
+      for (j = 0; j < n; j++)
+        if (phase[j] != i)
+          num_failed++;
+      #pragma omp barrier
+    }
+  }
+  time = omp_get_wtime() - start;
+
+  printf("%d threads: %.3f us per barrier\n", nthreads,
+         time * 1e6 / (2 * NUM_BARRIERS));
+  if (num_failed) {
+    printf("%d threads saw a barrier too early\n", num_failed);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+// RUN: %libomp-compile
+// RUN: %libomp-run
+// RUN: env OMP_SCHEDULE=dynamic,1 %libomp-run
+// RUN: env OMP_SCHEDULE=nonmonotonic:dynamic,4 %libomp-run
+// RUN: env KMP_FORCE_MONOTONIC_DYNAMIC_SCHEDULE=1 %libomp-run
+// RUN: env OMP_SCHEDULE=dynamic %libomp-run
+//
+// Checks that dynamic loops run every iteration exactly once whether they
+// are monotonic (a shared counter) or nonmonotonic (per-thread ranges with
+// stealing, the default for an unmodified dynamic schedule), with 32- and
+// 64-bit induction variables and with fewer chunks than threads. It prints
+// the average time per loop for each schedule, so the test doubles as a
+// microbenchmark: run it with OMP_NUM_THREADS and KMP_AFFINITY set to compare
+// the schedules on a given machine.
+#include <stdio.h>
+#include <stdlib.h>
+#include "omp_testsuite.h"
+
+#define N 20000
+#define REPS 200
+
+static int count[N];
+static volatile int sink;
+
+// Uneven work, so that threads run out of their own chunks at different times.
+static void work(int i) {
+  int j;
+  count[i]++;
+  for (j = 0; j < (i & 63); j++)
+    sink = j;
+}
+
+static int check(const char *name, int n, double time) {
+  int i, failed = 0;
+  for (i = 0; i < n; i++) {
+    if (count[i] != REPS)
+      failed++;
+    count[i] = 0;
+  }
+  printf("%-24s %10.3f us per loop\n", name, time * 1e6 / REPS);
+  if (failed)
+    printf("%s: %d iterations were not run exactly once\n", name, failed);
+  return failed;
+}
+
+#define RUN_LOOP(name, type, n, schedule)                                      \
+  do {                                                                         \
+    double start = omp_get_wtime();                                            \
+    _Pragma("omp parallel") {                                                  \
+      int r;                                                                   \
+      type i;                                                                  \
+      for (r = 0; r < REPS; r++) {                                             \
+        _Pragma(schedule) for (i = 0; i < (n); i++) work((int)i);              \
+      }                                                                        \
+    }                                                                          \
+    num_failed += check(name, (n), omp_get_wtime() - start);                   \
+  } while (0)
+
+// An ordered loop stays monotonic when its schedule comes from OMP_SCHEDULE,
+// so iterations reach the ordered region one after another.
+static int run_ordered_runtime(void) {
+  int i, next = 0, failed = 0;
+#pragma omp parallel for schedule(runtime) ordered
+  for (i = 0; i < N; i++) {
+    work(i);
+#pragma omp ordered
+    {
+      if (i != next)
+        failed++;
+      next = i + 1;
+    }
+  }
+  for (i = 0; i < N; i++) {
+    if (count[i] != 1)
+      failed++;
+    count[i] = 0;
+  }
+  if (failed)
+    printf("ordered runtime: %d iterations were out of order or not run "
+           "exactly once\n",
+           failed);
+  return failed;
+}
+
+int main() {
+  int num_failed = 0;
+
+  omp_set_dynamic(0);
+  printf("%d threads, %d iterations\n", omp_get_max_threads(), N);
+
+  RUN_LOOP("static", int, N, "omp for schedule(static)");
+  RUN_LOOP("monotonic:dynamic,1", int, N,
+           "omp for schedule(monotonic: dynamic, 1)");
+  RUN_LOOP("nonmonotonic:dynamic,1", int, N,
+           "omp for schedule(nonmonotonic: dynamic, 1)");
+  RUN_LOOP("dynamic,1", int, N, "omp for schedule(dynamic, 1)");
+  RUN_LOOP("dynamic,16", int, N, "omp for schedule(dynamic, 16)");
+  RUN_LOOP("guided,1", int, N, "omp for schedule(guided, 1)");
+  RUN_LOOP("runtime", int, N, "omp for schedule(runtime)");
+  RUN_LOOP("dynamic,1 (64-bit)", long long, N, "omp for schedule(dynamic, 1)");
+  // Fewer chunks than threads.
+  RUN_LOOP("dynamic,1 (short)", int, 3, "omp for schedule(dynamic, 1)");
+  RUN_LOOP("ordered dynamic,1", int, N, "omp for schedule(dynamic, 1) ordered");
+  num_failed += run_ordered_runtime();
+
+  return num_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -78,6 +78,31 @@ Stream &Stream::enqueueEvent(Event &E) {
   return *this;
 }
 
+Stream &Stream::beginCapture() {
+  setStatus(ThePlatform->streamBeginCapture(TheHandle.get()));
+  return *this;
+}
+
+Expected<Graph> Stream::endCapture() {
+  Expected<void *> MaybeGraphHandle =
+      ThePlatform->streamEndCapture(TheHandle.get());
+  if (MaybeGraphHandle.isError())
+    return takeStatusOr(MaybeGraphHandle.getError());
+  HandleDestructor Destructor = ThePlatform->getGraphHandleDestructor();
+  Status S = takeStatus();
+  if (S.isError()) {
+    Destructor(MaybeGraphHandle.getValue());
+    return S;
+  }
+  return Graph(ThePlatform, MaybeGraphHandle.getValue(), Destructor);
+}
+
+Stream &Stream::asyncGraphLaunch(const Graph &TheGraph) {
+  setStatus(ThePlatform->enqueueGraphLaunch(TheGraph.TheHandle.get(),
+                                            TheHandle.get()));
+  return *this;
+}
+
 Event::Event(Event &&) noexcept = default;
 Event &Event::operator=(Event &&) noexcept = default;
 
@@ -108,4 +133,7 @@ Program &Program::operator=(Program &&That) noexcept = default;
 Kernel::Kernel(Kernel &&) noexcept = default;
 Kernel &Kernel::operator=(Kernel &&That) noexcept = default;
 
+Graph::Graph(Graph &&) noexcept = default;
+Graph &Graph::operator=(Graph &&That) noexcept = default;
+
 } // namespace acxxel
@@ -96,6 +96,14 @@
 ///
 /// Acxxel functions as a modern replacement for the standard CUDA runtime
 /// library and interoperates seamlessly with kernel calls.
+///
+/// \subsubsection ResourceCaching Cheap streams, events, and memory
+///
+/// The CUDA platform keeps the streams, events, device memory, and async host
+/// memory that go out of scope and hands them out again, so creating them in
+/// the middle of a latency-sensitive pipeline does not call into the driver.
+/// Work that is enqueued over and over can also be captured once into an
+/// acxxel::Graph and then launched with a single call.
 
 #ifndef ACXXEL_ACXXEL_H
 #define ACXXEL_ACXXEL_H
@@ -127,6 +135,7 @@ struct CUstream_st; // NOLINT
 namespace acxxel {
 
 class Event;
+class Graph;
 class Platform;
 class Stream;
 
@@ -223,6 +232,30 @@ private:
   std::unique_ptr<void, HandleDestructor> TheHandle;
 };
 
+/// A sequence of work recorded from a Stream.
+///
+/// A Graph is created by calling Stream::beginCapture, enqueuing work on the
+/// stream as usual, and then calling Stream::endCapture. The Graph can then be
+/// launched any number of times by calling Stream::asyncGraphLaunch, which
+/// enqueues all the recorded copies and kernel launches at once.
+class Graph {
+public:
+  Graph(const Graph &) = delete;
+  Graph &operator=(const Graph &) = delete;
+  Graph(Graph &&) noexcept;
+  Graph &operator=(Graph &&That) noexcept;
+  ~Graph() = default;
+
+private:
+  // Only a stream can make a graph, and launch it.
+  friend class Stream;
+  Graph(Platform *APlatform, void *AHandle, HandleDestructor Destructor)
+      : ThePlatform(APlatform), TheHandle(AHandle, Destructor) {}
+
+  Platform *ThePlatform;
+  std::unique_ptr<void, HandleDestructor> TheHandle;
+};
+
 /// A stream of computation.
 ///
 /// All operations enqueued on a Stream are serialized, but operations enqueued
@@ -363,6 +396,29 @@ public:
   /// Enqueues an event in the stream.
   Stream &enqueueEvent(Event &E);
 
+  /// \name Graph capture
+  ///
+  /// Work enqueued on a Stream between calls to beginCapture and endCapture is
+  /// not run, but recorded into a Graph instead.
+  ///
+  /// Host callbacks cannot be captured, and memory should not be allocated or
+  /// freed while a capture is in progress.
+  /// \{
+
+  /// Starts recording the work enqueued on this Stream.
+  Stream &beginCapture();
+
+  /// Stops recording and returns the work enqueued since beginCapture.
+  ///
+  /// Returns the Status of the Stream instead if any of the captured work
+  /// failed to be enqueued, and clears the Status state of the Stream.
+  Expected<Graph> endCapture();
+
+  /// Enqueues all the work recorded in a Graph.
+  Stream &asyncGraphLaunch(const Graph &TheGraph);
+
+  /// \}
+
   // Allows implicit conversion to (CUstream_st *). This makes triple-chevron
   // kernel calls look nicer because you can just pass a acxxel::Stream
   // directly.
@@ -471,11 +527,21 @@ public:
   virtual Expected<int> getDeviceCount() = 0;
 
   /// Creates a stream on the given device for the platform.
+  ///
+  /// A platform may reuse a stream that went out of scope rather than create a
+  /// new one.
   virtual Expected<Stream> createStream(int DeviceIndex = 0) = 0;
 
   /// Creates an event on the given device for the platform.
+  ///
+  /// A platform may reuse an event that went out of scope rather than create a
+  /// new one.
   virtual Expected<Event> createEvent(int DeviceIndex = 0) = 0;
 
+  /// Frees the device memory and async host memory that the platform keeps
+  /// for reuse after it goes out of scope.
+  virtual Status releaseCachedMemory() = 0;
+
   /// Allocates owned device memory.
   ///
   /// \warning This function only allocates space in device memory, it does not
@@ -652,6 +718,11 @@ protected:
 
   virtual Status addStreamCallback(Stream &Stream, StreamCallback Callback) = 0;
 
+  virtual Status streamBeginCapture(void *Stream) = 0;
+  virtual Expected<void *> streamEndCapture(void *Stream) = 0;
+  virtual HandleDestructor getGraphHandleDestructor() = 0;
+  virtual Status enqueueGraphLaunch(void *Graph, void *Stream) = 0;
+
   virtual Expected<void *> rawCreateKernel(void *Program,
                                            const std::string &Name) = 0;
   virtual HandleDestructor getKernelHandleDestructor() = 0;
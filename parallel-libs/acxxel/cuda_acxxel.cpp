@@ -17,7 +17,9 @@
 
 #include <array>
 #include <cassert>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 namespace acxxel {
@@ -72,6 +74,324 @@ static void logCUWarning(CUresult Result, const std::string &Message) {
   }
 }
 
+/// Makes a context current for the lifetime of the object and restores the
+/// previous one afterwards.
+///
+/// This is used where the platform must not change the current context of the
+/// calling thread, such as in the destructors of handles.
+class ScopedContext {
+public:
+  explicit ScopedContext(CUcontext Context) {
+    CUresult Result = cuCtxPushCurrent(Context);
+    logCUWarning(Result, "cuCtxPushCurrent");
+    Pushed = !Result;
+  }
+
+  ~ScopedContext() {
+    CUcontext Context;
+    if (Pushed)
+      logCUWarning(cuCtxPopCurrent(&Context), "cuCtxPopCurrent");
+  }
+
+  ScopedContext(const ScopedContext &) = delete;
+  ScopedContext &operator=(const ScopedContext &) = delete;
+
+private:
+  bool Pushed;
+};
+
+/// A set of idle handles of one kind, such as streams, for each device.
+///
+/// Creating and destroying streams and events goes through the driver and can
+/// take longer than the work that is enqueued on them, so the handles of the
+/// objects that go out of scope are kept here and handed out again.
+template <typename HandleType> class HandlePool {
+public:
+  /// Takes an idle handle of the given device, or returns null if there is
+  /// none.
+  HandleType take(int DeviceIndex) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    std::vector<HandleType> &Handles = IdleHandles[DeviceIndex];
+    if (Handles.empty())
+      return nullptr;
+    HandleType Handle = Handles.back();
+    Handles.pop_back();
+    return Handle;
+  }
+
+  /// Records the device of a new handle.
+  void add(HandleType Handle, int DeviceIndex) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    DeviceIndices[Handle] = DeviceIndex;
+  }
+
+  /// Makes a handle that is no longer used available again.
+  void put(HandleType Handle) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    assert(DeviceIndices.count(Handle) && "handle was not added to the pool");
+    IdleHandles[DeviceIndices[Handle]].push_back(Handle);
+  }
+
+  /// Forgets a handle that is about to be destroyed.
+  void remove(HandleType Handle) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    DeviceIndices.erase(Handle);
+  }
+
+private:
+  std::mutex Mutex;
+  std::unordered_map<HandleType, int> DeviceIndices;
+  std::unordered_map<int, std::vector<HandleType>> IdleHandles;
+};
+
+// The pools are reached from the destructors of handles, which are plain
+// functions, so they are global. Like the platform, they are never destroyed,
+// so a handle can go out of scope at any time.
+
+static HandlePool<CUstream> &getStreamPool() {
+  static auto *Pool = new HandlePool<CUstream>;
+  return *Pool;
+}
+
+static HandlePool<CUevent> &getEventPool() {
+  static auto *Pool = new HandlePool<CUevent>;
+  return *Pool;
+}
+
+// Events without timing data which the memory cache records when memory is
+// freed.
+static HandlePool<CUevent> &getReleaseEventPool() {
+  static auto *Pool = new HandlePool<CUevent>;
+  return *Pool;
+}
+
+/// Rounds an allocation size up to its size class.
+///
+/// The classes between two powers of two are a quarter of the smaller one
+/// apart, so less than a fifth of a block is wasted, and all sizes up to 512
+/// bytes share one class.
+static size_t getSizeClass(size_t ByteCount) {
+  constexpr size_t MinClassSize = 512;
+  if (ByteCount <= MinClassSize)
+    return MinClassSize;
+  size_t Power = MinClassSize;
+  while (Power <= ByteCount / 2)
+    Power *= 2;
+  size_t Step = Power / 4;
+  return (ByteCount + Step - 1) / Step * Step;
+}
+
+/// A cache of device memory and page-locked host memory.
+///
+/// Allocating these through the driver is slow and freeing them waits for the
+/// device, so the blocks that are freed are kept and reused for later
+/// allocations of the same size class.
+///
+/// A freed block may still be used by work that was enqueued before it was
+/// freed. When a block is freed, an event is recorded in the legacy default
+/// stream of each device that can access it, and the block is only reused once
+/// those events are done. The legacy default stream waits for all the streams
+/// created by the platform, so that is when the work enqueued before the block
+/// was freed is done.
+class MemoryCache {
+public:
+  explicit MemoryCache(const std::vector<CUcontext> &Contexts)
+      : TheContexts(Contexts), FreeBlocks(Contexts.size() + 1) {}
+
+  Expected<void *> allocateDevice(int DeviceIndex, size_t ByteCount) {
+    return allocate(DeviceIndex, ByteCount);
+  }
+
+  Expected<void *> allocateHost(size_t ByteCount) {
+    return allocate(getHostArena(), ByteCount);
+  }
+
+  /// Frees a block allocated by the cache.
+  void release(void *Pointer);
+
+  /// Frees all the cached blocks through the driver.
+  Status trim();
+
+private:
+  struct FreeBlock {
+    void *Pointer;
+    std::vector<CUevent> Events;
+  };
+
+  struct BlockInfo {
+    size_t Arena;
+    size_t ClassSize;
+  };
+
+  // The blocks of device I are in arena I. Host blocks are in an extra arena.
+  size_t getHostArena() const { return TheContexts.size(); }
+
+  Expected<void *> allocate(size_t Arena, size_t ByteCount);
+  bool recordReleaseEvents(size_t Arena, std::vector<CUevent> &Events);
+  CUresult rawAllocate(size_t Arena, size_t ByteCount, void **Pointer);
+  CUresult rawFree(size_t Arena, void *Pointer);
+
+  std::vector<CUcontext> TheContexts;
+
+  std::mutex Mutex;
+
+  // The free blocks of each arena by size class.
+  std::vector<std::unordered_map<size_t, std::vector<FreeBlock>>> FreeBlocks;
+
+  // The blocks that are in use.
+  std::unordered_map<void *, BlockInfo> LiveBlocks;
+};
+
+static bool areEventsDone(const std::vector<CUevent> &Events) {
+  for (CUevent Event : Events)
+    if (cuEventQuery(Event) != CUDA_SUCCESS)
+      return false;
+  return true;
+}
+
+Expected<void *> MemoryCache::allocate(size_t Arena, size_t ByteCount) {
+  size_t ClassSize = getSizeClass(ByteCount);
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    std::vector<FreeBlock> &Blocks = FreeBlocks[Arena][ClassSize];
+    // The blocks that were freed first are the most likely to be done.
+    for (auto Iter = Blocks.begin(); Iter != Blocks.end(); ++Iter) {
+      if (!areEventsDone(Iter->Events))
+        continue;
+      void *Pointer = Iter->Pointer;
+      for (CUevent Event : Iter->Events)
+        getReleaseEventPool().put(Event);
+      Blocks.erase(Iter);
+      LiveBlocks[Pointer] = {Arena, ClassSize};
+      return Pointer;
+    }
+  }
+
+  void *Pointer;
+  CUresult Result = rawAllocate(Arena, ClassSize, &Pointer);
+  if (Result == CUDA_ERROR_OUT_OF_MEMORY) {
+    // Give the cached blocks back to the driver and try again.
+    Status S = trim();
+    if (S.isError())
+      return S;
+    Result = rawAllocate(Arena, ClassSize, &Pointer);
+  }
+  if (Result)
+    return getCUError(Result, Arena == getHostArena() ? "cuMemHostAlloc"
+                                                      : "cuMemAlloc");
+  std::lock_guard<std::mutex> Lock(Mutex);
+  LiveBlocks[Pointer] = {Arena, ClassSize};
+  return Pointer;
+}
+
+void MemoryCache::release(void *Pointer) {
+  BlockInfo Info;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto Iter = LiveBlocks.find(Pointer);
+    if (Iter == LiveBlocks.end()) {
+      logWarning("freeing memory that was not allocated by the CUDA platform");
+      return;
+    }
+    Info = Iter->second;
+    LiveBlocks.erase(Iter);
+  }
+
+  std::vector<CUevent> Events;
+  if (!recordReleaseEvents(Info.Arena, Events)) {
+    // There is no telling when the block will no longer be used, so it cannot
+    // be reused.
+    for (CUevent Event : Events)
+      getReleaseEventPool().put(Event);
+    logCUWarning(rawFree(Info.Arena, Pointer), "freeing memory");
+    return;
+  }
+
+  std::lock_guard<std::mutex> Lock(Mutex);
+  FreeBlocks[Info.Arena][Info.ClassSize].push_back(
+      {Pointer, std::move(Events)});
+}
+
+Status MemoryCache::trim() {
+  std::vector<std::unordered_map<size_t, std::vector<FreeBlock>>> Blocks(
+      FreeBlocks.size());
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Blocks.swap(FreeBlocks);
+  }
+
+  Status S;
+  for (size_t Arena = 0; Arena < Blocks.size(); ++Arena)
+    for (auto &ClassBlocks : Blocks[Arena])
+      for (FreeBlock &Block : ClassBlocks.second) {
+        // The block can only be freed once the work that uses it is done.
+        for (CUevent Event : Block.Events) {
+          if (CUresult Result = cuEventSynchronize(Event))
+            if (!S.isError())
+              S = getCUError(Result, "cuEventSynchronize");
+          getReleaseEventPool().put(Event);
+        }
+        if (CUresult Result = rawFree(Arena, Block.Pointer))
+          if (!S.isError())
+            S = getCUError(Result, "freeing cached memory");
+      }
+  return S;
+}
+
+bool MemoryCache::recordReleaseEvents(size_t Arena,
+                                      std::vector<CUevent> &Events) {
+  // Host blocks are accessible from every device.
+  size_t Begin = Arena == getHostArena() ? 0 : Arena;
+  size_t End = Arena == getHostArena() ? TheContexts.size() : Arena + 1;
+  for (size_t I = Begin; I < End; ++I) {
+    ScopedContext Context(TheContexts[I]);
+    CUevent Event = getReleaseEventPool().take(I);
+    if (!Event) {
+      if (CUresult Result = cuEventCreate(&Event, CU_EVENT_DISABLE_TIMING)) {
+        logCUWarning(Result, "cuEventCreate");
+        return false;
+      }
+      getReleaseEventPool().add(Event, I);
+    }
+    Events.push_back(Event);
+    if (CUresult Result = cuEventRecord(Event, CU_STREAM_LEGACY)) {
+      logCUWarning(Result, "cuEventRecord");
+      return false;
+    }
+  }
+  return true;
+}
+
+CUresult MemoryCache::rawAllocate(size_t Arena, size_t ByteCount,
+                                  void **Pointer) {
+  if (TheContexts.empty())
+    return CUDA_ERROR_NO_DEVICE;
+  if (Arena == getHostArena()) {
+    // Portable memory is page-locked for all the devices, so a cached host
+    // block can be reused for copies to and from any of them.
+    ScopedContext Context(TheContexts[0]);
+    return cuMemHostAlloc(Pointer, ByteCount, CU_MEMHOSTALLOC_PORTABLE);
+  }
+  ScopedContext Context(TheContexts[Arena]);
+  CUdeviceptr DevicePointer;
+  CUresult Result = cuMemAlloc(&DevicePointer, ByteCount);
+  *Pointer = reinterpret_cast<void *>(DevicePointer);
+  return Result;
+}
+
+CUresult MemoryCache::rawFree(size_t Arena, void *Pointer) {
+  if (Arena == getHostArena()) {
+    ScopedContext Context(TheContexts[0]);
+    return cuMemFreeHost(Pointer);
+  }
+  ScopedContext Context(TheContexts[Arena]);
+  return cuMemFree(reinterpret_cast<CUdeviceptr>(Pointer));
+}
+
+// The memory cache of the platform. Like the pools, it is reached from the
+// destructors of memory handles and is never destroyed.
+static MemoryCache *TheMemoryCache = nullptr;
+
 /// A CUDA Platform implementation.
 class CUDAPlatform : public Platform {
 public:
@@ -89,6 +409,8 @@ public:
 
   Expected<Event> createEvent(int DeviceIndex) override;
 
+  Status releaseCachedMemory() override;
+
 protected:
   Expected<void *> rawMallocD(ptrdiff_t ByteCount, int DeviceIndex) override;
   HandleDestructor getDeviceMemoryHandleDestructor() override;
@@ -132,6 +454,11 @@ protected:
   Expected<float> getSecondsBetweenEvents(void *StartEvent,
                                           void *EndEvent) override;
 
+  Status streamBeginCapture(void *Stream) override;
+  Expected<void *> streamEndCapture(void *Stream) override;
+  HandleDestructor getGraphHandleDestructor() override;
+  Status enqueueGraphLaunch(void *Graph, void *Stream) override;
+
   Expected<void *> rawCreateKernel(void *Program,
                                    const std::string &Name) override;
   HandleDestructor getKernelHandleDestructor() override;
@@ -179,6 +506,7 @@ Expected<CUDAPlatform> CUDAPlatform::create() {
     Contexts.emplace_back(Context);
   }
 
+  TheMemoryCache = new MemoryCache(Contexts);
   return CUDAPlatform(Contexts);
 }
 
@@ -189,20 +517,30 @@ Expected<int> CUDAPlatform::getDeviceCount() {
   return Count;
 }
 
-static void cudaDestroyStream(void *H) {
-  logCUWarning(cuStreamDestroy(static_cast<CUstream_st *>(H)),
-               "cuStreamDestroy");
+static void cudaReleaseStream(void *H) {
+  CUstream Handle = static_cast<CUstream_st *>(H);
+  // The work enqueued by the next user of a stream would wait for the work
+  // still in the stream, so only idle streams are reused.
+  if (cuStreamQuery(Handle) == CUDA_SUCCESS) {
+    getStreamPool().put(Handle);
+    return;
+  }
+  getStreamPool().remove(Handle);
+  logCUWarning(cuStreamDestroy(Handle), "cuStreamDestroy");
 }
 
 Expected<Stream> CUDAPlatform::createStream(int DeviceIndex) {
   Status S = setContext(DeviceIndex);
   if (S.isError())
     return S;
+  if (CUstream Handle = getStreamPool().take(DeviceIndex))
+    return constructStream(this, DeviceIndex, Handle, cudaReleaseStream);
   unsigned int Flags = CU_STREAM_DEFAULT;
   CUstream Handle;
   if (CUresult Result = cuStreamCreate(&Handle, Flags))
     return getCUError(Result, "cuStreamCreate");
-  return constructStream(this, DeviceIndex, Handle, cudaDestroyStream);
+  getStreamPool().add(Handle, DeviceIndex);
+  return constructStream(this, DeviceIndex, Handle, cudaReleaseStream);
 }
 
 Status CUDAPlatform::streamSync(void *Stream) {
@@ -218,21 +556,33 @@ Status CUDAPlatform::streamWaitOnEvent(void *Stream, void *Event) {
                     "cuStreamWaitEvent");
 }
 
-static void cudaDestroyEvent(void *H) {
-  logCUWarning(cuEventDestroy(static_cast<CUevent_st *>(H)), "cuEventDestroy");
+static void cudaReleaseEvent(void *H) {
+  CUevent Handle = static_cast<CUevent_st *>(H);
+  // A new event is done, so only events that are done are reused.
+  if (cuEventQuery(Handle) == CUDA_SUCCESS) {
+    getEventPool().put(Handle);
+    return;
+  }
+  getEventPool().remove(Handle);
+  logCUWarning(cuEventDestroy(Handle), "cuEventDestroy");
 }
 
 Expected<Event> CUDAPlatform::createEvent(int DeviceIndex) {
   Status S = setContext(DeviceIndex);
   if (S.isError())
     return S;
+  if (CUevent Handle = getEventPool().take(DeviceIndex))
+    return constructEvent(this, DeviceIndex, Handle, cudaReleaseEvent);
   unsigned int Flags = CU_EVENT_DEFAULT;
   CUevent Handle;
   if (CUresult Result = cuEventCreate(&Handle, Flags))
     return getCUError(Result, "cuEventCreate");
-  return constructEvent(this, DeviceIndex, Handle, cudaDestroyEvent);
+  getEventPool().add(Handle, DeviceIndex);
+  return constructEvent(this, DeviceIndex, Handle, cudaReleaseEvent);
 }
 
+Status CUDAPlatform::releaseCachedMemory() { return TheMemoryCache->trim(); }
+
 Status CUDAPlatform::enqueueEvent(void *Event, void *Stream) {
   return getCUError(cuEventRecord(static_cast<CUevent_st *>(Event),
                                   static_cast<CUstream_st *>(Stream)),
@@ -265,15 +615,10 @@ Expected<void *> CUDAPlatform::rawMallocD(ptrdiff_t ByteCount,
     return S;
   if (!ByteCount)
     return nullptr;
-  CUdeviceptr Pointer;
-  if (CUresult Result = cuMemAlloc(&Pointer, ByteCount))
-    return getCUError(Result, "cuMemAlloc");
-  return reinterpret_cast<void *>(Pointer);
+  return TheMemoryCache->allocateDevice(DeviceIndex, ByteCount);
 }
 
-static void cudaDestroyDeviceMemory(void *H) {
-  logCUWarning(cuMemFree(reinterpret_cast<CUdeviceptr>(H)), "cuMemFree");
-}
+static void cudaDestroyDeviceMemory(void *H) { TheMemoryCache->release(H); }
 
 HandleDestructor CUDAPlatform::getDeviceMemoryHandleDestructor() {
   return cudaDestroyDeviceMemory;
@@ -335,15 +680,11 @@ HandleDestructor CUDAPlatform::getUnregisterHostMemoryHandleDestructor() {
 }
 
 Expected<void *> CUDAPlatform::rawMallocRegisteredH(ptrdiff_t ByteCount) {
-  unsigned int Flags = 0;
-  void *Memory;
-  if (CUresult Result = cuMemHostAlloc(&Memory, ByteCount, Flags))
-    return getCUError(Result, "cuMemHostAlloc");
-  return Memory;
+  return TheMemoryCache->allocateHost(ByteCount);
 }
 
 static void cudaFreeHostMemoryHandleDestructor(void *H) {
-  logCUWarning(cuMemFreeHost(H), "cuMemFreeHost");
+  TheMemoryCache->release(H);
 }
 
 HandleDestructor CUDAPlatform::getFreeHostMemoryHandleDestructor() {
@@ -423,6 +764,69 @@ Status CUDAPlatform::addStreamCallback(Stream &Stream,
                     "cuStreamAddCallback");
 }
 
+#if CUDA_VERSION >= 10010
+Status CUDAPlatform::streamBeginCapture(void *Stream) {
+  // Only the calling thread is kept from making the calls that would break the
+  // capture, so that other threads can keep allocating memory.
+  return getCUError(cuStreamBeginCapture(static_cast<CUstream_st *>(Stream),
+                                         CU_STREAM_CAPTURE_MODE_THREAD_LOCAL),
+                    "cuStreamBeginCapture");
+}
+
+Expected<void *> CUDAPlatform::streamEndCapture(void *Stream) {
+  CUgraph Graph;
+  if (CUresult Result =
+          cuStreamEndCapture(static_cast<CUstream_st *>(Stream), &Graph))
+    return getCUError(Result, "cuStreamEndCapture");
+  CUgraphExec GraphExec;
+#if CUDA_VERSION >= 11040
+  CUresult Result = cuGraphInstantiateWithFlags(&GraphExec, Graph, 0);
+#else
+  CUresult Result = cuGraphInstantiate(&GraphExec, Graph, nullptr, nullptr, 0);
+#endif
+  // The executable graph does not need the graph it was made from.
+  logCUWarning(cuGraphDestroy(Graph), "cuGraphDestroy");
+  if (Result)
+    return getCUError(Result, "cuGraphInstantiate");
+  return GraphExec;
+}
+
+static void cudaDestroyGraph(void *H) {
+  logCUWarning(cuGraphExecDestroy(static_cast<CUgraphExec>(H)),
+               "cuGraphExecDestroy");
+}
+
+HandleDestructor CUDAPlatform::getGraphHandleDestructor() {
+  return cudaDestroyGraph;
+}
+
+Status CUDAPlatform::enqueueGraphLaunch(void *Graph, void *Stream) {
+  return getCUError(cuGraphLaunch(static_cast<CUgraphExec>(Graph),
+                                  static_cast<CUstream_st *>(Stream)),
+                    "cuGraphLaunch");
+}
+#else
+Status CUDAPlatform::streamBeginCapture(void *) {
+  return Status("stream capture requires CUDA 10.1 or later");
+}
+
+Expected<void *> CUDAPlatform::streamEndCapture(void *) {
+  return Status("stream capture requires CUDA 10.1 or later");
+}
+
+static void cudaDestroyGraph(void *) {
+  // Do nothing.
+}
+
+HandleDestructor CUDAPlatform::getGraphHandleDestructor() {
+  return cudaDestroyGraph;
+}
+
+Status CUDAPlatform::enqueueGraphLaunch(void *, void *) {
+  return Status("graph launches require CUDA 10.1 or later");
+}
+#endif
+
 static void cudaDestroyProgram(void *H) {
   logCUWarning(cuModuleUnload(static_cast<CUmod_st *>(H)), "cuModuleUnload");
 }
@@ -0,0 +1,148 @@
+//===--- latency_benchmark.cu - Latency of small Acxxel requests ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// This file measures the latency of the small requests of an inference-like
+/// pipeline: copy an input to the device, run a kernel on it, and copy the
+/// result back.
+///
+/// Each request is run in three ways:
+///   - "register": the request creates its stream, event, and device memory,
+///     and registers its host buffers with Platform::registerHostMem;
+///   - "cached": the request creates its stream, event, and device memory, and
+///     allocates its host buffers with Platform::newAsyncHostMem, all of which
+///     the platform reuses from earlier requests;
+///   - "graph": the work of a request is captured once into a Graph, and each
+///     request only launches the graph.
+///
+/// Usage: latency_benchmark [iterations]
+///
+//===----------------------------------------------------------------------===//
+
+#include "acxxel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+namespace {
+
+constexpr int ElementCount = 4096;
+constexpr int BlockSize = 256;
+constexpr int WarmupIterations = 10;
+
+__global__ void scaleKernel(float A, float *X, int N) {
+  int I = (blockDim.x * blockIdx.x) + threadIdx.x;
+  if (I < N)
+    X[I] *= A;
+}
+
+void check(const acxxel::Status &Status, const char *What) {
+  if (Status.isError()) {
+    std::fprintf(stderr, "Error in %s: %s\n", What,
+                 Status.getMessage().c_str());
+    std::exit(EXIT_FAILURE);
+  }
+}
+
+template <typename T>
+T take(acxxel::Expected<T> &&MaybeValue, const char *What) {
+  if (MaybeValue.isError())
+    check(MaybeValue.getError(), What);
+  return MaybeValue.takeValue();
+}
+
+// Runs a request the given number of times and prints the median and the 99th
+// percentile of its latency.
+void measure(const char *Name, int Iterations,
+             const std::function<void()> &Request) {
+  for (int I = 0; I < WarmupIterations; ++I)
+    Request();
+  std::vector<double> Microseconds(Iterations);
+  for (int I = 0; I < Iterations; ++I) {
+    auto Start = std::chrono::steady_clock::now();
+    Request();
+    auto End = std::chrono::steady_clock::now();
+    Microseconds[I] =
+        std::chrono::duration<double, std::micro>(End - Start).count();
+  }
+  std::sort(Microseconds.begin(), Microseconds.end());
+  std::printf("%-10s median %9.1f us   p99 %9.1f us\n", Name,
+              Microseconds[Iterations / 2],
+              Microseconds[Iterations * 99 / 100]);
+}
+
+// Enqueues the work of one request.
+template <typename InputTy, typename OutputTy>
+void enqueueRequest(acxxel::Stream &Stream, InputTy &Input,
+                    acxxel::DeviceMemory<float> &DeviceX, OutputTy &Output) {
+  Stream.asyncCopyHToD(Input, DeviceX);
+  scaleKernel<<<(ElementCount + BlockSize - 1) / BlockSize, BlockSize, 0,
+                Stream>>>(2.f, DeviceX, ElementCount);
+  Stream.asyncCopyDToH(DeviceX, Output);
+}
+
+} // namespace
+
+int main(int Argc, char **Argv) {
+  int Iterations = Argc > 1 ? std::atoi(Argv[1]) : 1000;
+  if (Iterations <= 0) {
+    std::fprintf(stderr, "usage: %s [iterations]\n", Argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  acxxel::Platform *CUDA = take(acxxel::getCUDAPlatform(), "getCUDAPlatform");
+
+  std::vector<float> PageableInput(ElementCount, 1.f);
+  std::vector<float> PageableOutput(ElementCount);
+  measure("register", Iterations, [&] {
+    acxxel::Stream Stream = take(CUDA->createStream(), "createStream");
+    acxxel::Event Done = take(CUDA->createEvent(), "createEvent");
+    auto Input = take(CUDA->registerHostMem(PageableInput), "registerHostMem");
+    auto Output =
+        take(CUDA->registerHostMem(PageableOutput), "registerHostMem");
+    auto DeviceX = take(CUDA->mallocD<float>(ElementCount), "mallocD");
+    enqueueRequest(Stream, Input, DeviceX, Output);
+    check(Stream.enqueueEvent(Done).takeStatus(), "register request");
+    check(Done.sync(), "Event::sync");
+  });
+
+  measure("cached", Iterations, [&] {
+    acxxel::Stream Stream = take(CUDA->createStream(), "createStream");
+    acxxel::Event Done = take(CUDA->createEvent(), "createEvent");
+    auto Input =
+        take(CUDA->newAsyncHostMem<float>(ElementCount), "newAsyncHostMem");
+    auto Output =
+        take(CUDA->newAsyncHostMem<float>(ElementCount), "newAsyncHostMem");
+    auto DeviceX = take(CUDA->mallocD<float>(ElementCount), "mallocD");
+    enqueueRequest(Stream, Input, DeviceX, Output);
+    check(Stream.enqueueEvent(Done).takeStatus(), "cached request");
+    check(Done.sync(), "Event::sync");
+  });
+
+  {
+    acxxel::Stream Stream = take(CUDA->createStream(), "createStream");
+    acxxel::Event Done = take(CUDA->createEvent(), "createEvent");
+    auto Input =
+        take(CUDA->newAsyncHostMem<float>(ElementCount), "newAsyncHostMem");
+    auto Output =
+        take(CUDA->newAsyncHostMem<float>(ElementCount), "newAsyncHostMem");
+    auto DeviceX = take(CUDA->mallocD<float>(ElementCount), "mallocD");
+    enqueueRequest(Stream.beginCapture(), Input, DeviceX, Output);
+    acxxel::Graph Request = take(Stream.endCapture(), "endCapture");
+    measure("graph", Iterations, [&] {
+      check(Stream.asyncGraphLaunch(Request).enqueueEvent(Done).takeStatus(),
+            "graph request");
+      check(Done.sync(), "Event::sync");
+    });
+  }
+
+  check(CUDA->releaseCachedMemory(), "releaseCachedMemory");
+}
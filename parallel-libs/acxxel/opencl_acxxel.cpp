@@ -68,6 +68,8 @@ public:
 
   Expected<Event> createEvent(int DeviceIndex) override;
 
+  Status releaseCachedMemory() override;
+
   Expected<Program> createProgramFromSource(Span<const char> Source,
                                             int DeviceIndex) override;
 
@@ -115,6 +117,11 @@ protected:
   Expected<float> getSecondsBetweenEvents(void *StartEvent,
                                           void *EndEvent) override;
 
+  Status streamBeginCapture(void *Stream) override;
+  Expected<void *> streamEndCapture(void *Stream) override;
+  HandleDestructor getGraphHandleDestructor() override;
+  Status enqueueGraphLaunch(void *Graph, void *Stream) override;
+
   Expected<void *> rawCreateKernel(void *Program,
                                    const std::string &Name) override;
   HandleDestructor getKernelHandleDestructor() override;
@@ -306,6 +313,11 @@ OpenCLPlatform::rawGetDeviceSymbolSize(const void * /*Symbol*/,
 
 static void noOpHandleDestructor(void *) {}
 
+Status OpenCLPlatform::releaseCachedMemory() {
+  // Memory is not cached for this platform.
+  return Status();
+}
+
 Status OpenCLPlatform::rawRegisterHostMem(const void * /*Memory*/,
                                           ptrdiff_t /*ByteCount*/) {
   // TODO(jhen): Do we want to do something to pin the memory here?
@@ -495,6 +507,24 @@ Expected<void *> OpenCLPlatform::rawCreateKernel(void *Program,
   return Kernel;
 }
 
+Status OpenCLPlatform::streamBeginCapture(void * /*Stream*/) {
+  // This doesn't seem to have any equivalent in OpenCL.
+  return Status("not implemented");
+}
+
+Expected<void *> OpenCLPlatform::streamEndCapture(void * /*Stream*/) {
+  return Status("not implemented");
+}
+
+HandleDestructor OpenCLPlatform::getGraphHandleDestructor() {
+  return noOpHandleDestructor;
+}
+
+Status OpenCLPlatform::enqueueGraphLaunch(void * /*Graph*/,
+                                          void * /*Stream*/) {
+  return Status("not implemented");
+}
+
 static void openCLDestroyKernel(void *H) {
   logOpenCLWarning(clReleaseKernel(static_cast<cl_kernel>(H)),
                    "clReleaseKernel");
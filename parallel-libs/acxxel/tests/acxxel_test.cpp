@@ -401,6 +401,63 @@ TEST_P(AcxxelTest, WaitForEventsInAStream) {
   EXPECT_FALSE(Stream1.sync().isError());
 }
 
+TEST_P(AcxxelTest, ReuseStreamsAndEvents) {
+  acxxel::Platform *Platform = GetParam()().takeValue();
+  for (int I = 0; I < 3; ++I) {
+    acxxel::Stream Stream = Platform->createStream().takeValue();
+    acxxel::Event Event = Platform->createEvent().takeValue();
+    EXPECT_TRUE(Event.isDone());
+    EXPECT_FALSE(Stream.enqueueEvent(Event).takeStatus().isError());
+    EXPECT_FALSE(Stream.sync().isError());
+    EXPECT_TRUE(Event.isDone());
+  }
+}
+
+TEST_P(AcxxelTest, ReuseMemory) {
+  acxxel::Platform *Platform = GetParam()().takeValue();
+  acxxel::Stream Stream = Platform->createStream().takeValue();
+  constexpr size_t Length = 1000;
+  for (int Value = 0; Value < 3; ++Value) {
+    acxxel::OwnedAsyncHostMemory<int> A =
+        Platform->newAsyncHostMem<int>(Length).takeValue();
+    acxxel::OwnedAsyncHostMemory<int> B =
+        Platform->newAsyncHostMem<int>(Length).takeValue();
+    for (size_t I = 0; I < Length; ++I)
+      A[I] = Value;
+    acxxel::DeviceMemory<int> X = Platform->mallocD<int>(Length).takeValue();
+    EXPECT_FALSE(Stream.asyncCopyHToD(A, X).takeStatus().isError());
+    EXPECT_FALSE(Stream.asyncCopyDToH(X, B).takeStatus().isError());
+    EXPECT_FALSE(Stream.sync().isError());
+    for (size_t I = 0; I < Length; ++I)
+      EXPECT_EQ(Value, B[I]);
+  }
+  EXPECT_FALSE(Platform->releaseCachedMemory().isError());
+}
+
+#ifdef ACXXEL_ENABLE_CUDA
+TEST(AcxxelCUDATest, GraphLaunch) {
+  acxxel::Platform *Platform = acxxel::getCUDAPlatform().takeValue();
+  constexpr size_t Length = 10;
+  acxxel::DeviceMemory<uint32_t> X =
+      Platform->mallocD<uint32_t>(Length).takeValue();
+  acxxel::OwnedAsyncHostMemory<uint32_t> Host =
+      Platform->newAsyncHostMem<uint32_t>(Length).takeValue();
+  acxxel::Stream Stream = Platform->createStream().takeValue();
+  Stream.beginCapture().asyncMemsetD(X, 0x12).asyncCopyDToH(X, Host);
+  acxxel::Expected<acxxel::Graph> MaybeGraph = Stream.endCapture();
+  EXPECT_FALSE(MaybeGraph.isError()) << MaybeGraph.getError().getMessage();
+  acxxel::Graph Graph = MaybeGraph.takeValue();
+  for (int I = 0; I < 2; ++I) {
+    for (size_t J = 0; J < Length; ++J)
+      Host[J] = 0;
+    EXPECT_FALSE(Stream.asyncGraphLaunch(Graph).takeStatus().isError());
+    EXPECT_FALSE(Stream.sync().isError());
+    for (size_t J = 0; J < Length; ++J)
+      EXPECT_EQ(0x12121212u, Host[J]);
+  }
+}
+#endif
+
 #if defined(ACXXEL_ENABLE_CUDA) || defined(ACXXEL_ENABLE_OPENCL)
 INSTANTIATE_TEST_CASE_P(BothPlatformTest, AcxxelTest,
                         ::testing::Values(
@@ -31,9 +31,14 @@ enum class OMPGeneralSchedulingType {
   Runtime = 37
 };
 
+/// Modifier or-ed into a dynamic scheduling type to mark the loop
+/// nonmonotonic. Value taken from OpenMP's enum in kmp.h: sched_type.
+const int OMPNonmonotonicModifier = 1 << 30;
+
 extern int PollyNumThreads;
 extern OMPGeneralSchedulingType PollyScheduling;
 extern int PollyChunkSize;
+extern int PollyChunksPerThread;
 
 /// Create a scalar do/for-style loop.
 ///
@@ -53,6 +53,16 @@ protected:
   /// Returns True if 'LongType' is 64bit wide, otherwise: False.
   bool is64BitArch();
 
+  /// Create the chunk size of a dynamically scheduled loop, such that each
+  /// thread of the team gets about PollyChunksPerThread chunks.
+  ///
+  /// @param LB     The loop's lower bound.
+  /// @param UB     The loop's (inclusive) upper bound.
+  /// @param Stride The loop increment.
+  ///
+  /// @return A Value which holds the chunk size, which is at least one.
+  Value *createDynamicChunkSize(Value *LB, Value *UB, Value *Stride);
+
 public:
   // The functions below may be used if one does not want to generate a
   // specific OpenMP parallel loop, but generate individual parts of it
@@ -83,6 +93,11 @@ public:
   /// @return A Value ref which holds the current global thread number.
   Value *createCallGlobalThreadNum();
 
+  /// Create a runtime library call to get the number of threads in the team.
+  ///
+  /// @return A Value ref which holds the number of threads.
+  Value *createCallNumThreads();
+
   /// Create a runtime library call to request a number of threads.
   /// Which will be used in the next OpenMP section (by the next fork).
   ///
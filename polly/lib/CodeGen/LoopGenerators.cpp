@@ -27,6 +27,7 @@ using namespace polly;
 int polly::PollyNumThreads;
 OMPGeneralSchedulingType polly::PollyScheduling;
 int polly::PollyChunkSize;
+int polly::PollyChunksPerThread;
 
 static cl::opt<int, true>
     XPollyNumThreads("polly-num-threads",
@@ -55,6 +56,13 @@ static cl::opt<int, true>
                     cl::Hidden, cl::location(polly::PollyChunkSize),
                     cl::init(0), cl::Optional, cl::cat(PollyCategory));
 
+static cl::opt<int, true> XPollyChunksPerThread(
+    "polly-scheduling-chunks-per-thread",
+    cl::desc("Number of chunks per thread of a dynamically scheduled loop "
+             "without an explicit chunk size"),
+    cl::Hidden, cl::location(polly::PollyChunksPerThread), cl::init(8),
+    cl::Optional, cl::cat(PollyCategory));
+
 // We generate a loop of either of the following structures:
 //
 //              BeforeBB                      BeforeBB
@@ -193,6 +193,12 @@ ParallelLoopGeneratorKMP::createSubFn(Value *StrideNotUsed,
   Value *ChunkSize =
       ConstantInt::get(LongType, std::max<int>(PollyChunkSize, 1));
 
+  // Without an explicit chunk size, a dynamic loop would ask the runtime for
+  // every single iteration.
+  if (PollyChunkSize == 0 &&
+      PollyScheduling == OMPGeneralSchedulingType::Dynamic)
+    ChunkSize = createDynamicChunkSize(LB, AdjustedUB, Stride);
+
   switch (PollyScheduling) {
   case OMPGeneralSchedulingType::Dynamic:
   case OMPGeneralSchedulingType::Guided:
@@ -287,6 +293,20 @@ Value *ParallelLoopGeneratorKMP::createCallGlobalThreadNum() {
   return Builder.CreateCall(F, {SourceLocationInfo});
 }
 
+Value *ParallelLoopGeneratorKMP::createCallNumThreads() {
+  const std::string Name = "omp_get_num_threads";
+  Function *F = M->getFunction(Name);
+
+  // If F is not available, declare it.
+  if (!F) {
+    GlobalValue::LinkageTypes Linkage = Function::ExternalLinkage;
+    FunctionType *Ty = FunctionType::get(Builder.getInt32Ty(), false);
+    F = Function::Create(Ty, Linkage, Name, M);
+  }
+
+  return Builder.CreateCall(F, {});
+}
+
 void ParallelLoopGeneratorKMP::createCallPushNumThreads(Value *GlobalThreadID,
                                                         Value *NumThreads) {
   const std::string Name = "__kmpc_push_num_threads";
@@ -396,16 +416,23 @@ void ParallelLoopGeneratorKMP::createCallDispatchInit(Value *GlobalThreadID,
     F = Function::Create(Ty, Linkage, Name, M);
   }
 
+  // The iterations of a parallel loop are independent, so a dynamic loop is
+  // nonmonotonic: the runtime may give each thread its own range of chunks
+  // and let threads steal from each other, instead of handing out every
+  // chunk from a single shared counter.
+  int SchedType = int(getSchedType(PollyChunkSize, PollyScheduling));
+  if (PollyScheduling == OMPGeneralSchedulingType::Dynamic)
+    SchedType |= OMPNonmonotonicModifier;
+
   // The parameter 'ChunkSize' will hold strictly positive integer values,
   // regardless of PollyChunkSize's value
-  Value *Args[] = {
-      SourceLocationInfo,
-      GlobalThreadID,
-      Builder.getInt32(int(getSchedType(PollyChunkSize, PollyScheduling))),
-      LB,
-      UB,
-      Inc,
-      ChunkSize};
+  Value *Args[] = {SourceLocationInfo,
+                   GlobalThreadID,
+                   Builder.getInt32(SchedType),
+                   LB,
+                   UB,
+                   Inc,
+                   ChunkSize};
 
   Builder.CreateCall(F, Args);
 }
@@ -493,6 +520,21 @@ GlobalVariable *ParallelLoopGeneratorKMP::createSourceLocation() {
   return SourceLocDummy;
 }
 
+Value *ParallelLoopGeneratorKMP::createDynamicChunkSize(Value *LB, Value *UB,
+                                                       Value *Stride) {
+  Value *One = ConstantInt::get(LongType, 1);
+  Value *NumThreads =
+      Builder.CreateSExt(createCallNumThreads(), LongType, "polly.par.nthreads");
+  Value *Trips = Builder.CreateAdd(
+      Builder.CreateSDiv(Builder.CreateSub(UB, LB), Stride), One,
+      "polly.par.trips");
+  Value *NumChunks = Builder.CreateMul(
+      NumThreads, ConstantInt::get(LongType, std::max(PollyChunksPerThread, 1)));
+  Value *Size = Builder.CreateSDiv(Trips, NumChunks);
+  Value *TooSmall = Builder.CreateICmpSLT(Size, One);
+  return Builder.CreateSelect(TooSmall, One, Size, "polly.par.chunkSize");
+}
+
 bool ParallelLoopGeneratorKMP::is64BitArch() {
   return (LongType->getIntegerBitWidth() == 64);
 }
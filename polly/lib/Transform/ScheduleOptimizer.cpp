@@ -54,6 +54,7 @@
 #include "polly/ScopInfo.h"
 #include "polly/ScopPass.h"
 #include "polly/Simplify.h"
+#include "polly/Support/GICHelper.h"
 #include "polly/Support/ISLOStream.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
@@ -93,6 +94,18 @@ static cl::opt<std::string>
                  cl::Hidden, cl::init("yes"), cl::ZeroOrMore,
                  cl::cat(PollyCategory));
 
+static cl::opt<int> OptComputeOut(
+    "polly-opt-computeout",
+    cl::desc("Bound the rescheduling of a scop by a maximal amount of "
+             "computational steps (0 means no bound)"),
+    cl::Hidden, cl::init(1000000), cl::ZeroOrMore, cl::cat(PollyCategory));
+
+static cl::opt<bool> ComputeOutTiling(
+    "polly-opt-computeout-tiling",
+    cl::desc("Tile the original schedule where legal if rescheduling a scop "
+             "runs out of computational steps"),
+    cl::Hidden, cl::init(true), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 static cl::opt<int> MaxConstantTerm(
     "polly-opt-max-constant-term",
     cl::desc("The maximal constant term allowed (-1 is unlimited)"), cl::Hidden,
@@ -270,6 +283,9 @@ static cl::opt<bool> OptimizedScops(
 STATISTIC(ScopsProcessed, "Number of scops processed");
 STATISTIC(ScopsRescheduled, "Number of scops rescheduled");
 STATISTIC(ScopsOptimized, "Number of scops optimized");
+STATISTIC(ScopsComputedOut,
+          "Number of scops whose rescheduling ran out of computational steps");
+STATISTIC(ScopsTiledOnly, "Number of scops tiled without rescheduling");
 
 STATISTIC(NumAffineLoopsOptimized, "Number of affine loops optimized");
 STATISTIC(NumBoxedLoopsOptimized, "Number of boxed loops optimized");
@@ -1379,6 +1395,74 @@ bool ScheduleTreeOptimizer::isProfitableSchedule(Scop &S,
   return changed;
 }
 
+/// Check whether a band with partial schedule @p Partial, placed at @p Node,
+/// can be tiled.
+///
+/// It can if no dependence @p Deps between instances that share the prefix
+/// schedule of @p Node has a negative distance in any of the band's members.
+static bool isPermutableBand(isl::schedule_node Node,
+                             isl::multi_union_pw_aff Partial,
+                             isl::union_map Deps) {
+  isl::union_map Prefix = Node.get_prefix_schedule_union_map();
+  Deps = Deps.intersect(Prefix.apply_range(Prefix.reverse()));
+  isl::union_map Schedule = isl::union_map::from(Partial);
+  isl::union_set Distances =
+      Deps.apply_domain(Schedule).apply_range(Schedule).deltas();
+  if (!Distances)
+    return false;
+
+  bool Permutable = true;
+  Distances.foreach_set([&Permutable](isl::set Set) -> isl::stat {
+    isl::set NonNegative = Set;
+    for (int i = 0, Dims = Set.dim(isl::dim::set); i < Dims; i++)
+      NonNegative = NonNegative.lower_bound_si(isl::dim::set, i, 0);
+    if (!Set.is_subset(NonNegative).is_true()) {
+      Permutable = false;
+      return isl::stat::error();
+    }
+    return isl::stat::ok();
+  });
+  return Permutable;
+}
+
+/// Merge perfectly nested bands below @p Node into permutable bands, as far
+/// as the dependences @p Deps allow.
+///
+/// The schedule tree built for a scop has a one-dimensional band per loop,
+/// none of them marked permutable, so none of them would be tiled.
+static isl::schedule_node markPermutableBands(isl::schedule_node Node,
+                                              isl::union_map Deps) {
+  if (!Node)
+    return Node;
+
+  if (isl_schedule_node_get_type(Node.get()) == isl_schedule_node_band) {
+    auto Partial =
+        isl::manage(isl_schedule_node_band_get_partial_schedule(Node.get()));
+    bool Merged = false;
+    while (isl_schedule_node_n_children(Node.get()) == 1) {
+      isl::schedule_node Child = Node.child(0);
+      if (isl_schedule_node_get_type(Child.get()) != isl_schedule_node_band)
+        break;
+      auto Combined = Partial.flat_range_product(isl::manage(
+          isl_schedule_node_band_get_partial_schedule(Child.get())));
+      if (!isPermutableBand(Node, Combined, Deps))
+        break;
+      Node = isl::manage(isl_schedule_node_delete(Child.release())).parent();
+      Node = isl::manage(isl_schedule_node_delete(Node.release()));
+      Node = Node.insert_partial_schedule(Combined);
+      Partial = Combined;
+      Merged = true;
+    }
+    if (Merged)
+      Node = isl::manage(
+          isl_schedule_node_band_set_permutable(Node.release(), 1));
+  }
+
+  for (int i = 0, N = isl_schedule_node_n_children(Node.get()); i < N; i++)
+    Node = markPermutableBands(Node.child(i), Deps).parent();
+  return Node;
+}
+
 namespace {
 
 class IslScheduleOptimizer : public ScopPass {
@@ -1592,7 +1676,30 @@ bool IslScheduleOptimizer::runOnScop(Scop &S) {
   SC = SC.set_proximity(Proximity);
   SC = SC.set_validity(Validity);
   SC = SC.set_coincidence(Validity);
-  auto Schedule = SC.compute_schedule();
+  isl::schedule Schedule;
+  bool ComputedOut;
+  {
+    IslMaxOperationsGuard MaxOpGuard(Ctx, OptComputeOut);
+    Schedule = SC.compute_schedule();
+    ComputedOut = MaxOpGuard.hasQuotaExceeded();
+  }
+
+  // Rescheduling a large scop can take very long. If it runs out of steps,
+  // fall back to tiling the loop nests as they are, which costs little more
+  // than checking the dependences of each nest.
+  bool Rescheduled = Schedule && !ComputedOut;
+  if (ComputedOut) {
+    ScopsComputedOut++;
+    LLVM_DEBUG(dbgs() << "Rescheduling ran out of computational steps\n");
+    Schedule = nullptr;
+    if (ComputeOutTiling) {
+      IslMaxOperationsGuard MaxOpGuard(Ctx, OptComputeOut);
+      Schedule = markPermutableBands(S.getScheduleTree().get_root(), Validity)
+                     .get_schedule();
+      if (MaxOpGuard.hasQuotaExceeded())
+        Schedule = nullptr;
+    }
+  }
   isl_options_set_on_error(Ctx, OnErrorStatus);
 
   walkScheduleTreeForStatistics(Schedule, 1);
@@ -1602,7 +1709,8 @@ bool IslScheduleOptimizer::runOnScop(Scop &S) {
   if (!Schedule)
     return false;
 
-  ScopsRescheduled++;
+  if (Rescheduled)
+    ScopsRescheduled++;
 
   LLVM_DEBUG({
     auto *P = isl_printer_to_str(Ctx);
@@ -1626,6 +1734,8 @@ bool IslScheduleOptimizer::runOnScop(Scop &S) {
 
   auto ScopStats = S.getStatistics();
   ScopsOptimized++;
+  if (!Rescheduled)
+    ScopsTiledOnly++;
   NumAffineLoopsOptimized += ScopStats.NumAffineLoops;
   NumBoxedLoopsOptimized += ScopStats.NumBoxedLoops;
 
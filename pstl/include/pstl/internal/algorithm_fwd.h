@@ -0,0 +1,93 @@
+// -*- C++ -*-
+//===-- algorithm_fwd.h ---------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_ALGORITHM_FWD_H
+#define _PSTL_ALGORITHM_FWD_H
+
+#include <iterator>
+#include <utility>
+
+#include "pstl_config.h"
+
+// Declarations of the parallel patterns that the glue headers call. The
+// definitions need the complete standard headers that include the glue, so
+// they are only pulled in by <execution>; see glue_execution_defs.h.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __internal
+{
+
+template <class _Size, class _Brick>
+void
+__pattern_walk_n(_Size __n, _Brick __brick);
+
+template <class _RandomAccessIterator, class _Function>
+void
+__pattern_for_each(_RandomAccessIterator __first, _RandomAccessIterator __last, _Function __f);
+
+template <class _RandomAccessIterator, class _Predicate>
+_RandomAccessIterator
+__pattern_find_if(_RandomAccessIterator __first, _RandomAccessIterator __last, _Predicate __pred);
+
+template <class _RandomAccessIterator, class _BinaryPredicate>
+_RandomAccessIterator
+__pattern_adjacent_find(_RandomAccessIterator __first, _RandomAccessIterator __last, _BinaryPredicate __pred);
+
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _BinaryPredicate>
+std::pair<_RandomAccessIterator1, _RandomAccessIterator2>
+__pattern_mismatch(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1, _RandomAccessIterator2 __first2,
+                   _RandomAccessIterator2 __last2, _BinaryPredicate __pred);
+
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _Compare>
+bool
+__pattern_lexicographical_compare(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1,
+                                  _RandomAccessIterator2 __first2, _RandomAccessIterator2 __last2, _Compare __comp);
+
+template <class _RandomAccessIterator, class _Compare>
+_RandomAccessIterator
+__pattern_is_heap_until(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp);
+
+template <class _RandomAccessIterator, class _Predicate>
+typename std::iterator_traits<_RandomAccessIterator>::difference_type
+__pattern_count_if(_RandomAccessIterator __first, _RandomAccessIterator __last, _Predicate __pred);
+
+template <class _RandomAccessIterator, class _Compare>
+_RandomAccessIterator
+__pattern_min_element(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp);
+
+template <class _RandomAccessIterator, class _Compare>
+_RandomAccessIterator
+__pattern_max_element(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp);
+
+template <class _RandomAccessIterator, class _Compare>
+std::pair<_RandomAccessIterator, _RandomAccessIterator>
+__pattern_minmax_element(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp);
+
+template <class _RandomAccessIterator, class _Compare>
+void
+__pattern_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp);
+
+template <class _RandomAccessIterator, class _Compare>
+void
+__pattern_stable_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp);
+
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _RandomAccessIterator3, class _Compare>
+_RandomAccessIterator3
+__pattern_merge(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1, _RandomAccessIterator2 __first2,
+                _RandomAccessIterator2 __last2, _RandomAccessIterator3 __result, _Compare __comp);
+
+} // namespace __internal
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_ALGORITHM_FWD_H */
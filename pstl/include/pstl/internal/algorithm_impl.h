@@ -0,0 +1,295 @@
+// -*- C++ -*-
+//===-- algorithm_impl.h --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_ALGORITHM_IMPL_H
+#define _PSTL_ALGORITHM_IMPL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "algorithm_fwd.h"
+#include "execution_impl.h"
+#include "parallel_backend.h"
+
+// The parallel versions of the algorithms. They take random access
+// iterators; the glue runs everything else sequentially.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __internal
+{
+
+//------------------------------------------------------------------------
+// walk
+//------------------------------------------------------------------------
+
+// Calls __brick(__b, __e) on index subranges of [0, __n).
+template <class _Size, class _Brick>
+void
+__pattern_walk_n(_Size __n, _Brick __brick)
+{
+    __par_backend::__parallel_for(_Size(0), __n, __brick);
+}
+
+template <class _RandomAccessIterator, class _Function>
+void
+__pattern_for_each(_RandomAccessIterator __first, _RandomAccessIterator __last, _Function __f)
+{
+    __par_backend::__parallel_for(__first, __last, [__f](_RandomAccessIterator __b, _RandomAccessIterator __e) {
+        std::for_each(__b, __e, __f);
+    });
+}
+
+//------------------------------------------------------------------------
+// find
+//------------------------------------------------------------------------
+
+// The smallest __i in [0, __n) for which __pred(__i) holds, or __n. Chunks
+// that start past a known match are skipped.
+template <class _Size, class _Predicate>
+_Size
+__parallel_find_index(_Size __n, _Predicate __pred)
+{
+    std::atomic<_Size> __found(__n);
+    __par_backend::__parallel_for(_Size(0), __n, [&__found, &__pred](_Size __b, _Size __e) {
+        for (; __b != __e; ++__b)
+        {
+            if (__b >= __found.load(std::memory_order_relaxed))
+                return;
+            if (__pred(__b))
+            {
+                _Size __current = __found.load(std::memory_order_relaxed);
+                while (__b < __current && !__found.compare_exchange_weak(__current, __b))
+                {
+                }
+                return;
+            }
+        }
+    });
+    return __found.load();
+}
+
+template <class _RandomAccessIterator, class _Predicate>
+_RandomAccessIterator
+__pattern_find_if(_RandomAccessIterator __first, _RandomAccessIterator __last, _Predicate __pred)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator>::difference_type _Size;
+    return __first + __parallel_find_index(__last - __first, [__first, &__pred](_Size __i) -> bool {
+               return __pred(__first[__i]);
+           });
+}
+
+// The first __i for which __pred(__first[__i], __first[__i + 1]) holds.
+template <class _RandomAccessIterator, class _BinaryPredicate>
+_RandomAccessIterator
+__pattern_adjacent_find(_RandomAccessIterator __first, _RandomAccessIterator __last, _BinaryPredicate __pred)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator>::difference_type _Size;
+    const _Size __n = __last - __first;
+    if (__n < 2)
+        return __last;
+    const _Size __i = __parallel_find_index(__n - 1, [__first, &__pred](_Size __i) -> bool {
+        return __pred(__first[__i], __first[__i + 1]);
+    });
+    return __i == __n - 1 ? __last : __first + __i;
+}
+
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _BinaryPredicate>
+std::pair<_RandomAccessIterator1, _RandomAccessIterator2>
+__pattern_mismatch(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1, _RandomAccessIterator2 __first2,
+                   _RandomAccessIterator2 __last2, _BinaryPredicate __pred)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator1>::difference_type _Size;
+    const _Size __n = std::min<_Size>(__last1 - __first1, __last2 - __first2);
+    const _Size __i = __parallel_find_index(__n, [__first1, __first2, &__pred](_Size __i) -> bool {
+        return !__pred(__first1[__i], __first2[__i]);
+    });
+    return std::make_pair(__first1 + __i, __first2 + __i);
+}
+
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _Compare>
+bool
+__pattern_lexicographical_compare(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1,
+                                  _RandomAccessIterator2 __first2, _RandomAccessIterator2 __last2, _Compare __comp)
+{
+    auto __m = __pattern_mismatch(__first1, __last1, __first2, __last2, [&__comp](const auto& __x, const auto& __y) {
+        return !__comp(__x, __y) && !__comp(__y, __x);
+    });
+    if (__m.first == __last1)
+        return __m.second != __last2;
+    if (__m.second == __last2)
+        return false;
+    return __comp(*__m.first, *__m.second);
+}
+
+template <class _RandomAccessIterator, class _Compare>
+_RandomAccessIterator
+__pattern_is_heap_until(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator>::difference_type _Size;
+    const _Size __n = __last - __first;
+    if (__n < 2)
+        return __last;
+    return __first + 1 + __parallel_find_index(__n - 1, [__first, &__comp](_Size __i) -> bool {
+               return __comp(__first[__i / 2], __first[__i + 1]);
+           });
+}
+
+//------------------------------------------------------------------------
+// count, min_element, max_element
+//------------------------------------------------------------------------
+
+template <class _RandomAccessIterator, class _Predicate>
+typename std::iterator_traits<_RandomAccessIterator>::difference_type
+__pattern_count_if(_RandomAccessIterator __first, _RandomAccessIterator __last, _Predicate __pred)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator>::difference_type _Size;
+    return __par_backend::__parallel_reduce(
+        __first, __last, _Size(0),
+        [&__pred](_RandomAccessIterator __b, _RandomAccessIterator __e, _Size __init) -> _Size {
+            return __init + std::count_if(__b, __e, __pred);
+        },
+        std::plus<_Size>());
+}
+
+// The first smallest element.
+template <class _RandomAccessIterator, class _Compare>
+_RandomAccessIterator
+__pattern_min_element(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    auto __pick = [__last, &__comp](_RandomAccessIterator __x, _RandomAccessIterator __y) {
+        if (__x == __last)
+            return __y;
+        if (__y == __last)
+            return __x;
+        return __comp(*__y, *__x) ? __y : __x;
+    };
+    return __par_backend::__parallel_reduce(
+        __first, __last, __last,
+        [&__comp, &__pick](_RandomAccessIterator __b, _RandomAccessIterator __e, _RandomAccessIterator __init) {
+            return __pick(__init, std::min_element(__b, __e, __comp));
+        },
+        __pick);
+}
+
+// The first largest element.
+template <class _RandomAccessIterator, class _Compare>
+_RandomAccessIterator
+__pattern_max_element(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    auto __pick = [__last, &__comp](_RandomAccessIterator __x, _RandomAccessIterator __y) {
+        if (__x == __last)
+            return __y;
+        if (__y == __last)
+            return __x;
+        return __comp(*__x, *__y) ? __y : __x;
+    };
+    return __par_backend::__parallel_reduce(
+        __first, __last, __last,
+        [&__comp, &__pick](_RandomAccessIterator __b, _RandomAccessIterator __e, _RandomAccessIterator __init) {
+            return __pick(__init, std::max_element(__b, __e, __comp));
+        },
+        __pick);
+}
+
+// The first smallest and the last largest element.
+template <class _RandomAccessIterator, class _Compare>
+std::pair<_RandomAccessIterator, _RandomAccessIterator>
+__pattern_minmax_element(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    typedef std::pair<_RandomAccessIterator, _RandomAccessIterator> _Result;
+    auto __pick = [__last, &__comp](const _Result& __x, const _Result& __y) {
+        if (__x.first == __last)
+            return __y;
+        if (__y.first == __last)
+            return __x;
+        return _Result(__comp(*__y.first, *__x.first) ? __y.first : __x.first,
+                       __comp(*__y.second, *__x.second) ? __x.second : __y.second);
+    };
+    return __par_backend::__parallel_reduce(
+        __first, __last, _Result(__last, __last),
+        [&__comp, &__pick](_RandomAccessIterator __b, _RandomAccessIterator __e, const _Result& __init) {
+            return __pick(__init, std::minmax_element(__b, __e, __comp));
+        },
+        __pick);
+}
+
+//------------------------------------------------------------------------
+// sort, merge
+//------------------------------------------------------------------------
+
+template <class _RandomAccessIterator, class _Compare>
+void
+__pattern_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    __par_backend::__parallel_stable_sort(
+        __first, __last, __comp,
+        [](_RandomAccessIterator __b, _RandomAccessIterator __e, _Compare __c) { std::sort(__b, __e, __c); });
+}
+
+template <class _RandomAccessIterator, class _Compare>
+void
+__pattern_stable_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    __par_backend::__parallel_stable_sort(
+        __first, __last, __comp,
+        [](_RandomAccessIterator __b, _RandomAccessIterator __e, _Compare __c) { std::stable_sort(__b, __e, __c); });
+}
+
+// Splits the merge into pieces: the longer input is cut evenly, and the cut
+// in the other input keeps equal elements of the first input first.
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _RandomAccessIterator3, class _Compare>
+_RandomAccessIterator3
+__pattern_merge(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1, _RandomAccessIterator2 __first2,
+                _RandomAccessIterator2 __last2, _RandomAccessIterator3 __result, _Compare __comp)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator1>::difference_type _Size1;
+    typedef typename std::iterator_traits<_RandomAccessIterator2>::difference_type _Size2;
+    const _Size1 __n1 = __last1 - __first1;
+    const _Size2 __n2 = __last2 - __first2;
+    const std::size_t __pieces = __par_backend::__chunk_count(std::size_t(__n1) + std::size_t(__n2),
+                                                              __par_backend::__concurrency());
+
+    auto __cut = [&](std::size_t __i) -> std::pair<_Size1, _Size2> {
+        if (__i == 0)
+            return {0, 0};
+        if (__i == __pieces)
+            return {__n1, __n2};
+        if (std::size_t(__n1) >= std::size_t(__n2))
+        {
+            const _Size1 __c1 = __par_backend::__chunk_begin(__n1, __pieces, __i);
+            return {__c1, std::lower_bound(__first2, __last2, __first1[__c1], __comp) - __first2};
+        }
+        const _Size2 __c2 = __par_backend::__chunk_begin(__n2, __pieces, __i);
+        return {std::upper_bound(__first1, __last1, __first2[__c2], __comp) - __first1, __c2};
+    };
+    __par_backend::__parallel_for(std::size_t(0), __pieces, [&](std::size_t __b, std::size_t __e) {
+        for (; __b != __e; ++__b)
+        {
+            const std::pair<_Size1, _Size2> __from = __cut(__b);
+            const std::pair<_Size1, _Size2> __to = __cut(__b + 1);
+            std::merge(__first1 + __from.first, __first1 + __to.first, __first2 + __from.second,
+                       __first2 + __to.second, __result + (__from.first + __from.second), __comp);
+        }
+    }, 1);
+    return __result + (__n1 + __n2);
+}
+
+} // namespace __internal
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_ALGORITHM_IMPL_H */
@@ -0,0 +1,60 @@
+// -*- C++ -*-
+//===-- execution_impl.h --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_EXECUTION_IMPL_H
+#define _PSTL_EXECUTION_IMPL_H
+
+#include <iterator>
+#include <type_traits>
+
+#include "execution_defs.h"
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __internal
+{
+
+template <class _ExecutionPolicy>
+struct __allows_parallel : std::false_type
+{
+};
+
+template <>
+struct __allows_parallel<__pstl::execution::parallel_policy> : std::true_type
+{
+};
+
+template <>
+struct __allows_parallel<__pstl::execution::parallel_unsequenced_policy> : std::true_type
+{
+};
+
+template <class... _IteratorTypes>
+struct __is_random_access
+    : std::conjunction<std::is_base_of<std::random_access_iterator_tag,
+                                       typename std::iterator_traits<_IteratorTypes>::iterator_category>...>
+{
+};
+
+// Whether an algorithm called with _ExecutionPolicy over _IteratorTypes runs
+// on the parallel backend. The others run the sequential algorithm, which
+// every policy allows.
+template <class _ExecutionPolicy, class... _IteratorTypes>
+using __is_parallelization_preferred =
+    std::integral_constant<bool, __allows_parallel<typename std::decay<_ExecutionPolicy>::type>::value &&
+                                     __is_random_access<_IteratorTypes...>::value>;
+
+} // namespace __internal
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_EXECUTION_IMPL_H */
@@ -0,0 +1,1073 @@
+// -*- C++ -*-
+//===-- glue_algorithm_impl.h ---------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_GLUE_ALGORITHM_IMPL_H
+#define _PSTL_GLUE_ALGORITHM_IMPL_H
+
+#include <functional>
+
+#include "algorithm_fwd.h"
+#include "execution_defs.h"
+#include "execution_impl.h"
+
+// The execution policy overloads of <algorithm>. Those without a parallel
+// pattern run the sequential algorithm, which is valid for every policy.
+
+namespace std
+{
+
+// [alg.any_of]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+any_of(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_find_if(__first, __last, __pred) != __last;
+    else
+        return std::any_of(__first, __last, __pred);
+}
+
+// [alg.all_of]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Pred>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+all_of(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Pred __pred)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_find_if(__first, __last, std::not_fn(__pred)) == __last;
+    else
+        return std::all_of(__first, __last, __pred);
+}
+
+// [alg.none_of]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+none_of(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_find_if(__first, __last, __pred) == __last;
+    else
+        return std::none_of(__first, __last, __pred);
+}
+
+// [alg.foreach]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Function>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+for_each(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Function __f)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        __pstl::__internal::__pattern_for_each(__first, __last, __f);
+    else
+        std::for_each(__first, __last, __f);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Function>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+for_each_n(_ExecutionPolicy&&, _ForwardIterator __first, _Size __n, _Function __f)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__n <= 0)
+            return __first;
+        __pstl::__internal::__pattern_for_each(__first, __first + __n, __f);
+        return __first + __n;
+    }
+    else
+        return std::for_each_n(__first, __n, __f);
+}
+
+// [alg.find]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+find_if(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_find_if(__first, __last, __pred);
+    else
+        return std::find_if(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+find_if_not(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    return std::find_if(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::not_fn(__pred));
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+find(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __value)
+{
+    return std::find_if(std::forward<_ExecutionPolicy>(__exec), __first, __last,
+                        [&__value](const auto& __x) -> bool { return __x == __value; });
+}
+
+// [alg.find.end]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator1>
+find_end(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __s_first,
+         _ForwardIterator2 __s_last, _BinaryPredicate __pred)
+{
+    return std::find_end(__first, __last, __s_first, __s_last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator1>
+find_end(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __s_first,
+         _ForwardIterator2 __s_last)
+{
+    return std::find_end(__first, __last, __s_first, __s_last);
+}
+
+// [alg.find_first_of]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator1>
+find_first_of(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+              _ForwardIterator2 __s_first, _ForwardIterator2 __s_last, _BinaryPredicate __pred)
+{
+    return std::find_if(std::forward<_ExecutionPolicy>(__exec), __first, __last, [&](const auto& __x) -> bool {
+        return std::any_of(__s_first, __s_last, [&](const auto& __y) -> bool { return __pred(__x, __y); });
+    });
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator1>
+find_first_of(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+              _ForwardIterator2 __s_first, _ForwardIterator2 __s_last)
+{
+    return std::find_first_of(std::forward<_ExecutionPolicy>(__exec), __first, __last, __s_first, __s_last,
+                              std::equal_to<>());
+}
+
+// [alg.adjacent_find]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+adjacent_find(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _BinaryPredicate __pred)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_adjacent_find(__first, __last, __pred);
+    else
+        return std::adjacent_find(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+adjacent_find(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last)
+{
+    return std::adjacent_find(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::equal_to<>());
+}
+
+// [alg.count]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy,
+                                                 typename iterator_traits<_ForwardIterator>::difference_type>
+count_if(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Predicate __pred)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_count_if(__first, __last, __pred);
+    else
+        return std::count_if(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy,
+                                                 typename iterator_traits<_ForwardIterator>::difference_type>
+count(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __value)
+{
+    return std::count_if(std::forward<_ExecutionPolicy>(__exec), __first, __last,
+                         [&__value](const auto& __x) -> bool { return __x == __value; });
+}
+
+// [alg.search]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator1>
+search(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __s_first,
+       _ForwardIterator2 __s_last, _BinaryPredicate __pred)
+{
+    return std::search(__first, __last, __s_first, __s_last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator1>
+search(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __s_first,
+       _ForwardIterator2 __s_last)
+{
+    return std::search(__first, __last, __s_first, __s_last);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Tp, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+search_n(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Size __count, const _Tp& __value,
+         _BinaryPredicate __pred)
+{
+    return std::search_n(__first, __last, __count, __value, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+search_n(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Size __count, const _Tp& __value)
+{
+    return std::search_n(__first, __last, __count, __value);
+}
+
+// [alg.copy]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+copy(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator1>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [=](_Size __b, _Size __e) {
+            std::copy(__first + __b, __first + __e, __result + __b);
+        });
+        return __result + (__last - __first);
+    }
+    else
+        return std::copy(__first, __last, __result);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _Size, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+copy_n(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _Size __n, _ForwardIterator2 __result)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+        return __n <= 0 ? __result
+                        : std::copy(std::forward<_ExecutionPolicy>(__exec), __first, __first + __n, __result);
+    else
+        return std::copy_n(__first, __n, __result);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+copy_if(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result,
+        _Predicate __pred)
+{
+    return std::copy_if(__first, __last, __result, __pred);
+}
+
+// [alg.swap]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+swap_ranges(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+            _ForwardIterator2 __first2)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator1>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last1 - __first1, [=](_Size __b, _Size __e) {
+            std::swap_ranges(__first1 + __b, __first1 + __e, __first2 + __b);
+        });
+        return __first2 + (__last1 - __first1);
+    }
+    else
+        return std::swap_ranges(__first1, __last1, __first2);
+}
+
+// [alg.transform]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _UnaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+transform(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result,
+          _UnaryOperation __op)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator1>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [=](_Size __b, _Size __e) {
+            std::transform(__first + __b, __first + __e, __result + __b, __op);
+        });
+        return __result + (__last - __first);
+    }
+    else
+        return std::transform(__first, __last, __result, __op);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator,
+          class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+transform(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+          _ForwardIterator __result, _BinaryOperation __op)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2, _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator1>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last1 - __first1, [=](_Size __b, _Size __e) {
+            std::transform(__first1 + __b, __first1 + __e, __first2 + __b, __result + __b, __op);
+        });
+        return __result + (__last1 - __first1);
+    }
+    else
+        return std::transform(__first1, __last1, __first2, __result, __op);
+}
+
+// [alg.replace]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _UnaryPredicate, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+replace_if(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _UnaryPredicate __pred,
+           const _Tp& __new_value)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        __pstl::__internal::__pattern_for_each(__first, __last, [&__pred, &__new_value](auto&& __x) {
+            if (__pred(__x))
+                __x = __new_value;
+        });
+    else
+        std::replace_if(__first, __last, __pred, __new_value);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+replace(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __old_value,
+        const _Tp& __new_value)
+{
+    std::replace_if(std::forward<_ExecutionPolicy>(__exec), __first, __last,
+                    [&__old_value](const auto& __x) -> bool { return __x == __old_value; }, __new_value);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _UnaryPredicate, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+replace_copy_if(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                _ForwardIterator2 __result, _UnaryPredicate __pred, const _Tp& __new_value)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator1>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [=, &__new_value](_Size __b, _Size __e) {
+            std::replace_copy_if(__first + __b, __first + __e, __result + __b, __pred, __new_value);
+        });
+        return __result + (__last - __first);
+    }
+    else
+        return std::replace_copy_if(__first, __last, __result, __pred, __new_value);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+replace_copy(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+             _ForwardIterator2 __result, const _Tp& __old_value, const _Tp& __new_value)
+{
+    return std::replace_copy_if(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result,
+                                [&__old_value](const auto& __x) -> bool { return __x == __old_value; },
+                                __new_value);
+}
+
+// [alg.fill]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+fill(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __value)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [__first, &__value](_Size __b, _Size __e) {
+            std::fill(__first + __b, __first + __e, __value);
+        });
+    }
+    else
+        std::fill(__first, __last, __value);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+fill_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __count, const _Tp& __value)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__count <= 0)
+            return __first;
+        std::fill(std::forward<_ExecutionPolicy>(__exec), __first, __first + __count, __value);
+        return __first + __count;
+    }
+    else
+        return std::fill_n(__first, __count, __value);
+}
+
+// [alg.generate]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Generator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+generate(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Generator __g)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [__first, __g](_Size __b, _Size __e) {
+            std::generate(__first + __b, __first + __e, __g);
+        });
+    }
+    else
+        std::generate(__first, __last, __g);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Generator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+generate_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __count, _Generator __g)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__count <= 0)
+            return __first;
+        std::generate(std::forward<_ExecutionPolicy>(__exec), __first, __first + __count, __g);
+        return __first + __count;
+    }
+    else
+        return std::generate_n(__first, __count, __g);
+}
+
+// [alg.remove]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Predicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+remove_copy_if(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _Predicate __pred)
+{
+    return std::remove_copy_if(__first, __last, __result, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+remove_copy(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result,
+            const _Tp& __value)
+{
+    return std::remove_copy(__first, __last, __result, __value);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _UnaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+remove_if(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _UnaryPredicate __pred)
+{
+    return std::remove_if(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+remove(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __value)
+{
+    return std::remove(__first, __last, __value);
+}
+
+// [alg.unique]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+unique(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _BinaryPredicate __pred)
+{
+    return std::unique(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+unique(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last)
+{
+    return std::unique(__first, __last);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+unique_copy(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result,
+            _BinaryPredicate __pred)
+{
+    return std::unique_copy(__first, __last, __result, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+unique_copy(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __result)
+{
+    return std::unique_copy(__first, __last, __result);
+}
+
+// [alg.reverse]
+
+template <class _ExecutionPolicy, class _BidirectionalIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+reverse(_ExecutionPolicy&&, _BidirectionalIterator __first, _BidirectionalIterator __last)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _BidirectionalIterator>::value)
+    {
+        typedef typename iterator_traits<_BidirectionalIterator>::difference_type _Size;
+        const _Size __n = __last - __first;
+        __pstl::__internal::__pattern_walk_n(__n / 2, [=](_Size __b, _Size __e) {
+            std::swap_ranges(__first + __b, __first + __e, std::reverse_iterator<_BidirectionalIterator>(__last - __b));
+        });
+    }
+    else
+        std::reverse(__first, __last);
+}
+
+template <class _ExecutionPolicy, class _BidirectionalIterator, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+reverse_copy(_ExecutionPolicy&&, _BidirectionalIterator __first, _BidirectionalIterator __last,
+             _ForwardIterator __d_first)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _BidirectionalIterator,
+                                                                     _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_BidirectionalIterator>::difference_type _Size;
+        const _Size __n = __last - __first;
+        __pstl::__internal::__pattern_walk_n(__n, [=](_Size __b, _Size __e) {
+            std::reverse_copy(__last - __e, __last - __b, __d_first + __b);
+        });
+        return __d_first + __n;
+    }
+    else
+        return std::reverse_copy(__first, __last, __d_first);
+}
+
+// [alg.rotate]
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+rotate(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __middle, _ForwardIterator __last)
+{
+    return std::rotate(__first, __middle, __last);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+rotate_copy(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __middle,
+            _ForwardIterator1 __last, _ForwardIterator2 __result)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+    {
+        _ForwardIterator2 __mid = std::copy(__exec, __middle, __last, __result);
+        return std::copy(__exec, __first, __middle, __mid);
+    }
+    else
+        return std::rotate_copy(__first, __middle, __last, __result);
+}
+
+// [alg.partitions]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _UnaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+is_partitioned(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _UnaryPredicate __pred)
+{
+    return std::is_partitioned(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _UnaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+partition(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _UnaryPredicate __pred)
+{
+    return std::partition(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _BidirectionalIterator, class _UnaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _BidirectionalIterator>
+stable_partition(_ExecutionPolicy&&, _BidirectionalIterator __first, _BidirectionalIterator __last,
+                 _UnaryPredicate __pred)
+{
+    return std::stable_partition(__first, __last, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _ForwardIterator1, class _ForwardIterator2,
+          class _UnaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, std::pair<_ForwardIterator1, _ForwardIterator2>>
+partition_copy(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last,
+               _ForwardIterator1 __out_true, _ForwardIterator2 __out_false, _UnaryPredicate __pred)
+{
+    return std::partition_copy(__first, __last, __out_true, __out_false, __pred);
+}
+
+// [alg.sort]
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+sort(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _RandomAccessIterator>::value)
+        __pstl::__internal::__pattern_sort(__first, __last, __comp);
+    else
+        std::sort(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+sort(_ExecutionPolicy&& __exec, _RandomAccessIterator __first, _RandomAccessIterator __last)
+{
+    std::sort(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+// [stable.sort]
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+stable_sort(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _RandomAccessIterator>::value)
+        __pstl::__internal::__pattern_stable_sort(__first, __last, __comp);
+    else
+        std::stable_sort(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+stable_sort(_ExecutionPolicy&& __exec, _RandomAccessIterator __first, _RandomAccessIterator __last)
+{
+    std::stable_sort(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+// [mismatch]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, std::pair<_ForwardIterator1, _ForwardIterator2>>
+mismatch(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+         _ForwardIterator2 __last2, _BinaryPredicate __pred)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+        return __pstl::__internal::__pattern_mismatch(__first1, __last1, __first2, __last2, __pred);
+    else
+        return std::mismatch(__first1, __last1, __first2, __last2, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, std::pair<_ForwardIterator1, _ForwardIterator2>>
+mismatch(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+         _ForwardIterator2 __first2, _BinaryPredicate __pred)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+        return std::mismatch(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2,
+                             __first2 + (__last1 - __first1), __pred);
+    else
+        return std::mismatch(__first1, __last1, __first2, __pred);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, std::pair<_ForwardIterator1, _ForwardIterator2>>
+mismatch(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+         _ForwardIterator2 __first2, _ForwardIterator2 __last2)
+{
+    return std::mismatch(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2, __last2,
+                         std::equal_to<>());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, std::pair<_ForwardIterator1, _ForwardIterator2>>
+mismatch(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+         _ForwardIterator2 __first2)
+{
+    return std::mismatch(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2, std::equal_to<>());
+}
+
+// [alg.equal]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+equal(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+      _ForwardIterator2 __first2, _BinaryPredicate __p)
+{
+    return std::mismatch(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2, __p).first ==
+           __last1;
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+equal(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+      _ForwardIterator2 __first2)
+{
+    return std::equal(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2, std::equal_to<>());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryPredicate>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+equal(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+      _ForwardIterator2 __first2, _ForwardIterator2 __last2, _BinaryPredicate __p)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+        return __last1 - __first1 == __last2 - __first2 &&
+               std::equal(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2, __p);
+    else
+        return std::equal(__first1, __last1, __first2, __last2, __p);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+equal(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+      _ForwardIterator2 __first2, _ForwardIterator2 __last2)
+{
+    return std::equal(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2, __last2,
+                      std::equal_to<>());
+}
+
+// [alg.move]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+move(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last, _ForwardIterator2 __d_first)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator1>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [=](_Size __b, _Size __e) {
+            std::move(__first + __b, __first + __e, __d_first + __b);
+        });
+        return __d_first + (__last - __first);
+    }
+    else
+        return std::move(__first, __last, __d_first);
+}
+
+// [partial.sort]
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+partial_sort(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __middle,
+             _RandomAccessIterator __last, _Compare __comp)
+{
+    std::partial_sort(__first, __middle, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+partial_sort(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __middle,
+             _RandomAccessIterator __last)
+{
+    std::partial_sort(__first, __middle, __last);
+}
+
+// [partial.sort.copy]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _RandomAccessIterator>
+partial_sort_copy(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last,
+                  _RandomAccessIterator __d_first, _RandomAccessIterator __d_last, _Compare __comp)
+{
+    return std::partial_sort_copy(__first, __last, __d_first, __d_last, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _RandomAccessIterator>
+partial_sort_copy(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last,
+                  _RandomAccessIterator __d_first, _RandomAccessIterator __d_last)
+{
+    return std::partial_sort_copy(__first, __last, __d_first, __d_last);
+}
+
+// [is.sorted]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+is_sorted_until(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        _ForwardIterator __it = __pstl::__internal::__pattern_adjacent_find(
+            __first, __last, [&__comp](const auto& __x, const auto& __y) -> bool { return __comp(__y, __x); });
+        return __it == __last ? __last : __it + 1;
+    }
+    else
+        return std::is_sorted_until(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+is_sorted_until(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last)
+{
+    return std::is_sorted_until(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+is_sorted(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Compare __comp)
+{
+    return std::is_sorted_until(std::forward<_ExecutionPolicy>(__exec), __first, __last, __comp) == __last;
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+is_sorted(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last)
+{
+    return std::is_sorted(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+// [alg.nth.element]
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+nth_element(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __nth,
+            _RandomAccessIterator __last, _Compare __comp)
+{
+    std::nth_element(__first, __nth, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+nth_element(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __nth,
+            _RandomAccessIterator __last)
+{
+    std::nth_element(__first, __nth, __last);
+}
+
+// [alg.merge]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator,
+          class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+merge(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+      _ForwardIterator2 __last2, _ForwardIterator __d_first, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_merge(__first1, __last1, __first2, __last2, __d_first, __comp);
+    else
+        return std::merge(__first1, __last1, __first2, __last2, __d_first, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+merge(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+      _ForwardIterator2 __last2, _ForwardIterator __d_first)
+{
+    return std::merge(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2, __last2, __d_first,
+                      std::less<>());
+}
+
+template <class _ExecutionPolicy, class _BidirectionalIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+inplace_merge(_ExecutionPolicy&&, _BidirectionalIterator __first, _BidirectionalIterator __middle,
+              _BidirectionalIterator __last, _Compare __comp)
+{
+    std::inplace_merge(__first, __middle, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _BidirectionalIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+inplace_merge(_ExecutionPolicy&&, _BidirectionalIterator __first, _BidirectionalIterator __middle,
+              _BidirectionalIterator __last)
+{
+    std::inplace_merge(__first, __middle, __last);
+}
+
+// [includes]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+includes(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+         _ForwardIterator2 __last2, _Compare __comp)
+{
+    return std::includes(__first1, __last1, __first2, __last2, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+includes(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+         _ForwardIterator2 __last2)
+{
+    return std::includes(__first1, __last1, __first2, __last2);
+}
+
+// [set.union], [set.intersection], [set.difference], [set.symmetric.difference]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator,
+          class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+set_union(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+          _ForwardIterator2 __last2, _ForwardIterator __result, _Compare __comp)
+{
+    return std::set_union(__first1, __last1, __first2, __last2, __result, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+set_union(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1, _ForwardIterator2 __first2,
+          _ForwardIterator2 __last2, _ForwardIterator __result)
+{
+    return std::set_union(__first1, __last1, __first2, __last2, __result);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator,
+          class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+set_intersection(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                 _ForwardIterator2 __first2, _ForwardIterator2 __last2, _ForwardIterator __result, _Compare __comp)
+{
+    return std::set_intersection(__first1, __last1, __first2, __last2, __result, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+set_intersection(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                 _ForwardIterator2 __first2, _ForwardIterator2 __last2, _ForwardIterator __result)
+{
+    return std::set_intersection(__first1, __last1, __first2, __last2, __result);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator,
+          class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+set_difference(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+               _ForwardIterator2 __first2, _ForwardIterator2 __last2, _ForwardIterator __result, _Compare __comp)
+{
+    return std::set_difference(__first1, __last1, __first2, __last2, __result, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+set_difference(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+               _ForwardIterator2 __first2, _ForwardIterator2 __last2, _ForwardIterator __result)
+{
+    return std::set_difference(__first1, __last1, __first2, __last2, __result);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator,
+          class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+set_symmetric_difference(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                         _ForwardIterator2 __first2, _ForwardIterator2 __last2, _ForwardIterator __result,
+                         _Compare __comp)
+{
+    return std::set_symmetric_difference(__first1, __last1, __first2, __last2, __result, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+set_symmetric_difference(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                         _ForwardIterator2 __first2, _ForwardIterator2 __last2, _ForwardIterator __result)
+{
+    return std::set_symmetric_difference(__first1, __last1, __first2, __last2, __result);
+}
+
+// [is.heap]
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _RandomAccessIterator>
+is_heap_until(_ExecutionPolicy&&, _RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _RandomAccessIterator>::value)
+        return __pstl::__internal::__pattern_is_heap_until(__first, __last, __comp);
+    else
+        return std::is_heap_until(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _RandomAccessIterator>
+is_heap_until(_ExecutionPolicy&& __exec, _RandomAccessIterator __first, _RandomAccessIterator __last)
+{
+    return std::is_heap_until(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+is_heap(_ExecutionPolicy&& __exec, _RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp)
+{
+    return std::is_heap_until(std::forward<_ExecutionPolicy>(__exec), __first, __last, __comp) == __last;
+}
+
+template <class _ExecutionPolicy, class _RandomAccessIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+is_heap(_ExecutionPolicy&& __exec, _RandomAccessIterator __first, _RandomAccessIterator __last)
+{
+    return std::is_heap(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+// [alg.min.max]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+min_element(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_min_element(__first, __last, __comp);
+    else
+        return std::min_element(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+min_element(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last)
+{
+    return std::min_element(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+max_element(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_max_element(__first, __last, __comp);
+    else
+        return std::max_element(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+max_element(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last)
+{
+    return std::max_element(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, std::pair<_ForwardIterator, _ForwardIterator>>
+minmax_element(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_minmax_element(__first, __last, __comp);
+    else
+        return std::minmax_element(__first, __last, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, std::pair<_ForwardIterator, _ForwardIterator>>
+minmax_element(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last)
+{
+    return std::minmax_element(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::less<>());
+}
+
+// [alg.lex.comparison]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Compare>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+lexicographical_compare(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                        _ForwardIterator2 __first2, _ForwardIterator2 __last2, _Compare __comp)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+        return __pstl::__internal::__pattern_lexicographical_compare(__first1, __last1, __first2, __last2, __comp);
+    else
+        return std::lexicographical_compare(__first1, __last1, __first2, __last2, __comp);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, bool>
+lexicographical_compare(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                        _ForwardIterator2 __first2, _ForwardIterator2 __last2)
+{
+    return std::lexicographical_compare(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2,
+                                        __last2, std::less<>());
+}
+
+} // namespace std
+
+#endif /* _PSTL_GLUE_ALGORITHM_IMPL_H */
@@ -0,0 +1,45 @@
+// -*- C++ -*-
+//===-- glue_execution_defs.h ---------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_GLUE_EXECUTION_DEFS_H
+#define _PSTL_GLUE_EXECUTION_DEFS_H
+
+#include <type_traits>
+
+#include "execution_defs.h"
+
+namespace std
+{
+// Type trait
+using __pstl::execution::is_execution_policy;
+template <class _Tp>
+constexpr bool is_execution_policy_v = __pstl::execution::is_execution_policy<_Tp>::value;
+
+namespace execution
+{
+// Standard C++ policy classes
+using __pstl::execution::parallel_policy;
+using __pstl::execution::parallel_unsequenced_policy;
+using __pstl::execution::sequenced_policy;
+using __pstl::execution::unsequenced_policy;
+
+// Standard predefined policy instances
+using __pstl::execution::par;
+using __pstl::execution::par_unseq;
+using __pstl::execution::seq;
+using __pstl::execution::unseq;
+} // namespace execution
+} // namespace std
+
+// The parallel patterns behind the execution policy overloads, which the
+// glue in <algorithm>, <memory> and <numeric> only declares.
+#include "algorithm_impl.h"
+#include "numeric_impl.h"
+
+#endif /* _PSTL_GLUE_EXECUTION_DEFS_H */
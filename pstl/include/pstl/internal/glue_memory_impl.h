@@ -0,0 +1,225 @@
+// -*- C++ -*-
+//===-- glue_memory_impl.h ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_GLUE_MEMORY_IMPL_H
+#define _PSTL_GLUE_MEMORY_IMPL_H
+
+#include "algorithm_fwd.h"
+#include "execution_defs.h"
+#include "execution_impl.h"
+
+// The execution policy overloads of the specialized memory algorithms. Each
+// parallel task runs the sequential algorithm on its subrange, so an
+// exception still destroys what that subrange had constructed.
+
+namespace std
+{
+
+// [uninitialized.copy]
+
+template <class _ExecutionPolicy, class _InputIterator, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+uninitialized_copy(_ExecutionPolicy&&, _InputIterator __first, _InputIterator __last, _ForwardIterator __result)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _InputIterator,
+                                                                     _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_InputIterator>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [=](_Size __b, _Size __e) {
+            std::uninitialized_copy(__first + __b, __first + __e, __result + __b);
+        });
+        return __result + (__last - __first);
+    }
+    else
+        return std::uninitialized_copy(__first, __last, __result);
+}
+
+template <class _ExecutionPolicy, class _InputIterator, class _Size, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+uninitialized_copy_n(_ExecutionPolicy&& __exec, _InputIterator __first, _Size __n, _ForwardIterator __result)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _InputIterator,
+                                                                     _ForwardIterator>::value)
+        return __n <= 0 ? __result
+                        : std::uninitialized_copy(std::forward<_ExecutionPolicy>(__exec), __first, __first + __n,
+                                                  __result);
+    else
+        return std::uninitialized_copy_n(__first, __n, __result);
+}
+
+// [uninitialized.move]
+
+template <class _ExecutionPolicy, class _InputIterator, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+uninitialized_move(_ExecutionPolicy&&, _InputIterator __first, _InputIterator __last, _ForwardIterator __result)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _InputIterator,
+                                                                     _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_InputIterator>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [=](_Size __b, _Size __e) {
+            std::uninitialized_move(__first + __b, __first + __e, __result + __b);
+        });
+        return __result + (__last - __first);
+    }
+    else
+        return std::uninitialized_move(__first, __last, __result);
+}
+
+template <class _ExecutionPolicy, class _InputIterator, class _Size, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, std::pair<_InputIterator, _ForwardIterator>>
+uninitialized_move_n(_ExecutionPolicy&& __exec, _InputIterator __first, _Size __n, _ForwardIterator __result)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _InputIterator,
+                                                                     _ForwardIterator>::value)
+    {
+        if (__n <= 0)
+            return {__first, __result};
+        return {__first + __n, std::uninitialized_move(std::forward<_ExecutionPolicy>(__exec), __first,
+                                                       __first + __n, __result)};
+    }
+    else
+        return std::uninitialized_move_n(__first, __n, __result);
+}
+
+// [uninitialized.fill]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+uninitialized_fill(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, const _Tp& __value)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [__first, &__value](_Size __b, _Size __e) {
+            std::uninitialized_fill(__first + __b, __first + __e, __value);
+        });
+    }
+    else
+        std::uninitialized_fill(__first, __last, __value);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+uninitialized_fill_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __n, const _Tp& __value)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__n <= 0)
+            return __first;
+        std::uninitialized_fill(std::forward<_ExecutionPolicy>(__exec), __first, __first + __n, __value);
+        return __first + __n;
+    }
+    else
+        return std::uninitialized_fill_n(__first, __n, __value);
+}
+
+// [specialized.destroy]
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+destroy(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator>::value_type _ValueType;
+        if constexpr (!is_trivially_destructible_v<_ValueType>)
+        {
+            typedef typename iterator_traits<_ForwardIterator>::difference_type _Size;
+            __pstl::__internal::__pattern_walk_n(__last - __first, [__first](_Size __b, _Size __e) {
+                std::destroy(__first + __b, __first + __e);
+            });
+        }
+    }
+    else
+        std::destroy(__first, __last);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+destroy_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __n)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__n <= 0)
+            return __first;
+        std::destroy(std::forward<_ExecutionPolicy>(__exec), __first, __first + __n);
+        return __first + __n;
+    }
+    else
+        return std::destroy_n(__first, __n);
+}
+
+// [uninitialized.construct.default]
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+uninitialized_default_construct(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [__first](_Size __b, _Size __e) {
+            std::uninitialized_default_construct(__first + __b, __first + __e);
+        });
+    }
+    else
+        std::uninitialized_default_construct(__first, __last);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+uninitialized_default_construct_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __n)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__n <= 0)
+            return __first;
+        std::uninitialized_default_construct(std::forward<_ExecutionPolicy>(__exec), __first, __first + __n);
+        return __first + __n;
+    }
+    else
+        return std::uninitialized_default_construct_n(__first, __n);
+}
+
+// [uninitialized.construct.value]
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, void>
+uninitialized_value_construct(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator>::difference_type _Size;
+        __pstl::__internal::__pattern_walk_n(__last - __first, [__first](_Size __b, _Size __e) {
+            std::uninitialized_value_construct(__first + __b, __first + __e);
+        });
+    }
+    else
+        std::uninitialized_value_construct(__first, __last);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Size>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator>
+uninitialized_value_construct_n(_ExecutionPolicy&& __exec, _ForwardIterator __first, _Size __n)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+    {
+        if (__n <= 0)
+            return __first;
+        std::uninitialized_value_construct(std::forward<_ExecutionPolicy>(__exec), __first, __first + __n);
+        return __first + __n;
+    }
+    else
+        return std::uninitialized_value_construct_n(__first, __n);
+}
+
+} // namespace std
+
+#endif /* _PSTL_GLUE_MEMORY_IMPL_H */
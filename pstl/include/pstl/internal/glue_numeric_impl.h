@@ -0,0 +1,232 @@
+// -*- C++ -*-
+//===-- glue_numeric_impl.h -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_GLUE_NUMERIC_IMPL_H
+#define _PSTL_GLUE_NUMERIC_IMPL_H
+
+#include <functional>
+#include <optional>
+#include <type_traits>
+
+#include "algorithm_fwd.h"
+#include "execution_defs.h"
+#include "execution_impl.h"
+#include "numeric_fwd.h"
+#include "utils.h"
+
+namespace std
+{
+
+// [transform.reduce]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp,
+          class _BinaryOperation1, class _BinaryOperation2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+transform_reduce(_ExecutionPolicy&&, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                 _ForwardIterator2 __first2, _Tp __init, _BinaryOperation1 __binary_op1,
+                 _BinaryOperation2 __binary_op2)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+        return __pstl::__internal::__pattern_transform_reduce(__first1, __last1, __first2, std::move(__init),
+                                                              __binary_op1, __binary_op2);
+    else
+        return std::transform_reduce(__first1, __last1, __first2, std::move(__init), __binary_op1, __binary_op2);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp, class _BinaryOperation, class _UnaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+transform_reduce(_ExecutionPolicy&&, _ForwardIterator __first, _ForwardIterator __last, _Tp __init,
+                 _BinaryOperation __binary_op, _UnaryOperation __unary_op)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator>::value)
+        return __pstl::__internal::__pattern_transform_reduce(__first, __last, std::move(__init), __binary_op,
+                                                              __unary_op);
+    else
+        return std::transform_reduce(__first, __last, std::move(__init), __binary_op, __unary_op);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+transform_reduce(_ExecutionPolicy&& __exec, _ForwardIterator1 __first1, _ForwardIterator1 __last1,
+                 _ForwardIterator2 __first2, _Tp __init)
+{
+    return std::transform_reduce(std::forward<_ExecutionPolicy>(__exec), __first1, __last1, __first2,
+                                 std::move(__init), std::plus<>(), std::multiplies<>());
+}
+
+// [reduce]
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp, class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+reduce(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Tp __init,
+       _BinaryOperation __binary_op)
+{
+    return std::transform_reduce(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::move(__init),
+                                 __binary_op, __pstl::__internal::__no_op());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _Tp>
+reduce(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last, _Tp __init)
+{
+    return std::reduce(std::forward<_ExecutionPolicy>(__exec), __first, __last, std::move(__init), std::plus<_Tp>());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy,
+                                                 typename iterator_traits<_ForwardIterator>::value_type>
+reduce(_ExecutionPolicy&& __exec, _ForwardIterator __first, _ForwardIterator __last)
+{
+    typedef typename iterator_traits<_ForwardIterator>::value_type _ValueType;
+    return std::reduce(std::forward<_ExecutionPolicy>(__exec), __first, __last, _ValueType{}, std::plus<_ValueType>());
+}
+
+// [transform.exclusive.scan]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp,
+          class _BinaryOperation, class _UnaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+transform_exclusive_scan(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                         _ForwardIterator2 __result, _Tp __init, _BinaryOperation __binary_op,
+                         _UnaryOperation __unary_op)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+        return __pstl::__internal::__pattern_transform_scan(__first, __last, __result, __unary_op,
+                                                            std::optional<_Tp>(std::move(__init)), __binary_op,
+                                                            std::false_type());
+    else
+        return std::transform_exclusive_scan(__first, __last, __result, std::move(__init), __binary_op,
+                                             __unary_op);
+}
+
+// [exclusive.scan]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp,
+          class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+exclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _Tp __init, _BinaryOperation __binary_op)
+{
+    return std::transform_exclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result,
+                                         std::move(__init), __binary_op, __pstl::__internal::__no_op());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+exclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _Tp __init)
+{
+    return std::exclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result, std::move(__init),
+                               std::plus<_Tp>());
+}
+
+// [transform.inclusive.scan]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation,
+          class _UnaryOperation, class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+transform_inclusive_scan(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                         _ForwardIterator2 __result, _BinaryOperation __binary_op, _UnaryOperation __unary_op,
+                         _Tp __init)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+        return __pstl::__internal::__pattern_transform_scan(__first, __last, __result, __unary_op,
+                                                            std::optional<_Tp>(std::move(__init)), __binary_op,
+                                                            std::true_type());
+    else
+        return std::transform_inclusive_scan(__first, __last, __result, __binary_op, __unary_op, std::move(__init));
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation,
+          class _UnaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+transform_inclusive_scan(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                         _ForwardIterator2 __result, _BinaryOperation __binary_op, _UnaryOperation __unary_op)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator1>::reference _Reference;
+        typedef decay_t<invoke_result_t<_UnaryOperation&, _Reference>> _Tp;
+        return __pstl::__internal::__pattern_transform_scan(__first, __last, __result, __unary_op,
+                                                            std::optional<_Tp>(), __binary_op, std::true_type());
+    }
+    else
+        return std::transform_inclusive_scan(__first, __last, __result, __binary_op, __unary_op);
+}
+
+// [inclusive.scan]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation,
+          class _Tp>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+inclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _BinaryOperation __binary_op, _Tp __init)
+{
+    return std::transform_inclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result,
+                                         __binary_op, __pstl::__internal::__no_op(), std::move(__init));
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+inclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result, _BinaryOperation __binary_op)
+{
+    return std::transform_inclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result,
+                                         __binary_op, __pstl::__internal::__no_op());
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+inclusive_scan(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+               _ForwardIterator2 __result)
+{
+    return std::inclusive_scan(std::forward<_ExecutionPolicy>(__exec), __first, __last, __result, std::plus<>());
+}
+
+// [adjacent.difference]
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2, class _BinaryOperation>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+adjacent_difference(_ExecutionPolicy&&, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                    _ForwardIterator2 __d_first, _BinaryOperation __op)
+{
+    if constexpr (__pstl::__internal::__is_parallelization_preferred<_ExecutionPolicy, _ForwardIterator1,
+                                                                     _ForwardIterator2>::value)
+    {
+        typedef typename iterator_traits<_ForwardIterator1>::difference_type _Size;
+        const _Size __n = __last - __first;
+        if (__n == 0)
+            return __d_first;
+        *__d_first = *__first;
+        __pstl::__internal::__pattern_walk_n(__n - 1, [=](_Size __b, _Size __e) {
+            for (; __b != __e; ++__b)
+                __d_first[__b + 1] = __op(__first[__b + 1], __first[__b]);
+        });
+        return __d_first + __n;
+    }
+    else
+        return std::adjacent_difference(__first, __last, __d_first, __op);
+}
+
+template <class _ExecutionPolicy, class _ForwardIterator1, class _ForwardIterator2>
+__pstl::__internal::__enable_if_execution_policy<_ExecutionPolicy, _ForwardIterator2>
+adjacent_difference(_ExecutionPolicy&& __exec, _ForwardIterator1 __first, _ForwardIterator1 __last,
+                    _ForwardIterator2 __d_first)
+{
+    return std::adjacent_difference(std::forward<_ExecutionPolicy>(__exec), __first, __last, __d_first,
+                                    std::minus<>());
+}
+
+} // namespace std
+
+#endif /* _PSTL_GLUE_NUMERIC_IMPL_H */
@@ -0,0 +1,53 @@
+// -*- C++ -*-
+//===-- numeric_fwd.h -----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_NUMERIC_FWD_H
+#define _PSTL_NUMERIC_FWD_H
+
+#include <iterator>
+#include <optional>
+
+#include "pstl_config.h"
+
+// Declarations of the parallel patterns that the glue headers call. The
+// definitions need the complete standard headers that include the glue, so
+// they are only pulled in by <execution>; see glue_execution_defs.h.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __internal
+{
+
+template <class _RandomAccessIterator, class _Tp, class _BinaryOperation, class _UnaryOperation>
+_Tp
+__pattern_transform_reduce(_RandomAccessIterator __first, _RandomAccessIterator __last, _Tp __init,
+                           _BinaryOperation __binary_op, _UnaryOperation __unary_op);
+
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _Tp, class _BinaryOperation1,
+          class _BinaryOperation2>
+_Tp
+__pattern_transform_reduce(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1,
+                           _RandomAccessIterator2 __first2, _Tp __init, _BinaryOperation1 __binary_op1,
+                           _BinaryOperation2 __binary_op2);
+
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _Tp, class _BinaryOperation,
+          class _UnaryOperation, class _Inclusive>
+_RandomAccessIterator2
+__pattern_transform_scan(_RandomAccessIterator1 __first, _RandomAccessIterator1 __last,
+                         _RandomAccessIterator2 __result, _UnaryOperation __unary_op, std::optional<_Tp> __init,
+                         _BinaryOperation __binary_op, _Inclusive);
+
+} // namespace __internal
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_NUMERIC_FWD_H */
@@ -0,0 +1,163 @@
+// -*- C++ -*-
+//===-- numeric_impl.h ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_NUMERIC_IMPL_H
+#define _PSTL_NUMERIC_IMPL_H
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "execution_impl.h"
+#include "numeric_fwd.h"
+#include "parallel_backend.h"
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __internal
+{
+
+//------------------------------------------------------------------------
+// transform_reduce
+//------------------------------------------------------------------------
+
+// The generalized sum of __init and __transform(__i) for __i in [0, __n).
+// __binary_op has no identity element to start the subranges from, so the
+// partial sums are optional.
+template <class _Size, class _Tp, class _BinaryOperation, class _Transform>
+_Tp
+__transform_reduce_index(_Size __n, _Tp __init, _BinaryOperation __binary_op, _Transform __transform)
+{
+    typedef std::optional<_Tp> _Partial;
+    _Partial __sum = __par_backend::__parallel_reduce(
+        _Size(0), __n, _Partial(),
+        [&__binary_op, &__transform](_Size __b, _Size __e, _Partial __acc) -> _Partial {
+            if (__b == __e)
+                return __acc;
+            if (!__acc)
+                __acc.emplace(__transform(__b++));
+            for (; __b != __e; ++__b)
+                *__acc = __binary_op(std::move(*__acc), __transform(__b));
+            return __acc;
+        },
+        [&__binary_op](_Partial __x, _Partial __y) -> _Partial {
+            if (!__x)
+                return __y;
+            if (!__y)
+                return __x;
+            return _Partial(__binary_op(std::move(*__x), std::move(*__y)));
+        });
+    if (!__sum)
+        return __init;
+    return __binary_op(std::move(__init), std::move(*__sum));
+}
+
+template <class _RandomAccessIterator, class _Tp, class _BinaryOperation, class _UnaryOperation>
+_Tp
+__pattern_transform_reduce(_RandomAccessIterator __first, _RandomAccessIterator __last, _Tp __init,
+                           _BinaryOperation __binary_op, _UnaryOperation __unary_op)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator>::difference_type _Size;
+    return __transform_reduce_index(__last - __first, std::move(__init), __binary_op,
+                                    [__first, &__unary_op](_Size __i) { return __unary_op(__first[__i]); });
+}
+
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _Tp, class _BinaryOperation1,
+          class _BinaryOperation2>
+_Tp
+__pattern_transform_reduce(_RandomAccessIterator1 __first1, _RandomAccessIterator1 __last1,
+                           _RandomAccessIterator2 __first2, _Tp __init, _BinaryOperation1 __binary_op1,
+                           _BinaryOperation2 __binary_op2)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator1>::difference_type _Size;
+    return __transform_reduce_index(
+        __last1 - __first1, std::move(__init), __binary_op1,
+        [__first1, __first2, &__binary_op2](_Size __i) { return __binary_op2(__first1[__i], __first2[__i]); });
+}
+
+//------------------------------------------------------------------------
+// scans
+//------------------------------------------------------------------------
+
+// Scans in three passes over the same chunks: sum each chunk, add up the
+// chunk sums sequentially, then scan each chunk from its offset. __init is
+// empty for an inclusive scan without an initial value.
+template <class _RandomAccessIterator1, class _RandomAccessIterator2, class _Tp, class _BinaryOperation,
+          class _UnaryOperation, class _Inclusive>
+_RandomAccessIterator2
+__pattern_transform_scan(_RandomAccessIterator1 __first, _RandomAccessIterator1 __last,
+                         _RandomAccessIterator2 __result, _UnaryOperation __unary_op, std::optional<_Tp> __init,
+                         _BinaryOperation __binary_op, _Inclusive)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator1>::difference_type _Size;
+    const _Size __n = __last - __first;
+    const std::size_t __chunks = __par_backend::__chunk_count(std::size_t(__n), __par_backend::__concurrency());
+
+    auto __chunk_first = [&](std::size_t __i) { return __par_backend::__chunk_begin(__n, __chunks, __i); };
+    auto __accumulate = [&](std::optional<_Tp>& __acc, _Size __i) {
+        if (__acc)
+            *__acc = __binary_op(std::move(*__acc), __unary_op(__first[__i]));
+        else
+            __acc.emplace(__unary_op(__first[__i]));
+    };
+
+    std::vector<std::optional<_Tp>> __offsets(__chunks);
+    __offsets[0] = std::move(__init);
+    if (__chunks > 1)
+    {
+        std::vector<std::optional<_Tp>> __sums(__chunks - 1);
+        __par_backend::__parallel_for(std::size_t(0), __chunks - 1, [&](std::size_t __b, std::size_t __e) {
+            for (; __b != __e; ++__b)
+                for (_Size __i = __chunk_first(__b); __i != __chunk_first(__b + 1); ++__i)
+                    __accumulate(__sums[__b], __i);
+        }, 1);
+        for (std::size_t __c = 1; __c < __chunks; ++__c)
+        {
+            __offsets[__c] = __offsets[__c - 1];
+            if (!__offsets[__c])
+                __offsets[__c] = std::move(__sums[__c - 1]);
+            else if (__sums[__c - 1])
+                *__offsets[__c] = __binary_op(std::move(*__offsets[__c]), std::move(*__sums[__c - 1]));
+        }
+    }
+
+    __par_backend::__parallel_for(std::size_t(0), __chunks, [&](std::size_t __b, std::size_t __e) {
+        for (; __b != __e; ++__b)
+        {
+            std::optional<_Tp>& __acc = __offsets[__b];
+            for (_Size __i = __chunk_first(__b); __i != __chunk_first(__b + 1); ++__i)
+            {
+                if (_Inclusive::value)
+                {
+                    __accumulate(__acc, __i);
+                    __result[__i] = *__acc;
+                }
+                else
+                {
+                    // __result may be __first.
+                    _Tp __value = __unary_op(__first[__i]);
+                    __result[__i] = *__acc;
+                    *__acc = __binary_op(std::move(*__acc), std::move(__value));
+                }
+            }
+        }
+    }, 1);
+    return __result + __n;
+}
+
+} // namespace __internal
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_NUMERIC_IMPL_H */
@@ -0,0 +1,49 @@
+// -*- C++ -*-
+//===-- parallel_backend.h ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_H
+#define _PSTL_PARALLEL_BACKEND_H
+
+#include "pstl_config.h"
+
+// Every backend provides, in namespace __pstl::__par_backend:
+//
+//   void __parallel_for(_Index __first, _Index __last, _Fp __f,
+//                       std::size_t __grain = _PSTL_GRAIN_SIZE);
+//     Calls __f(__b, __e) on disjoint subranges that cover [__first, __last),
+//     none shorter than __grain unless the whole range is.
+//
+//   _Tp __parallel_reduce(_Index __first, _Index __last, const _Tp& __identity,
+//                         const _RealBody& __real_body, const _Reduction& __reduction);
+//     __real_body(__b, __e, __init) folds a subrange into __init. The folds of
+//     the subranges, each starting from __identity or from the fold of the
+//     subranges before it, are combined in order with __reduction.
+//
+//   void __parallel_stable_sort(_RandomAccessIterator __first, _RandomAccessIterator __last,
+//                               _Compare __comp, _LeafSort __leaf_sort);
+//     Sorts with __leaf_sort(__b, __e, __comp) on subranges, then merges.
+//
+//   unsigned __concurrency();
+//     The number of threads the backend spreads work over.
+//
+// _Index is an integral type or a random access iterator.
+
+#if defined(_PSTL_PAR_BACKEND_SERIAL)
+#    include "parallel_backend_serial.h"
+#elif defined(_PSTL_PAR_BACKEND_LIBCXX)
+#    include "parallel_backend_libcxx.h"
+#elif defined(_PSTL_PAR_BACKEND_OMP)
+#    include "parallel_backend_omp.h"
+#elif defined(_PSTL_PAR_BACKEND_TBB)
+#    include "parallel_backend_tbb.h"
+#else
+#    error "No parallel backend was selected"
+#endif
+
+#endif /* _PSTL_PARALLEL_BACKEND_H */
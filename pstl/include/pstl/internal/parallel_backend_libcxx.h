@@ -0,0 +1,94 @@
+// -*- C++ -*-
+//===-- parallel_backend_libcxx.h -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_LIBCXX_H
+#define _PSTL_PARALLEL_BACKEND_LIBCXX_H
+
+#include <__thread_pool>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "parallel_backend_utils.h"
+#include "pstl_config.h"
+
+// Runs the algorithms on the worker threads libc++ keeps for them, see
+// <__thread_pool>. PSTL_NUM_THREADS limits the number of threads.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+inline unsigned
+__concurrency()
+{
+    return std::__thread_pool_concurrency();
+}
+
+// Calls __f(__i) for each __i in [0, __n) on the pool. An exception that
+// escapes __f ends the program.
+template <class _Fp>
+void
+__run_tasks(std::size_t __n, _Fp& __f)
+{
+    std::__thread_pool_run(__n, [](void* __context, std::size_t __i) noexcept { (*static_cast<_Fp*>(__context))(__i); },
+                           &__f);
+}
+
+template <class _Index, class _Fp>
+void
+__parallel_for(_Index __first, _Index __last, _Fp __f, std::size_t __grain = _PSTL_GRAIN_SIZE)
+{
+    const auto __n = __last - __first;
+    const std::size_t __chunks = __chunk_count(std::size_t(__n), __concurrency(), __grain);
+    if (__chunks <= 1)
+    {
+        __f(__first, __last);
+        return;
+    }
+    auto __task = [&](std::size_t __i) {
+        __f(__first + __chunk_begin(__n, __chunks, __i), __first + __chunk_begin(__n, __chunks, __i + 1));
+    };
+    __run_tasks(__chunks, __task);
+}
+
+template <class _Index, class _Tp, class _RealBody, class _Reduction>
+_Tp
+__parallel_reduce(_Index __first, _Index __last, const _Tp& __identity, const _RealBody& __real_body,
+                  const _Reduction& __reduction)
+{
+    const auto __n = __last - __first;
+    const std::size_t __chunks = __chunk_count(std::size_t(__n), __concurrency());
+    if (__chunks <= 1)
+        return __real_body(__first, __last, __identity);
+
+    std::vector<std::optional<_Tp>> __partial(__chunks);
+    auto __task = [&](std::size_t __i) {
+        __partial[__i].emplace(__real_body(__first + __chunk_begin(__n, __chunks, __i),
+                                           __first + __chunk_begin(__n, __chunks, __i + 1), __identity));
+    };
+    __run_tasks(__chunks, __task);
+
+    _Tp __result = std::move(*__partial[0]);
+    for (std::size_t __i = 1; __i < __chunks; ++__i)
+        __result = __reduction(std::move(__result), std::move(*__partial[__i]));
+    return __result;
+}
+
+} // namespace __par_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#include "parallel_stable_sort.h"
+
+#endif /* _PSTL_PARALLEL_BACKEND_LIBCXX_H */
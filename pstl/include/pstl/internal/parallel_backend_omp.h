@@ -0,0 +1,93 @@
+// -*- C++ -*-
+//===-- parallel_backend_omp.h --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_OMP_H
+#define _PSTL_PARALLEL_BACKEND_OMP_H
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include <omp.h>
+
+#include "parallel_backend_utils.h"
+#include "pstl_config.h"
+
+#if !defined(_OPENMP)
+#    error "The OpenMP backend needs the program to be compiled with OpenMP enabled"
+#endif
+
+// Runs the algorithms in OpenMP parallel regions. A call from inside a
+// parallel region runs on the calling thread, unless nested parallelism is
+// enabled.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+inline unsigned
+__concurrency()
+{
+    return omp_in_parallel() && omp_get_max_active_levels() <= omp_get_level() ? 1u
+                                                                                : unsigned(omp_get_max_threads());
+}
+
+template <class _Index, class _Fp>
+void
+__parallel_for(_Index __first, _Index __last, _Fp __f, std::size_t __grain = _PSTL_GRAIN_SIZE)
+{
+    const auto __n = __last - __first;
+    const std::size_t __chunks = __chunk_count(std::size_t(__n), __concurrency(), __grain);
+    if (__chunks <= 1)
+    {
+        __f(__first, __last);
+        return;
+    }
+    const long long __count = static_cast<long long>(__chunks);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (long long __i = 0; __i < __count; ++__i)
+        __f(__first + __chunk_begin(__n, __chunks, std::size_t(__i)),
+            __first + __chunk_begin(__n, __chunks, std::size_t(__i) + 1));
+}
+
+template <class _Index, class _Tp, class _RealBody, class _Reduction>
+_Tp
+__parallel_reduce(_Index __first, _Index __last, const _Tp& __identity, const _RealBody& __real_body,
+                  const _Reduction& __reduction)
+{
+    const auto __n = __last - __first;
+    const std::size_t __chunks = __chunk_count(std::size_t(__n), __concurrency());
+    if (__chunks <= 1)
+        return __real_body(__first, __last, __identity);
+
+    std::vector<std::optional<_Tp>> __partial(__chunks);
+    const long long __count = static_cast<long long>(__chunks);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (long long __i = 0; __i < __count; ++__i)
+        __partial[__i].emplace(__real_body(__first + __chunk_begin(__n, __chunks, std::size_t(__i)),
+                                           __first + __chunk_begin(__n, __chunks, std::size_t(__i) + 1),
+                                           __identity));
+
+    _Tp __result = std::move(*__partial[0]);
+    for (std::size_t __i = 1; __i < __chunks; ++__i)
+        __result = __reduction(std::move(__result), std::move(*__partial[__i]));
+    return __result;
+}
+
+} // namespace __par_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#include "parallel_stable_sort.h"
+
+#endif /* _PSTL_PARALLEL_BACKEND_OMP_H */
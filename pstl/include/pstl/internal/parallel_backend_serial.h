@@ -0,0 +1,59 @@
+// -*- C++ -*-
+//===-- parallel_backend_serial.h -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_SERIAL_H
+#define _PSTL_PARALLEL_BACKEND_SERIAL_H
+
+#include <cstddef>
+
+#include "parallel_backend_utils.h"
+#include "pstl_config.h"
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+inline unsigned
+__concurrency()
+{
+    return 1;
+}
+
+template <class _Index, class _Fp>
+void
+__parallel_for(_Index __first, _Index __last, _Fp __f, std::size_t = _PSTL_GRAIN_SIZE)
+{
+    __f(__first, __last);
+}
+
+template <class _Index, class _Tp, class _RealBody, class _Reduction>
+_Tp
+__parallel_reduce(_Index __first, _Index __last, const _Tp& __identity, const _RealBody& __real_body,
+                  const _Reduction&)
+{
+    return __real_body(__first, __last, __identity);
+}
+
+template <class _RandomAccessIterator, class _Compare, class _LeafSort>
+void
+__parallel_stable_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp,
+                       _LeafSort __leaf_sort)
+{
+    __leaf_sort(__first, __last, __comp);
+}
+
+} // namespace __par_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_PARALLEL_BACKEND_SERIAL_H */
@@ -0,0 +1,76 @@
+// -*- C++ -*-
+//===-- parallel_backend_tbb.h --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_TBB_H
+#define _PSTL_PARALLEL_BACKEND_TBB_H
+
+#include <cstddef>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/task_arena.h>
+
+#include "parallel_backend_utils.h"
+#include "pstl_config.h"
+
+#if TBB_INTERFACE_VERSION < 10000
+#    error "The TBB backend needs TBB 2018 or newer"
+#endif
+
+// Runs the algorithms as TBB tasks in the current task arena.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+inline unsigned
+__concurrency()
+{
+    return unsigned(tbb::this_task_arena::max_concurrency());
+}
+
+template <class _Index, class _Fp>
+void
+__parallel_for(_Index __first, _Index __last, _Fp __f, std::size_t __grain = _PSTL_GRAIN_SIZE)
+{
+    tbb::this_task_arena::isolate([=]() {
+        tbb::parallel_for(tbb::blocked_range<_Index>(__first, __last, __grain),
+                          [__f](const tbb::blocked_range<_Index>& __r) { __f(__r.begin(), __r.end()); });
+    });
+}
+
+// TBB combines the partial results in order, so __reduction need not be
+// commutative.
+template <class _Index, class _Tp, class _RealBody, class _Reduction>
+_Tp
+__parallel_reduce(_Index __first, _Index __last, const _Tp& __identity, const _RealBody& __real_body,
+                  const _Reduction& __reduction)
+{
+    return tbb::this_task_arena::isolate([&]() -> _Tp {
+        return tbb::parallel_reduce(
+            tbb::blocked_range<_Index>(__first, __last, _PSTL_GRAIN_SIZE), __identity,
+            [&](const tbb::blocked_range<_Index>& __r, const _Tp& __init) -> _Tp {
+                return __real_body(__r.begin(), __r.end(), __init);
+            },
+            [&](const _Tp& __x, const _Tp& __y) -> _Tp { return __reduction(__x, __y); });
+    });
+}
+
+} // namespace __par_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#include "parallel_stable_sort.h"
+
+#endif /* _PSTL_PARALLEL_BACKEND_TBB_H */
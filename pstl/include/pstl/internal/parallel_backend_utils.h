@@ -0,0 +1,76 @@
+// -*- C++ -*-
+//===-- parallel_backend_utils.h ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_UTILS_H
+#define _PSTL_PARALLEL_BACKEND_UTILS_H
+
+#include <cstddef>
+#include <memory>
+
+#include "pstl_config.h"
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+// The number of tasks for __n elements: a few per thread, so that uneven
+// tasks still balance, but none with fewer than __grain elements.
+inline std::size_t
+__chunk_count(std::size_t __n, unsigned __threads, std::size_t __grain = _PSTL_GRAIN_SIZE)
+{
+    if (__threads <= 1)
+        return 1;
+    const std::size_t __by_grain = (__n + __grain - 1) / __grain;
+    const std::size_t __by_threads = std::size_t(__threads) * 4;
+    return __by_grain < __by_threads ? (__by_grain == 0 ? 1 : __by_grain) : __by_threads;
+}
+
+// The start of chunk __i when [0, __n) is split into __chunks nearly equal
+// chunks. __chunk_begin(__n, __chunks, __chunks) is __n.
+template <class _Size>
+_Size
+__chunk_begin(_Size __n, std::size_t __chunks, std::size_t __i)
+{
+    const _Size __base = __n / _Size(__chunks);
+    const _Size __extra = __n % _Size(__chunks);
+    const _Size __index = _Size(__i);
+    return __base * __index + (__index < __extra ? __index : __extra);
+}
+
+// Uninitialized storage for __n objects of type _Tp.
+template <class _Tp>
+class __buffer
+{
+    std::allocator<_Tp> __allocator_;
+    _Tp* __ptr_;
+    std::size_t __n_;
+
+  public:
+    explicit __buffer(std::size_t __n) : __allocator_(), __ptr_(__allocator_.allocate(__n)), __n_(__n) {}
+    __buffer(const __buffer&) = delete;
+    __buffer&
+    operator=(const __buffer&) = delete;
+    ~__buffer() { __allocator_.deallocate(__ptr_, __n_); }
+
+    _Tp*
+    get() const
+    {
+        return __ptr_;
+    }
+};
+
+} // namespace __par_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_PARALLEL_BACKEND_UTILS_H */
@@ -0,0 +1,161 @@
+// -*- C++ -*-
+//===-- parallel_stable_sort.h --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_STABLE_SORT_H
+#define _PSTL_PARALLEL_STABLE_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "parallel_backend_utils.h"
+
+// A stable sort in terms of the __parallel_for and __concurrency of the
+// backend that includes it.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __par_backend
+{
+
+// Merges [__first1, __last1) and [__first2, __last2), given as offsets into
+// the source, to offset __out of the destination.
+template <class _Size>
+struct __merge_task
+{
+    _Size __first1, __last1, __first2, __last2, __out;
+};
+
+// Adds tasks that merge the sorted runs [__b1, __b2) and [__b2, __b3) of
+// __src, split into __pieces independent pieces. The longer run is cut
+// evenly, and the cut in the other run keeps equal elements in order.
+template <class _Iterator, class _Size, class _Compare>
+void
+__split_merge(_Iterator __src, _Size __b1, _Size __b2, _Size __b3, std::size_t __pieces, _Compare __comp,
+              std::vector<__merge_task<_Size>>& __tasks)
+{
+    _Size __prev1 = __b1, __prev2 = __b2;
+    for (std::size_t __i = 1; __i <= __pieces; ++__i)
+    {
+        _Size __cut1 = __b2, __cut2 = __b3;
+        if (__i != __pieces)
+        {
+            if (__b2 - __b1 >= __b3 - __b2)
+            {
+                __cut1 = __b1 + __chunk_begin(__b2 - __b1, __pieces, __i);
+                __cut2 = std::lower_bound(__src + __b2, __src + __b3, *(__src + __cut1), __comp) - __src;
+            }
+            else
+            {
+                __cut2 = __b2 + __chunk_begin(__b3 - __b2, __pieces, __i);
+                __cut1 = std::upper_bound(__src + __b1, __src + __b2, *(__src + __cut2), __comp) - __src;
+            }
+        }
+        __tasks.push_back({__prev1, __cut1, __prev2, __cut2, __b1 + (__prev1 - __b1) + (__prev2 - __b2)});
+        __prev1 = __cut1;
+        __prev2 = __cut2;
+    }
+}
+
+// Merges pairs of adjacent runs of __src into __dst, and leaves the run
+// boundaries of the result in __bounds.
+template <class _Src, class _Dst, class _Size, class _Compare>
+void
+__merge_runs(_Src __src, _Dst __dst, std::vector<_Size>& __bounds, _Compare __comp)
+{
+    const unsigned __threads = __concurrency();
+    const std::size_t __runs = __bounds.size() - 1;
+    std::vector<__merge_task<_Size>> __tasks;
+    std::vector<_Size> __merged;
+    for (std::size_t __r = 0; __r < __runs; __r += 2)
+    {
+        __merged.push_back(__bounds[__r]);
+        const _Size __b3 = __bounds[__r + 2 <= __runs ? __r + 2 : __r + 1];
+        const _Size __b2 = __bounds[__r + 1];
+        const std::size_t __pieces = __chunk_count(std::size_t(__b3 - __bounds[__r]), __threads) / 4 + 1;
+        __split_merge(__src, __bounds[__r], __b2, __b3, __pieces, __comp, __tasks);
+    }
+    __merged.push_back(__bounds[__runs]);
+    __bounds.swap(__merged);
+
+    __parallel_for(std::size_t(0), __tasks.size(), [&](std::size_t __b, std::size_t __e) {
+        for (; __b != __e; ++__b)
+        {
+            const __merge_task<_Size>& __t = __tasks[__b];
+            std::merge(std::make_move_iterator(__src + __t.__first1), std::make_move_iterator(__src + __t.__last1),
+                       std::make_move_iterator(__src + __t.__first2), std::make_move_iterator(__src + __t.__last2),
+                       __dst + __t.__out, __comp);
+        }
+    }, 1);
+}
+
+// Sorts runs of [__first, __last) with __leaf_sort in parallel, then merges
+// them in rounds through a temporary buffer. Each merge is split into pieces,
+// so that the last rounds stay parallel too.
+template <class _RandomAccessIterator, class _Compare, class _LeafSort>
+void
+__parallel_stable_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compare __comp,
+                       _LeafSort __leaf_sort)
+{
+    typedef typename std::iterator_traits<_RandomAccessIterator>::value_type _Tp;
+    typedef typename std::iterator_traits<_RandomAccessIterator>::difference_type _Size;
+
+    const _Size __n = __last - __first;
+    const std::size_t __runs = __chunk_count(std::size_t(__n), __concurrency());
+    if (__runs <= 1)
+    {
+        __leaf_sort(__first, __last, __comp);
+        return;
+    }
+
+    std::vector<_Size> __bounds(__runs + 1);
+    for (std::size_t __i = 0; __i <= __runs; ++__i)
+        __bounds[__i] = __chunk_begin(__n, __runs, __i);
+    __parallel_for(std::size_t(0), __runs, [&](std::size_t __b, std::size_t __e) {
+        for (; __b != __e; ++__b)
+            __leaf_sort(__first + __bounds[__b], __first + __bounds[__b + 1], __comp);
+    }, 1);
+
+    __buffer<_Tp> __buf(static_cast<std::size_t>(__n));
+    _Tp* const __tmp = __buf.get();
+    __parallel_for(_Size(0), __n, [&](_Size __b, _Size __e) {
+        std::uninitialized_copy(std::make_move_iterator(__first + __b), std::make_move_iterator(__first + __e),
+                                __tmp + __b);
+    });
+
+    // The runs alternate between the buffer and the sequence. The first
+    // round reads the buffer.
+    bool __in_buffer = true;
+    while (__bounds.size() > 2)
+    {
+        if (__in_buffer)
+            __merge_runs(__tmp, __first, __bounds, __comp);
+        else
+            __merge_runs(__first, __tmp, __bounds, __comp);
+        __in_buffer = !__in_buffer;
+    }
+
+    __parallel_for(_Size(0), __n, [&](_Size __b, _Size __e) {
+        if (__in_buffer)
+            std::move(__tmp + __b, __tmp + __e, __first + __b);
+        for (; __b != __e; ++__b)
+            (__tmp + __b)->~_Tp();
+    });
+}
+
+} // namespace __par_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_PARALLEL_STABLE_SORT_H */
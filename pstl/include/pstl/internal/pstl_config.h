@@ -0,0 +1,43 @@
+// -*- C++ -*-
+//===-- pstl_config.h -----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_CONFIG_H
+#define _PSTL_CONFIG_H
+
+#include <__pstl_config_site>
+
+// The version is XYYZ, where X is the major, YY the minor and Z the patch
+// version.
+#define _PSTL_VERSION 10000
+#define _PSTL_VERSION_MAJOR (_PSTL_VERSION / 1000)
+#define _PSTL_VERSION_MINOR ((_PSTL_VERSION % 1000) / 10)
+#define _PSTL_VERSION_PATCH (_PSTL_VERSION % 10)
+
+#if !defined(_PSTL_PAR_BACKEND_SERIAL) && !defined(_PSTL_PAR_BACKEND_LIBCXX) && !defined(_PSTL_PAR_BACKEND_OMP) &&     \
+    !defined(_PSTL_PAR_BACKEND_TBB)
+#    error "The parallel backend is neither serial, libcxx, omp, nor tbb"
+#endif
+
+// Keeps the ABI-unstable functions out of the exported symbols of each
+// translation unit.
+#if defined(_PSTL_HIDE_FROM_ABI_PER_TU)
+#    define _PSTL_HIDE_FROM_ABI_PUSH                                                                                   \
+        _Pragma("clang attribute _PSTL_HIDE_FROM_ABI.push(__attribute__((internal_linkage)), apply_to=any(function,record))")
+#    define _PSTL_HIDE_FROM_ABI_POP _Pragma("clang attribute _PSTL_HIDE_FROM_ABI.pop")
+#else
+#    define _PSTL_HIDE_FROM_ABI_PUSH /**/
+#    define _PSTL_HIDE_FROM_ABI_POP  /**/
+#endif
+
+// The smallest number of elements a parallel algorithm hands to one task.
+#if !defined(_PSTL_GRAIN_SIZE)
+#    define _PSTL_GRAIN_SIZE 512
+#endif
+
+#endif /* _PSTL_CONFIG_H */
@@ -0,0 +1,77 @@
+// -*- C++ -*-
+//===-- transform.pass.cpp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+#include <algorithm>
+#include <atomic>
+#include <execution>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+int
+main()
+{
+    for (std::size_t n : sizes)
+    {
+        std::vector<int> in(n);
+        for (std::size_t i = 0; i < n; ++i)
+            in[i] = int(i * 7 % 1013);
+
+        invoke_on_all_policies([&](auto&& exec) {
+            std::vector<int> out(n), expected(n);
+
+            std::transform(exec, in.begin(), in.end(), out.begin(), [](int x) { return x * 2; });
+            std::transform(in.begin(), in.end(), expected.begin(), [](int x) { return x * 2; });
+            EXPECT_TRUE(out == expected, "wrong result from transform");
+
+            std::transform(exec, in.begin(), in.end(), expected.begin(), out.begin(), std::minus<int>());
+            for (std::size_t i = 0; i < n; ++i)
+                EXPECT_TRUE(out[i] == -in[i], "wrong result from binary transform");
+
+            std::atomic<long> sum(0);
+            std::for_each(exec, in.begin(), in.end(), [&](int x) { sum += x; });
+            long expected_sum = 0;
+            for (int x : in)
+                expected_sum += x;
+            EXPECT_TRUE(sum == expected_sum, "wrong result from for_each");
+
+            std::copy(exec, in.begin(), in.end(), out.begin());
+            EXPECT_TRUE(out == in, "wrong result from copy");
+
+            std::fill(exec, out.begin(), out.end(), 3);
+            EXPECT_TRUE(std::count(out.begin(), out.end(), 3) == std::ptrdiff_t(n), "wrong result from fill");
+
+            std::reverse_copy(exec, in.begin(), in.end(), out.begin());
+            std::reverse_copy(in.begin(), in.end(), expected.begin());
+            EXPECT_TRUE(out == expected, "wrong result from reverse_copy");
+
+            std::reverse(exec, out.begin(), out.end());
+            EXPECT_TRUE(out == in, "wrong result from reverse");
+
+            std::replace(exec, out.begin(), out.end(), 7, -7);
+            expected = in;
+            std::replace(expected.begin(), expected.end(), 7, -7);
+            EXPECT_TRUE(out == expected, "wrong result from replace");
+
+            if (n != 0)
+            {
+                std::rotate_copy(exec, in.begin(), in.begin() + n / 3, in.end(), out.begin());
+                std::rotate_copy(in.begin(), in.begin() + n / 3, in.end(), expected.begin());
+                EXPECT_TRUE(out == expected, "wrong result from rotate_copy");
+            }
+        });
+    }
+
+    done();
+    return 0;
+}
@@ -0,0 +1,76 @@
+// -*- C++ -*-
+//===-- find_if.pass.cpp --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+int
+main()
+{
+    for (std::size_t n : sizes)
+    {
+        std::vector<int> in(n);
+        for (std::size_t i = 0; i < n; ++i)
+            in[i] = int(i % 97);
+
+        invoke_on_all_policies([&](auto&& exec) {
+            // Every position of the first match, including none.
+            for (std::size_t m : {std::size_t(0), n / 3, n / 2, n == 0 ? 0 : n - 1, n})
+            {
+                std::vector<int> v = in;
+                if (m < n)
+                    v[m] = -1;
+                auto is_negative = [](int x) { return x < 0; };
+                EXPECT_TRUE(std::find_if(exec, v.begin(), v.end(), is_negative) ==
+                                std::find_if(v.begin(), v.end(), is_negative),
+                            "wrong result from find_if");
+                EXPECT_TRUE(std::find(exec, v.begin(), v.end(), -1) == std::find(v.begin(), v.end(), -1),
+                            "wrong result from find");
+                EXPECT_TRUE(std::any_of(exec, v.begin(), v.end(), is_negative) == (m < n),
+                            "wrong result from any_of");
+                EXPECT_TRUE(std::none_of(exec, v.begin(), v.end(), is_negative) == (m >= n),
+                            "wrong result from none_of");
+                EXPECT_TRUE(std::all_of(exec, v.begin(), v.end(), std::not_fn(is_negative)) == (m >= n),
+                            "wrong result from all_of");
+                EXPECT_TRUE(std::mismatch(exec, in.begin(), in.end(), v.begin()) ==
+                                std::mismatch(in.begin(), in.end(), v.begin()),
+                            "wrong result from mismatch");
+                EXPECT_TRUE(std::equal(exec, in.begin(), in.end(), v.begin(), v.end()) == (m >= n),
+                            "wrong result from equal");
+                EXPECT_TRUE(std::lexicographical_compare(exec, v.begin(), v.end(), in.begin(), in.end()) ==
+                                std::lexicographical_compare(v.begin(), v.end(), in.begin(), in.end()),
+                            "wrong result from lexicographical_compare");
+                EXPECT_TRUE(std::adjacent_find(exec, v.begin(), v.end(), std::greater<int>()) ==
+                                std::adjacent_find(v.begin(), v.end(), std::greater<int>()),
+                            "wrong result from adjacent_find");
+                EXPECT_TRUE(std::count(exec, v.begin(), v.end(), 5) == std::count(v.begin(), v.end(), 5),
+                            "wrong result from count");
+            }
+
+            std::vector<int> heap = in;
+            std::make_heap(heap.begin(), heap.end());
+            if (n > 10)
+                heap[n - 5] = 1000;
+            EXPECT_TRUE(std::is_heap_until(exec, heap.begin(), heap.end()) ==
+                            std::is_heap_until(heap.begin(), heap.end()),
+                        "wrong result from is_heap_until");
+        });
+    }
+
+    done();
+    return 0;
+}
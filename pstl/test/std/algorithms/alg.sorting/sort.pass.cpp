@@ -0,0 +1,88 @@
+// -*- C++ -*-
+//===-- sort.pass.cpp -----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+// Sorts on the key only, so that equal keys show whether a sort is stable.
+struct KeyLess
+{
+    bool
+    operator()(const std::pair<int, std::size_t>& a, const std::pair<int, std::size_t>& b) const
+    {
+        return a.first < b.first;
+    }
+};
+
+int
+main()
+{
+    std::mt19937 gen(42);
+    for (std::size_t n : sizes)
+    {
+        std::vector<std::pair<int, std::size_t>> input(n);
+        for (std::size_t i = 0; i < n; ++i)
+            input[i] = {int(gen() % (n / 4 + 1)), i};
+        std::vector<std::pair<int, std::size_t>> expected = input;
+        std::stable_sort(expected.begin(), expected.end(), KeyLess());
+        std::vector<std::pair<int, std::size_t>> sorted = input;
+        std::sort(sorted.begin(), sorted.end());
+
+        invoke_on_all_policies([&](auto&& exec) {
+            auto v = input;
+            std::stable_sort(exec, v.begin(), v.end(), KeyLess());
+            EXPECT_TRUE(v == expected, "wrong result from stable_sort");
+
+            v = input;
+            std::sort(exec, v.begin(), v.end(), KeyLess());
+            EXPECT_TRUE(std::is_sorted(v.begin(), v.end(), KeyLess()), "wrong result from sort");
+            EXPECT_TRUE(std::is_sorted(exec, v.begin(), v.end(), KeyLess()), "wrong result from is_sorted");
+            std::sort(v.begin(), v.end());
+            EXPECT_TRUE(v == sorted, "sort lost elements");
+
+            EXPECT_TRUE(std::is_sorted_until(exec, input.begin(), input.end(), KeyLess()) ==
+                            std::is_sorted_until(input.begin(), input.end(), KeyLess()),
+                        "wrong result from is_sorted_until");
+            EXPECT_TRUE(std::min_element(exec, input.begin(), input.end(), KeyLess()) ==
+                            std::min_element(input.begin(), input.end(), KeyLess()),
+                        "wrong result from min_element");
+            EXPECT_TRUE(std::max_element(exec, input.begin(), input.end(), KeyLess()) ==
+                            std::max_element(input.begin(), input.end(), KeyLess()),
+                        "wrong result from max_element");
+            EXPECT_TRUE(std::minmax_element(exec, input.begin(), input.end(), KeyLess()) ==
+                            std::minmax_element(input.begin(), input.end(), KeyLess()),
+                        "wrong result from minmax_element");
+
+            std::vector<std::pair<int, std::size_t>> half(expected.begin(), expected.begin() + n / 2);
+            std::vector<std::pair<int, std::size_t>> rest(expected.begin() + n / 2, expected.end());
+            std::sort(rest.begin(), rest.end(), KeyLess());
+            std::vector<std::pair<int, std::size_t>> merged(n), merged_expected(n);
+            std::merge(exec, half.begin(), half.end(), rest.begin(), rest.end(), merged.begin(), KeyLess());
+            std::merge(half.begin(), half.end(), rest.begin(), rest.end(), merged_expected.begin(), KeyLess());
+            EXPECT_TRUE(merged == merged_expected, "wrong result from merge");
+        });
+    }
+
+    std::vector<int> v{3, 1, 2};
+    std::sort(std::execution::par, v.begin(), v.end(), std::greater<int>());
+    EXPECT_TRUE((v == std::vector<int>{3, 2, 1}), "wrong result from sort with greater");
+
+    done();
+    return 0;
+}
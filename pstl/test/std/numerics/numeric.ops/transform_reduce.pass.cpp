@@ -0,0 +1,72 @@
+// -*- C++ -*-
+//===-- transform_reduce.pass.cpp -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+int
+main()
+{
+    for (std::size_t n : sizes)
+    {
+        std::vector<long> in(n);
+        for (std::size_t i = 0; i < n; ++i)
+            in[i] = long(i % 31) - 15;
+
+        invoke_on_all_policies([&](auto&& exec) {
+            EXPECT_TRUE(std::reduce(exec, in.begin(), in.end()) == std::accumulate(in.begin(), in.end(), 0L),
+                        "wrong result from reduce");
+            EXPECT_TRUE(std::transform_reduce(exec, in.begin(), in.end(), in.begin(), 5L) ==
+                            std::inner_product(in.begin(), in.end(), in.begin(), 5L),
+                        "wrong result from transform_reduce");
+            EXPECT_TRUE(std::transform_reduce(exec, in.begin(), in.end(), 0L, std::plus<long>(),
+                                              [](long x) { return x * x * x; }) ==
+                            std::transform_reduce(in.begin(), in.end(), 0L, std::plus<long>(),
+                                                  [](long x) { return x * x * x; }),
+                        "wrong result from unary transform_reduce");
+
+            std::vector<long> out(n), expected(n);
+            std::inclusive_scan(exec, in.begin(), in.end(), out.begin());
+            std::partial_sum(in.begin(), in.end(), expected.begin());
+            EXPECT_TRUE(out == expected, "wrong result from inclusive_scan");
+
+            // In place.
+            out = in;
+            std::exclusive_scan(exec, out.begin(), out.end(), out.begin(), 10L);
+            std::exclusive_scan(in.begin(), in.end(), expected.begin(), 10L);
+            EXPECT_TRUE(out == expected, "wrong result from exclusive_scan");
+
+            std::adjacent_difference(exec, in.begin(), in.end(), out.begin());
+            std::adjacent_difference(in.begin(), in.end(), expected.begin());
+            EXPECT_TRUE(out == expected, "wrong result from adjacent_difference");
+        });
+
+        // The reduction only has to be associative; it may not commute.
+        std::vector<std::string> words(n);
+        for (std::size_t i = 0; i < n; ++i)
+            words[i] = std::string(1, char('a' + i % 26));
+        std::string expected = std::accumulate(words.begin(), words.end(), std::string(">"));
+        invoke_on_all_policies([&](auto&& exec) {
+            EXPECT_TRUE(std::reduce(exec, words.begin(), words.end(), std::string(">")) == expected,
+                        "reduce reordered a non-commutative operation");
+        });
+    }
+
+    done();
+    return 0;
+}
@@ -0,0 +1,54 @@
+// -*- C++ -*-
+//===-- uninitialized.pass.cpp --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++98, c++03, c++11, c++14
+
+#include <execution>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "support/utils.h"
+
+using namespace TestUtils;
+
+int
+main()
+{
+    for (std::size_t n : sizes)
+    {
+        std::vector<std::string> in(n);
+        for (std::size_t i = 0; i < n; ++i)
+            in[i] = std::to_string(i);
+
+        invoke_on_all_policies([&](auto&& exec) {
+            std::allocator<std::string> alloc;
+            std::string* p = alloc.allocate(n + 1);
+
+            std::uninitialized_copy(exec, in.begin(), in.end(), p);
+            EXPECT_TRUE(std::equal(in.begin(), in.end(), p), "wrong result from uninitialized_copy");
+            std::destroy(exec, p, p + n);
+
+            std::uninitialized_fill_n(exec, p, n, std::string("x"));
+            EXPECT_TRUE(std::all_of(p, p + n, [](const std::string& s) { return s == "x"; }),
+                        "wrong result from uninitialized_fill_n");
+            std::destroy_n(exec, p, n);
+
+            std::uninitialized_value_construct(exec, p, p + n);
+            EXPECT_TRUE(std::all_of(p, p + n, [](const std::string& s) { return s.empty(); }),
+                        "wrong result from uninitialized_value_construct");
+            std::destroy(exec, p, p + n);
+
+            alloc.deallocate(p, n + 1);
+        });
+    }
+
+    done();
+    return 0;
+}
@@ -0,0 +1,56 @@
+// -*- C++ -*-
+//===-- utils.h -----------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_TEST_UTILS_H
+#define _PSTL_TEST_UTILS_H
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <execution>
+
+namespace TestUtils
+{
+
+// Sizes around the chunking boundaries of the backends.
+constexpr std::size_t sizes[] = {0, 1, 2, 3, 7, 100, 511, 512, 513, 1000, 4097, 33333, 100000};
+
+#define EXPECT_TRUE(condition, message)                                                                    \
+    ::TestUtils::expect(condition, __FILE__, __LINE__, message)
+
+inline void
+expect(bool condition, const char* file, int line, const char* message)
+{
+    if (!condition)
+    {
+        std::fprintf(stderr, "%s:%d: error: %s\n", file, line, message);
+        std::exit(1);
+    }
+}
+
+// Calls op(policy) with each standard execution policy.
+template <class Op>
+void
+invoke_on_all_policies(Op op)
+{
+    op(std::execution::seq);
+    op(std::execution::unseq);
+    op(std::execution::par);
+    op(std::execution::par_unseq);
+}
+
+inline void
+done()
+{
+    std::fprintf(stdout, "done\n");
+}
+
+} // namespace TestUtils
+
+#endif /* _PSTL_TEST_UTILS_H */